@@ -0,0 +1,554 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <thread>
+#include <unordered_set>
+
+#include "dsp/anticipative_renderer.h"
+#include "dsp/graph_node.h"
+#include "utils/debug.h"
+#include "utils/exceptions.h"
+
+#include "juce_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+/**
+ * @brief Transport as seen by the nodes while rendering a block ahead: rolling,
+ * with the playhead at the start of the block.
+ */
+class AheadTransport final : public ITransport
+{
+public:
+  AheadTransport (const ITransport &transport, const Position &playhead)
+      : transport_ (transport), playhead_ (playhead)
+  {
+  }
+
+  void position_add_frames (Position &pos, signed_frame_t frames) const override
+  {
+    transport_.position_add_frames (pos, frames);
+  }
+  std::pair<Position, Position> get_loop_range_positions () const override
+  {
+    return transport_.get_loop_range_positions ();
+  }
+  PlayState get_play_state () const override { return PlayState::Rolling; }
+  Position  get_playhead_position () const override { return playhead_; }
+  bool get_loop_enabled () const override
+  {
+    return transport_.get_loop_enabled ();
+  }
+  nframes_t
+  is_loop_point_met (signed_frame_t g_start_frames, nframes_t nframes)
+    const override
+  {
+    return transport_.is_loop_point_met (g_start_frames, nframes);
+  }
+
+private:
+  const ITransport &transport_;
+  Position          playhead_;
+};
+
+}
+
+class AnticipativeRenderer::RenderThread final : public juce::Thread
+{
+public:
+  explicit RenderThread (AnticipativeRenderer &renderer)
+      : juce::Thread ("AnticipativeRenderer"), renderer_ (renderer)
+  {
+  }
+
+private:
+  void run () override
+  {
+    renderer_.render_thread_id_.store (
+      current_thread_id.get (), std::memory_order_relaxed);
+    while (!threadShouldExit ())
+      {
+        if (!renderer_.render_next_block ())
+          {
+            /* short enough to pick up again right after a live cycle */
+            std::this_thread::sleep_for (std::chrono::microseconds (200));
+          }
+      }
+  }
+
+private:
+  AnticipativeRenderer &renderer_;
+};
+
+AnticipativeRenderer::AnticipativeRenderer (
+  const ITransport &transport,
+  nframes_t         block_length,
+  size_t            num_blocks)
+    : transport_ (transport), block_length_ (block_length),
+      slots_ (std::max (num_blocks, size_t{ 1 }))
+{
+}
+
+void
+AnticipativeRenderer::set_block_length (nframes_t block_length)
+{
+  release_nodes ();
+  block_length_ = block_length;
+}
+
+void
+AnticipativeRenderer::assign_nodes (GraphNodeCollection &nodes)
+{
+  release_nodes ();
+
+  /* all nodes in processing order (parents before children) */
+  std::vector<GraphNode *> order;
+  for (const auto node : nodes.topological_order_)
+    {
+      order.push_back (&node.get ());
+      for (const auto fused : node.get ().fused_nodes_)
+        {
+          order.push_back (&fused.get ());
+        }
+    }
+
+  const GraphNode * initial_node =
+    nodes.initial_processor_
+      ? nodes.find_node_for_processable (*nodes.initial_processor_)
+      : nullptr;
+  const auto is_special = [&] (const GraphNode &node) {
+    return std::ranges::any_of (nodes.special_nodes_, [&] (const auto special) {
+      return std::addressof (special.get ()) == std::addressof (node);
+    });
+  };
+
+  /* the initial processor only orders the track inputs after the transport
+   * ports, so it doesn't make its children depend on live state */
+  std::unordered_set<const GraphNode *> ahead;
+  for (auto * node : order)
+    {
+      if (
+        node == initial_node || is_special (*node)
+        || !node->get_processable ().can_render_ahead ())
+        continue;
+
+      if (std::ranges::all_of (
+            node->get_parent_nodes (), [&] (const auto parent) {
+              return &parent.get () == initial_node
+                     || ahead.contains (&parent.get ());
+            }))
+        {
+          ahead.insert (node);
+        }
+    }
+
+  /* the boundary nodes are restored by the realtime threads while the rest of
+   * the set may be in use by the rendering thread, so drop boundary nodes that
+   * can't store their output and nodes fed by boundary nodes until there are
+   * none left */
+  std::unordered_set<const GraphNode *> boundary;
+  for (bool changed = true; changed;)
+    {
+      changed = false;
+      boundary.clear ();
+      for (const auto &node : nodes.graph_nodes_)
+        {
+          if (ahead.contains (node.get ()))
+            continue;
+          for (const auto parent : node->get_parent_nodes ())
+            {
+              if (ahead.contains (&parent.get ()))
+                boundary.insert (&parent.get ());
+            }
+        }
+
+      for (auto * node : order)
+        {
+          if (!ahead.contains (node))
+            continue;
+
+          const bool unsupported_boundary =
+            boundary.contains (node)
+            && !node->get_processable ().can_store_rendered_ahead_output ();
+          const bool bad_parent = std::ranges::any_of (
+            node->get_parent_nodes (), [&] (const auto parent) {
+              return &parent.get () != initial_node
+                     && (!ahead.contains (&parent.get ())
+                         || boundary.contains (&parent.get ()));
+            });
+          if (unsupported_boundary || bad_parent)
+            {
+              ahead.erase (node);
+              changed = true;
+            }
+        }
+    }
+
+  for (auto * node : order)
+    {
+      if (!ahead.contains (node))
+        continue;
+
+      nodes_.push_back (node);
+      node->anticipative_renderer_ = this;
+      node->rendered_ahead_boundary_ = boundary.contains (node);
+      if (node->rendered_ahead_boundary_)
+        {
+          node->get_processable ().allocate_rendered_ahead_slots (
+            slots_.size (), block_length_);
+          ++num_boundary_nodes_;
+        }
+      else
+        {
+          node->get_processable ().set_rendered_ahead (true);
+        }
+    }
+
+  read_idx_.store (write_idx_.load ());
+  has_render_pos_ = false;
+  invalidate ();
+
+  z_debug (
+    "rendering {} of {} nodes ahead ({} boundary nodes)", nodes_.size (),
+    nodes.graph_nodes_.size (), num_boundary_nodes_);
+}
+
+void
+AnticipativeRenderer::release_nodes ()
+{
+  for (auto * node : nodes_)
+    {
+      if (!node->rendered_ahead_boundary_)
+        {
+          node->get_processable ().set_rendered_ahead (false);
+        }
+      node->anticipative_renderer_ = nullptr;
+      node->rendered_ahead_boundary_ = false;
+    }
+  nodes_.clear ();
+  num_boundary_nodes_ = 0;
+  cycle_mode_ = CycleMode::Inactive;
+}
+
+void
+AnticipativeRenderer::start_thread ()
+{
+  if (render_thread_)
+    return;
+
+  render_thread_ = std::make_unique<RenderThread> (*this);
+  if (!render_thread_->startThread (juce::Thread::Priority::low))
+    {
+      render_thread_.reset ();
+      throw ZrythmException ("failed to start anticipative rendering thread");
+    }
+}
+
+void
+AnticipativeRenderer::stop_thread ()
+{
+  if (!render_thread_)
+    return;
+
+  pause ();
+  render_thread_->signalThreadShouldExit ();
+  render_thread_->waitForThreadToExit (1000);
+  render_thread_.reset ();
+  resume ();
+}
+
+void
+AnticipativeRenderer::pause ()
+{
+  pause_count_.fetch_add (1, std::memory_order_acq_rel);
+
+  /* the block in progress is aborted at the next node */
+  while (owner_.load (std::memory_order_acquire) == Owner::RenderThread)
+    {
+      std::this_thread::yield ();
+    }
+}
+
+void
+AnticipativeRenderer::resume ()
+{
+  z_return_if_fail (is_paused ());
+  invalidate ();
+  pause_count_.fetch_sub (1, std::memory_order_acq_rel);
+}
+
+bool
+AnticipativeRenderer::take_over_nodes ()
+{
+  takeover_requested_.store (true, std::memory_order_release);
+  const auto deadline = std::chrono::steady_clock::now () + MAX_TAKEOVER_WAIT;
+  bool       taken = false;
+  while (true)
+    {
+      auto expected = Owner::None;
+      if (owner_.compare_exchange_weak (
+            expected, Owner::Realtime, std::memory_order_acq_rel))
+        {
+          taken = true;
+          break;
+        }
+      if (std::chrono::steady_clock::now () > deadline) [[unlikely]]
+        break;
+    }
+  takeover_requested_.store (false, std::memory_order_release);
+  return taken;
+}
+
+void
+AnticipativeRenderer::clear_interior_buffers () const
+{
+  for (auto * node : nodes_)
+    {
+      if (!node->rendered_ahead_boundary_)
+        {
+          node->get_processable ().clear_rendered_ahead_buffers ();
+        }
+    }
+}
+
+void
+AnticipativeRenderer::publish_next_playhead (
+  const Position &playhead,
+  nframes_t       nframes)
+{
+  auto next = playhead;
+  transport_.position_add_frames (next, nframes);
+
+  const auto seq = next_playhead_seq_.load (std::memory_order_relaxed);
+  next_playhead_seq_.store (seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence (std::memory_order_release);
+  next_playhead_frames_.store (next.frames_, std::memory_order_relaxed);
+  next_playhead_ticks_.store (next.ticks_, std::memory_order_relaxed);
+  next_playhead_generation_.store (
+    generation_.load (std::memory_order_acquire), std::memory_order_relaxed);
+  next_playhead_seq_.store (seq + 2, std::memory_order_release);
+}
+
+bool
+AnticipativeRenderer::consume_next_playhead (
+  Position      &pos,
+  const uint64_t generation)
+{
+  const auto seq = next_playhead_seq_.load (std::memory_order_acquire);
+  if (seq == consumed_playhead_seq_ || (seq & 1) != 0)
+    return false;
+
+  Position next;
+  next.frames_ = next_playhead_frames_.load (std::memory_order_relaxed);
+  next.ticks_ = next_playhead_ticks_.load (std::memory_order_relaxed);
+  const auto published_generation =
+    next_playhead_generation_.load (std::memory_order_relaxed);
+  std::atomic_thread_fence (std::memory_order_acquire);
+  if (next_playhead_seq_.load (std::memory_order_relaxed) != seq)
+    return false;
+
+  /* positions published before an invalidation (e.g., right before pausing)
+   * may be stale */
+  consumed_playhead_seq_ = seq;
+  if (published_generation != generation)
+    return false;
+
+  pos = next;
+  return true;
+}
+
+void
+AnticipativeRenderer::begin_cycle (
+  const EngineProcessTimeInfo &time_nfo,
+  const nframes_t              remaining_preroll_frames)
+{
+  if (nodes_.empty ())
+    {
+      cycle_mode_ = CycleMode::Inactive;
+      return;
+    }
+
+  last_cycle_start_time_usecs_.store (
+    time_nfo.cycle_start_time_usecs_, std::memory_order_relaxed);
+
+  /* only whole blocks at the playhead are rendered ahead */
+  const auto playhead = transport_.get_playhead_position ();
+  const bool can_restore =
+    transport_.get_play_state () == ITransport::PlayState::Rolling
+    && !is_paused () && remaining_preroll_frames == 0
+    && time_nfo.local_offset_ == 0 && time_nfo.nframes_ == block_length_
+    && static_cast<signed_frame_t> (time_nfo.g_start_frame_)
+         == playhead.frames_;
+
+  /* drop the blocks that are stale or not at the playhead */
+  const auto generation = generation_.load (std::memory_order_acquire);
+  const auto write = write_idx_.load (std::memory_order_acquire);
+  auto       read = read_idx_.load (std::memory_order_relaxed);
+  for (; read < write; ++read)
+    {
+      const auto &slot = slots_[read % slots_.size ()];
+      if (
+        can_restore && slot.generation_ == generation
+        && slot.start_frame_ == playhead.frames_)
+        break;
+    }
+  read_idx_.store (read, std::memory_order_release);
+
+  if (read < write)
+    {
+      cycle_mode_ = CycleMode::RestoreFromSlot;
+      current_slot_ = read % slots_.size ();
+      num_rendered_ahead_cycles_.fetch_add (1, std::memory_order_relaxed);
+      return;
+    }
+
+  if (take_over_nodes ()) [[likely]]
+    {
+      cycle_mode_ = CycleMode::Live;
+      clear_interior_buffers ();
+    }
+  else
+    {
+      cycle_mode_ = CycleMode::Silence;
+    }
+
+  if (can_restore)
+    {
+      num_live_cycles_.fetch_add (1, std::memory_order_relaxed);
+      publish_next_playhead (playhead, time_nfo.nframes_);
+    }
+}
+
+void
+AnticipativeRenderer::end_cycle ()
+{
+  switch (cycle_mode_)
+    {
+    case CycleMode::RestoreFromSlot:
+      read_idx_.store (
+        read_idx_.load (std::memory_order_relaxed) + 1,
+        std::memory_order_release);
+      break;
+    case CycleMode::Live:
+      owner_.store (Owner::None, std::memory_order_release);
+      break;
+    case CycleMode::Inactive:
+    case CycleMode::Silence:
+      break;
+    }
+}
+
+bool
+AnticipativeRenderer::handle_node (
+  IProcessable                &processable,
+  const bool                   is_boundary,
+  const EngineProcessTimeInfo &time_nfo)
+{
+  switch (cycle_mode_)
+    {
+    case CycleMode::RestoreFromSlot:
+      if (is_boundary)
+        {
+          processable.restore_from_slot (current_slot_, time_nfo);
+        }
+      return true;
+    case CycleMode::Silence:
+      return true;
+    case CycleMode::Inactive:
+    case CycleMode::Live:
+      break;
+    }
+  return false;
+}
+
+bool
+AnticipativeRenderer::render_next_block ()
+{
+  if (
+    nodes_.empty () || is_paused ()
+    || transport_.get_play_state () != ITransport::PlayState::Rolling)
+    return false;
+
+  /* continue from the realtime thread's position after each live cycle, and
+   * wait for the next live cycle after an invalidation */
+  const auto generation = generation_.load (std::memory_order_acquire);
+  if (consume_next_playhead (render_pos_, generation))
+    {
+      has_render_pos_ = true;
+      render_generation_ = generation;
+    }
+  else if (generation != render_generation_)
+    {
+      has_render_pos_ = false;
+    }
+  if (!has_render_pos_)
+    return false;
+
+  const auto write = write_idx_.load (std::memory_order_relaxed);
+  if (write - read_idx_.load (std::memory_order_acquire) >= slots_.size ())
+    return false;
+
+  auto expected = Owner::None;
+  if (
+    takeover_requested_.load (std::memory_order_acquire)
+    || !owner_.compare_exchange_strong (
+      expected, Owner::RenderThread, std::memory_order_acq_rel))
+    return false;
+
+  const auto                  slot_idx = write % slots_.size ();
+  const auto                  start_frame = render_pos_.frames_;
+  const EngineProcessTimeInfo time_nfo{
+    .g_start_frame_ = static_cast<unsigned_frame_t> (start_frame),
+    .g_start_frame_w_offset_ = static_cast<unsigned_frame_t> (start_frame),
+    .local_offset_ = 0,
+    .nframes_ = block_length_,
+    .cycle_start_time_usecs_ =
+      last_cycle_start_time_usecs_.load (std::memory_order_relaxed),
+  };
+  const AheadTransport transport (transport_, render_pos_);
+
+  clear_interior_buffers ();
+  bool aborted = false;
+  for (auto * node : nodes_)
+    {
+      if (
+        takeover_requested_.load (std::memory_order_acquire) || is_paused ())
+        {
+          aborted = true;
+          break;
+        }
+
+      if (node->rendered_ahead_boundary_)
+        {
+          node->get_processable ().render_ahead_into_slot (slot_idx, time_nfo);
+        }
+      else
+        {
+          node->process_ahead (time_nfo, transport);
+        }
+    }
+  owner_.store (Owner::None, std::memory_order_release);
+
+  if (aborted || generation != generation_.load (std::memory_order_acquire))
+    {
+      has_render_pos_ = false;
+      return false;
+    }
+
+  slots_[slot_idx] =
+    Slot{ .start_frame_ = start_frame, .generation_ = generation };
+  write_idx_.store (write + 1, std::memory_order_release);
+  transport_.position_add_frames (render_pos_, block_length_);
+  return true;
+}
+
+AnticipativeRenderer::~AnticipativeRenderer ()
+{
+  stop_thread ();
+}
+
+} // namespace zrythm::dsp
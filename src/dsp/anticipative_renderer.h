@@ -0,0 +1,330 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include "dsp/itransport.h"
+#include "utils/rt_thread_id.h"
+#include "utils/types.h"
+
+namespace zrythm::dsp
+{
+
+class GraphNode;
+class GraphNodeCollection;
+class IProcessable;
+
+/**
+ * @brief Renders the parts of the graph that don't depend on live input ahead
+ * of the playhead on a low-priority thread.
+ *
+ * Tracks that only play back the timeline (no recording, monitoring or live
+ * MIDI) produce the same output no matter when they are processed, so they
+ * can be rendered a few blocks early on otherwise idle cores, leaving only the
+ * live part of the graph for the realtime threads.
+ *
+ * The rendered ahead part of the graph is the largest set of nodes that can
+ * render ahead (see IProcessable::can_render_ahead()) and whose parents are
+ * all rendered ahead (the initial processor aside). The nodes of that set that
+ * feed other nodes are its boundary: they render their output into slots that
+ * the realtime threads restore when the playhead gets there, and the other
+ * nodes of the set are skipped by the realtime threads.
+ *
+ * When the slot for a cycle is missing (after seeking, a tempo change, an
+ * invalidation, or when rendering ahead falls behind), the realtime threads
+ * take over the nodes and process them live for that cycle, and the renderer
+ * restarts from the next cycle.
+ *
+ * Anything that changes what the timeline renders to (regions, automation,
+ * parameters) must call invalidate().
+ */
+class AnticipativeRenderer
+{
+public:
+  static constexpr size_t DEFAULT_NUM_BLOCKS = 4;
+
+  /**
+   * @brief Longest the realtime thread waits for the renderer to give up the
+   * nodes on a miss before outputting silence for the cycle.
+   *
+   * The renderer checks for such requests between nodes, so this is only hit
+   * if the rendering thread gets preempted.
+   */
+  static constexpr auto MAX_TAKEOVER_WAIT = std::chrono::microseconds (200);
+
+  /**
+   * @param transport The transport of the graph.
+   * @param block_length The length of the blocks to render. Cycles of other
+   * lengths are processed live.
+   * @param num_blocks Number of blocks that can be rendered ahead.
+   */
+  AnticipativeRenderer (
+    const ITransport &transport,
+    nframes_t         block_length,
+    size_t            num_blocks = DEFAULT_NUM_BLOCKS);
+  ~AnticipativeRenderer ();
+  Z_DISABLE_COPY_MOVE (AnticipativeRenderer);
+
+  /**
+   * @brief Takes the nodes of @p nodes that can be rendered ahead.
+   *
+   * Releases the previously assigned nodes first.
+   *
+   * @note Must be called while paused (or before the thread is started) and
+   * while not processing.
+   */
+  void assign_nodes (GraphNodeCollection &nodes);
+
+  /**
+   * @brief Gives the assigned nodes back to the realtime threads.
+   *
+   * @note Same requirements as assign_nodes().
+   */
+  void release_nodes ();
+
+  size_t get_num_assigned_nodes () const { return nodes_.size (); }
+
+  size_t get_num_boundary_nodes () const { return num_boundary_nodes_; }
+
+  nframes_t get_block_length () const { return block_length_; }
+
+  /**
+   * @brief Changes the block length, releasing the assigned nodes.
+   *
+   * @note Same requirements as assign_nodes().
+   */
+  void set_block_length (nframes_t block_length);
+
+  /**
+   * @brief Starts the low-priority rendering thread.
+   *
+   * @throw ZrythmException on failure.
+   */
+  void start_thread ();
+
+  void stop_thread ();
+
+  /**
+   * @brief Stops rendering ahead and waits until the rendering thread is no
+   * longer processing any node.
+   *
+   * Must be called before modifying anything the assigned nodes use while
+   * the realtime threads are stopped. Can be nested.
+   */
+  void pause ();
+
+  /**
+   * @brief Resumes rendering ahead after pause().
+   *
+   * Everything rendered before pausing is discarded.
+   */
+  void resume ();
+
+  bool is_paused () const
+  {
+    return pause_count_.load (std::memory_order_acquire) > 0;
+  }
+
+  /**
+   * @brief Discards everything rendered so far.
+   *
+   * Realtime-safe. Can be called from any thread.
+   */
+  void invalidate () { generation_.fetch_add (1, std::memory_order_acq_rel); }
+
+  /**
+   * @brief Decides how the assigned nodes are handled in this cycle.
+   *
+   * Called by the realtime thread before processing the graph.
+   */
+  [[gnu::hot]] void begin_cycle (
+    const EngineProcessTimeInfo &time_nfo,
+    nframes_t                    remaining_preroll_frames);
+
+  /**
+   * @brief Called by the realtime thread after processing the graph.
+   */
+  [[gnu::hot]] void end_cycle ();
+
+  /**
+   * @brief Handles an assigned node on the realtime threads.
+   *
+   * @param processable The processable of the node.
+   * @param is_boundary Whether the node is a boundary node.
+   * @return Whether the node was handled (skipped or restored from a slot)
+   * and must not be processed.
+   */
+  [[gnu::hot]] bool handle_node (
+    IProcessable                &processable,
+    bool                         is_boundary,
+    const EngineProcessTimeInfo &time_nfo);
+
+  /**
+   * @brief Renders the next block ahead, if possible.
+   *
+   * Called repeatedly by the rendering thread.
+   *
+   * @return Whether a block was rendered.
+   */
+  bool render_next_block ();
+
+  /**
+   * @brief Returns whether the given thread is the rendering thread.
+   */
+  bool is_render_thread (RTThreadId::IdType thread_id) const
+  {
+    return render_thread_ != nullptr
+           && render_thread_id_.load (std::memory_order_relaxed) == thread_id;
+  }
+
+  /**
+   * @brief Number of cycles whose assigned nodes were restored from slots.
+   */
+  uint64_t get_num_rendered_ahead_cycles () const
+  {
+    return num_rendered_ahead_cycles_.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Number of cycles whose assigned nodes were processed live (or
+   * silenced) because no slot was ready.
+   */
+  uint64_t get_num_live_cycles () const
+  {
+    return num_live_cycles_.load (std::memory_order_relaxed);
+  }
+
+private:
+  class RenderThread;
+
+  enum class Owner
+  {
+    /** Nobody is processing the assigned nodes. */
+    None,
+    RenderThread,
+    Realtime,
+  };
+
+  enum class CycleMode
+  {
+    /** No nodes are assigned. */
+    Inactive,
+
+    /** The boundary nodes are restored from a slot. */
+    RestoreFromSlot,
+
+    /** The assigned nodes are processed live. */
+    Live,
+
+    /**
+     * The rendering thread didn't give up the nodes in time, so they are
+     * skipped, leaving the boundary buffers silent.
+     */
+    Silence,
+  };
+
+  struct Slot
+  {
+    /** Global start frame of the block. */
+    signed_frame_t start_frame_ = 0;
+
+    /** Value of @ref generation_ when the block was rendered. */
+    uint64_t generation_ = 0;
+  };
+
+  /**
+   * @brief Tries to take @ref owner_ for the realtime thread, asking the
+   * rendering thread to stop.
+   */
+  bool take_over_nodes ();
+
+  void clear_interior_buffers () const;
+
+  /**
+   * @brief Publishes the playhead of the next cycle for the rendering thread
+   * to continue from.
+   */
+  void publish_next_playhead (const Position &playhead, nframes_t nframes);
+
+  /**
+   * @brief Reads the position published by publish_next_playhead(), if a new
+   * one was published in the given generation.
+   */
+  bool consume_next_playhead (Position &pos, uint64_t generation);
+
+private:
+  const ITransport &transport_;
+
+  /** Assigned nodes in topological order. */
+  std::vector<GraphNode *> nodes_;
+
+  size_t num_boundary_nodes_ = 0;
+
+  nframes_t block_length_;
+
+  /** Ring of rendered blocks. */
+  std::vector<Slot> slots_;
+
+  /** Number of blocks rendered (only written to by the rendering thread). */
+  std::atomic<uint64_t> write_idx_ = 0;
+
+  /** Number of blocks consumed (only written to by the realtime thread). */
+  std::atomic<uint64_t> read_idx_ = 0;
+
+  /** Incremented on each invalidation. */
+  std::atomic<uint64_t> generation_ = 0;
+
+  /** Who is currently processing the assigned nodes. */
+  std::atomic<Owner> owner_ = Owner::None;
+
+  /** Set by the realtime thread when it needs the assigned nodes. */
+  std::atomic<bool> takeover_requested_ = false;
+
+  /** Number of pause() calls not matched by resume() yet. */
+  std::atomic<int> pause_count_ = 0;
+
+  /* --- realtime thread state --- */
+
+  CycleMode cycle_mode_ = CycleMode::Inactive;
+
+  /** Slot restored in this cycle. */
+  size_t current_slot_ = 0;
+
+  /**
+   * Cycle start time of the last cycle, used as the cycle start time of the
+   * blocks rendered ahead.
+   */
+  std::atomic<RtTimePoint> last_cycle_start_time_usecs_ = 0;
+
+  /* --- next playhead published by the realtime thread (seqlock) --- */
+
+  std::atomic<uint32_t>       next_playhead_seq_ = 0;
+  std::atomic<signed_frame_t> next_playhead_frames_ = 0;
+  std::atomic<double>         next_playhead_ticks_ = 0.0;
+  std::atomic<uint64_t>       next_playhead_generation_ = 0;
+
+  /* --- rendering thread state --- */
+
+  /** Last value of @ref next_playhead_seq_ read. */
+  uint32_t consumed_playhead_seq_ = 0;
+
+  /** Start of the next block to render (if @ref has_render_pos_). */
+  Position render_pos_;
+  bool     has_render_pos_ = false;
+
+  /** Generation @ref render_pos_ belongs to. */
+  uint64_t render_generation_ = 0;
+
+  std::unique_ptr<RenderThread>   render_thread_;
+  std::atomic<RTThreadId::IdType> render_thread_id_{};
+
+  std::atomic<uint64_t> num_rendered_ahead_cycles_ = 0;
+  std::atomic<uint64_t> num_live_cycles_ = 0;
+};
+
+} // namespace zrythm::dsp
@@ -0,0 +1,211 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cstring>
+
+#include "dsp/audio_range_patch.h"
+#include "utils/base64.h"
+#include "utils/compression.h"
+#include "utils/exceptions.h"
+
+#include <fmt/format.h>
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+constexpr size_t SAMPLE_SIZE = sizeof (float);
+
+/**
+ * Whether the samples of all channels are bitwise equal at @p frame (so that
+ * NaNs and signed zeros count as changes too).
+ */
+bool
+frame_equals (
+  const utils::audio::AudioBuffer &a,
+  const utils::audio::AudioBuffer &b,
+  int                              frame)
+{
+  for (int ch = 0; ch < a.getNumChannels (); ++ch)
+    {
+      if (
+        std::memcmp (
+          a.getReadPointer (ch, frame), b.getReadPointer (ch, frame),
+          SAMPLE_SIZE)
+        != 0)
+        return false;
+    }
+  return true;
+}
+
+/**
+ * Compresses @p num_frames frames of @p frames starting at @p start.
+ *
+ * The bytes of the samples are split into planes (all the first bytes, then
+ * all the second bytes, etc.) since neighbouring samples mostly share their
+ * sign and exponent bytes, which zstd then compresses much better than
+ * interleaved floats.
+ */
+std::string
+encode (const utils::audio::AudioBuffer &frames, int start, int num_frames)
+{
+  const auto  num_samples = static_cast<size_t> (num_frames);
+  std::string planes (
+    static_cast<size_t> (frames.getNumChannels ()) * num_samples * SAMPLE_SIZE,
+    '\0');
+  for (int ch = 0; ch < frames.getNumChannels (); ++ch)
+    {
+      const auto * src = reinterpret_cast<const unsigned char *> (
+        frames.getReadPointer (ch, start));
+      auto * dest = planes.data ()
+                    + static_cast<size_t> (ch) * num_samples * SAMPLE_SIZE;
+      for (size_t i = 0; i < num_samples; ++i)
+        {
+          for (size_t byte = 0; byte < SAMPLE_SIZE; ++byte)
+            {
+              dest[byte * num_samples + i] =
+                static_cast<char> (src[i * SAMPLE_SIZE + byte]);
+            }
+        }
+    }
+  return utils::compression::compress (planes);
+}
+
+/** Reverses encode() into @p frames, starting at @p start. */
+void
+decode (
+  std::string_view           data,
+  utils::audio::AudioBuffer &frames,
+  int                        start,
+  int                        num_frames)
+{
+  const auto planes = utils::compression::decompress (data);
+  const auto num_samples = static_cast<size_t> (num_frames);
+  if (
+    planes.size ()
+    != static_cast<size_t> (frames.getNumChannels ()) * num_samples
+         * SAMPLE_SIZE)
+    {
+      throw ZrythmException (fmt::format (
+        "Audio range patch has {} bytes, expected {} channels of {} frames",
+        planes.size (), frames.getNumChannels (), num_frames));
+    }
+
+  for (int ch = 0; ch < frames.getNumChannels (); ++ch)
+    {
+      auto * dest = reinterpret_cast<unsigned char *> (
+        frames.getWritePointer (ch, start));
+      const auto * src = planes.data ()
+                         + static_cast<size_t> (ch) * num_samples * SAMPLE_SIZE;
+      for (size_t i = 0; i < num_samples; ++i)
+        {
+          for (size_t byte = 0; byte < SAMPLE_SIZE; ++byte)
+            {
+              dest[i * SAMPLE_SIZE + byte] =
+                static_cast<unsigned char> (src[byte * num_samples + i]);
+            }
+        }
+    }
+}
+
+} // namespace
+
+AudioRangePatch::AudioRangePatch (
+  const utils::audio::AudioBuffer &before,
+  const utils::audio::AudioBuffer &after,
+  unsigned_frame_t                 start_frame)
+    : num_channels_ (before.getNumChannels ())
+{
+  if (
+    before.getNumChannels () != after.getNumChannels ()
+    || before.getNumSamples () != after.getNumSamples ())
+    {
+      throw ZrythmException (fmt::format (
+        "Audio range patch: buffer sizes differ ({}x{} vs {}x{})",
+        before.getNumChannels (), before.getNumSamples (),
+        after.getNumChannels (), after.getNumSamples ()));
+    }
+
+  /* only keep the frames that changed */
+  int first = 0;
+  int last = before.getNumSamples ();
+  while (first < last && frame_equals (before, after, first))
+    ++first;
+  while (last > first && frame_equals (before, after, last - 1))
+    --last;
+
+  start_frame_ = start_frame + static_cast<unsigned_frame_t> (first);
+  num_frames_ = static_cast<unsigned_frame_t> (last - first);
+  if (num_frames_ == 0)
+    return;
+
+  before_ = encode (before, first, last - first);
+  after_ = encode (after, first, last - first);
+}
+
+utils::audio::AudioBuffer
+AudioRangePatch::get_frames (bool after) const
+{
+  utils::audio::AudioBuffer ret (num_channels_, static_cast<int> (num_frames_));
+  if (num_frames_ > 0)
+    {
+      decode (after ? after_ : before_, ret, 0, static_cast<int> (num_frames_));
+    }
+  return ret;
+}
+
+void
+AudioRangePatch::apply (utils::audio::AudioBuffer &frames, bool after) const
+{
+  if (num_frames_ == 0)
+    return;
+
+  if (
+    frames.getNumChannels () != num_channels_
+    || start_frame_ + num_frames_
+         > static_cast<unsigned_frame_t> (frames.getNumSamples ()))
+    {
+      throw ZrythmException (fmt::format (
+        "Audio range patch ({} channels, frames {} to {}) doesn't fit in a "
+        "buffer of {} channels and {} frames",
+        num_channels_, start_frame_, start_frame_ + num_frames_,
+        frames.getNumChannels (), frames.getNumSamples ()));
+    }
+
+  decode (
+    after ? after_ : before_, frames, static_cast<int> (start_frame_),
+    static_cast<int> (num_frames_));
+}
+
+void
+AudioRangePatch::define_fields (const Context &ctx)
+{
+  /* the compressed data is binary, so it's stored as base64 */
+  const auto to_base64 = [] (const std::string &data) {
+    return utils::base64::encode (
+             QByteArray (data.data (), static_cast<qsizetype> (data.size ())))
+      .toStdString ();
+  };
+  std::string before_b64 = ctx.is_serializing () ? to_base64 (before_) : "";
+  std::string after_b64 = ctx.is_serializing () ? to_base64 (after_) : "";
+
+  using T = ISerializable<AudioRangePatch>;
+  T::serialize_fields (
+    ctx, T::make_field ("startFrame", start_frame_),
+    T::make_field ("numFrames", num_frames_),
+    T::make_field ("numChannels", num_channels_),
+    T::make_field ("before", before_b64), T::make_field ("after", after_b64));
+
+  if (!ctx.is_serializing ())
+    {
+      before_ =
+        utils::base64::decode (QByteArray::fromStdString (before_b64))
+          .toStdString ();
+      after_ = utils::base64::decode (QByteArray::fromStdString (after_b64))
+                 .toStdString ();
+    }
+}
+
+} // namespace zrythm::dsp
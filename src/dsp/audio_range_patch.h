@@ -0,0 +1,91 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <string>
+
+#include "utils/audio.h"
+#include "utils/iserializable.h"
+#include "utils/types.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief The frames of an audio clip before and after a destructive edit,
+ * limited to the range the edit actually changed.
+ *
+ * Used as undo data so that, e.g., a short fade applied to a long recording
+ * only stores the faded frames instead of copies of the whole clip.
+ *
+ * The frames are compressed losslessly (byte planes of the samples, then
+ * zstd at a fast level).
+ */
+class AudioRangePatch final
+    : public zrythm::utils::serialization::ISerializable<AudioRangePatch>
+{
+public:
+  AudioRangePatch () = default;
+
+  /**
+   * @brief Creates a patch from the frames of a range before and after an
+   * edit.
+   *
+   * Unchanged frames at the start and end of the range are left out.
+   *
+   * @param before Frames before the edit.
+   * @param after Frames after the edit (same size as @p before).
+   * @param start_frame Position of the range in the clip.
+   * @throw ZrythmException If the buffers differ in size or compression
+   * fails.
+   */
+  AudioRangePatch (
+    const utils::audio::AudioBuffer &before,
+    const utils::audio::AudioBuffer &after,
+    unsigned_frame_t                 start_frame);
+
+  /** Whether the edit didn't change anything. */
+  bool empty () const { return num_frames_ == 0; }
+
+  unsigned_frame_t get_start_frame () const { return start_frame_; }
+  unsigned_frame_t get_num_frames () const { return num_frames_; }
+  int              get_num_channels () const { return num_channels_; }
+
+  /**
+   * @brief Returns the changed frames before (@p after false) or after the
+   * edit.
+   *
+   * @throw ZrythmException If the data is corrupt.
+   */
+  utils::audio::AudioBuffer get_frames (bool after) const;
+
+  /**
+   * @brief Writes the changed frames before (@p after false) or after the
+   * edit into @p frames (the clip's frames).
+   *
+   * @throw ZrythmException If @p frames doesn't match or the data is corrupt.
+   */
+  void apply (utils::audio::AudioBuffer &frames, bool after) const;
+
+  /** Number of bytes used by the compressed frames. */
+  size_t get_compressed_size () const
+  {
+    return before_.size () + after_.size ();
+  }
+
+  DECLARE_DEFINE_FIELDS_METHOD ();
+
+private:
+  unsigned_frame_t start_frame_ = 0;
+  unsigned_frame_t num_frames_ = 0;
+  int              num_channels_ = 0;
+
+  /** Compressed frames before the edit. */
+  std::string before_;
+
+  /** Compressed frames after the edit. */
+  std::string after_;
+};
+
+} // namespace zrythm::dsp
@@ -0,0 +1,308 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <thread>
+
+#include "dsp/audio_stream_cache.h"
+#include "utils/dsp.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+namespace zrythm::dsp
+{
+
+AudioStreamCache::AudioStreamCache (
+  int              num_channels,
+  unsigned_frame_t num_frames,
+  ReadFunc         read_func,
+  size_t           num_pages)
+    : num_channels_ (num_channels), num_frames_ (num_frames),
+      num_source_pages_ (
+        static_cast<int64_t> ((num_frames + PAGE_SIZE - 1) / PAGE_SIZE)),
+      read_func_ (std::move (read_func))
+{
+  for (size_t i = 0; i < num_pages; i++)
+    {
+      auto slot = std::make_unique<Slot> ();
+      slot->frames_.setSize (num_channels_, static_cast<int> (PAGE_SIZE));
+      slots_.push_back (std::move (slot));
+    }
+  for (auto &hint : hints_)
+    {
+      hint.store (-1, std::memory_order_relaxed);
+    }
+}
+
+void
+AudioStreamCache::add_hint (unsigned_frame_t frame)
+{
+  const auto idx = next_hint_.fetch_add (1, std::memory_order_relaxed);
+  hints_[idx % NUM_HINTS].store (
+    static_cast<int64_t> (frame), std::memory_order_relaxed);
+}
+
+bool
+AudioStreamCache::read_from_page (
+  int64_t          page,
+  unsigned_frame_t offset_in_page,
+  float * const *  dest,
+  int              num_dest_channels,
+  unsigned_frame_t dest_offset,
+  unsigned_frame_t num_frames)
+{
+  for (auto &slot : slots_)
+    {
+      if (slot->page_.load (std::memory_order_relaxed) != page)
+        continue;
+
+      /* register as a reader before checking again, so that the prefetcher
+       * either sees us or we see it replacing the page */
+      slot->readers_.fetch_add (1);
+      const bool valid = slot->page_.load () == page;
+      if (valid)
+        {
+          for (int ch = 0; ch < num_dest_channels; ch++)
+            {
+              const int src_ch = std::min (ch, num_channels_ - 1);
+              utils::float_ranges::copy (
+                &dest[ch][dest_offset],
+                slot->frames_.getReadPointer (
+                  src_ch, static_cast<int> (offset_in_page)),
+                num_frames);
+            }
+          slot->last_used_.store (
+            access_counter_.fetch_add (1, std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+        }
+      slot->readers_.fetch_sub (1);
+      if (valid)
+        return true;
+    }
+  return false;
+}
+
+bool
+AudioStreamCache::read (
+  unsigned_frame_t start_frame,
+  float * const *  dest,
+  int              num_dest_channels,
+  unsigned_frame_t num_frames)
+{
+  add_hint (start_frame);
+
+  bool             complete = true;
+  unsigned_frame_t offset = 0;
+  while (offset < num_frames)
+    {
+      const unsigned_frame_t frame = start_frame + offset;
+      const unsigned_frame_t offset_in_page = frame % PAGE_SIZE;
+      const unsigned_frame_t len =
+        std::min (num_frames - offset, PAGE_SIZE - offset_in_page);
+      const unsigned_frame_t len_in_source =
+        frame < num_frames_ ? std::min (len, num_frames_ - frame) : 0;
+
+      if (
+        len_in_source > 0
+        && !read_from_page (
+          static_cast<int64_t> (frame / PAGE_SIZE), offset_in_page, dest,
+          num_dest_channels, offset, len_in_source))
+        {
+          complete = false;
+          for (int ch = 0; ch < num_dest_channels; ch++)
+            {
+              utils::float_ranges::fill (
+                &dest[ch][offset], 0.f, len_in_source);
+            }
+        }
+      if (len_in_source < len)
+        {
+          for (int ch = 0; ch < num_dest_channels; ch++)
+            {
+              utils::float_ranges::fill (
+                &dest[ch][offset + len_in_source], 0.f, len - len_in_source);
+            }
+        }
+      offset += len;
+    }
+
+  if (!complete)
+    {
+      num_underruns_.fetch_add (1, std::memory_order_relaxed);
+    }
+  return complete;
+}
+
+std::vector<int64_t>
+AudioStreamCache::get_wanted_pages () const
+{
+  /* most recent positions first */
+  std::vector<int64_t> hinted_pages;
+  const auto           next_hint = next_hint_.load (std::memory_order_relaxed);
+  for (size_t i = 1; i <= NUM_HINTS; i++)
+    {
+      const auto hint =
+        hints_[(next_hint - i) % NUM_HINTS].load (std::memory_order_relaxed);
+      if (hint < 0)
+        continue;
+      const int64_t page = hint / static_cast<int64_t> (PAGE_SIZE);
+      if (
+        std::find (hinted_pages.begin (), hinted_pages.end (), page)
+        == hinted_pages.end ())
+        {
+          hinted_pages.push_back (page);
+        }
+    }
+
+  /* the hinted pages first, then the pages after them */
+  std::vector<int64_t> wanted_pages;
+  for (size_t ahead = 0; ahead <= READ_AHEAD_PAGES; ahead++)
+    {
+      for (const auto hinted_page : hinted_pages)
+        {
+          const int64_t page = hinted_page + static_cast<int64_t> (ahead);
+          if (
+            page < num_source_pages_
+            && std::find (wanted_pages.begin (), wanted_pages.end (), page)
+                 == wanted_pages.end ())
+            {
+              wanted_pages.push_back (page);
+              if (wanted_pages.size () == slots_.size ())
+                return wanted_pages;
+            }
+        }
+    }
+  return wanted_pages;
+}
+
+bool
+AudioStreamCache::load_page (Slot &slot, int64_t page)
+{
+  /* wait for any reader that saw the previous page */
+  slot.page_.store (LOADING_PAGE);
+  while (slot.readers_.load () > 0)
+    {
+      std::this_thread::yield ();
+    }
+
+  const auto start_frame = static_cast<unsigned_frame_t> (page) * PAGE_SIZE;
+  try
+    {
+      read_func_ (
+        slot.frames_, start_frame,
+        std::min (PAGE_SIZE, num_frames_ - start_frame));
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("Failed to read frames at {}: {}", start_frame, e.what ());
+      slot.page_.store (EMPTY_PAGE);
+      return false;
+    }
+  slot.last_used_.store (
+    access_counter_.load (std::memory_order_relaxed),
+    std::memory_order_relaxed);
+  slot.page_.store (page);
+  return true;
+}
+
+bool
+AudioStreamCache::prefetch ()
+{
+  const auto wanted_pages = get_wanted_pages ();
+  const auto is_wanted = [&] (int64_t page) {
+    return std::find (wanted_pages.begin (), wanted_pages.end (), page)
+           != wanted_pages.end ();
+  };
+
+  bool loaded = false;
+  for (const auto page : wanted_pages)
+    {
+      const bool cached =
+        std::ranges::any_of (slots_, [page] (const auto &slot) {
+          return slot->page_.load (std::memory_order_relaxed) == page;
+        });
+      if (cached)
+        continue;
+
+      /* use an empty slot, or else the least recently used unwanted one */
+      Slot * victim = nullptr;
+      for (auto &slot : slots_)
+        {
+          const auto slot_page = slot->page_.load (std::memory_order_relaxed);
+          if (slot_page == EMPTY_PAGE)
+            {
+              victim = slot.get ();
+              break;
+            }
+          if (is_wanted (slot_page))
+            continue;
+          const auto last_used =
+            slot->last_used_.load (std::memory_order_relaxed);
+          if (
+            victim == nullptr
+            || last_used < victim->last_used_.load (std::memory_order_relaxed))
+            {
+              victim = slot.get ();
+            }
+        }
+      if (victim == nullptr)
+        break;
+
+      loaded = load_page (*victim, page) || loaded;
+    }
+  return loaded;
+}
+
+AudioStreamPrefetcher::AudioStreamPrefetcher ()
+    : juce::Thread ("AudioStreamPrefetcher")
+{
+}
+
+AudioStreamPrefetcher::~AudioStreamPrefetcher ()
+{
+  stopThread (-1);
+}
+
+void
+AudioStreamPrefetcher::add_cache (std::shared_ptr<AudioStreamCache> cache)
+{
+  std::lock_guard lock (caches_mutex_);
+  caches_.push_back (std::move (cache));
+  if (!isThreadRunning ())
+    {
+      startThread (juce::Thread::Priority::high);
+    }
+}
+
+void
+AudioStreamPrefetcher::run ()
+{
+  std::vector<std::shared_ptr<AudioStreamCache>> caches;
+  while (!threadShouldExit ())
+    {
+      {
+        std::lock_guard lock (caches_mutex_);
+
+        /* drop caches not used by any clip anymore */
+        std::erase_if (caches_, [] (const auto &cache) {
+          return cache.use_count () == 1;
+        });
+        caches = caches_;
+      }
+
+      bool loaded = false;
+      for (const auto &cache : caches)
+        {
+          loaded = cache->prefetch () || loaded;
+        }
+      caches.clear ();
+
+      /* keep going while catching up */
+      if (!loaded)
+        {
+          wait (UPDATE_INTERVAL_MS);
+        }
+    }
+}
+
+} // namespace zrythm::dsp
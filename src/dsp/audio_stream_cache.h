@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "utils/audio.h"
+#include "utils/types.h"
+
+#include "juce_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Keeps windows ("pages") of a long audio source in memory so that it
+ * can be played back without loading all of it.
+ *
+ * The realtime thread reads with read() and never blocks: frames that are not
+ * cached yet are returned as silence. Pages are loaded by prefetch() on a
+ * non-realtime thread (see AudioStreamPrefetcher), starting from the positions
+ * recently read or hinted with add_hint() (e.g., loop and cue points), and
+ * reading ahead of them.
+ */
+class AudioStreamCache
+{
+public:
+  /**
+   * @brief Reads @p num_frames frames of the source starting at
+   * @p start_frame to the start of @p dest.
+   *
+   * Only called from prefetch().
+   *
+   * @throw ZrythmException on error.
+   */
+  using ReadFunc = std::function<void (
+    utils::audio::AudioBuffer &dest,
+    unsigned_frame_t           start_frame,
+    unsigned_frame_t           num_frames)>;
+
+  /** Frames per page. */
+  static constexpr unsigned_frame_t PAGE_SIZE = 32768;
+
+  static constexpr size_t DEFAULT_NUM_PAGES = 32;
+
+  /** Pages loaded after the page of each position read or hinted. */
+  static constexpr size_t READ_AHEAD_PAGES = 4;
+
+  /** Number of recent positions considered by prefetch(). */
+  static constexpr size_t NUM_HINTS = 64;
+
+  /**
+   * @param num_pages Number of pages to keep in memory. Should be large
+   * enough to hold the read-ahead of all positions of interest.
+   */
+  AudioStreamCache (
+    int              num_channels,
+    unsigned_frame_t num_frames,
+    ReadFunc         read_func,
+    size_t           num_pages = DEFAULT_NUM_PAGES);
+
+  int              get_num_channels () const { return num_channels_; }
+  unsigned_frame_t get_num_frames () const { return num_frames_; }
+
+  /**
+   * @brief Copies @p num_frames frames starting at @p start_frame to
+   * @p dest.
+   *
+   * If @p num_dest_channels is larger than the number of channels, the last
+   * channel is repeated (e.g., mono to stereo). Frames that are not cached
+   * (or are past the end) are filled with silence.
+   *
+   * Realtime-safe.
+   *
+   * @return Whether all frames were cached.
+   */
+  bool read (
+    unsigned_frame_t start_frame,
+    float * const *  dest,
+    int              num_dest_channels,
+    unsigned_frame_t num_frames);
+
+  /**
+   * @brief Marks @p frame as a position that will likely be read soon.
+   *
+   * Realtime-safe.
+   */
+  void add_hint (unsigned_frame_t frame);
+
+  /**
+   * @brief Loads the pages needed for the recent positions.
+   *
+   * Must only be called from one (non-realtime) thread at a time.
+   *
+   * @return Whether any page was loaded.
+   */
+  bool prefetch ();
+
+  /**
+   * @brief Number of read() calls that found missing frames so far.
+   */
+  size_t get_num_underruns () const
+  {
+    return num_underruns_.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the number of bytes used by the pages kept in memory.
+   */
+  size_t get_memory_usage () const
+  {
+    return slots_.size () * static_cast<size_t> (num_channels_) * PAGE_SIZE
+           * sizeof (float);
+  }
+
+private:
+  static constexpr int64_t EMPTY_PAGE = -1;
+  static constexpr int64_t LOADING_PAGE = -2;
+
+  struct Slot
+  {
+    utils::audio::AudioBuffer frames_;
+
+    /** Index of the source page in this slot, or EMPTY_PAGE/LOADING_PAGE. */
+    std::atomic<int64_t> page_{ EMPTY_PAGE };
+
+    /** Number of realtime readers currently using this slot. */
+    std::atomic<int> readers_{ 0 };
+
+    /** Value of @ref access_counter_ when this slot was last read. */
+    std::atomic<uint64_t> last_used_{ 0 };
+  };
+
+  /**
+   * @brief Copies one page's worth of frames from the slot holding
+   * @p page, if any.
+   */
+  bool read_from_page (
+    int64_t          page,
+    unsigned_frame_t offset_in_page,
+    float * const *  dest,
+    int              num_dest_channels,
+    unsigned_frame_t dest_offset,
+    unsigned_frame_t num_frames);
+
+  /**
+   * @brief Returns the pages to keep in memory, most important first.
+   */
+  std::vector<int64_t> get_wanted_pages () const;
+
+  /**
+   * @brief Replaces the contents of @p slot with @p page.
+   *
+   * @return Whether the page was read successfully.
+   */
+  bool load_page (Slot &slot, int64_t page);
+
+private:
+  int              num_channels_;
+  unsigned_frame_t num_frames_;
+  int64_t          num_source_pages_;
+  ReadFunc         read_func_;
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+
+  /** Ring of recent positions (or -1). */
+  std::array<std::atomic<int64_t>, NUM_HINTS> hints_;
+  std::atomic<size_t>                         next_hint_{ 0 };
+
+  std::atomic<uint64_t> access_counter_{ 0 };
+  std::atomic<size_t>   num_underruns_{ 0 };
+};
+
+/**
+ * @brief Thread that calls AudioStreamCache::prefetch() on all registered
+ * caches until they are no longer used elsewhere.
+ */
+class AudioStreamPrefetcher final : public juce::Thread
+{
+public:
+  /** Interval between prefetch passes when nothing was loaded. */
+  static constexpr int UPDATE_INTERVAL_MS = 10;
+
+  AudioStreamPrefetcher ();
+  ~AudioStreamPrefetcher () override;
+
+  /**
+   * @brief Starts prefetching for @p cache (and starts the thread if
+   * needed).
+   */
+  void add_cache (std::shared_ptr<AudioStreamCache> cache);
+
+  void run () override;
+
+private:
+  std::mutex                                     caches_mutex_;
+  std::vector<std::shared_ptr<AudioStreamCache>> caches_;
+};
+
+} // namespace zrythm::dsp
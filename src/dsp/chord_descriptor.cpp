@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: © 2018-2021, 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <algorithm>
 #include <cstdlib>
 #include <cstring>
 
@@ -52,12 +53,18 @@ void
 ChordDescriptor::update_notes ()
 {
   if (type_ == ChordType::Custom)
-    return;
+    {
+      update_notes_mask ();
+      return;
+    }
 
   std::ranges::fill (notes_, false);
 
   if (type_ == ChordType::None)
-    return;
+    {
+      update_notes_mask ();
+      return;
+    }
 
   int root = ENUM_VALUE_TO_INT (root_note_);
   int bass = ENUM_VALUE_TO_INT (bass_note_);
@@ -154,6 +161,45 @@ ChordDescriptor::update_notes ()
     }
 
   invert_chord (notes_, inversion_);
+  update_notes_mask ();
+}
+
+void
+ChordDescriptor::update_notes_mask ()
+{
+  notes_mask_ = 0;
+  for (size_t i = 0; i < MAX_NOTES; i++)
+    {
+      if (notes_[i])
+        notes_mask_ |= static_cast<PitchClassMask> (1u << (i % 12));
+    }
+}
+
+KeyMask
+pitch_class_mask_to_key_mask (
+  PitchClassMask mask,
+  int            first_key,
+  int            num_keys)
+{
+  constexpr int num_midi_keys = 128;
+  first_key = std::clamp (first_key, 0, num_midi_keys);
+  num_keys = std::clamp (num_keys, 0, num_midi_keys - first_key);
+  if (num_keys == 0)
+    return {};
+
+  /* repeat the mask for each octave */
+  const KeyMask octave (mask & PITCH_CLASS_MASK_ALL);
+  KeyMask       keys;
+  for (int i = 0; i < num_midi_keys; i += 12)
+    {
+      keys |= octave << static_cast<size_t> (i);
+    }
+
+  KeyMask range;
+  range.set ();
+  range >>= static_cast<size_t> (num_midi_keys - num_keys);
+  range <<= static_cast<size_t> (first_key);
+  return keys & range;
 }
 
 static constexpr std::array<std::string_view, 8> chord_type_strings = {
@@ -194,33 +240,6 @@ ChordDescriptor::chord_accent_to_string (ChordAccent accent)
   return chord_accent_strings.at (ENUM_VALUE_TO_INT (accent));
 }
 
-bool
-ChordDescriptor::is_key_bass (MusicalNote key) const
-{
-  if (has_bass_)
-    {
-      return bass_note_ == key;
-    }
-
-  return root_note_ == key;
-}
-
-bool
-ChordDescriptor::is_key_in_chord (MusicalNote key) const
-{
-  if (is_key_bass (key))
-    {
-      return true;
-    }
-
-  for (size_t i = 0; i < MAX_NOTES; i++)
-    {
-      if (notes_[i] && i % 12 == static_cast<decltype (i)> (key))
-        return true;
-    }
-  return false;
-}
-
 void
 ChordDescriptor::define_fields (const Context &ctx)
 {
@@ -229,6 +248,10 @@ ChordDescriptor::define_fields (const Context &ctx)
     make_field ("bassNote", bass_note_), make_field ("type", type_),
     make_field ("accent", accent_), make_field ("notes", notes_),
     make_field ("inversion", inversion_));
+  if (ctx.is_deserializing ())
+    {
+      update_notes_mask ();
+    }
 }
 
 /**
@@ -4,6 +4,8 @@
 #ifndef ZRYTHM_DSP_CHORD_DESCRIPTOR_H
 #define ZRYTHM_DSP_CHORD_DESCRIPTOR_H
 
+#include <bitset>
+#include <cstdint>
 #include <string>
 
 #include "utils/iserializable.h"
@@ -27,6 +29,57 @@ enum class MusicalNote
   B
 };
 
+/**
+ * Set of pitch classes (bit N is set if the MusicalNote with value N is in the
+ * set).
+ */
+using PitchClassMask = uint16_t;
+
+/** All 12 pitch classes. */
+constexpr PitchClassMask PITCH_CLASS_MASK_ALL = 0xFFF;
+
+constexpr PitchClassMask
+pitch_class_mask_from_note (MusicalNote note)
+{
+  return static_cast<PitchClassMask> (1u << static_cast<unsigned> (note));
+}
+
+constexpr bool
+pitch_class_mask_contains (PitchClassMask mask, MusicalNote note)
+{
+  return (mask & pitch_class_mask_from_note (note)) != 0;
+}
+
+/**
+ * Returns @p mask transposed by @p semitones (wrapping around the octave).
+ */
+constexpr PitchClassMask
+pitch_class_mask_transpose (PitchClassMask mask, int semitones)
+{
+  const auto shift = static_cast<unsigned> (((semitones % 12) + 12) % 12);
+  const auto shifted = static_cast<unsigned> (mask) << shift;
+  return static_cast<PitchClassMask> (
+    (shifted | (shifted >> 12)) & PITCH_CLASS_MASK_ALL);
+}
+
+/**
+ * One bit per MIDI key (bit N is MIDI key N).
+ */
+using KeyMask = std::bitset<128>;
+
+/**
+ * Returns the keys in [@p first_key, @p first_key + @p num_keys) whose pitch
+ * class is in @p mask.
+ *
+ * Useful for highlighting all visible keys at once (e.g., in the piano roll)
+ * instead of querying each key separately.
+ */
+KeyMask
+pitch_class_mask_to_key_mask (
+  PitchClassMask mask,
+  int            first_key = 0,
+  int            num_keys = 128);
+
 /**
  * Chord type.
  */
@@ -136,14 +189,41 @@ public:
    *
    * @param key A note inside a single octave (0-11).
    */
-  bool is_key_in_chord (MusicalNote key) const;
+  bool is_key_in_chord (MusicalNote key) const
+  {
+    return pitch_class_mask_contains (get_pitch_class_mask (), key);
+  }
 
   /**
    * Returns if @ref key is the bass or root note of @ref chord.
    *
    * @param key A note inside a single octave (0-11).
    */
-  bool is_key_bass (MusicalNote key) const;
+  bool is_key_bass (MusicalNote key) const
+  {
+    return has_bass_ ? bass_note_ == key : root_note_ == key;
+  }
+
+  /**
+   * Returns the pitch classes of @ref notes_.
+   */
+  PitchClassMask get_notes_pitch_class_mask () const { return notes_mask_; }
+
+  /**
+   * Returns the pitch classes for which is_key_in_chord() returns true.
+   */
+  PitchClassMask get_pitch_class_mask () const
+  {
+    return notes_mask_ | get_bass_pitch_class_mask ();
+  }
+
+  /**
+   * Returns the pitch class for which is_key_bass() returns true.
+   */
+  PitchClassMask get_bass_pitch_class_mask () const
+  {
+    return pitch_class_mask_from_note (has_bass_ ? bass_note_ : root_note_);
+  }
 
   /**
    * Returns the chord type as a string (eg. "aug").
@@ -168,11 +248,19 @@ public:
   /**
    * Updates the notes array based on the current
    * settings.
+   *
+   * Must also be called after editing @ref notes_ of a custom chord.
    */
   void update_notes ();
 
   DECLARE_DEFINE_FIELDS_METHOD ();
 
+private:
+  /**
+   * Updates @ref notes_mask_ from @ref notes_.
+   */
+  void update_notes_mask ();
+
 public:
   /** Has bass note or not. */
   bool has_bass_ = false;
@@ -209,6 +297,10 @@ public:
    * greater than 0 lowest note(s) receive an octave.
    */
   int inversion_ = 0;
+
+private:
+  /** Pitch classes of @ref notes_ (cached by update_notes()). */
+  PitchClassMask notes_mask_ = 0;
 };
 
 inline bool
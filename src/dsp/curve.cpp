@@ -27,6 +27,7 @@
  * ---
  */
 
+#include <algorithm>
 #include <cmath>
 
 #include "dsp/curve.h"
@@ -42,95 +43,160 @@ CurveOptions::CurveOptions (double curviness, Algorithm algo)
 {
 }
 
-double
-CurveOptions::get_normalized_y (double x, bool start_higher) const
+namespace
 {
-  z_return_val_if_fail_cmp (x, >=, 0.0, 0.0);
-  z_return_val_if_fail_cmp (x, <=, 1.0, 0.0);
 
-  int curve_up = curviness_ >= 0;
+/**
+ * @brief CurveOptions::get_normalized_y() split into the constants of a curve
+ * (computed once) and the evaluation at each X.
+ */
+class CurveEvaluator
+{
+public:
+  /** Curve formula, after resolving the options. */
+  enum class Kind
+  {
+    Linear,
+    Exponent,
+    SuperEllipse,
+    Vital,
+    Pulse,
+    LogarithmicPrecise,
+    LogarithmicFast,
+  };
 
-  double val = -1.0;
-  switch (algo_)
-    {
-    case CurveOptions::Algorithm::Exponent:
-      {
-        /* convert curviness to bound */
-        double curviness_for_calc = curviness_ * EXPONENT_CURVINESS_BOUND;
+  CurveEvaluator (const CurveOptions &opts, bool start_higher);
 
-        curviness_for_calc = 1.0 - fabs (curviness_for_calc);
-        if (!start_higher)
-          x = 1.0 - x;
-        if (curve_up)
-          x = 1.0 - x;
+  Kind get_kind () const { return kind_; }
 
-        /* if curviness is 0, it is a straight line */
-        if (utils::math::floats_equal (curviness_for_calc, 0.0000))
-          {
-            val = x;
-          }
-        else
-          {
-            val = pow (x, curviness_for_calc);
-          }
+  template <Kind K> [[gnu::always_inline]] double eval (double x) const
+  {
+    x = x_offset_ + x_scale_ * x;
 
-        if (!curve_up)
-          val = 1.0 - val;
+    double val;
+    if constexpr (K == Kind::Linear)
+      {
+        val = x;
       }
-      break;
+    else if constexpr (K == Kind::Exponent)
+      {
+        val = std::pow (x, n_);
+      }
+    else if constexpr (K == Kind::SuperEllipse)
+      {
+        val = std::pow (1.0 - std::pow (x, n_), inv_n_);
+      }
+    else if constexpr (K == Kind::Vital)
+      {
+        val = std::expm1 (n_ * x) * inv_n_;
+      }
+    else if constexpr (K == Kind::Pulse)
+      {
+        val = n_ > x ? 0.0 : 1.0;
+      }
+    else if constexpr (K == Kind::LogarithmicPrecise)
+      {
+        val = (double) ((logf ((float) x + log_n_) - log_a_) * log_b_);
+      }
+    else if constexpr (K == Kind::LogarithmicFast)
+      {
+        val =
+          (double) ((utils::math::fast_log ((float) x + log_n_) - log_a_)
+                    * log_b_);
+      }
+
+    return std::clamp (y_offset_ + y_scale_ * val, 0.0, 1.0);
+  }
+
+private:
+  /** Mirrors X (x = 1 - x) if @p mirror. */
+  void set_x_mirrored (bool mirror)
+  {
+    x_offset_ = mirror ? 1.0 : 0.0;
+    x_scale_ = mirror ? -1.0 : 1.0;
+  }
+
+  /** Mirrors Y (y = 1 - y) if @p mirror. */
+  void set_y_mirrored (bool mirror)
+  {
+    y_offset_ = mirror ? 1.0 : 0.0;
+    y_scale_ = mirror ? -1.0 : 1.0;
+  }
+
+private:
+  Kind kind_ = Kind::Linear;
+
+  double x_offset_ = 0.0;
+  double x_scale_ = 1.0;
+  double y_offset_ = 0.0;
+  double y_scale_ = 1.0;
+
+  /** Exponent, Vital coefficient or Pulse threshold. */
+  double n_ = 0.0;
+
+  /** 1 / exponent, or 1 / (e^n - 1) for Vital. */
+  double inv_n_ = 0.0;
+
+  /** Logarithmic constants. */
+  float log_n_ = 0.f;
+  float log_a_ = 0.f;
+  float log_b_ = 0.f;
+};
+
+CurveEvaluator::CurveEvaluator (const CurveOptions &opts, bool start_higher)
+{
+  const bool curve_up = opts.curviness_ >= 0;
+
+  switch (opts.algo_)
+    {
+    case CurveOptions::Algorithm::Exponent:
     case CurveOptions::Algorithm::SuperEllipse:
       {
-        /* convert curviness to bound */
-        double curviness_for_calc = curviness_ * SUPERELLIPSE_CURVINESS_BOUND;
+        const bool exponent = opts.algo_ == CurveOptions::Algorithm::Exponent;
 
-        curviness_for_calc = 1.0 - fabs (curviness_for_calc);
-        if (!start_higher)
-          x = 1.0 - x;
-        if (curve_up)
-          x = 1.0 - x;
+        /* convert curviness to bound */
+        const double bound =
+          exponent
+            ? CurveOptions::EXPONENT_CURVINESS_BOUND
+            : CurveOptions::SUPERELLIPSE_CURVINESS_BOUND;
+        n_ = 1.0 - fabs (opts.curviness_ * bound);
+        set_x_mirrored (!start_higher != curve_up);
+        set_y_mirrored (exponent ? !curve_up : curve_up);
 
         /* if curviness is 0, it is a straight line */
-        if (utils::math::floats_equal (curviness_for_calc, 0.0000))
+        if (utils::math::floats_equal (n_, 0.0000))
           {
-            val = x;
+            kind_ = Kind::Linear;
           }
         else
           {
-            val = pow (
-              1.0 - pow (x, curviness_for_calc), (1.0 / curviness_for_calc));
+            kind_ = exponent ? Kind::Exponent : Kind::SuperEllipse;
+            inv_n_ = 1.0 / n_;
           }
-
-        if (curve_up)
-          val = 1.0 - val;
       }
       break;
     case CurveOptions::Algorithm::Vital:
       {
         /* convert curviness to bound */
-        double curviness_for_calc = curviness_ * VITAL_CURVINESS_BOUND;
-
-        curviness_for_calc = -curviness_for_calc * 10.0;
-        if (start_higher)
-          x = 1.0 - x;
+        n_ = -opts.curviness_ * CurveOptions::VITAL_CURVINESS_BOUND * 10.0;
+        set_x_mirrored (start_higher);
 
         /* if curviness is 0, it is a straight line */
-        if (utils::math::floats_equal (curviness_for_calc, 0.0000))
+        if (utils::math::floats_equal (n_, 0.0000))
           {
-            val = x;
+            kind_ = Kind::Linear;
           }
         else
           {
-            val = expm1 (curviness_for_calc * x) / expm1 (curviness_for_calc);
+            kind_ = Kind::Vital;
+            inv_n_ = 1.0 / expm1 (n_);
           }
       }
       break;
     case CurveOptions::Algorithm::Pulse:
-      {
-        val = ((1.0 + curviness_) / 2.0) > x ? 0.0 : 1.0;
-
-        if (start_higher)
-          val = 1.0 - val;
-      }
+      kind_ = Kind::Pulse;
+      n_ = (1.0 + opts.curviness_) / 2.0;
+      set_y_mirrored (start_higher);
       break;
     case CurveOptions::Algorithm::Logarithmic:
       {
@@ -138,70 +204,186 @@ CurveOptions::get_normalized_y (double x, bool start_higher) const
         static const float bound = 1e-12f;
         float              s =
           std::clamp (
-            static_cast<float> (std::fabs (curviness_)), 0.01f, 1.f - bound)
+            static_cast<float> (std::fabs (opts.curviness_)), 0.01f,
+            1.f - bound)
           * 10.f;
-        float curviness_for_calc =
+        log_n_ =
           std::clamp ((10.f - s) / (std::pow<float> (s, s)), bound, 10.f);
 
-        if (!start_higher)
-          x = 1.0 - x;
-        if (curve_up)
-          x = 1.0 - x;
+        set_x_mirrored (!start_higher != curve_up);
 
-#if 0
-        z_info (
-          "curviness (z): {:f} (for calc {:f}), x {:f}",
-          curviness_,
-          (double) curviness_for_calc, x);
-#endif
+        /* tilting down is the mirrored tilting up curve:
+         * (a - log (x + n)) * b + 1 */
+        set_y_mirrored (!curve_up);
 
         /* if close to the center, use precise
          * log (fast_log doesn't handle that well) */
-        if (curviness_for_calc >= 0.02f)
+        if (log_n_ >= 0.02f)
           {
-            /* required vals */
-            const float a = logf (curviness_for_calc);
-            const float b = 1.f / logf (1.f + (1.f / curviness_for_calc));
-
-            float fval;
-            if (curve_up)
-              {
-                fval = (logf ((float) x + curviness_for_calc) - a) * b;
-              }
-            else
-              {
-                fval = (a - logf ((float) x + curviness_for_calc)) * b + 1.f;
-              }
-            val = (double) fval;
+            kind_ = Kind::LogarithmicPrecise;
+            log_a_ = logf (log_n_);
+            log_b_ = 1.f / logf (1.f + (1.f / log_n_));
           }
         else
           {
-            /* required vals */
-            const float a = utils::math::fast_log (curviness_for_calc);
-            const float b =
-              1.f / utils::math::fast_log (1.f + (1.f / curviness_for_calc));
-
-            float fval;
-            if (curve_up)
-              {
-                fval =
-                  (utils::math::fast_log ((float) x + curviness_for_calc) - a)
-                  * b;
-              }
-            else
-              {
-                fval =
-                  (a - utils::math::fast_log ((float) x + curviness_for_calc)) * b
-                  + 1.f;
-              }
-            val = (double) fval;
+            kind_ = Kind::LogarithmicFast;
+            log_a_ = utils::math::fast_log (log_n_);
+            log_b_ = 1.f / utils::math::fast_log (1.f + (1.f / log_n_));
           }
       }
       break;
     default:
-      z_return_val_if_reached (-1);
+      z_warn_if_reached ();
+    }
+}
+
+template <CurveEvaluator::Kind K>
+void
+fill_ys (
+  const CurveEvaluator &evaluator,
+  float *               ys,
+  double                x_start,
+  double                x_step,
+  size_t                size)
+{
+  for (size_t i = 0; i < size; i++)
+    {
+      const double x =
+        std::clamp (x_start + x_step * static_cast<double> (i), 0.0, 1.0);
+      ys[i] = static_cast<float> (evaluator.eval<K> (x));
+    }
+}
+
+/**
+ * @brief Like fill_ys(), but interpolates linearly between exact values
+ * every CurveOptions::INTERPOLATION_STRIDE values away from the ends of the
+ * curve.
+ */
+template <CurveEvaluator::Kind K>
+void
+fill_ys_interpolated (
+  const CurveEvaluator &evaluator,
+  float *               ys,
+  double                x_start,
+  double                x_step,
+  size_t                size)
+{
+  constexpr auto stride = CurveOptions::INTERPOLATION_STRIDE;
+  constexpr auto edge = CurveOptions::INTERPOLATION_EDGE;
+  for (size_t offset = 0; offset < size; offset += stride)
+    {
+      const size_t len = std::min (stride, size - offset);
+      const double x0 = x_start + x_step * static_cast<double> (offset);
+      const double x1 = x_start + x_step * static_cast<double> (offset + len);
+      if (std::min (x0, x1) < edge || std::max (x0, x1) > 1.0 - edge)
+        {
+          fill_ys<K> (evaluator, &ys[offset], x0, x_step, len);
+          continue;
+        }
+
+      const double y0 = evaluator.eval<K> (x0);
+      const double y_step =
+        (evaluator.eval<K> (x1) - y0) / static_cast<double> (len);
+      for (size_t i = 0; i < len; i++)
+        {
+          ys[offset + i] =
+            static_cast<float> (y0 + y_step * static_cast<double> (i));
+        }
+    }
+}
+
+template <CurveEvaluator::Kind K>
+void
+fill_ys_for_kind (
+  const CurveEvaluator &evaluator,
+  float *               ys,
+  double                x_start,
+  double                x_step,
+  size_t                size)
+{
+  constexpr bool smooth =
+    K != CurveEvaluator::Kind::Linear && K != CurveEvaluator::Kind::Pulse;
+  if (
+    smooth && size >= 2 * CurveOptions::INTERPOLATION_STRIDE
+    && std::fabs (x_step)
+           * static_cast<double> (CurveOptions::INTERPOLATION_STRIDE)
+         <= CurveOptions::MAX_INTERPOLATION_SPAN)
+    {
+      fill_ys_interpolated<K> (evaluator, ys, x_start, x_step, size);
+    }
+  else
+    {
+      fill_ys<K> (evaluator, ys, x_start, x_step, size);
+    }
+}
+
+} // namespace
+
+double
+CurveOptions::get_normalized_y (double x, bool start_higher) const
+{
+  z_return_val_if_fail_cmp (x, >=, 0.0, 0.0);
+  z_return_val_if_fail_cmp (x, <=, 1.0, 0.0);
+
+  using Kind = CurveEvaluator::Kind;
+  const CurveEvaluator evaluator (*this, start_higher);
+  switch (evaluator.get_kind ())
+    {
+    case Kind::Linear:
+      return evaluator.eval<Kind::Linear> (x);
+    case Kind::Exponent:
+      return evaluator.eval<Kind::Exponent> (x);
+    case Kind::SuperEllipse:
+      return evaluator.eval<Kind::SuperEllipse> (x);
+    case Kind::Vital:
+      return evaluator.eval<Kind::Vital> (x);
+    case Kind::Pulse:
+      return evaluator.eval<Kind::Pulse> (x);
+    case Kind::LogarithmicPrecise:
+      return evaluator.eval<Kind::LogarithmicPrecise> (x);
+    case Kind::LogarithmicFast:
+      return evaluator.eval<Kind::LogarithmicFast> (x);
+    }
+  z_return_val_if_reached (-1);
+}
+
+void
+CurveOptions::get_normalized_ys (
+  float * ys,
+  double  x_start,
+  double  x_step,
+  size_t  size,
+  bool    start_higher) const
+{
+  using Kind = CurveEvaluator::Kind;
+  const CurveEvaluator evaluator (*this, start_higher);
+  switch (evaluator.get_kind ())
+    {
+    case Kind::Linear:
+      fill_ys_for_kind<Kind::Linear> (evaluator, ys, x_start, x_step, size);
+      break;
+    case Kind::Exponent:
+      fill_ys_for_kind<Kind::Exponent> (evaluator, ys, x_start, x_step, size);
+      break;
+    case Kind::SuperEllipse:
+      fill_ys_for_kind<Kind::SuperEllipse> (
+        evaluator, ys, x_start, x_step, size);
+      break;
+    case Kind::Vital:
+      fill_ys_for_kind<Kind::Vital> (evaluator, ys, x_start, x_step, size);
+      break;
+    case Kind::Pulse:
+      fill_ys_for_kind<Kind::Pulse> (evaluator, ys, x_start, x_step, size);
+      break;
+    case Kind::LogarithmicPrecise:
+      fill_ys_for_kind<Kind::LogarithmicPrecise> (
+        evaluator, ys, x_start, x_step, size);
+      break;
+    case Kind::LogarithmicFast:
+      fill_ys_for_kind<Kind::LogarithmicFast> (
+        evaluator, ys, x_start, x_step, size);
+      break;
     }
-  return std::clamp (val, 0.0, 1.0);
 }
 
 void
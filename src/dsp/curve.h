@@ -4,6 +4,7 @@
 #ifndef ZRYTHM_DSP_CURVE_H
 #define ZRYTHM_DSP_CURVE_H
 
+#include <cstddef>
 #include <string>
 #include <utility>
 #include <vector>
@@ -114,8 +115,63 @@ public:
     return get_normalized_y (x, !fade_in);
   }
 
+  /**
+   * Batch version of get_normalized_y() for @p size evenly spaced X values
+   * (@p x_start + @p x_step * i), e.g. one per frame of a fade.
+   *
+   * The algorithm-specific constants are computed once per call and each
+   * algorithm is evaluated in its own loop. When the X values are dense
+   * enough, smooth curves are only evaluated exactly every
+   * @ref INTERPOLATION_STRIDE values (and near the ends of the curve, where
+   * some of them are steep), and linearly interpolated in between.
+   *
+   * X values outside [0, 1] are clamped.
+   *
+   * @param[out] ys Output Y values.
+   * @param start_higher Start at higher point.
+   */
+  [[gnu::hot]] void get_normalized_ys (
+    float * ys,
+    double  x_start,
+    double  x_step,
+    size_t  size,
+    bool    start_higher) const;
+
+  /**
+   * Batch version of get_normalized_y_for_fade().
+   *
+   * @see get_normalized_ys().
+   */
+  void get_normalized_ys_for_fade (
+    float * ys,
+    double  x_start,
+    double  x_step,
+    size_t  size,
+    bool    fade_in) const
+  {
+    get_normalized_ys (ys, x_start, x_step, size, !fade_in);
+  }
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
+public:
+  /**
+   * Number of consecutive values interpolated by get_normalized_ys().
+   */
+  static constexpr size_t INTERPOLATION_STRIDE = 16;
+
+  /**
+   * Largest X distance covered by an interpolated segment in
+   * get_normalized_ys().
+   */
+  static constexpr double MAX_INTERPOLATION_SPAN = 1.0 / 1024.0;
+
+  /**
+   * Distance from either end of the curve within which get_normalized_ys()
+   * always evaluates exactly.
+   */
+  static constexpr double INTERPOLATION_EDGE = 1.0 / 32.0;
+
 public:
   /** Curviness between -1 and 1, where < 0 tils downwards, > 0
    * tilts upwards and 0 is a straight line. */
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "dsp/curve_simplifier.h"
+
+namespace zrythm::dsp
+{
+
+void
+StreamingCurveSimplifier::start_segment (double x, double y)
+{
+  const double dx = x - anchor_x_;
+  min_slope_ = (y - tolerance_ - anchor_y_) / dx;
+  max_slope_ = (y + tolerance_ - anchor_y_) / dx;
+  has_last_point_ = true;
+  last_x_ = x;
+  last_y_ = y;
+}
+
+StreamingCurveSimplifier::Result
+StreamingCurveSimplifier::add_point (double x, double y)
+{
+  if (!has_anchor_ || (has_last_point_ ? x <= last_x_ : x <= anchor_x_))
+    {
+      has_anchor_ = true;
+      has_last_point_ = false;
+      anchor_x_ = x;
+      anchor_y_ = y;
+      return Result::AppendPoint;
+    }
+
+  if (!has_last_point_)
+    {
+      start_segment (x, y);
+      return Result::AppendPoint;
+    }
+
+  /* the last point can be dropped if the line from the anchor to this point
+   * passes close enough to it (and to the points dropped before it) */
+  const double dx = x - anchor_x_;
+  const double slope = (y - anchor_y_) / dx;
+  if (tolerance_ > 0.0 && slope >= min_slope_ && slope <= max_slope_)
+    {
+      min_slope_ = std::max (min_slope_, (y - tolerance_ - anchor_y_) / dx);
+      max_slope_ = std::min (max_slope_, (y + tolerance_ - anchor_y_) / dx);
+      last_x_ = x;
+      last_y_ = y;
+      return Result::ReplaceLastPoint;
+    }
+
+  /* keep the last point and start a new segment from it */
+  anchor_x_ = last_x_;
+  anchor_y_ = last_y_;
+  start_segment (x, y);
+  return Result::AppendPoint;
+}
+
+} // namespace zrythm::dsp
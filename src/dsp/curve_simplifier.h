@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Simplifies a curve one point at a time, e.g. while recording
+ * automation, keeping only the points needed to stay within a tolerance.
+ *
+ * The kept points, joined with straight lines, stay within @ref tolerance_
+ * (vertically) of every added point and of the straight lines between them.
+ *
+ * This is a streaming variant of Ramer–Douglas–Peucker: the last kept point
+ * (the anchor) is only extended while a straight line from it to the newest
+ * point passes within the tolerance of all the points dropped since. To keep
+ * this O(1) per point, the constraints of the dropped points are kept as the
+ * range of slopes allowed from the anchor.
+ */
+class StreamingCurveSimplifier
+{
+public:
+  enum class Result
+  {
+    /** The point must be appended to the previous points. */
+    AppendPoint,
+
+    /**
+     * The previous point is not needed anymore and must be replaced by this
+     * point.
+     */
+    ReplaceLastPoint,
+  };
+
+  /**
+   * @param tolerance Maximum vertical distance allowed. 0 disables
+   * simplification.
+   */
+  explicit StreamingCurveSimplifier (double tolerance = 0.0)
+      : tolerance_ (tolerance)
+  {
+  }
+
+  /**
+   * @brief Sets the tolerance (used from the next point on).
+   */
+  void set_tolerance (double tolerance) { tolerance_ = tolerance; }
+
+  double get_tolerance () const { return tolerance_; }
+
+  /**
+   * @brief Forgets all the points, so that the next point starts a new
+   * curve.
+   */
+  void reset ()
+  {
+    has_anchor_ = false;
+    has_last_point_ = false;
+  }
+
+  bool empty () const { return !has_anchor_; }
+
+  /**
+   * @brief Adds a point after the previous ones.
+   *
+   * Points must be added in increasing X order. A point that doesn't come
+   * after the previous one starts a new curve.
+   */
+  Result add_point (double x, double y);
+
+private:
+  /**
+   * @brief Starts a new segment from the anchor to (x, y).
+   */
+  void start_segment (double x, double y);
+
+private:
+  double tolerance_ = 0.0;
+
+  /** Last kept point (the start of the current segment). */
+  bool   has_anchor_ = false;
+  double anchor_x_ = 0.0;
+  double anchor_y_ = 0.0;
+
+  /** Last point added (the end of the current segment), if any. */
+  bool   has_last_point_ = false;
+  double last_x_ = 0.0;
+  double last_y_ = 0.0;
+
+  /**
+   * Range of slopes from the anchor that pass within the tolerance of all
+   * the points of the current segment.
+   */
+  double min_slope_ = 0.0;
+  double max_slope_ = 0.0;
+};
+
+} // namespace zrythm::dsp
@@ -0,0 +1,316 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
+
+#include "dsp/cycle_capture.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+constexpr int COMPRESSION_LEVEL = 3;
+
+/** How often the writer thread drains the ring. */
+constexpr int DRAIN_INTERVAL_MS = 20;
+
+constexpr size_t DRAIN_CHUNK_SIZE = 1 << 16;
+
+template <typename T>
+uint8_t *
+write_raw (uint8_t * dst, const T * src, size_t count)
+{
+  static_assert (std::is_trivially_copyable_v<T>);
+  std::memcpy (dst, src, count * sizeof (T));
+  return dst + count * sizeof (T);
+}
+
+/**
+ * @brief Reads values from serialized data, throwing if it is truncated.
+ */
+class ByteReader
+{
+public:
+  explicit ByteReader (std::string_view data) : data_ (data) { }
+
+  bool at_end () const { return pos_ == data_.size (); }
+
+  template <typename T> void read (T * dst, size_t count = 1)
+  {
+    static_assert (std::is_trivially_copyable_v<T>);
+    const auto size = count * sizeof (T);
+    if (data_.size () - pos_ < size)
+      {
+        throw ZrythmException ("Truncated cycle capture");
+      }
+    std::memcpy (dst, data_.data () + pos_, size);
+    pos_ += size;
+  }
+
+private:
+  std::string_view data_;
+  size_t           pos_ = 0;
+};
+
+} // namespace
+
+CycleCapture::CycleCapture (
+  const fs::path &path,
+  sample_rate_t   sample_rate,
+  nframes_t       max_block_length,
+  size_t          num_audio_channels,
+  size_t          ring_size)
+    : juce::Thread ("CycleCapture"), compressor_ (path, COMPRESSION_LEVEL),
+      ring_ (std::max (
+        ring_size,
+        2 * get_max_record_size (num_audio_channels, max_block_length))),
+      queued_control_changes_ (MAX_CONTROL_CHANGES_PER_CYCLE * 4)
+{
+  file_header_.sample_rate_ = sample_rate;
+  file_header_.max_block_length_ = max_block_length;
+  file_header_.num_audio_channels_ =
+    static_cast<uint32_t> (num_audio_channels);
+
+  cur_midi_events_.reserve (MAX_MIDI_EVENTS_PER_CYCLE);
+  cur_control_changes_.reserve (MAX_CONTROL_CHANGES_PER_CYCLE);
+  cur_audio_.resize (num_audio_channels * max_block_length);
+  serialized_.resize (
+    get_max_record_size (num_audio_channels, max_block_length));
+  drain_buf_.resize (DRAIN_CHUNK_SIZE);
+
+  compressor_.write (std::string_view (
+    reinterpret_cast<const char *> (&file_header_), sizeof (file_header_)));
+
+  startThread (juce::Thread::Priority::low);
+}
+
+CycleCapture::~CycleCapture ()
+{
+  try
+    {
+      finish ();
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("failed to finish the cycle capture: {}", e.what ());
+    }
+}
+
+size_t
+CycleCapture::get_max_record_size (
+  size_t    num_audio_channels,
+  nframes_t max_block_length)
+{
+  return sizeof (CycleHeader) + MAX_MIDI_EVENTS_PER_CYCLE * sizeof (MidiEvent)
+         + MAX_CONTROL_CHANGES_PER_CYCLE * sizeof (ControlChange)
+         + num_audio_channels * max_block_length * sizeof (float);
+}
+
+void
+CycleCapture::queue_control_change (const ControlChange &change)
+{
+  queued_control_changes_.push_back (change);
+}
+
+void
+CycleCapture::begin_cycle (const CycleHeader &header)
+{
+  cur_header_ = header;
+  cur_header_.index_ = next_index_++;
+  cur_midi_events_.clear ();
+  cur_control_changes_.clear ();
+  cur_valid_ = header.nframes_ <= file_header_.max_block_length_;
+  if (!cur_valid_) [[unlikely]]
+    return;
+
+  std::fill_n (
+    cur_audio_.begin (),
+    file_header_.num_audio_channels_ * cur_header_.nframes_, 0.f);
+
+  ControlChange change;
+  while (
+    cur_control_changes_.size () < MAX_CONTROL_CHANGES_PER_CYCLE
+    && queued_control_changes_.pop_front (change))
+    {
+      cur_control_changes_.push_back (change);
+    }
+}
+
+void
+CycleCapture::add_midi_event (const MidiEvent &ev)
+{
+  if (cur_midi_events_.size () < MAX_MIDI_EVENTS_PER_CYCLE)
+    {
+      cur_midi_events_.push_back (ev);
+    }
+}
+
+void
+CycleCapture::set_audio_input (size_t channel, std::span<const float> frames)
+{
+  if (!cur_valid_ || channel >= file_header_.num_audio_channels_)
+    return;
+
+  std::copy_n (
+    frames.begin (), std::min<size_t> (frames.size (), cur_header_.nframes_),
+    cur_audio_.begin ()
+      + static_cast<ptrdiff_t> (channel * cur_header_.nframes_));
+}
+
+void
+CycleCapture::end_cycle ()
+{
+  if (!cur_valid_ || failed_.load (std::memory_order_relaxed)) [[unlikely]]
+    {
+      num_dropped_cycles_.fetch_add (1, std::memory_order_relaxed);
+      return;
+    }
+  cur_valid_ = false;
+
+  cur_header_.num_midi_events_ =
+    static_cast<uint32_t> (cur_midi_events_.size ());
+  cur_header_.num_control_changes_ =
+    static_cast<uint32_t> (cur_control_changes_.size ());
+
+  auto * dst = serialized_.data ();
+  dst = write_raw (dst, &cur_header_, 1);
+  dst = write_raw (dst, cur_midi_events_.data (), cur_midi_events_.size ());
+  dst =
+    write_raw (dst, cur_control_changes_.data (), cur_control_changes_.size ());
+  dst = write_raw (
+    dst, cur_audio_.data (),
+    file_header_.num_audio_channels_ * cur_header_.nframes_);
+
+  const auto size = static_cast<size_t> (dst - serialized_.data ());
+  if (ring_.write_multiple (serialized_.data (), size))
+    {
+      num_captured_cycles_.fetch_add (1, std::memory_order_relaxed);
+    }
+  else
+    {
+      num_dropped_cycles_.fetch_add (1, std::memory_order_relaxed);
+    }
+}
+
+void
+CycleCapture::drain ()
+{
+  size_t num_read = 0;
+  while (
+    (num_read = ring_.peek_multiple (drain_buf_.data (), drain_buf_.size ()))
+    > 0)
+    {
+      compressor_.write (std::string_view (
+        reinterpret_cast<const char *> (drain_buf_.data ()), num_read));
+      ring_.skip (num_read);
+    }
+}
+
+void
+CycleCapture::run ()
+{
+  try
+    {
+      while (!threadShouldExit ())
+        {
+          drain ();
+          wait (DRAIN_INTERVAL_MS);
+        }
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("failed to write the cycle capture: {}", e.what ());
+      failed_.store (true);
+    }
+}
+
+void
+CycleCapture::finish ()
+{
+  if (finished_)
+    return;
+
+  finished_ = true;
+  stopThread (-1);
+  if (failed_.load ())
+    {
+      throw ZrythmException ("Failed to write the cycle capture");
+    }
+  drain ();
+  compressor_.finish ();
+}
+
+CycleCaptureReader::CycleCaptureReader (const fs::path &path)
+{
+  parse (utils::compression::decompress_file (path));
+}
+
+CycleCaptureReader
+CycleCaptureReader::from_data (std::string_view data)
+{
+  CycleCaptureReader reader;
+  reader.parse (data);
+  return reader;
+}
+
+void
+CycleCaptureReader::parse (std::string_view data)
+{
+  ByteReader reader (data);
+  reader.read (&header_);
+  if (header_.magic_ != CycleCapture::MAGIC)
+    {
+      throw ZrythmException ("Not a cycle capture");
+    }
+  if (header_.version_ != CycleCapture::FORMAT_VERSION)
+    {
+      throw ZrythmException (fmt::format (
+        "Unsupported cycle capture version {}", header_.version_));
+    }
+
+  while (!reader.at_end ())
+    {
+      Cycle cycle;
+      reader.read (&cycle.header_);
+      const auto &cycle_header = cycle.header_;
+      if (
+        cycle_header.nframes_ > header_.max_block_length_
+        || cycle_header.num_midi_events_
+             > CycleCapture::MAX_MIDI_EVENTS_PER_CYCLE
+        || cycle_header.num_control_changes_
+             > CycleCapture::MAX_CONTROL_CHANGES_PER_CYCLE)
+        {
+          throw ZrythmException (fmt::format (
+            "Invalid cycle {} in cycle capture", cycle_header.index_));
+        }
+
+      cycle.midi_events_.resize (cycle_header.num_midi_events_);
+      reader.read (cycle.midi_events_.data (), cycle.midi_events_.size ());
+      cycle.control_changes_.resize (cycle_header.num_control_changes_);
+      reader.read (
+        cycle.control_changes_.data (), cycle.control_changes_.size ());
+      cycle.audio_.resize (
+        static_cast<size_t> (header_.num_audio_channels_)
+        * cycle_header.nframes_);
+      reader.read (cycle.audio_.data (), cycle.audio_.size ());
+
+      cycles_.push_back (std::move (cycle));
+    }
+}
+
+uint64_t
+CycleCaptureReader::get_num_missing_cycles () const
+{
+  if (cycles_.empty ())
+    return 0;
+
+  return cycles_.back ().header_.index_ + 1 - cycles_.size ();
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,283 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "utils/compression.h"
+#include "utils/mpmc_queue.h"
+#include "utils/ring_buffer.h"
+#include "utils/types.h"
+
+#include "juce_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Records the inputs of each engine cycle to a file, so that the
+ * cycles can be replayed deterministically (see CycleCaptureReader).
+ *
+ * For each cycle, the transport state, the incoming MIDI and audio, the
+ * control changes made outside the realtime thread and the version of the
+ * processing graph are recorded. Together with the project, this is enough
+ * to reproduce the engine's work offline (e.g., to investigate performance
+ * regressions).
+ *
+ * The realtime thread serializes each cycle into a ring buffer, which a
+ * background thread compresses (zstd) into the file. If the ring is full the
+ * cycle is dropped and counted (see get_num_dropped_cycles()); replays of
+ * such captures skip the dropped cycles.
+ *
+ * The file is a zstd stream containing a FileHeader followed by one record
+ * per cycle: a CycleHeader, its MIDI events, its control changes and its
+ * audio input (channel after channel), all in native byte order.
+ */
+class CycleCapture final : public juce::Thread
+{
+public:
+  static constexpr std::array<char, 8> MAGIC = { 'Z', 'C', 'Y', 'C',
+                                                 'C', 'A', 'P', '\0' };
+  static constexpr uint32_t            FORMAT_VERSION = 1;
+
+  /** Events/changes beyond these in a single cycle are dropped. */
+  static constexpr size_t MAX_MIDI_EVENTS_PER_CYCLE = 512;
+  static constexpr size_t MAX_CONTROL_CHANGES_PER_CYCLE = 256;
+
+  /** Default size of the ring between the realtime and writer threads. */
+  static constexpr size_t DEFAULT_RING_SIZE = 1 << 22;
+
+  struct FileHeader
+  {
+    std::array<char, 8> magic_ = MAGIC;
+    uint32_t            version_ = FORMAT_VERSION;
+    uint32_t            sample_rate_ = 0;
+    uint32_t            max_block_length_ = 0;
+    uint32_t            num_audio_channels_ = 0;
+  };
+
+  enum CycleFlags : uint32_t
+  {
+    Rolling = 1 << 0,
+    Looping = 1 << 1,
+    Recording = 1 << 2,
+  };
+
+  struct CycleHeader
+  {
+    /** Index of the cycle since the capture started. */
+    uint64_t index_ = 0;
+
+    /** Playhead position at the start of the cycle. */
+    int64_t playhead_frames_ = 0;
+
+    /** Version of the processing graph used (see GraphScheduler). */
+    uint64_t graph_generation_ = 0;
+
+    float    bpm_ = 0.f;
+    uint32_t nframes_ = 0;
+
+    /** Combination of CycleFlags. */
+    uint32_t flags_ = 0;
+
+    uint32_t num_midi_events_ = 0;
+    uint32_t num_control_changes_ = 0;
+
+    /** Unused (avoids uninitialized padding in the file). */
+    uint32_t reserved_ = 0;
+  };
+
+  struct MidiEvent
+  {
+    /** Offset from the start of the cycle. */
+    uint32_t time_ = 0;
+
+    /** Index of the input the event arrived at (defined by the caller). */
+    uint16_t input_ = 0;
+
+    uint8_t size_ = 0;
+    uint8_t reserved_ = 0;
+
+    /** Raw MIDI data (only the first @ref size_ bytes are used). */
+    std::array<uint8_t, 4> data_{};
+  };
+
+  struct ControlChange
+  {
+    /** UUID of the port (RFC 4122 bytes). */
+    std::array<uint8_t, 16> port_id_{};
+    float                   value_ = 0.f;
+  };
+
+public:
+  /**
+   * @param num_audio_channels Number of audio inputs recorded each cycle.
+   * @throw ZrythmException If the file could not be opened.
+   */
+  CycleCapture (
+    const fs::path &path,
+    sample_rate_t   sample_rate,
+    nframes_t       max_block_length,
+    size_t          num_audio_channels,
+    size_t          ring_size = DEFAULT_RING_SIZE);
+  ~CycleCapture () override;
+  Z_DISABLE_COPY_MOVE (CycleCapture)
+
+  const FileHeader &get_file_header () const { return file_header_; }
+
+  /**
+   * @brief Queues a control change to be recorded with the next cycle.
+   *
+   * Realtime-safe. Can be called from any thread.
+   */
+  void queue_control_change (const ControlChange &change);
+
+  /**
+   * @brief Starts recording a cycle.
+   *
+   * @p header's index and counts are filled in by the capture. Must be
+   * followed by end_cycle(). Realtime-safe.
+   */
+  void begin_cycle (const CycleHeader &header);
+
+  /** Realtime-safe. */
+  void add_midi_event (const MidiEvent &ev);
+
+  /**
+   * @brief Records the audio input of the given channel.
+   *
+   * Channels not set are recorded as silence. Realtime-safe.
+   */
+  void set_audio_input (size_t channel, std::span<const float> frames);
+
+  /**
+   * @brief Hands the cycle over to the writer thread, or drops it if the
+   * ring is full.
+   *
+   * Realtime-safe.
+   */
+  void end_cycle ();
+
+  uint64_t get_num_captured_cycles () const
+  {
+    return num_captured_cycles_.load (std::memory_order_relaxed);
+  }
+  uint64_t get_num_dropped_cycles () const
+  {
+    return num_dropped_cycles_.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Writes the remaining cycles and commits the file.
+   *
+   * Must not be called while cycles are being recorded, and no cycles can be
+   * recorded afterwards. Called by the destructor if not called before.
+   *
+   * @throw ZrythmException If writing failed.
+   */
+  void finish ();
+
+private:
+  void run () override;
+
+  /** Returns the size of the largest possible serialized cycle. */
+  static size_t
+  get_max_record_size (size_t num_audio_channels, nframes_t max_block_length);
+
+  /** Compresses what's in the ring into the file. */
+  void drain ();
+
+private:
+  FileHeader file_header_;
+
+  utils::compression::StreamingFileCompressor compressor_;
+
+  /** Serialized cycles, from the realtime thread to the writer thread. */
+  RingBuffer<uint8_t> ring_;
+
+  MPMCQueue<ControlChange> queued_control_changes_;
+
+  /* the cycle being recorded (only used by the realtime thread) */
+  CycleHeader                cur_header_;
+  std::vector<MidiEvent>     cur_midi_events_;
+  std::vector<ControlChange> cur_control_changes_;
+  std::vector<float>         cur_audio_;
+  bool                       cur_valid_ = false;
+  std::vector<uint8_t>       serialized_;
+
+  /** Buffer the writer thread drains the ring into. */
+  std::vector<uint8_t> drain_buf_;
+
+  uint64_t              next_index_ = 0;
+  std::atomic<uint64_t> num_captured_cycles_ = 0;
+  std::atomic<uint64_t> num_dropped_cycles_ = 0;
+
+  /** Set when writing fails, after which cycles are no longer written. */
+  std::atomic<bool> failed_ = false;
+  bool              finished_ = false;
+};
+
+/**
+ * @brief Reads the cycles recorded by CycleCapture.
+ */
+class CycleCaptureReader
+{
+public:
+  struct Cycle
+  {
+    CycleCapture::CycleHeader                header_;
+    std::vector<CycleCapture::MidiEvent>     midi_events_;
+    std::vector<CycleCapture::ControlChange> control_changes_;
+
+    /** Audio input, channel after channel. */
+    std::vector<float> audio_;
+
+    std::span<const float> get_audio_channel (size_t channel) const
+    {
+      return std::span (audio_).subspan (
+        channel * header_.nframes_, header_.nframes_);
+    }
+  };
+
+public:
+  /**
+   * @throw ZrythmException If the file could not be read or is not a valid
+   * capture.
+   */
+  explicit CycleCaptureReader (const fs::path &path);
+
+  /**
+   * @brief Parses decompressed capture data.
+   *
+   * @throw ZrythmException If @p data is not a valid capture.
+   */
+  static CycleCaptureReader from_data (std::string_view data);
+
+  const CycleCapture::FileHeader &get_file_header () const { return header_; }
+
+  const std::vector<Cycle> &get_cycles () const { return cycles_; }
+
+  /**
+   * @brief Returns the number of cycles missing from the capture (dropped
+   * while capturing).
+   */
+  uint64_t get_num_missing_cycles () const;
+
+private:
+  CycleCaptureReader () = default;
+
+  void parse (std::string_view data);
+
+private:
+  CycleCapture::FileHeader header_;
+  std::vector<Cycle>       cycles_;
+};
+
+} // namespace zrythm::dsp
@@ -15,50 +15,112 @@
  */
 // clang-format on
 
+#include <algorithm>
 #include <cmath>
-#include <cstdlib>
 
 #include "dsp/ditherer.h"
 
 namespace zrythm::dsp
 {
 
+Ditherer::Ditherer () noexcept
+{
+  /* seed each lane with splitmix32 (a fixed seed keeps exports
+   * reproducible) */
+  uint32_t seed = 0x9E3779B9u;
+  for (auto &lane_state : rng_state_)
+    {
+      for (auto &val : lane_state)
+        {
+          uint32_t z = (seed += 0x9E3779B9u);
+          z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+          z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+          val = z ^ (z >> 16);
+        }
+    }
+}
+
 void
 Ditherer::reset (int numBits) noexcept
 {
   auto wordLen = std::pow (2.0f, (float) (numBits - 1));
   auto invWordLen = 1.0f / wordLen;
-  amp_ = invWordLen / static_cast<float> (RAND_MAX);
+  amp_ = invWordLen;
   offset_ = invWordLen * 0.5f;
+  s1_ = 0;
+  s2_ = 0;
 }
 
 void
-Ditherer::process (float * samps, int num) noexcept
+Ditherer::generate_noise () noexcept
 {
-  while (--num >= 0)
+  noise_[0] = noise_[NOISE_BLOCK_SIZE];
+
+  auto &[rs0, rs1, rs2, rs3] = rng_state_;
+  for (size_t i = 0; i < NOISE_BLOCK_SIZE; i += NUM_LANES)
     {
-      random2_ = random1_;
-      random1_ = rand ();
+      /* xoshiro128+, one generator per lane */
+      for (size_t lane = 0; lane < NUM_LANES; lane++)
+        {
+          const uint32_t result = rs0[lane] + rs3[lane];
+          const uint32_t t = rs1[lane] << 9;
+          rs2[lane] ^= rs0[lane];
+          rs3[lane] ^= rs1[lane];
+          rs1[lane] ^= rs2[lane];
+          rs0[lane] ^= rs3[lane];
+          rs2[lane] ^= t;
+          rs3[lane] = (rs3[lane] << 11) | (rs3[lane] >> 21);
+
+          /* upper 24 bits to [0, 1) */
+          noise_[1 + i + lane] =
+            static_cast<float> (result >> 8) * (1.f / 16777216.f);
+        }
+    }
 
-      auto in = *samps;
+  noise_pos_ = 0;
+}
+
+void
+Ditherer::process_chunk (float * samps, size_t num) noexcept
+{
+  /* error feedback: err[i + 2] is s1_ after sample i */
+  std::array<float, NOISE_BLOCK_SIZE + 2> err;
+  err[0] = s2_;
+  err[1] = s1_;
+
+  const float * noise = &noise_[noise_pos_];
+  for (size_t i = 0; i < num; i++)
+    {
+      const float dither = offset_ + amp_ * (noise[i + 1] - noise[i]);
+      err[i + 2] = -dither;
+
+      const float in = samps[i];
+      const float out = in + 0.5f * (err[i + 1] + err[i + 1] - err[i]) + dither;
 
       // check for dodgy numbers coming in..
-      if (in < -0.000001f || in > 0.000001f)
-        {
-          in += 0.5f * (s1_ + s1_ - s2_);
-          auto out = in + offset_ + amp_ * (float) (random1_ - random2_);
-          *samps++ = out;
-          s2_ = s1_;
-          s1_ = in - out;
-        }
-      else
-        {
-          *samps++ = in;
-          in += 0.5f * (s1_ + s1_ - s2_);
-          auto out = in + offset_ + amp_ * (float) (random1_ - random2_);
-          s2_ = s1_;
-          s1_ = in - out;
-        }
+      const bool pass_through = in >= -0.000001f && in <= 0.000001f;
+      samps[i] = pass_through ? in : out;
+    }
+
+  s2_ = err[num];
+  s1_ = err[num + 1];
+  noise_pos_ += num;
+}
+
+void
+Ditherer::process (float * samps, int num) noexcept
+{
+  auto remaining = static_cast<size_t> (std::max (num, 0));
+  while (remaining > 0)
+    {
+      if (noise_pos_ == NOISE_BLOCK_SIZE)
+        generate_noise ();
+
+      const size_t chunk_size =
+        std::min (remaining, NOISE_BLOCK_SIZE - noise_pos_);
+      process_chunk (samps, chunk_size);
+      samps += chunk_size;
+      remaining -= chunk_size;
     }
 }
 
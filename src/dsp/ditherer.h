@@ -22,22 +22,61 @@
 #ifndef ZRYTHM_DSP_DITHER_H
 #define ZRYTHM_DSP_DITHER_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
 namespace zrythm::dsp
 {
 
 /**
     An extremely naive ditherer.
     TODO: this could be done much better!
+
+    Adds high-passed TPDF noise with simple error feedback. The noise is
+    generated in blocks by several interleaved xoshiro128+ generators and
+    applied in branch-free loops, so that both can be vectorized.
 */
 class Ditherer
 {
 public:
+  Ditherer () noexcept;
+
+  /**
+   * @brief Sets the target bit depth and resets the error feedback.
+   */
   void reset (int numBits) noexcept;
 
   void process (float * samps, int num) noexcept;
 
 private:
-  int   random1_ = 0, random2_ = 0;
+  static constexpr size_t NUM_LANES = 8;
+  static constexpr size_t NOISE_BLOCK_SIZE = 256;
+
+  /**
+   * @brief Refills @ref noise_ with the next NOISE_BLOCK_SIZE random values.
+   */
+  void generate_noise () noexcept;
+
+  /**
+   * @brief Processes up to the remaining values in @ref noise_.
+   */
+  void process_chunk (float * samps, size_t num) noexcept;
+
+private:
+  /** xoshiro128+ state of each lane. */
+  std::array<std::array<uint32_t, NUM_LANES>, 4> rng_state_{};
+
+  /**
+   * Uniform random values in [0, 1).
+   *
+   * The first element is the last value of the previous block.
+   */
+  std::array<float, NOISE_BLOCK_SIZE + 1> noise_{};
+
+  /** Values of @ref noise_ used so far. */
+  size_t noise_pos_ = NOISE_BLOCK_SIZE;
+
   float amp_ = 0, offset_ = 0;
   float s1_ = 0, s2_ = 0;
 };
@@ -8,6 +8,7 @@
 #include "./graph.h"
 #include "./graph_builder.h"
 #include "./graph_node.h"
+#include "./graph_node_stats.h"
 #include "./graph_scheduler.h"
 #include "./graph_thread.h"
 #include "./itransport.h"
@@ -0,0 +1,154 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <bit>
+
+#include "dsp/engine_telemetry.h"
+
+namespace zrythm::dsp
+{
+
+size_t
+EngineTelemetry::get_bin_for_duration (int64_t duration_us)
+{
+  if (duration_us < FIRST_BIN_UPPER_US)
+    return 0;
+
+  /* bin i (i > 0) covers [FIRST_BIN_UPPER_US * 2^(i-1),
+   * FIRST_BIN_UPPER_US * 2^i) */
+  const auto multiple = static_cast<uint64_t> (duration_us / FIRST_BIN_UPPER_US);
+  const auto bin = static_cast<size_t> (std::bit_width (multiple));
+  return std::min (bin, NUM_HISTOGRAM_BINS - 1);
+}
+
+std::pair<int64_t, int64_t>
+EngineTelemetry::get_bin_range_us (size_t bin)
+{
+  if (bin == 0)
+    return { 0, FIRST_BIN_UPPER_US };
+
+  const int64_t lower = FIRST_BIN_UPPER_US << (bin - 1);
+  if (bin >= NUM_HISTOGRAM_BINS - 1)
+    return { lower, 0 };
+
+  return { lower, lower * 2 };
+}
+
+void
+EngineTelemetry::record_cycle_end (int64_t duration_us, int64_t budget_us)
+{
+  duration_us = std::max (duration_us, int64_t{ 0 });
+
+  auto &bin = histogram_[get_bin_for_duration (duration_us)];
+  bin.store (
+    bin.load (std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  last_duration_us_.store (duration_us, std::memory_order_relaxed);
+  total_duration_us_.store (
+    total_duration_us_.load (std::memory_order_relaxed) + duration_us,
+    std::memory_order_relaxed);
+  if (duration_us > max_duration_us_.load (std::memory_order_relaxed))
+    max_duration_us_.store (duration_us, std::memory_order_relaxed);
+
+  if (budget_us > 0)
+    {
+      last_budget_us_.store (budget_us, std::memory_order_relaxed);
+      total_budget_us_.store (
+        total_budget_us_.load (std::memory_order_relaxed) + budget_us,
+        std::memory_order_relaxed);
+      const double load =
+        static_cast<double> (duration_us) * 100.0
+        / static_cast<double> (budget_us);
+      if (load > max_dsp_load_.load (std::memory_order_relaxed))
+        max_dsp_load_.store (load, std::memory_order_relaxed);
+    }
+
+  num_cycles_.store (
+    num_cycles_.load (std::memory_order_relaxed) + 1,
+    std::memory_order_release);
+}
+
+EngineTelemetry::Snapshot
+EngineTelemetry::get_snapshot () const
+{
+  Snapshot snapshot;
+  snapshot.num_cycles_ = num_cycles_.load (std::memory_order_acquire);
+  for (size_t i = 0; i < NUM_HISTOGRAM_BINS; ++i)
+    {
+      snapshot.histogram_[i] = histogram_[i].load (std::memory_order_relaxed);
+    }
+
+  snapshot.last_duration_us_ =
+    last_duration_us_.load (std::memory_order_relaxed);
+  snapshot.max_duration_us_ = max_duration_us_.load (std::memory_order_relaxed);
+  const auto total_duration =
+    total_duration_us_.load (std::memory_order_relaxed);
+  if (snapshot.num_cycles_ > 0)
+    {
+      snapshot.mean_duration_us_ =
+        total_duration / static_cast<int64_t> (snapshot.num_cycles_);
+    }
+
+  const auto last_budget = last_budget_us_.load (std::memory_order_relaxed);
+  if (last_budget > 0)
+    {
+      snapshot.last_dsp_load_ =
+        static_cast<double> (snapshot.last_duration_us_) * 100.0
+        / static_cast<double> (last_budget);
+    }
+  const auto total_budget = total_budget_us_.load (std::memory_order_relaxed);
+  if (total_budget > 0)
+    {
+      snapshot.mean_dsp_load_ =
+        static_cast<double> (total_duration) * 100.0
+        / static_cast<double> (total_budget);
+    }
+  snapshot.max_dsp_load_ = max_dsp_load_.load (std::memory_order_relaxed);
+
+  const auto jitter_count = jitter_count_.load (std::memory_order_relaxed);
+  if (jitter_count > 0)
+    {
+      snapshot.mean_jitter_us_ =
+        static_cast<double> (total_jitter_us_.load (std::memory_order_relaxed))
+        / static_cast<double> (jitter_count);
+    }
+  snapshot.max_jitter_us_ = max_jitter_us_.load (std::memory_order_relaxed);
+
+  snapshot.num_xruns_ = num_xruns_.load (std::memory_order_acquire);
+  const auto num_timestamps = std::min (
+    snapshot.num_xruns_, static_cast<uint64_t> (MAX_XRUN_TIMESTAMPS));
+  snapshot.xrun_timestamps_us_.reserve (num_timestamps);
+  for (
+    auto i = snapshot.num_xruns_ - num_timestamps; i < snapshot.num_xruns_; ++i)
+    {
+      snapshot.xrun_timestamps_us_.push_back (
+        xrun_timestamps_us_[i % MAX_XRUN_TIMESTAMPS].load (
+          std::memory_order_relaxed));
+    }
+
+  return snapshot;
+}
+
+void
+EngineTelemetry::reset ()
+{
+  for (auto &bin : histogram_)
+    {
+      bin.store (0, std::memory_order_relaxed);
+    }
+  num_cycles_.store (0, std::memory_order_relaxed);
+  last_duration_us_.store (0, std::memory_order_relaxed);
+  total_duration_us_.store (0, std::memory_order_relaxed);
+  max_duration_us_.store (0, std::memory_order_relaxed);
+  last_budget_us_.store (0, std::memory_order_relaxed);
+  total_budget_us_.store (0, std::memory_order_relaxed);
+  max_dsp_load_.store (0.0, std::memory_order_relaxed);
+  jitter_count_.store (0, std::memory_order_relaxed);
+  total_jitter_us_.store (0, std::memory_order_relaxed);
+  max_jitter_us_.store (0, std::memory_order_relaxed);
+  last_start_us_ = 0;
+  num_xruns_.store (0, std::memory_order_relaxed);
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,181 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Timing statistics of the audio callback, collected the same way for
+ * all backends so that backends and buffer sizes can be compared.
+ *
+ * Collects a histogram of the callback's processing time, the DSP load
+ * (processing time relative to the time available for the cycle), the jitter
+ * of the callback's arrival (difference between the time since the previous
+ * callback and the cycle's duration) and the xruns.
+ *
+ * The audio thread records into relaxed atomics without locking or allocating,
+ * while the GUI thread takes snapshots at any time. There must be only one
+ * writer at a time. Snapshots may observe a partially recorded cycle; this is
+ * acceptable for statistics.
+ */
+class EngineTelemetry
+{
+public:
+  /**
+   * @brief Number of histogram bins.
+   *
+   * Bin 0 counts callbacks that took less than @ref FIRST_BIN_UPPER_US
+   * microseconds, and each following bin covers twice the range of the
+   * previous one. The last bin also counts everything above it.
+   */
+  static constexpr size_t  NUM_HISTOGRAM_BINS = 16;
+  static constexpr int64_t FIRST_BIN_UPPER_US = 32;
+
+  /** Number of xrun timestamps kept. */
+  static constexpr size_t MAX_XRUN_TIMESTAMPS = 32;
+
+  struct Snapshot
+  {
+    /** Number of callbacks recorded. */
+    uint64_t num_cycles_ = 0;
+
+    /** Callback processing time histogram (see @ref get_bin_range_us()). */
+    std::array<uint64_t, NUM_HISTOGRAM_BINS> histogram_{};
+
+    int64_t last_duration_us_ = 0;
+    int64_t mean_duration_us_ = 0;
+    int64_t max_duration_us_ = 0;
+
+    /** DSP load of the last callback, in percent. */
+    double last_dsp_load_ = 0.0;
+
+    /** Mean DSP load, in percent. */
+    double mean_dsp_load_ = 0.0;
+
+    /** Highest DSP load of a single callback, in percent. */
+    double max_dsp_load_ = 0.0;
+
+    /** Mean absolute jitter of the callback's arrival. */
+    double  mean_jitter_us_ = 0.0;
+    int64_t max_jitter_us_ = 0;
+
+    uint64_t num_xruns_ = 0;
+
+    /** Timestamps of the last xruns (up to @ref MAX_XRUN_TIMESTAMPS), oldest
+     * first. */
+    std::vector<int64_t> xrun_timestamps_us_;
+  };
+
+public:
+  /**
+   * @brief Records the start of a callback.
+   *
+   * Realtime-safe.
+   *
+   * @param start_us Monotonic time at the start of the callback.
+   * @param cycle_duration_us Duration of the audio in the previous cycle (the
+   * expected time between callbacks).
+   */
+  [[gnu::hot]] void
+  record_cycle_start (int64_t start_us, int64_t cycle_duration_us)
+  {
+    if (last_start_us_ > 0 && cycle_duration_us > 0)
+      {
+        int64_t jitter = (start_us - last_start_us_) - cycle_duration_us;
+        jitter = jitter < 0 ? -jitter : jitter;
+        jitter_count_.store (
+          jitter_count_.load (std::memory_order_relaxed) + 1,
+          std::memory_order_relaxed);
+        total_jitter_us_.store (
+          total_jitter_us_.load (std::memory_order_relaxed) + jitter,
+          std::memory_order_relaxed);
+        if (jitter > max_jitter_us_.load (std::memory_order_relaxed))
+          max_jitter_us_.store (jitter, std::memory_order_relaxed);
+      }
+    last_start_us_ = start_us;
+  }
+
+  /**
+   * @brief Records the processing time of a callback.
+   *
+   * Realtime-safe.
+   *
+   * @param duration_us Time taken to process the callback.
+   * @param budget_us Duration of the audio processed in the callback.
+   */
+  [[gnu::hot]] void record_cycle_end (int64_t duration_us, int64_t budget_us);
+
+  /**
+   * @brief Records an xrun.
+   *
+   * Realtime-safe. Unlike the other recording methods, this may be called
+   * from any thread (backends may report xruns from their own threads).
+   */
+  void record_xrun (int64_t timestamp_us)
+  {
+    const auto pos = num_xruns_.fetch_add (1, std::memory_order_acq_rel);
+    xrun_timestamps_us_[pos % MAX_XRUN_TIMESTAMPS].store (
+      timestamp_us, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the range of callback processing times counted by the
+   * given histogram bin, in microseconds ([first, second)).
+   *
+   * The second value of the last bin is 0 (unbounded).
+   */
+  static std::pair<int64_t, int64_t> get_bin_range_us (size_t bin);
+
+  /**
+   * @brief Returns the histogram bin for the given processing time.
+   */
+  static size_t get_bin_for_duration (int64_t duration_us);
+
+  /**
+   * @brief Collects the statistics recorded so far.
+   *
+   * Not realtime-safe. Intended to be called from the GUI thread.
+   */
+  Snapshot get_snapshot () const;
+
+  /**
+   * @brief Discards all statistics.
+   *
+   * @warning Must not be called while the engine is processing.
+   */
+  void reset ();
+
+private:
+  std::array<std::atomic<uint64_t>, NUM_HISTOGRAM_BINS> histogram_{};
+
+  std::atomic<uint64_t> num_cycles_ = 0;
+  std::atomic<int64_t>  last_duration_us_ = 0;
+  std::atomic<int64_t>  total_duration_us_ = 0;
+  std::atomic<int64_t>  max_duration_us_ = 0;
+
+  /** Time available for the recorded callbacks (for the mean DSP load). */
+  std::atomic<int64_t> last_budget_us_ = 0;
+  std::atomic<int64_t> total_budget_us_ = 0;
+  std::atomic<double>  max_dsp_load_ = 0.0;
+
+  std::atomic<uint64_t> jitter_count_ = 0;
+  std::atomic<int64_t>  total_jitter_us_ = 0;
+  std::atomic<int64_t>  max_jitter_us_ = 0;
+
+  /** Start of the previous callback (only used by the audio thread). */
+  int64_t last_start_us_ = 0;
+
+  std::atomic<uint64_t>                                  num_xruns_ = 0;
+  std::array<std::atomic<int64_t>, MAX_XRUN_TIMESTAMPS> xrun_timestamps_us_{};
+};
+
+} // namespace zrythm::dsp
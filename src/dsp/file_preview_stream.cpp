@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <optional>
+
+#include "dsp/file_preview_stream.h"
+#include "utils/audio_file.h"
+#include "utils/dsp.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+#include "utils/resampler.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+/** How long the decoding thread sleeps when the rings are full. */
+constexpr int WAIT_FOR_SPACE_MS = 2;
+
+} // namespace
+
+FilePreviewStream::FilePreviewStream (
+  const fs::path         &path,
+  sample_rate_t           sample_rate,
+  size_t                  prefetch_frames,
+  const QualityGovernor * quality_governor)
+    : juce::Thread ("FilePreviewStream"), path_ (path),
+      sample_rate_ (sample_rate), quality_governor_ (quality_governor),
+      ring_l_ (prefetch_frames), ring_r_ (prefetch_frames),
+      read_buf_ (DECODE_CHUNK_FRAMES)
+{
+  startThread (juce::Thread::Priority::normal);
+}
+
+FilePreviewStream::~FilePreviewStream ()
+{
+  stopThread (-1);
+}
+
+size_t
+FilePreviewStream::read (
+  float * dest_l,
+  float * dest_r,
+  size_t  nframes,
+  float   gain)
+{
+  /* the right channel is written last, so it has the least frames */
+  nframes = std::min (nframes, ring_r_.read_space ());
+  size_t done = 0;
+  while (done < nframes)
+    {
+      const auto len = std::min (nframes - done, read_buf_.size ());
+      ring_l_.read_multiple (read_buf_.data (), len);
+      utils::float_ranges::mix_product (
+        &dest_l[done], read_buf_.data (), gain, len);
+      ring_r_.read_multiple (read_buf_.data (), len);
+      utils::float_ranges::mix_product (
+        &dest_r[done], read_buf_.data (), gain, len);
+      done += len;
+    }
+  return done;
+}
+
+void
+FilePreviewStream::run ()
+{
+  try
+    {
+      decode ();
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("failed to stream '{}': {}", path_.string (), e.what ());
+    }
+  decoding_done_.store (true, std::memory_order_release);
+}
+
+void
+FilePreviewStream::decode ()
+{
+  utils::audio::AudioFile file (path_.string ());
+  const auto              metadata = file.read_metadata ();
+  if (metadata.channels <= 0 || metadata.samplerate <= 0)
+    return;
+
+  utils::audio::AudioBuffer in (
+    metadata.channels, static_cast<int> (DECODE_CHUNK_FRAMES));
+  const auto in_l = in.getReadPointer (0);
+  const auto in_r = in.getReadPointer (metadata.channels > 1 ? 1 : 0);
+
+  std::optional<RealtimeResampler> resampler;
+  utils::audio::AudioBuffer        out;
+  if (metadata.samplerate != static_cast<int> (sample_rate_))
+    {
+      resampler.emplace (2, metadata.samplerate, sample_rate_);
+      out.setSize (2, static_cast<int> (DECODE_CHUNK_FRAMES));
+    }
+
+  for (int64_t pos = 0; pos < metadata.num_frames;)
+    {
+      if (threadShouldExit ())
+        return;
+
+      const auto len = static_cast<int> (std::min (
+        static_cast<int64_t> (DECODE_CHUNK_FRAMES), metadata.num_frames - pos));
+      if (!file.reader_->read (&in, 0, len, pos, true, true))
+        {
+          throw ZrythmException (
+            fmt::format ("Failed to read frames at {}", pos));
+        }
+      pos += len;
+
+      if (!resampler)
+        {
+          if (!push (in_l, in_r, static_cast<size_t> (len)))
+            return;
+          continue;
+        }
+
+      const bool fast =
+        quality_governor_ != nullptr && quality_governor_->is_reduced ();
+      if (fast != resampler->is_fast ())
+        {
+          z_info (
+            "Previewing '{}' with {} resampling", path_.string (),
+            fast ? "fast" : "full quality");
+          resampler->set_fast (fast);
+        }
+
+      const float * in_frames[] = { in_l, in_r };
+      size_t        consumed = 0;
+      while (consumed < static_cast<size_t> (len))
+        {
+          const float * in_offset[] = {
+            in_frames[0] + consumed, in_frames[1] + consumed
+          };
+          const auto [num_in, num_out] = resampler->process (
+            in_offset, static_cast<size_t> (len) - consumed,
+            out.getArrayOfWritePointers (), DECODE_CHUNK_FRAMES);
+          consumed += num_in;
+          if (!push (out.getReadPointer (0), out.getReadPointer (1), num_out))
+            return;
+        }
+    }
+}
+
+bool
+FilePreviewStream::push (const float * l, const float * r, size_t nframes)
+{
+  while (nframes > 0)
+    {
+      const auto len = std::min (nframes, ring_l_.write_space ());
+      if (len == 0)
+        {
+          if (threadShouldExit ())
+            return false;
+          wait (WAIT_FOR_SPACE_MS);
+          continue;
+        }
+
+      ring_l_.write_multiple (l, len);
+      ring_r_.write_multiple (r, len);
+      l += len;
+      r += len;
+      nframes -= len;
+    }
+  return !threadShouldExit ();
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "dsp/quality_governor.h"
+#include "utils/ring_buffer.h"
+#include "utils/types.h"
+
+#include "juce_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Streams an audio file from disk for previewing (auditioning).
+ *
+ * A background thread decodes the file in small chunks, resamples them to
+ * the engine's sample rate if needed and pushes them (as stereo) into a
+ * small prefetch buffer that the realtime thread reads from. Playback can
+ * start as soon as the first chunk is decoded, instead of after the whole
+ * file has been loaded.
+ *
+ * Destroying the stream cancels the decoding (at most one chunk is decoded
+ * after cancellation).
+ */
+class FilePreviewStream final : public juce::Thread
+{
+public:
+  /** Default size of the prefetch buffer, in frames. */
+  static constexpr size_t DEFAULT_PREFETCH_FRAMES = 1 << 15;
+
+  /** Number of frames decoded at a time. */
+  static constexpr size_t DECODE_CHUNK_FRAMES = 1024;
+
+public:
+  /**
+   * @brief Starts decoding the given file.
+   *
+   * The file is opened by the decoding thread, so this returns immediately.
+   * Files that fail to open or decode are logged and play as silence.
+   *
+   * @param sample_rate Sample rate to play the file at.
+   * @param quality_governor If given, resampling uses the faster mode while
+   * the governor reduces quality. Must outlive the stream.
+   */
+  FilePreviewStream (
+    const fs::path         &path,
+    sample_rate_t           sample_rate,
+    size_t                  prefetch_frames = DEFAULT_PREFETCH_FRAMES,
+    const QualityGovernor * quality_governor = nullptr);
+  ~FilePreviewStream () override;
+  Z_DISABLE_COPY_MOVE (FilePreviewStream)
+
+  /**
+   * @brief Mixes up to @p nframes decoded frames (multiplied by @p gain)
+   * into the given buffers.
+   *
+   * Frames not decoded yet are skipped (heard as silence). Realtime-safe.
+   *
+   * @return The number of frames mixed.
+   */
+  size_t read (float * dest_l, float * dest_r, size_t nframes, float gain);
+
+  /**
+   * @brief Returns the number of decoded frames ready to be read.
+   */
+  size_t get_num_buffered_frames () const { return ring_r_.read_space (); }
+
+  /**
+   * @brief Returns whether the whole file was decoded and played.
+   */
+  bool is_finished () const
+  {
+    return decoding_done_.load (std::memory_order_acquire)
+           && ring_l_.read_space () == 0;
+  }
+
+private:
+  void run () override;
+
+  /** Decodes the file into the rings until done or cancelled. */
+  void decode ();
+
+  /**
+   * @brief Pushes the given frames into the rings, waiting for space.
+   *
+   * @return False if cancelled.
+   */
+  bool push (const float * l, const float * r, size_t nframes);
+
+private:
+  fs::path      path_;
+  sample_rate_t sample_rate_;
+
+  const QualityGovernor * quality_governor_;
+
+  RingBuffer<float> ring_l_;
+  RingBuffer<float> ring_r_;
+
+  /** Scratch buffer for read() (realtime thread only). */
+  std::vector<float> read_buf_;
+
+  std::atomic<bool> decoding_done_ = false;
+};
+
+} // namespace zrythm::dsp
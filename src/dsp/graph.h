@@ -75,7 +75,20 @@ public:
 
   auto &get_nodes () { return setup_nodes_; }
 
-  void finalize_nodes () { setup_nodes_.finalize_nodes (); }
+  /**
+   * @see GraphNodeCollection::finalize_nodes().
+   */
+  bool finalize_nodes (const GraphNodeCollection * previous = nullptr)
+  {
+    return setup_nodes_.finalize_nodes (previous);
+  }
+
+  /**
+   * @brief Optimization pass to be run after finalize_nodes().
+   *
+   * @see GraphNodeCollection::fuse_linear_chains().
+   */
+  void fuse_linear_chains () { setup_nodes_.fuse_linear_chains (); }
 
 private:
   /**
@@ -23,11 +23,15 @@ public:
    * @brief Populates the graph.
    *
    * @param graph The graph to populate.
+   * @param previous Previous version of the graph, if any, used to only
+   * recalculate the latencies affected by the changes.
+   * @return Whether the topology differs from @p previous.
    */
-  void build_graph (Graph &graph)
+  bool
+  build_graph (Graph &graph, const GraphNodeCollection * previous = nullptr)
   {
     build_graph_impl (graph);
-    graph.finalize_nodes ();
+    return graph.finalize_nodes (previous);
   };
 
 protected:
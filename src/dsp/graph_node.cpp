@@ -26,11 +26,16 @@
  * ---
  */
 
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
 #include <utility>
 
+#include "dsp/anticipative_renderer.h"
 #include "dsp/graph_node.h"
 #include "dsp/itransport.h"
 #include "utils/debug.h"
+#include "utils/tracing.h"
 
 namespace zrythm::dsp
 {
@@ -41,6 +46,9 @@ GraphNode::GraphNode (
   dsp::IProcessable     &processable)
     : node_id_ (id), transport_ (transport), processable_ (processable)
 {
+#if ZRYTHM_TRACING
+  trace_name_ = processable_.get_node_name ();
+#endif
 }
 
 std::string
@@ -48,8 +56,9 @@ GraphNode::print_node_to_str () const
 {
   std::string name = processable_.get_node_name ();
   std::string str1 = fmt::format (
-    "node [({}) {}] refcount: {} | terminal: {} | initial: {} | playback latency: {}",
-    node_id_, name, refcount_.load (), terminal_, initial_, playback_latency_);
+    "node [({}) {}] refcount: {} | terminal: {} | initial: {} | playback latency: {} | priority: {} | fused: {}",
+    node_id_, name, refcount_.load (), terminal_, initial_, playback_latency_,
+    priority_, fused_nodes_.size ());
   std::string str2;
   for (const auto dest : childnodes_)
     {
@@ -69,6 +78,7 @@ GraphNode::print_node () const
 
 void
 GraphNode::compensate_latency (
+  const dsp::ITransport &transport,
   EngineProcessTimeInfo &time_nfo,
   const nframes_t        remaining_preroll_frames) const
 {
@@ -79,9 +89,9 @@ GraphNode::compensate_latency (
    * if the position is before loop-end and position + frames is after
    * loop end (there is a loop inside the range), that should be handled
    * by the ports/processors instead */
-  dsp::Position playhead_copy = transport_.get_playhead_position ();
+  dsp::Position playhead_copy = transport.get_playhead_position ();
   z_return_if_fail (route_playback_latency_ >= remaining_preroll_frames);
-  transport_.position_add_frames (
+  transport.position_add_frames (
     playhead_copy, route_playback_latency_ - remaining_preroll_frames);
   time_nfo.g_start_frame_ = (unsigned_frame_t) playhead_copy.frames_;
   time_nfo.g_start_frame_w_offset_ =
@@ -90,15 +100,13 @@ GraphNode::compensate_latency (
 
 void
 GraphNode::process_chunks_after_splitting_at_loop_points (
+  const dsp::ITransport &transport,
   EngineProcessTimeInfo &time_nfo) const
 {
   /* split at loop points */
   for (
     nframes_t num_processable_frames = 0;
-    (num_processable_frames = std::min (
-       transport_.is_loop_point_met (
-         (signed_frame_t) time_nfo.g_start_frame_w_offset_, time_nfo.nframes_),
-       time_nfo.nframes_))
+    (num_processable_frames = get_frames_until_loop_point (transport, time_nfo))
     != 0;)
     {
       // z_debug (
@@ -113,26 +121,50 @@ GraphNode::process_chunks_after_splitting_at_loop_points (
       // process current chunk
       processable_.process_block (time_nfo);
 
-      /* calculate the remaining frames */
-      time_nfo.nframes_ = orig_nframes - num_processable_frames;
-
-      /* loop back to loop start */
-      auto [transport_loop_start_pos, transport_loop_end_pos] =
-        transport_.get_loop_range_positions ();
-      unsigned_frame_t frames_to_add =
-        (num_processable_frames
-         + (unsigned_frame_t) transport_loop_start_pos.frames_)
-        - (unsigned_frame_t) transport_loop_end_pos.frames_;
-      time_nfo.g_start_frame_w_offset_ += frames_to_add;
-      time_nfo.g_start_frame_ += frames_to_add;
-      time_nfo.local_offset_ += num_processable_frames;
+      time_nfo.nframes_ = orig_nframes;
+      skip_to_loop_start (transport, time_nfo, num_processable_frames);
     }
 }
 
+void
+GraphNode::skip_to_loop_start (
+  const dsp::ITransport &transport,
+  EngineProcessTimeInfo &time_nfo,
+  const nframes_t        num_frames)
+{
+  /* calculate the remaining frames */
+  time_nfo.nframes_ -= num_frames;
+
+  /* loop back to loop start */
+  auto [transport_loop_start_pos, transport_loop_end_pos] =
+    transport.get_loop_range_positions ();
+  unsigned_frame_t frames_to_add =
+    (num_frames + (unsigned_frame_t) transport_loop_start_pos.frames_)
+    - (unsigned_frame_t) transport_loop_end_pos.frames_;
+  time_nfo.g_start_frame_w_offset_ += frames_to_add;
+  time_nfo.g_start_frame_ += frames_to_add;
+  time_nfo.local_offset_ += num_frames;
+}
+
 void
 GraphNode::process (
+  const EngineProcessTimeInfo time_nfo,
+  const nframes_t             remaining_preroll_frames,
+  const bool                  loop_points_handled) const
+{
+  process_self (time_nfo, remaining_preroll_frames, loop_points_handled);
+  for (const auto node : fused_nodes_)
+    {
+      node.get ().process_self (
+        time_nfo, remaining_preroll_frames, loop_points_handled);
+    }
+}
+
+void
+GraphNode::process_self (
   EngineProcessTimeInfo time_nfo,
-  const nframes_t       remaining_preroll_frames) const
+  const nframes_t       remaining_preroll_frames,
+  const bool            loop_points_handled) const
 {
   // if node is bypassed, skip processing
   if (bypass_) [[unlikely]]
@@ -140,6 +172,29 @@ GraphNode::process (
       return;
     }
 
+  Z_TRACE_ZONE_NAMED (trace_name_);
+
+  /* skip or restore the node if its output was rendered ahead */
+  if (anticipative_renderer_ != nullptr) [[unlikely]]
+    {
+      if (anticipative_renderer_->handle_node (
+            processable_, rendered_ahead_boundary_, time_nfo))
+        {
+          return;
+        }
+    }
+
+  process_self_with_transport (
+    transport_, time_nfo, remaining_preroll_frames, loop_points_handled);
+}
+
+void
+GraphNode::process_self_with_transport (
+  const dsp::ITransport &transport,
+  EngineProcessTimeInfo  time_nfo,
+  const nframes_t        remaining_preroll_frames,
+  const bool             loop_points_handled) const
+{
   // z_info ("processing {}", get_name ());
 
   /* skip if we are doing a no-roll */
@@ -148,13 +203,16 @@ GraphNode::process (
       return;
     }
 
-  /* compensate latency when rolling */
-  if (transport_.get_play_state () == dsp::ITransport::PlayState::Rolling)
+  if (!loop_points_handled)
     {
-      compensate_latency (time_nfo, remaining_preroll_frames);
-    }
+      /* compensate latency when rolling */
+      if (transport.get_play_state () == dsp::ITransport::PlayState::Rolling)
+        {
+          compensate_latency (transport, time_nfo, remaining_preroll_frames);
+        }
 
-  process_chunks_after_splitting_at_loop_points (time_nfo);
+      process_chunks_after_splitting_at_loop_points (transport, time_nfo);
+    }
 
   z_return_if_fail_cmp (
     time_nfo.g_start_frame_w_offset_, >=, time_nfo.g_start_frame_);
@@ -298,6 +356,217 @@ GraphNodeCollection::update_latencies ()
     max_playback_latency, 0);
 }
 
+void
+GraphNodeCollection::update_latencies_incrementally (
+  std::span<GraphNode * const> changed_nodes)
+{
+  apply_latency_updates (compute_latency_updates (changed_nodes));
+}
+
+std::vector<GraphNodeCollection::LatencyUpdate>
+GraphNodeCollection::compute_latency_updates (
+  std::span<GraphNode * const> changed_nodes) const
+{
+  /* collect the nodes whose own latency changed along with the changed nodes
+   * and everything upstream of them */
+  std::unordered_map<GraphNode *, nframes_t> playback_latencies;
+  std::unordered_set<GraphNode *>            affected;
+  std::vector<GraphNode *>                   stack (
+    changed_nodes.begin (), changed_nodes.end ());
+  for (const auto &node : graph_nodes_)
+    {
+      const auto latency = node->get_single_playback_latency ();
+      if (latency != node->playback_latency_)
+        {
+          playback_latencies[node.get ()] = latency;
+          stack.push_back (node.get ());
+        }
+    }
+  while (!stack.empty ())
+    {
+      auto * node = stack.back ();
+      stack.pop_back ();
+      if (!affected.insert (node).second)
+        continue;
+
+      for (const auto parent : node->get_parent_nodes ())
+        {
+          stack.push_back (std::addressof (parent.get ()));
+        }
+    }
+
+  if (affected.empty ())
+    {
+      return {};
+    }
+
+  z_debug (
+    "updating latencies of {} of {} graph nodes...", affected.size (),
+    graph_nodes_.size ());
+
+  /* the route playback latency of a node is the highest playback latency of
+   * itself and any node downstream of it, so compute it children-first
+   * (children are looked up through the parent links, which unlike
+   * childnodes_ are not changed by fusing) */
+  std::unordered_map<GraphNode *, std::vector<GraphNode *>> children;
+  std::unordered_map<GraphNode *, int>                      remaining_children;
+  for (const auto &node : graph_nodes_)
+    {
+      for (const auto parent : node->get_parent_nodes ())
+        {
+          auto * parent_ptr = std::addressof (parent.get ());
+          if (affected.contains (parent_ptr))
+            {
+              children[parent_ptr].push_back (node.get ());
+              if (affected.contains (node.get ()))
+                {
+                  ++remaining_children[parent_ptr];
+                }
+            }
+        }
+    }
+
+  for (auto * node : affected)
+    {
+      if (remaining_children[node] == 0)
+        {
+          stack.push_back (node);
+        }
+    }
+  std::unordered_map<GraphNode *, nframes_t> route_latencies;
+  std::vector<LatencyUpdate>                 updates;
+  while (!stack.empty ())
+    {
+      auto * node = stack.back ();
+      stack.pop_back ();
+
+      const auto it = playback_latencies.find (node);
+      const auto playback_latency =
+        it != playback_latencies.end () ? it->second : node->playback_latency_;
+      auto route_latency = playback_latency;
+      for (auto * child : children[node])
+        {
+          route_latency = std::max (
+            route_latency, affected.contains (child)
+                             ? route_latencies.at (child)
+                             : child->route_playback_latency_);
+        }
+      route_latencies[node] = route_latency;
+      if (
+        playback_latency != node->playback_latency_
+        || route_latency != node->route_playback_latency_)
+        {
+          updates.push_back (LatencyUpdate{
+            .node_ = node,
+            .playback_latency_ = playback_latency,
+            .route_playback_latency_ = route_latency });
+        }
+
+      for (const auto parent : node->get_parent_nodes ())
+        {
+          if (--remaining_children[std::addressof (parent.get ())] == 0)
+            {
+              stack.push_back (std::addressof (parent.get ()));
+            }
+        }
+    }
+  z_warn_if_fail (route_latencies.size () == affected.size ());
+  return updates;
+}
+
+void
+GraphNodeCollection::apply_latency_updates (
+  std::span<const LatencyUpdate> updates)
+{
+  for (const auto &update : updates)
+    {
+      update.node_->playback_latency_ = update.playback_latency_;
+      update.node_->route_playback_latency_ = update.route_playback_latency_;
+    }
+}
+
+std::vector<GraphNode *>
+GraphNodeCollection::get_nodes_with_changed_connections (
+  const GraphNodeCollection &previous) const
+{
+  using Connections = std::unordered_set<const IProcessable *>;
+  const auto get_children = [] (const GraphNodeCollection &collection) {
+    std::unordered_map<const IProcessable *, Connections> ret;
+    for (const auto &node : collection.graph_nodes_)
+      {
+        ret[std::addressof (node->get_processable ())];
+        for (const auto parent : node->get_parent_nodes ())
+          {
+            ret[std::addressof (parent.get ().get_processable ())].insert (
+              std::addressof (node->get_processable ()));
+          }
+      }
+    return ret;
+  };
+
+  const auto children = get_children (*this);
+  const auto prev_children = get_children (previous);
+
+  std::vector<GraphNode *> ret;
+  for (const auto &node : graph_nodes_)
+    {
+      const auto it =
+        prev_children.find (std::addressof (node->get_processable ()));
+      if (
+        it == prev_children.end ()
+        || it->second
+             != children.at (std::addressof (node->get_processable ())))
+        {
+          ret.push_back (node.get ());
+        }
+    }
+  return ret;
+}
+
+bool
+GraphNodeCollection::finalize_nodes (const GraphNodeCollection * previous)
+{
+  set_initial_and_terminal_nodes ();
+
+  bool topology_changed = true;
+  if (previous != nullptr)
+    {
+      /* start from the previous latencies and only update what changed */
+      std::unordered_map<const IProcessable *, const GraphNode *> prev_nodes;
+      prev_nodes.reserve (previous->graph_nodes_.size ());
+      for (const auto &node : previous->graph_nodes_)
+        {
+          prev_nodes.emplace (
+            std::addressof (node->get_processable ()), node.get ());
+        }
+      for (auto &node : graph_nodes_)
+        {
+          if (
+            auto it =
+              prev_nodes.find (std::addressof (node->get_processable ()));
+            it != prev_nodes.end ())
+            {
+              node->playback_latency_ = it->second->playback_latency_;
+              node->route_playback_latency_ =
+                it->second->route_playback_latency_;
+            }
+        }
+
+      const auto changed_nodes = get_nodes_with_changed_connections (*previous);
+      update_latencies_incrementally (changed_nodes);
+      topology_changed =
+        !changed_nodes.empty ()
+        || graph_nodes_.size () != previous->graph_nodes_.size ();
+    }
+  else
+    {
+      update_latencies ();
+    }
+
+  update_critical_path_priorities ();
+  return topology_changed;
+}
+
 void
 GraphNodeCollection::set_initial_and_terminal_nodes ()
 {
@@ -305,6 +574,9 @@ GraphNodeCollection::set_initial_and_terminal_nodes ()
   trigger_nodes_.clear ();
   for (const auto &node : graph_nodes_)
     {
+      if (node->fused_)
+        continue;
+
       if (node->childnodes_.empty ())
         {
           /* terminal node */
@@ -320,6 +592,291 @@ GraphNodeCollection::set_initial_and_terminal_nodes ()
     }
 }
 
+void
+GraphNodeCollection::update_critical_path_priorities ()
+{
+  topological_order_.clear ();
+  if (graph_nodes_.empty ())
+    {
+      return;
+    }
+
+  /* use the average measured cost for nodes that were never measured (or 1 if
+   * nothing was measured yet, in which case the cost is the path length) */
+  double total_measured_cost = 0.0;
+  size_t num_measured = 0;
+  for (const auto &node : graph_nodes_)
+    {
+      if (node->fused_)
+        continue;
+
+      const auto cost = node->processing_cost_ns_.load ();
+      if (cost > 0.f)
+        {
+          total_measured_cost += cost;
+          ++num_measured;
+        }
+    }
+  const double default_cost =
+    num_measured > 0 ? total_measured_cost / static_cast<double> (num_measured)
+                     : 1.0;
+
+  /* topologically sort the nodes (Kahn's algorithm) */
+  std::unordered_map<const GraphNode *, int> remaining_parents;
+  remaining_parents.reserve (graph_nodes_.size ());
+  std::vector<GraphNode *> sorted;
+  sorted.reserve (graph_nodes_.size ());
+  size_t num_scheduled_nodes = 0;
+  for (const auto &node : graph_nodes_)
+    {
+      if (node->fused_)
+        continue;
+
+      ++num_scheduled_nodes;
+      remaining_parents[node.get ()] = node->init_refcount_;
+      if (node->init_refcount_ == 0)
+        {
+          sorted.push_back (node.get ());
+        }
+    }
+  for (size_t i = 0; i < sorted.size (); ++i)
+    {
+      for (const auto child : sorted[i]->childnodes_)
+        {
+          if (--remaining_parents[std::addressof (child.get ())] == 0)
+            {
+              sorted.push_back (std::addressof (child.get ()));
+            }
+        }
+    }
+  z_return_if_fail (sorted.size () == num_scheduled_nodes);
+  topological_order_.reserve (sorted.size ());
+  for (auto * node : sorted)
+    {
+      topological_order_.emplace_back (*node);
+    }
+
+  /* walk backwards from the terminal nodes accumulating the most expensive
+   * downstream path */
+  double max_cost = 0.0;
+  for (auto * node : std::views::reverse (sorted))
+    {
+      double max_child_cost = 0.0;
+      for (const auto child : node->childnodes_)
+        {
+          max_child_cost =
+            std::max (max_child_cost, child.get ().critical_path_cost_);
+        }
+      /* the measured cost of a node includes its fused nodes */
+      const auto measured_cost = node->processing_cost_ns_.load ();
+      node->critical_path_cost_ =
+        (measured_cost > 0.f
+           ? measured_cost
+           : default_cost * static_cast<double> (1 + node->fused_nodes_.size ()))
+        + max_child_cost;
+      max_cost = std::max (max_cost, node->critical_path_cost_);
+    }
+
+  for (auto &node : graph_nodes_)
+    {
+      if (node->fused_)
+        continue;
+
+      node->priority_ = std::clamp (
+        static_cast<int> (
+          node->critical_path_cost_ / max_cost
+          * (GraphNode::NUM_PRIORITY_LEVELS - 1)),
+        0, GraphNode::NUM_PRIORITY_LEVELS - 1);
+
+      std::ranges::stable_sort (
+        node->childnodes_, std::ranges::greater{},
+        [] (const auto &child) { return child.get ().critical_path_cost_; });
+    }
+  std::ranges::stable_sort (
+    trigger_nodes_, std::ranges::greater{},
+    [] (const auto &node) { return node.get ().critical_path_cost_; });
+}
+
+void
+GraphNodeCollection::copy_processing_costs_from (
+  const GraphNodeCollection &other)
+{
+  std::unordered_map<const IProcessable *, const GraphNode *> other_nodes;
+  other_nodes.reserve (other.graph_nodes_.size ());
+  for (const auto &node : other.graph_nodes_)
+    {
+      other_nodes.emplace (
+        std::addressof (node->get_processable ()), node.get ());
+    }
+  for (auto &node : graph_nodes_)
+    {
+      if (
+        auto it = other_nodes.find (std::addressof (node->get_processable ()));
+        it != other_nodes.end ())
+        {
+          node->processing_cost_ns_.store (
+            it->second->processing_cost_ns_.load ());
+          node->numa_node_ = it->second->numa_node_;
+        }
+    }
+}
+
+std::vector<std::vector<GraphNode *>>
+GraphNodeCollection::get_placement_groups () const
+{
+  const auto num_nodes = topological_order_.size ();
+  std::unordered_map<const GraphNode *, size_t> indices;
+  indices.reserve (num_nodes);
+  for (size_t i = 0; i < num_nodes; ++i)
+    {
+      indices.emplace (std::addressof (topological_order_[i].get ()), i);
+    }
+
+  /* union-find over the indices in the topological order */
+  std::vector<size_t> roots (num_nodes);
+  std::iota (roots.begin (), roots.end (), size_t{ 0 });
+  const auto find_root = [&] (size_t i) {
+    while (roots[i] != i)
+      {
+        roots[i] = roots[roots[i]];
+        i = roots[i];
+      }
+    return i;
+  };
+  const auto join = [&] (size_t a, size_t b) {
+    roots[find_root (a)] = find_root (b);
+  };
+
+  std::vector<size_t> num_parents (num_nodes, 0);
+  std::vector<size_t> last_parents (num_nodes, 0);
+  for (size_t i = 0; i < num_nodes; ++i)
+    {
+      for (const auto child : topological_order_[i].get ().childnodes_)
+        {
+          const auto child_index = indices.at (std::addressof (child.get ()));
+          ++num_parents[child_index];
+          last_parents[child_index] = i;
+        }
+    }
+  for (size_t i = 0; i < num_nodes; ++i)
+    {
+      const auto &children = topological_order_[i].get ().childnodes_;
+      if (num_parents[i] == 1)
+        {
+          join (i, last_parents[i]);
+        }
+      else if (num_parents[i] == 0 && children.size () == 1)
+        {
+          join (i, indices.at (std::addressof (children.front ().get ())));
+        }
+    }
+
+  std::vector<std::vector<GraphNode *>> groups;
+  std::unordered_map<size_t, size_t>    group_indices;
+  for (size_t i = 0; i < num_nodes; ++i)
+    {
+      const auto [it, inserted] =
+        group_indices.try_emplace (find_root (i), groups.size ());
+      if (inserted)
+        {
+          groups.emplace_back ();
+        }
+      groups[it->second].push_back (
+        std::addressof (topological_order_[i].get ()));
+    }
+  return groups;
+}
+
+size_t
+GraphNodeCollection::remove_nodes_not_upstream_of (
+  std::span<GraphNode * const> sinks)
+{
+  /* collect the sinks and everything upstream of them */
+  std::unordered_set<const GraphNode *> kept;
+  std::vector<const GraphNode *>        to_visit (sinks.begin (), sinks.end ());
+  for (const auto special : special_nodes_)
+    {
+      to_visit.push_back (std::addressof (special.get ()));
+    }
+  while (!to_visit.empty ())
+    {
+      const auto * node = to_visit.back ();
+      to_visit.pop_back ();
+      if (!kept.insert (node).second)
+        continue;
+
+      for (const auto parent : node->get_parent_nodes ())
+        {
+          to_visit.push_back (std::addressof (parent.get ()));
+        }
+    }
+
+  /* the parents of the kept nodes are all kept, so only the edges to their
+   * children need to be dropped */
+  const auto is_removed = [&kept] (const auto &node) {
+    return !kept.contains (std::addressof (node.get ()));
+  };
+  for (auto &node : graph_nodes_)
+    {
+      if (kept.contains (node.get ()))
+        std::erase_if (node->childnodes_, is_removed);
+    }
+
+  const auto num_removed =
+    std::erase_if (graph_nodes_, [&kept] (const auto &node) {
+      return !kept.contains (node.get ());
+    });
+  z_debug (
+    "removed {} nodes not upstream of {} sinks", num_removed, sinks.size ());
+  return num_removed;
+}
+
+void
+GraphNodeCollection::fuse_linear_chains ()
+{
+  const auto is_special = [this] (const GraphNode &node) {
+    return std::ranges::any_of (special_nodes_, [&] (const auto special) {
+      return std::addressof (special.get ()) == std::addressof (node);
+    });
+  };
+
+  size_t num_fused = 0;
+  for (auto &node : graph_nodes_)
+    {
+      if (node->fused_ || is_special (*node))
+        continue;
+
+      while (node->childnodes_.size () == 1)
+        {
+          auto &child = node->childnodes_.front ().get ();
+          if (
+            std::addressof (child) == node.get () || child.init_refcount_ != 1
+            || is_special (child))
+            break;
+
+          /* the child may itself be the head of a chain fused earlier */
+          node->fused_nodes_.emplace_back (child);
+          node->fused_nodes_.insert (
+            node->fused_nodes_.end (), child.fused_nodes_.begin (),
+            child.fused_nodes_.end ());
+          child.fused_nodes_.clear ();
+          child.fused_ = true;
+          child.terminal_ = false;
+          child.initial_ = false;
+
+          /* take over the child's outgoing edges (the grandchildren's
+           * reference counts stay the same) */
+          node->childnodes_ = child.childnodes_;
+          ++num_fused;
+        }
+    }
+
+  set_initial_and_terminal_nodes ();
+  update_critical_path_priorities ();
+
+  z_debug ("fused {} of {} graph nodes", num_fused, graph_nodes_.size ());
+}
+
 dsp::GraphNode *
 GraphNodeCollection::find_node_for_processable (
   const dsp::IProcessable &processable) const
@@ -29,12 +29,20 @@
 #ifndef ZRYTHM_DSP_GRAPH_NODE_H
 #define ZRYTHM_DSP_GRAPH_NODE_H
 
+#include "zrythm-config.h"
+
+#include "dsp/graph_node_stats.h"
 #include "dsp/itransport.h"
 #include "utils/types.h"
 
+#include <algorithm>
+#include <span>
+
 namespace zrythm::dsp
 {
 
+class AnticipativeRenderer;
+
 /**
  * @brief Interface for objects that can be processed in the DSP graph.
  *
@@ -73,6 +81,69 @@ public:
   {
     return false;
   };
+
+  /**
+   * @brief Returns whether the output of this processable only depends on the
+   * timeline, so that it can be rendered ahead of the playhead (see
+   * AnticipativeRenderer).
+   *
+   * Processables that take live input (hardware inputs, MIDI played by the
+   * user, or anything else not derived from the project) must return false.
+   * When rendered ahead, process_block() must derive all timing from the
+   * given time info.
+   */
+  virtual bool can_render_ahead () const { return false; }
+
+  /**
+   * @brief Called when the processable starts or stops being rendered ahead.
+   *
+   * While rendered ahead, the buffers of the processable are owned by the
+   * thread rendering it, so they must be skipped by the engine's per-cycle
+   * buffer clearing. clear_rendered_ahead_buffers() is called instead.
+   */
+  virtual void set_rendered_ahead (bool rendered_ahead) { }
+
+  /**
+   * @brief Clears the buffers that the engine normally clears before each
+   * cycle, while rendered ahead.
+   */
+  virtual void clear_rendered_ahead_buffers () { }
+
+  /**
+   * @brief Returns whether the output of this processable can be rendered
+   * ahead into separate slots and restored later.
+   *
+   * Only processables whose output is computed from the buffers of their
+   * parent nodes (and not written to by them) can support this. These can be
+   * at the edge of the part of the graph that is rendered ahead.
+   */
+  virtual bool can_store_rendered_ahead_output () const { return false; }
+
+  /**
+   * @brief Allocates @p num_slots slots of @p block_length frames for
+   * render_ahead_into_slot().
+   */
+  virtual void
+  allocate_rendered_ahead_slots (size_t num_slots, nframes_t block_length)
+  {
+  }
+
+  /**
+   * @brief Computes the output for @p time_nfo into @p slot, leaving the live
+   * buffers untouched.
+   */
+  virtual void
+  render_ahead_into_slot (size_t slot, EngineProcessTimeInfo time_nfo)
+  {
+  }
+
+  /**
+   * @brief Makes the output stored in @p slot the live output, as if
+   * process_block() had been called for @p time_nfo.
+   */
+  virtual void restore_from_slot (size_t slot, EngineProcessTimeInfo time_nfo)
+  {
+  }
 };
 
 class InitialProcessor final : public IProcessable
@@ -104,6 +175,13 @@ class GraphNode
 public:
   using NodeId = int;
 
+  /**
+   * @brief Number of priority levels used when dispatching ready nodes.
+   *
+   * @see priority_.
+   */
+  static constexpr int NUM_PRIORITY_LEVELS = 8;
+
   GraphNode (
     NodeId                 id,
     const dsp::ITransport &transport,
@@ -116,7 +194,19 @@ public:
   void print_node () const;
 
   /**
-   * Processes the GraphNode.
+   * @brief Returns the approximate number of bytes used by the node (not
+   * including its processable).
+   */
+  size_t get_memory_usage () const
+  {
+    return sizeof (*this)
+           + (childnodes_.capacity () + parentnodes_.capacity ()
+              + fused_nodes_.capacity ())
+               * sizeof (std::reference_wrapper<GraphNode>);
+  }
+
+  /**
+   * Processes the GraphNode, followed by any nodes fused into it.
    *
    * @param remaining_preroll_frames The number of frames remaining for preroll
    * (as part of playback latency adjustment).
@@ -124,10 +214,29 @@ public:
    * currently in progress (and this function is called as part of it), as
    * opposed to being called before/after a processing cycle (e.g., for some
    * special nodes that are processed before/after the actual processing).
+   * @param loop_points_handled Whether @p time_nfo was already split at the
+   * loop points and latency-compensated for the whole graph (see
+   * GraphScheduler::run_cycle()), in which case it is used as is.
+   */
+  [[gnu::hot]] void process (
+    EngineProcessTimeInfo time_nfo,
+    nframes_t             remaining_preroll_frames,
+    bool                  loop_points_handled = false) const;
+
+  /**
+   * @brief Processes only this node for a block that is rendered ahead of the
+   * playhead.
+   *
+   * Used by AnticipativeRenderer.
+   *
+   * @param transport Transport whose playhead is at the start of the block.
    */
-  [[gnu::hot]] void
-  process (EngineProcessTimeInfo time_nfo, nframes_t remaining_preroll_frames)
-    const;
+  [[gnu::hot]] void process_ahead (
+    EngineProcessTimeInfo  time_nfo,
+    const dsp::ITransport &transport) const
+  {
+    process_self_with_transport (transport, time_nfo, 0);
+  }
 
   nframes_t get_single_playback_latency () const
   {
@@ -156,8 +265,46 @@ public:
   void set_skip_processing (bool skip) { bypass_ = skip; }
 
   IProcessable &get_processable () { return processable_; }
+  const dsp::ITransport &get_transport () const { return transport_; }
+  const IProcessable &get_processable () const { return processable_; }
+
+  /**
+   * @brief Returns the upstream nodes as connected (not affected by fusing).
+   */
+  const auto &get_parent_nodes () const { return parentnodes_; }
+
+  /**
+   * @brief Feeds a new processing time measurement into the cost estimate.
+   *
+   * Only called by the thread that processed the node.
+   *
+   * @param ns Time taken by process(), in nanoseconds.
+   */
+  void add_processing_cost_sample (float ns)
+  {
+    const auto prev = processing_cost_ns_.load (std::memory_order_relaxed);
+    processing_cost_ns_.store (
+      prev > 0.f ? prev + (ns - prev) * 0.25f : ns, std::memory_order_relaxed);
+  }
 
 private:
+  /**
+   * @brief Processes only this node (without the fused nodes).
+   */
+  [[gnu::hot]] void process_self (
+    EngineProcessTimeInfo time_nfo,
+    nframes_t             remaining_preroll_frames,
+    bool                  loop_points_handled) const;
+
+  /**
+   * @brief Processes only this node using the timing of @p transport.
+   */
+  [[gnu::hot]] void process_self_with_transport (
+    const dsp::ITransport &transport,
+    EngineProcessTimeInfo  time_nfo,
+    nframes_t              remaining_preroll_frames,
+    bool                   loop_points_handled = false) const;
+
   void add_feeds (GraphNode &dest);
   void add_depends (GraphNode &src);
 
@@ -168,10 +315,18 @@ private:
    * latency and remaining preroll frames. This ensures proper timing when
    * processing nodes with different latencies in the signal chain.
    *
+   * Compensation is done by processing each route ahead of the playhead by its
+   * route latency (like Ardour), rather than by delaying the output of faster
+   * routes. No delay buffers are involved, so changes in plugin latency only
+   * require updating @ref route_playback_latency_ (see
+   * GraphNodeCollection::update_latencies_incrementally()).
+   *
+   * @param transport Transport to take the playhead from
    * @param time_nfo Time info to be adjusted
    * @param remaining_preroll_frames Frames remaining in preroll period
    */
   [[gnu::hot]] void compensate_latency (
+    const dsp::ITransport &transport,
     EngineProcessTimeInfo &time_nfo,
     nframes_t              remaining_preroll_frames) const;
 
@@ -182,11 +337,37 @@ private:
    * transport loop points, ensuring seamless audio playback during looping.
    * Updates time info to handle loop point transitions correctly.
    *
+   * @param transport Transport to take the loop points from
    * @param time_nfo Time info containing frame counts and offsets
    */
   [[gnu::hot]] void process_chunks_after_splitting_at_loop_points (
+    const dsp::ITransport &transport,
     EngineProcessTimeInfo &time_nfo) const;
 
+public:
+  /**
+   * @brief Returns the number of frames of @p time_nfo before the loop end
+   * point, or 0 if the loop end point is not met.
+   */
+  [[gnu::hot]] static nframes_t get_frames_until_loop_point (
+    const dsp::ITransport       &transport,
+    const EngineProcessTimeInfo &time_nfo)
+  {
+    return std::min (
+      transport.is_loop_point_met (
+        (signed_frame_t) time_nfo.g_start_frame_w_offset_, time_nfo.nframes_),
+      time_nfo.nframes_);
+  }
+
+  /**
+   * @brief Advances @p time_nfo past the first @p num_frames frames (up to
+   * the loop end point) and moves its start to the loop start point.
+   */
+  [[gnu::hot]] static void skip_to_loop_start (
+    const dsp::ITransport &transport,
+    EngineProcessTimeInfo &time_nfo,
+    nframes_t              num_frames);
+
 public:
   /** Incoming node count. */
   std::atomic<int> refcount_ = 0;
@@ -212,6 +393,89 @@ public:
   bool terminal_ = false;
   bool initial_ = false;
 
+  /**
+   * @brief Moving average of the time it takes to process this node, in
+   * nanoseconds (0 if never measured).
+   *
+   * Updated by the scheduler on sampled cycles.
+   */
+  std::atomic<float> processing_cost_ns_ = 0.f;
+
+  /**
+   * @brief Cost of the most expensive path from this node (inclusive) to a
+   * terminal node.
+   *
+   * Set by GraphNodeCollection::update_critical_path_priorities().
+   */
+  double critical_path_cost_ = 0.0;
+
+  /**
+   * @brief Dispatch priority derived from @ref critical_path_cost_, from 0
+   * (lowest) to NUM_PRIORITY_LEVELS - 1 (on the critical path).
+   */
+  int priority_ = 0;
+
+  /**
+   * @brief Trace lane of the thread that last processed this node (see
+   * GraphScheduler::get_thread_names()), or -1 if unknown.
+   *
+   * Updated by the scheduler on sampled cycles.
+   */
+  std::atomic<int> last_thread_lane_ = -1;
+
+  /**
+   * @brief NUMA node whose threads should preferably process this node, or
+   * -1 for any.
+   *
+   * Set by the scheduler when its threads span several NUMA nodes (see
+   * GraphScheduler::get_numa_placement()).
+   */
+  int numa_node_ = -1;
+
+  /**
+   * @brief Downstream nodes fused into this node, in processing order.
+   *
+   * These are processed inline right after this node instead of being
+   * scheduled separately.
+   *
+   * @see GraphNodeCollection::fuse_linear_chains().
+   */
+  std::vector<std::reference_wrapper<GraphNode>> fused_nodes_;
+
+  /**
+   * @brief Whether this node was fused into another node (and is therefore
+   * not scheduled on its own).
+   */
+  bool fused_ = false;
+
+  /**
+   * @brief The renderer this node is rendered ahead by, if any.
+   *
+   * Set by AnticipativeRenderer::assign_nodes().
+   */
+  AnticipativeRenderer * anticipative_renderer_ = nullptr;
+
+  /**
+   * @brief Whether this node is rendered ahead and feeds nodes that are not,
+   * in which case its output is restored from the renderer's slots.
+   */
+  bool rendered_ahead_boundary_ = false;
+
+#if ZRYTHM_DSP_NODE_PROFILING
+  /**
+   * @brief Processing time statistics, recorded on every cycle.
+   */
+  GraphNodeStats stats_;
+#endif
+
+#if ZRYTHM_TRACING
+  /**
+   * @brief Name of the profiler zone for this node (cached on construction so
+   * that it isn't created on the realtime thread).
+   */
+  std::string trace_name_;
+#endif
+
 private:
   NodeId node_id_ = 0;
 
@@ -241,6 +505,17 @@ private:
  */
 class GraphNodeCollection
 {
+public:
+  /**
+   * @brief New latencies of a node (see compute_latency_updates()).
+   */
+  struct LatencyUpdate
+  {
+    GraphNode * node_ = nullptr;
+    nframes_t   playback_latency_ = 0;
+    nframes_t   route_playback_latency_ = 0;
+  };
+
 public:
   /**
    * Returns the max playback latency of the trigger nodes.
@@ -254,19 +529,129 @@ public:
    */
   void update_latencies ();
 
+  /**
+   * @brief Updates the latencies of only the nodes affected by a change.
+   *
+   * The route playback latency of a node depends only on the nodes downstream
+   * of it, so only @p changed_nodes, the nodes whose own latency changed and
+   * everything upstream of them are recalculated. All other nodes are assumed
+   * to already have up-to-date latencies.
+   *
+   * @param changed_nodes Nodes added or whose outgoing connections changed
+   * since the latencies were last calculated.
+   */
+  void
+  update_latencies_incrementally (std::span<GraphNode * const> changed_nodes);
+
+  /**
+   * @brief Computes the latencies update_latencies_incrementally() would set,
+   * without modifying any node.
+   *
+   * This allows calculating the new latencies while the graph is being
+   * processed and applying them at a cycle boundary (see
+   * apply_latency_updates()).
+   *
+   * @return The nodes whose latencies change, with their new latencies.
+   */
+  std::vector<LatencyUpdate> compute_latency_updates (
+    std::span<GraphNode * const> changed_nodes) const;
+
+  /**
+   * @brief Sets the latencies computed by compute_latency_updates().
+   *
+   * Realtime-safe.
+   */
+  [[gnu::hot]] static void
+  apply_latency_updates (std::span<const LatencyUpdate> updates);
+
+  /**
+   * @brief Returns the nodes whose outgoing connections differ from those of
+   * the corresponding nodes (with the same processable) in @p previous.
+   *
+   * Nodes that don't exist in @p previous are included. Nodes that were
+   * removed are not (they are not part of this collection), but any remaining
+   * node that was connected to them is.
+   */
+  std::vector<GraphNode *> get_nodes_with_changed_connections (
+    const GraphNodeCollection &previous) const;
+
   /**
    * @brief Updates the initial and terminal nodes based on @ref graph_nodes_.
    */
   void set_initial_and_terminal_nodes ();
 
+  /**
+   * @brief Computes the critical path cost and priority of each node.
+   *
+   * The cost of each node is its measured processing time (or the average
+   * measured time if it was never measured). Child nodes and trigger nodes are
+   * then sorted by descending critical path cost so that the most critical
+   * work is dispatched first. @ref topological_order_ is also updated.
+   *
+   * @note Requires calling set_initial_and_terminal_nodes() first.
+   */
+  void update_critical_path_priorities ();
+
+  /**
+   * @brief Fuses linear chains of nodes into single scheduling units.
+   *
+   * Every node whose only parent has no other children is appended to the
+   * parent's @ref GraphNode::fused_nodes_ and taken out of the schedule, so
+   * that the chain is processed back to back by a single thread without
+   * going through the scheduler for each node. Special nodes are never
+   * fused.
+   *
+   * @note Requires calling finalize_nodes() first. Trigger/terminal nodes and
+   * priorities are recomputed.
+   */
+  void fuse_linear_chains ();
+
+  /**
+   * @brief Copies the processing cost estimates and NUMA nodes from the nodes
+   * in @p other that have the same processable.
+   *
+   * Used to keep the measurements (and avoid moving memory around) when the
+   * graph is rebuilt.
+   */
+  void copy_processing_costs_from (const GraphNodeCollection &other);
+
+  /**
+   * @brief Splits the scheduled nodes into groups that should be processed on
+   * the same NUMA node, roughly one per track.
+   *
+   * A node with a single parent joins the parent's group, and a trigger node
+   * with a single child joins the child's group (e.g., the inputs of a
+   * processor). Nodes where several chains meet (e.g., the inputs of group
+   * tracks and the master track) start a new group.
+   *
+   * Nodes fused into others are not included (they follow their head node).
+   *
+   * @note Requires calling update_critical_path_priorities() first. The groups
+   * are in topological order of their first node.
+   */
+  std::vector<std::vector<GraphNode *>> get_placement_groups () const;
+
+  /**
+   * @brief Removes all nodes that don't feed (directly or indirectly) any of
+   * @p sinks or any special node.
+   *
+   * Used to process only the part of the graph that contributes to some
+   * outputs (e.g., when bouncing a single track).
+   *
+   * @note To be called before finalize_nodes().
+   * @return The number of nodes removed.
+   */
+  size_t remove_nodes_not_upstream_of (std::span<GraphNode * const> sinks);
+
   /**
    * @brief To be called when all nodes have been added.
+   *
+   * @param previous Previous version of this graph, if any. If given, only the
+   * latencies of the nodes affected by the changes are recalculated.
+   * @return Whether the topology differs from @p previous (always true if
+   * @p previous is not given).
    */
-  void finalize_nodes ()
-  {
-    set_initial_and_terminal_nodes ();
-    update_latencies ();
-  }
+  bool finalize_nodes (const GraphNodeCollection * previous = nullptr);
 
   dsp::GraphNode *
   find_node_for_processable (const dsp::IProcessable &processable) const;
@@ -294,6 +679,14 @@ public:
    */
   std::vector<std::reference_wrapper<dsp::GraphNode>> terminal_nodes_;
 
+  /**
+   * @brief The nodes in @ref graph_nodes_ that are not fused into other nodes,
+   * in topological order.
+   *
+   * Updated by update_critical_path_priorities().
+   */
+  std::vector<std::reference_wrapper<dsp::GraphNode>> topological_order_;
+
   std::unique_ptr<dsp::InitialProcessor> initial_processor_;
 
   /**
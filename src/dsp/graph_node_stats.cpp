@@ -0,0 +1,45 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <numeric>
+
+#include "dsp/graph_node_stats.h"
+
+namespace zrythm::dsp
+{
+
+GraphNodeStats::Snapshot
+GraphNodeStats::get_snapshot () const
+{
+  Snapshot   snapshot;
+  const auto count = count_.load (std::memory_order_acquire);
+  if (count == 0)
+    return snapshot;
+
+  const size_t num_samples =
+    std::min (static_cast<size_t> (count), static_cast<size_t> (WINDOW_SIZE));
+  std::array<uint32_t, WINDOW_SIZE> window{};
+  for (size_t i = 0; i < num_samples; ++i)
+    {
+      window[i] = samples_[i].load (std::memory_order_relaxed);
+    }
+
+  const auto end = window.begin () + static_cast<ptrdiff_t> (num_samples);
+  snapshot.num_samples_ = num_samples;
+  snapshot.last_ns_ =
+    samples_[(count - 1) % WINDOW_SIZE].load (std::memory_order_relaxed);
+  snapshot.mean_ns_ = static_cast<uint32_t> (
+    std::accumulate (window.begin (), end, uint64_t{ 0 }) / num_samples);
+  snapshot.max_ns_ = *std::max_element (window.begin (), end);
+
+  /* nearest-rank percentile */
+  const size_t p99_idx = (num_samples * 99 + 99) / 100 - 1;
+  std::nth_element (
+    window.begin (), window.begin () + static_cast<ptrdiff_t> (p99_idx), end);
+  snapshot.p99_ns_ = window[p99_idx];
+
+  return snapshot;
+}
+
+} // namespace zrythm::dsp
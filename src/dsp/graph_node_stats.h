@@ -0,0 +1,77 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Rolling statistics of the processing time of a graph node.
+ *
+ * Keeps the last @ref WINDOW_SIZE measurements in a ring buffer of relaxed
+ * atomics so that the DSP thread can record samples without locking or
+ * allocating, while the GUI thread takes snapshots at any time.
+ *
+ * There must be only one writer at a time (the thread processing the node).
+ * Snapshots may observe a window that is being written to; this is acceptable
+ * for statistics.
+ */
+class GraphNodeStats
+{
+public:
+  static constexpr size_t WINDOW_SIZE = 256;
+
+  struct Snapshot
+  {
+    /** Number of samples in the window. */
+    size_t num_samples_ = 0;
+
+    uint32_t last_ns_ = 0;
+    uint32_t mean_ns_ = 0;
+    uint32_t p99_ns_ = 0;
+    uint32_t max_ns_ = 0;
+  };
+
+public:
+  /**
+   * @brief Records a processing time measurement.
+   *
+   * Realtime-safe.
+   */
+  [[gnu::hot]] void record (uint64_t ns)
+  {
+    const auto pos = count_.load (std::memory_order_relaxed);
+    samples_[pos % WINDOW_SIZE].store (
+      ns > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t> (ns),
+      std::memory_order_relaxed);
+    count_.store (pos + 1, std::memory_order_release);
+  }
+
+  /**
+   * @brief Computes the statistics of the current window.
+   *
+   * Not realtime-safe. Intended to be called from the GUI thread.
+   */
+  Snapshot get_snapshot () const;
+
+  /**
+   * @brief Discards all samples.
+   *
+   * @warning Must not be called while the node is being processed.
+   */
+  void reset () { count_.store (0, std::memory_order_relaxed); }
+
+private:
+  std::array<std::atomic<uint32_t>, WINDOW_SIZE> samples_{};
+
+  /** Total number of samples recorded. */
+  std::atomic<uint64_t> count_ = 0;
+};
+
+} // namespace zrythm::dsp
@@ -0,0 +1,247 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cstdlib>
+#include <ranges>
+#include <unordered_map>
+
+#include "dsp/graph_node.h"
+#include "dsp/graph_profile.h"
+#include "utils/exceptions.h"
+
+#include <fmt/format.h>
+#include <yyjson.h>
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+/** Escapes @p str for use in a double-quoted DOT string. */
+std::string
+escape_dot (const std::string &str)
+{
+  std::string ret;
+  ret.reserve (str.size ());
+  for (const char c : str)
+    {
+      if (c == '"' || c == '\\')
+        ret += '\\';
+      ret += c;
+    }
+  return ret;
+}
+
+} // namespace
+
+GraphProfile
+GraphProfile::capture (
+  const GraphNodeCollection   &nodes,
+  std::span<const std::string> thread_names)
+{
+  GraphProfile profile;
+  const auto  &order = nodes.topological_order_;
+
+  std::unordered_map<const GraphNode *, size_t> indices;
+  indices.reserve (order.size ());
+  for (size_t i = 0; i < order.size (); ++i)
+    {
+      indices.emplace (std::addressof (order[i].get ()), i);
+    }
+
+  profile.nodes_.reserve (order.size ());
+  for (const auto &node_ref : order)
+    {
+      const auto &node = node_ref.get ();
+      Node        ret{
+        .name_ = node.get_processable ().get_node_name (),
+        .cost_ns_ = node.processing_cost_ns_.load (std::memory_order_relaxed),
+        .playback_latency_ = node.playback_latency_,
+        .route_playback_latency_ = node.route_playback_latency_,
+      };
+      for (const auto &fused : node.fused_nodes_)
+        {
+          ret.fused_names_.push_back (
+            fused.get ().get_processable ().get_node_name ());
+        }
+      const auto lane = node.last_thread_lane_.load (std::memory_order_relaxed);
+      if (lane >= 0 && static_cast<size_t> (lane) < thread_names.size ())
+        {
+          ret.thread_ = thread_names[static_cast<size_t> (lane)];
+        }
+      for (const auto &child : node.childnodes_)
+        {
+          ret.children_.push_back (indices.at (std::addressof (child.get ())));
+        }
+      profile.total_cost_ns_ += ret.cost_ns_;
+      profile.nodes_.push_back (std::move (ret));
+    }
+
+  /* walk backwards accumulating the most expensive downstream path (the
+   * estimates stored in the nodes may be older than the current costs) */
+  for (auto &node : std::views::reverse (profile.nodes_))
+    {
+      double max_child_cost = 0.0;
+      for (const auto child : node.children_)
+        {
+          const auto child_cost = profile.nodes_[child].path_cost_ns_;
+          if (!node.critical_child_ || child_cost > max_child_cost)
+            {
+              max_child_cost = child_cost;
+              node.critical_child_ = child;
+            }
+        }
+      node.path_cost_ns_ = node.cost_ns_ + max_child_cost;
+    }
+
+  /* the critical path starts at the most expensive node (which is always a
+   * trigger node) */
+  const auto start = std::ranges::max_element (
+    profile.nodes_, std::ranges::less{}, &Node::path_cost_ns_);
+  if (start != profile.nodes_.end ())
+    {
+      profile.critical_path_cost_ns_ = start->path_cost_ns_;
+      std::optional<size_t> index =
+        static_cast<size_t> (start - profile.nodes_.begin ());
+      while (index)
+        {
+          auto &node = profile.nodes_[*index];
+          node.critical_ = true;
+          index = node.critical_child_;
+        }
+    }
+
+  return profile;
+}
+
+std::string
+GraphProfile::to_dot () const
+{
+  const auto max_cost =
+    nodes_.empty ()
+      ? 0.0
+      : std::ranges::max (nodes_ | std::views::transform (&Node::cost_ns_));
+
+  std::string ret = "digraph \"processing graph\" {\n";
+  ret += fmt::format (
+    "  graph [rankdir=LR, labelloc=t, label=\"total {:.1f} us, critical "
+    "path {:.1f} us, max parallelism {:.2f}x\"];\n",
+    total_cost_ns_ / 1000.0, critical_path_cost_ns_ / 1000.0,
+    get_max_parallelism ());
+  ret += "  node [shape=box, style=\"rounded,filled\"];\n";
+
+  for (const auto &[index, node] : std::views::enumerate (nodes_))
+    {
+      std::string label = escape_dot (node.name_);
+      if (!node.fused_names_.empty ())
+        {
+          label += fmt::format ("\\n(+{} fused)", node.fused_names_.size ());
+        }
+      label += fmt::format (
+        "\\n{:.1f} us | latency {} (route {})", node.cost_ns_ / 1000.0,
+        node.playback_latency_, node.route_playback_latency_);
+      if (!node.thread_.empty ())
+        {
+          label += "\\n" + escape_dot (node.thread_);
+        }
+
+      /* from green (cheapest) to red (most expensive), white if unmeasured */
+      const auto fill =
+        node.cost_ns_ > 0.0
+          ? fmt::format (
+              "{:.3f} 0.6 1.0", (1.0 - node.cost_ns_ / max_cost) / 3.0)
+          : std::string ("white");
+      ret += fmt::format (
+        "  n{} [label=\"{}\", fillcolor=\"{}\"{}];\n", index, label, fill,
+        node.critical_ ? ", color=red, penwidth=3" : "");
+    }
+
+  for (const auto &[index, node] : std::views::enumerate (nodes_))
+    {
+      for (const auto child : node.children_)
+        {
+          const bool critical =
+            node.critical_ && node.critical_child_ == child;
+          ret += fmt::format (
+            "  n{} -> n{}{};\n", index, child,
+            critical ? " [color=red, penwidth=3]" : "");
+        }
+    }
+
+  ret += "}\n";
+  return ret;
+}
+
+std::string
+GraphProfile::to_json () const
+{
+  yyjson_mut_doc * doc = yyjson_mut_doc_new (nullptr);
+  yyjson_mut_val * root = yyjson_mut_obj (doc);
+  yyjson_mut_doc_set_root (doc, root);
+  yyjson_mut_obj_add_real (doc, root, "totalCostNs", total_cost_ns_);
+  yyjson_mut_obj_add_real (
+    doc, root, "criticalPathCostNs", critical_path_cost_ns_);
+  yyjson_mut_obj_add_real (
+    doc, root, "maxParallelism", get_max_parallelism ());
+
+  yyjson_mut_val * critical_path =
+    yyjson_mut_obj_add_arr (doc, root, "criticalPath");
+  yyjson_mut_val * nodes = yyjson_mut_obj_add_arr (doc, root, "nodes");
+  for (size_t index = 0; index < nodes_.size (); ++index)
+    {
+      const auto &node = nodes_[index];
+      if (node.critical_)
+        {
+          yyjson_mut_arr_add_uint (doc, critical_path, index);
+        }
+
+      yyjson_mut_val * obj = yyjson_mut_arr_add_obj (doc, nodes);
+      yyjson_mut_obj_add_uint (doc, obj, "id", index);
+      yyjson_mut_obj_add_strcpy (doc, obj, "name", node.name_.c_str ());
+      yyjson_mut_val * fused = yyjson_mut_obj_add_arr (doc, obj, "fused");
+      for (const auto &name : node.fused_names_)
+        {
+          yyjson_mut_arr_add_strcpy (doc, fused, name.c_str ());
+        }
+      yyjson_mut_obj_add_real (doc, obj, "costNs", node.cost_ns_);
+      yyjson_mut_obj_add_real (doc, obj, "pathCostNs", node.path_cost_ns_);
+      yyjson_mut_obj_add_uint (
+        doc, obj, "playbackLatency", node.playback_latency_);
+      yyjson_mut_obj_add_uint (
+        doc, obj, "routePlaybackLatency", node.route_playback_latency_);
+      if (node.thread_.empty ())
+        {
+          yyjson_mut_obj_add_null (doc, obj, "thread");
+        }
+      else
+        {
+          yyjson_mut_obj_add_strcpy (
+            doc, obj, "thread", node.thread_.c_str ());
+        }
+      yyjson_mut_obj_add_bool (doc, obj, "critical", node.critical_);
+      yyjson_mut_val * children =
+        yyjson_mut_obj_add_arr (doc, obj, "children");
+      for (const auto child : node.children_)
+        {
+          yyjson_mut_arr_add_uint (doc, children, child);
+        }
+    }
+
+  yyjson_write_err write_err;
+  char *           json = yyjson_mut_write_opts (
+    doc, YYJSON_WRITE_PRETTY, nullptr, nullptr, &write_err);
+  yyjson_mut_doc_free (doc);
+  if (json == nullptr)
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to serialize graph profile to JSON:\n{}", write_err.msg));
+    }
+
+  std::string ret (json);
+  std::free (json);
+  return ret;
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,115 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "utils/types.h"
+
+namespace zrythm::dsp
+{
+
+class GraphNodeCollection;
+
+/**
+ * @brief Snapshot of the scheduled processing graph, annotated with the
+ * measured cost, latency and thread of each node, and its critical path.
+ *
+ * Each scheduling unit (a node together with the nodes fused into it) is one
+ * node of the profile. The critical path is the most expensive chain of
+ * dependent nodes: no number of threads can process a cycle faster than it,
+ * so it shows where the graph is serialized and which routing to change to
+ * gain parallelism.
+ *
+ * Can be exported as Graphviz DOT (nodes colored from green to red by cost,
+ * with the critical path in bold) or as JSON.
+ */
+class GraphProfile
+{
+public:
+  struct Node
+  {
+    std::string name_;
+
+    /** Names of the nodes fused into this one, in processing order. */
+    std::vector<std::string> fused_names_;
+
+    /**
+     * @brief Measured processing time (including the fused nodes), or 0 if
+     * never measured.
+     */
+    double cost_ns_ = 0.0;
+
+    nframes_t playback_latency_ = 0;
+    nframes_t route_playback_latency_ = 0;
+
+    /** Thread that last processed the node (empty if unknown). */
+    std::string thread_;
+
+    /**
+     * @brief Cost of the most expensive path from this node (inclusive) to
+     * a terminal node.
+     */
+    double path_cost_ns_ = 0.0;
+
+    /** Whether the node is on the critical path. */
+    bool critical_ = false;
+
+    /** Indices of the downstream nodes. */
+    std::vector<size_t> children_;
+
+    /** Index of the next node on the critical path, if any. */
+    std::optional<size_t> critical_child_;
+  };
+
+public:
+  /**
+   * @brief Captures the profile of the given (finalized) nodes.
+   *
+   * The nodes may be processed meanwhile, but must not be modified.
+   *
+   * @param thread_names Thread names indexed by trace lane (see
+   * GraphScheduler::get_thread_names()).
+   */
+  static GraphProfile capture (
+    const GraphNodeCollection   &nodes,
+    std::span<const std::string> thread_names);
+
+  /**
+   * @brief Returns the upper bound of the speedup from processing the graph
+   * in parallel (the total cost divided by the cost of the critical path).
+   */
+  double get_max_parallelism () const
+  {
+    return critical_path_cost_ns_ > 0.0
+             ? total_cost_ns_ / critical_path_cost_ns_
+             : 1.0;
+  }
+
+  /**
+   * @brief Returns the profile as a Graphviz DOT document.
+   */
+  std::string to_dot () const;
+
+  /**
+   * @brief Returns the profile as a JSON document.
+   *
+   * @throw ZrythmException If serialization failed.
+   */
+  std::string to_json () const;
+
+public:
+  /** The nodes, in topological order. */
+  std::vector<Node> nodes_;
+
+  /** Sum of the costs of all nodes (the time a single thread would take). */
+  double total_cost_ns_ = 0.0;
+
+  double critical_path_cost_ns_ = 0.0;
+};
+
+} // namespace zrythm::dsp
@@ -26,32 +26,208 @@
 #include "dsp/graph_scheduler.h"
 #include "dsp/graph_thread.h"
 #include "utils/audio.h"
+#include "utils/cpu_affinity.h"
 #include "utils/env.h"
+#include "utils/rt_guard.h"
+#include "utils/rt_logger.h"
 
 namespace zrythm::dsp
 {
 
-GraphScheduler::GraphScheduler () = default;
+GraphScheduler::GraphScheduler (SchedulingStrategy strategy)
+    : strategy_ (strategy),
+      graph_nodes_ (std::make_unique<dsp::GraphNodeCollection> ())
+{
+}
 
 void
 GraphScheduler::trigger_node (GraphNode &node)
 {
   /* check if we can run */
-  if (node.refcount_.fetch_sub (1) == 1)
+  if (release_dependency (node))
     {
-      /* reset reference count for next cycle */
-      node.refcount_.store (node.init_refcount_);
-
       // FIXME: is the code below correct? seems like it would cause data
       // races since we are increasing the size but the pointer might not be
       // pushed in the queue yet?
 
       /* all nodes that feed this node have completed, so this node be
        * processed now. */
-      trigger_queue_size_.fetch_add (1);
-      /*z_info ("triggering node, pushing back");*/
-      trigger_queue_.push_back (&node);
+      push_ready_node (node);
+    }
+}
+
+void
+GraphScheduler::trigger_nodes (
+  std::span<const std::reference_wrapper<GraphNode>> nodes)
+{
+  /* collect the ready nodes per priority so that each batch is pushed with a
+   * single claim of the queue */
+  constexpr size_t BATCH_SIZE = 16;
+  using Batch = std::array<GraphNode *, BATCH_SIZE>;
+  std::array<Batch, GraphNode::NUM_PRIORITY_LEVELS>  batches;
+  std::array<size_t, GraphNode::NUM_PRIORITY_LEVELS> batch_sizes{};
+  for (const auto node_ref : nodes)
+    {
+      auto &node = node_ref.get ();
+      if (!release_dependency (node))
+        continue;
+
+      const auto priority = node.priority_;
+      auto      &batch_size = batch_sizes[priority];
+      batches[priority][batch_size++] = &node;
+      if (batch_size == BATCH_SIZE)
+        {
+          push_ready_nodes (priority, batches[priority]);
+          batch_size = 0;
+        }
+    }
+
+  for (int priority = 0; priority < GraphNode::NUM_PRIORITY_LEVELS; ++priority)
+    {
+      if (batch_sizes[priority] > 0)
+        {
+          push_ready_nodes (
+            priority,
+            std::span (batches[priority]).first (batch_sizes[priority]));
+        }
+    }
+}
+
+void
+GraphScheduler::process_node (GraphNode &node, size_t trace_lane)
+{
+  auto * const trace_recorder = trace_recorder_.get ();
+#if ZRYTHM_DSP_NODE_PROFILING
+  constexpr bool measure = true;
+#else
+  const bool measure = sample_node_costs_ || trace_recorder != nullptr;
+#endif
+  if (measure) [[unlikely]]
+    {
+      const auto start = std::chrono::steady_clock::now ();
+      node.process (time_nfo_, remaining_preroll_frames_, loop_points_handled_);
+      const auto end = std::chrono::steady_clock::now ();
+      const auto elapsed_ns =
+        std::chrono::duration_cast<std::chrono::nanoseconds> (end - start)
+          .count ();
+      if (trace_recorder != nullptr)
+        {
+          trace_recorder->record_node (trace_lane, node, start, end);
+        }
+      node.last_thread_lane_.store (
+        static_cast<int> (trace_lane), std::memory_order_relaxed);
+#if ZRYTHM_DSP_NODE_PROFILING
+      node.stats_.record (static_cast<uint64_t> (elapsed_ns));
+#endif
+      if (sample_node_costs_)
+        {
+          node.add_processing_cost_sample (static_cast<float> (elapsed_ns));
+        }
+      return;
     }
+
+  node.process (time_nfo_, remaining_preroll_frames_, loop_points_handled_);
+}
+
+void
+GraphScheduler::update_static_schedule_decision ()
+{
+  const auto &order = graph_nodes_->topological_order_;
+  if (threads_.empty ())
+    {
+      use_static_schedule_ = true;
+      return;
+    }
+  if (order.size () > static_schedule_max_nodes_)
+    {
+      use_static_schedule_ = false;
+      return;
+    }
+
+  double total_cost_ns = 0.0;
+  for (const auto node : order)
+    {
+      total_cost_ns +=
+        node.get ().processing_cost_ns_.load (std::memory_order_relaxed);
+    }
+
+  /* leave some headroom before switching back to avoid flip-flopping between
+   * the modes when the cost is close to the limit */
+  const auto max_cost_ns =
+    static_cast<double> (static_schedule_max_cost_.count ())
+    * (use_static_schedule_ ? 1.25 : 1.0);
+  use_static_schedule_ = total_cost_ns <= max_cost_ns;
+}
+
+void
+GraphScheduler::run_static_schedule ()
+{
+  for (const auto node : graph_nodes_->topological_order_)
+    {
+      process_node (node.get (), get_caller_trace_lane ());
+    }
+}
+
+void
+GraphScheduler::prepare_node_collection (
+  dsp::GraphNodeCollection &nodes,
+  std::vector<std::reference_wrapper<dsp::IProcessable>>
+    &processables_that_need_external_buffer_clear) const
+{
+  /* keep the measured processing costs of nodes that are still in the graph
+   * and recompute the priorities with them */
+  nodes.copy_processing_costs_from (*graph_nodes_);
+  nodes.update_critical_path_priorities ();
+  assign_numa_nodes (nodes);
+
+  /* the names are resolved outside the realtime threads when exporting */
+  if (trace_recorder_)
+    {
+      trace_recorder_->register_node_names (nodes);
+    }
+
+  processables_that_need_external_buffer_clear.clear ();
+  for (const auto &node : nodes.graph_nodes_)
+    {
+      if (
+        node->get_processable ().needs_external_buffer_clear_on_early_return ())
+        {
+          processables_that_need_external_buffer_clear.emplace_back (
+            node->get_processable ());
+        }
+    }
+}
+
+void
+GraphScheduler::enable_anticipative_rendering (
+  const ITransport &transport,
+  nframes_t         block_length,
+  size_t            num_blocks)
+{
+  const bool threads_running = main_thread_ != nullptr;
+  if (anticipative_renderer_)
+    {
+      anticipative_renderer_->stop_thread ();
+      anticipative_renderer_->release_nodes ();
+    }
+  anticipative_renderer_ = std::make_unique<AnticipativeRenderer> (
+    transport, block_length, num_blocks);
+  anticipative_renderer_->assign_nodes (*graph_nodes_);
+  if (threads_running)
+    {
+      anticipative_renderer_->start_thread ();
+    }
+}
+
+void
+GraphScheduler::reassign_rendered_ahead_nodes ()
+{
+  if (!anticipative_renderer_)
+    return;
+
+  anticipative_renderer_->pause ();
+  anticipative_renderer_->assign_nodes (*graph_nodes_);
+  anticipative_renderer_->resume ();
 }
 
 void
@@ -61,32 +237,500 @@ GraphScheduler::rechain_from_node_collection (dsp::GraphNodeCollection &&nodes)
 
   z_return_if_fail (trigger_queue_size_.load () == 0);
 
+  /* the renderer must let go of the old nodes before they are destroyed */
+  if (anticipative_renderer_)
+    {
+      anticipative_renderer_->pause ();
+      anticipative_renderer_->release_nodes ();
+    }
+
+  /* a collection that was published but not picked up is superseded */
+  if (auto * pending = pending_graph_nodes_.exchange (nullptr))
+    {
+      delete pending;
+      applied_generation_.store (published_generation_);
+    }
+  free_retired_node_collections ();
+
+  prepare_node_collection (
+    nodes,
+    processables_that_need_external_buffer_clear_when_returning_early_from_processing_cycle_);
+
   /* --- swap setup nodes with graph nodes --- */
 
-  graph_nodes_ = std::move (nodes);
+  *graph_nodes_ = std::move (nodes);
+
+  terminal_refcnt_.store (graph_nodes_->terminal_nodes_.size ());
+  update_static_schedule_decision ();
+
+  /* leave room for the graph to grow so that later changes can be published
+   * without reallocating */
+  const auto capacity =
+    graph_nodes_->graph_nodes_.size () * QUEUE_CAPACITY_HEADROOM;
+  for (auto &queue : trigger_queues_)
+    {
+      queue.reserve (capacity);
+    }
+  for (auto &queue : numa_queues_)
+    {
+      if (queue)
+        queue->reserve (capacity);
+    }
+  for (auto &thread : threads_)
+    {
+      thread->local_queue_.reserve (capacity);
+    }
+  if (main_thread_)
+    {
+      main_thread_->local_queue_.reserve (capacity);
+    }
+
+  if (anticipative_renderer_)
+    {
+      anticipative_renderer_->assign_nodes (*graph_nodes_);
+      anticipative_renderer_->resume ();
+    }
+
+  z_debug ("rechaining done");
+}
+
+bool
+GraphScheduler::publish_node_collection (dsp::GraphNodeCollection &&nodes)
+{
+  z_return_val_if_fail (!has_pending_node_collection (), false);
+  free_retired_node_collections ();
+
+  /* the nodes can only be handed over to the renderer while not processing */
+  if (anticipative_renderer_)
+    {
+      return false;
+    }
+
+  /* the queues can't be resized while processing */
+  if (nodes.graph_nodes_.size () > get_queue_capacity ())
+    {
+      z_debug (
+        "graph with {} nodes exceeds queue capacity {}, can't publish",
+        nodes.graph_nodes_.size (), get_queue_capacity ());
+      return false;
+    }
+
+  prepare_node_collection (nodes, pending_processables_);
 
-  processables_that_need_external_buffer_clear_when_returning_early_from_processing_cycle_
-    .clear ();
-  for (const auto &node : graph_nodes_.graph_nodes_)
+  ++published_generation_;
+  pending_graph_nodes_.store (
+    new dsp::GraphNodeCollection (std::move (nodes)),
+    std::memory_order_release);
+  return true;
+}
+
+void
+GraphScheduler::apply_pending_node_collection ()
+{
+  auto * pending =
+    pending_graph_nodes_.exchange (nullptr, std::memory_order_acq_rel);
+  if (pending == nullptr) [[likely]]
+    {
+      return;
+    }
+
+  /* the previous collection is freed on a non-realtime thread by
+   * free_retired_node_collections() */
+  retired_graph_nodes_.store (
+    graph_nodes_.release (), std::memory_order_relaxed);
+  graph_nodes_.reset (pending);
+  std::swap (
+    processables_that_need_external_buffer_clear_when_returning_early_from_processing_cycle_,
+    pending_processables_);
+  terminal_refcnt_.store (graph_nodes_->terminal_nodes_.size ());
+  update_static_schedule_decision ();
+
+  applied_generation_.fetch_add (1, std::memory_order_release);
+}
+
+void
+GraphScheduler::publish_latency_updates (
+  std::vector<GraphNodeCollection::LatencyUpdate> &&updates)
+{
+  z_return_if_fail (!has_pending_latency_updates ());
+  z_return_if_fail (!has_pending_node_collection ());
+
+  pending_latency_updates_ = std::move (updates);
+  latency_updates_pending_.store (true, std::memory_order_release);
+}
+
+bool
+GraphScheduler::apply_pending_latency_updates ()
+{
+  if (!latency_updates_pending_.load (std::memory_order_acquire)) [[likely]]
+    {
+      return false;
+    }
+
+  GraphNodeCollection::apply_latency_updates (pending_latency_updates_);
+
+  /* blocks rendered ahead were rendered with the previous offsets */
+  if (anticipative_renderer_)
+    {
+      anticipative_renderer_->invalidate ();
+    }
+
+  latency_updates_pending_.store (false, std::memory_order_release);
+  return true;
+}
+
+void
+GraphScheduler::free_retired_node_collections ()
+{
+  z_return_if_fail (!has_pending_node_collection ());
+  delete retired_graph_nodes_.exchange (nullptr, std::memory_order_acquire);
+}
+
+size_t
+GraphScheduler::get_queue_capacity () const
+{
+  size_t capacity = trigger_queues_.front ().capacity ();
+  for (const auto &thread : threads_)
+    {
+      capacity = std::min (capacity, thread->local_queue_.capacity ());
+    }
+  if (main_thread_)
     {
+      capacity = std::min (capacity, main_thread_->local_queue_.capacity ());
+    }
+  return capacity;
+}
+
+GraphNode *
+GraphScheduler::steal_node (const GraphThread &thief)
+{
+  const auto steal_from =
+    [] (std::span<GraphThread * const> victims) -> GraphNode * {
+    for (auto * victim : victims)
+      {
+        if (auto node = victim->local_queue_.steal ())
+          {
+            return *node;
+          }
+      }
+    return nullptr;
+  };
+
+  /* prefer work on this thread's NUMA node: first the nodes placed on it,
+   * then the nodes of the other threads on it */
+  const auto victims = std::span (thief.steal_victims_);
+  const auto same_node_victims = victims.first (thief.num_same_node_victims_);
+  const auto other_victims = victims.subspan (thief.num_same_node_victims_);
+  if (thief.numa_node_ >= 0)
+    {
+      if (auto * node = pop_numa_ready_node (thief.numa_node_))
+        {
+          return node;
+        }
+    }
+  if (auto * node = steal_from (same_node_victims))
+    {
+      return node;
+    }
+
+  /* then help the other NUMA nodes */
+  for (const auto numa_node : numa_node_ids_)
+    {
+      if (numa_node == thief.numa_node_)
+        continue;
+
+      if (auto * node = pop_numa_ready_node (numa_node))
+        {
+          return node;
+        }
+    }
+  if (auto * node = steal_from (other_victims))
+    {
+      return node;
+    }
+
+  /* check the overflow queue last */
+  GraphNode * node = nullptr;
+  if (pop_ready_node (node))
+    {
+      trigger_queue_size_.fetch_sub (1);
+      return node;
+    }
+
+  return nullptr;
+}
+
+void
+GraphScheduler::wake_idle_threads (int max_threads)
+{
+  const int wakeup = std::min (idle_thread_cnt_.load (), max_threads);
+  for (int i = 0; i < wakeup; ++i)
+    {
+      trigger_sem_.release ();
+    }
+}
+
+std::vector<int>
+GraphScheduler::get_default_cpu_affinity ()
+{
+  auto cpus = utils::cpu::get_isolated_cpus ();
+  if (!cpus.empty ())
+    {
+      z_info ("using isolated CPUs {} for DSP", fmt::join (cpus, ","));
+      return cpus;
+    }
+
+  cpus = utils::cpu::get_performance_cpus ();
+  if (!cpus.empty ())
+    {
+      z_info ("using performance cores {} for DSP", fmt::join (cpus, ","));
+      return cpus;
+    }
+
+  const auto numa_nodes = utils::cpu::get_numa_nodes ();
+  if (numa_nodes.size () > 1)
+    {
+      /* alternate between the nodes so that any number of threads is spread
+       * over them */
+      const auto max_cpus_per_node =
+        std::ranges::max (numa_nodes, {}, [] (const auto &numa_node) {
+          return numa_node.cpus_.size ();
+        }).cpus_.size ();
+      for (size_t i = 0; i < max_cpus_per_node; ++i)
+        {
+          for (const auto &numa_node : numa_nodes)
+            {
+              if (i < numa_node.cpus_.size ())
+                cpus.push_back (numa_node.cpus_[i]);
+            }
+        }
+
+      /* leave a CPU to the OS and other tasks */
+      cpus.pop_back ();
+      z_info (
+        "using CPUs {} of {} NUMA nodes for DSP", fmt::join (cpus, ","),
+        numa_nodes.size ());
+    }
+  return cpus;
+}
+
+void
+GraphScheduler::apply_cpu_affinity (const GraphThread &thread) const
+{
+  if (thread_cpus_.empty ())
+    return;
+
+  utils::cpu::set_current_thread_affinity (
+    std::span (thread_cpus_).subspan (get_thread_cpu_index (thread), 1));
+}
+
+size_t
+GraphScheduler::get_thread_cpu_index (const GraphThread &thread) const
+{
+  /* the main thread takes the first CPU and the workers the next ones */
+  return thread.is_main_
+           ? 0
+           : static_cast<size_t> (thread.id_ + 1) % thread_cpus_.size ();
+}
+
+void
+GraphScheduler::update_numa_placement ()
+{
+  /* the main thread is treated as the last entry */
+  std::vector<GraphThread *> all_threads;
+  all_threads.reserve (threads_.size () + 1);
+  for (auto &thread : threads_)
+    {
+      all_threads.push_back (thread.get ());
+    }
+  all_threads.push_back (main_thread_.get ());
+
+  numa_node_ids_.clear ();
+  numa_queues_.clear ();
+  const auto numa_nodes =
+    thread_cpus_.empty () || strategy_ != SchedulingStrategy::WorkStealing
+      ? std::vector<utils::cpu::NumaNode> ()
+      : utils::cpu::get_numa_nodes ();
+  for (auto * thread : all_threads)
+    {
+      thread->numa_node_ =
+        numa_nodes.empty ()
+          ? -1
+          : utils::cpu::get_numa_node_of_cpu (
+              thread_cpus_[get_thread_cpu_index (*thread)], numa_nodes);
       if (
-        node->get_processable ().needs_external_buffer_clear_on_early_return ())
+        thread->numa_node_ >= 0
+        && !std::ranges::contains (numa_node_ids_, thread->numa_node_))
+        {
+          numa_node_ids_.push_back (thread->numa_node_);
+        }
+    }
+
+  if (numa_node_ids_.size () < 2)
+    {
+      numa_node_ids_.clear ();
+      for (auto * thread : all_threads)
+        {
+          thread->numa_node_ = -1;
+        }
+    }
+  else
+    {
+      std::ranges::sort (numa_node_ids_);
+      numa_queues_.resize (static_cast<size_t> (numa_node_ids_.back ()) + 1);
+      for (const auto numa_node : numa_node_ids_)
         {
-          processables_that_need_external_buffer_clear_when_returning_early_from_processing_cycle_
-            .emplace_back (node->get_processable ());
+          numa_queues_[numa_node] =
+            std::make_unique<MPMCQueue<GraphNode *>> (get_queue_capacity ());
         }
     }
 
-  terminal_refcnt_.store (graph_nodes_.terminal_nodes_.size ());
+  /* each thread steals round-robin starting from the thread after it, from
+   * the threads on its NUMA node first */
+  const auto num_threads = all_threads.size ();
+  for (size_t i = 0; i < num_threads; ++i)
+    {
+      auto * thief = all_threads[i];
+      thief->steal_victims_.clear ();
+      for (size_t j = 1; j < num_threads; ++j)
+        {
+          thief->steal_victims_.push_back (all_threads[(i + j) % num_threads]);
+        }
+      const auto other_nodes = std::ranges::stable_partition (
+        thief->steal_victims_, [thief] (const GraphThread * victim) {
+          return victim->numa_node_ == thief->numa_node_;
+        });
+      thief->num_same_node_victims_ = static_cast<size_t> (
+        other_nodes.begin () - thief->steal_victims_.begin ());
+    }
 
-  trigger_queue_.reserve (graph_nodes_.graph_nodes_.size ());
+  assign_numa_nodes (*graph_nodes_);
+  if (!numa_node_ids_.empty ())
+    {
+      z_info ("NUMA placement:\n{}", numa_placement_to_str ());
+    }
+}
 
-  z_debug ("rechaining done");
+void
+GraphScheduler::assign_numa_nodes (dsp::GraphNodeCollection &nodes) const
+{
+  if (numa_node_ids_.empty ())
+    {
+      for (auto &node : nodes.graph_nodes_)
+        {
+          node->numa_node_ = -1;
+        }
+      return;
+    }
+
+  /* nodes that were never measured count as the average measured node (or 1
+   * if nothing was measured yet, in which case the node count is balanced) */
+  double total_measured_cost = 0.0;
+  size_t num_measured = 0;
+  for (const auto &node : nodes.graph_nodes_)
+    {
+      if (node->fused_)
+        continue;
+
+      const auto cost = node->processing_cost_ns_.load ();
+      if (cost > 0.f)
+        {
+          total_measured_cost += cost;
+          ++num_measured;
+        }
+    }
+  const double default_cost =
+    num_measured > 0 ? total_measured_cost / static_cast<double> (num_measured)
+                     : 1.0;
+  /* the measured cost of a node includes its fused nodes */
+  const auto get_cost = [default_cost] (const GraphNode &node) {
+    const auto cost = node.processing_cost_ns_.load ();
+    if (cost > 0.f)
+      return static_cast<double> (cost);
+    return default_cost * static_cast<double> (1 + node.fused_nodes_.size ());
+  };
+
+  struct NumaNodeLoad
+  {
+    int    numa_node_ = -1;
+    size_t num_threads_ = 0;
+    double cost_ = 0.0;
+  };
+  std::vector<NumaNodeLoad> loads;
+  for (const auto numa_node : numa_node_ids_)
+    {
+      loads.push_back (NumaNodeLoad{ .numa_node_ = numa_node });
+    }
+  const auto find_load = [&] (int numa_node) {
+    return std::ranges::find (loads, numa_node, &NumaNodeLoad::numa_node_);
+  };
+  const auto count_thread = [&] (const GraphThread &thread) {
+    if (const auto load = find_load (thread.numa_node_); load != loads.end ())
+      ++load->num_threads_;
+  };
+  for (const auto &thread : threads_)
+    {
+      count_thread (*thread);
+    }
+  count_thread (*main_thread_);
+
+  const auto set_numa_node = [] (std::span<GraphNode * const> group, int id) {
+    for (auto * node : group)
+      {
+        node->numa_node_ = id;
+        for (const auto fused : node->fused_nodes_)
+          {
+            fused.get ().numa_node_ = id;
+          }
+      }
+  };
+
+  /* groups keep the NUMA node they were on (so that their memory doesn't have
+   * to be moved), and the rest go to the least loaded node per thread, most
+   * expensive first */
+  const auto groups = nodes.get_placement_groups ();
+  std::vector<std::pair<double, size_t>> unplaced_groups;
+  for (const auto &[index, group] : std::views::enumerate (groups))
+    {
+      double cost = 0.0;
+      for (const auto * node : group)
+        {
+          cost += get_cost (*node);
+        }
+
+      const auto load = find_load (group.front ()->numa_node_);
+      if (load != loads.end ())
+        {
+          load->cost_ += cost;
+          set_numa_node (group, load->numa_node_);
+        }
+      else
+        {
+          unplaced_groups.emplace_back (cost, static_cast<size_t> (index));
+        }
+    }
+  std::ranges::stable_sort (
+    unplaced_groups, std::ranges::greater{},
+    &std::pair<double, size_t>::first);
+  for (const auto &[cost, index] : unplaced_groups)
+    {
+      const auto load =
+        std::ranges::min_element (loads, {}, [cost] (const NumaNodeLoad &l) {
+          return (l.cost_ + cost) / static_cast<double> (l.num_threads_);
+        });
+      load->cost_ += cost;
+      set_numa_node (groups[index], load->numa_node_);
+    }
 }
 
 void
 GraphScheduler::start_threads (std::optional<int> num_threads)
 {
+  thread_cpus_ = cpu_affinity_.value_or (get_default_cpu_affinity ());
+
+  /* start the realtime logger before the threads may use it */
+  utils::RtLogger::instance ();
+
   if (num_threads)
     {
       num_threads.emplace (
@@ -98,9 +742,15 @@ GraphScheduler::start_threads (std::optional<int> num_threads)
         std::min (MAX_GRAPH_THREADS, utils::audio::get_num_cores ());
 
       /* we reserve 1 core for the OS and other tasks and 1 core for the main
-       * thread
+       * thread, unless we were given dedicated CPUs (in which case 1 of them is
+       * for the main thread)
        */
-      auto num_threads_int = env_get_int ("ZRYTHM_DSP_THREADS", num_cores - 2);
+      const int default_num_threads =
+        thread_cpus_.empty ()
+          ? num_cores - 2
+          : static_cast<int> (thread_cpus_.size ()) - 1;
+      auto num_threads_int =
+        env_get_int ("ZRYTHM_DSP_THREADS", default_num_threads);
 
       if (num_threads_int < 0)
         {
@@ -122,6 +772,16 @@ GraphScheduler::start_threads (std::optional<int> num_threads)
 
       /* and the main thread */
       main_thread_ = std::make_unique<GraphThread> (-1, true, *this);
+
+      update_numa_placement ();
+
+      trace_recorder_.reset ();
+      if (trace_recording_enabled_)
+        {
+          trace_recorder_ =
+            std::make_unique<GraphTraceRecorder> (get_thread_names ());
+          trace_recorder_->register_node_names (*graph_nodes_);
+        }
     }
   catch (const std::exception &e)
     {
@@ -151,6 +811,19 @@ GraphScheduler::start_threads (std::optional<int> num_threads)
     }
   start_thread (main_thread_);
 
+  if (anticipative_renderer_)
+    {
+      try
+        {
+          anticipative_renderer_->start_thread ();
+        }
+      catch (const ZrythmException &)
+        {
+          terminate_threads ();
+          throw;
+        }
+    }
+
   /* wait for all threads to go idle */
   while (idle_thread_cnt_.load () != static_cast<int> (threads_.size ()))
     {
@@ -160,6 +833,8 @@ GraphScheduler::start_threads (std::optional<int> num_threads)
         threads_.size (), idle_thread_cnt_.load ());
       std::this_thread::sleep_for (std::chrono::milliseconds (1));
     }
+
+  update_static_schedule_decision ();
 }
 
 void
@@ -167,6 +842,11 @@ GraphScheduler::terminate_threads ()
 {
   z_info ("terminating graph...");
 
+  if (anticipative_renderer_)
+    {
+      anticipative_renderer_->stop_thread ();
+    }
+
   /* Flag threads to terminate */
   for (auto &thread : threads_)
     {
@@ -203,10 +883,97 @@ GraphScheduler::terminate_threads ()
   main_thread_->waitForThreadToExit (5);
   threads_.clear ();
   main_thread_.reset ();
+  numa_node_ids_.clear ();
+  numa_queues_.clear ();
+
+  /* reset the synchronization state so that the threads can be restarted */
+  idle_thread_cnt_.store (0);
+  while (trigger_sem_.try_acquire ())
+    ;
+  while (callback_start_sem_.try_acquire ())
+    ;
+  while (callback_done_sem_.try_acquire ())
+    ;
+  terminal_refcnt_.store (graph_nodes_->terminal_nodes_.size ());
+  update_static_schedule_decision ();
 
   z_info ("graph terminated");
 }
 
+int
+GraphScheduler::calibrate_num_threads (
+  const EngineProcessTimeInfo time_nfo,
+  const int                   max_threads,
+  const int                   num_cycles)
+{
+  constexpr int NUM_WARMUP_CYCLES = 16;
+
+  /* a cycle never completes without terminal nodes */
+  z_return_val_if_fail (
+    !graph_nodes_->terminal_nodes_.empty (),
+    static_cast<int> (threads_.size ()));
+
+  const int        max = std::clamp (max_threads, 1, MAX_GRAPH_THREADS);
+  std::vector<int> p99_ns_per_num_threads;
+  for (int num_threads = 1; num_threads <= max; ++num_threads)
+    {
+      if (main_thread_)
+        {
+          terminate_threads ();
+        }
+      start_threads (num_threads);
+
+      std::vector<int> cycle_ns;
+      cycle_ns.reserve (num_cycles);
+      for (int i = 0; i < NUM_WARMUP_CYCLES + num_cycles; ++i)
+        {
+          const auto start = std::chrono::steady_clock::now ();
+          run_cycle (time_nfo, 0);
+          const auto elapsed_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds> (
+              std::chrono::steady_clock::now () - start)
+              .count ();
+          if (i >= NUM_WARMUP_CYCLES)
+            {
+              cycle_ns.push_back (static_cast<int> (elapsed_ns));
+            }
+        }
+
+      int p99_ns = 0;
+      if (!cycle_ns.empty ())
+        {
+          const auto p99_idx = (cycle_ns.size () * 99 + 99) / 100 - 1;
+          std::ranges::nth_element (
+            cycle_ns, cycle_ns.begin () + static_cast<ptrdiff_t> (p99_idx));
+          p99_ns = cycle_ns[p99_idx];
+        }
+      z_info (
+        "calibration: {} worker threads: p99 cycle time {:.1f} us", num_threads,
+        p99_ns / 1000.0);
+      p99_ns_per_num_threads.push_back (p99_ns);
+    }
+
+  /* pick the fewest threads within 5% of the fastest */
+  const auto best_ns = std::ranges::min (p99_ns_per_num_threads);
+  int        best_num_threads = max;
+  for (int i = 0; i < max; ++i)
+    {
+      if (p99_ns_per_num_threads[i] <= best_ns + best_ns / 20)
+        {
+          best_num_threads = i + 1;
+          break;
+        }
+    }
+  z_info ("calibration: using {} worker threads", best_num_threads);
+
+  if (best_num_threads != max)
+    {
+      terminate_threads ();
+      start_threads (best_num_threads);
+    }
+  return best_num_threads;
+}
+
 bool
 GraphScheduler::contains_thread (RTThreadId::IdType thread_id)
 {
@@ -218,6 +985,13 @@ GraphScheduler::contains_thread (RTThreadId::IdType thread_id)
         }
     }
 
+  if (
+    anticipative_renderer_
+    && anticipative_renderer_->is_render_thread (thread_id))
+    {
+      return true;
+    }
+
   return main_thread_ && thread_id == main_thread_->rt_thread_id_;
 }
 
@@ -239,22 +1013,320 @@ GraphScheduler::run_cycle (
 {
   time_nfo_ = time_nfo;
   remaining_preroll_frames_ = remaining_preroll_frames;
+  advance_cost_sampling ();
+
+  /* estimate when the next cycle will start (idle threads use this to decide
+   * whether to spin) */
+  const auto now = std::chrono::steady_clock::now ();
+  if (last_cycle_start_ != std::chrono::steady_clock::time_point{})
+    {
+      const auto period = now - last_cycle_start_;
+      /* follow big changes (e.g., after a pause or a buffer size change)
+       * immediately and smooth out jitter otherwise */
+      if (period > cycle_period_ * 2 || period < cycle_period_ / 2)
+        {
+          cycle_period_ = period;
+        }
+      else
+        {
+          cycle_period_ = (cycle_period_ * 7 + period) / 8;
+        }
+    }
+  last_cycle_start_ = now;
+  next_cycle_due_ns_.store (
+    std::chrono::duration_cast<std::chrono::nanoseconds> (
+      (now + cycle_period_).time_since_epoch ())
+      .count (),
+    std::memory_order_relaxed);
+
+  /* switch to a newly published graph at the cycle boundary */
+  apply_pending_node_collection ();
 
   /* process special nodes first */
-  for (const auto node : graph_nodes_.special_nodes_)
+  for (const auto node : graph_nodes_->special_nodes_)
     {
       node.get ().process (time_nfo_, remaining_preroll_frames);
       node.get ().set_skip_processing (true);
     }
 
-  callback_start_sem_.release ();
-  callback_done_sem_.acquire ();
+  if (anticipative_renderer_)
+    {
+      anticipative_renderer_->begin_cycle (time_nfo_, remaining_preroll_frames);
+    }
+
+  if (can_split_graph_at_loop_points ())
+    {
+      /* run the whole graph once per part of the cycle instead of having
+       * each node split its own processing */
+      const auto &transport =
+        graph_nodes_->graph_nodes_.front ()->get_transport ();
+      auto part_nfo = time_nfo_;
+      if (transport.get_play_state () == ITransport::PlayState::Rolling)
+        {
+          /* same as GraphNode::compensate_latency() without latency */
+          const auto playhead =
+            (unsigned_frame_t) transport.get_playhead_position ().frames_;
+          part_nfo.g_start_frame_ = playhead;
+          part_nfo.g_start_frame_w_offset_ = playhead + part_nfo.local_offset_;
+        }
+
+      loop_points_handled_ = true;
+      for (
+        nframes_t num_frames = 0;
+        (num_frames = GraphNode::get_frames_until_loop_point (
+           transport, part_nfo))
+        != 0;)
+        {
+          time_nfo_ = part_nfo;
+          time_nfo_.nframes_ = num_frames;
+          run_graph_pass ();
+          GraphNode::skip_to_loop_start (transport, part_nfo, num_frames);
+        }
+      if (part_nfo.nframes_ > 0)
+        {
+          time_nfo_ = part_nfo;
+          run_graph_pass ();
+        }
+      loop_points_handled_ = false;
+      time_nfo_ = time_nfo;
+    }
+  else
+    {
+      run_graph_pass ();
+    }
+
+  if (anticipative_renderer_)
+    {
+      anticipative_renderer_->end_cycle ();
+    }
 
   /* reset bypass state of special nodes */
-  for (const auto node : graph_nodes_.special_nodes_)
+  for (const auto node : graph_nodes_->special_nodes_)
     {
       node.get ().set_skip_processing (false);
     }
+
+  if (trace_recorder_) [[unlikely]]
+    {
+      trace_recorder_->record_cycle (now, std::chrono::steady_clock::now ());
+    }
+
+  /* the graph may have become cheap enough (or too expensive) for the static
+   * schedule */
+  if (sample_node_costs_) [[unlikely]]
+    {
+      update_static_schedule_decision ();
+    }
+}
+
+void
+GraphScheduler::run_graph_pass ()
+{
+  if (use_static_schedule_)
+    {
+      run_static_schedule ();
+    }
+  else
+    {
+      callback_start_sem_.release ();
+
+      /* waiting for the graph threads is intended */
+      utils::RtGuard::Suspend rt_guard_suspend;
+      callback_done_sem_.acquire ();
+    }
+}
+
+bool
+GraphScheduler::can_split_graph_at_loop_points () const
+{
+  if (
+    !graph_loop_splitting_enabled_ || anticipative_renderer_
+    || remaining_preroll_frames_ > 0 || graph_nodes_->graph_nodes_.empty ())
+    return false;
+
+  const auto &transport = graph_nodes_->graph_nodes_.front ()->get_transport ();
+  if (!transport.get_loop_enabled ())
+    return false;
+
+  /* with latency each route crosses the loop point at a different time */
+  return graph_nodes_->get_max_route_playback_latency () == 0;
+}
+
+std::vector<std::string>
+GraphScheduler::get_thread_names () const
+{
+  std::vector<std::string> names;
+  names.reserve (threads_.size () + 2);
+  for (size_t i = 0; i < threads_.size (); ++i)
+    {
+      names.push_back (fmt::format ("graph thread {}", i));
+    }
+  names.emplace_back ("main graph thread");
+  names.emplace_back ("engine thread");
+  return names;
+}
+
+std::vector<GraphScheduler::NodeStats>
+GraphScheduler::get_node_stats () const
+{
+  std::vector<NodeStats> ret;
+#if ZRYTHM_DSP_NODE_PROFILING
+  ret.reserve (graph_nodes_->graph_nodes_.size ());
+  for (const auto &node : graph_nodes_->graph_nodes_)
+    {
+      if (node->fused_)
+        continue;
+
+      auto name = node->get_processable ().get_node_name ();
+      if (!node->fused_nodes_.empty ())
+        {
+          name += fmt::format (" (+{} fused)", node->fused_nodes_.size ());
+        }
+      ret.push_back (NodeStats{
+        .name_ = name,
+        .stats_ = node->stats_.get_snapshot (),
+        .numa_node_ = node->numa_node_ });
+    }
+  std::ranges::stable_sort (ret, [] (const auto &a, const auto &b) {
+    return a.stats_.mean_ns_ > b.stats_.mean_ns_;
+  });
+#endif
+  return ret;
+}
+
+size_t
+GraphScheduler::get_memory_usage () const
+{
+  size_t ret = 0;
+  if (graph_nodes_)
+    {
+      for (const auto &node : graph_nodes_->graph_nodes_)
+        {
+          ret += node->get_memory_usage ();
+        }
+    }
+
+  size_t num_queue_entries = 0;
+  for (const auto &queue : trigger_queues_)
+    {
+      num_queue_entries += queue.capacity ();
+    }
+  for (const auto &thread : threads_)
+    {
+      num_queue_entries += thread->local_queue_.capacity ();
+    }
+  if (main_thread_)
+    {
+      num_queue_entries += main_thread_->local_queue_.capacity ();
+    }
+  for (const auto &queue : numa_queues_)
+    {
+      if (queue)
+        num_queue_entries += queue->capacity ();
+    }
+  ret += num_queue_entries * sizeof (GraphNode *);
+
+  if (trace_recorder_)
+    {
+      ret += trace_recorder_->get_memory_usage ();
+    }
+  return ret;
+}
+
+std::vector<GraphScheduler::NumaPlacement>
+GraphScheduler::get_numa_placement () const
+{
+  std::vector<NumaPlacement> ret;
+  for (const auto numa_node : numa_node_ids_)
+    {
+      ret.push_back (NumaPlacement{ .numa_node_ = numa_node });
+    }
+  const auto find_placement = [&] (int numa_node) -> NumaPlacement * {
+    const auto it =
+      std::ranges::find (ret, numa_node, &NumaPlacement::numa_node_);
+    return it != ret.end () ? std::addressof (*it) : nullptr;
+  };
+
+  const auto thread_names = get_thread_names ();
+  for (const auto &thread : threads_)
+    {
+      if (auto * placement = find_placement (thread->numa_node_))
+        {
+          placement->thread_names_.push_back (
+            thread_names[thread->get_trace_lane ()]);
+        }
+    }
+  if (main_thread_)
+    {
+      if (auto * placement = find_placement (main_thread_->numa_node_))
+        {
+          placement->thread_names_.push_back (
+            thread_names[main_thread_->get_trace_lane ()]);
+        }
+    }
+
+  for (const auto &node : graph_nodes_->graph_nodes_)
+    {
+      if (auto * placement = find_placement (node->numa_node_))
+        {
+          ++placement->num_graph_nodes_;
+
+          /* the measured cost of a node includes its fused nodes */
+          if (!node->fused_)
+            placement->cost_ns_ += node->processing_cost_ns_.load ();
+        }
+    }
+  return ret;
+}
+
+std::string
+GraphScheduler::numa_placement_to_str () const
+{
+  const auto placement = get_numa_placement ();
+  if (placement.empty ())
+    return "NUMA placement not in use";
+
+  std::string str;
+  for (const auto &numa_node : placement)
+    {
+      str += fmt::format (
+        "NUMA node {}: {} graph nodes, {:.1f} us per cycle, threads: {}\n",
+        numa_node.numa_node_, numa_node.num_graph_nodes_,
+        numa_node.cost_ns_ / 1000.0, fmt::join (numa_node.thread_names_, ", "));
+    }
+  str.pop_back ();
+  return str;
+}
+
+std::string
+GraphScheduler::node_stats_to_str () const
+{
+  const auto stats = get_node_stats ();
+  if (stats.empty ())
+    return "No node statistics available";
+
+  std::string str = fmt::format (
+    "{:>10} {:>10} {:>10} {:>10}  {}\n", "last (us)", "mean (us)", "p99 (us)",
+    "max (us)", "node");
+  double total_mean = 0.0;
+  for (const auto &node_stats : stats)
+    {
+      const auto &s = node_stats.stats_;
+      str += fmt::format (
+        "{:>10.1f} {:>10.1f} {:>10.1f} {:>10.1f}  {}", s.last_ns_ / 1000.0,
+        s.mean_ns_ / 1000.0, s.p99_ns_ / 1000.0, s.max_ns_ / 1000.0,
+        node_stats.name_);
+      if (node_stats.numa_node_ >= 0)
+        {
+          str += fmt::format (" [NUMA node {}]", node_stats.numa_node_);
+        }
+      str += '\n';
+      total_mean += s.mean_ns_ / 1000.0;
+    }
+  str += fmt::format (
+    "{} nodes, {:.1f} us total mean processing time per cycle", stats.size (),
+    total_mean);
+  return str;
 }
 
 GraphScheduler::~GraphScheduler ()
@@ -268,6 +1340,8 @@ GraphScheduler::~GraphScheduler ()
     {
       z_info ("graph already terminated");
     }
+  delete pending_graph_nodes_.exchange (nullptr);
+  delete retired_graph_nodes_.exchange (nullptr);
 }
 
 } // namespace zrythm::dsp
@@ -27,11 +27,18 @@
 #ifndef ZRYTHM_DSP_GRAPH_SCHEDULER_H
 #define ZRYTHM_DSP_GRAPH_SCHEDULER_H
 
+#include <array>
+#include <chrono>
+#include <optional>
 #include <semaphore>
+#include <span>
 
+#include "dsp/anticipative_renderer.h"
 #include "dsp/graph_node.h"
+#include "dsp/graph_trace_recorder.h"
 #include "utils/mpmc_queue.h"
 #include "utils/rt_thread_id.h"
+#include "utils/work_stealing_deque.h"
 
 namespace zrythm::dsp
 {
@@ -58,26 +65,323 @@ class GraphScheduler
   static constexpr int MAX_GRAPH_THREADS = 128;
 
 public:
-  GraphScheduler ();
+  /**
+   * @brief Strategy used to hand ready nodes to the worker threads.
+   */
+  enum class SchedulingStrategy
+  {
+    /**
+     * @brief All ready nodes go through a single shared MPMC queue.
+     */
+    SharedQueue,
+
+    /**
+     * @brief Each thread owns a deque of ready nodes.
+     *
+     * Newly-triggered downstream nodes are pushed to the local deque of the
+     * thread that completed their last dependency (the first one is run
+     * inline), and idle threads steal from the other threads' deques.
+     */
+    WorkStealing,
+  };
+
+  explicit GraphScheduler (
+    SchedulingStrategy strategy = SchedulingStrategy::SharedQueue);
   ~GraphScheduler ();
   Z_DISABLE_COPY_MOVE (GraphScheduler); // copy/move don't make sense here
 
   /**
    * @brief Steals the nodes from the given collection and prepares for
    * processing.
+   *
+   * @note Processing must be stopped while this is called.
    */
   void rechain_from_node_collection (dsp::GraphNodeCollection &&nodes);
 
+  /**
+   * @brief Prepares the given collection and hands it over to the processing
+   * threads, which switch to it at the start of the next cycle.
+   *
+   * Unlike rechain_from_node_collection(), this doesn't require processing to
+   * be stopped. The previous collection is kept alive until
+   * free_retired_node_collections() is called after the switch.
+   *
+   * @note Must only be called from one non-realtime thread, and only when
+   * there is no pending collection.
+   *
+   * @return Whether the collection was published. If false (the queues are
+   * too small for the new graph, or anticipative rendering is enabled), @p
+   * nodes is left untouched and rechain_from_node_collection() must be used
+   * instead.
+   */
+  bool publish_node_collection (dsp::GraphNodeCollection &&nodes);
+
+  /**
+   * @brief Returns whether a published collection hasn't been switched to yet.
+   */
+  bool has_pending_node_collection () const
+  {
+    return applied_generation_.load (std::memory_order_acquire)
+           != published_generation_;
+  }
+
+  /**
+   * @brief Returns the number of published collections switched to (the
+   * version of the graph being processed).
+   */
+  uint64_t get_applied_generation () const
+  {
+    return applied_generation_.load (std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Switches to the published collection, if any.
+   *
+   * Called at the start of each cycle. May also be called from other threads
+   * while processing is stopped.
+   */
+  [[gnu::hot]] void apply_pending_node_collection ();
+
+  /**
+   * @brief Frees the collection that was replaced by the last published
+   * collection.
+   *
+   * Must be called from the publishing thread once
+   * has_pending_node_collection() returns false.
+   */
+  void free_retired_node_collections ();
+
+  /**
+   * @brief Hands over latencies computed with
+   * GraphNodeCollection::compute_latency_updates() on the live nodes, to be
+   * set by apply_pending_latency_updates() at a cycle boundary.
+   *
+   * @note Must only be called from one non-realtime thread, and only when
+   * there are no pending updates or collection.
+   */
+  void publish_latency_updates (
+    std::vector<GraphNodeCollection::LatencyUpdate> &&updates);
+
+  /**
+   * @brief Returns whether published latency updates haven't been applied yet.
+   */
+  bool has_pending_latency_updates () const
+  {
+    return latency_updates_pending_.load (std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Sets the published latency updates, if any.
+   *
+   * Must be called at a cycle boundary by the thread calling run_cycle(), or
+   * from other threads while processing is stopped. Realtime-safe.
+   *
+   * @return Whether any updates were applied.
+   */
+  [[gnu::hot]] bool apply_pending_latency_updates ();
+
+  /**
+   * @brief Sets the CPUs the graph threads are pinned to.
+   *
+   * The main graph thread is pinned to the first CPU and each worker thread to
+   * one of the next ones (wrapping around if there are more threads than
+   * CPUs). An empty list disables pinning.
+   *
+   * If never called, get_default_cpu_affinity() is used.
+   *
+   * If the CPUs span several NUMA nodes and the
+   * @ref SchedulingStrategy::WorkStealing strategy is used, the graph is
+   * partitioned between the nodes (see get_numa_placement()).
+   *
+   * @note Takes effect on the next start_threads().
+   */
+  void set_cpu_affinity (std::vector<int> cpus)
+  {
+    cpu_affinity_ = std::move (cpus);
+  }
+
+  /**
+   * @brief Sets for how long idle graph threads busy-wait for work before
+   * blocking.
+   *
+   * Waking up a blocked thread takes a system call on both sides, which is a
+   * measurable part of the cycle at small buffer sizes. Idle threads first
+   * spin for up to @p duration (within a cycle, or when the next cycle is due
+   * within @p duration), then yield a few times, then block. Zero disables
+   * spinning.
+   *
+   * @note Must be called before start_threads().
+   */
+  void set_idle_spin_duration (std::chrono::nanoseconds duration)
+  {
+    idle_spin_duration_ = duration;
+  }
+
+  /**
+   * @brief Sets the limits below which graphs are processed by walking
+   * @ref GraphNodeCollection::topological_order_ on the thread calling
+   * run_cycle(), without involving the graph threads.
+   *
+   * For small graphs the synchronization needed to distribute the work costs
+   * more than running the nodes in parallel saves. The static schedule is used
+   * if the graph has at most @p max_nodes scheduling units whose estimated
+   * total processing time is at most @p max_cost, and always if there are no
+   * worker threads. The decision is revisited whenever new processing time
+   * measurements come in.
+   *
+   * Disabled by default (@p max_nodes = 0).
+   *
+   * @note Must not be called while processing.
+   */
+  void set_static_schedule_limits (
+    size_t                   max_nodes,
+    std::chrono::nanoseconds max_cost)
+  {
+    static_schedule_max_nodes_ = max_nodes;
+    static_schedule_max_cost_ = max_cost;
+    update_static_schedule_decision ();
+  }
+
+  /**
+   * @brief Sets whether cycles that cross the loop end point are split for
+   * the whole graph.
+   *
+   * When enabled, run_cycle() runs the graph once for the part of the cycle
+   * before the loop end point and once for the part after the loop start
+   * point, so that the nodes don't need to look for loop points themselves.
+   * This only applies to graphs without playback latency (otherwise each
+   * route crosses the loop point at a different time) and while anticipative
+   * rendering is disabled. Other cycles fall back to splitting per node.
+   *
+   * Enabled by default.
+   *
+   * @note Must not be called while processing.
+   */
+  void set_graph_loop_splitting_enabled (bool enabled)
+  {
+    graph_loop_splitting_enabled_ = enabled;
+  }
+
+  /**
+   * @brief Returns whether the current graph is processed with the static
+   * schedule (see set_static_schedule_limits()).
+   */
+  bool is_using_static_schedule () const { return use_static_schedule_; }
+
+  /**
+   * @brief Enables the flight recorder that keeps the node execution spans of
+   * the last cycles (see GraphTraceRecorder).
+   *
+   * Every node is timed while enabled, which costs two clock reads per node.
+   *
+   * @note Takes effect on the next start_threads().
+   */
+  void set_trace_recording_enabled (bool enabled)
+  {
+    trace_recording_enabled_ = enabled;
+  }
+
+  /**
+   * @brief Returns the flight recorder, or nullptr if trace recording was not
+   * enabled when the threads were started.
+   *
+   * The recorder is kept until the threads are started again, so a recording
+   * can still be exported after terminate_threads().
+   */
+  GraphTraceRecorder * get_trace_recorder () { return trace_recorder_.get (); }
+
+  /**
+   * @brief Returns the names of the threads that process the graph, indexed
+   * by their trace lane (see GraphThread::get_trace_lane()).
+   *
+   * The worker threads come first, followed by the main graph thread and the
+   * thread calling run_cycle().
+   */
+  std::vector<std::string> get_thread_names () const;
+
+  /**
+   * @brief Enables rendering the parts of the graph that don't depend on live
+   * input ahead of the playhead on a low-priority thread (see
+   * AnticipativeRenderer).
+   *
+   * The nodes are assigned to the renderer on each rechain, so published
+   * collections can't be used while this is enabled.
+   *
+   * @param transport The transport of the graph.
+   * @param block_length Length of the cycles to render ahead.
+   * @param num_blocks Number of blocks to render ahead.
+   * @note Must not be called while processing. The rendering thread is
+   * started by start_threads().
+   */
+  void enable_anticipative_rendering (
+    const ITransport &transport,
+    nframes_t         block_length,
+    size_t            num_blocks = AnticipativeRenderer::DEFAULT_NUM_BLOCKS);
+
+  /**
+   * @brief Returns the anticipative renderer, or nullptr if not enabled.
+   */
+  AnticipativeRenderer * get_anticipative_renderer ()
+  {
+    return anticipative_renderer_.get ();
+  }
+
+  /**
+   * @brief Reassigns the nodes of the current graph to the anticipative
+   * renderer, if enabled.
+   *
+   * Used when something that affects IProcessable::can_render_ahead() changed
+   * without the graph being rechained.
+   *
+   * @note Must not be called while processing.
+   */
+  void reassign_rendered_ahead_nodes ();
+
+  /**
+   * @brief Returns the CPUs best suited for the graph threads, or an empty list
+   * if all CPUs are equally suitable.
+   *
+   * These are the CPUs isolated from the kernel scheduler if any, otherwise
+   * the performance cores on hybrid CPUs. Placing DSP threads on efficiency
+   * cores can double the worst-case processing time of a cycle, since a cycle
+   * is only as fast as its slowest thread.
+   *
+   * On machines with several NUMA nodes (e.g., multi-socket servers), all CPUs
+   * but one are used otherwise, alternating between the nodes so that the
+   * threads are spread over them.
+   */
+  static std::vector<int> get_default_cpu_affinity ();
+
   /**
    * Starts the threads that will be processing the graph.
    *
    * @param num_threads Number of threads to use. If not set, uses an
-   * appropriate number based on the number of cores. If set, the number will be
-   * clamped to reasonable bounds.
+   * appropriate number based on the number of cores (or the number of CPUs the
+   * threads are pinned to, if any). If set, the number will be clamped to
+   * reasonable bounds.
    * @throw ZrythmException on failure.
    */
   void start_threads (std::optional<int> num_threads = std::nullopt);
 
+  /**
+   * @brief Finds the number of worker threads that processes the current graph
+   * fastest.
+   *
+   * Restarts the threads with each number of workers from 1 to @p max_threads,
+   * runs @p num_cycles cycles and compares the 99th percentile cycle times.
+   * Fewer threads are preferred when the difference is within 5%. The threads
+   * are left running with the chosen number of workers.
+   *
+   * @note The engine must not be running and the graph must have been
+   * rechained.
+   * @throw ZrythmException if the threads fail to start.
+   * @return The chosen number of worker threads.
+   */
+  int calibrate_num_threads (
+    EngineProcessTimeInfo time_nfo,
+    int                   max_threads,
+    int                   num_cycles = 256);
+
   /**
    * Tell all threads to terminate.
    */
@@ -88,7 +392,37 @@ public:
    */
   [[gnu::hot]] void trigger_node (GraphNode &node);
 
-  auto &get_nodes () { return graph_nodes_; }
+  /**
+   * @brief Called when a node has completed processing, with its child
+   * nodes.
+   *
+   * Like calling trigger_node() for each node, but the ready nodes are pushed
+   * to the trigger queues in batches.
+   */
+  [[gnu::hot]] void
+  trigger_nodes (std::span<const std::reference_wrapper<GraphNode>> nodes);
+
+  /**
+   * @brief Decrements the node's reference count and returns whether all its
+   * dependencies have now completed.
+   *
+   * If so, the reference count is reset for the next cycle and the caller is
+   * responsible for running the node.
+   */
+  [[gnu::hot]] static bool release_dependency (GraphNode &node)
+  {
+    if (node.refcount_.fetch_sub (1) == 1)
+      {
+        /* reset reference count for next cycle */
+        node.refcount_.store (node.init_refcount_);
+        return true;
+      }
+    return false;
+  }
+
+  auto get_scheduling_strategy () const { return strategy_; }
+
+  auto &get_nodes () { return *graph_nodes_; }
 
   void
   run_cycle (EngineProcessTimeInfo time_nfo, nframes_t remaining_preroll_frames);
@@ -103,13 +437,296 @@ public:
 
   void clear_external_output_buffers ();
 
+  /**
+   * @brief Processing time statistics of a single node.
+   */
+  struct NodeStats
+  {
+    std::string              name_;
+    GraphNodeStats::Snapshot stats_;
+
+    /** See GraphNode::numa_node_. */
+    int numa_node_ = -1;
+  };
+
+  /**
+   * @brief Returns the processing time statistics of each node, sorted by
+   * descending mean processing time.
+   *
+   * The statistics of a node include the nodes fused into it.
+   *
+   * Always empty unless built with ZRYTHM_DSP_NODE_PROFILING.
+   *
+   * @note Must be called from the thread that rechains the graph.
+   */
+  std::vector<NodeStats> get_node_stats () const;
+
+  /**
+   * @brief Returns the result of get_node_stats() as a human-readable table.
+   */
+  std::string node_stats_to_str () const;
+
+  /**
+   * @brief Graph threads and graph nodes placed on a NUMA node.
+   */
+  struct NumaPlacement
+  {
+    int numa_node_ = -1;
+
+    /** Names of the threads pinned to CPUs of the node. */
+    std::vector<std::string> thread_names_;
+
+    /** Number of graph nodes assigned to the node (including fused ones). */
+    size_t num_graph_nodes_ = 0;
+
+    /** Measured processing time of those nodes per cycle. */
+    double cost_ns_ = 0.0;
+  };
+
+  /**
+   * @brief Returns how the graph is partitioned between NUMA nodes.
+   *
+   * When the threads are pinned to CPUs of several NUMA nodes and the
+   * @ref SchedulingStrategy::WorkStealing strategy is used, each group of
+   * graph nodes that make up roughly one track (see
+   * GraphNodeCollection::get_placement_groups()) is assigned to one of the
+   * NUMA nodes, balancing the processing time per thread. The threads prefer
+   * nodes assigned to their NUMA node and only take others when they run out
+   * of work, and the port buffers of each group are allocated on its node
+   * (see AudioEngine::rebuild_port_buffer_arena()). Groups keep their NUMA
+   * node across rechains; only new groups are balanced.
+   *
+   * Empty if NUMA placement is not in use.
+   *
+   * @note Must be called from the thread that rechains the graph.
+   */
+  std::vector<NumaPlacement> get_numa_placement () const;
+
+  /**
+   * @brief Returns the result of get_numa_placement() as a human-readable
+   * summary.
+   */
+  std::string numa_placement_to_str () const;
+
+  /**
+   * @brief Returns whether the graph is partitioned between NUMA nodes (see
+   * get_numa_placement()).
+   */
+  bool uses_numa_placement () const { return !numa_node_ids_.empty (); }
+
+  /**
+   * @brief Returns the approximate number of bytes used by the scheduler
+   * (the nodes of the graph, the queues and the trace recorder).
+   *
+   * @note Must be called from the thread that rechains the graph.
+   */
+  size_t get_memory_usage () const;
+
+private:
+  /**
+   * @brief Processes the given node, measuring how long it takes if cost
+   * sampling was requested for this cycle or trace recording is enabled.
+   *
+   * @param trace_lane The lane of the calling thread in the trace recorder.
+   */
+  [[gnu::hot]] void process_node (GraphNode &node, size_t trace_lane);
+
+  /**
+   * @brief Trace recorder lane of the thread calling run_cycle() (used by
+   * the static schedule).
+   */
+  size_t get_caller_trace_lane () const { return threads_.size () + 1; }
+
+  /**
+   * @brief Decides whether the current graph should be processed with the
+   * static schedule.
+   *
+   * Realtime-safe.
+   */
+  void update_static_schedule_decision ();
+
+  /**
+   * @brief Processes the current graph on the calling thread in topological
+   * order.
+   */
+  [[gnu::hot]] void run_static_schedule ();
+
+  /**
+   * @brief Processes the current graph once for @ref time_nfo_, either with
+   * the static schedule or on the graph threads.
+   */
+  [[gnu::hot]] void run_graph_pass ();
+
+  /**
+   * @brief Returns whether the current cycle can be split at the loop points
+   * for the whole graph (see set_graph_loop_splitting_enabled()).
+   */
+  bool can_split_graph_at_loop_points () const;
+
+  /**
+   * @brief Pins the calling thread to the CPU assigned to @p thread, if any.
+   *
+   * Called by each graph thread when it starts.
+   */
+  void apply_cpu_affinity (const GraphThread &thread) const;
+
+  /**
+   * @brief Returns the index in @ref thread_cpus_ of the CPU @p thread is
+   * pinned to.
+   *
+   * @note Requires @ref thread_cpus_ to be non-empty.
+   */
+  size_t get_thread_cpu_index (const GraphThread &thread) const;
+
+  /**
+   * @brief Sets up the NUMA nodes of the threads, the order in which they steal
+   * from each other and the per-node ready queues, and assigns the current
+   * graph's nodes to the NUMA nodes.
+   *
+   * Called by start_threads() once the threads are created.
+   */
+  void update_numa_placement ();
+
+  /**
+   * @brief Assigns each placement group of @p nodes to a NUMA node used by the
+   * threads (see get_numa_placement()).
+   *
+   * Clears the NUMA nodes of @p nodes if NUMA placement is not in use.
+   */
+  void assign_numa_nodes (dsp::GraphNodeCollection &nodes) const;
+
+  /**
+   * @brief Gets @p nodes ready to be switched to.
+   *
+   * @param[out] processables_that_need_external_buffer_clear Populated with the
+   * processables of @p nodes that need their external buffers cleared.
+   */
+  void prepare_node_collection (
+    dsp::GraphNodeCollection &nodes,
+    std::vector<std::reference_wrapper<dsp::IProcessable>>
+      &processables_that_need_external_buffer_clear) const;
+
+  /**
+   * @brief Returns the number of nodes the ready-node queues can hold without
+   * reallocating.
+   */
+  size_t get_queue_capacity () const;
+
+  /**
+   * @brief Attempts to steal a node from any thread other than @p thief.
+   *
+   * Used by @ref SchedulingStrategy::WorkStealing.
+   */
+  [[gnu::hot]] GraphNode * steal_node (const GraphThread &thief);
+
+  /**
+   * @brief Wakes up to @p max_threads idle threads.
+   */
+  [[gnu::hot]] void wake_idle_threads (int max_threads);
+
+  /**
+   * @brief Pushes a ready node to the trigger queue matching its priority.
+   */
+  [[gnu::hot]] void push_ready_node (GraphNode &node)
+  {
+    trigger_queue_size_.fetch_add (1);
+    trigger_queues_[node.priority_].push_back (&node);
+  }
+
+  /**
+   * @brief Pushes ready nodes of the same @p priority to the matching trigger
+   * queue at once.
+   */
+  [[gnu::hot]] void
+  push_ready_nodes (int priority, std::span<GraphNode * const> nodes)
+  {
+    trigger_queue_size_.fetch_add (static_cast<int> (nodes.size ()));
+    trigger_queues_[priority].push_back_multiple (nodes.data (), nodes.size ());
+  }
+
+  /**
+   * @brief Pushes a ready node to the queue of its NUMA node (see
+   * GraphNode::numa_node_), or to the trigger queues if the node isn't used.
+   */
+  [[gnu::hot]] void push_numa_ready_node (GraphNode &node)
+  {
+    const auto numa_node = static_cast<size_t> (node.numa_node_);
+    if (numa_node >= numa_queues_.size () || !numa_queues_[numa_node])
+      {
+        push_ready_node (node);
+        return;
+      }
+
+    trigger_queue_size_.fetch_add (1);
+    numa_queues_[numa_node]->push_back (&node);
+  }
+
+  /**
+   * @brief Pops a ready node from the queue of @p numa_node, if any.
+   *
+   * Decrements @ref trigger_queue_size_ on success.
+   */
+  [[gnu::hot]] GraphNode * pop_numa_ready_node (int numa_node)
+  {
+    GraphNode * node = nullptr;
+    if (numa_queues_[numa_node]->pop_front (node))
+      {
+        trigger_queue_size_.fetch_sub (1);
+        return node;
+      }
+    return nullptr;
+  }
+
+  /**
+   * @brief Pops the highest priority ready node from the trigger queues.
+   *
+   * @note The caller is responsible for decrementing @ref trigger_queue_size_
+   * on success.
+   */
+  [[gnu::hot]] bool pop_ready_node (GraphNode *&node)
+  {
+    for (auto &queue : std::views::reverse (trigger_queues_))
+      {
+        if (queue.pop_front (node))
+          {
+            return true;
+          }
+      }
+    return false;
+  }
+
+  /**
+   * @brief Increments the number of processed cycles and decides whether node
+   * processing times should be measured in the new cycle.
+   */
+  void advance_cost_sampling ()
+  {
+    sample_node_costs_ = (++cycle_count_ % COST_SAMPLING_INTERVAL) == 0;
+  }
+
 private:
+  SchedulingStrategy strategy_;
+
   std::vector<GraphThreadPtr> threads_;
   GraphThreadPtr              main_thread_;
 
+  /** CPUs requested via set_cpu_affinity(). */
+  std::optional<std::vector<int>> cpu_affinity_;
+
+  /** CPUs the running threads are pinned to (empty if not pinned). */
+  std::vector<int> thread_cpus_;
+
   std::vector<std::reference_wrapper<dsp::IProcessable>>
     processables_that_need_external_buffer_clear_when_returning_early_from_processing_cycle_;
 
+  /**
+   * @brief The processables of @ref pending_graph_nodes_ that need their
+   * external buffers cleared.
+   *
+   * Swapped with the above when switching to the pending collection.
+   */
+  std::vector<std::reference_wrapper<dsp::IProcessable>> pending_processables_;
+
   /**
    * @brief Time info for the current process cycle.
    */
@@ -120,6 +737,15 @@ private:
    */
   nframes_t remaining_preroll_frames_{};
 
+  /** See set_graph_loop_splitting_enabled(). */
+  bool graph_loop_splitting_enabled_ = true;
+
+  /**
+   * @brief Whether @ref time_nfo_ is a part of the cycle that was already
+   * split at the loop points (see GraphNode::process()).
+   */
+  bool loop_points_handled_ = false;
+
   /** Synchronization with main process callback. */
   /* FIXME: this should probably be binary semaphore but i left it as a
    * counting one out of caution while refactoring from ZixSem */
@@ -129,19 +755,125 @@ private:
   /** Number of threads waiting for work. */
   std::atomic<int> idle_thread_cnt_ = 0;
 
+  static constexpr std::chrono::nanoseconds DEFAULT_IDLE_SPIN_DURATION =
+    std::chrono::microseconds (20);
+
+  /** See set_idle_spin_duration(). */
+  std::chrono::nanoseconds idle_spin_duration_ = DEFAULT_IDLE_SPIN_DURATION;
+
+  /** Start time of the last cycle (steady clock). */
+  std::chrono::steady_clock::time_point last_cycle_start_;
+
+  /** Moving average of the time between cycle starts. */
+  std::chrono::nanoseconds cycle_period_{};
+
+  /**
+   * @brief Expected start time of the next cycle, in nanoseconds since the
+   * steady clock's epoch.
+   *
+   * Used by idle threads to decide whether spinning is worth it.
+   */
+  std::atomic<int64_t> next_cycle_due_ns_ = 0;
+
   /** Wake up graph node process threads. */
   std::counting_semaphore<MAX_GRAPH_THREADS> trigger_sem_{ 0 };
 
-  /** Queue containing nodes that can be processed. */
-  MPMCQueue<GraphNode *> trigger_queue_;
+  /**
+   * Queues containing nodes that can be processed, one per priority level
+   * (see GraphNode::priority_).
+   *
+   * When using @ref SchedulingStrategy::WorkStealing these are only used as a
+   * fallback if a thread's local deque is full.
+   */
+  std::array<MPMCQueue<GraphNode *>, GraphNode::NUM_PRIORITY_LEVELS>
+    trigger_queues_;
 
   /** Number of entries in trigger queue. */
   std::atomic<int> trigger_queue_size_ = 0;
 
+  /**
+   * @brief The NUMA nodes the threads are pinned to, if more than one and the
+   * graph is partitioned between them (see get_numa_placement()).
+   */
+  std::vector<int> numa_node_ids_;
+
+  /**
+   * @brief Ready nodes assigned to each NUMA node (see GraphNode::numa_node_)
+   * that were made ready by a thread on another node, indexed by NUMA node ID
+   * (null for the nodes not in @ref numa_node_ids_).
+   *
+   * Also counted in @ref trigger_queue_size_.
+   */
+  std::vector<std::unique_ptr<MPMCQueue<GraphNode *>>> numa_queues_;
+
+  /**
+   * @brief Node processing times are measured once every this many cycles.
+   *
+   * The measurements are used to compute the critical path priorities.
+   */
+  static constexpr uint64_t COST_SAMPLING_INTERVAL = 64;
+
+  /** Number of cycles run so far. */
+  uint64_t cycle_count_ = 0;
+
+  /** Whether to measure node processing times in the current cycle. */
+  bool sample_node_costs_ = false;
+
+  /** See set_static_schedule_limits(). */
+  size_t                   static_schedule_max_nodes_ = 0;
+  std::chrono::nanoseconds static_schedule_max_cost_{};
+
+  /** Whether the current graph is processed with the static schedule. */
+  bool use_static_schedule_ = false;
+
+  /** See set_trace_recording_enabled(). */
+  bool trace_recording_enabled_ = false;
+
+  /**
+   * @brief Flight recorder with one lane per worker thread, one for the main
+   * thread and one for the thread calling run_cycle().
+   */
+  std::unique_ptr<GraphTraceRecorder> trace_recorder_;
+
+  /** See enable_anticipative_rendering(). */
+  std::unique_ptr<AnticipativeRenderer> anticipative_renderer_;
+
+  /**
+   * @brief The queues are sized to this many times the number of nodes on
+   * rechain, so that graphs that grow can still be published.
+   */
+  static constexpr size_t QUEUE_CAPACITY_HEADROOM = 2;
+
   /**
    * @brief Live graph nodes.
    */
-  dsp::GraphNodeCollection graph_nodes_;
+  std::unique_ptr<dsp::GraphNodeCollection> graph_nodes_;
+
+  /**
+   * @brief Collection published by publish_node_collection(), to be switched
+   * to at the start of the next cycle.
+   */
+  std::atomic<dsp::GraphNodeCollection *> pending_graph_nodes_ = nullptr;
+
+  /**
+   * @brief Collection replaced by the pending collection, to be freed outside
+   * the realtime threads.
+   */
+  std::atomic<dsp::GraphNodeCollection *> retired_graph_nodes_ = nullptr;
+
+  /** Number of collections published (only accessed by the publisher). */
+  uint64_t published_generation_ = 0;
+
+  /** Number of published collections switched to. */
+  std::atomic<uint64_t> applied_generation_ = 0;
+
+  /**
+   * @brief Latency updates published by publish_latency_updates() (only
+   * accessed by the publisher while @ref latency_updates_pending_ is false).
+   */
+  std::vector<GraphNodeCollection::LatencyUpdate> pending_latency_updates_;
+
+  std::atomic<bool> latency_updates_pending_ = false;
 
   /** Remaining unprocessed terminal nodes in this cycle. */
   std::atomic<int> terminal_refcnt_ = 0;
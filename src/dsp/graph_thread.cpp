@@ -89,7 +89,10 @@
 
 #include "dsp/graph_scheduler.h"
 #include "dsp/graph_thread.h"
+#include "utils/rt_guard.h"
+#include "utils/rt_logger.h"
 #include "utils/rt_thread_id.h"
+#include "utils/tracing.h"
 
 namespace zrythm::dsp
 {
@@ -102,6 +105,66 @@ constexpr auto THREAD_STACK_SIZE = 0x80000; // 512kB
 constexpr auto THREAD_STACK_SIZE = 0x20000; // 128kB
 #endif
 
+/**
+ * @brief Hints the CPU that we are busy-waiting.
+ */
+[[gnu::always_inline]] static inline void
+cpu_relax ()
+{
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause ();
+#elif defined(__aarch64__)
+  asm volatile ("isb" ::: "memory");
+#endif
+}
+
+template <typename Semaphore>
+void
+GraphThread::wait_for (Semaphore &sem)
+{
+  /* number of attempts between clock reads while spinning */
+  constexpr int SPINS_PER_CLOCK_CHECK = 64;
+  constexpr int NUM_YIELDS = 4;
+
+  const auto spin_duration = scheduler_.idle_spin_duration_;
+  if (spin_duration.count () > 0)
+    {
+      const auto now = std::chrono::steady_clock::now ();
+
+      /* within a cycle more work is coming soon, but between cycles spinning
+       * only pays off if the next cycle is due shortly */
+      const bool between_cycles = scheduler_.terminal_refcnt_.load () == 0;
+      const auto next_cycle_due = std::chrono::steady_clock::time_point (
+        std::chrono::nanoseconds (
+          scheduler_.next_cycle_due_ns_.load (std::memory_order_relaxed)));
+      if (!between_cycles || next_cycle_due - now <= spin_duration)
+        {
+          const auto deadline = now + spin_duration;
+          do
+            {
+              for (int i = 0; i < SPINS_PER_CLOCK_CHECK; ++i)
+                {
+                  if (sem.try_acquire ())
+                    return;
+                  cpu_relax ();
+                }
+            }
+          while (std::chrono::steady_clock::now () < deadline);
+
+          for (int i = 0; i < NUM_YIELDS; ++i)
+            {
+              if (sem.try_acquire ())
+                return;
+              yield ();
+            }
+        }
+    }
+
+  /* blocking while there is nothing to do is intended */
+  utils::RtGuard::Suspend rt_guard_suspend;
+  sem.acquire ();
+}
+
 void
 GraphThread::on_reached_terminal_node ()
 {
@@ -127,25 +190,27 @@ GraphThread::on_reached_terminal_node ()
         return;
 
       /* now wait for the next cycle to begin */
-      scheduler_.callback_start_sem_.acquire ();
+      wait_for (scheduler_.callback_start_sem_);
 
       if (threadShouldExit ())
         return;
 
       /* reset terminal reference count */
       scheduler_.terminal_refcnt_.store (
-        scheduler_.graph_nodes_.terminal_nodes_.size ());
+        scheduler_.graph_nodes_->terminal_nodes_.size ());
 
       /* and start the initial nodes */
-      for (auto node : scheduler_.graph_nodes_.trigger_nodes_)
-        {
-          scheduler_.trigger_queue_size_.fetch_add (1);
-          scheduler_.trigger_queue_.push_back (std::addressof (node.get ()));
-        }
+      push_trigger_nodes ();
       /* continue in worker-thread */
     }
 }
 
+size_t
+GraphThread::get_trace_lane () const
+{
+  return is_main_ ? scheduler_.threads_.size () : static_cast<size_t> (id_);
+}
+
 void
 GraphThread::run_worker () [[clang::nonblocking]]
 {
@@ -157,18 +222,30 @@ GraphThread::run_worker () [[clang::nonblocking]]
     "Worker thread {} created (num threads {})", id_,
     scheduler->threads_.size ());
 
+  Z_TRACE_SET_THREAD_NAME (getThreadName ().toRawUTF8 ());
+
+  utils::RtGuard::Scope rt_guard_scope;
+
   /* wait for all threads to get created */
   if (id_ < static_cast<int> (scheduler->threads_.size ()) - 1)
     {
       yield ();
     }
 
+  if (
+    scheduler->strategy_ == GraphScheduler::SchedulingStrategy::WorkStealing)
+    {
+      run_work_stealing_worker ();
+      return;
+    }
+
   for (;;)
     {
       dsp::GraphNode * to_run = nullptr;
 
       if (threadShouldExit ()) [[unlikely]]
         {
+          utils::RtGuard::Suspend rt_guard_suspend;
           if (id_ == -1)
             {
               z_info ("terminating main thread");
@@ -180,11 +257,12 @@ GraphThread::run_worker () [[clang::nonblocking]]
           return;
         }
 
-      if (scheduler->trigger_queue_.pop_front (to_run))
+      if (scheduler->pop_ready_node (to_run))
         {
           if (to_run == nullptr) [[unlikely]]
             {
-              z_error ("[{}]: null node in queue, terminating thread...", id_);
+              z_rt_error (
+                "[{}]: null node in queue, terminating thread...", id_);
               return;
             }
           if constexpr (DEBUG_THREADS)
@@ -202,7 +280,7 @@ GraphThread::run_worker () [[clang::nonblocking]]
           int wakeup = std::min (idle_cnt + 1, work_avail);
           if constexpr (DEBUG_THREADS)
             {
-              z_debug (
+              z_rt_debug (
                 "[{}]: Waking up {} idle threads (idle count {}), work available -> {}",
                 id_, wakeup - 1, idle_cnt, work_avail);
             }
@@ -219,7 +297,7 @@ GraphThread::run_worker () [[clang::nonblocking]]
           int idle_thread_cnt = scheduler->idle_thread_cnt_.fetch_add (1) + 1;
           if constexpr (DEBUG_THREADS)
             {
-              z_debug (
+              z_rt_debug (
                 "[{}]: no node to run. just increased idle thread count and waiting for work "
                 "(current idle threads {})",
                 id_, idle_thread_cnt);
@@ -227,13 +305,13 @@ GraphThread::run_worker () [[clang::nonblocking]]
           if (idle_thread_cnt > static_cast<int> (scheduler->threads_.size ()))
             [[unlikely]]
             {
-              z_error (
+              z_rt_error (
                 "[{}]: idle thread count {} is greater than the number of threads "
                 "{}. this should never occur",
                 id_, idle_thread_cnt, scheduler->threads_.size ());
             }
 
-          scheduler->trigger_sem_.acquire ();
+          wait_for (scheduler->trigger_sem_);
 
           if (threadShouldExit ()) [[unlikely]]
             {
@@ -244,25 +322,25 @@ GraphThread::run_worker () [[clang::nonblocking]]
           scheduler->idle_thread_cnt_.fetch_sub (1);
           if constexpr (DEBUG_THREADS)
             {
-              z_info (
-                "[{}]: work found, decremented idle thread count (current count %d) and "
+              z_rt_info (
+                "[{}]: work found, decremented idle thread count (current count {}) and "
                 "dequeuing node to process",
                 id_, scheduler->idle_thread_cnt_.load ());
             }
 
           /* try to find some work to do */
-          scheduler->trigger_queue_.pop_front (to_run);
+          scheduler->pop_ready_node (to_run);
         }
 
       /* this thread has now claimed the graph node for processing - process it */
+      Z_TRACE_ZONE ("GraphThread::run_worker");
       scheduler->trigger_queue_size_.fetch_sub (1);
       if constexpr (DEBUG_THREADS)
         {
-          z_info ("[{}]: running node", id_);
+          z_rt_info ("[{}]: running node", id_);
         }
 
-      to_run->process (
-        scheduler_.get_time_nfo (), scheduler_.get_remaining_preroll_frames ());
+      scheduler->process_node (*to_run, get_trace_lane ());
 
       /* if there are no outgoing edges, this is a terminal node */
       if (to_run->childnodes_.empty ())
@@ -273,9 +351,165 @@ GraphThread::run_worker () [[clang::nonblocking]]
       else
         {
           /* notify downstream nodes that depend on this node */
-          for (const auto child_node : to_run->childnodes_)
+          scheduler->trigger_nodes (to_run->childnodes_);
+        }
+    }
+}
+
+void
+GraphThread::push_trigger_nodes ()
+{
+  const auto &trigger_nodes = scheduler_.graph_nodes_->trigger_nodes_;
+  if (
+    scheduler_.strategy_ == GraphScheduler::SchedulingStrategy::WorkStealing)
+    {
+      /* push in reverse so that the most critical node is popped first */
+      for (const auto node : std::views::reverse (trigger_nodes))
+        {
+          push_ready (node.get ());
+        }
+
+      /* this thread will pick up one of them itself */
+      scheduler_.wake_idle_threads (static_cast<int> (trigger_nodes.size ()) - 1);
+      return;
+    }
+
+  for (const auto node : trigger_nodes)
+    {
+      scheduler_.push_ready_node (node.get ());
+    }
+}
+
+void
+GraphThread::push_local (GraphNode &node)
+{
+  if (!local_queue_.push (&node)) [[unlikely]]
+    {
+      /* should not happen since the deque is sized to the number of nodes */
+      scheduler_.push_ready_node (node);
+    }
+}
+
+void
+GraphThread::push_ready (GraphNode &node)
+{
+  if (is_for_other_numa_node (node))
+    {
+      scheduler_.push_numa_ready_node (node);
+      return;
+    }
+
+  push_local (node);
+}
+
+bool
+GraphThread::is_for_other_numa_node (const GraphNode &node) const
+{
+  return numa_node_ >= 0 && node.numa_node_ >= 0
+         && node.numa_node_ != numa_node_;
+}
+
+GraphNode *
+GraphThread::release_children (GraphNode &node)
+{
+  /* children are sorted by descending priority. iterate in reverse so that the
+   * most critical ready child is run inline and the next most critical one
+   * ends up at the bottom of the deque (popped next by this thread) */
+  GraphNode * next = nullptr;
+  int         num_pushed = 0;
+  for (const auto child : std::views::reverse (node.childnodes_))
+    {
+      if (!GraphScheduler::release_dependency (child.get ()))
+        {
+          continue;
+        }
+
+      /* leave children placed on other NUMA nodes to their threads */
+      if (is_for_other_numa_node (child.get ()))
+        {
+          scheduler_.push_numa_ready_node (child.get ());
+          ++num_pushed;
+          continue;
+        }
+
+      if (next != nullptr)
+        {
+          push_local (*next);
+          ++num_pushed;
+        }
+      next = std::addressof (child.get ());
+    }
+
+  if (num_pushed > 0)
+    {
+      scheduler_.wake_idle_threads (num_pushed);
+    }
+
+  return next;
+}
+
+void
+GraphThread::run_work_stealing_worker ()
+{
+  auto * scheduler = &scheduler_;
+
+  for (;;)
+    {
+      if (threadShouldExit ()) [[unlikely]]
+        {
+          utils::RtGuard::Suspend rt_guard_suspend;
+          z_info ("[{}]: terminating thread", id_);
+          return;
+        }
+
+      dsp::GraphNode * to_run = nullptr;
+      if (auto local = local_queue_.pop ())
+        {
+          to_run = *local;
+        }
+      else
+        {
+          to_run = scheduler->steal_node (*this);
+        }
+
+      if (to_run == nullptr)
+        {
+          /* no work anywhere - fall asleep until some thread pushes new nodes.
+           * a thread never sleeps while its own deque is non-empty, so work
+           * can't get stranded even if a wakeup is missed */
+          scheduler->idle_thread_cnt_.fetch_add (1);
+          wait_for (scheduler->trigger_sem_);
+
+          if (threadShouldExit ()) [[unlikely]]
             {
-              scheduler->trigger_node (child_node);
+              return;
+            }
+
+          scheduler->idle_thread_cnt_.fetch_sub (1);
+          continue;
+        }
+
+      /* keep following the chain on this thread for as long as processing
+       * makes a child node ready */
+      while (to_run != nullptr)
+        {
+          Z_TRACE_ZONE ("GraphThread::run_worker");
+          if constexpr (DEBUG_THREADS)
+            {
+              z_rt_info ("[{}]: running node", id_);
+            }
+
+          scheduler->process_node (*to_run, get_trace_lane ());
+
+          if (to_run->childnodes_.empty ())
+            {
+              /* notify parent graph */
+              on_reached_terminal_node ();
+              to_run = nullptr;
+            }
+          else
+            {
+              to_run = release_children (*to_run);
             }
         }
     }
@@ -287,6 +521,8 @@ GraphThread::run ()
   /* pre-create the unique identifier of this thread */
   rt_thread_id_ = current_thread_id.get ();
 
+  scheduler_.apply_cpu_affinity (*this);
+
   if (is_main_)
     {
       auto graph = &scheduler_;
@@ -302,6 +538,9 @@ GraphThread::run ()
       /* wait for initial process callback */
       graph->callback_start_sem_.acquire ();
 
+      if (threadShouldExit ())
+        return;
+
       /* first time setup */
 
       /* Can't run without a graph */
@@ -311,12 +550,7 @@ GraphThread::run ()
 
       /* bootstrap trigger-list.
        * (later this is done by Graph.reached_terminal_node())*/
-      for (const auto node : graph->graph_nodes_.trigger_nodes_)
-        {
-          graph->trigger_queue_size_.fetch_add (1);
-          /*z_info ("[main] pushing back node {} during bootstrap", i);*/
-          graph->trigger_queue_.push_back (std::addressof (node.get ()));
-        }
+      push_trigger_nodes ();
     }
 
   /* after setup, the main-thread just becomes a normal worker */
@@ -365,7 +599,8 @@ GraphThread::
     : juce::Thread (
         is_main ? "GraphWorkerMain" : fmt::format ("GraphWorker{}", id),
         THREAD_STACK_SIZE + get_stack_size ()),
-      id_ (id), is_main_ (is_main), scheduler_ (scheduler)
+      id_ (id), is_main_ (is_main), scheduler_ (scheduler),
+      local_queue_ (scheduler.get_queue_capacity ())
 {
 }
 
@@ -6,7 +6,10 @@
 
 #include "zrythm-config.h"
 
+#include <vector>
+
 #include "utils/rt_thread_id.h"
+#include "utils/work_stealing_deque.h"
 
 #include "juce_wrapper.h"
 
@@ -14,6 +17,7 @@ namespace zrythm::dsp
 {
 
 class GraphScheduler;
+class GraphNode;
 
 /**
  * @brief Processing graph thread.
@@ -41,6 +45,14 @@ public:
    */
   [[gnu::hot]] void on_reached_terminal_node ();
 
+  /**
+   * @brief Returns the lane this thread records to in the scheduler's trace
+   * recorder.
+   *
+   * Workers use their index and the main thread the lane after them.
+   */
+  size_t get_trace_lane () const;
+
 private:
   void run () override;
 
@@ -49,6 +61,52 @@ private:
    */
   void run_worker ();
 
+  /**
+   * @brief Worker loop used with GraphScheduler::SchedulingStrategy::WorkStealing.
+   */
+  void run_work_stealing_worker ();
+
+  /**
+   * @brief Acquires @p sem, spinning and yielding for a while before blocking
+   * according to GraphScheduler::set_idle_spin_duration().
+   */
+  template <typename Semaphore> [[gnu::hot]] void wait_for (Semaphore &sem);
+
+  /**
+   * @brief Queues the trigger nodes of the graph to start a new cycle.
+   */
+  void push_trigger_nodes ();
+
+  /**
+   * @brief Pushes a ready node to this thread's local deque, falling back to
+   * the scheduler's shared queue if the deque is full.
+   */
+  [[gnu::hot]] void push_local (GraphNode &node);
+
+  /**
+   * @brief Pushes a ready node to this thread's local deque, or to the queue
+   * of its NUMA node if it is assigned to a NUMA node other than this
+   * thread's.
+   */
+  [[gnu::hot]] void push_ready (GraphNode &node);
+
+  /**
+   * @brief Returns whether @p node should be processed by the threads of
+   * another NUMA node.
+   */
+  bool is_for_other_numa_node (const GraphNode &node) const;
+
+  /**
+   * @brief Notifies the children of the given (just processed) node.
+   *
+   * Used with GraphScheduler::SchedulingStrategy::WorkStealing.
+   *
+   * @return The first child that became ready (to be run inline by this
+   * thread), or nullptr. Any other children that became ready are pushed with
+   * push_ready().
+   */
+  [[gnu::hot]] GraphNode * release_children (GraphNode &node);
+
 public:
   /**
    * Thread index in zrythm.
@@ -66,6 +124,28 @@ public:
 
   /** Pointer back to the owner scheduler. */
   GraphScheduler &scheduler_;
+
+  /**
+   * @brief Nodes ready to be processed by this thread (or stolen by others).
+   *
+   * Only used with GraphScheduler::SchedulingStrategy::WorkStealing.
+   */
+  WorkStealingDeque<GraphNode *> local_queue_;
+
+  /**
+   * @brief NUMA node of the CPU this thread is pinned to, if the graph is
+   * partitioned between NUMA nodes (see GraphScheduler::get_numa_placement()),
+   * otherwise -1.
+   */
+  int numa_node_ = -1;
+
+  /**
+   * @brief The other threads, in the order this thread steals from them.
+   *
+   * The first @ref num_same_node_victims_ are on the same NUMA node.
+   */
+  std::vector<GraphThread *> steal_victims_;
+  size_t                     num_same_node_victims_ = 0;
 };
 
 } // namespace zrythm::dsp
@@ -0,0 +1,164 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cstdlib>
+
+#include "dsp/graph_node.h"
+#include "dsp/graph_trace_recorder.h"
+#include "utils/exceptions.h"
+
+#include <yyjson.h>
+
+namespace zrythm::dsp
+{
+
+GraphTraceRecorder::GraphTraceRecorder (
+  std::vector<std::string> lane_names,
+  size_t                   spans_per_lane)
+    : lane_names_ (std::move (lane_names)), lanes_ (lane_names_.size () + 1)
+{
+  for (auto &lane : lanes_)
+    {
+      lane.spans_.resize (std::max (spans_per_lane, size_t{ 2 }));
+    }
+}
+
+void
+GraphTraceRecorder::reset ()
+{
+  for (auto &lane : lanes_)
+    {
+      lane.head_.store (0);
+    }
+  frozen_.store (false, std::memory_order_release);
+}
+
+void
+GraphTraceRecorder::register_node_names (const GraphNodeCollection &nodes)
+{
+  prev_node_names_ = std::move (node_names_);
+  node_names_.clear ();
+  for (const auto &node : nodes.graph_nodes_)
+    {
+      node_names_.emplace (
+        node.get (), node->get_processable ().get_node_name ());
+    }
+}
+
+std::string
+GraphTraceRecorder::get_node_name (const GraphNode * node) const
+{
+  if (auto it = node_names_.find (node); it != node_names_.end ())
+    return it->second;
+  if (auto it = prev_node_names_.find (node); it != prev_node_names_.end ())
+    return it->second;
+  return "(unknown node)";
+}
+
+std::vector<GraphTraceRecorder::Span>
+GraphTraceRecorder::get_spans (size_t lane_idx) const
+{
+  const auto &lane = lanes_.at (lane_idx);
+  const auto  head = lane.head_.load (std::memory_order_acquire);
+  const auto  capacity = lane.spans_.size ();
+
+  /* a thread that checked the frozen flag just before it was set may still be
+   * writing the slot at the head, so that slot is skipped */
+  const auto first = head >= capacity ? head - capacity + 1 : 0;
+
+  std::vector<Span> spans;
+  spans.reserve (head - first);
+  for (auto i = first; i < head; ++i)
+    {
+      spans.push_back (lane.spans_[i % capacity]);
+    }
+  return spans;
+}
+
+std::string
+GraphTraceRecorder::to_chrome_trace_json (
+  std::chrono::nanoseconds budget,
+  size_t                   num_cycles) const
+{
+  auto cycles = get_spans (get_num_lanes ());
+  if (cycles.size () > num_cycles)
+    {
+      cycles.erase (
+        cycles.begin (),
+        cycles.end () - static_cast<ptrdiff_t> (num_cycles));
+    }
+  const auto start_ns = cycles.empty () ? 0 : cycles.front ().start_ns_;
+  const auto end_ns = cycles.empty () ? 0 : cycles.back ().end_ns_;
+
+  yyjson_mut_doc * doc = yyjson_mut_doc_new (nullptr);
+  yyjson_mut_val * root = yyjson_mut_obj (doc);
+  yyjson_mut_doc_set_root (doc, root);
+  yyjson_mut_obj_add_str (doc, root, "displayTimeUnit", "ns");
+  yyjson_mut_val * events = yyjson_mut_obj_add_arr (doc, root, "traceEvents");
+
+  /* timestamps are in microseconds, relative to the first exported cycle */
+  auto add_event = [&] (
+                     const std::string &name, size_t tid, const Span &span) {
+    yyjson_mut_val * event = yyjson_mut_arr_add_obj (doc, events);
+    yyjson_mut_obj_add_strcpy (doc, event, "name", name.c_str ());
+    yyjson_mut_obj_add_str (doc, event, "ph", "X");
+    yyjson_mut_obj_add_int (doc, event, "pid", 1);
+    yyjson_mut_obj_add_uint (doc, event, "tid", tid);
+    yyjson_mut_obj_add_real (
+      doc, event, "ts",
+      static_cast<double> (span.start_ns_ - start_ns) / 1000.0);
+    yyjson_mut_obj_add_real (
+      doc, event, "dur",
+      static_cast<double> (span.end_ns_ - span.start_ns_) / 1000.0);
+  };
+  auto add_lane_name = [&] (size_t tid, const std::string &name) {
+    yyjson_mut_val * event = yyjson_mut_arr_add_obj (doc, events);
+    yyjson_mut_obj_add_str (doc, event, "name", "thread_name");
+    yyjson_mut_obj_add_str (doc, event, "ph", "M");
+    yyjson_mut_obj_add_int (doc, event, "pid", 1);
+    yyjson_mut_obj_add_uint (doc, event, "tid", tid);
+    yyjson_mut_val * args = yyjson_mut_obj_add_obj (doc, event, "args");
+    yyjson_mut_obj_add_strcpy (doc, args, "name", name.c_str ());
+  };
+
+  /* the cycles go on lane 0 and the graph threads after it */
+  add_lane_name (0, "cycles");
+  for (const auto &cycle : cycles)
+    {
+      const auto duration =
+        std::chrono::nanoseconds (cycle.end_ns_ - cycle.start_ns_);
+      const bool overrun = budget.count () > 0 && duration > budget;
+      add_event (overrun ? "cycle (overrun)" : "cycle", 0, cycle);
+    }
+
+  for (size_t lane = 0; lane < get_num_lanes (); ++lane)
+    {
+      add_lane_name (lane + 1, lane_names_[lane]);
+      for (const auto &span : get_spans (lane))
+        {
+          if (
+            cycles.empty () || span.end_ns_ < start_ns
+            || span.start_ns_ > end_ns)
+            continue;
+
+          add_event (get_node_name (span.node_), lane + 1, span);
+        }
+    }
+
+  yyjson_write_err write_err;
+  char *           json = yyjson_mut_write_opts (
+    doc, YYJSON_WRITE_NOFLAG, nullptr, nullptr, &write_err);
+  yyjson_mut_doc_free (doc);
+  if (json == nullptr)
+    {
+      throw ZrythmException (
+        fmt::format ("Failed to serialize trace to JSON:\n{}", write_err.msg));
+    }
+
+  std::string ret (json);
+  std::free (json);
+  return ret;
+}
+
+} // namespace zrythm::dsp
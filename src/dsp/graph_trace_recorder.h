@@ -0,0 +1,204 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/types.h"
+
+namespace zrythm::dsp
+{
+
+class GraphNode;
+class GraphNodeCollection;
+
+/**
+ * @brief Flight recorder for the processing graph.
+ *
+ * Keeps the execution spans of the nodes processed during the last cycles in
+ * a fixed-size ring per graph thread ("lane"), plus the span of each cycle.
+ * When a deadline is missed the recorder is frozen, so that the cycles leading
+ * up to the overrun can be inspected as a timeline with to_chrome_trace_json()
+ * (viewable in chrome://tracing or Perfetto).
+ *
+ * Each lane must only be written to by one thread at a time. Recording and
+ * freezing are realtime-safe; everything else must be done outside the
+ * realtime threads.
+ */
+class GraphTraceRecorder
+{
+public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Span
+  {
+    /** The processed node, or nullptr for cycle spans. */
+    const GraphNode * node_ = nullptr;
+
+    /** Start/end times in nanoseconds since the clock's epoch. */
+    int64_t start_ns_ = 0;
+    int64_t end_ns_ = 0;
+  };
+
+  static constexpr size_t DEFAULT_SPANS_PER_LANE = 4096;
+
+  /**
+   * @brief Number of cycles exported by default.
+   */
+  static constexpr size_t DEFAULT_NUM_EXPORTED_CYCLES = 16;
+
+  /**
+   * @param lane_names Display names of the lanes (one per graph thread).
+   * @param spans_per_lane Capacity of each ring.
+   */
+  explicit GraphTraceRecorder (
+    std::vector<std::string> lane_names,
+    size_t                   spans_per_lane = DEFAULT_SPANS_PER_LANE);
+  Z_DISABLE_COPY_MOVE (GraphTraceRecorder);
+
+  size_t get_num_lanes () const { return lanes_.size () - 1; }
+
+  /**
+   * @brief Returns the number of bytes used by the rings.
+   */
+  size_t get_memory_usage () const
+  {
+    size_t ret = 0;
+    for (const auto &lane : lanes_)
+      {
+        ret += lane.spans_.capacity () * sizeof (Span);
+      }
+    return ret;
+  }
+
+  /**
+   * @brief Records the processing of @p node on the given lane.
+   *
+   * Does nothing while frozen.
+   */
+  [[gnu::hot]] void record_node (
+    size_t            lane,
+    const GraphNode  &node,
+    Clock::time_point start,
+    Clock::time_point end)
+  {
+    record (lanes_[lane], &node, start, end);
+  }
+
+  /**
+   * @brief Records a processing cycle.
+   *
+   * Must only be called from the thread that runs the cycles.
+   */
+  [[gnu::hot]] void
+  record_cycle (Clock::time_point start, Clock::time_point end)
+  {
+    record (lanes_.back (), nullptr, start, end);
+  }
+
+  /**
+   * @brief Stops recording so that the current contents are preserved.
+   *
+   * Realtime-safe. Can be called from any thread.
+   *
+   * @return Whether the recorder was not already frozen.
+   */
+  bool freeze ()
+  {
+    return !frozen_.exchange (true, std::memory_order_acq_rel);
+  }
+
+  bool is_frozen () const { return frozen_.load (std::memory_order_acquire); }
+
+  /**
+   * @brief Clears the recorded spans and resumes recording.
+   *
+   * @note Must only be called while frozen or while not processing.
+   */
+  void reset ();
+
+  /**
+   * @brief Remembers the names of the nodes in @p nodes, used when exporting.
+   *
+   * The names of the previously registered collection are kept as well, so
+   * that spans recorded just before switching to @p nodes can be resolved.
+   */
+  void register_node_names (const GraphNodeCollection &nodes);
+
+  /**
+   * @brief Returns the spans recorded on the given lane, oldest first.
+   *
+   * Pass get_num_lanes() for the cycle spans.
+   *
+   * @note Must only be called while frozen.
+   */
+  std::vector<Span> get_spans (size_t lane) const;
+
+  /**
+   * @brief Exports the last @p num_cycles recorded cycles as a Chrome trace
+   * event JSON document.
+   *
+   * Cycles are shown on their own lane, and the cycles that exceeded
+   * @p budget (if set) are marked as overruns.
+   *
+   * @note Must only be called while frozen.
+   */
+  std::string to_chrome_trace_json (
+    std::chrono::nanoseconds budget = {},
+    size_t                   num_cycles = DEFAULT_NUM_EXPORTED_CYCLES) const;
+
+private:
+  struct Lane
+  {
+    std::vector<Span> spans_;
+
+    /** Number of spans written so far. */
+    std::atomic<uint64_t> head_ = 0;
+  };
+
+  [[gnu::hot]] void record (
+    Lane             &lane,
+    const GraphNode * node,
+    Clock::time_point start,
+    Clock::time_point end)
+  {
+    if (frozen_.load (std::memory_order_acquire)) [[unlikely]]
+      return;
+
+    const auto head = lane.head_.load (std::memory_order_relaxed);
+    lane.spans_[head % lane.spans_.size ()] = Span{
+      .node_ = node,
+      .start_ns_ = to_ns (start),
+      .end_ns_ = to_ns (end),
+    };
+    lane.head_.store (head + 1, std::memory_order_release);
+  }
+
+  static int64_t to_ns (Clock::time_point time)
+  {
+    return std::chrono::duration_cast<std::chrono::nanoseconds> (
+             time.time_since_epoch ())
+      .count ();
+  }
+
+  std::string get_node_name (const GraphNode * node) const;
+
+private:
+  std::vector<std::string> lane_names_;
+
+  /** One lane per graph thread, plus one for the cycles. */
+  std::vector<Lane> lanes_;
+
+  std::atomic<bool> frozen_ = false;
+
+  /** Node names of the last two registered collections. */
+  std::unordered_map<const GraphNode *, std::string> node_names_;
+  std::unordered_map<const GraphNode *, std::string> prev_node_names_;
+};
+
+} // namespace zrythm::dsp
@@ -0,0 +1,233 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <numbers>
+
+#include "dsp/loudness_meter.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+/** Absolute gate (LUFS). */
+constexpr double ABSOLUTE_GATE = -70.0;
+
+/** Relative gate for the integrated loudness (LU). */
+constexpr double INTEGRATED_RELATIVE_GATE = -10.0;
+
+/** Relative gate for the loudness range (LU). */
+constexpr double RANGE_RELATIVE_GATE = -20.0;
+
+double
+energy_to_loudness (double energy)
+{
+  return -0.691 + 10.0 * std::log10 (energy);
+}
+
+double
+loudness_to_energy (double loudness)
+{
+  return std::pow (10.0, (loudness + 0.691) / 10.0);
+}
+
+/**
+ * @brief Returns the mean of the energies above @p threshold, or 0 if there
+ * are none.
+ */
+double
+gated_mean (const std::vector<double> &energies, double threshold)
+{
+  double sum = 0.0;
+  size_t count = 0;
+  for (const double energy : energies)
+    {
+      if (energy > threshold)
+        {
+          sum += energy;
+          ++count;
+        }
+    }
+  return count > 0 ? sum / static_cast<double> (count) : 0.0;
+}
+
+}
+
+void
+LoudnessMeter::init (float samplerate, size_t num_channels)
+{
+  const double fs = samplerate;
+
+  /* high shelf (head effects), BS.1770-4 stage 1 */
+  Biquad shelf;
+  {
+    constexpr double f0 = 1681.974450955533;
+    constexpr double gain_db = 3.999843853973347;
+    constexpr double q = 0.7071752369554196;
+    const double     k = std::tan (std::numbers::pi * f0 / fs);
+    const double     vh = std::pow (10.0, gain_db / 20.0);
+    const double     vb = std::pow (vh, 0.4996667741545416);
+    const double     a0 = 1.0 + k / q + k * k;
+    shelf.b0_ = (vh + vb * k / q + k * k) / a0;
+    shelf.b1_ = 2.0 * (k * k - vh) / a0;
+    shelf.b2_ = (vh - vb * k / q + k * k) / a0;
+    shelf.a1_ = 2.0 * (k * k - 1.0) / a0;
+    shelf.a2_ = (1.0 - k / q + k * k) / a0;
+  }
+
+  /* RLB high-pass, stage 2 */
+  Biquad highpass;
+  {
+    constexpr double f0 = 38.13547087602444;
+    constexpr double q = 0.5003270373238773;
+    const double     k = std::tan (std::numbers::pi * f0 / fs);
+    const double     a0 = 1.0 + k / q + k * k;
+    highpass.b0_ = 1.0;
+    highpass.b1_ = -2.0;
+    highpass.b2_ = 1.0;
+    highpass.a1_ = 2.0 * (k * k - 1.0) / a0;
+    highpass.a2_ = (1.0 - k / q + k * k) / a0;
+  }
+
+  channel_states_.assign (
+    num_channels, ChannelState{ .shelf_ = shelf, .highpass_ = highpass });
+  chunk_channels_.assign (num_channels, nullptr);
+  sub_block_frames_ = static_cast<size_t> (std::lround (fs / 10.0));
+  sub_block_pos_ = 0;
+  sub_block_sum_ = 0.0;
+  sub_block_energies_.fill (0.0);
+  num_sub_blocks_ = 0;
+  momentary_energies_.clear ();
+  short_term_energies_.clear ();
+
+  true_peak_dsp_.init (samplerate, num_channels);
+  true_peak_ = 0.f;
+}
+
+void
+LoudnessMeter::process (const float * const * channels, int n)
+{
+  assert (!channel_states_.empty ());
+
+  for (int offset = 0; offset < n; offset += TruePeakDsp::MAX_BLOCK_LENGTH)
+    {
+      const int chunk = std::min (n - offset, TruePeakDsp::MAX_BLOCK_LENGTH);
+      for (size_t ch = 0; ch < channel_states_.size (); ++ch)
+        {
+          chunk_channels_[ch] = channels[ch] + offset;
+        }
+      true_peak_dsp_.process_max (chunk_channels_.data (), chunk);
+    }
+  true_peak_ = std::max (true_peak_, true_peak_dsp_.read_f ());
+
+  size_t pos = 0;
+  const auto num_frames = static_cast<size_t> (n);
+  while (pos < num_frames)
+    {
+      const size_t len =
+        std::min (num_frames - pos, sub_block_frames_ - sub_block_pos_);
+      for (size_t ch = 0; ch < channel_states_.size (); ++ch)
+        {
+          auto         &state = channel_states_[ch];
+          const float * in = channels[ch] + pos;
+          double        sum = 0.0;
+          for (size_t i = 0; i < len; ++i)
+            {
+              const double out =
+                state.highpass_.process (state.shelf_.process (in[i]));
+              sum += out * out;
+            }
+          sub_block_sum_ += sum;
+        }
+      pos += len;
+      sub_block_pos_ += len;
+
+      if (sub_block_pos_ == sub_block_frames_)
+        {
+          end_sub_block ();
+        }
+    }
+}
+
+void
+LoudnessMeter::end_sub_block ()
+{
+  sub_block_energies_[num_sub_blocks_ % NUM_SHORT_TERM_SUB_BLOCKS] =
+    sub_block_sum_ / static_cast<double> (sub_block_frames_);
+  ++num_sub_blocks_;
+  sub_block_pos_ = 0;
+  sub_block_sum_ = 0.0;
+
+  const auto mean_of_last = [this] (size_t count) {
+    double sum = 0.0;
+    for (size_t i = 0; i < count; ++i)
+      {
+        sum += sub_block_energies_
+          [(num_sub_blocks_ - 1 - i) % NUM_SHORT_TERM_SUB_BLOCKS];
+      }
+    return sum / static_cast<double> (count);
+  };
+  if (num_sub_blocks_ >= NUM_MOMENTARY_SUB_BLOCKS)
+    {
+      momentary_energies_.push_back (mean_of_last (NUM_MOMENTARY_SUB_BLOCKS));
+    }
+  if (num_sub_blocks_ >= NUM_SHORT_TERM_SUB_BLOCKS)
+    {
+      short_term_energies_.push_back (mean_of_last (NUM_SHORT_TERM_SUB_BLOCKS));
+    }
+}
+
+double
+LoudnessMeter::get_integrated_loudness () const
+{
+  const double absolute_threshold = loudness_to_energy (ABSOLUTE_GATE);
+  const double ungated = gated_mean (momentary_energies_, absolute_threshold);
+  if (ungated <= 0.0)
+    return -std::numeric_limits<double>::infinity ();
+
+  const double relative_threshold = std::max (
+    absolute_threshold,
+    loudness_to_energy (
+      energy_to_loudness (ungated) + INTEGRATED_RELATIVE_GATE));
+  const double gated = gated_mean (momentary_energies_, relative_threshold);
+  if (gated <= 0.0)
+    return -std::numeric_limits<double>::infinity ();
+
+  return energy_to_loudness (gated);
+}
+
+double
+LoudnessMeter::get_loudness_range () const
+{
+  const double absolute_threshold = loudness_to_energy (ABSOLUTE_GATE);
+  const double ungated = gated_mean (short_term_energies_, absolute_threshold);
+  if (ungated <= 0.0)
+    return 0.0;
+
+  const double relative_threshold = std::max (
+    absolute_threshold,
+    loudness_to_energy (energy_to_loudness (ungated) + RANGE_RELATIVE_GATE));
+  std::vector<double> gated;
+  std::ranges::copy_if (
+    short_term_energies_, std::back_inserter (gated),
+    [relative_threshold] (double energy) {
+      return energy > relative_threshold;
+    });
+  if (gated.empty ())
+    return 0.0;
+
+  std::ranges::sort (gated);
+  const auto percentile = [&gated] (double p) {
+    const auto index = static_cast<size_t> (
+      std::lround (p * static_cast<double> (gated.size () - 1)));
+    return energy_to_loudness (gated[index]);
+  };
+  return percentile (0.95) - percentile (0.10);
+}
+
+} // namespace zrythm::dsp
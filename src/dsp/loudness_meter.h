@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef ZRYTHM_DSP_LOUDNESS_METER_H
+#define ZRYTHM_DSP_LOUDNESS_METER_H
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "dsp/true_peak_dsp.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Measures the loudness of a whole signal according to EBU R128
+ * (ITU-R BS.1770-4 and EBU Tech 3342).
+ *
+ * Meant for offline analysis (e.g., while exporting): the gating blocks are
+ * kept until the end, so the memory used grows with the length of the signal
+ * (about 160 KiB per hour).
+ *
+ * All channels are weighted equally, which is correct for mono and stereo.
+ */
+class LoudnessMeter
+{
+public:
+  /**
+   * @brief Prepares the meter and clears any previous measurement.
+   */
+  void init (float samplerate, size_t num_channels);
+
+  /**
+   * @brief Processes @p n samples of each channel.
+   *
+   * @param channels One buffer per channel passed to init().
+   */
+  void process (const float * const * channels, int n);
+
+  /**
+   * @brief Returns the integrated (gated) loudness in LUFS, or -infinity if
+   * the signal was too short or silent.
+   */
+  double get_integrated_loudness () const;
+
+  /**
+   * @brief Returns the loudness range in LU, or 0 if the signal was too
+   * short.
+   */
+  double get_loudness_range () const;
+
+  /**
+   * @brief Returns the true peak (4x oversampled) as an amplitude.
+   */
+  float get_true_peak () const { return true_peak_; }
+
+private:
+  /** Second-order IIR filter (transposed direct form II). */
+  struct Biquad
+  {
+    double b0_ = 1.0, b1_ = 0.0, b2_ = 0.0, a1_ = 0.0, a2_ = 0.0;
+    double z1_ = 0.0, z2_ = 0.0;
+
+    double process (double in)
+    {
+      const double out = b0_ * in + z1_;
+      z1_ = b1_ * in - a1_ * out + z2_;
+      z2_ = b2_ * in - a2_ * out;
+      return out;
+    }
+  };
+
+  /** K-weighting filter state of a channel. */
+  struct ChannelState
+  {
+    Biquad shelf_;
+    Biquad highpass_;
+  };
+
+  /** Sub-blocks of 100 ms making up a 3 s short-term block. */
+  static constexpr size_t NUM_SHORT_TERM_SUB_BLOCKS = 30;
+
+  /** Sub-blocks of 100 ms making up a 400 ms gating block. */
+  static constexpr size_t NUM_MOMENTARY_SUB_BLOCKS = 4;
+
+  /**
+   * @brief Adds the energy of the sub-block that was just completed and
+   * stores the blocks ending with it.
+   */
+  void end_sub_block ();
+
+private:
+  std::vector<ChannelState> channel_states_;
+
+  /** Frames in a 100 ms sub-block. */
+  size_t sub_block_frames_ = 0;
+
+  /** Frames and summed channel energy of the current sub-block so far. */
+  size_t sub_block_pos_ = 0;
+  double sub_block_sum_ = 0.0;
+
+  /** Mean energy of the last sub-blocks (ring). */
+  std::array<double, NUM_SHORT_TERM_SUB_BLOCKS> sub_block_energies_{};
+  size_t                                         num_sub_blocks_ = 0;
+
+  /** Mean energy of each 400 ms gating block (75% overlap). */
+  std::vector<double> momentary_energies_;
+
+  /** Mean energy of each 3 s block (10 Hz), for the loudness range. */
+  std::vector<double> short_term_energies_;
+
+  /** Channel pointers offset into the current chunk, for the true peak. */
+  std::vector<const float *> chunk_channels_;
+
+  TruePeakDsp true_peak_dsp_;
+  float       true_peak_ = 0.f;
+};
+
+} // namespace zrythm::dsp
+
+#endif
@@ -0,0 +1,66 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cmath>
+
+#include "dsp/metronome_click_schedule.h"
+#include "dsp/position.h"
+
+namespace zrythm::dsp
+{
+
+void
+MetronomeClickSchedule::set_grid (
+  double frames_per_tick,
+  int    ticks_per_beat,
+  int    beats_per_bar)
+{
+  if (
+    frames_per_tick == frames_per_tick_ && ticks_per_beat == ticks_per_beat_
+    && beats_per_bar == beats_per_bar_)
+    return;
+
+  frames_per_tick_ = frames_per_tick;
+  ticks_per_beat_ = ticks_per_beat;
+  beats_per_bar_ = beats_per_bar;
+  num_clicks_ = 0;
+  window_start_ = 0;
+  window_end_ = 0;
+}
+
+signed_frame_t
+MetronomeClickSchedule::get_beat_frame (int64_t beat) const
+{
+  /* same rounding as the positions of bars and beats */
+  return Position::get_frames_from_ticks (
+    static_cast<double> (beat) * ticks_per_beat_, frames_per_tick_);
+}
+
+void
+MetronomeClickSchedule::fill (signed_frame_t frame)
+{
+  /* find the beat at (or just before) the frame */
+  const double frames_per_beat = frames_per_tick_ * ticks_per_beat_;
+  auto         first_beat = static_cast<int64_t> (
+    std::floor (static_cast<double> (frame) / frames_per_beat));
+  first_beat = std::max (first_beat, int64_t{ 0 });
+  while (first_beat > 0 && get_beat_frame (first_beat) > frame)
+    --first_beat;
+  while (get_beat_frame (first_beat + 1) <= frame)
+    ++first_beat;
+
+  for (size_t i = 0; i < LOOKAHEAD_BEATS; ++i)
+    {
+      const auto beat = first_beat + static_cast<int64_t> (i);
+      clicks_[i] = {
+        .frame_ = get_beat_frame (beat),
+        .emphasis_ = beat % beats_per_bar_ == 0,
+      };
+    }
+  num_clicks_ = LOOKAHEAD_BEATS;
+  window_start_ = clicks_[0].frame_;
+  window_end_ =
+    get_beat_frame (first_beat + static_cast<int64_t> (LOOKAHEAD_BEATS));
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "utils/types.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Precomputed metronome click positions for a look-ahead window.
+ *
+ * Finding the bar and beat changes within each processing cycle used to
+ * involve several Position conversions per cycle. Instead, the clicks of the
+ * next @ref LOOKAHEAD_BEATS beats are computed once and each cycle only
+ * searches the precomputed list. The list is refilled when the requested
+ * range leaves the window (e.g., when the playhead loops or jumps) or when
+ * the grid changes.
+ *
+ * Storage is fixed-size, so nothing is allocated on the realtime thread.
+ */
+class MetronomeClickSchedule
+{
+public:
+  /** Number of beats computed at a time. */
+  static constexpr size_t LOOKAHEAD_BEATS = 64;
+
+  struct Click
+  {
+    signed_frame_t frame_ = 0;
+
+    /** Whether this is the first beat of a bar. */
+    bool emphasis_ = false;
+  };
+
+  /**
+   * @brief Sets the grid the clicks are placed on.
+   *
+   * Invalidates the schedule if anything changed. Realtime-safe.
+   */
+  void set_grid (double frames_per_tick, int ticks_per_beat, int beats_per_bar);
+
+  /**
+   * @brief Calls @p func with each click in [@p start, @p end).
+   *
+   * Realtime-safe.
+   */
+  template <typename Func>
+  void for_each_click (signed_frame_t start, signed_frame_t end, Func &&func)
+  {
+    if (!has_grid ())
+      return;
+
+    start = std::max (start, signed_frame_t{ 0 });
+    while (start < end)
+      {
+        if (start < window_start_ || start >= window_end_)
+          {
+            fill (start);
+          }
+
+        auto * it = std::lower_bound (
+          clicks_.begin (), clicks_.begin () + num_clicks_, start,
+          [] (const Click &click, signed_frame_t frame) {
+            return click.frame_ < frame;
+          });
+        for (; it != clicks_.begin () + num_clicks_ && it->frame_ < end; ++it)
+          {
+            func (*it);
+          }
+
+        start = window_end_;
+      }
+  }
+
+  /** Frame of the given beat (counted from 0). */
+  signed_frame_t get_beat_frame (int64_t beat) const;
+
+private:
+  bool has_grid () const
+  {
+    return frames_per_tick_ > 0 && ticks_per_beat_ > 0 && beats_per_bar_ > 0;
+  }
+
+  /** Computes the clicks of the window starting at the beat at @p frame. */
+  void fill (signed_frame_t frame);
+
+private:
+  double frames_per_tick_ = 0;
+  int    ticks_per_beat_ = 0;
+  int    beats_per_bar_ = 0;
+
+  std::array<Click, LOOKAHEAD_BEATS> clicks_{};
+  size_t                             num_clicks_ = 0;
+
+  /** Frames covered by @ref clicks_ (end exclusive). */
+  signed_frame_t window_start_ = 0;
+  signed_frame_t window_end_ = 0;
+};
+
+} // namespace zrythm::dsp
@@ -93,15 +93,30 @@ MusicalScale::get_triad_types_for_type (Type type, bool ascending)
 #undef SET_7_TRIADS
 }
 
-const bool *
-MusicalScale::get_notes_for_type (Type type, bool ascending)
+namespace
 {
+
+/**
+ * Returns the notes of the given scale type starting at C (0 if the type is
+ * unimplemented).
+ */
+constexpr PitchClassMask
+builtin_pitch_class_mask (MusicalScale::Type type)
+{
+  using Type = MusicalScale::Type;
+
 #define SET_NOTES(n1, n2, n3, n4, n5, n6, n7, n8, n9, n10, n11, n12) \
   { \
-    static const bool notes[] = { \
+    const std::array<int, 12> notes = { \
       n1, n2, n3, n4, n5, n6, n7, n8, n9, n10, n11, n12 \
     }; \
-    return notes; \
+    PitchClassMask mask = 0; \
+    for (size_t i = 0; i < notes.size (); ++i) \
+      { \
+        if (notes[i] != 0) \
+          mask |= static_cast<PitchClassMask> (1u << i); \
+      } \
+    return mask; \
   }
 
   /* get the notes starting at C */
@@ -291,33 +306,84 @@ MusicalScale::get_notes_for_type (Type type, bool ascending)
       break;
     }
 
+  return 0;
+
 #undef SET_NOTES
+}
+
+constexpr size_t NUM_SCALE_TYPES =
+  static_cast<size_t> (MusicalScale::Type::UkranianDorian) + 1;
+
+constexpr auto pitch_class_masks = [] () {
+  std::array<PitchClassMask, NUM_SCALE_TYPES> masks{};
+  for (size_t i = 0; i < NUM_SCALE_TYPES; ++i)
+    {
+      masks[i] =
+        builtin_pitch_class_mask (static_cast<MusicalScale::Type> (i));
+    }
+  return masks;
+}();
+
+constexpr auto scale_notes = [] () {
+  std::array<std::array<bool, 12>, NUM_SCALE_TYPES> notes{};
+  for (size_t i = 0; i < NUM_SCALE_TYPES; ++i)
+    {
+      for (size_t j = 0; j < 12; ++j)
+        {
+          notes[i][j] = ((pitch_class_masks[i] >> j) & 1u) != 0;
+        }
+    }
+  return notes;
+}();
+
+static_assert (
+  pitch_class_masks[static_cast<size_t> (MusicalScale::Type::Chromatic)]
+  == PITCH_CLASS_MASK_ALL);
+static_assert (
+  pitch_class_masks[static_cast<size_t> (MusicalScale::Type::Major)]
+  == 0b1010'1011'0101);
 
-  return nullptr;
+} // namespace
+
+const bool *
+MusicalScale::get_notes_for_type (Type type, bool ascending)
+{
+  const auto index = static_cast<size_t> (type);
+  if (index >= NUM_SCALE_TYPES || pitch_class_masks[index] == 0)
+    return nullptr;
+
+  return scale_notes[index].data ();
 }
 
-bool
-MusicalScale::contains_note (MusicalNote note) const
+PitchClassMask
+MusicalScale::get_pitch_class_mask_for_type (Type type)
 {
-  if (root_key_ == note)
-    return true;
+  const auto index = static_cast<size_t> (type);
+  if (index >= NUM_SCALE_TYPES)
+    return 0;
+
+  return pitch_class_masks[index];
+}
 
-  const bool * notes = get_notes_for_type (type_, false);
+PitchClassMask
+MusicalScale::get_pitch_class_mask () const
+{
+  return pitch_class_mask_transpose (
+           get_pitch_class_mask_for_type (type_),
+           static_cast<int> (root_key_))
+         | pitch_class_mask_from_note (root_key_);
+}
 
-  return notes[((int) note - (int) root_key_ + 12) % 12];
+bool
+MusicalScale::contains_note (MusicalNote note) const
+{
+  return pitch_class_mask_contains (get_pitch_class_mask (), note);
 }
 
 bool
 MusicalScale::contains_chord (const ChordDescriptor &chord) const
 {
-  for (size_t i = 0; i < ChordDescriptor::MAX_NOTES; i++)
-    {
-      if (
-        chord.notes_[i]
-        && !contains_note (ENUM_INT_TO_VALUE (MusicalNote, i % 12)))
-        return false;
-    }
-  return true;
+  return (chord.get_notes_pitch_class_mask () & ~get_pitch_class_mask ()) == 0;
 }
 
 /**
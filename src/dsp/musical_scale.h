@@ -129,6 +129,14 @@ public:
    */
   static const bool * get_notes_for_type (Type type, bool ascending);
 
+  /**
+   * Returns the notes in the given scale starting at C (0 if the scale is
+   * unimplemented).
+   *
+   * Looked up from a table computed at compile time.
+   */
+  static PitchClassMask get_pitch_class_mask_for_type (Type type);
+
   /**
    * Returns the triads in the given scale.
    *
@@ -168,6 +176,11 @@ public:
    */
   bool contains_note (MusicalNote note) const;
 
+  /**
+   * Returns the pitch classes for which contains_note() returns true.
+   */
+  PitchClassMask get_pitch_class_mask () const;
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 public:
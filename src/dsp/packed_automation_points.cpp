@@ -0,0 +1,161 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "dsp/packed_automation_points.h"
+
+namespace zrythm::dsp
+{
+
+void
+PackedAutomationPoints::reserve (size_t size)
+{
+  pos_ticks_.reserve (size);
+  values_.reserve (size);
+  curviness_.reserve (size);
+  curve_algos_.reserve (size);
+}
+
+void
+PackedAutomationPoints::push_back (
+  double              pos_ticks,
+  float               normalized_value,
+  const CurveOptions &curve)
+{
+  pos_ticks_.push_back (pos_ticks);
+  values_.push_back (normalized_value);
+  curviness_.push_back (curve.curviness_);
+  curve_algos_.push_back (static_cast<uint8_t> (curve.algo_));
+}
+
+CurveOptions
+PackedAutomationPoints::get_curve (size_t index) const
+{
+  return { curviness_[index],
+           static_cast<CurveOptions::Algorithm> (curve_algos_[index]) };
+}
+
+std::vector<size_t>
+PackedAutomationPoints::get_changed_indices (
+  const PackedAutomationPoints &other) const
+{
+  std::vector<size_t> ret;
+  const auto          num_points = std::min (size (), other.size ());
+  for (size_t i = 0; i < num_points; ++i)
+    {
+      if (
+        pos_ticks_[i] != other.pos_ticks_[i] || values_[i] != other.values_[i]
+        || curviness_[i] != other.curviness_[i]
+        || curve_algos_[i] != other.curve_algos_[i])
+        ret.push_back (i);
+    }
+  return ret;
+}
+
+PackedAutomationPoints
+PackedAutomationPoints::select (std::span<const size_t> indices) const
+{
+  PackedAutomationPoints ret;
+  ret.reserve (indices.size ());
+  for (const auto i : indices)
+    {
+      ret.push_back (pos_ticks_[i], values_[i], get_curve (i));
+    }
+  return ret;
+}
+
+void
+PackedAutomationPoints::append (const PackedAutomationPoints &other)
+{
+  pos_ticks_.insert (
+    pos_ticks_.end (), other.pos_ticks_.begin (), other.pos_ticks_.end ());
+  values_.insert (values_.end (), other.values_.begin (), other.values_.end ());
+  curviness_.insert (
+    curviness_.end (), other.curviness_.begin (), other.curviness_.end ());
+  curve_algos_.insert (
+    curve_algos_.end (), other.curve_algos_.begin (),
+    other.curve_algos_.end ());
+}
+
+void
+PackedAutomationPoints::flatten ()
+{
+  std::ranges::fill (curviness_, 1.0);
+  std::ranges::fill (
+    curve_algos_, static_cast<uint8_t> (CurveOptions::Algorithm::Pulse));
+}
+
+void
+PackedAutomationPoints::flip_vertical ()
+{
+  for (size_t i = 0; i < size (); ++i)
+    {
+      values_[i] = 1.f - values_[i];
+      curviness_[i] = -curviness_[i];
+    }
+}
+
+void
+PackedAutomationPoints::flip_horizontal ()
+{
+  if (size () < 2)
+    return;
+
+  const double first = pos_ticks_.front ();
+  const double last = pos_ticks_.back ();
+  for (auto &pos : pos_ticks_)
+    {
+      pos = first + last - pos;
+    }
+
+  /* the curve of each segment now starts at the other end of the segment
+   * (the old first point, now last, takes the old trailing curve) */
+  std::ranges::rotate (curviness_, curviness_.end () - 1);
+  std::ranges::rotate (curve_algos_, curve_algos_.end () - 1);
+  for (size_t i = 1; i < size (); ++i)
+    {
+      curviness_[i] = -curviness_[i];
+    }
+}
+
+void
+PackedAutomationPoints::smooth (size_t radius)
+{
+  if (radius == 0 || size () < 2)
+    return;
+
+  std::vector<double> sums (size () + 1);
+  for (size_t i = 0; i < size (); ++i)
+    {
+      sums[i + 1] = sums[i] + values_[i];
+    }
+  for (size_t i = 0; i < size (); ++i)
+    {
+      const size_t from = i >= radius ? i - radius : 0;
+      const size_t to = std::min (size (), i + radius + 1);
+      values_[i] = static_cast<float> (
+        (sums[to] - sums[from]) / static_cast<double> (to - from));
+    }
+}
+
+void
+PackedAutomationPoints::scale_values (float factor, float pivot)
+{
+  for (auto &val : values_)
+    {
+      val = std::clamp (pivot + (val - pivot) * factor, 0.f, 1.f);
+    }
+}
+
+void
+PackedAutomationPoints::define_fields (const Context &ctx)
+{
+  using T = ISerializable<PackedAutomationPoints>;
+  T::serialize_fields (
+    ctx, T::make_field ("posTicks", pos_ticks_),
+    T::make_field ("values", values_), T::make_field ("curviness", curviness_),
+    T::make_field ("curveAlgorithms", curve_algos_));
+}
+
+} // namespace zrythm::dsp
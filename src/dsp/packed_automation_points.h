@@ -0,0 +1,96 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "dsp/curve.h"
+#include "utils/iserializable.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Automation points (e.g., the selected points of a region) packed
+ * into parallel arrays, for editing many points at once.
+ *
+ * Positions are in ticks, relative to the start of the region owning the
+ * points, and the points are expected in ascending order. The edits only
+ * change the values in the arrays; the order of the points is kept, so that
+ * they can be written back to the objects they were packed from.
+ */
+class PackedAutomationPoints final
+    : public zrythm::utils::serialization::ISerializable<PackedAutomationPoints>
+{
+public:
+  size_t size () const { return values_.size (); }
+  bool   empty () const { return values_.empty (); }
+
+  void reserve (size_t size);
+
+  void push_back (
+    double              pos_ticks,
+    float               normalized_value,
+    const CurveOptions &curve);
+
+  CurveOptions get_curve (size_t index) const;
+
+  /**
+   * @brief Returns the indices of the points that differ from the points in
+   * @p other (which must have the same size), in ascending order.
+   */
+  std::vector<size_t>
+  get_changed_indices (const PackedAutomationPoints &other) const;
+
+  /**
+   * @brief Returns the points at @p indices.
+   */
+  PackedAutomationPoints select (std::span<const size_t> indices) const;
+
+  /**
+   * @brief Appends the points of @p other.
+   */
+  void append (const PackedAutomationPoints &other);
+
+  /**
+   * @brief Makes all the curves pulses (steps).
+   */
+  void flatten ();
+
+  /**
+   * @brief Mirrors the values (and curves) vertically.
+   */
+  void flip_vertical ();
+
+  /**
+   * @brief Reverses the points in time between the first and last point.
+   *
+   * Each curve moves to the point at the other end of its segment, mirrored.
+   */
+  void flip_horizontal ();
+
+  /**
+   * @brief Replaces each value with the mean of the values of the points up
+   * to @p radius points away.
+   */
+  void smooth (size_t radius);
+
+  /**
+   * @brief Scales the distances of the values from @p pivot by @p factor,
+   * clamping them to [0, 1].
+   */
+  void scale_values (float factor, float pivot);
+
+  DECLARE_DEFINE_FIELDS_METHOD ();
+
+public:
+  std::vector<double>  pos_ticks_;
+  std::vector<float>   values_;
+  std::vector<double>  curviness_;
+  std::vector<uint8_t> curve_algos_;
+};
+
+} // namespace zrythm::dsp
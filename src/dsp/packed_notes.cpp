@@ -0,0 +1,326 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+#include "dsp/packed_notes.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+constexpr int MAX_MIDI_VALUE = 127;
+
+uint8_t
+clamp_midi_value (int val)
+{
+  return static_cast<uint8_t> (std::clamp (val, 0, MAX_MIDI_VALUE));
+}
+
+/**
+ * Returns the distance from @p ticks to the nearest of @p points (the
+ * previous one on ties), like QuantizeOptions::quantize_position().
+ */
+double
+get_distance_to_nearest_point (std::span<const double> points, double ticks)
+{
+  auto next = std::ranges::lower_bound (points, ticks);
+  if (next == points.end ())
+    return points.back () - ticks;
+  if (*next == ticks || next == points.begin ())
+    return *next - ticks;
+
+  const double prev = *(next - 1);
+  return ticks - prev <= *next - ticks ? prev - ticks : *next - ticks;
+}
+}
+
+void
+PackedNotes::reserve (size_t size)
+{
+  start_ticks_.reserve (size);
+  end_ticks_.reserve (size);
+  pitches_.reserve (size);
+  velocities_.reserve (size);
+}
+
+void
+PackedNotes::push_back (
+  double  start_ticks,
+  double  end_ticks,
+  uint8_t pitch,
+  uint8_t velocity)
+{
+  start_ticks_.push_back (start_ticks);
+  end_ticks_.push_back (end_ticks);
+  pitches_.push_back (pitch);
+  velocities_.push_back (velocity);
+}
+
+std::vector<size_t>
+PackedNotes::get_changed_indices (const PackedNotes &other) const
+{
+  std::vector<size_t> ret;
+  const auto          num_notes = std::min (size (), other.size ());
+  for (size_t i = 0; i < num_notes; ++i)
+    {
+      if (
+        start_ticks_[i] != other.start_ticks_[i]
+        || end_ticks_[i] != other.end_ticks_[i]
+        || pitches_[i] != other.pitches_[i]
+        || velocities_[i] != other.velocities_[i])
+        ret.push_back (i);
+    }
+  return ret;
+}
+
+PackedNotes
+PackedNotes::select (std::span<const size_t> indices) const
+{
+  PackedNotes ret;
+  ret.offset_ticks_ = offset_ticks_;
+  ret.reserve (indices.size ());
+  for (const auto i : indices)
+    {
+      ret.push_back (
+        start_ticks_[i], end_ticks_[i], pitches_[i], velocities_[i]);
+    }
+  return ret;
+}
+
+void
+PackedNotes::append (const PackedNotes &other)
+{
+  start_ticks_.insert (
+    start_ticks_.end (), other.start_ticks_.begin (),
+    other.start_ticks_.end ());
+  end_ticks_.insert (
+    end_ticks_.end (), other.end_ticks_.begin (), other.end_ticks_.end ());
+  pitches_.insert (
+    pitches_.end (), other.pitches_.begin (), other.pitches_.end ());
+  velocities_.insert (
+    velocities_.end (), other.velocities_.begin (), other.velocities_.end ());
+}
+
+void
+PackedNotes::ensure_min_length (size_t index)
+{
+  end_ticks_[index] =
+    std::max (end_ticks_[index], start_ticks_[index] + MIN_LENGTH_TICKS);
+}
+
+void
+PackedNotes::quantize (
+  std::span<const double> points,
+  double                  amount,
+  bool                    adjust_start,
+  bool                    adjust_end,
+  double                  rand_ticks,
+  uint32_t                seed)
+{
+  if (points.empty ())
+    return;
+
+  std::mt19937                           gen (seed);
+  std::uniform_real_distribution<double> rand_dist (-rand_ticks, rand_ticks);
+  const auto get_rand_ticks = [&] () {
+    return rand_ticks > 0.0 ? rand_dist (gen) : 0.0;
+  };
+
+  for (size_t i = 0; i < size (); ++i)
+    {
+      if (adjust_start)
+        {
+          const double diff =
+            get_distance_to_nearest_point (
+              points, start_ticks_[i] + offset_ticks_)
+              * amount
+            + get_rand_ticks ();
+          start_ticks_[i] += diff;
+          end_ticks_[i] += diff;
+        }
+      if (adjust_end)
+        {
+          end_ticks_[i] +=
+            get_distance_to_nearest_point (
+              points, end_ticks_[i] + offset_ticks_)
+              * amount
+            + get_rand_ticks ();
+        }
+      ensure_min_length (i);
+    }
+}
+
+void
+PackedNotes::transpose (int semitones)
+{
+  for (auto &pitch : pitches_)
+    {
+      pitch = clamp_midi_value (pitch + semitones);
+    }
+}
+
+void
+PackedNotes::humanize_velocities (int max_delta, uint32_t seed)
+{
+  std::mt19937                       gen (seed);
+  std::uniform_int_distribution<int> dist (-max_delta, max_delta);
+  for (auto &vel : velocities_)
+    {
+      /* keep the notes audible */
+      vel = std::max<uint8_t> (1, clamp_midi_value (vel + dist (gen)));
+    }
+}
+
+void
+PackedNotes::ramp_velocities (
+  double              first_tick,
+  double              last_tick,
+  uint8_t             start_vel,
+  uint8_t             end_vel,
+  const CurveOptions &curve)
+{
+  const double total_ticks = last_tick - first_tick;
+  const int    min_vel = std::min (start_vel, end_vel);
+  const int    vel_interval = std::abs (end_vel - start_vel);
+  for (size_t i = 0; i < size (); ++i)
+    {
+      if (total_ticks <= 0.0)
+        {
+          velocities_[i] = start_vel;
+          continue;
+        }
+
+      const double x = std::clamp (
+        (start_ticks_[i] + offset_ticks_ - first_tick) / total_ticks, 0.0, 1.0);
+      const double multiplier =
+        curve.get_normalized_y (x, start_vel > end_vel);
+      velocities_[i] = clamp_midi_value (
+        min_vel + static_cast<int> (std::lround (vel_interval * multiplier)));
+    }
+}
+
+void
+PackedNotes::flip_vertical (uint8_t lowest, uint8_t highest)
+{
+  for (auto &pitch : pitches_)
+    {
+      pitch = clamp_midi_value (lowest + highest - pitch);
+    }
+}
+
+void
+PackedNotes::flip_horizontal ()
+{
+  const auto order = get_order_by_start ();
+  const auto starts = start_ticks_;
+  for (size_t i = 0; i < order.size (); ++i)
+    {
+      const auto   index = order[i];
+      const double length = end_ticks_[index] - start_ticks_[index];
+      start_ticks_[index] = starts[order[order.size () - i - 1]];
+      end_ticks_[index] = start_ticks_[index] + length;
+    }
+}
+
+void
+PackedNotes::connect_to_next (double gap_ticks, double min_length_ticks)
+{
+  const auto order = get_order_by_start ();
+  for (size_t i = 0; i + 1 < order.size (); ++i)
+    {
+      const auto   index = order[i];
+      const double next_start = start_ticks_[order[i + 1]];
+      end_ticks_[index] = next_start - gap_ticks;
+      if (end_ticks_[index] - start_ticks_[index] < MIN_LENGTH_TICKS)
+        {
+          end_ticks_[index] = next_start + min_length_ticks;
+        }
+      ensure_min_length (index);
+    }
+}
+
+void
+PackedNotes::set_lengths (double length_ticks)
+{
+  for (size_t i = 0; i < size (); ++i)
+    {
+      end_ticks_[i] = start_ticks_[i] + length_ticks;
+      ensure_min_length (i);
+    }
+}
+
+void
+PackedNotes::strum (
+  double              max_offset_ticks,
+  bool                ascending,
+  const CurveOptions &curve)
+{
+  if (empty ())
+    return;
+
+  std::vector<size_t> order (size ());
+  std::iota (order.begin (), order.end (), 0);
+  std::ranges::stable_sort (order, [&] (size_t a, size_t b) {
+    return ascending ? pitches_[a] < pitches_[b] : pitches_[a] > pitches_[b];
+  });
+
+  const double first_start = start_ticks_[order.front ()];
+  for (size_t i = 0; i < order.size (); ++i)
+    {
+      const auto   index = order[i];
+      const double length = end_ticks_[index] - start_ticks_[index];
+      const double multiplier = curve.get_normalized_y (
+        static_cast<double> (i) / static_cast<double> (order.size ()),
+        !ascending);
+      start_ticks_[index] = first_start + multiplier * max_offset_ticks;
+      end_ticks_[index] = start_ticks_[index] + length;
+    }
+}
+
+std::pair<uint8_t, uint8_t>
+PackedNotes::get_pitch_range () const
+{
+  if (empty ())
+    return { 0, 0 };
+
+  const auto [min, max] = std::ranges::minmax_element (pitches_);
+  return { *min, *max };
+}
+
+std::pair<double, double>
+PackedNotes::get_start_range () const
+{
+  if (empty ())
+    return { 0.0, 0.0 };
+
+  const auto [min, max] = std::ranges::minmax_element (start_ticks_);
+  return { *min + offset_ticks_, *max + offset_ticks_ };
+}
+
+std::vector<size_t>
+PackedNotes::get_order_by_start () const
+{
+  std::vector<size_t> order (size ());
+  std::iota (order.begin (), order.end (), 0);
+  std::ranges::stable_sort (order, [&] (size_t a, size_t b) {
+    return start_ticks_[a] < start_ticks_[b];
+  });
+  return order;
+}
+
+void
+PackedNotes::define_fields (const Context &ctx)
+{
+  using T = ISerializable<PackedNotes>;
+  T::serialize_fields (
+    ctx, T::make_field ("startTicks", start_ticks_),
+    T::make_field ("endTicks", end_ticks_), T::make_field ("pitches", pitches_),
+    T::make_field ("velocities", velocities_));
+}
+
+} // namespace zrythm::dsp
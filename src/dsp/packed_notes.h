@@ -0,0 +1,160 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "dsp/curve.h"
+#include "utils/iserializable.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief MIDI notes (e.g., the selected notes of a region) packed into
+ * parallel arrays, for editing many notes at once.
+ *
+ * Positions are in ticks, relative to @ref offset_ticks_ (e.g., the start of
+ * the region owning the notes). The edits only change the values in the
+ * arrays; the order of the notes is kept, so that they can be written back
+ * to the objects they were packed from.
+ */
+class PackedNotes final
+    : public zrythm::utils::serialization::ISerializable<PackedNotes>
+{
+public:
+  /** Notes are never made shorter than this (in ticks). */
+  static constexpr double MIN_LENGTH_TICKS = 1.0;
+
+  size_t size () const { return pitches_.size (); }
+  bool   empty () const { return pitches_.empty (); }
+
+  void reserve (size_t size);
+
+  void push_back (
+    double  start_ticks,
+    double  end_ticks,
+    uint8_t pitch,
+    uint8_t velocity);
+
+  /**
+   * @brief Returns the indices of the notes that differ from the notes in
+   * @p other (which must have the same size), in ascending order.
+   */
+  std::vector<size_t> get_changed_indices (const PackedNotes &other) const;
+
+  /**
+   * @brief Returns the notes at @p indices.
+   */
+  PackedNotes select (std::span<const size_t> indices) const;
+
+  /**
+   * @brief Appends the notes of @p other.
+   */
+  void append (const PackedNotes &other);
+
+  /**
+   * @brief Moves each note to the nearest of @p points (absolute, ascending),
+   * like QuantizeOptions.
+   *
+   * @param amount How far to move towards the nearest point (0 to 1).
+   * @param adjust_start Whether to quantize the starts (the ends move along).
+   * @param adjust_end Whether to quantize the ends.
+   * @param rand_ticks Maximum random ticks added to each quantized position.
+   * @param seed Seed of the random ticks.
+   */
+  void quantize (
+    std::span<const double> points,
+    double                  amount,
+    bool                    adjust_start,
+    bool                    adjust_end,
+    double                  rand_ticks,
+    uint32_t                seed);
+
+  /**
+   * @brief Shifts the pitches, clamping them to the MIDI range.
+   */
+  void transpose (int semitones);
+
+  /**
+   * @brief Adds random amounts of up to @p max_delta to the velocities.
+   */
+  void humanize_velocities (int max_delta, uint32_t seed);
+
+  /**
+   * @brief Sets the velocities along a curve from @p start_vel at
+   * @p first_tick to @p end_vel at @p last_tick (absolute).
+   */
+  void ramp_velocities (
+    double              first_tick,
+    double              last_tick,
+    uint8_t             start_vel,
+    uint8_t             end_vel,
+    const CurveOptions &curve);
+
+  /**
+   * @brief Mirrors the pitches within [@p lowest, @p highest].
+   */
+  void flip_vertical (uint8_t lowest, uint8_t highest);
+
+  /**
+   * @brief Reverses the order of the notes in time, keeping their lengths.
+   */
+  void flip_horizontal ();
+
+  /**
+   * @brief Makes each note (but the last) end @p gap_ticks before the start
+   * of the next note (legato/portato).
+   *
+   * Notes that would end up shorter than @ref MIN_LENGTH_TICKS end
+   * @p min_length_ticks after the start of the next note instead.
+   */
+  void connect_to_next (double gap_ticks, double min_length_ticks);
+
+  /**
+   * @brief Sets the length of all the notes.
+   */
+  void set_lengths (double length_ticks);
+
+  /**
+   * @brief Starts all the notes at the start of the first note (in pitch
+   * order), delayed along a curve of up to @p max_offset_ticks.
+   */
+  void
+  strum (double max_offset_ticks, bool ascending, const CurveOptions &curve);
+
+  /**
+   * @brief Returns the lowest and highest pitches.
+   */
+  std::pair<uint8_t, uint8_t> get_pitch_range () const;
+
+  /**
+   * @brief Returns the earliest and latest absolute starts.
+   */
+  std::pair<double, double> get_start_range () const;
+
+  DECLARE_DEFINE_FIELDS_METHOD ();
+
+private:
+  /**
+   * @brief Returns the indices of the notes sorted by start.
+   */
+  std::vector<size_t> get_order_by_start () const;
+
+  void ensure_min_length (size_t index);
+
+public:
+  /** Offset of the positions (not serialized). */
+  double offset_ticks_ = 0.0;
+
+  std::vector<double>  start_ticks_;
+  std::vector<double>  end_ticks_;
+  std::vector<uint8_t> pitches_;
+  std::vector<uint8_t> velocities_;
+};
+
+} // namespace zrythm::dsp
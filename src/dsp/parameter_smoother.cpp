@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cmath>
+
+#include "dsp/parameter_smoother.h"
+#include "utils/dsp.h"
+
+namespace zrythm::dsp
+{
+
+void
+ParameterSmoother::reset (float value)
+{
+  current_ = value;
+  target_ = value;
+  remaining_frames_ = 0;
+  has_value_ = true;
+}
+
+void
+ParameterSmoother::set_target (float target)
+{
+  if (!has_value_ || ramp_length_ == 0)
+    {
+      reset (target);
+      return;
+    }
+  if (utils::math::floats_equal (target, target_))
+    return;
+
+  target_ = target;
+  remaining_frames_ = ramp_length_;
+  const auto num_frames = static_cast<float> (ramp_length_);
+
+  /* an exponential ramp can't start or end at 0 */
+  constexpr float min_exponential_value = 1e-5f;
+  exponential_ramp_ =
+    mode_ == Mode::Exponential && current_ > min_exponential_value
+    && target_ > min_exponential_value;
+  if (exponential_ramp_)
+    {
+      const float ratio = std::pow (target_ / current_, 1.f / num_frames);
+      float       power = 1.f;
+      for (auto &ratio_power : ratio_powers_)
+        {
+          power *= ratio;
+          ratio_power = power;
+        }
+    }
+  else
+    {
+      step_ = (target_ - current_) / num_frames;
+    }
+}
+
+void
+ParameterSmoother::fill_ramp (float * values, size_t size)
+{
+  if (exponential_ramp_)
+    {
+      for (size_t i = 0; i < size; i++)
+        {
+          values[i] = current_ * ratio_powers_[i];
+        }
+    }
+  else
+    {
+      for (size_t i = 0; i < size; i++)
+        {
+          values[i] = current_ + step_ * static_cast<float> (i + 1);
+        }
+    }
+
+  remaining_frames_ -= size;
+  current_ = remaining_frames_ == 0 ? target_ : values[size - 1];
+}
+
+void
+ParameterSmoother::apply_gain (float * buf, size_t size)
+{
+  const size_t ramp_frames =
+    process_ramp (size, [buf] (size_t offset, const float * values, size_t n) {
+      for (size_t i = 0; i < n; i++)
+        {
+          buf[offset + i] *= values[i];
+        }
+    });
+  if (ramp_frames < size)
+    {
+      utils::float_ranges::mul_k2 (
+        &buf[ramp_frames], target_, size - ramp_frames);
+    }
+}
+
+void
+ParameterSmoother::mix_product (float * dest, const float * src, size_t size)
+{
+  const size_t ramp_frames = process_ramp (
+    size, [dest, src] (size_t offset, const float * values, size_t n) {
+      for (size_t i = 0; i < n; i++)
+        {
+          dest[offset + i] += src[offset + i] * values[i];
+        }
+    });
+  if (ramp_frames < size)
+    {
+      utils::float_ranges::mix_product (
+        &dest[ramp_frames], &src[ramp_frames], target_, size - ramp_frames);
+    }
+}
+
+void
+ParameterSmoother::fill_values (float * values, size_t size)
+{
+  const size_t ramp_frames = process_ramp (
+    size, [values] (size_t offset, const float * ramp_values, size_t n) {
+      std::copy_n (ramp_values, n, &values[offset]);
+    });
+  if (ramp_frames < size)
+    {
+      utils::float_ranges::fill (
+        &values[ramp_frames], target_, size - ramp_frames);
+    }
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Ramps a control value (e.g., a gain) to its target over a number of
+ * frames instead of jumping to it at the start of a block, which would cause
+ * zipper noise.
+ *
+ * The ramp is evaluated in small chunks so that both computing it and
+ * applying it to a buffer can be vectorized.
+ */
+class ParameterSmoother
+{
+public:
+  enum class Mode
+  {
+    /** Constant step per frame. */
+    Linear,
+
+    /**
+     * Constant ratio per frame (sounds more natural for gains).
+     *
+     * Falls back to a linear ramp when the start or target value is not
+     * positive.
+     */
+    Exponential,
+  };
+
+  /** Default ramp length, in seconds. */
+  static constexpr float DEFAULT_RAMP_TIME = 0.01f;
+
+  explicit ParameterSmoother (Mode mode = Mode::Linear) : mode_ (mode) { }
+
+  /**
+   * @brief Sets the length of the ramps started by subsequent set_target()
+   * calls.
+   */
+  void set_ramp_length (size_t num_frames) { ramp_length_ = num_frames; }
+
+  size_t get_ramp_length () const { return ramp_length_; }
+
+  /**
+   * @brief Jumps to @p value, cancelling any ramp.
+   */
+  void reset (float value);
+
+  /**
+   * @brief Starts ramping from the current value to @p target.
+   *
+   * Does nothing if @p target is already the target. The first target set
+   * after construction is jumped to.
+   */
+  void set_target (float target);
+
+  float get_target () const { return target_; }
+
+  /**
+   * @brief Value reached so far (the value of the last frame processed).
+   */
+  float get_current_value () const { return current_; }
+
+  bool is_smoothing () const { return remaining_frames_ > 0; }
+
+  /**
+   * @brief Calculates buf[i] = buf[i] * value[i], advancing the ramp by
+   * @p size frames.
+   */
+  [[gnu::hot]] void apply_gain (float * buf, size_t size);
+
+  /**
+   * @brief Calculates dest[i] = dest[i] + src[i] * value[i], advancing the
+   * ramp by @p size frames.
+   */
+  [[gnu::hot]] void mix_product (float * dest, const float * src, size_t size);
+
+  /**
+   * @brief Writes the next @p size values to @p values, advancing the ramp
+   * by @p size frames.
+   */
+  [[gnu::hot]] void fill_values (float * values, size_t size);
+
+private:
+  static constexpr size_t CHUNK_SIZE = 64;
+
+  /**
+   * @brief Fills @p values with the next @p size values of the ramp and
+   * advances it.
+   *
+   * @p size must not exceed CHUNK_SIZE or the remaining frames of the ramp.
+   */
+  void fill_ramp (float * values, size_t size);
+
+  /**
+   * @brief Calls @p op (offset, values, size) for each chunk of the ramp in
+   * the next @p size frames.
+   *
+   * @return The number of frames processed (the rest use the target).
+   */
+  template <typename Op> size_t process_ramp (size_t size, Op op)
+  {
+    size_t offset = 0;
+    while (offset < size && remaining_frames_ > 0)
+      {
+        std::array<float, CHUNK_SIZE> values;
+        const size_t                  chunk_size =
+          std::min ({ CHUNK_SIZE, size - offset, remaining_frames_ });
+        fill_ramp (values.data (), chunk_size);
+        op (offset, values.data (), chunk_size);
+        offset += chunk_size;
+      }
+    return offset;
+  }
+
+private:
+  Mode   mode_;
+  size_t ramp_length_ = 0;
+
+  float current_ = 0.f;
+  float target_ = 0.f;
+
+  /** Frames left until @ref target_ is reached. */
+  size_t remaining_frames_ = 0;
+
+  /** Whether a value was set yet. */
+  bool has_value_ = false;
+
+  /** Whether the current ramp is exponential. */
+  bool exponential_ramp_ = false;
+
+  /** Per-frame increment of a linear ramp. */
+  float step_ = 0.f;
+
+  /**
+   * Powers of the per-frame ratio of an exponential ramp (ratio^1 to
+   * ratio^CHUNK_SIZE).
+   */
+  std::array<float, CHUNK_SIZE> ratio_powers_{};
+};
+
+} // namespace zrythm::dsp
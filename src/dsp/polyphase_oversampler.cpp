@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+#include "dsp/polyphase_oversampler.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+/**
+ * Zeroth order modified Bessel function of the first kind (used by the Kaiser
+ * window).
+ */
+double
+bessel_i0 (double x)
+{
+  double sum = 1.0;
+  double term = 1.0;
+  for (int k = 1; k < 32; k++)
+    {
+      term *= (x / (2.0 * k)) * (x / (2.0 * k));
+      sum += term;
+    }
+  return sum;
+}
+
+}
+
+const PolyphaseOversampler::Coefficients &
+PolyphaseOversampler::get_coefficients ()
+{
+  static const Coefficients coefficients = [] () {
+    constexpr size_t num_taps = FACTOR * TAPS_PER_PHASE;
+    constexpr double beta = 7.0;
+    constexpr double center = (num_taps - 1) / 2.0;
+
+    std::array<double, num_taps> h{};
+    for (size_t i = 0; i < num_taps; i++)
+      {
+        /* sinc with its cutoff at the input's Nyquist frequency */
+        const double x = (static_cast<double> (i) - center) / FACTOR;
+        const double sinc =
+          x == 0.0
+            ? 1.0
+            : std::sin (std::numbers::pi * x) / (std::numbers::pi * x);
+        const double r = (static_cast<double> (i) - center) / center;
+        const double window =
+          bessel_i0 (beta * std::sqrt (1.0 - r * r)) / bessel_i0 (beta);
+        h[i] = sinc * window;
+      }
+
+    Coefficients ret{};
+    for (size_t phase = 0; phase < FACTOR; phase++)
+      {
+        /* normalize each phase to unity gain at DC */
+        double sum = 0.0;
+        for (size_t tap = 0; tap < TAPS_PER_PHASE; tap++)
+          {
+            sum += h[phase + FACTOR * tap];
+          }
+        for (size_t tap = 0; tap < TAPS_PER_PHASE; tap++)
+          {
+            ret[TAPS_PER_PHASE - 1 - tap][phase] =
+              static_cast<float> (h[phase + FACTOR * tap] / sum);
+          }
+      }
+    return ret;
+  }();
+  return coefficients;
+}
+
+void
+PolyphaseOversampler::init (size_t num_channels, size_t max_block_length)
+{
+  max_block_length_ = max_block_length;
+  history_.assign (
+    num_channels, std::vector<float> (TAPS_PER_PHASE - 1 + max_block_length));
+
+  /* compute the coefficients outside the realtime thread */
+  get_coefficients ();
+}
+
+void
+PolyphaseOversampler::reset ()
+{
+  for (auto &history : history_)
+    {
+      std::ranges::fill (history, 0.f);
+    }
+}
+
+void
+PolyphaseOversampler::process (
+  const float * const * in,
+  float * const *       out,
+  size_t                num_frames)
+{
+  assert (num_frames <= max_block_length_);
+
+  const auto &coefficients = get_coefficients ();
+  for (size_t ch = 0; ch < history_.size (); ch++)
+    {
+      auto &history = history_[ch];
+      std::copy_n (in[ch], num_frames, &history[TAPS_PER_PHASE - 1]);
+
+      float * dest = out[ch];
+      for (size_t i = 0; i < num_frames; i++)
+        {
+          /* the oldest sample used for this frame first */
+          const float *             window = &history[i];
+          std::array<float, FACTOR> acc{};
+          for (size_t tap = 0; tap < TAPS_PER_PHASE; tap++)
+            {
+              for (size_t phase = 0; phase < FACTOR; phase++)
+                {
+                  acc[phase] += coefficients[tap][phase] * window[tap];
+                }
+            }
+          std::ranges::copy (acc, &dest[i * FACTOR]);
+        }
+
+      /* keep the last frames for the next block */
+      std::copy_n (
+        &history[num_frames], TAPS_PER_PHASE - 1, history.begin ());
+    }
+}
+
+} // namespace zrythm::dsp
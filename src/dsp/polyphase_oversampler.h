@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief 4x oversampler using a polyphase FIR interpolation filter, for
+ * detecting inter-sample peaks.
+ *
+ * The filter is a Kaiser-windowed sinc with its cutoff at the Nyquist
+ * frequency of the input. Each input frame produces @ref FACTOR output
+ * frames, which are computed together in a multiply-accumulate loop over
+ * the taps that the compiler can vectorize.
+ *
+ * Several channels can be processed in a single call.
+ */
+class PolyphaseOversampler
+{
+public:
+  static constexpr size_t FACTOR = 4;
+  static constexpr size_t TAPS_PER_PHASE = 16;
+
+  /**
+   * @brief Allocates the channel history.
+   *
+   * @param max_block_length Maximum number of input frames passed to
+   * process().
+   */
+  void init (size_t num_channels, size_t max_block_length);
+
+  /**
+   * @brief Clears the filter history (as if silence was processed).
+   */
+  void reset ();
+
+  size_t get_num_channels () const { return history_.size (); }
+
+  /**
+   * @brief Delay of the output relative to the input, in output frames.
+   */
+  static constexpr size_t get_latency ()
+  {
+    return (FACTOR * TAPS_PER_PHASE - 1) / 2;
+  }
+
+  /**
+   * @brief Oversamples @p num_frames frames of each channel.
+   *
+   * @param in One buffer of @p num_frames frames per channel.
+   * @param out One buffer of @p num_frames * FACTOR frames per channel.
+   * @param num_frames Must not exceed the max block length given to init().
+   */
+  [[gnu::hot]] void
+  process (const float * const * in, float * const * out, size_t num_frames);
+
+private:
+  /**
+   * Coefficients for each tap, with the phases of each tap next to each
+   * other.
+   *
+   * The taps are reversed so that they can be applied to the history in
+   * ascending order.
+   */
+  using Coefficients = std::array<std::array<float, FACTOR>, TAPS_PER_PHASE>;
+
+  static const Coefficients &get_coefficients ();
+
+private:
+  size_t max_block_length_ = 0;
+
+  /**
+   * Per channel: the last TAPS_PER_PHASE - 1 input frames of the previous
+   * block, followed by room for the current block.
+   */
+  std::vector<std::vector<float>> history_;
+};
+
+} // namespace zrythm::dsp
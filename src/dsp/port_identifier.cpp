@@ -62,17 +62,17 @@ PortIdentifier::get_hash () const
   uint32_t hash = 0;
   if (!sym_.empty ())
     {
-      hash = hash ^ qHash (sym_);
+      hash = hash ^ qHash (sym_.hash ());
     }
   /* don't check label when have symbol because label might be
    * localized */
   else if (!label_.empty ())
     {
-      hash = hash ^ qHash (label_);
+      hash = hash ^ qHash (label_.hash ());
     }
 
   if (!uri_.empty ())
-    hash = hash ^ qHash (uri_);
+    hash = hash ^ qHash (uri_.hash ());
   hash = hash ^ qHash (owner_type_);
   hash = hash ^ qHash (type_);
   hash = hash ^ qHash (flow_);
@@ -82,9 +82,9 @@ PortIdentifier::get_hash () const
   if (plugin_id_.has_value ())
     hash = hash ^ qHash (type_safe::get (plugin_id_.value ()));
   if (!port_group_.empty ())
-    hash = hash ^ qHash (port_group_);
+    hash = hash ^ qHash (port_group_.hash ());
   if (!ext_port_id_.empty ())
-    hash = hash ^ qHash (ext_port_id_);
+    hash = hash ^ qHash (ext_port_id_.hash ());
   if (track_id_.has_value ())
     hash = hash ^ qHash (type_safe::get (track_id_.value ()));
   hash = hash ^ qHash (port_index_);
@@ -95,17 +95,33 @@ PortIdentifier::get_hash () const
 void
 PortIdentifier::define_fields (const Context &ctx)
 {
+  /* the interned strings are (de)serialized as plain strings */
+  std::string label = label_;
+  std::string sym = sym_;
+  std::string uri = uri_;
+  std::string comment = comment_;
+  std::string port_group = port_group_;
+  std::string ext_port_id = ext_port_id_;
   serialize_fields (
-    ctx, make_field ("label", label_, true), make_field ("symbol", sym_, true),
-    make_field ("uri", uri_, true), make_field ("comment", comment_, true),
+    ctx, make_field ("label", label, true), make_field ("symbol", sym, true),
+    make_field ("uri", uri, true), make_field ("comment", comment, true),
     make_field ("ownerType", owner_type_), make_field ("type", type_),
     make_field ("flow", flow_), make_field ("unit", unit_),
     make_field ("flags", flags_), make_field ("flags2", flags2_),
     make_field ("trackId", track_id_), make_field ("pluginId", plugin_id_),
-    make_field ("portGroup", port_group_, true),
-    make_field ("externalPortId", ext_port_id_, true),
+    make_field ("portGroup", port_group, true),
+    make_field ("externalPortId", ext_port_id, true),
     make_field ("portIndex", port_index_),
     make_field ("midiChannel", midi_channel_));
+  if (ctx.is_deserializing ())
+    {
+      label_ = label;
+      sym_ = sym;
+      uri_ = uri;
+      comment_ = comment;
+      port_group_ = port_group;
+      ext_port_id_ = ext_port_id;
+    }
 }
 
 bool
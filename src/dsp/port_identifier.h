@@ -7,6 +7,7 @@
 #include "zrythm-config.h"
 
 #include "utils/icloneable.h"
+#include "utils/interned_string.h"
 #include "utils/types.h"
 #include "utils/uuid_identifiable_object.h"
 
@@ -412,22 +413,22 @@ public:
   std::optional<PluginUuid> plugin_id_;
 
   /** Human readable label. */
-  std::string label_;
+  utils::InternedString label_;
 
   /** Unique symbol. */
-  std::string sym_;
+  utils::InternedString sym_;
 
   /** URI, if LV2 property. */
-  std::string uri_;
+  utils::InternedString uri_;
 
   /** Comment, if any. */
-  std::string comment_;
+  utils::InternedString comment_;
 
   /** Port group this port is part of (only applicable for LV2 plugin ports). */
-  std::string port_group_;
+  utils::InternedString port_group_;
 
   /** ExtPort ID (type + full name), if hw port. */
-  std::string ext_port_id_;
+  utils::InternedString ext_port_id_;
 
   /** MIDI channel if MIDI CC port, starting from 1 (so [1, 16]). */
   std::optional<midi_byte_t> midi_channel_;
@@ -90,6 +90,74 @@ Position::update_frames_from_ticks (double frames_per_tick)
     }
 }
 
+void
+Position::ticks_to_frames (
+  std::span<const double>   ticks,
+  std::span<signed_frame_t> frames,
+  double                    frames_per_tick)
+{
+  z_return_if_fail (frames_per_tick > 0 && frames.size () >= ticks.size ());
+
+  for (size_t i = 0; i < ticks.size (); ++i)
+    {
+      /* round half away from zero, like llround() */
+      const double   val = ticks[i] * frames_per_tick;
+      signed_frame_t rounded = static_cast<signed_frame_t> (val);
+      const double   rem = val - static_cast<double> (rounded);
+      rounded += static_cast<signed_frame_t> (rem >= 0.5)
+                 - static_cast<signed_frame_t> (rem <= -0.5);
+      frames[i] = rounded;
+    }
+}
+
+void
+Position::frames_to_ticks (
+  std::span<const signed_frame_t> frames,
+  std::span<double>               ticks,
+  double                          ticks_per_frame)
+{
+  z_return_if_fail (ticks_per_frame > 0 && ticks.size () >= frames.size ());
+
+  for (size_t i = 0; i < frames.size (); ++i)
+    {
+      ticks[i] = static_cast<double> (frames[i]) * ticks_per_frame;
+    }
+}
+
+void
+Position::update (
+  std::span<Position * const> positions,
+  bool                        from_ticks,
+  double                      ratio)
+{
+  std::vector<double>         ticks (positions.size ());
+  std::vector<signed_frame_t> frames (positions.size ());
+  if (from_ticks)
+    {
+      for (size_t i = 0; i < positions.size (); ++i)
+        {
+          ticks[i] = positions[i]->ticks_;
+        }
+      ticks_to_frames (ticks, frames, ratio);
+      for (size_t i = 0; i < positions.size (); ++i)
+        {
+          positions[i]->frames_ = frames[i];
+        }
+    }
+  else
+    {
+      for (size_t i = 0; i < positions.size (); ++i)
+        {
+          frames[i] = positions[i]->frames_;
+        }
+      frames_to_ticks (frames, ticks, ratio);
+      for (size_t i = 0; i < positions.size (); ++i)
+        {
+          positions[i]->ticks_ = ticks[i];
+        }
+    }
+}
+
 void
 Position::set_to_bar (int bar, int ticks_per_bar, double frames_per_tick)
 {
@@ -4,6 +4,8 @@
 #ifndef ZRYTHM_COMMON_DSP_POSITION_H
 #define ZRYTHM_COMMON_DSP_POSITION_H
 
+#include <span>
+
 #include "utils/iserializable.h"
 #include "utils/types.h"
 
@@ -277,6 +279,38 @@ public:
       update_ticks_from_frames (ratio);
   }
 
+  /**
+   * @brief Converts @p ticks to @p frames, rounding like
+   * get_frames_from_ticks().
+   *
+   * The loop is branch-free so that the compiler can vectorize it.
+   *
+   * @pre @p frames is at least as large as @p ticks.
+   */
+  static void ticks_to_frames (
+    std::span<const double>   ticks,
+    std::span<signed_frame_t> frames,
+    double                    frames_per_tick);
+
+  /**
+   * @brief Converts @p frames to @p ticks, like update_ticks_from_frames().
+   *
+   * @pre @p ticks is at least as large as @p frames.
+   */
+  static void frames_to_ticks (
+    std::span<const signed_frame_t> frames,
+    std::span<double>               ticks,
+    double                          ticks_per_frame);
+
+  /**
+   * @brief Same as calling update() on each of @p positions.
+   *
+   * The ticks (or frames) are gathered into a contiguous array and converted
+   * in one pass.
+   */
+  static void
+  update (std::span<Position * const> positions, bool from_ticks, double ratio);
+
   /**
    * @brief Sets the position to the midway point between the two given
    * positions.
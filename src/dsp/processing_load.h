@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Rolling load of a processor, as a fraction of the real-time budget.
+ *
+ * The load of a block is the time spent processing it divided by the duration
+ * of the block (so 1 means the processor alone used the whole budget). Blocks
+ * are averaged with an exponential moving average whose time constant is
+ * @ref TIME_CONSTANT_SECONDS regardless of the block size.
+ *
+ * There must be only one writer at a time (the thread processing the owner).
+ * The load may be read from any thread.
+ */
+class ProcessingLoad
+{
+public:
+  static constexpr double TIME_CONSTANT_SECONDS = 0.5;
+
+public:
+  /**
+   * @brief Records the processing time of a block.
+   *
+   * Realtime-safe.
+   *
+   * @param ns Time spent processing the block, in nanoseconds.
+   * @param nframes Number of frames in the block.
+   * @param sample_rate Sample rate.
+   */
+  [[gnu::hot]] void record (uint64_t ns, uint32_t nframes, uint32_t sample_rate)
+  {
+    if (nframes == 0 || sample_rate == 0)
+      return;
+
+    const double block_seconds =
+      static_cast<double> (nframes) / static_cast<double> (sample_rate);
+    const double block_load = static_cast<double> (ns) / (block_seconds * 1e9);
+    const double alpha = 1.0 - std::exp (-block_seconds / TIME_CONSTANT_SECONDS);
+    const double prev = load_.load (std::memory_order_relaxed);
+    load_.store (
+      static_cast<float> (prev + alpha * (block_load - prev)),
+      std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the current load (1 = 100% of the budget).
+   */
+  float get_load () const { return load_.load (std::memory_order_relaxed); }
+
+  void reset () { load_.store (0.f, std::memory_order_relaxed); }
+
+private:
+  std::atomic<float> load_ = 0.f;
+};
+
+} // namespace zrythm::dsp
@@ -0,0 +1,57 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "dsp/quality_governor.h"
+
+namespace zrythm::dsp
+{
+
+bool
+QualityGovernor::record_cycle (
+  double  dsp_load,
+  bool    xrun,
+  bool    offline,
+  int64_t now_us)
+{
+  const auto prev_quality = get_quality ();
+  if (offline)
+    {
+      /* start over once realtime processing resumes */
+      smoothed_load_ = 0.0;
+      low_load_since_us_ = -1;
+      quality_.store (Quality::Full, std::memory_order_relaxed);
+      return prev_quality != Quality::Full;
+    }
+
+  smoothed_load_ += options_.smoothing_ * (dsp_load - smoothed_load_);
+
+  auto quality = prev_quality;
+  if (xrun || smoothed_load_ > options_.reduce_above_)
+    {
+      quality = Quality::Reduced;
+      low_load_since_us_ = -1;
+    }
+  else if (smoothed_load_ < options_.restore_below_)
+    {
+      if (low_load_since_us_ < 0)
+        {
+          low_load_since_us_ = now_us;
+        }
+      else if (now_us - low_load_since_us_ >= options_.restore_after_us_)
+        {
+          quality = Quality::Full;
+        }
+    }
+  else
+    {
+      low_load_since_us_ = -1;
+    }
+
+  if (quality == prev_quality)
+    return false;
+
+  quality_.store (quality, std::memory_order_relaxed);
+  return true;
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,90 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Decides whether realtime stretchers and resamplers should run in
+ * their faster, lower quality modes, based on the DSP load.
+ *
+ * Quality is reduced as soon as the smoothed DSP load exceeds a threshold or
+ * an xrun happens, and restored once the load has stayed below a lower
+ * threshold for a while (so that it doesn't flip back and forth). Offline
+ * processing (e.g., exporting) always uses full quality.
+ *
+ * Updated by the audio thread; the quality can be read from any thread.
+ */
+class QualityGovernor
+{
+public:
+  enum class Quality : uint8_t
+  {
+    Full,
+    Reduced,
+  };
+
+  struct Options
+  {
+    /** Smoothed DSP load (in percent) above which quality is reduced. */
+    double reduce_above_ = 85.0;
+
+    /** Smoothed DSP load (in percent) below which quality is restored. */
+    double restore_below_ = 60.0;
+
+    /**
+     * Time the load must stay below @ref restore_below_ before quality is
+     * restored.
+     */
+    int64_t restore_after_us_ = 3'000'000;
+
+    /** Weight of each cycle's load in the smoothed load (0 to 1). */
+    double smoothing_ = 0.1;
+  };
+
+public:
+  QualityGovernor () = default;
+  explicit QualityGovernor (Options options) : options_ (options) { }
+
+  /**
+   * @brief Records the DSP load of a cycle.
+   *
+   * Realtime-safe.
+   *
+   * @param dsp_load Processing time relative to the cycle's duration, in
+   * percent.
+   * @param xrun Whether the cycle missed its deadline.
+   * @param offline Whether the cycle was processed offline (full quality is
+   * used regardless of the load).
+   * @param now_us Monotonic time.
+   * @return Whether the quality changed.
+   */
+  bool record_cycle (double dsp_load, bool xrun, bool offline, int64_t now_us);
+
+  Quality get_quality () const
+  {
+    return quality_.load (std::memory_order_relaxed);
+  }
+
+  bool is_reduced () const { return get_quality () == Quality::Reduced; }
+
+  /** Smoothed DSP load, in percent (only for the audio thread). */
+  double get_smoothed_load () const { return smoothed_load_; }
+
+private:
+  Options options_;
+
+  double smoothed_load_ = 0.0;
+
+  /** Since when the load has been low (-1 if it isn't). */
+  int64_t low_load_since_us_ = -1;
+
+  std::atomic<Quality> quality_{ Quality::Full };
+};
+
+} // namespace zrythm::dsp
@@ -0,0 +1,54 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+
+#include "utils/dsp.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Applies per-frame gains to a stereo signal in a single pass over
+ * the buffers (see utils::float_ranges::stereo_gain()).
+ *
+ * Used by the channel strip stages (faders and sends), which combine their
+ * gain, pan, fades, phase inversion etc. into one gain per frame and channel
+ * instead of going over the buffers once for each of them.
+ *
+ * The gains are computed in chunks small enough to stay in the L1 cache, by
+ * calling @p fill_gains (offset, gains_l, gains_r, size) for each chunk.
+ *
+ * @param mono_k See utils::float_ranges::stereo_gain().
+ * @param limit See utils::float_ranges::stereo_gain().
+ */
+template <typename FillGains>
+[[gnu::hot]] void
+apply_stereo_gain (
+  float *       dest_l,
+  float *       dest_r,
+  const float * src_l,
+  const float * src_r,
+  size_t        size,
+  float         mono_k,
+  float         limit,
+  FillGains   &&fill_gains)
+{
+  constexpr size_t              CHUNK_SIZE = 64;
+  std::array<float, CHUNK_SIZE> gains_l;
+  std::array<float, CHUNK_SIZE> gains_r;
+  for (size_t offset = 0; offset < size; offset += CHUNK_SIZE)
+    {
+      const size_t chunk_size = std::min (CHUNK_SIZE, size - offset);
+      fill_gains (offset, gains_l.data (), gains_r.data (), chunk_size);
+      utils::float_ranges::stereo_gain (
+        &dest_l[offset], &dest_r[offset], &src_l[offset], &src_r[offset],
+        gains_l.data (), gains_r.data (), mono_k, limit, chunk_size);
+    }
+}
+
+} // namespace zrythm::dsp
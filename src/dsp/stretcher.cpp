@@ -24,9 +24,16 @@
  * ---
  */
 
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
+#include <cstddef>
 #include <cstdlib>
 #include <cstring>
+#include <future>
+#include <thread>
+#include <vector>
 
 #include "dsp/stretcher.h"
 #include "utils/audio_file.h"
@@ -51,6 +58,12 @@ struct Stretcher::Impl
 
   bool is_realtime{};
 
+  /** Options the instance was created with. */
+  RubberBandOptions options{};
+
+  /** Whether the faster options are in use (see set_reduced_quality()). */
+  bool reduced_quality{};
+
   /**
    * Size of the block to process in each iteration.
    *
@@ -93,6 +106,7 @@ Stretcher::create_rubberband (
         | RubberBandOptionThreadingAlways | RubberBandOptionWindowStandard
         | RubberBandOptionSmoothingOff | RubberBandOptionFormantShifted
         | RubberBandOptionPitchHighSpeed | RubberBandOptionChannelsApart;
+      impl.options = opts;
       impl.block_size = 16000;
       impl.rubberband_state =
         rubberband_new (samplerate, channels, opts, time_ratio, pitch_ratio);
@@ -166,6 +180,7 @@ Stretcher::create_rubberband (
         | RubberBandOptionEngineFiner
 #endif
         ;
+      impl.options = opts;
       impl.block_size = 6000;
       impl.rubberband_state =
         rubberband_new (samplerate, channels, opts, time_ratio, pitch_ratio);
@@ -253,22 +268,178 @@ Stretcher::set_time_ratio (double ratio)
   rubberband_set_time_ratio (pimpl_->rubberband_state, ratio);
 }
 
+void
+Stretcher::set_reduced_quality (bool reduced)
+{
+  auto &impl = *pimpl_;
+  if (!impl.is_realtime || reduced == impl.reduced_quality)
+    return;
+
+  impl.reduced_quality = reduced;
+
+  /* (only the phase and transients options can be changed on a realtime
+   * instance) */
+  constexpr RubberBandOptions transients_mask =
+    RubberBandOptionTransientsMixed | RubberBandOptionTransientsSmooth;
+  rubberband_set_phase_option (
+    impl.rubberband_state,
+    reduced ? RubberBandOptionPhaseIndependent
+            : impl.options & RubberBandOptionPhaseIndependent);
+  rubberband_set_transients_option (
+    impl.rubberband_state,
+    reduced ? RubberBandOptionTransientsSmooth
+            : impl.options & transients_mask);
+}
+
 unsigned int
 Stretcher::get_latency () const
 {
   return rubberband_get_latency (pimpl_->rubberband_state);
 }
 
+namespace
+{
+
+/** Planar frames of each channel (the right channel is unused for mono). */
+using PlanarFrames = std::array<std::vector<float>, 2>;
+
+/**
+ * Studies and processes @p num_frames frames with an offline Rubber Band
+ * instance, returning the stretched frames.
+ */
+PlanarFrames
+stretch_offline (
+  RubberBandState state,
+  unsigned int    block_size,
+  unsigned int    channels,
+  const float *   in_l,
+  const float *   in_r,
+  size_t          num_frames)
+{
+  /* tell rubberband how many input samples it will receive */
+  rubberband_set_expected_input_duration (state, num_frames);
+
+  /* study first */
+  for (size_t studied = 0; studied < num_frames;)
+    {
+      const auto    read_now = static_cast<unsigned int> (
+        std::min (static_cast<size_t> (block_size), num_frames - studied));
+      const float * in[2] = { in_l + studied, in_r + studied };
+      studied += read_now;
+      rubberband_study (state, in, read_now, studied == num_frames);
+    }
+
+  PlanarFrames out;
+  const auto   expected_frames = static_cast<size_t> (std::llround (
+    rubberband_get_time_ratio (state) * static_cast<double> (num_frames)));
+  for (unsigned int ch = 0; ch < channels; ch++)
+    {
+      out[ch].reserve (expected_frames);
+    }
+
+  /* process */
+  std::vector<float> tmp_out_l;
+  std::vector<float> tmp_out_r;
+  size_t             processed = 0;
+  while (processed < num_frames)
+    {
+      const size_t in_chunk_size = std::min (
+        static_cast<size_t> (rubberband_get_samples_required (state)),
+        num_frames - processed);
+      const float * in[2] = { in_l + processed, in_r + processed };
+      processed += in_chunk_size;
+      rubberband_process (
+        state, in, static_cast<unsigned int> (in_chunk_size),
+        processed == num_frames);
+
+      /* retrieve the output data */
+      const auto avail =
+        static_cast<size_t> (std::max (rubberband_available (state), 0));
+      tmp_out_l.resize (avail);
+      tmp_out_r.resize (avail);
+      float *      tmp_out[2] = { tmp_out_l.data (), tmp_out_r.data () };
+      const size_t out_chunk_size = rubberband_retrieve (
+        state, tmp_out, static_cast<unsigned int> (avail));
+      for (unsigned int ch = 0; ch < channels; ch++)
+        {
+          out[ch].insert (
+            out[ch].end (), tmp_out[ch], tmp_out[ch] + out_chunk_size);
+        }
+    }
+
+  return out;
+}
+
+/**
+ * Maximum offset of a segment when aligning it to the previous one, in
+ * seconds.
+ */
+constexpr double MAX_SEGMENT_OFFSET_SECONDS = 0.01;
+
+/** Maximum number of frames compared when aligning segments. */
+constexpr size_t MAX_SEGMENT_ALIGNMENT_FRAMES = 4096;
+
+/**
+ * Returns the offset (within +/- @p max_offset) to read @p segment at so that
+ * its first @p num_frames frames are most similar to the frames already mixed
+ * at @p dest_start, so that segments don't cancel out when crossfaded.
+ */
+ptrdiff_t
+find_segment_offset (
+  const utils::audio::AudioBuffer &dest,
+  size_t                           dest_start,
+  const PlanarFrames              &segment,
+  unsigned int                     channels,
+  size_t                           num_frames,
+  ptrdiff_t                        max_offset)
+{
+  ptrdiff_t best_offset = 0;
+  double    best_score = 0.0;
+  for (ptrdiff_t offset = -max_offset; offset <= max_offset; ++offset)
+    {
+      double correlation = 0.0;
+      double energy = 0.0;
+      for (unsigned int ch = 0; ch < channels; ch++)
+        {
+          const float * dest_frames =
+            dest.getReadPointer (static_cast<int> (ch));
+          const auto &src = segment[ch];
+          for (size_t k = 0; k < num_frames; k++)
+            {
+              const auto src_index = static_cast<ptrdiff_t> (k) + offset;
+              if (
+                src_index < 0
+                || src_index >= static_cast<ptrdiff_t> (src.size ()))
+                continue;
+
+              const double val = src[static_cast<size_t> (src_index)];
+              correlation += val * dest_frames[dest_start + k];
+              energy += val * val;
+            }
+        }
+      const double score = correlation / std::sqrt (energy + 1e-9);
+      if (score > best_score)
+        {
+          best_score = score;
+          best_offset = offset;
+        }
+    }
+  return best_offset;
+}
+
+} // namespace
+
 zrythm::utils::audio::AudioBuffer
 Stretcher::stretch_interleaved (zrythm::utils::audio::AudioBuffer &in_samples)
 {
   z_return_val_if_fail (in_samples.getNumSamples () % pimpl_->channels == 0, {});
   z_return_val_if_fail (in_samples.getNumChannels () == 1, {});
-  auto in_samples_per_channel = in_samples.getNumSamples () / pimpl_->channels;
+  const size_t in_samples_per_channel =
+    in_samples.getNumSamples () / pimpl_->channels;
   z_debug ("num input samples: {}", in_samples_per_channel);
 
   /* create the de-interleaved array */
-  unsigned int       channels = pimpl_->channels;
+  const unsigned int channels = pimpl_->channels;
   std::vector<float> in_buffers_l (in_samples_per_channel, 0.f);
   std::vector<float> in_buffers_r (in_samples_per_channel, 0.f);
   for (size_t i = 0; i < in_samples_per_channel; i++)
@@ -277,87 +448,148 @@ Stretcher::stretch_interleaved (zrythm::utils::audio::AudioBuffer &in_samples)
       if (channels == 2)
         in_buffers_r[i] = in_samples.getSample (0, i * channels + 1);
     }
-  const float * in_buffers[2] = { in_buffers_l.data (), in_buffers_r.data () };
-
-  /* tell rubberband how many input samples it will
-   * receive */
-  rubberband_set_expected_input_duration (
-    pimpl_->rubberband_state, in_samples_per_channel);
-
-  /* study first */
-  size_t samples_to_read = in_samples_per_channel;
-  while (samples_to_read > 0)
-    {
-      /* samples to read now */
-      unsigned int read_now =
-        (unsigned int) std::min ((size_t) pimpl_->block_size, samples_to_read);
-
-      /* read */
-      rubberband_study (
-        pimpl_->rubberband_state, in_buffers, read_now,
-        read_now == samples_to_read);
-
-      /* remaining samples to read */
-      samples_to_read -= read_now;
-    }
-  z_warn_if_fail (samples_to_read == 0);
 
-  /* create the out sample arrays */
-  // float * out_samples[channels];
-  size_t out_samples_size = (size_t) utils::math::round_to_signed_64 (
-    rubberband_get_time_ratio (pimpl_->rubberband_state)
-    * in_samples_per_channel);
-  zrythm::utils::audio::AudioBuffer out_samples (channels, out_samples_size);
-
-  /* process */
-  size_t processed = 0;
+  const double time_ratio =
+    rubberband_get_time_ratio (pimpl_->rubberband_state);
+  const size_t out_samples_size = (size_t) utils::math::round_to_signed_64 (
+    time_ratio * static_cast<double> (in_samples_per_channel));
+  zrythm::utils::audio::AudioBuffer out_samples (
+    static_cast<int> (channels), static_cast<int> (out_samples_size));
+  out_samples.clear ();
+
+  const auto segment_frames = static_cast<size_t> (
+    SEGMENT_LENGTH_SECONDS * pimpl_->samplerate);
+  const auto min_segmented_frames = static_cast<size_t> (
+    MIN_SEGMENTED_LENGTH_SECONDS * pimpl_->samplerate);
   size_t total_out_frames = 0;
-  while (processed < in_samples_per_channel)
+  if (pimpl_->is_realtime || in_samples_per_channel < min_segmented_frames)
     {
-      size_t in_chunk_size =
-        rubberband_get_samples_required (pimpl_->rubberband_state);
-      size_t samples_left = in_samples_per_channel - processed;
-
-      if (samples_left < in_chunk_size)
+      auto out = stretch_offline (
+        pimpl_->rubberband_state, pimpl_->block_size, channels,
+        in_buffers_l.data (), in_buffers_r.data (), in_samples_per_channel);
+      total_out_frames = std::min (out[0].size (), out_samples_size);
+      for (unsigned int ch = 0; ch < channels; ch++)
         {
-          in_chunk_size = samples_left;
+          out_samples.copyFrom (
+            static_cast<int> (ch), 0, out[ch].data (),
+            static_cast<int> (total_out_frames));
         }
-
-      /* move the in buffers */
-      const float * tmp_in_arrays[2] = {
-        in_buffers[0] + processed, in_buffers[1] + processed
+    }
+  else
+    {
+      /* each segment also covers the beginning of the next one, where the two
+       * are crossfaded */
+      const auto overlap_frames = static_cast<size_t> (
+        SEGMENT_OVERLAP_SECONDS * pimpl_->samplerate);
+      const size_t num_segments =
+        (in_samples_per_channel + segment_frames - 1) / segment_frames;
+      const auto to_out_frame = [time_ratio] (size_t in_frame) {
+        return static_cast<size_t> (
+          std::llround (time_ratio * static_cast<double> (in_frame)));
+      };
+      const auto get_fade_frames = [&] (size_t segment_start) {
+        return std::max (
+          to_out_frame (segment_start + overlap_frames)
+            - to_out_frame (segment_start),
+          size_t{ 1 });
+      };
+      const double pitch_ratio =
+        rubberband_get_pitch_scale (pimpl_->rubberband_state);
+
+      std::vector<PlanarFrames> segments (num_segments);
+      std::atomic<size_t>       next_segment = 0;
+      const auto                stretch_next_segments = [&] () {
+        for (auto i = next_segment++; i < num_segments; i = next_segment++)
+          {
+            const size_t start = i * segment_frames;
+            const size_t end = std::min (
+              start + segment_frames + overlap_frames, in_samples_per_channel);
+            RubberBandState state = rubberband_new (
+              pimpl_->samplerate, channels, pimpl_->options, time_ratio,
+              pitch_ratio);
+            rubberband_set_max_process_size (state, pimpl_->block_size);
+            segments[i] = stretch_offline (
+              state, pimpl_->block_size, channels, in_buffers_l.data () + start,
+              in_buffers_r.data () + start, end - start);
+            rubberband_delete (state);
+          }
       };
 
-      /* process */
-      rubberband_process (
-        pimpl_->rubberband_state, tmp_in_arrays, in_chunk_size,
-        samples_left == in_chunk_size);
-
-      processed += in_chunk_size;
-
-      /*z_debug ("processed {}, in samples {}",*/
-      /*processed, in_samples_size);*/
-
-      size_t avail = (size_t) rubberband_available (pimpl_->rubberband_state);
-
-      /* retrieve the output data in temporary arrays */
-      std::vector<float> tmp_out_l (avail);
-      std::vector<float> tmp_out_r (avail);
-      float * tmp_out_arrays[2] = { tmp_out_l.data (), tmp_out_r.data () };
-      size_t  out_chunk_size =
-        rubberband_retrieve (pimpl_->rubberband_state, tmp_out_arrays, avail);
+      const auto num_threads = std::min (
+        static_cast<size_t> (
+          std::max (std::thread::hardware_concurrency (), 1u)),
+        num_segments);
+      std::vector<std::future<void>> workers;
+      workers.reserve (num_threads);
+      for (size_t i = 0; i < num_threads; ++i)
+        {
+          workers.emplace_back (
+            std::async (std::launch::async, stretch_next_segments));
+        }
+      for (auto &worker : workers)
+        {
+          worker.get ();
+        }
 
-      /* save the result */
-      for (size_t i = 0; i < channels; i++)
+      /* mix the segments, crossfading linearly where they overlap (after
+       * aligning each segment with the end of the previous one) */
+      const auto max_offset = static_cast<ptrdiff_t> (
+        MAX_SEGMENT_OFFSET_SECONDS * pimpl_->samplerate);
+      for (size_t i = 0; i < num_segments; i++)
         {
-          for (size_t j = 0; j < out_chunk_size; j++)
+          const auto  &segment = segments[i];
+          const size_t out_start = to_out_frame (i * segment_frames);
+          const size_t next_out_start = to_out_frame ((i + 1) * segment_frames);
+          const size_t fade_in_frames = get_fade_frames (i * segment_frames);
+          const size_t fade_out_frames =
+            get_fade_frames ((i + 1) * segment_frames);
+          const size_t len =
+            out_start < out_samples_size
+              ? std::min (segment[0].size (), out_samples_size - out_start)
+              : 0;
+          if (len == 0)
+            continue;
+
+          const ptrdiff_t offset =
+            i > 0 ? find_segment_offset (
+                      out_samples, out_start, segment, channels,
+                      std::min (
+                        { fade_in_frames, MAX_SEGMENT_ALIGNMENT_FRAMES, len }),
+                      max_offset)
+                  : 0;
+          for (unsigned int ch = 0; ch < channels; ch++)
             {
-              out_samples.setSample (
-                i, j + total_out_frames, tmp_out_arrays[i][j]);
+              float * dest = out_samples.getWritePointer (
+                static_cast<int> (ch), static_cast<int> (out_start));
+              for (size_t j = 0; j < len; j++)
+                {
+                  float gain = 1.f;
+                  if (i > 0 && j < fade_in_frames)
+                    {
+                      gain = static_cast<float> (j) / fade_in_frames;
+                    }
+                  const size_t out_frame = out_start + j;
+                  if (i + 1 < num_segments && out_frame >= next_out_start)
+                    {
+                      gain *= std::max (
+                        1.f
+                          - static_cast<float> (out_frame - next_out_start)
+                              / fade_out_frames,
+                        0.f);
+                    }
+                  const auto src_index = static_cast<ptrdiff_t> (j) + offset;
+                  if (
+                    src_index >= 0
+                    && src_index
+                         < static_cast<ptrdiff_t> (segment[ch].size ()))
+                    {
+                      dest[j] +=
+                        gain * segment[ch][static_cast<size_t> (src_index)];
+                    }
+                }
             }
+          total_out_frames = std::max (total_out_frames, out_start + len);
         }
-
-      total_out_frames += out_chunk_size;
     }
 
   z_debug (
@@ -365,7 +597,7 @@ Stretcher::stretch_interleaved (zrythm::utils::audio::AudioBuffer &in_samples)
   z_warn_if_fail (
     /* allow 1 sample earlier */
     total_out_frames <= out_samples_size
-    && total_out_frames >= out_samples_size - 1);
+    && total_out_frames + 1 >= out_samples_size);
 
   out_samples.interleave_samples ();
   return out_samples;
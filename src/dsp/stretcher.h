@@ -85,9 +85,23 @@ public:
 
   void set_time_ratio (double ratio);
 
+  /**
+   * @brief Switches a realtime instance to faster, lower quality options
+   * (independent phases and smooth transients) or back to the options it
+   * was created with.
+   *
+   * Realtime-safe. Does nothing for offline instances, which always use full
+   * quality.
+   */
+  void set_reduced_quality (bool reduced);
+
   /**
    * Perform stretching.
    *
+   * Inputs longer than @ref MIN_SEGMENTED_LENGTH_SECONDS are split into
+   * overlapping segments that are stretched concurrently (each with its own
+   * Rubber Band instance) and crossfaded at the seams.
+   *
    * @warning Not real-time safe, does allocations.
    *
    * @param in_samples Input samples (interleaved).
@@ -96,6 +110,16 @@ public:
   zrythm::utils::audio::AudioBuffer
   stretch_interleaved (zrythm::utils::audio::AudioBuffer &in_samples);
 
+  /** Length of each segment stretched concurrently, in input seconds. */
+  static constexpr double SEGMENT_LENGTH_SECONDS = 20.0;
+
+  /** Length of the crossfade between segments, in input seconds. */
+  static constexpr double SEGMENT_OVERLAP_SECONDS = 0.5;
+
+  /** Shorter inputs are stretched in one piece. */
+  static constexpr double MIN_SEGMENTED_LENGTH_SECONDS =
+    2 * SEGMENT_LENGTH_SECONDS;
+
 private:
   struct Impl;
   std::unique_ptr<Impl> pimpl_;
@@ -0,0 +1,165 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "dsp/tempo_map.h"
+#include "utils/logger.h"
+#include "utils/math.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+double
+calc_frames_per_tick (bpm_t bpm, sample_rate_t sample_rate, int ticks_per_beat)
+{
+  return (static_cast<double> (sample_rate) * 60.0)
+         / (static_cast<double> (bpm) * static_cast<double> (ticks_per_beat));
+}
+}
+
+void
+TempoMap::set_constant_tempo (
+  bpm_t         bpm,
+  sample_rate_t sample_rate,
+  int           ticks_per_beat)
+{
+  rebuild (bpm, {}, sample_rate, ticks_per_beat);
+}
+
+void
+TempoMap::rebuild (
+  bpm_t                        initial_bpm,
+  std::span<const TempoChange> changes,
+  sample_rate_t                sample_rate,
+  int                          ticks_per_beat)
+{
+  z_return_if_fail (initial_bpm > 0 && sample_rate > 0 && ticks_per_beat > 0);
+
+  sample_rate_ = sample_rate;
+  ticks_per_beat_ = ticks_per_beat;
+  segments_.clear ();
+  segments_.push_back (Segment{
+    .start_ticks_ = 0.0,
+    .start_frames_ = 0.0,
+    .frames_per_tick_ =
+      calc_frames_per_tick (initial_bpm, sample_rate, ticks_per_beat),
+    .bpm_ = initial_bpm,
+  });
+
+  for (const auto &change : changes)
+    {
+      if (change.ticks_ < 0)
+        continue;
+
+      auto &last = segments_.back ();
+      z_return_if_fail (change.bpm_ > 0 && change.ticks_ >= last.start_ticks_);
+      if (utils::math::floats_equal (change.bpm_, last.bpm_))
+        continue;
+
+      const double frames_per_tick =
+        calc_frames_per_tick (change.bpm_, sample_rate, ticks_per_beat);
+
+      /* a change at the start of the last segment replaces its tempo */
+      if (change.ticks_ == last.start_ticks_)
+        {
+          last.frames_per_tick_ = frames_per_tick;
+          last.bpm_ = change.bpm_;
+          continue;
+        }
+
+      const double start_frames =
+        last.start_frames_
+        + (change.ticks_ - last.start_ticks_) * last.frames_per_tick_;
+      segments_.push_back (Segment{
+        .start_ticks_ = change.ticks_,
+        .start_frames_ = start_frames,
+        .frames_per_tick_ = frames_per_tick,
+        .bpm_ = change.bpm_,
+      });
+    }
+}
+
+size_t
+TempoMap::find_segment_at_ticks (double ticks) const
+{
+  const auto it = std::ranges::upper_bound (
+    segments_, ticks, std::ranges::less{}, &Segment::start_ticks_);
+  return it == segments_.begin ()
+           ? 0
+           : static_cast<size_t> (std::distance (segments_.begin (), it)) - 1;
+}
+
+size_t
+TempoMap::find_segment_at_frames (double frames) const
+{
+  const auto it = std::ranges::upper_bound (
+    segments_, frames, std::ranges::less{}, &Segment::start_frames_);
+  return it == segments_.begin ()
+           ? 0
+           : static_cast<size_t> (std::distance (segments_.begin (), it)) - 1;
+}
+
+template <auto StartMember>
+size_t
+TempoMap::find_segment_from (double val, size_t hint) const
+{
+  const auto starts_after = [&] (size_t idx) {
+    return idx + 1 < segments_.size ()
+           && segments_[idx + 1].*StartMember <= val;
+  };
+
+  /* the position is in the same segment or the next one */
+  if (val >= segments_[hint].*StartMember || hint == 0)
+    {
+      if (!starts_after (hint))
+        return hint;
+      if (!starts_after (hint + 1))
+        return hint + 1;
+    }
+
+  if constexpr (StartMember == &Segment::start_ticks_)
+    return find_segment_at_ticks (val);
+  else
+    return find_segment_at_frames (val);
+}
+
+void
+TempoMap::ticks_to_frames (
+  std::span<const double>   ticks,
+  std::span<signed_frame_t> frames) const
+{
+  z_return_if_fail (!empty () && frames.size () >= ticks.size ());
+
+  size_t seg_idx = 0;
+  for (size_t i = 0; i < ticks.size (); ++i)
+    {
+      seg_idx = find_segment_from<&Segment::start_ticks_> (ticks[i], seg_idx);
+      const auto &seg = segments_[seg_idx];
+      frames[i] = utils::math::round_to_signed_frame_t (
+        seg.start_frames_
+        + (ticks[i] - seg.start_ticks_) * seg.frames_per_tick_);
+    }
+}
+
+void
+TempoMap::frames_to_ticks (
+  std::span<const signed_frame_t> frames,
+  std::span<double>               ticks) const
+{
+  z_return_if_fail (!empty () && ticks.size () >= frames.size ());
+
+  size_t seg_idx = 0;
+  for (size_t i = 0; i < frames.size (); ++i)
+    {
+      const auto frame = static_cast<double> (frames[i]);
+      seg_idx = find_segment_from<&Segment::start_frames_> (frame, seg_idx);
+      const auto &seg = segments_[seg_idx];
+      ticks[i] =
+        seg.start_ticks_ + (frame - seg.start_frames_) / seg.frames_per_tick_;
+    }
+}
+
+} // namespace zrythm::dsp
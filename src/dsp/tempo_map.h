@@ -0,0 +1,152 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "utils/types.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Converts between ticks and frames for songs whose tempo changes.
+ *
+ * The tempo is stored as a list of segments of constant tempo, each with the
+ * frame it starts at, so a conversion is a binary search for the segment
+ * followed by a multiplication instead of an integration over all the tempo
+ * changes before the position.
+ *
+ * Positions before the first segment use the tempo of the first segment.
+ */
+class TempoMap
+{
+public:
+  /**
+   * @brief A tempo change (the tempo stays the same until the next change).
+   */
+  struct TempoChange
+  {
+    double ticks_;
+    bpm_t  bpm_;
+  };
+
+  struct Segment
+  {
+    double start_ticks_;
+    double start_frames_;
+    double frames_per_tick_;
+    bpm_t  bpm_;
+  };
+
+  /**
+   * @brief Sets a single tempo for the whole song.
+   */
+  void
+  set_constant_tempo (bpm_t bpm, sample_rate_t sample_rate, int ticks_per_beat);
+
+  /**
+   * @brief Rebuilds the map.
+   *
+   * @param initial_bpm Tempo at the start of the song.
+   * @param changes Tempo changes, sorted by position. Changes at negative
+   * positions and changes that don't change the tempo are ignored.
+   */
+  void rebuild (
+    bpm_t                        initial_bpm,
+    std::span<const TempoChange> changes,
+    sample_rate_t                sample_rate,
+    int                          ticks_per_beat);
+
+  bool empty () const { return segments_.empty (); }
+
+  /** Sample rate the map was built for. */
+  sample_rate_t get_sample_rate () const { return sample_rate_; }
+
+  /** Ticks per beat the map was built for. */
+  int get_ticks_per_beat () const { return ticks_per_beat_; }
+
+  std::span<const Segment> get_segments () const { return segments_; }
+
+  /**
+   * @brief Returns the segment containing @p ticks.
+   *
+   * @pre The map is not empty.
+   */
+  const Segment &get_segment_at_ticks (double ticks) const
+  {
+    return segments_[find_segment_at_ticks (ticks)];
+  }
+
+  /**
+   * @brief Returns the segment containing @p frames.
+   *
+   * @pre The map is not empty.
+   */
+  const Segment &get_segment_at_frames (double frames) const
+  {
+    return segments_[find_segment_at_frames (frames)];
+  }
+
+  bpm_t get_bpm_at_ticks (double ticks) const
+  {
+    return get_segment_at_ticks (ticks).bpm_;
+  }
+
+  double ticks_to_frames (double ticks) const
+  {
+    const auto &seg = get_segment_at_ticks (ticks);
+    return seg.start_frames_
+           + (ticks - seg.start_ticks_) * seg.frames_per_tick_;
+  }
+
+  double frames_to_ticks (double frames) const
+  {
+    const auto &seg = get_segment_at_frames (frames);
+    return seg.start_ticks_
+           + (frames - seg.start_frames_) / seg.frames_per_tick_;
+  }
+
+  /**
+   * @brief Converts positions in ticks to (rounded) frames.
+   *
+   * Sorted positions only need a binary search when they skip segments.
+   *
+   * @pre @p frames is at least as large as @p ticks.
+   */
+  void ticks_to_frames (
+    std::span<const double>   ticks,
+    std::span<signed_frame_t> frames) const;
+
+  /**
+   * @brief Converts positions in frames to ticks.
+   *
+   * Sorted positions only need a binary search when they skip segments.
+   *
+   * @pre @p ticks is at least as large as @p frames.
+   */
+  void frames_to_ticks (
+    std::span<const signed_frame_t> frames,
+    std::span<double>               ticks) const;
+
+private:
+  size_t find_segment_at_ticks (double ticks) const;
+  size_t find_segment_at_frames (double frames) const;
+
+  /**
+   * @brief Returns the segment containing @p val, starting from the segment
+   * at @p hint (the segment of the previous position).
+   */
+  template <auto StartMember>
+  size_t find_segment_from (double val, size_t hint) const;
+
+private:
+  std::vector<Segment> segments_;
+  sample_rate_t        sample_rate_ = 0;
+  int                  ticks_per_beat_ = 0;
+};
+
+} // namespace zrythm::dsp
@@ -0,0 +1,310 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <thread>
+
+#include "dsp/stretcher.h"
+#include "dsp/timestretch_cache.h"
+#include "utils/dsp.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+namespace zrythm::dsp
+{
+
+bool
+TimestretchCache::Slot::matches (const Key &key) const
+{
+  return source_hash_.load () == key.source_hash_
+         && ratio_.load () == key.ratio_
+         && samplerate_.load () == key.samplerate_;
+}
+
+TimestretchCache::TimestretchCache (
+  StretchFunc stretch_func,
+  size_t      max_entries,
+  size_t      max_bytes)
+    : juce::Thread ("TimestretchCache"),
+      stretch_func_ (std::move (stretch_func)), max_entries_ (max_entries),
+      max_bytes_ (max_bytes)
+{
+  for (size_t i = 0; i < max_entries_; i++)
+    {
+      slots_.push_back (std::make_unique<Slot> ());
+    }
+}
+
+TimestretchCache::~TimestretchCache ()
+{
+  stopThread (-1);
+}
+
+utils::audio::AudioBuffer
+TimestretchCache::stretch_with_rubberband (
+  const utils::audio::AudioBuffer &source,
+  const Key                       &key)
+{
+  const auto num_channels = source.getNumChannels ();
+  if (num_channels < 1 || num_channels > 2)
+    {
+      throw ZrythmException (
+        fmt::format ("Cannot stretch {} channels", num_channels));
+    }
+
+  /* the stretcher uses the inverse ratio (the ratio of the durations) */
+  auto stretcher = Stretcher::create_rubberband (
+    key.samplerate_, static_cast<unsigned> (num_channels), 1.0 / key.ratio_,
+    1.0, false);
+
+  utils::audio::AudioBuffer interleaved;
+  interleaved.makeCopyOf (source);
+  interleaved.interleave_samples ();
+  auto frames = stretcher->stretch_interleaved (interleaved);
+  if (frames.getNumSamples () == 0)
+    {
+      throw ZrythmException ("Failed to stretch frames");
+    }
+  frames.deinterleave_samples (static_cast<size_t> (num_channels));
+  return frames;
+}
+
+TimestretchCache::Slot *
+TimestretchCache::acquire_slot (const Key &key) const
+{
+  for (const auto &slot : slots_)
+    {
+      if (
+        slot->state_.load (std::memory_order_acquire) != READY
+        || !slot->matches (key))
+        continue;
+
+      /* register as a reader before checking again, so that an eviction
+       * either sees us or we see it */
+      slot->readers_.fetch_add (1);
+      if (slot->state_.load () == READY && slot->matches (key))
+        {
+          slot->last_used_.store (
+            access_counter_.fetch_add (1, std::memory_order_relaxed) + 1,
+            std::memory_order_relaxed);
+          return slot.get ();
+        }
+      slot->readers_.fetch_sub (1);
+    }
+  return nullptr;
+}
+
+std::optional<unsigned_frame_t>
+TimestretchCache::get_num_frames (const Key &key) const
+{
+  auto * slot = acquire_slot (key);
+  if (slot == nullptr)
+    return std::nullopt;
+
+  const auto num_frames =
+    static_cast<unsigned_frame_t> (slot->frames_.getNumSamples ());
+  slot->readers_.fetch_sub (1);
+  return num_frames;
+}
+
+bool
+TimestretchCache::read (
+  const Key       &key,
+  unsigned_frame_t start_frame,
+  float *          l,
+  float *          r,
+  unsigned_frame_t num_frames)
+{
+  auto * slot = acquire_slot (key);
+  if (slot == nullptr)
+    {
+      utils::float_ranges::fill (l, 0.f, num_frames);
+      utils::float_ranges::fill (r, 0.f, num_frames);
+      return false;
+    }
+
+  const auto &frames = slot->frames_;
+  const auto  total_frames =
+    static_cast<unsigned_frame_t> (frames.getNumSamples ());
+  const auto num_frames_in_entry =
+    start_frame < total_frames
+      ? std::min (num_frames, total_frames - start_frame)
+      : 0;
+  const int r_ch = frames.getNumChannels () == 1 ? 0 : 1;
+  if (num_frames_in_entry > 0)
+    {
+      utils::float_ranges::copy (
+        l, frames.getReadPointer (0, static_cast<int> (start_frame)),
+        num_frames_in_entry);
+      utils::float_ranges::copy (
+        r, frames.getReadPointer (r_ch, static_cast<int> (start_frame)),
+        num_frames_in_entry);
+    }
+  slot->readers_.fetch_sub (1);
+
+  if (num_frames_in_entry < num_frames)
+    {
+      utils::float_ranges::fill (
+        &l[num_frames_in_entry], 0.f, num_frames - num_frames_in_entry);
+      utils::float_ranges::fill (
+        &r[num_frames_in_entry], 0.f, num_frames - num_frames_in_entry);
+    }
+  return true;
+}
+
+void
+TimestretchCache::request (const Key &key, Source source)
+{
+  if (auto * slot = acquire_slot (key))
+    {
+      slot->readers_.fetch_sub (1);
+      return;
+    }
+
+  {
+    std::lock_guard lock (jobs_mutex_);
+    if (
+      rendering_key_ == key
+      || std::ranges::any_of (
+        jobs_, [&key] (const auto &job) { return job.key_ == key; }))
+      {
+        return;
+      }
+    z_debug (
+      "requesting timestretch of {} with ratio {}",
+      utils::hash::to_string (key.source_hash_), key.ratio_);
+    jobs_.push_back ({ key, std::move (source) });
+  }
+
+  if (!isThreadRunning ())
+    {
+      startThread (juce::Thread::Priority::low);
+    }
+  notify ();
+}
+
+void
+TimestretchCache::evict (Slot &slot)
+{
+  slot.state_.store (EMPTY);
+  while (slot.readers_.load () > 0)
+    {
+      std::this_thread::yield ();
+    }
+}
+
+void
+TimestretchCache::store (const Key &key, utils::audio::AudioBuffer &&frames)
+{
+  const auto get_num_bytes = [] (const utils::audio::AudioBuffer &buf) {
+    return static_cast<size_t> (buf.getNumChannels ())
+           * static_cast<size_t> (buf.getNumSamples ()) * sizeof (float);
+  };
+  const auto new_num_bytes = get_num_bytes (frames);
+  if (new_num_bytes > max_bytes_)
+    {
+      z_warning (
+        "stretched frames ({} bytes) don't fit in the cache", new_num_bytes);
+      return;
+    }
+
+  /* evict the least recently used entries until there is room */
+  while (true)
+    {
+      Slot * empty_slot = nullptr;
+      Slot * lru_slot = nullptr;
+      size_t num_bytes = new_num_bytes;
+      for (auto &slot : slots_)
+        {
+          if (slot->state_.load () != READY)
+            {
+              empty_slot = slot.get ();
+              continue;
+            }
+          num_bytes += get_num_bytes (slot->frames_);
+          if (
+            lru_slot == nullptr
+            || slot->last_used_.load () < lru_slot->last_used_.load ())
+            {
+              lru_slot = slot.get ();
+            }
+        }
+
+      if (empty_slot != nullptr && num_bytes <= max_bytes_)
+        {
+          empty_slot->frames_ = std::move (frames);
+          empty_slot->source_hash_.store (key.source_hash_);
+          empty_slot->ratio_.store (key.ratio_);
+          empty_slot->samplerate_.store (key.samplerate_);
+          empty_slot->last_used_.store (access_counter_.load ());
+          empty_slot->state_.store (READY, std::memory_order_release);
+          num_bytes_.store (num_bytes, std::memory_order_relaxed);
+          return;
+        }
+
+      z_return_if_fail (lru_slot);
+      evict (*lru_slot);
+      lru_slot->frames_.setSize (0, 0);
+    }
+}
+
+void
+TimestretchCache::run ()
+{
+  while (!threadShouldExit ())
+    {
+      std::optional<Job> job;
+      {
+        std::lock_guard lock (jobs_mutex_);
+
+        /* skip sources not used anywhere else anymore */
+        std::erase_if (jobs_, [] (const auto &j) {
+          return j.source_.use_count () == 1;
+        });
+
+        /* most recent requests first */
+        if (!jobs_.empty ())
+          {
+            job = std::move (jobs_.back ());
+            jobs_.pop_back ();
+            rendering_key_ = job->key_;
+          }
+        else
+          {
+            rendering_key_.reset ();
+          }
+      }
+
+      if (!job)
+        {
+          wait (-1);
+          continue;
+        }
+
+      try
+        {
+          auto frames = stretch_func_ (*job->source_, job->key_);
+          job->source_.reset ();
+          store (job->key_, std::move (frames));
+          z_debug (
+            "stretched {} with ratio {}",
+            utils::hash::to_string (job->key_.source_hash_), job->key_.ratio_);
+        }
+      catch (const ZrythmException &e)
+        {
+          z_warning (
+            "Failed to stretch {} with ratio {}: {}",
+            utils::hash::to_string (job->key_.source_hash_), job->key_.ratio_,
+            e.what ());
+        }
+      catch (const std::exception &e)
+        {
+          z_warning (
+            "Failed to stretch {} with ratio {}: {}",
+            utils::hash::to_string (job->key_.source_hash_), job->key_.ratio_,
+            e.what ());
+        }
+    }
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,201 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "utils/audio.h"
+#include "utils/hash.h"
+#include "utils/types.h"
+
+#include "juce_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+/**
+ * @brief Renders time-stretched versions of audio sources on a background
+ * thread, so that playback doesn't need to stretch them in realtime.
+ *
+ * Entries are identified by a Key (the hash of the source, the stretch ratio
+ * and the sample rate). Renders are requested with request() and, once
+ * finished, can be read from the realtime thread with read(). Until then,
+ * callers are expected to fall back to realtime stretching.
+ *
+ * The least recently read entries are evicted when there are more than
+ * @ref max_entries_ entries or they take more than @ref max_bytes_ bytes.
+ */
+class TimestretchCache final : public juce::Thread
+{
+public:
+  struct Key
+  {
+    /** Hash of the source (e.g., of the file of an audio clip). */
+    utils::hash::HashT source_hash_{};
+
+    /**
+     * Speed-up ratio (e.g., 2.0 when the BPM is doubled, which halves the
+     * duration).
+     */
+    double ratio_ = 1.0;
+
+    sample_rate_t samplerate_ = 0;
+
+    bool operator== (const Key &other) const = default;
+  };
+
+  /**
+   * @brief Frames to stretch.
+   *
+   * They must not be modified while referenced.
+   */
+  using Source = std::shared_ptr<const utils::audio::AudioBuffer>;
+
+  /**
+   * @brief Returns the frames of @p source stretched by @p key's ratio.
+   *
+   * @throw ZrythmException on error.
+   */
+  using StretchFunc = std::function<utils::audio::AudioBuffer (
+    const utils::audio::AudioBuffer &source,
+    const Key                       &key)>;
+
+  static constexpr size_t DEFAULT_MAX_ENTRIES = 32;
+  static constexpr size_t DEFAULT_MAX_BYTES = 1024ULL * 1024 * 1024;
+
+  /**
+   * @param stretch_func Function used to stretch. Defaults to
+   * stretch_with_rubberband().
+   */
+  TimestretchCache (
+    StretchFunc stretch_func = stretch_with_rubberband,
+    size_t      max_entries = DEFAULT_MAX_ENTRIES,
+    size_t      max_bytes = DEFAULT_MAX_BYTES);
+  ~TimestretchCache () override;
+  Z_DISABLE_COPY_MOVE (TimestretchCache);
+
+  /**
+   * @brief Stretches @p source offline with rubberband (high quality).
+   */
+  static utils::audio::AudioBuffer stretch_with_rubberband (
+    const utils::audio::AudioBuffer &source,
+    const Key                       &key);
+
+  /**
+   * @brief Requests rendering @p source for @p key in the background, unless
+   * it is already rendered or requested (and starts the thread if needed).
+   *
+   * Not realtime-safe.
+   */
+  void request (const Key &key, Source source);
+
+  /**
+   * @brief Returns the number of frames of the rendered entry for @p key, or
+   * nothing if it is not rendered (yet).
+   *
+   * Realtime-safe.
+   */
+  std::optional<unsigned_frame_t> get_num_frames (const Key &key) const;
+
+  /**
+   * @brief Copies @p num_frames frames of the rendered entry for @p key
+   * starting at @p start_frame to @p l and @p r (mono entries are copied to
+   * both).
+   *
+   * Frames past the end of the entry are filled with silence.
+   *
+   * Realtime-safe.
+   *
+   * @return Whether the entry was rendered (otherwise all frames are silent).
+   */
+  bool read (
+    const Key       &key,
+    unsigned_frame_t start_frame,
+    float *          l,
+    float *          r,
+    unsigned_frame_t num_frames);
+
+  /**
+   * @brief Returns the number of bytes used by the rendered entries.
+   */
+  size_t get_memory_usage () const
+  {
+    return num_bytes_.load (std::memory_order_relaxed);
+  }
+
+  void run () override;
+
+private:
+  static constexpr int EMPTY = 0;
+  static constexpr int READY = 1;
+
+  struct Slot
+  {
+    utils::audio::AudioBuffer frames_;
+
+    /** EMPTY or READY. */
+    std::atomic<int> state_{ EMPTY };
+
+    std::atomic<utils::hash::HashT> source_hash_{ 0 };
+    std::atomic<double>             ratio_{ 0.0 };
+    std::atomic<sample_rate_t>      samplerate_{ 0 };
+
+    /** Number of realtime readers currently using this slot. */
+    std::atomic<int> readers_{ 0 };
+
+    /** Value of @ref access_counter_ when this slot was last read. */
+    std::atomic<uint64_t> last_used_{ 0 };
+
+    bool matches (const Key &key) const;
+  };
+
+  struct Job
+  {
+    Key    key_;
+    Source source_;
+  };
+
+  /**
+   * @brief Returns the ready slot for @p key, with its reader count
+   * incremented (the caller must decrement it), or nullptr.
+   */
+  Slot * acquire_slot (const Key &key) const;
+
+  /**
+   * @brief Stores @p frames for @p key, evicting the least recently used
+   * entries as needed.
+   */
+  void store (const Key &key, utils::audio::AudioBuffer &&frames);
+
+  /**
+   * @brief Empties @p slot once no realtime thread reads from it anymore.
+   */
+  static void evict (Slot &slot);
+
+private:
+  StretchFunc stretch_func_;
+  size_t      max_entries_;
+  size_t      max_bytes_;
+
+  std::vector<std::unique_ptr<Slot>> slots_;
+
+  /** Protects @ref jobs_ and @ref rendering_key_. */
+  std::mutex       jobs_mutex_;
+  std::vector<Job> jobs_;
+
+  /** Key of the job being rendered, if any. */
+  std::optional<Key> rendering_key_;
+
+  mutable std::atomic<uint64_t> access_counter_{ 0 };
+
+  /** Bytes used by the rendered entries (see get_memory_usage()). */
+  std::atomic<size_t> num_bytes_{ 0 };
+};
+
+} // namespace zrythm::dsp
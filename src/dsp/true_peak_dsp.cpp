@@ -22,86 +22,73 @@
  */
 
 #include <cassert>
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
 #include "dsp/true_peak_dsp.h"
 #include "utils/dsp.h"
 
-#include "zita-resampler/resampler.h"
-
 namespace zrythm::dsp
 {
 
-struct TruePeakDsp::Impl
-{
-  zita::Resampler src_;
-};
+TruePeakDsp::TruePeakDsp () = default;
 
-TruePeakDsp::TruePeakDsp () : impl_ (std::make_unique<Impl> ()) { }
+void
+TruePeakDsp::oversample (const float * const * channels, int n)
+{
+  assert (n > 0);
+  assert (n <= MAX_BLOCK_LENGTH);
+  assert (!bufs_.empty ());
+  oversampler_.process (channels, buf_ptrs_.data (), static_cast<size_t> (n));
+}
 
 void
 TruePeakDsp::process (float * data, int n)
 {
-  assert (n > 0);
-  assert (n <= 8192);
-  impl_->src_.inp_count = static_cast<unsigned int> (n);
-  impl_->src_.inp_data = data;
-  impl_->src_.out_count = static_cast<unsigned int> (n * 4);
-  impl_->src_.out_data = buf_.data ();
-  impl_->src_.process ();
-
-  float         v;
-  float         m = res_ ? 0 : m_;
-  float         p = res_ ? 0 : p_;
-  float         z1 = z1_ > 20 ? 20 : (z1_ < 0 ? 0 : z1_);
-  float         z2 = z2_ > 20 ? 20 : (z2_ < 0 ? 0 : z2_);
-  const float * b = buf_.data ();
-
-  while (n--)
+  process (&data, n);
+}
+
+void
+TruePeakDsp::process (const float * const * channels, int n)
+{
+  oversample (channels, n);
+
+  float v;
+  float m = res_ ? 0 : m_;
+  float p = res_ ? 0 : p_;
+
+  for (size_t ch = 0; ch < bufs_.size (); ch++)
     {
-      z1 *= w3_;
-      z2 *= w3_;
-
-      v = fabsf (*b++);
-      if (v > z1)
-        z1 += w1_ * (v - z1);
-      if (v > z2)
-        z2 += w2_ * (v - z2);
-      if (v > p)
-        p = v;
-
-      v = fabsf (*b++);
-      if (v > z1)
-        z1 += w1_ * (v - z1);
-      if (v > z2)
-        z2 += w2_ * (v - z2);
-      if (v > p)
-        p = v;
-
-      v = fabsf (*b++);
-      if (v > z1)
-        z1 += w1_ * (v - z1);
-      if (v > z2)
-        z2 += w2_ * (v - z2);
-      if (v > p)
-        p = v;
-
-      v = fabsf (*b++);
-      if (v > z1)
-        z1 += w1_ * (v - z1);
-      if (v > z2)
-        z2 += w2_ * (v - z2);
-      if (v > p)
-        p = v;
-
-      v = z1 + z2;
-      if (v > m)
-        m = v;
-    }
+      auto         &state = channel_states_[ch];
+      float         z1 = state.z1_ > 20 ? 20 : (state.z1_ < 0 ? 0 : state.z1_);
+      float         z2 = state.z2_ > 20 ? 20 : (state.z2_ < 0 ? 0 : state.z2_);
+      const float * b = bufs_[ch].data ();
 
-  z1_ = z1 + 1e-20f;
-  z2_ = z2 + 1e-20f;
+      for (int i = 0; i < n; i++)
+        {
+          z1 *= w3_;
+          z2 *= w3_;
+
+          for (size_t j = 0; j < PolyphaseOversampler::FACTOR; j++)
+            {
+              v = fabsf (*b++);
+              if (v > z1)
+                z1 += w1_ * (v - z1);
+              if (v > z2)
+                z2 += w2_ * (v - z2);
+              if (v > p)
+                p = v;
+            }
+
+          v = z1 + z2;
+          if (v > m)
+            m = v;
+        }
+
+      state.z1_ = z1 + 1e-20f;
+      state.z2_ = z2 + 1e-20f;
+    }
 
   m *= g_;
 
@@ -127,30 +114,20 @@ TruePeakDsp::process (float * data, int n)
 void
 TruePeakDsp::process_max (float * p, int n)
 {
-  assert (n <= 8192);
-  impl_->src_.inp_count = static_cast<unsigned int> (n);
-  impl_->src_.inp_data = p;
-  impl_->src_.out_count = static_cast<unsigned int> (n * 4);
-  impl_->src_.out_data = buf_.data ();
-  impl_->src_.process ();
-
-  float        m = res_ ? 0 : m_;
-  float        v{};
-  const auto * b = buf_.data ();
-  while (n--)
+  process_max (&p, n);
+}
+
+void
+TruePeakDsp::process_max (const float * const * channels, int n)
+{
+  oversample (channels, n);
+
+  float      m = res_ ? 0 : m_;
+  const auto num_frames =
+    static_cast<size_t> (n) * PolyphaseOversampler::FACTOR;
+  for (const auto &buf : bufs_)
     {
-      v = fabsf (*b++);
-      if (v > m)
-        m = v;
-      v = fabsf (*b++);
-      if (v > m)
-        m = v;
-      v = fabsf (*b++);
-      if (v > m)
-        m = v;
-      v = fabsf (*b++);
-      if (v > m)
-        m = v;
+      m = std::max (m, utils::float_ranges::abs_max (buf.data (), num_frames));
     }
   m_ = m;
 }
@@ -178,26 +155,23 @@ TruePeakDsp::reset ()
 }
 
 void
-TruePeakDsp::init (float samplerate)
+TruePeakDsp::init (float samplerate, size_t num_channels)
 {
-  impl_->src_.setup (
-    static_cast<unsigned int> (samplerate),
-    static_cast<unsigned int> (samplerate * 4.f), 1, 24, 1.0);
-  buf_.resize (32768);
+  oversampler_.init (num_channels, MAX_BLOCK_LENGTH);
+  bufs_.assign (
+    num_channels,
+    std::vector<float> (MAX_BLOCK_LENGTH * PolyphaseOversampler::FACTOR));
+  buf_ptrs_.clear ();
+  for (auto &buf : bufs_)
+    {
+      buf_ptrs_.push_back (buf.data ());
+    }
 
-  z1_ = z2_ = .0f;
+  channel_states_.assign (num_channels, ChannelState{});
   w1_ = 4000.f / samplerate / 4.f;
   w2_ = 17200.f / samplerate / 4.f;
   w3_ = 1.0f - 7.f / samplerate / 4.f;
   g_ = 0.502f;
-
-  std::array<float, 8192> zero{};
-  utils::float_ranges::fill (zero.data (), 0.f, zero.size ());
-  impl_->src_.inp_count = 8192;
-  impl_->src_.inp_data = zero.data ();
-  impl_->src_.out_count = 32768;
-  impl_->src_.out_data = buf_.data ();
-  impl_->src_.process ();
 }
 
 TruePeakDsp::~TruePeakDsp () = default;
@@ -24,12 +24,23 @@
 #ifndef ZRYTHM_DSP_TRUE_PEAK_DSP
 #define ZRYTHM_DSP_TRUE_PEAK_DSP
 
+#include "dsp/polyphase_oversampler.h"
+
 namespace zrythm::dsp
 {
 
+/**
+ * @brief True peak meter (4x oversampled).
+ *
+ * Can meter several channels at once, in which case the readings are the
+ * maximum over the channels.
+ */
 class TruePeakDsp
 {
 public:
+  /** Maximum number of frames that can be processed at once. */
+  static constexpr int MAX_BLOCK_LENGTH = 8192;
+
   TruePeakDsp ();
   ~TruePeakDsp ();
 
@@ -41,8 +52,17 @@ public:
    */
   void process (float * p, int n);
 
+  /**
+   * @brief Processes @p n samples of each channel.
+   *
+   * @param channels One buffer per channel passed to init().
+   */
+  void process (const float * const * channels, int n);
+
   void process_max (float * p, int n);
 
+  void process_max (const float * const * channels, int n);
+
   float read_f ();
 
   /**
@@ -58,25 +78,41 @@ public:
 
   /**
    * Init with the samplerate.
+   *
+   * @param num_channels Number of channels passed to process().
+   */
+  void init (float samplerate, size_t num_channels = 1);
+
+private:
+  /**
+   * @brief Oversamples the given channels into @ref bufs_.
    */
-  void init (float samplerate);
+  void oversample (const float * const * channels, int n);
 
 private:
-  float              m_ = 0.0f;
-  float              p_ = 0.0f;
-  float              z1_ = 0.0f;
-  float              z2_ = 0.0f;
-  bool               res_ = true;
-  std::vector<float> buf_;
+  struct ChannelState
+  {
+    float z1_ = 0.0f;
+    float z2_ = 0.0f;
+  };
+
+  float                     m_ = 0.0f;
+  float                     p_ = 0.0f;
+  std::vector<ChannelState> channel_states_;
+  bool                      res_ = true;
+
+  /** Oversampled signal of each channel. */
+  std::vector<std::vector<float>> bufs_;
+
+  /** Pointers to @ref bufs_. */
+  std::vector<float *> buf_ptrs_;
 
   float w1_ = 0.0f; // attack filter coefficient
   float w2_ = 0.0f; // attack filter coefficient
   float w3_ = 0.0f; // release filter coefficient
   float g_ = 1.0f;  // gain factor
 
-  // Forward declared implementation struct to hide zita::Resampler
-  struct Impl;
-  std::unique_ptr<Impl> impl_;
+  PolyphaseOversampler oversampler_;
 };
 
 } // namespace zrythm::dsp
@@ -77,6 +77,18 @@ AudioEngineApplication::initialise (const juce::String &commandLine)
 void
 AudioEngineApplication::setup_ipc ()
 {
+  if (!shared_memory_)
+    {
+      try
+        {
+          shared_memory_ = IPCSharedMemory::create ();
+        }
+      catch (const ZrythmException &e)
+        {
+          z_error ("Failed to set up shared memory: {}", e.what ());
+        }
+    }
+
 #if 0
   server_ = new QLocalServer (this);
   qDebug () << "Listening for IPC connections";
@@ -113,6 +125,15 @@ AudioEngineApplication::onNewConnection ()
   connect (
     client_connection_, &QLocalSocket::disconnected, client_connection_,
     &QLocalSocket::deleteLater);
+
+  if (shared_memory_)
+    {
+      QDataStream out (client_connection_);
+      out << IPCMessage{
+        MessageType::AttachSharedMemory,
+        QByteArray (IPC_SHARED_MEMORY_KEY)
+      };
+    }
 }
 
 void
@@ -122,6 +143,17 @@ AudioEngineApplication::onDataReceived ()
   IPCMessage  message;
   in >> message;
 
+  if (message.type_ == MessageType::Batch)
+    {
+      if (!parse_ipc_batch (message.data_, pending_updates_))
+        {
+          z_warning ("Received invalid update batch");
+          return;
+        }
+      coalesce_ipc_updates (pending_updates_);
+      return;
+    }
+
   qDebug () << "Received message:" << message.data_;
 }
 #endif
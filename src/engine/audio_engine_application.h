@@ -7,7 +7,9 @@
 #include <QLocalServer>
 #include <QLocalSocket>
 
+#include "engine/ipc_batch.h"
 #include "engine/ipc_message.h"
+#include "engine/ipc_shared_memory.h"
 #include "juce_wrapper.h"
 
 namespace zrythm::engine
@@ -58,5 +60,14 @@ private:
   QLocalServer *                    server_ = nullptr;
   QLocalSocket *                    client_connection_ = nullptr;
   std::unique_ptr<QCoreApplication> qt_app_;
+
+  /** High-rate channel to the GUI (the socket is used for the rest). */
+  std::unique_ptr<IPCSharedMemory> shared_memory_;
+
+  /**
+   * Updates received from the GUI and not applied yet, coalesced so that
+   * only the latest update to each target is kept.
+   */
+  std::vector<IPCUpdateRecord> pending_updates_;
 };
 }
\ No newline at end of file
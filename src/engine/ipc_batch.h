@@ -0,0 +1,244 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include <QByteArray>
+
+/**
+ * @brief Kind of update carried by an IPCUpdateRecord.
+ */
+enum class IPCUpdateType : uint32_t
+{
+  /** Sets parameter @ref IPCUpdateRecord::target_id_ to @ref
+   * IPCUpdateRecord::value_ (normalized). */
+  ParameterValue,
+
+  TransportPlay,
+  TransportStop,
+
+  /** Moves the playhead to @ref IPCUpdateRecord::value_ (in frames). */
+  TransportSeek,
+
+  /** Connects port @ref IPCUpdateRecord::target_id_ to port @ref
+   * IPCUpdateRecord::aux_id_. */
+  PortConnect,
+  PortDisconnect,
+};
+
+/**
+ * @brief A single update in an IPC batch.
+ *
+ * Plain data with a fixed layout so that batches can be copied to and from
+ * the wire as is.
+ */
+struct IPCUpdateRecord
+{
+  /**
+   * Sequence number, increasing with each update the sender creates.
+   *
+   * An update supersedes older (lower-numbered) updates to the same target
+   * (see coalesce_ipc_updates()).
+   */
+  uint64_t seq_ = 0;
+
+  /** Parameter or (source) port ID hash. Unused for transport updates. */
+  uint64_t target_id_ = 0;
+
+  /** Destination port ID hash for connection updates. */
+  uint64_t aux_id_ = 0;
+
+  double        value_ = 0.0;
+  IPCUpdateType type_ = IPCUpdateType::ParameterValue;
+  uint32_t      reserved_ = 0;
+};
+static_assert (std::is_trivially_copyable_v<IPCUpdateRecord>);
+static_assert (sizeof (IPCUpdateRecord) == 40);
+
+/**
+ * @brief Fixed header of the payload of a MessageType::Batch message,
+ * followed by @ref num_records_ IPCUpdateRecords.
+ */
+struct IPCBatchHeader
+{
+  static constexpr uint32_t MAGIC = 0x5a52'4254; // "ZRBT"
+  static constexpr uint16_t VERSION = 1;
+
+  uint32_t magic_ = MAGIC;
+  uint16_t version_ = VERSION;
+  uint16_t record_size_ = sizeof (IPCUpdateRecord);
+  uint32_t num_records_ = 0;
+  uint32_t reserved_ = 0;
+};
+static_assert (std::is_trivially_copyable_v<IPCBatchHeader>);
+
+/**
+ * @brief Builds the payload of a MessageType::Batch message.
+ *
+ * Assigns increasing sequence numbers to the updates added, across batches.
+ */
+class IPCBatchWriter
+{
+public:
+  void add_parameter_value (uint64_t param_id, double value)
+  {
+    add ({ .target_id_ = param_id,
+           .value_ = value,
+           .type_ = IPCUpdateType::ParameterValue });
+  }
+
+  void add_transport (IPCUpdateType type, double seek_frames = 0.0)
+  {
+    add ({ .value_ = seek_frames, .type_ = type });
+  }
+
+  void add_port_connection (uint64_t src_id, uint64_t dest_id, bool connect)
+  {
+    add ({ .target_id_ = src_id,
+           .aux_id_ = dest_id,
+           .type_ =
+             connect ? IPCUpdateType::PortConnect : IPCUpdateType::PortDisconnect });
+  }
+
+  bool empty () const { return records_.empty (); }
+
+  /**
+   * @brief Returns the payload with the updates added since the last call
+   * and clears them.
+   */
+  QByteArray take_payload ()
+  {
+    IPCBatchHeader header;
+    header.num_records_ = static_cast<uint32_t> (records_.size ());
+
+    QByteArray payload;
+    payload.resize (static_cast<qsizetype> (
+      sizeof (header) + records_.size () * sizeof (IPCUpdateRecord)));
+    std::memcpy (payload.data (), &header, sizeof (header));
+    if (!records_.empty ())
+      {
+        std::memcpy (
+          payload.data () + sizeof (header), records_.data (),
+          records_.size () * sizeof (IPCUpdateRecord));
+      }
+    records_.clear ();
+    return payload;
+  }
+
+private:
+  void add (IPCUpdateRecord record)
+  {
+    record.seq_ = next_seq_++;
+    records_.push_back (record);
+  }
+
+private:
+  std::vector<IPCUpdateRecord> records_;
+  uint64_t                     next_seq_ = 1;
+};
+
+/**
+ * @brief Parses the payload of a MessageType::Batch message and appends its
+ * updates to @p records.
+ *
+ * @return Whether the payload was valid (nothing is appended otherwise).
+ */
+inline bool
+parse_ipc_batch (const QByteArray &payload, std::vector<IPCUpdateRecord> &records)
+{
+  IPCBatchHeader header;
+  if (payload.size () < static_cast<qsizetype> (sizeof (header)))
+    return false;
+
+  std::memcpy (&header, payload.constData (), sizeof (header));
+  if (
+    header.magic_ != IPCBatchHeader::MAGIC
+    || header.version_ != IPCBatchHeader::VERSION
+    || header.record_size_ != sizeof (IPCUpdateRecord)
+    || static_cast<size_t> (payload.size ())
+         != sizeof (header) + header.num_records_ * sizeof (IPCUpdateRecord))
+    return false;
+
+  const auto old_size = records.size ();
+  records.resize (old_size + header.num_records_);
+  if (header.num_records_ > 0)
+    {
+      std::memcpy (
+        &records[old_size], payload.constData () + sizeof (header),
+        header.num_records_ * sizeof (IPCUpdateRecord));
+    }
+  return true;
+}
+
+/**
+ * @brief Removes the updates superseded by newer updates to the same target,
+ * keeping the rest in sequence order.
+ *
+ * Targets are: each parameter, the transport's play state, the playhead and
+ * each (source, destination) port pair.
+ */
+inline void
+coalesce_ipc_updates (std::vector<IPCUpdateRecord> &records)
+{
+  enum class TargetKind : uint64_t
+  {
+    Parameter,
+    PlayState,
+    Playhead,
+    Connection,
+  };
+  struct Target
+  {
+    TargetKind kind_;
+    uint64_t   id_;
+    uint64_t   aux_id_;
+    bool       operator== (const Target &) const = default;
+  };
+  struct TargetHash
+  {
+    size_t operator() (const Target &t) const
+    {
+      return std::hash<uint64_t>{}(t.id_) ^ (std::hash<uint64_t>{}(t.aux_id_) << 1)
+             ^ (static_cast<size_t> (t.kind_) << 2);
+    }
+  };
+
+  const auto get_target = [] (const IPCUpdateRecord &r) -> Target {
+    switch (r.type_)
+      {
+      case IPCUpdateType::ParameterValue:
+        return { TargetKind::Parameter, r.target_id_, 0 };
+      case IPCUpdateType::TransportPlay:
+      case IPCUpdateType::TransportStop:
+        return { TargetKind::PlayState, 0, 0 };
+      case IPCUpdateType::TransportSeek:
+        return { TargetKind::Playhead, 0, 0 };
+      case IPCUpdateType::PortConnect:
+      case IPCUpdateType::PortDisconnect:
+        return { TargetKind::Connection, r.target_id_, r.aux_id_ };
+      }
+    return { TargetKind::Parameter, r.target_id_, 0 };
+  };
+
+  std::ranges::stable_sort (records, {}, &IPCUpdateRecord::seq_);
+
+  /* latest sequence number per target */
+  std::unordered_map<Target, uint64_t, TargetHash> latest;
+  latest.reserve (records.size ());
+  for (const auto &r : records)
+    {
+      latest[get_target (r)] = r.seq_;
+    }
+
+  std::erase_if (records, [&] (const IPCUpdateRecord &r) {
+    return latest.at (get_target (r)) != r.seq_;
+  });
+}
@@ -14,7 +14,19 @@ enum class MessageType
   Play,
   Stop,
   GetStatus,
-  StatusUpdate
+  StatusUpdate,
+
+  /**
+   * Sent by the engine once connected: the GUI should attach to the shared
+   * memory (see IPCSharedMemory) named in the data.
+   */
+  AttachSharedMemory,
+
+  /**
+   * Sent by the GUI: a batch of parameter, transport and port connection
+   * updates (see IPCBatchHeader).
+   */
+  Batch,
 };
 
 struct IPCMessage
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <new>
+
+#include <QSharedMemory>
+
+#include "utils/exceptions.h"
+#include "utils/fixed_spsc_ring.h"
+#include "utils/format.h"
+
+constexpr const char * IPC_SHARED_MEMORY_KEY = "ZrythmEngineSharedMemory";
+
+/**
+ * @brief Parameter change sent from the GUI to the engine.
+ */
+struct IPCParameterChange
+{
+  /** Hash of the parameter (port) ID. */
+  uint64_t param_id_ = 0;
+
+  /** Normalized value. */
+  float value_ = 0.f;
+};
+
+/**
+ * @brief Meter values of a port sent from the engine to the GUI.
+ */
+struct IPCMeterSnapshot
+{
+  /** Hash of the port ID. */
+  uint64_t port_id_ = 0;
+
+  float peak_ = 0.f;
+  float rms_ = 0.f;
+};
+
+/**
+ * @brief Transport state sent from the engine to the GUI every cycle.
+ */
+struct IPCTransportState
+{
+  int64_t playhead_frames_ = 0;
+  double  bpm_ = 0.0;
+  bool    rolling_ = false;
+  bool    recording_ = false;
+};
+
+/**
+ * @brief Layout of the memory shared between the GUI and the engine process.
+ *
+ * Each ring has a single producer (the engine's audio thread or the GUI
+ * thread) and a single consumer, so neither side ever blocks on the other.
+ */
+struct IPCSharedMemoryLayout
+{
+  static constexpr uint32_t MAGIC = 0x5a52'5348; // "ZRSH"
+  static constexpr uint32_t VERSION = 1;
+
+  uint32_t magic_ = MAGIC;
+  uint32_t version_ = VERSION;
+
+  /** GUI -> engine. */
+  zrythm::utils::FixedSpscRing<IPCParameterChange, 4096> parameter_changes_;
+
+  /** Engine -> GUI. */
+  zrythm::utils::FixedSpscRing<IPCMeterSnapshot, 4096> meter_snapshots_;
+
+  /** Engine -> GUI (only the latest state matters - see pop_latest()). */
+  zrythm::utils::FixedSpscRing<IPCTransportState, 64> transport_states_;
+};
+
+/**
+ * @brief Shared-memory channel between the GUI and the engine process, for
+ * high-rate data (parameter changes, meters, transport state).
+ *
+ * The local socket (see IPCMessage) is only used for setup and rare commands.
+ * The engine creates the channel before accepting connections and the GUI
+ * attaches to it once connected.
+ */
+class IPCSharedMemory
+{
+public:
+  /**
+   * @brief Creates the shared memory (engine side).
+   *
+   * @throw ZrythmException on failure.
+   */
+  static std::unique_ptr<IPCSharedMemory> create ()
+  {
+    auto ret = std::unique_ptr<IPCSharedMemory> (
+      new IPCSharedMemory (QString::fromUtf8 (IPC_SHARED_MEMORY_KEY)));
+    constexpr auto size = sizeof (IPCSharedMemoryLayout);
+    if (!ret->shm_.create (size))
+      {
+        /* a previous engine may have crashed without releasing it (on unix
+         * systems) - attaching and detaching releases it */
+        const bool recreated =
+          ret->shm_.error () == QSharedMemory::AlreadyExists
+          && ret->shm_.attach () && ret->shm_.detach ()
+          && ret->shm_.create (size);
+        if (!recreated)
+          {
+            throw ZrythmException (format_str (
+              "Failed to create shared memory: {}", ret->shm_.errorString ()));
+          }
+      }
+    ret->layout_ = new (ret->shm_.data ()) IPCSharedMemoryLayout ();
+    return ret;
+  }
+
+  /**
+   * @brief Attaches to the shared memory created by the engine (GUI side).
+   *
+   * @param key Key sent by the engine (see MessageType::AttachSharedMemory).
+   * @throw ZrythmException on failure or if the layout doesn't match.
+   */
+  static std::unique_ptr<IPCSharedMemory> attach (const QString &key)
+  {
+    auto ret = std::unique_ptr<IPCSharedMemory> (new IPCSharedMemory (key));
+    if (!ret->shm_.attach ())
+      {
+        throw ZrythmException (format_str (
+          "Failed to attach to shared memory: {}", ret->shm_.errorString ()));
+      }
+    if (
+      ret->shm_.size ()
+      < static_cast<qsizetype> (sizeof (IPCSharedMemoryLayout)))
+      {
+        throw ZrythmException ("Shared memory is too small");
+      }
+    ret->layout_ =
+      std::launder (static_cast<IPCSharedMemoryLayout *> (ret->shm_.data ()));
+    if (
+      ret->layout_->magic_ != IPCSharedMemoryLayout::MAGIC
+      || ret->layout_->version_ != IPCSharedMemoryLayout::VERSION)
+      {
+        throw ZrythmException ("Shared memory layout mismatch");
+      }
+    return ret;
+  }
+
+  IPCSharedMemoryLayout &layout () { return *layout_; }
+
+private:
+  explicit IPCSharedMemory (const QString &key) : shm_ (key) { }
+
+private:
+  QSharedMemory           shm_;
+  IPCSharedMemoryLayout * layout_ = nullptr;
+};
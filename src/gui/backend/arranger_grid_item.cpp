@@ -0,0 +1,261 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/backend/arranger_grid_item.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+
+using namespace zrythm::gui;
+
+namespace
+{
+enum class LineKind
+{
+  Bar,
+  Beat,
+  Sixteenth,
+};
+
+constexpr size_t NUM_LINE_KINDS = 3;
+
+QSGGeometryNode *
+create_lines_node ()
+{
+  auto * geometry =
+    new QSGGeometry (QSGGeometry::defaultAttributes_Point2D (), 0);
+  geometry->setDrawingMode (QSGGeometry::DrawTriangles);
+  auto * node = new QSGGeometryNode ();
+  node->setGeometry (geometry);
+  node->setFlag (QSGNode::OwnsGeometry);
+  node->setMaterial (new QSGFlatColorMaterial ());
+  node->setFlag (QSGNode::OwnsMaterial);
+  return node;
+}
+}
+
+ArrangerGridItem::ArrangerGridItem (QQuickItem * parent) : QQuickItem (parent)
+{
+  setFlag (QQuickItem::ItemHasContents);
+}
+
+void
+ArrangerGridItem::setPxPerSixteenth (double px)
+{
+  if (qFuzzyCompare (px_per_sixteenth_, px))
+    return;
+
+  px_per_sixteenth_ = px;
+  Q_EMIT pxPerSixteenthChanged ();
+  invalidate ();
+}
+
+void
+ArrangerGridItem::setDetailMeasurePxThreshold (double px)
+{
+  if (qFuzzyCompare (detail_threshold_, px))
+    return;
+
+  detail_threshold_ = px;
+  Q_EMIT detailMeasurePxThresholdChanged ();
+  invalidate ();
+}
+
+void
+ArrangerGridItem::setVisibleX (double x)
+{
+  if (qFuzzyCompare (visible_x_, x))
+    return;
+
+  visible_x_ = x;
+  Q_EMIT visibleXChanged ();
+  update_range ();
+}
+
+void
+ArrangerGridItem::setVisibleWidth (double width)
+{
+  if (qFuzzyCompare (visible_width_, width))
+    return;
+
+  visible_width_ = width;
+  Q_EMIT visibleWidthChanged ();
+  update_range ();
+}
+
+void
+ArrangerGridItem::setColor (const QColor &color)
+{
+  if (color_ == color)
+    return;
+
+  color_ = color;
+  Q_EMIT colorChanged ();
+  update ();
+}
+
+void
+ArrangerGridItem::setBarLineOpacity (double opacity)
+{
+  if (qFuzzyCompare (bar_line_opacity_, opacity))
+    return;
+
+  bar_line_opacity_ = opacity;
+  Q_EMIT colorChanged ();
+  update ();
+}
+
+void
+ArrangerGridItem::setBeatLineOpacity (double opacity)
+{
+  if (qFuzzyCompare (beat_line_opacity_, opacity))
+    return;
+
+  beat_line_opacity_ = opacity;
+  Q_EMIT colorChanged ();
+  update ();
+}
+
+void
+ArrangerGridItem::setSixteenthLineOpacity (double opacity)
+{
+  if (qFuzzyCompare (sixteenth_line_opacity_, opacity))
+    return;
+
+  sixteenth_line_opacity_ = opacity;
+  Q_EMIT colorChanged ();
+  update ();
+}
+
+void
+ArrangerGridItem::invalidate ()
+{
+  lines_dirty_ = true;
+  update ();
+}
+
+void
+ArrangerGridItem::update_range ()
+{
+  /* the drawn range stops at the item's bounds */
+  const double start_x = std::max (0.0, visible_x_);
+  const double end_x = std::min (width (), visible_x_ + visible_width_);
+  if (start_x < drawn_start_x_ || end_x > drawn_end_x_)
+    {
+      invalidate ();
+    }
+}
+
+void
+ArrangerGridItem::geometryChange (
+  const QRectF &new_geometry,
+  const QRectF &old_geometry)
+{
+  QQuickItem::geometryChange (new_geometry, old_geometry);
+  if (new_geometry.size () != old_geometry.size ())
+    invalidate ();
+}
+
+QSGNode *
+ArrangerGridItem::updatePaintNode (QSGNode * old_node, UpdatePaintNodeData *)
+{
+  auto * node = old_node;
+  if (px_per_sixteenth_ <= 0.0 || width () <= 0 || height () <= 0)
+    {
+      delete node;
+      return nullptr;
+    }
+
+  /* one child per line kind */
+  if (!node)
+    {
+      node = new QSGNode ();
+      for (size_t i = 0; i < NUM_LINE_KINDS; ++i)
+        {
+          node->appendChildNode (create_lines_node ());
+        }
+      lines_dirty_ = true;
+    }
+  const auto get_lines_node = [node] (LineKind kind) {
+    return static_cast<QSGGeometryNode *> (
+      node->childAtIndex (static_cast<int> (kind)));
+  };
+
+  const std::array<double, NUM_LINE_KINDS> opacities = {
+    bar_line_opacity_, beat_line_opacity_, sixteenth_line_opacity_
+  };
+  for (size_t i = 0; i < NUM_LINE_KINDS; ++i)
+    {
+      auto * lines_node = get_lines_node (static_cast<LineKind> (i));
+      auto   color = color_;
+      color.setAlphaF (static_cast<float> (color.alphaF () * opacities[i]));
+      auto * material =
+        static_cast<QSGFlatColorMaterial *> (lines_node->material ());
+      if (material->color () != color)
+        {
+          material->setColor (color);
+          lines_node->markDirty (QSGNode::DirtyMaterial);
+        }
+    }
+
+  if (!lines_dirty_)
+    return node;
+
+  /* draw the visible part and a viewport on each side of it, so that
+   * scrolling doesn't need to rebuild the lines until it goes past them */
+  drawn_start_x_ = std::max (0.0, visible_x_ - visible_width_);
+  drawn_end_x_ = std::min (width (), visible_x_ + visible_width_ * 2.0);
+
+  /* only draw the lines that are far enough apart */
+  const double px_per_beat = px_per_sixteenth_ * SIXTEENTHS_PER_BEAT;
+  int          step = 1;
+  if (px_per_beat <= detail_threshold_)
+    step = SIXTEENTHS_PER_BEAT * BEATS_PER_BAR;
+  else if (px_per_sixteenth_ <= detail_threshold_)
+    step = SIXTEENTHS_PER_BEAT;
+
+  const auto first =
+    static_cast<int64_t> (std::ceil (drawn_start_x_ / px_per_sixteenth_ / step))
+    * step;
+  const auto last = static_cast<int64_t> (drawn_end_x_ / px_per_sixteenth_);
+
+  /* 2 triangles per line */
+  std::array<std::vector<QSGGeometry::Point2D>, NUM_LINE_KINDS> vertices;
+  const auto height_f = static_cast<float> (height ());
+  for (auto i = first; i <= last; i += step)
+    {
+      auto kind = LineKind::Sixteenth;
+      if (i % (SIXTEENTHS_PER_BEAT * BEATS_PER_BAR) == 0)
+        kind = LineKind::Bar;
+      else if (i % SIXTEENTHS_PER_BEAT == 0)
+        kind = LineKind::Beat;
+
+      const auto left =
+        static_cast<float> (static_cast<double> (i) * px_per_sixteenth_);
+      const auto right = left + 1.f;
+      auto      &kind_vertices = vertices[static_cast<size_t> (kind)];
+      kind_vertices.push_back ({ left, 0.f });
+      kind_vertices.push_back ({ right, 0.f });
+      kind_vertices.push_back ({ left, height_f });
+      kind_vertices.push_back ({ right, 0.f });
+      kind_vertices.push_back ({ right, height_f });
+      kind_vertices.push_back ({ left, height_f });
+    }
+
+  for (size_t i = 0; i < NUM_LINE_KINDS; ++i)
+    {
+      auto * lines_node = get_lines_node (static_cast<LineKind> (i));
+      auto * geometry = lines_node->geometry ();
+      geometry->allocate (static_cast<int> (vertices[i].size ()));
+      std::ranges::copy (vertices[i], geometry->vertexDataAsPoint2D ());
+      lines_node->markDirty (QSGNode::DirtyGeometry);
+    }
+  lines_dirty_ = false;
+
+  return node;
+}
@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <QColor>
+#include <QQuickItem>
+#include <QtQmlIntegration>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Draws the bar, beat and sixteenth lines of an arranger's background.
+ *
+ * The lines are drawn with one scene graph node per kind of line (instead of
+ * an item per line), for a range around the visible part of the arranger.
+ * The geometry is only rebuilt when zooming, resizing, or scrolling out of
+ * that range, so redrawing the arranger for moving parts (e.g. the playhead
+ * during playback) doesn't touch the grid.
+ */
+class ArrangerGridItem : public QQuickItem
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (
+    double pxPerSixteenth READ pxPerSixteenth WRITE setPxPerSixteenth NOTIFY
+      pxPerSixteenthChanged)
+  Q_PROPERTY (
+    double detailMeasurePxThreshold READ detailMeasurePxThreshold WRITE
+      setDetailMeasurePxThreshold NOTIFY detailMeasurePxThresholdChanged)
+  Q_PROPERTY (
+    double visibleX READ visibleX WRITE setVisibleX NOTIFY visibleXChanged)
+  Q_PROPERTY (
+    double visibleWidth READ visibleWidth WRITE setVisibleWidth NOTIFY
+      visibleWidthChanged)
+  Q_PROPERTY (QColor color READ color WRITE setColor NOTIFY colorChanged)
+  Q_PROPERTY (
+    double barLineOpacity READ barLineOpacity WRITE setBarLineOpacity NOTIFY
+      colorChanged)
+  Q_PROPERTY (
+    double beatLineOpacity READ beatLineOpacity WRITE setBeatLineOpacity NOTIFY
+      colorChanged)
+  Q_PROPERTY (
+    double sixteenthLineOpacity READ sixteenthLineOpacity WRITE
+      setSixteenthLineOpacity NOTIFY colorChanged)
+
+public:
+  static constexpr int SIXTEENTHS_PER_BEAT = 4;
+  static constexpr int BEATS_PER_BAR = 4;
+
+  explicit ArrangerGridItem (QQuickItem * parent = nullptr);
+
+  double pxPerSixteenth () const { return px_per_sixteenth_; }
+  void   setPxPerSixteenth (double px);
+
+  /**
+   * Beat and sixteenth lines are only drawn when they are further apart than
+   * this.
+   */
+  double detailMeasurePxThreshold () const { return detail_threshold_; }
+  void   setDetailMeasurePxThreshold (double px);
+
+  /** Start of the visible part of the arranger, in item coordinates. */
+  double visibleX () const { return visible_x_; }
+  void   setVisibleX (double x);
+
+  double visibleWidth () const { return visible_width_; }
+  void   setVisibleWidth (double width);
+
+  QColor color () const { return color_; }
+  void   setColor (const QColor &color);
+
+  double barLineOpacity () const { return bar_line_opacity_; }
+  void   setBarLineOpacity (double opacity);
+
+  double beatLineOpacity () const { return beat_line_opacity_; }
+  void   setBeatLineOpacity (double opacity);
+
+  double sixteenthLineOpacity () const { return sixteenth_line_opacity_; }
+  void   setSixteenthLineOpacity (double opacity);
+
+Q_SIGNALS:
+  void pxPerSixteenthChanged ();
+  void detailMeasurePxThresholdChanged ();
+  void visibleXChanged ();
+  void visibleWidthChanged ();
+  void colorChanged ();
+
+protected:
+  QSGNode *
+  updatePaintNode (QSGNode * old_node, UpdatePaintNodeData * data) override;
+
+  void
+  geometryChange (const QRectF &new_geometry, const QRectF &old_geometry)
+    override;
+
+private:
+  /**
+   * @brief Schedules rebuilding the lines.
+   */
+  void invalidate ();
+
+  /**
+   * @brief Schedules rebuilding the lines if the visible part is no longer in
+   * the drawn range.
+   */
+  void update_range ();
+
+private:
+  double px_per_sixteenth_ = 0.0;
+  double detail_threshold_ = 32.0;
+  double visible_x_ = 0.0;
+  double visible_width_ = 0.0;
+  QColor color_ = Qt::gray;
+  double bar_line_opacity_ = 0.8;
+  double beat_line_opacity_ = 0.6;
+  double sixteenth_line_opacity_ = 0.4;
+
+  /** Whether the lines must be rebuilt on the next update. */
+  bool lines_dirty_ = true;
+
+  /** Range the lines are drawn for, in item coordinates. */
+  double drawn_start_x_ = 0.0;
+  double drawn_end_x_ = 0.0;
+};
+
+} // namespace zrythm::gui
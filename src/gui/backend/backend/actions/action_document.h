@@ -0,0 +1,36 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UNDO_ACTION_DOCUMENT_H__
+#define __UNDO_ACTION_DOCUMENT_H__
+
+#include "gui/backend/backend/actions/undoable_action_all.h"
+
+#include "utils/iserializable.h"
+
+namespace zrythm::gui::actions
+{
+
+/**
+ * @brief Root document for serializing a single action on its own (actions
+ * are otherwise only serialized as part of an UndoStack).
+ */
+class ActionDocument final
+    : public zrythm::utils::serialization::ISerializable<ActionDocument>
+{
+public:
+  std::string get_document_type () const override
+  {
+    return "ZrythmActionDocument";
+  }
+
+  DECLARE_DEFINE_FIELDS_METHOD ();
+
+public:
+  /** A single action (not owned). */
+  std::vector<UndoableActionPtrVariant> actions_;
+};
+
+}; // namespace zrythm::gui::actions
+
+#endif
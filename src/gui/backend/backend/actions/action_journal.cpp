@@ -0,0 +1,372 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cstring>
+
+#include "gui/backend/backend/actions/action_journal.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSaveFile>
+
+namespace fs = std::filesystem;
+
+using namespace zrythm::gui::actions;
+
+namespace
+{
+constexpr char     JOURNAL_MAGIC[4] = { 'Z', 'A', 'J', 'N' };
+constexpr uint32_t JOURNAL_VERSION = 2;
+
+/** Type byte + payload size. */
+constexpr size_t RECORD_HEADER_SIZE = 1 + 4;
+
+void
+append_le (std::string &out, uint64_t val, int num_bytes)
+{
+  for (int i = 0; i < num_bytes; ++i)
+    {
+      out.push_back (static_cast<char> ((val >> (i * 8)) & 0xFF));
+    }
+}
+
+uint64_t
+read_le (const char * data, int num_bytes)
+{
+  uint64_t val = 0;
+  for (int i = 0; i < num_bytes; ++i)
+    {
+      val |= static_cast<uint64_t> (static_cast<uint8_t> (data[i])) << (i * 8);
+    }
+  return val;
+}
+}
+
+ActionJournal::ActionJournal (fs::path path, const fs::path &base_file)
+    : path_ (std::move (path))
+{
+  auto records = read_records (base_file);
+  if (records.has_value ())
+    {
+      num_records_ = records->size ();
+      pending_records_ = std::move (*records);
+
+      /* drop any partially written record */
+      if (
+        QFileInfo (path_).size () != static_cast<qint64> (size_)
+        && !QFile::resize (path_, static_cast<qint64> (size_)))
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to truncate action journal {}", path_.string ()));
+        }
+
+      file_ = std::make_unique<QFile> (path_);
+      if (!file_->open (QIODevice::WriteOnly | QIODevice::Append))
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to open action journal {}: {}", path_.string (),
+            file_->errorString ()));
+        }
+
+      z_info (
+        "opened action journal {} with {} records to replay", path_.string (),
+        num_records_);
+    }
+  else
+    {
+      write_file (create_header (base_file), {});
+      num_records_ = 0;
+      z_debug (
+        "started action journal {} based on {}", path_.string (),
+        base_file.string ());
+    }
+}
+
+ActionJournal::~ActionJournal () = default;
+
+std::string
+ActionJournal::create_header (const fs::path &base_file) const
+{
+  const QFileInfo base_info (base_file);
+  const auto      base_rel_path =
+    QDir (path_.parent_path ())
+      .relativeFilePath (base_info.absoluteFilePath ())
+      .toStdString ();
+
+  std::string header (JOURNAL_MAGIC, sizeof (JOURNAL_MAGIC));
+  append_le (header, JOURNAL_VERSION, 4);
+  append_le (header, static_cast<uint64_t> (base_info.size ()), 8);
+  append_le (
+    header,
+    static_cast<uint64_t> (base_info.lastModified ().toMSecsSinceEpoch ()), 8);
+  append_le (header, base_rel_path.size (), 4);
+  header.append (base_rel_path);
+  return header;
+}
+
+std::optional<std::vector<ActionJournal::Record>>
+ActionJournal::read_records (const fs::path &base_file)
+{
+  QFile file (path_);
+  if (!file.exists () || !QFileInfo::exists (base_file))
+    return std::nullopt;
+
+  if (!file.open (QIODevice::ReadOnly))
+    {
+      z_warning (
+        "Failed to open action journal {}: {}", path_.string (),
+        file.errorString ());
+      return std::nullopt;
+    }
+  const auto data = file.readAll ();
+
+  /* the header must match the one the snapshot would get now */
+  const auto header = create_header (base_file);
+  if (
+    static_cast<size_t> (data.size ()) < header.size ()
+    || std::memcmp (data.constData (), header.data (), header.size ()) != 0)
+    {
+      z_info (
+        "action journal {} is not based on {} - discarding it", path_.string (),
+        base_file.string ());
+      return std::nullopt;
+    }
+
+  std::vector<Record> records;
+  size_t              pos = header.size ();
+  const auto          data_size = static_cast<size_t> (data.size ());
+  while (data_size - pos >= RECORD_HEADER_SIZE)
+    {
+      const auto type =
+        static_cast<uint8_t> (data.at (static_cast<qsizetype> (pos)));
+      const auto payload_size = read_le (data.constData () + pos + 1, 4);
+      if (
+        type > static_cast<uint8_t> (RecordType::Redo)
+        || payload_size > data_size - pos - RECORD_HEADER_SIZE)
+        {
+          break;
+        }
+
+      records.push_back (Record{
+        .type_ = static_cast<RecordType> (type),
+        .data_ = std::string (
+          data.constData () + pos + RECORD_HEADER_SIZE, payload_size),
+        .offset_ = pos,
+      });
+      pos += RECORD_HEADER_SIZE + payload_size;
+    }
+
+  if (pos != data_size)
+    {
+      z_warning (
+        "discarding {} bytes of incomplete records at the end of action "
+        "journal {}",
+        data_size - pos, path_.string ());
+    }
+
+  header_size_ = header.size ();
+  size_ = pos;
+  return records;
+}
+
+void
+ActionJournal::write_file (
+  const std::string &header,
+  const std::string &records_data)
+{
+  file_.reset ();
+
+  QSaveFile save_file (path_);
+  if (
+    !save_file.open (QIODevice::WriteOnly)
+    || save_file.write (header.data (), static_cast<qint64> (header.size ()))
+         != static_cast<qint64> (header.size ())
+    || save_file.write (
+         records_data.data (), static_cast<qint64> (records_data.size ()))
+         != static_cast<qint64> (records_data.size ())
+    || !save_file.commit ())
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to write action journal {}: {}", path_.string (),
+        save_file.errorString ()));
+    }
+
+  file_ = std::make_unique<QFile> (path_);
+  if (!file_->open (QIODevice::WriteOnly | QIODevice::Append))
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to open action journal {}: {}", path_.string (),
+        file_->errorString ()));
+    }
+
+  header_size_ = header.size ();
+  size_ = header.size () + records_data.size ();
+}
+
+UndoableActionPtrVariant
+ActionJournal::deserialize_action (const Record &record)
+{
+  z_return_val_if_fail (record.type_ == RecordType::Perform, {});
+
+  ActionDocument doc;
+  doc.deserialize_from_binary (record.data_);
+  if (doc.actions_.size () != 1)
+    {
+      throw ZrythmException (fmt::format (
+        "Invalid action journal entry with {} actions", doc.actions_.size ()));
+    }
+  return doc.actions_.front ();
+}
+
+void
+ActionJournal::append_perform (const UndoableActionPtrVariant &action)
+{
+  if (invalid_)
+    return;
+
+  ActionDocument doc;
+  doc.actions_.push_back (action);
+  std::string data;
+  try
+    {
+      data = doc.serialize_to_binary ();
+    }
+  catch (const ZrythmException &e)
+    {
+      invalidate (e.what ());
+      return;
+    }
+  append (RecordType::Perform, data);
+}
+
+void
+ActionJournal::append (RecordType type, const std::string &data)
+{
+  if (invalid_)
+    return;
+
+  std::string record;
+  record.reserve (RECORD_HEADER_SIZE + data.size ());
+  record.push_back (static_cast<char> (type));
+  append_le (record, data.size (), 4);
+  record.append (data);
+
+  /* flush so that the record survives a crash of the application */
+  if (
+    !file_
+    || file_->write (record.data (), static_cast<qint64> (record.size ()))
+         != static_cast<qint64> (record.size ())
+    || !file_->flush ())
+    {
+      invalidate (
+        file_ ? file_->errorString ().toStdString () : "journal not open");
+      return;
+    }
+
+  size_ += record.size ();
+  ++num_records_;
+}
+
+void
+ActionJournal::invalidate (const std::string &reason)
+{
+  z_warning (
+    "Failed to append to action journal {} ({}): recent changes can't be "
+    "recovered until the project is saved",
+    path_.string (), reason);
+  invalid_ = true;
+}
+
+void
+ActionJournal::rebase (const fs::path &base_file, const Checkpoint &checkpoint)
+{
+  z_return_if_fail (
+    checkpoint.offset_ >= header_size_ && checkpoint.offset_ <= size_);
+
+  /* records appended after the snapshot was taken */
+  std::string tail;
+  if (checkpoint.offset_ < size_)
+    {
+      QFile file (path_);
+      if (
+        !file.open (QIODevice::ReadOnly)
+        || !file.seek (static_cast<qint64> (checkpoint.offset_)))
+        {
+          z_warning (
+            "Failed to read action journal {}: {}", path_.string (),
+            file.errorString ());
+          return;
+        }
+      tail = file.readAll ().toStdString ();
+    }
+
+  size_t num_tail_records = 0;
+  for (size_t pos = 0; pos + RECORD_HEADER_SIZE <= tail.size ();)
+    {
+      pos += RECORD_HEADER_SIZE + read_le (tail.data () + pos + 1, 4);
+      ++num_tail_records;
+    }
+
+  try
+    {
+      write_file (create_header (base_file), tail);
+    }
+  catch (const ZrythmException &e)
+    {
+      invalidate (e.what ());
+      return;
+    }
+
+  num_records_ = num_tail_records;
+  compaction_requested_ = false;
+
+  /* resume appending if it failed before the snapshot was taken (the snapshot
+   * contains all the changes), otherwise records are still missing */
+  if (invalid_ && !checkpoint.valid_)
+    {
+      invalid_ = false;
+    }
+
+  z_debug (
+    "rebased action journal on {} ({} records kept)", base_file.string (),
+    num_records_);
+}
+
+void
+ActionJournal::truncate (size_t offset)
+{
+  z_return_if_fail (offset >= header_size_ && offset <= size_);
+
+  file_.reset ();
+  if (!QFile::resize (path_, static_cast<qint64> (offset)))
+    {
+      invalidate ("failed to truncate");
+      return;
+    }
+  file_ = std::make_unique<QFile> (path_);
+  if (!file_->open (QIODevice::WriteOnly | QIODevice::Append))
+    {
+      invalidate (file_->errorString ().toStdString ());
+      return;
+    }
+  size_ = offset;
+}
+
+bool
+ActionJournal::should_request_compaction ()
+{
+  if (compaction_requested_)
+    return false;
+
+  if (
+    invalid_ || num_records_ >= COMPACTION_RECORD_COUNT
+    || size_ >= COMPACTION_SIZE)
+    {
+      compaction_requested_ = true;
+      return true;
+    }
+  return false;
+}
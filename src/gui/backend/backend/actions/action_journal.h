@@ -0,0 +1,189 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UNDO_ACTION_JOURNAL_H__
+#define __UNDO_ACTION_JOURNAL_H__
+
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gui/backend/backend/actions/action_document.h"
+
+class QFile;
+
+namespace zrythm::gui::actions
+{
+
+/**
+ * @brief Append-only log of the actions applied to a project since one of its
+ * snapshots (the project file or a backup) was saved.
+ *
+ * Each performed action is appended in the binary serialization format, and
+ * undo/redo are appended as markers, right after they are applied. Loading
+ * the snapshot and replaying the journal on top of it restores the project
+ * without having to save the whole project after every change.
+ *
+ * When a new snapshot is saved, the journal is rebased on it (see rebase()),
+ * keeping only the records applied after the snapshot was taken.
+ *
+ * The file starts with a header identifying the snapshot (its path relative
+ * to the journal and its size and modification time), followed by records
+ * made of a type byte, a 32-bit little-endian payload size and the payload.
+ * A record that was only partially written (e.g., because of a crash) is
+ * discarded when the journal is opened.
+ */
+class ActionJournal final
+{
+public:
+  enum class RecordType : uint8_t
+  {
+    Perform = 0,
+    Undo,
+    Redo,
+  };
+
+  struct Record
+  {
+    RecordType type_;
+
+    /** Serialized action for RecordType::Perform, empty otherwise. */
+    std::string data_;
+
+    /** Offset of the record in the file. */
+    size_t offset_;
+  };
+
+  /** Number of records after which compaction is requested. */
+  static constexpr size_t COMPACTION_RECORD_COUNT = 256;
+
+  /** Size of the journal after which compaction is requested. */
+  static constexpr size_t COMPACTION_SIZE = 32 * 1024 * 1024;
+
+  /**
+   * @brief Opens or creates the journal at @p path.
+   *
+   * If the journal exists and is based on @p base_file as it currently is on
+   * disk, its records are kept to be replayed (see take_pending_records()).
+   * Otherwise, a new journal based on @p base_file is started.
+   *
+   * @throw ZrythmException If the journal could not be written.
+   */
+  ActionJournal (
+    std::filesystem::path        path,
+    const std::filesystem::path &base_file);
+  ~ActionJournal ();
+  Z_DISABLE_COPY_MOVE (ActionJournal)
+
+  const std::filesystem::path &get_path () const { return path_; }
+
+  /**
+   * @brief Returns the records found when the journal was opened, in order.
+   */
+  std::vector<Record> take_pending_records ()
+  {
+    return std::move (pending_records_);
+  }
+
+  /**
+   * @brief Creates the action serialized in a RecordType::Perform record.
+   *
+   * @note The caller takes ownership of the action.
+   * @throw ZrythmException If the record could not be deserialized.
+   */
+  static UndoableActionPtrVariant deserialize_action (const Record &record);
+
+  /**
+   * @brief Appends a performed action.
+   *
+   * Errors are logged and stop the journal until a snapshot taken after the
+   * failure is saved, since a journal with missing records can't be
+   * replayed.
+   */
+  void append_perform (const UndoableActionPtrVariant &action);
+  void append_undo () { append (RecordType::Undo, {}); }
+  void append_redo () { append (RecordType::Redo, {}); }
+
+  /**
+   * @brief Position in the journal when a snapshot is taken.
+   */
+  struct Checkpoint
+  {
+    size_t offset_ = 0;
+
+    /** Whether no records were lost before the snapshot. */
+    bool valid_ = false;
+  };
+
+  /**
+   * @brief Returns the current position, to be passed to rebase() once the
+   * snapshot taken now is saved.
+   */
+  Checkpoint checkpoint () const { return { size_, !invalid_ }; }
+
+  /**
+   * @brief Restarts the journal based on @p base_file, keeping the records
+   * appended after @p checkpoint.
+   */
+  void
+  rebase (const std::filesystem::path &base_file, const Checkpoint &checkpoint);
+
+  /**
+   * @brief Drops the records from @p offset onward (e.g., after failing to
+   * replay the record at @p offset).
+   */
+  void truncate (size_t offset);
+
+  /**
+   * @brief Returns true once when the journal grew large enough (or was
+   * invalidated) that a new snapshot should be saved.
+   */
+  bool should_request_compaction ();
+
+private:
+  std::string create_header (const std::filesystem::path &base_file) const;
+
+  /**
+   * @brief Reads the journal and returns the records, or std::nullopt if it
+   * is not based on @p base_file.
+   */
+  std::optional<std::vector<Record>>
+  read_records (const std::filesystem::path &base_file);
+
+  /**
+   * @brief Replaces the journal with @p header followed by @p records_data.
+   */
+  void write_file (const std::string &header, const std::string &records_data);
+
+  void append (RecordType type, const std::string &data);
+
+  void invalidate (const std::string &reason);
+
+private:
+  std::filesystem::path  path_;
+  std::unique_ptr<QFile> file_;
+  std::vector<Record>    pending_records_;
+
+  /** Size of the header. */
+  size_t header_size_ = 0;
+
+  /** Current size of the file. */
+  size_t size_ = 0;
+
+  size_t num_records_ = 0;
+
+  /**
+   * Whether appending failed. Records are no longer appended until a
+   * snapshot taken after the failure is saved, so that the journal remains a
+   * valid (partial) history.
+   */
+  bool invalid_ = false;
+
+  bool compaction_requested_ = false;
+};
+
+}; // namespace zrythm::gui::actions
+
+#endif
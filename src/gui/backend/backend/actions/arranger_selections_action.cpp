@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: © 2019-2025 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <unordered_map>
+#include <unordered_set>
+
 #include "dsp/port_identifier.h"
 #include "gui/backend/backend/actions/arranger_selections_action.h"
 #include "gui/backend/backend/project.h"
@@ -13,6 +16,7 @@
 #include "gui/dsp/control_port.h"
 #include "gui/dsp/laned_track.h"
 #include "gui/dsp/marker_track.h"
+#include "gui/dsp/region_link_group.h"
 #include "gui/dsp/router.h"
 #include "gui/dsp/track.h"
 #include "gui/dsp/tracklist.h"
@@ -109,6 +113,12 @@ ArrangerSelectionsAction::init_after_cloning (
         other.region_after_.value ());
     }
   resize_type_ = other.resize_type_;
+  note_ids_ = other.note_ids_;
+  notes_before_ = other.notes_before_;
+  notes_after_ = other.notes_after_;
+  automation_point_ids_ = other.automation_point_ids_;
+  automation_points_before_ = other.automation_points_before_;
+  automation_points_after_ = other.automation_points_after_;
 }
 
 ArrangerObjectRegistry &
@@ -200,6 +210,25 @@ ArrangerSelectionsAction::needs_transport_total_bar_update (bool perform) const
   return true;
 }
 
+void
+ArrangerSelectionsAction::update_transport_total_bars (bool perform) const
+{
+  /* these actions only add, remove or change the objects in the selections
+   * without changing their IDs, so only those objects need to be checked */
+  const bool keeps_ids =
+    type_ == Type::Create || type_ == Type::Delete || type_ == Type::Edit
+    || type_ == Type::Quantize || type_ == Type::Resize
+    || (type_ == Type::Move && delta_tracks_ == 0 && delta_lanes_ == 0
+        && !target_port_);
+  if (keeps_ids && sel_)
+    {
+      TRANSPORT->recalculate_total_bars (ArrangerObjectSpan{ *sel_ });
+      return;
+    }
+
+  UndoableAction::update_transport_total_bars (perform);
+}
+
 std::vector<ArrangerObjectPtrVariant>
 ArrangerSelectionsAction::get_project_arranger_objects () const
 {
@@ -370,7 +399,8 @@ EditArrangerSelectionsAction::EditArrangerSelectionsAction (
   const dsp::Position       &sel_end,
   AudioFunctionType          audio_func_type,
   AudioFunctionOpts          opts,
-  std::optional<std::string> uri)
+  std::optional<std::string> uri,
+  ProgressInfo *             progress_info)
     : EditArrangerSelectionsAction (
         ArrangerObjectRegistrySpan{
           PROJECT->get_arranger_object_registry (), region_id },
@@ -381,18 +411,165 @@ EditArrangerSelectionsAction::EditArrangerSelectionsAction (
   clip_editor_region_id_  = region_id;
   selected_positions_in_audio_editor_ = std::make_pair(sel_start, sel_end);
 
-  z_debug ("saving file before applying audio func...");
-  audio_function_apply (
-    region_id, sel_start, sel_end, AudioFunctionType::Invalid, opts, uri);
-
-  z_debug ("applying actual audio func...");
-  audio_function_apply (
-    region_id, sel_start, sel_end, audio_func_type, opts, uri);
+  audio_frames_patch_ = audio_function_apply (
+    region_id, sel_start, sel_end, audio_func_type, opts, uri, progress_info);
 
   set_after_selections (ArrangerObjectRegistrySpan{
     PROJECT->get_arranger_object_registry (), region_id });
 }
 
+ArrangerSelectionsAction::EditNotesAction::EditNotesAction (
+  ArrangerObjectSpanVariant sel_var,
+  const EditFunc           &edit_func)
+{
+  type_ = Type::Edit;
+  edit_type_ = EditType::EditorFunction;
+
+  /* pack the notes of each region */
+  std::vector<dsp::PackedNotes>                  notes_per_region;
+  std::vector<std::vector<ArrangerObject::Uuid>> ids_per_region;
+  std::unordered_map<const Region *, size_t>     region_indices;
+  std::visit (
+    [&] (auto &&sel) {
+      for (auto * mn : sel.template get_elements_by_type<MidiNote> ())
+        {
+          const auto * region = mn->get_region ();
+          z_return_if_fail (region);
+          auto [it, inserted] =
+            region_indices.try_emplace (region, notes_per_region.size ());
+          if (inserted)
+            {
+              notes_per_region.emplace_back ().offset_ticks_ =
+                region->pos_->ticks_;
+              ids_per_region.emplace_back ();
+            }
+          notes_per_region[it->second].push_back (
+            mn->pos_->ticks_, mn->end_pos_->ticks_, mn->pitch_,
+            mn->vel_->vel_);
+          ids_per_region[it->second].push_back (mn->get_uuid ());
+        }
+    },
+    sel_var);
+
+  const auto packed_before = notes_per_region;
+  edit_func (notes_per_region);
+
+  /* only keep the notes that changed */
+  for (size_t i = 0; i < notes_per_region.size (); ++i)
+    {
+      const auto changed =
+        packed_before[i].get_changed_indices (notes_per_region[i]);
+      for (const auto index : changed)
+        {
+          note_ids_.push_back (ids_per_region[i][index]);
+        }
+      notes_before_.append (packed_before[i].select (changed));
+      notes_after_.append (notes_per_region[i].select (changed));
+    }
+  z_debug (
+    "editing {} notes in {} regions", note_ids_.size (),
+    notes_per_region.size ());
+}
+
+ArrangerSelectionsAction::EditNotesAction::EditNotesAction (
+  ArrangerObjectSpanVariant sel_var,
+  MidiFunction::Type        midi_func_type,
+  MidiFunction::Options     opts)
+    : EditNotesAction (
+        sel_var,
+        [&] (std::span<dsp::PackedNotes> notes_per_region) {
+          MidiFunction::apply (notes_per_region, midi_func_type, opts);
+        })
+{
+}
+
+ArrangerSelectionsAction::EditNotesAction::EditNotesAction (
+  ArrangerObjectSpanVariant       sel_var,
+  const old_dsp::QuantizeOptions &opts)
+    : EditNotesAction (
+        sel_var,
+        [&] (std::span<dsp::PackedNotes> notes_per_region) {
+          opts.quantize_notes (notes_per_region);
+        })
+{
+}
+
+ArrangerSelectionsAction::EditAutomationPointsAction::
+  EditAutomationPointsAction (
+    ArrangerObjectSpanVariant sel_var,
+    const EditFunc           &edit_func)
+{
+  type_ = Type::Edit;
+  edit_type_ = EditType::EditorFunction;
+
+  /* group the points by region, in position order */
+  std::vector<std::vector<AutomationPoint *>>          aps_per_region;
+  std::unordered_map<const AutomationRegion *, size_t> region_indices;
+  std::visit (
+    [&] (auto &&sel) {
+      for (
+        auto * ap : sel.template get_elements_by_type<AutomationPoint> ())
+        {
+          const auto * region = ap->get_region ();
+          z_return_if_fail (region);
+          auto [it, inserted] =
+            region_indices.try_emplace (region, aps_per_region.size ());
+          if (inserted)
+            aps_per_region.emplace_back ();
+          aps_per_region[it->second].push_back (ap);
+        }
+    },
+    sel_var);
+
+  std::vector<dsp::PackedAutomationPoints> points_per_region;
+  points_per_region.reserve (aps_per_region.size ());
+  for (auto &aps : aps_per_region)
+    {
+      std::ranges::sort (aps, [] (const auto * a, const auto * b) {
+        return *a->pos_ < *b->pos_;
+      });
+      auto &points = points_per_region.emplace_back ();
+      points.reserve (aps.size ());
+      for (const auto * ap : aps)
+        {
+          points.push_back (
+            ap->pos_->ticks_, ap->normalized_val_, ap->curve_opts_);
+        }
+    }
+
+  const auto packed_before = points_per_region;
+  edit_func (points_per_region);
+
+  /* only keep the points that changed */
+  for (size_t i = 0; i < points_per_region.size (); ++i)
+    {
+      const auto changed =
+        packed_before[i].get_changed_indices (points_per_region[i]);
+      for (const auto index : changed)
+        {
+          automation_point_ids_.push_back (
+            aps_per_region[i][index]->get_uuid ());
+        }
+      automation_points_before_.append (packed_before[i].select (changed));
+      automation_points_after_.append (points_per_region[i].select (changed));
+    }
+  z_debug (
+    "editing {} automation points in {} regions",
+    automation_point_ids_.size (), points_per_region.size ());
+}
+
+ArrangerSelectionsAction::EditAutomationPointsAction::
+  EditAutomationPointsAction (
+    ArrangerObjectSpanVariant sel_var,
+    AutomationFunction::Type  automation_func_type)
+    : EditAutomationPointsAction (
+        sel_var,
+        [&] (std::span<dsp::PackedAutomationPoints> points_per_region) {
+          AutomationFunction::apply (points_per_region, automation_func_type);
+        })
+{
+}
+
 ArrangerSelectionsAction::SplitAction::SplitAction (
   ArrangerObjectSpanVariant sel,
   Position                  pos)
@@ -498,6 +675,104 @@ ArrangerSelectionsAction::update_region_link_groups (const auto &objects)
     }
 }
 
+void
+ArrangerSelectionsAction::invalidate_playback_snapshots () const
+{
+  const auto invalidate_region = [] (Region &region) {
+    region.invalidate_playback_snapshot ();
+    if (region.has_link_group ())
+      {
+        auto * link_group = region.get_link_group ();
+        z_return_if_fail (link_group);
+        for (const auto &id : link_group->ids_)
+          {
+            if (auto linked_region_var = Region::find (id))
+              {
+                std::visit (
+                  [] (auto &&linked_region) {
+                    linked_region->invalidate_playback_snapshot ();
+                  },
+                  *linked_region_var);
+              }
+          }
+      }
+  };
+
+  /* @p obj is either a project object, or a clone used to find the region
+   * owning a deleted object */
+  const auto invalidate_object = [&] (const ArrangerObjectPtrVariant &obj_var) {
+    std::visit (
+      [&] (auto &&obj) {
+        using ObjT = base_type<decltype (obj)>;
+        if constexpr (std::derived_from<ObjT, Region>)
+          {
+            invalidate_region (*obj);
+          }
+        else if constexpr (std::derived_from<ObjT, RegionOwnedObject>)
+          {
+            if (auto * region = obj->get_region ())
+              {
+                invalidate_region (*region);
+              }
+          }
+      },
+      obj_var);
+  };
+
+  const auto invalidate_objects = [&] (const auto &objects) {
+    for (const auto &own_obj_var : objects)
+      {
+        auto prj_obj_var = std::visit (
+          [] (auto &&own_obj) { return own_obj->find_in_project (); },
+          own_obj_var);
+        invalidate_object (prj_obj_var ? *prj_obj_var : own_obj_var);
+      }
+  };
+
+  if (sel_)
+    invalidate_objects (*sel_);
+  if (sel_after_)
+    invalidate_objects (*sel_after_);
+
+  /* notes and automation points edited in bulk (once per region) */
+  std::unordered_set<Region *> note_regions;
+  for (const auto &id : note_ids_)
+    {
+      if (auto obj_var = get_arranger_object_registry ().find_by_id (id))
+        {
+          if (auto * mn = std::get_if<MidiNote *> (&obj_var->get ()))
+            note_regions.insert ((*mn)->get_region ());
+        }
+    }
+  for (const auto &id : automation_point_ids_)
+    {
+      if (auto obj_var = get_arranger_object_registry ().find_by_id (id))
+        {
+          if (auto * ap = std::get_if<AutomationPoint *> (&obj_var->get ()))
+            note_regions.insert ((*ap)->get_region ());
+        }
+    }
+  for (auto * region : note_regions)
+    {
+      if (region)
+        invalidate_region (*region);
+    }
+  if (region_before_)
+    invalidate_objects (std::views::single (*region_before_));
+  if (region_after_)
+    invalidate_objects (std::views::single (*region_after_));
+  for (const auto &uuids : { std::cref (r1_), std::cref (r2_) })
+    {
+      for (const auto &uuid : uuids.get ())
+        {
+          if (auto obj_var = get_arranger_object_registry ().find_by_id (uuid))
+            {
+              invalidate_object (obj_var->get ());
+            }
+        }
+    }
+}
+
 void
 ArrangerSelectionsAction::do_or_undo_move (bool do_it)
 {
@@ -1480,9 +1755,92 @@ ArrangerSelectionsAction::do_or_undo_record (bool do_it)
     }
 }
 
+void
+ArrangerSelectionsAction::apply_packed_notes (const dsp::PackedNotes &notes)
+{
+  z_return_if_fail (notes.size () == note_ids_.size ());
+
+  std::unordered_set<Region *> regions;
+  for (size_t i = 0; i < note_ids_.size (); ++i)
+    {
+      auto * mn = std::get<MidiNote *> (
+        get_arranger_object_registry ().find_by_id_or_throw (note_ids_[i]));
+
+      /* move the edge that keeps the note valid first */
+      const Position start (notes.start_ticks_[i], frames_per_tick_);
+      const Position end (notes.end_ticks_[i], frames_per_tick_);
+      if (start.ticks_ < mn->end_pos_->ticks_)
+        {
+          mn->pos_setter (&start);
+          mn->end_pos_setter (&end);
+        }
+      else
+        {
+          mn->end_pos_setter (&end);
+          mn->pos_setter (&start);
+        }
+      mn->set_val (notes.pitches_[i]);
+      mn->vel_->set_val (notes.velocities_[i]);
+      regions.insert (mn->get_region ());
+    }
+
+  for (auto * region : regions)
+    {
+      region->update_link_group ();
+    }
+}
+
+void
+ArrangerSelectionsAction::apply_packed_automation_points (
+  const dsp::PackedAutomationPoints &points)
+{
+  z_return_if_fail (points.size () == automation_point_ids_.size ());
+
+  /* the port is looked up once per region */
+  std::unordered_map<AutomationRegion *, ControlPort *> region_ports;
+  for (size_t i = 0; i < automation_point_ids_.size (); ++i)
+    {
+      auto * ap = std::get<AutomationPoint *> (
+        get_arranger_object_registry ().find_by_id_or_throw (
+          automation_point_ids_[i]));
+      auto * region = ap->get_region ();
+      z_return_if_fail (region);
+      auto [it, inserted] = region_ports.try_emplace (region, nullptr);
+      if (inserted)
+        it->second = ap->get_port ();
+      z_return_if_fail (it->second);
+
+      const Position pos (points.pos_ticks_[i], frames_per_tick_);
+      ap->pos_setter (&pos);
+      ap->normalized_val_ = std::clamp (points.values_[i], 0.f, 1.f);
+      ap->fvalue_ = it->second->normalized_val_to_real (ap->normalized_val_);
+      ap->curve_opts_ = points.get_curve (i);
+    }
+
+  for (auto &[region, port] : region_ports)
+    {
+      region->force_sort ();
+      region->update_link_group ();
+    }
+}
+
 void
 ArrangerSelectionsAction::do_or_undo_edit (bool do_it)
 {
+  /* notes and automation points edited in bulk (without clones) */
+  if (!sel_)
+    {
+      if (!note_ids_.empty ())
+        apply_packed_notes (do_it ? notes_after_ : notes_before_);
+      if (!automation_point_ids_.empty ())
+        {
+          apply_packed_automation_points (
+            do_it ? automation_points_after_ : automation_points_before_);
+        }
+      first_run_ = false;
+      return;
+    }
+
   const auto &src_sel = do_it ? sel_ : sel_after_;
   const auto &dest_sel = do_it ? sel_after_ : sel_;
 
@@ -1491,38 +1849,19 @@ ArrangerSelectionsAction::do_or_undo_edit (bool do_it)
       if (selected_positions_in_audio_editor_.has_value())
         {
           z_return_if_fail (edit_type_ == EditType::EditorFunction);
-          auto src_audio_sel = dest_sel;
           auto r = std::get<AudioRegion*>(get_arranger_object_registry().find_by_id_or_throw(*clip_editor_region_id_));
-          auto src_clip = AUDIO_POOL->get_clip (r->pool_id_);
-          z_return_if_fail (src_clip);
-
-          /* adjust the positions */
-          auto [start, end] = *selected_positions_in_audio_editor_;
-          start.add_frames (-r->pos_->frames_, get_ticks_per_frame());
-          end.add_frames (-r->pos_->frames_, get_ticks_per_frame());
-          auto num_frames =
-            static_cast<unsigned_frame_t> (end.frames_ - start.frames_);
-          z_return_if_fail (
-            num_frames
-            == (unsigned_frame_t) src_clip->get_num_frames ());
-
-          auto src_clip_path =
-            AUDIO_POOL->get_clip_path (*src_clip, false);
+          z_return_if_fail (audio_frames_patch_);
+          const auto &patch = *audio_frames_patch_;
           z_debug (
-            "replacing audio region {} frames with {} frames", r->name_,
-            src_clip_path);
-
-          /* replace the frames in the region */
-          utils::audio::AudioBuffer buf{
-            src_clip->get_num_channels (), static_cast<int> (num_frames)
-          };
-          for (int i = 0; i < buf.getNumChannels (); ++i)
+            "restoring {} frames of audio region {}", patch.get_num_frames (),
+            r->name_);
+
+          /* patch the changed frames in the region's clip */
+          if (!patch.empty ())
             {
-              buf.copyFrom (
-                i, 0, src_clip->get_samples (), i, start.frames_,
-                num_frames);
+              r->replace_frames (
+                patch.get_frames (do_it), patch.get_start_frame (), false);
             }
-          r->replace_frames (buf, start.frames_, false);
         }
       else /* not audio function */
         {
@@ -2034,7 +2373,7 @@ ArrangerSelectionsAction::do_or_undo_quantize (bool do_it)
                   /* quantize it */
                   if (opts_->adj_start_)
                     {
-                      double ticks = opts_->quantize_position (obj->pos_);
+                      double ticks = opts_->quantize_position (&*obj->pos_);
                       if constexpr (std::derived_from<ObjT, BoundedObject>)
                         {
                           obj->end_pos_->add_ticks (ticks, frames_per_tick_);
@@ -2044,13 +2383,13 @@ ArrangerSelectionsAction::do_or_undo_quantize (bool do_it)
                     {
                       if constexpr (std::derived_from<ObjT, BoundedObject>)
                         {
-                          opts_->quantize_position (obj->end_pos_);
+                          opts_->quantize_position (&*obj->end_pos_);
                         }
                     }
-                  obj->pos_setter (obj->pos_);
+                  obj->pos_setter (&*obj->pos_);
                   if constexpr (std::derived_from<ObjT, BoundedObject>)
                     {
-                      obj->end_pos_setter (obj->end_pos_);
+                      obj->end_pos_setter (&*obj->end_pos_);
                     }
 
                   /* remember the quantized position so we can find the
@@ -2064,10 +2403,10 @@ ArrangerSelectionsAction::do_or_undo_quantize (bool do_it)
               else
                 {
                   /* unquantize it */
-                  obj->pos_setter (own_obj->pos_);
+                  obj->pos_setter (&*own_obj->pos_);
                   if constexpr (std::derived_from<ObjT, BoundedObject>)
                     {
-                      obj->end_pos_setter (own_obj->end_pos_);
+                      obj->end_pos_setter (&*own_obj->end_pos_);
                     }
                 }
             }
@@ -2082,7 +2421,7 @@ ArrangerSelectionsAction::do_or_undo_quantize (bool do_it)
 }
 
 void
-ArrangerSelectionsAction::do_or_undo (bool do_it)
+ArrangerSelectionsAction::do_or_undo_type (bool do_it)
 {
   switch (type_)
     {
@@ -2126,9 +2465,22 @@ ArrangerSelectionsAction::do_or_undo (bool do_it)
       z_return_if_reached ();
       break;
     }
+}
+
+void
+ArrangerSelectionsAction::do_or_undo (bool do_it)
+{
+  {
+    /* update each link group once after all the objects are changed */
+    RegionLinkGroupManager::DeferredUpdates deferred_link_group_updates (
+      REGION_LINK_GROUP_MANAGER);
+
+    do_or_undo_type (do_it);
+  }
 
-  /* update playback caches */
-  TRACKLIST->get_track_span ().set_caches (CacheType::PlaybackSnapshots);
+  /* update the playback snapshots of the affected regions */
+  invalidate_playback_snapshots ();
+  TRACKLIST->get_track_span ().update_playback_snapshots ();
 
   /* reset new_lane_created */
   for (auto track_var : TRACKLIST->get_track_span ())
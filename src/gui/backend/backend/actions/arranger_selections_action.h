@@ -4,6 +4,11 @@
 #ifndef UNDO_ARRANGER_SELECTIONS_ACTION_H
 #define UNDO_ARRANGER_SELECTIONS_ACTION_H
 
+#include <functional>
+#include <span>
+
+#include "dsp/packed_automation_points.h"
+#include "dsp/packed_notes.h"
 #include "dsp/port_identifier.h"
 #include "gui/backend/backend/actions/undoable_action.h"
 #include "gui/dsp/arranger_object_span.h"
@@ -132,6 +137,8 @@ public:
   class MergeAction;
   class ResizeAction;
   class QuantizeAction;
+  class EditNotesAction;
+  class EditAutomationPointsAction;
 
   ArrangerObjectRegistry &get_arranger_object_registry () const;
 
@@ -143,6 +150,8 @@ public:
 
   bool needs_transport_total_bar_update (bool perform) const override;
 
+  void update_transport_total_bars (bool perform) const override;
+
   bool needs_pause () const override
   {
     /* always needs a pause to update the track playback snapshots */
@@ -188,6 +197,9 @@ private:
   /** Common logic for perform/undo. */
   void do_or_undo (bool do_it);
 
+  /** Calls the perform/undo logic of the action's type. */
+  void do_or_undo_type (bool do_it);
+
   void do_or_undo_duplicate_or_link (bool link, bool do_it);
   void do_or_undo_move (bool do_it);
   void do_or_undo_create_or_delete (bool do_it, bool create);
@@ -199,12 +211,32 @@ private:
   void do_or_undo_resize (bool do_it);
   void do_or_undo_quantize (bool do_it);
 
+  /**
+   * @brief Writes @p notes to the MIDI notes in @ref note_ids_ (see
+   * EditNotesAction).
+   */
+  void apply_packed_notes (const dsp::PackedNotes &notes);
+
+  /**
+   * @brief Writes @p points to the automation points in
+   * @ref automation_point_ids_ (see EditAutomationPointsAction).
+   */
+  void apply_packed_automation_points (
+    const dsp::PackedAutomationPoints &points);
+
   /**
    * Finds all corresponding objects in the project and calls
    * Region.update_link_group().
    */
   void update_region_link_groups (const auto &objects);
 
+  /**
+   * @brief Invalidates the playback snapshots of the regions affected by this
+   * action (the regions in the action and the regions owning the objects in
+   * the action, along with their linked regions).
+   */
+  void invalidate_playback_snapshots () const;
+
   /**
    * @brief Moves a project object by tracks and/or labes.
    *
@@ -264,6 +296,12 @@ public:
   std::optional<std::pair<Position, Position>>
     selected_positions_in_audio_editor_;
 
+  /**
+   * Frames of the clip changed by an audio function, before and after (only
+   * the changed range is kept).
+   */
+  std::optional<dsp::AudioRangePatch> audio_frames_patch_;
+
   /** Clip editor region ID (for non-timeline actions). */
   std::optional<Region::Uuid> clip_editor_region_id_;
 
@@ -303,6 +341,30 @@ public:
 
   /** Used by the resize action. */
   ResizeType resize_type_ = (ResizeType) 0;
+
+  /**
+   * MIDI notes changed by an EditNotesAction, in the order of
+   * @ref notes_before_ and @ref notes_after_.
+   */
+  std::vector<ArrangerObject::Uuid> note_ids_;
+
+  /** Values of the notes in @ref note_ids_ before the change. */
+  dsp::PackedNotes notes_before_;
+
+  /** Values of the notes in @ref note_ids_ after the change. */
+  dsp::PackedNotes notes_after_;
+
+  /**
+   * Automation points changed by an EditAutomationPointsAction, in the order
+   * of @ref automation_points_before_ and @ref automation_points_after_.
+   */
+  std::vector<ArrangerObject::Uuid> automation_point_ids_;
+
+  /** Values of the points in @ref automation_point_ids_ before the change. */
+  dsp::PackedAutomationPoints automation_points_before_;
+
+  /** Values of the points in @ref automation_point_ids_ after the change. */
+  dsp::PackedAutomationPoints automation_points_after_;
 };
 
 class CreateOrDeleteArrangerSelectionsAction : public ArrangerSelectionsAction
@@ -574,6 +636,9 @@ public:
 
   /**
    * @brief Wrapper for audio functions.
+   *
+   * @param progress_info Optional progress info passed to
+   * audio_function_apply().
    */
   EditArrangerSelectionsAction (
     Region::Uuid               region_id,
@@ -581,7 +646,8 @@ public:
     const dsp::Position       &sel_end,
     AudioFunctionType          audio_func_type,
     AudioFunctionOpts          opts,
-    std::optional<std::string> uri);
+    std::optional<std::string> uri,
+    ProgressInfo *             progress_info = nullptr);
 };
 
 class ArrangerSelectionsAction::AutomationFillAction
@@ -658,6 +724,70 @@ public:
   }
 };
 
+class ArrangerSelectionsAction::EditNotesAction
+    : public ArrangerSelectionsAction
+{
+public:
+  using EditFunc = std::function<void (std::span<dsp::PackedNotes>)>;
+
+  /**
+   * Creates a new action for editing many MIDI notes at once.
+   *
+   * The notes in @p sel are packed into arrays (one per region) and passed
+   * to @p edit_func. Only the values of the notes that changed are kept for
+   * undoing, instead of clones of all the notes.
+   *
+   * Objects other than MIDI notes are ignored.
+   */
+  EditNotesAction (ArrangerObjectSpanVariant sel, const EditFunc &edit_func);
+
+  /**
+   * @brief Wrapper for MIDI functions.
+   */
+  EditNotesAction (
+    ArrangerObjectSpanVariant sel,
+    MidiFunction::Type        midi_func_type,
+    MidiFunction::Options     opts);
+
+  /**
+   * @brief Wrapper for quantizing.
+   *
+   * @param opts Quantize options (with up to date quantize points).
+   */
+  EditNotesAction (
+    ArrangerObjectSpanVariant       sel,
+    const old_dsp::QuantizeOptions &opts);
+};
+
+class ArrangerSelectionsAction::EditAutomationPointsAction
+    : public ArrangerSelectionsAction
+{
+public:
+  using EditFunc =
+    std::function<void (std::span<dsp::PackedAutomationPoints>)>;
+
+  /**
+   * Creates a new action for editing many automation points at once.
+   *
+   * The points in @p sel are packed into arrays (one per region, in
+   * position order) and passed to @p edit_func. Only the values of the
+   * points that changed are kept for undoing, instead of clones of all the
+   * points.
+   *
+   * Objects other than automation points are ignored.
+   */
+  EditAutomationPointsAction (
+    ArrangerObjectSpanVariant sel,
+    const EditFunc           &edit_func);
+
+  /**
+   * @brief Wrapper for automation functions.
+   */
+  EditAutomationPointsAction (
+    ArrangerObjectSpanVariant sel,
+    AutomationFunction::Type  automation_func_type);
+};
+
 }; // namespace zrythm::gui::actions
 
 DEFINE_ENUM_FORMATTER (
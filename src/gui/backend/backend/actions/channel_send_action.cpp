@@ -163,7 +163,7 @@ ChannelSendAction::perform_impl ()
     {
       save_or_load_port_connections (true);
 
-      ROUTER->recalc_graph (false);
+      ROUTER->recalc_graph_connections ();
     }
 
   /* EVENTS_PUSH (EventType::ET_CHANNEL_SEND_CHANGED, send); */
@@ -208,7 +208,7 @@ ChannelSendAction::undo_impl ()
     {
       save_or_load_port_connections (false);
 
-      ROUTER->recalc_graph (false);
+      ROUTER->recalc_graph_connections ();
 
       TRACKLIST->validate ();
     }
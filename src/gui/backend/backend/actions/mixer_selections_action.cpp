@@ -188,6 +188,7 @@ MixerSelectionsAction::copy_at_regions (
     dest_region->setParent (&dest);
     dest.region_list_->regions_.push_back (dest_region);
   });
+  RegionList::invalidate_indices ();
 
   if (!dest.region_list_->regions_.empty ())
     {
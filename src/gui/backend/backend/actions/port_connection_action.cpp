@@ -104,7 +104,7 @@ PortConnectionAction::do_or_undo (bool _do)
               PORT_CONNECTIONS_MGR->ensure_disconnect (
                 src->get_uuid (), dest->get_uuid ());
             }
-          ROUTER->recalc_graph (false);
+          ROUTER->recalc_graph_connections ();
           break;
         case Type::Enable:
           prj_connection->enabled_ = _do;
@@ -457,7 +457,9 @@ TracklistSelectionsAction::TracklistSelectionsAction (
 }
 
 void
-TracklistSelectionsAction::create_track (int idx)
+TracklistSelectionsAction::create_track (
+  int                           idx,
+  const MidiFileTrackContents * midi_track)
 {
   int pos = track_pos_ + idx;
 
@@ -561,23 +563,12 @@ TracklistSelectionsAction::create_track (int idx)
                   pool_id_, start_pos, added_track->get_uuid (), 0, 0),
                 nullptr, 0, true, false);
             }
-          else if (
-            track_type_ == Track::Type::Midi && !base64_midi_.empty ()
-            && !file_basename_.empty ())
+          else if (track_type_ == Track::Type::Midi && midi_track != nullptr)
             {
-              /* create a temporary midi file */
-              auto full_path_file = utils::io::make_tmp_file (
-                std::make_optional<std::string> ("data.MID"));
-              fs::path full_path (full_path_file->fileName ().toStdString ());
-              auto     data = utils::base64::decode (
-                QByteArray::fromStdString (base64_midi_));
-              utils::io::set_file_contents (
-                full_path, data.constData (), data.size ());
-
               /* create a MIDI region from the MIDI file & add to track */
               added_track->Track::add_region (
                 new MidiRegion (
-                  pos_, full_path, added_track->get_uuid (), 0, 0, idx),
+                  pos_, *midi_track, added_track->get_uuid (), 0, 0),
                 nullptr, 0, true, false);
             }
 
@@ -609,9 +600,28 @@ TracklistSelectionsAction::do_or_undo_create_or_delete (bool _do, bool create)
     {
       if (create)
         {
+          /* read all the tracks of the MIDI file at once (in parallel) instead
+           * of reading the file again for each track */
+          std::vector<MidiFileTrackContents> midi_tracks;
+          if (
+            !is_empty_ && track_type_ == Track::Type::Midi
+            && !base64_midi_.empty () && !file_basename_.empty ())
+            {
+              const auto data =
+                utils::base64::decode (QByteArray::fromStdString (base64_midi_));
+              midi_tracks =
+                MidiFile (
+                  std::span (
+                    data.constData (), static_cast<size_t> (data.size ())))
+                  .read_tracks (TRANSPORT->get_ppqn ());
+              z_return_if_fail (
+                midi_tracks.size () == static_cast<size_t> (num_tracks_));
+            }
+
           for (int i = 0; i < num_tracks_; i++)
             {
-              create_track (i);
+              create_track (
+                i, midi_tracks.empty () ? nullptr : &midi_tracks.at (i));
 
               /* TODO select each plugin that was selected */
             }
@@ -13,6 +13,8 @@
 #include "gui/dsp/track_span.h"
 #include "utils/color.h"
 
+struct MidiFileTrackContents;
+
 namespace zrythm::gui::actions
 {
 
@@ -238,8 +240,10 @@ private:
    * @brief Creates a track at index @p idx.
    *
    * @param idx
+   * @param midi_track Track read from @ref base64_midi_, if creating a MIDI
+   * track from a MIDI file.
    */
-  void create_track (int idx);
+  void create_track (int idx, const MidiFileTrackContents * midi_track);
 
   /* all these may throw ZrythmException */
 
@@ -419,6 +423,36 @@ public:
   }
 };
 
+/**
+ * @brief Creates an audio track with a region of a clip that is already in
+ * the pool (e.g., when importing many files at once).
+ */
+class CreateAudioTrackFromClipAction : public CreateTracksAction
+{
+public:
+  /**
+   * @param name Track name (normally the basename of the file).
+   */
+  CreateAudioTrackFromClipAction (
+    int              pool_id,
+    std::string      name,
+    int              track_pos,
+    const Position * pos)
+      : CreateTracksAction (
+          Track::Type::Audio,
+          nullptr,
+          nullptr,
+          track_pos,
+          pos,
+          1,
+          -1)
+  {
+    is_empty_ = false;
+    pool_id_ = pool_id;
+    file_basename_ = std::move (name);
+  }
+};
+
 /**
  * @brief To be used when creating tracks of a given type with a plugin.
  *
@@ -109,6 +109,8 @@ TransportAction::do_or_undo (bool do_it)
     .g_start_frame_w_offset_ = (unsigned_frame_t) PLAYHEAD.frames_,
     .local_offset_ = 0,
     .nframes_ = 1,
+    .cycle_start_time_usecs_ =
+      Zrythm::getInstance ()->get_monotonic_time_usecs (),
   };
   ROUTER->start_cycle (time_nfo);
   AUDIO_ENGINE->post_process (0, 1);
@@ -173,6 +175,15 @@ TransportAction::undo_impl ()
   /* EVENTS_PUSH (EventType::ET_TIME_SIGNATURE_CHANGED, nullptr); */
 }
 
+void
+TransportAction::update_transport_total_bars (bool perform) const
+{
+  /* object positions in ticks don't change, only the number of bars they
+   * span, so no objects need to be checked */
+  const std::vector<ArrangerObjectPtrVariant> no_objects;
+  TRANSPORT->recalculate_total_bars (ArrangerObjectSpan{ no_objects });
+}
+
 QString
 TransportAction::to_string () const
 {
@@ -72,6 +72,8 @@ public:
 
   QString to_string () const override;
 
+  void update_transport_total_bars (bool perform) const override;
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 private:
@@ -3,6 +3,7 @@
 
 # include "gui/dsp/router.h"
 #include "utils/gtest_wrapper.h"
+#include "gui/backend/backend/actions/action_journal.h"
 #include "gui/backend/backend/actions/undo_manager.h"
 #include "gui/backend/backend/actions/undo_stack.h"
 #include "gui/backend/backend/actions/undoable_action.h"
@@ -11,6 +12,44 @@
 
 using namespace zrythm::gui::actions;
 
+namespace
+{
+
+/**
+ * Waits for the clips still loading in the background after loading the
+ * project if @p action may access their frames.
+ */
+template <UndoableActionSubclass T>
+void
+wait_for_clips_if_needed (const T &action)
+{
+  if constexpr (std::derived_from<T, TracklistSelectionsAction>)
+    {
+      /* edits don't touch regions */
+      if (
+        action.tracklist_selections_action_type_
+        == TracklistSelectionsAction::Type::Edit)
+        return;
+    }
+  else if constexpr (
+    !std::derived_from<T, ArrangerSelectionsAction>
+    && !std::derived_from<T, RangeAction>)
+    {
+      return;
+    }
+
+  try
+    {
+      AUDIO_POOL->wait_until_loaded ();
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("some clips failed to load: {}", e.what ());
+    }
+}
+
+}
+
 UndoManager::UndoManager (QObject * parent) : QObject (parent)
 {
   undo_stack_ = new UndoStack (this);
@@ -41,6 +80,12 @@ UndoManager::do_or_undo_action (
   else
     z_return_if_reached (); // invalid stack
 
+  /* the action may have changed what frozen tracks were rendered from */
+  if (in_transaction ())
+    transaction_dirty_ = true;
+  else
+    TRACKLIST->get_track_span ().unfreeze_stale_tracks ();
+
   /* if redo stack is locked don't alter it */
   if (redo_stack_locked_ && &opposite_stack == redo_stack_)
     return;
@@ -48,7 +93,10 @@ UndoManager::do_or_undo_action (
   /* if the redo stack is full, delete the last element */
   if (opposite_stack.is_full ())
     {
-      opposite_stack.pop_last ();
+      if (auto oldest = opposite_stack.pop_last ())
+        {
+          std::visit ([] (auto * ptr) { delete ptr; }, *oldest);
+        }
 
       /* TODO create functions to delete unnecessary files held by the action
        * (eg, something that calls plugin_delete_state_files()) */
@@ -75,11 +123,20 @@ UndoManager::do_undo_redo (bool is_undo)
   auto action_opt = main_stack.peek ();
   z_return_if_fail (action_opt.has_value ());
 
+  std::visit (
+    [] (auto &&action) { wait_for_clips_if_needed (*action); },
+    action_opt.value ());
+
   std::visit (
     [&] (auto &&action) {
       const auto num_actions = action->num_actions_;
       z_return_if_fail (num_actions > 0);
 
+      /* rebuild the graph once for the whole group */
+      std::optional<Transaction> transaction;
+      if (num_actions > 1)
+        transaction.emplace (*this);
+
       for (int i = 0; i < num_actions; ++i)
         {
           z_info ("[ACTION {}/{}]", i + 1, num_actions);
@@ -108,16 +165,105 @@ UndoManager::do_undo_redo (bool is_undo)
     action_opt.value ());
 }
 
+void
+UndoManager::enforce_memory_limit ()
+{
+  if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
+    return;
+
+  const auto limit_mib =
+    zrythm::gui::SettingsManager::get_instance ()->get_undoHistoryMemoryLimit ();
+  if (limit_mib <= 0)
+    return;
+
+  const auto limit = static_cast<size_t> (limit_mib) * 1024 * 1024;
+  size_t     total =
+    undo_stack_->get_memory_estimate () + redo_stack_->get_memory_estimate ();
+  size_t num_evicted = 0;
+
+  /* drop the oldest undo history first, then the furthest redos, but always
+   * keep the last performed action */
+  while (total > limit)
+    {
+      auto &stack = undo_stack_->size () > 1 ? *undo_stack_ : *redo_stack_;
+      auto  oldest = stack.pop_last ();
+      if (!oldest)
+        break;
+
+      std::visit (
+        [&total] (auto * ptr) {
+          total -= std::min (total, ptr->memory_estimate_);
+          delete ptr;
+        },
+        *oldest);
+      ++num_evicted;
+    }
+
+  if (num_evicted > 0)
+    {
+      z_info (
+        "Dropped {} actions from the undo history to stay within {} MiB",
+        num_evicted, limit_mib);
+    }
+}
+
+void
+UndoManager::request_journal_compaction_if_needed ()
+{
+  if (journal_->should_request_compaction ())
+    {
+      Q_EMIT journalCompactionNeeded ();
+    }
+}
+
+void
+UndoManager::beginTransaction ()
+{
+  if (transaction_depth_++ == 0)
+    {
+      transaction_dirty_ = false;
+    }
+  ROUTER->begin_deferred_recalc ();
+}
+
+void
+UndoManager::endTransaction ()
+{
+  z_return_if_fail (transaction_depth_ > 0);
+
+  /* unfreeze before the graph is rebuilt, so that it is only rebuilt once */
+  if (--transaction_depth_ == 0 && transaction_dirty_)
+    {
+      TRACKLIST->get_track_span ().unfreeze_stale_tracks ();
+      transaction_dirty_ = false;
+    }
+  ROUTER->end_deferred_recalc ();
+}
+
 void
 UndoManager::undo ()
 {
   do_undo_redo (true);
+  enforce_memory_limit ();
+
+  if (journal_)
+    {
+      journal_->append_undo ();
+      request_journal_compaction_if_needed ();
+    }
 }
 
 void
 UndoManager::redo ()
 {
   do_undo_redo (false);
+  enforce_memory_limit ();
+
+  if (journal_)
+    {
+      journal_->append_redo ();
+      request_journal_compaction_if_needed ();
+    }
 }
 
 void
@@ -136,6 +282,8 @@ UndoManager::perform (QObject * action_qobject)
 
       SemaphoreRAII<> sem_guard (action_sem_);
 
+      wait_for_clips_if_needed (*action);
+
       do_or_undo_action (std::move (action), *redo_stack_, *undo_stack_);
 
       if (!redo_stack_locked_)
@@ -143,6 +291,14 @@ UndoManager::perform (QObject * action_qobject)
           redo_stack_->clear ();
         }
 
+      enforce_memory_limit ();
+
+      if (journal_)
+        {
+          journal_->append_perform (UndoableActionPtrVariant{ action });
+          request_journal_compaction_if_needed ();
+        }
+
       if (ZRYTHM_HAVE_UI)
         {
           /* EVENTS_PUSH (EventType::ET_UNDO_REDO_ACTION_DONE, nullptr); */
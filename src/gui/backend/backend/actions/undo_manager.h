@@ -15,6 +15,8 @@ class AudioClip;
 namespace zrythm::gui::actions
 {
 
+class ActionJournal;
+
 /**
  * Undo manager.
  */
@@ -64,6 +66,44 @@ public:
    */
   Q_INVOKABLE void perform (QObject * action_qobject);
 
+  /**
+   * @brief Starts an edit transaction.
+   *
+   * Until the matching endTransaction(), performed (or undone/redone)
+   * actions only mark the processing graph and the frozen tracks dirty, and
+   * they are updated once when the outermost transaction ends. Meant for
+   * scripts and macros that apply many edits at once. Transactions can be
+   * nested.
+   *
+   * @see Transaction.
+   */
+  Q_INVOKABLE void beginTransaction ();
+
+  /**
+   * @brief Ends a transaction started with beginTransaction().
+   */
+  Q_INVOKABLE void endTransaction ();
+
+  /**
+   * @brief RAII helper for beginTransaction()/endTransaction().
+   */
+  class Transaction
+  {
+  public:
+    explicit Transaction (UndoManager &undo_manager)
+        : undo_manager_ (undo_manager)
+    {
+      undo_manager_.beginTransaction ();
+    }
+    ~Transaction () { undo_manager_.endTransaction (); }
+    Z_DISABLE_COPY_MOVE (Transaction)
+
+  private:
+    UndoManager &undo_manager_;
+  };
+
+  bool in_transaction () const { return transaction_depth_ > 0; }
+
   /**
    * Returns whether the given clip is used by any stack.
    */
@@ -91,8 +131,21 @@ public:
   void init_after_cloning (const UndoManager &other, ObjectCloneType clone_type)
     override;
 
+  /**
+   * @brief Sets the journal that performed/undone/redone actions are appended
+   * to, or nullptr to stop journaling.
+   */
+  void set_journal (ActionJournal * journal) { journal_ = journal; }
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
+Q_SIGNALS:
+  /**
+   * @brief Emitted when the journal grew large enough that a new snapshot of
+   * the project should be saved.
+   */
+  void journalCompactionNeeded ();
+
 private:
   /**
    * @brief Does or undoes the given action.
@@ -111,6 +164,14 @@ private:
    */
   void do_undo_redo (bool is_undo);
 
+  /**
+   * Drops the oldest actions while the undo history uses more memory than
+   * allowed by the settings.
+   */
+  void enforce_memory_limit ();
+
+  void request_journal_compaction_if_needed ();
+
 public:
   UndoStack * undo_stack_ = nullptr;
   UndoStack * redo_stack_ = nullptr;
@@ -124,6 +185,16 @@ public:
 
   /** Semaphore for performing actions. */
   std::binary_semaphore action_sem_{ 1 };
+
+private:
+  /** Journal of the applied actions (not owned). */
+  ActionJournal * journal_ = nullptr;
+
+  /** Nesting level of beginTransaction(). */
+  int transaction_depth_ = 0;
+
+  /** Whether actions were applied in the current transaction. */
+  bool transaction_dirty_ = false;
 };
 
 extern template void
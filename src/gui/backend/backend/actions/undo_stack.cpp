@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
 #include "utils/gtest_wrapper.h"
+#include "gui/backend/backend/actions/action_document.h"
 #include "gui/backend/backend/actions/undo_stack.h"
 #include "gui/backend/backend/actions/undoable_action_all.h"
 #include "gui/backend/backend/settings_manager.h"
@@ -49,6 +50,16 @@ UndoStack::init_after_cloning (const UndoStack &other, ObjectCloneType clone_typ
 {
   max_size_ = other.max_size_;
 
+  /* snapshots (used for saving) share the actions with the original stack,
+   * which keeps owning them. actions are only changed by the undo manager,
+   * which stays locked until the snapshot is serialized (see
+   * Project::save()) */
+  if (clone_type == ObjectCloneType::Snapshot)
+    {
+      actions_ = other.actions_;
+      return;
+    }
+
   /* clone all actions */
   for (const auto &action : other.actions_)
     {
@@ -100,7 +111,14 @@ UndoStack::push (T * action)
 {
   if (is_full ())
     {
-      pop_last ();
+      if (auto oldest = pop_last ())
+        {
+          std::visit ([] (auto * ptr) { delete ptr; }, *oldest);
+        }
+    }
+  if (action->memory_estimate_ == 0)
+    {
+      action->memory_estimate_ = estimate_memory (action);
     }
   beginInsertRows ({}, 0, 0);
   actions_.insert (actions_.cbegin (), action);
@@ -162,6 +180,55 @@ UndoStack::peek () const
                actions_.front ());
 }
 
+void
+UndoStack::clear ()
+{
+  if (actions_.empty ())
+    return;
+
+  beginResetModel ();
+  for (auto &action : actions_)
+    {
+      std::visit ([] (auto * ptr) { delete ptr; }, action);
+    }
+  actions_.clear ();
+  endResetModel ();
+  Q_EMIT rowCountChanged (rowCount ());
+}
+
+size_t
+UndoStack::get_memory_estimate () const
+{
+  size_t total = 0;
+  for (const auto &action : actions_)
+    {
+      total += std::visit (
+        [] (auto * ptr) { return ptr->memory_estimate_; }, action);
+    }
+  return total;
+}
+
+size_t
+UndoStack::estimate_memory (const UndoableActionPtrVariant &action)
+{
+  /* the in-memory objects take more space than their serialization, but they
+   * are roughly proportional */
+  ActionDocument doc;
+  doc.actions_.push_back (action);
+  size_t size = 0;
+  try
+    {
+      doc.serialize_to_binary ([&size] (std::string_view chunk) {
+        size += chunk.size ();
+      });
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("Failed to estimate the size of an action: {}", e.what ());
+    }
+  return std::max (size, size_t{ 1 });
+}
+
 bool
 UndoStack::contains_clip (const AudioClip &clip) const
 {
@@ -86,6 +86,13 @@ public:
   bool             empty () const { return is_empty (); }
   bool             is_full () const { return size () == max_size_; }
 
+  /**
+   * @brief Returns the approximate memory used by the actions in bytes.
+   *
+   * @see UndoableAction::memory_estimate_.
+   */
+  size_t get_memory_estimate () const;
+
   /**
    * @brief
    *
@@ -95,7 +102,10 @@ public:
    */
   std::optional<UndoableActionPtrVariant> peek () const;
 
-  void clear () { actions_.clear (); };
+  /**
+   * @brief Removes and frees all the actions.
+   */
+  void clear ();
 
   /* --- end wrappers --- */
 
@@ -113,11 +123,22 @@ public:
   void
   get_plugins (std::vector<zrythm::gui::old_dsp::plugins::Plugin *> &arr) const;
 
+  /**
+   * @note Snapshots share the actions of @p other without owning them, so
+   * they must not outlive @p other or be used while the actions change.
+   */
   void init_after_cloning (const UndoStack &other, ObjectCloneType clone_type)
     override;
 
   DECLARE_DEFINE_FIELDS_METHOD ();
 
+private:
+  /**
+   * @brief Estimates the memory used by @p action from the size of its binary
+   * serialization.
+   */
+  static size_t estimate_memory (const UndoableActionPtrVariant &action);
+
 public:
   /**
    * @brief Actions on the stack.
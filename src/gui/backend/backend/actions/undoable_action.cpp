@@ -118,8 +118,7 @@ UndoableAction::do_or_undo (bool perform)
 
   if (needs_transport_total_bar_update (perform))
     {
-      /* recalculate transport bars */
-      TRANSPORT->recalculate_total_bars ();
+      update_transport_total_bars (perform);
     }
 
   if (affects_audio_region_internal_positions ())
@@ -138,6 +137,12 @@ UndoableAction::do_or_undo (bool perform)
     std::rethrow_exception (saved_exception);
 }
 
+void
+UndoableAction::update_transport_total_bars (bool perform) const
+{
+  TRANSPORT->recalculate_total_bars ();
+}
+
 void
 UndoableAction::perform ()
 {
@@ -103,6 +103,15 @@ public:
     return true;
   };
 
+  /**
+   * Recalculates the total transport bars after performing or undoing the
+   * action (if needs_transport_total_bar_update()).
+   *
+   * The default implementation checks every object in the project. Actions
+   * that know which objects they changed should only pass those.
+   */
+  virtual void update_transport_total_bars (bool perform) const;
+
   /**
    * Whether audio region loop/fade/etc. positions are affected by this undoable
    * action.
@@ -194,6 +203,12 @@ public:
   /** A snapshot of AudioEngine.frames_per_tick when the action is executed. */
   double frames_per_tick_ = 0.0;
 
+  /**
+   * Approximate memory used by the action in bytes, estimated when it's first
+   * pushed to an UndoStack (0 if not estimated yet).
+   */
+  size_t memory_estimate_ = 0;
+
   /**
    * Sample rate of this action.
    *
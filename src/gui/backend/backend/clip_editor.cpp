@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
 #include "gui/backend/backend/clip_editor.h"
+#include "gui/dsp/engine.h"
 #include "gui/dsp/router.h"
 #include "gui/dsp/track.h"
 #include "utils/rt_thread_id.h"
@@ -37,10 +38,22 @@ ClipEditor::unsetRegion ()
   if (!region_id_)
     return;
 
+  const auto prev_track_id = get_track_id ();
   region_id_.reset ();
+  on_track_maybe_changed (prev_track_id);
   Q_EMIT regionChanged ({});
 }
 
+void
+ClipEditor::on_track_maybe_changed (
+  const std::optional<Region::TrackUuid> &prev_track_id)
+{
+  if (AUDIO_ENGINE && ROUTER && get_track_id () != prev_track_id)
+    {
+      ROUTER->reassign_rendered_ahead_nodes ();
+    }
+}
+
 #if 0
 void
 ClipEditor::set_region (
@@ -92,7 +92,9 @@ public:
     if (region_id_.has_value () && region_id_.value () == region_id)
       return;
 
+    const auto prev_track_id = get_track_id ();
     region_id_ = region_id;
+    on_track_maybe_changed (prev_track_id);
     Q_EMIT regionChanged (QVariant::fromStdVariant (get_region ().value ()));
   };
 
@@ -118,6 +120,15 @@ public:
 
   DECLARE_DEFINE_FIELDS_METHOD ();
 
+private:
+  /**
+   * @brief Reassigns the nodes rendered ahead if the track changed, since
+   * the clip editor's track gets live MIDI from the piano roll.
+   */
+  void on_track_maybe_changed (
+    const std::optional<Region::TrackUuid> &prev_track_id);
+
+public:
   void init_after_cloning (const ClipEditor &other, ObjectCloneType clone_type)
     override
   {
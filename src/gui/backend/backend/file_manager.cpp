@@ -21,6 +21,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <memory>
+#include <unordered_map>
 
 #include "gui/backend/io/file_descriptor.h"
 #include "utils/gtest_wrapper.h"
@@ -31,8 +32,25 @@
 #include "gui/backend/backend/settings_manager.h"
 #include "gui/backend/backend/zrythm.h"
 
+#include <QtConcurrent>
+
 using namespace zrythm;
 
+namespace
+{
+/** Number of files to report at once while scanning. */
+constexpr size_t SCAN_BATCH_SIZE = 64;
+
+/** Number of files to report at once while reading metadata. */
+constexpr size_t SCAN_INFO_BATCH_SIZE = 16;
+
+auto
+compare_labels (const FileDescriptor &a, const FileDescriptor &b)
+{
+  return a.label_ < b.label_;
+}
+}
+
 #if 0
 void
 FileManager::add_volume (GVolume * vol)
@@ -67,8 +85,19 @@ FileManager::add_volume (GVolume * vol)
 }
 #endif
 
-FileManager::FileManager ()
+FileManager::FileManager (QObject * parent)
+    : QObject (parent), file_info_cache_ (std::make_shared<FileInfoCache> ()),
+      persist_file_info_cache_ (ZRYTHM_HAVE_UI && !ZRYTHM_TESTING)
 {
+  QObject::connect (
+    &scan_watcher_, &QFutureWatcher<ScanBatch>::resultsReadyAt, this,
+    &FileManager::apply_scan_results);
+  QObject::connect (
+    &scan_watcher_, &QFutureWatcher<ScanBatch>::finished, this, [this] () {
+      z_info ("Total files: {}", files.size ());
+      Q_EMIT filesLoaded ();
+    });
+
   /* add standard locations */
   FileBrowserLocation fl = FileBrowserLocation (
     /* TRANSLATORS: Home directory */
@@ -176,52 +205,195 @@ FileManager::FileManager ()
 void
 FileManager::load_files_from_location (FileBrowserLocation &location)
 {
+  if (scan_watcher_.isRunning ())
+    scan_watcher_.cancel ();
+
   files.clear ();
 
-      /* create special parent dir entry */
+  /* create special parent dir entry */
+  {
+    auto           parent_dir = fs::path (location.path_).parent_path ();
+    FileDescriptor fd;
+    fd.abs_path_ = parent_dir.string ();
+    fd.type_ = FileType::ParentDirectory;
+    fd.hidden_ = false;
+    fd.label_ = "..";
+    if (fd.abs_path_.length () > 1)
       {
-        auto parent_dir = fs::path (location.path_).parent_path ();
-        FileDescriptor fd;
-        fd.abs_path_ = parent_dir.string ();
-        fd.type_ = FileType::ParentDirectory;
-        fd.hidden_ = false;
-        fd.label_ = "..";
-        if (fd.abs_path_.length () > 1)
+        files.push_back (fd);
+      }
+  }
+  Q_EMIT filesChanged ();
+
+  scan_watcher_.setFuture (QtConcurrent::run (
+    &FileManager::scan_directory, location.path_, file_info_cache_,
+    persist_file_info_cache_));
+}
+
+void
+FileManager::scan_directory (
+  QPromise<ScanBatch>           &promise,
+  const fs::path                &dir,
+  std::shared_ptr<FileInfoCache> cache,
+  bool                           persist_cache)
+{
+  if (persist_cache)
+    cache->ensure_read_from_file ();
+
+  /* list the files first so they show up before their metadata is read */
+  std::vector<std::pair<FileDescriptor, int64_t>> without_info;
+  ScanBatch                                       batch;
+  std::error_code                                 ec;
+  for (fs::directory_iterator it (dir, ec), end; !ec && it != end;
+       it.increment (ec))
+    {
+      if (promise.isCanceled ())
+        return;
+
+      const auto    &absolute_path = it->path ();
+      FileDescriptor fd;
+      fd.abs_path_ = absolute_path.string ();
+      fd.label_ = absolute_path.filename ().string ();
+      fd.hidden_ = utils::io::is_file_hidden (absolute_path);
+      std::error_code type_ec;
+      if (it->is_directory (type_ec))
+        {
+          fd.type_ = FileType::Directory;
+        }
+      else
+        {
+          fd.type_ = FileDescriptor::get_type_from_path (absolute_path);
+        }
+
+      if (fd.is_audio ())
+        {
+          const auto mtime = CachedFileInfo::get_mtime (absolute_path);
+          if (auto info = cache->find (fd.abs_path_, mtime))
+            {
+              fd.metadata_ = info->get_metadata ();
+              fd.peaks_ = std::move (info->peaks_);
+              fd.detected_bpm_ = info->detected_bpm_;
+            }
+          else
+            {
+              without_info.emplace_back (fd, mtime);
+            }
+        }
+
+      batch.added_.push_back (std::move (fd));
+      if (batch.added_.size () >= SCAN_BATCH_SIZE)
+        {
+          promise.addResult (std::move (batch));
+          batch = {};
+        }
+    }
+  if (ec)
+    {
+      z_warning ("Failed to list {}: {}", dir, ec.message ());
+    }
+  if (!batch.added_.empty ())
+    {
+      promise.addResult (std::move (batch));
+      batch = {};
+    }
+
+  /* read the infos of each batch of files in parallel (this decodes short
+   * files whole, for their thumbnails and tempo) */
+  for (size_t begin = 0; begin < without_info.size ();
+       begin += SCAN_INFO_BATCH_SIZE)
+    {
+      if (promise.isCanceled ())
+        break;
+
+      struct ToRead
+      {
+        FileDescriptor *              fd_;
+        int64_t                       mtime_;
+        std::optional<CachedFileInfo> info_;
+      };
+      const auto end =
+        std::min (begin + SCAN_INFO_BATCH_SIZE, without_info.size ());
+      std::vector<ToRead> to_read;
+      for (auto i = begin; i < end; ++i)
+        {
+          auto &[fd, mtime] = without_info[i];
+          to_read.push_back ({ &fd, mtime, std::nullopt });
+        }
+      QtConcurrent::blockingMap (to_read, [&promise] (ToRead &file) {
+        if (promise.isCanceled ())
+          return;
+
+        try
           {
-            files.push_back (fd);
+            file.info_ =
+              CachedFileInfo::read (file.fd_->abs_path_, file.mtime_);
           }
-      }
+        catch (const ZrythmException &e)
+          {
+            z_debug (
+              "Failed to read metadata of {}: {}", file.fd_->abs_path_,
+              e.what ());
+          }
+      });
 
-      for (const auto &file : fs::directory_iterator (location.path_))
+      for (auto &file : to_read)
         {
-          FileDescriptor fd;
+          if (!file.info_)
+            continue;
+
+          auto &fd = *file.fd_;
+          fd.metadata_ = file.info_->get_metadata ();
+          fd.peaks_ = file.info_->peaks_;
+          fd.detected_bpm_ = file.info_->detected_bpm_;
+          cache->add (std::move (*file.info_));
+          batch.updated_.push_back (std::move (fd));
+        }
+      if (!batch.updated_.empty ())
+        {
+          promise.addResult (std::move (batch));
+          batch = {};
+        }
+    }
 
-          /* set absolute path & label */
-          auto absolute_path = file.path ();
-          fd.abs_path_ = absolute_path.string ();
-          fd.label_ = file.path ().filename ().string ();
+  if (persist_cache && cache->is_dirty ())
+    cache->serialize_to_file_no_throw ();
+}
 
-          fd.hidden_ = utils::io::is_file_hidden (absolute_path);
+void
+FileManager::apply_scan_results (int begin, int end)
+{
+  for (int i = begin; i < end; ++i)
+    {
+      auto batch = scan_watcher_.resultAt (i);
 
-          /* set type */
-          if (fs::is_directory (absolute_path))
+      /* keep the files sorted alphabetically */
+      if (!batch.added_.empty ())
+        {
+          std::ranges::sort (batch.added_, compare_labels);
+          const auto num_sorted = static_cast<ptrdiff_t> (files.size ());
+          std::ranges::move (batch.added_, std::back_inserter (files));
+          std::inplace_merge (
+            files.begin (), files.begin () + num_sorted, files.end (),
+            compare_labels);
+        }
+
+      if (!batch.updated_.empty ())
+        {
+          std::unordered_map<std::string, size_t> indices;
+          for (size_t j = 0; j < files.size (); ++j)
             {
-              fd.type_ = FileType::Directory;
+              indices[files[j].abs_path_] = j;
             }
-          else
+          for (auto &fd : batch.updated_)
             {
-              fd.type_ = FileDescriptor::get_type_from_path (file);
+              const auto it = indices.find (fd.abs_path_);
+              if (it != indices.end ())
+                files[it->second] = std::move (fd);
             }
-
-          /* add to list */
-          files.push_back (fd);
         }
+    }
 
-  /* sort alphabetically */
-  std::sort (files.begin (), files.end (), [] (const auto &a, const auto &b) {
-    return a.label_ < b.label_;
-  });
-  z_info ("Total files: {}", files.size ());
+  Q_EMIT filesChanged ();
 }
 
 void
@@ -10,7 +10,10 @@
 #include <vector>
 
 #include "gui/backend/io/file_descriptor.h"
+#include "gui/backend/io/file_info_cache.h"
 
+#include <QFutureWatcher>
+#include <QPromise>
 #include <QString>
 
 /**
@@ -96,17 +99,42 @@ enum class FileBrowserSelectionType
  * Manages the file browser functionality, including loading files, setting the
  * current selection, adding and removing locations (bookmarks), and saving
  * the locations.
+ *
+ * Files are loaded by a background scan that adds them to @ref files in
+ * batches, then reads the metadata of audio files. Metadata and waveform
+ * thumbnails are cached in a FileInfoCache, so revisiting a folder doesn't read
+ * the files again.
  */
-class FileManager
+class FileManager : public QObject
 {
+  Q_OBJECT
+
 public:
-  FileManager ();
+  /**
+   * Files found by a background scan.
+   */
+  struct ScanBatch
+  {
+    /** Files to add. */
+    std::vector<FileDescriptor> added_;
+
+    /** Files whose metadata was read, to replace the ones with their path. */
+    std::vector<FileDescriptor> updated_;
+  };
+
+  FileManager (QObject * parent = nullptr);
 
   /**
-   * Loads the files under the current selection.
+   * Starts loading the files under the current selection in the background,
+   * cancelling any previous load.
    */
   void load_files ();
 
+  /**
+   * Returns whether files are still being loaded.
+   */
+  bool is_loading () const { return scan_watcher_.isRunning (); }
+
   /**
    * Sets the current selection and optionally loads the files and saves the
    * location to the settings.
@@ -137,6 +165,17 @@ public:
   void
   remove_location_and_save (const fs::path &location, bool skip_if_standard);
 
+Q_SIGNALS:
+  /**
+   * Emitted when files were added to or updated in @ref files.
+   */
+  void filesChanged ();
+
+  /**
+   * Emitted when the files under the current selection are fully loaded.
+   */
+  void filesLoaded ();
+
 private:
   /**
    * Saves the current locations (bookmarks) to the settings.
@@ -144,12 +183,29 @@ private:
   void save_locations ();
 
   /**
-   * Loads the files from the given file browser location.
+   * Starts loading the files from the given file browser location.
    *
    * @param location The location to load the files from.
    */
   void load_files_from_location (FileBrowserLocation &location);
 
+  /**
+   * Lists @p dir and reads the metadata of its audio files, reporting the
+   * results to @p promise in batches.
+   *
+   * Runs on a worker thread.
+   */
+  static void scan_directory (
+    QPromise<ScanBatch>           &promise,
+    const fs::path                &dir,
+    std::shared_ptr<FileInfoCache> cache,
+    bool                           persist_cache);
+
+  /**
+   * Merges the given scan results into @ref files.
+   */
+  void apply_scan_results (int begin, int end);
+
   // void add_volume (GVolume * vol);
 
 public:
@@ -168,6 +224,15 @@ public:
    * The current selection in the top window.
    */
   std::unique_ptr<FileBrowserLocation> selection;
+
+private:
+  QFutureWatcher<ScanBatch> scan_watcher_;
+
+  /** Shared with the scans, which may outlive this. */
+  std::shared_ptr<FileInfoCache> file_info_cache_;
+
+  /** Whether to read and write the cache file. */
+  bool persist_file_info_cache_ = false;
 };
 
 /**
@@ -4,8 +4,11 @@
 #include "zrythm-config.h"
 
 #include <filesystem>
+#include <future>
+#include <thread>
 
 #include "gui/backend/backend/project.h"
+#include "gui/backend/backend/settings_manager.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/backend/project_manager.h"
 #include "gui/backend/ui.h"
@@ -15,13 +18,16 @@
 #include "gui/dsp/router.h"
 #include "gui/dsp/tracklist.h"
 #include "gui/dsp/transport.h"
+#include "utils/compression.h"
 #include "utils/datetime.h"
 #include "utils/exceptions.h"
 #include "utils/gtest_wrapper.h"
 #include "utils/io.h"
 #include "utils/logger.h"
 #include "utils/objects.h"
+#include "utils/phase_timer.h"
 #include "utils/progress_info.h"
+#include "utils/tracing.h"
 
 #include "juce_wrapper.h"
 #include <fmt/printf.h>
@@ -79,6 +85,12 @@ Project::Project (const std::string &title, QObject * parent) : Project (parent)
 
 Project::~Project ()
 {
+  if (action_journal_)
+    {
+      undo_manager_->set_journal (nullptr);
+      action_journal_.reset ();
+    }
+  plugin_loader_.reset ();
   loaded_ = false;
 }
 
@@ -161,6 +173,8 @@ Project::is_audio_clip_in_use (const AudioClip &clip, bool check_undo_stack) con
         return std::visit (
           [&] (auto &&track) {
             using TrackT = base_type<decltype (track)>;
+            if (track->frozen_ && track->pool_id_ == clip.get_pool_id ())
+              return true;
             if constexpr (std::is_same_v<TrackT, AudioTrack>)
               {
                 for (auto &lane_var : track->lanes_)
@@ -334,21 +348,66 @@ Project::compress_or_decompress (
         {
           throw ZrythmException ("Project not compressed by zstd");
         }
-      dest = (char *) malloc ((size_t) frame_content_size);
-      dest_size = ZSTD_decompress (
-        dest, frame_content_size, src.constData (), src.size ());
-      if (ZSTD_isError (dest_size))
+#if !(ZSTD_VERSION_MAJOR == 1 && ZSTD_VERSION_MINOR < 3)
+      /* projects saved in streaming mode don't record their size */
+      if (frame_content_size == ZSTD_CONTENTSIZE_UNKNOWN)
         {
-          free (dest);
-          throw ZrythmException (format_str (
-            "Failed to decompress project file: {}",
-            ZSTD_getErrorName (dest_size)));
+          ZSTD_DCtx *   dctx = ZSTD_createDCtx ();
+          ZSTD_inBuffer in{ src.constData (), (size_t) src.size (), 0 };
+          size_t        capacity = std::max<size_t> (
+            ZSTD_DStreamOutSize (), (size_t) src.size () * 4);
+          dest = (char *) malloc (capacity);
+          size_t ret = 1;
+          while (in.pos < in.size || ret != 0)
+            {
+              if (dest_size == capacity)
+                {
+                  capacity *= 2;
+                  dest = (char *) realloc (dest, capacity);
+                }
+              ZSTD_outBuffer out{ dest, capacity, dest_size };
+              ret = ZSTD_decompressStream (dctx, &out, &in);
+              if (ZSTD_isError (ret))
+                {
+                  free (dest);
+                  ZSTD_freeDCtx (dctx);
+                  throw ZrythmException (format_str (
+                    "Failed to decompress project file: {}",
+                    ZSTD_getErrorName (ret)));
+                }
+              dest_size = out.pos;
+
+              /* all input consumed with room left but the frame is not
+               * complete */
+              if (in.pos == in.size && ret != 0 && dest_size < capacity)
+                {
+                  free (dest);
+                  ZSTD_freeDCtx (dctx);
+                  throw ZrythmException (
+                    "Failed to decompress project file: truncated data");
+                }
+            }
+          ZSTD_freeDCtx (dctx);
         }
-      if (dest_size != frame_content_size)
+      else
+#endif
         {
-          free (dest);
-          /* impossible because zstd will check this condition */
-          throw ZrythmException ("uncompressed_size != frame_content_size");
+          dest = (char *) malloc ((size_t) frame_content_size);
+          dest_size = ZSTD_decompress (
+            dest, frame_content_size, src.constData (), src.size ());
+          if (ZSTD_isError (dest_size))
+            {
+              free (dest);
+              throw ZrythmException (format_str (
+                "Failed to decompress project file: {}",
+                ZSTD_getErrorName (dest_size)));
+            }
+          if (dest_size != frame_content_size)
+            {
+              free (dest);
+              /* impossible because zstd will check this condition */
+              throw ZrythmException ("uncompressed_size != frame_content_size");
+            }
         }
     }
 
@@ -443,6 +502,96 @@ Project::activate ()
   z_debug ("Project {} ({:p}) activated", title_, fmt::ptr (this));
 }
 
+void
+Project::open_action_journal (const fs::path &base_file)
+{
+  if (
+    ZRYTHM_TESTING || ZRYTHM_BENCHMARKING
+    || !zrythm::gui::SettingsManager::get_instance ()->get_journalActions ())
+    {
+      return;
+    }
+
+  undo_manager_->set_journal (nullptr);
+  action_journal_.reset ();
+  try
+    {
+      action_journal_ = std::make_unique<gui::actions::ActionJournal> (
+        get_path (ProjectPath::ActionJournal, false), base_file);
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("Failed to open action journal: {}", e.what ());
+      return;
+    }
+
+  /* replay the actions applied after the project was last saved */
+  auto records = action_journal_->take_pending_records ();
+  for (const auto &record : records)
+    {
+      using RecordType = gui::actions::ActionJournal::RecordType;
+      try
+        {
+          switch (record.type_)
+            {
+            case RecordType::Perform:
+              {
+                auto action =
+                  gui::actions::ActionJournal::deserialize_action (record);
+                std::visit (
+                  [&] (auto * ptr) {
+                    ptr->init_loaded (audio_engine_->sample_rate_);
+                  },
+                  action);
+                undo_manager_->perform (std::visit (
+                  [] (auto * ptr) -> QObject * { return ptr; }, action));
+              }
+              break;
+            case RecordType::Undo:
+              undo_manager_->undo ();
+              break;
+            case RecordType::Redo:
+              undo_manager_->redo ();
+              break;
+            }
+        }
+      catch (const ZrythmException &e)
+        {
+          /* the remaining records depend on this one */
+          z_warning (
+            "Failed to replay action journal record at {}: {}", record.offset_,
+            e.what ());
+          action_journal_->truncate (record.offset_);
+          break;
+        }
+    }
+  if (!records.empty ())
+    {
+      z_info ("Replayed {} actions from the action journal", records.size ());
+    }
+
+  undo_manager_->set_journal (action_journal_.get ());
+
+  /* compact the journal by saving a backup, which the journal is then rebased
+   * on */
+  QObject::disconnect (
+    undo_manager_, &gui::actions::UndoManager::journalCompactionNeeded, this,
+    nullptr);
+  QObject::connect (
+    undo_manager_, &gui::actions::UndoManager::journalCompactionNeeded, this,
+    [this] () {
+      try
+        {
+          save (dir_.string (), true, false, true);
+        }
+      catch (const ZrythmException &e)
+        {
+          z_warning ("Failed to compact action journal: {}", e.what ());
+        }
+    },
+    Qt::QueuedConnection);
+}
+
 void
 Project::add_default_tracks ()
 {
@@ -501,8 +650,11 @@ Project::add_default_tracks ()
 }
 
 bool
-Project::validate () const
+Project::validate (ValidationMode mode) const
 {
+  if (mode == ValidationMode::Skip)
+    return true;
+
   z_debug ("validating project...");
 
 #if 0
@@ -522,7 +674,10 @@ Project::validate () const
   free (ports);
 #endif
 
-  if (!tracklist_->validate ())
+  /* number of tracks a sampled validation checks one of */
+  constexpr size_t sample_stride = 4;
+  if (!tracklist_->validate (
+        mode == ValidationMode::Sampled ? sample_stride : 1))
     return false;
 
   region_link_group_manager_.validate ();
@@ -635,40 +790,20 @@ Project::get_existing_uncompressed_text (bool backup)
   std::string project_file_path = get_path (ProjectPath::ProjectFile, backup);
   z_debug ("getting text for project file {}", project_file_path);
 
-  QByteArray compressed_pj{};
-  try
-    {
-      compressed_pj = utils::io::read_file_contents (project_file_path);
-    }
-  catch (const ZrythmException &e)
-    {
-      throw ZrythmException (format_qstr (
-        QObject::tr ("Unable to read file at {}: {}"), project_file_path,
-        e.what ()));
-    }
-
-  /* decompress */
+  /* decompress while reading, so that the compressed file is never held in
+   * memory as a whole */
   z_info ("decompressing project...");
-  char * text = nullptr;
-  size_t text_size = 0;
+  std::string ret;
   try
     {
-      decompress (
-        &text, &text_size, PROJECT_DECOMPRESS_DATA, compressed_pj.constData (),
-        compressed_pj.size (), PROJECT_DECOMPRESS_DATA);
+      ret = utils::compression::decompress_file (project_file_path);
     }
-  catch (ZrythmException &e)
+  catch (const ZrythmException &e)
     {
       throw ZrythmException (format_qstr (
-        QObject::tr ("Unable to decompress project file at {}"),
-        project_file_path));
+        QObject::tr ("Unable to decompress project file at {}: {}"),
+        project_file_path, e.what ()));
     }
-
-  /* make string null-terminated */
-  text = (char *) realloc (text, text_size + sizeof (char));
-  text[text_size] = '\0';
-  std::string ret (text);
-  free (text);
   return ret;
 }
 
@@ -810,10 +945,18 @@ Project::get_path (ProjectPath path, bool backup)
       break;
     case ProjectPath::POOL:
       return dir / PROJECT_POOL_DIR;
+    case ProjectPath::POOL_DECODED_CACHE:
+      return dir / PROJECT_POOL_DIR / PROJECT_POOL_DECODED_CACHE_DIR;
+    case ProjectPath::POOL_PEAKS:
+      return dir / PROJECT_POOL_DIR / PROJECT_POOL_PEAKS_DIR;
     case ProjectPath::ProjectFile:
       return dir / PROJECT_FILE;
     case ProjectPath::FINISHED_FILE:
       return dir / PROJECT_FINISHED_FILE;
+    case ProjectPath::ActionJournal:
+      return dir / PROJECT_ACTION_JOURNAL_FILE;
+    case ProjectPath::LoadReport:
+      return dir / PROJECT_LOAD_REPORT_FILE;
     default:
       z_return_val_if_reached ({});
     }
@@ -834,60 +977,61 @@ Project::SerializeProjectThread::~SerializeProjectThread ()
 void
 Project::SerializeProjectThread::run ()
 {
-  char * compressed_json{};
-  size_t compressed_size{};
-
-  /* generate json */
-  z_debug ("serializing project to json...");
-  auto   time_before = Zrythm::getInstance ()->get_monotonic_time_usecs ();
-  qint64 time_after{};
-  std::optional<utils::string::CStringRAII> json;
-  try
-    {
-      json = ctx_.project_->serialize_to_json_string ();
-    }
-  catch (const ZrythmException &e)
-    {
-      e.handle ("Failed to serialize project");
-      ctx_.has_error_ = true;
-      goto serialize_end;
-    }
-  time_after = Zrythm::getInstance ()->get_monotonic_time_usecs ();
-  z_debug ("time to serialize: {}ms", (time_after - time_before) / 1000);
+  Z_TRACE_SET_THREAD_NAME ("SerializeProjectThread");
+  Z_TRACE_ZONE ("Project::SerializeProjectThread::run");
 
-  /* compress */
+  /* serialize straight into a streaming compressor that writes the file, so
+   * that neither the serialized nor the compressed project is held in memory
+   * as a whole */
+  z_debug (
+    "saving project file at {} ({}, compression level {})...",
+    ctx_.project_file_path_, ctx_.binary_ ? "binary" : "json",
+    ctx_.compression_level_);
+  auto time_before = Zrythm::getInstance ()->get_monotonic_time_usecs ();
   try
     {
-      compress (
-        &compressed_json, &compressed_size,
-        ProjectCompressionFlag::PROJECT_COMPRESS_DATA, json->c_str (),
-        strlen (json->c_str ()) * sizeof (char),
-        ProjectCompressionFlag::PROJECT_COMPRESS_DATA);
+      /* compress on other cores while serializing (leaving some for the
+       * audio engine) */
+      const int num_workers = std::max (
+        1, static_cast<int> (std::thread::hardware_concurrency ()) / 2);
+      utils::compression::StreamingFileCompressor compressor (
+        ctx_.project_file_path_, ctx_.compression_level_, num_workers);
+      const auto sink = [&compressor] (std::string_view chunk) {
+        compressor.write (chunk);
+      };
+      {
+        Z_TRACE_ZONE ("Project::serialize");
+        if (ctx_.binary_)
+          {
+            ctx_.project_->serialize_to_binary (sink);
+          }
+        else
+          {
+            ctx_.project_->serialize_to_json (sink);
+          }
+      }
+      {
+        Z_TRACE_ZONE ("StreamingFileCompressor::finish");
+        compressor.finish ();
+      }
+      z_debug (
+        "Compression : {} bytes -> {} bytes", compressor.get_total_in (),
+        compressor.get_total_out ());
     }
-  catch (const ZrythmException &ex)
+  catch (const ZrythmException &e)
     {
-      ex.handle (QObject::tr ("Failed to compress project file"));
+      e.handle ("Failed to save project");
       ctx_.has_error_ = true;
-      goto serialize_end;
     }
 
-  /* set file contents */
-  z_debug ("saving project file at {}...", ctx_.project_file_path_);
-  try
-    {
-      utils::io::set_file_contents (
-        ctx_.project_file_path_, compressed_json, compressed_size);
-    }
-  catch (const ZrythmException &e)
+  if (!ctx_.has_error_)
     {
-      ctx_.has_error_ = true;
-      z_error ("Unable to write project file: {}", e.what ());
+      auto time_after = Zrythm::getInstance ()->get_monotonic_time_usecs ();
+      z_debug (
+        "successfully saved project in {}ms",
+        (time_after - time_before) / 1000);
     }
-  free (compressed_json);
-
-  z_debug ("successfully saved project");
 
-serialize_end:
   ctx_.main_project_->undo_manager_->action_sem_.release ();
   ctx_.finished_.store (true);
 }
@@ -930,11 +1074,111 @@ Project::idle_saved_callback (SaveContext * ctx)
     }
 #endif
 
+  /* drop the journaled actions now included in the saved project */
+  auto * main_project = ctx->main_project_;
+  if (!ctx->has_error_ && main_project->action_journal_)
+    {
+      if (
+        main_project->action_journal_->get_path ()
+        == main_project->get_path (ProjectPath::ActionJournal, false))
+        {
+          main_project->action_journal_->rebase (
+            ctx->project_file_path_, ctx->journal_checkpoint_);
+        }
+      else
+        {
+          /* saved to another dir */
+          main_project->open_action_journal (ctx->project_file_path_);
+        }
+    }
+
   ctx->progress_info_.mark_completed (ProgressInfo::CompletionType::SUCCESS, {});
 
   return false;
 }
 
+void
+Project::save_plugin_states ()
+{
+  std::vector<gui::old_dsp::plugins::Plugin *> worker_plugins;
+  std::vector<gui::old_dsp::plugins::Plugin *> main_thread_plugins;
+  for (const auto &pl_var : get_plugin_registry ().get_hash_map ().values ())
+    {
+      std::visit (
+        [&] (auto &&pl) {
+          if (!pl->instantiated_ || !pl->state_needs_saving ())
+            return;
+
+          if (pl->requires_main_thread_instantiation ())
+            main_thread_plugins.push_back (pl);
+          else
+            worker_plugins.push_back (pl);
+        },
+        pl_var);
+    }
+
+  z_debug (
+    "saving {} changed plugin states ({} on the calling thread)",
+    worker_plugins.size () + main_thread_plugins.size (),
+    main_thread_plugins.size ());
+
+  std::atomic<size_t> next_plugin = 0;
+  std::mutex          error_mutex;
+  std::string         error_message;
+  auto                save_next_plugins = [&] () {
+    while (true)
+      {
+        const auto idx = next_plugin.fetch_add (1);
+        if (idx >= worker_plugins.size ())
+          break;
+
+        try
+          {
+            worker_plugins[idx]->save_state_if_changed ();
+          }
+        catch (const ZrythmException &e)
+          {
+            std::lock_guard lock (error_mutex);
+            error_message = e.what ();
+          }
+      }
+  };
+
+  const auto num_workers = std::min (
+    static_cast<size_t> (juce::SystemStats::getNumCpus ()),
+    worker_plugins.size ());
+  std::vector<std::future<void>> workers;
+  for (size_t i = 0; i < num_workers; ++i)
+    {
+      workers.emplace_back (std::async (std::launch::async, save_next_plugins));
+    }
+
+  /* meanwhile, save the plugins that must be used from this thread */
+  for (auto * pl : main_thread_plugins)
+    {
+      try
+        {
+          pl->save_state_if_changed ();
+        }
+      catch (const ZrythmException &e)
+        {
+          std::lock_guard lock (error_mutex);
+          error_message = e.what ();
+        }
+    }
+
+  for (auto &worker : workers)
+    {
+      worker.get ();
+    }
+
+  if (!error_message.empty ())
+    {
+      throw ZrythmException (
+        fmt::format ("Failed to save plugin state: {}", error_message));
+    }
+}
+
 void
 Project::cleanup_plugin_state_dirs (Project &main_project, bool is_backup)
 {
@@ -1000,12 +1244,15 @@ Project::save (
     "Saving project at {}, is backup: {}, show notification: {}, async: {}",
     _dir, is_backup, show_notification, async);
 
+  utils::PhaseTimer phase_timer ("project save");
+
   /* pause engine */
   AudioEngine::State state{};
   bool               engine_paused = false;
   z_return_if_fail (audio_engine_);
   if (audio_engine_->activated_)
     {
+      auto phase = phase_timer.scope ("pause engine");
       audio_engine_->wait_for_pause (state, false, true);
       engine_paused = true;
     }
@@ -1066,19 +1313,45 @@ Project::save (
       throw ZrythmException ("Failed to create project directories");
     }
 
-  if (this == get_active_instance ())
+  /* clips may still be loading in the background after loading the project */
+  try
+    {
+      auto phase = phase_timer.scope ("wait for clips");
+      audio_engine_->pool_->wait_until_loaded ();
+    }
+  catch (const ZrythmException &e)
     {
-      /* write the pool */
-      audio_engine_->pool_->remove_unused (is_backup);
+      z_warning ("some clips failed to load: {}", e.what ());
     }
 
+  {
+    auto phase = phase_timer.scope ("write pool");
+    if (this == get_active_instance ())
+      {
+        /* write the pool */
+        audio_engine_->pool_->remove_unused (is_backup);
+      }
+
+    try
+      {
+        audio_engine_->pool_->write_to_disk (is_backup);
+      }
+    catch (const ZrythmException &e)
+      {
+        throw ZrythmException ("Failed to write audio pool to disk");
+      }
+  }
+
+  /* save the changed plugin states before cloning (which would otherwise
+   * save them one by one) */
   try
     {
-      audio_engine_->pool_->write_to_disk (is_backup);
+      auto phase = phase_timer.scope ("save plugin states");
+      save_plugin_states ();
     }
   catch (const ZrythmException &e)
     {
-      throw ZrythmException ("Failed to write audio pool to disk");
+      throw ZrythmException (QObject::tr ("Failed to save plugin states"));
     }
 
   auto ctx = std::make_unique<SaveContext> ();
@@ -1086,18 +1359,39 @@ Project::save (
   ctx->project_file_path_ = get_path (ProjectPath::ProjectFile, is_backup);
   ctx->show_notification_ = show_notification;
   ctx->is_backup_ = is_backup;
+  if (!ZRYTHM_TESTING && !ZRYTHM_BENCHMARKING)
+    {
+      auto * settings = zrythm::gui::SettingsManager::get_instance ();
+      ctx->binary_ = settings->get_saveProjectsAsBinary ();
+      ctx->compression_level_ =
+        is_backup ? settings->get_backupCompressionLevel ()
+                  : settings->get_projectCompressionLevel ();
+    }
+  /* the clone shares the undo history, so keep the undo manager locked until
+   * it's serialized (SerializeProjectThread releases it) */
   if (ZRYTHM_IS_QT_THREAD)
     {
+      if (!async)
+        undo_manager_->action_sem_.acquire ();
+      if (action_journal_)
+        ctx->journal_checkpoint_ = action_journal_->checkpoint ();
+      auto phase = phase_timer.scope ("clone");
       ctx->project_ = std::unique_ptr<Project> (clone (is_backup));
     }
   else
     {
+      auto       phase = phase_timer.scope ("clone");
       Project *  cloned_prj = nullptr;
       QThread *  currentThread = QThread::currentThread ();
       QEventLoop loop;
       QMetaObject::invokeMethod (
         QCoreApplication::instance (),
-        [this, currentThread, is_backup, &cloned_prj, &loop] () {
+        [this, currentThread, is_backup, async, &cloned_prj, &ctx,
+         &loop] () {
+          if (!async)
+            undo_manager_->action_sem_.acquire ();
+          if (action_journal_)
+            ctx->journal_checkpoint_ = action_journal_->checkpoint ();
           cloned_prj = clone (is_backup);
 
           // need to move the temporary cloned project to the outer scope's
@@ -1134,45 +1428,49 @@ Project::save (
 
   /* TODO verify all plugin states exist */
 
-  if (async)
-    {
-      SerializeProjectThread save_thread (*ctx);
+  {
+    auto phase = phase_timer.scope ("serialize");
+    if (async)
+      {
+        SerializeProjectThread save_thread (*ctx);
 
-      /* TODO: show progress dialog */
-      if (ZRYTHM_HAVE_UI && false)
-        {
-          auto timer = new QTimer (this);
-          QObject::connect (timer, &QTimer::timeout, this, [timer, &ctx] () {
-            bool keep_calling = idle_saved_callback (ctx.get ());
-            if (!keep_calling)
+        /* TODO: show progress dialog */
+        if (ZRYTHM_HAVE_UI && false)
+          {
+            auto timer = new QTimer (this);
+            QObject::connect (
+              timer, &QTimer::timeout, this, [timer, &ctx] () {
+                bool keep_calling = idle_saved_callback (ctx.get ());
+                if (!keep_calling)
+                  {
+                    timer->stop ();
+                    timer->deleteLater ();
+                  }
+              });
+            timer->start (100);
+
+            /* show progress while saving (TODO) */
+          }
+        else
+          {
+            while (!ctx->finished_.load ())
               {
-                timer->stop ();
-                timer->deleteLater ();
+                std::this_thread::sleep_for (std::chrono::milliseconds (1));
               }
-          });
-          timer->start (100);
-
-          /* show progress while saving (TODO) */
-        }
-      else
-        {
-          while (!ctx->finished_.load ())
-            {
-              std::this_thread::sleep_for (std::chrono::milliseconds (1));
-            }
-          idle_saved_callback (ctx.get ());
-        }
-    }
-  else /* else if no async */
-    {
-      /* call synchronously */
-      SerializeProjectThread save_thread (*ctx);
-      while (save_thread.isThreadRunning ())
-        {
-          std::this_thread::sleep_for (std::chrono::milliseconds (1));
-        }
-      idle_saved_callback (ctx.get ());
-    }
+            idle_saved_callback (ctx.get ());
+          }
+      }
+    else /* else if no async */
+      {
+        /* call synchronously */
+        SerializeProjectThread save_thread (*ctx);
+        while (save_thread.isThreadRunning ())
+          {
+            std::this_thread::sleep_for (std::chrono::milliseconds (1));
+          }
+        idle_saved_callback (ctx.get ());
+      }
+  }
 
   /* write FINISHED file */
   {
@@ -1180,8 +1478,9 @@ Project::save (
     utils::io::touch_file (finished_file_path);
   }
 
+  /* the project was validated before saving, so only spot-check it */
   if (ZRYTHM_TESTING)
-    tracklist_->validate ();
+    validate (ValidationMode::Sampled);
 
   auto last_action = undo_manager_->get_last_action ();
   if (is_backup)
@@ -1201,6 +1500,7 @@ Project::save (
   z_info (
     "Saved project at {}, is backup: {}, show notification: {}, async: {}",
     _dir, is_backup, show_notification, async);
+  z_info ("{}", phase_timer.get_summary ());
 }
 
 bool
@@ -4,6 +4,7 @@
 #ifndef GUI_BACKEND_PROJECT_H
 #define GUI_BACKEND_PROJECT_H
 
+#include "gui/backend/backend/actions/action_journal.h"
 #include "gui/backend/backend/actions/undo_manager.h"
 #include "gui/backend/backend/clip_editor.h"
 #include "gui/backend/backend/timeline.h"
@@ -11,6 +12,7 @@
 #include "gui/dsp/engine.h"
 #include "gui/dsp/midi_mapping.h"
 #include "gui/dsp/plugin.h"
+#include "gui/dsp/plugin_loader.h"
 #include "gui/dsp/port.h"
 #include "gui/dsp/port_connections_manager.h"
 #include "gui/dsp/quantize_options.h"
@@ -35,7 +37,11 @@ constexpr const char * PROJECT_FILE = "project.zpj";
 #define PROJECT_EXPORTS_DIR "exports"
 #define PROJECT_STEMS_DIR "stems"
 #define PROJECT_POOL_DIR "pool"
+#define PROJECT_POOL_DECODED_CACHE_DIR "decoded"
+#define PROJECT_POOL_PEAKS_DIR "peaks"
 #define PROJECT_FINISHED_FILE "FINISHED"
+#define PROJECT_ACTION_JOURNAL_FILE "action-journal"
+#define PROJECT_LOAD_REPORT_FILE "load-report.json"
 
 enum class ProjectPath
 {
@@ -63,7 +69,20 @@ enum class ProjectPath
 
   POOL,
 
+  /** Decoded audio cache files, under the POOL dir. */
+  POOL_DECODED_CACHE,
+
+  /** Waveform peak files, under the POOL dir. */
+  POOL_PEAKS,
+
   FINISHED_FILE,
+
+  /** Journal of the actions applied since the last save (only exists in the
+   * main project dir). */
+  ActionJournal,
+
+  /** Timing of the phases of the last project load. */
+  LoadReport,
 };
 
 /**
@@ -178,10 +197,32 @@ public:
    */
   fs::path get_path (ProjectPath path, bool backup);
 
+  /**
+   * @brief How thoroughly validate() checks the project.
+   */
+  enum class ValidationMode
+  {
+    /** Check everything. */
+    Full,
+
+    /**
+     * Check a different subset of the tracks each time.
+     *
+     * For projects already known to be valid (e.g., ones validated just
+     * before), where a full pass would take too long.
+     */
+    Sampled,
+
+    /** Don't check anything (trusted projects). */
+    Skip,
+  };
+
   /**
    * Checks that everything is okay with the project.
+   *
+   * Tracks are checked in parallel and checking stops at the first problem.
    */
-  bool validate () const;
+  bool validate (ValidationMode mode = ValidationMode::Full) const;
 
   static Project * get_active_instance ();
 
@@ -282,7 +323,10 @@ public:
   }
 
   /**
-   * Returns the uncompressed text representation of the saved project file.
+   * Returns the uncompressed contents of the saved project file.
+   *
+   * This is either JSON text or a binary document (see
+   * utils::binary_json::is_binary()).
    *
    * @param backup Whether to use the project file from the most recent
    * backup.
@@ -322,6 +366,15 @@ public:
    */
   Q_INVOKABLE void activate ();
 
+  /**
+   * @brief Opens the action journal of the project, replaying any actions
+   * recorded on top of @p base_file (the project file that was loaded) in a
+   * previous session, and starts journaling new actions.
+   *
+   * To be called after activate().
+   */
+  void open_action_journal (const fs::path &base_file);
+
   /**
    * @brief Gets all the ports in the project.
    *
@@ -410,6 +463,17 @@ private:
    */
   void set_and_create_next_available_backup_dir ();
 
+  /**
+   * @brief Saves the states of the plugins that changed since they were last
+   * saved.
+   *
+   * Plugins that can be used from worker threads are saved in parallel. The
+   * engine must be paused.
+   *
+   * @throw ZrythmException If a plugin state could not be saved.
+   */
+  void save_plugin_states ();
+
   /**
    * Cleans up unnecessary plugin state dirs from the main project.
    *
@@ -438,6 +502,19 @@ private:
 
     bool is_backup_ = false;
 
+    /**
+     * @brief Whether to save in the binary format instead of JSON.
+     *
+     * @see utils::binary_json.
+     */
+    bool binary_ = false;
+
+    /** zstd compression level. */
+    int compression_level_ = 1;
+
+    /** Position in the action journal when the project was cloned. */
+    gui::actions::ActionJournal::Checkpoint journal_checkpoint_;
+
     /** To be set to true when the thread finishes. */
     std::atomic_bool finished_ = false;
 
@@ -552,6 +629,14 @@ public:
    */
   std::unique_ptr<AudioEngine> audio_engine_;
 
+  /**
+   * @brief Loads the project's plugins in parallel (only while the project is
+   * being loaded and its plugins are loading).
+   *
+   * Must be free'd before the tracklist and engine.
+   */
+  std::unique_ptr<gui::old_dsp::plugins::PluginLoader> plugin_loader_;
+
   /**
    * Timeline metadata like BPM, time signature, etc.
    */
@@ -594,6 +679,13 @@ public:
 
   gui::actions::UndoManager * undo_manager_ = nullptr;
 
+  /**
+   * @brief Journal of the actions applied since the last save, if enabled.
+   *
+   * @see open_action_journal().
+   */
+  std::unique_ptr<gui::actions::ActionJournal> action_journal_;
+
   /** Used when deserializing projects. */
   int format_major_ = 0;
   int format_minor_ = 0;
@@ -14,10 +14,12 @@
 #include "gui/backend/backend/zrythm.h"
 #include "gui/backend/project_manager.h"
 #include "gui/backend/ui.h"
+#include "gui/dsp/pool.h"
 #include "gui/dsp/router.h"
 #include "gui/dsp/tempo_track.h"
 #include "gui/dsp/tracklist.h"
 
+#include "utils/binary_json.h"
 #include "utils/datetime.h"
 #include "utils/flags.h"
 #include "utils/gtest_wrapper.h"
@@ -395,6 +397,7 @@ ProjectInitFlowManager::save_and_activate_after_successful_load_or_create ()
        * save the newly created project */
       if (is_template_ || filename_.empty ())
         {
+          auto phase = timer_.scope ("save new project");
           PROJECT->save (PROJECT->dir_, false, false, false);
         }
     }
@@ -404,10 +407,47 @@ ProjectInitFlowManager::save_and_activate_after_successful_load_or_create ()
       return;
     }
 
-  PROJECT->activate ();
+  {
+    auto phase = timer_.scope ("activate");
+    PROJECT->activate ();
+  }
+
+  {
+    auto phase = timer_.scope ("open action journal");
+
+    /* replay the actions of a previous session that weren't saved */
+    PROJECT->open_action_journal (
+      is_template_ || filename_.empty ()
+        ? PROJECT->get_path (ProjectPath::ProjectFile, false)
+        : loaded_project_file_);
+  }
+
+  write_load_report ();
+
   call_last_callback_success ();
 }
 
+void
+ProjectInitFlowManager::write_load_report ()
+{
+  z_info ("{}", timer_.get_summary ());
+
+  if (filename_.empty () || ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
+    return;
+
+  auto report_path = PROJECT->get_path (ProjectPath::LoadReport, false);
+  try
+    {
+      timer_.write_report (report_path);
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning (
+        "Failed to write project load report to {}: {}", report_path,
+        e.what ());
+    }
+}
+
 #if 0
 void
 ProjectInitFlowManager::replace_main_window (MainWindowWidget * mww)
@@ -433,10 +473,13 @@ ProjectInitFlowManager::continue_load_from_file_after_open_backup_response ()
 {
   bool use_backup = !PROJECT->backup_dir_.empty ();
   PROJECT->loading_from_backup_ = use_backup;
+  loaded_project_file_ =
+    PROJECT->get_path (ProjectPath::ProjectFile, use_backup);
 
   std::string text;
   try
     {
+      auto phase = timer_.scope ("decompress");
       text = PROJECT->get_existing_uncompressed_text (use_backup);
     }
   catch (const ZrythmException &e)
@@ -445,13 +488,20 @@ ProjectInitFlowManager::continue_load_from_file_after_open_backup_response ()
       return;
     }
 
+  /* binary projects are always in the current (JSON) schema */
+  const bool             is_binary = utils::binary_json::is_binary (text);
   struct yyjson_read_err json_read_err = {};
-  yyjson_doc *           doc = yyjson_read_opts (
-    // NOLINTNEXTLINE
-    const_cast<char *> (text.c_str ()), text.length (), YYJSON_READ_NOFLAG,
-    nullptr, &json_read_err);
-  bool json_read_success = doc != nullptr;
-  object_free_w_func_and_null (yyjson_doc_free, doc);
+  bool                   json_read_success = is_binary;
+  if (!is_binary)
+    {
+      auto         phase = timer_.scope ("validate JSON");
+      yyjson_doc * doc = yyjson_read_opts (
+        // NOLINTNEXTLINE
+        const_cast<char *> (text.c_str ()), text.length (), YYJSON_READ_NOFLAG,
+        nullptr, &json_read_err);
+      json_read_success = doc != nullptr;
+      object_free_w_func_and_null (yyjson_doc_free, doc);
+    }
   [[maybe_unused]] bool upgraded = false;
   int                   yaml_schema_ver = -1;
   if (!json_read_success)
@@ -482,6 +532,7 @@ ProjectInitFlowManager::continue_load_from_file_after_open_backup_response ()
                 {
                   /* upgrade project */
 #if HAVE_CYAML
+                  auto   phase = timer_.scope ("upgrade schema");
                   char * txt_copy = strdup (text.c_str ());
                   upgrade_schema (&txt_copy, schema_ver);
                   text = txt_copy;
@@ -504,6 +555,7 @@ ProjectInitFlowManager::continue_load_from_file_after_open_backup_response ()
             {
               /* upgrade latest yaml to json */
 #if HAVE_CYAML
+              auto   phase = timer_.scope ("upgrade to JSON");
               char * txt_copy = strdup (text.c_str ());
               upgrade_to_json (&txt_copy);
               text = txt_copy;
@@ -534,11 +586,15 @@ ProjectInitFlowManager::continue_load_from_file_after_open_backup_response ()
   std::unique_ptr<Project> deserialized_project = std::make_unique<Project> ();
   try
     {
-      auto time_before = Zrythm::getInstance ()->get_monotonic_time_usecs ();
-      deserialized_project->deserialize_from_json_string (text.c_str ());
-      auto time_after = Zrythm::getInstance ()->get_monotonic_time_usecs ();
-      z_info (
-        "time to deserialize: {}ms", (long) (time_after - time_before) / 1000);
+      auto phase = timer_.scope ("deserialize");
+      if (is_binary)
+        {
+          deserialized_project->deserialize_from_binary (text);
+        }
+      else
+        {
+          deserialized_project->deserialize_from_json_string (text.c_str ());
+        }
     }
   catch (const ZrythmException &e)
     {
@@ -655,43 +711,85 @@ ProjectInitFlowManager::continue_load_from_file_after_open_backup_response ()
     z_warning ("error: {}", e.what ());
   };
 
+  {
+    auto phase = timer_.scope ("init engine");
+    try
+      {
+        auto * tempo_track = prj->tracklist_->tempo_track_;
+        if (!tempo_track)
+          {
+            tempo_track = get_tempo_track (prj);
+          }
+        if (!tempo_track)
+          {
+            throw ZrythmException ("Tempo track not found");
+          }
+
+        prj->transport_->init_loaded (prj, tempo_track);
+        prj->audio_engine_->init_loaded (prj);
+      }
+    catch (const ZrythmException &e)
+      {
+        handle_err (e);
+        return;
+      }
+    engine->pre_setup ();
+  }
+
+  /* load the clips now that the sample rate is known (it can change during
+   * engine pre setup), while initializing the rest of the project */
+  engine->pool_->start_init_loaded (engine, &clip_loading_progress_);
+
+  prj->clip_editor_->init_loaded ();
+
+  /* plugins are collected while initializing the tracklist and loaded in
+   * parallel */
+  prj->plugin_loader_ =
+    std::make_unique<gui::old_dsp::plugins::PluginLoader> (
+      &plugin_loading_progress_);
+
+  auto * tracklist = prj->tracklist_;
+  {
+    auto phase = timer_.scope ("init tracks");
+    tracklist->init_loaded (prj->get_port_registry (), *prj);
+  }
+
+  prj->plugin_loader_->start ();
+
+  /* only the clips of the visible tracks are needed now - the rest keep
+   * loading in the background (their regions are silent until loaded),
+   * except when the project needs to be complete */
   try
     {
-      auto * tempo_track = prj->tracklist_->tempo_track_;
-      if (!tempo_track)
+      auto phase = timer_.scope ("wait for clips");
+      if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
         {
-          tempo_track = get_tempo_track (prj);
+          engine->pool_->wait_until_loaded ();
         }
-      if (!tempo_track)
+      else
         {
-          throw ZrythmException ("Tempo track not found");
+          std::vector<AudioClip *> visible_clips;
+          for (const auto &track_var : tracklist->get_track_span ())
+            {
+              std::visit (
+                [&] (auto &&track) {
+                  if (!track->should_be_visible ())
+                    return;
+
+                  std::ranges::copy (
+                    AudioPool::get_clips_used_by_track (*track),
+                    std::back_inserter (visible_clips));
+                },
+                track_var);
+            }
+          engine->pool_->wait_until_clips_loaded (visible_clips);
         }
-
-      prj->transport_->init_loaded (prj, tempo_track);
-      prj->audio_engine_->init_loaded (prj);
     }
   catch (const ZrythmException &e)
     {
       handle_err (e);
       return;
     }
-  engine->pre_setup ();
-
-  /* re-load clips because sample rate can change during engine pre setup */
-  try
-    {
-      engine->pool_->init_loaded (engine);
-    }
-  catch (const ZrythmException &e)
-    {
-      handle_err (e);
-      return;
-    }
-
-  prj->clip_editor_->init_loaded ();
-
-  auto * tracklist = prj->tracklist_;
-  tracklist->init_loaded (prj->get_port_registry (), *prj);
 
   int beats_per_bar = tracklist->tempo_track_->get_beats_per_bar ();
   engine->update_frames_per_tick (
@@ -719,10 +817,24 @@ ProjectInitFlowManager::continue_load_from_file_after_open_backup_response ()
 
   // replace_main_window (mww);
 
+  /* the project is playable while the remaining plugins load (they are
+   * silent until loaded), except when the project needs to be complete */
+  if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
+    {
+      auto phase = timer_.scope ("wait for plugins");
+      prj->plugin_loader_->wait_until_loaded ();
+    }
+
   /* sanity check */
-  z_warn_if_fail (prj->validate ());
+  {
+    auto phase = timer_.scope ("validate");
+    z_warn_if_fail (prj->validate ());
+  }
 
-  engine->setup ();
+  {
+    auto phase = timer_.scope ("setup engine");
+    engine->setup ();
+  }
 
   /* init ports */
   std::vector<Port *> ports;
@@ -742,7 +854,10 @@ ProjectInitFlowManager::continue_load_from_file_after_open_backup_response ()
   z_debug ("project loaded");
 
   /* recalculate the routing graph */
-  engine->router_->recalc_graph (false);
+  {
+    auto phase = timer_.scope ("build graph");
+    engine->router_->recalc_graph (false);
+  }
 
 #if 0
   z_debug ("setting up main window...");
@@ -815,7 +930,7 @@ ProjectInitFlowManager::load_from_file ()
         {
           z_debug ("newer backup found {}", PROJECT->backup_dir_);
 
-          if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
+          if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING || ZRYTHM_RENDERING)
             {
               if (!gZrythm->open_newer_backup_)
                 {
@@ -884,6 +999,9 @@ ProjectInitFlowManager::ProjectInitFlowManager (
 
   append_callback (cb, user_data);
 
+  timer_.set_info ("version", Zrythm::get_version (false));
+  timer_.set_info ("file", filename_);
+
   if (!filename.empty ())
     {
       append_callback (load_from_file_ready_cb, this);
@@ -896,6 +1014,7 @@ ProjectInitFlowManager::ProjectInitFlowManager (
     {
       z_return_if_fail (gZrythm);
       // FIXME/TODO - it expects a reference to the active project here
+      auto phase = timer_.scope ("create default project");
       auto prj = std::make_unique<Project> ();
       create_default (prj, gZrythm->create_project_path_, false, true);
     }
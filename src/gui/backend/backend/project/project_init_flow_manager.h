@@ -16,6 +16,8 @@
 #include <string>
 #include <string_view>
 
+#include "utils/phase_timer.h"
+#include "utils/progress_info.h"
 #include "utils/types.h"
 
 class Project;
@@ -98,6 +100,13 @@ private:
    */
   void save_and_activate_after_successful_load_or_create ();
 
+  /**
+   * @brief Logs the phases timed while loading the project and, if loaded
+   * from a file, writes them next to the project (see
+   * ProjectPath::LoadReport).
+   */
+  void write_load_report ();
+
 #if HAVE_CYAML
   /**
    * Upgrades the given project YAML's schema if needed.
@@ -141,6 +150,20 @@ private:
 public:
   unsigned long open_backup_response_cb_id_ = 0;
 
+  /**
+   * @brief Progress of loading the project's audio clips (can be polled from
+   * other threads).
+   */
+  ProgressInfo clip_loading_progress_;
+
+  /**
+   * @brief Progress of loading the project's plugins (can be polled from
+   * other threads).
+   *
+   * Plugins may keep loading after the project is loaded.
+   */
+  ProgressInfo plugin_loading_progress_;
+
 private:
   /**
    * @brief The filename to open. This will be the template in the case of
@@ -156,6 +179,12 @@ private:
   /** Same as Project.dir. */
   std::string dir_;
 
+  /** The project file that was loaded (the main one or a backup). */
+  fs::path loaded_project_file_;
+
+  /** Times the phases of loading (or creating) the project. */
+  utils::PhaseTimer timer_{ "project load" };
+
   /** Callback/user data pairs. */
   std::vector<std::pair<ProjectInitDoneCallback, void *>> callbacks_;
 };
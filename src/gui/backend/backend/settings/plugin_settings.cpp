@@ -14,6 +14,7 @@
 #include "gui/backend/backend/actions/tracklist_selections_action.h"
 #include "gui/backend/backend/settings/plugin_settings.h"
 #include "gui/backend/backend/settings/settings.h"
+#include "gui/backend/backend/settings_manager.h"
 #include "gui/backend/backend/zrythm.h"
 
 using namespace zrythm;
@@ -170,13 +171,17 @@ PluginSetting::validate (bool print_result)
         }
     }
 
-#  if 0
-  /* force bridge mode */
-  if (this->bridge_mode_ == zrythm::gui::old_dsp::plugins::CarlaBridgeMode::None)
+  /* force bridging the whole plugin if the user requested all plugins to be
+   * sandboxed, so that a plugin crashing or misbehaving cannot take the
+   * engine down */
+  if (
+    !ZRYTHM_TESTING && !ZRYTHM_BENCHMARKING
+    && zrythm::gui::SettingsManager::get_instance ()->get_sandboxAllPlugins ()
+    && this->bridge_mode_ != zrythm::gui::old_dsp::plugins::CarlaBridgeMode::Full)
     {
+      this->open_with_carla_ = true;
       this->bridge_mode_ = zrythm::gui::old_dsp::plugins::CarlaBridgeMode::Full;
     }
-#  endif
 
     /*z_debug ("done recalculating bridge mode");*/
 #endif
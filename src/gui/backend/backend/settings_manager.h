@@ -123,11 +123,25 @@ class SettingsManager final : public QObject
   DEFINE_SETTING_PROPERTY (int, midiBackend, 0)  // dummy
   DEFINE_SETTING_PROPERTY (int, panLaw, 1)
   DEFINE_SETTING_PROPERTY (int, panAlgorithm, 2)
+  // fill cleared buffers with a tiny value instead of 0
+  DEFINE_SETTING_PROPERTY (bool, denormalPreventionValue, true)
   DEFINE_SETTING_PROPERTY (QStringList, midiControllers, QStringList ())
   DEFINE_SETTING_PROPERTY (QStringList, audioInputs, QStringList ())
   DEFINE_SETTING_PROPERTY (QStringList, fileBrowserBookmarks, QStringList ())
   DEFINE_SETTING_PROPERTY (QString, fileBrowserLastLocation, {})
   DEFINE_SETTING_PROPERTY (int, undoStackLength, 128)
+  // approximate memory limit of the undo history in MiB (0 for no limit)
+  DEFINE_SETTING_PROPERTY (int, undoHistoryMemoryLimit, 512)
+  // save projects in the compact binary format instead of JSON (faster to
+  // load, but not human-readable)
+  DEFINE_SETTING_PROPERTY (bool, saveProjectsAsBinary, false)
+  // zstd compression levels for project files (higher is smaller but slower);
+  // backups (autosaves) default to the fastest level
+  DEFINE_SETTING_PROPERTY (int, projectCompressionLevel, 3)
+  DEFINE_SETTING_PROPERTY (int, backupCompressionLevel, 1)
+  // record actions to a journal next to the project so that unsaved changes
+  // can be recovered without saving full backups
+  DEFINE_SETTING_PROPERTY (bool, journalActions, true)
   DEFINE_SETTING_PROPERTY (int, pianoRollHighlight, 3)    // both
   DEFINE_SETTING_PROPERTY (int, pianoRollMidiModifier, 0) // velocity
   /* these are all in amplitude (0.0 ~ 2.0) */
@@ -139,6 +153,20 @@ class SettingsManager final : public QObject
   DEFINE_SETTING_PROPERTY (bool, monitorMuteEnabled, false)
   DEFINE_SETTING_PROPERTY (bool, monitorMonoEnabled, false)
   DEFINE_SETTING_PROPERTY (bool, openPluginsOnInstantiation, true)
+  // run every plugin in a separate (bridged) process, regardless of its own
+  // setting
+  DEFINE_SETTING_PROPERTY (bool, sandboxAllPlugins, false)
+  // stop processing plugins whose inputs and outputs have gone silent
+  DEFINE_SETTING_PROPERTY (bool, suspendIdlePlugins, true)
+  // how long to keep processing after the inputs go silent, for plugins that
+  // don't report a tail length
+  DEFINE_SETTING_PROPERTY (int, pluginIdleTimeoutMs, 2000)
+  // back large buffers (port buffers, clips loaded in memory) with huge pages
+  // to reduce TLB misses
+  DEFINE_SETTING_PROPERTY (bool, hugePageBuffers, false)
+  // lock large buffers in RAM so that they never get paged out (e.g., during
+  // live shows)
+  DEFINE_SETTING_PROPERTY (bool, lockBuffersInMemory, false)
   // list of output devices to connect each channel to
   DEFINE_SETTING_PROPERTY (
     QStringList,
@@ -163,6 +191,9 @@ class SettingsManager final : public QObject
   DEFINE_SETTING_PROPERTY (int, lastMidiFunction, -1)
   DEFINE_SETTING_PROPERTY (QString, fileBrowserInstrument, {})
   DEFINE_SETTING_PROPERTY (int, automationCurveAlgorithm, 1) // superellipse
+  // max deviation of simplified recorded automation, in % of the range (0 to
+  // keep every recorded point)
+  DEFINE_SETTING_PROPERTY_DOUBLE (double, automationRecordingTolerance, 0.5)
   DEFINE_SETTING_PROPERTY_DOUBLE (
     double,
     timelineLastCreatedObjectLengthInTicks,
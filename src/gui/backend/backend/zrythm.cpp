@@ -63,6 +63,11 @@ Zrythm::init ()
 {
   settings_->init ();
   recording_manager_ = new RecordingManager (this);
+  metering_service_ = std::make_unique<MeteringService> ();
+  audio_stream_prefetcher_ =
+    std::make_unique<zrythm::dsp::AudioStreamPrefetcher> ();
+  timestretch_cache_ = std::make_unique<zrythm::dsp::TimestretchCache> ();
+  background_thread_pool_ = std::make_unique<juce::ThreadPool> (2);
   chord_preset_pack_manager_ = std::make_unique<ChordPresetPackManager> (
     have_ui_ && !ZRYTHM_TESTING && !ZRYTHM_BENCHMARKING);
 
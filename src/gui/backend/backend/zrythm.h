@@ -8,10 +8,13 @@
 
 #include <memory>
 
+#include "dsp/audio_stream_cache.h"
+#include "dsp/timestretch_cache.h"
 #include "gui/backend/backend/file_manager.h"
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/settings/chord_preset_pack_manager.h"
 #include "gui/backend/backend/settings/settings.h"
+#include "gui/backend/metering_service.h"
 #include "gui/backend/plugin_manager.h"
 #include "gui/dsp/recording_manager.h"
 #include "utils/dsp_context.h"
@@ -31,6 +34,7 @@
 #define MAX_RECENT_PROJECTS 20
 #define DEBUGGING (Q_UNLIKELY (gZrythm && gZrythm->debug_))
 #define ZRYTHM_BENCHMARKING (gZrythm && gZrythm->benchmarking_)
+#define ZRYTHM_RENDERING (gZrythm && gZrythm->rendering_)
 #define ZRYTHM_GENERATING_PROJECT (gZrythm->generating_project_)
 #define ZRYTHM_HAVE_UI (gZrythm && gZrythm->have_ui_)
 #define ZRYTHM_BREAK_ON_ERROR (gZrythm && gZrythm->break_on_error_)
@@ -221,6 +225,21 @@ public:
   /** Recording manager. */
   RecordingManager * recording_manager_ = nullptr;
 
+  /** Computes the values of the meters shown in the UI. */
+  std::unique_ptr<MeteringService> metering_service_;
+
+  /** Loads the frames of streaming audio clips ahead of playback. */
+  std::unique_ptr<zrythm::dsp::AudioStreamPrefetcher> audio_stream_prefetcher_;
+
+  /** Stretches the clips of musical mode audio regions ahead of playback. */
+  std::unique_ptr<zrythm::dsp::TimestretchCache> timestretch_cache_;
+
+  /**
+   * Runs non-realtime background jobs (e.g., summarizing audio clips for
+   * drawing waveforms).
+   */
+  std::unique_ptr<juce::ThreadPool> background_thread_pool_;
+
   /**
    * Project data.
    *
@@ -242,6 +261,15 @@ public:
    */
   bool benchmarking_ = false;
 
+  /**
+   * @brief Whether rendering projects from the command line without a UI
+   * (see gui::BatchRenderer).
+   *
+   * The dummy backends are used and no questions are asked when loading
+   * projects.
+   */
+  bool rendering_ = false;
+
   JUCE_DECLARE_SINGLETON_SINGLETHREADED (Zrythm, false)
 
   JUCE_HEAVYWEIGHT_LEAK_DETECTOR (Zrythm)
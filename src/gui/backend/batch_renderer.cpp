@@ -0,0 +1,469 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <utility>
+
+#include "gui/backend/backend/project.h"
+#include "gui/backend/backend/project/project_init_flow_manager.h"
+#include "gui/backend/backend/zrythm.h"
+#include "gui/backend/batch_renderer.h"
+#include "gui/dsp/engine.h"
+#include "gui/dsp/transport.h"
+#include "utils/exceptions.h"
+#include "utils/io.h"
+#include "utils/logger.h"
+#include "utils/progress_info.h"
+
+#include <QEventLoop>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QProcess>
+#include <QTemporaryDir>
+
+using namespace Qt::StringLiterals;
+
+namespace zrythm::gui
+{
+
+namespace
+{
+
+/** Names of the formats that can be rendered, for the command line. */
+constexpr std::array<std::pair<const char *, Exporter::Format>, 10>
+  FORMAT_NAMES = { {
+    { "aiff", Exporter::Format::AIFF },
+    { "au", Exporter::Format::AU },
+    { "caf", Exporter::Format::CAF },
+    { "flac", Exporter::Format::FLAC },
+    { "mp3", Exporter::Format::MP3 },
+    { "vorbis", Exporter::Format::Vorbis },
+    { "opus", Exporter::Format::OggOpus },
+    { "raw", Exporter::Format::Raw },
+    { "wav", Exporter::Format::WAV },
+    { "w64", Exporter::Format::W64 },
+  } };
+
+const char *
+format_to_name (Exporter::Format format)
+{
+  const auto it = std::ranges::find (
+    FORMAT_NAMES, format, &std::pair<const char *, Exporter::Format>::second);
+  z_return_val_if_fail (it != FORMAT_NAMES.end (), "wav");
+  return it->first;
+}
+
+double
+get_secs_since (std::chrono::steady_clock::time_point start)
+{
+  return std::chrono::duration<double> (
+           std::chrono::steady_clock::now () - start)
+    .count ();
+}
+
+} // namespace
+
+void
+BatchRenderer::add_command_line_options (QCommandLineParser &parser)
+{
+  parser.addOptions ({
+    { u"render"_s,
+     QObject::tr (
+        "Render the mixdown of the projects given as arguments without a UI, "
+        "then exit") },
+    { u"render-format"_s,
+     QObject::tr (
+        "Format to render to (aiff, au, caf, flac, mp3, vorbis, opus, raw, "
+        "wav or w64)"),
+     u"format"_s, u"wav"_s },
+    { u"render-bit-depth"_s, QObject::tr ("Bit depth to render with"),
+     u"bits"_s, u"24"_s },
+    { u"render-dither"_s, QObject::tr ("Dither the rendered audio") },
+    { u"render-loudness-metadata"_s,
+     QObject::tr ("Write the measured loudness to the rendered WAV files") },
+    { u"render-output-dir"_s,
+     QObject::tr (
+        "Directory to render to (defaults to each project's exports "
+        "directory)"),
+     u"dir"_s },
+    { u"render-jobs"_s,
+     QObject::tr ("Number of projects to render at the same time"),
+     u"jobs"_s, u"1"_s },
+    { u"render-json"_s,
+     QObject::tr (
+        "Write the timings and loudness of the renders as JSON to the given "
+        "file instead of the standard output"),
+     u"file"_s },
+  });
+}
+
+BatchRenderer::Options
+BatchRenderer::parse_command_line_options (const QCommandLineParser &parser)
+{
+  Options options;
+
+  const auto format_name = parser.value (u"render-format"_s).toLower ();
+  const auto format_it = std::ranges::find_if (
+    FORMAT_NAMES, [&format_name] (const auto &pair) {
+      return format_name == QString::fromUtf8 (pair.first);
+    });
+  if (format_it == FORMAT_NAMES.end ())
+    {
+      throw ZrythmException (
+        fmt::format ("Unknown render format '{}'", format_name));
+    }
+  options.format_ = format_it->second;
+
+  const auto depth = parser.value (u"render-bit-depth"_s).toInt ();
+  if (depth != 16 && depth != 24 && depth != 32)
+    {
+      throw ZrythmException (fmt::format ("Invalid bit depth {}", depth));
+    }
+  options.depth_ = utils::audio::bit_depth_int_to_enum (depth);
+
+  options.dither_ = parser.isSet (u"render-dither"_s);
+  options.write_loudness_metadata_ =
+    parser.isSet (u"render-loudness-metadata"_s);
+  if (parser.isSet (u"render-output-dir"_s))
+    {
+      options.output_dir_ = fs::absolute (
+        fs::path (parser.value (u"render-output-dir"_s).toStdString ()));
+    }
+
+  options.num_jobs_ = parser.value (u"render-jobs"_s).toInt ();
+  if (options.num_jobs_ < 1)
+    {
+      throw ZrythmException ("The number of jobs must be at least 1");
+    }
+
+  if (parser.isSet (u"render-json"_s))
+    {
+      options.json_path_ =
+        fs::path (parser.value (u"render-json"_s).toStdString ());
+    }
+
+  return options;
+}
+
+QStringList
+BatchRenderer::options_to_arguments (const Options &options)
+{
+  QStringList args{
+    u"--render"_s,
+    u"--render-format"_s,
+    QString::fromUtf8 (format_to_name (options.format_)),
+    u"--render-bit-depth"_s,
+    QString::number (utils::audio::bit_depth_enum_to_int (options.depth_)),
+  };
+  if (options.dither_)
+    {
+      args << u"--render-dither"_s;
+    }
+  if (options.write_loudness_metadata_)
+    {
+      args << u"--render-loudness-metadata"_s;
+    }
+  if (!options.output_dir_.empty ())
+    {
+      args << u"--render-output-dir"_s
+           << QString::fromStdString (options.output_dir_.string ());
+    }
+  return args;
+}
+
+bool
+BatchRenderer::run (
+  const QString               &program,
+  const std::vector<fs::path> &projects,
+  const Options               &options)
+{
+  const auto start = std::chrono::steady_clock::now ();
+
+  std::vector<Result> results;
+  if (projects.size () == 1)
+    {
+      results.push_back (render_project (projects.front (), options));
+    }
+  else
+    {
+      results = render_in_child_processes (program, projects, options);
+    }
+
+  QJsonArray results_json;
+  for (const auto &result : results)
+    {
+      results_json.append (result_to_json (result));
+    }
+  const auto num_failed = std::ranges::count_if (
+    results, [] (const auto &result) { return !result.success_; });
+  const QJsonObject json{
+    { u"results"_s, results_json },
+    { u"failed"_s, static_cast<qint64> (num_failed) },
+    { u"totalMs"_s, get_secs_since (start) * 1000.0 },
+  };
+  const auto json_str =
+    QJsonDocument (json).toJson (QJsonDocument::Indented).toStdString ();
+  if (options.json_path_.empty ())
+    {
+      std::cout << json_str << std::flush;
+    }
+  else
+    {
+      try
+        {
+          utils::io::set_file_contents (options.json_path_, json_str);
+        }
+      catch (const ZrythmException &e)
+        {
+          z_warning ("Failed to write the render results: {}", e.what ());
+          return false;
+        }
+    }
+
+  return num_failed == 0;
+}
+
+std::vector<BatchRenderer::Result>
+BatchRenderer::render_in_child_processes (
+  const QString               &program,
+  const std::vector<fs::path> &projects,
+  const Options               &options)
+{
+  std::vector<Result> results (projects.size ());
+  for (size_t i = 0; i < projects.size (); ++i)
+    {
+      results[i].project_ = projects[i];
+    }
+
+  std::unique_ptr<QTemporaryDir> tmp_dir;
+  try
+    {
+      tmp_dir = utils::io::make_tmp_dir (u"zrythm_render_XXXXXX"_s);
+    }
+  catch (const ZrythmException &e)
+    {
+      for (auto &result : results)
+        {
+          result.message_ = e.what ();
+        }
+      return results;
+    }
+
+  const auto base_args = options_to_arguments (options);
+  QEventLoop loop;
+  size_t     next = 0;
+  size_t     num_running = 0;
+
+  const auto get_json_path = [&tmp_dir] (size_t index) {
+    return tmp_dir->filePath (QString::number (index) + u".json"_s);
+  };
+
+  /* when a child finishes, read its result and start the next project */
+  std::function<void ()> start_next;
+  const auto on_finished = [&] (size_t index, QProcess * process) {
+    --num_running;
+    auto &result = results[index];
+    QFile file (get_json_path (index));
+    const auto json = file.open (QIODevice::ReadOnly)
+                        ? QJsonDocument::fromJson (file.readAll ())
+                        : QJsonDocument ();
+    const auto results_json = json.object ()[u"results"_s].toArray ();
+    try
+      {
+        if (results_json.size () != 1)
+          {
+            throw ZrythmException (fmt::format (
+              "Render process exited with code {} without results",
+              process->exitCode ()));
+          }
+        result = result_from_json (results_json.first ().toObject ());
+      }
+    catch (const ZrythmException &e)
+      {
+        result.success_ = false;
+        result.message_ = e.what ();
+      }
+    z_info (
+      "[{}/{}] {} {}", index + 1, projects.size (),
+      result.success_ ? "rendered" : "failed to render", result.project_);
+    process->deleteLater ();
+    start_next ();
+  };
+
+  start_next = [&] () {
+    while (
+      num_running < static_cast<size_t> (options.num_jobs_)
+      && next < projects.size ())
+      {
+        const auto index = next++;
+        auto *     process = new QProcess ();
+        process->setProcessChannelMode (QProcess::ForwardedErrorChannel);
+        process->setStandardOutputFile (QProcess::nullDevice ());
+        QObject::connect (
+          process, &QProcess::finished, &loop,
+          [&on_finished, index, process] () { on_finished (index, process); });
+        QObject::connect (
+          process, &QProcess::errorOccurred, &loop,
+          [&on_finished, index, process] (QProcess::ProcessError error) {
+            if (error == QProcess::FailedToStart)
+              on_finished (index, process);
+          });
+        auto args = base_args;
+        args << u"--render-json"_s << get_json_path (index)
+             << QString::fromStdString (projects[index].string ());
+        process->start (program, args);
+        ++num_running;
+      }
+    if (num_running == 0)
+      {
+        loop.quit ();
+      }
+  };
+
+  start_next ();
+  if (num_running > 0)
+    {
+      loop.exec ();
+    }
+
+  return results;
+}
+
+BatchRenderer::Result
+BatchRenderer::render_project (const fs::path &project, const Options &options)
+{
+  Result result;
+  result.project_ = project;
+  const auto project_file =
+    fs::is_directory (project) ? project / PROJECT_FILE : project;
+
+  /* load the project (this happens synchronously without a UI) */
+  const auto  load_start = std::chrono::steady_clock::now ();
+  bool        loaded = false;
+  std::string load_error;
+  ProjectInitFlowManager flow_mgr (
+    project_file.string (), false,
+    [&] (bool success, std::string error, void *) {
+      loaded = success;
+      load_error = std::move (error);
+    },
+    nullptr);
+  result.load_secs_ = get_secs_since (load_start);
+  if (!loaded || !PROJECT)
+    {
+      result.message_ = fmt::format ("Failed to load project: {}", load_error);
+      return result;
+    }
+
+  const auto output_dir =
+    options.output_dir_.empty ()
+      ? PROJECT->get_path (ProjectPath::EXPORTS, false)
+      : options.output_dir_;
+  result.output_file_ =
+    output_dir
+    / fmt::format (
+      "{}.{}", project_file.parent_path ().filename ().string (),
+      Exporter::format_get_ext (options.format_));
+
+  Exporter::Settings settings;
+  settings.mode_ = Exporter::Mode::Full;
+  settings.set_bounce_defaults (
+    options.format_, result.output_file_.string (), "");
+  settings.depth_ = options.depth_;
+  settings.dither_ = options.dither_;
+  settings.write_loudness_metadata_ = options.write_loudness_metadata_;
+
+  const auto render_start = std::chrono::steady_clock::now ();
+  Exporter   exporter (settings);
+  exporter.prepare_tracks_for_export (*AUDIO_ENGINE, *TRANSPORT);
+  exporter.export_to_file ();
+  exporter.post_export ();
+  result.render_secs_ = get_secs_since (render_start);
+
+  const auto &progress_info = *exporter.progress_info_;
+  const auto  completion_type = progress_info.get_completion_type ();
+  result.message_ = progress_info.get_message ();
+  if (
+    progress_info.get_status () != ProgressInfo::Status::COMPLETED
+    || (completion_type != ProgressInfo::CompletionType::SUCCESS
+        && completion_type != ProgressInfo::CompletionType::HAS_WARNING))
+    {
+      if (result.message_.empty ())
+        {
+          result.message_ = "Failed to export";
+        }
+      return result;
+    }
+
+  result.success_ = true;
+  if (!exporter.loudness_.empty ())
+    {
+      result.loudness_ = exporter.loudness_.front ();
+    }
+  return result;
+}
+
+QJsonObject
+BatchRenderer::result_to_json (const Result &result)
+{
+  QJsonObject json{
+    { u"project"_s, QString::fromStdString (result.project_.string ()) },
+    { u"output"_s, QString::fromStdString (result.output_file_.string ()) },
+    { u"success"_s, result.success_ },
+    { u"message"_s, QString::fromStdString (result.message_) },
+    { u"loadMs"_s, result.load_secs_ * 1000.0 },
+    { u"renderMs"_s, result.render_secs_ * 1000.0 },
+  };
+  if (result.loudness_)
+    {
+      /* non-finite values (e.g., the integrated loudness of silence) are
+       * written as null */
+      json[u"loudness"_s] = QJsonObject{
+        { u"integratedLufs"_s, result.loudness_->integrated_lufs_ },
+        { u"rangeLu"_s, result.loudness_->range_lu_ },
+        { u"truePeakDbtp"_s, result.loudness_->true_peak_dbtp_ },
+      };
+    }
+  return json;
+}
+
+BatchRenderer::Result
+BatchRenderer::result_from_json (const QJsonObject &json)
+{
+  if (!json[u"project"_s].isString () || !json[u"success"_s].isBool ())
+    {
+      throw ZrythmException ("Invalid render result");
+    }
+
+  Result result;
+  result.project_ = fs::path (json[u"project"_s].toString ().toStdString ());
+  result.output_file_ = fs::path (json[u"output"_s].toString ().toStdString ());
+  result.success_ = json[u"success"_s].toBool ();
+  result.message_ = json[u"message"_s].toString ().toStdString ();
+  result.load_secs_ = json[u"loadMs"_s].toDouble () / 1000.0;
+  result.render_secs_ = json[u"renderMs"_s].toDouble () / 1000.0;
+  if (json[u"loudness"_s].isObject ())
+    {
+      const auto loudness = json[u"loudness"_s].toObject ();
+      const auto to_double = [] (const QJsonValue &value) {
+        return value.isDouble ()
+                 ? value.toDouble ()
+                 : -std::numeric_limits<double>::infinity ();
+      };
+      result.loudness_ = Exporter::Loudness{
+        .integrated_lufs_ = to_double (loudness[u"integratedLufs"_s]),
+        .range_lu_ = loudness[u"rangeLu"_s].toDouble (),
+        .true_peak_dbtp_ = to_double (loudness[u"truePeakDbtp"_s]),
+      };
+    }
+  return result;
+}
+
+} // namespace zrythm::gui
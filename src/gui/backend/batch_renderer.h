@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "gui/dsp/exporter.h"
+#include "utils/types.h"
+
+#include <QCommandLineParser>
+#include <QJsonObject>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Renders the mixdown of projects from the command line, without a UI
+ * (see the `--render` option).
+ *
+ * A single project is rendered in the current process: it is loaded with the
+ * dummy backends (see Zrythm::rendering_) and exported with the Exporter,
+ * which renders offline as fast as possible.
+ *
+ * When given several projects, each one is rendered by a child process (the
+ * application re-invoked with the same options and that project), at most
+ * Options::num_jobs_ at a time. This is what allows rendering in parallel
+ * since only one project can be loaded per process, and it also means a
+ * project that crashes only fails its own render.
+ *
+ * The results (paths, load/render timings and loudness) are written as JSON.
+ */
+class BatchRenderer
+{
+public:
+  struct Options
+  {
+    Exporter::Format       format_ = Exporter::Format::WAV;
+    utils::audio::BitDepth depth_ = utils::audio::BitDepth::BIT_DEPTH_24;
+    bool                   dither_ = false;
+    bool                   write_loudness_metadata_ = false;
+
+    /** Directory to write the files to (each project's exports dir if empty).
+     */
+    fs::path output_dir_;
+
+    /** Number of projects to render at the same time. */
+    int num_jobs_ = 1;
+
+    /** File to write the JSON results to (standard output if empty). */
+    fs::path json_path_;
+  };
+
+  struct Result
+  {
+    fs::path project_;
+    fs::path output_file_;
+    bool     success_ = false;
+
+    /** Error, or warning if successful (e.g., clipping). */
+    std::string message_;
+
+    double load_secs_ = 0.0;
+    double render_secs_ = 0.0;
+
+    /** Only set if the render succeeded. */
+    std::optional<Exporter::Loudness> loudness_;
+  };
+
+public:
+  static void add_command_line_options (QCommandLineParser &parser);
+
+  /**
+   * @brief Returns the options given on the command line.
+   *
+   * @throw ZrythmException If a value is invalid.
+   */
+  static Options parse_command_line_options (const QCommandLineParser &parser);
+
+  /**
+   * @brief Renders the given projects (project files or directories) and
+   * writes the results.
+   *
+   * @param program Program to run the child processes with.
+   * @return Whether all the projects were rendered.
+   */
+  static bool run (
+    const QString               &program,
+    const std::vector<fs::path> &projects,
+    const Options               &options);
+
+  /**
+   * @brief Loads and renders the given project in this process.
+   *
+   * Zrythm must be initialized without a UI (see Zrythm::rendering_) and no
+   * other project must be loaded.
+   */
+  static Result
+  render_project (const fs::path &project, const Options &options);
+
+  static QJsonObject result_to_json (const Result &result);
+
+  /**
+   * @throw ZrythmException If @p json is not a valid result.
+   */
+  static Result result_from_json (const QJsonObject &json);
+
+private:
+  /**
+   * @brief Renders each project in a child process.
+   */
+  static std::vector<Result> render_in_child_processes (
+    const QString               &program,
+    const std::vector<fs::path> &projects,
+    const Options               &options);
+
+  /**
+   * @brief Returns the command line arguments that give @p options to a child
+   * process (except the number of jobs and the JSON path).
+   */
+  static QStringList options_to_arguments (const Options &options);
+};
+
+} // namespace zrythm::gui
@@ -179,6 +179,12 @@ Channel::should_bounce_to_master (utils::audio::BounceStep step) const
   return !track.is_master () && track.bounce_to_master_;
 }
 
+utils::audio::AudioBuffer *
+Channel::get_bounce_tap () const
+{
+  return get_track ().bounce_tap_;
+}
+
 void
 Channel::connect_no_prev_no_next (Channel::Plugin &pl)
 {
@@ -425,9 +431,13 @@ Channel::prepare_process (nframes_t nframes)
       send->prepare_process ();
     }
 
-  if (track_->in_signal_type_ == PortType::Event)
+  /* copy the cached MIDI events to the MIDI events in the MIDI in port
+   * (unless the port is rendered ahead, in which case it has no live inputs
+   * and the anticipative renderer dequeues them when processing it) */
+  if (
+    track_->in_signal_type_ == PortType::Event
+    && !track_->processor_->get_midi_in_port ().is_rendered_ahead ())
     {
-      /* copy the cached MIDI events to the MIDI events in the MIDI in port */
       track_->processor_->get_midi_in_port ().midi_events_.dequeue (0, nframes);
     }
 }
@@ -1513,6 +1523,33 @@ Channel::get_plugin_at_slot (dsp::PluginSlot slot) const
   return get_plugin_registry ().find_by_id (existing_pl_id.value ());
 }
 
+double
+Channel::getPluginDspLoad (int slotType, int slot) const
+{
+  const auto slot_type = static_cast<zrythm::dsp::PluginSlotType> (slotType);
+  switch (slot_type)
+    {
+    case zrythm::dsp::PluginSlotType::Insert:
+    case zrythm::dsp::PluginSlotType::MidiFx:
+      z_return_val_if_fail (slot >= 0 && slot < (int) STRIP_SIZE, 0.0);
+      break;
+    case zrythm::dsp::PluginSlotType::Instrument:
+      break;
+    default:
+      z_return_val_if_reached (0.0);
+    }
+
+  const auto pl_var = get_plugin_at_slot (
+    slot_type == zrythm::dsp::PluginSlotType::Instrument
+      ? dsp::PluginSlot (slot_type)
+      : dsp::PluginSlot (slot_type, static_cast<dsp::PluginSlot::SlotNo> (slot)));
+  if (!pl_var.has_value ())
+    return 0.0;
+
+  return std::visit (
+    [] (auto &&pl) { return pl->get_dsp_load () * 100.0; }, pl_var.value ());
+}
+
 struct PluginImportData
 {
   Channel *                                  ch{};
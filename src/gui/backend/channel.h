@@ -127,6 +127,15 @@ public:
     return midi_out_id_.has_value () ? std::addressof (get_midi_out_port ()) : nullptr;
   }
 
+  /**
+   * @brief Returns the DSP load of the plugin in the given slot, in percent
+   * of the real-time budget (or 0 if the slot is empty).
+   *
+   * @param slotType A dsp::PluginSlotType.
+   * @param slot The slot index (ignored for instruments).
+   */
+  Q_INVOKABLE double getPluginDspLoad (int slotType, int slot) const;
+
   // ============================================================================
 
   /**
@@ -145,6 +154,8 @@ public:
 
   bool should_bounce_to_master (utils::audio::BounceStep step) const override;
 
+  utils::audio::AudioBuffer * get_bounce_tap () const override;
+
   MidiPort &get_midi_out_port () const
   {
     return *std::get<MidiPort *> (
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/backend/dsp_load_model.h"
+#include "gui/dsp/engine.h"
+#include "gui/dsp/router.h"
+
+using namespace zrythm::gui;
+
+DspLoadModel::DspLoadModel (QObject * parent) : QAbstractListModel (parent) { }
+
+int
+DspLoadModel::rowCount (const QModelIndex &parent) const
+{
+  if (parent.isValid ())
+    return 0;
+  return static_cast<int> (stats_.size ());
+}
+
+QVariant
+DspLoadModel::data (const QModelIndex &index, int role) const
+{
+  if (!index.isValid () || index.row () >= rowCount ())
+    return {};
+
+  const auto &node_stats = stats_.at (index.row ());
+  const auto &s = node_stats.stats_;
+
+  switch (role)
+    {
+    case Qt::DisplayRole:
+    case NameRole:
+      return QString::fromStdString (node_stats.name_);
+    case LastUsRole:
+      return s.last_ns_ / 1000.0;
+    case MeanUsRole:
+      return s.mean_ns_ / 1000.0;
+    case P99UsRole:
+      return s.p99_ns_ / 1000.0;
+    case MaxUsRole:
+      return s.max_ns_ / 1000.0;
+    default:
+      return {};
+    }
+
+  return {};
+}
+
+QHash<int, QByteArray>
+DspLoadModel::roleNames () const
+{
+  QHash<int, QByteArray> roles;
+  roles[NameRole] = "name";
+  roles[LastUsRole] = "lastUs";
+  roles[MeanUsRole] = "meanUs";
+  roles[P99UsRole] = "p99Us";
+  roles[MaxUsRole] = "maxUs";
+  return roles;
+}
+
+void
+DspLoadModel::refresh ()
+{
+  beginResetModel ();
+  stats_.clear ();
+  if (AUDIO_ENGINE && ROUTER && ROUTER->scheduler_)
+    {
+      stats_ = ROUTER->scheduler_->get_node_stats ();
+    }
+  endResetModel ();
+}
+
+void
+DspLoadModel::dumpToLog () const
+{
+  if (!AUDIO_ENGINE || !ROUTER || !ROUTER->scheduler_)
+    {
+      z_info ("No DSP graph to dump node statistics for");
+      return;
+    }
+
+  z_info ("DSP node statistics:\n{}", ROUTER->scheduler_->node_stats_to_str ());
+  z_info (
+    "DSP NUMA placement:\n{}", ROUTER->scheduler_->numa_placement_to_str ());
+}
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include "dsp/graph_scheduler.h"
+
+#include <QAbstractListModel>
+#include <QQmlEngine>
+#include <QtQmlIntegration>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Per-node breakdown of the DSP load.
+ *
+ * Lists the processing time statistics of each node in the DSP graph, most
+ * expensive first. The statistics are only collected when built with
+ * ZRYTHM_DSP_NODE_PROFILING (see @ref available).
+ */
+class DspLoadModel : public QAbstractListModel
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (bool available READ available CONSTANT)
+
+public:
+  enum DspLoadRoles
+  {
+    NameRole = Qt::UserRole + 1,
+    LastUsRole,
+    MeanUsRole,
+    P99UsRole,
+    MaxUsRole,
+  };
+
+  explicit DspLoadModel (QObject * parent = nullptr);
+
+  int rowCount (const QModelIndex &parent = QModelIndex ()) const override;
+  QVariant
+  data (const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QHash<int, QByteArray> roleNames () const override;
+
+  bool available () const { return ZRYTHM_DSP_NODE_PROFILING; }
+
+  /**
+   * @brief Takes a new snapshot of the statistics from the active project's
+   * graph.
+   */
+  Q_INVOKABLE void refresh ();
+
+  /**
+   * @brief Logs the statistics of all nodes as a table, followed by the
+   * placement of the graph on NUMA nodes.
+   */
+  Q_INVOKABLE void dumpToLog () const;
+
+private:
+  std::vector<dsp::GraphScheduler::NodeStats> stats_;
+};
+
+} // namespace zrythm::gui
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/backend/engine_telemetry_model.h"
+#include "gui/backend/backend/zrythm.h"
+#include "gui/dsp/engine.h"
+#include "utils/io.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+using namespace zrythm::gui;
+using namespace Qt::StringLiterals;
+
+EngineTelemetryModel::EngineTelemetryModel (QObject * parent) : QObject (parent)
+{
+}
+
+QVariantList
+EngineTelemetryModel::histogram () const
+{
+  QVariantList ret;
+  for (size_t i = 0; i < snapshot_.histogram_.size (); ++i)
+    {
+      const auto [lower, upper] = dsp::EngineTelemetry::get_bin_range_us (i);
+      ret.append (QVariantMap{
+        { u"lowerUs"_s, static_cast<double> (lower) },
+        { u"upperUs"_s, static_cast<double> (upper) },
+        { u"count"_s, static_cast<double> (snapshot_.histogram_[i]) },
+      });
+    }
+  return ret;
+}
+
+QVariantList
+EngineTelemetryModel::xrunTimestampsUs () const
+{
+  QVariantList ret;
+  for (const auto timestamp : snapshot_.xrun_timestamps_us_)
+    {
+      ret.append (static_cast<double> (timestamp));
+    }
+  return ret;
+}
+
+void
+EngineTelemetryModel::refresh ()
+{
+  snapshot_ = {};
+  backend_.clear ();
+  block_length_ = 0;
+  sample_rate_ = 0;
+  if (auto * engine = AUDIO_ENGINE)
+    {
+      snapshot_ = engine->telemetry_.get_snapshot ();
+      backend_ = QString::fromUtf8 (ENUM_NAME (engine->audio_backend_));
+      block_length_ = static_cast<int> (engine->block_length_);
+      sample_rate_ = static_cast<int> (engine->sample_rate_);
+    }
+  disk_stats_ = {};
+  recording_stats_ = {};
+  if (gZrythm && RECORDING_MANAGER)
+    {
+      recording_stats_ = RECORDING_MANAGER->get_stats ();
+      if (RECORDING_MANAGER->disk_writer_)
+        {
+          disk_stats_ = RECORDING_MANAGER->disk_writer_->get_stats ();
+        }
+    }
+  Q_EMIT changed ();
+}
+
+void
+EngineTelemetryModel::reset ()
+{
+  if (auto * engine = AUDIO_ENGINE)
+    {
+      AudioEngine::State state{};
+      engine->wait_for_pause (state, true, false);
+      engine->telemetry_.reset ();
+      engine->resume (state);
+    }
+  refresh ();
+}
+
+QString
+EngineTelemetryModel::toJson () const
+{
+  return QString::fromUtf8 (
+    QJsonDocument (to_json (snapshot_, backend_, block_length_, sample_rate_))
+      .toJson (QJsonDocument::Indented));
+}
+
+QJsonObject
+EngineTelemetryModel::to_json (const AudioEngine &engine)
+{
+  return to_json (
+    engine.telemetry_.get_snapshot (),
+    QString::fromUtf8 (ENUM_NAME (engine.audio_backend_)),
+    static_cast<int> (engine.block_length_),
+    static_cast<int> (engine.sample_rate_));
+}
+
+void
+EngineTelemetryModel::dump_to_file (
+  const AudioEngine &engine,
+  const QString     &path)
+{
+  const auto json =
+    QJsonDocument (to_json (engine)).toJson (QJsonDocument::Indented);
+  utils::io::set_file_contents (path.toStdString (), json.toStdString ());
+}
+
+QJsonObject
+EngineTelemetryModel::to_json (
+  const dsp::EngineTelemetry::Snapshot &snapshot,
+  const QString                        &backend,
+  int                                   block_length,
+  int                                   sample_rate)
+{
+  QJsonArray histogram;
+  for (size_t i = 0; i < snapshot.histogram_.size (); ++i)
+    {
+      const auto [lower, upper] = dsp::EngineTelemetry::get_bin_range_us (i);
+      histogram.append (QJsonObject{
+        { u"lower_us"_s, static_cast<qint64> (lower) },
+        { u"upper_us"_s, static_cast<qint64> (upper) },
+        { u"count"_s, static_cast<qint64> (snapshot.histogram_[i]) },
+      });
+    }
+
+  QJsonArray xrun_timestamps;
+  for (const auto timestamp : snapshot.xrun_timestamps_us_)
+    {
+      xrun_timestamps.append (static_cast<qint64> (timestamp));
+    }
+
+  return QJsonObject{
+    { u"backend"_s, backend },
+    { u"block_length"_s, block_length },
+    { u"sample_rate"_s, sample_rate },
+    { u"num_cycles"_s, static_cast<qint64> (snapshot.num_cycles_) },
+    { u"last_duration_us"_s, static_cast<qint64> (snapshot.last_duration_us_) },
+    { u"mean_duration_us"_s, static_cast<qint64> (snapshot.mean_duration_us_) },
+    { u"max_duration_us"_s, static_cast<qint64> (snapshot.max_duration_us_) },
+    { u"duration_histogram"_s, histogram },
+    { u"last_dsp_load"_s, snapshot.last_dsp_load_ },
+    { u"mean_dsp_load"_s, snapshot.mean_dsp_load_ },
+    { u"max_dsp_load"_s, snapshot.max_dsp_load_ },
+    { u"mean_jitter_us"_s, snapshot.mean_jitter_us_ },
+    { u"max_jitter_us"_s, static_cast<qint64> (snapshot.max_jitter_us_) },
+    { u"num_xruns"_s, static_cast<qint64> (snapshot.num_xruns_) },
+    { u"xrun_timestamps_us"_s, xrun_timestamps },
+  };
+}
@@ -0,0 +1,172 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include "dsp/engine_telemetry.h"
+#include "gui/dsp/recording_disk_writer.h"
+#include "gui/dsp/recording_manager.h"
+
+#include <QJsonObject>
+#include <QObject>
+#include <QQmlEngine>
+#include <QtQmlIntegration>
+
+class AudioEngine;
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Timing statistics of the audio callback (see dsp::EngineTelemetry)
+ * of the active project's engine, along with the statistics of the recording
+ * pipeline (see RecordingManager and RecordingDiskWriter).
+ *
+ * The values are updated on refresh().
+ */
+class EngineTelemetryModel : public QObject
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (QString backend READ backend NOTIFY changed)
+  Q_PROPERTY (int blockLength READ blockLength NOTIFY changed)
+  Q_PROPERTY (int sampleRate READ sampleRate NOTIFY changed)
+  Q_PROPERTY (double numCycles READ numCycles NOTIFY changed)
+  Q_PROPERTY (double dspLoad READ dspLoad NOTIFY changed)
+  Q_PROPERTY (double meanDspLoad READ meanDspLoad NOTIFY changed)
+  Q_PROPERTY (double maxDspLoad READ maxDspLoad NOTIFY changed)
+  Q_PROPERTY (double meanDurationUs READ meanDurationUs NOTIFY changed)
+  Q_PROPERTY (double maxDurationUs READ maxDurationUs NOTIFY changed)
+  Q_PROPERTY (double meanJitterUs READ meanJitterUs NOTIFY changed)
+  Q_PROPERTY (double maxJitterUs READ maxJitterUs NOTIFY changed)
+  Q_PROPERTY (double numXruns READ numXruns NOTIFY changed)
+  Q_PROPERTY (QVariantList histogram READ histogram NOTIFY changed)
+  Q_PROPERTY (QVariantList xrunTimestampsUs READ xrunTimestampsUs NOTIFY changed)
+  Q_PROPERTY (
+    double diskWriteThroughput READ diskWriteThroughput NOTIFY changed)
+  Q_PROPERTY (
+    double diskWriteBacklogFrames READ diskWriteBacklogFrames NOTIFY changed)
+  Q_PROPERTY (
+    double maxDiskWriteBacklogFrames READ maxDiskWriteBacklogFrames NOTIFY
+      changed)
+  Q_PROPERTY (
+    double recordingEventBacklog READ recordingEventBacklog NOTIFY changed)
+  Q_PROPERTY (
+    double maxRecordingEventBacklog READ maxRecordingEventBacklog NOTIFY
+      changed)
+  Q_PROPERTY (
+    double numDroppedRecordingEvents READ numDroppedRecordingEvents NOTIFY
+      changed)
+
+public:
+  explicit EngineTelemetryModel (QObject * parent = nullptr);
+
+  QString backend () const { return backend_; }
+  int     blockLength () const { return block_length_; }
+  int     sampleRate () const { return sample_rate_; }
+  double  numCycles () const
+  {
+    return static_cast<double> (snapshot_.num_cycles_);
+  }
+  double dspLoad () const { return snapshot_.last_dsp_load_; }
+  double meanDspLoad () const { return snapshot_.mean_dsp_load_; }
+  double maxDspLoad () const { return snapshot_.max_dsp_load_; }
+  double meanDurationUs () const
+  {
+    return static_cast<double> (snapshot_.mean_duration_us_);
+  }
+  double maxDurationUs () const
+  {
+    return static_cast<double> (snapshot_.max_duration_us_);
+  }
+  double meanJitterUs () const { return snapshot_.mean_jitter_us_; }
+  double maxJitterUs () const
+  {
+    return static_cast<double> (snapshot_.max_jitter_us_);
+  }
+  double numXruns () const
+  {
+    return static_cast<double> (snapshot_.num_xruns_);
+  }
+
+  /**
+   * @brief Returns the histogram bins as objects with `lowerUs`, `upperUs` (0
+   * for the last bin) and `count`.
+   */
+  QVariantList histogram () const;
+
+  QVariantList xrunTimestampsUs () const;
+
+  /** Bytes of recorded audio written to disk per second. */
+  double diskWriteThroughput () const { return disk_stats_.throughput_; }
+  double diskWriteBacklogFrames () const
+  {
+    return static_cast<double> (disk_stats_.backlog_frames_);
+  }
+  double maxDiskWriteBacklogFrames () const
+  {
+    return static_cast<double> (disk_stats_.max_backlog_frames_);
+  }
+  double recordingEventBacklog () const
+  {
+    return static_cast<double> (recording_stats_.backlog_events_);
+  }
+  double maxRecordingEventBacklog () const
+  {
+    return static_cast<double> (recording_stats_.max_backlog_events_);
+  }
+  double numDroppedRecordingEvents () const
+  {
+    return static_cast<double> (recording_stats_.num_dropped_events_);
+  }
+
+  /**
+   * @brief Takes a new snapshot of the statistics from the active project's
+   * engine.
+   */
+  Q_INVOKABLE void refresh ();
+
+  /**
+   * @brief Discards the statistics collected so far (e.g., after changing
+   * the buffer size).
+   */
+  Q_INVOKABLE void reset ();
+
+  /**
+   * @brief Returns the current snapshot as indented JSON.
+   */
+  Q_INVOKABLE QString toJson () const;
+
+  /**
+   * @brief Returns the statistics of @p engine (along with the backend
+   * configuration, so that dumps can be compared) as JSON.
+   */
+  static QJsonObject to_json (const AudioEngine &engine);
+
+  /**
+   * @brief Writes the statistics of @p engine as JSON to @p path.
+   *
+   * @throw ZrythmException on failure.
+   */
+  static void dump_to_file (const AudioEngine &engine, const QString &path);
+
+Q_SIGNALS:
+  void changed ();
+
+private:
+  static QJsonObject to_json (
+    const dsp::EngineTelemetry::Snapshot &snapshot,
+    const QString                        &backend,
+    int                                   block_length,
+    int                                   sample_rate);
+
+private:
+  dsp::EngineTelemetry::Snapshot snapshot_;
+  QString                        backend_;
+  int                            block_length_ = 0;
+  int                            sample_rate_ = 0;
+  RecordingDiskWriter::Stats     disk_stats_;
+  RecordingManager::Stats        recording_stats_;
+};
+
+} // namespace zrythm::gui
@@ -144,6 +144,16 @@ FileDescriptor::get_type_ext (FileType type)
     }
 }
 
+zrythm::utils::audio::AudioFileMetadata
+FileDescriptor::get_metadata () const
+{
+  if (metadata_)
+    return *metadata_;
+
+  zrythm::utils::audio::AudioFile af (abs_path_);
+  return af.read_metadata ();
+}
+
 bool
 FileDescriptor::should_autoplay () const
 {
@@ -157,8 +167,7 @@ FileDescriptor::should_autoplay () const
     {
       try
         {
-          zrythm::utils::audio::AudioFile af (abs_path_);
-          auto                            metadata = af.read_metadata ();
+          auto metadata = get_metadata ();
           if ((metadata.length / 1000) > 60)
             {
               autoplay = false;
@@ -182,20 +191,26 @@ FileDescriptor::get_info_text_for_label () const
     {
       try
         {
-          utils::audio::AudioFile af (abs_path_);
-          auto                    metadata = af.read_metadata ();
+          auto metadata = get_metadata ();
+          auto bpm_str = format_str ("{:.1f}", (double) metadata.bpm);
+          if (metadata.bpm <= 0.f && detected_bpm_ > 0.f)
+            {
+              bpm_str = format_str (
+                QObject::tr ("~{:.1f} (detected)").toStdString (),
+                (double) detected_bpm_);
+            }
           return format_str (
             QObject::tr (
               "<b>{}</b>\n"
               "Sample rate: {}\n"
               "Length: {}s "
-              "{} ms | BPM: {:.1f}\n"
+              "{} ms | BPM: {}\n"
               "Channel(s): {} | Bitrate: {:L}.{} kb/s\n"
               "Bit depth: {} bits")
               .toStdString (),
             utils::string::escape_html (label_), metadata.samplerate,
-            metadata.length / 1000, metadata.length % 1000,
-            (double) metadata.bpm, metadata.channels, metadata.bit_rate / 1000,
+            metadata.length / 1000, metadata.length % 1000, bpm_str,
+            metadata.channels, metadata.bit_rate / 1000,
             (metadata.bit_rate % 1000) / 100, metadata.bit_depth);
         }
       catch (const ZrythmException &e)
@@ -5,8 +5,11 @@
 #define __AUDIO_SUPPORTED_FILE_H__
 
 #include <memory>
+#include <optional>
 #include <string>
+#include <vector>
 
+#include "utils/audio_file.h"
 #include "utils/types.h"
 
 /**
@@ -106,6 +109,14 @@ public:
    */
   std::string get_info_text_for_label () const;
 
+private:
+  /**
+   * Returns @ref metadata_ if already read, otherwise reads it from the file.
+   *
+   * @throw ZrythmException on error.
+   */
+  zrythm::utils::audio::AudioFileMetadata get_metadata () const;
+
 public:
   /** Absolute path. */
   std::string abs_path_;
@@ -118,6 +129,20 @@ public:
 
   /** Hidden or not. */
   bool hidden_ = false;
+
+  /**
+   * Audio metadata, if already read (e.g., by the file browser's background
+   * scan).
+   */
+  std::optional<zrythm::utils::audio::AudioFileMetadata> metadata_;
+
+  /** Waveform thumbnail (see CachedFileInfo::peaks_), if available. */
+  std::vector<float> peaks_;
+
+  /**
+   * Tempo detected from the audio (see CachedFileInfo::detected_bpm_), or 0.
+   */
+  float detected_bpm_ = 0.f;
 };
 
 /**
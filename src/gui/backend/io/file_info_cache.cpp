@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cmath>
+
+#include "gui/backend/io/file_info_cache.h"
+#include "gui/backend/zrythm_application.h"
+#include "utils/audio.h"
+#include "utils/directory_manager.h"
+#include "utils/io.h"
+#include "utils/math.h"
+
+constexpr const char * FILE_INFO_CACHE_JSON_FILENAME = "cached-file-infos.json";
+
+using namespace zrythm;
+
+void
+CachedFileInfo::define_fields (const Context &ctx)
+{
+  using T = ISerializable<CachedFileInfo>;
+  T::serialize_fields (
+    ctx, T::make_field ("absPath", abs_path_), T::make_field ("mtime", mtime_),
+    T::make_field ("samplerate", samplerate_),
+    T::make_field ("channels", channels_), T::make_field ("length", length_),
+    T::make_field ("numFrames", num_frames_),
+    T::make_field ("bitRate", bit_rate_),
+    T::make_field ("bitDepth", bit_depth_), T::make_field ("bpm", bpm_),
+    T::make_field ("detectedBpm", detected_bpm_),
+    T::make_field ("peaks", peaks_));
+}
+
+int64_t
+CachedFileInfo::get_mtime (const fs::path &path)
+{
+  std::error_code ec;
+  const auto      time = fs::last_write_time (path, ec);
+  if (ec)
+    return 0;
+
+  return time.time_since_epoch ().count ();
+}
+
+CachedFileInfo
+CachedFileInfo::read (const fs::path &path, int64_t mtime)
+{
+  utils::audio::AudioFile af (path.string ());
+  const auto              metadata = af.read_metadata ();
+
+  CachedFileInfo info;
+  info.abs_path_ = path.string ();
+  info.mtime_ = mtime;
+  info.samplerate_ = metadata.samplerate;
+  info.channels_ = metadata.channels;
+  info.length_ = metadata.length;
+  info.num_frames_ = metadata.num_frames;
+  info.bit_rate_ = metadata.bit_rate;
+  info.bit_depth_ = metadata.bit_depth;
+  info.bpm_ = metadata.bpm;
+
+  if (
+    metadata.length > MAX_THUMBNAIL_LENGTH_MS || metadata.num_frames <= 0
+    || metadata.channels <= 0)
+    return info;
+
+  /* detect the tempo in the same pass */
+  std::optional<utils::audio::BpmDetector> bpm_detector;
+  if (
+    utils::math::floats_equal (metadata.bpm, 0.f)
+    && metadata.length <= MAX_BPM_DETECTION_LENGTH_MS
+    && metadata.samplerate > 0)
+    {
+      bpm_detector.emplace (static_cast<unsigned int> (metadata.samplerate));
+    }
+
+  /* read one peak at a time to keep the buffer small */
+  const auto num_frames = static_cast<size_t> (metadata.num_frames);
+  const auto channels = static_cast<size_t> (metadata.channels);
+  const auto max_frames_per_peak = (num_frames + NUM_PEAKS - 1) / NUM_PEAKS;
+  std::vector<float> samples (max_frames_per_peak * channels);
+  info.peaks_.reserve (NUM_PEAKS);
+  for (size_t i = 0; i < NUM_PEAKS; ++i)
+    {
+      const size_t start = num_frames * i / NUM_PEAKS;
+      const size_t end = num_frames * (i + 1) / NUM_PEAKS;
+      float        peak = 0.f;
+      if (end > start)
+        {
+          af.read_samples_interleaved (
+            true, samples.data (), start, end - start);
+          for (size_t j = 0; j < (end - start) * channels; ++j)
+            {
+              peak = std::max (peak, std::abs (samples[j]));
+            }
+          if (bpm_detector)
+            {
+              bpm_detector->process_interleaved (
+                samples.data (), channels, end - start);
+            }
+        }
+      info.peaks_.push_back (peak);
+    }
+
+  if (bpm_detector)
+    {
+      std::vector<float> candidates;
+      info.detected_bpm_ = bpm_detector->detect (candidates);
+    }
+
+  return info;
+}
+
+utils::audio::AudioFileMetadata
+CachedFileInfo::get_metadata () const
+{
+  utils::audio::AudioFileMetadata metadata;
+  metadata.samplerate = samplerate_;
+  metadata.channels = channels_;
+  metadata.length = length_;
+  metadata.num_frames = num_frames_;
+  metadata.bit_rate = bit_rate_;
+  metadata.bit_depth = bit_depth_;
+  metadata.bpm = bpm_;
+  metadata.filled = true;
+  return metadata;
+}
+
+fs::path
+FileInfoCache::get_file_path ()
+{
+  auto zrythm_dir =
+    dynamic_cast<ZrythmApplication *> (qApp)->get_directory_manager ().get_dir (
+      IDirectoryManager::DirectoryType::USER_TOP);
+  z_return_val_if_fail (!zrythm_dir.empty (), "");
+
+  return fs::path (zrythm_dir) / FILE_INFO_CACHE_JSON_FILENAME;
+}
+
+void
+FileInfoCache::define_fields (const Context &ctx)
+{
+  using T = ISerializable<FileInfoCache>;
+  T::serialize_fields (ctx, T::make_field ("infos", infos_));
+}
+
+void
+FileInfoCache::ensure_read_from_file ()
+{
+  std::call_once (read_flag_, [this] () {
+    auto path = get_file_path ();
+    if (path.empty () || !fs::exists (path))
+      return;
+
+    FileInfoCache read_cache;
+    try
+      {
+        auto json = utils::io::read_file_contents (path).toStdString ();
+        read_cache.deserialize_from_json_string (json.c_str ());
+      }
+    catch (const ZrythmException &e)
+      {
+        z_warning (
+          "Ignoring invalid file info cache at {}: {}", path, e.what ());
+        return;
+      }
+
+    /* infos added in the meantime are newer */
+    std::lock_guard             lock (mutex_);
+    std::vector<CachedFileInfo> infos;
+    for (auto &info : read_cache.infos_)
+      {
+        if (!index_.contains (info.abs_path_))
+          infos.push_back (std::move (info));
+      }
+    std::ranges::move (infos_, std::back_inserter (infos));
+    infos_ = std::move (infos);
+    rebuild_index ();
+  });
+}
+
+void
+FileInfoCache::serialize_to_file ()
+{
+  auto path = get_file_path ();
+  z_return_if_fail (
+    !path.empty () && path.is_absolute () && path.has_parent_path ());
+
+  std::lock_guard file_lock (file_mutex_);
+  std::string     json_str;
+  {
+    std::lock_guard lock (mutex_);
+    json_str = serialize_to_json_string ();
+    dirty_ = false;
+  }
+
+  z_debug ("Writing file info cache to {}...", path);
+  try
+    {
+      utils::io::set_file_contents (path, json_str.c_str ());
+    }
+  catch (const ZrythmException &e)
+    {
+      throw ZrythmException (
+        format_str ("Unable to write file info cache: {}", e.what ()));
+    }
+}
+
+std::optional<CachedFileInfo>
+FileInfoCache::find (const std::string &abs_path, int64_t mtime) const
+{
+  std::lock_guard lock (mutex_);
+  const auto      it = index_.find (abs_path);
+  if (it == index_.end ())
+    return std::nullopt;
+
+  const auto &info = infos_[it->second];
+  if (info.mtime_ != mtime)
+    return std::nullopt;
+
+  return info;
+}
+
+void
+FileInfoCache::add (CachedFileInfo info)
+{
+  std::lock_guard lock (mutex_);
+  dirty_ = true;
+  const auto it = index_.find (info.abs_path_);
+  if (it != index_.end ())
+    {
+      infos_[it->second] = std::move (info);
+      return;
+    }
+
+  infos_.push_back (std::move (info));
+  index_.emplace (infos_.back ().abs_path_, infos_.size () - 1);
+  if (infos_.size () > MAX_INFOS)
+    {
+      /* drop the oldest quarter at once to not rebuild the index on every
+       * addition */
+      infos_.erase (
+        infos_.begin (),
+        infos_.begin () + static_cast<ptrdiff_t> (MAX_INFOS / 4));
+      rebuild_index ();
+    }
+}
+
+bool
+FileInfoCache::is_dirty () const
+{
+  std::lock_guard lock (mutex_);
+  return dirty_;
+}
+
+void
+FileInfoCache::rebuild_index ()
+{
+  index_.clear ();
+  for (size_t i = 0; i < infos_.size (); ++i)
+    {
+      index_[infos_[i].abs_path_] = i;
+    }
+}
@@ -0,0 +1,192 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __IO_FILE_INFO_CACHE_H__
+#define __IO_FILE_INFO_CACHE_H__
+
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/audio_file.h"
+#include "utils/iserializable.h"
+
+/**
+ * @addtogroup io
+ *
+ * @{
+ */
+
+/**
+ * Audio metadata and waveform thumbnail of a file, as of its modification time.
+ */
+class CachedFileInfo final
+    : public zrythm::utils::serialization::ISerializable<CachedFileInfo>
+{
+public:
+  /** Number of peaks in the waveform thumbnail. */
+  static constexpr size_t NUM_PEAKS = 64;
+
+  /**
+   * Files longer than this (in milliseconds) get no waveform thumbnail, so
+   * that scanning a folder doesn't read whole albums.
+   */
+  static constexpr int64_t MAX_THUMBNAIL_LENGTH_MS = 5 * 60 * 1000;
+
+  /**
+   * The tempo of files without a BPM tag is only detected when they are
+   * shorter than this (in milliseconds), as it's mostly useful for loops.
+   */
+  static constexpr int64_t MAX_BPM_DETECTION_LENGTH_MS = 60 * 1000;
+
+  /**
+   * @brief Reads the metadata and computes the waveform thumbnail (and the
+   * detected tempo, if applicable) of the given audio file.
+   *
+   * @throw ZrythmException on error.
+   */
+  static CachedFileInfo read (const fs::path &path, int64_t mtime);
+
+  /**
+   * @brief Returns the modification time of @p path to compare cached infos
+   * with, or 0 if it can't be read.
+   */
+  static int64_t get_mtime (const fs::path &path);
+
+  zrythm::utils::audio::AudioFileMetadata get_metadata () const;
+
+  DECLARE_DEFINE_FIELDS_METHOD ();
+
+public:
+  /** Absolute path. */
+  std::string abs_path_;
+
+  /** Modification time the info was read at. */
+  int64_t mtime_ = 0;
+
+  int samplerate_ = 0;
+  int channels_ = 0;
+
+  /** Milliseconds. */
+  int64_t length_ = 0;
+
+  int64_t num_frames_ = 0;
+  int     bit_rate_ = 0;
+  int     bit_depth_ = 0;
+  float   bpm_ = 0.f;
+
+  /**
+   * Tempo detected from the audio, or 0 if the file has a BPM tag or its
+   * tempo was not detected.
+   */
+  float detected_bpm_ = 0.f;
+
+  /**
+   * Absolute peak of each of @ref NUM_PEAKS equal parts of the file (all
+   * channels), or empty if the file is too long.
+   */
+  std::vector<float> peaks_;
+};
+
+/**
+ * Persistent cache of file infos, so that revisiting a folder in the file
+ * browser doesn't read the files again.
+ *
+ * Infos are keyed by path and only valid for the modification time they
+ * were read at. The cache can be accessed from multiple threads.
+ */
+class FileInfoCache final
+    : public zrythm::utils::serialization::ISerializable<FileInfoCache>
+{
+public:
+  /** Oldest infos are dropped when the cache grows larger than this. */
+  static constexpr size_t MAX_INFOS = 10000;
+
+  /**
+   * @brief Adds the infos from the cache file, the first time this is called.
+   *
+   * A missing or invalid file is ignored.
+   */
+  void ensure_read_from_file ();
+
+  /**
+   * @brief Serializes the cache to the standard file.
+   *
+   * @throw ZrythmException if an error occurred while serializing.
+   */
+  void serialize_to_file ();
+
+  /**
+   * @brief Wrapper over @ref serialize_to_file that ignores exceptions.
+   */
+  void serialize_to_file_no_throw ()
+  {
+    try
+      {
+        serialize_to_file ();
+      }
+    catch (const ZrythmException &e)
+      {
+        z_warning (e.what ());
+      }
+  }
+
+  DECLARE_DEFINE_FIELDS_METHOD ();
+
+  int get_format_major_version () const override { return 2; }
+  int get_format_minor_version () const override { return 0; }
+
+  std::string get_document_type () const override { return "FileInfoCache"; }
+
+  /**
+   * @brief Returns the info of @p abs_path if it was read at @p mtime.
+   */
+  std::optional<CachedFileInfo>
+  find (const std::string &abs_path, int64_t mtime) const;
+
+  /**
+   * @brief Adds or replaces the info of its path.
+   */
+  void add (CachedFileInfo info);
+
+  /**
+   * @brief Returns whether infos were added since the cache was last
+   * serialized.
+   */
+  bool is_dirty () const;
+
+private:
+  static fs::path get_file_path ();
+
+  /**
+   * @brief Rebuilds @ref index_ from @ref infos_.
+   *
+   * Must be called with @ref mutex_ locked.
+   */
+  void rebuild_index ();
+
+private:
+  /** Infos, oldest first. */
+  std::vector<CachedFileInfo> infos_;
+
+  /** Index in @ref infos_ of each path. */
+  std::unordered_map<std::string, size_t> index_;
+
+  bool dirty_ = false;
+
+  std::once_flag read_flag_;
+
+  /** Guards the members above. */
+  mutable std::mutex mutex_;
+
+  /** Serializes writes to the cache file. */
+  std::mutex file_mutex_;
+};
+
+/**
+ * @}
+ */
+
+#endif
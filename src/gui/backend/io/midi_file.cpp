@@ -1,6 +1,13 @@
 // SPDX-FileCopyrightText: © 2020-2021, 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <deque>
+#include <future>
+#include <thread>
+
 #include "gui/backend/backend/zrythm.h"
 #include "gui/backend/io/midi_file.h"
 #include "gui/dsp/midi_region.h"
@@ -15,15 +22,34 @@ MidiFile::MidiFile (const fs::path &path) : for_reading_ (true)
 {
   juce::File            file (path.string ());
   juce::FileInputStream in_stream (file);
+  if (!read_from (in_stream))
+    {
+      throw ZrythmException (
+        fmt::format ("Could not read MIDI file at '{}'", path.string ()));
+    }
+}
+
+MidiFile::MidiFile (std::span<const char> data) : for_reading_ (true)
+{
+  juce::MemoryInputStream in_stream (data.data (), data.size (), false);
+  if (!read_from (in_stream))
+    {
+      throw ZrythmException (
+        fmt::format ("Could not read MIDI file of {} bytes", data.size ()));
+    }
+}
 
+bool
+MidiFile::read_from (juce::InputStream &in_stream)
+{
   int format = 0;
   if (!midi_file_.readFrom (in_stream, true, &format))
     {
-      throw ZrythmException (
-        fmt::format ("Could not read MIDI file at '{}'", path.string ()));
+      return false;
     }
 
   format_ = ENUM_INT_TO_VALUE (Format, format);
+  return true;
 }
 
 MidiFile::Format
@@ -86,105 +112,205 @@ MidiFile::get_ppqn () const
   throw ZrythmException ("SMPTE format not supported yet");
 }
 
-void
-MidiFile::into_region (
-  MidiRegion &region,
-  Transport  &transport,
-  const int   midi_track_idx) const
+std::vector<int>
+MidiFile::get_non_empty_track_indices () const
 {
-  using Position = MidiRegion::Position;
-  const int    num_tracks = midi_file_.getNumTracks ();
-  const auto   ppqn = static_cast<double> (get_ppqn ());
-  const double transport_ppqn = transport.get_ppqn ();
-
-  int actual_iter = 0;
-
-  for (int i = 0; i < num_tracks; i++)
+  std::vector<int> track_indices;
+  for (int i = 0; i < midi_file_.getNumTracks (); i++)
     {
-      if (!track_has_midi_note_events (i))
+      if (track_has_midi_note_events (i))
         {
-          continue;
+          track_indices.push_back (i);
         }
+    }
+  if (!track_indices.empty () && track_indices.back () >= 1000)
+    {
+      throw ZrythmException ("Too many tracks in midi file");
+    }
+  return track_indices;
+}
 
-      if (actual_iter != midi_track_idx)
-        {
-          actual_iter++;
-          continue;
-        }
+namespace
+{
 
-      z_debug ("reading MIDI Track {}", i);
-      if (i >= 1000)
-        {
-          throw ZrythmException ("Too many tracks in midi file");
-        }
+MidiFileTrackContents
+read_track_contents (
+  const juce::MidiMessageSequence &track,
+  int                              track_idx,
+  double                           ppqn,
+  double                           transport_ppqn)
+{
+  MidiFileTrackContents contents;
+  contents.track_idx_ = track_idx;
 
-      // set a temp name
-      region.set_name (
-        format_str (QObject::tr ("Untitled Track {}").toStdString (), i), false);
+  /* indices of the notes waiting for a note off, per pitch */
+  std::array<std::deque<size_t>, 128> unended_notes;
 
-      const auto * track = midi_file_.getTrack (i);
-      for (const auto * event : *track)
-        {
-          const auto &msg = event->message;
-
-          /* convert time to zrythm time */
-          double ticks = ((double) msg.getTimeStamp () * transport_ppqn) / ppqn;
-          Position pos{ ticks, AUDIO_ENGINE->frames_per_tick_ };
-          Position global_pos = *region.pos_;
-          global_pos.add_ticks (ticks, AUDIO_ENGINE->frames_per_tick_);
-          z_trace (
-            "event at {}: {} ", msg.getTimeStamp (), msg.getDescription ());
-
-          int bars = pos.get_bars (true, transport.ticks_per_bar_);
-          if (ZRYTHM_HAVE_UI && bars > transport.total_bars_ - 8)
-            {
-              TRANSPORT->update_total_bars (bars + 8, true);
-            }
+  for (const auto * event : track)
+    {
+      const auto &msg = event->message;
 
-          if (msg.isNoteOff (true))
-            {
-              auto * mn = region.pop_unended_note (msg.getNoteNumber ());
-              if (mn != nullptr)
-                {
-                  mn->end_pos_setter (&pos);
-                  if (global_pos > *region.end_pos_)
-                    {
-                      region.end_pos_setter (&global_pos);
-                    }
-                }
-              else
-                {
-                  z_info (
-                    "Found a Note off event without a corresponding Note on. Skipping...");
-                }
-            }
-          else if (msg.isNoteOn (false))
+      /* convert time to zrythm time */
+      const double ticks = (msg.getTimeStamp () * transport_ppqn) / ppqn;
+      contents.last_event_ticks_ = std::max (contents.last_event_ticks_, ticks);
+
+      if (msg.isNoteOff (true))
+        {
+          auto &pitch_unended_notes =
+            unended_notes.at (static_cast<size_t> (msg.getNoteNumber ()));
+          if (pitch_unended_notes.empty ())
             {
-              region.start_unended_note (
-                &pos, nullptr, msg.getNoteNumber (), msg.getVelocity (), false);
+              z_info (
+                "Found a Note off event without a corresponding Note on. Skipping...");
+              continue;
             }
-          else if (msg.isTrackNameEvent ())
+          contents.notes_[pitch_unended_notes.front ()].end_ticks_ = ticks;
+          pitch_unended_notes.pop_front ();
+          contents.last_note_off_ticks_ =
+            std::max (contents.last_note_off_ticks_.value_or (ticks), ticks);
+        }
+      else if (msg.isNoteOn (false))
+        {
+          unended_notes.at (static_cast<size_t> (msg.getNoteNumber ()))
+            .push_back (contents.notes_.size ());
+          contents.notes_.push_back ({
+            .start_ticks_ = ticks,
+            .end_ticks_ = ticks + 1,
+            .pitch_ = static_cast<midi_byte_t> (msg.getNoteNumber ()),
+            .velocity_ = msg.getVelocity (),
+          });
+        }
+      else if (msg.isTrackNameEvent ())
+        {
+          auto name = msg.getTextFromTextMetaEvent ();
+          if (!name.isEmpty ())
             {
-              auto name = msg.getTextFromTextMetaEvent ();
-              if (!name.isEmpty ())
-                {
-                  region.set_name (name.toStdString (), false);
-                }
+              contents.name_ = name.toStdString ();
             }
         }
+    }
+
+  return contents;
+}
+
+} // namespace
+
+std::vector<MidiFileTrackContents>
+MidiFile::read_tracks (double transport_ppqn, unsigned max_threads) const
+{
+  z_return_val_if_fail (for_reading_, {});
+
+  const auto track_indices = get_non_empty_track_indices ();
+  const auto ppqn = static_cast<double> (get_ppqn ());
+
+  std::vector<MidiFileTrackContents> tracks (track_indices.size ());
+  if (max_threads == 0)
+    {
+      max_threads = std::max (1u, std::thread::hardware_concurrency ());
+    }
+  const auto num_threads =
+    std::min (static_cast<size_t> (max_threads), tracks.size ());
+
+  /* tracks are independent, so convert them on worker threads that each pick
+   * the next unconverted track */
+  std::atomic_size_t             next_track{ 0 };
+  std::vector<std::future<void>> workers;
+  workers.reserve (num_threads);
+  for (size_t i = 0; i < num_threads; i++)
+    {
+      workers.emplace_back (std::async (std::launch::async, [&] () {
+        for (size_t t = next_track++; t < tracks.size (); t = next_track++)
+          {
+            tracks[t] = read_track_contents (
+              *midi_file_.getTrack (track_indices[t]), track_indices[t], ppqn,
+              transport_ppqn);
+          }
+      }));
+    }
+  for (auto &worker : workers)
+    {
+      worker.get ();
+    }
+
+  return tracks;
+}
+
+MidiFileTrackContents
+MidiFile::read_track (double transport_ppqn, int midi_track_idx) const
+{
+  z_return_val_if_fail (for_reading_, {});
+
+  const auto track_indices = get_non_empty_track_indices ();
+  if (midi_track_idx < 0 || midi_track_idx >= (int) track_indices.size ())
+    {
+      throw ZrythmException ("No events in MIDI region");
+    }
 
-      if (actual_iter == midi_track_idx)
+  const int track_idx = track_indices[midi_track_idx];
+  z_debug ("reading MIDI Track {}", track_idx);
+  return read_track_contents (
+    *midi_file_.getTrack (track_idx), track_idx,
+    static_cast<double> (get_ppqn ()), transport_ppqn);
+}
+
+void
+MidiFile::into_region (
+  MidiRegion &region,
+  Transport  &transport,
+  const int   midi_track_idx) const
+{
+  into_region (
+    read_track (transport.get_ppqn (), midi_track_idx), region, transport);
+}
+
+void
+MidiFile::into_region (
+  const MidiFileTrackContents &contents,
+  MidiRegion                  &region,
+  Transport                   &transport)
+{
+  using Position = MidiRegion::Position;
+  const auto frames_per_tick = AUDIO_ENGINE->frames_per_tick_;
+
+  region.set_name (
+    contents.name_.empty ()
+      ? format_str (
+          QObject::tr ("Untitled Track {}").toStdString (), contents.track_idx_)
+      : contents.name_,
+    false);
+
+  for (const auto &note : contents.notes_)
+    {
+      Position start_pos{ note.start_ticks_, frames_per_tick };
+      Position end_pos{ note.end_ticks_, frames_per_tick };
+      region.start_unended_note (
+        &start_pos, &end_pos, note.pitch_, note.velocity_, false);
+    }
+  /* all the notes have their end position already */
+  region.unended_notes_.clear ();
+
+  if (contents.last_note_off_ticks_)
+    {
+      Position global_pos = *region.pos_;
+      global_pos.add_ticks (*contents.last_note_off_ticks_, frames_per_tick);
+      if (global_pos > *region.end_pos_)
         {
-          break;
+          region.end_pos_setter (&global_pos);
         }
     }
 
+  Position last_event_pos{ contents.last_event_ticks_, frames_per_tick };
+  int      bars = last_event_pos.get_bars (true, transport.ticks_per_bar_);
+  if (ZRYTHM_HAVE_UI && bars > transport.total_bars_ - 8)
+    {
+      transport.update_total_bars (bars + 8, true);
+    }
+
   if (region.end_pos_ == region.pos_)
     {
       throw ZrythmException ("No events in MIDI region");
     }
   Position loop_end_pos_to_set (
-    region.end_pos_->ticks_ - region.pos_->ticks_,
-    AUDIO_ENGINE->frames_per_tick_);
+    region.end_pos_->ticks_ - region.pos_->ticks_, frames_per_tick);
   region.loop_end_pos_setter (&loop_end_pos_to_set);
 }
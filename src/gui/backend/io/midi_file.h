@@ -7,6 +7,10 @@
 #include "zrythm-config.h"
 
 #include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
 
 #include "juce_wrapper.h"
 #include "utils/types.h"
@@ -20,6 +24,43 @@ class Transport;
  * @{
  */
 
+/**
+ * @brief Notes and name of a track in a MIDI file, with times converted to
+ * Zrythm ticks.
+ *
+ * This is plain data so it can be read off the GUI thread (see
+ * MidiFile::read_tracks()) and turned into a region later.
+ */
+struct MidiFileTrackContents
+{
+  struct Note
+  {
+    double      start_ticks_ = 0;
+    double      end_ticks_ = 0;
+    midi_byte_t pitch_ = 0;
+    midi_byte_t velocity_ = 0;
+  };
+
+  /** Index of the track in the file (including tracks without notes). */
+  int track_idx_ = 0;
+
+  /** Track name, or empty if the track has no name. */
+  std::string name_;
+
+  /**
+   * Notes, in the order they start.
+   *
+   * Notes without a note off last 1 tick.
+   */
+  std::vector<Note> notes_;
+
+  /** Position of the last matched note off, if any. */
+  std::optional<double> last_note_off_ticks_;
+
+  /** Position of the last event. */
+  double last_event_ticks_ = 0;
+};
+
 /**
  * @brief MIDI file handling.
  */
@@ -48,6 +89,14 @@ public:
    */
   MidiFile (const fs::path &path);
 
+  /**
+   * @brief Construct a new Midi File object for reading from memory.
+   *
+   * @param data Contents of a MIDI file.
+   * @throw ZrythmException If the data could not be read.
+   */
+  MidiFile (std::span<const char> data);
+
   /**
    * Returns whether the given track in the midi file has data.
    */
@@ -81,6 +130,55 @@ public:
   into_region (MidiRegion &region, Transport &transport, int midi_track_idx)
     const;
 
+  /**
+   * @brief Reads all the tracks that have MIDI note events.
+   *
+   * The tracks are converted in parallel, and nothing in the project is
+   * touched, so this can be called from any thread.
+   *
+   * @param transport_ppqn PPQN to convert the times to.
+   * @param max_threads Maximum number of threads to use (0 for the number of
+   * cores).
+   * @throw ZrythmException On error.
+   */
+  std::vector<MidiFileTrackContents>
+  read_tracks (double transport_ppqn, unsigned max_threads = 0) const;
+
+  /**
+   * @brief Reads a single track that has MIDI note events.
+   *
+   * @param midi_track_idx See into_region().
+   * @throw ZrythmException If there is no such track.
+   */
+  MidiFileTrackContents
+  read_track (double transport_ppqn, int midi_track_idx) const;
+
+  /**
+   * @brief Fills a region with the contents of a track.
+   *
+   * @param region A freshly created region to fill.
+   * @throw ZrythmException If the track has no events.
+   */
+  static void into_region (
+    const MidiFileTrackContents &contents,
+    MidiRegion                  &region,
+    Transport                   &transport);
+
+private:
+  /**
+   * @brief Reads the file from @p in_stream.
+   *
+   * @return Whether successful.
+   */
+  bool read_from (juce::InputStream &in_stream);
+
+  /**
+   * @brief Returns the indices of the tracks that have MIDI note events.
+   *
+   * @throw ZrythmException If there are too many tracks.
+   */
+  std::vector<int> get_non_empty_track_indices () const;
+
 private:
   juce::MidiFile midi_file_;
   Format         format_ = Format::MIDI0;
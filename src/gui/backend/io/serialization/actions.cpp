@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: © 2023-2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include "gui/backend/backend/actions/action_document.h"
 #include "gui/backend/backend/actions/arranger_selections_action.h"
 #include "gui/backend/backend/actions/channel_send_action.h"
 #include "gui/backend/backend/actions/chord_action.h"
@@ -15,6 +16,13 @@
 
 using namespace zrythm::gui::actions;
 
+void
+ActionDocument::define_fields (const Context &ctx)
+{
+  using T = ISerializable<ActionDocument>;
+  T::serialize_fields (ctx, T::make_field ("actions", actions_));
+}
+
 void
 UndoStack::define_fields (const Context &ctx)
 {
@@ -108,7 +116,15 @@ ArrangerSelectionsAction::define_fields (const Context &ctx)
     T::make_field ("selectionsAfter", sel_after_, true),
     T::make_field ("regionBefore", region_before_, true),
     T::make_field ("regionAfter", region_after_, true),
-    T::make_field ("r1", r1_, true), T::make_field ("r2", r2_, true));
+    T::make_field ("r1", r1_, true), T::make_field ("r2", r2_, true),
+    T::make_field ("noteIds", note_ids_, true),
+    T::make_field ("notesBefore", notes_before_, true),
+    T::make_field ("notesAfter", notes_after_, true),
+    T::make_field ("automationPointIds", automation_point_ids_, true),
+    T::make_field (
+      "automationPointsBefore", automation_points_before_, true),
+    T::make_field ("automationPointsAfter", automation_points_after_, true),
+    T::make_field ("audioFramesPatch", audio_frames_patch_, true));
 }
 
 void
@@ -26,14 +26,14 @@ ArrangerObject::define_base_fields (const Context &ctx)
   using T = ISerializable<ArrangerObject>;
   T::serialize_fields (
     ctx, T::make_field ("type", type_), T::make_field ("flags", flags_),
-    T::make_field ("trackNameHash", track_id_), T::make_field ("pos", pos_));
+    T::make_field ("trackNameHash", track_id_), T::make_field ("pos", *pos_));
 }
 
 void
 BoundedObject::define_base_fields (const Context &ctx)
 {
   ISerializable<BoundedObject>::serialize_fields (
-    ctx, ISerializable<BoundedObject>::make_field ("endPos", end_pos_));
+    ctx, ISerializable<BoundedObject>::make_field ("endPos", *end_pos_));
 }
 
 void
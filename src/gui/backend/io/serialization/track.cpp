@@ -36,7 +36,9 @@ Track::define_base_fields (const Context &ctx)
     T::make_field ("inSignalType", in_signal_type_),
     T::make_field ("outSignalType", out_signal_type_),
     T::make_field ("comment", comment_, true),
-    T::make_field ("frozen", frozen_), T::make_field ("poolId", pool_id_));
+    T::make_field ("frozen", frozen_), T::make_field ("poolId", pool_id_),
+    T::make_field ("freezeStep", freeze_step_, true),
+    T::make_field ("freezeFingerprint", freeze_fingerprint_, true));
 }
 
 template <typename TrackLaneT>
@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+
+#include "dsp/position.h"
+#include "gui/backend/position_proxy.h"
+
+/**
+ * @brief A position stored by value, with a PositionProxy created only when
+ * requested (e.g., when the position is bound to QML).
+ *
+ * Arranger objects used to own a PositionProxy (a QObject) for each of their
+ * positions, so large projects (e.g., with many MIDI notes) had hundreds of
+ * thousands of QObjects, which made cloning slow and used a lot of memory.
+ *
+ * This behaves like a pointer to the position (`pos_->ticks_`, `*pos_`), so
+ * it is accessed the same way whether the proxy exists or not. Once created,
+ * the proxy holds the position, so that changes made from QML are seen from
+ * C++ and vice versa.
+ *
+ * Assigning copies the position only (the proxy, if any, is kept).
+ */
+class LazyPositionProxy
+{
+public:
+  LazyPositionProxy () = default;
+  LazyPositionProxy (const LazyPositionProxy &) = delete;
+  LazyPositionProxy (LazyPositionProxy &&) = delete;
+  ~LazyPositionProxy () = default;
+
+  LazyPositionProxy &operator= (const dsp::Position &pos)
+  {
+    *get () = pos;
+    return *this;
+  }
+  LazyPositionProxy &operator= (const LazyPositionProxy &other)
+  {
+    return *this = *other;
+  }
+  LazyPositionProxy &operator= (LazyPositionProxy &&) = delete;
+
+  dsp::Position       *operator->() { return get (); }
+  const dsp::Position *operator->() const { return get (); }
+  dsp::Position       &operator* () { return *get (); }
+  const dsp::Position &operator* () const { return *get (); }
+
+  /**
+   * @brief Returns the proxy, creating it first if needed.
+   *
+   * Must be called from the GUI thread.
+   *
+   * @param parent Owner of the proxy (the object holding this position).
+   */
+  PositionProxy * get_proxy (QObject * parent) const
+  {
+    auto * proxy = proxy_.load (std::memory_order_acquire);
+    if (proxy == nullptr)
+      {
+        proxy = new PositionProxy (parent, &pos_);
+        proxy_.store (proxy, std::memory_order_release);
+      }
+    return proxy;
+  }
+
+  bool has_proxy () const
+  {
+    return proxy_.load (std::memory_order_acquire) != nullptr;
+  }
+
+  friend auto
+  operator<=> (const LazyPositionProxy &lhs, const LazyPositionProxy &rhs)
+  {
+    return *lhs <=> *rhs;
+  }
+  friend bool
+  operator== (const LazyPositionProxy &lhs, const LazyPositionProxy &rhs)
+  {
+    return *lhs == *rhs;
+  }
+  friend auto
+  operator<=> (const LazyPositionProxy &lhs, const dsp::Position &rhs)
+  {
+    return *lhs <=> rhs;
+  }
+  friend bool
+  operator== (const LazyPositionProxy &lhs, const dsp::Position &rhs)
+  {
+    return *lhs == rhs;
+  }
+
+private:
+  dsp::Position * get ()
+  {
+    auto * proxy = proxy_.load (std::memory_order_acquire);
+    return proxy != nullptr ? static_cast<dsp::Position *> (proxy) : &pos_;
+  }
+  const dsp::Position * get () const
+  {
+    const auto * proxy = proxy_.load (std::memory_order_acquire);
+    return proxy != nullptr
+             ? static_cast<const dsp::Position *> (proxy)
+             : &pos_;
+  }
+
+private:
+  /** The position, until the proxy is created. */
+  dsp::Position pos_;
+
+  /** Owned by its QObject parent. */
+  mutable std::atomic<PositionProxy *> proxy_ = nullptr;
+};
+
+DEFINE_OBJECT_FORMATTER (
+  LazyPositionProxy,
+  LazyPositionProxy,
+  [] (const auto &obj) { return Position_to_string (*obj); });
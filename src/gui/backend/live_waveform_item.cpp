@@ -0,0 +1,176 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "gui/backend/backend/zrythm.h"
+#include "gui/backend/live_waveform_item.h"
+#include "gui/dsp/audio_port.h"
+#include "gui/dsp/engine.h"
+
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+
+using namespace zrythm::gui;
+
+namespace
+{
+/** Interval between checks for new columns. */
+constexpr int POLL_INTERVAL_MS = 1000 / 60;
+}
+
+LiveWaveformItem::LiveWaveformItem (QQuickItem * parent) : QQuickItem (parent)
+{
+  setFlag (QQuickItem::ItemHasContents);
+  poll_timer_.setInterval (POLL_INTERVAL_MS);
+  QObject::connect (
+    &poll_timer_, &QTimer::timeout, this, &LiveWaveformItem::poll_feed);
+}
+
+LiveWaveformItem::~LiveWaveformItem ()
+{
+  release_feed ();
+}
+
+void
+LiveWaveformItem::release_feed ()
+{
+  poll_timer_.stop ();
+  if (subscribed_port_ != nullptr)
+    {
+      subscribed_port_->unsubscribe_from_ring_buffers ();
+      subscribed_port_ = nullptr;
+    }
+  feed_.reset ();
+}
+
+void
+LiveWaveformItem::setPort (const QVariant &port)
+{
+  auto * port_obj = port.value<QObject *> ();
+  if (port_obj_ == port_obj)
+    return;
+
+  release_feed ();
+  if (port_obj_)
+    {
+      QObject::disconnect (port_obj_, nullptr, this, nullptr);
+    }
+  port_obj_ = port_obj;
+
+  auto * audio_port = qobject_cast<AudioPort *> (port_obj);
+  if (audio_port)
+    {
+      QObject::connect (audio_port, &QObject::destroyed, this, [this] () {
+        poll_timer_.stop ();
+        subscribed_port_ = nullptr;
+        feed_.reset ();
+      });
+
+      feed_ = gZrythm->metering_service_->get_waveform_feed (
+        audio_port->audio_ring_,
+        static_cast<float> (AUDIO_ENGINE->sample_rate_));
+
+      /* the port only fills its ring buffer while subscribed */
+      audio_port->subscribe_to_ring_buffers ();
+      subscribed_port_ = audio_port;
+      poll_timer_.start ();
+    }
+  else if (port_obj)
+    {
+      z_warning ("live waveforms are only supported for audio ports");
+    }
+
+  Q_EMIT portChanged ();
+  update ();
+}
+
+void
+LiveWaveformItem::setColor (const QColor &color)
+{
+  if (color_ == color)
+    return;
+
+  color_ = color;
+  Q_EMIT colorChanged ();
+  update ();
+}
+
+void
+LiveWaveformItem::poll_feed ()
+{
+  if (feed_ && feed_->get_generation () != drawn_generation_ && isVisible ())
+    update ();
+}
+
+QSGNode *
+LiveWaveformItem::updatePaintNode (QSGNode * old_node, UpdatePaintNodeData *)
+{
+  auto *    node = static_cast<QSGGeometryNode *> (old_node);
+  const int width_px = static_cast<int> (width ());
+  if (!feed_ || width_px <= 0 || height () <= 0)
+    {
+      delete node;
+      return nullptr;
+    }
+
+  if (!node)
+    {
+      auto * geometry =
+        new QSGGeometry (QSGGeometry::defaultAttributes_Point2D (), 0);
+      geometry->setDrawingMode (QSGGeometry::DrawLines);
+      geometry->setLineWidth (1);
+      node = new QSGGeometryNode ();
+      node->setGeometry (geometry);
+      node->setFlag (QSGNode::OwnsGeometry);
+      node->setMaterial (new QSGFlatColorMaterial ());
+      node->setFlag (QSGNode::OwnsMaterial);
+    }
+
+  auto * material = static_cast<QSGFlatColorMaterial *> (node->material ());
+  if (material->color () != color_)
+    {
+      material->setColor (color_);
+      node->markDirty (QSGNode::DirtyMaterial);
+    }
+
+  drawn_generation_ = feed_->get_generation ();
+  feed_->get_columns (columns_);
+  const auto num_columns = columns_.size ();
+  if (num_columns == 0)
+    return node;
+
+  /* one vertical line per pixel column, spanning the min and max of the feed
+   * columns under it */
+  auto * geometry = node->geometry ();
+  geometry->allocate (width_px * 2);
+  auto *     vertices = geometry->vertexDataAsPoint2D ();
+  const auto half_height = static_cast<float> (height ()) / 2.f;
+  const auto to_y = [half_height] (float val) {
+    return half_height * (1.f - std::clamp (val, -1.f, 1.f));
+  };
+  for (int x = 0; x < width_px; ++x)
+    {
+      const auto first = static_cast<size_t> (x) * num_columns
+                         / static_cast<size_t> (width_px);
+      const auto last = std::max (
+        first + 1, static_cast<size_t> (x + 1) * num_columns
+                     / static_cast<size_t> (width_px));
+      float min = columns_[first].min_;
+      float max = columns_[first].max_;
+      for (auto i = first + 1; i < last; ++i)
+        {
+          min = std::min (min, columns_[i].min_);
+          max = std::max (max, columns_[i].max_);
+        }
+
+      const auto line_x = static_cast<float> (x) + 0.5f;
+      const auto top = to_y (max);
+      const auto bottom = std::max (to_y (min), top + 1.f);
+      vertices[x * 2].set (line_x, top);
+      vertices[x * 2 + 1].set (line_x, bottom);
+    }
+  node->markDirty (QSGNode::DirtyGeometry);
+
+  return node;
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "gui/backend/metering_service.h"
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickItem>
+#include <QTimer>
+#include <QtQmlIntegration>
+
+class AudioPort;
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Draws the recent signal of an audio port.
+ *
+ * The samples are decimated by the MeteringService into a fixed number of
+ * min/max columns shared by all the live waveforms of the port, so this
+ * only draws a line per pixel column and is only updated when new columns
+ * are published.
+ */
+class LiveWaveformItem : public QQuickItem
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (QVariant port READ port WRITE setPort NOTIFY portChanged)
+  Q_PROPERTY (QColor color READ color WRITE setColor NOTIFY colorChanged)
+
+public:
+  explicit LiveWaveformItem (QQuickItem * parent = nullptr);
+  ~LiveWaveformItem () override;
+
+  QVariant port () const { return QVariant::fromValue (port_obj_.get ()); }
+  void     setPort (const QVariant &port);
+
+  QColor color () const { return color_; }
+  void   setColor (const QColor &color);
+
+Q_SIGNALS:
+  void portChanged ();
+  void colorChanged ();
+
+protected:
+  QSGNode *
+  updatePaintNode (QSGNode * old_node, UpdatePaintNodeData * data) override;
+
+private:
+  /**
+   * @brief Unsubscribes from the ring buffers of the port, if subscribed, and
+   * releases the feed.
+   */
+  void release_feed ();
+
+  /**
+   * @brief Schedules a redraw if the feed published new columns.
+   */
+  void poll_feed ();
+
+private:
+  QPointer<QObject> port_obj_;
+
+  /** Port subscribed to, while @ref feed_ is held. */
+  AudioPort * subscribed_port_ = nullptr;
+
+  std::shared_ptr<const MeteringService::WaveformFeed> feed_;
+
+  /** Feed generation drawn last. */
+  uint64_t drawn_generation_ = 0;
+
+  QColor color_ = Qt::white;
+
+  QTimer poll_timer_;
+
+  /** Columns copied from the feed (kept to avoid reallocating). */
+  std::vector<MeteringService::WaveformFeed::Column> columns_;
+};
+
+} // namespace zrythm::gui
@@ -0,0 +1,203 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "dsp/graph_scheduler.h"
+#include "dsp/timestretch_cache.h"
+#include "gui/backend/backend/project.h"
+#include "gui/backend/backend/zrythm.h"
+#include "gui/backend/memory_usage_model.h"
+#include "gui/dsp/arranger_object_all.h"
+#include "gui/dsp/engine.h"
+#include "gui/dsp/pool.h"
+#include "gui/dsp/port_all.h"
+#include "gui/dsp/router.h"
+#include "gui/dsp/track.h"
+#include "gui/dsp/tracklist.h"
+#include "utils/io.h"
+
+#include <QJsonArray>
+#include <QJsonDocument>
+
+using namespace zrythm::gui;
+using namespace Qt::StringLiterals;
+
+namespace
+{
+QVariantList
+entries_to_variant_list (const std::vector<MemoryUsageModel::Entry> &entries)
+{
+  QVariantList ret;
+  for (const auto &entry : entries)
+    {
+      ret.append (QVariantMap{
+        { u"name"_s, QString::fromStdString (entry.name_) },
+        { u"bytes"_s, static_cast<double> (entry.bytes_) },
+      });
+    }
+  return ret;
+}
+
+QJsonArray
+entries_to_json (const std::vector<MemoryUsageModel::Entry> &entries)
+{
+  QJsonArray ret;
+  for (const auto &entry : entries)
+    {
+      ret.append (QJsonObject{
+        { u"name"_s, QString::fromStdString (entry.name_) },
+        { u"bytes"_s, static_cast<qint64> (entry.bytes_) },
+      });
+    }
+  return ret;
+}
+}
+
+size_t
+MemoryUsageModel::Usage::get_total_bytes () const
+{
+  size_t ret = 0;
+  for (const auto &entry : subsystems_)
+    {
+      ret += entry.bytes_;
+    }
+  return ret;
+}
+
+MemoryUsageModel::MemoryUsageModel (QObject * parent) : QObject (parent) { }
+
+QVariantList
+MemoryUsageModel::subsystems () const
+{
+  return entries_to_variant_list (usage_.subsystems_);
+}
+
+QVariantList
+MemoryUsageModel::tracks () const
+{
+  return entries_to_variant_list (usage_.tracks_);
+}
+
+void
+MemoryUsageModel::refresh ()
+{
+  usage_ = {};
+  if (auto * project = PROJECT)
+    {
+      usage_ = get_usage (*project);
+    }
+  Q_EMIT changed ();
+}
+
+QString
+MemoryUsageModel::toJson () const
+{
+  return QString::fromUtf8 (
+    QJsonDocument (to_json (usage_)).toJson (QJsonDocument::Indented));
+}
+
+MemoryUsageModel::Usage
+MemoryUsageModel::get_usage (const Project &project)
+{
+  Usage usage;
+
+  size_t arranger_objects_bytes = 0;
+  if (project.tracklist_)
+    {
+      std::vector<ArrangerObjectPtrVariant> objs;
+      for (const auto &track_var : project.tracklist_->get_track_span ())
+        {
+          const auto * track = Track::from_variant (track_var);
+          objs.clear ();
+          track->append_objects (objs);
+          size_t bytes = 0;
+          for (const auto &obj_var : objs)
+            {
+              bytes += std::visit (
+                [] (auto &&obj) { return obj->get_memory_usage (); }, obj_var);
+            }
+          usage.tracks_.push_back (
+            { .name_ = track->get_name (), .bytes_ = bytes });
+          arranger_objects_bytes += bytes;
+        }
+    }
+  usage.subsystems_.push_back (
+    { .name_ = "arranger_objects", .bytes_ = arranger_objects_bytes });
+
+  size_t pool_bytes = 0;
+  size_t waveform_bytes = 0;
+  size_t graph_bytes = 0;
+  if (const auto &engine = project.audio_engine_)
+    {
+      if (engine->pool_)
+        {
+          for (const auto &clip : engine->pool_->clips_)
+            {
+              pool_bytes += clip->get_memory_usage ();
+              waveform_bytes += clip->get_peaks ()->get_memory_usage ();
+            }
+        }
+      if (engine->router_ && engine->router_->scheduler_)
+        {
+          graph_bytes = engine->router_->scheduler_->get_memory_usage ();
+        }
+    }
+  usage.subsystems_.push_back ({ .name_ = "audio_pool", .bytes_ = pool_bytes });
+  usage.subsystems_.push_back (
+    { .name_ = "waveforms", .bytes_ = waveform_bytes });
+
+  size_t ports_bytes = 0;
+  for (const auto &port_var : project.get_port_registry ().get_hash_map ())
+    {
+      ports_bytes += std::visit (
+        [] (auto &&port) {
+          return sizeof (*port) + port->get_memory_usage ();
+        },
+        port_var);
+    }
+  usage.subsystems_.push_back ({ .name_ = "ports", .bytes_ = ports_bytes });
+
+  size_t undo_bytes = 0;
+  if (const auto * undo_manager = project.undo_manager_)
+    {
+      undo_bytes = undo_manager->getUndoStack ()->get_memory_estimate ()
+                   + undo_manager->getRedoStack ()->get_memory_estimate ();
+    }
+  usage.subsystems_.push_back (
+    { .name_ = "undo_history", .bytes_ = undo_bytes });
+
+  usage.subsystems_.push_back ({ .name_ = "graph", .bytes_ = graph_bytes });
+
+  size_t timestretch_bytes = 0;
+  if (gZrythm && gZrythm->timestretch_cache_)
+    {
+      timestretch_bytes = gZrythm->timestretch_cache_->get_memory_usage ();
+    }
+  usage.subsystems_.push_back (
+    { .name_ = "timestretch_cache", .bytes_ = timestretch_bytes });
+
+  return usage;
+}
+
+QJsonObject
+MemoryUsageModel::to_json (const Project &project)
+{
+  return to_json (get_usage (project));
+}
+
+void
+MemoryUsageModel::dump_to_file (const Project &project, const QString &path)
+{
+  const auto json =
+    QJsonDocument (to_json (project)).toJson (QJsonDocument::Indented);
+  utils::io::set_file_contents (path.toStdString (), json.toStdString ());
+}
+
+QJsonObject
+MemoryUsageModel::to_json (const Usage &usage)
+{
+  return QJsonObject{
+    { u"total_bytes"_s, static_cast<qint64> (usage.get_total_bytes ()) },
+    { u"subsystems"_s, entries_to_json (usage.subsystems_) },
+    { u"tracks"_s, entries_to_json (usage.tracks_) },
+  };
+}
@@ -0,0 +1,114 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QJsonObject>
+#include <QObject>
+#include <QQmlEngine>
+#include <QtQmlIntegration>
+
+class Project;
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Approximate memory used by each subsystem of the active project
+ * (audio pool, arranger objects of each track, ports, undo history, graph,
+ * waveform summaries and caches).
+ *
+ * The numbers are estimates from the sizes of the objects and of their
+ * buffers, meant for spotting what grows, not exact accounting. Plugins are
+ * not included since the plugin APIs don't report their memory usage.
+ *
+ * The values are updated on refresh().
+ */
+class MemoryUsageModel : public QObject
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (QVariantList subsystems READ subsystems NOTIFY changed)
+  Q_PROPERTY (QVariantList tracks READ tracks NOTIFY changed)
+  Q_PROPERTY (double totalBytes READ totalBytes NOTIFY changed)
+
+public:
+  /**
+   * @brief Bytes used by a subsystem or track.
+   */
+  struct Entry
+  {
+    std::string name_;
+    size_t      bytes_ = 0;
+  };
+
+  struct Usage
+  {
+    std::vector<Entry> subsystems_;
+
+    /** Arranger objects of each track (included in the subsystems). */
+    std::vector<Entry> tracks_;
+
+    size_t get_total_bytes () const;
+  };
+
+  explicit MemoryUsageModel (QObject * parent = nullptr);
+
+  /**
+   * @brief Returns the subsystems as objects with `name` and `bytes`.
+   */
+  QVariantList subsystems () const;
+
+  /**
+   * @brief Returns the tracks as objects with `name` and `bytes`.
+   */
+  QVariantList tracks () const;
+
+  double totalBytes () const
+  {
+    return static_cast<double> (usage_.get_total_bytes ());
+  }
+
+  /**
+   * @brief Measures the active project's memory usage again.
+   */
+  Q_INVOKABLE void refresh ();
+
+  /**
+   * @brief Returns the current measurement as indented JSON.
+   */
+  Q_INVOKABLE QString toJson () const;
+
+  /**
+   * @brief Measures the memory usage of @p project.
+   *
+   * @note Must be called from the main thread.
+   */
+  static Usage get_usage (const Project &project);
+
+  /**
+   * @brief Returns the memory usage of @p project as JSON.
+   */
+  static QJsonObject to_json (const Project &project);
+
+  /**
+   * @brief Writes the memory usage of @p project as JSON to @p path.
+   *
+   * @throw ZrythmException on failure.
+   */
+  static void dump_to_file (const Project &project, const QString &path);
+
+Q_SIGNALS:
+  void changed ();
+
+private:
+  static QJsonObject to_json (const Usage &usage);
+
+private:
+  Usage usage_;
+};
+
+} // namespace zrythm::gui
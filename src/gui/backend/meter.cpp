@@ -1,7 +1,7 @@
 // SPDX-FileCopyrightText: © 2020-2022, 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
-#include "dsp/kmeter_dsp.h"
+#include "gui/backend/backend/zrythm.h"
 #include "gui/backend/meter.h"
 #include "gui/dsp/audio_port.h"
 #include "gui/dsp/engine.h"
@@ -15,11 +15,29 @@
 
 MeterProcessor::MeterProcessor (QObject * parent) : QObject (parent) { }
 
+MeterProcessor::~MeterProcessor ()
+{
+  release_ring_buffer_subscription ();
+}
+
+void
+MeterProcessor::release_ring_buffer_subscription ()
+{
+  if (subscribed_port_ != nullptr)
+    {
+      subscribed_port_->unsubscribe_from_ring_buffers ();
+      subscribed_port_ = nullptr;
+    }
+  meter_.reset ();
+}
+
 void
 MeterProcessor::setPort (QVariant port_var)
 {
+  release_ring_buffer_subscription ();
   if (port_obj_)
     {
+      QObject::disconnect (port_obj_, nullptr, this, nullptr);
       port_obj_.clear ();
     }
   port_obj_ = port_var.value<QObject *> ();
@@ -27,6 +45,8 @@ MeterProcessor::setPort (QVariant port_var)
     {
       QObject::connect (port_obj_, &QObject::destroyed, this, [this] () {
         port_obj_.clear ();
+        subscribed_port_ = nullptr;
+        meter_.reset ();
       });
 
       std::visit (
@@ -54,21 +74,17 @@ MeterProcessor::setPort (QVariant port_var)
                     track_var.value ());
                 }
 
-              if (is_master_fader)
-                {
-                  algorithm_ = MeterAlgorithm::METER_ALGORITHM_K;
-                  kmeter_processor_ =
-                    std::make_unique<zrythm::dsp::KMeterDsp> ();
-                  kmeter_processor_->init (AUDIO_ENGINE->sample_rate_);
-                }
-              else
-                {
-                  algorithm_ = MeterAlgorithm::METER_ALGORITHM_DIGITAL_PEAK;
-                  peak_processor_ = std::make_unique<zrythm::dsp::PeakDsp> ();
-                  peak_processor_->init (AUDIO_ENGINE->sample_rate_);
-                }
+              algorithm_ =
+                is_master_fader
+                  ? MeterAlgorithm::METER_ALGORITHM_K
+                  : MeterAlgorithm::METER_ALGORITHM_DIGITAL_PEAK;
+              meter_ = gZrythm->metering_service_->get_meter (
+                port_->audio_ring_, algorithm_,
+                static_cast<float> (AUDIO_ENGINE->sample_rate_));
 
-              tmp_buf_.reserve (AudioPort::AUDIO_RING_SIZE);
+              /* the port only fills its ring buffer while subscribed */
+              port_->subscribe_to_ring_buffers ();
+              subscribed_port_ = port_;
             }
           else if (port_->is_event ())
             {
@@ -142,62 +158,21 @@ MeterProcessor::get_value (AudioValueFormat format, float * val, float * max)
       if constexpr (
         std::derived_from<PortT, AudioPort> || std::derived_from<PortT, CVPort>)
         {
-          size_t       read_space_avail = port->audio_ring_->read_space ();
-          const size_t block_length = AUDIO_ENGINE->block_length_;
-          size_t       blocks_to_read =
-            block_length == 0 ? 0 : read_space_avail / block_length;
-          /* if no blocks available, skip */
-          if (blocks_to_read == 0)
-            {
-              *val = 1e-20f;
-              *max = 1e-20f;
-              z_trace ("no blocks to read for port {}", port->get_label ());
-              return;
-            }
-
-          z_return_if_fail (tmp_buf_.capacity () >= read_space_avail);
-          tmp_buf_.resize (read_space_avail);
-          auto samples_read = port->audio_ring_->peek_multiple (
-            tmp_buf_.data (), read_space_avail);
-          auto   blocks_read = samples_read / block_length;
-          auto   num_cycles = std::min (static_cast<size_t> (4), blocks_read);
-          size_t start_index = (blocks_read - num_cycles) * block_length;
-          if (blocks_read == 0)
+          if (!meter_)
             {
-              z_debug ("blocks read for port {} is 0", port->get_label ());
               *val = 1e-20f;
               *max = 1e-20f;
               return;
             }
 
-          switch (algorithm_)
-            {
-            case MeterAlgorithm::METER_ALGORITHM_RMS:
-              /* not used */
-              z_warn_if_reached ();
-              amp = utils::math::calculate_rms_amp (
-                &tmp_buf_[start_index], (size_t) num_cycles * block_length);
-              break;
-            case MeterAlgorithm::METER_ALGORITHM_TRUE_PEAK:
-              true_peak_processor_->process (port->buf_.data (), block_length);
-              amp = true_peak_processor_->read_f ();
-              break;
-            case MeterAlgorithm::METER_ALGORITHM_K:
-              kmeter_processor_->process (port->buf_.data (), block_length);
-              std::tie (amp, max_amp) = kmeter_processor_->read ();
-              break;
-            case MeterAlgorithm::METER_ALGORITHM_DIGITAL_PEAK:
-              peak_processor_->process (port->buf_.data (), block_length);
-              std::tie (amp, max_amp) = peak_processor_->read ();
-              break;
-            default:
-              break;
-            }
+          const auto values = meter_->get_values ();
+          amp = values.amp_;
+          max_amp = values.max_amp_;
         }
       else if constexpr (std::derived_from<PortT, MidiPort>)
         {
           bool on = false;
-          if (port->write_ring_buffers_)
+          if (port->has_ring_buffer_subscribers ())
             {
               MidiEvent event;
               while (port->midi_ring_->peek (event))
@@ -4,9 +4,7 @@
 #ifndef __AUDIO_METER_H__
 #define __AUDIO_METER_H__
 
-#include "dsp/kmeter_dsp.h"
-#include "dsp/peak_dsp.h"
-#include "dsp/true_peak_dsp.h"
+#include "gui/backend/metering_service.h"
 #include "utils/traits.h"
 #include "utils/types.h"
 
@@ -22,19 +20,6 @@ class AudioPort;
  * @{
  */
 
-enum class MeterAlgorithm
-{
-  /** Use default algorithm for the port. */
-  METER_ALGORITHM_AUTO,
-
-  METER_ALGORITHM_DIGITAL_PEAK,
-
-  /** @note True peak is intensive, only use it where needed (mixer). */
-  METER_ALGORITHM_TRUE_PEAK,
-  METER_ALGORITHM_RMS,
-  METER_ALGORITHM_K,
-};
-
 /**
  * @brief A meter processor for a single GUI element.
  *
@@ -43,8 +28,8 @@ enum class MeterAlgorithm
  * including digital peak, true peak, RMS, and K-meter.
  *
  * The meter processor is associated with a port, which can be either an
- * AudioPort or a MidiPort. The meter values are updated based on the data
- * from the associated port.
+ * AudioPort or a MidiPort. The meter values of audio ports are computed by
+ * the MeteringService, and only read and smoothed here.
  *
  * The meter processor emits the `valuesChanged` signal whenever the meter
  * values are updated, allowing the GUI to update the display accordingly.
@@ -65,6 +50,7 @@ public:
   using MeterPortPtrVariant = to_pointer_variant<MeterPortVariant>;
 
   MeterProcessor (QObject * parent = nullptr);
+  ~MeterProcessor () override;
 
   // ================================================================
   // QML Interface
@@ -98,22 +84,18 @@ private:
    */
   void get_value (AudioValueFormat format, float * val, float * max);
 
+  /**
+   * @brief Unsubscribes from the ring buffers of the port, if subscribed, and
+   * releases the meter.
+   */
+  void release_ring_buffer_subscription ();
+
 public:
   /** Port associated with this meter. */
   QPointer<QObject> port_obj_;
 
-  /** True peak processor. */
-  std::unique_ptr<zrythm::dsp::TruePeakDsp> true_peak_processor_;
-  std::unique_ptr<zrythm::dsp::TruePeakDsp> true_peak_max_processor_;
-
-  /** Current true peak. */
-  float true_peak_ = 0.f;
-  float true_peak_max_ = 0.f;
-
-  /** K RMS processor, if K meter. */
-  std::unique_ptr<zrythm::dsp::KMeterDsp> kmeter_processor_;
-
-  std::unique_ptr<zrythm::dsp::PeakDsp> peak_processor_;
+  /** Meter computing the values of audio/CV ports. */
+  std::shared_ptr<const MeteringService::Meter> meter_;
 
   /**
    * Algorithm to use.
@@ -135,7 +117,11 @@ public:
   qint64 last_midi_trigger_time_ = 0;
 
 private:
-  std::vector<float> tmp_buf_;
+  /**
+   * @brief The port whose ring buffers this meter is subscribed to (see
+   * Port::subscribe_to_ring_buffers()).
+   */
+  Port * subscribed_port_ = nullptr;
 
   std::atomic<float> current_amp_ = 0.f;
   std::atomic<float> peak_amp_ = 0.f;
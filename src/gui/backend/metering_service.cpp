@@ -0,0 +1,333 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <span>
+
+#include "gui/backend/metering_service.h"
+#include "utils/dsp.h"
+#include "utils/math.h"
+
+MeteringService::Meter::Meter (
+  std::shared_ptr<RingBuffer<float>> ring,
+  MeterAlgorithm                     algorithm,
+  float                              sample_rate)
+    : RingConsumer (std::move (ring)), algorithm_ (algorithm),
+      sample_rate_ (sample_rate)
+{
+  switch (algorithm_)
+    {
+    case MeterAlgorithm::METER_ALGORITHM_DIGITAL_PEAK:
+      peak_processor_ = std::make_unique<zrythm::dsp::PeakDsp> ();
+      peak_processor_->init (sample_rate);
+      break;
+    case MeterAlgorithm::METER_ALGORITHM_K:
+      kmeter_processor_ = std::make_unique<zrythm::dsp::KMeterDsp> ();
+      kmeter_processor_->init (sample_rate);
+      break;
+    case MeterAlgorithm::METER_ALGORITHM_TRUE_PEAK:
+      true_peak_processor_ = std::make_unique<zrythm::dsp::TruePeakDsp> ();
+      true_peak_processor_->init (sample_rate);
+      break;
+    default:
+      break;
+    }
+}
+
+void
+MeteringService::Meter::publish (Values values)
+{
+  amp_.store (values.amp_, std::memory_order_relaxed);
+  max_amp_.store (values.max_amp_, std::memory_order_relaxed);
+}
+
+void
+MeteringService::Meter::process (float * buf, size_t num_samples)
+{
+  const auto n = static_cast<int> (num_samples);
+  switch (algorithm_)
+    {
+    case MeterAlgorithm::METER_ALGORITHM_DIGITAL_PEAK:
+      peak_processor_->process (buf, n);
+      break;
+    case MeterAlgorithm::METER_ALGORITHM_K:
+      kmeter_processor_->process (buf, n);
+      break;
+    case MeterAlgorithm::METER_ALGORITHM_TRUE_PEAK:
+      true_peak_processor_->process (buf, n);
+      break;
+    case MeterAlgorithm::METER_ALGORITHM_RMS:
+      for (size_t i = 0; i < num_samples; i++)
+        {
+          rms_sum_ += buf[i] * buf[i];
+        }
+      rms_peak_ = std::max (
+        rms_peak_, utils::float_ranges::abs_max (buf, num_samples, true));
+      break;
+    default:
+      break;
+    }
+}
+
+void
+MeteringService::Meter::finish_update (size_t num_samples)
+{
+  if (num_samples == 0)
+    {
+      /* the port is not being processed anymore */
+      constexpr int max_updates_without_data = 6;
+      if (++updates_without_data_ == max_updates_without_data)
+        {
+          publish ({});
+        }
+      return;
+    }
+  updates_without_data_ = 0;
+
+  Values values;
+  switch (algorithm_)
+    {
+    case MeterAlgorithm::METER_ALGORITHM_DIGITAL_PEAK:
+      std::tie (values.amp_, values.max_amp_) = peak_processor_->read ();
+      break;
+    case MeterAlgorithm::METER_ALGORITHM_K:
+      std::tie (values.amp_, values.max_amp_) = kmeter_processor_->read ();
+      break;
+    case MeterAlgorithm::METER_ALGORITHM_TRUE_PEAK:
+      values.amp_ = true_peak_processor_->read_f ();
+      values.max_amp_ = values.amp_;
+      break;
+    case MeterAlgorithm::METER_ALGORITHM_RMS:
+      values.amp_ = std::sqrt (rms_sum_ / static_cast<float> (num_samples));
+      values.max_amp_ = rms_peak_;
+      rms_sum_ = 0.f;
+      rms_peak_ = 0.f;
+      break;
+    default:
+      break;
+    }
+  publish (values);
+}
+
+MeteringService::WaveformFeed::WaveformFeed (
+  std::shared_ptr<RingBuffer<float>> ring,
+  float                              sample_rate)
+    : RingConsumer (std::move (ring)), sample_rate_ (sample_rate),
+      samples_per_column_ (std::max<size_t> (
+        1,
+        static_cast<size_t> (sample_rate * DURATION_MS / 1000.f)
+          / NUM_COLUMNS)),
+      history_ (NUM_COLUMNS), published_ (NUM_COLUMNS)
+{
+}
+
+void
+MeteringService::WaveformFeed::get_columns (std::vector<Column> &columns) const
+{
+  const std::lock_guard lock (published_mutex_);
+  columns = published_;
+}
+
+void
+MeteringService::WaveformFeed::process (float * buf, size_t num_samples)
+{
+  while (num_samples > 0)
+    {
+      const auto n =
+        std::min (num_samples, samples_per_column_ - current_num_samples_);
+      const auto [min, max] = std::ranges::minmax (std::span (buf, n));
+      if (current_num_samples_ == 0)
+        {
+          current_column_ = { min, max };
+        }
+      else
+        {
+          current_column_.min_ = std::min (current_column_.min_, min);
+          current_column_.max_ = std::max (current_column_.max_, max);
+        }
+      current_num_samples_ += n;
+      buf += n;
+      num_samples -= n;
+
+      if (current_num_samples_ == samples_per_column_)
+        {
+          history_[next_column_] = current_column_;
+          next_column_ = (next_column_ + 1) % history_.size ();
+          current_num_samples_ = 0;
+          has_new_columns_ = true;
+        }
+    }
+}
+
+void
+MeteringService::WaveformFeed::finish_update (size_t num_samples)
+{
+  if (num_samples == 0)
+    {
+      /* the port is not being processed anymore */
+      constexpr int max_updates_without_data = 6;
+      if (++updates_without_data_ == max_updates_without_data)
+        {
+          std::ranges::fill (history_, Column{});
+          current_num_samples_ = 0;
+          has_new_columns_ = true;
+        }
+    }
+  else
+    {
+      updates_without_data_ = 0;
+    }
+
+  if (!has_new_columns_)
+    return;
+
+  {
+    const std::lock_guard lock (published_mutex_);
+    std::ranges::rotate_copy (
+      history_, history_.begin () + static_cast<ptrdiff_t> (next_column_),
+      published_.begin ());
+  }
+  generation_.fetch_add (1, std::memory_order_release);
+  has_new_columns_ = false;
+}
+
+MeteringService::MeteringService ()
+    : juce::Thread ("MeteringService"),
+      scratch_ (zrythm::dsp::TruePeakDsp::MAX_BLOCK_LENGTH)
+{
+}
+
+MeteringService::~MeteringService ()
+{
+  stopThread (-1);
+}
+
+void
+MeteringService::start_if_needed ()
+{
+  if (!isThreadRunning ())
+    {
+      startThread (juce::Thread::Priority::low);
+    }
+}
+
+std::shared_ptr<const MeteringService::Meter>
+MeteringService::get_meter (
+  std::shared_ptr<RingBuffer<float>> ring,
+  MeterAlgorithm                     algorithm,
+  float                              sample_rate)
+{
+  std::shared_ptr<Meter> meter;
+  {
+    const std::lock_guard lock (consumers_mutex_);
+    for (const auto &consumer : consumers_)
+      {
+        auto existing = std::dynamic_pointer_cast<Meter> (consumer);
+        if (
+          existing && existing->ring_ == ring
+          && existing->algorithm_ == algorithm
+          && utils::math::floats_equal (existing->sample_rate_, sample_rate))
+          {
+            return existing;
+          }
+      }
+
+    meter = std::make_shared<Meter> (std::move (ring), algorithm, sample_rate);
+    consumers_.push_back (meter);
+  }
+
+  start_if_needed ();
+  return meter;
+}
+
+std::shared_ptr<const MeteringService::WaveformFeed>
+MeteringService::get_waveform_feed (
+  std::shared_ptr<RingBuffer<float>> ring,
+  float                              sample_rate)
+{
+  std::shared_ptr<WaveformFeed> feed;
+  {
+    const std::lock_guard lock (consumers_mutex_);
+    for (const auto &consumer : consumers_)
+      {
+        auto existing = std::dynamic_pointer_cast<WaveformFeed> (consumer);
+        if (
+          existing && existing->ring_ == ring
+          && utils::math::floats_equal (existing->sample_rate_, sample_rate))
+          {
+            return existing;
+          }
+      }
+
+    feed = std::make_shared<WaveformFeed> (std::move (ring), sample_rate);
+    consumers_.push_back (feed);
+  }
+
+  start_if_needed ();
+  return feed;
+}
+
+void
+MeteringService::update_consumers ()
+{
+  {
+    const std::lock_guard lock (consumers_mutex_);
+
+    /* drop the consumers only referenced by this */
+    std::erase_if (consumers_, [] (const auto &consumer) {
+      return consumer.use_count () == 1;
+    });
+    consumers_to_update_ = consumers_;
+  }
+
+  std::ranges::sort (consumers_to_update_, {}, [] (const auto &consumer) {
+    return consumer->ring_.get ();
+  });
+
+  for (
+    auto group_begin = consumers_to_update_.begin ();
+    group_begin != consumers_to_update_.end ();)
+    {
+      auto &ring = *(*group_begin)->ring_;
+      auto  group_end = std::find_if (
+        group_begin, consumers_to_update_.end (),
+        [&ring] (const auto &consumer) {
+          return consumer->ring_.get () != &ring;
+        });
+
+      /* only drain what is available now, so that a busy port can't keep
+       * this busy */
+      const size_t num_samples = ring.read_space ();
+      size_t       num_samples_read = 0;
+      while (num_samples_read < num_samples)
+        {
+          const auto chunk_size =
+            std::min (num_samples - num_samples_read, scratch_.size ());
+          if (!ring.read_multiple (scratch_.data (), chunk_size))
+            break;
+
+          for (auto it = group_begin; it != group_end; ++it)
+            {
+              (*it)->process (scratch_.data (), chunk_size);
+            }
+          num_samples_read += chunk_size;
+        }
+
+      for (auto it = group_begin; it != group_end; ++it)
+        {
+          (*it)->finish_update (num_samples_read);
+        }
+      group_begin = group_end;
+    }
+  consumers_to_update_.clear ();
+}
+
+void
+MeteringService::run ()
+{
+  while (!threadShouldExit ())
+    {
+      update_consumers ();
+      wait (UPDATE_INTERVAL_MS);
+    }
+}
@@ -0,0 +1,290 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "dsp/kmeter_dsp.h"
+#include "dsp/peak_dsp.h"
+#include "dsp/true_peak_dsp.h"
+#include "utils/ring_buffer.h"
+
+#include "juce_wrapper.h"
+
+/**
+ * @addtogroup dsp
+ *
+ * @{
+ */
+
+enum class MeterAlgorithm
+{
+  /** Use default algorithm for the port. */
+  METER_ALGORITHM_AUTO,
+
+  METER_ALGORITHM_DIGITAL_PEAK,
+
+  METER_ALGORITHM_TRUE_PEAK,
+  METER_ALGORITHM_RMS,
+  METER_ALGORITHM_K,
+};
+
+/**
+ * @brief Computes the values of all meters and live waveforms shown in the UI.
+ *
+ * Instead of each MeterProcessor pulling and processing the data of its port
+ * on the GUI thread, this drains the ring buffers of all metered ports in a
+ * single pass on a low-priority thread, and publishes the results through
+ * atomics that MeterProcessor's read without blocking.
+ *
+ * Live waveforms are fed the same way, with the samples decimated to a fixed
+ * number of min/max columns (see WaveformFeed).
+ */
+class MeteringService final : public juce::Thread
+{
+public:
+  /** Interval between meter updates. */
+  static constexpr int UPDATE_INTERVAL_MS = 1000 / 60;
+
+  /**
+   * @brief Meter values (as amplitudes).
+   */
+  struct Values
+  {
+    /** Current value (e.g., RMS for K meters). */
+    float amp_ = 0.f;
+
+    /** Peak value since the last update. */
+    float max_amp_ = 0.f;
+  };
+
+  /**
+   * @brief Consumer of the samples drained from a ring buffer.
+   */
+  class RingConsumer
+  {
+  public:
+    virtual ~RingConsumer () = default;
+
+  protected:
+    explicit RingConsumer (std::shared_ptr<RingBuffer<float>> ring)
+        : ring_ (std::move (ring))
+    {
+    }
+
+    /**
+     * @brief Processes samples read from the ring buffer.
+     */
+    virtual void process (float * buf, size_t num_samples) = 0;
+
+    /**
+     * @brief Publishes the results of the samples processed since the last
+     * call.
+     *
+     * @param num_samples Number of samples processed since the last call.
+     */
+    virtual void finish_update (size_t num_samples) = 0;
+
+  protected:
+    friend class MeteringService;
+
+    /** Ring buffer of the port (see Port::audio_ring_). */
+    std::shared_ptr<RingBuffer<float>> ring_;
+  };
+
+  /**
+   * @brief Meter of a single ring buffer, shared by all MeterProcessor's that
+   * show the same port with the same algorithm.
+   */
+  class Meter final : public RingConsumer
+  {
+  public:
+    Meter (
+      std::shared_ptr<RingBuffer<float>> ring,
+      MeterAlgorithm                     algorithm,
+      float                              sample_rate);
+
+    /**
+     * @brief Returns the values published by the last update.
+     *
+     * Can be called from any thread.
+     */
+    Values get_values () const
+    {
+      return {
+        amp_.load (std::memory_order_relaxed),
+        max_amp_.load (std::memory_order_relaxed)
+      };
+    }
+
+  private:
+    friend class MeteringService;
+
+    void process (float * buf, size_t num_samples) override;
+    void finish_update (size_t num_samples) override;
+
+    void publish (Values values);
+
+  private:
+    MeterAlgorithm algorithm_;
+    float          sample_rate_;
+
+    std::unique_ptr<zrythm::dsp::PeakDsp>     peak_processor_;
+    std::unique_ptr<zrythm::dsp::KMeterDsp>   kmeter_processor_;
+    std::unique_ptr<zrythm::dsp::TruePeakDsp> true_peak_processor_;
+
+    /** Consecutive updates without new samples. */
+    int updates_without_data_ = 0;
+
+    /** Sum of squares and peak since the last update, for RMS meters. */
+    float rms_sum_ = 0.f;
+    float rms_peak_ = 0.f;
+
+    std::atomic<float> amp_ = 0.f;
+    std::atomic<float> max_amp_ = 0.f;
+  };
+
+  /**
+   * @brief Recent samples of a single ring buffer decimated to min/max pairs,
+   * shared by all the live waveforms showing the same port.
+   *
+   * Each column covers a fixed number of samples (depending on the sample
+   * rate), so drawing costs the same regardless of the sample rate.
+   */
+  class WaveformFeed final : public RingConsumer
+  {
+  public:
+    /** Number of columns in the feed. */
+    static constexpr size_t NUM_COLUMNS = 512;
+
+    /** Duration covered by all the columns. */
+    static constexpr int DURATION_MS = 2000;
+
+    struct Column
+    {
+      float min_ = 0.f;
+      float max_ = 0.f;
+    };
+
+    WaveformFeed (std::shared_ptr<RingBuffer<float>> ring, float sample_rate);
+
+    /**
+     * @brief Returns a number that changes each time new columns are
+     * published.
+     *
+     * Can be called from any thread.
+     */
+    uint64_t get_generation () const
+    {
+      return generation_.load (std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Copies the published columns, oldest first, to @p columns.
+     *
+     * Can be called from any thread.
+     */
+    void get_columns (std::vector<Column> &columns) const;
+
+  private:
+    friend class MeteringService;
+
+    void process (float * buf, size_t num_samples) override;
+    void finish_update (size_t num_samples) override;
+
+  private:
+    float  sample_rate_;
+    size_t samples_per_column_;
+
+    /** Completed columns, as a circular buffer (service thread only). */
+    std::vector<Column> history_;
+
+    /** Index in @ref history_ of the next column to complete. */
+    size_t next_column_ = 0;
+
+    /** Column being accumulated and the number of samples in it. */
+    Column current_column_;
+    size_t current_num_samples_ = 0;
+
+    /** Whether columns were completed since the last publish. */
+    bool has_new_columns_ = false;
+
+    /** Consecutive updates without new samples. */
+    int updates_without_data_ = 0;
+
+    /** Protects @ref published_. */
+    mutable std::mutex published_mutex_;
+
+    /** Columns as of the last update, oldest first. */
+    std::vector<Column> published_;
+
+    std::atomic<uint64_t> generation_ = 0;
+  };
+
+  MeteringService ();
+  ~MeteringService () override;
+
+  /**
+   * @brief Returns a meter for the given ring buffer, creating it if needed.
+   *
+   * The meter is updated for as long as the returned pointer is held. The
+   * port must be subscribed to (see Port::subscribe_to_ring_buffers()) for
+   * its ring buffer to be filled.
+   *
+   * @param ring Ring buffer of an audio or CV port.
+   */
+  std::shared_ptr<const Meter> get_meter (
+    std::shared_ptr<RingBuffer<float>> ring,
+    MeterAlgorithm                     algorithm,
+    float                              sample_rate);
+
+  /**
+   * @brief Returns a waveform feed for the given ring buffer, creating it if
+   * needed.
+   *
+   * Same as get_meter() otherwise.
+   */
+  std::shared_ptr<const WaveformFeed> get_waveform_feed (
+    std::shared_ptr<RingBuffer<float>> ring,
+    float                              sample_rate);
+
+  void run () override;
+
+private:
+  /**
+   * @brief Starts the service thread if not running.
+   */
+  void start_if_needed ();
+
+  /**
+   * @brief Updates all consumers in one pass and drops the ones no longer
+   * used.
+   *
+   * Each ring buffer is drained once and its samples are fed to all of its
+   * consumers.
+   */
+  void update_consumers ();
+
+private:
+  /** Protects @ref consumers_. */
+  std::mutex consumers_mutex_;
+
+  std::vector<std::shared_ptr<RingConsumer>> consumers_;
+
+  /**
+   * Consumers being updated, grouped by ring buffer (only used by the service
+   * thread).
+   */
+  std::vector<std::shared_ptr<RingConsumer>> consumers_to_update_;
+
+  /** Buffer the ring buffers are drained into. */
+  std::vector<float> scratch_;
+};
+
+/**
+ * @}
+ */
@@ -0,0 +1,277 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/backend/midi_note_window_model.h"
+#include "gui/dsp/midi_note.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_set>
+
+using namespace zrythm::gui;
+
+MidiNoteWindowModel::MidiNoteWindowModel (QObject * parent)
+    : QAbstractListModel (parent)
+{
+}
+
+QHash<int, QByteArray>
+MidiNoteWindowModel::roleNames () const
+{
+  QHash<int, QByteArray> roles;
+  roles[MidiNotePtrRole] = "midiNote";
+  return roles;
+}
+
+int
+MidiNoteWindowModel::rowCount (const QModelIndex &parent) const
+{
+  if (parent.isValid ())
+    return 0;
+
+  return static_cast<int> (visible_notes_.size ());
+}
+
+QVariant
+MidiNoteWindowModel::data (const QModelIndex &index, int role) const
+{
+  if (
+    index.row () < 0
+    || index.row () >= static_cast<int> (visible_notes_.size ()))
+    return {};
+
+  if (role == MidiNotePtrRole)
+    {
+      return QVariant::fromValue (visible_notes_.at (index.row ()));
+    }
+  return {};
+}
+
+void
+MidiNoteWindowModel::setRegion (MidiRegion * region)
+{
+  if (region_ == region)
+    return;
+
+  if (region_)
+    {
+      disconnect (region_, nullptr, this, nullptr);
+    }
+
+  beginResetModel ();
+  region_ = region;
+  visible_notes_.clear ();
+  index_.clear ();
+  index_built_generation_.reset ();
+  endResetModel ();
+
+  if (region_)
+    {
+      /* the rows refer to the region's notes, so they are updated right away
+       * when notes are removed */
+      const auto on_notes_changed = [this] () { invalidate (); };
+      connect (
+        region_, &QAbstractItemModel::rowsInserted, this, on_notes_changed);
+      connect (
+        region_, &QAbstractItemModel::rowsRemoved, this, on_notes_changed);
+      connect (
+        region_, &QAbstractItemModel::modelReset, this, on_notes_changed);
+      connect (
+        region_, &QAbstractItemModel::layoutChanged, this, on_notes_changed);
+      connect (
+        region_, &QAbstractItemModel::dataChanged, this, on_notes_changed);
+      connect (region_, &QObject::destroyed, this, [this] () {
+        beginResetModel ();
+        visible_notes_.clear ();
+        index_.clear ();
+        endResetModel ();
+      });
+      refresh ();
+    }
+
+  Q_EMIT regionChanged ();
+}
+
+void
+MidiNoteWindowModel::setStartTicks (double ticks)
+{
+  if (qFuzzyCompare (start_ticks_, ticks))
+    return;
+
+  start_ticks_ = ticks;
+  refresh ();
+  Q_EMIT windowChanged ();
+}
+
+void
+MidiNoteWindowModel::setEndTicks (double ticks)
+{
+  if (qFuzzyCompare (end_ticks_, ticks))
+    return;
+
+  end_ticks_ = ticks;
+  refresh ();
+  Q_EMIT windowChanged ();
+}
+
+void
+MidiNoteWindowModel::setLowestPitch (int pitch)
+{
+  if (lowest_pitch_ == pitch)
+    return;
+
+  lowest_pitch_ = pitch;
+  refresh ();
+  Q_EMIT windowChanged ();
+}
+
+void
+MidiNoteWindowModel::setHighestPitch (int pitch)
+{
+  if (highest_pitch_ == pitch)
+    return;
+
+  highest_pitch_ = pitch;
+  refresh ();
+  Q_EMIT windowChanged ();
+}
+
+void
+MidiNoteWindowModel::setSelectedOnly (bool selected_only)
+{
+  if (selected_only_ == selected_only)
+    return;
+
+  selected_only_ = selected_only;
+  refresh ();
+  Q_EMIT selectedOnlyChanged ();
+}
+
+void
+MidiNoteWindowModel::invalidate ()
+{
+  index_built_generation_.reset ();
+  refresh ();
+}
+
+std::vector<MidiNote *>
+MidiNoteWindowModel::get_notes_in_window ()
+{
+  std::vector<MidiNote *> ret;
+  if (!region_)
+    return ret;
+
+  const auto &notes = region_->midi_notes_;
+  const auto  generation = ArrangerObject::get_placement_generation ();
+  if (index_built_generation_ != generation || index_.size () != notes.size ())
+    {
+      std::vector<utils::IntervalIndex::Interval> intervals;
+      intervals.reserve (notes.size ());
+      for (const auto * mn : notes)
+        {
+          intervals.push_back (
+            { static_cast<int64_t> (std::floor (mn->pos_->ticks_)),
+              static_cast<int64_t> (std::ceil (mn->end_pos_->ticks_)) });
+        }
+      index_.build (intervals);
+      index_built_generation_ = generation;
+    }
+
+  std::vector<size_t> indices;
+  index_.for_each_overlapping (
+    static_cast<int64_t> (std::floor (start_ticks_)),
+    static_cast<int64_t> (std::ceil (end_ticks_)), [&] (size_t idx) {
+      const auto * mn = notes[idx];
+      const auto   pitch = static_cast<int> (mn->pitch_);
+      if (
+        pitch >= lowest_pitch_ && pitch <= highest_pitch_
+        && (!selected_only_ || mn->is_selected ()))
+        {
+          indices.push_back (idx);
+        }
+    });
+  std::ranges::sort (indices);
+  ret.reserve (indices.size ());
+  for (const auto idx : indices)
+    {
+      ret.push_back (notes[idx]);
+    }
+  return ret;
+}
+
+void
+MidiNoteWindowModel::refresh ()
+{
+  auto new_notes = get_notes_in_window ();
+  if (new_notes == visible_notes_)
+    return;
+
+  const std::unordered_set<MidiNote *> new_set (
+    new_notes.begin (), new_notes.end ());
+  const std::unordered_set<MidiNote *> old_set (
+    visible_notes_.begin (), visible_notes_.end ());
+
+  /* the notes staying in the window must keep their order, otherwise they
+   * would need to be moved, so just reset in that (rare) case */
+  {
+    auto it = new_notes.begin ();
+    for (auto * mn : visible_notes_)
+      {
+        if (!new_set.contains (mn))
+          continue;
+
+        it = std::find (it, new_notes.end (), mn);
+        if (it == new_notes.end ())
+          {
+            beginResetModel ();
+            visible_notes_ = std::move (new_notes);
+            endResetModel ();
+            return;
+          }
+      }
+  }
+
+  /* remove the notes that left the window, in runs of consecutive rows */
+  for (auto row = static_cast<int> (visible_notes_.size ()) - 1; row >= 0;)
+    {
+      if (new_set.contains (visible_notes_[row]))
+        {
+          --row;
+          continue;
+        }
+
+      const int last = row;
+      while (row >= 0 && !new_set.contains (visible_notes_[row]))
+        {
+          --row;
+        }
+      const int first = row + 1;
+      beginRemoveRows ({}, first, last);
+      visible_notes_.erase (
+        visible_notes_.begin () + first, visible_notes_.begin () + last + 1);
+      endRemoveRows ();
+    }
+
+  /* insert the notes that entered the window, in runs of consecutive rows */
+  for (int row = 0; row < static_cast<int> (new_notes.size ());)
+    {
+      if (old_set.contains (new_notes[row]))
+        {
+          ++row;
+          continue;
+        }
+
+      const int first = row;
+      while (
+        row < static_cast<int> (new_notes.size ())
+        && !old_set.contains (new_notes[row]))
+        {
+          ++row;
+        }
+      beginInsertRows ({}, first, row - 1);
+      visible_notes_.insert (
+        visible_notes_.begin () + first, new_notes.begin () + first,
+        new_notes.begin () + row);
+      endInsertRows ();
+    }
+}
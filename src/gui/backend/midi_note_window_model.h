@@ -0,0 +1,137 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include "gui/dsp/midi_region.h"
+#include "utils/interval_index.h"
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QtQmlIntegration>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Model of the MIDI notes of a region that are inside a time/pitch
+ * window (usually the part of the piano roll that is on screen).
+ *
+ * Notes are looked up in an index of their positions (see
+ * utils::IntervalIndex), so moving the window costs O(log n + k) for k
+ * visible notes instead of going through all the notes, and only the notes
+ * entering or leaving the window are inserted or removed. This lets views
+ * create items only for the visible notes and keep the items of the notes
+ * that stay visible while scrolling.
+ *
+ * The index is rebuilt when notes are added or removed, and when positions or
+ * pitches change (see ArrangerObject::get_placement_generation()). Changes
+ * that don't go through the C++ setters require calling invalidate().
+ */
+class MidiNoteWindowModel : public QAbstractListModel
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (
+    MidiRegion * region READ region WRITE setRegion NOTIFY regionChanged)
+  Q_PROPERTY (
+    double startTicks READ startTicks WRITE setStartTicks NOTIFY windowChanged)
+  Q_PROPERTY (
+    double endTicks READ endTicks WRITE setEndTicks NOTIFY windowChanged)
+  Q_PROPERTY (
+    int lowestPitch READ lowestPitch WRITE setLowestPitch NOTIFY windowChanged)
+  Q_PROPERTY (
+    int highestPitch READ highestPitch WRITE setHighestPitch NOTIFY
+      windowChanged)
+  Q_PROPERTY (
+    bool selectedOnly READ selectedOnly WRITE setSelectedOnly NOTIFY
+      selectedOnlyChanged)
+
+public:
+  enum MidiNoteWindowRoles
+  {
+    MidiNotePtrRole = Qt::UserRole + 1,
+  };
+
+  explicit MidiNoteWindowModel (QObject * parent = nullptr);
+
+  QHash<int, QByteArray> roleNames () const override;
+  int rowCount (const QModelIndex &parent = QModelIndex ()) const override;
+  QVariant
+  data (const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+  MidiRegion * region () const { return region_; }
+  void         setRegion (MidiRegion * region);
+
+  /** Start of the window, in ticks relative to the region start. */
+  double startTicks () const { return start_ticks_; }
+  void   setStartTicks (double ticks);
+
+  /** End of the window, in ticks relative to the region start. */
+  double endTicks () const { return end_ticks_; }
+  void   setEndTicks (double ticks);
+
+  int  lowestPitch () const { return lowest_pitch_; }
+  void setLowestPitch (int pitch);
+
+  int  highestPitch () const { return highest_pitch_; }
+  void setHighestPitch (int pitch);
+
+  /**
+   * @brief Whether to only include selected notes (e.g. to draw them on top
+   * of a MidiNotesItem).
+   *
+   * Selection changes are not tracked, so invalidate() must be called after
+   * selecting notes.
+   */
+  bool selectedOnly () const { return selected_only_; }
+  void setSelectedOnly (bool selected_only);
+
+  /**
+   * @brief Rebuilds the index and updates the notes in the window.
+   *
+   * To be called after notes were changed without going through their C++
+   * setters (e.g. by editing their positions directly from QML).
+   */
+  Q_INVOKABLE void invalidate ();
+
+Q_SIGNALS:
+  void regionChanged ();
+  void windowChanged ();
+  void selectedOnlyChanged ();
+
+private:
+  /**
+   * @brief Updates @ref visible_notes_ to the notes in the window, rebuilding
+   * the index first if needed.
+   */
+  void refresh ();
+
+  /**
+   * @brief Returns the notes in the window, in the order of the region's
+   * notes.
+   */
+  std::vector<MidiNote *> get_notes_in_window ();
+
+private:
+  QPointer<MidiRegion> region_;
+  double               start_ticks_ = 0.0;
+  double               end_ticks_ = 0.0;
+  int                  lowest_pitch_ = 0;
+  int                  highest_pitch_ = 127;
+  bool                 selected_only_ = false;
+
+  /** Index of the region's notes by their [start, end] ticks. */
+  utils::IntervalIndex index_;
+
+  /**
+   * Value of ArrangerObject::get_placement_generation() when @ref index_ was
+   * built, or nullopt if the index must be rebuilt.
+   */
+  std::optional<uint64_t> index_built_generation_;
+
+  /** Notes in the window (the rows), in the order of the region's notes. */
+  std::vector<MidiNote *> visible_notes_;
+};
+
+} // namespace zrythm::gui
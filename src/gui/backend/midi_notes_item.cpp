@@ -0,0 +1,214 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/backend/midi_notes_item.h"
+#include "gui/dsp/midi_note.h"
+
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+
+using namespace zrythm::gui;
+
+MidiNotesItem::MidiNotesItem (QQuickItem * parent) : QQuickItem (parent)
+{
+  setFlag (QQuickItem::ItemHasContents);
+}
+
+void
+MidiNotesItem::setRegion (MidiRegion * region)
+{
+  if (region_ == region)
+    return;
+
+  if (region_)
+    {
+      disconnect (region_, nullptr, this, nullptr);
+    }
+  region_ = region;
+  if (region_)
+    {
+      connect (
+        region_, &QAbstractItemModel::rowsInserted, this,
+        &MidiNotesItem::invalidate);
+      connect (
+        region_, &QAbstractItemModel::rowsRemoved, this,
+        &MidiNotesItem::invalidate);
+      connect (
+        region_, &QAbstractItemModel::modelReset, this,
+        &MidiNotesItem::invalidate);
+      connect (
+        region_, &QAbstractItemModel::dataChanged, this,
+        &MidiNotesItem::invalidate);
+    }
+  Q_EMIT regionChanged ();
+  invalidate ();
+}
+
+void
+MidiNotesItem::setDrawMode (DrawMode mode)
+{
+  if (draw_mode_ == mode)
+    return;
+
+  draw_mode_ = mode;
+  Q_EMIT drawModeChanged ();
+  invalidate ();
+}
+
+void
+MidiNotesItem::setPxPerTick (double px_per_tick)
+{
+  if (qFuzzyCompare (px_per_tick_, px_per_tick))
+    return;
+
+  px_per_tick_ = px_per_tick;
+  Q_EMIT pxPerTickChanged ();
+  invalidate ();
+}
+
+void
+MidiNotesItem::setKeyHeight (double key_height)
+{
+  if (qFuzzyCompare (key_height_, key_height))
+    return;
+
+  key_height_ = key_height;
+  Q_EMIT keyHeightChanged ();
+  invalidate ();
+}
+
+void
+MidiNotesItem::setColor (const QColor &color)
+{
+  if (color_ == color)
+    return;
+
+  color_ = color;
+  Q_EMIT colorChanged ();
+  update ();
+}
+
+void
+MidiNotesItem::invalidate ()
+{
+  geometry_dirty_ = true;
+  update ();
+}
+
+void
+MidiNotesItem::geometryChange (
+  const QRectF &new_geometry,
+  const QRectF &old_geometry)
+{
+  QQuickItem::geometryChange (new_geometry, old_geometry);
+
+  /* velocities are scaled to the height */
+  if (
+    draw_mode_ == DrawMode::Velocities
+    && new_geometry.height () != old_geometry.height ())
+    {
+      invalidate ();
+    }
+}
+
+QRectF
+MidiNotesItem::get_note_rect (const MidiNote &note) const
+{
+  const double x = note.pos_->ticks_ * px_per_tick_;
+  if (draw_mode_ == DrawMode::Velocities)
+    {
+      const double bar_height =
+        height () * static_cast<double> (note.vel_->vel_) / 127.0;
+      return { x, height () - bar_height, VELOCITY_BAR_WIDTH, bar_height };
+    }
+
+  return {
+    x, (127 - static_cast<double> (note.pitch_)) * key_height_,
+    (note.end_pos_->ticks_ - note.pos_->ticks_) * px_per_tick_, key_height_
+  };
+}
+
+MidiNote *
+MidiNotesItem::noteAt (double x, double y) const
+{
+  if (!region_)
+    return nullptr;
+
+  /* later notes are drawn on top, so they are checked first. this goes
+   * through all the notes, which is fast enough for pointer events */
+  const auto &notes = region_->midi_notes_;
+  for (auto it = notes.rbegin (); it != notes.rend (); ++it)
+    {
+      const auto rect = get_note_rect (**it);
+      const bool in_y =
+        draw_mode_ == DrawMode::Velocities
+        || (y >= rect.top () && y < rect.bottom ());
+      if (x >= rect.left () && x < rect.right () && in_y)
+        {
+          return *it;
+        }
+    }
+  return nullptr;
+}
+
+QSGNode *
+MidiNotesItem::updatePaintNode (QSGNode * old_node, UpdatePaintNodeData *)
+{
+  auto * node = static_cast<QSGGeometryNode *> (old_node);
+
+  if (!region_ || region_->midi_notes_.empty ())
+    {
+      delete node;
+      return nullptr;
+    }
+
+  if (!node)
+    {
+      auto * geometry =
+        new QSGGeometry (QSGGeometry::defaultAttributes_Point2D (), 0);
+      geometry->setDrawingMode (QSGGeometry::DrawTriangles);
+      node = new QSGGeometryNode ();
+      node->setGeometry (geometry);
+      node->setFlag (QSGNode::OwnsGeometry);
+      node->setMaterial (new QSGFlatColorMaterial ());
+      node->setFlag (QSGNode::OwnsMaterial);
+      geometry_dirty_ = true;
+    }
+
+  auto * material = static_cast<QSGFlatColorMaterial *> (node->material ());
+  if (material->color () != color_)
+    {
+      material->setColor (color_);
+      node->markDirty (QSGNode::DirtyMaterial);
+    }
+
+  const auto generation = ArrangerObject::get_placement_generation ();
+  if (geometry_dirty_ || built_generation_ != generation)
+    {
+      /* 2 triangles per note */
+      const auto &notes = region_->midi_notes_;
+      auto *      geometry = node->geometry ();
+      geometry->allocate (static_cast<int> (notes.size () * 6));
+      auto * vertices = geometry->vertexDataAsPoint2D ();
+      for (const auto * note : notes)
+        {
+          const auto rect = get_note_rect (*note);
+          const auto left = static_cast<float> (rect.left ());
+          const auto top = static_cast<float> (rect.top ());
+          const auto right = static_cast<float> (rect.right ());
+          const auto bottom = static_cast<float> (rect.bottom ());
+          vertices[0].set (left, top);
+          vertices[1].set (right, top);
+          vertices[2].set (left, bottom);
+          vertices[3].set (right, top);
+          vertices[4].set (right, bottom);
+          vertices[5].set (left, bottom);
+          vertices += 6;
+        }
+      node->markDirty (QSGNode::DirtyGeometry);
+      geometry_dirty_ = false;
+      built_generation_ = generation;
+    }
+
+  return node;
+}
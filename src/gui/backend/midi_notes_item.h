@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include "gui/dsp/midi_region.h"
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickItem>
+#include <QtQmlIntegration>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Draws all the MIDI notes of a region (or their velocities) with a
+ * single scene graph node.
+ *
+ * The notes are drawn as quads of one geometry, so drawing them costs one
+ * draw call regardless of their number, instead of an item per note. The
+ * geometry is only rebuilt when the notes, their placements (see
+ * ArrangerObject::get_placement_generation()) or the zoom change.
+ *
+ * This item does not handle interaction: notes that need it (e.g. hovered or
+ * selected ones) are expected to be drawn as separate items on top, and
+ * noteAt() can be used to find the note under the pointer.
+ */
+class MidiNotesItem : public QQuickItem
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (
+    MidiRegion * region READ region WRITE setRegion NOTIFY regionChanged)
+  Q_PROPERTY (
+    DrawMode drawMode READ drawMode WRITE setDrawMode NOTIFY drawModeChanged)
+  Q_PROPERTY (
+    double pxPerTick READ pxPerTick WRITE setPxPerTick NOTIFY pxPerTickChanged)
+  Q_PROPERTY (
+    double keyHeight READ keyHeight WRITE setKeyHeight NOTIFY keyHeightChanged)
+  Q_PROPERTY (QColor color READ color WRITE setColor NOTIFY colorChanged)
+
+public:
+  enum class DrawMode
+  {
+    /** Notes as rectangles, with pitch 127 at the top. */
+    Notes,
+
+    /** Velocities as bars at the start of each note. */
+    Velocities,
+  };
+  Q_ENUM (DrawMode)
+
+  /** Width of the velocity bars, in pixels. */
+  static constexpr double VELOCITY_BAR_WIDTH = 4.0;
+
+  explicit MidiNotesItem (QQuickItem * parent = nullptr);
+
+  MidiRegion * region () const { return region_; }
+  void         setRegion (MidiRegion * region);
+
+  DrawMode drawMode () const { return draw_mode_; }
+  void     setDrawMode (DrawMode mode);
+
+  double pxPerTick () const { return px_per_tick_; }
+  void   setPxPerTick (double px_per_tick);
+
+  /** Height of each pitch row (only used when drawing notes). */
+  double keyHeight () const { return key_height_; }
+  void   setKeyHeight (double key_height);
+
+  QColor color () const { return color_; }
+  void   setColor (const QColor &color);
+
+  /**
+   * @brief Returns the note drawn at @p x, @p y (in item coordinates), or
+   * null.
+   *
+   * When drawing velocities, only @p x is used.
+   */
+  Q_INVOKABLE MidiNote * noteAt (double x, double y) const;
+
+  /**
+   * @brief Redraws the notes.
+   *
+   * To be called after notes were changed without going through their C++
+   * setters (e.g. by editing their positions directly from QML).
+   */
+  Q_INVOKABLE void invalidate ();
+
+Q_SIGNALS:
+  void regionChanged ();
+  void drawModeChanged ();
+  void pxPerTickChanged ();
+  void keyHeightChanged ();
+  void colorChanged ();
+
+protected:
+  QSGNode *
+  updatePaintNode (QSGNode * old_node, UpdatePaintNodeData * data) override;
+
+  void
+  geometryChange (const QRectF &new_geometry, const QRectF &old_geometry)
+    override;
+
+private:
+  /** Returns the rectangle of @p note, in item coordinates. */
+  QRectF get_note_rect (const MidiNote &note) const;
+
+private:
+  QPointer<MidiRegion> region_;
+  DrawMode             draw_mode_ = DrawMode::Notes;
+  double               px_per_tick_ = 1.0;
+  double               key_height_ = 16.0;
+  QColor               color_ = Qt::white;
+
+  /** Whether the geometry must be rebuilt on the next update. */
+  bool geometry_dirty_ = true;
+
+  /**
+   * Value of ArrangerObject::get_placement_generation() when the geometry was
+   * built.
+   */
+  uint64_t built_generation_ = 0;
+};
+
+} // namespace zrythm::gui
@@ -0,0 +1,340 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "gui/backend/plugin_description_cache.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+using namespace zrythm::gui::old_dsp::plugins;
+
+namespace
+{
+constexpr char     CACHE_MAGIC[4] = { 'Z', 'P', 'D', 'C' };
+constexpr uint32_t CACHE_VERSION = 1;
+}
+
+struct PluginDescriptionCache::Header
+{
+  char     magic[4];
+  uint32_t version;
+  uint32_t num_descriptions;
+  uint32_t num_blacklisted;
+  uint32_t strings_size;
+  uint32_t reserved;
+};
+
+/** Strings are offsets into the string table. */
+struct PluginDescriptionCache::Record
+{
+  uint32_t name;
+  uint32_t descriptive_name;
+  uint32_t format_name;
+  uint32_t category;
+  uint32_t manufacturer;
+  uint32_t version;
+  uint32_t file_or_identifier;
+  int32_t  unique_id;
+  int32_t  deprecated_uid;
+  int32_t  num_inputs;
+  int32_t  num_outputs;
+  uint8_t  is_instrument;
+  uint8_t  has_shared_container;
+  uint8_t  has_ara_extension;
+  uint8_t  padding;
+  int64_t  last_file_mod_time;
+  int64_t  last_info_update_time;
+};
+
+std::unique_ptr<PluginDescriptionCache>
+PluginDescriptionCache::open (const std::filesystem::path &path)
+{
+  const juce::File file (path.string ());
+  if (!file.existsAsFile ())
+    return nullptr;
+
+  std::unique_ptr<PluginDescriptionCache> cache (new PluginDescriptionCache ());
+  cache->mapped_file_ = std::make_unique<juce::MemoryMappedFile> (
+    file, juce::MemoryMappedFile::readOnly);
+  const auto * data = static_cast<const char *> (cache->mapped_file_->getData ());
+  const auto   data_size = cache->mapped_file_->getSize ();
+  if (data == nullptr || data_size < sizeof (Header))
+    {
+      z_warning ("Invalid plugin description cache at {}", path.string ());
+      return nullptr;
+    }
+
+  Header header;
+  std::memcpy (&header, data, sizeof (Header));
+  if (
+    std::memcmp (header.magic, CACHE_MAGIC, sizeof (CACHE_MAGIC)) != 0
+    || header.version != CACHE_VERSION)
+    {
+      z_info (
+        "Ignoring plugin description cache at {} (unknown version)",
+        path.string ());
+      return nullptr;
+    }
+
+  const size_t records_size =
+    static_cast<size_t> (header.num_descriptions) * sizeof (Record);
+  const size_t blacklisted_size =
+    static_cast<size_t> (header.num_blacklisted) * sizeof (uint32_t);
+  const size_t expected_size =
+    sizeof (Header) + records_size + blacklisted_size + header.strings_size;
+  const auto * strings = data + sizeof (Header) + records_size + blacklisted_size;
+  if (
+    data_size != expected_size || header.strings_size == 0
+    || strings[header.strings_size - 1] != '\0')
+    {
+      z_warning ("Corrupt plugin description cache at {}", path.string ());
+      return nullptr;
+    }
+
+  cache->records_ = reinterpret_cast<const Record *> (data + sizeof (Header));
+  cache->blacklisted_ =
+    reinterpret_cast<const uint32_t *> (data + sizeof (Header) + records_size);
+  cache->strings_ = strings;
+  cache->num_descriptions_ = header.num_descriptions;
+  cache->num_blacklisted_ = header.num_blacklisted;
+
+  /* validate the string offsets once so that lookups don't need to */
+  const auto valid_offset = [&] (uint32_t offset) {
+    return offset < header.strings_size;
+  };
+  for (size_t i = 0; i < cache->num_descriptions_; ++i)
+    {
+      const auto &r = cache->records_[i];
+      if (
+        !valid_offset (r.name) || !valid_offset (r.descriptive_name)
+        || !valid_offset (r.format_name) || !valid_offset (r.category)
+        || !valid_offset (r.manufacturer) || !valid_offset (r.version)
+        || !valid_offset (r.file_or_identifier))
+        {
+          z_warning ("Corrupt plugin description cache at {}", path.string ());
+          return nullptr;
+        }
+    }
+  for (size_t i = 0; i < cache->num_blacklisted_; ++i)
+    {
+      if (!valid_offset (cache->blacklisted_[i]))
+        {
+          z_warning ("Corrupt plugin description cache at {}", path.string ());
+          return nullptr;
+        }
+    }
+
+  z_debug (
+    "Mapped plugin description cache at {} ({} descriptions)", path.string (),
+    cache->num_descriptions_);
+
+  return cache;
+}
+
+void
+PluginDescriptionCache::write (
+  const std::filesystem::path                &path,
+  const juce::Array<juce::PluginDescription> &descriptions,
+  const juce::StringArray                    &blacklisted_files)
+{
+  std::string                               strings;
+  std::unordered_map<std::string, uint32_t> string_offsets;
+  const auto add_string = [&] (const juce::String &jstr) -> uint32_t {
+    auto str = jstr.toStdString ();
+    if (auto it = string_offsets.find (str); it != string_offsets.end ())
+      return it->second;
+
+    const auto offset = static_cast<uint32_t> (strings.size ());
+    strings.append (str);
+    strings.push_back ('\0');
+    string_offsets.emplace (std::move (str), offset);
+    return offset;
+  };
+
+  std::vector<Record> records;
+  records.reserve (static_cast<size_t> (descriptions.size ()));
+  for (const auto &descr : descriptions)
+    {
+      records.push_back (Record{
+        .name = add_string (descr.name),
+        .descriptive_name = add_string (descr.descriptiveName),
+        .format_name = add_string (descr.pluginFormatName),
+        .category = add_string (descr.category),
+        .manufacturer = add_string (descr.manufacturerName),
+        .version = add_string (descr.version),
+        .file_or_identifier = add_string (descr.fileOrIdentifier),
+        .unique_id = descr.uniqueId,
+        .deprecated_uid = descr.deprecatedUid,
+        .num_inputs = descr.numInputChannels,
+        .num_outputs = descr.numOutputChannels,
+        .is_instrument = static_cast<uint8_t> (descr.isInstrument),
+        .has_shared_container = static_cast<uint8_t> (descr.hasSharedContainer),
+        .has_ara_extension = static_cast<uint8_t> (descr.hasARAExtension),
+        .padding = 0,
+        .last_file_mod_time = descr.lastFileModTime.toMilliseconds (),
+        .last_info_update_time = descr.lastInfoUpdateTime.toMilliseconds (),
+      });
+    }
+
+  std::vector<uint32_t> blacklisted;
+  blacklisted.reserve (static_cast<size_t> (blacklisted_files.size ()));
+  for (const auto &file : blacklisted_files)
+    {
+      blacklisted.push_back (add_string (file));
+    }
+
+  /* so that the table is never empty */
+  add_string ({});
+
+  Header header{};
+  std::memcpy (header.magic, CACHE_MAGIC, sizeof (CACHE_MAGIC));
+  header.version = CACHE_VERSION;
+  header.num_descriptions = static_cast<uint32_t> (records.size ());
+  header.num_blacklisted = static_cast<uint32_t> (blacklisted.size ());
+  header.strings_size = static_cast<uint32_t> (strings.size ());
+
+  auto tmp_path = path;
+  tmp_path += ".tmp";
+  {
+    std::ofstream out (tmp_path, std::ios::binary | std::ios::trunc);
+    out.write (reinterpret_cast<const char *> (&header), sizeof (header));
+    out.write (
+      reinterpret_cast<const char *> (records.data ()),
+      static_cast<std::streamsize> (records.size () * sizeof (Record)));
+    out.write (
+      reinterpret_cast<const char *> (blacklisted.data ()),
+      static_cast<std::streamsize> (blacklisted.size () * sizeof (uint32_t)));
+    out.write (strings.data (), static_cast<std::streamsize> (strings.size ()));
+    if (!out)
+      {
+        throw ZrythmException (fmt::format (
+          "Failed to write plugin description cache to {}", tmp_path.string ()));
+      }
+  }
+
+  std::error_code ec;
+  std::filesystem::rename (tmp_path, path, ec);
+  if (ec)
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to move plugin description cache to {}: {}", path.string (),
+        ec.message ()));
+    }
+}
+
+const PluginDescriptionCache::Record &
+PluginDescriptionCache::get_record (size_t index) const
+{
+  assert (index < num_descriptions_);
+  return records_[index];
+}
+
+std::string_view
+PluginDescriptionCache::get_string (uint32_t offset) const
+{
+  return { strings_ + offset };
+}
+
+std::string_view
+PluginDescriptionCache::get_name (size_t index) const
+{
+  return get_string (get_record (index).name);
+}
+
+std::string_view
+PluginDescriptionCache::get_format_name (size_t index) const
+{
+  return get_string (get_record (index).format_name);
+}
+
+std::string_view
+PluginDescriptionCache::get_category (size_t index) const
+{
+  return get_string (get_record (index).category);
+}
+
+std::string_view
+PluginDescriptionCache::get_manufacturer (size_t index) const
+{
+  return get_string (get_record (index).manufacturer);
+}
+
+std::string_view
+PluginDescriptionCache::get_file_or_identifier (size_t index) const
+{
+  return get_string (get_record (index).file_or_identifier);
+}
+
+bool
+PluginDescriptionCache::is_instrument (size_t index) const
+{
+  return get_record (index).is_instrument != 0;
+}
+
+juce::PluginDescription
+PluginDescriptionCache::get_description (size_t index) const
+{
+  const auto &r = get_record (index);
+  const auto  to_juce_string = [this] (uint32_t offset) {
+    return juce::String::fromUTF8 (strings_ + offset);
+  };
+
+  juce::PluginDescription descr;
+  descr.name = to_juce_string (r.name);
+  descr.descriptiveName = to_juce_string (r.descriptive_name);
+  descr.pluginFormatName = to_juce_string (r.format_name);
+  descr.category = to_juce_string (r.category);
+  descr.manufacturerName = to_juce_string (r.manufacturer);
+  descr.version = to_juce_string (r.version);
+  descr.fileOrIdentifier = to_juce_string (r.file_or_identifier);
+  descr.uniqueId = r.unique_id;
+  descr.deprecatedUid = r.deprecated_uid;
+  descr.numInputChannels = r.num_inputs;
+  descr.numOutputChannels = r.num_outputs;
+  descr.isInstrument = r.is_instrument != 0;
+  descr.hasSharedContainer = r.has_shared_container != 0;
+  descr.hasARAExtension = r.has_ara_extension != 0;
+  descr.lastFileModTime = juce::Time (r.last_file_mod_time);
+  descr.lastInfoUpdateTime = juce::Time (r.last_info_update_time);
+  return descr;
+}
+
+std::optional<size_t>
+PluginDescriptionCache::find_by_file_or_identifier (
+  std::string_view file_or_identifier) const
+{
+  for (size_t i = 0; i < num_descriptions_; ++i)
+    {
+      if (get_file_or_identifier (i) == file_or_identifier)
+        return i;
+    }
+  return std::nullopt;
+}
+
+std::string_view
+PluginDescriptionCache::get_blacklisted_file (size_t index) const
+{
+  assert (index < num_blacklisted_);
+  return get_string (blacklisted_[index]);
+}
+
+void
+PluginDescriptionCache::add_to_known_plugin_list (
+  juce::KnownPluginList &list) const
+{
+  for (size_t i = 0; i < num_descriptions_; ++i)
+    {
+      list.addType (get_description (i));
+    }
+  for (size_t i = 0; i < num_blacklisted_; ++i)
+    {
+      list.addToBlacklist (
+        juce::String::fromUTF8 (strings_ + blacklisted_[i]));
+    }
+}
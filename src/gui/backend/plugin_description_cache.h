@@ -0,0 +1,117 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __PLUGINS_PLUGIN_DESCRIPTION_CACHE_H__
+#define __PLUGINS_PLUGIN_DESCRIPTION_CACHE_H__
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+#include "juce_wrapper.h"
+
+/**
+ * @addtogroup plugins
+ *
+ * @{
+ */
+
+namespace zrythm::gui::old_dsp::plugins
+{
+
+/**
+ * @brief Read-only, memory-mapped binary cache of known plugin descriptions.
+ *
+ * The file consists of a header, an array of fixed-size records (one per
+ * plugin description), an array of blacklisted identifiers and a table of
+ * null-terminated UTF-8 strings referenced by offset from the records. Opening
+ * it only maps the file and validates its layout, so it is cheap regardless of
+ * the number of plugins. Individual fields can be queried directly from the
+ * mapping, and full juce::PluginDescription's are only created on request
+ * (see get_description()).
+ *
+ * The format uses the host's byte order and is not meant to be portable.
+ */
+class PluginDescriptionCache final
+{
+public:
+  /**
+   * @brief Maps the cache file at @p path.
+   *
+   * @return The cache, or nullptr if the file doesn't exist or is not a valid
+   * cache (e.g., written by a different version).
+   */
+  static std::unique_ptr<PluginDescriptionCache>
+  open (const std::filesystem::path &path);
+
+  /**
+   * @brief Writes the given descriptions and blacklisted identifiers to a new
+   * cache file at @p path.
+   *
+   * The file is written next to @p path and moved in place, so that open
+   * caches remain valid.
+   *
+   * @throw ZrythmException If the file could not be written.
+   */
+  static void write (
+    const std::filesystem::path               &path,
+    const juce::Array<juce::PluginDescription> &descriptions,
+    const juce::StringArray                    &blacklisted_files);
+
+  size_t size () const { return num_descriptions_; }
+  size_t num_blacklisted () const { return num_blacklisted_; }
+
+  std::string_view get_name (size_t index) const;
+  std::string_view get_format_name (size_t index) const;
+  std::string_view get_category (size_t index) const;
+  std::string_view get_manufacturer (size_t index) const;
+  std::string_view get_file_or_identifier (size_t index) const;
+  bool             is_instrument (size_t index) const;
+
+  /**
+   * @brief Creates the full description at @p index.
+   */
+  juce::PluginDescription get_description (size_t index) const;
+
+  /**
+   * @brief Returns the index of the first description with the given file or
+   * identifier, if any.
+   */
+  std::optional<size_t>
+  find_by_file_or_identifier (std::string_view file_or_identifier) const;
+
+  std::string_view get_blacklisted_file (size_t index) const;
+
+  /**
+   * @brief Adds all descriptions and blacklisted files to @p list.
+   */
+  void add_to_known_plugin_list (juce::KnownPluginList &list) const;
+
+private:
+  struct Header;
+  struct Record;
+
+  PluginDescriptionCache () = default;
+
+  const Record    &get_record (size_t index) const;
+  std::string_view get_string (uint32_t offset) const;
+
+private:
+  std::unique_ptr<juce::MemoryMappedFile> mapped_file_;
+
+  const Record *   records_ = nullptr;
+  const uint32_t * blacklisted_ = nullptr;
+  const char *     strings_ = nullptr;
+  size_t           num_descriptions_ = 0;
+  size_t           num_blacklisted_ = 0;
+};
+
+} // namespace zrythm::gui::old_dsp::plugins
+
+/**
+ * @}
+ */
+
+#endif
@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "gui/backend/backend/project.h"
+#include "gui/backend/plugin_load_model.h"
+#include "gui/dsp/plugin.h"
+#include "gui/dsp/track.h"
+
+using namespace zrythm::gui;
+
+PluginLoadModel::PluginLoadModel (QObject * parent)
+    : QAbstractListModel (parent)
+{
+}
+
+int
+PluginLoadModel::rowCount (const QModelIndex &parent) const
+{
+  if (parent.isValid ())
+    return 0;
+  return static_cast<int> (loads_.size ());
+}
+
+QVariant
+PluginLoadModel::data (const QModelIndex &index, int role) const
+{
+  if (!index.isValid () || index.row () >= rowCount ())
+    return {};
+
+  const auto &pl_load = loads_.at (index.row ());
+
+  switch (role)
+    {
+    case Qt::DisplayRole:
+    case NameRole:
+      return QString::fromStdString (pl_load.name_);
+    case TrackNameRole:
+      return QString::fromStdString (pl_load.track_name_);
+    case SlotTypeRole:
+      return pl_load.slot_type_;
+    case SlotRole:
+      return pl_load.slot_;
+    case LoadRole:
+      return pl_load.load_;
+    default:
+      return {};
+    }
+
+  return {};
+}
+
+QHash<int, QByteArray>
+PluginLoadModel::roleNames () const
+{
+  QHash<int, QByteArray> roles;
+  roles[NameRole] = "name";
+  roles[TrackNameRole] = "trackName";
+  roles[SlotTypeRole] = "slotType";
+  roles[SlotRole] = "slot";
+  roles[LoadRole] = "load";
+  return roles;
+}
+
+void
+PluginLoadModel::refresh ()
+{
+  beginResetModel ();
+  loads_.clear ();
+  total_load_ = 0.0;
+  if (PROJECT)
+    {
+      for (
+        const auto &pl_var : PROJECT->get_plugin_registry ().get_hash_map ().values ())
+        {
+          std::visit (
+            [&] (auto &&pl) {
+              if (!pl->instantiated_ || !pl->is_in_active_project ())
+                return;
+
+              auto *     track = pl->get_track ();
+              const auto slot = pl->get_slot ();
+              loads_.push_back (PluginLoad{
+                .name_ = pl->get_name (),
+                .track_name_ = track ? track->get_name () : std::string (),
+                .slot_type_ = static_cast<int> (pl->get_slot_type ()),
+                .slot_ =
+                  slot.has_slot_index ()
+                    ? static_cast<int> (slot.get_slot_with_index ().second)
+                    : -1,
+                .load_ = pl->get_dsp_load () * 100.0,
+              });
+              total_load_ += loads_.back ().load_;
+            },
+            pl_var);
+        }
+      std::ranges::sort (loads_, std::ranges::greater{}, &PluginLoad::load_);
+    }
+  endResetModel ();
+  Q_EMIT totalLoadChanged ();
+}
+
+void
+PluginLoadModel::dumpToLog () const
+{
+  if (loads_.empty ())
+    {
+      z_info ("No plugin loads to dump (call refresh() first)");
+      return;
+    }
+
+  std::string str = fmt::format ("{:>8}  {}\n", "load (%)", "plugin");
+  for (const auto &pl_load : loads_)
+    {
+      str += fmt::format (
+        "{:>8.2f}  {}/{}\n", pl_load.load_, pl_load.track_name_, pl_load.name_);
+    }
+  str += fmt::format (
+    "{} plugins, {:.2f}% total load", loads_.size (), total_load_);
+  z_info ("Plugin DSP loads:\n{}", str);
+}
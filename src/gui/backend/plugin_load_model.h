@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include <QAbstractListModel>
+#include <QQmlEngine>
+#include <QtQmlIntegration>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Per-plugin breakdown of the DSP load.
+ *
+ * Lists the plugins of the active project with the share of the real-time
+ * budget each one is using (see Plugin::get_dsp_load()), most expensive first.
+ */
+class PluginLoadModel : public QAbstractListModel
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (double totalLoad READ totalLoad NOTIFY totalLoadChanged)
+
+public:
+  enum PluginLoadRoles
+  {
+    NameRole = Qt::UserRole + 1,
+    TrackNameRole,
+    SlotTypeRole,
+    SlotRole,
+    LoadRole,
+  };
+
+  explicit PluginLoadModel (QObject * parent = nullptr);
+
+  int rowCount (const QModelIndex &parent = QModelIndex ()) const override;
+  QVariant
+  data (const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QHash<int, QByteArray> roleNames () const override;
+
+  /**
+   * @brief Sum of the loads of all plugins, in percent.
+   */
+  double totalLoad () const { return total_load_; }
+
+  /**
+   * @brief Takes a new snapshot of the plugin loads from the active project.
+   */
+  Q_INVOKABLE void refresh ();
+
+  /**
+   * @brief Logs the loads of all plugins as a table.
+   */
+  Q_INVOKABLE void dumpToLog () const;
+
+Q_SIGNALS:
+  void totalLoadChanged ();
+
+private:
+  struct PluginLoad
+  {
+    std::string name_;
+    std::string track_name_;
+    int         slot_type_ = 0;
+
+    /** Slot index, or -1 for instruments/modulators. */
+    int slot_ = -1;
+
+    /** Load in percent. */
+    double load_ = 0.0;
+  };
+
+  std::vector<PluginLoad> loads_;
+  double                  total_load_ = 0.0;
+};
+
+} // namespace zrythm::gui
@@ -48,7 +48,6 @@ PluginManager::PluginManager (QObject * parent)
       plugin_descriptors_ (std::make_unique<gui::PluginDescriptorList> ()),
       known_plugin_list_ (std::make_shared<juce::KnownPluginList> ()),
       // cached_plugin_descriptors_ (CachedPluginDescriptors::read_or_new ()),
-      collections_ (PluginCollections::read_or_new ()),
       scanner_ (std::make_unique<PluginScanner> (known_plugin_list_))
 #if HAVE_CARLA
       ,
@@ -57,6 +56,16 @@ PluginManager::PluginManager (QObject * parent)
 {
 }
 
+PluginCollections &
+PluginManager::get_collections ()
+{
+  if (!collections_)
+    {
+      collections_ = PluginCollections::read_or_new ();
+    }
+  return *collections_;
+}
+
 PluginManager *
 PluginManager::get_active_instance ()
 {
@@ -162,50 +171,133 @@ PluginManager::get_known_plugins_xml_path ()
   return dir.absoluteFilePath (u"known_plugins.xml"_s).toStdString ();
 }
 
+fs::path
+PluginManager::get_known_plugins_cache_path ()
+{
+  QString local_app_data_path =
+    QStandardPaths::writableLocation (QStandardPaths::AppLocalDataLocation);
+  QDir dir (local_app_data_path);
+  return dir.absoluteFilePath (u"known_plugins.bin"_s).toStdString ();
+}
+
+fs::path
+PluginManager::get_scanned_plugin_files_xml_path ()
+{
+  QString local_app_data_path =
+    QStandardPaths::writableLocation (QStandardPaths::AppLocalDataLocation);
+  QDir dir (local_app_data_path);
+  return dir.absoluteFilePath (u"scanned_plugin_files.xml"_s).toStdString ();
+}
+
 void
 PluginManager::serialize_known_plugins ()
 {
-  const auto known_plugins_xml_path = get_known_plugins_xml_path ();
+  const auto cache_path = get_known_plugins_cache_path ();
   z_return_if_fail (known_plugin_list_);
-  if (known_plugin_list_->createXml ()->writeTo (
-        juce::File (known_plugins_xml_path.string ())))
+
+  /* nothing was scanned, so the cache is up to date */
+  if (scanner_->has_unused_known_plugins_cache ())
+    return;
+
+  /* unmap the previous cache first (required on some platforms) */
+  known_plugins_cache_.reset ();
+  try
     {
-      z_debug ("Saved known plugins to {}", known_plugins_xml_path.string ());
+      PluginDescriptionCache::write (
+        cache_path, known_plugin_list_->getTypes (),
+        known_plugin_list_->getBlacklistedFiles ());
+      z_debug ("Saved known plugins to {}", cache_path.string ());
     }
-  else
+  catch (const ZrythmException &e)
+    {
+      z_warning ("Failed to save known plugins: {}", e.what ());
+    }
+
+  const auto scanned_files_xml_path = get_scanned_plugin_files_xml_path ();
+  if (!scanner_->create_file_fingerprints_xml ()->writeTo (
+        juce::File (scanned_files_xml_path.string ())))
     {
       z_warning (
-        "Failed to save known plugins to {}", known_plugins_xml_path.string ());
+        "Failed to save scanned plugin files to {}",
+        scanned_files_xml_path.string ());
     }
 }
 
 void
 PluginManager::deserialize_known_plugins ()
 {
-  const auto known_plugins_xml_path = get_known_plugins_xml_path ();
   known_plugin_list_->clear ();
-  const juce::File jfile (known_plugins_xml_path.string ());
-  if (jfile.existsAsFile ())
+
+  /* only map the binary cache here - the known plugin list is filled from it
+   * when scanning */
+  known_plugins_cache_ =
+    PluginDescriptionCache::open (get_known_plugins_cache_path ());
+  if (known_plugins_cache_)
+    {
+      scanner_->set_known_plugins_cache (known_plugins_cache_);
+    }
+  else
     {
-      z_debug (
-        "Loading known plugins from {}", known_plugins_xml_path.string ());
-      const auto xml_doc = juce::XmlDocument::parse (jfile);
-      if (xml_doc)
+      /* known plugins saved by older versions */
+      const auto known_plugins_xml_path = get_known_plugins_xml_path ();
+      const juce::File jfile (known_plugins_xml_path.string ());
+      if (jfile.existsAsFile ())
         {
-          known_plugin_list_->recreateFromXml (*xml_doc);
+          z_debug (
+            "Loading known plugins from {}", known_plugins_xml_path.string ());
+          const auto xml_doc = juce::XmlDocument::parse (jfile);
+          if (xml_doc)
+            {
+              known_plugin_list_->recreateFromXml (*xml_doc);
+            }
+          else
+            {
+              z_warning (
+                "Failed to load known plugins from {}",
+                known_plugins_xml_path.string ());
+            }
         }
       else
         {
-          z_warning (
-            "Failed to load known plugins from {}",
-            known_plugins_xml_path.string ());
+          z_info ("No known plugins file found");
         }
     }
-  else
+
+  /* used to only rescan changed plugin files */
+  const juce::File scanned_files_file (
+    get_scanned_plugin_files_xml_path ().string ());
+  if (scanned_files_file.existsAsFile ())
+    {
+      if (const auto xml_doc = juce::XmlDocument::parse (scanned_files_file))
+        {
+          scanner_->restore_file_fingerprints_from_xml (*xml_doc);
+        }
+    }
+}
+
+std::optional<juce::PluginDescription>
+PluginManager::find_known_plugin_description (
+  std::string_view file_or_identifier) const
+{
+  if (known_plugins_cache_)
+    {
+      if (
+        auto idx =
+          known_plugins_cache_->find_by_file_or_identifier (file_or_identifier))
+        {
+          return known_plugins_cache_->get_description (*idx);
+        }
+      return std::nullopt;
+    }
+
+  if (
+    auto descr = known_plugin_list_->getTypeForFile (
+      juce::String::fromUTF8 (
+        file_or_identifier.data (), static_cast<int> (file_or_identifier.size ()))))
     {
-      z_info (
-        "No known plugins file found at {}", known_plugins_xml_path.string ());
+      return *descr;
     }
+  return std::nullopt;
 }
 
 void
@@ -9,6 +9,7 @@
 #include "gui/backend/cached_plugin_descriptors.h"
 #include "gui/backend/carla_discovery.h"
 #include "gui/backend/plugin_collections.h"
+#include "gui/backend/plugin_description_cache.h"
 #include "gui/backend/plugin_descriptor_list.h"
 #include "gui/backend/plugin_scanner.h"
 #include "gui/dsp/plugin_descriptor.h"
@@ -81,12 +82,27 @@ public:
 
   void clear_plugins ();
 
+  /**
+   * @brief Returns the known description for the given plugin file or
+   * identifier, if any.
+   *
+   * Only this description is created if the known plugins are still in the
+   * cache.
+   */
+  std::optional<juce::PluginDescription>
+  find_known_plugin_description (std::string_view file_or_identifier) const;
+
   /**
    * @brief Returns the number of new plugins scanned this time (as opposed to
    * known ones).
    */
   int get_num_new_plugins () const { return num_new_plugins_; }
 
+  /**
+   * @brief Returns the plugin collections, reading them on first use.
+   */
+  PluginCollections &get_collections ();
+
   Q_SIGNAL void scanFinished ();
   Q_SIGNAL void currentlyScanningPluginChanged (const QString &plugin);
 
@@ -104,6 +120,8 @@ private:
   add_category_and_author (std::string_view category, std::string_view author);
 
   static fs::path get_known_plugins_xml_path ();
+  static fs::path get_known_plugins_cache_path ();
+  static fs::path get_scanned_plugin_files_xml_path ();
   void            serialize_known_plugins ();
   void            deserialize_known_plugins ();
 
@@ -124,7 +142,14 @@ public:
   // std::unique_ptr<CachedPluginDescriptors> cached_plugin_descriptors_;
   std::shared_ptr<juce::KnownPluginList> known_plugin_list_;
 
-  /** Plugin collections. */
+  /**
+   * @brief Memory-mapped cache of the known plugins from the last scan.
+   *
+   * @ref known_plugin_list_ is only filled from it when scanning.
+   */
+  std::shared_ptr<PluginDescriptionCache> known_plugins_cache_;
+
+  /** Plugin collections (see get_collections()). */
   std::unique_ptr<PluginCollections> collections_;
 
   std::unique_ptr<PluginScanner> scanner_;
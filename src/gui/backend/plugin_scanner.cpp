@@ -37,8 +37,10 @@
  * SPDX-License-Identifier: AGPL-3.0-only
  */
 
+#include <future>
 #include <utility>
 
+#include "gui/backend/plugin_description_cache.h"
 #include "gui/backend/plugin_protocol_paths.h"
 #include "gui/backend/plugin_scanner.h"
 
@@ -212,43 +214,78 @@ Worker::process ()
 {
   z_info ("Scanning for plugins...");
 
-  scanner_.known_plugin_list_->setCustomScanner (
-    std::make_unique<OutOfProcessPluginScanner> ());
+  // Fill the known plugin list (needed to know what changed)
+  if (scanner_.known_plugins_cache_)
+    {
+      scanner_.known_plugins_cache_->add_to_known_plugin_list (
+        *scanner_.known_plugin_list_);
+      scanner_.known_plugins_cache_.reset ();
+    }
 
   // Initialize the format manager
   juce::AudioPluginFormatManager formatManager;
   formatManager.addDefaultFormats ();
   formatManager.addFormat (new juce::CLAPPluginFormat ());
 
-  // Iterate through available formats
+  struct ScanJob
+  {
+    juce::AudioPluginFormat *                     format;
+    juce::String                                  identifier;
+    std::optional<PluginScanner::FileFingerprint> fingerprint;
+  };
+  std::vector<ScanJob> jobs;
+  size_t               num_identifiers = 0;
+
+  // Collect the new or changed plugin files of the available formats
   for (auto * format : formatManager.getFormats ())
     {
-      z_debug ("Scanning plugins for format {}", format->getName ());
+      z_debug ("Searching plugins for format {}", format->getName ());
       const auto protocol = Protocol::from_juce_format_name (format->getName ());
       const auto paths = PluginProtocolPaths::get_for_protocol (protocol);
       // auto defaultLocations = format->getDefaultLocationsToSearch ();
       auto identifiers = format->searchPathsForPlugins (
         paths->get_as_juce_file_search_path (), true, true);
+      num_identifiers += static_cast<size_t> (identifiers.size ());
       for (const auto &identifier : identifiers)
         {
-          scanner_.set_currently_scanning_plugin (
-            QString::fromStdString (identifier.toStdString ()));
-          juce::OwnedArray<juce::PluginDescription> types;
-          bool has_new = scanner_.known_plugin_list_->scanAndAddFile (
-            identifier, true, types, *format);
-          if (has_new)
-            {
-              z_info (
-                "Found new plugins for identifier '{}' (total types {})",
-                identifier, types.size ());
-            }
-          if (types.isEmpty ())
+          auto fingerprint = PluginScanner::get_file_fingerprint (identifier);
+          if (scanner_.needs_scanning (*format, identifier, fingerprint))
             {
-              z_warning ("Blacklisting plugin: {}", identifier);
-              scanner_.known_plugin_list_->addToBlacklist (identifier);
+              jobs.push_back (ScanJob{ format, identifier, fingerprint });
             }
         }
     }
+
+  // Scan them using multiple scanner processes
+  const auto num_scanners = std::min (
+    static_cast<size_t> (juce::SystemStats::getNumCpus ()), jobs.size ());
+  z_info (
+    "Scanning {} new or changed plugin files (out of {}) using {} processes",
+    jobs.size (), num_identifiers, num_scanners);
+
+  std::atomic<size_t> next_job = 0;
+  auto                scan_next_jobs = [&] () {
+    OutOfProcessPluginScanner scanner;
+    while (true)
+      {
+        const auto idx = next_job.fetch_add (1);
+        if (idx >= jobs.size ())
+          break;
+
+        const auto &job = jobs[idx];
+        scanner_.scan_file (scanner, *job.format, job.identifier, job.fingerprint);
+      }
+  };
+  std::vector<std::future<void>> scanners;
+  for (size_t i = 0; i < num_scanners; ++i)
+    {
+      scanners.emplace_back (std::async (std::launch::async, scan_next_jobs));
+    }
+  for (auto &scanner : scanners)
+    {
+      scanner.get ();
+    }
+
   z_debug ("Scanning in thread finished");
   Q_EMIT finished ();
 }
@@ -290,6 +327,158 @@ PluginScanner::scan_finished ()
   Q_EMIT scanningFinished ();
 }
 
+void
+PluginScanner::set_known_plugins_cache (
+  std::shared_ptr<const PluginDescriptionCache> cache)
+{
+  known_plugins_cache_ = std::move (cache);
+}
+
+std::optional<PluginScanner::FileFingerprint>
+PluginScanner::get_file_fingerprint (const juce::String &file_or_identifier)
+{
+  if (!juce::File::isAbsolutePath (file_or_identifier))
+    return std::nullopt;
+
+  const juce::File file (file_or_identifier);
+  if (file.existsAsFile ())
+    {
+      return FileFingerprint{
+        .size_ = file.getSize (),
+        .mod_time_ms_ = file.getLastModificationTime ().toMilliseconds ()
+      };
+    }
+  if (!file.isDirectory ())
+    return std::nullopt;
+
+  // bundle - combine the files inside it
+  FileFingerprint fingerprint{
+    .mod_time_ms_ = file.getLastModificationTime ().toMilliseconds ()
+  };
+  for (
+    const auto &entry :
+    juce::RangedDirectoryIterator (file, true, "*", juce::File::findFiles))
+    {
+      fingerprint.size_ += entry.getFileSize ();
+      fingerprint.mod_time_ms_ = std::max (
+        fingerprint.mod_time_ms_, entry.getModificationTime ().toMilliseconds ());
+    }
+  return fingerprint;
+}
+
+bool
+PluginScanner::needs_scanning (
+  juce::AudioPluginFormat              &format,
+  const juce::String                   &file_or_identifier,
+  const std::optional<FileFingerprint> &fingerprint)
+{
+  const bool blacklisted =
+    known_plugin_list_->getBlacklistedFiles ().contains (file_or_identifier);
+  const bool up_to_date =
+    known_plugin_list_->isListingUpToDate (file_or_identifier, format);
+
+  if (!fingerprint)
+    {
+      // nothing to compare - rely on the format
+      return !blacklisted && !up_to_date;
+    }
+
+  std::lock_guard lock (file_fingerprints_mutex_);
+  const auto      it = file_fingerprints_.find (file_or_identifier);
+  if (it == file_fingerprints_.end ())
+    {
+      // known from before fingerprints were recorded
+      if (blacklisted || up_to_date)
+        {
+          file_fingerprints_.emplace (file_or_identifier, *fingerprint);
+          return false;
+        }
+      return true;
+    }
+
+  return it->second != *fingerprint;
+}
+
+void
+PluginScanner::scan_file (
+  OutOfProcessPluginScanner            &scanner,
+  juce::AudioPluginFormat              &format,
+  const juce::String                   &file_or_identifier,
+  const std::optional<FileFingerprint> &fingerprint)
+{
+  set_currently_scanning_plugin (
+    QString::fromStdString (file_or_identifier.toStdString ()));
+
+  // changed files get another chance
+  {
+    std::lock_guard lock (known_plugin_list_mutex_);
+    known_plugin_list_->removeFromBlacklist (file_or_identifier);
+  }
+
+  juce::OwnedArray<juce::PluginDescription> types;
+  if (!scanner.findPluginTypesFor (format, types, file_or_identifier))
+    {
+      types.clear ();
+    }
+
+  {
+    std::lock_guard lock (known_plugin_list_mutex_);
+    for (const auto * type : types)
+      {
+        known_plugin_list_->addType (*type);
+      }
+    if (types.isEmpty ())
+      {
+        z_warning ("Blacklisting plugin: {}", file_or_identifier);
+        known_plugin_list_->addToBlacklist (file_or_identifier);
+      }
+    else
+      {
+        z_info (
+          "Found plugins for identifier '{}' (total types {})",
+          file_or_identifier, types.size ());
+      }
+  }
+
+  if (fingerprint)
+    {
+      std::lock_guard lock (file_fingerprints_mutex_);
+      file_fingerprints_[file_or_identifier] = *fingerprint;
+    }
+}
+
+std::unique_ptr<juce::XmlElement>
+PluginScanner::create_file_fingerprints_xml () const
+{
+  auto xml = std::make_unique<juce::XmlElement> ("FILEFINGERPRINTS");
+
+  std::lock_guard lock (file_fingerprints_mutex_);
+  for (const auto &[identifier, fingerprint] : file_fingerprints_)
+    {
+      auto * e = xml->createNewChildElement ("FILE");
+      e->setAttribute ("id", identifier);
+      e->setAttribute ("size", juce::String (fingerprint.size_));
+      e->setAttribute ("modTime", juce::String (fingerprint.mod_time_ms_));
+    }
+  return xml;
+}
+
+void
+PluginScanner::restore_file_fingerprints_from_xml (const juce::XmlElement &xml)
+{
+  std::lock_guard lock (file_fingerprints_mutex_);
+  file_fingerprints_.clear ();
+  for (const auto * e : xml.getChildWithTagNameIterator ("FILE"))
+    {
+      file_fingerprints_.emplace (
+        e->getStringAttribute ("id"),
+        FileFingerprint{
+          .size_ = e->getStringAttribute ("size").getLargeIntValue (),
+          .mod_time_ms_ =
+            e->getStringAttribute ("modTime").getLargeIntValue () });
+    }
+}
+
 QString
 PluginScanner::getCurrentlyScanningPlugin () const
 {
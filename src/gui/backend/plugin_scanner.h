@@ -40,6 +40,10 @@
 #ifndef ZRYTHM_COMMON_PLUGINS_PLUGIN_SCANNER_H
 #define ZRYTHM_COMMON_PLUGINS_PLUGIN_SCANNER_H
 
+#include <map>
+#include <mutex>
+#include <optional>
+
 #include <QList>
 #include <QObject>
 #include <QString>
@@ -48,6 +52,8 @@
 namespace zrythm::gui::old_dsp::plugins
 {
 
+class PluginDescriptionCache;
+
 //==============================================================================
 
 /**
@@ -58,6 +64,9 @@ namespace zrythm::gui::old_dsp::plugins
  * to avoid potential crashes or hangs in the main process when scanning for
  * plugins.
  *
+ * Each instance drives its own child process, so multiple instances can be
+ * used concurrently from different threads.
+ *
  * The scanning is performed asynchronously, and a `scanCompleted()` signal is
  * emitted when the scan is finished.
  */
@@ -223,6 +232,21 @@ class PluginScanner final : public QObject
     QString currentlyScanningPlugin READ getCurrentlyScanningPlugin NOTIFY
       currentlyScanningPluginChanged FINAL)
 
+public:
+  /**
+   * @brief Size and last modification time of a scanned plugin file (or of
+   * the files inside a plugin bundle).
+   *
+   * Used to only rescan new or changed plugins.
+   */
+  struct FileFingerprint
+  {
+    juce::int64 size_ = 0;
+    juce::int64 mod_time_ms_ = 0;
+
+    bool operator== (const FileFingerprint &other) const = default;
+  };
+
 public:
   /**
    * @brief Constructs a PluginScanner object.
@@ -278,14 +302,88 @@ public:
    */
   Q_SLOT void scan_finished ();
 
+  /**
+   * @brief Sets a cache to fill the known plugin list from before scanning.
+   *
+   * The list is filled on the scan thread, so that startup doesn't need to
+   * wait for it.
+   */
+  void
+  set_known_plugins_cache (std::shared_ptr<const PluginDescriptionCache> cache);
+
+  /**
+   * @brief Returns whether the cache set with set_known_plugins_cache() was
+   * not used yet (i.e., no scan happened since).
+   */
+  bool has_unused_known_plugins_cache () const
+  {
+    return known_plugins_cache_ != nullptr;
+  }
+
+  /**
+   * @brief Returns the fingerprints of the scanned plugin files, to be saved
+   * along with the known plugin list.
+   */
+  std::unique_ptr<juce::XmlElement> create_file_fingerprints_xml () const;
+
+  /**
+   * @brief Restores the fingerprints saved with
+   * create_file_fingerprints_xml().
+   */
+  void restore_file_fingerprints_from_xml (const juce::XmlElement &xml);
+
 private:
   void scan_for_plugins ();
 
   void set_currently_scanning_plugin (const QString &plugin);
 
+  /**
+   * @brief Returns the fingerprint of the given plugin file or bundle, or
+   * nullopt if the identifier is not a file (e.g., AudioUnit identifiers).
+   */
+  static std::optional<FileFingerprint>
+  get_file_fingerprint (const juce::String &file_or_identifier);
+
+  /**
+   * @brief Returns whether the given plugin file needs to be (re)scanned.
+   *
+   * Files whose fingerprint matches the one recorded on their last scan are
+   * skipped (including blacklisted ones), as are up-to-date files known from
+   * before fingerprints were recorded.
+   */
+  bool needs_scanning (
+    juce::AudioPluginFormat              &format,
+    const juce::String                   &file_or_identifier,
+    const std::optional<FileFingerprint> &fingerprint);
+
+  /**
+   * @brief Scans the given plugin file with @p scanner and adds the results
+   * to the known plugin list (or blacklists the file).
+   *
+   * Can be called concurrently with different scanners.
+   */
+  void scan_file (
+    OutOfProcessPluginScanner            &scanner,
+    juce::AudioPluginFormat              &format,
+    const juce::String                   &file_or_identifier,
+    const std::optional<FileFingerprint> &fingerprint);
+
 private:
   std::shared_ptr<juce::KnownPluginList> known_plugin_list_;
 
+  /**
+   * @brief Serializes modifications of the known plugin list by concurrent
+   * scans (its blacklist is not thread-safe).
+   */
+  std::mutex known_plugin_list_mutex_;
+
+  /** Cache to fill @ref known_plugin_list_ from before scanning, if any. */
+  std::shared_ptr<const PluginDescriptionCache> known_plugins_cache_;
+
+  /** Fingerprints of scanned files, by identifier. */
+  std::map<juce::String, FileFingerprint> file_fingerprints_;
+  mutable std::mutex                      file_fingerprints_mutex_;
+
   mutable QMutex currently_scanning_plugin_mutex_;
   QString        currently_scanning_plugin_;
 
@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/backend/plugin_search_model.h"
+#include "gui/dsp/plugin_protocol.h"
+
+#include <QtConcurrent>
+
+using namespace zrythm::gui;
+
+using TextSearchIndex = zrythm::utils::TextSearchIndex;
+
+namespace
+{
+/** Time to wait for more changes to the source before rebuilding the index. */
+constexpr int REBUILD_DELAY_MS = 100;
+}
+
+PluginSearchModel::PluginSearchModel (QObject * parent)
+    : QAbstractListModel (parent)
+{
+  rebuild_timer_.setSingleShot (true);
+  rebuild_timer_.setInterval (REBUILD_DELAY_MS);
+  QObject::connect (
+    &rebuild_timer_, &QTimer::timeout, this, &PluginSearchModel::rebuild_index);
+}
+
+int
+PluginSearchModel::rowCount (const QModelIndex &parent) const
+{
+  if (parent.isValid ())
+    return 0;
+  return static_cast<int> (rows_.size ());
+}
+
+QVariant
+PluginSearchModel::data (const QModelIndex &index, int role) const
+{
+  if (!index.isValid () || index.row () >= rowCount () || !source_)
+    return {};
+
+  const int source_row = rows_.at (index.row ());
+  if (source_row >= source_->rowCount ())
+    return {};
+
+  if (role == DescriptorRole)
+    return QVariant::fromValue (source_->at (source_row));
+
+  return source_->data (source_->index (source_row, 0), role);
+}
+
+QHash<int, QByteArray>
+PluginSearchModel::roleNames () const
+{
+  auto roles = QAbstractListModel::roleNames ();
+  roles[DescriptorRole] = "descriptor";
+  return roles;
+}
+
+void
+PluginSearchModel::setSource (PluginDescriptorList * source)
+{
+  if (source_ == source)
+    return;
+
+  if (source_)
+    source_->disconnect (this);
+
+  source_ = source;
+  if (source_)
+    {
+      const auto schedule_rebuild = [this] () { rebuild_timer_.start (); };
+      QObject::connect (
+        source_, &QAbstractItemModel::rowsInserted, this, schedule_rebuild);
+      QObject::connect (
+        source_, &QAbstractItemModel::rowsRemoved, this, schedule_rebuild);
+      QObject::connect (
+        source_, &QAbstractItemModel::modelReset, this, schedule_rebuild);
+    }
+  Q_EMIT sourceChanged ();
+
+  rebuild_index ();
+}
+
+void
+PluginSearchModel::setSearchText (const QString &text)
+{
+  if (search_text_ == text)
+    return;
+
+  search_text_ = text;
+  Q_EMIT searchTextChanged ();
+  run_query ();
+}
+
+void
+PluginSearchModel::setCategory (const QString &category)
+{
+  if (category_ == category)
+    return;
+
+  category_ = category;
+  Q_EMIT categoryChanged ();
+  run_query ();
+}
+
+void
+PluginSearchModel::setAuthor (const QString &author)
+{
+  if (author_ == author)
+    return;
+
+  author_ = author;
+  Q_EMIT authorChanged ();
+  run_query ();
+}
+
+void
+PluginSearchModel::setProtocol (const QString &protocol)
+{
+  if (protocol_ == protocol)
+    return;
+
+  protocol_ = protocol;
+  Q_EMIT protocolChanged ();
+  run_query ();
+}
+
+QStringList
+PluginSearchModel::get_facet_values (Facet facet) const
+{
+  QStringList ret;
+  if (!index_)
+    return ret;
+
+  const auto values = index_->get_facet_values (static_cast<size_t> (facet));
+  for (const auto &value : values)
+    {
+      if (!value.empty ())
+        ret.append (QString::fromStdString (value));
+    }
+  ret.sort (Qt::CaseInsensitive);
+  return ret;
+}
+
+void
+PluginSearchModel::rebuild_index ()
+{
+  rebuild_timer_.stop ();
+
+  /* only copy the strings on this thread, the descriptors may change while
+   * indexing */
+  std::vector<TextSearchIndex::Document> documents;
+  if (source_)
+    {
+      documents.reserve (source_->rowCount ());
+      for (int i = 0; i < source_->rowCount (); ++i)
+        {
+          const auto * descr = source_->at (i);
+          documents.push_back (
+            { descr->name_,
+              { descr->category_str_, descr->author_,
+                old_dsp::plugins::Protocol::to_string (descr->protocol_) } });
+        }
+    }
+
+  const auto generation = ++index_generation_;
+  QtConcurrent::run ([documents = std::move (documents)] () {
+    auto index = std::make_shared<TextSearchIndex> ();
+    index->build (documents);
+    return IndexPtr (std::move (index));
+  }).then (this, [this, generation] (IndexPtr index) {
+    if (generation != index_generation_)
+      return;
+
+    index_ = std::move (index);
+    Q_EMIT indexChanged ();
+    run_query ();
+  });
+}
+
+void
+PluginSearchModel::run_query ()
+{
+  if (!index_)
+    return;
+
+  const auto to_facet_value =
+    [] (const QString &value) -> std::optional<std::string> {
+    if (value.isEmpty ())
+      return std::nullopt;
+    return value.toStdString ();
+  };
+  TextSearchIndex::Query query{
+    .text_ = search_text_.toStdString (),
+    .facet_values_ = {
+      to_facet_value (category_), to_facet_value (author_),
+      to_facet_value (protocol_) },
+  };
+
+  const auto generation = ++query_generation_;
+  QtConcurrent::run ([index = index_, query = std::move (query)] () {
+    return index->search (query);
+  }).then (this, [this, generation] (std::vector<size_t> results) {
+    /* a newer query was started in the meantime */
+    if (generation != query_generation_)
+      return;
+
+    beginResetModel ();
+    rows_.assign (results.begin (), results.end ());
+    endResetModel ();
+  });
+}
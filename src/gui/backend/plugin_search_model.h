@@ -0,0 +1,141 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "gui/backend/plugin_descriptor_list.h"
+#include "utils/text_search_index.h"
+
+#include <QAbstractListModel>
+#include <QPointer>
+#include <QTimer>
+#include <QtQmlIntegration>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Plugins of a PluginDescriptorList matching a search text and the
+ * selected category, author and protocol.
+ *
+ * The descriptors are indexed in a utils::TextSearchIndex, which is rebuilt
+ * off the GUI thread when the source changes. Queries also run off the GUI
+ * thread, and only the result of the latest query is applied, so typing in
+ * the search field never blocks on the search.
+ */
+class PluginSearchModel : public QAbstractListModel
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (
+    zrythm::gui::PluginDescriptorList * source READ source WRITE setSource
+      NOTIFY sourceChanged)
+  Q_PROPERTY (
+    QString searchText READ searchText WRITE setSearchText NOTIFY
+      searchTextChanged)
+  Q_PROPERTY (
+    QString category READ category WRITE setCategory NOTIFY categoryChanged)
+  Q_PROPERTY (QString author READ author WRITE setAuthor NOTIFY authorChanged)
+  Q_PROPERTY (
+    QString protocol READ protocol WRITE setProtocol NOTIFY protocolChanged)
+  Q_PROPERTY (QStringList categories READ categories NOTIFY indexChanged)
+  Q_PROPERTY (QStringList authors READ authors NOTIFY indexChanged)
+  Q_PROPERTY (QStringList protocols READ protocols NOTIFY indexChanged)
+
+public:
+  enum PluginSearchRoles
+  {
+    DescriptorRole = Qt::UserRole + 1,
+  };
+
+  explicit PluginSearchModel (QObject * parent = nullptr);
+
+  int rowCount (const QModelIndex &parent = QModelIndex ()) const override;
+  QVariant
+  data (const QModelIndex &index, int role = Qt::DisplayRole) const override;
+  QHash<int, QByteArray> roleNames () const override;
+
+  PluginDescriptorList * source () const { return source_; }
+  void                   setSource (PluginDescriptorList * source);
+
+  QString searchText () const { return search_text_; }
+  void    setSearchText (const QString &text);
+
+  /** Category to filter by, or empty for any category. */
+  QString category () const { return category_; }
+  void    setCategory (const QString &category);
+
+  /** Author to filter by, or empty for any author. */
+  QString author () const { return author_; }
+  void    setAuthor (const QString &author);
+
+  /** Protocol to filter by, or empty for any protocol. */
+  QString protocol () const { return protocol_; }
+  void    setProtocol (const QString &protocol);
+
+  /** Distinct values of each facet in the indexed descriptors. */
+  QStringList categories () const { return get_facet_values (Facet::Category); }
+  QStringList authors () const { return get_facet_values (Facet::Author); }
+  QStringList protocols () const { return get_facet_values (Facet::Protocol); }
+
+Q_SIGNALS:
+  void sourceChanged ();
+  void searchTextChanged ();
+  void categoryChanged ();
+  void authorChanged ();
+  void protocolChanged ();
+  void indexChanged ();
+
+private:
+  enum class Facet
+  {
+    Category,
+    Author,
+    Protocol,
+  };
+
+  using IndexPtr = std::shared_ptr<const utils::TextSearchIndex>;
+
+  QStringList get_facet_values (Facet facet) const;
+
+  /**
+   * @brief Starts rebuilding the index from the source's descriptors.
+   */
+  void rebuild_index ();
+
+  /**
+   * @brief Starts running the current query against the current index.
+   */
+  void run_query ();
+
+private:
+  QPointer<PluginDescriptorList> source_;
+  QString                        search_text_;
+  QString                        category_;
+  QString                        author_;
+  QString                        protocol_;
+
+  /** Index of the source's descriptors, as of the last completed rebuild. */
+  IndexPtr index_;
+
+  /**
+   * Coalesces the source's changes (e.g. descriptors being added one by one
+   * while scanning) into a single rebuild.
+   */
+  QTimer rebuild_timer_;
+
+  /**
+   * Incremented on each rebuild and query, so that only the results of the
+   * latest ones are applied.
+   */
+  uint64_t index_generation_ = 0;
+  uint64_t query_generation_ = 0;
+
+  /** Source rows of the matching descriptors. */
+  std::vector<int> rows_;
+};
+
+} // namespace zrythm::gui
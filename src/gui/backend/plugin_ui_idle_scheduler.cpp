@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "gui/backend/plugin_ui_idle_scheduler.h"
+#include "utils/tracing.h"
+
+#include <QGuiApplication>
+
+PluginUiIdleScheduler::PluginUiIdleScheduler (QObject * parent)
+    : QObject (parent)
+{
+  timer_.setInterval (FRAME_INTERVAL_MS);
+  timer_.setTimerType (Qt::PreciseTimer);
+  connect (&timer_, &QTimer::timeout, this, &PluginUiIdleScheduler::idle_uis);
+}
+
+bool
+PluginUiIdleScheduler::is_registered (const IPluginUiIdler * ui) const
+{
+  return std::ranges::contains (entries_, ui, &Entry::ui_);
+}
+
+void
+PluginUiIdleScheduler::register_ui (IPluginUiIdler * ui)
+{
+  if (is_registered (ui))
+    return;
+
+  Entry entry{ .ui_ = ui };
+  entry.last_idle_.start ();
+  ui->mark_ui_changed ();
+  entries_.push_back (entry);
+
+  if (!timer_.isActive ())
+    {
+      timer_.start ();
+    }
+}
+
+void
+PluginUiIdleScheduler::deregister_ui (IPluginUiIdler * ui)
+{
+  std::erase_if (entries_, [ui] (const auto &entry) {
+    return entry.ui_ == ui;
+  });
+
+  if (entries_.empty ())
+    {
+      timer_.stop ();
+    }
+}
+
+bool
+PluginUiIdleScheduler::should_idle (const Entry &entry, bool app_hidden) const
+{
+  if (!app_hidden)
+    return true;
+
+  const auto elapsed = entry.last_idle_.elapsed ();
+  if (elapsed >= KEEP_ALIVE_INTERVAL_MS)
+    return true;
+
+  return elapsed >= THROTTLED_INTERVAL_MS
+         && entry.ui_->ui_changed_.load (std::memory_order_acquire);
+}
+
+void
+PluginUiIdleScheduler::idle_uis ()
+{
+  Z_TRACE_ZONE ("PluginUiIdleScheduler::idle_uis");
+
+  const bool app_hidden =
+    qGuiApp && qGuiApp->applicationState () == Qt::ApplicationHidden;
+
+  /* UIs may be deregistered while idling (e.g., when closed), so collect the
+   * UIs to idle first */
+  std::vector<IPluginUiIdler *> uis;
+  uis.reserve (entries_.size ());
+  for (auto &entry : entries_)
+    {
+      if (should_idle (entry, app_hidden))
+        {
+          entry.last_idle_.restart ();
+          uis.push_back (entry.ui_);
+        }
+    }
+
+  for (auto * ui : uis)
+    {
+      if (!is_registered (ui))
+        continue;
+
+      ui->ui_changed_.store (false, std::memory_order_release);
+      ui->idle_ui ();
+    }
+}
+
+PluginUiIdleScheduler::~PluginUiIdleScheduler ()
+{
+  timer_.stop ();
+}
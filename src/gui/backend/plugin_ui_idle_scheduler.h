@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QTimer>
+
+/**
+ * @brief A plugin UI that needs to be idled periodically (e.g., to process its
+ * events and show parameter changes).
+ */
+class IPluginUiIdler
+{
+public:
+  virtual ~IPluginUiIdler () = default;
+
+  /**
+   * @brief Idles the UI.
+   *
+   * Called on the GUI thread.
+   */
+  virtual void idle_ui () = 0;
+
+  /**
+   * @brief Marks the UI as having changes to show (e.g., a parameter was
+   * changed by the host).
+   *
+   * Realtime-safe.
+   */
+  void mark_ui_changed ()
+  {
+    ui_changed_.store (true, std::memory_order_release);
+  }
+
+private:
+  friend class PluginUiIdleScheduler;
+
+  std::atomic<bool> ui_changed_{ true };
+};
+
+/**
+ * @brief Idles all open plugin UIs from a single timer.
+ *
+ * Plugin UIs used to have a timer each, so many open UIs caused many wakeups
+ * per frame. Instead, UIs are idled here in one pass per frame:
+ * - Open UIs are idled every frame, since idling also processes their own
+ *   input.
+ * - While the application is minimised (plugin windows are transient for the
+ *   main window, so they are minimised too), UIs are only idled when they
+ *   have changes to show (see IPluginUiIdler::mark_ui_changed()), at most at
+ *   @ref THROTTLED_INTERVAL_MS, and otherwise at @ref KEEP_ALIVE_INTERVAL_MS.
+ * - Hidden UIs are deregistered and not idled at all.
+ *
+ * The timer only runs while there are UIs, and runs outside of the window's
+ * rendering so that plugin UIs don't draw in between the application's own GL
+ * calls.
+ */
+class PluginUiIdleScheduler : public QObject
+{
+  Q_OBJECT
+public:
+  /** Interval for visible UIs (60 fps). */
+  static constexpr int FRAME_INTERVAL_MS = 1000 / 60;
+
+  /** Minimum interval for throttled UIs with changes. */
+  static constexpr int THROTTLED_INTERVAL_MS = 250;
+
+  /** Interval for throttled UIs without changes. */
+  static constexpr int KEEP_ALIVE_INTERVAL_MS = 2000;
+
+  static PluginUiIdleScheduler &instance ()
+  {
+    static PluginUiIdleScheduler instance;
+    return instance;
+  }
+
+  ~PluginUiIdleScheduler () override;
+
+  /**
+   * @brief Starts idling @p ui.
+   *
+   * Must be called from the GUI thread. Does nothing if @p ui is already
+   * registered.
+   */
+  void register_ui (IPluginUiIdler * ui);
+
+  /**
+   * @brief Stops idling @p ui.
+   *
+   * Must be called from the GUI thread (may be called from @p ui's
+   * IPluginUiIdler::idle_ui()).
+   */
+  void deregister_ui (IPluginUiIdler * ui);
+
+  bool is_registered (const IPluginUiIdler * ui) const;
+
+private:
+  struct Entry
+  {
+    IPluginUiIdler * ui_ = nullptr;
+
+    /** Time since the last idle. */
+    QElapsedTimer last_idle_;
+  };
+
+  PluginUiIdleScheduler (QObject * parent = nullptr);
+
+  /** Whether @p entry should be idled in this pass. */
+  bool should_idle (const Entry &entry, bool app_hidden) const;
+
+  void idle_uis ();
+
+  QTimer             timer_;
+  std::vector<Entry> entries_;
+};
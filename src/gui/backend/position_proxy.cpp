@@ -30,11 +30,24 @@ PositionProxy::~PositionProxy ()
     }
 }
 
+void
+PositionProxy::mark_updated ()
+{
+  /* only queue the first change until processed */
+  if (
+    !has_update_.exchange (true, std::memory_order_acq_rel)
+    && realtime_updateable_)
+    {
+      RealtimeUpdater::instance ().mark_dirty (*this);
+    }
+}
+
 bool
 PositionProxy::processUpdates ()
 {
-  bool has_updates = true;
-  if (has_update_.compare_exchange_weak (has_updates, false))
+  /* a spurious failure would lose the update, since the proxy is only marked
+   * dirty again after this clears the flag */
+  if (has_update_.exchange (false, std::memory_order_acq_rel))
     {
       Q_EMIT framesChanged ();
       Q_EMIT ticksChanged ();
@@ -76,12 +76,12 @@ public:
   void set_frames_rtsafe (signed_frame_t frames, double ticks_per_frame = 0.0)
   {
     from_frames (frames, ticks_per_frame);
-    has_update_.store (true, std::memory_order_release);
+    mark_updated ();
   }
   void set_ticks_rtsafe (double ticks, double frames_per_tick = 0.0)
   {
     from_ticks (ticks, frames_per_tick);
-    has_update_.store (true, std::memory_order_release);
+    mark_updated ();
   }
 
   /**
@@ -98,7 +98,7 @@ public:
       update_frames_from_ticks (ratio);
     else
       update_ticks_from_frames (ratio);
-    has_update_.store (true, std::memory_order_release);
+    mark_updated ();
   }
 
   void set_position_rtsafe (const Position &pos)
@@ -108,7 +108,7 @@ public:
 
     frames_ = pos.frames_;
     ticks_ = pos.ticks_;
-    has_update_.store (true, std::memory_order_release);
+    mark_updated ();
   }
 
   void add_frames_rtsafe (signed_frame_t frames, double ticks_per_frame)
@@ -117,7 +117,7 @@ public:
       return;
 
     add_frames (frames, ticks_per_frame);
-    has_update_.store (true, std::memory_order_release);
+    mark_updated ();
   }
 
   bool processUpdates () override;
@@ -126,6 +126,14 @@ public:
   init_after_cloning (const PositionProxy &other, ObjectCloneType clone_type)
     override;
 
+private:
+  /**
+   * @brief Marks the position as changed from a realtime thread.
+   *
+   * Realtime-safe.
+   */
+  void mark_updated ();
+
 private:
   std::atomic<bool> has_update_{ false };
   bool              realtime_updateable_;
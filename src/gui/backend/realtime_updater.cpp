@@ -2,41 +2,116 @@
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
 #include "utils/logger.h"
+#include "utils/tracing.h"
 
 #include "realtime_property.h"
 #include "realtime_updater.h"
 
+#include <QGuiApplication>
+
 RealtimeUpdater::RealtimeUpdater (QObject * parent) : QObject (parent)
 {
   timer_.setInterval (16); // 60Hz updates
-  connect (&timer_, &QTimer::timeout, this, &RealtimeUpdater::processUpdates);
+  connect (&timer_, &QTimer::timeout, this, &RealtimeUpdater::scheduleUpdates);
   timer_.start ();
+
+  if (qGuiApp)
+    {
+      connect (
+        qGuiApp, &QGuiApplication::focusWindowChanged, this,
+        &RealtimeUpdater::setWindow);
+      setWindow (QGuiApplication::focusWindow ());
+    }
+}
+
+void
+RealtimeUpdater::setWindow (QWindow * window)
+{
+  auto * quick_window = qobject_cast<QQuickWindow *> (window);
+  if (!quick_window || quick_window == window_)
+    return;
+
+  if (window_)
+    {
+      disconnect (window_, nullptr, this, nullptr);
+    }
+  window_ = quick_window;
+  connect (
+    window_, &QQuickWindow::afterAnimating, this,
+    &RealtimeUpdater::processUpdates);
+}
+
+void
+RealtimeUpdater::mark_dirty (IRealtimeProperty &obj)
+{
+  if (!dirty_objects_.push_back (&obj))
+    {
+      dirty_objects_overflowed_.store (true, std::memory_order_release);
+    }
+  has_dirty_objects_.store (true, std::memory_order_release);
+}
+
+void
+RealtimeUpdater::scheduleUpdates ()
+{
+  if (!has_dirty_objects_.load (std::memory_order_acquire))
+    return;
+
+  /* process the updates along with the window's next frame */
+  if (window_ && window_->isExposed ())
+    {
+      window_->requestUpdate ();
+    }
+  else
+    {
+      processUpdates ();
+    }
 }
 
 void
 RealtimeUpdater::processUpdates ()
 {
+  if (!has_dirty_objects_.exchange (false, std::memory_order_acq_rel))
+    return;
+
+  Z_TRACE_ZONE ("RealtimeUpdater::processUpdates");
   QMutexLocker lock (&mutex_);
-  for (auto * obj : objects_)
+  if (dirty_objects_overflowed_.exchange (false, std::memory_order_acq_rel))
+    {
+      IRealtimeProperty * obj = nullptr;
+      while (dirty_objects_.pop_front (obj))
+        {
+        }
+      for (auto * rt_prop : std::as_const (objects_))
+        {
+          rt_prop->processUpdates ();
+        }
+      return;
+    }
+
+  IRealtimeProperty * obj = nullptr;
+  while (dirty_objects_.pop_front (obj))
     {
-      auto * rt_prop = dynamic_cast<IRealtimeProperty *> (obj);
-      z_return_if_fail (rt_prop);
-      rt_prop->processUpdates ();
+      /* skip objects deregistered after being marked dirty */
+      if (objects_.contains (obj))
+        {
+          obj->processUpdates ();
+        }
     }
 }
 
 void
-RealtimeUpdater::registerObject (QObject * obj)
+RealtimeUpdater::registerObject (IRealtimeProperty * obj)
 {
   QMutexLocker lock (&mutex_);
-  objects_.push_back (obj);
+  objects_.insert (obj);
 }
 
 void
-RealtimeUpdater::deregisterObject (QObject * obj)
+RealtimeUpdater::deregisterObject (IRealtimeProperty * obj)
 {
   QMutexLocker lock (&mutex_);
-  objects_.removeOne (obj);
+  objects_.remove (obj);
 }
 
 RealtimeUpdater::~RealtimeUpdater ()
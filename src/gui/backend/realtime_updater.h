@@ -2,15 +2,35 @@
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
 #pragma once
-#include <QList>
+#include <atomic>
+
+#include "utils/mpmc_queue.h"
+
 #include <QMutex>
 #include <QObject>
+#include <QPointer>
+#include <QQuickWindow>
+#include <QSet>
 #include <QTimer>
 
+class IRealtimeProperty;
+
+/**
+ * @brief Forwards changes made to realtime properties (see
+ * IRealtimeProperty) from realtime threads to the GUI thread.
+ *
+ * Realtime threads mark changed properties as dirty with mark_dirty(), and
+ * only the dirty properties are processed. Processing happens once per frame
+ * of the focused window (after its animations advance), or on a timer when
+ * no window is shown.
+ */
 class RealtimeUpdater : public QObject
 {
   Q_OBJECT
 public:
+  /** Max number of dirty properties between 2 updates. */
+  static constexpr size_t MAX_DIRTY_PROPERTIES = 4096;
+
   static RealtimeUpdater &instance ()
   {
     static RealtimeUpdater instance;
@@ -19,16 +39,44 @@ public:
 
   ~RealtimeUpdater () override;
 
-  void registerObject (QObject * obj);
+  void registerObject (IRealtimeProperty * obj);
+
+  void deregisterObject (IRealtimeProperty * obj);
 
-  void deregisterObject (QObject * obj);
+  /**
+   * @brief Queues processing @p obj's updates.
+   *
+   * Realtime-safe. Should only be called when @p obj goes from having no
+   * updates to having updates, so that it is queued only once.
+   */
+  void mark_dirty (IRealtimeProperty &obj);
 
 private:
   RealtimeUpdater (QObject * parent = nullptr);
 
+  /**
+   * @brief Requests a frame from the focused window if there are dirty
+   * properties, or processes them directly if there is no such window.
+   */
+  void scheduleUpdates ();
+
   void processUpdates ();
 
-  QTimer           timer_;
-  QList<QObject *> objects_;
-  QMutex           mutex_;
+  void setWindow (QWindow * window);
+
+  QTimer                    timer_;
+  QSet<IRealtimeProperty *> objects_;
+  QMutex                    mutex_;
+
+  /** Window whose frames drive the updates. */
+  QPointer<QQuickWindow> window_;
+
+  MPMCQueue<IRealtimeProperty *> dirty_objects_{ MAX_DIRTY_PROPERTIES };
+  std::atomic<bool>              has_dirty_objects_{ false };
+
+  /**
+   * Whether @ref dirty_objects_ overflowed, in which case all objects are
+   * processed.
+   */
+  std::atomic<bool> dirty_objects_overflowed_{ false };
 };
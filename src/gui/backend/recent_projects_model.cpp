@@ -1,6 +1,7 @@
 #include "gui/backend/backend/settings_manager.h"
 
 #include <QSettings>
+#include <QtConcurrent>
 
 #include "recent_projects_model.h"
 
@@ -9,51 +10,70 @@ using namespace zrythm::gui;
 RecentProjectsModel::RecentProjectsModel (QObject * parent)
     : QAbstractListModel (parent)
 {
+  rescan ();
 }
 
-std::vector<std::unique_ptr<ProjectInfo>>
-RecentProjectsModel::get_recent_projects ()
+std::vector<RecentProjectsModel::Entry>
+RecentProjectsModel::get_recent_projects (const QStringList &paths)
 {
-  auto list =
-    zrythm::gui::SettingsManager::get_instance ()->get_recent_projects ();
-  // list.append ("test 2");
-
-  std::vector<std::unique_ptr<ProjectInfo>> ret;
+  std::vector<Entry> ret;
   std::transform (
-    list.begin (), list.end (), std::back_inserter (ret),
+    paths.begin (), paths.end (), std::back_inserter (ret),
     [] (const auto &pathstr) {
-      return std::make_unique<ProjectInfo> (fs::path (pathstr.toStdString ()));
+      const ProjectInfo info (fs::path (pathstr.toStdString ()));
+      return Entry{
+        info.getPath (), info.getName (), info.getLastSavedAt () };
     });
 
   return ret;
 }
 
+void
+RecentProjectsModel::rescan ()
+{
+  /* only read the settings on this thread */
+  auto paths =
+    zrythm::gui::SettingsManager::get_instance ()->get_recent_projects ();
+
+  const auto generation = ++scan_generation_;
+  QtConcurrent::run ([paths = std::move (paths)] () {
+    return get_recent_projects (paths);
+  }).then (this, [this, generation] (std::vector<Entry> entries) {
+    /* the list changed in the meantime */
+    if (generation != scan_generation_)
+      return;
+
+    beginResetModel ();
+    entries_ = std::move (entries);
+    endResetModel ();
+  });
+}
+
 int
 RecentProjectsModel::rowCount (const QModelIndex &parent) const
 {
   if (parent.isValid ())
     return 0;
-  return (int) get_recent_projects ().size ();
+  return (int) entries_.size ();
 }
 
 QVariant
 RecentProjectsModel::data (const QModelIndex &index, int role) const
 {
-  if (!index.isValid ())
+  if (!index.isValid () || index.row () >= (int) entries_.size ())
     return {};
 
-  const auto   recent_projects = get_recent_projects ();
-  const auto * project = recent_projects.at (index.row ()).get ();
+  const auto &project = entries_.at (index.row ());
 
   switch (role)
     {
     case PathRole:
-      return project->getPath ();
+      return project.path_;
     case Qt::DisplayRole:
     case NameRole:
-      return project->getName ();
+      return project.name_;
     case DateRole:
-      return project->getLastSavedAt ();
+      return project.last_saved_at_;
     default:
       return {};
     }
@@ -74,7 +94,6 @@ RecentProjectsModel::roleNames () const
 void
 RecentProjectsModel::addRecentProject (const QString &path)
 {
-  beginResetModel ();
   auto recent_projects =
     SettingsManager::get_instance ()->get_recent_projects ();
   recent_projects.removeAll (path);
@@ -84,18 +103,17 @@ RecentProjectsModel::addRecentProject (const QString &path)
       recent_projects.removeLast ();
     }
   store_recent_projects (recent_projects);
-  endResetModel ();
+  rescan ();
 }
 
 void
 RecentProjectsModel::removeRecentProject (const QString &path)
 {
-  beginResetModel ();
   auto recent_projects =
     SettingsManager::get_instance ()->get_recent_projects ();
   recent_projects.removeAll (path);
   store_recent_projects (recent_projects);
-  endResetModel ();
+  rescan ();
 }
 
 void
@@ -107,7 +125,6 @@ RecentProjectsModel::store_recent_projects (const QStringList &list)
 void
 RecentProjectsModel::clearRecentProjects ()
 {
-  beginResetModel ();
   store_recent_projects ({});
-  endResetModel ();
+  rescan ();
 }
\ No newline at end of file
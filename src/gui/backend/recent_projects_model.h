@@ -3,6 +3,7 @@
 #include "project_info.h"
 
 #include <QAbstractListModel>
+#include <QDateTime>
 #include <QQmlEngine>
 #include <QStringList>
 #include <QtQmlIntegration>
@@ -10,6 +11,12 @@
 namespace zrythm::gui
 {
 
+/**
+ * @brief The recent projects, as stored in the settings.
+ *
+ * The project files are looked up on a background thread (see rescan()), so
+ * the model is empty until the first lookup finishes.
+ */
 class RecentProjectsModel : public QAbstractListModel
 {
   Q_OBJECT
@@ -35,10 +42,31 @@ public:
   Q_INVOKABLE void clearRecentProjects ();
 
 private:
-  static std::vector<std::unique_ptr<ProjectInfo>> get_recent_projects ();
-  static void store_recent_projects (const QStringList &list);
+  /**
+   * @brief Plain copy of a ProjectInfo that can be created on any thread.
+   */
+  struct Entry
+  {
+    QString   path_;
+    QString   name_;
+    QDateTime last_saved_at_;
+  };
+
+  static std::vector<Entry> get_recent_projects (const QStringList &paths);
+  static void               store_recent_projects (const QStringList &list);
+
+  /**
+   * @brief Looks up the recent projects on a background thread and resets
+   * the model with them when done.
+   */
+  void rescan ();
 
   static constexpr int MAX_RECENT_DOCUMENTS = 12;
+
+  std::vector<Entry> entries_;
+
+  /** Used to ignore the results of outdated scans. */
+  uint64_t scan_generation_ = 0;
 };
 
 } // namespace zrythm::gui
\ No newline at end of file
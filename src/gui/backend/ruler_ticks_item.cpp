@@ -0,0 +1,466 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/backend/ruler_ticks_item.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+#include <QPainter>
+#include <QQuickWindow>
+#include <QSGSimpleTextureNode>
+
+using namespace zrythm::gui;
+
+namespace
+{
+/**
+ * Labels are drawn right of their markers, so markers up to this far before a
+ * tile are drawn too in case their labels overflow into it.
+ */
+constexpr double MAX_LABEL_WIDTH = 96.0;
+
+constexpr int SIXTEENTHS_PER_BAR =
+  RulerTicksItem::SIXTEENTHS_PER_BEAT * RulerTicksItem::BEATS_PER_BAR;
+
+/* marker sizes */
+constexpr double BAR_LINE_WIDTH = 2.0;
+constexpr double BAR_LINE_HEIGHT = 14.0;
+constexpr double BEAT_LINE_HEIGHT = 10.0;
+constexpr double SIXTEENTH_LINE_HEIGHT = 8.0;
+constexpr double LABEL_MARGIN = 2.0;
+}
+
+/**
+ * @brief Root node owning the cached tile nodes, of which only the ones in
+ * view are attached.
+ */
+class RulerTicksItem::TilesNode : public QSGNode
+{
+public:
+  struct Tile
+  {
+    QSGSimpleTextureNode * node_ = nullptr;
+
+    /** Last frame the tile was shown in. */
+    uint64_t last_used_ = 0;
+  };
+
+  ~TilesNode () override { clear (); }
+
+  /**
+   * @brief Deletes all the tiles.
+   */
+  void clear ()
+  {
+    removeAllChildNodes ();
+    for (auto &[index, tile] : tiles_)
+      {
+        delete tile.node_;
+      }
+    tiles_.clear ();
+  }
+
+public:
+  std::unordered_map<int64_t, Tile> tiles_;
+
+  /** Cache version of the tiles. */
+  uint64_t version_ = 0;
+
+  uint64_t frame_ = 0;
+};
+
+RulerTicksItem::RulerTicksItem (QQuickItem * parent) : QQuickItem (parent)
+{
+  setFlag (QQuickItem::ItemHasContents);
+}
+
+RulerTicksItem::~RulerTicksItem () = default;
+
+void
+RulerTicksItem::setPxPerSixteenth (double px)
+{
+  if (qFuzzyCompare (px_per_sixteenth_, px))
+    return;
+
+  px_per_sixteenth_ = px;
+  Q_EMIT pxPerSixteenthChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setDetailMeasurePxThreshold (double px)
+{
+  if (qFuzzyCompare (detail_threshold_, px))
+    return;
+
+  detail_threshold_ = px;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setDetailMeasureLabelPxThreshold (double px)
+{
+  if (qFuzzyCompare (detail_label_threshold_, px))
+    return;
+
+  detail_label_threshold_ = px;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setVisibleX (double x)
+{
+  if (qFuzzyCompare (visible_x_, x))
+    return;
+
+  visible_x_ = x;
+  Q_EMIT visibleXChanged ();
+  update_range ();
+}
+
+void
+RulerTicksItem::setVisibleWidth (double width)
+{
+  if (qFuzzyCompare (visible_width_, width))
+    return;
+
+  visible_width_ = width;
+  Q_EMIT visibleWidthChanged ();
+  update_range ();
+}
+
+void
+RulerTicksItem::setColor (const QColor &color)
+{
+  if (color_ == color)
+    return;
+
+  color_ = color;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setBarFont (const QFont &font)
+{
+  if (bar_font_ == font)
+    return;
+
+  bar_font_ = font;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setBeatFont (const QFont &font)
+{
+  if (beat_font_ == font)
+    return;
+
+  beat_font_ = font;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setSixteenthFont (const QFont &font)
+{
+  if (sixteenth_font_ == font)
+    return;
+
+  sixteenth_font_ = font;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setBarLineOpacity (double opacity)
+{
+  if (qFuzzyCompare (bar_line_opacity_, opacity))
+    return;
+
+  bar_line_opacity_ = opacity;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setBeatLineOpacity (double opacity)
+{
+  if (qFuzzyCompare (beat_line_opacity_, opacity))
+    return;
+
+  beat_line_opacity_ = opacity;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::setSixteenthLineOpacity (double opacity)
+{
+  if (qFuzzyCompare (sixteenth_line_opacity_, opacity))
+    return;
+
+  sixteenth_line_opacity_ = opacity;
+  Q_EMIT styleChanged ();
+  invalidate ();
+}
+
+void
+RulerTicksItem::invalidate ()
+{
+  ++cache_version_;
+  rendered_tiles_.clear ();
+  uploaded_tiles_.clear ();
+  bar_labels_.clear ();
+  beat_labels_.clear ();
+  sixteenth_labels_.clear ();
+  shown_tiles_ = get_tile_range ();
+  polish ();
+  update ();
+}
+
+void
+RulerTicksItem::update_range ()
+{
+  const auto range = get_tile_range ();
+  if (range == shown_tiles_)
+    return;
+
+  shown_tiles_ = range;
+  polish ();
+  update ();
+}
+
+std::pair<int64_t, int64_t>
+RulerTicksItem::get_tile_range () const
+{
+  if (px_per_sixteenth_ <= 0.0 || width () <= 0 || height () <= 0)
+    return { 0, -1 };
+
+  /* show the whole item if the visible part is not set */
+  const double start_x = std::max (0.0, visible_x_);
+  const double end_x = std::min (
+    width (), visible_width_ > 0.0 ? visible_x_ + visible_width_ : width ());
+  if (end_x <= start_x)
+    return { 0, -1 };
+
+  const auto last_tile = static_cast<int64_t> ((width () - 1.0) / TILE_WIDTH);
+  return {
+    std::max<int64_t> (0, static_cast<int64_t> (start_x / TILE_WIDTH) - 1),
+    std::min<int64_t> (
+      last_tile, static_cast<int64_t> ((end_x - 1.0) / TILE_WIDTH) + 1)
+  };
+}
+
+const QStaticText &
+RulerTicksItem::get_label (
+  QHash<QString, QStaticText> &labels,
+  const QString               &text,
+  const QFont                 &font)
+{
+  auto it = labels.find (text);
+  if (it == labels.end ())
+    {
+      QStaticText label (text);
+      label.setTextFormat (Qt::PlainText);
+      label.prepare ({}, font);
+      it = labels.insert (text, label);
+    }
+  return *it;
+}
+
+QImage
+RulerTicksItem::render_tile (int64_t tile)
+{
+  const qreal dpr = window () ? window ()->effectiveDevicePixelRatio () : 1.0;
+  QImage      image (
+    QSize (TILE_WIDTH, static_cast<int> (std::ceil (height ()))) * dpr,
+    QImage::Format_ARGB32_Premultiplied);
+  image.setDevicePixelRatio (dpr);
+  image.fill (Qt::transparent);
+
+  QPainter painter (&image);
+  const auto tile_start = static_cast<double> (tile * TILE_WIDTH);
+  painter.translate (-tile_start, 0.0);
+
+  /* only draw the markers that are far enough apart */
+  const double px_per_beat = px_per_sixteenth_ * SIXTEENTHS_PER_BEAT;
+  int          step = 1;
+  if (px_per_beat <= detail_threshold_)
+    step = SIXTEENTHS_PER_BAR;
+  else if (px_per_sixteenth_ <= detail_threshold_)
+    step = SIXTEENTHS_PER_BEAT;
+
+  const auto first = std::max<int64_t> (
+    0, static_cast<int64_t> (std::ceil (
+         (tile_start - MAX_LABEL_WIDTH) / px_per_sixteenth_ / step))
+         * step);
+  const auto last =
+    static_cast<int64_t> ((tile_start + TILE_WIDTH) / px_per_sixteenth_);
+  for (auto i = first; i <= last; i += step)
+    {
+      const double x = static_cast<double> (i) * px_per_sixteenth_;
+      const auto   bar = i / SIXTEENTHS_PER_BAR + 1;
+      const auto   beat = (i % SIXTEENTHS_PER_BAR) / SIXTEENTHS_PER_BEAT + 1;
+      if (i % SIXTEENTHS_PER_BAR == 0)
+        {
+          painter.setOpacity (bar_line_opacity_);
+          painter.fillRect (
+            QRectF (x, 0.0, BAR_LINE_WIDTH, BAR_LINE_HEIGHT), color_);
+          const auto &label =
+            get_label (bar_labels_, QString::number (bar), bar_font_);
+          painter.setFont (bar_font_);
+          painter.setPen (color_);
+          painter.drawStaticText (
+            QPointF (
+              x + BAR_LINE_WIDTH + LABEL_MARGIN,
+              BAR_LINE_HEIGHT - label.size ().height ()),
+            label);
+        }
+      else if (i % SIXTEENTHS_PER_BEAT == 0)
+        {
+          painter.setOpacity (beat_line_opacity_);
+          painter.fillRect (QRectF (x, 0.0, 1.0, BEAT_LINE_HEIGHT), color_);
+          if (px_per_beat > detail_label_threshold_)
+            {
+              const auto &label = get_label (
+                beat_labels_, QStringLiteral ("%1.%2").arg (bar).arg (beat),
+                beat_font_);
+              painter.setFont (beat_font_);
+              painter.setPen (color_);
+              painter.drawStaticText (
+                QPointF (x + 1.0 + LABEL_MARGIN, 0.0), label);
+            }
+        }
+      else
+        {
+          painter.setOpacity (sixteenth_line_opacity_);
+          painter.fillRect (
+            QRectF (x, 0.0, 1.0, SIXTEENTH_LINE_HEIGHT), color_);
+          if (px_per_sixteenth_ > detail_label_threshold_)
+            {
+              const auto  sixteenth = i % SIXTEENTHS_PER_BEAT + 1;
+              const auto &label = get_label (
+                sixteenth_labels_,
+                QStringLiteral ("%1.%2.%3")
+                  .arg (bar)
+                  .arg (beat)
+                  .arg (sixteenth),
+                sixteenth_font_);
+              painter.setFont (sixteenth_font_);
+              painter.setPen (color_);
+              painter.drawStaticText (
+                QPointF (x + 1.0 + LABEL_MARGIN, 0.0), label);
+            }
+        }
+    }
+
+  return image;
+}
+
+void
+RulerTicksItem::updatePolish ()
+{
+  const auto [first, last] = get_tile_range ();
+  for (auto tile = first; tile <= last; ++tile)
+    {
+      if (!uploaded_tiles_.contains (tile) && !rendered_tiles_.contains (tile))
+        {
+          rendered_tiles_.emplace (tile, render_tile (tile));
+        }
+    }
+}
+
+void
+RulerTicksItem::geometryChange (
+  const QRectF &new_geometry,
+  const QRectF &old_geometry)
+{
+  QQuickItem::geometryChange (new_geometry, old_geometry);
+  if (new_geometry.height () != old_geometry.height ())
+    invalidate ();
+  else if (new_geometry.width () != old_geometry.width ())
+    update_range ();
+}
+
+void
+RulerTicksItem::itemChange (ItemChange change, const ItemChangeData &value)
+{
+  QQuickItem::itemChange (change, value);
+  if (change == ItemSceneChange || change == ItemDevicePixelRatioHasChanged)
+    invalidate ();
+}
+
+QSGNode *
+RulerTicksItem::updatePaintNode (QSGNode * old_node, UpdatePaintNodeData *)
+{
+  auto *     node = static_cast<TilesNode *> (old_node);
+  const auto [first, last] = get_tile_range ();
+  if (last < first)
+    {
+      delete node;
+      uploaded_tiles_.clear ();
+      return nullptr;
+    }
+
+  if (!node)
+    {
+      node = new TilesNode ();
+      node->version_ = cache_version_;
+    }
+  if (node->version_ != cache_version_)
+    {
+      node->clear ();
+      node->version_ = cache_version_;
+    }
+
+  /* upload the tiles rendered since the last update */
+  node->removeAllChildNodes ();
+  for (auto &[index, image] : rendered_tiles_)
+    {
+      auto &tile = node->tiles_[index];
+      delete tile.node_;
+      tile.node_ = new QSGSimpleTextureNode ();
+      tile.node_->setTexture (window ()->createTextureFromImage (image));
+      tile.node_->setOwnsTexture (true);
+      tile.node_->setRect (
+        static_cast<double> (index * TILE_WIDTH), 0.0, TILE_WIDTH,
+        image.deviceIndependentSize ().height ());
+      uploaded_tiles_.insert (index);
+    }
+  rendered_tiles_.clear ();
+
+  /* attach the tiles in view */
+  ++node->frame_;
+  for (auto index = first; index <= last; ++index)
+    {
+      auto it = node->tiles_.find (index);
+      if (it == node->tiles_.end ())
+        continue;
+
+      it->second.last_used_ = node->frame_;
+      node->appendChildNode (it->second.node_);
+    }
+
+  /* drop the least recently shown tiles */
+  while (node->tiles_.size () > MAX_CACHED_TILES)
+    {
+      auto oldest = std::ranges::min_element (
+        node->tiles_, {}, [] (const auto &entry) {
+          return entry.second.last_used_;
+        });
+      if (oldest->second.last_used_ == node->frame_)
+        break;
+
+      delete oldest->second.node_;
+      uploaded_tiles_.erase (oldest->first);
+      node->tiles_.erase (oldest);
+    }
+
+  return node;
+}
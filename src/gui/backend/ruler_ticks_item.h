@@ -0,0 +1,216 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <unordered_set>
+
+#include <QColor>
+#include <QFont>
+#include <QHash>
+#include <QImage>
+#include <QQuickItem>
+#include <QStaticText>
+#include <QtQmlIntegration>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Draws the bar, beat and sixteenth markers and labels of a ruler.
+ *
+ * The ruler is split into fixed-width tiles that are rendered once (with
+ * their labels) into textures and cached until the zoom level or the style
+ * changes. Scrolling only adds the tiles coming into view, so it doesn't
+ * redraw or lay out any text for the tiles already seen.
+ */
+class RulerTicksItem : public QQuickItem
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (
+    double pxPerSixteenth READ pxPerSixteenth WRITE setPxPerSixteenth NOTIFY
+      pxPerSixteenthChanged)
+  Q_PROPERTY (
+    double detailMeasurePxThreshold READ detailMeasurePxThreshold WRITE
+      setDetailMeasurePxThreshold NOTIFY styleChanged)
+  Q_PROPERTY (
+    double detailMeasureLabelPxThreshold READ detailMeasureLabelPxThreshold
+      WRITE setDetailMeasureLabelPxThreshold NOTIFY styleChanged)
+  Q_PROPERTY (
+    double visibleX READ visibleX WRITE setVisibleX NOTIFY visibleXChanged)
+  Q_PROPERTY (
+    double visibleWidth READ visibleWidth WRITE setVisibleWidth NOTIFY
+      visibleWidthChanged)
+  Q_PROPERTY (QColor color READ color WRITE setColor NOTIFY styleChanged)
+  Q_PROPERTY (QFont barFont READ barFont WRITE setBarFont NOTIFY styleChanged)
+  Q_PROPERTY (
+    QFont beatFont READ beatFont WRITE setBeatFont NOTIFY styleChanged)
+  Q_PROPERTY (
+    QFont sixteenthFont READ sixteenthFont WRITE setSixteenthFont NOTIFY
+      styleChanged)
+  Q_PROPERTY (
+    double barLineOpacity READ barLineOpacity WRITE setBarLineOpacity NOTIFY
+      styleChanged)
+  Q_PROPERTY (
+    double beatLineOpacity READ beatLineOpacity WRITE setBeatLineOpacity NOTIFY
+      styleChanged)
+  Q_PROPERTY (
+    double sixteenthLineOpacity READ sixteenthLineOpacity WRITE
+      setSixteenthLineOpacity NOTIFY styleChanged)
+
+public:
+  static constexpr int SIXTEENTHS_PER_BEAT = 4;
+  static constexpr int BEATS_PER_BAR = 4;
+
+  /** Width of a tile in pixels. */
+  static constexpr int TILE_WIDTH = 512;
+
+  /** Tiles kept in the cache, including the visible ones. */
+  static constexpr size_t MAX_CACHED_TILES = 48;
+
+  explicit RulerTicksItem (QQuickItem * parent = nullptr);
+  ~RulerTicksItem () override;
+
+  double pxPerSixteenth () const { return px_per_sixteenth_; }
+  void   setPxPerSixteenth (double px);
+
+  /**
+   * Beat and sixteenth markers are only drawn when they are further apart
+   * than this.
+   */
+  double detailMeasurePxThreshold () const { return detail_threshold_; }
+  void   setDetailMeasurePxThreshold (double px);
+
+  /**
+   * Beat and sixteenth labels are only drawn when their markers are further
+   * apart than this.
+   */
+  double detailMeasureLabelPxThreshold () const
+  {
+    return detail_label_threshold_;
+  }
+  void setDetailMeasureLabelPxThreshold (double px);
+
+  /** Start of the visible part of the ruler, in item coordinates. */
+  double visibleX () const { return visible_x_; }
+  void   setVisibleX (double x);
+
+  double visibleWidth () const { return visible_width_; }
+  void   setVisibleWidth (double width);
+
+  QColor color () const { return color_; }
+  void   setColor (const QColor &color);
+
+  QFont barFont () const { return bar_font_; }
+  void  setBarFont (const QFont &font);
+
+  QFont beatFont () const { return beat_font_; }
+  void  setBeatFont (const QFont &font);
+
+  QFont sixteenthFont () const { return sixteenth_font_; }
+  void  setSixteenthFont (const QFont &font);
+
+  double barLineOpacity () const { return bar_line_opacity_; }
+  void   setBarLineOpacity (double opacity);
+
+  double beatLineOpacity () const { return beat_line_opacity_; }
+  void   setBeatLineOpacity (double opacity);
+
+  double sixteenthLineOpacity () const { return sixteenth_line_opacity_; }
+  void   setSixteenthLineOpacity (double opacity);
+
+Q_SIGNALS:
+  void pxPerSixteenthChanged ();
+  void visibleXChanged ();
+  void visibleWidthChanged ();
+  void styleChanged ();
+
+protected:
+  void updatePolish () override;
+
+  QSGNode *
+  updatePaintNode (QSGNode * old_node, UpdatePaintNodeData * data) override;
+
+  void
+  geometryChange (const QRectF &new_geometry, const QRectF &old_geometry)
+    override;
+
+  void itemChange (ItemChange change, const ItemChangeData &value) override;
+
+private:
+  class TilesNode;
+
+  /**
+   * @brief Drops all the cached tiles and labels and schedules redrawing.
+   */
+  void invalidate ();
+
+  /**
+   * @brief Schedules rendering the tiles coming into view, if any.
+   */
+  void update_range ();
+
+  /**
+   * @brief Returns the first and last tiles to show (the visible ones and
+   * one on each side).
+   */
+  std::pair<int64_t, int64_t> get_tile_range () const;
+
+  /**
+   * @brief Renders the markers and labels of a tile.
+   */
+  QImage render_tile (int64_t tile);
+
+  /**
+   * @brief Returns the laid out @p text, caching it in @p labels.
+   */
+  static const QStaticText &get_label (
+    QHash<QString, QStaticText> &labels,
+    const QString               &text,
+    const QFont                 &font);
+
+private:
+  double px_per_sixteenth_ = 0.0;
+  double detail_threshold_ = 32.0;
+  double detail_label_threshold_ = 64.0;
+  double visible_x_ = 0.0;
+  double visible_width_ = 0.0;
+  QColor color_ = Qt::white;
+  QFont  bar_font_;
+  QFont  beat_font_;
+  QFont  sixteenth_font_;
+  double bar_line_opacity_ = 0.8;
+  double beat_line_opacity_ = 0.6;
+  double sixteenth_line_opacity_ = 0.4;
+
+  /**
+   * Incremented when the cached tiles become invalid (on zoom or style
+   * changes).
+   */
+  uint64_t cache_version_ = 0;
+
+  /** Tiles shown by the last update. */
+  std::pair<int64_t, int64_t> shown_tiles_ = { 0, -1 };
+
+  /**
+   * Tiles rendered on the GUI thread, waiting to be uploaded in the next
+   * updatePaintNode().
+   */
+  std::map<int64_t, QImage> rendered_tiles_;
+
+  /**
+   * Tiles uploaded to the scene graph (updated in updatePaintNode(), while
+   * the GUI thread is blocked).
+   */
+  std::unordered_set<int64_t> uploaded_tiles_;
+
+  /** Laid out labels, per font. */
+  QHash<QString, QStaticText> bar_labels_;
+  QHash<QString, QStaticText> beat_labels_;
+  QHash<QString, QStaticText> sixteenth_labels_;
+};
+
+} // namespace zrythm::gui
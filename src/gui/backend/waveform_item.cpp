@@ -0,0 +1,321 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/backend/waveform_item.h"
+#include "gui/dsp/tempo_track.h"
+#include "gui/dsp/tracklist.h"
+
+#include <span>
+
+#include <QMatrix4x4>
+#include <QSGClipNode>
+#include <QSGFlatColorMaterial>
+#include <QSGGeometryNode>
+#include <QSGTransformNode>
+
+using namespace zrythm::gui;
+
+using PeakPyramid = zrythm::utils::audio::PeakPyramid;
+
+/**
+ * @brief Root node holding the uploaded peaks, shared by the nodes drawing
+ * each loop of the region.
+ *
+ * Children are one clip node per loop, each with one transform node per
+ * channel drawing the channel's geometry.
+ */
+class WaveformItem::WaveformNode : public QSGNode
+{
+public:
+  /* the children refer to the geometries and the material */
+  ~WaveformNode () override { remove_loops (0); }
+
+  /**
+   * @brief Uploads @p level of @p peaks, unless already uploaded.
+   */
+  void upload (std::shared_ptr<const PeakPyramid> peaks, size_t level)
+  {
+    const auto num_frames = peaks->get_num_frames ();
+    if (peaks == peaks_ && num_frames == num_frames_ && level == level_)
+      return;
+
+    peaks_ = std::move (peaks);
+    num_frames_ = num_frames;
+    level_ = level;
+
+    const auto bucket_size = PeakPyramid::BUCKET_SIZES[level];
+    const auto num_peaks =
+      static_cast<size_t> ((num_frames + bucket_size - 1) / bucket_size);
+    std::vector<PeakPyramid::Peak> channel_peaks (num_peaks);
+    geometries_.clear ();
+    for (int ch = 0; ch < peaks_->get_num_channels (); ++ch)
+      {
+        peaks_->get_peaks (
+          ch, 0.0, static_cast<double> (bucket_size), channel_peaks);
+
+        /* a strip between the min and max of each peak */
+        auto geometry = std::make_unique<QSGGeometry> (
+          QSGGeometry::defaultAttributes_Point2D (),
+          static_cast<int> (num_peaks * 2));
+        geometry->setDrawingMode (QSGGeometry::DrawTriangleStrip);
+        geometry->setVertexDataPattern (QSGGeometry::StaticPattern);
+        auto * vertices = geometry->vertexDataAsPoint2D ();
+        for (size_t i = 0; i < num_peaks; ++i)
+          {
+            const auto x =
+              static_cast<float> (static_cast<int64_t> (i) * bucket_size);
+            vertices[i * 2].set (x, channel_peaks[i].max_);
+            vertices[i * 2 + 1].set (x, channel_peaks[i].min_);
+          }
+        geometries_.push_back (std::move (geometry));
+      }
+
+    /* the nodes referring to the previous geometries are recreated */
+    remove_loops (0);
+  }
+
+  /**
+   * @brief Adds a node drawing each channel inside @p clip_rect, with the
+   * clip frame/amplitude coordinates mapped by @p matrices.
+   */
+  void add_loop (const QRectF &clip_rect, std::span<const QMatrix4x4> matrices)
+  {
+    auto * clip_node = new QSGClipNode ();
+    clip_node->setIsRectangular (true);
+    clip_node->setClipRect (clip_rect);
+    for (size_t ch = 0; ch < geometries_.size (); ++ch)
+      {
+        auto * transform_node = new QSGTransformNode ();
+        transform_node->setMatrix (matrices[ch]);
+        auto * geometry_node = new QSGGeometryNode ();
+        geometry_node->setGeometry (geometries_[ch].get ());
+        geometry_node->setMaterial (&material_);
+        transform_node->appendChildNode (geometry_node);
+        clip_node->appendChildNode (transform_node);
+      }
+    appendChildNode (clip_node);
+  }
+
+  /**
+   * @brief Updates the loop node at @p index.
+   */
+  void update_loop (
+    int                         index,
+    const QRectF               &clip_rect,
+    std::span<const QMatrix4x4> matrices)
+  {
+    auto * clip_node = static_cast<QSGClipNode *> (childAtIndex (index));
+    if (clip_node->clipRect () != clip_rect)
+      {
+        clip_node->setClipRect (clip_rect);
+        clip_node->markDirty (QSGNode::DirtyGeometry);
+      }
+    for (size_t ch = 0; ch < matrices.size (); ++ch)
+      {
+        auto * transform_node = static_cast<QSGTransformNode *> (
+          clip_node->childAtIndex (static_cast<int> (ch)));
+        if (transform_node->matrix () != matrices[ch])
+          {
+            transform_node->setMatrix (matrices[ch]);
+            transform_node->markDirty (QSGNode::DirtyMatrix);
+          }
+      }
+  }
+
+  void set_color (const QColor &color)
+  {
+    if (material_.color () == color)
+      return;
+
+    material_.setColor (color);
+    for (int i = 0; i < childCount (); ++i)
+      {
+        for (auto * node = childAtIndex (i)->firstChild (); node != nullptr;
+             node = node->nextSibling ())
+          {
+            node->firstChild ()->markDirty (QSGNode::DirtyMaterial);
+          }
+      }
+  }
+
+  /**
+   * @brief Removes the loop nodes from @p index on.
+   */
+  void remove_loops (int index)
+  {
+    while (childCount () > index)
+      {
+        auto * child = lastChild ();
+        removeChildNode (child);
+        delete child;
+      }
+  }
+
+  size_t get_num_channels () const { return geometries_.size (); }
+
+private:
+  std::shared_ptr<const PeakPyramid>        peaks_;
+  int64_t                                   num_frames_ = -1;
+  size_t                                    level_ = 0;
+  std::vector<std::unique_ptr<QSGGeometry>> geometries_;
+  QSGFlatColorMaterial                      material_;
+};
+
+WaveformItem::WaveformItem (QQuickItem * parent) : QQuickItem (parent)
+{
+  setFlag (QQuickItem::ItemHasContents);
+}
+
+void
+WaveformItem::setRegion (AudioRegion * region)
+{
+  if (region_ == region)
+    return;
+
+  if (region_)
+    {
+      disconnect (region_->getPosition (), nullptr, this, nullptr);
+      disconnect (region_->getEndPosition (), nullptr, this, nullptr);
+    }
+  region_ = region;
+  if (region_)
+    {
+      connect (
+        region_->getPosition (), &PositionProxy::framesChanged, this,
+        &QQuickItem::update);
+      connect (
+        region_->getEndPosition (), &PositionProxy::framesChanged, this,
+        &QQuickItem::update);
+    }
+  Q_EMIT regionChanged ();
+  update ();
+}
+
+void
+WaveformItem::setColor (const QColor &color)
+{
+  if (color_ == color)
+    return;
+
+  color_ = color;
+  Q_EMIT colorChanged ();
+  update ();
+}
+
+void
+WaveformItem::geometryChange (
+  const QRectF &new_geometry,
+  const QRectF &old_geometry)
+{
+  QQuickItem::geometryChange (new_geometry, old_geometry);
+  if (new_geometry.size () != old_geometry.size ())
+    update ();
+}
+
+size_t
+WaveformItem::get_level_to_upload (
+  double  clip_frames_per_pixel,
+  int64_t num_frames)
+{
+  /* the coarsest level that is not coarser than a pixel (like
+   * PeakPyramid::get_peaks()), unless it has too many peaks */
+  size_t level = 0;
+  while (
+    level + 1 < PeakPyramid::BUCKET_SIZES.size ()
+    && (static_cast<double> (PeakPyramid::BUCKET_SIZES[level + 1])
+          <= clip_frames_per_pixel
+        || static_cast<size_t> (num_frames / PeakPyramid::BUCKET_SIZES[level])
+             > MAX_PEAKS_PER_CHANNEL))
+    {
+      ++level;
+    }
+  return level;
+}
+
+QSGNode *
+WaveformItem::updatePaintNode (QSGNode * old_node, UpdatePaintNodeData *)
+{
+  auto * node = static_cast<WaveformNode *> (old_node);
+
+  const auto * clip = region_ ? region_->get_clip () : nullptr;
+  auto         peaks = clip ? clip->get_peaks () : nullptr;
+  const auto   length = region_ ? region_->get_length_in_frames () : 0;
+  if (
+    !peaks || peaks->get_num_frames () == 0 || length <= 0 || width () <= 0
+    || height () <= 0)
+    {
+      delete node;
+      return nullptr;
+    }
+
+  /* clip frames per region frame */
+  double ratio = 1.0;
+  if (region_->get_musical_mode ())
+    {
+      ratio = static_cast<double> (P_TEMPO_TRACK->get_current_bpm ())
+              / static_cast<double> (clip->get_bpm ());
+    }
+  const double px_per_frame = width () / static_cast<double> (length);
+
+  if (!node)
+    {
+      node = new WaveformNode ();
+    }
+  const auto level =
+    get_level_to_upload (ratio / px_per_frame, peaks->get_num_frames ());
+  node->upload (std::move (peaks), level);
+  node->set_color (color_);
+
+  /* the first loop plays from the clip start, the next ones from the loop
+   * start */
+  const auto clip_start =
+    static_cast<double> (region_->clip_start_pos_.frames_);
+  const auto loop_start =
+    static_cast<double> (region_->loop_start_pos_.frames_);
+  const auto loop_end = static_cast<double> (region_->loop_end_pos_.frames_);
+  const auto num_channels = node->get_num_channels ();
+  const auto channel_height = height () / static_cast<double> (num_channels);
+  std::vector<QMatrix4x4> matrices (num_channels);
+  int                     loop_idx = 0;
+  double                  loop_x_frames = 0.0;
+  while (loop_x_frames < static_cast<double> (length))
+    {
+      const double local_start = loop_idx == 0 ? clip_start : loop_start;
+      const double loop_length = loop_end - local_start;
+      if (loop_length <= 0)
+        break;
+
+      const double x = loop_x_frames * px_per_frame;
+      const double loop_width =
+        std::min (loop_length, static_cast<double> (length) - loop_x_frames)
+        * px_per_frame;
+      for (size_t ch = 0; ch < num_channels; ++ch)
+        {
+          auto &matrix = matrices[ch];
+          matrix.setToIdentity ();
+          matrix.translate (
+            static_cast<float> (x - local_start * px_per_frame),
+            static_cast<float> (
+              channel_height * (static_cast<double> (ch) + 0.5)));
+          matrix.scale (
+            static_cast<float> (px_per_frame / ratio),
+            static_cast<float> (-channel_height / 2.0));
+        }
+      const QRectF clip_rect (x, 0.0, loop_width, height ());
+      if (loop_idx < node->childCount ())
+        {
+          node->update_loop (loop_idx, clip_rect, matrices);
+        }
+      else
+        {
+          node->add_loop (clip_rect, matrices);
+        }
+
+      loop_x_frames += loop_length;
+      ++loop_idx;
+    }
+
+  node->remove_loops (loop_idx);
+
+  return node;
+}
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include "gui/dsp/audio_region.h"
+
+#include <QColor>
+#include <QPointer>
+#include <QQuickItem>
+#include <QtQmlIntegration>
+
+namespace zrythm::gui
+{
+
+/**
+ * @brief Draws the waveform of an audio region on the GPU.
+ *
+ * A level of the clip's peak pyramid (see utils::audio::PeakPyramid) is
+ * uploaded once per channel as a vertex buffer in clip frame/amplitude
+ * coordinates, and transform nodes map it to the item. Moving, resizing or
+ * zooming the region only updates the transforms (and the clip rectangles of
+ * the loops), so the peaks are only read again when the clip changes or the
+ * zoom level needs a different pyramid level.
+ */
+class WaveformItem : public QQuickItem
+{
+  Q_OBJECT
+  QML_ELEMENT
+  Q_PROPERTY (
+    AudioRegion * region READ region WRITE setRegion NOTIFY regionChanged)
+  Q_PROPERTY (QColor color READ color WRITE setColor NOTIFY colorChanged)
+
+public:
+  /**
+   * @brief Max number of peaks uploaded per channel.
+   *
+   * Coarser levels are used for long clips when zoomed in, instead of
+   * uploading the finest level of the whole clip.
+   */
+  static constexpr size_t MAX_PEAKS_PER_CHANNEL = 1 << 18;
+
+  explicit WaveformItem (QQuickItem * parent = nullptr);
+
+  AudioRegion * region () const { return region_; }
+  void          setRegion (AudioRegion * region);
+
+  QColor color () const { return color_; }
+  void   setColor (const QColor &color);
+
+Q_SIGNALS:
+  void regionChanged ();
+  void colorChanged ();
+
+protected:
+  QSGNode *
+  updatePaintNode (QSGNode * old_node, UpdatePaintNodeData * data) override;
+
+  void
+  geometryChange (const QRectF &new_geometry, const QRectF &old_geometry)
+    override;
+
+private:
+  class WaveformNode;
+
+  /**
+   * @brief Returns the index of the pyramid level to upload for drawing
+   * @p clip_frames_per_pixel clip frames per pixel.
+   */
+  static size_t
+  get_level_to_upload (double clip_frames_per_pixel, int64_t num_frames);
+
+private:
+  QPointer<AudioRegion> region_;
+  QColor                color_ = Qt::white;
+};
+
+} // namespace zrythm::gui
@@ -2,9 +2,13 @@
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
 #include "utils/directory_manager.h"
+#include "utils/large_buffer_allocator.h"
 #include "utils/pcg_rand.h"
 #include "gui/backend/backend/settings_manager.h"
 #include "gui/backend/backend/zrythm.h"
+#include "gui/backend/batch_renderer.h"
+#include "gui/backend/engine_telemetry_model.h"
+#include "gui/backend/memory_usage_model.h"
 #include "gui/backend/realtime_updater.h"
 
 #include <QFontDatabase>
@@ -14,9 +18,11 @@
 #include <QQmlContext>
 #include <QQmlProperty>
 #include <QQuickStyle>
+#include <QQuickWindow>
 #include <QTimer>
 
 #include "engine/ipc_message.h"
+#include "engine/ipc_shared_memory.h"
 #include "zrythm_application.h"
 
 using namespace zrythm::gui;
@@ -37,6 +43,7 @@ ZrythmApplication::ZrythmApplication (int &argc, char ** argv)
   setApplicationDisplayName (u"Zrythm"_s);
   // setWindowIcon (QIcon (":/org.zrythm.Zrythm/resources/icons/zrythm.svg"));
 
+  const auto settings_start_usecs = startup_timer_.get_elapsed_usecs ();
   settings_manager_ = new SettingsManager (this);
   dir_manager_ = std::make_unique<DirectoryManager> ([&] () {
     return
@@ -55,27 +62,71 @@ ZrythmApplication::ZrythmApplication (int &argc, char ** argv)
   /* setup command line parser */
   setup_command_line_options ();
   cmd_line_parser_.process (*this);
+  startup_timer_.add_phase (
+    "settings", settings_start_usecs,
+    startup_timer_.get_elapsed_usecs () - settings_start_usecs);
+
+  /* applies to large buffers allocated from now on */
+  const auto apply_large_buffer_settings = [this] () {
+    utils::LargeBufferAllocator::set_options ({
+      .huge_pages_ = settings_manager_->get_hugePageBuffers (),
+      .lock_ = settings_manager_->get_lockBuffersInMemory (),
+    });
+  };
+  apply_large_buffer_settings ();
+  QObject::connect (
+    settings_manager_, &SettingsManager::hugePageBuffers_changed, this,
+    apply_large_buffer_settings);
+  QObject::connect (
+    settings_manager_, &SettingsManager::lockBuffersInMemory_changed, this,
+    apply_large_buffer_settings);
+
+  const bool rendering = cmd_line_parser_.isSet (u"render"_s);
 
   // Initialize JUCE
   juce ::JUCEApplicationBase ::createInstance = &juce_CreateApplication;
   juce::MessageManager::getInstance ()->setCurrentThreadAsMessageThread ();
 
-  alert_manager_ = new AlertManager (this);
-  theme_manager_ = new ThemeManager (this);
-  project_manager_ = new ProjectManager (this);
-  translation_manager_ = new TranslationManager (this);
-  RealtimeUpdater::instance ();
+  {
+    auto phase = startup_timer_.scope ("managers");
+    alert_manager_ = new AlertManager (this);
+    theme_manager_ = new ThemeManager (this);
+    project_manager_ = new ProjectManager (this);
+    translation_manager_ = new TranslationManager (this);
+    RealtimeUpdater::instance ();
+  }
 
-  launch_engine_process ();
+  if (!rendering)
+    {
+      auto phase = startup_timer_.scope ("engine process");
+      launch_engine_process ();
+    }
 
-  Zrythm::getInstance ()->pre_init (
-    applicationFilePath ().toStdString ().c_str (), true, true);
+  {
+    auto phase = startup_timer_.scope ("pre-init");
+    Zrythm::getInstance ()->pre_init (
+      applicationFilePath ().toStdString ().c_str (), !rendering, true);
+    gZrythm->rendering_ = rendering;
+  }
 
-  AudioEngine::set_default_backends (false);
+  if (rendering)
+    {
+      /* the dummy backends are always used when rendering (see
+       * Zrythm::rendering_) */
+      QTimer::singleShot (0, this, &ZrythmApplication::run_batch_render);
+      return;
+    }
 
-  setup_ui ();
+  {
+    auto phase = startup_timer_.scope ("default backends");
+    AudioEngine::set_default_backends (false);
+  }
 
-  gZrythm->init ();
+  {
+    /* also loads the greeter */
+    auto phase = startup_timer_.scope ("UI");
+    setup_ui ();
+  }
 
   constexpr const char * copyright_line =
     "Copyright (C) " COPYRIGHT_YEARS " " COPYRIGHT_NAME;
@@ -139,7 +190,23 @@ ZrythmApplication::setup_command_line_options ()
     {
      u"dummy"_s, tr ("Use dummy audio/midi engine"),
      },
+    { u"engine-telemetry-json"_s,
+     tr ("Write the audio engine's timing statistics (callback durations, DSP "
+          "load, jitter, xruns) as JSON to the given file on exit"),
+     u"file"_s },
+    { u"memory-usage-json"_s,
+     tr ("Write the approximate memory usage of each subsystem as JSON to "
+          "the given file on exit"),
+     u"file"_s },
+    { u"startup-profile-json"_s,
+     tr ("Write the time taken by each startup stage as JSON to the given "
+          "file once the greeter is shown"),
+     u"file"_s },
   });
+  BatchRenderer::add_command_line_options (cmd_line_parser_);
+  cmd_line_parser_.addPositionalArgument (
+    u"projects"_s, tr ("Projects to render (with --render)"),
+    u"[projects...]"_s);
 }
 
 SettingsManager *
@@ -261,6 +328,93 @@ ZrythmApplication::setup_ui ()
     {
       z_critical ("Failed to load QML file");
     }
+
+  /* finish initializing once the greeter is on screen */
+  auto * window =
+    qml_engine_->rootObjects ().isEmpty ()
+      ? nullptr
+      : qobject_cast<QQuickWindow *> (qml_engine_->rootObjects ().first ());
+  if (window)
+    {
+      connect (
+        window, &QQuickWindow::frameSwapped, this,
+        &ZrythmApplication::post_greeter_initialization,
+        static_cast<Qt::ConnectionType> (
+          Qt::QueuedConnection | Qt::SingleShotConnection));
+    }
+  else
+    {
+      QTimer::singleShot (
+        0, this, &ZrythmApplication::post_greeter_initialization);
+    }
+}
+
+void
+ZrythmApplication::post_greeter_initialization ()
+{
+  const auto greeter_shown_ms = startup_timer_.get_elapsed_usecs () / 1000;
+  startup_timer_.set_info (
+    "greeter_shown_ms", std::to_string (greeter_shown_ms));
+  z_info ("Greeter shown {}ms after startup", greeter_shown_ms);
+
+  /* not needed by the greeter (events are handled after this returns, so
+   * nothing can use it before) */
+  {
+    auto phase = startup_timer_.scope ("init (deferred)");
+    gZrythm->init ();
+  }
+
+  z_info ("{}", startup_timer_.get_summary ());
+  if (cmd_line_parser_.isSet (u"startup-profile-json"_s))
+    {
+      const auto path = cmd_line_parser_.value (u"startup-profile-json"_s);
+      try
+        {
+          startup_timer_.write_report (path.toStdString ());
+          z_info ("Wrote startup profile to {}", path);
+        }
+      catch (const ZrythmException &e)
+        {
+          z_warning ("Failed to write startup profile: {}", e.what ());
+        }
+    }
+}
+
+void
+ZrythmApplication::run_batch_render ()
+{
+  std::vector<fs::path> projects;
+  for (const auto &arg : cmd_line_parser_.positionalArguments ())
+    {
+      projects.emplace_back (arg.toStdString ());
+    }
+  if (projects.empty ())
+    {
+      z_warning ("No projects given to render");
+      exit (EXIT_FAILURE);
+      return;
+    }
+
+  try
+    {
+      const auto options =
+        BatchRenderer::parse_command_line_options (cmd_line_parser_);
+
+      /* only needed when rendering in this process (see BatchRenderer) */
+      if (projects.size () == 1)
+        {
+          gZrythm->init ();
+        }
+
+      const bool success =
+        BatchRenderer::run (applicationFilePath (), projects, options);
+      exit (success ? EXIT_SUCCESS : EXIT_FAILURE);
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("Failed to render: {}", e.what ());
+      exit (EXIT_FAILURE);
+    }
 }
 
 void
@@ -281,6 +435,9 @@ ZrythmApplication::setup_ipc ()
   if (socket_->waitForConnected (1000))
     {
       z_info ("Connected to IPC server");
+      connect (
+        socket_, &QLocalSocket::readyRead, this,
+        &ZrythmApplication::onIpcDataReceived);
     }
   else
     {
@@ -288,6 +445,38 @@ ZrythmApplication::setup_ipc ()
     }
 }
 
+void
+ZrythmApplication::onIpcDataReceived ()
+{
+  QDataStream in (socket_);
+  while (!in.atEnd ())
+    {
+      in.startTransaction ();
+      IPCMessage message;
+      in >> message;
+      if (!in.commitTransaction ())
+        break;
+
+      switch (message.type_)
+        {
+        case MessageType::AttachSharedMemory:
+          try
+            {
+              shared_memory_ = IPCSharedMemory::attach (
+                QString::fromUtf8 (message.data_));
+              z_info ("Attached to engine shared memory");
+            }
+          catch (const ZrythmException &e)
+            {
+              z_error ("Failed to attach to engine shared memory: {}", e.what ());
+            }
+          break;
+        default:
+          break;
+        }
+    }
+}
+
 void
 ZrythmApplication::launch_engine_process ()
 {
@@ -351,6 +540,36 @@ ZrythmApplication::onAboutToQuit ()
     {
       if (gZrythm->project_ && gZrythm->project_->audio_engine_)
         {
+          if (cmd_line_parser_.isSet (u"engine-telemetry-json"_s))
+            {
+              const auto path =
+                cmd_line_parser_.value (u"engine-telemetry-json"_s);
+              try
+                {
+                  EngineTelemetryModel::dump_to_file (
+                    *gZrythm->project_->audio_engine_, path);
+                  z_info ("Wrote engine telemetry to {}", path);
+                }
+              catch (const ZrythmException &e)
+                {
+                  z_warning ("Failed to write engine telemetry: {}", e.what ());
+                }
+            }
+
+          if (cmd_line_parser_.isSet (u"memory-usage-json"_s))
+            {
+              const auto path = cmd_line_parser_.value (u"memory-usage-json"_s);
+              try
+                {
+                  MemoryUsageModel::dump_to_file (*gZrythm->project_, path);
+                  z_info ("Wrote memory usage to {}", path);
+                }
+              catch (const ZrythmException &e)
+                {
+                  z_warning ("Failed to write memory usage: {}", e.what ());
+                }
+            }
+
           gZrythm->project_->audio_engine_->activate (false);
         }
       gZrythm->project_.reset ();
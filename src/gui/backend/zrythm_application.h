@@ -20,8 +20,11 @@
 #include <QTranslator>
 
 #include "utils/directory_manager.h"
+#include "utils/phase_timer.h"
 #include "utils/rt_thread_id.h"
 
+class IPCSharedMemory;
+
 namespace zrythm::gui
 {
 
@@ -73,8 +76,21 @@ private:
 
   void post_exec_initialization ();
 
+  /**
+   * @brief Initializes what isn't needed to show the greeter, once it's
+   * shown.
+   */
+  void post_greeter_initialization ();
+
+  /**
+   * @brief Renders the projects given on the command line without a UI and
+   * exits (see BatchRenderer).
+   */
+  void run_batch_render ();
+
 private Q_SLOTS:
   void onEngineOutput ();
+  void onIpcDataReceived ();
   void onAboutToQuit ();
 
 public:
@@ -82,11 +98,23 @@ public:
   QCommandLineParser cmd_line_parser_;
 
 private:
+  /**
+   * @brief Times the startup stages until the greeter is shown (see
+   * post_greeter_initialization()).
+   */
+  utils::PhaseTimer startup_timer_{ "startup" };
+
   /**
    * @brief Socket for communicating with the engine process.
    */
   QLocalSocket * socket_ = nullptr;
 
+  /**
+   * @brief High-rate channel to the engine process (parameter changes, meters,
+   * transport state).
+   */
+  std::unique_ptr<IPCSharedMemory> shared_memory_;
+
   std::unique_ptr<DirectoryManager> dir_manager_;
   AlertManager *    alert_manager_ = nullptr;
   SettingsManager * settings_manager_ = nullptr;
@@ -15,6 +15,7 @@
 #include "gui/dsp/marker.h"
 #include "gui/dsp/marker_track.h"
 #include "gui/dsp/midi_region.h"
+#include "gui/dsp/region_list.h"
 #include "gui/dsp/router.h"
 #include "gui/dsp/tracklist.h"
 #include "utils/debug.h"
@@ -24,16 +25,7 @@
 
 using namespace zrythm;
 
-ArrangerObject::ArrangerObject (Type type)
-    : pos_ (new PositionProxy ()), type_ (type)
-{
-}
-
-void
-ArrangerObject::parent_base_qproperties (QObject &derived)
-{
-  pos_->setParent (&derived);
-}
+ArrangerObject::ArrangerObject (Type type) : type_ (type) { }
 
 void
 ArrangerObject::generate_transient ()
@@ -178,12 +170,12 @@ ArrangerObject::get_position_ptr (PositionType pos_type)
   switch (pos_type)
     {
     case PositionType::Start:
-      return pos_;
+      return &*pos_;
     case PositionType::End:
       {
         auto lo = dynamic_cast<BoundedObject *> (this);
         z_return_val_if_fail (lo != nullptr, nullptr);
-        return lo->end_pos_;
+        return &*lo->end_pos_;
       }
     case PositionType::ClipStart:
       {
@@ -368,6 +360,14 @@ ArrangerObject::set_position (
   z_return_val_if_fail (pos_ptr, false);
   *pos_ptr = *pos;
 
+  invalidate_placements ();
+  if (
+    type_ == Type::Region
+    && (pos_type == PositionType::Start || pos_type == PositionType::End))
+    {
+      RegionList::invalidate_indices ();
+    }
+
   z_trace (
     "set {} position {} to {}", fmt::ptr (this), ENUM_NAME (pos_type), *pos);
 
@@ -577,7 +577,7 @@ ArrangerObject::
         {
           for (auto &note : obj->midi_notes_)
             {
-              note->update_positions (from_ticks, bpm_change, ratio);
+              note->update_positions (from_ticks, bpm_change, frames_per_tick);
             }
         }
 
@@ -585,7 +585,7 @@ ArrangerObject::
         {
           for (auto &ap : obj->aps_)
             {
-              ap->update_positions (from_ticks, bpm_change, ratio);
+              ap->update_positions (from_ticks, bpm_change, frames_per_tick);
             }
         }
 
@@ -593,13 +593,157 @@ ArrangerObject::
         {
           for (auto &chord : obj->chord_objects_)
             {
-              chord->update_positions (from_ticks, bpm_change, ratio);
+              chord->update_positions (from_ticks, bpm_change, frames_per_tick);
             }
         }
     },
     convert_to_variant<ArrangerObjectPtrVariant> (this));
 }
 
+void
+ArrangerObject::update_positions (
+  std::span<const ArrangerObjectPtrVariant> objects,
+  bool                                      from_ticks,
+  bool                                      bpm_change,
+  double                                    frames_per_tick)
+{
+  z_return_if_fail (frames_per_tick > 1e-10);
+
+  std::vector<Position *> positions;
+  for (const auto &obj_var : objects)
+    {
+      std::visit (
+        [&] (auto &&obj) {
+          using ObjT = base_type<decltype (obj)>;
+          if constexpr (std::is_same_v<ObjT, AudioRegion>)
+            {
+              if (!obj->get_musical_mode ())
+                {
+                  obj->update_positions (
+                    from_ticks, bpm_change, frames_per_tick);
+                  return;
+                }
+            }
+          obj->append_positions (positions);
+        },
+        obj_var);
+    }
+
+  const double ratio = from_ticks ? frames_per_tick : 1.0 / frames_per_tick;
+  Position::update (positions, from_ticks, ratio);
+
+  if (ROUTER->is_processing_kickoff_thread ())
+    {
+      /* do some validation */
+      for (const auto &obj_var : objects)
+        {
+          std::visit (
+            [&] (auto &&obj) {
+              using ObjT = base_type<decltype (obj)>;
+              if constexpr (std::derived_from<ObjT, BoundedObject>)
+                {
+                  z_return_if_fail (
+                    obj->is_position_valid (*obj->end_pos_, PositionType::End));
+                }
+            },
+            obj_var);
+        }
+    }
+}
+
+void
+ArrangerObject::append_positions (std::vector<Position *> &positions)
+{
+  std::visit (
+    [&] (auto &&obj) {
+      using ObjT = base_type<decltype (obj)>;
+      positions.push_back (&*obj->pos_);
+      if constexpr (std::derived_from<ObjT, BoundedObject>)
+        {
+          positions.push_back (&*obj->end_pos_);
+        }
+      if constexpr (std::derived_from<ObjT, LoopableObject>)
+        {
+          positions.push_back (&obj->clip_start_pos_);
+          positions.push_back (&obj->loop_start_pos_);
+          positions.push_back (&obj->loop_end_pos_);
+        }
+      if constexpr (std::derived_from<ObjT, FadeableObject>)
+        {
+          positions.push_back (&obj->fade_in_pos_);
+          positions.push_back (&obj->fade_out_pos_);
+        }
+
+      if constexpr (std::is_same_v<ObjT, MidiRegion>)
+        {
+          for (auto &note : obj->midi_notes_)
+            {
+              note->append_positions (positions);
+            }
+        }
+      else if constexpr (std::is_same_v<ObjT, AutomationRegion>)
+        {
+          for (auto &ap : obj->aps_)
+            {
+              ap->append_positions (positions);
+            }
+        }
+      else if constexpr (std::is_same_v<ObjT, ChordRegion>)
+        {
+          for (auto &chord : obj->chord_objects_)
+            {
+              chord->append_positions (positions);
+            }
+        }
+    },
+    convert_to_variant<ArrangerObjectPtrVariant> (this));
+}
+
+size_t
+ArrangerObject::get_memory_usage () const
+{
+  return std::visit (
+    [&] (auto &&obj) {
+      using ObjT = base_type<decltype (obj)>;
+      size_t ret = sizeof (ObjT);
+      if (obj->pos_.has_proxy ())
+        {
+          ret += sizeof (PositionProxy);
+        }
+      if constexpr (std::derived_from<ObjT, BoundedObject>)
+        {
+          if (obj->end_pos_.has_proxy ())
+            {
+              ret += sizeof (PositionProxy);
+            }
+        }
+
+      if constexpr (std::is_same_v<ObjT, MidiRegion>)
+        {
+          for (const auto &note : obj->midi_notes_)
+            {
+              ret += note->get_memory_usage ();
+            }
+        }
+      else if constexpr (std::is_same_v<ObjT, AutomationRegion>)
+        {
+          for (const auto &ap : obj->aps_)
+            {
+              ret += ap->get_memory_usage ();
+            }
+        }
+      else if constexpr (std::is_same_v<ObjT, ChordRegion>)
+        {
+          for (const auto &chord : obj->chord_objects_)
+            {
+              ret += chord->get_memory_usage ();
+            }
+        }
+      return ret;
+    },
+    convert_to_variant<ArrangerObjectPtrVariant> (this));
+}
+
 void
 ArrangerObject::post_deserialize ()
 {
@@ -721,6 +865,25 @@ ArrangerObject::is_frozen () const
     [&] (auto &&track) { return track->frozen_; }, get_track ());
 }
 
+void
+ArrangerObject::update_selection_index ()
+{
+  if (!PROJECT || !TRACKLIST)
+    return;
+
+  auto obj_var = PROJECT->find_arranger_object_by_id (get_uuid ());
+  if (!obj_var)
+    return;
+
+  const bool is_registered = std::visit (
+    [&] (auto &&obj) { return static_cast<ArrangerObject *> (obj) == this; },
+    obj_var->get ());
+  if (is_registered)
+    {
+      TRACKLIST->update_arranger_object_selection (*this);
+    }
+}
+
 bool
 ArrangerObject::is_hovered () const
 {
@@ -733,11 +896,7 @@ ArrangerObject::copy_members_from (
   const ArrangerObject &other,
   ObjectCloneType       clone_type)
 {
-  pos_ = other.pos_->clone_raw_ptr ();
-  if (auto * qobject = dynamic_cast<QObject *> (this))
-    {
-      pos_->setParent (qobject);
-    }
+  pos_ = other.pos_;
   type_ = other.type_;
   track_id_ = other.track_id_;
   deleted_temporarily_ = other.deleted_temporarily_;
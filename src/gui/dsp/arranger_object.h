@@ -4,7 +4,9 @@
 #ifndef __GUI_BACKEND_ARRANGER_OBJECT_H__
 #define __GUI_BACKEND_ARRANGER_OBJECT_H__
 
-#include "gui/backend/position_proxy.h"
+#include <atomic>
+
+#include "gui/backend/lazy_position_proxy.h"
 #include "gui/dsp/arranger_object_fwd.h"
 #include "gui/dsp/track_fwd.h"
 
@@ -46,6 +48,7 @@ public: \
       } \
 \
     selected_ = selected; \
+    update_selection_index (); \
 \
     Q_EMIT selectedChanged (selected); \
   } \
@@ -56,7 +59,7 @@ public: \
   Q_PROPERTY (PositionProxy * position READ getPosition CONSTANT) \
   PositionProxy * getPosition () const \
   { \
-    return pos_; \
+    return pos_.get_proxy (const_cast<ClassType *> (this)); \
   }
 
 /**
@@ -216,13 +219,21 @@ public:
            && (range_end_inclusive ? (pos_->frames_ <= global_frames_end) : (pos_->frames_ < global_frames_end));
   }
 
-  void parent_base_qproperties (QObject &derived);
-
   /**
    * Returns if the object is in the selections.
    */
   bool is_selected () const { return selected_; }
 
+  /**
+   * @brief Updates the project's selection index after the selection status
+   * changed.
+   *
+   * Clones (e.g., the ones held by undoable actions) share the UUID of the
+   * project's object, so only the object registered in the project updates
+   * the index.
+   */
+  void update_selection_index ();
+
   /**
    * @brief Prints the given object to a string.
    */
@@ -240,7 +251,7 @@ public:
    */
   void get_pos (dsp::Position * pos) const
   {
-    *pos = *static_cast<dsp::Position *> (pos_);
+    *pos = *pos_;
   };
 
   void get_position_from_type (dsp::Position * pos, PositionType type) const;
@@ -298,6 +309,26 @@ public:
   bool
   set_position (const dsp::Position * pos, PositionType pos_type, bool validate);
 
+  /**
+   * @brief Returns a counter incremented whenever the placement of any object
+   * changes (positions set through set_position(), and MIDI note pitches and
+   * velocities), so that caches of object placements can tell whether they
+   * are outdated.
+   */
+  static uint64_t get_placement_generation ()
+  {
+    return placement_generation_.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Marks caches of object placements as outdated (see
+   * get_placement_generation()).
+   */
+  static void invalidate_placements ()
+  {
+    placement_generation_.fetch_add (1, std::memory_order_relaxed);
+  }
+
   /**
    * Moves the object by the given amount of ticks.
    */
@@ -323,6 +354,31 @@ public:
   void
   update_positions (bool from_ticks, bool bpm_change, double frames_per_tick);
 
+  /**
+   * @brief Same as calling update_positions() on each of @p objects, with all
+   * their positions converted in one pass.
+   *
+   * Audio regions that are not in musical mode are still updated one by one,
+   * since they may need to be resized to fit their clip.
+   */
+  static void update_positions (
+    std::span<const ArrangerObjectPtrVariant> objects,
+    bool                                      from_ticks,
+    bool                                      bpm_change,
+    double                                    frames_per_tick);
+
+  /**
+   * @brief Appends the positions of this object and of its children
+   * (recursively).
+   */
+  void append_positions (std::vector<Position *> &positions);
+
+  /**
+   * @brief Returns the approximate number of bytes used by this object and
+   * its children (recursively).
+   */
+  size_t get_memory_usage () const;
+
   /**
    * Returns the Track this ArrangerObject is in.
    */
@@ -417,6 +473,9 @@ protected:
 private:
   dsp::Position * get_position_ptr (PositionType type);
 
+  /** Incremented whenever the placement of any object changes. */
+  static inline std::atomic<uint64_t> placement_generation_ = 0;
+
 public:
   /**
    * Position (or start Position if the object has length).
@@ -425,8 +484,10 @@ public:
    *
    * Midway Position between previous and next AutomationPoint's, if
    * AutomationCurve.
+   *
+   * The PositionProxy exposed to QML is only created when first requested.
    */
-  PositionProxy * pos_ = nullptr;
+  LazyPositionProxy pos_;
 
   Type type_{};
 
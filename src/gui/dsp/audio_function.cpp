@@ -6,18 +6,119 @@
 #include "gui/backend/backend/zrythm.h"
 #include "gui/dsp/audio_function.h"
 #include "gui/dsp/audio_region.h"
+#include "gui/dsp/clip.h"
 #include "gui/dsp/engine.h"
 
 #include "utils/debug.h"
 #include "utils/dsp.h"
 #include "utils/exceptions.h"
 #include "utils/gtest_wrapper.h"
+#include "utils/progress_info.h"
 #include "utils/rt_thread_id.h"
 #include "utils/string.h"
+
+#include <QtConcurrent>
+
 #include <rubberband/rubberband-c.h>
 
 using namespace zrythm;
 
+namespace
+{
+
+/** Frames processed by each job of a chunked audio function. */
+constexpr unsigned_frame_t CHUNK_FRAMES = 1 << 16;
+
+/**
+ * A range of frames of one channel, processed independently of the others.
+ */
+struct Chunk
+{
+  int              channel_ = 0;
+  unsigned_frame_t start_ = 0;
+  unsigned_frame_t size_ = 0;
+
+  /** Result of an analysis pass (e.g. the peak of the chunk). */
+  float result_ = 0.f;
+};
+
+std::vector<Chunk>
+split_into_chunks (int channels, unsigned_frame_t num_frames)
+{
+  std::vector<Chunk> chunks;
+  for (int ch = 0; ch < channels; ++ch)
+    {
+      for (unsigned_frame_t start = 0; start < num_frames;
+           start += CHUNK_FRAMES)
+        {
+          chunks.push_back (Chunk{
+            .channel_ = ch,
+            .start_ = start,
+            .size_ = std::min (CHUNK_FRAMES, num_frames - start) });
+        }
+    }
+  return chunks;
+}
+
+/**
+ * @brief Marks @p progress_info cancelled and throws if cancellation was
+ * requested.
+ *
+ * @throw ZrythmException if cancellation was requested.
+ */
+void
+throw_if_cancelled (ProgressInfo * progress_info)
+{
+  if (progress_info && progress_info->pending_cancellation ())
+    {
+      progress_info->mark_completed (
+        ProgressInfo::CompletionType::CANCELLED, {});
+      throw ZrythmException (QObject::tr ("Audio function cancelled"));
+    }
+}
+
+/**
+ * @brief Runs @p func on each of the @p chunks on the global thread pool and
+ * waits for all of them.
+ *
+ * Progress is reported to @p progress_info (if any) as going from
+ * @p progress_from to @p progress_to. Chunks not started yet when cancellation
+ * is requested are skipped.
+ *
+ * @throw ZrythmException if cancellation was requested.
+ */
+template <typename Func>
+void
+run_chunked (
+  std::vector<Chunk> &chunks,
+  ProgressInfo *      progress_info,
+  double              progress_from,
+  double              progress_to,
+  Func              &&func)
+{
+  std::atomic<size_t> num_done = 0;
+  const auto          num_chunks = chunks.size ();
+  QtConcurrent::blockingMap (chunks, [&] (Chunk &chunk) {
+    if (progress_info && progress_info->pending_cancellation ())
+      return;
+
+    func (chunk);
+
+    if (progress_info)
+      {
+        const auto done = ++num_done;
+        progress_info->update_progress (
+          progress_from
+            + (progress_to - progress_from) * static_cast<double> (done)
+                / static_cast<double> (num_chunks),
+          {});
+      }
+  });
+  throw_if_cancelled (progress_info);
+}
+
+} // namespace
+
 std::string
 audio_function_get_action_target_for_type (AudioFunctionType type)
 {
@@ -279,25 +380,67 @@ apply_plugin (
 }
 #endif
 
-void
+std::vector<dsp::Position>
+audio_function_get_transients (
+  ArrangerObject::Uuid region_id,
+  const dsp::Position &sel_start,
+  const dsp::Position &sel_end,
+  float                min_strength)
+{
+  auto * r =
+    std::get<AudioRegion *> (*PROJECT->find_arranger_object_by_id (region_id));
+  z_return_val_if_fail (r, {});
+  auto * clip = r->get_clip ();
+  z_return_val_if_fail (clip, {});
+
+  if (sel_start < *r->pos_ || sel_end > *r->end_pos_)
+    {
+      throw ZrythmException (QObject::tr ("Invalid positions"));
+    }
+
+  auto onsets = clip->get_onsets ();
+  if (!onsets->is_computed ())
+    {
+      const auto frames = clip->get_shared_frames ();
+      z_return_val_if_fail (frames, {});
+      auto detected = std::make_shared<utils::audio::OnsetIndex> ();
+      detected->update (*frames, clip->get_samplerate ());
+      onsets = std::move (detected);
+    }
+
+  /* the selection maps to the clip's frames as in audio_function_apply() */
+  std::vector<dsp::Position> ret;
+  for (
+    const auto &onset : onsets->get_onsets (
+      sel_start.frames_ - r->pos_->frames_, sel_end.frames_ - r->pos_->frames_,
+      min_strength))
+    {
+      ret.emplace_back (
+        r->pos_->frames_ + onset.frame_, AUDIO_ENGINE->ticks_per_frame_);
+    }
+  return ret;
+}
+
+dsp::AudioRangePatch
 audio_function_apply (
   ArrangerObject::Uuid       region_id,
   const dsp::Position       &sel_start,
   const dsp::Position       &sel_end,
   AudioFunctionType          type,
   AudioFunctionOpts          opts,
-  std::optional<std::string> uri)
+  std::optional<std::string> uri,
+  ProgressInfo *             progress_info)
 {
   using Position = AudioRegion::Position;
   z_debug ("applying {}...", AudioFunctionType_to_string (type));
 
   auto * r =
     std::get<AudioRegion *> (*PROJECT->find_arranger_object_by_id (region_id));
-  z_return_if_fail (r);
+  z_return_val_if_fail (r, {});
   auto tr = std::get<AudioTrack *> (r->get_track ());
-  z_return_if_fail (tr);
+  z_return_val_if_fail (tr, {});
   auto * orig_clip = r->get_clip ();
-  z_return_if_fail (orig_clip);
+  z_return_val_if_fail (orig_clip, {});
 
   Position init_pos;
   if (sel_start < *r->pos_ || sel_end > *r->end_pos_)
@@ -334,15 +477,48 @@ audio_function_apply (
     ArrangerObject::DEFAULT_NUDGE_TICKS, 0.0);
   unsigned_frame_t num_frames_excl_nudge;
   z_debug ("num frames {}, nudge_frames {}", num_frames, nudge_frames);
-  z_return_if_fail_cmp (nudge_frames, >, 0);
+  z_return_val_if_fail_cmp (nudge_frames, >, 0, {});
+
+  if (progress_info)
+    {
+      progress_info->update_progress (
+        0.0, AudioFunctionType_to_string (type));
+    }
 
+  auto chunks = split_into_chunks (channels, num_frames);
   switch (type)
     {
     case AudioFunctionType::Invert:
-      dest_frames.invert_phase ();
+      run_chunked (chunks, progress_info, 0.0, 1.0, [&] (const Chunk &chunk) {
+        utils::float_ranges::mul_k2 (
+          dest_frames.getWritePointer (chunk.channel_, chunk.start_), -1.f,
+          chunk.size_);
+      });
       break;
     case AudioFunctionType::NormalizePeak:
-      dest_frames.normalize_peak ();
+      {
+        /* find the peak of each channel first, then apply the gain */
+        run_chunked (chunks, progress_info, 0.0, 0.5, [&] (Chunk &chunk) {
+          chunk.result_ = utils::float_ranges::abs_max (
+            src_frames.getReadPointer (chunk.channel_, chunk.start_),
+            chunk.size_);
+        });
+        std::vector<float> peaks (channels, 0.f);
+        for (const auto &chunk : chunks)
+          {
+            peaks[chunk.channel_] =
+              std::max (peaks[chunk.channel_], chunk.result_);
+          }
+        run_chunked (chunks, progress_info, 0.5, 1.0, [&] (const Chunk &chunk) {
+          const auto peak = peaks[chunk.channel_];
+          if (peak <= 0.f)
+            return;
+
+          utils::float_ranges::mul_k2 (
+            dest_frames.getWritePointer (chunk.channel_, chunk.start_),
+            1.f / peak, chunk.size_);
+        });
+      }
       break;
     case AudioFunctionType::NormalizeRMS:
       /* TODO rms-normalize */
@@ -351,13 +527,24 @@ audio_function_apply (
       /* TODO lufs-normalize */
       break;
     case AudioFunctionType::LinearFadeIn:
-      dest_frames.applyGainRamp (0, num_frames, 0.f, 1.f);
-      break;
     case AudioFunctionType::LinearFadeOut:
-      dest_frames.applyGainRamp (0, num_frames, 1.f, 0.f);
+      {
+        const bool fade_in = type == AudioFunctionType::LinearFadeIn;
+        const auto gain_at = [&] (unsigned_frame_t frame) {
+          const auto pos = static_cast<float> (
+            static_cast<double> (frame) / static_cast<double> (num_frames));
+          return fade_in ? pos : 1.f - pos;
+        };
+        run_chunked (chunks, progress_info, 0.0, 1.0, [&] (const Chunk &chunk) {
+          dest_frames.applyGainRamp (
+            chunk.channel_, static_cast<int> (chunk.start_),
+            static_cast<int> (chunk.size_), gain_at (chunk.start_),
+            gain_at (chunk.start_ + chunk.size_));
+        });
+      }
       break;
     case AudioFunctionType::NudgeLeft:
-      z_return_if_fail (num_frames > nudge_frames);
+      z_return_val_if_fail (num_frames > nudge_frames, {});
       num_frames_excl_nudge = num_frames - (size_t) nudge_frames;
 
       for (int ch = 0; ch < channels; ch++)
@@ -372,7 +559,7 @@ audio_function_apply (
         }
       break;
     case AudioFunctionType::NudgeRight:
-      z_return_if_fail (num_frames > nudge_frames);
+      z_return_val_if_fail (num_frames > nudge_frames, {});
       num_frames_excl_nudge = num_frames - (size_t) nudge_frames;
       for (int ch = 0; ch < channels; ch++)
         {
@@ -385,11 +572,19 @@ audio_function_apply (
         }
       break;
     case AudioFunctionType::Reverse:
-      dest_frames.reverse (0, num_frames);
+      /* each chunk of the destination is the mirrored chunk of the source,
+       * reversed */
+      run_chunked (chunks, progress_info, 0.0, 1.0, [&] (const Chunk &chunk) {
+        utils::float_ranges::reverse (
+          dest_frames.getWritePointer (chunk.channel_, chunk.start_),
+          src_frames.getReadPointer (
+            chunk.channel_, num_frames - chunk.start_ - chunk.size_),
+          chunk.size_);
+      });
       break;
     case AudioFunctionType::PitchShift:
       {
-        z_return_if_fail_cmp (channels, >=, 2);
+        z_return_val_if_fail_cmp (channels, >=, 2, {});
         RubberBandState   rubberband_state{};
         RubberBandOptions rubberband_opts =
           RubberBandOptionProcessOffline
@@ -403,6 +598,9 @@ audio_function_apply (
         rubberband_state = rubberband_new (
           AUDIO_ENGINE->sample_rate_, channels, rubberband_opts, 1.0,
           opts.amount_);
+        std::unique_ptr<
+          std::remove_pointer_t<RubberBandState>, decltype (&rubberband_delete)>
+          rubberband_state_owner (rubberband_state, rubberband_delete);
         const size_t max_process_size = 8192;
         rubberband_set_debug_level (rubberband_state, 2);
         rubberband_set_max_process_size (rubberband_state, max_process_size);
@@ -414,6 +612,17 @@ audio_function_apply (
         size_t frames_read = 0;
         while (frames_read < num_frames)
           {
+            /* pitch shifting is sequential, so only report progress and check
+             * for cancellation between blocks */
+            throw_if_cancelled (progress_info);
+            if (progress_info)
+              {
+                progress_info->update_progress (
+                  static_cast<double> (frames_read)
+                    / static_cast<double> (num_frames),
+                  {});
+              }
+
             unsigned int samples_required =
               std::min (num_frames - samples_fed, max_process_size);
             /*rubberband_get_samples_required (*/
@@ -551,30 +760,15 @@ audio_function_apply (
       break;
     }
 
-#if 0
-  char * tmp =
-    g_strdup_printf (
-      "%s - %s - %s",
-      tr->name, r->name,
-      audio_function_type_to_string (type));
-
-  /* remove dots from name */
-  char * name = string_replace (tmp, ".", "_");
-  g_free (tmp);
-#endif
-
-  int  id = AUDIO_POOL->add_clip (std::make_unique<AudioClip> (
-    dest_frames, AudioClip::BitDepth::BIT_DEPTH_32, AUDIO_ENGINE->sample_rate_,
-    P_TEMPO_TRACK->get_current_bpm (), orig_clip->get_name ()));
-  auto clip = AUDIO_POOL->get_clip (id);
+  /* keep only the changed frames for undoing, instead of copies of the
+   * clip */
+  dsp::AudioRangePatch patch (
+    src_frames, dest_frames, static_cast<unsigned_frame_t> (start.frames_));
   z_debug (
-    "writing {} to pool (id {})", clip->get_name (), clip->get_pool_id ());
-  AUDIO_POOL->write_clip (*clip, false, false);
-
-  // FIXME: needed?
-  // audio_sel.pool_id_ = clip->get_pool_id ();
+    "{} frames changed ({} bytes compressed)", patch.get_num_frames (),
+    patch.get_compressed_size ());
 
-  if (type != AudioFunctionType::Invalid)
+  if (type != AudioFunctionType::Invalid && !patch.empty ())
     {
       /* replace the frames in the region */
       r->replace_frames (dest_frames, start.frames_, false);
@@ -594,5 +788,13 @@ audio_function_apply (
         }
     }
 
+  if (progress_info)
+    {
+      progress_info->mark_completed (
+        ProgressInfo::CompletionType::SUCCESS, {});
+    }
+
   // EVENTS_PUSH (EventType::ET_EDITOR_FUNCTION_APPLIED, nullptr);
+
+  return patch;
 }
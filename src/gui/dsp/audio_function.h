@@ -12,11 +12,14 @@
 #ifndef __AUDIO_AUDIO_FUNCTION_H__
 #define __AUDIO_AUDIO_FUNCTION_H__
 
+#include "dsp/audio_range_patch.h"
 #include "gui/dsp/arranger_object.h"
 #include "gui/dsp/plugin.h"
 #include "utils/format.h"
 #include "utils/logger.h"
 
+class ProgressInfo;
+
 /**
  * @addtogroup dsp
  *
@@ -96,24 +99,49 @@ audio_function_get_plugin_uri_for_type (AudioFunctionType type)
 }
 
 /**
- * Applies the given action to the given selections.
+ * Applies the given action to the selected range of the region's clip.
+ *
+ * @param type Function type. If invalid is passed, nothing is changed.
+ * @param progress_info Optional progress info to report progress to and to
+ * check for cancellation requests. It is marked completed when done.
  *
- * This will save a file in the pool and store the pool ID in the selections.
+ * Functions that process each channel and each part of the selection
+ * independently (and the analysis pass of the normalize functions) are split
+ * into chunks processed in parallel on the global thread pool. This call
+ * waits for them.
  *
- * @param sel Selections to edit.
- * @param type Function type. If invalid is passed, this will simply add the
- * audio file in the pool for the unchanged audio material (used in audio
- * selection actions for the selections before the change).
- * @throw ZrythmException on error.
+ * @return The frames of the clip that changed, before and after (used as
+ * undo data).
+ * @throw ZrythmException on error or if cancellation was requested.
  */
-void
+dsp::AudioRangePatch
 audio_function_apply (
   ArrangerObject::Uuid       region_id,
   const dsp::Position       &sel_start,
   const dsp::Position       &sel_end,
   AudioFunctionType          type,
   AudioFunctionOpts          opts,
-  std::optional<std::string> uri);
+  std::optional<std::string> uri,
+  ProgressInfo *             progress_info = nullptr);
+
+/**
+ * Returns the global positions of the transients (onsets) of the region's
+ * clip within the given selection, in ascending order (e.g., to slice or
+ * quantize the selection).
+ *
+ * The onsets detected in the background are used if available (see
+ * AudioClip::get_onsets()), otherwise they are detected now.
+ *
+ * @param min_strength Minimum relative strength of the onsets (0 to 1).
+ *
+ * @throw ZrythmException if the positions are invalid.
+ */
+std::vector<dsp::Position>
+audio_function_get_transients (
+  ArrangerObject::Uuid region_id,
+  const dsp::Position &sel_start,
+  const dsp::Position &sel_end,
+  float                min_strength);
 
 DEFINE_ENUM_FORMATTER (
   AudioFunctionType,
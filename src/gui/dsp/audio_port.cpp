@@ -10,6 +10,8 @@
 #include "gui/dsp/tracklist.h"
 #include "utils/dsp.h"
 
+#include <cmath>
+
 #include <fmt/format.h>
 
 AudioPort::AudioPort () : AudioPort ("", PortFlow::Input) { }
@@ -28,18 +30,200 @@ AudioPort::init_after_cloning (const AudioPort &other, ObjectCloneType clone_typ
 void
 AudioPort::allocate_bufs ()
 {
-  audio_ring_ = std::make_unique<RingBuffer<float>> (AUDIO_RING_SIZE);
+  audio_ring_ = std::make_shared<RingBuffer<float>> (AUDIO_RING_SIZE);
 
-  size_t max = std::max (AUDIO_ENGINE->block_length_, 1u);
-  buf_.resize (max);
+  size_t max = std::max (AUDIO_ENGINE->max_block_length_, 1u);
+  ensure_buffer_size (max);
   last_buf_sz_ = max;
 }
 
 void
 AudioPort::clear_buffer (AudioEngine &engine)
 {
+  if (is_rendered_ahead ())
+    return;
+
+  clear_buffer_unconditionally (engine);
+}
+
+void
+AudioPort::clear_buffer_unconditionally (const AudioEngine &engine)
+{
+  buf_ = own_buf_;
   utils::float_ranges::fill (
     buf_.data (), DENORMAL_PREVENTION_VAL (&engine), engine.block_length_);
+  silent_ = true;
+  deferred_src_ = nullptr;
+}
+
+void
+AudioPort::clear_rendered_ahead_buffers ()
+{
+  clear_buffer_unconditionally (*AUDIO_ENGINE);
+}
+
+void
+AudioPort::allocate_rendered_ahead_slots (
+  size_t    num_slots,
+  nframes_t block_length)
+{
+  rendered_ahead_slots_.assign (num_slots, std::vector<float> (block_length));
+}
+
+void
+AudioPort::render_ahead_into_slot (
+  size_t                slot,
+  EngineProcessTimeInfo time_nfo)
+{
+  auto &dest = rendered_ahead_slots_[slot];
+  utils::float_ranges::fill (
+    dest.data (), DENORMAL_PREVENTION_VAL (AUDIO_ENGINE), dest.size ());
+  sum_sources (dest.data (), time_nfo);
+}
+
+void
+AudioPort::restore_from_slot (size_t slot, EngineProcessTimeInfo time_nfo)
+{
+  if (is_buffer_aliased ())
+    stop_aliasing (time_nfo.local_offset_);
+  utils::float_ranges::copy (
+    &buf_[time_nfo.local_offset_],
+    &rendered_ahead_slots_[slot][time_nfo.local_offset_], time_nfo.nframes_);
+  finish_processing (time_nfo);
+}
+
+void
+AudioPort::update_processing_info ()
+{
+  alias_src_ = nullptr;
+  if (srcs_.size () == 1 && srcs_.front ()->is_audio ())
+    {
+      alias_src_ = static_cast<const AudioPort *> (srcs_.front ());
+    }
+
+  const auto owner_type = id_->owner_type_;
+  const bool is_stereo = is_stereo_port ();
+  processing_info_ = {
+    .clip_sources_ = owner_type == PortIdentifier::OwnerType::Fader,
+    .update_peak_ =
+      owner_type == PortIdentifier::OwnerType::Channel && is_stereo
+      && is_output (),
+    .is_stereo_output_ = is_stereo && is_output (),
+  };
+  if (auto * master = P_MASTER_TRACK; master != nullptr && master->processor_)
+    {
+      processing_info_.is_master_stereo_input_ =
+        master->processor_->stereo_in_left_id_ == get_uuid ()
+        || master->processor_->stereo_in_right_id_ == get_uuid ();
+    }
+
+  /* split many sources into groups of about sqrt(n) sources, so that both the
+   * partial sums and the port have little to sum */
+  size_t num_partial_sums = 0;
+  size_t group_size = 0;
+  if (
+    srcs_.size () >= MIN_SOURCES_FOR_PARTIAL_SUMS
+    && !processing_info_.clip_sources_ && !processing_info_.update_peak_)
+    {
+      group_size = static_cast<size_t> (
+        std::ceil (std::sqrt (static_cast<double> (srcs_.size ()))));
+      num_partial_sums = (srcs_.size () + group_size - 1) / group_size;
+    }
+  partial_sums_.resize (num_partial_sums);
+  const size_t max_block_length =
+    std::max (AUDIO_ENGINE->max_block_length_, 1u);
+  for (const auto &[index, partial_sum] : std::views::enumerate (partial_sums_))
+    {
+      if (!partial_sum)
+        {
+          partial_sum =
+            std::make_unique<PartialSum> (*this, static_cast<size_t> (index));
+        }
+      partial_sum->src_begin_ = static_cast<size_t> (index) * group_size;
+      partial_sum->src_end_ =
+        std::min (partial_sum->src_begin_ + group_size, srcs_.size ());
+      partial_sum->buf_.resize (max_block_length);
+    }
+}
+
+AudioPort::PartialSum *
+AudioPort::get_partial_sum_for_source (const Port &src) const
+{
+  const auto it = std::ranges::find (srcs_, &src);
+  if (it == srcs_.end ())
+    return nullptr;
+
+  const auto index = static_cast<size_t> (std::distance (srcs_.begin (), it));
+  for (const auto &partial_sum : partial_sums_)
+    {
+      if (index >= partial_sum->src_begin_ && index < partial_sum->src_end_)
+        return partial_sum.get ();
+    }
+  return nullptr;
+}
+
+std::string
+AudioPort::PartialSum::get_node_name () const
+{
+  return fmt::format ("{} (partial sum {})", port_.get_node_name (), index_);
+}
+
+void
+AudioPort::PartialSum::process_block (const EngineProcessTimeInfo time_nfo)
+{
+  utils::float_ranges::fill (
+    &buf_[time_nfo.local_offset_], 0.f, time_nfo.nframes_);
+  bool summed_any = false;
+  port_.sum_source_range (
+    buf_.data (), time_nfo, src_begin_, src_end_, summed_any);
+  silent_ = !summed_any;
+}
+
+bool
+AudioPort::can_alias_source (const EngineProcessTimeInfo &time_nfo) const
+{
+  if (alias_src_ == nullptr)
+    return false;
+
+  const auto &conn = src_connections_.front ();
+  if (
+    !conn->enabled_
+    || !utils::math::floats_near (conn->multiplier_, 1.f, 0.00001f))
+    return false;
+
+  /* the source's signal is not in its buffer */
+  if (alias_src_->deferred_src_ != nullptr)
+    return false;
+
+  /* backend data gets summed into the buffer */
+  if (is_input () && owner_->should_sum_data_from_backend ())
+    return false;
+
+  /* the frames processed earlier in the cycle must be in the source buffer
+   * too */
+  if (time_nfo.local_offset_ > 0 && buf_.data () != alias_src_->buf_.data ())
+    return false;
+
+  /* fader inputs get clipped (see sum_sources()) */
+  if (
+    processing_info_.clip_sources_
+    && utils::float_ranges::abs_max (
+         &alias_src_->buf_[time_nfo.local_offset_], time_nfo.nframes_)
+         > 2.f)
+    return false;
+
+  return true;
+}
+
+void
+AudioPort::stop_aliasing (nframes_t num_frames_to_keep)
+{
+  utils::float_ranges::copy (
+    own_buf_.data (), buf_.data (), num_frames_to_keep);
+  utils::float_ranges::fill (
+    &own_buf_[num_frames_to_keep], DENORMAL_PREVENTION_VAL (AUDIO_ENGINE),
+    own_buf_.size () - num_frames_to_keep);
+  buf_ = own_buf_;
 }
 
 void
@@ -90,9 +274,74 @@ AudioPort::has_sound () const
   return false;
 }
 
+size_t
+AudioPort::get_memory_usage () const
+{
+  size_t ret = Port::get_memory_usage ();
+  for (const auto &slot : rendered_ahead_slots_)
+    {
+      ret += slot.capacity () * sizeof (float);
+    }
+  return ret;
+}
+
+float *
+AudioPort::get_backend_buffer_to_use (const EngineProcessTimeInfo &time_nfo)
+{
+  if (!backend_ || !backend_->is_exposed ())
+    return nullptr;
+
+  /* inputs can only use the backend's data as is if there is nothing to add
+   * to it */
+  if (
+    is_input ()
+    && (!owner_->should_sum_data_from_backend () || !srcs_.empty ()))
+    return nullptr;
+
+  auto * backend_buf =
+    backend_->get_audio_buffer_for_cycle (AUDIO_ENGINE->block_length_);
+
+  /* the frames processed earlier in the cycle must be in the backend's buffer
+   * too */
+  if (time_nfo.local_offset_ > 0 && buf_.data () != backend_buf)
+    return nullptr;
+
+  return backend_buf;
+}
+
 void
 AudioPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
 {
+  if (!noroll && can_alias_source (time_nfo))
+    {
+      /* use the source's buffer as is instead of copying it */
+      buf_ = alias_src_->buf_;
+      finish_processing (time_nfo);
+      return;
+    }
+  if (!noroll)
+    {
+      if (auto * backend_buf = get_backend_buffer_to_use (time_nfo))
+        {
+          /* use the backend's buffer directly instead of copying from/to it */
+          buf_ = { backend_buf, AUDIO_ENGINE->block_length_ };
+          if (is_input ())
+            {
+              finish_processing (time_nfo);
+              return;
+            }
+
+          utils::float_ranges::fill (
+            &buf_[time_nfo.local_offset_],
+            DENORMAL_PREVENTION_VAL (AUDIO_ENGINE), time_nfo.nframes_);
+          const float peak = sum_sources (buf_.data (), time_nfo);
+          finish_processing (time_nfo, peak);
+          return;
+        }
+    }
+  if (is_buffer_aliased ())
+    stop_aliasing (time_nfo.local_offset_);
+
   if (noroll)
     {
       utils::float_ranges::fill (
@@ -101,11 +350,6 @@ AudioPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
       return;
     }
 
-  const auto &id = id_;
-  const auto  owner_type = id->owner_type_;
-
-  const bool is_stereo = is_stereo_port ();
-
   if (is_input () && owner_->should_sum_data_from_backend ())
     {
       if (backend_ && backend_->is_exposed ())
@@ -123,51 +367,147 @@ AudioPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
         }
     }
 
-  for (const auto &[src_port, conn] : std::views::zip (srcs_, src_connections_))
+  const float peak = sum_sources (buf_.data (), time_nfo);
+  finish_processing (time_nfo, peak);
+}
+
+float
+AudioPort::sum_sources (float * dest, const EngineProcessTimeInfo &time_nfo)
+  const
+{
+  /* the sources were summed by the partial sums in parallel */
+  if (!partial_sums_.empty ())
+    {
+      for (const auto &partial_sum : partial_sums_)
+        {
+          if (partial_sum->silent_)
+            continue;
+
+          utils::float_ranges::add2 (
+            &dest[time_nfo.local_offset_],
+            &partial_sum->buf_[time_nfo.local_offset_], time_nfo.nframes_);
+        }
+      return -1.f;
+    }
+
+  bool summed_any = false;
+  return sum_source_range (dest, time_nfo, 0, srcs_.size (), summed_any);
+}
+
+float
+AudioPort::sum_source_range (
+  float *                      dest,
+  const EngineProcessTimeInfo &time_nfo,
+  const size_t                 begin,
+  const size_t                 end,
+  bool                        &summed_any) const
+{
+  /* when bouncing, some buffers are written to after their ports are
+   * processed, so the silence flags can't be trusted */
+  const bool skip_silent_srcs =
+    AUDIO_ENGINE->bounce_mode_ == BounceMode::BOUNCE_OFF;
+
+  float peak = -1.f;
+
+  for (
+    const auto &[src_port, conn] :
+    std::views::zip (srcs_, src_connections_)
+      | std::views::take (end) | std::views::drop (begin))
     {
       if (!conn->enabled_)
         continue;
 
-      const float multiplier = conn->multiplier_;
+      /* nothing to add */
+      if (
+        skip_silent_srcs && src_port->is_audio ()
+        && static_cast<const AudioPort *> (src_port)->silent_)
+        continue;
 
-      /* sum the signals */
-      if (utils::math::floats_near (multiplier, 1.f, 0.00001f)) [[likely]]
-        {
-          utils::float_ranges::add2 (
-            &buf_[time_nfo.local_offset_],
-            &src_port->buf_[time_nfo.local_offset_], time_nfo.nframes_);
-        }
-      else
+      summed_any = true;
+
+      /* mix the signal of sources that don't write it to their buffer
+       * straight from where it is (see set_deferred_signal()) */
+      const Port * signal_port = src_port;
+      float        multiplier = conn->multiplier_;
+      if (src_port->is_audio ())
         {
-          utils::float_ranges::mix_product (
-            &buf_[time_nfo.local_offset_],
-            &src_port->buf_[time_nfo.local_offset_], multiplier,
-            time_nfo.nframes_);
+          const auto * audio_src = static_cast<const AudioPort *> (src_port);
+          if (audio_src->deferred_src_ != nullptr)
+            {
+              signal_port = audio_src->deferred_src_;
+              multiplier *= audio_src->deferred_gain_;
+            }
         }
 
-      if (owner_type == PortIdentifier::OwnerType::Fader)
+      const bool is_unity =
+        utils::math::floats_near (multiplier, 1.f, 0.00001f);
+      float *       dest_frames = &dest[time_nfo.local_offset_];
+      const float * src_frames = &signal_port->buf_[time_nfo.local_offset_];
+      const auto    nframes = time_nfo.nframes_;
+
+      /* sum the signals, clipping fader inputs to [-2, 2] and tracking the
+       * peak of metered ports in the same pass */
+      if (processing_info_.clip_sources_)
         {
           constexpr float minf = -2.f;
           constexpr float maxf = 2.f;
-          float           abs_peak = utils::float_ranges::abs_max (
-            &buf_[time_nfo.local_offset_], time_nfo.nframes_);
-          if (abs_peak > maxf)
+          if (is_unity) [[likely]]
             {
-              /* this limiting wastes around 50% of port processing so only
-               * do it on CV connections and faders if they exceed maxf */
-              utils::float_ranges::clip (
-                &buf_[time_nfo.local_offset_], minf, maxf, time_nfo.nframes_);
+              utils::float_ranges::add2_clamped (
+                dest_frames, src_frames, minf, maxf, nframes);
+            }
+          else
+            {
+              utils::float_ranges::mix_product_clamped (
+                dest_frames, src_frames, multiplier, minf, maxf, nframes);
             }
         }
+      else if (processing_info_.update_peak_)
+        {
+          peak =
+            is_unity
+              ? utils::float_ranges::add2_with_peak (
+                  dest_frames, src_frames, nframes)
+              : utils::float_ranges::mix_product_with_peak (
+                  dest_frames, src_frames, multiplier, nframes);
+        }
+      else if (is_unity) [[likely]]
+        {
+          utils::float_ranges::add2 (dest_frames, src_frames, nframes);
+        }
+      else
+        {
+          utils::float_ranges::mix_product (
+            dest_frames, src_frames, multiplier, nframes);
+        }
     }
 
-  if (is_output () && backend_ && backend_->is_exposed ())
+  return peak;
+}
+
+void
+AudioPort::finish_processing (
+  const EngineProcessTimeInfo &time_nfo,
+  float                        known_peak)
+{
+  silent_ =
+    silent_
+    && utils::float_ranges::is_silent (
+      &buf_[time_nfo.local_offset_], time_nfo.nframes_, SILENCE_THRESHOLD);
+
+  if (
+    is_output () && backend_ && backend_->is_exposed ()
+    && buf_.data ()
+         != backend_->get_audio_buffer_for_cycle (AUDIO_ENGINE->block_length_))
     {
       backend_->send_data (
         buf_.data (), { time_nfo.local_offset_, time_nfo.nframes_ });
     }
 
-  if (time_nfo.local_offset_ + time_nfo.nframes_ == AUDIO_ENGINE->block_length_)
+  if (
+    has_ring_buffer_subscribers ()
+    && time_nfo.local_offset_ + time_nfo.nframes_
+         == AUDIO_ENGINE->block_length_)
     {
       // z_debug ("writing to ring for {}", get_label ());
       audio_ring_->force_write_multiple (
@@ -175,49 +515,84 @@ AudioPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
     }
 
   /* if track output (to be shown on mixer) */
-  if (
-    owner_type == PortIdentifier::OwnerType::Channel && is_stereo
-    && is_output ())
+  if (processing_info_.update_peak_)
     {
       /* calculate meter values */
       /* reset peak if needed */
-      auto time_now = Zrythm::getInstance ()->get_monotonic_time_usecs ();
+      const auto time_now = time_nfo.cycle_start_time_usecs_;
       if (time_now - peak_timestamp_ > TIME_TO_RESET_PEAK)
         peak_ = -1.f;
 
-      bool changed = utils::float_ranges::abs_max_with_existing_peak (
-        &buf_[time_nfo.local_offset_], &peak_, time_nfo.nframes_);
-      if (changed)
+      if (silent_)
         {
-          peak_timestamp_ = Zrythm::getInstance ()->get_monotonic_time_usecs ();
+          /* no need to scan */
+          peak_ = std::max (peak_, 0.f);
         }
+      else
+        {
+          bool changed = false;
+          if (known_peak >= 0.f)
+            {
+              changed = !utils::math::floats_equal (known_peak, peak_);
+              peak_ = known_peak;
+            }
+          else
+            {
+              changed = utils::float_ranges::abs_max_with_existing_peak (
+                &buf_[time_nfo.local_offset_], &peak_, time_nfo.nframes_);
+            }
+          if (changed)
+            {
+              peak_timestamp_ = time_now;
+            }
+        }
+    }
+
+  if (AUDIO_ENGINE->bounce_mode_ > BounceMode::BOUNCE_OFF) [[unlikely]]
+    {
+      process_bouncing (time_nfo);
     }
+}
 
+void
+AudioPort::process_bouncing (const EngineProcessTimeInfo &time_nfo)
+{
   /* if bouncing tracks directly to master (e.g., when bouncing the track on
    * its own without parents), clear master input */
-  auto master_processor_stereo_ins = std::pair (
-    *P_MASTER_TRACK->processor_->stereo_in_left_id_,
-    *P_MASTER_TRACK->processor_->stereo_in_right_id_);
-  if (AUDIO_ENGINE->bounce_mode_ > BounceMode::BOUNCE_OFF && !AUDIO_ENGINE->bounce_with_parents_ &&
-    (get_uuid() == master_processor_stereo_ins.first
-    || get_uuid() == master_processor_stereo_ins.second)) [[unlikely]]
+  if (
+    !AUDIO_ENGINE->bounce_with_parents_
+    && processing_info_.is_master_stereo_input_)
     {
+      make_buffer_writable ();
       utils::float_ranges::fill (
         &buf_[time_nfo.local_offset_], AUDIO_ENGINE->denormal_prevention_val_,
         time_nfo.nframes_);
     }
 
   /* if bouncing directly to master (e.g., when bouncing a track on
-   * its own without parents), add the buffer to master output */
+   * its own without parents), add the buffer to master output (or to the
+   * track's stem when rendering several stems at once) */
   if (
-    AUDIO_ENGINE->bounce_mode_ > BounceMode::BOUNCE_OFF && is_stereo
-    && is_output ()
-    && owner_->should_bounce_to_master (AUDIO_ENGINE->bounce_step_)) [[unlikely]]
+    processing_info_.is_stereo_output_
+    && owner_->should_bounce_to_master (AUDIO_ENGINE->bounce_step_))
     {
+      if (auto * tap = owner_->get_bounce_tap ())
+        {
+          const int channel =
+            ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::StereoL)
+              ? 0
+              : 1;
+          utils::float_ranges::add2 (
+            tap->getWritePointer (channel, (int) time_nfo.local_offset_),
+            &this->buf_[time_nfo.local_offset_], time_nfo.nframes_);
+          return;
+        }
+
       auto &dest =
         ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::StereoL)
           ? P_MASTER_TRACK->channel_->get_stereo_out_ports ().first
           : P_MASTER_TRACK->channel_->get_stereo_out_ports ().second;
+      dest.make_buffer_writable ();
       utils::float_ranges::add2 (
         &dest.buf_[time_nfo.local_offset_], &this->buf_[time_nfo.local_offset_],
         time_nfo.nframes_);
@@ -232,6 +607,7 @@ AudioPort::apply_pan (
   nframes_t                 start_frame,
   const nframes_t           nframes)
 {
+  make_buffer_writable ();
   auto [calc_r, calc_l] = dsp::calculate_panning (pan_law, pan_algo, pan);
 
   /* if stereo R */
@@ -249,6 +625,7 @@ AudioPort::apply_pan (
 void
 AudioPort::apply_fader (float amp, nframes_t start_frame, const nframes_t nframes)
 {
+  make_buffer_writable ();
   utils::float_ranges::mul_k2 (&buf_[start_frame], amp, nframes);
 }
 
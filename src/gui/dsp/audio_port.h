@@ -35,8 +35,33 @@ public:
 
   bool has_sound () const override;
 
+  size_t get_memory_usage () const override;
+
   static constexpr size_t AUDIO_RING_SIZE = 65536;
 
+  /**
+   * @brief Samples within ±this value are considered silent (-140 dBFS).
+   */
+  static constexpr float SILENCE_THRESHOLD = 1e-7f;
+
+  /**
+   * @brief Ports with at least this many sources sum them in partial sums
+   * (see PartialSum).
+   */
+  static constexpr size_t MIN_SOURCES_FOR_PARTIAL_SUMS = 8;
+
+  class PartialSum;
+
+  /**
+   * @brief Returns whether the buffer has been silent in this cycle so far.
+   *
+   * The buffer is marked as silent when cleared at the start of the cycle and
+   * checked each time the port is processed, so this is only reliable for
+   * ports that are processed as part of the graph, once the port's node has
+   * run.
+   */
+  bool is_silent () const { return silent_; }
+
   /**
    * @brief Applies the fader to the audio buffer.
    *
@@ -74,12 +99,104 @@ public:
    */
   void reset_peak () { peak_ = 0.f; }
 
+  /**
+   * @brief Sums the sources into the buffer.
+   *
+   * When the only source is connected as is (enabled with a multiplier of 1),
+   * the buffer points to the source's buffer for the cycle instead (see
+   * update_processing_info()). Ports exposed to a backend that supports it
+   * (JACK) use the backend's buffer for the cycle instead of copying from/to
+   * it.
+   */
   void process (EngineProcessTimeInfo time_nfo, bool noroll) override;
 
+  /**
+   * @brief Caches what process() needs to know about the port's role and
+   * sources so that it isn't looked up in every cycle.
+   *
+   * Decides whether the buffer may alias the buffer of the port's source and
+   * which of the optional processing steps (clipping, metering, bouncing)
+   * apply to the port.
+   *
+   * Ports with many sources also get their partial sums (see PartialSum),
+   * which are kept when their number doesn't change so that the graph nodes
+   * for them stay the same.
+   *
+   * To be called when building the graph, after the sources are set.
+   */
+  void update_processing_info ();
+
+  /**
+   * @brief Returns the partial sums the sources are summed in, if any.
+   *
+   * Each must be added to the graph between its sources and the port.
+   */
+  const auto &get_partial_sums () const { return partial_sums_; }
+
+  /**
+   * @brief Returns the partial sum that @p src is summed in, or nullptr if
+   * @p src is summed directly (or not a source).
+   */
+  PartialSum * get_partial_sum_for_source (const Port &src) const;
+
+  /**
+   * @brief Gives the port a copy of the buffer of its own if it currently
+   * aliases its source's buffer.
+   *
+   * Must be called before modifying the buffer in place from outside
+   * process().
+   */
+  void make_buffer_writable ()
+  {
+    if (is_buffer_aliased ())
+      stop_aliasing (own_buf_.size ());
+  }
+
+  /**
+   * @brief Makes the port's signal @p src scaled by @p gain, without writing
+   * it to the buffer.
+   *
+   * The destinations mix @p src into their own buffers directly (see
+   * sum_sources()), which saves writing and reading this port's buffer (used
+   * by sends). Only valid while nothing else reads the buffer, until the
+   * buffer is cleared or clear_deferred_signal() is called.
+   *
+   * @p src must be processed before the destinations.
+   */
+  void set_deferred_signal (const AudioPort &src, float gain)
+  {
+    deferred_src_ = &src;
+    deferred_gain_ = gain;
+    silent_ = src.silent_;
+  }
+
+  void clear_deferred_signal () { deferred_src_ = nullptr; }
+
   void allocate_bufs () override;
 
   void clear_buffer (AudioEngine &engine) override;
 
+  void clear_rendered_ahead_buffers () override;
+
+  bool can_store_rendered_ahead_output () const override { return true; }
+
+  void
+  allocate_rendered_ahead_slots (size_t num_slots, nframes_t block_length)
+    override;
+
+  /**
+   * @brief Sums the sources into the slot instead of the buffer, as the buffer
+   * is still used by the realtime threads.
+   */
+  void
+  render_ahead_into_slot (size_t slot, EngineProcessTimeInfo time_nfo) override;
+
+  /**
+   * @brief Copies the slot into the buffer, then does what process() does
+   * after summing the sources (backend, ring buffer, meters, bouncing).
+   */
+  void restore_from_slot (size_t slot, EngineProcessTimeInfo time_nfo) override;
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
   bool is_stereo_port () const
@@ -98,12 +215,164 @@ private:
    */
   void sum_data_from_dummy (nframes_t start_frame, nframes_t nframes);
 
+  void clear_buffer_unconditionally (const AudioEngine &engine);
+
+  /**
+   * @brief Returns whether the buffer can alias @ref alias_src_ for the given
+   * part of the cycle.
+   */
+  [[gnu::hot]] bool
+  can_alias_source (const EngineProcessTimeInfo &time_nfo) const;
+
+  /**
+   * @brief Returns the backend's buffer if the port can use it directly as its
+   * buffer for the given part of the cycle, or nullptr.
+   *
+   * Exposed inputs with no sources use the backend's input data as is, and
+   * exposed outputs sum their sources straight into the backend's output.
+   */
+  [[gnu::hot]] float *
+  get_backend_buffer_to_use (const EngineProcessTimeInfo &time_nfo);
+
+  /**
+   * @brief Points the buffer back to the port's own buffer.
+   *
+   * @param num_frames_to_keep Number of frames (from the start of the cycle)
+   * to copy from the aliased buffer. The rest is cleared.
+   */
+  void stop_aliasing (nframes_t num_frames_to_keep);
+
+  /**
+   * @brief Sums the enabled source connections (or the partial sums, if any)
+   * into @p dest (which starts at frame 0 of the cycle).
+   *
+   * @return The absolute peak of @p dest in the processed range if the port
+   * tracks its peak and any source was summed, or a negative value otherwise.
+   */
+  [[gnu::hot]] float
+  sum_sources (float * dest, const EngineProcessTimeInfo &time_nfo) const;
+
+  /**
+   * @brief Sums the enabled connections of the sources in [@p begin, @p end)
+   * into @p dest.
+   *
+   * @param[out] summed_any Whether any source was summed.
+   * @return See sum_sources().
+   */
+  [[gnu::hot]] float sum_source_range (
+    float *                      dest,
+    const EngineProcessTimeInfo &time_nfo,
+    size_t                       begin,
+    size_t                       end,
+    bool                        &summed_any) const;
+
+  /**
+   * @brief Second half of process(), once the buffer has its final contents.
+   *
+   * @param known_peak The absolute peak of the buffer in the processed range,
+   * if already known (see sum_sources()), or a negative value.
+   */
+  [[gnu::hot]] void finish_processing (
+    const EngineProcessTimeInfo &time_nfo,
+    float                        known_peak = -1.f);
+
+  /**
+   * @brief Part of finish_processing() that only applies while bouncing.
+   */
+  void process_bouncing (const EngineProcessTimeInfo &time_nfo);
+
 private:
+  /**
+   * @brief Role of the port in processing, cached by update_processing_info().
+   */
+  struct ProcessingInfo
+  {
+    /** Whether the sum of the sources gets clipped (fader ports). */
+    bool clip_sources_ = false;
+
+    /** Whether the peak is tracked (channel stereo outputs). */
+    bool update_peak_ = false;
+
+    /** Whether the port is a stereo output (bounced directly to master). */
+    bool is_stereo_output_ = false;
+
+    /**
+     * Whether the port is a stereo input of the master track processor
+     * (cleared when bouncing without parents).
+     */
+    bool is_master_stereo_input_ = false;
+  };
+
   /** Max amplitude during processing (fabsf). */
   float peak_ = 0.f;
 
   /** Last time @ref peak_ was set. */
   qint64 peak_timestamp_ = 0;
+
+  /** See is_silent(). */
+  bool silent_ = false;
+
+  /**
+   * @brief The only source, if the buffer may alias its buffer.
+   *
+   * @see update_processing_info().
+   */
+  const AudioPort * alias_src_ = nullptr;
+
+  /* see set_deferred_signal() */
+  const AudioPort * deferred_src_ = nullptr;
+  float             deferred_gain_ = 1.f;
+
+  ProcessingInfo processing_info_;
+
+  /** See get_partial_sums(). */
+  std::vector<std::unique_ptr<PartialSum>> partial_sums_;
+
+  /** Blocks rendered ahead (see render_ahead_into_slot()). */
+  std::vector<std::vector<float>> rendered_ahead_slots_;
+};
+
+/**
+ * @brief Sum of a group of the sources of an AudioPort, processed as a
+ * separate graph node.
+ *
+ * Summing many sources (e.g., in the inputs of group tracks and the master
+ * track) in the port would make it wait for all of them and then do all the
+ * work on a single thread. Instead, the sources are split into groups that
+ * are each summed as soon as their sources are processed, in parallel, and
+ * the port only sums the groups.
+ *
+ * Only used for ports that don't clip their sources or track their peak.
+ */
+class AudioPort::PartialSum final : public dsp::IProcessable
+{
+public:
+  PartialSum (const AudioPort &port, size_t index)
+      : port_ (port), index_ (index)
+  {
+  }
+
+  std::string get_node_name () const override;
+
+  /** The output only depends on the sources. */
+  bool can_render_ahead () const override { return true; }
+
+  void process_block (EngineProcessTimeInfo time_nfo) override;
+
+private:
+  friend class AudioPort;
+
+  const AudioPort &port_;
+  size_t           index_ = 0;
+
+  /** The port's sources summed here (indices in Port::srcs_). */
+  size_t src_begin_ = 0;
+  size_t src_end_ = 0;
+
+  std::vector<float> buf_;
+
+  /** Whether nothing was summed in the last processed part of the cycle. */
+  bool silent_ = true;
 };
 
 /**
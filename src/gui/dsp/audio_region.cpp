@@ -1,10 +1,15 @@
 // SPDX-FileCopyrightText: © 2018-2022, 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <array>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
+#include "dsp/stretcher.h"
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/settings_manager.h"
+#include "gui/backend/backend/zrythm.h"
 #include "gui/dsp/audio_region.h"
 #include "gui/dsp/audio_track.h"
 #include "gui/dsp/clip.h"
@@ -15,6 +20,7 @@
 #include "utils/debug.h"
 #include "utils/dsp.h"
 #include "utils/flags.h"
+#include "utils/hash.h"
 #include "utils/logger.h"
 #include "utils/math.h"
 
@@ -25,8 +31,6 @@ using namespace zrythm;
 AudioRegion::AudioRegion (QObject * parent)
     : ArrangerObject (Type::Region), QObject (parent)
 {
-  ArrangerObject::parent_base_qproperties (*this);
-  BoundedObject::parent_base_qproperties (*this);
   init_colored_object ();
 }
 
@@ -131,7 +135,9 @@ AudioRegion::get_clip () const
       clip = clip_.get ();
     }
 
-  z_return_val_if_fail (clip && clip->get_num_frames () > 0, nullptr);
+  /* clips still loading in the background have no frames yet */
+  z_return_val_if_fail (
+    clip && (!clip->is_loaded () || clip->get_num_frames () > 0), nullptr);
 
   return clip;
 }
@@ -184,7 +190,7 @@ AudioRegion::replace_frames (
 
   clip->replace_frames (src_frames, start_frame);
 
-  AUDIO_POOL->write_clip (*clip, false, false);
+  AUDIO_POOL->write_clip (*clip, false);
 }
 
 void
@@ -200,15 +206,79 @@ AudioRegion::replace_frames_from_interleaved (
   replace_frames (buf, start_frame, duplicate_clip);
 }
 
+utils::audio::AudioBuffer
+AudioRegion::get_stretched_frames (double ratio) const
+{
+  AudioClip * clip = get_clip ();
+  z_return_val_if_fail (clip, {});
+
+  const auto num_channels = clip->get_num_channels ();
+  auto       stretcher = dsp::Stretcher::create_rubberband (
+    AUDIO_ENGINE->sample_rate_, num_channels, ratio, 1.0, false);
+
+  auto buf = clip->get_samples ();
+  buf.interleave_samples ();
+  auto stretched_buf = stretcher->stretch_interleaved (buf);
+  if (stretched_buf.getNumSamples () == 0)
+    {
+      throw ZrythmException ("Failed to stretch frames");
+    }
+  stretched_buf.deinterleave_samples (num_channels);
+  return stretched_buf;
+}
+
+void
+AudioRegion::apply_stretched_frames (const utils::audio::AudioBuffer &frames)
+{
+  AudioClip * clip = get_clip ();
+  z_return_if_fail (clip);
+
+  int new_clip_id = AUDIO_POOL->duplicate_clip (clip->get_pool_id (), false);
+  if (new_clip_id < 0)
+    {
+      throw ZrythmException (QObject::tr ("Failed to duplicate audio clip"));
+    }
+  auto * new_clip = AUDIO_POOL->get_clip (new_clip_id);
+  set_clip_id (new_clip->get_pool_id ());
+
+  new_clip->clear_frames ();
+  new_clip->expand_with_frames (frames);
+  auto num_frames_per_channel = new_clip->get_num_frames ();
+  z_return_if_fail (num_frames_per_channel > 0);
+
+  AUDIO_POOL->write_clip (*new_clip, false);
+
+  /* readjust end position to match the number of frames exactly */
+  dsp::Position new_end_pos (
+    static_cast<signed_frame_t> (num_frames_per_channel),
+    AUDIO_ENGINE->ticks_per_frame_);
+  set_position (&new_end_pos, ArrangerObject::PositionType::LoopEnd, false);
+  new_end_pos.add_frames (pos_->frames_, AUDIO_ENGINE->ticks_per_frame_);
+  set_position (&new_end_pos, ArrangerObject::PositionType::End, false);
+}
+
 void
 AudioRegion::fill_stereo_ports (
   const EngineProcessTimeInfo        &time_nfo,
-  std::pair<AudioPort &, AudioPort &> stereo_ports) const
+  std::pair<AudioPort &, AudioPort &> stereo_ports,
+  ScratchBuffers                     &scratch) const
 {
   AudioClip * clip = get_clip ();
   z_return_if_fail (clip);
   auto * track = std::get<AudioTrack *> (get_track ());
 
+  /* silent until the clip is loaded */
+  if (!clip->is_loaded ()) [[unlikely]]
+    {
+      utils::float_ranges::fill (
+        &stereo_ports.first.buf_[time_nfo.local_offset_],
+        DENORMAL_PREVENTION_VAL (AUDIO_ENGINE), time_nfo.nframes_);
+      utils::float_ranges::fill (
+        &stereo_ports.second.buf_[time_nfo.local_offset_],
+        DENORMAL_PREVENTION_VAL (AUDIO_ENGINE), time_nfo.nframes_);
+      return;
+    }
+
   /* if timestretching in the timeline, skip processing */
 #if 0
   if (
@@ -234,8 +304,10 @@ AudioRegion::fill_stereo_ports (
   bpm_t  cur_bpm = P_TEMPO_TRACK->get_bpm_at_pos (g_start_pos);
   double timestretch_ratio = 1.0;
   bool   needs_rt_timestretch = false;
+  /* TODO: support timestretching streaming clips (the stretcher reads
+   * directly from the clip's frames) */
   if (
-    get_musical_mode ()
+    get_musical_mode () && !clip->is_streaming ()
     && !utils::math::floats_equal (clip->get_bpm (), cur_bpm))
     {
       needs_rt_timestretch = true;
@@ -245,9 +317,27 @@ AudioRegion::fill_stereo_ports (
         (double) clip->get_bpm (), timestretch_ratio);
     }
 
+  /* prefer the frames stretched in the background if they are ready (their
+   * frames correspond to the region's local frames) */
+  std::optional<dsp::TimestretchCache::Key> stretched_key;
+  if (needs_rt_timestretch)
+    {
+      stretched_key = get_timestretch_key (cur_bpm);
+      if (
+        stretched_key && gZrythm->timestretch_cache_
+        && gZrythm->timestretch_cache_->get_num_frames (*stretched_key))
+        {
+          needs_rt_timestretch = false;
+        }
+      else
+        {
+          stretched_key.reset ();
+        }
+    }
+
   /* buffers after timestretch */
-  auto lbuf_after_ts = tmp_bufs_[0].data ();
-  auto rbuf_after_ts = tmp_bufs_[1].data ();
+  auto lbuf_after_ts = scratch[0].data ();
+  auto rbuf_after_ts = scratch[1].data ();
   utils::float_ranges::fill (lbuf_after_ts, 0, time_nfo.nframes_);
   utils::float_ranges::fill (rbuf_after_ts, 0, time_nfo.nframes_);
 
@@ -283,7 +373,49 @@ AudioRegion::fill_stereo_ports (
     &r_local_pos_at_start, &r_local_pos_at_end);
 #endif
 
-  const auto &clip_frames = clip->get_samples ();
+  /* let streaming clips prefetch where playback may jump to */
+  if (clip->is_streaming ())
+    {
+      clip->add_stream_hint ((unsigned_frame_t) clip_start_pos_.frames_);
+      clip->add_stream_hint ((unsigned_frame_t) loop_start_pos_.frames_);
+      for (
+        const auto * transport_pos :
+        { TRANSPORT->loop_start_pos_, TRANSPORT->cue_pos_ })
+        {
+          const auto transport_frames = transport_pos->getFrames ();
+          if (
+            transport_frames >= pos_->frames_
+            && transport_frames < end_pos_->frames_)
+            {
+              clip->add_stream_hint ((unsigned_frame_t) timeline_frames_to_local (
+                transport_frames, F_NORMALIZE));
+            }
+        }
+    }
+
+  /* consecutive clip frames to copy when not timestretching in realtime */
+  unsigned_frame_t run_start_j = 0;
+  signed_frame_t   run_start_buff_index = 0;
+  unsigned_frame_t run_length = 0;
+  const auto       flush_run = [&] () {
+    if (run_length == 0)
+      return;
+    if (stretched_key)
+      {
+        /* frames past the end (due to rounding) are silent */
+        gZrythm->timestretch_cache_->read (
+          *stretched_key, (unsigned_frame_t) run_start_buff_index,
+          &lbuf_after_ts[run_start_j], &rbuf_after_ts[run_start_j],
+          run_length);
+      }
+    else
+      {
+        clip->read_frames (
+          (unsigned_frame_t) run_start_buff_index, &lbuf_after_ts[run_start_j],
+          &rbuf_after_ts[run_start_j], run_length);
+      }
+    run_length = 0;
+  };
 
   size_t    buff_index_start = (size_t) clip->get_num_frames () + 16;
   size_t    buff_size = 0;
@@ -356,7 +488,9 @@ AudioRegion::fill_stereo_ports (
       else
         {
           z_return_if_fail_cmp (buff_index, >=, 0);
-          if (buff_index >= (decltype (buff_index)) clip->get_num_frames ())
+          if (
+            !stretched_key
+            && buff_index >= (decltype (buff_index)) clip->get_num_frames ())
             [[unlikely]]
             {
               z_error (
@@ -365,13 +499,19 @@ AudioRegion::fill_stereo_ports (
                 buff_index, clip->get_num_frames (), clip->get_name ());
               return;
             }
-          lbuf_after_ts[j] = clip_frames.getSample (0, buff_index);
-          rbuf_after_ts[j] =
-            clip->get_num_channels () == 1
-              ? clip_frames.getSample (0, buff_index)
-              : clip_frames.getSample (1, buff_index);
+          if (
+            run_length == 0
+            || buff_index
+                 != run_start_buff_index + (signed_frame_t) run_length)
+            {
+              flush_run ();
+              run_start_j = j;
+              run_start_buff_index = buff_index;
+            }
+          run_length++;
         }
     }
+  flush_run ();
 
   /* apply gain */
   if (!utils::math::floats_equal (gain_, 1.f))
@@ -388,10 +528,67 @@ AudioRegion::fill_stereo_ports (
     &stereo_ports.second.buf_[time_nfo.local_offset_], &rbuf_after_ts[0],
     time_nfo.nframes_);
 
-  /* apply fades */
-  const signed_frame_t num_frames_in_fade_in_area = fade_in_pos_.frames_;
-  const signed_frame_t num_frames_in_fade_out_area =
-    end_pos_->frames_ - (fade_out_pos_.frames_ + pos_->frames_);
+  /* apply object fades */
+  const signed_frame_t block_start_local_frame =
+    (signed_frame_t) time_nfo.g_start_frame_w_offset_ - pos_->frames_;
+  const auto apply_object_fade = [&] (
+                                   const dsp::CurveOptions &opts,
+                                   const FadeTable *        table,
+                                   signed_frame_t           fade_start_frame,
+                                   signed_frame_t           num_fade_frames,
+                                   bool                     fade_in) {
+    /* frames of the fade in this block, local to region start */
+    const signed_frame_t start_frame =
+      std::max (fade_start_frame, block_start_local_frame);
+    const signed_frame_t end_frame = std::min (
+      fade_start_frame + num_fade_frames,
+      block_start_local_frame + (signed_frame_t) time_nfo.nframes_);
+    if (start_frame >= end_frame)
+      return;
+
+    const auto cycle_offset =
+      time_nfo.local_offset_ + (start_frame - block_start_local_frame);
+    float * lbuf = &stereo_ports.first.buf_[cycle_offset];
+    float * rbuf = &stereo_ports.second.buf_[cycle_offset];
+    if (table != nullptr) [[likely]]
+      {
+        const float * gains = &table->gains_[start_frame - fade_start_frame];
+        const auto    num_frames = (size_t) (end_frame - start_frame);
+        utils::float_ranges::mul2 (lbuf, gains, num_frames);
+        utils::float_ranges::mul2 (rbuf, gains, num_frames);
+        return;
+      }
+
+    /* not precomputed (e.g., very long fade) */
+    constexpr signed_frame_t      chunk_size = 256;
+    std::array<float, chunk_size> gains;
+    const double                  x_step = 1.0 / (double) num_fade_frames;
+    for (signed_frame_t frame = start_frame; frame < end_frame;
+         frame += chunk_size)
+      {
+        const auto num_frames =
+          (size_t) std::min (chunk_size, end_frame - frame);
+        opts.get_normalized_ys_for_fade (
+          gains.data (), (double) (frame - fade_start_frame) * x_step, x_step,
+          num_frames, fade_in);
+        const auto cycle_frame =
+          time_nfo.local_offset_ + (frame - block_start_local_frame);
+        float * lbuf = &stereo_ports.first.buf_[cycle_frame];
+        float * rbuf = &stereo_ports.second.buf_[cycle_frame];
+        for (size_t i = 0; i < num_frames; i++)
+          {
+            lbuf[i] *= gains[i];
+            rbuf[i] *= gains[i];
+          }
+      }
+  };
+  apply_object_fade (
+    fade_in_opts_, get_fade_in_table (), 0, get_fade_in_frames (), true);
+  apply_object_fade (
+    fade_out_opts_, get_fade_out_table (), fade_out_pos_.frames_,
+    get_fade_out_frames (), false);
+
+  /* apply builtin fades */
   const signed_frame_t local_builtin_fade_out_start_frames =
     end_pos_->frames_ - (AUDIO_REGION_BUILTIN_FADE_FRAMES + pos_->frames_);
   for (nframes_t j = 0; j < time_nfo.nframes_; j++)
@@ -402,51 +599,16 @@ AudioRegion::fill_stereo_ports (
       const signed_frame_t current_local_frame =
         (signed_frame_t) (time_nfo.g_start_frame_w_offset_ + j) - pos_->frames_;
 
-      /* skip to fade out (or builtin fade out) if not in any fade area */
+      /* skip to builtin fade out if not in any fade area */
       if (
-        current_local_frame >= std::max (
-          fade_in_pos_.frames_,
-          static_cast<decltype (fade_in_pos_.frames_)> (
-            AUDIO_REGION_BUILTIN_FADE_FRAMES))
-        && current_local_frame < std::min (
-             fade_out_pos_.frames_, local_builtin_fade_out_start_frames))
-        [[likely]]
+        current_local_frame >= AUDIO_REGION_BUILTIN_FADE_FRAMES
+        && current_local_frame < local_builtin_fade_out_start_frames) [[likely]]
         {
-          j +=
-            std::min (fade_out_pos_.frames_, local_builtin_fade_out_start_frames)
-            - current_local_frame;
+          j += local_builtin_fade_out_start_frames - current_local_frame;
           j--;
           continue;
         }
 
-      /* if inside object fade in */
-      if (
-        current_local_frame >= 0
-        && current_local_frame < num_frames_in_fade_in_area)
-        {
-          auto fade_in = (float) fade_in_opts_.get_normalized_y_for_fade (
-            (double) current_local_frame / (double) num_frames_in_fade_in_area,
-            true);
-
-          stereo_ports.first.buf_[current_cycle_frame] *= fade_in;
-          stereo_ports.second.buf_[current_cycle_frame] *= fade_in;
-        }
-      /* if inside object fade out */
-      if (current_local_frame >= fade_out_pos_.frames_)
-        {
-          z_return_if_fail_cmp (num_frames_in_fade_out_area, >, 0);
-          signed_frame_t num_frames_from_fade_out_start =
-            current_local_frame - fade_out_pos_.frames_;
-          z_return_if_fail_cmp (
-            num_frames_from_fade_out_start, <=, num_frames_in_fade_out_area);
-          auto fade_out = (float) fade_out_opts_.get_normalized_y_for_fade (
-            (double) num_frames_from_fade_out_start
-              / (double) num_frames_in_fade_out_area,
-            false);
-
-          stereo_ports.first.buf_[current_cycle_frame] *= fade_out;
-          stereo_ports.second.buf_[current_cycle_frame] *= fade_out;
-        }
       /* if inside builtin fade in, apply builtin fade in */
       if (
         current_local_frame >= 0
@@ -478,15 +640,171 @@ AudioRegion::fill_stereo_ports (
     }
 }
 
+namespace
+{
+/**
+ * Detected tempos by hash of the analysed audio, so that the tempo of the
+ * same audio (e.g., duplicated regions or the same loop imported many times)
+ * is only detected once.
+ */
+class BpmDetectionCache
+{
+public:
+  struct Result
+  {
+    float              bpm_ = 0.f;
+    std::vector<float> candidates_;
+  };
+
+  /** The cache is cleared when it grows larger than this. */
+  static constexpr size_t MAX_RESULTS = 1024;
+
+  static BpmDetectionCache &get_instance ()
+  {
+    static BpmDetectionCache cache;
+    return cache;
+  }
+
+  std::optional<Result> find (utils::hash::HashT hash) const
+  {
+    std::scoped_lock lock (mutex_);
+    auto             it = results_.find (hash);
+    if (it == results_.end ())
+      return std::nullopt;
+
+    return it->second;
+  }
+
+  void add (utils::hash::HashT hash, Result result)
+  {
+    std::scoped_lock lock (mutex_);
+    if (results_.size () >= MAX_RESULTS)
+      results_.clear ();
+
+    results_.insert_or_assign (hash, std::move (result));
+  }
+
+private:
+  std::unordered_map<utils::hash::HashT, Result> results_;
+  mutable std::mutex                             mutex_;
+};
+
+/**
+ * Returns the key of the clip's audio (at the given sample rate) in the
+ * BpmDetectionCache.
+ *
+ * The hash of the clip's pool file is used when it is up to date, so only
+ * clips not written to the pool need their samples hashed.
+ */
+utils::hash::HashT
+get_bpm_detection_key (const AudioClip &clip, unsigned int samplerate)
+{
+  std::unique_ptr<XXH3_state_t, decltype (&XXH3_freeState)> state (
+    XXH3_createState (), XXH3_freeState);
+  XXH3_64bits_reset (state.get ());
+  XXH3_64bits_update (state.get (), &samplerate, sizeof (samplerate));
+  if (clip.is_written_to_pool ())
+    {
+      const auto file_hash = clip.get_file_hash ();
+      XXH3_64bits_update (state.get (), &file_hash, sizeof (file_hash));
+    }
+  else
+    {
+      const auto &samples = clip.get_samples ();
+      for (int ch = 0; ch < samples.getNumChannels (); ++ch)
+        {
+          XXH3_64bits_update (
+            state.get (), samples.getReadPointer (ch),
+            static_cast<size_t> (samples.getNumSamples ()) * sizeof (float));
+        }
+    }
+  return XXH3_64bits_digest (state.get ());
+}
+}
+
 float
 AudioRegion::detect_bpm (std::vector<float> &candidates)
 {
   AudioClip * clip = get_clip ();
-  z_return_val_if_fail (clip, 0.f);
+  z_return_val_if_fail (clip && clip->is_loaded (), 0.f);
+
+  const auto samplerate = (unsigned int) AUDIO_ENGINE->sample_rate_;
+  auto      &cache = BpmDetectionCache::get_instance ();
+  const auto key = get_bpm_detection_key (*clip, samplerate);
+  if (auto result = cache.find (key))
+    {
+      candidates = std::move (result->candidates_);
+      return result->bpm_;
+    }
 
-  return utils::audio::detect_bpm (
-    clip->get_samples ().getReadPointer (0), (size_t) clip->get_num_frames (),
-    (unsigned int) AUDIO_ENGINE->sample_rate_, candidates);
+  /* detect on a mono mix-down of all the channels */
+  const auto                &samples = clip->get_samples ();
+  utils::audio::BpmDetector detector (samplerate);
+  detector.process (
+    samples.getArrayOfReadPointers (),
+    static_cast<size_t> (samples.getNumChannels ()),
+    static_cast<size_t> (samples.getNumSamples ()));
+  const float bpm = detector.detect (candidates);
+  cache.add (key, { bpm, candidates });
+
+  return bpm;
+}
+
+std::vector<AudioRegion::Position>
+AudioRegion::get_transient_positions (float min_strength) const
+{
+  std::vector<Position> ret;
+  const auto *          clip = get_clip ();
+  if (!clip)
+    return ret;
+
+  const auto onsets = clip->get_onsets ();
+  if (!onsets->is_computed ())
+    return ret;
+
+  /* clip frames are played this many times faster in musical mode */
+  double ratio = 1.0;
+  if (get_musical_mode () && !clip->is_streaming ())
+    {
+      const auto bpm = P_TEMPO_TRACK->get_bpm_at_pos (*pos_);
+      if (!utils::math::floats_equal (clip->get_bpm (), bpm))
+        ratio = (double) bpm / (double) clip->get_bpm ();
+    }
+
+  /* the clip is played from the clip start to the loop end, then repeats
+   * the loop until the end of the region */
+  const auto clip_start = clip_start_pos_.frames_;
+  const auto loop_start = loop_start_pos_.frames_;
+  const auto loop_end = loop_end_pos_.frames_;
+  const auto loop_length = loop_end - loop_start;
+  const auto length = get_length_in_frames ();
+  const auto add_onset = [&] (signed_frame_t local_frame) {
+    if (local_frame >= 0 && local_frame < length)
+      {
+        ret.emplace_back (
+          pos_->frames_ + local_frame, AUDIO_ENGINE->ticks_per_frame_);
+      }
+  };
+  for (
+    const auto &onset : onsets->get_onsets (
+      (int64_t) ((double) clip_start * ratio),
+      (int64_t) ((double) loop_end * ratio), min_strength))
+    {
+      const auto frame = (signed_frame_t) ((double) onset.frame_ / ratio);
+      add_onset (frame - clip_start);
+      if (frame < loop_start || loop_length <= 0)
+        continue;
+
+      for (
+        auto local_frame = (loop_end - clip_start) + (frame - loop_start);
+        local_frame < length; local_frame += loop_length)
+        {
+          add_onset (local_frame);
+        }
+    }
+
+  std::ranges::sort (ret);
+  return ret;
 }
 
 bool
@@ -509,12 +827,52 @@ AudioRegion::get_musical_mode () const
   z_return_val_if_reached (false);
 }
 
+std::optional<dsp::TimestretchCache::Key>
+AudioRegion::get_timestretch_key (bpm_t bpm) const
+{
+  const auto * clip = get_clip ();
+  if (
+    !clip || !get_musical_mode () || clip->get_file_hash () == 0
+    || utils::math::floats_equal (clip->get_bpm (), bpm))
+    return std::nullopt;
+
+  return dsp::TimestretchCache::Key{
+    clip->get_file_hash (), (double) bpm / (double) clip->get_bpm (),
+    AUDIO_ENGINE->sample_rate_
+  };
+}
+
+void
+AudioRegion::request_timestretch (bpm_t bpm) const
+{
+  if (!gZrythm || !gZrythm->timestretch_cache_)
+    return;
+
+  const auto key = get_timestretch_key (bpm);
+  if (!key)
+    return;
+
+  const auto * clip = get_clip ();
+  if (!clip->is_loaded ())
+    return;
+
+  auto frames = clip->get_shared_frames ();
+  if (!frames)
+    return;
+
+  gZrythm->timestretch_cache_->request (*key, std::move (frames));
+}
+
 bool
 AudioRegion::fix_positions (double frames_per_tick)
 {
   AudioClip * clip = get_clip ();
   z_return_val_if_fail (clip, false);
 
+  /* can't check until the clip is loaded */
+  if (!clip->is_loaded ())
+    return false;
+
   /* verify that the loop does not contain more frames than available in the
    * clip */
   /* use global positions because sometimes the loop appears to have 1 more
@@ -570,6 +928,8 @@ AudioRegion::validate (bool is_project, double frames_per_tick) const
     {
       auto clip = get_clip ();
       z_return_val_if_fail (clip, false);
+      if (!clip->is_loaded ())
+        return true;
 
       /* verify that the loop does not contain more frames than available in
       the clip. use global positions because sometimes the loop appears to have
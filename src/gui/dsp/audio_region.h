@@ -10,6 +10,7 @@
 #include "gui/dsp/region.h"
 
 #include "dsp/position.h"
+#include "dsp/timestretch_cache.h"
 #include "utils/audio.h"
 #include "utils/types.h"
 
@@ -216,6 +217,24 @@ public:
    */
   bool get_musical_mode () const;
 
+  /**
+   * @brief Returns the key of the region's clip stretched to @p bpm in the
+   * timestretch cache, or nothing if it doesn't need stretching (or can't be
+   * cached).
+   *
+   * Realtime-safe.
+   */
+  std::optional<dsp::TimestretchCache::Key>
+  get_timestretch_key (bpm_t bpm) const;
+
+  /**
+   * @brief Requests stretching the region's clip to @p bpm in the background
+   * (if needed), so that playback doesn't need to stretch it in realtime.
+   *
+   * @warning Not realtime safe.
+   */
+  void request_timestretch (bpm_t bpm) const;
+
   /**
    * Replaces the region's frames starting from @p start_frame with @p frames.
    *
@@ -254,6 +273,36 @@ public:
     channels_t       channels,
     bool             duplicate_clip);
 
+  /**
+   * @brief Returns the frames of the region's clip stretched by @p ratio.
+   *
+   * Doesn't modify the region, so it can be called for many regions in
+   * parallel (the result is then passed to apply_stretched_frames()).
+   *
+   * @warning Not realtime safe.
+   *
+   * @throw ZrythmException if stretching failed.
+   */
+  utils::audio::AudioBuffer get_stretched_frames (double ratio) const;
+
+  /**
+   * @brief Makes the region use a new clip with the given stretched frames
+   * and adjusts its end positions to match.
+   *
+   * @warning Not realtime safe.
+   *
+   * @throw ZrythmException if the clip couldn't be created.
+   */
+  void apply_stretched_frames (const utils::audio::AudioBuffer &frames);
+
+  /**
+   * @brief Scratch buffers (L/R) used by fill_stereo_ports().
+   *
+   * These are owned by whoever processes the region instead of each region
+   * (regions have many clones in undo stacks and snapshots).
+   */
+  using ScratchBuffers = std::array<std::array<float, 0x4000>, 2>;
+
   /**
    * Fills audio data from the region.
    *
@@ -261,13 +310,35 @@ public:
    * inside the region, so region loop related logic is not needed.
    *
    * @param stereo_ports StereoPorts to fill.
+   * @param scratch Scratch buffers not used by other threads at the same
+   * time.
    */
   [[gnu::hot]] void fill_stereo_ports (
     const EngineProcessTimeInfo        &time_nfo,
-    std::pair<AudioPort &, AudioPort &> stereo_ports) const;
+    std::pair<AudioPort &, AudioPort &> stereo_ports,
+    ScratchBuffers                     &scratch) const;
 
+  /**
+   * @brief Detects the tempo of the clip.
+   *
+   * Results are cached by the hash of the clip's audio.
+   *
+   * @param[out] candidates The most likely BPMs, most likely first.
+   * @return The BPM, or 0 if not found.
+   */
   float detect_bpm (std::vector<float> &candidates);
 
+  /**
+   * @brief Returns the global positions where the onsets (transients) of
+   * the clip are played, in ascending order (including repeats in loops).
+   *
+   * Nothing is returned while the onsets are still being detected (see
+   * AudioClip::get_onsets()).
+   *
+   * @param min_strength Minimum relative strength of the onsets (0 to 1).
+   */
+  std::vector<Position> get_transient_positions (float min_strength) const;
+
   /**
    * Fixes off-by-one rounding errors when changing BPM or sample rate which
    * result in the looped part being longer than there are actual frames in
@@ -307,11 +378,6 @@ public:
 
   /** Musical mode setting. */
   MusicalMode musical_mode_ = (MusicalMode) 0;
-
-  /**
-   * @brief Temporary buffers used during audio processing.
-   */
-  mutable std::array<std::array<float, 0x4000>, 2> tmp_bufs_{};
 };
 
 inline bool
@@ -13,6 +13,7 @@
 #include "gui/dsp/engine.h"
 #include "gui/dsp/pool.h"
 #include "gui/dsp/port.h"
+#include "gui/dsp/tempo_track.h"
 #include "gui/dsp/tracklist.h"
 #include "utils/objects.h"
 
@@ -94,6 +95,8 @@ AudioTrack::timestretch_buf (
   unsigned_frame_t    frames_to_process)
 {
   z_return_if_fail (r && rt_stretcher_);
+  rt_stretcher_->set_reduced_quality (
+    AUDIO_ENGINE->quality_governor_.is_reduced ());
   rt_stretcher_->set_time_ratio (1.0 / timestretch_ratio);
   auto in_frames_to_process =
     (unsigned_frame_t) (frames_to_process * timestretch_ratio);
@@ -135,8 +138,29 @@ AudioTrack::validate () const
 void
 AudioTrack::set_playback_caches ()
 {
+  /* precompute fade gains before generating the snapshots so that they
+   * share them */
+  for (const auto &lane_var : lanes_)
+    {
+      auto * lane = std::get<AudioLane *> (lane_var);
+      for (const auto &region_var : lane->region_list_->regions_)
+        {
+          std::get<AudioRegion *> (region_var)->update_fade_tables ();
+        }
+    }
+
   LanedTrackImpl::set_playback_caches ();
   AutomatableTrack::set_playback_caches ();
+
+  /* stretch musical mode regions ahead of playback */
+  const auto bpm = P_TEMPO_TRACK->get_current_bpm ();
+  for (const auto &lane : lane_snapshots_)
+    {
+      for (const auto &region : lane->region_snapshots_)
+        {
+          region->request_timestretch (bpm);
+        }
+    }
 }
 
 void
@@ -95,6 +95,15 @@ public:
 
   DECLARE_DEFINE_FIELDS_METHOD ();
 
+public:
+  /**
+   * @brief Scratch buffers for processing the track's regions.
+   *
+   * A track is only processed by one thread at a time, so its regions can
+   * share these.
+   */
+  mutable AudioRegion::ScratchBuffers region_scratch_bufs_{};
+
 private:
   bool initialize ();
 
@@ -106,26 +106,8 @@ AutomatableTrack::generate_automation_tracks ()
         }
     }
 
-  if (has_piano_roll ())
-    {
-      auto &track = dynamic_cast<ProcessableTrack &> (*this);
-      auto &processor = track.processor_;
-      /* midi automatables */
-      for (const auto channel_index : std::views::iota (0, 16))
-        {
-          for (const auto cc_index : std::views::iota (0, 128))
-            {
-            create_and_add_at (
-              processor->get_midi_cc_port (channel_index, cc_index));
-            }
-
-          create_and_add_at (processor->get_pitch_bend_port (channel_index));
-          create_and_add_at (
-            processor->get_poly_key_pressure_port (channel_index));
-          create_and_add_at (
-            processor->get_channel_pressure_port (channel_index));
-        }
-    }
+  /* MIDI automatables get their automation tracks when created (see
+   * TrackProcessor::get_or_create_midi_cc_port()) */
 
   switch (type_)
     {
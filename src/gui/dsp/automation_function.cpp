@@ -11,6 +11,8 @@
 #include "utils/flags.h"
 #include "utils/rt_thread_id.h"
 
+#include <QtConcurrent>
+
 using namespace zrythm;
 
 void
@@ -55,6 +57,9 @@ AutomationFunction::apply (ArrangerObjectSpanVariant sel_var, Type type)
         case Type::Flatten:
           flatten ();
           break;
+        case Type::Smooth:
+          /* TODO */
+          break;
         }
 
       /* set last action */
@@ -65,3 +70,36 @@ AutomationFunction::apply (ArrangerObjectSpanVariant sel_var, Type type)
     },
     sel_var);
 }
+
+void
+AutomationFunction::apply (
+  std::span<dsp::PackedAutomationPoints> points_per_region,
+  Type                                   type)
+{
+  z_debug (
+    "applying {} to the points of {} regions...",
+    AutomationFunctionType_to_string (type), points_per_region.size ());
+
+  QtConcurrent::blockingMap (
+    points_per_region.begin (), points_per_region.end (),
+    [type] (dsp::PackedAutomationPoints &points) {
+      switch (type)
+        {
+        case Type::FlipHorizontal:
+          points.flip_horizontal ();
+          break;
+        case Type::FlipVertical:
+          points.flip_vertical ();
+          break;
+        case Type::Flatten:
+          points.flatten ();
+          break;
+        case Type::Smooth:
+          points.smooth (SMOOTH_RADIUS);
+          break;
+        }
+    });
+
+  gui::SettingsManager::get_instance ()->set_lastAutomationFunction (
+    ENUM_VALUE_TO_INT (type));
+}
@@ -4,6 +4,9 @@
 #ifndef __AUDIO_AUTOMATION_FUNCTION_H__
 #define __AUDIO_AUTOMATION_FUNCTION_H__
 
+#include <span>
+
+#include "dsp/packed_automation_points.h"
 #include "gui/dsp/arranger_object_span.h"
 #include "utils/format.h"
 #include "utils/logger.h"
@@ -22,8 +25,12 @@ public:
     FlipHorizontal,
     FlipVertical,
     Flatten,
+    Smooth,
   };
 
+  /** Number of neighbouring points on each side averaged by Smooth. */
+  static constexpr size_t SMOOTH_RADIUS = 2;
+
   /**
    * Applies the given action to the given selections.
    *
@@ -32,6 +39,19 @@ public:
    * @throw ZrythmException on error.
    */
   static void apply (ArrangerObjectSpanVariant sel, Type type);
+
+  /**
+   * Applies the given function to the packed automation points of many
+   * regions at once (see
+   * ArrangerSelectionsAction::EditAutomationPointsAction).
+   *
+   * The regions are processed in parallel.
+   *
+   * @param points_per_region Selected points of each region.
+   */
+  static void apply (
+    std::span<dsp::PackedAutomationPoints> points_per_region,
+    Type                                   type);
 };
 
 DEFINE_ENUM_FORMATTER (
@@ -39,7 +59,8 @@ DEFINE_ENUM_FORMATTER (
   AutomationFunctionType,
   QT_TR_NOOP_UTF8 ("Flip H"),
   QT_TR_NOOP_UTF8 ("Flip V"),
-  QT_TR_NOOP_UTF8 ("Flatten"));
+  QT_TR_NOOP_UTF8 ("Flatten"),
+  QT_TR_NOOP_UTF8 ("Smooth"));
 
 /**
  * @}
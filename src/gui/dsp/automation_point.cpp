@@ -27,13 +27,12 @@ using namespace zrythm;
 AutomationPoint::AutomationPoint (QObject * parent)
     : ArrangerObject (Type::AutomationPoint), QObject (parent)
 {
-  ArrangerObject::parent_base_qproperties (*this);
 }
 
 AutomationPoint::AutomationPoint (const Position &pos, QObject * parent)
     : AutomationPoint (parent)
 {
-  *static_cast<Position *> (pos_) = pos;
+  *pos_ = pos;
   curve_opts_.algo_ =
     ZRYTHM_TESTING || ZRYTHM_BENCHMARKING
       ? dsp::CurveOptions::Algorithm::SuperEllipse
@@ -13,8 +13,6 @@
 AutomationRegion::AutomationRegion (QObject * parent)
     : ArrangerObject (Type::Region), BoundedObject (), QAbstractListModel (parent)
 {
-  ArrangerObject::parent_base_qproperties (*this);
-  BoundedObject::parent_base_qproperties (*this);
   init_colored_object ();
 }
 
@@ -13,6 +13,8 @@
 #include "gui/dsp/automation_region.h"
 #include "gui/dsp/automation_track.h"
 #include "gui/dsp/control_port.h"
+#include "gui/dsp/engine.h"
+#include "gui/dsp/router.h"
 #include "gui/dsp/track.h"
 #include "gui/dsp/tracklist.h"
 #include "utils/gtest_wrapper.h"
@@ -160,13 +162,71 @@ AutomationTrack::get_automation_tracklist () const
   return track->automation_tracklist_;
 }
 
+bool
+AutomationTrack::can_use_playback_cursors (bool use_snapshots) const
+{
+  return use_snapshots && ROUTER && ROUTER->is_processing_thread ();
+}
+
+void
+AutomationTrack::reset_playback_cursors ()
+{
+  for (auto &cursor : region_cursors_)
+    {
+      cursor.valid_ = false;
+    }
+  ap_cursor_.valid_ = false;
+  ap_cursor_region_ = nullptr;
+}
+
 AutomationRegion *
 AutomationTrack::get_region_before_pos (
   const Position &pos,
   bool            ends_after,
   bool            use_snapshots) const
 {
-  auto process_regions = [=] (const auto &regions) {
+  const bool use_cursor = can_use_playback_cursors (use_snapshots);
+  auto      &cursor = region_cursors_[ends_after ? 1 : 0];
+  if (use_cursor && cursor.contains (pos.frames_))
+    {
+      return cursor.result_;
+    }
+
+  /* playback uses the index built with the snapshots */
+  if (use_snapshots)
+    {
+      const auto &index = get_region_snapshot_index ();
+      const auto  found =
+        ends_after ? index.find_last_overlapping (pos.frames_, pos.frames_)
+                   : index.find_latest_ending_started_by (pos.frames_);
+      auto * region = found ? region_snapshots_[*found].get () : nullptr;
+      if (use_cursor)
+        {
+          const auto [valid_from, valid_until] =
+            index.get_boundaries_around (pos.frames_, ends_after);
+          cursor = {
+            .valid_ = true,
+            .from_ = valid_from,
+            .until_ = valid_until,
+            .result_ = region,
+          };
+        }
+      return region;
+    }
+
+  /* the result only changes at the positions where a region starts (or ends,
+   * if ends_after), so also find the closest ones around pos */
+  signed_frame_t valid_from = std::numeric_limits<signed_frame_t>::min ();
+  signed_frame_t valid_until = std::numeric_limits<signed_frame_t>::max ();
+  auto           add_boundary = [&] (signed_frame_t frames) {
+    if (frames <= pos.frames_)
+      valid_from = std::max (valid_from, frames);
+    else
+      valid_until = std::min (valid_until, frames);
+  };
+
+  auto process_regions = [&] (const auto &regions) {
+    AutomationRegion * found_r = nullptr;
     if (ends_after)
       {
         for (auto it = regions.rbegin (); it != regions.rend (); ++it)
@@ -182,14 +242,16 @@ AutomationTrack::get_region_before_pos (
               {
                 region = std::get<AutomationRegion *> (region_var);
               }
-            if (*region->pos_ <= pos && *region->end_pos_ >= pos)
-              return region;
+            add_boundary (region->pos_->frames_);
+            add_boundary (region->end_pos_->frames_ + 1);
+            if (
+              !found_r && *region->pos_ <= pos && *region->end_pos_ >= pos)
+              found_r = region;
           }
       }
     else
       {
-        AutomationRegion * latest_r = nullptr;
-        signed_frame_t     latest_distance =
+        signed_frame_t latest_distance =
           std::numeric_limits<signed_frame_t>::min ();
         for (auto it = regions.rbegin (); it != regions.rend (); ++it)
           {
@@ -204,22 +266,33 @@ AutomationTrack::get_region_before_pos (
               {
                 region = std::get<AutomationRegion *> (region_var);
               }
+            add_boundary (region->pos_->frames_);
             signed_frame_t distance_from_r_end =
               region->end_pos_->frames_ - pos.frames_;
             if (*region->pos_ <= pos && distance_from_r_end > latest_distance)
               {
                 latest_distance = distance_from_r_end;
-                latest_r = region;
+                found_r = region;
               }
           }
-        return latest_r;
       }
-    return static_cast<AutomationRegion *> (nullptr);
+    return found_r;
   };
 
-  return use_snapshots
-           ? process_regions (region_snapshots_)
-           : process_regions (region_list_->regions_);
+  /* not using the region list's index here, since this may be called from
+   * the audio thread (e.g. for the tempo) and rebuilding it allocates */
+  auto * region = process_regions (region_list_->regions_);
+
+  if (use_cursor)
+    {
+      cursor = {
+        .valid_ = true,
+        .from_ = valid_from,
+        .until_ = valid_until,
+        .result_ = region,
+      };
+    }
+  return region;
 }
 
 AutomationPoint *
@@ -242,15 +315,39 @@ AutomationTrack::get_ap_before_pos (
       : pos.frames_,
     true);
 
+  const bool use_cursor = can_use_playback_cursors (use_snapshots);
+  if (use_cursor && ap_cursor_region_ == r && ap_cursor_.contains (local_pos))
+    {
+      return ap_cursor_.result_;
+    }
+
+  /* the result stays the same until the position of the next point after
+   * it */
+  AutomationPoint * found_ap = nullptr;
+  signed_frame_t    valid_until = std::numeric_limits<signed_frame_t>::max ();
   for (auto &ap : std::ranges::reverse_view (r->aps_))
     {
       if (ap->pos_->frames_ <= local_pos)
         {
-          return ap;
+          found_ap = ap;
+          break;
         }
+      valid_until = std::min (valid_until, ap->pos_->frames_);
     }
 
-  return nullptr;
+  if (use_cursor)
+    {
+      ap_cursor_region_ = r;
+      ap_cursor_ = {
+        .valid_ = true,
+        .from_ =
+          found_ap ? found_ap->pos_->frames_
+                   : std::numeric_limits<signed_frame_t>::min (),
+        .until_ = valid_until,
+        .result_ = found_ap,
+      };
+    }
+  return found_ap;
 }
 
 AutomationTrack *
@@ -515,11 +612,13 @@ AutomationTrack::set_caches (CacheType types)
 {
   if (ENUM_BITSET_TEST (types, CacheType::PlaybackSnapshots))
     {
-      region_snapshots_.clear ();
-      for (const auto &r_var : region_list_->regions_)
+      reset_playback_cursors ();
+      update_region_snapshots (*this);
+
+      /* the blocks rendered ahead used the old snapshots */
+      if (AUDIO_ENGINE && ROUTER)
         {
-          region_snapshots_.emplace_back (
-            std::get<AutomationRegion *> (r_var)->clone_unique ());
+          ROUTER->invalidate_rendered_ahead ();
         }
     }
 
@@ -6,6 +6,8 @@
 
 #include "zrythm-config.h"
 
+#include <array>
+
 #include "gui/dsp/automation_point.h"
 #include "gui/dsp/port.h"
 #include "gui/dsp/region_owner.h"
@@ -13,6 +15,7 @@
 #include <QtQmlIntegration>
 
 #include "automation_region.h"
+#include "dsp/curve_simplifier.h"
 #include "dsp/position.h"
 
 class AutomatableTrack;
@@ -286,6 +289,15 @@ public:
   /** Last value recorded in this automation track. */
   float last_recorded_value_ = 0.f;
 
+  /**
+   * Drops recorded automation points that the curve doesn't need (see
+   * RecordingManager::create_automation_point()).
+   *
+   * Its last point is the last recorded automation point of
+   * @ref recording_region_, if any.
+   */
+  dsp::StreamingCurveSimplifier recording_simplifier_;
+
   /** Automation mode. */
   AutomationMode automation_mode_ = AutomationMode::Read;
 
@@ -317,10 +329,55 @@ public:
    */
   bool recording_paused_ = false;
 
+private:
+  /**
+   * @brief Result of a lookup during playback, along with the range of
+   * positions (in frames) that give the same result.
+   *
+   * Lookups only search again when the playhead leaves the range (e.g.,
+   * when reaching the next region or automation point, or after a jump).
+   */
+  template <typename T> struct PlaybackCursor
+  {
+    bool contains (signed_frame_t frames) const
+    {
+      return valid_ && frames >= from_ && frames < until_;
+    }
+
+    bool           valid_ = false;
+    signed_frame_t from_ = 0;
+    signed_frame_t until_ = 0;
+    T *            result_ = nullptr;
+  };
+
+  /**
+   * @brief Returns whether lookups may use the playback cursors.
+   *
+   * Cursors are only used for the snapshots and only from the processing
+   * threads, so they are never accessed concurrently.
+   */
+  bool can_use_playback_cursors (bool use_snapshots) const;
+
+  /** Invalidates the playback cursors (e.g., after the snapshots change). */
+  void reset_playback_cursors ();
+
 private:
   /** Pointer to owner automation tracklist, if any. */
   AutomationTracklist * atl_ = nullptr;
 
+  /**
+   * Cursors for get_region_before_pos() with `ends_after` false and true
+   * respectively.
+   */
+  mutable std::array<PlaybackCursor<AutomationRegion>, 2> region_cursors_;
+
+  /**
+   * Cursor for the automation point lookup in get_ap_before_pos(), in frames
+   * local to @ref ap_cursor_region_.
+   */
+  mutable PlaybackCursor<AutomationPoint> ap_cursor_;
+  mutable const AutomationRegion *        ap_cursor_region_ = nullptr;
+
   /** Cache used during DSP. */
   // std::optional<std::reference_wrapper<ControlPort>> port_;
 };
@@ -13,24 +13,14 @@
 #include "utils/gtest_wrapper.h"
 #include "utils/rt_thread_id.h"
 
-BoundedObject::BoundedObject () : end_pos_ (new PositionProxy ()) { }
-
-void
-BoundedObject::parent_base_qproperties (QObject &derived)
-{
-  end_pos_->setParent (&derived);
-}
+BoundedObject::BoundedObject () = default;
 
 void
 BoundedObject::copy_members_from (
   const BoundedObject &other,
   ObjectCloneType      clone_type)
 {
-  end_pos_ = other.end_pos_->clone_raw_ptr ();
-  if (auto * qobject = dynamic_cast<QObject *> (this))
-    {
-      end_pos_->setParent (qobject);
-    }
+  end_pos_ = other.end_pos_;
 }
 
 void
@@ -82,7 +72,7 @@ BoundedObject::resize (
             }
           else
             {
-              tmp = *static_cast<Position *> (pos_);
+              tmp = *pos_;
               tmp.add_ticks (ticks, AUDIO_ENGINE->frames_per_tick_);
               set_position (&tmp, PositionType::Start, false);
 
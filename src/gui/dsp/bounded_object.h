@@ -14,7 +14,7 @@ public: \
   Q_PROPERTY (PositionProxy * endPosition READ getEndPosition CONSTANT) \
   PositionProxy * getEndPosition () const \
   { \
-    return end_pos_; \
+    return end_pos_.get_proxy (const_cast<ClassType *> (this)); \
   }
 
 /**
@@ -42,11 +42,9 @@ public:
    */
   void get_end_pos (dsp::Position * pos) const
   {
-    *pos = *static_cast<dsp::Position *> (end_pos_);
+    *pos = *end_pos_;
   }
 
-  void parent_base_qproperties (QObject &derived);
-
   /**
    * The setter is for use in e.g. the digital meters whereas the set_pos func
    * is used during arranger actions.
@@ -240,7 +238,7 @@ public:
    * This is exclusive of the material, i.e., the data at this position is not
    * counted (for audio regions at least, TODO check for others).
    */
-  PositionProxy * end_pos_ = nullptr;
+  LazyPositionProxy end_pos_;
 };
 
 template <typename T>
@@ -4,6 +4,7 @@
 #include "zrythm-config.h"
 
 #include <algorithm>
+#include <bit>
 
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/zrythm.h"
@@ -14,6 +15,7 @@
 #include "gui/dsp/engine.h"
 #include "gui/dsp/midi_event.h"
 #include "gui/dsp/plugin.h"
+#include "gui/dsp/plugin_preset_cache.h"
 #include "gui/dsp/tempo_track.h"
 #include "gui/dsp/tracklist.h"
 #include "gui/dsp/transport.h"
@@ -25,6 +27,7 @@
 #include "utils/gtest_wrapper.h"
 #include "utils/io.h"
 #include "utils/math.h"
+#include "utils/rt_logger.h"
 #include "utils/rt_thread_id.h"
 #include "utils/string.h"
 #include <fmt/format.h>
@@ -63,30 +66,22 @@ return_gl_context (GdkGLContext * context)
 }
 #endif // HAVE_CARLA
 
-bool
-CarlaNativePlugin::idle_cb ()
+void
+CarlaNativePlugin::idle_ui ()
 {
-  if (visible_) // && MAIN_WINDOW)
-    {
 #if HAVE_CARLA
-      GdkGLContext * context = clear_gl_context ();
-      /*z_debug ("calling ui_idle()...");*/
-      native_plugin_descriptor_->ui_idle (native_plugin_handle_);
-      /*z_debug ("done calling ui_idle()");*/
-      return_gl_context (context);
+  GdkGLContext * context = clear_gl_context ();
+  native_plugin_descriptor_->ui_idle (native_plugin_handle_);
+  return_gl_context (context);
 #endif
-      return SourceFuncContinue;
-    }
-  else
-    return SourceFuncRemove;
 }
 
 #if HAVE_CARLA
 static uint32_t
 host_get_buffer_size (NativeHostHandle handle)
 {
-  if (PROJECT && AUDIO_ENGINE && AUDIO_ENGINE->block_length_ > 0)
-    return AUDIO_ENGINE->block_length_;
+  if (PROJECT && AUDIO_ENGINE && AUDIO_ENGINE->max_block_length_ > 0)
+    return AUDIO_ENGINE->max_block_length_;
   return 512;
 }
 
@@ -160,7 +155,7 @@ host_ui_closed (NativeHostHandle handle)
 {
   auto * self = static_cast<CarlaNativePlugin *> (handle);
   z_info ("{} UI closed", self->get_name ());
-  self->idle_connection_.disconnect ();
+  PluginUiIdleScheduler::instance ().deregister_ui (self);
 }
 
 static intptr_t
@@ -244,9 +239,20 @@ carla_engine_callback (
         val1 == CarlaBackend::PARAMETER_ACTIVE && val2 == 0 && val3 == 0
         && self->activated_ && !self->deactivating_ && !self->loading_state_)
         {
+          /* bridged plugins only take their own process down and are
+           * silent from now on */
+          z_warning (
+            "Plugin '{}' crashed or stopped responding (bridge mode: {})",
+            self->get_name (), ENUM_NAME (self->setting_->bridge_mode_));
+
           /* send crash signal */
           // EVENTS_PUSH (EventType::ET_PLUGIN_CRASHED, self);
         }
+      /* changed from the plugin's UI or by MIDI */
+      if (val1 >= 0 && !self->loading_state_)
+        {
+          self->mark_state_dirty ();
+        }
       break;
     case CarlaBackend::ENGINE_CALLBACK_PARAMETER_DEFAULT_CHANGED:
     case CarlaBackend::ENGINE_CALLBACK_PARAMETER_MAPPED_CONTROL_INDEX_CHANGED:
@@ -257,9 +263,13 @@ carla_engine_callback (
       break;
     case CarlaBackend::ENGINE_CALLBACK_PROGRAM_CHANGED:
       z_debug ("Program changed: plugin {} - {}", plugin_id, val1);
+      self->mark_state_dirty ();
+      self->mark_ui_changed ();
       break;
     case CarlaBackend::ENGINE_CALLBACK_MIDI_PROGRAM_CHANGED:
       z_debug ("MIDI program changed: plugin {} - {}", plugin_id, val1);
+      self->mark_state_dirty ();
+      self->mark_ui_changed ();
       break;
     case CarlaBackend::ENGINE_CALLBACK_UI_STATE_CHANGED:
       switch (val1)
@@ -267,6 +277,7 @@ carla_engine_callback (
         case 0:
         case -1:
           self->visible_ = false;
+          PluginUiIdleScheduler::instance ().deregister_ui (self);
           break;
         case 1:
           self->visible_ = true;
@@ -479,13 +490,56 @@ CarlaNativePlugin::set_selected_preset_from_index_impl (int idx)
   else
     {
       const auto &pset = banks_[selected_bank_.bank_idx_].presets_[idx];
+
+      /* restore recently used presets from their state instead of having
+       * the plugin load them again */
+      const auto it = std::ranges::find_if (
+        preset_state_cache_, [&] (const CachedPresetState &cached) {
+          return cached.carla_program_ == pset.carla_program_;
+        });
+      if (it != preset_state_cache_.end ())
+        {
+          carla_set_chunk_data (host_handle_, 0, it->chunk_.c_str ());
+          std::rotate (preset_state_cache_.begin (), it, it + 1);
+          z_info ("applied preset '{}' from cached state", pset.name_);
+          return;
+        }
+
       carla_set_program (
         host_handle_, 0, static_cast<uint32_t> (pset.carla_program_));
       z_info ("applied preset '{}'", pset.name_);
+
+      if (uses_chunks ())
+        {
+          const char * chunk = carla_get_chunk_data (host_handle_, 0);
+          if (chunk != nullptr && strlen (chunk) > 0)
+            {
+              if (preset_state_cache_.size () >= MAX_CACHED_PRESET_STATES)
+                {
+                  preset_state_cache_.pop_back ();
+                }
+              preset_state_cache_.insert (
+                preset_state_cache_.begin (),
+                CachedPresetState{
+                  .carla_program_ = pset.carla_program_, .chunk_ = chunk });
+            }
+        }
     }
 #endif
 }
 
+bool
+CarlaNativePlugin::uses_chunks () const
+{
+#if HAVE_CARLA
+  const auto * info = carla_get_plugin_info (host_handle_, 0);
+  return info != nullptr
+         && (info->optionsEnabled & CarlaBackend::PLUGIN_OPTION_USE_CHUNKS) != 0;
+#else
+  return false;
+#endif
+}
+
 void
 CarlaNativePlugin::cleanup_impl ()
 {
@@ -509,29 +563,42 @@ CarlaNativePlugin::populate_banks ()
     pl_def_bank->add_preset (std::move (pl_def_preset));
   }
 
-  std::string presets_gstr;
-  uint32_t    count = carla_get_program_count (host_handle_, 0);
-  for (uint32_t i = 0; i < count; i++)
+  /* the program count is cheap to query, but the names are not (especially
+   * for bridged plugins), so take them from the cache if it has the same
+   * number of presets */
+  const uint32_t count = carla_get_program_count (host_handle_, 0);
+  auto           presets = PluginPresetCache::load (get_descriptor ());
+  if (presets && presets->size () == count)
     {
-      auto pl_preset = Preset ();
-      pl_preset.carla_program_ = static_cast<int> (i);
-      const char * program_name = carla_get_program_name (host_handle_, 0, i);
-      if (strlen (program_name) == 0)
-        {
-          pl_preset.name_ = format_str (QObject::tr ("Preset {}"), i);
-        }
-      else
+      z_debug ("using {} cached presets", count);
+    }
+  else
+    {
+      presets.emplace ();
+      presets->reserve (count);
+      for (uint32_t i = 0; i < count; i++)
         {
-          pl_preset.name_ = program_name;
+          const char * program_name =
+            carla_get_program_name (host_handle_, 0, i);
+          presets->push_back (PluginPresetCache::PresetInfo{
+            .name_ =
+              strlen (program_name) == 0
+                ? format_str (QObject::tr ("Preset {}"), i)
+                : std::string (program_name),
+            .carla_program_ = static_cast<int> (i) });
         }
-      pl_def_bank->add_preset (std::move (pl_preset));
+      PluginPresetCache::save (get_descriptor (), *presets);
+    }
 
-      presets_gstr += fmt::format (
-        "found preset {} ({})\n", pl_preset.name_, pl_preset.carla_program_);
+  for (const auto &preset : *presets)
+    {
+      auto pl_preset = Preset ();
+      pl_preset.carla_program_ = preset.carla_program_;
+      pl_preset.name_ = preset.name_;
+      pl_def_bank->add_preset (std::move (pl_preset));
     }
 
   z_info ("found {} presets", count);
-  z_info ("{}", presets_gstr);
 #endif // HAVE_CARLA
 }
 
@@ -647,12 +714,10 @@ CarlaNativePlugin::process_impl (const EngineProcessTimeInfo time_nfo)
   /* get main midi port */
   auto port = midi_in_port_;
 
-  constexpr int                           MAX_EVENTS = 4000;
-  std::array<NativeMidiEvent, MAX_EVENTS> events;
-  int                                     num_events_written = 0;
+  uint32_t num_events_written = 0;
   if (port)
     {
-      for (auto &ev : port->midi_events_.active_events_)
+      for (const auto &ev : port->midi_events_.active_events_)
         {
           if (
             ev.time_ < time_nfo.local_offset_
@@ -662,7 +727,9 @@ CarlaNativePlugin::process_impl (const EngineProcessTimeInfo time_nfo)
                * cycle
                */
 #  if 0
-          z_debug ("skip events scheduled for another split within the processing cycle: ev->time {}, local_offset {}, nframes {}", ev.time_, time_nfo.local_offset, time_nfo.nframes);
+              z_rt_debug (
+                "skip events scheduled for another split within the processing cycle: ev->time {}, local_offset {}, nframes {}",
+                ev.time_, time_nfo.local_offset_, time_nfo.nframes_);
 #  endif
               continue;
             }
@@ -678,20 +745,21 @@ CarlaNativePlugin::process_impl (const EngineProcessTimeInfo time_nfo)
       ev.print ();
 #  endif
 
-          /* event time is relative to the current zrythm full cycle (not
-           * split). it needs to be made relative to the current split */
-          events[num_events_written].time = ev.time_ - time_nfo.local_offset_;
-          events[num_events_written].size = 3;
-          events[num_events_written].data[0] = ev.raw_buffer_[0];
-          events[num_events_written].data[1] = ev.raw_buffer_[1];
-          events[num_events_written].data[2] = ev.raw_buffer_[2];
-          ++num_events_written;
-
-          if (num_events_written == MAX_EVENTS)
+          /* the port holds at most MAX_MIDI_EVENTS events so this can't
+           * happen */
+          if (num_events_written == native_midi_events_.size ()) [[unlikely]]
             {
-              z_warning ("written {} events", MAX_EVENTS);
               break;
             }
+
+          /* event time is relative to the current zrythm full cycle (not
+           * split). it needs to be made relative to the current split */
+          auto &native_ev = native_midi_events_[num_events_written++];
+          native_ev.time = ev.time_ - time_nfo.local_offset_;
+          native_ev.size = 3;
+          native_ev.data[0] = ev.raw_buffer_[0];
+          native_ev.data[1] = ev.raw_buffer_[1];
+          native_ev.data[2] = ev.raw_buffer_[2];
         }
     }
   if (num_events_written > 0)
@@ -704,13 +772,14 @@ CarlaNativePlugin::process_impl (const EngineProcessTimeInfo time_nfo)
 #  endif
     }
 
+  /* parameter changes since the last cycle (e.g., from automation, MIDI
+   * mappings or presets) */
+  flush_param_values ();
+
   native_plugin_descriptor_->process (
     native_plugin_handle_, const_cast<float **> (inbufs_.data ()),
-    outbufs_.data (), time_nfo.nframes_, events.data (),
-    static_cast<uint32_t> (num_events_written));
-
-  /* update latency */
-  latency_ = get_latency ();
+    outbufs_.data (), time_nfo.nframes_, native_midi_events_.data (),
+    num_events_written);
 #endif // HAVE_CARLA
 }
 
@@ -963,6 +1032,7 @@ CarlaNativePlugin::create_ports (bool loading)
     "params: %d ins and %d outs",
     descr->num_ctrl_ins, (int) param_counts->outs);
 #  endif
+  init_param_value_queue (param_counts->ins);
   for (uint32_t i = 0; i < param_counts->ins; i++)
     {
       ControlPort * added_port = nullptr;
@@ -1099,9 +1169,9 @@ CarlaNativePlugin::update_buffer_size_and_sample_rate ()
   z_debug (
     "setting carla buffer size and sample rate: "
     "{} {}",
-    engine.block_length_, engine.sample_rate_);
+    engine.max_block_length_, engine.sample_rate_);
   carla_set_engine_buffer_size_and_sample_rate (
-    host_handle_, engine.block_length_, engine.sample_rate_);
+    host_handle_, engine.max_block_length_, engine.sample_rate_);
 
   /* update processing buffers */
   const auto max_variant_ins = max_variant_audio_ins_ + max_variant_cv_ins_;
@@ -1109,8 +1179,8 @@ CarlaNativePlugin::update_buffer_size_and_sample_rate ()
   inbufs_.resize (max_variant_ins);
   for (size_t i = 0; i < max_variant_ins; i++)
     {
-      zero_inbufs_[i].resize (engine.block_length_);
-      utils::float_ranges::fill (zero_inbufs_[i].data (), 1e-20f, engine.block_length_);
+      zero_inbufs_[i].resize (engine.max_block_length_);
+      utils::float_ranges::fill (zero_inbufs_[i].data (), 1e-20f, engine.max_block_length_);
       inbufs_[i] = zero_inbufs_[i].data ();
     }
 
@@ -1119,8 +1189,8 @@ CarlaNativePlugin::update_buffer_size_and_sample_rate ()
   outbufs_.resize (max_variant_outs);
   for (size_t i = 0; i < max_variant_outs; i++)
     {
-      zero_outbufs_[i].resize (engine.block_length_);
-      utils::float_ranges::fill (zero_outbufs_[i].data (), 1e-20f, engine.block_length_);
+      zero_outbufs_[i].resize (engine.max_block_length_);
+      utils::float_ranges::fill (zero_outbufs_[i].data (), 1e-20f, engine.max_block_length_);
       outbufs_[i] = zero_outbufs_[i].data ();
     }
 
@@ -1128,7 +1198,7 @@ CarlaNativePlugin::update_buffer_size_and_sample_rate ()
     {
       intptr_t ret = native_plugin_descriptor_->dispatcher (
         native_plugin_handle_, NATIVE_PLUGIN_OPCODE_BUFFER_SIZE_CHANGED, 0,
-        engine.block_length_, nullptr, 0.f);
+        engine.max_block_length_, nullptr, 0.f);
       z_return_if_fail (ret == 0);
       ret = native_plugin_descriptor_->dispatcher (
         native_plugin_handle_, NATIVE_PLUGIN_OPCODE_SAMPLE_RATE_CHANGED, 0, 0,
@@ -1356,19 +1426,20 @@ CarlaNativePlugin::instantiate_impl (bool loading, bool use_state_file)
       max_variant_audio_outs_ = 2;
     }
 
+  buffer_size_ = AUDIO_ENGINE->max_block_length_;
   unsigned int max_variant_ins = max_variant_audio_ins_ + max_variant_cv_ins_;
   zero_inbufs_.resize (max_variant_ins);
   inbufs_.resize (max_variant_ins);
   for (auto &buf : zero_inbufs_)
     {
-      buf.resize (AUDIO_ENGINE->block_length_);
+      buf.resize (AUDIO_ENGINE->max_block_length_);
     }
   unsigned int max_variant_outs = max_variant_audio_outs_ + max_variant_cv_outs_;
   zero_outbufs_.resize (max_variant_outs);
   outbufs_.resize (max_variant_ins);
   for (auto &buf : zero_outbufs_)
     {
-      buf.resize (AUDIO_ENGINE->block_length_);
+      buf.resize (AUDIO_ENGINE->max_block_length_);
     }
 
   /* instantiate the plugin to get its info */
@@ -1691,9 +1762,8 @@ CarlaNativePlugin::open_custom_ui (bool show)
 
   z_debug ("show/hide '{} ({})' UI: {}", get_name (), fmt::ptr (this), show);
 
-  if (
-    (!idle_connection_.connected () && !show)
-    || (idle_connection_.connected () && show))
+  auto &idle_scheduler = PluginUiIdleScheduler::instance ();
+  if (idle_scheduler.is_registered (this) == show)
     {
       z_info (
         "plugin already has visibility status %d, "
@@ -1761,21 +1831,15 @@ CarlaNativePlugin::open_custom_ui (bool show)
           visible_ = show;
         }
 
-        if (idle_connection_.connected ())
+        if (show)
           {
-            z_debug ("removing tick callback for {}", get_name ());
-            idle_connection_.disconnect ();
+            z_debug ("idling UI of {}", get_name ());
+            idle_scheduler.register_ui (this);
           }
-
-        if (show)
+        else
           {
-            z_return_if_fail (MAIN_WINDOW);
-            z_debug ("setting tick callback for {}", get_name ());
-            idle_connection_ = Glib::signal_timeout ().connect (
-              sigc::track_obj (
-                sigc::mem_fun (*this, &CarlaNativePlugin::idle_cb), *this),
-              /* 60 fps */
-              1000 / 60, Glib::PRIORITY_DEFAULT);
+            z_debug ("no longer idling UI of {}", get_name ());
+            idle_scheduler.deregister_ui (this);
           }
 
         if (ZRYTHM_HAVE_UI)
@@ -1803,11 +1867,45 @@ float
 CarlaNativePlugin::get_param_value (const uint32_t id)
 {
 #if HAVE_CARLA
+  /* not sent yet */
+  if (
+    id < num_queued_params_
+    && (pending_param_bits_[id / 64].load (std::memory_order_acquire)
+        & (uint64_t{ 1 } << (id % 64))))
+    {
+      return pending_param_values_[id].load (std::memory_order_relaxed);
+    }
   return carla_get_current_parameter_value (host_handle_, 0, id);
 #endif
   return 0.f;
 }
 
+void
+CarlaNativePlugin::init_param_value_queue (size_t num_params)
+{
+  /* (value-initialized to 0) */
+  pending_param_values_ = std::make_unique<std::atomic<float>[]> (num_params);
+  pending_param_bits_ =
+    std::make_unique<std::atomic<uint64_t>[]> ((num_params + 63) / 64);
+  num_queued_params_ = num_params;
+  has_pending_param_values_.store (false, std::memory_order_release);
+}
+
+void
+CarlaNativePlugin::send_param_value (const uint32_t id, float val)
+{
+#if HAVE_CARLA
+  carla_set_parameter_value (host_handle_, 0, id, val);
+  if (carla_get_current_plugin_count (host_handle_) == 2)
+    {
+      carla_set_parameter_value (host_handle_, 1, id, val);
+    }
+
+  /* let a throttled UI catch up */
+  mark_ui_changed ();
+#endif
+}
+
 void
 CarlaNativePlugin::set_param_value (const uint32_t id, float val)
 {
@@ -1817,15 +1915,41 @@ CarlaNativePlugin::set_param_value (const uint32_t id, float val)
       return;
     }
 
-  float cur_val = carla_get_current_parameter_value (host_handle_, 0, id);
-  if (DEBUGGING && !utils::math::floats_equal (cur_val, val))
+  /* no queue yet (not instantiated) */
+  if (id >= num_queued_params_) [[unlikely]]
     {
-      z_debug ("setting param {} value to {:f}", id, (double) val);
+      send_param_value (id, val);
+      return;
     }
-  carla_set_parameter_value (host_handle_, 0, id, val);
-  if (carla_get_current_plugin_count (host_handle_) == 2)
+
+  /* superseded values are simply overwritten */
+  pending_param_values_[id].store (val, std::memory_order_relaxed);
+  pending_param_bits_[id / 64].fetch_or (
+    uint64_t{ 1 } << (id % 64), std::memory_order_release);
+  has_pending_param_values_.store (true, std::memory_order_release);
+#endif
+}
+
+void
+CarlaNativePlugin::flush_param_values ()
+{
+#if HAVE_CARLA
+  if (!has_pending_param_values_.exchange (false, std::memory_order_acquire))
+    return;
+
+  const size_t num_words = (num_queued_params_ + 63) / 64;
+  for (size_t word_idx = 0; word_idx < num_words; ++word_idx)
     {
-      carla_set_parameter_value (host_handle_, 1, id, val);
+      auto bits =
+        pending_param_bits_[word_idx].exchange (0, std::memory_order_acquire);
+      while (bits != 0)
+        {
+          const auto bit = static_cast<size_t> (std::countr_zero (bits));
+          bits &= bits - 1;
+          const auto id = static_cast<uint32_t> (word_idx * 64 + bit);
+          send_param_value (
+            id, pending_param_values_[id].load (std::memory_order_relaxed));
+        }
     }
 #endif
 }
@@ -1886,6 +2010,9 @@ CarlaNativePlugin::save_state (bool is_backup, const std::string * abs_state_dir
       return;
     }
 
+  /* include the values not sent yet */
+  flush_param_values ();
+
   auto dir_to_use =
     abs_state_dir ? *abs_state_dir : get_abs_state_dir (is_backup, true);
 
@@ -1942,6 +2069,7 @@ CarlaNativePlugin::load_state (const std::string * abs_path)
       carla_load_plugin_state (host_handle_, 1, state_file.string ().c_str ());
     }
   loading_state_ = false;
+  mark_state_dirty ();
   if (visible_ && is_in_active_project ())
     {
       // EVENTS_PUSH (EventType::ET_PLUGIN_VISIBILITY_CHANGED, this);
@@ -1970,7 +2098,7 @@ CarlaNativePlugin::close ()
       carla_set_engine_about_to_close (host_handle_);
     }
 
-  idle_connection_.disconnect ();
+  PluginUiIdleScheduler::instance ().deregister_ui (this);
 
   auto &descr = get_descriptor ();
   z_debug ("closing plugin {}...", descr.name_);
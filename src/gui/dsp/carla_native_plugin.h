@@ -6,9 +6,12 @@
 
 #include "zrythm-config.h"
 
+#include <atomic>
+#include <memory>
 #include <utility>
 #include <vector>
 
+#include "gui/backend/plugin_ui_idle_scheduler.h"
 #include "gui/dsp/plugin.h"
 
 #include "utils/icloneable.h"
@@ -67,6 +70,7 @@ struct CarlaPatchbayPortInfo
 class CarlaNativePlugin final
     : public QObject,
       public Plugin,
+      public IPluginUiIdler,
       public ICloneable<CarlaNativePlugin>,
       public zrythm::utils::serialization::ISerializable<CarlaNativePlugin>
 {
@@ -132,11 +136,21 @@ public:
   /**
    * Called from port_set_control_value() to send the value to carla.
    *
+   * The value is queued and sent along with the other queued changes right
+   * before the plugin is processed (only the latest value of each parameter is
+   * sent). Realtime-safe.
+   *
    * @param val Real value (ie, not normalized).
    */
-
   void set_param_value (uint32_t id, float val);
 
+  /**
+   * @brief Sends the parameter values queued by set_param_value() to carla.
+   *
+   * Called before processing and before saving the state.
+   */
+  void flush_param_values ();
+
   void close () override;
 
   static bool has_custom_ui (const PluginDescriptor &descr);
@@ -147,6 +161,17 @@ public:
 
   nframes_t get_single_playback_latency () const override;
 
+  /**
+   * @brief Returns the buffer size the plugin was instantiated with.
+   *
+   * Buffer size changes are not forwarded to Carla, so larger engine blocks
+   * are processed in sub-blocks.
+   */
+  nframes_t get_max_block_length () const override
+  {
+    return buffer_size_ > 0 ? buffer_size_ : Plugin::get_max_block_length ();
+  }
+
   /**
    * @brief Adds the internal plugin from the given descriptor.
    *
@@ -166,6 +191,11 @@ private:
 
   void set_selected_preset_from_index_impl (int idx) override;
 
+  /**
+   * @brief Returns whether the plugin's state is saved as an opaque chunk.
+   */
+  bool uses_chunks () const;
+
   void activate_impl (bool activate) override;
 
   /**
@@ -188,12 +218,43 @@ private:
   void cleanup_impl () override;
 
   /**
-   * @brief Idle callback for the plugin UI.
+   * @brief Idles the plugin UI (called by PluginUiIdleScheduler while the UI
+   * is open).
+   *
+   * Not called from a tick callback:
+   * falktx: I am doing some checks on ildaeil/carla, and see there is
+   * a nice way without conflicts to avoid the GL context issues. it
+   * came from cardinal, where I cannot draw plugin UIs in the same
+   * function as the main stuff, because it is in between other opengl
+   * calls (before and after). the solution I found was to have a
+   * dedicated idle timer, and handle the plugin UI stuff there,
+   * outside of the main application draw function
    */
-  bool idle_cb ();
+  void idle_ui () override;
 
+  /**
+   * @brief Creates the plugin's ports, or loads the current parameter values
+   * into them if @p loading.
+   *
+   * @note This is currently disabled, along with the rest of the Carla
+   * processing code, pending the port to the new port registry.
+   *
+   * @todo When re-enabling, create the parameter ControlPorts lazily: keep
+   * the parameter metadata and values in a plain table owned by the plugin
+   * and only materialize a ControlPort for a parameter when it gets
+   * automated, mapped, modulated or shown in the UI. Plugins with thousands
+   * of parameters would otherwise register, serialize and clone thousands
+   * of ports per instance.
+   */
   void create_ports (bool loading);
 
+  /**
+   * @brief Allocates the parameter value queue for @p num_params parameters.
+   */
+  void init_param_value_queue (size_t num_params);
+
+  void send_param_value (uint32_t id, float val);
+
 public:
 #if HAVE_CARLA
   NativePluginHandle             native_plugin_handle_ = nullptr;
@@ -203,6 +264,16 @@ public:
   CarlaHostHandle host_handle_ = nullptr;
 
   NativeTimeInfo time_info_ = {};
+
+  /**
+   * MIDI events passed to Carla during processing.
+   *
+   * This can hold all the events of a MIDI port (see MAX_MIDI_EVENTS), so no
+   * events are dropped, and it is allocated once instead of on the stack each
+   * cycle.
+   */
+  std::vector<NativeMidiEvent> native_midi_events_ =
+    std::vector<NativeMidiEvent> (MAX_MIDI_EVENTS);
 #endif
 
   /** Plugin ID inside carla engine. */
@@ -214,6 +285,39 @@ public:
   /** Flag. */
   bool loading_state_ = false;
 
+  /**
+   * Latest values queued by set_param_value() (only valid for parameters
+   * whose bit is set in @ref pending_param_bits_).
+   */
+  std::unique_ptr<std::atomic<float>[]> pending_param_values_;
+
+  /** Bitmap of parameters with a queued value. */
+  std::unique_ptr<std::atomic<uint64_t>[]> pending_param_bits_;
+
+  /** Number of parameters in the queue. */
+  size_t num_queued_params_ = 0;
+
+  /** Whether any bit is set in @ref pending_param_bits_. */
+  std::atomic<bool> has_pending_param_values_ = false;
+
+  /**
+   * @brief State of a preset applied recently.
+   */
+  struct CachedPresetState
+  {
+    int         carla_program_ = 0;
+    std::string chunk_;
+  };
+
+  static constexpr size_t MAX_CACHED_PRESET_STATES = 8;
+
+  /**
+   * States of the most recently applied presets (most recent first), so that
+   * switching between them doesn't make the plugin load them again. Only used
+   * for plugins whose state is a chunk (see uses_chunks()).
+   */
+  std::vector<CachedPresetState> preset_state_cache_;
+
   /** Port ID of first audio input (for connecting inside patchbay). */
   unsigned int audio_input_port_id_ = 0;
   /** Port ID of first audio output (for connecting inside patchbay). */
@@ -232,20 +336,6 @@ public:
   /** Used when connecting Carla's internal plugin to patchbay ports. */
   std::vector<CarlaPatchbayPortInfo> patchbay_port_info_;
 
-  /**
-   * @brief Idle callback for the plugin UI.
-   *
-   * do not use tick callback:
-   * falktx: I am doing some checks on ildaeil/carla, and see there is
-   * a nice way without conflicts to avoid the GL context issues. it
-   * came from cardinal, where I cannot draw plugin UIs in the same
-   * function as the main stuff, because it is in between other opengl
-   * calls (before and after). the solution I found was to have a
-   * dedicated idle timer, and handle the plugin UI stuff there,
-   * outside of the main application draw function
-   */
-  // sigc::scoped_connection idle_connection_;
-
   /**
    * Used during processing.
    *
@@ -256,6 +346,9 @@ public:
   std::vector<const float *>      inbufs_;
   std::vector<float *>            outbufs_;
 
+  /** Buffer size given to the plugin on instantiation. */
+  nframes_t buffer_size_ = 0;
+
   unsigned int max_variant_audio_ins_ = 0;
   unsigned int max_variant_audio_outs_ = 0;
   unsigned int max_variant_cv_ins_ = 0;
@@ -1,6 +1,7 @@
 // SPDX-FileCopyrightText: © 2020-2022, 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include "dsp/stereo_gain.h"
 #include "gui/backend/backend/project.h"
 #include "gui/dsp/channel_send.h"
 #include "gui/dsp/channel_track.h"
@@ -286,25 +287,52 @@ ChannelSend::process_block (const EngineProcessTimeInfo time_nfo)
   if (track->out_signal_type_ == PortType::Audio)
     {
       const auto amount_val = get_amount_value ();
-      if (utils::math::floats_near (amount_val, 1.f, 0.00001f))
+      amount_smoother_.set_ramp_length (static_cast<size_t> (
+        static_cast<float> (AUDIO_ENGINE->sample_rate_)
+        * dsp::ParameterSmoother::DEFAULT_RAMP_TIME));
+      amount_smoother_.set_target (amount_val);
+
+      /* unless the amount is ramping, something reads the outputs or the
+       * cycle is split, let the destination mix the input directly instead
+       * of going through the outputs */
+      auto stereo_in = get_stereo_in_ports ();
+      auto stereo_out = get_stereo_out_ports ();
+      if (
+        local_offset == 0 && nframes == AUDIO_ENGINE->block_length_
+        && !amount_smoother_.is_smoothing ()
+        && !stereo_out.first.has_ring_buffer_subscribers ()
+        && !stereo_out.second.has_ring_buffer_subscribers ())
+        {
+          stereo_out.first.set_deferred_signal (stereo_in.first, amount_val);
+          stereo_out.second.set_deferred_signal (stereo_in.second, amount_val);
+          return;
+        }
+      stereo_out.first.clear_deferred_signal ();
+      stereo_out.second.clear_deferred_signal ();
+
+      if (
+        !amount_smoother_.is_smoothing ()
+        && utils::math::floats_near (amount_val, 1.f, 0.00001f))
         {
           utils::float_ranges::copy (
-            &get_stereo_out_ports ().first.buf_[local_offset],
-            &get_stereo_in_ports ().first.buf_[local_offset], nframes);
+            &stereo_out.first.buf_[local_offset],
+            &stereo_in.first.buf_[local_offset], nframes);
           utils::float_ranges::copy (
-            &get_stereo_out_ports ().second.buf_[local_offset],
-            &get_stereo_in_ports ().second.buf_[local_offset], nframes);
+            &stereo_out.second.buf_[local_offset],
+            &stereo_in.second.buf_[local_offset], nframes);
         }
       else
         {
-          utils::float_ranges::mix_product (
-            &get_stereo_out_ports ().first.buf_[local_offset],
-            &get_stereo_in_ports ().first.buf_[local_offset], amount_val,
-            nframes);
-          utils::float_ranges::mix_product (
-            &get_stereo_out_ports ().second.buf_[local_offset],
-            &get_stereo_in_ports ().second.buf_[local_offset], amount_val,
-            nframes);
+          /* both channels follow the same ramp */
+          dsp::apply_stereo_gain (
+            &stereo_out.first.buf_[local_offset],
+            &stereo_out.second.buf_[local_offset],
+            &stereo_in.first.buf_[local_offset],
+            &stereo_in.second.buf_[local_offset], nframes, 0.f, 0.f,
+            [this] (size_t, float * gains_l, float * gains_r, size_t size) {
+              amount_smoother_.fill_values (gains_l, size);
+              std::copy_n (gains_l, size, gains_r);
+            });
         }
     }
   else if (track->out_signal_type_ == PortType::Event)
@@ -467,7 +495,7 @@ ChannelSend::connect_stereo (
 #endif
 
   if (recalc_graph)
-    ROUTER->recalc_graph (false);
+    ROUTER->recalc_graph_connections ();
 
   return true;
 }
@@ -495,7 +523,7 @@ ChannelSend::connect_midi (MidiPort &port, bool recalc_graph, bool validate)
   get_enabled_port ().set_control_value (1.f, false, true);
 
   if (recalc_graph)
-    ROUTER->recalc_graph (false);
+    ROUTER->recalc_graph_connections ();
 
   return true;
 }
@@ -568,7 +596,7 @@ ChannelSend::disconnect (bool recalc_graph)
   is_sidechain_ = false;
 
   if (recalc_graph)
-    ROUTER->recalc_graph (false);
+    ROUTER->recalc_graph_connections ();
 }
 
 PortConnectionsManager *
@@ -4,6 +4,7 @@
 #ifndef __AUDIO_CHANNEL_SEND_H__
 #define __AUDIO_CHANNEL_SEND_H__
 
+#include "dsp/parameter_smoother.h"
 #include "dsp/plugin_identifier.h"
 #include "gui/dsp/audio_port.h"
 #include "gui/dsp/control_port.h"
@@ -145,6 +146,8 @@ public:
 
   std::string get_node_name () const override;
 
+  bool can_render_ahead () const override { return true; }
+
   bool is_enabled () const;
 
   bool is_empty () const { return !is_enabled (); }
@@ -205,15 +208,18 @@ public:
         throw ZrythmException ("stereo_in_left_id_ not set");
       }
     auto * l = std::get<AudioPort *> (
-      get_port_registry ().find_by_id_or_throw (stereo_in_left_id_.value ()));
+      get_port_registry ().find_by_id_or_throw (
+        stereo_in_left_id_.value (), stereo_in_left_handle_));
     auto * r = std::get<AudioPort *> (
-      get_port_registry ().find_by_id_or_throw (stereo_in_right_id_.value ()));
+      get_port_registry ().find_by_id_or_throw (
+        stereo_in_right_id_.value (), stereo_in_right_handle_));
     return { *l, *r };
   }
   MidiPort &get_midi_in_port () const
   {
     return *std::get<MidiPort *> (
-      get_port_registry ().find_by_id_or_throw (midi_in_id_.value ()));
+      get_port_registry ().find_by_id_or_throw (
+        midi_in_id_.value (), midi_in_handle_));
   }
   std::pair<AudioPort &, AudioPort &> get_stereo_out_ports () const
   {
@@ -222,25 +228,30 @@ public:
         throw ZrythmException ("stereo_out_left_id_ not set");
       }
     auto * l = std::get<AudioPort *> (
-      get_port_registry ().find_by_id_or_throw (stereo_out_left_id_.value ()));
+      get_port_registry ().find_by_id_or_throw (
+        stereo_out_left_id_.value (), stereo_out_left_handle_));
     auto * r = std::get<AudioPort *> (
-      get_port_registry ().find_by_id_or_throw (stereo_out_right_id_.value ()));
+      get_port_registry ().find_by_id_or_throw (
+        stereo_out_right_id_.value (), stereo_out_right_handle_));
     return { *l, *r };
   }
   MidiPort &get_midi_out_port () const
   {
     return *std::get<MidiPort *> (
-      get_port_registry ().find_by_id_or_throw (midi_in_id_.value ()));
+      get_port_registry ().find_by_id_or_throw (
+        midi_in_id_.value (), midi_in_handle_));
   }
   ControlPort &get_amount_port () const
   {
     return *std::get<ControlPort *> (
-      get_port_registry ().find_by_id_or_throw (amount_id_.value ()));
+      get_port_registry ().find_by_id_or_throw (
+        amount_id_.value (), amount_handle_));
   }
   ControlPort &get_enabled_port () const
   {
     return *std::get<ControlPort *> (
-      get_port_registry ().find_by_id_or_throw (enabled_id_.value ()));
+      get_port_registry ().find_by_id_or_throw (
+        enabled_id_.value (), enabled_handle_));
   }
 
   /**
@@ -359,9 +370,26 @@ public:
    */
   std::optional<PortUuid> enabled_id_;
 
+  /** Handles the port IDs above last resolved to, for the getters. */
+  utils::ObjectHandleCache stereo_in_left_handle_;
+  utils::ObjectHandleCache stereo_in_right_handle_;
+  utils::ObjectHandleCache midi_in_handle_;
+  utils::ObjectHandleCache stereo_out_left_handle_;
+  utils::ObjectHandleCache stereo_out_right_handle_;
+  utils::ObjectHandleCache amount_handle_;
+  utils::ObjectHandleCache enabled_handle_;
+
   /** If the send is a sidechain. */
   bool is_sidechain_ = false;
 
+  /**
+   * Ramps the send amount (for audio sends) so that changes don't cause
+   * zipper noise.
+   */
+  dsp::ParameterSmoother amount_smoother_{
+    dsp::ParameterSmoother::Mode::Exponential
+  };
+
   /** Pointer back to owner track. */
   // ChannelTrack * track_ = nullptr;
 
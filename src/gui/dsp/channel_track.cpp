@@ -5,7 +5,13 @@
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/dsp/channel_track.h"
+#include "gui/dsp/exporter.h"
+#include "gui/dsp/marker_track.h"
+#include "gui/dsp/pool.h"
+#include "gui/dsp/tempo_track.h"
 #include "gui/dsp/tracklist.h"
+#include "utils/hash.h"
+#include "utils/io.h"
 
 using namespace zrythm;
 
@@ -233,6 +239,166 @@ ChannelTrack::get_fader (bool post_fader)
   return nullptr;
 }
 
+void
+ChannelTrack::freeze (
+  utils::audio::BounceStep      step,
+  std::shared_ptr<ProgressInfo> progress_info)
+{
+  z_return_if_fail (
+    step == utils::audio::BounceStep::PreFader
+    || step == utils::audio::BounceStep::PostFader);
+
+  if (is_master () || out_signal_type_ != dsp::PortType::Audio)
+    {
+      throw ZrythmException (
+        fmt::format ("Track '{}' can't be frozen", name_));
+    }
+
+  if (frozen_)
+    {
+      unfreeze ();
+    }
+
+  z_info ("freezing {}...", name_);
+
+  Exporter::Settings settings;
+  settings.mode_ = Exporter::Mode::Tracks;
+  settings.set_bounce_defaults (Exporter::Format::WAV, "", name_);
+  settings.custom_start_ = dsp::Position ();
+  settings.depth_ = utils::audio::BitDepth::BIT_DEPTH_32;
+  settings.bounce_with_parents_ = false;
+  settings.bounce_step_ = step;
+  settings.disable_after_bounce_ = false;
+
+  /* mute is applied live, so render the track unmuted */
+  auto &fader = *channel_->fader_;
+  const bool was_muted = fader.get_muted ();
+  if (was_muted)
+    {
+      fader.set_muted (false, false);
+    }
+
+  TRACKLIST->get_track_span ().mark_all_tracks_for_bounce (false);
+  bounce_to_master_ = true;
+  mark_for_bounce (true, true, false, false);
+
+  Exporter exporter (settings, std::move (progress_info));
+  exporter.prepare_tracks_for_export (*AUDIO_ENGINE, *TRANSPORT);
+  exporter.export_to_file ();
+  exporter.post_export ();
+  TRACKLIST->get_track_span ().mark_all_tracks_for_bounce (false);
+
+  if (was_muted)
+    {
+      fader.set_muted (true, false);
+    }
+
+  const auto  path = exporter.get_exported_path ();
+  const auto &progress = *exporter.progress_info_;
+  if (
+    progress.get_status () != ProgressInfo::COMPLETED
+    || progress.get_completion_type () == ProgressInfo::HAS_ERROR)
+    {
+      utils::io::remove (path.string ());
+      throw ZrythmException (
+        fmt::format ("Failed to render frozen audio for track '{}'", name_));
+    }
+  if (progress.get_completion_type () == ProgressInfo::CANCELLED)
+    {
+      z_info ("freezing {} cancelled", name_);
+      return;
+    }
+
+  /* move the rendered audio to the pool */
+  auto clip = std::make_unique<AudioClip> (
+    path.string (), AUDIO_ENGINE->sample_rate_,
+    P_TEMPO_TRACK->get_current_bpm ());
+  const auto clip_id = AUDIO_POOL->add_clip (std::move (clip));
+  z_return_if_fail (clip_id >= 0);
+  AUDIO_POOL->write_clip (*AUDIO_POOL->get_clip (clip_id), false);
+  utils::io::remove (path.string ());
+
+  AudioEngine::State state;
+  AUDIO_ENGINE->wait_for_pause (state, Z_F_NO_FORCE, false);
+  pool_id_ = clip_id;
+  freeze_step_ = step;
+  freeze_fingerprint_ = get_freeze_fingerprint ();
+  frozen_ = true;
+  AUDIO_ENGINE->resume (state);
+
+  z_info ("froze {} to clip {}", name_, clip_id);
+}
+
+void
+ChannelTrack::unfreeze ()
+{
+  if (!frozen_)
+    return;
+
+  z_info ("unfreezing {}...", name_);
+
+  AudioEngine::State state;
+  AUDIO_ENGINE->wait_for_pause (state, Z_F_NO_FORCE, false);
+  frozen_ = false;
+  AUDIO_ENGINE->resume (state);
+
+  /* the file is kept until the project is saved, since the project on disk
+   * may still refer to it */
+  AUDIO_POOL->remove_clip (pool_id_, false, false);
+  pool_id_ = 0;
+  freeze_fingerprint_ = 0;
+}
+
+bool
+ChannelTrack::is_freeze_stale ()
+{
+  return frozen_ && get_freeze_fingerprint () != freeze_fingerprint_;
+}
+
+uint64_t
+ChannelTrack::get_freeze_fingerprint ()
+{
+  std::string state;
+
+  /* regions, including automation regions */
+  std::vector<Region *> regions;
+  get_regions_in_range (regions, nullptr, nullptr);
+  for (auto * region : regions)
+    {
+      std::visit (
+        [&] (auto &&r) { state += r->serialize_to_json_string ().c_str (); },
+        convert_to_variant<RegionPtrVariant> (region));
+    }
+
+  for (const auto * at : get_automation_tracklist ().ats_)
+    {
+      state += fmt::format ("|at:{}", ENUM_VALUE_TO_INT (at->automation_mode_));
+    }
+
+  std::vector<zrythm::gui::old_dsp::plugins::Plugin *> plugins;
+  channel_->get_plugins (plugins);
+  for (auto * pl : plugins)
+    {
+      state += fmt::format (
+        "|pl:{}:{}", pl->get_descriptor ().uri_, pl->is_enabled (false));
+      for (const auto * port : pl->ctrl_in_ports_)
+        {
+          state += fmt::format (",{}", port->control_);
+        }
+    }
+
+  /* the fader is only part of post-fader renders */
+  if (freeze_step_ == utils::audio::BounceStep::PostFader)
+    {
+      const auto &fader = *channel_->fader_;
+      state += fmt::format (
+        "|fader:{}:{}", fader.get_amp_port ().control_,
+        fader.get_balance_port ().control_);
+    }
+
+  return utils::hash::get_string_hash (state);
+}
+
 #if 0
 GMenu *
 ChannelTrack::generate_channel_context_menu ()
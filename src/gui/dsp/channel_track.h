@@ -7,6 +7,8 @@
 #include "gui/backend/channel.h"
 #include "gui/dsp/processable_track.h"
 
+class ProgressInfo;
+
 #define DEFINE_CHANNEL_TRACK_QML_PROPERTIES(ClassType) \
 public: \
   /* ================================================================ */ \
@@ -126,6 +128,38 @@ public:
 
   Fader::Type get_prefader_type () { return type_get_prefader_type (type_); }
 
+  /**
+   * @brief Freezes the track.
+   *
+   * The output of the track at @p step is rendered from the start of the
+   * song to its end marker into a clip in the pool, which is then played
+   * back instead of the track's regions and plugins (the plugins are skipped
+   * while the track is frozen). Anything after @p step, as well as mute and
+   * solo, is still applied live.
+   *
+   * If the track is already frozen, it is rendered again.
+   *
+   * @param step BounceStep::PreFader or BounceStep::PostFader.
+   * @param progress_info Progress of the render, if it needs to be shown or
+   * cancelled.
+   * @throw ZrythmException If the track can't be frozen or rendering failed.
+   */
+  void freeze (
+    utils::audio::BounceStep      step,
+    std::shared_ptr<ProgressInfo> progress_info = nullptr);
+
+  /**
+   * @brief Plays the track live again and drops its frozen clip from the
+   * pool.
+   */
+  void unfreeze ();
+
+  /**
+   * @brief Returns whether the regions, automation or plugin parameters of
+   * the frozen track changed since it was frozen.
+   */
+  bool is_freeze_stale ();
+
 protected:
   void
   append_member_ports (std::vector<Port *> &ports, bool include_plugins) const;
@@ -143,6 +177,11 @@ protected:
   DECLARE_DEFINE_BASE_FIELDS_METHOD ();
 
 private:
+  /**
+   * @brief Returns a hash of the state that the frozen clip depends on.
+   */
+  uint64_t get_freeze_fingerprint ();
+
   /**
    * Removes the AutomationTrack's associated with this channel from the
    * AutomationTracklist in the corresponding Track.
@@ -13,7 +13,6 @@
 ChordObject::ChordObject (QObject * parent)
     : ArrangerObject (Type::ChordObject), QObject (parent)
 {
-  ArrangerObject::parent_base_qproperties (*this);
 }
 
 ChordObject::ChordObject (
@@ -24,7 +23,6 @@ ChordObject::ChordObject (
     : ArrangerObject (Type::ChordObject), QObject (parent),
       RegionOwnedObjectImpl (region_id, index), chord_index_ (chord_index)
 {
-  ArrangerObject::parent_base_qproperties (*this);
 }
 
 void
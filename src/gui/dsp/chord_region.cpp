@@ -10,8 +10,6 @@
 ChordRegion::ChordRegion (QObject * parent)
     : ArrangerObject (Type::Region), QAbstractListModel (parent)
 {
-  ArrangerObject::parent_base_qproperties (*this);
-  BoundedObject::parent_base_qproperties (*this);
   init_colored_object ();
 }
 
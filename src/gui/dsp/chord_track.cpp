@@ -132,12 +132,10 @@ ChordTrack::clear_objects ()
 void
 ChordTrack::set_playback_caches ()
 {
-  region_snapshots_.clear ();
-  region_snapshots_.reserve (region_list_->regions_.size ());
   foreach_region ([&] (auto &region) {
     z_return_if_fail (region.track_id_ == get_uuid ());
-    region_snapshots_.push_back (region.clone_unique ());
   });
+  update_region_snapshots (*this);
 
   scale_snapshots_.clear ();
   scale_snapshots_.reserve (scales_.size ());
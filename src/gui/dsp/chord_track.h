@@ -139,9 +139,10 @@ public:
     const Position *       p1,
     const Position *       p2) override
   {
-    std::ranges::for_each (regions, [&] (auto &region) {
-      add_region_if_in_range (p1, p2, regions, region);
+    foreach_region ([&] (auto &region) {
+      add_region_if_in_range (p1, p2, regions, &region);
     });
+    AutomatableTrack::get_regions_in_range (regions, p1, p2);
   }
 
   void init_after_cloning (const ChordTrack &other, ObjectCloneType clone_type)
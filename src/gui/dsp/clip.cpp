@@ -1,11 +1,19 @@
 // SPDX-FileCopyrightText: © 2019-2022, 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+#include "gui/backend/backend/zrythm.h"
 #include "gui/dsp/clip.h"
 #include "utils/audio.h"
 #include "utils/audio_file.h"
 #include "utils/debug.h"
+#include "utils/dsp.h"
 #include "utils/exceptions.h"
+#include "utils/large_buffer_allocator.h"
 #include "utils/logger.h"
 
 #include <fmt/printf.h>
@@ -37,7 +45,9 @@ AudioClip::AudioClip (
   use_flac_ = should_use_flac (bit_depth);
   pool_id_ = -1;
 
-  ch_frames_ = buf;
+  auto frames = std::make_shared<utils::audio::AudioBuffer> ();
+  frames->makeCopyOf (buf);
+  set_shared_frames (std::move (frames));
 
   bpm_ = current_bpm;
 }
@@ -82,15 +92,34 @@ AudioClip::init_from_file (
   bit_depth_ = utils::audio::bit_depth_int_to_enum (file.metadata_.bit_depth);
   bpm_ = file.metadata_.bpm;
 
-  try
+  /* stream large files (only if they don't need resampling) */
+  const auto num_bytes =
+    static_cast<size_t> (file.metadata_.num_frames)
+    * static_cast<size_t> (file.metadata_.channels) * sizeof (float);
+  if (
+    num_bytes > STREAMING_THRESHOLD_BYTES
+    && file.metadata_.samplerate == static_cast<int> (samplerate_)
+    && gZrythm && gZrythm->audio_stream_prefetcher_)
     {
-      /* read frames into project's samplerate */
-      file.read_full (ch_frames_, samplerate_);
+      z_info (
+        "streaming '{}' ({} MiB) from disk", full_path,
+        num_bytes / (1024 * 1024));
+      init_stream (std::move (file));
     }
-  catch (ZrythmException &e)
+  else
     {
-      throw ZrythmException (
-        fmt::format ("Failed to read frames from file '{}'", full_path));
+      try
+        {
+          /* read frames into project's samplerate */
+          auto frames = std::make_shared<utils::audio::AudioBuffer> ();
+          file.read_full (*frames, samplerate_);
+          set_shared_frames (std::move (frames));
+        }
+      catch (ZrythmException &e)
+        {
+          throw ZrythmException (
+            fmt::format ("Failed to read frames from file '{}'", full_path));
+        }
     }
 
   name_ = juce::File (full_path).getFileNameWithoutExtension ().toStdString ();
@@ -102,8 +131,148 @@ AudioClip::init_from_file (
 }
 
 void
-AudioClip::init_loaded (const fs::path &full_path)
+AudioClip::init_stream (AudioFile file)
+{
+  stream_file_path_ = file.filepath_;
+  const auto num_channels = file.metadata_.channels;
+  const auto num_frames =
+    static_cast<unsigned_frame_t> (file.metadata_.num_frames);
+
+  /* the file is only read from the prefetch thread */
+  auto shared_file = std::make_shared<AudioFile> (std::move (file));
+  stream_ = std::make_shared<zrythm::dsp::AudioStreamCache> (
+    num_channels, num_frames,
+    [shared_file] (
+      utils::audio::AudioBuffer &dest, unsigned_frame_t start_frame,
+      unsigned_frame_t num_frames_to_read) {
+      if (!shared_file->reader_->read (
+            &dest, 0, static_cast<int> (num_frames_to_read),
+            static_cast<juce::int64> (start_frame), true, true))
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to read frames at {} from file '{}'", start_frame,
+            shared_file->filepath_));
+        }
+    });
+  gZrythm->audio_stream_prefetcher_->add_cache (stream_);
+  ch_frames_.setSize (num_channels, 0);
+  streaming_.store (true, std::memory_order_release);
+}
+
+const utils::audio::AudioBuffer &
+AudioClip::get_samples () const
+{
+  ensure_frames_loaded ();
+  return ch_frames_;
+}
+
+void
+AudioClip::ensure_frames_loaded () const
+{
+  if (!stream_ || ch_frames_.getNumSamples () > 0)
+    return;
+
+  z_debug ("loading all frames of streamed clip '{}'", name_);
+  try
+    {
+      AudioFile file (stream_file_path_);
+      file.read_full (ch_frames_, samplerate_);
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning (
+        "Failed to read frames from file '{}': {}", stream_file_path_,
+        e.what ());
+    }
+}
+
+void
+AudioClip::stop_streaming ()
+{
+  if (!is_streaming ())
+    return;
+
+  ensure_frames_loaded ();
+  streaming_.store (false, std::memory_order_release);
+}
+
+size_t
+AudioClip::get_memory_usage () const
+{
+  size_t ret = static_cast<size_t> (ch_frames_.getNumChannels ())
+               * static_cast<size_t> (ch_frames_.getNumSamples ())
+               * sizeof (float);
+  if (is_streaming ())
+    {
+      ret += stream_->get_memory_usage ();
+    }
+  return ret;
+}
+
+void
+AudioClip::read_frames (
+  unsigned_frame_t start_frame,
+  float *          l,
+  float *          r,
+  unsigned_frame_t num_frames) const
+{
+  if (is_streaming ())
+    {
+      std::array<float *, 2> dest{ l, r };
+      stream_->read (start_frame, dest.data (), 2, num_frames);
+      return;
+    }
+
+  const int r_ch = ch_frames_.getNumChannels () == 1 ? 0 : 1;
+  utils::float_ranges::copy (
+    l, ch_frames_.getReadPointer (0, static_cast<int> (start_frame)),
+    num_frames);
+  utils::float_ranges::copy (
+    r, ch_frames_.getReadPointer (r_ch, static_cast<int> (start_frame)),
+    num_frames);
+}
+
+void
+AudioClip::init_loaded (
+  const fs::path                &full_path,
+  const std::optional<fs::path> &decoded_cache_path)
 {
+  using DecodedAudioCache = utils::audio::DecodedAudioCache;
+
+  /* the file in the pool has the frames about to be loaded */
+  if (file_hash_ != 0)
+    {
+      written_generation_ = generation_;
+    }
+
+  /* skip decoding if the file was already decoded (the other fields are
+   * already loaded from the project) */
+  if (decoded_cache_path && file_hash_ != 0)
+    {
+      if (
+        auto cache = DecodedAudioCache::open (
+          *decoded_cache_path, samplerate_, file_hash_))
+        {
+          z_debug (
+            "using decoded cache '{}' for clip '{}'", *decoded_cache_path,
+            name_);
+          use_decoded_cache (std::move (cache));
+          return;
+        }
+    }
+
+  /* don't decode into frames shared with clones or mapped */
+  if (shared_frames_ || decoded_cache_)
+    {
+      clear_frames ();
+    }
+
+  /* fix the header if the application crashed while recording the clip */
+  if (AudioFile::repair_wav_header (full_path))
+    {
+      z_warning ("repaired unfinished recording '{}'", full_path.string ());
+    }
+
   bpm_t bpm = bpm_;
   try
     {
@@ -115,35 +284,194 @@ AudioClip::init_loaded (const fs::path &full_path)
         fmt::format ("Failed to initialize audio file: {}", e.what ()));
     }
   bpm_ = bpm;
+
+  /* cache the decoded frames for next time (streaming clips are not kept in
+   * memory anyway) */
+  if (decoded_cache_path && file_hash_ != 0 && !is_streaming ())
+    {
+      try
+        {
+          DecodedAudioCache::write (
+            *decoded_cache_path, ch_frames_, samplerate_, file_hash_);
+
+          /* let the OS page out the frames when not used */
+          if (
+            auto cache = DecodedAudioCache::open (
+              *decoded_cache_path, samplerate_, file_hash_))
+            {
+              use_decoded_cache (std::move (cache));
+            }
+        }
+      catch (const ZrythmException &e)
+        {
+          z_warning (
+            "Failed to write decoded cache for clip '{}': {}", name_,
+            e.what ());
+        }
+    }
+
+  if (
+    !shared_frames_ && !decoded_cache_ && !is_streaming ()
+    && utils::LargeBufferAllocator::is_enabled ())
+    {
+      use_large_buffer_for_frames (ch_frames_);
+    }
+}
+
+void
+AudioClip::use_decoded_cache (
+  std::shared_ptr<const utils::audio::DecodedAudioCache> cache)
+{
+  /* copy the frames out of the mapping so that they can't be paged out */
+  if (utils::LargeBufferAllocator::is_enabled ())
+    {
+      use_large_buffer_for_frames (cache->get_frames ());
+      return;
+    }
+
+  /* the view keeps the mapping alive while shared (e.g., with the
+   * timestretch cache) */
+  set_shared_frames (std::shared_ptr<utils::audio::AudioBuffer> (
+    new utils::audio::AudioBuffer (cache->get_frames ()),
+    [cache] (utils::audio::AudioBuffer * frames) { delete frames; }));
+  decoded_cache_ = std::move (cache);
+}
+
+void
+AudioClip::use_large_buffer_for_frames (
+  const utils::audio::AudioBuffer &frames)
+{
+  /* each channel starts on a cache line */
+  constexpr size_t ALIGNMENT = 64;
+  constexpr size_t floats_per_line = ALIGNMENT / sizeof (float);
+  const auto       num_channels = frames.getNumChannels ();
+  const auto       num_frames = static_cast<size_t> (frames.getNumSamples ());
+  const size_t     stride =
+    (num_frames + floats_per_line - 1) / floats_per_line * floats_per_line;
+
+  auto storage = utils::LargeBufferAllocator::allocate_floats (
+    stride * static_cast<size_t> (num_channels), ALIGNMENT);
+  std::vector<float *> channels;
+  for (int ch = 0; ch < num_channels; ++ch)
+    {
+      channels.push_back (storage.get () + static_cast<size_t> (ch) * stride);
+      std::copy_n (frames.getReadPointer (ch), num_frames, channels.back ());
+    }
+
+  /* the buffer keeps the storage alive while shared */
+  set_shared_frames (std::shared_ptr<utils::audio::AudioBuffer> (
+    new utils::audio::AudioBuffer (
+      channels.data (), num_channels, frames.getNumSamples ()),
+    [storage] (utils::audio::AudioBuffer * buf) { delete buf; }));
+}
+
+void
+AudioClip::set_shared_frames (
+  std::shared_ptr<utils::audio::AudioBuffer> frames)
+{
+  if (frames != shared_frames_)
+    {
+      peaks_ = std::make_shared<utils::audio::PeakPyramid> ();
+      onsets_ = std::make_shared<utils::audio::OnsetIndex> ();
+    }
+  ch_frames_ = utils::audio::AudioBuffer (
+    frames->getArrayOfWritePointers (), frames->getNumChannels (),
+    frames->getNumSamples ());
+  shared_frames_ = std::move (frames);
+  decoded_cache_.reset ();
+}
+
+utils::audio::AudioBuffer &
+AudioClip::get_frames_for_writing ()
+{
+  ++generation_;
+  onsets_ = std::make_shared<utils::audio::OnsetIndex> ();
+  if (decoded_cache_ || (shared_frames_ && shared_frames_.use_count () > 1))
+    {
+      /* copy-on-write (note that copy-constructing a buffer that refers to
+       * external data would only copy the reference) */
+      auto frames = std::make_shared<utils::audio::AudioBuffer> ();
+      frames->makeCopyOf (ch_frames_);
+      auto peaks = peaks_;
+      set_shared_frames (std::move (frames));
+
+      /* start from the summary of the original frames (it catches up on
+       * the next update if incomplete) */
+      peaks_ = std::make_shared<utils::audio::PeakPyramid> (*peaks);
+    }
+  else if (!shared_frames_)
+    {
+      set_shared_frames (
+        std::make_shared<utils::audio::AudioBuffer> (std::move (ch_frames_)));
+    }
+  return *shared_frames_;
+}
+
+bool
+AudioClip::has_identical_frames (const AudioClip &other) const
+{
+  if (
+    ch_frames_.getNumChannels () != other.ch_frames_.getNumChannels ()
+    || ch_frames_.getNumSamples () != other.ch_frames_.getNumSamples ())
+    return false;
+
+  const auto num_bytes =
+    static_cast<size_t> (ch_frames_.getNumSamples ()) * sizeof (float);
+  for (int ch = 0; ch < ch_frames_.getNumChannels (); ++ch)
+    {
+      if (
+        std::memcmp (
+          ch_frames_.getReadPointer (ch), other.ch_frames_.getReadPointer (ch),
+          num_bytes)
+        != 0)
+        return false;
+    }
+  return true;
+}
+
+void
+AudioClip::share_frames_with (const AudioClip &other)
+{
+  z_return_if_fail (other.shared_frames_ && !is_streaming ());
+  z_return_if_fail (has_identical_frames (other));
+
+  /* the contents don't change, so the generation (and the file in the pool)
+   * stays valid */
+  set_shared_frames (other.shared_frames_);
+  decoded_cache_ = other.decoded_cache_;
+  peaks_ = other.peaks_;
+  onsets_ = other.onsets_;
+  onsets_generation_ = generation_;
 }
 
 void
 AudioClip::init_after_cloning (const AudioClip &other, ObjectCloneType clone_type)
 {
   name_ = other.name_;
-  ch_frames_ = other.ch_frames_;
+  if (other.shared_frames_)
+    {
+      set_shared_frames (other.shared_frames_);
+      decoded_cache_ = other.decoded_cache_;
+      peaks_ = other.peaks_;
+      onsets_ = other.onsets_;
+    }
+  else
+    {
+      ch_frames_ = other.ch_frames_;
+    }
+  stream_ = other.stream_;
+  stream_file_path_ = other.stream_file_path_;
+  streaming_.store (other.is_streaming (), std::memory_order_release);
+  loaded_.store (other.is_loaded (), std::memory_order_release);
   bpm_ = other.bpm_;
   samplerate_ = other.samplerate_;
   bit_depth_ = other.bit_depth_;
   use_flac_ = other.use_flac_;
   pool_id_ = other.pool_id_;
   file_hash_ = other.file_hash_;
-}
-
-void
-AudioClip::finalize_buffered_write ()
-{
-  if (frames_written_ == 0)
-    {
-      z_debug ("nothing to write, skipping");
-      return;
-    }
-
-  z_return_if_fail (writer_);
-  z_return_if_fail (writer_path_.has_value ());
-  writer_->flush ();
-  writer_.reset ();
-  writer_path_.reset ();
+  generation_ = other.generation_;
+  written_generation_ = other.written_generation_;
+  onsets_generation_ = other.onsets_generation_;
 }
 
 void
@@ -163,6 +491,7 @@ AudioClip::replace_frames (
   const utils::audio::AudioBuffer &src_frames,
   unsigned_frame_t                 start_frame)
 {
+  stop_streaming ();
   z_return_if_fail_cmp (
     src_frames.getNumChannels (), ==, ch_frames_.getNumChannels ());
 
@@ -170,102 +499,154 @@ AudioClip::replace_frames (
    * the actual file write is skipped to save time */
   file_hash_ = 0;
 
+  auto &frames = get_frames_for_writing ();
   for (int i = 0; i < src_frames.getNumChannels (); ++i)
     {
-      ch_frames_.copyFrom (
+      frames.copyFrom (
         i, start_frame, src_frames.getReadPointer (i, 0),
         src_frames.getNumSamples ());
     }
+  peaks_->update (frames, static_cast<int64_t> (start_frame));
+}
+
+void
+AudioClip::compute_peaks_in_background (
+  const std::optional<fs::path> &peaks_path)
+{
+  if (!shared_frames_ || !gZrythm || !gZrythm->background_thread_pool_)
+    return;
+
+  /* the frames are not modified while the job refers to them (edits copy
+   * them and replace the pyramid) */
+  gZrythm->background_thread_pool_->addJob (
+    [frames = shared_frames_, peaks = peaks_, peaks_path,
+     file_hash = file_hash_] () {
+      if (peaks_path && file_hash != 0)
+        {
+          auto stored =
+            utils::audio::PeakPyramid::read (*peaks_path, file_hash);
+          if (
+            stored && stored->get_num_channels () == frames->getNumChannels ()
+            && stored->get_num_frames () == frames->getNumSamples ())
+            {
+              peaks->assign (std::move (*stored));
+              return;
+            }
+        }
+
+      utils::audio::PeakPyramid computed;
+      computed.update (*frames);
+      if (peaks_path && file_hash != 0)
+        {
+          try
+            {
+              computed.write (*peaks_path, file_hash);
+            }
+          catch (const ZrythmException &e)
+            {
+              z_warning ("Failed to write waveform peaks: {}", e.what ());
+            }
+        }
+      peaks->assign (std::move (computed));
+    });
+}
+
+void
+AudioClip::compute_onsets_in_background (
+  const std::optional<fs::path> &onsets_path)
+{
+  if (
+    !shared_frames_ || onsets_generation_ == generation_ || !gZrythm
+    || !gZrythm->background_thread_pool_)
+    return;
+
+  onsets_generation_ = generation_;
+
+  /* the frames are not modified while the job refers to them (edits copy
+   * them and replace the index) */
+  gZrythm->background_thread_pool_->addJob (
+    [frames = shared_frames_, onsets = onsets_, onsets_path,
+     file_hash = file_hash_, samplerate = samplerate_] () {
+      if (onsets_path && file_hash != 0)
+        {
+          auto stored =
+            utils::audio::OnsetIndex::read (*onsets_path, file_hash);
+          if (stored && stored->get_num_frames () == frames->getNumSamples ())
+            {
+              onsets->assign (std::move (*stored));
+              return;
+            }
+        }
+
+      utils::audio::OnsetIndex computed;
+      computed.update (*frames, samplerate);
+      if (onsets_path && file_hash != 0)
+        {
+          try
+            {
+              computed.write (*onsets_path, file_hash);
+            }
+          catch (const ZrythmException &e)
+            {
+              z_warning ("Failed to write onsets: {}", e.what ());
+            }
+        }
+      onsets->assign (std::move (computed));
+    });
 }
 
 void
 AudioClip::expand_with_frames (const utils::audio::AudioBuffer &frames)
 {
+  stop_streaming ();
   z_return_if_fail (frames.getNumChannels () == ch_frames_.getNumChannels ());
   z_return_if_fail (frames.getNumSamples () > 0);
 
   unsigned_frame_t prev_end = ch_frames_.getNumSamples ();
-  ch_frames_.setSize (
-    ch_frames_.getNumChannels (),
-    ch_frames_.getNumSamples () + frames.getNumSamples (), true, false);
-  replace_frames (frames, prev_end);
-}
+  auto            &clip_frames = get_frames_for_writing ();
+  clip_frames.setSize (
+    clip_frames.getNumChannels (),
+    clip_frames.getNumSamples () + frames.getNumSamples (), true, false);
 
-bool
-AudioClip::enough_time_elapsed_since_last_write () const
-{
-  /* write to pool if 2 seconds passed since last write */
-  auto   cur_time = get_monotonic_time_usecs ();
-  constexpr utils::MonotonicTime usec_to_wait = 2 * 1000 * 1000;
-  return cur_time - last_write_ > usec_to_wait;
+  /* refer to the reallocated frames */
+  set_shared_frames (shared_frames_);
+
+  replace_frames (frames, prev_end);
 }
 
 void
-AudioClip::write_to_file (const std::string &filepath, bool parts)
+AudioClip::write_to_file (const std::string &filepath)
 {
   z_return_if_fail (samplerate_ > 0);
-  z_return_if_fail (frames_written_ < SIZE_MAX);
-
-  auto create_writer_for_filepath = [&] () {
-    juce::File file (filepath);
-    auto       out_stream = std::make_unique<juce::FileOutputStream> (file);
-
-    if (!out_stream || !out_stream->openedOk ())
-      {
-        throw ZrythmException (
-          fmt::format ("Failed to open file '{}' for writing", filepath));
-      }
-
-    auto format = std::unique_ptr<juce::AudioFormat> (
-      use_flac_
-        ? static_cast<juce::AudioFormat *> (new juce::FlacAudioFormat ())
-        : static_cast<juce::AudioFormat *> (new juce::WavAudioFormat ()));
-
-    auto writer = std::unique_ptr<
-      juce::AudioFormatWriter> (format->createWriterFor (
-      out_stream.release (), samplerate_, get_num_channels (),
-      utils::audio::bit_depth_enum_to_int (bit_depth_), {}, 0));
-
-    if (writer == nullptr)
-      {
-        throw ZrythmException (
-          "Failed to create audio writer for file: " + filepath);
-      }
-    return writer;
-  };
 
-  const auto num_frames = get_num_frames ();
-  if (parts)
+  juce::File file (filepath);
+  auto       out_stream = std::make_unique<juce::FileOutputStream> (file);
+  if (!out_stream || !out_stream->openedOk ())
     {
-      z_return_if_fail_cmp (num_frames, >=, (int) frames_written_);
-      unsigned_frame_t nframes_to_write_this_time = num_frames - frames_written_;
-      z_return_if_fail_cmp (nframes_to_write_this_time, <, SIZE_MAX);
+      throw ZrythmException (
+        fmt::format ("Failed to open file '{}' for writing", filepath));
+    }
 
-      // create writer if first time
-      if (frames_written_ == 0)
-        {
-          writer_ = create_writer_for_filepath ();
-          writer_path_.emplace (filepath);
-        }
-      else
-        {
-          z_return_if_fail (writer_ != nullptr);
-        }
-      writer_->writeFromAudioSampleBuffer (
-        ch_frames_, frames_written_, nframes_to_write_this_time);
+  auto format = std::unique_ptr<juce::AudioFormat> (
+    use_flac_
+      ? static_cast<juce::AudioFormat *> (new juce::FlacAudioFormat ())
+      : static_cast<juce::AudioFormat *> (new juce::WavAudioFormat ()));
 
-      frames_written_ = num_frames;
-      last_write_ = get_monotonic_time_usecs ();
-    }
-  else
+  auto writer = std::unique_ptr<
+    juce::AudioFormatWriter> (format->createWriterFor (
+    out_stream.release (), samplerate_, get_num_channels (),
+    utils::audio::bit_depth_enum_to_int (bit_depth_), {}, 0));
+  if (writer == nullptr)
     {
-      z_return_if_fail_cmp (num_frames, <, (int) INT_MAX);
-      size_t nframes = num_frames;
-
-      auto writer = create_writer_for_filepath ();
-      writer->writeFromAudioSampleBuffer (ch_frames_, 0, nframes);
-      writer->flush ();
+      throw ZrythmException (
+        "Failed to create audio writer for file: " + filepath);
     }
+
+  ensure_frames_loaded ();
+  const auto num_frames = get_num_frames ();
+  z_return_if_fail_cmp (num_frames, <, (int) INT_MAX);
+  writer->writeFromAudioSampleBuffer (ch_frames_, 0, num_frames);
+  writer->flush ();
 }
 
 bool
@@ -334,7 +715,7 @@ AudioClip::edit_in_ext_program ()
   std::string abs_path = Glib::build_filename (tmp_dir, "tmp.wav");
   try
     {
-      write_to_file (abs_path, false);
+      write_to_file (abs_path);
     }
   catch (ZrythmException &e)
     {
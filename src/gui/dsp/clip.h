@@ -4,12 +4,17 @@
 #ifndef ZRYTHM_DSP_AUDIO_CLIP_H
 #define ZRYTHM_DSP_AUDIO_CLIP_H
 
+#include <atomic>
+
+#include "dsp/audio_stream_cache.h"
 #include "utils/audio.h"
 #include "utils/audio_file.h"
+#include "utils/decoded_audio_cache.h"
 #include "utils/hash.h"
 #include "utils/icloneable.h"
 #include "utils/iserializable.h"
-#include "utils/monotonic_time_provider.h"
+#include "utils/onset_index.h"
+#include "utils/peak_pyramid.h"
 #include "utils/types.h"
 
 using namespace zrythm;
@@ -21,14 +26,19 @@ using namespace zrythm;
  */
 class AudioClip final
     : public zrythm::utils::serialization::ISerializable<AudioClip>,
-      public ICloneable<AudioClip>,
-      private utils::QElapsedTimeProvider
+      public ICloneable<AudioClip>
 {
 public:
   using BitDepth = zrythm::utils::audio::BitDepth;
   using AudioFile = zrythm::utils::audio::AudioFile;
   using PoolId = int;
 
+  /**
+   * Clips whose frames would take more than this many bytes in memory are
+   * streamed from their file during playback instead of loaded.
+   */
+  static constexpr size_t STREAMING_THRESHOLD_BYTES = 512ULL * 1024 * 1024;
+
 public:
   /* Rule of 0 */
   AudioClip () = default;
@@ -119,9 +129,14 @@ public:
    * Inits after loading a Project.
    *
    * @param full_path Full path to the corresponding audio file in the pool.
+   * @param decoded_cache_path Path to the decoded audio cache of the file, if
+   * any. The frames are mapped from it if it is valid, otherwise it is
+   * (re)created after decoding the file.
    * @throw ZrythmException on error.
    */
-  void init_loaded (const fs::path &full_path);
+  void init_loaded (
+    const fs::path                &full_path,
+    const std::optional<fs::path> &decoded_cache_path = std::nullopt);
 
   /**
    * Shows a dialog with info on how to edit a file, with an option to open an
@@ -142,25 +157,54 @@ public:
   /**
    * Writes the given audio clip data to a file.
    *
-   * @param parts If true, only write new data. @see AudioClip.frames_written.
-   *
    * @throw ZrythmException on error.
    */
-  void write_to_file (const std::string &filepath, bool parts);
+  void write_to_file (const std::string &filepath);
 
   auto        get_pool_id () const { return pool_id_; }
   auto        get_bit_depth () const { return bit_depth_; }
+  auto        get_samplerate () const { return samplerate_; }
   auto        get_name () const { return name_; }
   auto        get_file_hash () const { return file_hash_; }
   auto        get_bpm () const { return bpm_; }
-  const auto &get_samples () const { return ch_frames_; }
-  auto        get_last_write_to_file () const { return last_write_; }
+
+  /**
+   * @brief Returns the clip's frames.
+   *
+   * For streaming clips, this loads all the frames into memory on first use
+   * (not realtime-safe), so playback should use read_frames() instead.
+   */
+  const utils::audio::AudioBuffer &get_samples () const;
+
   auto        get_use_flac () const { return use_flac_; }
 
-  void set_name (const std::string &name) { name_ = name; }
+  void set_name (const std::string &name)
+  {
+    name_ = name;
+    ++generation_;
+  }
   void set_pool_id (PoolId id) { pool_id_ = id; }
   void set_file_hash (utils::hash::HashT hash) { file_hash_ = hash; }
 
+  /**
+   * @brief Returns whether the clip's file in the main project's pool was
+   * written after the last change to the clip's frames or name.
+   */
+  bool is_written_to_pool () const
+  {
+    return file_hash_ != 0 && written_generation_ == generation_;
+  }
+
+  /**
+   * @brief Marks the current frames as written to the main project's pool
+   * in a file with the given hash.
+   */
+  void mark_written_to_pool (utils::hash::HashT hash)
+  {
+    file_hash_ = hash;
+    written_generation_ = generation_;
+  }
+
   /**
    * @brief Expands (appends to the end) the frames in the clip by the given
    * frames.
@@ -203,16 +247,157 @@ public:
   void clear_frames ()
   {
     ch_frames_.setSize (ch_frames_.getNumChannels (), 0, false, true);
+    shared_frames_.reset ();
+    decoded_cache_.reset ();
+    peaks_ = std::make_shared<utils::audio::PeakPyramid> ();
+    onsets_ = std::make_shared<utils::audio::OnsetIndex> ();
+  }
+
+  int get_num_channels () const
+  {
+    return is_streaming () ? stream_->get_num_channels ()
+                           : ch_frames_.getNumChannels ();
+  }
+  int get_num_frames () const
+  {
+    return is_streaming ()
+             ? static_cast<int> (stream_->get_num_frames ())
+             : ch_frames_.getNumSamples ();
+  }
+
+  /**
+   * @brief Returns the approximate number of bytes used by the clip's frames
+   * (including the streaming cache of streaming clips).
+   *
+   * Frames mapped from a decoded cache file are counted even though the
+   * system may not keep all of them in memory.
+   */
+  size_t get_memory_usage () const;
+
+  /**
+   * @brief Whether playback streams the frames from the clip's file.
+   *
+   * @see STREAMING_THRESHOLD_BYTES.
+   */
+  bool is_streaming () const
+  {
+    return streaming_.load (std::memory_order_acquire);
+  }
+
+  /**
+   * @brief Whether the clip's frames are available.
+   *
+   * This is false while the clip waits to be loaded in the background after
+   * the project was loaded (see AudioPool::start_init_loaded()). Regions
+   * using the clip are silent meanwhile.
+   */
+  bool is_loaded () const { return loaded_.load (std::memory_order_acquire); }
+
+  void set_loaded (bool loaded)
+  {
+    loaded_.store (loaded, std::memory_order_release);
+  }
+
+  /**
+   * @brief Returns the clip's frames as a shared buffer that is never
+   * modified (edits copy the frames first), or nullptr if they are not
+   * shared (e.g., streaming clips).
+   */
+  std::shared_ptr<const utils::audio::AudioBuffer> get_shared_frames () const
+  {
+    return shared_frames_;
+  }
+
+  /**
+   * @brief Returns the summary of the clip's frames used to draw waveforms.
+   *
+   * It may still be computed in the background (see
+   * compute_peaks_in_background()), in which case it is empty.
+   */
+  std::shared_ptr<const utils::audio::PeakPyramid> get_peaks () const
+  {
+    return peaks_;
   }
 
-  auto get_num_channels () const { return ch_frames_.getNumChannels (); };
-  auto get_num_frames () const { return ch_frames_.getNumSamples (); };
+  /**
+   * @brief Returns the onsets (transients) of the clip's frames.
+   *
+   * They may still be detected in the background (see
+   * compute_onsets_in_background()), in which case they are not computed
+   * yet. Changing the frames drops them until they are detected again.
+   */
+  std::shared_ptr<const utils::audio::OnsetIndex> get_onsets () const
+  {
+    return onsets_;
+  }
+
+  /**
+   * @brief Returns a number that changes whenever the frames or the name
+   * change.
+   */
+  auto get_generation () const { return generation_; }
+
+  /**
+   * @brief Returns whether the clip's frames are identical to the frames of
+   * @p other.
+   */
+  bool has_identical_frames (const AudioClip &other) const;
 
   /**
-   * @brief Finalizes buffered write to a file (when `parts` is true in @ref
-   * write_to_file()).
+   * @brief Makes the clip refer to the (identical) shared frames of @p other
+   * instead of its own copy, to save memory.
+   *
+   * Edits copy the frames first, as for clones. This must not be called
+   * while the clip may be played back, as its previous frames are freed.
+   */
+  void share_frames_with (const AudioClip &other);
+
+  /**
+   * @brief Summarizes the clip's frames in the background, or reads the
+   * summary from @p peaks_path if it is up to date.
+   *
+   * Later changes to the frames (e.g., while recording) update the summary
+   * incrementally.
+   *
+   * @param peaks_path Path to read/write the summary from/to, if any.
    */
-  void finalize_buffered_write ();
+  void compute_peaks_in_background (const std::optional<fs::path> &peaks_path);
+
+  /**
+   * @brief Detects the onsets of the clip's frames in the background, or
+   * reads them from @p onsets_path if they are up to date.
+   *
+   * Does nothing if they were already requested for the current frames.
+   *
+   * @param onsets_path Path to read/write the onsets from/to, if any.
+   */
+  void
+  compute_onsets_in_background (const std::optional<fs::path> &onsets_path);
+
+  /**
+   * @brief Copies @p num_frames frames starting at @p start_frame to @p l and
+   * @p r (mono clips are copied to both).
+   *
+   * Realtime-safe. For streaming clips, frames that are not cached yet are
+   * silent.
+   */
+  void read_frames (
+    unsigned_frame_t start_frame,
+    float *          l,
+    float *          r,
+    unsigned_frame_t num_frames) const;
+
+  /**
+   * @brief Tells the streaming cache that @p frame will likely be read soon
+   * (e.g., a loop point).
+   *
+   * Realtime-safe. Does nothing if the clip is not streaming.
+   */
+  void add_stream_hint (unsigned_frame_t frame) const
+  {
+    if (is_streaming ())
+      stream_->add_hint (frame);
+  }
 
   /**
    * @brief Used during tests to verify that the recorded file is valid.
@@ -225,12 +410,6 @@ public:
     sample_rate_t   project_sample_rate,
     bpm_t           current_bpm) const;
 
-  /**
-   * @brief Returns whether enough time has elapsed since the last write to
-   * file. This is used so that writing to file is done in chunks.
-   */
-  bool enough_time_elapsed_since_last_write () const;
-
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 private:
@@ -248,14 +427,107 @@ private:
     sample_rate_t        project_sample_rate,
     std::optional<bpm_t> bpm_to_set);
 
+  /**
+   * @brief Sets up streaming of the clip's frames from @p file.
+   *
+   * @throw ZrythmException on I/O error.
+   */
+  void init_stream (AudioFile file);
+
+  /**
+   * @brief Loads the frames of a streaming clip into @ref ch_frames_, if not
+   * loaded yet.
+   */
+  void ensure_frames_loaded () const;
+
+  /**
+   * @brief Makes @ref ch_frames_ the source of playback before editing them.
+   */
+  void stop_streaming ();
+
+  /**
+   * @brief Makes @ref ch_frames_ (and @ref shared_frames_) refer to the
+   * frames in @p cache.
+   */
+  void use_decoded_cache (
+    std::shared_ptr<const utils::audio::DecodedAudioCache> cache);
+
+  /**
+   * @brief Makes @ref ch_frames_ (and @ref shared_frames_) refer to a copy of
+   * @p frames in memory from utils::LargeBufferAllocator.
+   */
+  void use_large_buffer_for_frames (const utils::audio::AudioBuffer &frames);
+
+  /**
+   * @brief Makes @ref ch_frames_ refer to @p frames (which may be shared with
+   * clones).
+   */
+  void set_shared_frames (std::shared_ptr<utils::audio::AudioBuffer> frames);
+
+  /**
+   * @brief Returns frames that only this clip uses, copying them first if
+   * they are shared with clones or mapped from @ref decoded_cache_.
+   *
+   * @ref ch_frames_ refers to the returned frames, so it must be updated with
+   * set_shared_frames() if they get reallocated.
+   */
+  utils::audio::AudioBuffer &get_frames_for_writing ();
+
 private:
   /** Name of the clip. */
   std::string name_;
 
   /**
    * Per-channel frames.
+   *
+   * These are only loaded on demand for streaming clips. They usually refer
+   * to the frames of @ref shared_frames_ or @ref decoded_cache_ instead of
+   * owning them.
+   */
+  mutable utils::audio::AudioBuffer ch_frames_;
+
+  /**
+   * Frames shared between clones of this clip (copy-on-write, see
+   * get_frames_for_writing()).
+   */
+  std::shared_ptr<utils::audio::AudioBuffer> shared_frames_;
+
+  /**
+   * Memory-mapped decoded frames of the clip's file, if used (@ref
+   * shared_frames_ then refers to them).
    */
-  utils::audio::AudioBuffer ch_frames_;
+  std::shared_ptr<const utils::audio::DecodedAudioCache> decoded_cache_;
+
+  /**
+   * Summary of the frames of @ref shared_frames_ (replaced along with them).
+   */
+  std::shared_ptr<utils::audio::PeakPyramid> peaks_ =
+    std::make_shared<utils::audio::PeakPyramid> ();
+
+  /**
+   * Onsets of the frames of @ref shared_frames_ (replaced whenever the
+   * frames change).
+   */
+  std::shared_ptr<utils::audio::OnsetIndex> onsets_ =
+    std::make_shared<utils::audio::OnsetIndex> ();
+
+  /**
+   * @ref generation_ when the onsets were last requested (see
+   * compute_onsets_in_background()).
+   */
+  uint64_t onsets_generation_{};
+
+  /** Cache of the frames during playback of streaming clips. */
+  std::shared_ptr<zrythm::dsp::AudioStreamCache> stream_;
+
+  /** File streamed by @ref stream_. */
+  std::string stream_file_path_;
+
+  /** Whether playback reads from @ref stream_. */
+  std::atomic_bool streaming_{ false };
+
+  /** See is_loaded(). */
+  std::atomic_bool loaded_{ true };
 
   /**
    * BPM of the clip, or BPM of the project when the clip was first loaded.
@@ -282,28 +554,14 @@ private:
   /** File hash, used for checking if a clip is already written to the pool. */
   utils::hash::HashT file_hash_{};
 
-  /**
-   * Frames already written to the file, per channel.
-   *
-   * Used when writing in chunks/parts.
-   */
-  unsigned_frame_t frames_written_{};
-
-  /**
-   * Time the last write took place.
-   *
-   * This is used so that we can write every x ms instead of all the time.
-   *
-   * @see AudioClip.frames_written.
-   */
-  utils::MonotonicTime last_write_{};
+  /** Incremented whenever the frames or the name change. */
+  uint64_t generation_{ 1 };
 
   /**
-   * @brief Audio writer mainly to be used during recording to write data
-   * continuously.
+   * @ref generation_ when the clip was last written to (or loaded from) the
+   * main project's pool.
    */
-  std::unique_ptr<juce::AudioFormatWriter> writer_;
-  std::optional<fs::path>                  writer_path_;
+  uint64_t written_generation_{};
 };
 
 /**
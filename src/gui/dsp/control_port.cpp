@@ -95,6 +95,14 @@ ControlPort::set_control_value (
         {
           owner_->on_control_change_event (get_uuid (), *id_, control_);
         }
+
+      /* changes made while processing come from automation or MIDI, which
+       * the blocks rendered ahead (and cycle captures) already include */
+      if (AUDIO_ENGINE && ROUTER && !ROUTER->is_processing_thread ())
+        {
+          ROUTER->invalidate_rendered_ahead ();
+          AUDIO_ENGINE->capture_control_change (get_uuid (), control_);
+        }
     } /* endif port value changed */
 
   if (forward_event_to_plugin)
@@ -231,14 +239,20 @@ ControlPort::set_val_from_normalized (float val, bool automating)
   else if (ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::Toggle))
     {
       auto real_val = normalized_val_to_real (val);
-      if (!utils::math::floats_equal (control_, real_val))
+
+      /* go through set_control_value() so that the fader is notified */
+      if (
+        ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::FaderMute)
+        || ENUM_BITSET_TEST (id_->flags2_, PortIdentifier::Flags2::FaderSolo)
+        || ENUM_BITSET_TEST (id_->flags2_, PortIdentifier::Flags2::FaderListen))
         {
-          // EVENTS_PUSH (EventType::ET_AUTOMATION_VALUE_CHANGED, this);
-          control_ = is_val_toggled (real_val) ? 1.f : 0.f;
+          set_control_value (
+            is_val_toggled (real_val) ? 1.f : 0.f, false, true);
         }
-      if (ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::FaderMute))
+      else if (!utils::math::floats_equal (control_, real_val))
         {
-          set_control_value (is_toggled () ? 1.f : 0.f, false, true);
+          // EVENTS_PUSH (EventType::ET_AUTOMATION_VALUE_CHANGED, this);
+          control_ = is_val_toggled (real_val) ? 1.f : 0.f;
         }
     }
   else if (ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::ChannelFader))
@@ -281,9 +295,91 @@ ControlPort::set_val_from_normalized (float val, bool automating)
     }
 }
 
+void
+ControlPort::allocate_bufs ()
+{
+  automation_values_.resize (std::max (AUDIO_ENGINE->max_block_length_, 1u));
+}
+
+std::optional<std::span<const float>>
+ControlPort::get_automation_values (const EngineProcessTimeInfo &time_nfo) const
+{
+  if (
+    !has_automation_values_ || time_nfo.nframes_ == 0
+    || time_nfo.local_offset_ + time_nfo.nframes_ > automation_values_.size ())
+    {
+      return std::nullopt;
+    }
+  return std::span (automation_values_)
+    .subspan (time_nfo.local_offset_, time_nfo.nframes_);
+}
+
+float
+ControlPort::normalized_automation_val_to_real (float normalized_val) const
+{
+  if (ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::PluginControl))
+    {
+      return normalized_val_to_real (normalized_val);
+    }
+  if (ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::ChannelFader))
+    {
+      return utils::math::get_amp_val_from_fader (normalized_val);
+    }
+  if (ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::MidiAutomatable))
+    {
+      return range_.minf_ + normalized_val * (range_.maxf_ - range_.minf_);
+    }
+  return normalized_val_to_real (normalized_val);
+}
+
+void
+ControlPort::render_automation_values (
+  const AutomationTrack       &at,
+  const EngineProcessTimeInfo &time_nfo,
+  bool                         ends_after)
+{
+  if (
+    time_nfo.local_offset_ + time_nfo.nframes_ > automation_values_.size ()
+    || ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::Toggle)
+    || ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::Integer))
+    {
+      return;
+    }
+
+  const auto get_val_at_frame = [&] (unsigned_frame_t frame) {
+    const dsp::Position pos{
+      (signed_frame_t) frame, AUDIO_ENGINE->ticks_per_frame_
+    };
+    return normalized_automation_val_to_real (
+      at.get_val_at_pos (pos, true, ends_after, Z_F_USE_SNAPSHOTS));
+  };
+
+  /* evaluate every AUTOMATION_RESOLUTION frames (and at the end of the range)
+   * and interpolate linearly in between */
+  float * values = &automation_values_[time_nfo.local_offset_];
+  float   start_val = get_val_at_frame (time_nfo.g_start_frame_w_offset_);
+  for (nframes_t offset = 0; offset < time_nfo.nframes_;
+       offset += AUTOMATION_RESOLUTION)
+    {
+      const nframes_t num_frames =
+        std::min (AUTOMATION_RESOLUTION, time_nfo.nframes_ - offset);
+      const float end_val =
+        get_val_at_frame (time_nfo.g_start_frame_w_offset_ + offset + num_frames);
+      const float step = (end_val - start_val) / static_cast<float> (num_frames);
+      for (nframes_t i = 0; i < num_frames; i++)
+        {
+          values[offset + i] = start_val + step * static_cast<float> (i);
+        }
+      start_val = end_val;
+    }
+  has_automation_values_ = true;
+}
+
 void
 ControlPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
 {
+  has_automation_values_ = false;
+
   const auto owner_type = id_->owner_type_;
 
   if (
@@ -332,6 +428,8 @@ ControlPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
             pos, true, !can_read_previous_automation, Z_F_USE_SNAPSHOTS);
           set_val_from_normalized (val, true);
           value_changed_from_reading_ = true;
+          render_automation_values (
+            *at, time_nfo, !can_read_previous_automation);
         }
     }
 
@@ -4,7 +4,10 @@
 #ifndef __AUDIO_CONTROL_PORT_H__
 #define __AUDIO_CONTROL_PORT_H__
 
+#include <optional>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include "gui/dsp/port.h"
 #include "utils/icloneable.h"
@@ -249,11 +252,35 @@ public:
    */
   [[gnu::hot]] float get_control_value (const bool normalize) const;
 
-  void allocate_bufs () override { }
+  /**
+   * @brief Allocates the buffer for the values returned by
+   * get_automation_values().
+   */
+  void allocate_bufs () override;
 
+  /**
+   * @brief Reads automation (if any) and applies CV modulation.
+   *
+   * When reading automation, the value of each frame is also rendered (see
+   * get_automation_values()).
+   */
   void
   process (const EngineProcessTimeInfo time_nfo, const bool noroll) override;
 
+  /**
+   * @brief Returns the automation value (real, not normalized) of each frame
+   * of the last process() call, if it read automation.
+   *
+   * Values are evaluated every AUTOMATION_RESOLUTION frames and interpolated
+   * in between, so that consumers (e.g., Fader) can follow automation more
+   * accurately than once per block. Toggle and integer ports don't have
+   * per-frame values.
+   *
+   * @param time_nfo The time info passed to process().
+   */
+  std::optional<std::span<const float>>
+  get_automation_values (const EngineProcessTimeInfo &time_nfo) const;
+
   void clear_buffer (AudioEngine &engine) override { }
 
   void copy_metadata_from_project (const Port &project_port) override
@@ -358,6 +385,34 @@ public:
    * Only used for generic UIs.
    */
   // zrythm::gui::old_dsp::plugins::PluginGtkController * widget_ = 0;
+
+  /** Number of frames between the automation values evaluated per frame. */
+  static constexpr nframes_t AUTOMATION_RESOLUTION = 32;
+
+private:
+  /**
+   * @brief Returns the real value set_val_from_normalized() would set for
+   * @p normalized_val (for continuous ports).
+   */
+  float normalized_automation_val_to_real (float normalized_val) const;
+
+  /**
+   * @brief Fills @ref automation_values_ for the given range from @p at.
+   */
+  void render_automation_values (
+    const AutomationTrack       &at,
+    const EngineProcessTimeInfo &time_nfo,
+    bool                         ends_after);
+
+private:
+  /**
+   * Automation value of each frame of the last cycle (see
+   * get_automation_values()), indexed like audio port buffers.
+   */
+  std::vector<float> automation_values_;
+
+  /** Whether @ref automation_values_ is valid for the last process() call. */
+  bool has_automation_values_ = false;
 };
 
 /**
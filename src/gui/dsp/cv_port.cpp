@@ -8,6 +8,9 @@
 #include "utils/dsp.h"
 #include "utils/gtest_wrapper.h"
 
+#include <algorithm>
+#include <cmath>
+
 CVPort::CVPort () : CVPort ({}, {}) { }
 
 CVPort::CVPort (std::string label, PortFlow flow)
@@ -18,20 +21,35 @@ CVPort::CVPort (std::string label, PortFlow flow)
 void
 CVPort::allocate_bufs ()
 {
-  audio_ring_ = std::make_unique<RingBuffer<float>> (AudioPort::AUDIO_RING_SIZE);
+  audio_ring_ = std::make_shared<RingBuffer<float>> (AudioPort::AUDIO_RING_SIZE);
 
-  size_t max = std::max (AUDIO_ENGINE->block_length_, 1u);
-  buf_.resize (max);
+  size_t max = std::max (AUDIO_ENGINE->max_block_length_, 1u);
+  ensure_buffer_size (max);
   last_buf_sz_ = max;
 }
 
 void
 CVPort::clear_buffer (AudioEngine &engine)
+{
+  if (is_rendered_ahead ())
+    return;
+
+  clear_buffer_unconditionally (engine);
+}
+
+void
+CVPort::clear_buffer_unconditionally (const AudioEngine &engine)
 {
   utils::float_ranges::fill (
     buf_.data (), DENORMAL_PREVENTION_VAL (&engine), engine.block_length_);
 }
 
+void
+CVPort::clear_rendered_ahead_buffers ()
+{
+  clear_buffer_unconditionally (*AUDIO_ENGINE);
+}
+
 void
 CVPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
 {
@@ -43,6 +61,29 @@ CVPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
       return;
     }
 
+  /* (the buffer of ports without sources is written by their owner) */
+  if (control_rate_interval_ > 0 && !srcs_.empty ())
+    {
+      process_at_control_rate (time_nfo);
+    }
+  else
+    {
+      process_at_audio_rate (time_nfo);
+    }
+
+  if (
+    has_ring_buffer_subscribers ()
+    && time_nfo.local_offset_ + time_nfo.nframes_
+         == AUDIO_ENGINE->block_length_)
+    {
+      audio_ring_->force_write_multiple (
+        &buf_.data ()[0], AUDIO_ENGINE->block_length_);
+    }
+}
+
+void
+CVPort::process_at_audio_rate (const EngineProcessTimeInfo &time_nfo)
+{
   for (size_t k = 0; k < srcs_.size (); k++)
     {
       const auto * src_port = srcs_[k];
@@ -79,14 +120,48 @@ CVPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
             time_nfo.nframes_);
         }
     } /* foreach source */
+}
 
-  if (time_nfo.local_offset_ + time_nfo.nframes_ == AUDIO_ENGINE->block_length_)
+void
+CVPort::process_at_control_rate (const EngineProcessTimeInfo &time_nfo)
+{
+  const float     depth_range = (range_.maxf_ - range_.minf_) * 0.5f;
+  const nframes_t end = time_nfo.local_offset_ + time_nfo.nframes_;
+  for (
+    nframes_t frame = time_nfo.local_offset_; frame < end;
+    frame += control_rate_interval_)
     {
-      audio_ring_->force_write_multiple (
-        &buf_.data ()[0], AUDIO_ENGINE->block_length_);
+      /* sum the signals like at audio rate, but only for the first frame of
+       * the interval */
+      float val = buf_[frame];
+      for (size_t k = 0; k < srcs_.size (); k++)
+        {
+          const auto &conn = src_connections_[k];
+          if (!conn->enabled_)
+            continue;
+
+          val += srcs_[k]->buf_[frame] * depth_range * conn->multiplier_;
+          if (std::fabs (val) > range_.maxf_)
+            {
+              val = std::clamp (val, range_.minf_, range_.maxf_);
+            }
+        }
+
+      utils::float_ranges::fill (
+        &buf_[frame], val, std::min (control_rate_interval_, end - frame));
     }
 }
 
+void
+CVPort::update_processing_info (const nframes_t control_rate_interval)
+{
+  const bool only_feeds_control_ports =
+    !dests_.empty () && std::ranges::all_of (dests_, [] (const Port * dest) {
+      return dest->is_control ();
+    });
+  control_rate_interval_ = only_feeds_control_ports ? control_rate_interval : 0;
+}
+
 bool
 CVPort::has_sound () const
 {
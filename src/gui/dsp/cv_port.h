@@ -26,21 +26,79 @@ class CVPort final
   Q_OBJECT
   QML_ELEMENT
 public:
+  /**
+   * @brief Default number of frames CV ports processed at control rate hold
+   * each value for (see update_processing_info()).
+   */
+  static constexpr nframes_t DEFAULT_CONTROL_RATE_INTERVAL = 32;
+
   CVPort ();
   CVPort (std::string label, PortFlow flow);
 
   bool has_sound () const override;
 
+  /**
+   * @brief Sums the sources into the buffer.
+   *
+   * At control rate, the sum is only computed once per control rate interval
+   * (starting from the first frame processed) and held for the rest of the
+   * interval.
+   */
   void process (EngineProcessTimeInfo time_nfo, bool noroll) override;
 
+  /**
+   * @brief Decides whether the port is processed at control rate.
+   *
+   * Ports whose destinations are all control ports (which only read the
+   * first frame of each cycle) are processed at control rate, the rest at
+   * audio rate.
+   *
+   * To be called when building the graph, after the destinations are set.
+   *
+   * @param control_rate_interval Number of frames to hold each value for at
+   * control rate, or 0 to always process at audio rate.
+   */
+  void update_processing_info (nframes_t control_rate_interval);
+
+  /**
+   * @brief Returns the control rate interval, or 0 if the port is processed at
+   * audio rate.
+   */
+  nframes_t get_control_rate_interval () const
+  {
+    return control_rate_interval_;
+  }
+
+  /**
+   * @brief Overrides the interval decided by update_processing_info() (used by
+   * owners that know better who consumes the port).
+   */
+  void set_control_rate_interval (nframes_t control_rate_interval)
+  {
+    control_rate_interval_ = control_rate_interval;
+  }
+
   void allocate_bufs () override;
 
   void clear_buffer (AudioEngine &engine) override;
 
+  void clear_rendered_ahead_buffers () override;
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
   void
   init_after_cloning (const CVPort &other, ObjectCloneType clone_type) override;
+
+private:
+  void clear_buffer_unconditionally (const AudioEngine &engine);
+
+  /** Parts of process() for each rate. */
+  void process_at_audio_rate (const EngineProcessTimeInfo &time_nfo);
+  void process_at_control_rate (const EngineProcessTimeInfo &time_nfo);
+
+private:
+  /** See get_control_rate_interval(). */
+  nframes_t control_rate_interval_ = 0;
 };
 
 /**
@@ -29,6 +29,7 @@
 
 #include "zrythm-config.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdlib>
 
@@ -45,6 +46,7 @@
 #include "gui/dsp/engine_dummy.h"
 #include "gui/dsp/engine_jack.h"
 #include "gui/dsp/engine_pa.h"
+#include "gui/dsp/engine_pipewire.h"
 #include "gui/dsp/engine_pulse.h"
 #include "gui/dsp/engine_rtaudio.h"
 #include "gui/dsp/engine_rtmidi.h"
@@ -60,10 +62,18 @@
 #include "gui/dsp/tempo_track.h"
 #include "gui/dsp/tracklist.h"
 #include "gui/dsp/transport.h"
+#include "utils/datetime.h"
+#include "utils/directory_manager.h"
+#include "utils/dsp_context.h"
+#include "utils/env.h"
 #include "utils/gtest_wrapper.h"
+#include "utils/io.h"
 #include "utils/mpmc_queue.h"
 #include "utils/object_pool.h"
+#include "utils/rt_guard.h"
+#include "utils/rt_logger.h"
 #include "utils/rt_thread_id.h"
+#include "utils/tracing.h"
 
 #if HAVE_JACK
 #  include "weakjack/weak_libjack.h"
@@ -119,6 +129,99 @@ AudioEngine::get_dummy_input_ports ()
   return { *l, *r };
 }
 
+void
+AudioEngine::start_cycle_capture (const fs::path &path)
+{
+  auto capture = std::make_unique<dsp::CycleCapture> (
+    path, sample_rate_, std::max (max_block_length_, block_length_),
+    hw_in_processor_->audio_ports_.size ());
+
+  State state{};
+  if (activated_)
+    wait_for_pause (state, true, false);
+  std::swap (cycle_capture_, capture);
+  if (activated_)
+    resume (state);
+
+  z_info ("capturing engine cycles to {}", path);
+}
+
+void
+AudioEngine::stop_cycle_capture ()
+{
+  std::unique_ptr<dsp::CycleCapture> capture;
+  State                              state{};
+  if (activated_)
+    wait_for_pause (state, true, false);
+  std::swap (cycle_capture_, capture);
+  if (activated_)
+    resume (state);
+
+  if (capture)
+    {
+      capture->finish ();
+      z_info (
+        "captured {} engine cycles ({} dropped)",
+        capture->get_num_captured_cycles (),
+        capture->get_num_dropped_cycles ());
+    }
+}
+
+void
+AudioEngine::capture_control_change (const Port::Uuid &port_id, float value)
+{
+  if (!cycle_capture_)
+    return;
+
+  dsp::CycleCapture::ControlChange change{ .value_ = value };
+  const auto bytes = type_safe::get (port_id).toRfc4122 ();
+  std::copy_n (
+    reinterpret_cast<const uint8_t *> (bytes.constData ()),
+    std::min<size_t> (bytes.size (), change.port_id_.size ()),
+    change.port_id_.begin ());
+  cycle_capture_->queue_control_change (change);
+}
+
+void
+AudioEngine::replay_cycle (const dsp::CycleCaptureReader::Cycle &cycle)
+{
+  const auto &header = cycle.header_;
+  for (const auto &change : cycle.control_changes_)
+    {
+      const auto port_var = project_->find_port_by_id (Port::Uuid (
+        QUuid::fromRfc4122 (QByteArrayView (
+          reinterpret_cast<const char *> (change.port_id_.data ()),
+          static_cast<qsizetype> (change.port_id_.size ())))));
+      if (!port_var)
+        continue;
+
+      std::visit (
+        [&] (auto &&port) {
+          using PortT = base_type<decltype (port)>;
+          if constexpr (std::is_same_v<PortT, ControlPort>)
+            port->set_control_value (change.value_, false, true);
+        },
+        *port_var);
+    }
+
+  auto * transport = project_->transport_;
+  if (transport->playhead_pos_->getFrames () != header.playhead_frames_)
+    {
+      dsp::Position pos;
+      pos.from_frames (header.playhead_frames_, ticks_per_frame_);
+      transport->set_playhead_pos_rt_safe (pos);
+    }
+  transport->loop_ = (header.flags_ & dsp::CycleCapture::Looping) != 0;
+  transport->set_play_state_rt_safe (
+    (header.flags_ & dsp::CycleCapture::Rolling) != 0
+      ? Transport::PlayState::Rolling
+      : Transport::PlayState::Paused);
+
+  replayed_cycle_ = &cycle;
+  process (header.nframes_);
+  replayed_cycle_ = nullptr;
+}
+
 void
 AudioEngine::set_buffer_size (uint32_t buf_size)
 {
@@ -133,6 +236,19 @@ AudioEngine::set_buffer_size (uint32_t buf_size)
       z_debug ("called jack_set_buffer_size");
     }
 #endif
+#if HAVE_PIPEWIRE
+  if (audio_backend_ == AudioBackend::AUDIO_BACKEND_PIPEWIRE)
+    {
+      engine_pipewire_set_quantum (this, buf_size);
+    }
+#endif
+  if (audio_backend_ == AudioBackend::AUDIO_BACKEND_DUMMY && buf_size > 0)
+    {
+      State state{};
+      wait_for_pause (state, true, true);
+      realloc_port_buffers (buf_size);
+      resume (state);
+    }
 }
 
 void
@@ -196,49 +312,44 @@ AudioEngine::update_frames_per_tick (
         track);
     }
 
+  if (project_->tracklist_->tempo_track_)
+    {
+      project_->tracklist_->tempo_track_->update_tempo_map ();
+    }
+
   updating_frames_per_tick_ = false;
 }
 
-int
-AudioEngine::clean_duplicate_events_and_copy (std::array<Event *, 100> &ret)
+void
+AudioEngine::pop_and_coalesce_events ()
 {
-  auto &q = ev_queue_;
+  events_to_process_.clear ();
 
-  int     num_events = 0;
   Event * event = nullptr;
-  while (q.pop_front (event))
+  while (ev_queue_.pop_front (event))
     {
-      bool already_exists = false;
-
-      for (int i = 0; i < num_events; ++i)
-        {
-          if (
-            event->type_ == ret.at (i)->type_ && event->arg_ == ret.at (i)->arg_
-            && event->uint_arg_ == ret.at (i)->uint_arg_)
-            {
-              already_exists = true;
-              break;
-            }
-        }
-
-      if (already_exists)
+      auto it = std::ranges::find_if (events_to_process_, [event] (Event * ev) {
+        return ev->type_ == event->type_ && ev->arg_ == event->arg_;
+      });
+      if (it != events_to_process_.end ())
         {
+          /* only the latest value matters */
+          (*it)->uint_arg_ = event->uint_arg_;
+          (*it)->float_arg_ = event->float_arg_;
           ev_pool_.release (event);
         }
       else
         {
-          ret[num_events++] = event;
-          if (num_events == 100)
-            break;
+          events_to_process_.push_back (event);
         }
     }
-
-  return num_events;
 }
 
 bool
 AudioEngine::process_events ()
 {
+  Z_TRACE_ZONE ("AudioEngine::process_events");
+
   // we may be creating a project on a different thread
   z_warn_if_fail (ZRYTHM_IS_QT_THREAD);
 
@@ -247,28 +358,45 @@ AudioEngine::process_events ()
       return SourceFuncContinue;
     }
 
+  save_xrun_trace ();
+
   last_events_process_started_ = SteadyClock::now ();
 
-  std::array<Event *, 100> events{};
-  int num_events = clean_duplicate_events_and_copy (events);
+  pop_and_coalesce_events ();
+
+  /* top up the event pool off the realtime thread */
+  ev_pool_.refill ();
+  if (const auto num_dropped = ev_pool_.get_num_failed_acquires ();
+      num_dropped > num_dropped_events_) [[unlikely]]
+    {
+      z_warning (
+        "dropped {} engine events (at most {} were pending)",
+        num_dropped - num_dropped_events_, ev_pool_.get_high_water_mark ());
+      num_dropped_events_ = num_dropped;
+    }
+
+  if (events_to_process_.empty ())
+    {
+      return SourceFuncContinue;
+    }
 
   State state{};
   bool  need_resume = false;
-  if (activated_ && num_events > 0)
+  if (activated_)
     {
       wait_for_pause (state, true, true);
       need_resume = true;
     }
 
-  for (int i = 0; i < num_events; i++)
+  for (auto * ev : events_to_process_)
     {
-      if (i > 30)
+      z_debug ("processing engine event {}", ENUM_NAME (ev->type_));
+      if (!ev->backtrace_.empty ())
         {
-          z_warning ("more than 30 engine events processed!");
+          z_debug (
+            "event pushed from {} ({}:{}):\n{}", ev->func_, ev->file_,
+            ev->lineno_, ev->backtrace_.to_string ());
         }
-      z_debug ("processing engine event {}", i);
-
-      auto &ev = events[i];
 
       switch (ev->type_)
         {
@@ -278,6 +406,12 @@ AudioEngine::process_events ()
             {
               engine_jack_handle_buf_size_change (this, ev->uint_arg_);
             }
+#endif
+#if HAVE_PIPEWIRE
+          if (audio_backend_ == AudioBackend::AUDIO_BACKEND_PIPEWIRE)
+            {
+              engine_pipewire_handle_buf_size_change (this, ev->uint_arg_);
+            }
 #endif
           // EVENTS_PUSH (EventType::ET_ENGINE_BUFFER_SIZE_CHANGED, nullptr);
           break;
@@ -287,6 +421,12 @@ AudioEngine::process_events ()
             {
               engine_jack_handle_sample_rate_change (this, ev->uint_arg_);
             }
+#endif
+#if HAVE_PIPEWIRE
+          if (audio_backend_ == AudioBackend::AUDIO_BACKEND_PIPEWIRE)
+            {
+              engine_pipewire_handle_sample_rate_change (this, ev->uint_arg_);
+            }
 #endif
           // EVENTS_PUSH (EventType::ET_ENGINE_SAMPLE_RATE_CHANGED, nullptr);
           break;
@@ -297,9 +437,7 @@ AudioEngine::process_events ()
 
       ev_pool_.release (ev);
     }
-
-  if (num_events > 6)
-    z_warning ("More than 6 events processed. Optimization needed.");
+  events_to_process_.clear ();
 
   if (activated_ && need_resume)
     {
@@ -381,18 +519,6 @@ AudioEngine::append_ports (std::vector<Port *> &ports)
 void
 AudioEngine::pre_setup ()
 {
-#if 0
-  if (process_source_id_.connected ())
-    {
-      z_warning ("engine already processing events");
-      return;
-    }
-  z_debug ("starting event timeout");
-  process_source_id_ =
-    Glib::MainContext::get_default ()->signal_timeout ().connect (
-      sigc::mem_fun (*this, &AudioEngine::process_events), 12);
-#endif
-
   z_return_if_fail (!setup_ && !pre_setup_);
 
   int ret = 0;
@@ -406,6 +532,11 @@ AudioEngine::pre_setup ()
       ret = engine_jack_setup (this);
       break;
 #endif
+#if HAVE_PIPEWIRE
+    case AudioBackend::AUDIO_BACKEND_PIPEWIRE:
+      ret = engine_pipewire_setup (this);
+      break;
+#endif
 #if HAVE_PULSEAUDIO
     case AudioBackend::AUDIO_BACKEND_PULSEAUDIO:
       ret = engine_pulse_setup (this);
@@ -477,6 +608,11 @@ AudioEngine::pre_setup ()
         }
       break;
 #endif
+#if HAVE_PIPEWIRE
+    case MidiBackend::MIDI_BACKEND_PIPEWIRE:
+      mret = engine_pipewire_midi_setup (this);
+      break;
+#endif
 #if HAVE_RTMIDI
     case MidiBackend::MIDI_BACKEND_ALSA_RTMIDI:
     case MidiBackend::MIDI_BACKEND_JACK_RTMIDI:
@@ -580,8 +716,18 @@ AudioEngine::init_common ()
   metronome_ = std::make_unique<Metronome> (*this);
   router_ = std::make_unique<Router> (this);
 
+  events_to_process_.reserve (ENGINE_MAX_EVENTS);
+  capture_event_backtraces_ =
+    env_get_int ("ZRYTHM_ENGINE_EVENT_BACKTRACES", 0) != 0;
+  ev_notifier_ =
+    std::make_unique<utils::MainThreadNotifier> ([this] () { process_events (); });
+
   auto ab_code = AudioBackend::AUDIO_BACKEND_DUMMY;
-  if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
+  if (ZRYTHM_RENDERING)
+    {
+      ab_code = AudioBackend::AUDIO_BACKEND_DUMMY;
+    }
+  else if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
     {
       ab_code =
         gZrythm->use_pipewire_in_tests_
@@ -612,6 +758,11 @@ AudioEngine::init_common ()
       audio_backend_ = AudioBackend::AUDIO_BACKEND_JACK;
       break;
 #endif
+#if HAVE_PIPEWIRE
+    case AudioBackend::AUDIO_BACKEND_PIPEWIRE:
+      audio_backend_ = AudioBackend::AUDIO_BACKEND_PIPEWIRE;
+      break;
+#endif
 #if HAVE_PULSEAUDIO
     case AudioBackend::AUDIO_BACKEND_PULSEAUDIO:
       audio_backend_ = AudioBackend::AUDIO_BACKEND_PULSEAUDIO;
@@ -641,7 +792,11 @@ AudioEngine::init_common ()
     }
 
   auto mb_code = MidiBackend::MIDI_BACKEND_DUMMY;
-  if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
+  if (ZRYTHM_RENDERING)
+    {
+      mb_code = MidiBackend::MIDI_BACKEND_DUMMY;
+    }
+  else if (ZRYTHM_TESTING || ZRYTHM_BENCHMARKING)
     {
       mb_code =
         gZrythm->use_pipewire_in_tests_
@@ -670,6 +825,11 @@ AudioEngine::init_common ()
       midi_backend_ = MidiBackend::MIDI_BACKEND_JACK;
       break;
 #endif
+#if HAVE_PIPEWIRE
+    case MidiBackend::MIDI_BACKEND_PIPEWIRE:
+      midi_backend_ = MidiBackend::MIDI_BACKEND_PIPEWIRE;
+      break;
+#endif
 #if HAVE_RTMIDI
     case MidiBackend::MIDI_BACKEND_JACK_RTMIDI:
     case MidiBackend::MIDI_BACKEND_WINDOWS_MME_RTMIDI:
@@ -713,11 +873,16 @@ AudioEngine::init_common ()
       ? zrythm::dsp::PanAlgorithm::SineLaw
       : static_cast<zrythm::dsp::PanAlgorithm> (
           zrythm::gui::SettingsManager::get_instance ()->get_panAlgorithm ());
+  use_denormal_prevention_val_ =
+    ZRYTHM_TESTING || ZRYTHM_BENCHMARKING
+    || zrythm::gui::SettingsManager::get_instance ()
+         ->get_denormalPreventionValue ();
 
   if (block_length_ == 0)
     {
       block_length_ = 8192;
     }
+  max_block_length_ = std::max (block_length_, ENGINE_PREALLOCATED_BLOCK_LENGTH);
   if (midi_buf_size_ == 0)
     {
       midi_buf_size_ = 8192;
@@ -737,7 +902,9 @@ AudioEngine::init_loaded (Project * project)
   project_ = project;
   port_registry_ = project->get_port_registry ();
 
-  pool_->init_loaded (this);
+  /* the clips are loaded later, after the sample rate is known (see
+   * ProjectInitFlowManager) */
+  pool_->engine_ = this;
 
   control_room_->init_loaded (*port_registry_, this);
   sample_processor_->init_loaded (this);
@@ -901,9 +1068,19 @@ AudioEngine::wait_for_pause (State &state, bool force_pause, bool with_fadeout)
     }
   z_debug ("cycle finished");
 
-  /* scan for new ports here for now (why???) (TODO move this to a new thread
-   * that runs periodically) */
-  hw_in_processor_->rescan_ext_ports ();
+  /* the caller may modify anything the nodes rendered ahead use */
+  if (
+    auto * renderer = router_ ? router_->get_anticipative_renderer () : nullptr)
+    {
+      renderer->pause ();
+    }
+
+  /* backends that don't notify about port changes only pick up new ports
+   * here */
+  if (!hw_in_processor_->has_ext_port_notifications ())
+    {
+      hw_in_processor_->rescan_ext_ports ();
+    }
 
   control_room_->monitor_fader_->fading_out_.store (false);
 
@@ -920,6 +1097,8 @@ AudioEngine::wait_for_pause (State &state, bool force_pause, bool with_fadeout)
           project_->transport_->playhead_pos_->getFrames ()),
         .local_offset_ = 0,
         .nframes_ = 1,
+        .cycle_start_time_usecs_ =
+          Zrythm::getInstance ()->get_monotonic_time_usecs (),
       };
 
       router_->start_cycle (time_nfo);
@@ -937,6 +1116,12 @@ AudioEngine::resume (State &state)
       z_debug ("engine was not running - won't resume");
       return;
     }
+
+  if (
+    auto * renderer = router_ ? router_->get_anticipative_renderer () : nullptr)
+    {
+      renderer->resume ();
+    }
   project_->transport_->loop_ = state.looping_;
   if (state.playing_)
     {
@@ -999,6 +1184,9 @@ AudioEngine::activate (bool activate)
       State state{};
       wait_for_pause (state, true, true);
       activated_ = false;
+
+      /* the capture's file is committed when freed */
+      cycle_capture_.reset ();
     }
 
   if (!activate)
@@ -1012,6 +1200,12 @@ AudioEngine::activate (bool activate)
       engine_jack_activate (this, activate);
     }
 #endif
+#if HAVE_PIPEWIRE
+  if (audio_backend_ == AudioBackend::AUDIO_BACKEND_PIPEWIRE)
+    {
+      engine_pipewire_activate (this, activate);
+    }
+#endif
 #if HAVE_PULSEAUDIO
   if (audio_backend_ == AudioBackend::AUDIO_BACKEND_PULSEAUDIO)
     {
@@ -1045,6 +1239,21 @@ AudioEngine::activate (bool activate)
 
   activated_ = activate;
 
+  if (
+    activate && !cycle_capture_
+    && qEnvironmentVariableIsSet ("ZRYTHM_CYCLE_CAPTURE"))
+    {
+      try
+        {
+          start_cycle_capture (
+            qEnvironmentVariable ("ZRYTHM_CYCLE_CAPTURE").toStdString ());
+        }
+      catch (const ZrythmException &e)
+        {
+          z_warning ("failed to start the cycle capture: {}", e.what ());
+        }
+    }
+
   if (ZRYTHM_HAVE_UI && project_->loaded_)
     {
       // EVENTS_PUSH (EventType::ET_ENGINE_ACTIVATE_CHANGED, nullptr);
@@ -1056,9 +1265,26 @@ AudioEngine::activate (bool activate)
 void
 AudioEngine::realloc_port_buffers (nframes_t nframes)
 {
+  const bool fits_in_buffers = buf_size_set_ && nframes <= max_block_length_;
   block_length_ = nframes;
+  nframes_ = nframes;
   buf_size_set_ = true;
-  z_info ("Block length changed to {}. reallocating buffers...", block_length_);
+
+  /* the graph processes blocks of any length up to the buffer capacity, so
+   * there's nothing to reallocate */
+  if (fits_in_buffers)
+    {
+      z_info (
+        "Block length changed to {} (buffer capacity: {})", block_length_,
+        max_block_length_);
+      ROUTER->update_block_length ();
+      return;
+    }
+
+  max_block_length_ = std::max (nframes, ENGINE_PREALLOCATED_BLOCK_LENGTH);
+  z_info (
+    "Block length changed to {}. reallocating buffers for {} frames...",
+    block_length_, max_block_length_);
 
   /* TODO make function that fetches all plugins in the project */
   std::vector<zrythm::gui::old_dsp::plugins::Plugin *> plugins;
@@ -1072,13 +1298,69 @@ AudioEngine::realloc_port_buffers (nframes_t nframes)
           carla->update_buffer_size_and_sample_rate ();
         }
     }
-  nframes_ = nframes;
 
   ROUTER->recalc_graph (false);
 
   z_debug ("done");
 }
 
+void
+AudioEngine::rebuild_port_buffer_arena (const dsp::GraphNodeCollection &nodes)
+{
+  std::vector<std::pair<Port *, int>> ports;
+  const auto                          add_port = [&] (dsp::GraphNode &node) {
+    auto * port = dynamic_cast<Port *> (&node.get_processable ());
+    if (port && (port->is_audio () || port->is_cv ()))
+      {
+        ports.emplace_back (port, node.numa_node_);
+      }
+  };
+  for (const auto node : nodes.topological_order_)
+    {
+      add_port (node.get ());
+      for (const auto fused : node.get ().fused_nodes_)
+        {
+          add_port (fused.get ());
+        }
+    }
+
+  /* keep the buffers of each NUMA node together so that they can be moved to
+   * it (see GraphScheduler::get_numa_placement()) */
+  std::ranges::stable_sort (ports, {}, &std::pair<Port *, int>::second);
+
+  const size_t block_length = std::max (max_block_length_, 1u);
+  port_buffer_arena_.allocate (ports.size (), block_length);
+  for (const auto &[index, entry] : std::views::enumerate (ports))
+    {
+      auto * port = entry.first;
+      port->set_buffer (
+        port_buffer_arena_.get_slice (index),
+        port_buffer_arena_.get_storage ());
+      port->last_buf_sz_ = block_length;
+    }
+
+  for (auto it = ports.begin (); it != ports.end ();)
+    {
+      const auto numa_node = it->second;
+      const auto next =
+        std::ranges::find_if (it, ports.end (), [numa_node] (const auto &e) {
+          return e.second != numa_node;
+        });
+      if (numa_node >= 0)
+        {
+          port_buffer_arena_.bind_slices_to_numa_node (
+            static_cast<size_t> (it - ports.begin ()),
+            static_cast<size_t> (next - it), numa_node);
+        }
+      it = next;
+    }
+
+  z_debug (
+    "allocated {} port buffers of {} samples ({} KiB)", ports.size (),
+    block_length,
+    ports.size () * port_buffer_arena_.get_stride () * sizeof (float) / 1024);
+}
+
 void
 AudioEngine::clear_output_buffers (nframes_t nframes)
 {
@@ -1143,7 +1425,11 @@ AudioEngine::process_prepare (
   nframes_t                                  nframes,
   SemaphoreRAII<std::counting_semaphore<>> * sem)
 {
-  if (denormal_prevention_val_positive_)
+  if (!use_denormal_prevention_val_)
+    {
+      denormal_prevention_val_ = 0.f;
+    }
+  else if (denormal_prevention_val_positive_)
     {
       denormal_prevention_val_ = -1e-20f;
     }
@@ -1253,13 +1539,106 @@ AudioEngine::receive_midi_events (uint32_t nframes)
     }
 }
 
+void
+AudioEngine::apply_replayed_inputs (nframes_t nframes)
+{
+  const auto &cycle = *replayed_cycle_;
+  const auto &midi_ports = hw_in_processor_->midi_ports_;
+
+  /* MIDI input 0 is the engine's MIDI in port and the rest are the hardware
+   * inputs (see capture_cycle_inputs()) */
+  midi_in_->midi_events_.active_events_.clear ();
+  for (auto &port : midi_ports)
+    {
+      port->midi_events_.active_events_.clear ();
+    }
+  for (const auto &ev : cycle.midi_events_)
+    {
+      if (ev.input_ > midi_ports.size ()) [[unlikely]]
+        continue;
+
+      auto &port = ev.input_ == 0 ? *midi_in_ : *midi_ports[ev.input_ - 1];
+      MidiEvent midi_ev (ev.data_[0], ev.data_[1], ev.data_[2], ev.time_);
+      midi_ev.raw_buffer_sz_ = ev.size_;
+      port.midi_events_.active_events_.push_back (midi_ev);
+    }
+
+  const auto &audio_ports = hw_in_processor_->audio_ports_;
+  const auto  num_channels =
+    cycle.header_.nframes_ > 0 ? cycle.audio_.size () / cycle.header_.nframes_
+                               : 0;
+  for (size_t i = 0; i < audio_ports.size (); ++i)
+    {
+      auto buf = audio_ports[i]->buf_.first (nframes);
+      std::ranges::fill (buf, 0.f);
+      if (i < num_channels)
+        {
+          const auto frames = cycle.get_audio_channel (i);
+          std::copy_n (
+            frames.begin (), std::min<size_t> (frames.size (), nframes),
+            buf.begin ());
+        }
+    }
+}
+
+void
+AudioEngine::capture_cycle_inputs (nframes_t nframes)
+{
+  auto *   transport = project_->transport_;
+  uint32_t flags = 0;
+  if (transport->isRolling ())
+    flags |= dsp::CycleCapture::Rolling;
+  if (transport->loop_)
+    flags |= dsp::CycleCapture::Looping;
+  if (transport->recording_)
+    flags |= dsp::CycleCapture::Recording;
+  const auto &tempo_track = project_->tracklist_->tempo_track_;
+  cycle_capture_->begin_cycle ({
+    .playhead_frames_ = transport->playhead_pos_->getFrames (),
+    .graph_generation_ = router_->scheduler_->get_applied_generation (),
+    .bpm_ = tempo_track ? tempo_track->get_current_bpm () : 0.f,
+    .nframes_ = nframes,
+    .flags_ = flags,
+  });
+
+  const auto capture_midi = [this] (const MidiPort &port, uint16_t input) {
+    for (const auto &ev : port.midi_events_.active_events_)
+      {
+        cycle_capture_->add_midi_event ({
+          .time_ = ev.time_,
+          .input_ = input,
+          .size_ = static_cast<uint8_t> (ev.raw_buffer_sz_),
+          .data_ = { ev.raw_buffer_[0], ev.raw_buffer_[1], ev.raw_buffer_[2] },
+        });
+      }
+  };
+  capture_midi (*midi_in_, 0);
+  const auto &midi_ports = hw_in_processor_->midi_ports_;
+  for (size_t i = 0; i < midi_ports.size (); ++i)
+    {
+      capture_midi (*midi_ports[i], static_cast<uint16_t> (i + 1));
+    }
+
+  const auto &audio_ports = hw_in_processor_->audio_ports_;
+  for (size_t i = 0; i < audio_ports.size (); ++i)
+    {
+      cycle_capture_->set_audio_input (i, audio_ports[i]->buf_.first (nframes));
+    }
+
+  cycle_capture_->end_cycle ();
+}
+
 int
 AudioEngine::process (const nframes_t total_frames_to_process)
 {
   /* RAIIs */
-  juce::ScopedNoDenormals no_denormals;
-  AtomicBoolRAII          cycle_running (cycle_running_);
-  SemaphoreRAII           port_operation_sem (port_operation_lock_);
+  DspContextRAII                dsp_context;
+  zrythm::utils::RtGuard::Scope rt_guard_scope;
+  AtomicBoolRAII                cycle_running (cycle_running_);
+  SemaphoreRAII                 port_operation_sem (port_operation_lock_);
+
+  Z_TRACE_FRAME_MARK ("Engine cycle");
+  Z_TRACE_ZONE ("AudioEngine::process");
 
   if (ZRYTHM_TESTING)
     {
@@ -1275,6 +1654,13 @@ AudioEngine::process (const nframes_t total_frames_to_process)
   /* calculate timestamps (used for synchronizing external events like Windows
    * MME MIDI) */
   timestamp_start_ = Zrythm::getInstance ()->get_monotonic_time_usecs ();
+  if (sample_rate_ > 0)
+    {
+      telemetry_.record_cycle_start (
+        timestamp_start_,
+        (static_cast<RtDuration> (total_frames_to_process) * 1'000'000)
+          / sample_rate_);
+    }
   // timestamp_end_ = timestamp_start_ + (total_frames_to_process * 1000000) /
   // sample_rate_;
 
@@ -1318,6 +1704,18 @@ AudioEngine::process (const nframes_t total_frames_to_process)
   /* process HW processor to get audio/MIDI data from hardware */
   hw_in_processor_->process (total_frames_to_process);
 
+  if (replayed_cycle_) [[unlikely]]
+    {
+      apply_replayed_inputs (total_frames_to_process);
+    }
+  if (cycle_capture_) [[unlikely]]
+    {
+      capture_cycle_inputs (total_frames_to_process);
+    }
+
+  /* so that the faders don't need to go through all the tracks */
+  project_->tracklist_->update_solo_state ();
+
   nframes_t total_frames_remaining = total_frames_to_process;
 
   /* --- handle preroll --- */
@@ -1329,6 +1727,7 @@ AudioEngine::process (const nframes_t total_frames_to_process)
       (unsigned_frame_t) transport_->playhead_pos_->getFrames (),
     .local_offset_ = 0,
     .nframes_ = 0,
+    .cycle_start_time_usecs_ = timestamp_start_,
   };
 
   while (remaining_latency_preroll_ > 0)
@@ -1524,6 +1923,88 @@ AudioEngine::post_process (const nframes_t roll_nframes, const nframes_t nframes
     {
       max_time_taken_ = last_time_taken;
     }
+
+  /* check whether we missed the deadline */
+  const auto budget_usecs =
+    (static_cast<RtDuration> (nframes) * 1'000'000) / sample_rate_;
+  telemetry_.record_cycle_end (last_time_taken, budget_usecs);
+  if (last_time_taken > budget_usecs) [[unlikely]]
+    {
+      notify_xrun ();
+    }
+
+  /* adapt realtime stretching/resampling quality to the load */
+  const double dsp_load =
+    budget_usecs > 0
+      ? 100.0 * static_cast<double> (last_time_taken)
+          / static_cast<double> (budget_usecs)
+      : 0.0;
+  if (quality_governor_.record_cycle (
+        dsp_load, last_time_taken > budget_usecs, exporting_.load (),
+        timestamp_start_ + last_time_taken)) [[unlikely]]
+    {
+      z_rt_info (
+        "DSP load {:.0f}%: using {} quality for realtime stretching and "
+        "resampling",
+        quality_governor_.get_smoothed_load (),
+        quality_governor_.is_reduced () ? "reduced" : "full");
+    }
+}
+
+void
+AudioEngine::notify_xrun ()
+{
+  telemetry_.record_xrun (Zrythm::getInstance ()->get_monotonic_time_usecs ());
+
+  if (!router_ || !router_->scheduler_)
+    return;
+
+  if (auto * recorder = router_->scheduler_->get_trace_recorder ())
+    {
+      recorder->freeze ();
+    }
+}
+
+void
+AudioEngine::save_xrun_trace ()
+{
+  constexpr auto MIN_SAVE_INTERVAL = std::chrono::seconds (10);
+
+  auto * recorder =
+    router_ && router_->scheduler_
+      ? router_->scheduler_->get_trace_recorder ()
+      : nullptr;
+  if (!recorder || !recorder->is_frozen ())
+    return;
+
+  /* keep the recorder frozen until we can save again */
+  const auto now = SteadyClock::now ();
+  if (
+    last_xrun_trace_saved_ != SteadyTimePoint{}
+    && now - last_xrun_trace_saved_ < MIN_SAVE_INTERVAL)
+    return;
+  last_xrun_trace_saved_ = now;
+
+  const auto budget = std::chrono::nanoseconds (
+    (static_cast<int64_t> (block_length_) * 1'000'000'000) / sample_rate_);
+  try
+    {
+      auto * dir_mgr = DirectoryManager::getInstance ();
+      const auto path =
+        fs::path (
+          dir_mgr->get_dir (DirectoryManager::DirectoryType::USER_PROFILING))
+        / fmt::format (
+          "xrun-{}.json", utils::datetime::get_for_filename ());
+      utils::io::set_file_contents (
+        path, recorder->to_chrome_trace_json (budget));
+      z_warning ("xrun: saved DSP trace of the last cycles to {}", path);
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("failed to save xrun trace: {}", e.what ());
+    }
+
+  recorder->reset ();
 }
 
 void
@@ -1697,8 +2178,6 @@ AudioEngine::set_default_backends (bool reset_to_dummy)
 void
 AudioEngine::stop_events ()
 {
-  // process_source_id_.disconnect ();
-
   if (activated_)
     {
       /* process any remaining events - clear the queue. */
@@ -1751,6 +2230,11 @@ AudioEngine::~AudioEngine ()
       engine_jack_tear_down (this);
       break;
 #endif
+#if HAVE_PIPEWIRE
+    case AudioBackend::AUDIO_BACKEND_PIPEWIRE:
+      engine_pipewire_tear_down (this);
+      break;
+#endif
 #if HAVE_RTAUDIO
     case AudioBackend::AUDIO_BACKEND_ALSA_RTAUDIO:
     case AudioBackend::AUDIO_BACKEND_JACK_RTAUDIO:
@@ -1788,8 +2272,9 @@ void
 EngineProcessTimeInfo::print () const
 {
   z_info (
-    "Global start frame: {} (with offset {}) | local offset: {} | num frames: {}",
-    g_start_frame_, g_start_frame_w_offset_, local_offset_, nframes_);
+    "Global start frame: {} (with offset {}) | local offset: {} | num frames: {} | cycle start time: {}",
+    g_start_frame_, g_start_frame_w_offset_, local_offset_, nframes_,
+    cycle_start_time_usecs_);
 }
 
 AudioEngine *
@@ -13,7 +13,10 @@
 
 #include "zrythm-config.h"
 
+#include "dsp/cycle_capture.h"
+#include "dsp/engine_telemetry.h"
 #include "dsp/panning.h"
+#include "dsp/quality_governor.h"
 #include "gui/backend/channel.h"
 #include "gui/dsp/audio_port.h"
 #include "gui/dsp/control_room.h"
@@ -23,9 +26,11 @@
 #include "gui/dsp/pool.h"
 #include "gui/dsp/sample_processor.h"
 #include "gui/dsp/transport.h"
+#include "utils/aligned_buffer_arena.h"
 #include "utils/audio.h"
 #include "utils/backtrace.h"
 #include "utils/concurrency.h"
+#include "utils/main_thread_notifier.h"
 #include "utils/object_pool.h"
 #include "utils/types.h"
 
@@ -37,6 +42,10 @@
 #  include <pulse/pulseaudio.h>
 #endif
 
+#if HAVE_PIPEWIRE
+class PipeWireClient;
+#endif
+
 #ifdef HAVE_PORT_AUDIO
 #  include <portaudio.h>
 #endif
@@ -49,6 +58,10 @@ namespace zrythm::gui::old_dsp::plugins
 {
 class Plugin;
 }
+namespace zrythm::dsp
+{
+class GraphNodeCollection;
+}
 class Tracklist;
 class ExtPort;
 class MidiMappings;
@@ -75,20 +88,45 @@ constexpr int MIDI_BUF_SIZE = 1024;
 
 constexpr int ENGINE_MAX_EVENTS = 128;
 
+/**
+ * Maximum number of events that can be pending at once (the event pool is
+ * refilled up to this many events while processing events).
+ */
+constexpr int ENGINE_MAX_PENDING_EVENTS = ENGINE_MAX_EVENTS * 4;
+
+/**
+ * Minimum capacity of the port buffers, so that switching between common
+ * block lengths doesn't need reallocations (see
+ * AudioEngine::realloc_port_buffers()).
+ */
+constexpr nframes_t ENGINE_PREALLOCATED_BLOCK_LENGTH = 2048;
+
 /**
  * Push events.
+ *
+ * Realtime-safe: the event is dropped if too many events are pending (see
+ * AudioEngine::ev_pool_).
  */
 #define ENGINE_EVENTS_PUSH(et, _arg, _uint_arg, _float_arg) \
   { \
     auto _ev = AUDIO_ENGINE->ev_pool_.acquire (); \
-    _ev->file_ = __FILE__; \
-    _ev->func_ = __func__; \
-    _ev->lineno_ = __LINE__; \
-    _ev->type_ = et; \
-    _ev->arg_ = (void *) _arg; \
-    _ev->uint_arg_ = _uint_arg; \
-    _ev->float_arg_ = _float_arg; \
-    AUDIO_ENGINE->ev_queue_.push_back (_ev); \
+    if (_ev) [[likely]] \
+      { \
+        _ev->file_ = __FILE__; \
+        _ev->func_ = __func__; \
+        _ev->lineno_ = __LINE__; \
+        _ev->type_ = et; \
+        _ev->arg_ = (void *) _arg; \
+        _ev->uint_arg_ = _uint_arg; \
+        _ev->float_arg_ = _float_arg; \
+        if (AUDIO_ENGINE->capture_event_backtraces_) [[unlikely]] \
+          _ev->backtrace_.capture (); \
+        else \
+          _ev->backtrace_.clear (); \
+        if (!AUDIO_ENGINE->ev_queue_.push_back (_ev)) [[unlikely]] \
+          AUDIO_ENGINE->ev_pool_.release (_ev); \
+        AUDIO_ENGINE->ev_notifier_->notify (); \
+      } \
   }
 
 enum class AudioBackend
@@ -110,6 +148,7 @@ enum class AudioBackend
   AUDIO_BACKEND_WASAPI_LIBSOUNDIO,
   AUDIO_BACKEND_WASAPI_RTAUDIO,
   AUDIO_BACKEND_ASIO_RTAUDIO,
+  AUDIO_BACKEND_PIPEWIRE,
 };
 
 static inline bool
@@ -155,6 +194,7 @@ enum class MidiBackend
   MIDI_BACKEND_WINDOWS_MME_RTMIDI,
   MIDI_BACKEND_COREMIDI_RTMIDI,
   MIDI_BACKEND_WINDOWS_UWP_RTMIDI,
+  MIDI_BACKEND_PIPEWIRE,
 };
 
 static inline bool
@@ -208,6 +248,8 @@ public:
 
   /**
    * Audio engine event.
+   *
+   * Pushing an event doesn't allocate (see ENGINE_EVENTS_PUSH()).
    */
   class Event
   {
@@ -223,7 +265,12 @@ public:
     const char * file_ = nullptr;
     const char * func_ = nullptr;
     int          lineno_ = 0;
-    std::string  backtrace_;
+
+    /**
+     * Where the event was pushed from, if @ref
+     * AudioEngine::capture_event_backtraces_ is enabled.
+     */
+    utils::RawBacktrace backtrace_;
   };
 
   /**
@@ -312,8 +359,9 @@ public:
 
   bool has_handled_buffer_size_change () const
   {
-    return audio_backend_ != AudioBackend::AUDIO_BACKEND_JACK
-           || (audio_backend_ == AudioBackend::AUDIO_BACKEND_JACK && handled_jack_buffer_size_change_.load());
+    return (audio_backend_ != AudioBackend::AUDIO_BACKEND_JACK
+            && audio_backend_ != AudioBackend::AUDIO_BACKEND_PIPEWIRE)
+           || handled_jack_buffer_size_change_.load ();
   }
 
   bool is_in_active_project () const override;
@@ -331,8 +379,28 @@ public:
    */
   void wait_for_pause (State &state, bool force_pause, bool with_fadeout);
 
+  /**
+   * @brief Applies a block length change.
+   *
+   * If @p buf_size fits in the buffers already allocated (see @ref
+   * max_block_length_), only the block length is updated. Otherwise, the port
+   * buffers are reallocated, plugins are notified and the graph is rebuilt.
+   *
+   * Must be called with the engine paused.
+   */
   void realloc_port_buffers (nframes_t buf_size);
 
+  /**
+   * @brief Moves the buffers of the audio and CV ports in @p nodes into a
+   * single cache-aligned allocation, in processing order.
+   *
+   * If the nodes are assigned to NUMA nodes, the buffers are grouped by NUMA
+   * node and the memory of each group is moved to its node.
+   *
+   * @note Must be called while not processing.
+   */
+  void rebuild_port_buffer_arena (const dsp::GraphNodeCollection &nodes);
+
   /**
    * @brief
    *
@@ -389,10 +457,19 @@ public:
     bool                bpm_change);
 
   /**
-   * Timeout function to be called periodically by Glib.
+   * Processes the queued events.
+   *
+   * Called on the main thread when events are pushed (see @ref ev_notifier_),
+   * and directly when the events must be handled immediately.
    */
   bool process_events ();
 
+  /**
+   * @brief Saves the DSP trace frozen by notify_xrun() to the profiling
+   * directory, if any, and resumes recording.
+   */
+  void save_xrun_trace ();
+
   /**
    * To be called by each implementation to prepare the structures before
    * processing.
@@ -424,6 +501,18 @@ public:
   [[gnu::hot]] void
   post_process (const nframes_t roll_nframes, const nframes_t nframes);
 
+  /**
+   * @brief Called when a cycle missed its deadline or the backend reported an
+   * xrun.
+   *
+   * Records the xrun in @ref telemetry_ and freezes the DSP trace recorder
+   * (if enabled) so that the cycles leading up to the xrun are saved by the
+   * next process_events().
+   *
+   * Realtime-safe.
+   */
+  void notify_xrun ();
+
   /**
    * Called to fill in the external buffers at the end of the processing cycle.
    */
@@ -442,7 +531,8 @@ public:
   /**
    * Request the backend to set the buffer size.
    *
-   * The backend is expected to call the buffer size change callbacks.
+   * The backend is expected to call the buffer size change callbacks. The
+   * dummy backend applies the change directly.
    *
    * @see jack_set_buffer_size().
    */
@@ -467,13 +557,47 @@ public:
   std::pair<AudioPort &, AudioPort &> get_monitor_out_ports ();
   std::pair<AudioPort &, AudioPort &> get_dummy_input_ports ();
 
+  /**
+   * @brief Starts recording the inputs of each cycle to @p path (see
+   * dsp::CycleCapture), replacing the running capture if any.
+   *
+   * Also started on activation if the ZRYTHM_CYCLE_CAPTURE environment
+   * variable is set to a path.
+   *
+   * @throw ZrythmException If the file could not be opened.
+   */
+  void start_cycle_capture (const fs::path &path);
+
+  /**
+   * @brief Stops the running cycle capture (if any) and commits its file.
+   *
+   * @throw ZrythmException If writing the file failed.
+   */
+  void stop_cycle_capture ();
+
+  /**
+   * @brief Records a control change made outside the processing thread, if
+   * a cycle capture is running.
+   */
+  void capture_control_change (const Port::Uuid &port_id, float value);
+
+  /**
+   * @brief Processes a captured cycle deterministically: applies its control
+   * changes and transport state and processes it with its inputs instead of
+   * the ones received from the backend.
+   *
+   * Meant for replaying captures offline, with the backend not running.
+   */
+  void replay_cycle (const dsp::CycleCaptureReader::Cycle &cycle);
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 private:
   /**
-   * Cleans duplicate events and copies the events to the given vector.
+   * Pops all the queued events into @ref events_to_process_, merging events
+   * of the same type and target (the last event's arguments are kept).
    */
-  int clean_duplicate_events_and_copy (std::array<Event *, 100> &ret);
+  void pop_and_coalesce_events ();
 
   [[gnu::cold]] void init_common ();
 
@@ -488,6 +612,17 @@ private:
 
   void receive_midi_events (uint32_t nframes);
 
+  /**
+   * @brief Replaces the received inputs with the ones of @ref
+   * replayed_cycle_.
+   */
+  void apply_replayed_inputs (nframes_t nframes);
+
+  /**
+   * @brief Records the inputs of the current cycle in @ref cycle_capture_.
+   */
+  void capture_cycle_inputs (nframes_t nframes);
+
   /**
    * @brief Stops events from getting fired.
    *
@@ -515,11 +650,22 @@ public:
   void * client_ = nullptr;
 #endif
 
+#if HAVE_PIPEWIRE
+  /**
+   * PipeWire connection (when using the PipeWire backend).
+   *
+   * Shared with the exposed ports, which need it until they are destroyed.
+   */
+  std::shared_ptr<PipeWireClient> pw_client_;
+#endif
+
   /**
    * Whether pending jack buffer change was handled (buffers reallocated).
    *
    * To be set to zero when a change starts and 1 when the change is fully
    * processed.
+   *
+   * Also used by the PipeWire backend for quantum and rate changes.
    */
   std::atomic_bool handled_jack_buffer_size_change_ = false;
 
@@ -537,6 +683,14 @@ public:
   /** Audio buffer size (block length), per channel. */
   nframes_t block_length_ = 0;
 
+  /**
+   * @brief Capacity of the port buffers in frames (at least @ref
+   * block_length_).
+   *
+   * Plugins are prepared for blocks of up to this length.
+   */
+  nframes_t max_block_length_ = 0;
+
   /** Size of MIDI port buffers in bytes. */
   size_t midi_buf_size_ = 0;
 
@@ -557,6 +711,9 @@ public:
   /** The processing graph router. */
   std::unique_ptr<Router> router_;
 
+  /** See rebuild_port_buffer_arena(). */
+  utils::AlignedBufferArena port_buffer_arena_;
+
   /** Input device processor. */
   std::unique_ptr<HardwareProcessor> hw_in_processor_;
 
@@ -695,6 +852,16 @@ public:
    */
   std::unique_ptr<juce::Thread> dummy_audio_thread_;
 
+  /**
+   * @brief Whether the dummy backend processes cycles as fast as the graph
+   * allows instead of at wall-clock pace.
+   *
+   * Used for headless rendering and benchmarks.
+   *
+   * @see engine_dummy_freewheel().
+   */
+  std::atomic_bool dummy_freewheel_{ false };
+
   /* note: these 2 are ignored at the moment */
   /** Pan law. */
   dsp::PanLaw pan_law_ = {};
@@ -715,6 +882,27 @@ public:
    */
   RtDuration max_time_taken_{};
 
+  /**
+   * @brief Timing statistics of the callbacks and xruns, collected the same
+   * way for all backends.
+   */
+  dsp::EngineTelemetry telemetry_;
+
+  /**
+   * @brief Whether realtime stretchers and resamplers should use their
+   * faster, lower quality modes (updated after each cycle).
+   */
+  dsp::QualityGovernor quality_governor_;
+
+  /**
+   * @brief Records the inputs of each cycle while set (see
+   * start_cycle_capture()).
+   */
+  std::unique_ptr<dsp::CycleCapture> cycle_capture_;
+
+  /** Cycle whose inputs are used instead of the received ones, if any. */
+  const dsp::CycleCaptureReader::Cycle * replayed_cycle_ = nullptr;
+
   /** Timestamp at the start of the current cycle. */
   RtTimePoint timestamp_start_{};
 
@@ -748,6 +936,14 @@ public:
    */
   SteadyTimePoint last_xrun_notification_;
 
+  /**
+   * Last time the trace of an xrun was saved.
+   *
+   * Traces are saved at most once every few seconds so that a burst of xruns
+   * doesn't flood the profiling directory.
+   */
+  SteadyTimePoint last_xrun_trace_saved_;
+
   /**
    * Whether the denormal prevention value (1e-12 ~ 1e-20) is positive.
    *
@@ -760,6 +956,16 @@ public:
   bool  denormal_prevention_val_positive_ = true;
   float denormal_prevention_val_ = 1e-12f;
 
+  /**
+   * Whether to use @ref denormal_prevention_val_ when clearing buffers
+   * (otherwise it is 0).
+   *
+   * Denormals are already flushed to zero on the realtime threads (see
+   * DspContextRAII), so this is only needed for code that doesn't respect
+   * that (e.g., some plugins), at the cost of a tiny DC offset.
+   */
+  bool use_denormal_prevention_val_ = true;
+
   /**
    * If this is on, only tracks/regions marked as "for bounce" will be
    * allowed to make sound.
@@ -788,15 +994,35 @@ public:
    * The engine will skip processing while the queue still has events or is
    * currently processing events.
    */
-  MPMCQueue<Event *> ev_queue_{ ENGINE_MAX_EVENTS };
+  MPMCQueue<Event *> ev_queue_{ ENGINE_MAX_PENDING_EVENTS };
 
   /**
    * Object pool of event structs to avoid allocation.
+   *
+   * This is a realtime pool: pushing events never allocates, and the pool
+   * is refilled (up to ENGINE_MAX_PENDING_EVENTS) in process_events().
+   */
+  ObjectPool<Event> ev_pool_{ ENGINE_MAX_EVENTS, ENGINE_MAX_PENDING_EVENTS };
+
+  /**
+   * Number of events dropped because @ref ev_pool_ was empty, as of the last
+   * process_events() (to report new drops).
+   */
+  size_t num_dropped_events_ = 0;
+
+  /**
+   * Whether to capture a backtrace when pushing events, to be logged when
+   * they are processed (for debugging - see ZRYTHM_ENGINE_EVENT_BACKTRACES).
+   */
+  bool capture_event_backtraces_ = false;
+
+  /**
+   * Wakes up the main thread to call process_events() when events are pushed.
    */
-  ObjectPool<Event> ev_pool_{ ENGINE_MAX_EVENTS };
+  std::unique_ptr<utils::MainThreadNotifier> ev_notifier_;
 
-  /** ID of the event processing source func. */
-  // sigc::scoped_connection process_source_id_;
+  /** Events being processed (reused to avoid allocations). */
+  std::vector<Event *> events_to_process_;
 
   /** Whether currently processing events. */
   bool processing_events_ = false;
@@ -22,21 +22,24 @@ public:
 
   void run () override
   {
-    double secs_per_block =
-      (double) engine_.block_length_ / engine_.sample_rate_;
-    auto sleep_time = (unsigned_frame_t) (secs_per_block * 1000.0 * 1000);
-
     z_info ("Running dummy audio engine thread for first time");
 
-    std::optional<DspContextRAII> dsp_context;
-    if (ZRYTHM_USE_OPTIMIZED_DSP)
-      {
-        dsp_context.emplace ();
-      }
+    DspContextRAII dsp_context;
 
     while (!threadShouldExit ())
       {
         engine_.process (engine_.block_length_);
+
+        /* when freewheeling, only sleep while the engine is not running to
+         * avoid spinning */
+        if (engine_.dummy_freewheel_.load () && engine_.run_.load ())
+          continue;
+
+        /* the block length may change while running (see
+         * AudioEngine::set_buffer_size()) */
+        double secs_per_block =
+          (double) engine_.block_length_ / engine_.sample_rate_;
+        auto sleep_time = (unsigned_frame_t) (secs_per_block * 1000.0 * 1000);
         std::this_thread::sleep_for (std::chrono::microseconds (sleep_time));
       }
 
@@ -53,31 +56,33 @@ engine_dummy_setup (AudioEngine * self)
   /* Set audio engine properties */
   self->midi_buf_size_ = 4096;
 
-#if 0
-  if (ZRYTHM_HAVE_UI && zrythm_app->buf_size_ > 0)
+  /* allow overriding the configuration for headless runs (CI renders,
+   * benchmarks) */
+  bool ok = false;
+  const int block_length =
+    qEnvironmentVariableIntValue ("ZRYTHM_DUMMY_BLOCK_LENGTH", &ok);
+  if (ok && block_length > 0)
     {
-      self->block_length_ = (nframes_t) zrythm_app->buf_size_;
+      self->block_length_ = static_cast<nframes_t> (block_length);
     }
-  else
+  const int sample_rate =
+    qEnvironmentVariableIntValue ("ZRYTHM_DUMMY_SAMPLE_RATE", &ok);
+  if (ok && sample_rate > 0)
     {
-      self->block_length_ = 256;
+      self->sample_rate_ = static_cast<sample_rate_t> (sample_rate);
     }
-
-  if (zrythm_app->samplerate_ > 0)
+  if (qEnvironmentVariableIsSet ("ZRYTHM_DUMMY_FREEWHEEL"))
     {
-      self->sample_rate_ = (nframes_t) zrythm_app->samplerate_;
+      self->dummy_freewheel_ = true;
     }
-  else
-    {
-      self->sample_rate_ = 44100;
-    }
-#endif
 
   int beats_per_bar =
     self->project_->tracklist_->tempo_track_->get_beats_per_bar ();
   z_warn_if_fail (beats_per_bar >= 1);
 
-  z_info ("Dummy Engine set up [samplerate: {}]", self->sample_rate_);
+  z_info (
+    "Dummy Engine set up [samplerate: {}, block length: {}, freewheel: {}]",
+    self->sample_rate_, self->block_length_, self->dummy_freewheel_.load ());
 
   return 0;
 }
@@ -123,3 +128,35 @@ void
 engine_dummy_tear_down (AudioEngine * self)
 {
 }
+
+unsigned_frame_t
+engine_dummy_freewheel (AudioEngine * self, unsigned_frame_t nframes)
+{
+  z_return_val_if_fail (
+    self->audio_backend_ == AudioBackend::AUDIO_BACKEND_DUMMY && self->run_, 0);
+
+  const bool thread_was_running =
+    self->dummy_audio_thread_ && self->dummy_audio_thread_->isThreadRunning ();
+  if (thread_was_running)
+    {
+      self->dummy_audio_thread_->signalThreadShouldExit ();
+      self->dummy_audio_thread_->waitForThreadToExit (-1);
+    }
+
+  unsigned_frame_t num_cycles = 0;
+  while (nframes > 0)
+    {
+      const auto cycle_frames = static_cast<nframes_t> (
+        std::min<unsigned_frame_t> (nframes, self->block_length_));
+      self->process (cycle_frames);
+      nframes -= cycle_frames;
+      ++num_cycles;
+    }
+
+  if (thread_was_running)
+    {
+      self->dummy_audio_thread_->startThread ();
+    }
+
+  return num_cycles;
+}
@@ -4,6 +4,8 @@
 #ifndef __AUDIO_ENGINE_DUMMY_H__
 #define __AUDIO_ENGINE_DUMMY_H__
 
+#include "utils/types.h"
+
 class AudioEngine;
 
 /**
@@ -27,4 +29,16 @@ engine_dummy_activate (AudioEngine * self, bool activate);
 void
 engine_dummy_tear_down (AudioEngine * self);
 
+/**
+ * @brief Processes @p nframes frames in the calling thread, as fast as the
+ * graph allows.
+ *
+ * The dummy audio thread (if running) is stopped during this and restarted
+ * afterwards.
+ *
+ * @return The number of cycles processed.
+ */
+unsigned_frame_t
+engine_dummy_freewheel (AudioEngine * self, unsigned_frame_t nframes);
+
 #endif
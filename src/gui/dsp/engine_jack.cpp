@@ -266,6 +266,8 @@ process_cb (nframes_t nframes, void * data)
 static int
 xrun_cb (AudioEngine * self)
 {
+  self->notify_xrun ();
+
   auto cur_time = SteadyClock::now ();
   if ((cur_time - self->last_xrun_notification_).count () > 6000000)
     {
@@ -358,9 +360,23 @@ port_registration_cb (jack_port_id_t port_id, int registered, void * arg)
   AudioEngine * self = (AudioEngine *) arg;
 
   jack_port_t * jport = jack_port_by_id (self->client_, port_id);
-  z_info (
-    "JACK: port '%s' %sregistered", jack_port_name (jport),
-    registered ? "" : "un");
+  if (!jport)
+    return;
+
+  const char * name = jack_port_name (jport);
+  z_info ("JACK: port '{}' {}registered", name, registered ? "" : "un");
+
+  /* let the hardware processors pick up (or drop) the port instead of
+   * rescanning all ports */
+  for (
+    auto * hw_processor :
+    { self->hw_in_processor_.get (), self->hw_out_processor_.get () })
+    {
+      if (hw_processor)
+        {
+          hw_processor->notify_ext_port_change (name, registered != 0);
+        }
+    }
 }
 
 static void
@@ -35,6 +35,11 @@ port_audio_stream_cb (
   PaStreamCallbackFlags            status_flags,
   AudioEngine *                    self)
 {
+  if (status_flags & (paInputOverflow | paOutputUnderflow))
+    {
+      self->notify_xrun ();
+    }
+
   engine_process (self, (nframes_t) nframes);
 
   float * outf = (float *) out;
@@ -0,0 +1,483 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-config.h"
+
+#if HAVE_PIPEWIRE
+
+#  include "gui/backend/backend/settings_manager.h"
+#  include "gui/backend/backend/zrythm.h"
+#  include "gui/dsp/engine.h"
+#  include "gui/dsp/engine_pipewire.h"
+#  include "gui/dsp/port_backend.h"
+#  include "gui/dsp/tempo_track.h"
+#  include "utils/dsp.h"
+#  include "utils/math.h"
+
+#  include <pipewire/filter.h>
+#  include <pipewire/pipewire.h>
+#  include <spa/control/control.h>
+#  include <spa/pod/builder.h>
+#  include <spa/pod/iter.h>
+
+using namespace zrythm;
+
+PipeWireClient::PipeWireClient ()
+{
+  pw_init (nullptr, nullptr);
+}
+
+PipeWireClient::~PipeWireClient ()
+{
+  if (loop_)
+    {
+      pw_thread_loop_stop (loop_);
+    }
+  if (filter_)
+    {
+      pw_filter_destroy (filter_);
+    }
+  if (loop_)
+    {
+      pw_thread_loop_destroy (loop_);
+    }
+  pw_deinit ();
+}
+
+PipeWireClient::LoopLock::LoopLock (PipeWireClient &client) : client_ (client)
+{
+  pw_thread_loop_lock (client_.loop_);
+}
+
+PipeWireClient::LoopLock::~LoopLock ()
+{
+  pw_thread_loop_unlock (client_.loop_);
+}
+
+/**
+ * Called by PipeWire in its data thread once per graph cycle.
+ */
+static void
+on_process (void * data, spa_io_position * position)
+{
+  auto * self = static_cast<AudioEngine *> (data);
+  auto  &client = *self->pw_client_;
+
+  const auto nframes = static_cast<nframes_t> (position->clock.duration);
+  const auto sample_rate =
+    static_cast<sample_rate_t> (position->clock.rate.denom);
+  ++client.cycle_;
+  client.cycle_nframes_ = nframes;
+
+  /* the driver changed the rate or quantum: skip cycles (the ports output
+   * nothing) until the engine switches to them on the GUI thread */
+  if (sample_rate != self->sample_rate_)
+    {
+      if (client.pending_sample_rate_.exchange (sample_rate) != sample_rate)
+        {
+          self->handled_jack_buffer_size_change_.store (false);
+          ENGINE_EVENTS_PUSH (
+            AudioEngine::AudioEngineEventType::
+              AUDIO_ENGINE_EVENT_SAMPLE_RATE_CHANGE,
+            nullptr, sample_rate, 0.f);
+        }
+      return;
+    }
+  if (nframes != self->block_length_)
+    {
+      if (client.pending_block_length_.exchange (nframes) != nframes)
+        {
+          self->handled_jack_buffer_size_change_.store (false);
+          ENGINE_EVENTS_PUSH (
+            AudioEngine::AudioEngineEventType::
+              AUDIO_ENGINE_EVENT_BUFFER_SIZE_CHANGE,
+            nullptr, nframes, 0.f);
+        }
+      return;
+    }
+
+  self->process (nframes);
+}
+
+static const pw_filter_events filter_events = {
+  .version = PW_VERSION_FILTER_EVENTS,
+  .process = on_process,
+};
+
+int
+engine_pipewire_setup (AudioEngine * self)
+{
+  z_info ("Setting up PipeWire...");
+
+  auto client = std::make_shared<PipeWireClient> ();
+  client->loop_ = pw_thread_loop_new ("zrythm-pipewire", nullptr);
+  if (!client->loop_)
+    {
+      z_warning ("Failed to create PipeWire thread loop");
+      return -1;
+    }
+
+  /* request the project's settings - the driver may still choose others, in
+   * which case the engine follows it */
+  self->sample_rate_ =
+    static_cast<sample_rate_t> (AudioEngine::samplerate_enum_to_int (
+      static_cast<AudioEngine::SampleRate> (
+        gui::SettingsManager::sampleRate ())));
+  self->block_length_ =
+    static_cast<nframes_t> (AudioEngine::buffer_size_enum_to_int (
+      static_cast<AudioEngine::BufferSize> (
+        gui::SettingsManager::audioBufferSize ())));
+  const auto latency =
+    fmt::format ("{}/{}", self->block_length_, self->sample_rate_);
+  const auto rate = fmt::format ("1/{}", self->sample_rate_);
+
+  client->filter_ = pw_filter_new_simple (
+    pw_thread_loop_get_loop (client->loop_), PROGRAM_NAME,
+    pw_properties_new (
+      PW_KEY_MEDIA_TYPE, "Audio", PW_KEY_MEDIA_CATEGORY, "Duplex",
+      PW_KEY_MEDIA_ROLE, "DSP", PW_KEY_NODE_LATENCY, latency.c_str (),
+      PW_KEY_NODE_RATE, rate.c_str (), PW_KEY_NODE_ALWAYS_PROCESS, "true",
+      nullptr),
+    &filter_events, self);
+  if (!client->filter_)
+    {
+      z_warning ("Failed to create PipeWire filter");
+      return -1;
+    }
+
+  /* process directly in the data thread, and only once activated */
+  if (
+    pw_filter_connect (
+      client->filter_,
+      static_cast<pw_filter_flags> (
+        PW_FILTER_FLAG_RT_PROCESS | PW_FILTER_FLAG_INACTIVE),
+      nullptr, 0)
+    < 0)
+    {
+      z_warning ("Failed to connect PipeWire filter");
+      return -1;
+    }
+
+  if (pw_thread_loop_start (client->loop_) < 0)
+    {
+      z_warning ("Failed to start PipeWire thread loop");
+      return -1;
+    }
+
+  self->pw_client_ = std::move (client);
+  self->handled_jack_buffer_size_change_.store (true);
+
+  z_info (
+    "PipeWire set up [requested sample rate: {}, quantum: {}]",
+    self->sample_rate_, self->block_length_);
+  return 0;
+}
+
+int
+engine_pipewire_midi_setup (AudioEngine * self)
+{
+  if (!self->pw_client_)
+    {
+      z_warning (
+        "The PipeWire MIDI backend can only be used with the PipeWire audio "
+        "backend");
+      return -1;
+    }
+
+  z_info ("Setting up PipeWire MIDI...");
+  self->midi_buf_size_ = 4096;
+  return 0;
+}
+
+int
+engine_pipewire_activate (AudioEngine * self, bool activate)
+{
+  z_return_val_if_fail (self->pw_client_, -1);
+
+  PipeWireClient::LoopLock lock (*self->pw_client_);
+  if (pw_filter_set_active (self->pw_client_->filter_, activate) < 0)
+    {
+      z_warning (
+        "Failed to {} PipeWire filter", activate ? "activate" : "deactivate");
+      return -1;
+    }
+
+  z_info ("PipeWire {}", activate ? "activated" : "deactivated");
+  return 0;
+}
+
+void
+engine_pipewire_tear_down (AudioEngine * self)
+{
+  /* the filter is destroyed once the exposed ports release it too */
+  self->pw_client_.reset ();
+}
+
+void
+engine_pipewire_set_quantum (AudioEngine * self, nframes_t quantum)
+{
+  z_return_if_fail (self->pw_client_);
+
+  z_info ("Requesting PipeWire quantum {}", quantum);
+
+  const auto quantum_str = fmt::format ("{}", quantum);
+  const auto latency = fmt::format ("{}/{}", quantum, self->sample_rate_);
+  const spa_dict_item items[] = {
+    { PW_KEY_NODE_FORCE_QUANTUM, quantum_str.c_str () },
+    { PW_KEY_NODE_LATENCY,       latency.c_str ()     },
+  };
+  const spa_dict dict = {
+    .flags = 0,
+    .n_items = std::size (items),
+    .items = items,
+  };
+
+  PipeWireClient::LoopLock lock (*self->pw_client_);
+  pw_filter_update_properties (self->pw_client_->filter_, nullptr, &dict);
+}
+
+void
+engine_pipewire_handle_buf_size_change (AudioEngine * self, nframes_t frames)
+{
+  self->realloc_port_buffers (frames);
+  self->pw_client_->pending_block_length_.store (0);
+  self->handled_jack_buffer_size_change_.store (true);
+  z_info ("PipeWire: Block length changed to {}", self->block_length_);
+}
+
+void
+engine_pipewire_handle_sample_rate_change (
+  AudioEngine * self,
+  sample_rate_t sample_rate)
+{
+  self->sample_rate_ = sample_rate;
+
+  if (P_TEMPO_TRACK)
+    {
+      int beats_per_bar = P_TEMPO_TRACK->get_beats_per_bar ();
+      self->update_frames_per_tick (
+        beats_per_bar, P_TEMPO_TRACK->get_current_bpm (), self->sample_rate_,
+        true, true, false);
+    }
+
+  self->pw_client_->pending_sample_rate_.store (0);
+  self->handled_jack_buffer_size_change_.store (true);
+  z_info ("PipeWire: Sample rate changed to {}", sample_rate);
+}
+
+PipeWirePortBackend::~PipeWirePortBackend ()
+{
+  if (is_exposed ())
+    {
+      unexpose ();
+    }
+}
+
+void
+PipeWirePortBackend::sum_data (float * buf, FrameRange range)
+{
+  const auto * in = static_cast<const float *> (
+    pw_filter_get_dsp_buffer (port_data_, client_->cycle_nframes_));
+  if (!in)
+    return;
+
+  utils::float_ranges::add2 (
+    &buf[range.start_frame], &in[range.start_frame], range.nframes);
+}
+
+void
+PipeWirePortBackend::sum_data (
+  MidiEvents               &midi_events,
+  FrameRange                range,
+  IsMidiChannelAcceptedFunc approve_func)
+{
+  auto * pod = static_cast<spa_pod *> (
+    pw_filter_get_dsp_buffer (port_data_, client_->cycle_nframes_));
+  if (!pod || !spa_pod_is_sequence (pod))
+    return;
+
+  spa_pod_control * c{};
+  SPA_POD_SEQUENCE_FOREACH (reinterpret_cast<spa_pod_sequence *> (pod), c)
+  {
+    if (c->type != SPA_CONTROL_Midi)
+      continue;
+
+    if (
+      c->offset < range.start_frame
+      || c->offset >= range.start_frame + range.nframes)
+      continue;
+
+    auto *     midi_data = static_cast<midi_byte_t *> (SPA_POD_BODY (&c->value));
+    const auto size = SPA_POD_BODY_SIZE (&c->value);
+    const midi_byte_t channel = midi_data[0] & 0xf;
+    if (size == 3 && approve_func (channel))
+      {
+        midi_events.active_events_.add_event_from_buf (
+          c->offset, midi_data, static_cast<int> (size));
+      }
+  }
+}
+
+void
+PipeWirePortBackend::send_data (const float * buf, FrameRange range)
+{
+  auto * out = static_cast<float *> (
+    pw_filter_get_dsp_buffer (port_data_, client_->cycle_nframes_));
+  if (!out)
+    return;
+
+  utils::float_ranges::copy (
+    &out[range.start_frame], &buf[range.start_frame], range.nframes);
+}
+
+void *
+PipeWirePortBackend::get_midi_output_buffer ()
+{
+  void * buf = pw_filter_get_dsp_buffer (port_data_, client_->cycle_nframes_);
+  if (!buf)
+    return nullptr;
+
+  if (midi_out_cycle_ != client_->cycle_)
+    {
+      spa_pod_builder builder{};
+      spa_pod_builder_init (
+        &builder, buf,
+        static_cast<uint32_t> (client_->cycle_nframes_ * sizeof (float)));
+      spa_pod_frame frame{};
+      spa_pod_builder_push_sequence (&builder, &frame, 0);
+      spa_pod_builder_pop (&builder, &frame);
+      midi_out_size_ = builder.state.offset;
+      midi_out_cycle_ = client_->cycle_;
+    }
+  return buf;
+}
+
+void
+PipeWirePortBackend::send_data (const MidiEvents &midi_events, FrameRange range)
+{
+  void * buf = get_midi_output_buffer ();
+  if (!buf)
+    return;
+
+  /* append to the sequence started in this cycle */
+  spa_pod_builder builder{};
+  spa_pod_builder_init (
+    &builder, buf,
+    static_cast<uint32_t> (client_->cycle_nframes_ * sizeof (float)));
+  builder.state.offset = midi_out_size_;
+  for (const auto &ev : midi_events.active_events_)
+    {
+      if (
+        ev.time_ < range.start_frame
+        || ev.time_ >= range.start_frame + range.nframes)
+        {
+          continue;
+        }
+
+      if (
+        spa_pod_builder_control (&builder, ev.time_, SPA_CONTROL_Midi) < 0
+        || spa_pod_builder_bytes (
+             &builder, ev.raw_buffer_.data (), ev.raw_buffer_sz_)
+             < 0)
+        {
+          z_warning ("PipeWire MIDI output buffer full, dropping events");
+          break;
+        }
+      midi_out_size_ = builder.state.offset;
+    }
+
+  auto * seq = static_cast<spa_pod_sequence *> (buf);
+  seq->pod.size = midi_out_size_ - sizeof (spa_pod);
+}
+
+void
+PipeWirePortBackend::expose (
+  const dsp::PortIdentifier &id,
+  PortDesignationProvider    designation_provider)
+{
+  if (!id.is_input () && !id.is_output ())
+    {
+      z_return_if_reached ();
+    }
+
+  const char * format = nullptr;
+  switch (id.type_)
+    {
+    case dsp::PortType::Audio:
+      format = "32 bit float mono audio";
+      break;
+    case dsp::PortType::Event:
+      format = "8 bit raw midi";
+      break;
+    default:
+      z_return_if_reached ();
+    }
+
+  const auto label = designation_provider ();
+  z_info ("exposing port {} to PipeWire", label);
+
+  PipeWireClient::LoopLock lock (*client_);
+  if (port_data_ == nullptr)
+    {
+      port_data_ = pw_filter_add_port (
+        client_->filter_,
+        id.is_input () ? PW_DIRECTION_INPUT : PW_DIRECTION_OUTPUT,
+        PW_FILTER_PORT_FLAG_MAP_BUFFERS, sizeof (void *),
+        pw_properties_new (
+          PW_KEY_FORMAT_DSP, format, PW_KEY_PORT_NAME, label.c_str (), nullptr),
+        nullptr, 0);
+      z_return_if_fail (port_data_);
+    }
+  else
+    {
+      const spa_dict_item items[] = {
+        { PW_KEY_PORT_NAME, label.c_str () },
+      };
+      const spa_dict dict = {
+        .flags = 0,
+        .n_items = std::size (items),
+        .items = items,
+      };
+      pw_filter_update_properties (client_->filter_, port_data_, &dict);
+    }
+}
+
+void
+PipeWirePortBackend::unexpose ()
+{
+  if (!is_exposed ())
+    return;
+
+  PipeWireClient::LoopLock lock (*client_);
+  if (pw_filter_remove_port (port_data_) < 0)
+    {
+      z_warning ("Failed to remove PipeWire port");
+    }
+  port_data_ = nullptr;
+}
+
+void
+PipeWirePortBackend::clear_backend_buffer (dsp::PortType type, nframes_t nframes)
+{
+  z_return_if_fail (port_data_ != nullptr);
+  if (type == dsp::PortType::Audio)
+    {
+      if (auto * buf = get_audio_buffer_for_cycle (nframes))
+        {
+          utils::float_ranges::fill (buf, utils::math::ALMOST_SILENCE, nframes);
+        }
+    }
+  else if (type == dsp::PortType::Event)
+    {
+      /* starts an empty sequence if nothing was sent yet */
+      get_midi_output_buffer ();
+    }
+}
+
+float *
+PipeWirePortBackend::get_audio_buffer_for_cycle (nframes_t nframes)
+{
+  return static_cast<float *> (pw_filter_get_dsp_buffer (port_data_, nframes));
+}
+
+#endif /* HAVE_PIPEWIRE */
@@ -0,0 +1,121 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __AUDIO_ENGINE_PIPEWIRE_H__
+#define __AUDIO_ENGINE_PIPEWIRE_H__
+
+#include "zrythm-config.h"
+
+#include "gui/dsp/engine.h"
+
+#if HAVE_PIPEWIRE
+
+struct pw_thread_loop;
+struct pw_filter;
+
+/**
+ * @addtogroup dsp
+ *
+ * @{
+ */
+
+/**
+ * @brief Connection to PipeWire.
+ *
+ * The engine is a single filter node whose ports are the ports exposed to the
+ * backend (see PipeWirePortBackend). The filter is processed directly in
+ * PipeWire's data thread, driven by the graph driver, so there is no extra
+ * buffering between PipeWire and the engine.
+ */
+class PipeWireClient
+{
+public:
+  PipeWireClient ();
+  ~PipeWireClient ();
+  Z_DISABLE_COPY_MOVE (PipeWireClient)
+
+  /**
+   * @brief Locks the thread loop (required for any call on the filter from
+   * outside the processing thread).
+   */
+  class LoopLock
+  {
+  public:
+    explicit LoopLock (PipeWireClient &client);
+    ~LoopLock ();
+    Z_DISABLE_COPY_MOVE (LoopLock)
+
+  private:
+    PipeWireClient &client_;
+  };
+
+public:
+  pw_thread_loop * loop_ = nullptr;
+  pw_filter *      filter_ = nullptr;
+
+  /**
+   * @brief Incremented at the start of each cycle (only accessed from the
+   * processing thread).
+   *
+   * Used by the ports to know when a new cycle's buffers begin.
+   */
+  uint64_t cycle_ = 0;
+
+  /** Quantum of the current cycle (only accessed from the processing thread). */
+  nframes_t cycle_nframes_ = 0;
+
+  /**
+   * @brief Quantum/rate reported by the driver that the engine hasn't
+   * switched to yet (0 if none).
+   *
+   * Used to avoid queuing the same change multiple times.
+   */
+  std::atomic<nframes_t>     pending_block_length_ = 0;
+  std::atomic<sample_rate_t> pending_sample_rate_ = 0;
+};
+
+/**
+ * Sets up the PipeWire audio backend.
+ *
+ * @return 0 on success.
+ */
+int
+engine_pipewire_setup (AudioEngine * self);
+
+/**
+ * Sets up the PipeWire MIDI backend (requires the PipeWire audio backend).
+ *
+ * @return 0 on success.
+ */
+int
+engine_pipewire_midi_setup (AudioEngine * self);
+
+int
+engine_pipewire_activate (AudioEngine * self, bool activate);
+
+void
+engine_pipewire_tear_down (AudioEngine * self);
+
+/**
+ * @brief Asks the graph to run with the given quantum (block length).
+ *
+ * The engine switches to it once the driver applies it (see
+ * engine_pipewire_handle_buf_size_change()).
+ */
+void
+engine_pipewire_set_quantum (AudioEngine * self, nframes_t quantum);
+
+void
+engine_pipewire_handle_buf_size_change (AudioEngine * self, nframes_t frames);
+
+void
+engine_pipewire_handle_sample_rate_change (
+  AudioEngine * self,
+  sample_rate_t sample_rate);
+
+/**
+ * @}
+ */
+
+#endif /* HAVE_PIPEWIRE */
+#endif /* header guard */
@@ -95,6 +95,8 @@ engine_pulse_stream_underflow_callback (pa_stream * stream, void * userdata)
 {
   AudioEngine * self = (AudioEngine *) userdata;
 
+  self->notify_xrun ();
+
   if (self->pulse_notified_underflow_)
     return;
 
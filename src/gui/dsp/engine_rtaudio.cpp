@@ -80,6 +80,7 @@ audio_cb (
     {
       /* xrun */
       // z_warning("XRUN in RtAudio");
+      self->notify_xrun ();
     }
 
   if (!self->run_.load ())
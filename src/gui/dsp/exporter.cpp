@@ -3,9 +3,17 @@
 
 #include "zrythm-config.h"
 
+#include <array>
+#include <condition_variable>
 #include <cstdio>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <optional>
 
 #include "dsp/ditherer.h"
+#include "dsp/loudness_meter.h"
 #include "gui/backend/backend/settings_manager.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/backend/channel.h"
@@ -40,6 +48,233 @@ using namespace zrythm;
 
 #define AMPLITUDE (1.0 * 0x7F000000)
 
+namespace
+{
+
+/**
+ * @brief Dithers and writes rendered blocks to an audio file on its own
+ * thread, so that rendering doesn't wait for the encoder.
+ *
+ * The loudness of the blocks is measured on the same thread, so that it's
+ * known once the file is written without having to read it again.
+ *
+ * Blocks are passed through a bounded queue: push() waits while the encoder
+ * is QUEUE_LENGTH blocks behind.
+ */
+class BlockEncoder
+{
+public:
+  static constexpr size_t QUEUE_LENGTH = 4;
+
+  /**
+   * @param dither_bit_depth Bit depth to dither to, if dithering.
+   */
+  BlockEncoder (
+    juce::AudioFormatWriter &writer,
+    sample_rate_t            sample_rate,
+    int                      num_channels,
+    nframes_t                block_length,
+    std::optional<int>       dither_bit_depth)
+      : writer_ (writer)
+  {
+    loudness_meter_.init (
+      static_cast<float> (sample_rate), static_cast<size_t> (num_channels));
+    for (size_t i = 0; i < QUEUE_LENGTH; ++i)
+      {
+        blocks_[i].setSize (num_channels, (int) block_length);
+        free_blocks_.push_back (i);
+      }
+    if (dither_bit_depth)
+      {
+        dither_ = true;
+        ditherer_.reset (*dither_bit_depth);
+      }
+    encoding_ = std::async (std::launch::async, [this] { run (); });
+  }
+
+  ~BlockEncoder ()
+  {
+    if (encoding_.valid ())
+      {
+        stop ();
+        encoding_.wait ();
+      }
+  }
+
+  Z_DISABLE_COPY_MOVE (BlockEncoder)
+
+  /**
+   * @brief Waits for a free block, passes it to @p fill and queues its first
+   * @p nframes frames for writing.
+   *
+   * @throw ZrythmException If writing a previous block failed.
+   */
+  void push (
+    nframes_t                                              nframes,
+    const std::function<void (utils::audio::AudioBuffer &)> &fill)
+  {
+    size_t index = 0;
+    {
+      std::unique_lock lock (mutex_);
+      cv_.wait (lock, [this] { return !free_blocks_.empty () || failed_; });
+      if (failed_)
+        {
+          lock.unlock ();
+          finish ();
+          throw ZrythmException ("Failed to write audio data");
+        }
+      index = free_blocks_.back ();
+      free_blocks_.pop_back ();
+    }
+
+    fill (blocks_[index]);
+
+    {
+      std::lock_guard lock (mutex_);
+      queued_blocks_.push_back ({ index, nframes });
+    }
+    cv_.notify_all ();
+  }
+
+  /**
+   * @brief Waits until the queued blocks are written.
+   *
+   * @return The largest amplitude above 1 written, or 0 if the audio didn't
+   * clip.
+   * @throw ZrythmException If writing failed.
+   */
+  float finish ()
+  {
+    stop ();
+    encoding_.get ();
+    return clip_amp_;
+  }
+
+  /**
+   * @brief Returns the loudness of the blocks written (only valid after
+   * finish()).
+   */
+  Exporter::Loudness get_loudness () const
+  {
+    return {
+      .integrated_lufs_ = loudness_meter_.get_integrated_loudness (),
+      .range_lu_ = loudness_meter_.get_loudness_range (),
+      .true_peak_dbtp_ =
+        utils::math::amp_to_dbfs (loudness_meter_.get_true_peak ()),
+    };
+  }
+
+private:
+  struct QueuedBlock
+  {
+    size_t    index_;
+    nframes_t nframes_;
+  };
+
+  void stop ()
+  {
+    {
+      std::lock_guard lock (mutex_);
+      stopping_ = true;
+    }
+    cv_.notify_all ();
+  }
+
+  void run ()
+  {
+    try
+      {
+        while (true)
+          {
+            QueuedBlock queued{};
+            {
+              std::unique_lock lock (mutex_);
+              cv_.wait (
+                lock, [this] { return !queued_blocks_.empty () || stopping_; });
+              if (queued_blocks_.empty ())
+                return;
+
+              queued = queued_blocks_.front ();
+              queued_blocks_.pop_front ();
+            }
+
+            encode (blocks_[queued.index_], queued.nframes_);
+
+            {
+              std::lock_guard lock (mutex_);
+              free_blocks_.push_back (queued.index_);
+            }
+            cv_.notify_all ();
+          }
+      }
+    catch (...)
+      {
+        {
+          std::lock_guard lock (mutex_);
+          failed_ = true;
+        }
+        cv_.notify_all ();
+        throw;
+      }
+  }
+
+  void encode (utils::audio::AudioBuffer &block, nframes_t nframes)
+  {
+    /* clipping detection */
+    const float max_amp = block.getMagnitude (0, (int) nframes);
+    if (max_amp > 1.f && max_amp > clip_amp_)
+      {
+        clip_amp_ = max_amp;
+      }
+
+    /* measure the rendered audio, not the dither noise */
+    loudness_meter_.process (block.getArrayOfReadPointers (), (int) nframes);
+
+    if (dither_)
+      {
+        for (int i = 0; i < block.getNumChannels (); ++i)
+          {
+            ditherer_.process (block.getWritePointer (i), (int) nframes);
+          }
+      }
+
+    if (!writer_.writeFromAudioSampleBuffer (block, 0, (int) nframes))
+      {
+        throw ZrythmException ("Failed to write audio data");
+      }
+  }
+
+private:
+  juce::AudioFormatWriter &writer_;
+
+  std::array<utils::audio::AudioBuffer, QUEUE_LENGTH> blocks_;
+
+  /** Indices of the blocks that can be filled. */
+  std::vector<size_t> free_blocks_;
+
+  /** Blocks waiting to be written, in order. */
+  std::deque<QueuedBlock> queued_blocks_;
+
+  std::mutex              mutex_;
+  std::condition_variable cv_;
+
+  /** Whether no more blocks will be pushed. */
+  bool stopping_ = false;
+
+  /** Whether writing failed (the error is rethrown by finish()). */
+  bool failed_ = false;
+
+  /** Only accessed by the encoder thread until finish() returns. */
+  zrythm::dsp::Ditherer      ditherer_;
+  bool                       dither_ = false;
+  float                      clip_amp_ = 0.f;
+  zrythm::dsp::LoudnessMeter loudness_meter_;
+
+  std::future<void> encoding_;
+};
+
+} // namespace
+
 Exporter::ExportThread::ExportThread (Exporter &exporter)
     : juce::Thread ("ExportThread"), exporter_ (exporter)
 {
@@ -122,6 +357,58 @@ Exporter::get_exported_path () const
   return settings_.file_uri_;
 }
 
+bool
+Exporter::can_export_stems_in_parallel (
+  const Settings             &settings,
+  const std::vector<Track *> &tracks)
+{
+  if (
+    settings.mode_ != Mode::Tracks || settings.bounce_with_parents_
+    || settings.format_ == Format::Midi0 || settings.format_ == Format::Midi1)
+    {
+      return false;
+    }
+
+  if (std::ranges::any_of (tracks, [] (const auto * track) {
+        return track->is_master ();
+      }))
+    {
+      return false;
+    }
+
+  const auto is_stem = [&tracks] (const Track * track) {
+    return track != nullptr && std::ranges::contains (tracks, track);
+  };
+  for (const auto &track_var : TRACKLIST->get_track_span ())
+    {
+      auto * channel_track =
+        dynamic_cast<ChannelTrack *> (Track::from_variant (track_var));
+      if (!channel_track)
+        continue;
+
+      const auto * ch = channel_track->get_channel ();
+      if (is_stem (ch->get_output_track ()))
+        {
+          z_debug (
+            "{} is routed to a stem track, exporting stems sequentially",
+            channel_track->get_name ());
+          return false;
+        }
+      for (const auto &send : ch->get_sends ())
+        {
+          if (send->is_enabled () && is_stem (send->get_target_track ()))
+            {
+              z_debug (
+                "{} sends to a stem track, exporting stems sequentially",
+                channel_track->get_name ());
+              return false;
+            }
+        }
+    }
+
+  return true;
+}
+
 void
 Exporter::export_audio (Settings &info)
 {
@@ -149,16 +436,12 @@ Exporter::export_audio (Settings &info)
       throw ZrythmException ("Unsupported export format");
     }
 
-  juce::File outputFile (info.file_uri_);
-  if (!outputFile.getParentDirectory ().createDirectory ())
+  if (info.write_loudness_metadata_ && info.format_ != Format::WAV)
     {
-      throw ZrythmException ("Failed to create parent directories");
-    }
-
-  auto file_output_stream = new juce::FileOutputStream (outputFile);
-  if (!file_output_stream->openedOk ())
-    {
-      throw ZrythmException ("Failed to open output file");
+      z_warning (
+        "loudness metadata is only supported for WAV - not writing it for {}",
+        Exporter_Format_to_string (info.format_));
+      info.write_loudness_metadata_ = false;
     }
 
   juce::StringPairArray metadata;
@@ -169,15 +452,69 @@ Exporter::export_audio (Settings &info)
     metadata.set ("genre", info.genre_);
   metadata.set ("software", PROGRAM_NAME);
 
-  juce::AudioFormatWriter * writer = format->createWriterFor (
-    file_output_stream, AUDIO_ENGINE->sample_rate_, EXPORT_CHANNELS,
-    utils::audio::bit_depth_enum_to_int (info.depth_), metadata, 0);
-  if (writer == nullptr)
+  /* a file being written (the mixdown, or one of the stems rendered in this
+   * pass) */
+  struct Output
+  {
+    juce::File                               file_;
+    std::unique_ptr<juce::AudioFormatWriter> writer_;
+
+    /**
+     * Writes the blocks to @ref writer_ (declared after it so that it's
+     * stopped first).
+     */
+    std::unique_ptr<BlockEncoder> encoder_;
+
+    /** Track of the stem, if rendering stems. */
+    Track * track_ = nullptr;
+
+    /** Stem output of the track (see Track::bounce_tap_). */
+    utils::audio::AudioBuffer tap_;
+  };
+
+  const bool parallel_stems = !stem_file_uris_.empty ();
+  z_return_if_fail (
+    !parallel_stems
+    || (export_stems_ && stem_file_uris_.size () == tracks_.size ()));
+
+  std::vector<std::unique_ptr<Output>> outputs;
+  for (size_t i = 0; i < (parallel_stems ? stem_file_uris_.size () : 1); ++i)
     {
-      throw ZrythmException ("Failed to create audio writer");
-    }
+      auto output = std::make_unique<Output> ();
+      output->file_ =
+        juce::File (parallel_stems ? stem_file_uris_[i] : info.file_uri_);
+      if (!output->file_.getParentDirectory ().createDirectory ())
+        {
+          throw ZrythmException ("Failed to create parent directories");
+        }
+
+      auto file_output_stream =
+        std::make_unique<juce::FileOutputStream> (output->file_);
+      if (!file_output_stream->openedOk ())
+        {
+          throw ZrythmException ("Failed to open output file");
+        }
+
+      output->writer_.reset (format->createWriterFor (
+        file_output_stream.get (), AUDIO_ENGINE->sample_rate_,
+        EXPORT_CHANNELS, utils::audio::bit_depth_enum_to_int (info.depth_),
+        metadata, 0));
+      if (output->writer_ == nullptr)
+        {
+          throw ZrythmException ("Failed to create audio writer");
+        }
 
-  std::unique_ptr<juce::AudioFormatWriter> writer_ptr (writer);
+      /* the writer owns the stream now */
+      file_output_stream.release ();
+
+      if (parallel_stems)
+        {
+          output->track_ = tracks_[i];
+          output->tap_.setSize (
+            EXPORT_CHANNELS, (int) AUDIO_ENGINE->block_length_);
+        }
+      outputs.push_back (std::move (output));
+    }
 
   auto [start_pos, end_pos] = info.get_export_time_range ();
 
@@ -189,6 +526,26 @@ Exporter::export_audio (Settings &info)
   AUDIO_ENGINE->bounce_step_ = info.bounce_step_;
   AUDIO_ENGINE->bounce_with_parents_ = info.bounce_with_parents_;
 
+  /* route each stem to its own output instead of master (until this
+   * returns) */
+  struct TapsGuard
+  {
+    std::vector<std::unique_ptr<Output>> &outputs_;
+    ~TapsGuard ()
+    {
+      for (auto &output : outputs_)
+        {
+          if (output->track_)
+            output->track_->bounce_tap_ = nullptr;
+        }
+    }
+  } taps_guard{ outputs };
+  for (auto &output : outputs)
+    {
+      if (output->track_)
+        output->track_->bounce_tap_ = &output->tap_;
+    }
+
   /* set jack freewheeling mode and temporarily disable transport link */
 #if HAVE_JACK
   AudioEngine::JackTransportType transport_type = AUDIO_ENGINE->transport_type_;
@@ -207,24 +564,24 @@ Exporter::export_audio (Settings &info)
     }
 #endif
 
-  /* init ditherer */
-  zrythm::dsp::Ditherer ditherer;
+  /* start the encoders */
+  std::optional<int> dither_bit_depth;
   if (info.dither_)
     {
-      z_debug (
-        "dither {} bits", utils::audio::bit_depth_enum_to_int (info.depth_));
-      ditherer.reset (utils::audio::bit_depth_enum_to_int (info.depth_));
+      dither_bit_depth = utils::audio::bit_depth_enum_to_int (info.depth_);
+      z_debug ("dither {} bits", *dither_bit_depth);
+    }
+  for (auto &output : outputs)
+    {
+      output->encoder_ = std::make_unique<BlockEncoder> (
+        *output->writer_, AUDIO_ENGINE->sample_rate_, EXPORT_CHANNELS,
+        AUDIO_ENGINE->block_length_, dither_bit_depth);
     }
 
   z_return_if_fail (end_pos.frames_ >= 1 || start_pos.frames_ >= 0);
   const double total_ticks = (end_pos.ticks_ - start_pos.ticks_);
   /* frames written so far */
   double covered_ticks = 0;
-  bool   clipped = false;
-  float  clip_amp = 0.f;
-
-  zrythm::utils::audio::AudioBuffer buffer (
-    EXPORT_CHANNELS, AUDIO_ENGINE->block_length_);
 
   do
     {
@@ -236,6 +593,12 @@ Exporter::export_audio (Settings &info)
         (long) AUDIO_ENGINE->block_length_);
       z_return_if_fail (nframes > 0);
 
+      for (auto &output : outputs)
+        {
+          if (output->track_)
+            output->tap_.clear (0, (int) nframes);
+        }
+
       /* run process code */
       AUDIO_ENGINE->process_prepare (nframes);
       EngineProcessTimeInfo time_nfo = {
@@ -243,40 +606,37 @@ Exporter::export_audio (Settings &info)
         .g_start_frame_w_offset_ = (unsigned_frame_t) PLAYHEAD.frames_,
         .local_offset_ = 0,
         .nframes_ = nframes,
+        .cycle_start_time_usecs_ =
+          Zrythm::getInstance ()->get_monotonic_time_usecs (),
       };
       ROUTER->start_cycle (time_nfo);
       AUDIO_ENGINE->post_process (nframes, nframes);
 
-      /* by this time, the Master channel should have its Stereo Out ports
-       * filled - pass its buffers to the output */
-      for (int i = 0; i < EXPORT_CHANNELS; ++i)
+      for (auto &output : outputs)
         {
-          auto &ch_data =
-            i == 0
-              ? P_MASTER_TRACK->channel_->get_stereo_out_ports ().first.buf_
-              : P_MASTER_TRACK->channel_->get_stereo_out_ports ().second.buf_;
-          buffer.copyFrom (i, 0, ch_data.data (), (int) nframes);
-        }
-
-      /* clipping detection */
-      float max_amp = buffer.getMagnitude (0, (int) nframes);
-      if (max_amp > 1.f && max_amp > clip_amp)
-        {
-          clip_amp = max_amp;
-          clipped = true;
-        }
-
-      /* apply dither */
-      if (info.dither_)
-        {
-          ditherer.process (buffer.getWritePointer (0), nframes);
-          ditherer.process (buffer.getWritePointer (1), nframes);
-        }
-
-      /* write the frames for the current cycle */
-      if (!writer->writeFromAudioSampleBuffer (buffer, 0, nframes))
-        {
-          throw ZrythmException ("Failed to write audio data");
+          /* by this time, the Master channel should have its Stereo Out
+           * ports filled - pass its buffers to the encoder, adding the
+           * stem the same way it would be added to master when bouncing
+           * it on its own */
+          output->encoder_->push (
+            nframes, [&] (utils::audio::AudioBuffer &block) {
+              for (int i = 0; i < EXPORT_CHANNELS; ++i)
+                {
+                  auto &ch_data =
+                    i == 0
+                      ? P_MASTER_TRACK->channel_->get_stereo_out_ports ()
+                          .first.buf_
+                      : P_MASTER_TRACK->channel_->get_stereo_out_ports ()
+                          .second.buf_;
+                  block.copyFrom (i, 0, ch_data.data (), (int) nframes);
+                  if (output->track_)
+                    {
+                      utils::float_ranges::add2 (
+                        block.getWritePointer (i),
+                        output->tap_.getReadPointer (i), nframes);
+                    }
+                }
+            });
         }
 
       covered_ticks += AUDIO_ENGINE->ticks_per_frame_ * nframes;
@@ -289,7 +649,15 @@ Exporter::export_audio (Settings &info)
     TRANSPORT->playhead_pos_->getTicks () < end_pos.ticks_
     && !progress_info_->pending_cancellation ());
 
-  writer_ptr.reset ();
+  float clip_amp = 0.f;
+  loudness_.clear ();
+  for (auto &output : outputs)
+    {
+      clip_amp = std::max (clip_amp, output->encoder_->finish ());
+      loudness_.push_back (output->encoder_->get_loudness ());
+      output->encoder_.reset ();
+      output->writer_.reset ();
+    }
 
   if (!progress_info_->pending_cancellation ())
     {
@@ -323,15 +691,41 @@ Exporter::export_audio (Settings &info)
   /* if cancelled, delete */
   if (progress_info_->pending_cancellation ())
     {
-      outputFile.deleteFile ();
+      for (auto &output : outputs)
+        {
+          output->file_.deleteFile ();
+        }
       progress_info_->mark_completed (
         ProgressInfo::CompletionType::CANCELLED, {});
     }
   else
     {
-      z_debug ("successfully exported to {}", info.file_uri_);
+      for (size_t i = 0; i < outputs.size (); ++i)
+        {
+          const auto &file = outputs[i]->file_;
+          z_info (
+            "successfully exported to {} ({})",
+            file.getFullPathName ().toStdString (), loudness_[i].to_string ());
+
+          if (info.write_loudness_metadata_)
+            {
+              /* the broadcast extension chunk has a fixed size, so it's
+               * replaced in place */
+              auto loudness_metadata = metadata;
+              loudness_metadata.set (
+                juce::WavAudioFormat::bwavDescription,
+                loudness_[i].to_string ());
+              if (!juce::WavAudioFormat ().replaceMetadataInFile (
+                    file, loudness_metadata))
+                {
+                  z_warning (
+                    "Failed to write loudness metadata to {}",
+                    file.getFullPathName ().toStdString ());
+                }
+            }
+        }
 
-      if (clipped)
+      if (clip_amp > 1.f)
         {
           float       max_db = utils::math::amp_to_dbfs (clip_amp);
           std::string warn_str = format_str (
@@ -495,9 +889,23 @@ Exporter::prepare_tracks_for_export (AudioEngine &engine, Transport &transport)
   AUDIO_ENGINE->preparing_to_export_ = true;
   state_ = std::make_unique<AudioEngine::State> ();
 
+  /* regions are silent until their clips are loaded */
+  try
+    {
+      AUDIO_POOL->wait_until_loaded ();
+    }
+  catch (const ZrythmException &e)
+    {
+      z_warning ("some clips failed to load: {}", e.what ());
+    }
+
   AUDIO_ENGINE->wait_for_pause (*state_, Z_F_NO_FORCE, true);
   z_info ("engine paused");
 
+  /* render in large blocks since there is no deadline to meet */
+  prev_block_length_ = AUDIO_ENGINE->block_length_;
+  AUDIO_ENGINE->realloc_port_buffers (OFFLINE_BLOCK_LENGTH);
+
   TRANSPORT->play_state_ = Transport::PlayState::Rolling;
 
   AUDIO_ENGINE->exporting_ = true;
@@ -552,7 +960,9 @@ Exporter::prepare_tracks_for_export (AudioEngine &engine, Transport &transport)
           PORT_CONNECTIONS_MGR->ensure_disconnect (r_src_id, r_dest_id);
         }
 
-      /* recalculate the graph to apply the changes */
+      /* recalculate the graph to apply the changes, leaving out the tracks
+       * that don't contribute to the bounce */
+      ROUTER->bounced_tracks_only_ = true;
       ROUTER->recalc_graph (false);
 
       /* remark all tracks for bounce */
@@ -583,6 +993,7 @@ Exporter::post_export ()
       connections_.reset ();
 
       /* recalculate the graph to apply the changes */
+      ROUTER->bounced_tracks_only_ = false;
       ROUTER->recalc_graph (false);
     }
 
@@ -592,12 +1003,25 @@ Exporter::post_export ()
     tr->bounce_to_master_ = false;
   });
 
+  /* the buffers are large enough for the previous block length, so this only
+   * updates the length */
+  AUDIO_ENGINE->realloc_port_buffers (prev_block_length_);
+
   /* restart engine */
   AUDIO_ENGINE->exporting_ = false;
   AUDIO_ENGINE->resume (*state_);
   state_.reset ();
 }
 
+std::string
+Exporter::Loudness::to_string () const
+{
+  return fmt::format (
+    "integrated loudness: {:.1f} LUFS, loudness range: {:.1f} LU, "
+    "true peak: {:.1f} dBTP",
+    integrated_lufs_, range_lu_, true_peak_dbtp_);
+}
+
 void
 Exporter::Settings::print () const
 {
@@ -633,12 +1057,14 @@ Exporter::Settings::print () const
     "bounce with parents: {}\n"
     "bounce step: {}\n"
     "dither: {}\n"
+    "write loudness metadata: {}\n"
     "file: {}\n"
     "num files: {}\n",
     Exporter_Format_to_string (format_), artist_, title_, genre_,
     utils::audio::bit_depth_enum_to_int (depth_), time_range,
     Exporter_Mode_to_string (mode_), disable_after_bounce_, bounce_with_parents_,
-    BounceStep_to_string (bounce_step_), dither_, file_uri_, num_files_);
+    BounceStep_to_string (bounce_step_), dither_, write_loudness_metadata_,
+    file_uri_, num_files_);
 }
 
 void
@@ -158,6 +158,15 @@ public:
      */
     bool dither_ = false;
 
+    /**
+     * Write the measured loudness (see Loudness) to the exported file's
+     * metadata.
+     *
+     * Only supported for WAV, where it's written to the description of the
+     * broadcast extension chunk.
+     */
+    bool write_loudness_metadata_ = false;
+
     /**
      * Absolute path for export file.
      */
@@ -168,6 +177,28 @@ public:
     int num_files_ = 1;
   };
 
+  /**
+   * @brief Loudness of an exported file according to EBU R128, measured while
+   * rendering it.
+   */
+  struct Loudness
+  {
+    /** Integrated loudness in LUFS (-infinity if too short or silent). */
+    double integrated_lufs_ = 0.0;
+
+    /** Loudness range in LU. */
+    double range_lu_ = 0.0;
+
+    /** True peak in dBTP. */
+    double true_peak_dbtp_ = 0.0;
+
+    /**
+     * @brief Returns a description of the values, e.g. for the file's
+     * metadata.
+     */
+    std::string to_string () const;
+  };
+
   class ExportThread final : public juce::Thread
   {
   public:
@@ -182,6 +213,16 @@ public:
   };
 
 public:
+  /**
+   * @brief Block length the engine renders with while exporting.
+   *
+   * Larger blocks amortize the per-cycle overhead when rendering offline.
+   * Automation and MIDI events are still applied at their exact positions
+   * inside each block, and plugins that can't process blocks this large are
+   * given sub-blocks (see Plugin::get_max_block_length()).
+   */
+  static constexpr nframes_t OFFLINE_BLOCK_LENGTH = 8192;
+
   Exporter (
     Settings                      settings,
     std::shared_ptr<ProgressInfo> progress_info = nullptr,
@@ -218,6 +259,20 @@ public:
    */
   fs::path get_exported_path () const;
 
+  /**
+   * @brief Returns whether the stems of @p tracks can be rendered in a single
+   * pass (see @ref stem_file_uris_), producing the same files as exporting
+   * them one after another.
+   *
+   * This requires bouncing the stems directly to master (without their
+   * parents), and that no other track routes its output or sends to a stem
+   * track, since that track would only be audible when rendering all the
+   * stems at once.
+   */
+  static bool can_export_stems_in_parallel (
+    const Settings             &settings,
+    const std::vector<Track *> &tracks);
+
   /**
    * To be called to create and perform an undoable action for creating an audio
    * track with the bounced material.
@@ -250,6 +305,22 @@ public:
   std::vector<Track *> tracks_;
   size_t               cur_track_ = 0;
 
+  /**
+   * @brief Output file of each track in @ref tracks_ when rendering all the
+   * stems in a single pass.
+   *
+   * If set, all of @ref tracks_ must be marked for bounce directly to master
+   * and can_export_stems_in_parallel() must be true. Otherwise, only the
+   * file in @ref settings_ is exported.
+   */
+  std::vector<std::string> stem_file_uris_;
+
+  /**
+   * @brief Loudness of each exported audio file (the mixdown, or each of
+   * @ref stem_file_uris_), set once the audio is exported.
+   */
+  std::vector<Loudness> loudness_;
+
   std::shared_ptr<ProgressInfo> progress_info_;
 
   // GtkWidget * parent_owner_ = nullptr;
@@ -266,6 +337,9 @@ private:
    */
   std::unique_ptr<AudioEngine::State> state_;
 
+  /** Engine block length to restore after exporting. */
+  nframes_t prev_block_length_ = 0;
+
   std::unique_ptr<ExportThread> thread_;
 };
 
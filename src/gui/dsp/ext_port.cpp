@@ -628,6 +628,31 @@ ExtPort::ext_ports_get (
     } /* endif MIDI */
 }
 
+#if HAVE_JACK
+std::optional<ExtPort::PortType>
+ExtPort::get_jack_port_type (jack_port_t * jport, PortFlow flow, bool hw)
+{
+  const int flags = jack_port_flags (jport);
+  if (hw && !(flags & JackPortIsPhysical))
+    return std::nullopt;
+  if (flow == PortFlow::Input && !(flags & JackPortIsInput))
+    return std::nullopt;
+  if (flow == PortFlow::Output && !(flags & JackPortIsOutput))
+    return std::nullopt;
+
+  const char * jtype = jack_port_type (jport);
+  if (!jtype)
+    return std::nullopt;
+  for (const auto type : { PortType::Audio, PortType::Event })
+    {
+      const char * expected = JackPortBackend::get_jack_type (type);
+      if (expected && std::string_view (jtype) == expected)
+        return type;
+    }
+  return std::nullopt;
+}
+#endif
+
 void
 ExtPort::print () const
 {
@@ -12,6 +12,8 @@
 
 #include "zrythm-config.h"
 
+#include <optional>
+
 #include "gui/dsp/port.h"
 
 #include "utils/iserializable.h"
@@ -168,6 +170,15 @@ connect (
     std::vector<ExtPort> &ports,
     AudioEngine          &engine);
 
+#if HAVE_JACK
+  /**
+   * Returns the type of the given JACK port if it would be collected by
+   * ext_ports_get() with the given @p flow and @p hw, or nullopt otherwise.
+   */
+  static std::optional<PortType>
+  get_jack_port_type (jack_port_t * jport, PortFlow flow, bool hw);
+#endif
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 public:
@@ -14,6 +14,38 @@ FadeableObject::copy_members_from (
   fade_out_pos_ = other.fade_out_pos_;
   fade_in_opts_ = other.fade_in_opts_;
   fade_out_opts_ = other.fade_out_opts_;
+  fade_in_table_ = other.fade_in_table_;
+  fade_out_table_ = other.fade_out_table_;
+}
+
+void
+FadeableObject::update_fade_tables ()
+{
+  const auto update_table = [] (
+                              std::shared_ptr<const FadeTable> &table,
+                              const dsp::CurveOptions          &opts,
+                              signed_frame_t                    num_frames,
+                              bool                              fade_in) {
+    if (num_frames <= 0 || num_frames > MAX_FADE_TABLE_FRAMES)
+      {
+        table.reset ();
+        return;
+      }
+    if (table && table->matches (opts, num_frames))
+      return;
+
+    /* replace instead of modifying the table since it may be in use by
+     * playback snapshots */
+    auto new_table = std::make_shared<FadeTable> ();
+    new_table->opts_ = opts;
+    new_table->gains_.resize (num_frames);
+    opts.get_normalized_ys_for_fade (
+      new_table->gains_.data (), 0.0, 1.0 / (double) num_frames,
+      new_table->gains_.size (), fade_in);
+    table = std::move (new_table);
+  };
+  update_table (fade_in_table_, fade_in_opts_, get_fade_in_frames (), true);
+  update_table (fade_out_table_, fade_out_opts_, get_fade_out_frames (), false);
 }
 
 bool
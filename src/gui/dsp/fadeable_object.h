@@ -4,6 +4,9 @@
 #ifndef __DSP_FADEABLE_OBJECT_H__
 #define __DSP_FADEABLE_OBJECT_H__
 
+#include <memory>
+#include <vector>
+
 #include "dsp/curve.h"
 #include "dsp/position.h"
 #include "gui/dsp/bounded_object.h"
@@ -16,6 +19,32 @@ class FadeableObject
     : virtual public BoundedObject,
       public zrythm::utils::serialization::ISerializable<FadeableObject>
 {
+public:
+  /**
+   * @brief Gains of a fade, precomputed for given curve options and length.
+   */
+  struct FadeTable
+  {
+    /**
+     * @brief Whether these are the gains of a fade with @p opts that lasts
+     * @p num_frames frames.
+     */
+    bool
+    matches (const dsp::CurveOptions &opts, signed_frame_t num_frames) const
+    {
+      return (signed_frame_t) gains_.size () == num_frames && opts_ == opts;
+    }
+
+    dsp::CurveOptions  opts_;
+    std::vector<float> gains_;
+  };
+
+  /**
+   * Fades longer than this many frames are not precomputed (their gains are
+   * calculated during playback instead).
+   */
+  static constexpr signed_frame_t MAX_FADE_TABLE_FRAMES = 1 << 20;
+
 public:
   FadeableObject () = default;
   ~FadeableObject () override = default;
@@ -31,6 +60,60 @@ public:
    */
   void get_fade_out_pos (Position * pos) const { *pos = fade_out_pos_; }
 
+  /**
+   * Returns the length of the fade in, in frames.
+   */
+  signed_frame_t get_fade_in_frames () const { return fade_in_pos_.frames_; }
+
+  /**
+   * Returns the length of the fade out, in frames.
+   */
+  signed_frame_t get_fade_out_frames () const
+  {
+    return get_length_in_frames () - fade_out_pos_.frames_;
+  }
+
+  /**
+   * @brief Recalculates the precomputed fade gains if the fade options or
+   * lengths changed since they were last calculated.
+   *
+   * Clones share the tables, so this is called on the project's objects
+   * before generating playback snapshots of them.
+   *
+   * @warning Not realtime safe.
+   */
+  void update_fade_tables ();
+
+  /**
+   * @brief Returns the precomputed fade in gains, or nullptr if they are not
+   * available or outdated.
+   *
+   * Realtime-safe.
+   */
+  const FadeTable * get_fade_in_table () const
+  {
+    return fade_in_table_
+               && fade_in_table_->matches (
+                 fade_in_opts_, get_fade_in_frames ())
+             ? fade_in_table_.get ()
+             : nullptr;
+  }
+
+  /**
+   * @brief Returns the precomputed fade out gains, or nullptr if they are
+   * not available or outdated.
+   *
+   * Realtime-safe.
+   */
+  const FadeTable * get_fade_out_table () const
+  {
+    return fade_out_table_
+               && fade_out_table_->matches (
+                 fade_out_opts_, get_fade_out_frames ())
+             ? fade_out_table_.get ()
+             : nullptr;
+  }
+
 protected:
   void
   copy_members_from (const FadeableObject &other, ObjectCloneType clone_type);
@@ -59,6 +142,13 @@ public:
 
   /** Fade out curve options. */
   dsp::CurveOptions fade_out_opts_;
+
+private:
+  /** Precomputed fade in gains (see update_fade_tables()). */
+  std::shared_ptr<const FadeTable> fade_in_table_;
+
+  /** Precomputed fade out gains (see update_fade_tables()). */
+  std::shared_ptr<const FadeTable> fade_out_table_;
 };
 
 #endif // __DSP_FADEABLE_OBJECT_H__
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
 #include "dsp/panning.h"
+#include "dsp/stereo_gain.h"
 #include "gui/backend/backend/actions/tracklist_selections_action.h"
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/settings_manager.h"
@@ -15,6 +16,7 @@
 #include "gui/dsp/group_target_track.h"
 #include "gui/dsp/master_track.h"
 #include "gui/dsp/midi_event.h"
+#include "gui/dsp/pool.h"
 #include "gui/dsp/port.h"
 #include "gui/dsp/track.h"
 #include "gui/dsp/tracklist.h"
@@ -397,6 +399,17 @@ Fader::on_control_change_event (
     || ENUM_BITSET_TEST (id.flags2_, PortIdentifier::Flags2::FaderMonoCompat))
     {
       // EVENTS_PUSH (EventType::ET_TRACK_FADER_BUTTON_CHANGED, track);
+
+      /* other faders' solo state may depend on this */
+      if (
+        ENUM_BITSET_TEST (id.flags2_, PortIdentifier::Flags2::FaderSolo)
+        || ENUM_BITSET_TEST (id.flags2_, PortIdentifier::Flags2::FaderListen))
+        {
+          if (auto * tracklist = track_ ? track_->get_tracklist () : nullptr)
+            {
+              tracklist->invalidate_solo_state ();
+            }
+        }
     }
   else if (ENUM_BITSET_TEST (id.flags_, PortIdentifier::Flags::Amplitude))
     {
@@ -421,6 +434,12 @@ Fader::should_bounce_to_master (utils::audio::BounceStep step) const
   return !track->is_master () && track->bounce_to_master_;
 }
 
+utils::audio::AudioBuffer *
+Fader::get_bounce_tap () const
+{
+  return get_track ()->bounce_tap_;
+}
+
 void
 Fader::set_muted (bool mute, bool fire_events)
 {
@@ -719,170 +738,36 @@ Fader::clear_buffers ()
   if (has_audio_ports ())
     {
       auto stereo_in = get_stereo_in_ports ();
-      stereo_in.first.clear_buffer (*AUDIO_ENGINE);
-      stereo_in.second.clear_buffer (*AUDIO_ENGINE);
-      auto stereo_out = get_stereo_out_ports ();
-      stereo_out.first.clear_buffer (*AUDIO_ENGINE);
-      stereo_out.second.clear_buffer (*AUDIO_ENGINE);
-    }
-  else if (has_midi_ports ())
-    {
-      auto &midi_in = get_midi_in_port ();
-      midi_in.clear_buffer (*AUDIO_ENGINE);
-      auto &midi_out = get_midi_out_port ();
-      midi_out.clear_buffer (*AUDIO_ENGINE);
-    }
-}
-
-void
-Fader::disconnect_all ()
-{
-  if (has_audio_ports ())
-    {
-      auto stereo_in = get_stereo_in_ports ();
-      stereo_in.first.disconnect_all ();
-      stereo_in.second.disconnect_all ();
       auto stereo_out = get_stereo_out_ports ();
-      stereo_out.first.disconnect_all ();
-      stereo_out.second.disconnect_all ();
-    }
-  else if (has_midi_ports ())
-    {
-      auto &midi_in = get_midi_in_port ();
-      midi_in.disconnect_all ();
-      auto &midi_out = get_midi_out_port ();
-      midi_out.disconnect_all ();
-    }
-
-  get_amp_port ().disconnect_all ();
-  get_balance_port ().disconnect_all ();
-  get_mute_port ().disconnect_all ();
-  get_solo_port ().disconnect_all ();
-  get_listen_port ().disconnect_all ();
-  get_mono_compat_enabled_port ().disconnect_all ();
-  get_swap_phase_port ().disconnect_all ();
-}
 
-int
-Fader::fade_frames_for_type (Type type)
-{
-  return type == Type::Monitor
-           ? FADER_DEFAULT_FADE_FRAMES
-           : FADER_DEFAULT_FADE_FRAMES_SHORT;
-}
-
-std::string
-Fader::get_node_name () const
-{
-  if (type_ == Type::AudioChannel || type_ == Type::MidiChannel)
-    {
-      auto * track = get_track ();
-      return fmt::format (
-        "{} {}", track->get_name (), passthrough_ ? "Pre-Fader" : "Fader");
-    }
-  if (type_ == Type::Monitor)
-    {
-      return "Monitor Fader";
-    }
-
-  return "Fader";
-}
-
-/**
- * Process the Fader.
- */
-void
-Fader::process_block (const EngineProcessTimeInfo time_nfo)
-{
-  if (ZRYTHM_TESTING)
-    {
-#if 0
-      z_debug (
-        "g_start %ld, start frame {}, nframes {}", time_nfo->g_start_frame_w_offset,
-        time_nfo->local_offset, time_nfo->nframes);
-#endif
-    }
-
-  Track * track = nullptr;
-  if (type_ == Type::AudioChannel)
-    {
-      track = get_track ();
-      z_return_if_fail (track);
-    }
-
-  const int default_fade_frames = fade_frames_for_type (type_);
-
-  bool effectively_muted = false;
-  if (!passthrough_)
-    {
-      /* muted if any of the following is true:
-       * 1. muted
-       * 2. other track(s) is soloed and this isn't
-       * 3. bounce mode and the track is set to BOUNCE_OFF */
-      effectively_muted =
-        get_muted()
-        ||
-        ((type_ == Type::AudioChannel || type_ == Type::MidiChannel)
-         && TRACKLIST->get_track_span().has_soloed() && !get_soloed() && !get_implied_soloed()
-         && track != P_MASTER_TRACK)
-        ||
-        (AUDIO_ENGINE->bounce_mode_ == BounceMode::BOUNCE_ON
-         &&
-         (type_ == Type::AudioChannel
-          || type_ == Type::MidiChannel)
-         && track
-         && !track->is_master()
-         && !track->bounce_);
-
-#if 0
-      if (ZRYTHM_TESTING && track &&
-          (self->type == Fader::Type::FADER_TYPE_AUDIO_CHANNEL ||
-           self->type == Fader::Type::FADER_TYPE_MIDI_CHANNEL))
+      /* if the track was frozen at this fader, play its frozen clip instead
+       * of the (silent) live signal */
+      const bool plays_frozen_clip =
+        track && track->frozen_
+        && track->freeze_step_
+             == (passthrough_
+                   ? utils::audio::BounceStep::PreFader
+                   : utils::audio::BounceStep::PostFader);
+
+      /* the gain below reads the input directly, except when the signal is
+       * prepared in the output first */
+      if (passthrough_ || type_ == Fader::Type::Monitor)
         {
-          z_debug ("{} soloed {} implied soloed {} effectively muted {}",
-            track->name, fader_get_soloed (self),
-            fader_get_implied_soloed (self),
-            effectively_muted);
+          utils::float_ranges::copy (
+            &stereo_out.first.buf_[time_nfo.local_offset_],
+            &stereo_in.first.buf_[time_nfo.local_offset_], time_nfo.nframes_);
+          utils::float_ranges::copy (
+            &stereo_out.second.buf_[time_nfo.local_offset_],
+            &stereo_in.second.buf_[time_nfo.local_offset_],
+            time_nfo.nframes_);
         }
-#endif
-    }
-
-  if (has_audio_ports ())
-    {
-      auto stereo_in = get_stereo_in_ports ();
-      auto stereo_out = get_stereo_out_ports ();
-      /* copy the input to output */
-      utils::float_ranges::copy (
-        &stereo_out.first.buf_[time_nfo.local_offset_],
-        &stereo_in.first.buf_[time_nfo.local_offset_], time_nfo.nframes_);
-      utils::float_ranges::copy (
-        &stereo_out.second.buf_[time_nfo.local_offset_],
-        &stereo_in.second.buf_[time_nfo.local_offset_], time_nfo.nframes_);
-
-      /* if prefader */
-      if (passthrough_)
+      if (plays_frozen_clip)
         {
-
-          /* if track frozen and transport is rolling */
-          if (track && track->frozen_ && TRANSPORT->isRolling ())
-            {
-#if 0
-              /* get audio from clip */
-              AudioClip * clip =
-                audio_pool_get_clip (
-                  AUDIO_POOL, track->pool_id_);
-              /* FIXME this is wrong - need to
-               * also calculate the offset in the
-               * clip */
-              stereo_ports_fill_from_clip (
-                self->stereo_out, clip,
-                time_nfo->g_start_frame_w_offset,
-                time_nfo->local_offset,
-                time_nfo->nframes);
-#endif
-            }
+          fill_from_frozen_clip (*track, time_nfo);
         }
-      else /* not prefader */
+
+      /* if not prefader */
+      if (!passthrough_)
         {
           /* if monitor */
           float mute_amp;
@@ -892,7 +777,7 @@ Fader::process_block (const EngineProcessTimeInfo time_nfo)
               float dim_amp = CONTROL_ROOM->dim_fader_->get_amp ();
 
               /* if have listened tracks */
-              if (TRACKLIST->get_track_span ().has_listened ())
+              if (TRACKLIST->has_listened_tracks ())
                 {
                   /* dim signal */
                   utils::float_ranges::mul_k2 (
@@ -967,30 +852,32 @@ Fader::process_block (const EngineProcessTimeInfo time_nfo)
                 }
             }
 
-          /* handle fade in */
-          int fade_in_samples = fade_in_samples_.load ();
+          /* work out the mute fades of this block (applied together with
+           * the gain below) */
+          const auto nframes = static_cast<size_t> (time_nfo.nframes_);
+          size_t     fade_in_start = 0;
+          size_t     num_fade_in_frames = 0;
+          int        fade_in_samples = fade_in_samples_.load ();
           if (fade_in_samples > 0) [[unlikely]]
             {
               z_return_if_fail_cmp (default_fade_frames, >=, fade_in_samples);
-#if 0
-              z_debug (
-                "fading in %d samples", fade_in_samples);
-#endif
-              utils::float_ranges::linear_fade_in_from (
-                &stereo_out.first.buf_[time_nfo.local_offset_],
-                default_fade_frames - fade_in_samples, default_fade_frames,
-                time_nfo.nframes_, mute_amp);
-              utils::float_ranges::linear_fade_in_from (
-                &stereo_out.second.buf_[time_nfo.local_offset_],
-                default_fade_frames - fade_in_samples, default_fade_frames,
-                time_nfo.nframes_, mute_amp);
+              fade_in_start =
+                static_cast<size_t> (default_fade_frames - fade_in_samples);
+              num_fade_in_frames =
+                std::min (static_cast<size_t> (fade_in_samples), nframes);
               fade_in_samples -= (int) time_nfo.nframes_;
               fade_in_samples = std::max (fade_in_samples, 0);
               fade_in_samples_.store (fade_in_samples);
             }
 
-          /* handle fade out */
-          size_t faded_out_frames = 0;
+          /* frames from this one on are at the mute level */
+          size_t mute_start = nframes;
+
+          /* whether to silence the muted frames instead of applying the mute
+           * level */
+          bool   silence_muted = false;
+          size_t fade_out_start = 0;
+          size_t num_fade_out_frames = 0;
           if (fading_out_.load ()) [[unlikely]]
             {
               int fade_out_samples = fade_out_samples_.load ();
@@ -1000,130 +887,171 @@ Fader::process_block (const EngineProcessTimeInfo time_nfo)
                 {
                   z_return_if_fail_cmp (
                     default_fade_frames, >=, fade_out_samples);
-
-#if 0
-                  z_debug (
-                    "fading out %d frames",
-                    samples_to_process);
-#endif
-                  utils::float_ranges::linear_fade_out_to (
-                    &stereo_out.first.buf_[time_nfo.local_offset_],
-                    default_fade_frames - fade_out_samples, default_fade_frames,
-                    (size_t) samples_to_process, mute_amp);
-                  utils::float_ranges::linear_fade_out_to (
-                    &stereo_out.second.buf_[time_nfo.local_offset_],
-                    default_fade_frames - fade_out_samples, default_fade_frames,
-                    (size_t) samples_to_process, mute_amp);
+                  fade_out_start = static_cast<size_t> (
+                    default_fade_frames - fade_out_samples);
+                  num_fade_out_frames =
+                    static_cast<size_t> (samples_to_process);
                   fade_out_samples -= samples_to_process;
-                  faded_out_frames += (size_t) samples_to_process;
                   fade_out_samples_.store (fade_out_samples);
                 }
 
-              /* if still fading out and have no more fade out samples, silence */
+              /* if faded out, stay at the mute level */
               if (fade_out_samples == 0)
                 {
-                  size_t remaining_frames =
-                    time_nfo.nframes_ - (size_t) samples_to_process;
-#if 0
-                  z_debug (
-                    "silence for remaining %zu frames", remaining_frames);
-#endif
-                  if (remaining_frames > 0)
-                    {
-                      utils::float_ranges::mul_k2 (
-                        &stereo_out.first
-                           .buf_[time_nfo.local_offset_ + faded_out_frames],
-                        mute_amp, remaining_frames);
-                      utils::float_ranges::mul_k2 (
-                        &stereo_out.second
-                           .buf_[time_nfo.local_offset_ + faded_out_frames],
-                        mute_amp, remaining_frames);
-                      faded_out_frames += (size_t) remaining_frames;
-                    }
+                  mute_start = num_fade_out_frames;
                 }
             }
+          else if (effectively_muted && fade_out_samples_.load () == 0)
+            {
+              mute_start = 0;
+              silence_muted = mute_amp < 0.00001f;
+            }
 
-          const float pan = get_balance_port ().get_control_value (false);
-          const float amp = get_amp_port ().get_control_value (false);
+          const bool  has_fades = num_fade_in_frames > 0
+                                 || num_fade_out_frames > 0
+                                 || mute_start < nframes;
+          const float fade_scale =
+            (1.f - mute_amp) / static_cast<float> (default_fade_frames - 1);
+          const auto get_fade_gain = [&] (size_t frame) {
+            float gain = 1.f;
+            if (frame < num_fade_in_frames)
+              {
+                gain *=
+                  mute_amp
+                  + fade_scale * static_cast<float> (fade_in_start + frame);
+              }
+            if (frame < num_fade_out_frames)
+              {
+                const auto index =
+                  static_cast<size_t> (default_fade_frames - 1)
+                  - fade_out_start - frame;
+                gain *= mute_amp + fade_scale * static_cast<float> (index);
+              }
+            if (frame >= mute_start)
+              {
+                gain *= mute_amp;
+              }
+            return gain;
+          };
+
+          /* the frozen clip was rendered after the fader and pan, so only
+           * mute is applied to it */
+          const float pan =
+            plays_frozen_clip
+              ? 0.5f
+              : get_balance_port ().get_control_value (false);
+          const float amp =
+            plays_frozen_clip ? 1.f : get_amp_port ().get_control_value (false);
 
           auto [calc_l, calc_r] = dsp::calculate_balance_control (
             dsp::BalanceControlAlgorithm::Linear, pan);
 
-          /* apply fader and pan */
-          utils::float_ranges::mul_k2 (
-            &stereo_out.first.buf_[time_nfo.local_offset_], amp * calc_l,
-            time_nfo.nframes_);
-          utils::float_ranges::mul_k2 (
-            &stereo_out.second.buf_[time_nfo.local_offset_], amp * calc_r,
-            time_nfo.nframes_);
-
-          /* make mono if mono compat enabled */
-          if (get_mono_compat_enabled_port ().is_toggled ())
+          std::optional<std::span<const float>> automated_amps;
+          if (!plays_frozen_clip)
             {
-              utils::float_ranges::make_mono (
-                &stereo_out.first.buf_[time_nfo.local_offset_],
-                &stereo_out.second.buf_[time_nfo.local_offset_],
-                time_nfo.nframes_, false);
+              automated_amps = get_amp_port ().get_automation_values (time_nfo);
             }
-
-          /* swap phase if need */
-          if (get_swap_phase_port ().is_toggled ())
+          if (!automated_amps)
             {
-              utils::float_ranges::mul_k2 (
-                &stereo_out.first.buf_[time_nfo.local_offset_], -1.f,
-                time_nfo.nframes_);
-              utils::float_ranges::mul_k2 (
-                &stereo_out.second.buf_[time_nfo.local_offset_], -1.f,
-                time_nfo.nframes_);
+              /* ramp from the previous gains */
+              const auto ramp_length = static_cast<size_t> (
+                static_cast<float> (AUDIO_ENGINE->sample_rate_)
+                * dsp::ParameterSmoother::DEFAULT_RAMP_TIME);
+              gain_smoothers_.first.set_ramp_length (ramp_length);
+              gain_smoothers_.second.set_ramp_length (ramp_length);
+              gain_smoothers_.first.set_target (amp * calc_l);
+              gain_smoothers_.second.set_target (amp * calc_r);
             }
 
-          int fade_out_samples = fade_out_samples_.load ();
-          if (
-            effectively_muted && fade_out_samples == 0
-            && time_nfo.nframes_ - faded_out_frames > 0)
-            {
-#if 0
-              z_debug (
-                "muting %zu frames",
-                time_nfo->nframes - faded_out_frames);
-#endif
-              /* apply mute level */
-              if (mute_amp < 0.00001f)
+          const float phase =
+            !plays_frozen_clip && get_swap_phase_port ().is_toggled ()
+              ? -1.f
+              : 1.f;
+          const float mono_k =
+            !plays_frozen_clip && get_mono_compat_enabled_port ().is_toggled ()
+              ? 0.5f
+              : 0.f;
+
+          /* if master or monitor or sample processor, hard limit the output */
+          const float limit =
+            (type_ == Type::AudioChannel && track && track->is_master ())
+                || type_ == Type::Monitor || type_ == Type::SampleProcessor
+              ? 2.f
+              : 0.f;
+
+          /* apply the fader (automated per frame, as the automation is already
+           * smooth), pan, fades, mute, phase and mono compatibility in a
+           * single pass */
+          const bool src_is_out =
+            plays_frozen_clip || type_ == Fader::Type::Monitor;
+          const auto &src = src_is_out ? stereo_out : stereo_in;
+          const auto  local_offset = time_nfo.local_offset_;
+          const auto  num_gain_frames = silence_muted ? mute_start : nframes;
+          dsp::apply_stereo_gain (
+            &stereo_out.first.buf_[local_offset],
+            &stereo_out.second.buf_[local_offset],
+            &src.first.buf_[local_offset], &src.second.buf_[local_offset],
+            num_gain_frames, mono_k, limit,
+            [&] (
+              size_t offset, float * gains_l, float * gains_r, size_t size) {
+              if (automated_amps)
                 {
-                  utils::float_ranges::fill (
-                    &stereo_out.first
-                       .buf_[time_nfo.local_offset_ + faded_out_frames],
-                    AUDIO_ENGINE->denormal_prevention_val_,
-                    time_nfo.nframes_ - faded_out_frames);
-                  utils::float_ranges::fill (
-                    &stereo_out.second
-                       .buf_[time_nfo.local_offset_ + faded_out_frames],
-                    AUDIO_ENGINE->denormal_prevention_val_,
-                    time_nfo.nframes_ - faded_out_frames);
+                  for (size_t i = 0; i < size; i++)
+                    {
+                      const float automated_amp =
+                        (*automated_amps)[offset + i];
+                      gains_l[i] = automated_amp * calc_l;
+                      gains_r[i] = automated_amp * calc_r;
+                    }
                 }
               else
                 {
-                  utils::float_ranges::mul_k2 (
-                    &stereo_out.first.buf_[time_nfo.local_offset_], mute_amp,
-                    time_nfo.nframes_ - faded_out_frames);
-                  utils::float_ranges::mul_k2 (
-                    &stereo_out.second
-                       .buf_[time_nfo.local_offset_ + faded_out_frames],
-                    mute_amp, time_nfo.nframes_ - faded_out_frames);
+                  gain_smoothers_.first.fill_values (gains_l, size);
+                  gain_smoothers_.second.fill_values (gains_r, size);
                 }
+              if (has_fades) [[unlikely]]
+                {
+                  for (size_t i = 0; i < size; i++)
+                    {
+                      const float fade_gain = get_fade_gain (offset + i);
+                      gains_l[i] *= fade_gain;
+                      gains_r[i] *= fade_gain;
+                    }
+                }
+              if (phase < 0.f)
+                {
+                  for (size_t i = 0; i < size; i++)
+                    {
+                      gains_l[i] = -gains_l[i];
+                      gains_r[i] = -gains_r[i];
+                    }
+                }
+            });
+
+          if (automated_amps)
+            {
+              gain_smoothers_.first.reset (automated_amps->back () * calc_l);
+              gain_smoothers_.second.reset (automated_amps->back () * calc_r);
+            }
+          else if (num_gain_frames < nframes)
+            {
+              /* keep the ramps in sync with the frames processed */
+              gain_smoothers_.first.reset (gain_smoothers_.first.get_target ());
+              gain_smoothers_.second.reset (
+                gain_smoothers_.second.get_target ());
             }
 
-          /* if master or monitor or sample processor, hard limit the output */
-          if (
-            (type_ == Type::AudioChannel && track && track->is_master ())
-            || type_ == Type::Monitor || type_ == Type::SampleProcessor)
+          /* silence the muted frames */
+          if (num_gain_frames < nframes)
             {
-              utils::float_ranges::clip (
-                &stereo_out.first.buf_[time_nfo.local_offset_], -2.f, 2.f,
-                time_nfo.nframes_);
-              utils::float_ranges::clip (
-                &stereo_out.second.buf_[time_nfo.local_offset_], -2.f, 2.f,
-                time_nfo.nframes_);
+              utils::float_ranges::fill (
+                &stereo_out.first.buf_[local_offset + num_gain_frames],
+                AUDIO_ENGINE->denormal_prevention_val_,
+                nframes - num_gain_frames);
+              utils::float_ranges::fill (
+                &stereo_out.second.buf_[local_offset + num_gain_frames],
+                AUDIO_ENGINE->denormal_prevention_val_,
+                nframes - num_gain_frames);
             }
         } /* fi not prefader */
     } /* fi monitor/audio fader */
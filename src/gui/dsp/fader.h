@@ -6,6 +6,7 @@
 
 #include <atomic>
 
+#include "dsp/parameter_smoother.h"
 #include "gui/dsp/audio_port.h"
 #include "gui/dsp/control_port.h"
 #include "gui/dsp/midi_port.h"
@@ -126,6 +127,15 @@ public:
 
   std::string get_node_name () const override;
 
+  /**
+   * Only channel faders can be rendered ahead (the monitor fader handles
+   * fading and the sample processor fader plays live samples).
+   */
+  bool can_render_ahead () const override
+  {
+    return type_ == Type::AudioChannel || type_ == Type::MidiChannel;
+  }
+
   /**
    * Sets the amplitude of the fader. (0.0 to 2.0)
    */
@@ -271,6 +281,8 @@ public:
 
   bool should_bounce_to_master (utils::audio::BounceStep step) const override;
 
+  utils::audio::AudioBuffer * get_bounce_tap () const override;
+
   static int fade_frames_for_type (Type type);
 
   bool has_audio_ports () const
@@ -287,37 +299,41 @@ public:
   ControlPort &get_amp_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_->find_by_id_or_throw (amp_id_.value ()));
+      port_registry_->find_by_id_or_throw (amp_id_.value (), amp_handle_));
   }
   ControlPort &get_balance_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_->find_by_id_or_throw (balance_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        balance_id_.value (), balance_handle_));
   }
   ControlPort &get_mute_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_->find_by_id_or_throw (mute_id_.value ()));
+      port_registry_->find_by_id_or_throw (mute_id_.value (), mute_handle_));
   }
   ControlPort &get_solo_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_->find_by_id_or_throw (solo_id_.value ()));
+      port_registry_->find_by_id_or_throw (solo_id_.value (), solo_handle_));
   }
   ControlPort &get_listen_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_->find_by_id_or_throw (listen_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        listen_id_.value (), listen_handle_));
   }
   ControlPort &get_mono_compat_enabled_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_->find_by_id_or_throw (mono_compat_enabled_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        mono_compat_enabled_id_.value (), mono_compat_enabled_handle_));
   }
   ControlPort &get_swap_phase_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_->find_by_id_or_throw (swap_phase_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        swap_phase_id_.value (), swap_phase_handle_));
   }
   std::pair<AudioPort &, AudioPort &> get_stereo_in_ports () const
   {
@@ -326,9 +342,11 @@ public:
         throw std::runtime_error ("Not an audio fader");
       }
     auto * l = std::get<AudioPort *> (
-      port_registry_->find_by_id_or_throw (stereo_in_left_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        stereo_in_left_id_.value (), stereo_in_left_handle_));
     auto * r = std::get<AudioPort *> (
-      port_registry_->find_by_id_or_throw (stereo_in_right_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        stereo_in_right_id_.value (), stereo_in_right_handle_));
     return { *l, *r };
   }
   std::pair<AudioPort &, AudioPort &> get_stereo_out_ports () const
@@ -338,20 +356,24 @@ public:
         throw std::runtime_error ("Not an audio fader");
       }
     auto * l = std::get<AudioPort *> (
-      port_registry_->find_by_id_or_throw (stereo_out_left_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        stereo_out_left_id_.value (), stereo_out_left_handle_));
     auto * r = std::get<AudioPort *> (
-      port_registry_->find_by_id_or_throw (stereo_out_right_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        stereo_out_right_id_.value (), stereo_out_right_handle_));
     return { *l, *r };
   }
   MidiPort &get_midi_in_port () const
   {
     return *std::get<MidiPort *> (
-      port_registry_->find_by_id_or_throw (midi_in_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        midi_in_id_.value (), midi_in_handle_));
   }
   MidiPort &get_midi_out_port () const
   {
     return *std::get<MidiPort *> (
-      port_registry_->find_by_id_or_throw (midi_out_id_.value ()));
+      port_registry_->find_by_id_or_throw (
+        midi_out_id_.value (), midi_out_handle_));
   }
 
   auto get_stereo_in_left_id () const
@@ -431,6 +453,15 @@ public:
    */
   float last_cc_volume_ = 0.f;
 
+private:
+  /**
+   * @brief Writes the frozen clip of @p track to the output (silence while
+   * the transport is stopped or past the end of the clip).
+   */
+  [[gnu::hot]] void fill_from_frozen_clip (
+    const Track                 &track,
+    const EngineProcessTimeInfo &time_nfo);
+
 private:
   /**
    * A control port that controls the volume in amplitude (0.0 ~ 1.5)
@@ -480,6 +511,30 @@ private:
    */
   std::optional<PortUuid> midi_out_id_;
 
+  /** Handles the port IDs above last resolved to, for the getters. */
+  utils::ObjectHandleCache amp_handle_;
+  utils::ObjectHandleCache balance_handle_;
+  utils::ObjectHandleCache mute_handle_;
+  utils::ObjectHandleCache solo_handle_;
+  utils::ObjectHandleCache listen_handle_;
+  utils::ObjectHandleCache mono_compat_enabled_handle_;
+  utils::ObjectHandleCache swap_phase_handle_;
+  utils::ObjectHandleCache stereo_in_left_handle_;
+  utils::ObjectHandleCache stereo_in_right_handle_;
+  utils::ObjectHandleCache stereo_out_left_handle_;
+  utils::ObjectHandleCache stereo_out_right_handle_;
+  utils::ObjectHandleCache midi_in_handle_;
+  utils::ObjectHandleCache midi_out_handle_;
+
+  /**
+   * Ramps the gains applied to the left and right outputs (amplitude and
+   * balance) so that changes don't cause zipper noise.
+   */
+  std::pair<dsp::ParameterSmoother, dsp::ParameterSmoother> gain_smoothers_{
+    dsp::ParameterSmoother (dsp::ParameterSmoother::Mode::Exponential),
+    dsp::ParameterSmoother (dsp::ParameterSmoother::Mode::Exponential)
+  };
+
 public:
   /**
    * Current dBFS after processing each output port.
@@ -536,6 +591,13 @@ public:
   /** Cache. */
   bool was_effectively_muted_ = false;
 
+  /**
+   * @brief Cached get_implied_soloed(), for use while processing.
+   *
+   * @see Tracklist::update_solo_state().
+   */
+  std::atomic<bool> implied_soloed_ = false;
+
   OptionalRef<PortRegistry> port_registry_;
 };
 
@@ -157,6 +157,27 @@ FoldableTrack::
     {
       folded_ = folded;
 
+      /* load the clips of the tracks that became visible first if clips are
+       * still loading */
+      if (!folded && AUDIO_POOL->has_pending_clips ())
+        {
+          std::vector<AudioClip *> clips;
+          for (const auto &track_var : TRACKLIST->get_track_span ())
+            {
+              std::visit (
+                [&] (auto &&track) {
+                  if (is_child (*track) && track->should_be_visible ())
+                    {
+                      std::ranges::copy (
+                        AudioPool::get_clips_used_by_track (*track),
+                        std::back_inserter (clips));
+                    }
+                },
+                track_var);
+            }
+          AUDIO_POOL->prioritize_clips (clips);
+        }
+
       if (fire_events)
         {
           // EVENTS_PUSH (EventType::ET_TRACK_FOLD_CHANGED, this);
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
 #include "dsp/graph.h"
+#include "dsp/graph_profile.h"
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/dsp/fader.h"
@@ -11,7 +12,9 @@
 #include "gui/dsp/project_graph_builder.h"
 #include "gui/dsp/router.h"
 #include "gui/dsp/track.h"
+#include "utils/exceptions.h"
 #include "utils/flags.h"
+#include "utils/io.h"
 #include "utils/objects.h"
 
 #ifdef HAVE_CGRAPH
@@ -431,3 +434,52 @@ graph_export_as (
 
   z_info ("graph exported");
 }
+
+void
+graph_export_profile (const fs::path &path)
+{
+  auto &router = *AUDIO_ENGINE->router_;
+  if (!router.scheduler_)
+    {
+      throw ZrythmException ("The graph is not running");
+    }
+
+  const auto profile = dsp::GraphProfile::capture (
+    router.scheduler_->get_nodes (), router.scheduler_->get_thread_names ());
+  const auto ext = path.extension ().string ();
+  if (ext.empty ())
+    {
+      throw ZrythmException ("No format given (missing file extension)");
+    }
+  z_info ("exporting graph profile to {}...", path);
+  if (ext == ".json")
+    {
+      utils::io::set_file_contents (path, profile.to_json ());
+    }
+  else if (ext == ".dot" || ext == ".gv")
+    {
+      utils::io::set_file_contents (path, profile.to_dot ());
+    }
+  else
+    {
+#ifdef HAVE_CGRAPH
+      GVC_t *    gvc = gvContext ();
+      Agraph_t * agraph = agmemread (profile.to_dot ().c_str ());
+      gvLayout (gvc, agraph, "dot");
+      const int ret = gvRenderFilename (
+        gvc, agraph, ext.substr (1).c_str (), path.string ().c_str ());
+      gvFreeLayout (gvc, agraph);
+      agclose (agraph);
+      gvFreeContext (gvc);
+      if (ret != 0)
+        {
+          throw ZrythmException (
+            fmt::format ("Failed to render the graph as '{}'", ext));
+        }
+#else
+      throw ZrythmException (fmt::format (
+        "Cannot export the graph as '{}' without Graphviz", ext));
+#endif
+    }
+  z_info ("graph profile exported");
+}
@@ -12,6 +12,8 @@
 
 #include "zrythm-config.h"
 
+#include "utils/types.h"
+
 using namespace zrythm;
 
 namespace zrythm::dsp
@@ -50,6 +52,19 @@ graph_export_as_simple (GraphExportType type, const char * export_path);
 void
 graph_export_as (dsp::Graph * graph, GraphExportType type, const char * path);
 
+/**
+ * Exports the running graph annotated with the measured processing cost,
+ * latency and thread of each node, with the critical path highlighted (see
+ * dsp::GraphProfile).
+ *
+ * The format is chosen from the extension: ".json", ".dot"/".gv", or any
+ * other format supported by Graphviz (e.g. ".svg") if available.
+ *
+ * @throw ZrythmException If the format is not supported or writing failed.
+ */
+void
+graph_export_profile (const fs::path &path);
+
 /**
  * @}
  */
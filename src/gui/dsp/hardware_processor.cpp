@@ -98,74 +98,76 @@ HardwareProcessor::create_port_for_ext_port (
   return port;
 }
 
-void
-HardwareProcessor::rescan_ext_ports ()
+ExtPort *
+HardwareProcessor::add_ext_port (const ExtPort &ext_port)
 {
-  z_debug ("rescanning ports...");
+  if (auto * existing = find_ext_port (ext_port.get_id ()))
+    return existing;
 
-  /* get correct flow */
-  PortFlow flow =
-    /* these are reversed:
-     * input here -> port that outputs in backend */
-    is_input_ ? PortFlow::Output : PortFlow::Input;
+  auto new_port = std::make_unique<ExtPort> (ext_port);
+  new_port->hw_processor_ = this;
+  auto * ret = new_port.get ();
+  if (ext_port.is_midi_)
+    {
+      ext_midi_ports_.push_back (std::move (new_port));
+      midi_ports_.push_back (
+        create_port_for_ext_port<MidiPort> (*ret, PortFlow::Output));
+    }
+  else
+    {
+      ext_audio_ports_.push_back (std::move (new_port));
+      audio_ports_.push_back (
+        create_port_for_ext_port<AudioPort> (*ret, PortFlow::Output));
+    }
 
-  // Function to collect and add ports
-  auto collect_and_add_ports = [&] (dsp::PortType type) {
-    std::vector<ExtPort> ports;
-    ExtPort::ext_ports_get (type, flow, true, ports, *engine_);
+  z_info (
+    "[HW] Added {} port {}", ext_port.is_midi_ ? "MIDI" : "audio",
+    ext_port.get_id ());
+  return ret;
+}
 
-    for (const auto &ext_port : ports)
+void
+HardwareProcessor::reconnect_pending_ports ()
+{
+  /* attempt to reconnect the ports that need reconnect (e.g. if disconnected
+   * earlier) */
+  const auto reconnect = [] (auto &ext_ports, auto &ports) {
+    for (size_t i = 0; i < ext_ports.size (); i++)
       {
-        if (!find_ext_port (ext_port.get_id ()))
+        auto &ext_port = ext_ports[i];
+        if (ext_port->pending_reconnect_)
           {
-            auto new_port = std::make_unique<ExtPort> (ext_port);
-            new_port->hw_processor_ = this;
-
-            if (type == dsp::PortType::Audio)
-              {
-                ext_audio_ports_.push_back (std::move (new_port));
-              }
-            else
+            if (ext_port->activate (ports[i].get (), true))
               {
-                ext_midi_ports_.push_back (std::move (new_port));
+                ext_port->pending_reconnect_ = false;
               }
-
-            z_info (
-              "[HW] Added {} port {}",
-              type == dsp::PortType::Audio ? "audio" : "MIDI",
-              ext_port.get_id ());
           }
       }
   };
+  reconnect (ext_midi_ports_, midi_ports_);
+  reconnect (ext_audio_ports_, audio_ports_);
+}
 
-  // Collect and add audio ports
-  collect_and_add_ports (dsp::PortType::Audio);
-
-  // Collect and add MIDI ports
-  collect_and_add_ports (dsp::PortType::Event);
-
-  /* create ports for each ext port */
-  audio_ports_.reserve (std::max (size_t (1), ext_audio_ports_.size ()));
-  midi_ports_.reserve (std::max (size_t (1), ext_midi_ports_.size ()));
-
-  auto create_ports = [&]<typename PortType> (const auto &ext_ports, auto &ports) {
-    for (size_t i = 0; i < ext_ports.size (); ++i)
-      {
-        const auto &ext_port = ext_ports[i];
-        assert (ext_port);
-
-        if (i >= ports.size ())
-          {
-            ports.emplace_back (
-              create_port_for_ext_port<PortType> (*ext_port, PortFlow::Output));
-          }
+void
+HardwareProcessor::rescan_ext_ports ()
+{
+  z_debug ("rescanning ports...");
 
-        assert (ports[i]);
-      }
-  };
+  /* get correct flow */
+  PortFlow flow =
+    /* these are reversed:
+     * input here -> port that outputs in backend */
+    is_input_ ? PortFlow::Output : PortFlow::Input;
 
-  create_ports.template operator()<AudioPort> (ext_audio_ports_, audio_ports_);
-  create_ports.template operator()<MidiPort> (ext_midi_ports_, midi_ports_);
+  for (const auto type : { dsp::PortType::Audio, dsp::PortType::Event })
+    {
+      std::vector<ExtPort> ports;
+      ExtPort::ext_ports_get (type, flow, true, ports, *engine_);
+      for (const auto &ext_port : ports)
+        {
+          add_ext_port (ext_port);
+        }
+    }
 
   /* TODO deactivate ports that weren't found (stop engine temporarily to
    * remove) */
@@ -175,21 +177,103 @@ HardwareProcessor::rescan_ext_ports ()
     is_input_ ? "HW processor inputs" : "HW processor outputs",
     ext_audio_ports_.size (), ext_midi_ports_.size ());
 
-  for (size_t i = 0; i < ext_midi_ports_.size (); i++)
+  reconnect_pending_ports ();
+}
+
+bool
+HardwareProcessor::has_ext_port_notifications () const
+{
+#if HAVE_JACK
+  /* port registration callbacks (see engine_jack_setup()) */
+  return engine_ && engine_->audio_backend_ == AudioBackend::AUDIO_BACKEND_JACK
+         && engine_->midi_backend_ == MidiBackend::MIDI_BACKEND_JACK;
+#else
+  return false;
+#endif
+}
+
+void
+HardwareProcessor::notify_ext_port_change (
+  std::string full_name,
+  bool        registered)
+{
+  {
+    std::lock_guard lock (ext_port_changes_mutex_);
+    ext_port_changes_.push_back (
+      { .full_name_ = std::move (full_name), .registered_ = registered });
+  }
+  if (ext_port_changes_notifier_)
     {
-      auto &ext_port = ext_midi_ports_[i];
+      ext_port_changes_notifier_->notify ();
+    }
+}
+
+void
+HardwareProcessor::apply_ext_port_changes ()
+{
+  std::vector<ExtPortChange> changes;
+  {
+    std::lock_guard lock (ext_port_changes_mutex_);
+    changes.swap (ext_port_changes_);
+  }
+  if (changes.empty () || !engine_)
+    return;
+
+#if HAVE_JACK
+  if (!engine_->client_)
+    return;
 
-      /* attempt to reconnect the if the port needs reconnect (e.g. if
-       * disconnected earlier) */
-      if (ext_port->pending_reconnect_)
+  const PortFlow flow = is_input_ ? PortFlow::Output : PortFlow::Input;
+
+  /* the engine skips cycles while this is held, instead of processing the
+   * port lists while they are modified */
+  SemaphoreRAII sem (engine_->port_operation_lock_, true);
+
+  for (const auto &change : changes)
+    {
+      if (!change.registered_)
         {
-          auto &port = midi_ports_[i];
-          if (ext_port->activate (port.get (), true))
+          /* keep the port (the engine refers to it) and reconnect it if it
+           * comes back */
+          ExtPort tmp;
+          tmp.type_ = ExtPort::Type::JACK;
+          tmp.full_name_ = change.full_name_;
+          if (auto * ext_port = find_ext_port (tmp.get_id ()))
             {
-              ext_port->pending_reconnect_ = false;
+              z_info ("[HW] Port {} disappeared", ext_port->get_id ());
+              /* looked up again on reconnect */
+              ext_port->jport_ = nullptr;
+              ext_port->pending_reconnect_ = ext_port->active_;
+              ext_port->active_ = false;
             }
+          continue;
+        }
+
+      auto * jport =
+        jack_port_by_name (engine_->client_, change.full_name_.c_str ());
+      if (!jport)
+        continue;
+      const auto type = ExtPort::get_jack_port_type (jport, flow, true);
+      if (!type)
+        continue;
+
+      ExtPort ext_port (jport);
+      ext_port.is_midi_ = *type == dsp::PortType::Event;
+      auto * added = add_ext_port (ext_port);
+
+      /* activate the port if the user selected it */
+      const auto &selected =
+        ext_port.is_midi_ ? selected_midi_ports_ : selected_audio_ports_;
+      if (
+        activated_ && std::ranges::contains (selected, added->get_id ())
+        && !added->active_)
+        {
+          added->pending_reconnect_ = true;
         }
     }
+
+  reconnect_pending_ports ();
+#endif
 }
 
 void
@@ -216,6 +300,13 @@ HardwareProcessor::setup ()
 
   /* ---- end scan ---- */
 
+  /* from now on, only apply the changes the backend notifies about */
+  if (has_ext_port_notifications () && !ext_port_changes_notifier_)
+    {
+      ext_port_changes_notifier_ = std::make_unique<utils::MainThreadNotifier> (
+        [this] () { apply_ext_port_changes (); });
+    }
+
   setup_ = true;
 }
 
@@ -244,24 +335,6 @@ HardwareProcessor::activate (bool activate)
   activate_ports (selected_midi_ports_);
   activate_ports (selected_audio_ports_);
 
-  if (activate && !rescan_timeout_id_)
-    {
-      /* TODO: do the following on another thread - this blocks the UI
-       * until then, the rescan is done when temporarily pausing the engine (so
-       * on a user action) */
-#if 0
-      /* add timer to keep rescanning */
-      self->rescan_timeout_id = g_timeout_add_seconds (
-        7, (GSourceFunc) hardware_processor_rescan_ext_ports, self);
-#endif
-    }
-  else if (!activate && rescan_timeout_id_)
-    {
-      /* remove timeout */
-      // g_source_remove (rescan_timeout_id_);
-      rescan_timeout_id_ = 0;
-    }
-
   activated_ = activate;
 }
 
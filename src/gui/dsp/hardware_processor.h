@@ -4,11 +4,14 @@
 #ifndef __AUDIO_HARDWARE_PROCESSOR_H__
 #define __AUDIO_HARDWARE_PROCESSOR_H__
 
+#include <mutex>
+
 #include "gui/dsp/audio_port.h"
 #include "gui/dsp/ext_port.h"
 #include "gui/dsp/midi_port.h"
 
 #include "utils/icloneable.h"
+#include "utils/main_thread_notifier.h"
 
 class AudioEngine;
 
@@ -45,10 +48,32 @@ public:
     /**
      * Rescans the hardware ports and appends any missing ones.
      *
-     * @note This was a GSource callback.
+     * Enumerating the devices can be slow, so this is only done on setup and,
+     * for backends without port change notifications, when the engine is
+     * paused.
+     *
+     * @see has_ext_port_notifications().
      */
     void rescan_ext_ports ();
 
+    /**
+     * Returns whether the backend notifies about hardware ports appearing and
+     * disappearing (see notify_ext_port_change()), so that rescanning is not
+     * needed.
+     */
+    bool has_ext_port_notifications () const;
+
+    /**
+     * Queues a change in the backend's ports (e.g., a device was plugged in),
+     * to be applied on the main thread.
+     *
+     * To be called from the backend's notification thread (not realtime).
+     *
+     * @param full_name Full name of the port in the backend.
+     * @param registered Whether the port appeared or disappeared.
+     */
+    void notify_ext_port_change (std::string full_name, bool registered);
+
     /**
      * Finds an ext port from its ID (type + full name).
      *
@@ -96,6 +121,23 @@ public:
     std::unique_ptr<T>
     create_port_for_ext_port (const ExtPort &ext_port, PortFlow flow);
 
+    /**
+     * Adds @p ext_port and a port for it, if not known yet.
+     *
+     * @return The known or added ext port.
+     */
+    ExtPort * add_ext_port (const ExtPort &ext_port);
+
+    /**
+     * Reconnects the MIDI ports that were disconnected in the backend.
+     */
+    void reconnect_pending_ports ();
+
+    /**
+     * Applies the changes queued by notify_ext_port_change().
+     */
+    void apply_ext_port_changes ();
+
   public:
     /**
      * Whether this is the processor at the start of the graph (input) or at the
@@ -131,10 +173,22 @@ public:
     /** Whether currently active. */
     bool activated_ = false;
 
-    quint64 rescan_timeout_id_ = 0;
-
     /** Pointer to owner engine, if any. */
     AudioEngine * engine_ = nullptr;
+
+  private:
+    struct ExtPortChange
+    {
+      std::string full_name_;
+      bool        registered_ = false;
+    };
+
+    /** Port changes not applied yet (protected by the mutex below). */
+    std::vector<ExtPortChange> ext_port_changes_;
+    std::mutex                 ext_port_changes_mutex_;
+
+    /** Applies the port changes on the main thread (created in setup()). */
+    std::unique_ptr<utils::MainThreadNotifier> ext_port_changes_notifier_;
 };
 
 extern template std::unique_ptr<MidiPort>
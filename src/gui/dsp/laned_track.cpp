@@ -24,8 +24,6 @@ LanedTrackImpl<TrackLaneT>::remove_empty_last_lanes ()
   if (last_lane_created_ > 0)
     return;
 
-  lanes_.beginResetModel ();
-
   z_info ("removing empty last lanes from {}", name_);
   bool removed = false;
   for (int i = lanes_.size () - 1; i >= 1; i--)
@@ -47,8 +45,6 @@ LanedTrackImpl<TrackLaneT>::remove_empty_last_lanes ()
         }
     }
 
-  lanes_.endResetModel ();
-
   if (removed)
     {
       // EVENTS_PUSH (EventType::ET_TRACK_LANE_REMOVED, nullptr);
@@ -132,13 +128,17 @@ template <typename TrackLaneT>
 void
 LanedTrackImpl<TrackLaneT>::set_playback_caches ()
 {
+  /* update the previous lane snapshots so that the snapshots of unchanged
+   * regions are reused */
+  auto prev_snapshots = std::move (lane_snapshots_);
   lane_snapshots_.clear ();
   lane_snapshots_.reserve (lanes_.size ());
-  for (const auto &lane_var : lanes_)
+  for (size_t i = 0; i < lanes_.size (); ++i)
     {
-      auto lane = std::get<TrackLaneT *> (lane_var);
+      auto lane = std::get<TrackLaneT *> (lanes_.at (i));
 
-      lane_snapshots_.push_back (lane->gen_snapshot ());
+      lane_snapshots_.push_back (lane->gen_snapshot (
+        i < prev_snapshots.size () ? std::move (prev_snapshots[i]) : nullptr));
     }
 }
 
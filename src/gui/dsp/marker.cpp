@@ -13,7 +13,6 @@ Marker::Marker (const std::string &name, QObject * parent)
     : ArrangerObject (ArrangerObject::Type::Marker), QObject (parent),
       NamedObject (name)
 {
-  ArrangerObject::parent_base_qproperties (*this);
 }
 
 void
@@ -9,6 +9,7 @@
 #include "gui/backend/zrythm_application.h"
 #include "gui/dsp/engine.h"
 #include "gui/dsp/metronome.h"
+#include "gui/dsp/tempo_track.h"
 #include "gui/dsp/transport.h"
 
 #include "dsp/position.h"
@@ -67,6 +68,16 @@ Metronome::Metronome (AudioEngine &engine)
       : (float) zrythm::gui::SettingsManager::metronomeVolume ();
 }
 
+void
+Metronome::update_click_grid (const AudioEngine &engine)
+{
+  const auto * tempo_track = engine.project_->tracklist_->tempo_track_;
+  z_return_if_fail (tempo_track);
+  click_schedule_.set_grid (
+    engine.frames_per_tick_, engine.project_->transport_->ticks_per_beat_,
+    tempo_track->get_beats_per_bar ());
+}
+
 void
 Metronome::queue_events (
   AudioEngine *   engine,
@@ -76,12 +87,12 @@ Metronome::queue_events (
   using Position = dsp::Position;
   auto *     transport_ = engine->project_->transport_;
   const auto playhead = transport_->playhead_pos_;
-  Position   bar_pos, beat_pos;
   Position   playhead_pos = playhead->get_position ();
   Position   unlooped_playhead = playhead->get_position ();
   transport_->position_add_frames (playhead_pos, nframes);
   unlooped_playhead.add_frames ((long) nframes, engine->ticks_per_frame_);
   bool loop_crossed = unlooped_playhead.frames_ != playhead_pos.frames_;
+  update_click_grid (*engine);
   if (loop_crossed)
     {
       /* find each bar / beat change until loop end */
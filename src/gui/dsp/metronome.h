@@ -12,6 +12,7 @@
 
 #include <filesystem>
 
+#include "dsp/metronome_click_schedule.h"
 #include "dsp/position.h"
 #include "juce_wrapper.h"
 #include "utils/types.h"
@@ -55,6 +56,14 @@ public:
 
   void set_volume (float volume);
 
+  /**
+   * @brief Updates the grid of @ref click_schedule_ from the engine's tempo
+   * and time signature.
+   *
+   * Realtime-safe.
+   */
+  void update_click_grid (const AudioEngine &engine);
+
   /**
    * Queues metronome events (if any) within the current processing cycle.
    *
@@ -78,6 +87,9 @@ public:
   /** The normal sample. */
   SampleBufferPtr normal_;
 
+  /** Clicks of the upcoming beats (used by the engine thread only). */
+  zrythm::dsp::MetronomeClickSchedule click_schedule_;
+
   float volume_;
 };
 
@@ -68,6 +68,9 @@ static const char * midi_event_type_strings[] = {
   "pitchbend", "controller", "note off", "note on", "all notes off",
 };
 
+static bool
+event_less (const MidiEvent &a, const MidiEvent &b);
+
 void
 MidiEventVector::append (
   const MidiEventVector &src,
@@ -77,6 +80,85 @@ MidiEventVector::append (
   append_w_filter (src, std::nullopt, local_offset, nframes);
 }
 
+void
+MidiEventVector::merge (
+  std::span<const MidiEventVector * const> sources,
+  const nframes_t                          local_offset,
+  const nframes_t                          nframes)
+{
+  /* merge in batches so that the source ranges fit on the stack */
+  if (sources.size () > MAX_MERGE_SOURCES) [[unlikely]]
+    {
+      for (size_t i = 0; i < sources.size (); i += MAX_MERGE_SOURCES)
+        {
+          merge (
+            sources.subspan (
+              i, std::min (MAX_MERGE_SOURCES, sources.size () - i)),
+            local_offset, nframes);
+        }
+      return;
+    }
+
+  std::array<std::span<const MidiEvent>, MAX_MERGE_SOURCES> ranges;
+  size_t num_new_events = 0;
+  for (size_t i = 0; i < sources.size (); ++i)
+    {
+      z_return_if_fail (sources[i] != this);
+
+      /* only merge events inside the current time range */
+      const auto &src = sources[i]->events_;
+      const auto  first =
+        std::ranges::lower_bound (src, local_offset, {}, &MidiEvent::time_);
+      const auto last = std::ranges::lower_bound (
+        first, src.end (), local_offset + nframes, {}, &MidiEvent::time_);
+      auto num_events = static_cast<size_t> (last - first);
+      if (fixed_capacity_)
+        {
+          num_events = std::min (
+            num_events, MAX_MIDI_EVENTS - events_.size () - num_new_events);
+        }
+      ranges[i] = std::span (first, num_events);
+      num_new_events += num_events;
+    }
+  if (num_new_events == 0)
+    return;
+
+  /* fill from the end, taking the last of the remaining events each time */
+  size_t num_dest_events = events_.size ();
+  size_t out = num_dest_events + num_new_events;
+  events_.resize (out);
+  while (out > num_dest_events)
+    {
+      const MidiEvent * last_ev =
+        num_dest_events > 0 ? &events_[num_dest_events - 1] : nullptr;
+      std::span<const MidiEvent> * last_range = nullptr;
+      for (size_t i = 0; i < sources.size (); ++i)
+        {
+          auto &range = ranges[i];
+          if (
+            !range.empty ()
+            && (last_ev == nullptr || !event_less (range.back (), *last_ev)))
+            {
+              last_ev = &range.back ();
+              last_range = &range;
+            }
+        }
+
+      if (last_range != nullptr)
+        {
+          events_[--out] = *last_ev;
+          *last_range = last_range->first (last_range->size () - 1);
+        }
+      else
+        {
+          events_[--out] = events_[--num_dest_events];
+        }
+    }
+
+  /* clear duplicates */
+  clear_duplicates ();
+}
+
 void
 MidiEventVector::transform_chord_and_append (
   MidiEventVector &src,
@@ -84,7 +166,6 @@ MidiEventVector::transform_chord_and_append (
   const nframes_t  nframes)
 {
   {
-    const std::lock_guard<crill::spin_mutex> lock (src.lock_);
     for (const auto &src_ev : src.events_)
       {
         /* only copy events inside the current time range */
@@ -139,7 +220,6 @@ MidiEventVector::append_w_filter (
   const nframes_t                     nframes)
 {
   {
-    const std::lock_guard<crill::spin_mutex> lock (src.lock_);
     for (const auto &src_ev : src.events_)
       {
         /* only copy events inside the current time range */
@@ -178,7 +258,6 @@ MidiEventVector::append_w_filter (
 void
 MidiEventVector::set_channel (const midi_byte_t channel)
 {
-  const std::lock_guard<crill::spin_mutex> lock (lock_);
   for (auto &ev : events_)
     {
       /* do this on all MIDI events that have channels */
@@ -284,12 +363,26 @@ MidiEvents::has_note_on (bool check_main, bool check_queued)
 }
 #endif
 
+void
+MidiEvents::queue_from_non_rt (const MidiEventVector &events)
+{
+  for (const auto &ev : events)
+    {
+      if (!non_rt_events_.write (ev))
+        {
+          z_warning ("MIDI event queue full, dropping events");
+          return;
+        }
+    }
+}
+
 void
 MidiEvents::dequeue (const nframes_t local_offset, const nframes_t nframes)
 {
-  if (ZRYTHM_TESTING) [[unlikely]]
+  MidiEvent ev;
+  while (non_rt_events_.read (ev))
     {
-      assert (active_events_.capacity () >= queued_events_.size ());
+      queued_events_.insert_sorted (ev);
     }
 
   active_events_.append (queued_events_, local_offset, nframes);
@@ -299,8 +392,7 @@ MidiEvents::dequeue (const nframes_t local_offset, const nframes_t nframes)
 }
 
 void
-MidiEventVector::
-  add_all_notes_off (midi_byte_t channel, midi_time_t time, bool with_lock)
+MidiEventVector::add_all_notes_off (midi_byte_t channel, midi_time_t time)
 {
   z_return_if_fail (channel > 0 && channel <= 16);
 
@@ -309,40 +401,12 @@ MidiEventVector::
     0x00, time);
   z_return_if_fail (midi_is_all_notes_off (ev.raw_buffer_.data ()));
 
-  if (with_lock)
-    {
-      lock_.lock ();
-    }
-
-  events_.push_back (ev);
-
-  if (with_lock)
-    {
-      lock_.unlock ();
-    }
-}
-
-void
-MidiEventVector::panic ()
-{
-  // if (zrythm_app)
-  //   {
-  //     z_return_if_fail (current_thread_id.get () ==
-  //     zrythm_app->gtk_thread_id_);
-  //   }
-
-  while (lock_.try_lock ())
-    {
-      std::this_thread::sleep_for (std::chrono::milliseconds (10));
-    }
-  panic_without_lock ();
-  lock_.unlock ();
+  push_back (ev);
 }
 
 void
 MidiEventVector::write_to_midi_file (MIDI_FILE * mf, int midi_track) const
 {
-  const std::lock_guard<crill::spin_mutex> lock (lock_);
   z_return_if_fail (midi_track > 0);
 
   int last_time = 0;
@@ -365,7 +429,6 @@ MidiEventVector::copy_to_jack (
   const nframes_t nframes,
   void *          buff) const
 {
-  const std::lock_guard<crill::spin_mutex> lock (lock_);
   /*jack_midi_clear_buffer (buff);*/
 
   for (const auto &ev : events_)
@@ -502,28 +565,48 @@ get_event_type (const std::array<midi_byte_t, 3> _short_msg)
     return MidiEventType::MIDI_EVENT_TYPE_RAW;
 }
 
-void
-MidiEventVector::sort ()
+/**
+ * Returns whether @p a should be processed before @p b.
+ */
+static bool
+event_less (const MidiEvent &a, const MidiEvent &b)
 {
-  const std::lock_guard<crill::spin_mutex> lock (lock_);
-
-  std::sort (
-    events_.begin (), events_.end (),
-    [] (const MidiEvent &a, const MidiEvent &b) {
-      if (a.time_ == b.time_) [[unlikely]]
-        {
-          MidiEventType a_type = get_event_type (a.raw_buffer_);
-          MidiEventType b_type = get_event_type (b.raw_buffer_);
-          (void) midi_event_type_strings;
+  if (a.time_ == b.time_) [[unlikely]]
+    {
+      MidiEventType a_type = get_event_type (a.raw_buffer_);
+      MidiEventType b_type = get_event_type (b.raw_buffer_);
+      (void) midi_event_type_strings;
 #if 0
       z_debug ("a type {}, b type {}",
         midi_event_type_strings[a_type],
         midi_event_type_strings[b_type]);
 #endif
-          return (int) a_type < (int) b_type;
-        }
-      return a.time_ < b.time_;
-    });
+      return (int) a_type < (int) b_type;
+    }
+  return a.time_ < b.time_;
+}
+
+void
+MidiEventVector::sort ()
+{
+  std::sort (events_.begin (), events_.end (), event_less);
+}
+
+bool
+MidiEventVector::is_sorted () const
+{
+  return std::ranges::is_sorted (events_, event_less);
+}
+
+bool
+MidiEventVector::insert_sorted (const MidiEvent &ev)
+{
+  if (fixed_capacity_ && events_.size () >= MAX_MIDI_EVENTS) [[unlikely]]
+    return false;
+
+  events_.insert (
+    std::upper_bound (events_.begin (), events_.end (), ev, event_less), ev);
+  return true;
 }
 
 void
@@ -661,7 +744,6 @@ MidiEvent::print () const
 void
 MidiEventVector::print () const
 {
-  const std::lock_guard<crill::spin_mutex> lock (lock_);
   for (const auto &ev : events_)
     {
       ev.print ();
@@ -673,7 +755,11 @@ MidiEvents::panic_all ()
 {
   z_info ("~ midi panic all ~");
 
-  AUDIO_ENGINE->midi_editor_manual_press_->midi_events_.queued_events_.panic ();
+  MidiEventVector panic_events;
+  panic_events.panic ();
+
+  AUDIO_ENGINE->midi_editor_manual_press_->midi_events_.queue_from_non_rt (
+    panic_events);
 
   for (auto track_var : TRACKLIST->get_track_span ())
     {
@@ -685,7 +771,7 @@ MidiEvents::panic_all ()
             || std::is_same_v<TrackT, ChordTrack>)
             {
               track->processor_->get_piano_roll_port ()
-                .midi_events_.queued_events_.panic ();
+                .midi_events_.queue_from_non_rt (panic_events);
             }
         },
         track_var);
@@ -695,8 +781,6 @@ MidiEvents::panic_all ()
 void
 MidiEventVector::clear_duplicates ()
 {
-  const std::lock_guard<crill::spin_mutex> lock (lock_);
-
   /* push duplicates to the end of the vector and get iterator to first
    * duplicate*/
   auto last = std::unique (events_.begin (), events_.end ());
@@ -15,9 +15,11 @@
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
+#include <span>
+#include <vector>
 
-#include "crill/spin_mutex.h"
 #include "midilib/src/midifile.h"
+#include "utils/ring_buffer.h"
 #include "utils/types.h"
 
 using namespace zrythm;
@@ -34,7 +36,7 @@ class ChordDescriptor;
  */
 
 /** Max events to hold in queues. */
-constexpr int MAX_MIDI_EVENTS = 2560;
+constexpr size_t MAX_MIDI_EVENTS = 2560;
 
 /**
  * Timed MIDI event.
@@ -83,14 +85,25 @@ operator== (const MidiEvent &lhs, const MidiEvent &rhs)
 }
 
 /**
- * @brief A lock-free thread-safe vector of `MidiEvent`s.
+ * @brief A vector of `MidiEvent`s.
  *
- * Not necessarily the best implementation, but it's good enough for now.
+ * This is not thread-safe: each vector must only be used by one thread at a
+ * time. Events are handed over to the realtime thread through
+ * MidiEvents::queue_from_non_rt().
  */
 class MidiEventVector final
 {
 public:
-  MidiEventVector () { events_.reserve (MAX_MIDI_EVENTS); }
+  /**
+   * @param fixed_capacity Whether the capacity is fixed to MAX_MIDI_EVENTS,
+   * in which case events that don't fit are dropped instead of reallocating
+   * (for use in the realtime thread).
+   */
+  explicit MidiEventVector (bool fixed_capacity = false)
+      : fixed_capacity_ (fixed_capacity)
+  {
+    events_.reserve (MAX_MIDI_EVENTS);
+  }
 
   using ChordDescriptor = dsp::ChordDescriptor;
 
@@ -99,103 +112,79 @@ public:
   using ConstIterator = std::vector<MidiEvent>::const_iterator;
 
   // Iterator methods
-  Iterator begin ()
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.begin ();
-  }
-
-  Iterator end ()
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.end ();
-  }
+  Iterator      begin () { return events_.begin (); }
+  Iterator      end () { return events_.end (); }
+  ConstIterator begin () const { return events_.begin (); }
+  ConstIterator end () const { return events_.end (); }
 
-  void erase (Iterator it, Iterator it_end)
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    events_.erase (it, it_end);
-  }
-
-  ConstIterator begin () const
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.begin ();
-  }
+  void erase (Iterator it, Iterator it_end) { events_.erase (it, it_end); }
 
-  ConstIterator end () const
+  /**
+   * @brief Appends @p ev (unless full, if the capacity is fixed).
+   *
+   * @return Whether the event was added.
+   */
+  bool push_back (const MidiEvent &ev)
   {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.end ();
-  }
+    if (fixed_capacity_ && events_.size () >= MAX_MIDI_EVENTS) [[unlikely]]
+      return false;
 
-  void push_back (const MidiEvent &ev)
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
     events_.push_back (ev);
+    return true;
   }
 
   void push_back (const std::vector<MidiEvent> &events)
   {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    events_.insert (events_.end (), events.begin (), events.end ());
+    auto num_events = events.size ();
+    if (fixed_capacity_)
+      {
+        num_events = std::min (num_events, MAX_MIDI_EVENTS - events_.size ());
+      }
+    events_.insert (
+      events_.end (), events.begin (),
+      events.begin () + static_cast<std::ptrdiff_t> (num_events));
   }
 
+  /**
+   * @brief Inserts @p ev after the events that sort before or equal to it
+   * (see sort()), so that sorted events stay sorted.
+   *
+   * @return Whether the event was added.
+   */
+  bool insert_sorted (const MidiEvent &ev);
+
   MidiEvent pop_front ()
   {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    MidiEvent                                ev = events_.front ();
+    MidiEvent ev = events_.front ();
     events_.erase (events_.begin ());
     return ev;
   }
 
   MidiEvent pop_back ()
   {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    MidiEvent                                ev = events_.back ();
+    MidiEvent ev = events_.back ();
     events_.pop_back ();
     return ev;
   }
 
-  void clear ()
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    events_.clear ();
-  }
+  void clear () { events_.clear (); }
 
-  size_t size () const
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.size ();
-  }
+  size_t size () const { return events_.size (); }
 
-  MidiEvent front () const
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.front ();
-  }
+  MidiEvent front () const { return events_.front (); }
 
-  MidiEvent back () const
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.back ();
-  }
+  MidiEvent back () const { return events_.back (); }
 
-  MidiEvent at (size_t index) const
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.at (index);
-  }
+  MidiEvent at (size_t index) const { return events_.at (index); }
 
   void swap (MidiEventVector &other)
   {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
     events_.swap (other.events_);
+    std::swap (fixed_capacity_, other.fixed_capacity_);
   }
 
-  void remove_if (std::function<bool (const MidiEvent &)> predicate)
+  template <typename Predicate> void remove_if (Predicate predicate)
   {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
     events_.erase (
       std::remove_if (events_.begin (), events_.end (), predicate),
       events_.end ());
@@ -209,11 +198,7 @@ public:
     remove_if ([&event] (const MidiEvent &e) { return e == event; });
   }
 
-  size_t capacity () const
-  {
-    const std::lock_guard<crill::spin_mutex> lock (lock_);
-    return events_.capacity ();
-  }
+  size_t capacity () const { return events_.capacity (); }
 
   void print () const;
 
@@ -239,6 +224,36 @@ public:
   void
   append (const MidiEventVector &src, nframes_t local_offset, nframes_t nframes);
 
+  /**
+   * @brief Merges the events from @p sources that are inside the given range
+   * into this vector, keeping it sorted.
+   *
+   * Unlike appending and then calling sort(), this takes linear time (for a
+   * bounded number of sources) and doesn't use temporary buffers: the events
+   * are merged in place from the end, into the reserved capacity.
+   *
+   * Events that sort equal keep their order, with the events already in this
+   * vector first, followed by the events of each source in order.
+   *
+   * @pre This vector and each source are sorted (see sort()).
+   * @param local_offset The start frame offset from 0 in this cycle.
+   * @param nframes Number of frames to process.
+   */
+  void merge (
+    std::span<const MidiEventVector * const> sources,
+    nframes_t                                local_offset,
+    nframes_t                                nframes);
+
+  /**
+   * @brief Merges the events from @p src (see the overload above).
+   */
+  void
+  merge (const MidiEventVector &src, nframes_t local_offset, nframes_t nframes)
+  {
+    const std::array<const MidiEventVector *, 1> sources{ &src };
+    merge (sources, local_offset, nframes);
+  }
+
   /**
    * Transforms the given MIDI input to the MIDI notes of the corresponding
    * chord.
@@ -359,27 +374,21 @@ public:
   add_channel_pressure (midi_byte_t channel, midi_byte_t value, midi_time_t time);
 
   /**
-   * Queues MIDI note off to event queue.
+   * Adds an all notes off event.
    */
-  void
-  add_all_notes_off (midi_byte_t channel, midi_time_t time, bool with_lock);
+  void add_all_notes_off (midi_byte_t channel, midi_time_t time);
 
   /**
    * Adds a note off message to every MIDI channel.
    */
-  void panic_without_lock ()
+  void panic ()
   {
     for (midi_byte_t i = 1; i < 17; i++)
       {
-        add_all_notes_off (i, 0, false);
+        add_all_notes_off (i, 0);
       }
   }
 
-  /**
-   * Must only be called from the UI thread.
-   */
-  void panic ();
-
   void write_to_midi_file (MIDI_FILE * mf, int midi_track) const;
 
   /**
@@ -405,6 +414,11 @@ public:
    */
   void sort ();
 
+  /**
+   * @brief Returns whether the events are sorted (see sort()).
+   */
+  bool is_sorted () const;
+
   /**
    * Sets the given MIDI channel on all applicable
    * MIDI events.
@@ -423,10 +437,13 @@ public:
 #endif
 
 private:
+  /** Maximum number of sources merged at once by merge(). */
+  static constexpr size_t MAX_MERGE_SOURCES = 16;
+
   std::vector<MidiEvent> events_;
 
-  /** Spinlock for exclusive read/write. */
-  mutable crill::spin_mutex lock_;
+  /** Whether the capacity is fixed to MAX_MIDI_EVENTS. */
+  bool fixed_capacity_ = false;
 };
 
 class MidiEvents;
@@ -440,8 +457,16 @@ class Port;
 class MidiEvents final
 {
 public:
-  // Rule of 5
-  // MidiEvents ();
+  /**
+   * Hands @p events over to the realtime thread, which adds them to @ref
+   * queued_events_ at the start of the next dequeue().
+   *
+   * Events that don't fit in the hand-off buffer are dropped.
+   *
+   * @note Must only be called from one non-realtime thread at a time
+   * (usually the GUI thread).
+   */
+  void queue_from_non_rt (const MidiEventVector &events);
 
   /**
    * Copies the queue contents to the original struct
@@ -458,18 +483,32 @@ public:
    */
   static void panic_all ();
 
+  /**
+   * @brief Returns the number of bytes used by the event buffers (which have
+   * a fixed capacity).
+   */
+  static constexpr size_t get_memory_usage ()
+  {
+    return 3 * MAX_MIDI_EVENTS * sizeof (MidiEvent);
+  }
+
 public:
   /** Events to use in this cycle. */
-  MidiEventVector active_events_;
+  MidiEventVector active_events_{ true };
 
   /**
-   * For queueing events from the GUI or from hardware, since they run in
-   * different threads.
+   * Events to use in this or later cycles.
    *
    * Engine will copy them to the unqueued MIDI events when ready to be
    * processed.
+   *
+   * @note Only to be used from the realtime thread (see queue_from_non_rt()).
    */
-  MidiEventVector queued_events_;
+  MidiEventVector queued_events_{ true };
+
+private:
+  /** Events from non-realtime threads, for @ref queued_events_. */
+  RingBuffer<MidiEvent> non_rt_events_{ MAX_MIDI_EVENTS };
 };
 
 /**
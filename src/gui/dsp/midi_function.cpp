@@ -10,6 +10,10 @@
 #include "utils/rt_thread_id.h"
 #include "utils/string.h"
 
+#include <limits>
+
+#include <QtConcurrent>
+
 using namespace zrythm;
 
 /**
@@ -168,10 +172,8 @@ MidiFunction::apply (ArrangerObjectSpanVariant sel_var, Type type, Options opts)
                 .template get_elements_by_type<MidiNote> ())
               {
                 double ticks = mn->get_length_in_ticks ();
-                *static_cast<Position *> (mn->pos_) =
-                  poses[(copies.size () - i) - 1];
-                *static_cast<Position *> (mn->end_pos_) =
-                  *static_cast<Position *> (mn->pos_);
+                mn->pos_ = poses[(copies.size () - i) - 1];
+                mn->end_pos_ = mn->pos_;
                 mn->end_pos_->add_ticks (ticks, AUDIO_ENGINE->frames_per_tick_);
                 ++i;
               }
@@ -215,8 +217,7 @@ MidiFunction::apply (ArrangerObjectSpanVariant sel_var, Type type, Options opts)
                 /* make sure the note has a length */
                 if (mn->end_pos_->ticks_ - mn->pos_->ticks_ < 1.0)
                   {
-                    *static_cast<Position *> (mn->end_pos_) =
-                      *static_cast<Position *> (next_mn->pos_);
+                    mn->end_pos_ = next_mn->pos_;
                     mn->end_pos_->add_ms (
                       40.0, AUDIO_ENGINE->sample_rate_,
                       AUDIO_ENGINE->ticks_per_frame_);
@@ -229,8 +230,7 @@ MidiFunction::apply (ArrangerObjectSpanVariant sel_var, Type type, Options opts)
             for (auto it = sel.begin (); it < (sel.end () - 1); ++it)
               {
                 auto mn = std::get<MidiNote *> (*it);
-                *static_cast<dsp::Position *> (mn->end_pos_) =
-                  *static_cast<dsp::Position *> (mn->pos_);
+                mn->end_pos_ = mn->pos_;
                 mn->end_pos_->add_ms (
                   140.0, AUDIO_ENGINE->sample_rate_,
                   AUDIO_ENGINE->ticks_per_frame_);
@@ -266,11 +266,7 @@ MidiFunction::apply (ArrangerObjectSpanVariant sel_var, Type type, Options opts)
                 double ms_to_add = ms_multiplier * opts.time_;
                 z_trace ("multi {:f}, ms {:f}", ms_multiplier, ms_to_add);
                 double len_ticks = mn->get_length_in_ticks ();
-                *static_cast<dsp::Position *> (mn->pos_) =
-                  *static_cast<dsp::Position *> (
-                    first_mn->pos_); // FIXME!!!!!!! setting pointers instead of
-                                     // assigning position !!!!! fix others
-                                     // above too
+                mn->pos_ = first_mn->pos_;
                 mn->pos_->add_ms (
                   ms_to_add, AUDIO_ENGINE->sample_rate_,
                   AUDIO_ENGINE->ticks_per_frame_);
@@ -295,3 +291,89 @@ MidiFunction::apply (ArrangerObjectSpanVariant sel_var, Type type, Options opts)
     },
     sel_var);
 }
+
+void
+MidiFunction::apply (
+  std::span<dsp::PackedNotes> notes_per_region,
+  Type                        type,
+  Options                     opts)
+{
+  z_debug (
+    "applying {} to the notes of {} regions...",
+    MidiFunctionType_to_string (type), notes_per_region.size ());
+
+  dsp::CurveOptions curve_opts;
+  curve_opts.algo_ = opts.curve_algo_;
+  curve_opts.curviness_ = opts.curviness_;
+  const auto ms_to_ticks = [] (double ms) {
+    return dsp::Position::ms_to_ticks (
+      ms, AUDIO_ENGINE->sample_rate_, AUDIO_ENGINE->ticks_per_frame_);
+  };
+
+  /* ranges spanning all the regions */
+  double  first_start = std::numeric_limits<double>::max ();
+  double  last_start = std::numeric_limits<double>::lowest ();
+  uint8_t lowest_pitch = 127;
+  uint8_t highest_pitch = 0;
+  for (const auto &notes : notes_per_region)
+    {
+      if (notes.empty ())
+        continue;
+
+      const auto [first, last] = notes.get_start_range ();
+      first_start = std::min (first_start, first);
+      last_start = std::max (last_start, last);
+      const auto [lowest, highest] = notes.get_pitch_range ();
+      lowest_pitch = std::min (lowest_pitch, lowest);
+      highest_pitch = std::max (highest_pitch, highest);
+    }
+
+  /* convert before going parallel (the conversions use the engine) */
+  const double min_length_ticks = ms_to_ticks (40.0);
+  const double portato_gap_ticks = ms_to_ticks (80.0);
+  const double staccato_length_ticks = ms_to_ticks (140.0);
+  const double strum_ticks = ms_to_ticks (opts.time_);
+
+  QtConcurrent::blockingMap (
+    notes_per_region.begin (), notes_per_region.end (),
+    [&] (dsp::PackedNotes &notes) {
+      if (notes.empty ())
+        return;
+
+      switch (type)
+        {
+        case Type::Crescendo:
+          notes.ramp_velocities (
+            first_start, last_start, opts.start_vel_, opts.end_vel_,
+            curve_opts);
+          break;
+        case Type::Flam:
+          /* currently MIDI functions assume no new notes are added */
+          break;
+        case Type::FlipHorizontal:
+          notes.flip_horizontal ();
+          break;
+        case Type::FlipVertical:
+          notes.flip_vertical (lowest_pitch, highest_pitch);
+          break;
+        case Type::Legato:
+          notes.connect_to_next (0.0, min_length_ticks);
+          break;
+        case Type::Portato:
+          notes.connect_to_next (portato_gap_ticks, min_length_ticks);
+          break;
+        case Type::Staccato:
+          notes.set_lengths (staccato_length_ticks);
+          break;
+        case Type::Strum:
+          notes.strum (strum_ticks, opts.ascending_, curve_opts);
+          break;
+        }
+    });
+
+  if (ZRYTHM_HAVE_UI)
+    {
+      gui::SettingsManager::get_instance ()->set_lastMidiFunction (
+        ENUM_VALUE_TO_INT (type));
+    }
+}
@@ -12,7 +12,10 @@
 #ifndef __AUDIO_MIDI_FUNCTION_H__
 #define __AUDIO_MIDI_FUNCTION_H__
 
+#include <span>
+
 #include "dsp/curve.h"
+#include "dsp/packed_notes.h"
 #include "gui/dsp/arranger_object_span.h"
 #include "utils/format.h"
 #include "utils/types.h"
@@ -73,6 +76,22 @@ public:
    * @throw ZrythmException on error.
    */
   static void apply (ArrangerObjectSpanVariant sel, Type type, Options opts);
+
+  /**
+   * Applies the given function to the packed notes of many regions at once
+   * (see ArrangerSelectionsAction::EditNotesAction).
+   *
+   * The regions are processed in parallel. Functions spanning the whole
+   * selection (crescendo and vertical flip) use the range of all the notes;
+   * the rest apply to the notes of each region separately. Flam is not
+   * supported (it would add notes).
+   *
+   * @param notes_per_region Selected notes of each region.
+   */
+  static void apply (
+    std::span<dsp::PackedNotes> notes_per_region,
+    Type                        type,
+    Options                     opts);
 };
 
 DEFINE_ENUM_FORMATTER (
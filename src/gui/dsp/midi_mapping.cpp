@@ -23,6 +23,7 @@ MidiMappings::init_loaded ()
       z_return_if_fail (dest_var);
       std::visit ([&] (auto &&dest) { mapping->dest_ = dest; }, *dest_var);
     }
+  rebuild_dispatch_table ();
 }
 
 void
@@ -57,6 +58,7 @@ MidiMappings::bind_at (
   mapping->enabled_.store (true);
 
   mappings_.insert (mappings_.begin () + idx, std::move (mapping));
+  rebuild_dispatch_table ();
 
   char str[100];
   midi_ctrl_change_get_ch_and_description (buf.data (), str);
@@ -79,6 +81,7 @@ MidiMappings::unbind (int idx, bool fire_events)
   z_return_if_fail (idx >= 0 && idx < static_cast<int> (mappings_.size ()));
 
   mappings_.erase (mappings_.begin () + idx);
+  rebuild_dispatch_table ();
 
   if (fire_events && ZRYTHM_HAVE_UI)
     {
@@ -86,6 +89,50 @@ MidiMappings::unbind (int idx, bool fire_events)
     }
 }
 
+std::optional<size_t>
+MidiMappings::get_cc_key (midi_byte_t status, midi_byte_t controller)
+{
+  if ((status & 0xf0) != MIDI_CH1_CTRL_CHANGE || controller >= 128)
+    {
+      return std::nullopt;
+    }
+  return static_cast<size_t> (status & 0x0f) * 128 + controller;
+}
+
+void
+MidiMappings::rebuild_dispatch_table ()
+{
+  /* count the mappings of each key, then turn the counts into offsets */
+  std::array<uint32_t, NUM_CC_KEYS + 1> counts{};
+  other_mappings_.clear ();
+  for (const auto &mapping : mappings_)
+    {
+      if (const auto key = get_cc_key (mapping->key_[0], mapping->key_[1]))
+        {
+          counts[*key + 1]++;
+        }
+      else
+        {
+          other_mappings_.push_back (mapping.get ());
+        }
+    }
+  for (size_t key = 0; key < NUM_CC_KEYS; key++)
+    {
+      counts[key + 1] += counts[key];
+    }
+  cc_offsets_ = counts;
+
+  /* place the mappings, keeping their order within each key */
+  cc_mappings_.resize (cc_offsets_.back ());
+  for (const auto &mapping : mappings_)
+    {
+      if (const auto key = get_cc_key (mapping->key_[0], mapping->key_[1]))
+        {
+          cc_mappings_[counts[*key]++] = mapping.get ();
+        }
+    }
+}
+
 int
 MidiMappings::get_mapping_index (const MidiMapping &mapping) const
 {
@@ -166,10 +213,8 @@ MidiMappings::apply_from_cc_events (MidiEventVector &events)
     {
       if (midi_is_controller (ev.raw_buffer_.data ()))
         {
-          auto channel = midi_get_channel_1_to_16 (ev.raw_buffer_.data ());
-          auto controller = midi_get_controller_number (ev.raw_buffer_.data ());
-          auto &mapping = mappings_[(channel - 1) * 128 + controller];
-          mapping->apply (ev.raw_buffer_);
+          /* only the controllers that have a port are mapped */
+          apply (ev.raw_buffer_.data ());
         }
     }
 }
@@ -177,13 +222,27 @@ MidiMappings::apply_from_cc_events (MidiEventVector &events)
 void
 MidiMappings::apply (const midi_byte_t * buf)
 {
-  for (auto &mapping : mappings_)
+  const std::array<midi_byte_t, 3> arr = { buf[0], buf[1], buf[2] };
+  if (const auto key = get_cc_key (buf[0], buf[1]))
+    {
+      for (
+        auto i = cc_offsets_[*key], end = cc_offsets_[*key + 1]; i < end; i++)
+        {
+          auto * mapping = cc_mappings_[i];
+          if (mapping->enabled_.load ())
+            {
+              mapping->apply (arr);
+            }
+        }
+      return;
+    }
+
+  for (auto * mapping : other_mappings_)
     {
       if (
         mapping->enabled_.load () && mapping->key_[0] == buf[0]
         && mapping->key_[1] == buf[1])
         {
-          std::array<midi_byte_t, 3> arr = { buf[0], buf[1], buf[2] };
           mapping->apply (arr);
         }
     }
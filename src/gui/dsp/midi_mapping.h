@@ -146,12 +146,47 @@ public:
     override
   {
     clone_unique_ptr_container (mappings_, other.mappings_);
+    rebuild_dispatch_table ();
   }
 
+  /**
+   * @brief Rebuilds the lookup table used by apply() to find the mappings of
+   * a message.
+   *
+   * bind_at() and unbind() call this, so this only needs to be called after
+   * changing @ref mappings_ directly.
+   */
+  void rebuild_dispatch_table ();
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
+private:
+  /** Number of (channel, controller) combinations of CC messages. */
+  static constexpr size_t NUM_CC_KEYS = 16 * 128;
+
+  /**
+   * @brief Returns the index of a CC message in @ref cc_offsets_, or nullopt
+   * if the message is not a CC message.
+   */
+  static std::optional<size_t>
+  get_cc_key (midi_byte_t status, midi_byte_t controller);
+
 public:
   std::vector<std::unique_ptr<MidiMapping>> mappings_;
+
+private:
+  /**
+   * Where the mappings of each CC key start in @ref cc_mappings_.
+   *
+   * The mappings for key `k` are in `[cc_offsets_[k], cc_offsets_[k + 1])`.
+   */
+  std::array<uint32_t, NUM_CC_KEYS + 1> cc_offsets_{};
+
+  /** Mappings of CC messages, grouped by key, in the order of @ref mappings_. */
+  std::vector<MidiMapping *> cc_mappings_;
+
+  /** Mappings of other messages, which are matched one by one. */
+  std::vector<MidiMapping *> other_mappings_;
 };
 
 /**
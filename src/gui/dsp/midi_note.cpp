@@ -14,8 +14,6 @@
 MidiNote::MidiNote (QObject * parent)
     : ArrangerObject (Type::MidiNote), QObject (parent), BoundedObject ()
 {
-  ArrangerObject::parent_base_qproperties (*this);
-  BoundedObject::parent_base_qproperties (*this);
 }
 
 MidiNote::MidiNote (
@@ -29,10 +27,8 @@ MidiNote::MidiNote (
       RegionOwnedObjectImpl (region_id), BoundedObject (),
       vel_ (new Velocity (this, vel)), pitch_ (val)
 {
-  ArrangerObject::parent_base_qproperties (*this);
-  BoundedObject::parent_base_qproperties (*this);
-  *static_cast<Position *> (pos_) = start_pos;
-  *static_cast<Position *> (end_pos_) = end_pos;
+  *pos_ = start_pos;
+  *end_pos_ = end_pos;
 }
 
 void
@@ -89,8 +85,7 @@ MidiNote::listen (bool listen)
       using TrackT = base_type<decltype (track)>;
       if constexpr (std::derived_from<TrackT, PianoRollTrack>)
         {
-          auto &events =
-            track->processor_->get_midi_in_port ().midi_events_.queued_events_;
+          MidiEventVector events;
 
           if (listen)
             {
@@ -126,6 +121,9 @@ MidiNote::listen (bool listen)
               currently_listened_ = false;
               last_listened_pitch_ = 255;
             }
+
+          track->processor_->get_midi_in_port ()
+            .midi_events_.queue_from_non_rt (events);
         }
     },
     track_var);
@@ -177,25 +175,28 @@ MidiNote::set_val (const uint8_t val)
           using TrackT = base_type<decltype (track)>;
           if constexpr (std::derived_from<TrackT, PianoRollTrack>)
             {
-              auto &midi_events =
-                track->processor_->get_piano_roll_port ()
-                  .midi_events_.queued_events_;
-
-              uint8_t midi_ch = region->get_midi_ch ();
+              MidiEventVector midi_events;
+              uint8_t         midi_ch = region->get_midi_ch ();
               midi_events.add_note_off (midi_ch, pitch_, 0);
+              track->processor_->get_piano_roll_port ()
+                .midi_events_.queue_from_non_rt (midi_events);
             }
         },
         track_var);
     }
 
-  pitch_ = val;
+  if (pitch_ != val)
+    {
+      pitch_ = val;
+      invalidate_placements ();
+      Q_EMIT pitchChanged (pitch_);
+    }
 }
 
 void
 MidiNote::shift_pitch (const int delta)
 {
-  pitch_ = (uint8_t) ((int) pitch_ + delta);
-  set_val (pitch_);
+  set_val ((uint8_t) ((int) pitch_ + delta));
 }
 
 void
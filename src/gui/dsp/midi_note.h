@@ -39,6 +39,7 @@ class MidiNote final
   Q_OBJECT
   QML_ELEMENT
   DEFINE_ARRANGER_OBJECT_QML_PROPERTIES (MidiNote)
+  Q_PROPERTY (int pitch READ getPitch NOTIFY pitchChanged)
 
 public:
   MidiNote (QObject * parent = nullptr);
@@ -56,6 +57,16 @@ public:
   Q_DISABLE_COPY_MOVE (MidiNote)
   ~MidiNote () override = default;
 
+  // ========================================================================
+  // QML Interface
+  // ========================================================================
+
+  int getPitch () const { return pitch_; }
+
+  Q_SIGNAL void pitchChanged (int pitch);
+
+  // ========================================================================
+
   void init_loaded () override;
 
   void set_cache_val (const uint8_t val) { cache_pitch_ = val; }
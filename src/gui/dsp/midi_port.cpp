@@ -34,8 +34,28 @@ MidiPort::allocate_bufs ()
   midi_ring_ = std::make_unique<RingBuffer<MidiEvent>> (11);
 }
 
+size_t
+MidiPort::get_memory_usage () const
+{
+  size_t ret = Port::get_memory_usage () + MidiEvents::get_memory_usage ();
+  if (midi_ring_)
+    {
+      ret += midi_ring_->capacity () * sizeof (MidiEvent);
+    }
+  return ret;
+}
+
 void
 MidiPort::clear_buffer (AudioEngine &engine)
+{
+  if (is_rendered_ahead ())
+    return;
+
+  clear_rendered_ahead_buffers ();
+}
+
+void
+MidiPort::clear_rendered_ahead_buffers ()
 {
   midi_events_.active_events_.clear ();
   // midi_events_.queued_events_.clear ();
@@ -256,7 +276,7 @@ MidiPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
 
   if (time_nfo.local_offset_ + time_nfo.nframes_ == AUDIO_ENGINE->block_length_)
     {
-      if (write_ring_buffers_)
+      if (has_ring_buffer_subscribers ())
         {
           for (auto &ev : events | std::views::reverse)
             {
@@ -265,7 +285,7 @@ MidiPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
                   midi_ring_->skip (1);
                 }
 
-              ev.systime_ = Zrythm::getInstance ()->get_monotonic_time_usecs ();
+              ev.systime_ = time_nfo.cycle_start_time_usecs_;
               midi_ring_->write (ev);
               // z_warning ("writing to ring for {}", get_label ());
             }
@@ -274,8 +294,7 @@ MidiPort::process (const EngineProcessTimeInfo time_nfo, const bool noroll)
         {
           if (events.has_any ())
             {
-              last_midi_event_time_ =
-                Zrythm::getInstance ()->get_monotonic_time_usecs ();
+              last_midi_event_time_ = time_nfo.cycle_start_time_usecs_;
               // z_warning (
               //   "wrote last event time {} for '{}'", last_midi_event_time_,
               //   get_label ());
@@ -37,6 +37,10 @@ public:
 
   void clear_buffer (AudioEngine &engine) override;
 
+  void clear_rendered_ahead_buffers () override;
+
+  size_t get_memory_usage () const override;
+
   void init_after_cloning (const MidiPort &original, ObjectCloneType clone_type)
     override;
 
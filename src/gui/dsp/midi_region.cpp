@@ -45,12 +45,52 @@
 #include "midilib/src/midifile.h"
 #include "midilib/src/midiutil.h"
 
+namespace
+{
+
+/**
+ * Returns the index of the first frame in @p frames (sorted) that is not
+ * before @p frame.
+ *
+ * Gallops forward from @p cursor if the result is not before it, otherwise
+ * binary-searches the frames before @p cursor.
+ */
+size_t
+find_first_note_from (
+  std::span<const signed_frame_t> frames,
+  signed_frame_t                  frame,
+  size_t                          cursor)
+{
+  const auto is_before = [&] (signed_frame_t f) { return f < frame; };
+
+  cursor = std::min (cursor, frames.size ());
+  size_t lo = 0;
+  size_t hi = cursor;
+  if (cursor == 0 || is_before (frames[cursor - 1]))
+    {
+      lo = cursor;
+      size_t step = 1;
+      while (hi < frames.size () && is_before (frames[hi]))
+        {
+          lo = hi + 1;
+          hi = std::min (hi + step, frames.size ());
+          step *= 2;
+        }
+    }
+
+  return static_cast<size_t> (
+    std::partition_point (
+      frames.begin () + static_cast<ptrdiff_t> (lo),
+      frames.begin () + static_cast<ptrdiff_t> (hi), is_before)
+    - frames.begin ());
+}
+
+}
+
 MidiRegion::MidiRegion (QObject * parent)
     : ArrangerObject (Type::Region), QAbstractListModel (parent)
 {
   id_.type_ = RegionType::Midi;
-  ArrangerObject::parent_base_qproperties (*this);
-  BoundedObject::parent_base_qproperties (*this);
   init_colored_object ();
   unended_notes_.reserve (12000);
 }
@@ -114,18 +154,36 @@ MidiRegion::MidiRegion (
   int                            idx_inside_lane,
   int                            midi_track_idx,
   QObject *                      parent)
-    : MidiRegion (parent)
+    : MidiRegion (
+        start_pos,
+        [&] {
+          z_debug ("reading from {}...", abs_path);
+          return MidiFile (abs_path).read_track (
+            TRANSPORT->get_ppqn (), midi_track_idx);
+        }(),
+        track_uuid,
+        lane_pos,
+        idx_inside_lane,
+        parent)
 {
-  z_debug ("reading from {}...", abs_path);
+}
 
+MidiRegion::MidiRegion (
+  const Position                &start_pos,
+  const MidiFileTrackContents   &contents,
+  dsp::PortIdentifier::TrackUuid track_uuid,
+  int                            lane_pos,
+  int                            idx_inside_lane,
+  QObject *                      parent)
+    : MidiRegion (parent)
+{
   Position end_pos = start_pos;
   end_pos.add_ticks (1, AUDIO_ENGINE->frames_per_tick_);
   init (
     start_pos, end_pos, track_uuid, lane_pos, idx_inside_lane,
     AUDIO_ENGINE->ticks_per_frame_);
 
-  MidiFile mf (abs_path);
-  mf.into_region (*this, *TRANSPORT, midi_track_idx);
+  MidiFile::into_region (contents, *this, *TRANSPORT);
 
   if (*pos_ >= end_pos_)
     {
@@ -453,7 +511,7 @@ MidiRegion::add_events (
 
       do
         {
-          Position mn_pos = *static_cast<Position *> (mn->pos_);
+          Position mn_pos = *mn->pos_;
           Position mn_end_pos = *mn->end_pos_;
 
           if (full)
@@ -543,3 +601,63 @@ MidiRegion::validate (bool is_project, double frames_per_tick) const
     }
   return true;
 }
+
+void
+MidiRegion::build_note_index ()
+{
+  std::vector<const MidiNote *> notes;
+  notes.reserve (midi_notes_.size ());
+  for (const auto * mn : midi_notes_)
+    {
+      if (!mn->get_muted (false))
+        notes.push_back (mn);
+    }
+
+  auto fill_index = [&] (NoteIndex &index, auto get_frames) {
+    std::ranges::stable_sort (notes, {}, get_frames);
+    index.frames_.clear ();
+    index.pitches_.clear ();
+    index.velocities_.clear ();
+    index.frames_.reserve (notes.size ());
+    index.pitches_.reserve (notes.size ());
+    index.velocities_.reserve (notes.size ());
+    for (const auto * mn : notes)
+      {
+        index.frames_.push_back (get_frames (mn));
+        index.pitches_.push_back (mn->pitch_);
+        index.velocities_.push_back (mn->vel_->vel_);
+      }
+    index.cursor_ = 0;
+  };
+  fill_index (notes_by_start_, [] (const MidiNote * mn) {
+    return mn->pos_->frames_;
+  });
+  fill_index (notes_by_end_, [] (const MidiNote * mn) {
+    return mn->end_pos_->frames_;
+  });
+
+  num_indexed_notes_ = midi_notes_.size ();
+  note_index_built_ = true;
+}
+
+MidiRegion::NoteRange
+MidiRegion::get_notes_starting_in (signed_frame_t start, signed_frame_t end) const
+{
+  const std::span<const signed_frame_t> frames = notes_by_start_.frames_;
+  const auto first =
+    find_first_note_from (frames, start, notes_by_start_.cursor_);
+  const auto last = find_first_note_from (frames, end, first);
+  notes_by_start_.cursor_ = last;
+  return notes_by_start_.get_range (first, last);
+}
+
+MidiRegion::NoteRange
+MidiRegion::get_notes_ending_in (signed_frame_t start, signed_frame_t end) const
+{
+  const std::span<const signed_frame_t> frames = notes_by_end_.frames_;
+  const auto first =
+    find_first_note_from (frames, start, notes_by_end_.cursor_);
+  const auto last = find_first_note_from (frames, end + 1, first);
+  notes_by_end_.cursor_ = last;
+  return notes_by_end_.get_range (first, last);
+}
@@ -4,6 +4,8 @@
 #ifndef __AUDIO_MIDI_REGION_H__
 #define __AUDIO_MIDI_REGION_H__
 
+#include <span>
+
 #include "gui/dsp/lane_owned_object.h"
 #include "gui/dsp/midi_note.h"
 #include "gui/dsp/region.h"
@@ -18,6 +20,7 @@ namespace zrythm::dsp
 class ChordDescriptor;
 }
 class Velocity;
+struct MidiFileTrackContents;
 using MIDI_FILE = void;
 
 /**
@@ -88,6 +91,20 @@ public:
     int                            midi_track_idx,
     QObject *                      parent = nullptr);
 
+  /**
+   * Creates a MIDI region from a track read from a MIDI file (see
+   * MidiFile::read_tracks()), starting at the given Position.
+   *
+   * @throw ZrythmException if the track has no events.
+   */
+  MidiRegion (
+    const Position                &start_pos,
+    const MidiFileTrackContents   &contents,
+    dsp::PortIdentifier::TrackUuid track_uuid,
+    int                            lane_pos,
+    int                            idx_inside_lane,
+    QObject *                      parent = nullptr);
+
   /**
    * Create a region from the chord descriptor.
    *
@@ -296,8 +313,99 @@ public:
    */
   bool is_note_export_start_pos_in_full_region (Position start_pos) const;
 
+  /**
+   * @brief Indexes the notes by their start and end positions so that
+   * get_notes_starting_in() and get_notes_ending_in() don't need to go
+   * through all the notes.
+   *
+   * The index stores what playback needs from each (unmuted) note in
+   * contiguous arrays, so that playback doesn't need to access the notes
+   * themselves.
+   *
+   * This is called on playback snapshots, which are regenerated after each
+   * change.
+   */
+  void build_note_index ();
+
+  /**
+   * @brief Returns whether the note index is usable (built after the last
+   * change to the notes).
+   */
+  bool has_note_index () const
+  {
+    return note_index_built_ && num_indexed_notes_ == midi_notes_.size ();
+  }
+
+  /**
+   * @brief Notes returned by get_notes_starting_in() and
+   * get_notes_ending_in(), as parallel arrays.
+   */
+  struct NoteRange
+  {
+    size_t size () const { return frames_.size (); }
+
+    /** Region-local start or end positions. */
+    std::span<const signed_frame_t> frames_;
+    std::span<const uint8_t>        pitches_;
+    std::span<const uint8_t>        velocities_;
+  };
+
+  /**
+   * @brief Returns the unmuted notes starting in [@p start, @p end) (in
+   * region-local frames), sorted by their start position.
+   *
+   * Consecutive calls with advancing ranges (as during playback) only search
+   * forward from the previous range, and ranges before it (e.g., after
+   * looping) are binary-searched.
+   *
+   * @pre has_note_index().
+   * @note Realtime-safe, but not thread-safe.
+   */
+  NoteRange
+  get_notes_starting_in (signed_frame_t start, signed_frame_t end) const;
+
+  /**
+   * @brief Returns the unmuted notes ending in [@p start, @p end] (in
+   * region-local frames), sorted by their end position.
+   *
+   * @see get_notes_starting_in().
+   */
+  NoteRange
+  get_notes_ending_in (signed_frame_t start, signed_frame_t end) const;
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
+private:
+  /**
+   * Notes sorted by a position, as parallel arrays, along with a playback
+   * cursor.
+   */
+  struct NoteIndex
+  {
+    NoteRange get_range (size_t first, size_t last) const
+    {
+      return {
+        .frames_ = std::span (frames_).subspan (first, last - first),
+        .pitches_ = std::span (pitches_).subspan (first, last - first),
+        .velocities_ = std::span (velocities_).subspan (first, last - first),
+      };
+    }
+
+    std::vector<signed_frame_t> frames_;
+    std::vector<uint8_t>        pitches_;
+    std::vector<uint8_t>        velocities_;
+
+    /** Index of the first note after the last returned range. */
+    mutable size_t cursor_ = 0;
+  };
+
+  NoteIndex notes_by_start_;
+  NoteIndex notes_by_end_;
+
+  /** Number of notes (including muted ones) when the index was built. */
+  size_t num_indexed_notes_ = 0;
+  bool   note_index_built_ = false;
+
 public:
   /**
    * MIDI notes.
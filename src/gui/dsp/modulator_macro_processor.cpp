@@ -101,7 +101,22 @@ ModulatorMacroProcessor::process_block (const EngineProcessTimeInfo time_nfo)
     get_cv_out_port ().last_buf_sz_);
 
   /* if there are inputs, multiply by the knob value */
-  if (!cv_in.srcs_.empty ())
+  const auto control_rate_interval = cv_out.get_control_rate_interval ();
+  if (!cv_in.srcs_.empty () && control_rate_interval > 0)
+    {
+      /* the input holds each value for the whole interval */
+      const float     macro_val = macro.get_val ();
+      const nframes_t end = time_nfo.local_offset_ + time_nfo.nframes_;
+      for (
+        nframes_t frame = time_nfo.local_offset_; frame < end;
+        frame += control_rate_interval)
+        {
+          utils::float_ranges::fill (
+            &cv_out.buf_[frame], cv_in.buf_[frame] * macro_val,
+            std::min (control_rate_interval, end - frame));
+        }
+    }
+  else if (!cv_in.srcs_.empty ())
     {
       utils::float_ranges::copy (
         &cv_out.buf_[time_nfo.local_offset_],
@@ -121,6 +136,13 @@ ModulatorMacroProcessor::process_block (const EngineProcessTimeInfo time_nfo)
     }
 }
 
+void
+ModulatorMacroProcessor::update_processing_info ()
+{
+  get_cv_in_port ().set_control_rate_interval (
+    get_cv_out_port ().get_control_rate_interval ());
+}
+
 void
 ModulatorMacroProcessor::set_port_metadata_from_owner (
   dsp::PortIdentifier &id,
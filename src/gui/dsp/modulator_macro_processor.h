@@ -59,8 +59,20 @@ public:
     return fmt::format ("{} Modulator Macro Processor", name_);
   }
 
+  /**
+   * @brief Applies the macro to the CV input, at control rate if the CV output
+   * is processed at control rate (see CVPort::update_processing_info()).
+   */
   void process_block (EngineProcessTimeInfo time_nfo) override;
 
+  /**
+   * @brief Processes the CV input at the rate of the CV output, as the output
+   * is the only consumer of the input.
+   *
+   * To be called when building the graph, after the ports were updated.
+   */
+  void update_processing_info ();
+
   void init_after_cloning (
     const ModulatorMacroProcessor &other,
     ObjectCloneType                clone_type) override;
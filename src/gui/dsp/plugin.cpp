@@ -7,6 +7,7 @@
 #include "gui/backend/backend/actions/undo_manager.h"
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/settings/settings.h"
+#include "gui/backend/backend/settings_manager.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/backend/cached_plugin_descriptors.h"
 #include "gui/backend/channel.h"
@@ -24,6 +25,8 @@
 #include "gui/dsp/midi_port.h"
 #include "gui/dsp/modulator_track.h"
 #include "gui/dsp/plugin.h"
+#include "gui/dsp/plugin_loader.h"
+#include "gui/dsp/router.h"
 #include "gui/dsp/track.h"
 #include "gui/dsp/tracklist.h"
 #include "gui/dsp/transport.h"
@@ -33,11 +36,14 @@
 #include "utils/gtest_wrapper.h"
 #include "utils/io.h"
 #include "utils/math.h"
+#include "utils/midi.h"
 #include "utils/mem.h"
 #include "utils/objects.h"
 #include "utils/rt_thread_id.h"
 #include "utils/string.h"
 
+#include <chrono>
+
 #include <fmt/printf.h>
 
 using namespace zrythm;
@@ -234,6 +240,7 @@ Plugin::on_control_change_event (
       carla->set_param_value (static_cast<uint32_t> (carla_param_id_), val);
     }
 #endif
+  mark_state_dirty ();
   if (!state_changed_event_sent_.load (std::memory_order_acquire))
     {
       // EVENTS_PUSH (EventType::ET_PLUGIN_STATE_CHANGED, pl);
@@ -256,6 +263,13 @@ Plugin::should_bounce_to_master (utils::audio::BounceStep step) const
   return track->bounce_to_master_;
 }
 
+utils::audio::AudioBuffer *
+Plugin::get_bounce_tap () const
+{
+  auto * track = get_track ();
+  return track ? track->bounce_tap_ : nullptr;
+}
+
 bool
 Plugin::is_auditioner () const
 {
@@ -280,6 +294,14 @@ Plugin::init_loaded (AutomatableTrack * track)
   if (is_in_active_project ())
     {
       bool was_enabled = this->is_enabled (false);
+
+      /* instantiated in parallel with the other plugins of the project */
+      if (PROJECT->plugin_loader_ && !PROJECT->loaded_)
+        {
+          PROJECT->plugin_loader_->add (*this, was_enabled);
+          return;
+        }
+
       try
         {
           instantiate ();
@@ -428,6 +450,7 @@ Plugin::set_selected_preset_from_index (int idx)
 
   z_debug ("applying preset at index {}", idx);
   set_selected_preset_from_index_impl (idx);
+  mark_state_dirty ();
 }
 
 void
@@ -541,7 +564,10 @@ Plugin::remove_ats_from_automation_tracklist (bool free_ats, bool fire_events)
 bool
 Plugin::validate () const
 {
-  if (is_in_active_project ())
+  /* plugins may still be loading right after the project is loaded */
+  if (
+    is_in_active_project ()
+    && !(PROJECT->plugin_loader_ && PROJECT->plugin_loader_->is_loading ()))
     {
       /* assert instantiated and activated, or instantiation failed */
       z_return_val_if_fail (
@@ -837,8 +863,25 @@ Plugin::activate (bool activate)
       deactivating_ = true;
     }
 
+  if (activate && !ZRYTHM_TESTING && !ZRYTHM_BENCHMARKING)
+    {
+      const auto * settings = zrythm::gui::SettingsManager::get_instance ();
+      suspend_when_idle_ = settings->get_suspendIdlePlugins ();
+      idle_timeout_ms_ =
+        static_cast<unsigned int> (std::max (settings->get_pluginIdleTimeoutMs (), 0));
+    }
+
   activate_impl (activate);
+  if (activate)
+    {
+      reported_latency_ = get_single_playback_latency ();
+    }
 
+  held_notes_.reset ();
+  sustained_channels_.reset ();
+  silent_input_frames_ = 0;
+  outputs_silent_ = false;
+  suspended_.store (false);
   activated_ = activate;
   deactivating_ = false;
 }
@@ -1081,6 +1124,66 @@ Plugin::change_track (TrackUuid track_id)
 
 void
 Plugin::instantiate ()
+{
+  if (!prepare_instantiation ())
+    return;
+
+  instantiate_impl (!PROJECT->loaded_, !state_dir_.empty ());
+  finish_instantiation ();
+}
+
+bool
+Plugin::requires_main_thread_instantiation () const
+{
+  if (setting_->bridge_mode_ == CarlaBridgeMode::Full)
+    return false;
+
+  switch (get_protocol ())
+    {
+    case Protocol::ProtocolType::VST3:
+    case Protocol::ProtocolType::AudioUnit:
+    case Protocol::ProtocolType::CLAP:
+      return true;
+    default:
+      return false;
+    }
+}
+
+bool
+Plugin::state_needs_saving () const
+{
+  return state_dirty_.load (std::memory_order_acquire) || visible_
+         || last_saved_abs_state_dir_ != get_abs_state_dir (false);
+}
+
+void
+Plugin::save_state_if_changed ()
+{
+  if (!instantiated_)
+    return;
+
+  if (!state_needs_saving ())
+    {
+      z_debug ("state of plugin '{}' unchanged, not saving", get_name ());
+      return;
+    }
+
+  /* clear before saving so that changes made while saving are not lost */
+  state_dirty_.store (false, std::memory_order_release);
+  try
+    {
+      save_state (false, nullptr);
+    }
+  catch (const ZrythmException &e)
+    {
+      mark_state_dirty ();
+      throw;
+    }
+  last_saved_abs_state_dir_ = get_abs_state_dir (false);
+}
+
+bool
+Plugin::prepare_instantiation ()
 {
   z_debug ("Instantiating plugin '{}'...", get_name ());
 
@@ -1090,12 +1193,26 @@ Plugin::instantiate ()
 
   if (!PROJECT->loaded_)
     {
-      z_return_if_fail (!state_dir_.empty ());
+      z_return_val_if_fail (!state_dir_.empty (), false);
     }
   z_debug ("state dir: {}", state_dir_);
+  return true;
+}
 
-  instantiate_impl (!PROJECT->loaded_, !state_dir_.empty ());
-  save_state (false, nullptr);
+void
+Plugin::finish_instantiation ()
+{
+  /* the state dir already contains the state the plugin was loaded from */
+  if (
+    !PROJECT->loaded_ && !PROJECT->loading_from_backup_ && !state_dir_.empty ())
+    {
+      state_dirty_.store (false, std::memory_order_release);
+      last_saved_abs_state_dir_ = get_abs_state_dir (false);
+    }
+  else
+    {
+      save_state_if_changed ();
+    }
 
   z_return_if_fail (enabled_);
   enabled_->set_val_from_normalized (1.f, 0);
@@ -1132,12 +1249,113 @@ Plugin::prepare_process ()
     }
 }
 
+nframes_t
+Plugin::get_tail_length () const
+{
+  return static_cast<nframes_t> (
+    static_cast<uint64_t> (idle_timeout_ms_) * AUDIO_ENGINE->sample_rate_
+    / 1000);
+}
+
+void
+Plugin::update_held_notes ()
+{
+  for (const auto &port : midi_in_ports_)
+    {
+      for (const auto &ev : port->midi_events_.active_events_)
+        {
+          const auto * buf = ev.raw_buffer_.data ();
+          const auto   channel = midi_get_channel_0_to_15 (buf);
+          if (midi_is_note_on (buf))
+            {
+              held_notes_.set (channel * 128 + midi_get_note_number (buf));
+            }
+          else if (midi_is_note_off (buf))
+            {
+              held_notes_.reset (channel * 128 + midi_get_note_number (buf));
+            }
+          else if (midi_is_all_notes_off (buf) || midi_is_all_sound_off (buf))
+            {
+              for (size_t i = 0; i < 128; ++i)
+                {
+                  held_notes_.reset (channel * 128 + i);
+                }
+              sustained_channels_.reset (channel);
+            }
+          else if (
+            midi_is_controller (buf) && midi_get_controller_number (buf) == 64)
+            {
+              sustained_channels_.set (
+                channel, midi_get_controller_value (buf) >= 64);
+            }
+        }
+    }
+}
+
+bool
+Plugin::inputs_are_silent () const
+{
+  const auto &descr = get_descriptor ();
+  if (
+    !cv_in_ports_.empty () || descr.num_midi_outs_ > 0 || descr.num_cv_outs_ > 0)
+    {
+      return false;
+    }
+
+  if (descr.is_instrument ())
+    {
+      if (held_notes_.any () || sustained_channels_.any ())
+        return false;
+    }
+  /* effects without inputs generate sound on their own */
+  else if (audio_in_ports_.empty ())
+    {
+      return false;
+    }
+
+  return std::ranges::all_of (
+           audio_in_ports_,
+           [] (const auto &port) { return port->is_silent (); })
+         && std::ranges::all_of (midi_in_ports_, [] (const auto &port) {
+              return port->midi_events_.active_events_.empty ();
+            });
+}
+
+nframes_t
+Plugin::get_sub_block_length (const EngineProcessTimeInfo &time_nfo) const
+{
+  nframes_t sub_block_length = std::max (get_max_block_length (), 1u);
+  if (
+    time_nfo.nframes_ > AUTOMATION_SUB_BLOCK_LENGTH
+    && std::ranges::any_of (ctrl_in_ports_, [&time_nfo] (const auto &port) {
+         return port->get_automation_values (time_nfo).has_value ();
+       }))
+    {
+      sub_block_length =
+        std::min (sub_block_length, AUTOMATION_SUB_BLOCK_LENGTH);
+    }
+  return sub_block_length;
+}
+
+void
+Plugin::apply_automation_values (const EngineProcessTimeInfo &time_nfo)
+{
+  for (auto &port : ctrl_in_ports_)
+    {
+      if (const auto values = port->get_automation_values (time_nfo))
+        {
+          port->set_control_value (values->front (), false, false);
+        }
+    }
+}
+
 void
 Plugin::process_block (const EngineProcessTimeInfo time_nfo)
 {
   if (!is_enabled (true) && !own_enabled_port_)
     {
       process_passthrough (time_nfo);
+      processing_load_.record (0, time_nfo.nframes_, AUDIO_ENGINE->sample_rate_);
       return;
     }
 
@@ -1146,6 +1364,12 @@ Plugin::process_block (const EngineProcessTimeInfo time_nfo)
       return;
     }
 
+  /* the frozen clip is played instead (see ChannelTrack::freeze()) */
+  if (track_ && track_->frozen_) [[unlikely]]
+    {
+      return;
+    }
+
   /* if has MIDI input port */
   if (get_descriptor ().num_midi_ins_ > 0)
     {
@@ -1155,7 +1379,78 @@ Plugin::process_block (const EngineProcessTimeInfo time_nfo)
       /* add midi events to input port */
     }
 
-  process_impl (time_nfo);
+  update_held_notes ();
+
+  /* once the inputs have been silent for longer than the tail and the output
+   * has died down there is nothing to process (the output buffers were
+   * already cleared in prepare_process()) */
+  const bool inputs_silent = inputs_are_silent ();
+  if (inputs_silent)
+    {
+      if (
+        suspend_when_idle_ && outputs_silent_
+        && silent_input_frames_
+             >= std::max (get_tail_length (), get_single_playback_latency ()))
+        {
+          suspended_.store (true, std::memory_order_relaxed);
+          processing_load_.record (
+            0, time_nfo.nframes_, AUDIO_ENGINE->sample_rate_);
+          return;
+        }
+      silent_input_frames_ += time_nfo.nframes_;
+    }
+  else
+    {
+      silent_input_frames_ = 0;
+      outputs_silent_ = false;
+    }
+
+  /* the plugin's state had died down before it was suspended, so it can
+   * resume from this cycle as if it was never suspended (parameter changes
+   * queued in the meantime are sent before processing) */
+  suspended_.store (false, std::memory_order_relaxed);
+
+  const auto process_start = std::chrono::steady_clock::now ();
+  const auto sub_block_length = get_sub_block_length (time_nfo);
+  if (time_nfo.nframes_ <= sub_block_length) [[likely]]
+    {
+      process_impl (time_nfo);
+    }
+  else
+    {
+      /* MIDI events are passed to the sub-block they fall in, so they stay
+       * sample-accurate */
+      for (nframes_t offset = 0; offset < time_nfo.nframes_;
+           offset += sub_block_length)
+        {
+          EngineProcessTimeInfo sub_time_nfo = time_nfo;
+          sub_time_nfo.g_start_frame_w_offset_ += offset;
+          sub_time_nfo.local_offset_ += offset;
+          sub_time_nfo.nframes_ =
+            std::min (sub_block_length, time_nfo.nframes_ - offset);
+          if (offset > 0)
+            {
+              apply_automation_values (sub_time_nfo);
+            }
+          process_impl (sub_time_nfo);
+        }
+    }
+  processing_load_.record (
+    static_cast<uint64_t> (
+      std::chrono::duration_cast<std::chrono::nanoseconds> (
+        std::chrono::steady_clock::now () - process_start)
+        .count ()),
+    time_nfo.nframes_, AUDIO_ENGINE->sample_rate_);
+
+  /* pick up latency changes (e.g., when the plugin switches its lookahead
+   * mode) without rebuilding the graph */
+  if (
+    const auto latency = get_single_playback_latency ();
+    latency != reported_latency_) [[unlikely]]
+    {
+      reported_latency_ = latency;
+      ROUTER->queue_latency_update ();
+    }
 
   /* if plugin has gain, apply it */
   if (!utils::math::floats_near (gain_->control_, 1.f, 0.001f))
@@ -1179,6 +1474,17 @@ Plugin::process_block (const EngineProcessTimeInfo time_nfo)
             }
         }
     }
+
+  if (inputs_silent)
+    {
+      outputs_silent_ = std::ranges::all_of (
+        get_output_port_span ().get_elements_by_type<AudioPort> (),
+        [&] (const auto &port) {
+          return utils::float_ranges::is_silent (
+            &port->buf_[time_nfo.local_offset_], time_nfo.nframes_,
+            AudioPort::SILENCE_THRESHOLD);
+        });
+    }
 }
 
 std::string
@@ -1374,8 +1680,8 @@ Plugin::copy_members_from (Plugin &other)
   z_debug ("[1/5] saving state of source plugin (if instantiated)");
   if (other.instantiated_)
     {
-      other.save_state (false, nullptr);
-      z_debug ("saved source plugin state to {}", other.state_dir_);
+      other.save_state_if_changed ();
+      z_debug ("source plugin state is in {}", other.state_dir_);
     }
 
   /* create a new plugin with same descriptor */
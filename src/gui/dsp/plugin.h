@@ -6,11 +6,15 @@
 
 #include "zrythm-config.h"
 
+#include <atomic>
+#include <bitset>
+#include <limits>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "dsp/plugin_identifier.h"
+#include "dsp/processing_load.h"
 #include "gui/backend/backend/settings/plugin_settings.h"
 #include "gui/dsp/plugin_descriptor.h"
 #include "gui/dsp/port.h"
@@ -185,6 +189,8 @@ public:
    * @brief Initializes a plugin after deserialization.
    *
    * This may attempt to instantiate the plugin, which can throw an exception.
+   * While a project is being loaded, the plugin is instead handed to the
+   * project's PluginLoader.
    *
    * @param track
    * @param ms
@@ -208,6 +214,8 @@ public:
 
   bool should_bounce_to_master (utils::audio::BounceStep step) const override;
 
+  utils::audio::AudioBuffer * get_bounce_tap () const override;
+
   /** Whether the plugin is used for MIDI auditioning in SampleProcessor. */
   bool is_auditioner () const;
 
@@ -420,6 +428,45 @@ public:
    */
   void instantiate ();
 
+  /**
+   * @brief Returns whether the plugin must be instantiated on the main thread.
+   *
+   * VST3, AU and CLAP require creating plugin instances on the main thread.
+   * Other plugins, and plugins bridged in a separate process, can be
+   * instantiated on worker threads (see PluginLoader).
+   */
+  virtual bool requires_main_thread_instantiation () const;
+
+  /**
+   * @brief Marks the state as changed since it was last saved.
+   *
+   * Realtime-safe.
+   */
+  void mark_state_dirty ()
+  {
+    state_dirty_.store (true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Returns whether the state saved in the plugin's state directory
+   * may be out of date.
+   *
+   * Plugins with a visible custom UI are always considered changed, since
+   * their UI can change state that is not reported to the host.
+   */
+  bool state_needs_saving () const;
+
+  /**
+   * @brief Saves the state inside the plugin's state directory, unless it is
+   * known to be up to date.
+   *
+   * Can be called from a worker thread (with the engine paused) if
+   * requires_main_thread_instantiation() is false.
+   *
+   * @throw ZrythmException If the state could not be saved.
+   */
+  void save_state_if_changed ();
+
   /**
    * Sets the track name hash on the plugin.
    */
@@ -430,6 +477,12 @@ public:
    */
   [[gnu::hot]] void process_block (EngineProcessTimeInfo time_nfo) override;
 
+  /**
+   * Plugins are only fed through their ports, so whether they can be rendered
+   * ahead depends on what they are connected to.
+   */
+  bool can_render_ahead () const override { return true; }
+
   std::string get_node_name () const override;
 
   std::string generate_window_title () const;
@@ -471,6 +524,48 @@ public:
    */
   [[gnu::hot]] void process_passthrough (EngineProcessTimeInfo time_nfo);
 
+  /**
+   * @brief Returns for how long the plugin may keep producing sound after its
+   * inputs go silent, in frames.
+   *
+   * Processing is suspended once the inputs have been silent for at least this
+   * long (or the latency, if longer) and the outputs have died down, so that
+   * reverbs and delays can ring out. It resumes as soon as the inputs receive
+   * audio or MIDI again.
+   *
+   * Carla doesn't expose the tail length of the plugins it hosts, so this
+   * returns the idle timeout from the settings by default.
+   */
+  virtual nframes_t get_tail_length () const;
+
+  /**
+   * @brief Returns the largest number of frames the plugin can process at
+   * once.
+   *
+   * Blocks larger than this (e.g., when rendering offline with a large block
+   * length) are processed in several sub-blocks.
+   */
+  virtual nframes_t get_max_block_length () const
+  {
+    return std::numeric_limits<nframes_t>::max ();
+  }
+
+  /**
+   * @brief Returns whether processing is currently suspended because the
+   * plugin is idle.
+   *
+   * Can be called from any thread.
+   */
+  bool is_suspended () const { return suspended_.load (); }
+
+  /**
+   * @brief Returns the rolling share of the real-time budget spent processing
+   * this plugin (1 = 100%).
+   *
+   * Can be called from any thread.
+   */
+  float get_dsp_load () const { return processing_load_.get_load (); }
+
   /**
    * Process hide ui
    */
@@ -574,6 +669,20 @@ protected:
   Plugin () = default;
 
 private:
+  friend class PluginLoader;
+
+  /**
+   * @brief The part of instantiate() before instantiate_impl() (main thread).
+   *
+   * @return Whether instantiate_impl() can be called.
+   */
+  bool prepare_instantiation ();
+
+  /**
+   * @brief The part of instantiate() after instantiate_impl() (main thread).
+   */
+  void finish_instantiation ();
+
   void set_stereo_outs_and_midi_in ();
   void set_enabled_and_gain ();
   void init (TrackUuid track_id, PluginSlot slot);
@@ -656,6 +765,36 @@ protected:
 
   DECLARE_DEFINE_BASE_FIELDS_METHOD ();
 
+private:
+  /**
+   * @brief Updates the held notes and sustain pedals from the MIDI events of
+   * this cycle.
+   */
+  [[gnu::hot]] void update_held_notes ();
+
+  /**
+   * @brief Returns whether all the inputs are known to be silent in this
+   * cycle.
+   *
+   * Always false for instruments with held (or sustained) notes, for effects
+   * without inputs and for plugins with inputs or outputs other than audio
+   * and MIDI in.
+   */
+  [[gnu::hot]] bool inputs_are_silent () const;
+
+  /**
+   * @brief Returns the length of the sub-blocks to process this cycle in.
+   */
+  [[gnu::hot]] nframes_t
+  get_sub_block_length (const EngineProcessTimeInfo &time_nfo) const;
+
+  /**
+   * @brief Sends the automation values at the start of the given sub-block
+   * to the plugin.
+   */
+  [[gnu::hot]] void
+  apply_automation_values (const EngineProcessTimeInfo &time_nfo);
+
 public:
   PluginIdentifier id_;
 
@@ -727,6 +866,51 @@ public:
   /** Whether the plugin is currently activated or not. */
   bool activated_ = false;
 
+  /** Number of frames the inputs have been silent for. */
+  unsigned_frame_t silent_input_frames_ = 0;
+
+  /**
+   * Whether the audio outputs were silent the last time the plugin was
+   * processed with silent inputs.
+   */
+  bool outputs_silent_ = false;
+
+  /** Notes held on the MIDI inputs, indexed by channel * 128 + note. */
+  std::bitset<16 * 128> held_notes_;
+
+  /** MIDI channels whose sustain pedal is down. */
+  std::bitset<16> sustained_channels_;
+
+  /** Whether processing is suspended because the plugin is idle. */
+  std::atomic<bool> suspended_ = false;
+
+  /**
+   * Whether to suspend processing while idle (cached from the settings on
+   * activation).
+   */
+  bool suspend_when_idle_ = true;
+
+  /**
+   * Tail length to assume when the plugin doesn't report one, in milliseconds
+   * (cached from the settings on activation).
+   */
+  unsigned int idle_timeout_ms_ = 2000;
+
+  /**
+   * Latency last reported by the plugin, used to detect changes while
+   * processing.
+   */
+  nframes_t reported_latency_ = 0;
+
+  /**
+   * Plugins with automated parameters are processed in sub-blocks of at most
+   * this many frames, and the automation values are sent before each one.
+   */
+  static constexpr nframes_t AUTOMATION_SUB_BLOCK_LENGTH = 256;
+
+  /** Time spent in process_impl() (written by the processing thread). */
+  dsp::ProcessingLoad processing_load_;
+
   /** Update frequency of the UI, in Hz (times per second). */
   float ui_update_hz_ = 0.f;
 
@@ -782,6 +966,15 @@ public:
    */
   std::atomic<bool> state_changed_event_sent_ = false;
 
+  /**
+   * Whether the state may have changed since it was last saved to the state
+   * directory.
+   */
+  std::atomic<bool> state_dirty_ = true;
+
+  /** Absolute state directory the state was last saved to. */
+  std::string last_saved_abs_state_dir_;
+
   /** Whether the plugin is used for functions. */
   bool is_function_ = false;
 
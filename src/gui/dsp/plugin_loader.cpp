@@ -0,0 +1,238 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "gui/backend/backend/project.h"
+#include "gui/dsp/engine.h"
+#include "gui/dsp/plugin.h"
+#include "gui/dsp/plugin_loader.h"
+#include "gui/dsp/router.h"
+
+namespace zrythm::gui::old_dsp::plugins
+{
+
+PluginLoader::PluginLoader (ProgressInfo * progress_info)
+    : progress_info_ (progress_info),
+      notifier_ (std::make_unique<utils::MainThreadNotifier> ([this] () {
+        process_ready_entries ();
+      }))
+{
+}
+
+PluginLoader::~PluginLoader ()
+{
+  cancelled_.store (true);
+  for (auto &worker : workers_)
+    {
+      worker.wait ();
+    }
+  notifier_.reset ();
+}
+
+void
+PluginLoader::add (Plugin &plugin, bool was_enabled)
+{
+  z_return_if_fail (workers_.empty ());
+  entries_.push_back (
+    Entry{
+      .plugin_ = &plugin,
+      .was_enabled_ = was_enabled,
+      .requires_main_thread_ = plugin.requires_main_thread_instantiation () });
+}
+
+void
+PluginLoader::start ()
+{
+  z_return_if_fail (workers_.empty ());
+
+  for (size_t i = 0; i < entries_.size (); ++i)
+    {
+      auto &entry = entries_[i];
+      if (!entry.plugin_->prepare_instantiation ())
+        {
+          entry.error_ = "Plugin has no state";
+          std::lock_guard lock (ready_entries_mutex_);
+          ready_entries_.push_back (i);
+          continue;
+        }
+
+      if (entry.requires_main_thread_)
+        main_thread_entries_.push_back (i);
+      else
+        worker_entries_.push_back (i);
+    }
+
+  z_debug (
+    "loading {} plugins ({} on the main thread)", entries_.size (),
+    main_thread_entries_.size ());
+
+  const auto num_workers = std::min (
+    static_cast<size_t> (juce::SystemStats::getNumCpus ()),
+    worker_entries_.size ());
+  for (size_t i = 0; i < num_workers; ++i)
+    {
+      workers_.emplace_back (std::async (std::launch::async, [this] () {
+        process_worker_entries ();
+      }));
+    }
+
+  notifier_->notify ();
+}
+
+void
+PluginLoader::instantiate_entry (Entry &entry)
+{
+  auto &pl = *entry.plugin_;
+  try
+    {
+      pl.instantiate_impl (true, !pl.state_dir_.empty ());
+    }
+  catch (const ZrythmException &e)
+    {
+      entry.error_ = e.what ();
+    }
+}
+
+void
+PluginLoader::process_worker_entries ()
+{
+  while (!cancelled_.load ())
+    {
+      const auto idx = next_worker_entry_.fetch_add (1);
+      if (idx >= worker_entries_.size ())
+        break;
+
+      const auto entry_idx = worker_entries_[idx];
+      instantiate_entry (entries_[entry_idx]);
+
+      {
+        std::lock_guard lock (ready_entries_mutex_);
+        ready_entries_.push_back (entry_idx);
+      }
+      notifier_->notify ();
+    }
+}
+
+void
+PluginLoader::finish_entry (Entry &entry)
+{
+  auto &pl = *entry.plugin_;
+  if (!entry.error_.empty ())
+    {
+      /* disable plugin, instantiation failed */
+      pl.instantiation_failed_ = true;
+      z_warning (
+        "Instantiation failed for plugin '{}'. Disabling... ({})",
+        pl.get_name (), entry.error_);
+    }
+  else
+    {
+      pl.finish_instantiation ();
+      pl.activate (true);
+      pl.set_enabled (entry.was_enabled_, false);
+    }
+
+  ++num_finished_;
+  if (progress_info_)
+    {
+      progress_info_->update_progress (
+        static_cast<double> (num_finished_)
+          / static_cast<double> (entries_.size ()),
+        fmt::format (
+          "Loaded {}/{} plugins ({})", num_finished_, entries_.size (),
+          pl.get_name ()));
+    }
+}
+
+void
+PluginLoader::process_ready_entries ()
+{
+  if (!is_loading ())
+    return;
+
+  std::vector<size_t> ready_entries;
+  {
+    std::lock_guard lock (ready_entries_mutex_);
+    ready_entries.swap (ready_entries_);
+  }
+
+  const bool have_main_thread_entry =
+    next_main_thread_entry_ < main_thread_entries_.size ();
+  if (ready_entries.empty () && !have_main_thread_entry)
+    return;
+
+  /* the graph is already running if the project finished loading */
+  const bool         project_loaded = PROJECT->loaded_;
+  AudioEngine::State state{};
+  if (project_loaded)
+    {
+      AUDIO_ENGINE->wait_for_pause (state, true, false);
+    }
+
+  for (const auto idx : ready_entries)
+    {
+      finish_entry (entries_[idx]);
+    }
+
+  /* instantiate one plugin at a time so the event loop stays responsive */
+  if (have_main_thread_entry)
+    {
+      auto &entry = entries_[main_thread_entries_[next_main_thread_entry_++]];
+      instantiate_entry (entry);
+      finish_entry (entry);
+    }
+
+  if (project_loaded)
+    {
+      AUDIO_ENGINE->resume (state);
+    }
+
+  if (!is_loading ())
+    {
+      const bool has_error = std::ranges::any_of (entries_, [] (const auto &e) {
+        return !e.error_.empty ();
+      });
+      z_debug ("loaded {} plugins", entries_.size ());
+      if (progress_info_)
+        {
+          progress_info_->mark_completed (
+            has_error
+              ? ProgressInfo::CompletionType::HAS_ERROR
+              : ProgressInfo::CompletionType::SUCCESS,
+            {});
+        }
+
+      /* plugin latencies are known now */
+      if (project_loaded)
+        {
+          ROUTER->recalc_graph (false);
+        }
+    }
+  else if (next_main_thread_entry_ < main_thread_entries_.size ())
+    {
+      notifier_->notify ();
+    }
+}
+
+void
+PluginLoader::wait_until_loaded ()
+{
+  while (next_main_thread_entry_ < main_thread_entries_.size ())
+    {
+      const auto idx = main_thread_entries_[next_main_thread_entry_++];
+      instantiate_entry (entries_[idx]);
+      std::lock_guard lock (ready_entries_mutex_);
+      ready_entries_.push_back (idx);
+    }
+
+  for (auto &worker : workers_)
+    {
+      worker.wait ();
+    }
+
+  process_ready_entries ();
+  z_warn_if_fail (!is_loading ());
+}
+
+} // namespace zrythm::gui::old_dsp::plugins
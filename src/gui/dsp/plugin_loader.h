@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __PLUGINS_PLUGIN_LOADER_H__
+#define __PLUGINS_PLUGIN_LOADER_H__
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utils/main_thread_notifier.h"
+#include "utils/progress_info.h"
+
+namespace zrythm::gui::old_dsp::plugins
+{
+
+class Plugin;
+
+/**
+ * @addtogroup plugins
+ *
+ * @{
+ */
+
+/**
+ * @brief Instantiates and restores the plugins of a project being loaded in
+ * parallel.
+ *
+ * Plugins are added while the project is initialized (see
+ * Plugin::init_loaded()) and start() hands them to worker threads, except
+ * those that must be instantiated on the main thread (see
+ * Plugin::requires_main_thread_instantiation()), which are instantiated one
+ * at a time from the main thread's event loop. Each plugin is activated on
+ * the main thread as soon as it is ready, so the project can be played while
+ * the remaining plugins are loading (plugins that are not ready yet are
+ * silent).
+ *
+ * Plugins must not be removed while they are being loaded. Must be created
+ * and destroyed on the main thread.
+ */
+class PluginLoader
+{
+public:
+  /**
+   * @param progress_info Progress info to report each loaded plugin to, if
+   * any.
+   */
+  explicit PluginLoader (ProgressInfo * progress_info = nullptr);
+
+  /**
+   * @brief Waits for the worker threads (plugins that weren't finished yet
+   * are left uninstantiated).
+   */
+  ~PluginLoader ();
+
+  PluginLoader (const PluginLoader &) = delete;
+  PluginLoader &operator= (const PluginLoader &) = delete;
+
+  /**
+   * @brief Adds a plugin to load (before start()).
+   *
+   * @param was_enabled Whether to enable the plugin once it is loaded.
+   */
+  void add (Plugin &plugin, bool was_enabled);
+
+  /**
+   * @brief Starts loading the added plugins.
+   */
+  void start ();
+
+  /**
+   * @brief Returns whether some plugins are still loading.
+   */
+  bool is_loading () const { return num_finished_ < entries_.size (); }
+
+  /**
+   * @brief Loads all remaining plugins on the calling (main) thread and waits
+   * for the worker threads.
+   *
+   * Used when the project needs to be complete right away (e.g., in tests).
+   */
+  void wait_until_loaded ();
+
+private:
+  struct Entry
+  {
+    Plugin * plugin_ = nullptr;
+    bool     was_enabled_ = false;
+    bool     requires_main_thread_ = false;
+
+    /** Error message if instantiate_impl() failed (set by the worker). */
+    std::string error_;
+  };
+
+  /**
+   * @brief Runs instantiate_impl() on the given entry, recording any error.
+   */
+  void instantiate_entry (Entry &entry);
+
+  /**
+   * @brief Worker thread body.
+   */
+  void process_worker_entries ();
+
+  /**
+   * @brief Finishes the plugins loaded by the workers and instantiates the
+   * next main-thread plugin, if any (main thread).
+   */
+  void process_ready_entries ();
+
+  /**
+   * @brief Activates the plugin of @p entry, or disables it if instantiation
+   * failed (main thread).
+   */
+  void finish_entry (Entry &entry);
+
+private:
+  std::vector<Entry> entries_;
+
+  /** Indices of the entries to instantiate on worker threads. */
+  std::vector<size_t> worker_entries_;
+
+  /** Indices of the entries to instantiate on the main thread. */
+  std::vector<size_t> main_thread_entries_;
+
+  /** Next index in @ref worker_entries_ to instantiate. */
+  std::atomic<size_t> next_worker_entry_ = 0;
+
+  /** Next index in @ref main_thread_entries_ to instantiate. */
+  size_t next_main_thread_entry_ = 0;
+
+  /** Entries instantiated by the workers but not finished yet. */
+  std::vector<size_t> ready_entries_;
+  std::mutex          ready_entries_mutex_;
+
+  /** Number of entries finished (main thread). */
+  size_t num_finished_ = 0;
+
+  /** Set when the loader is destroyed, to make the workers stop early. */
+  std::atomic<bool> cancelled_ = false;
+
+  ProgressInfo * progress_info_ = nullptr;
+
+  std::vector<std::future<void>> workers_;
+
+  /** Runs process_ready_entries() on the main thread. */
+  std::unique_ptr<utils::MainThreadNotifier> notifier_;
+};
+
+/**
+ * @}
+ */
+
+} // namespace zrythm::gui::old_dsp::plugins
+
+#endif
@@ -0,0 +1,140 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "gui/dsp/plugin_descriptor.h"
+#include "gui/dsp/plugin_preset_cache.h"
+#include "utils/logger.h"
+#include "utils/types.h"
+
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QStandardPaths>
+
+using namespace zrythm::gui::old_dsp::plugins;
+using namespace Qt::StringLiterals;
+
+std::optional<PluginPresetCache::Fingerprint>
+PluginPresetCache::get_fingerprint (const PluginDescriptor &descr)
+{
+  if (descr.path_.empty ())
+    return std::nullopt;
+
+  /* bundles are directories whose modification time changes when their
+   * contents are replaced */
+  const QFileInfo info (QString::fromStdString (descr.path_.string ()));
+  if (!info.exists ())
+    return std::nullopt;
+
+  return Fingerprint{
+    .size_ = info.isDir () ? 0 : info.size (),
+    .mod_time_ms_ = info.lastModified ().toMSecsSinceEpoch (),
+  };
+}
+
+std::string
+PluginPresetCache::get_key (const PluginDescriptor &descr)
+{
+  return fmt::format (
+    "{}|{}|{}|{}", ENUM_NAME (descr.protocol_), descr.path_.string (),
+    descr.uri_, descr.unique_id_);
+}
+
+std::filesystem::path
+PluginPresetCache::get_cache_path (const std::string &key)
+{
+  const auto hash =
+    QCryptographicHash::hash (
+      QByteArray::fromStdString (key), QCryptographicHash::Sha1)
+      .toHex ();
+  QDir dir (
+    QStandardPaths::writableLocation (QStandardPaths::AppLocalDataLocation));
+  return dir
+    .absoluteFilePath (
+      QStringLiteral ("preset_cache/%1.json").arg (QString::fromLatin1 (hash)))
+    .toStdString ();
+}
+
+std::optional<std::vector<PluginPresetCache::PresetInfo>>
+PluginPresetCache::load (const PluginDescriptor &descr)
+{
+  const auto fingerprint = get_fingerprint (descr);
+  if (!fingerprint)
+    return std::nullopt;
+
+  const auto key = get_key (descr);
+  QFile      file (QString::fromStdString (get_cache_path (key).string ()));
+  if (!file.open (QIODevice::ReadOnly))
+    return std::nullopt;
+
+  const auto doc = QJsonDocument::fromJson (file.readAll ());
+  const auto obj = doc.object ();
+  if (
+    obj[u"key"].toString ().toStdString () != key
+    || obj[u"size"].toInteger () != fingerprint->size_
+    || obj[u"modTime"].toInteger () != fingerprint->mod_time_ms_)
+    {
+      z_debug ("preset cache for {} is out of date", descr.name_);
+      return std::nullopt;
+    }
+
+  std::vector<PresetInfo> presets;
+  const auto              presets_arr = obj[u"presets"].toArray ();
+  presets.reserve (static_cast<size_t> (presets_arr.size ()));
+  for (const auto &preset_val : presets_arr)
+    {
+      const auto preset_obj = preset_val.toObject ();
+      presets.push_back (PresetInfo{
+        .name_ = preset_obj[u"name"].toString ().toStdString (),
+        .carla_program_ = preset_obj[u"program"].toInt () });
+    }
+  return presets;
+}
+
+void
+PluginPresetCache::save (
+  const PluginDescriptor        &descr,
+  const std::vector<PresetInfo> &presets)
+{
+  const auto fingerprint = get_fingerprint (descr);
+  if (!fingerprint)
+    return;
+
+  QJsonArray presets_arr;
+  for (const auto &preset : presets)
+    {
+      presets_arr.append (QJsonObject{
+        { u"name"_s,    QString::fromStdString (preset.name_) },
+        { u"program"_s, preset.carla_program_                 },
+      });
+    }
+
+  const auto  key = get_key (descr);
+  QJsonObject obj{
+    { u"key"_s,     QString::fromStdString (key) },
+    { u"size"_s,    fingerprint->size_           },
+    { u"modTime"_s, fingerprint->mod_time_ms_    },
+    { u"presets"_s, presets_arr                  },
+  };
+
+  const auto path = QString::fromStdString (get_cache_path (key).string ());
+  QDir ().mkpath (QFileInfo (path).absolutePath ());
+
+  /* QSaveFile writes to a unique temporary file and renames it, so concurrent
+   * writers and readers never see a partial file */
+  QSaveFile file (path);
+  if (
+    !file.open (QIODevice::WriteOnly)
+    || file.write (QJsonDocument (obj).toJson (QJsonDocument::Compact)) < 0
+    || !file.commit ())
+    {
+      z_warning (
+        "failed to write preset cache for {}: {}", descr.name_,
+        file.errorString ().toStdString ());
+    }
+}
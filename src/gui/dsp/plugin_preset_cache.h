@@ -0,0 +1,82 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __PLUGINS_PLUGIN_PRESET_CACHE_H__
+#define __PLUGINS_PLUGIN_PRESET_CACHE_H__
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace zrythm::gui::old_dsp::plugins
+{
+
+class PluginDescriptor;
+
+/**
+ * @addtogroup plugins
+ *
+ * @{
+ */
+
+/**
+ * @brief On-disk cache of the factory presets of each plugin.
+ *
+ * Querying the names of thousands of presets from a plugin (especially a
+ * bridged one) is slow, so the preset list is stored per plugin descriptor
+ * the first time it is queried. An entry is discarded when the plugin's
+ * binary (or bundle) changes size or modification time.
+ *
+ * Thread-safe (entries are replaced atomically).
+ */
+class PluginPresetCache
+{
+public:
+  struct PresetInfo
+  {
+    std::string name_;
+    int         carla_program_ = 0;
+  };
+
+public:
+  /**
+   * @brief Returns the cached presets of the plugin, if any and still valid.
+   */
+  static std::optional<std::vector<PresetInfo>>
+  load (const PluginDescriptor &descr);
+
+  /**
+   * @brief Stores the presets of the plugin.
+   *
+   * Does nothing for plugins that are not backed by a file (their presets
+   * can't be invalidated). Errors are logged.
+   */
+  static void
+  save (const PluginDescriptor &descr, const std::vector<PresetInfo> &presets);
+
+private:
+  struct Fingerprint
+  {
+    int64_t size_ = 0;
+    int64_t mod_time_ms_ = 0;
+  };
+
+  static std::optional<Fingerprint>
+  get_fingerprint (const PluginDescriptor &descr);
+
+  /**
+   * @brief Returns a string identifying the plugin.
+   */
+  static std::string get_key (const PluginDescriptor &descr);
+
+  static std::filesystem::path get_cache_path (const std::string &key);
+};
+
+/**
+ * @}
+ */
+
+} // namespace zrythm::gui::old_dsp::plugins
+
+#endif
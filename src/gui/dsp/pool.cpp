@@ -1,11 +1,14 @@
 // SPDX-FileCopyrightText: © 2019-2023 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <atomic>
 #include <cstdlib>
+#include <mutex>
 
 #include "gui/backend/backend/actions/undo_manager.h"
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/zrythm.h"
+#include "gui/dsp/audio_region.h"
 #include "gui/dsp/clip.h"
 #include "gui/dsp/pool.h"
 #include "gui/dsp/track.h"
@@ -13,25 +16,305 @@
 
 #include "utils/io.h"
 #include "utils/string.h"
+#include "utils/tracing.h"
 
 using namespace zrythm;
 
 AudioPool::AudioPool (AudioEngine * engine) : engine_ (engine) { }
 
 void
-AudioPool::init_loaded (AudioEngine * engine)
+AudioPool::init_loaded (AudioEngine * engine, ProgressInfo * progress_info)
 {
+  start_init_loaded (engine, progress_info);
+  wait_until_loaded ();
+}
+
+void
+AudioPool::start_init_loaded (
+  AudioEngine *  engine,
+  ProgressInfo * progress_info)
+{
+  wait_until_loaded ();
   engine_ = engine;
-  for (auto &clip : clips_)
+  {
+    std::lock_guard lock (loading_mutex_);
+    pending_clips_.clear ();
+    failed_clips_.clear ();
+    for (auto &clip : clips_)
+      {
+        if (clip)
+          {
+            clip->set_loaded (false);
+            pending_clips_.push_back (clip.get ());
+          }
+      }
+  }
+  loading_ = std::async (std::launch::async, [this, progress_info] () {
+    load_pending_clips (progress_info);
+  });
+}
+
+void
+AudioPool::wait_until_loaded ()
+{
+  if (loading_.valid ())
     {
-      if (clip)
+      /* rethrows any error */
+      loading_.get ();
+      update_fingerprints ();
+      update_onsets ();
+    }
+}
+
+void
+AudioPool::prioritize_clips (const std::vector<AudioClip *> &clips)
+{
+  std::lock_guard lock (loading_mutex_);
+  std::ranges::stable_partition (pending_clips_, [&clips] (AudioClip * clip) {
+    return std::ranges::contains (clips, clip);
+  });
+}
+
+void
+AudioPool::wait_until_clips_loaded (const std::vector<AudioClip *> &clips)
+{
+  prioritize_clips (clips);
+
+  std::unique_lock lock (loading_mutex_);
+  for (auto * clip : clips)
+    {
+      clip_loaded_cv_.wait (lock, [this, clip] () {
+        return clip->is_loaded () || failed_clips_.contains (clip);
+      });
+      if (auto it = failed_clips_.find (clip); it != failed_clips_.end ())
         {
-          clip->init_loaded (get_clip_path_from_name (
-            clip->get_name (), clip->get_use_flac (), false));
+          throw ZrythmException (
+            fmt::format ("Failed to load clip {}", it->second));
         }
     }
 }
 
+bool
+AudioPool::has_pending_clips ()
+{
+  std::lock_guard lock (loading_mutex_);
+  return !pending_clips_.empty ();
+}
+
+std::vector<AudioClip *>
+AudioPool::get_clips_used_by_track (Track &track)
+{
+  std::vector<Region *> regions;
+  track.get_regions_in_range (regions, nullptr, nullptr);
+
+  std::vector<AudioClip *> clips;
+  for (auto * region : regions)
+    {
+      auto * audio_region = dynamic_cast<AudioRegion *> (region);
+      if (!audio_region)
+        continue;
+
+      auto * clip = audio_region->get_clip ();
+      if (clip && !std::ranges::contains (clips, clip))
+        {
+          clips.push_back (clip);
+        }
+    }
+  return clips;
+}
+
+AudioClip *
+AudioPool::take_next_pending_clip ()
+{
+  std::lock_guard lock (loading_mutex_);
+  if (pending_clips_.empty ())
+    return nullptr;
+
+  auto * clip = pending_clips_.front ();
+  pending_clips_.pop_front ();
+  return clip;
+}
+
+void
+AudioPool::for_each_index_in_parallel (
+  size_t                                     count,
+  size_t                                     max_threads,
+  const std::function<void (size_t)>        &func,
+  const std::function<std::string (size_t)> &get_error_prefix)
+{
+  const auto num_threads = std::min (max_threads, count);
+
+  std::string         error_message;
+  std::mutex          error_mutex;
+  std::atomic<size_t> next_index = 0;
+
+  const auto process_next_indices = [&] () {
+    for (auto i = next_index++; i < count; i = next_index++)
+      {
+        try
+          {
+            func (i);
+          }
+        catch (const std::exception &e)
+          {
+            std::lock_guard lock (error_mutex);
+            if (error_message.empty ())
+              {
+                error_message =
+                  fmt::format ("{}: {}", get_error_prefix (i), e.what ());
+              }
+          }
+      }
+  };
+
+  z_debug ("processing {} items with {} threads...", count, num_threads);
+  std::vector<std::future<void>> workers;
+  workers.reserve (num_threads);
+  for (size_t i = 0; i < num_threads; ++i)
+    {
+      workers.emplace_back (
+        std::async (std::launch::async, process_next_indices));
+    }
+  for (auto &worker : workers)
+    {
+      worker.get ();
+    }
+  z_debug ("done");
+
+  if (!error_message.empty ())
+    {
+      throw ZrythmException (error_message);
+    }
+}
+
+void
+AudioPool::for_each_clip_in_parallel (
+  const std::vector<AudioClip *>          &clips,
+  size_t                                   max_threads,
+  const std::function<void (AudioClip &)> &func)
+{
+  for_each_index_in_parallel (
+    clips.size (), max_threads, [&] (size_t i) { func (*clips[i]); },
+    [&] (size_t i) { return clips[i]->get_name (); });
+}
+
+void
+AudioPool::load_pending_clips (ProgressInfo * progress_info)
+{
+  Z_TRACE_ZONE ("AudioPool::load_pending_clips");
+
+  size_t num_clips = 0;
+  {
+    std::lock_guard lock (loading_mutex_);
+    num_clips = pending_clips_.size ();
+  }
+  if (num_clips == 0)
+    return;
+
+  std::atomic<size_t> num_loaded = 0;
+  std::string         error_message;
+  std::mutex          error_mutex;
+
+  const auto load_next_clips = [&] () {
+    while (auto * clip = take_next_pending_clip ())
+      {
+        std::string error;
+        const bool  cancelled =
+          progress_info && progress_info->pending_cancellation ();
+        if (cancelled)
+          {
+            error = fmt::format ("{}: cancelled", clip->get_name ());
+          }
+        else
+          {
+            try
+              {
+                clip->init_loaded (
+                  get_clip_path_from_name (
+                    clip->get_name (), clip->get_use_flac (), false),
+                  get_decoded_cache_path (*clip));
+                clip->compute_peaks_in_background (get_peaks_path (*clip));
+                clip->compute_onsets_in_background (get_onsets_path (*clip));
+              }
+            catch (const std::exception &e)
+              {
+                error = fmt::format ("{}: {}", clip->get_name (), e.what ());
+              }
+          }
+
+        /* mark the clip under the lock so that waiters don't miss it */
+        {
+          std::lock_guard lock (loading_mutex_);
+          if (error.empty ())
+            {
+              clip->set_loaded (true);
+            }
+          else
+            {
+              failed_clips_.emplace (clip, error);
+            }
+        }
+        clip_loaded_cv_.notify_all ();
+
+        if (cancelled)
+          continue;
+
+        if (!error.empty ())
+          {
+            z_warning ("Failed to load clip {}", error);
+            std::lock_guard lock (error_mutex);
+            if (error_message.empty ())
+              {
+                error_message = fmt::format ("Failed to load clip {}", error);
+              }
+          }
+        else if (progress_info)
+          {
+            const auto loaded = ++num_loaded;
+            progress_info->update_progress (
+              (double) loaded / (double) num_clips,
+              fmt::format ("Loaded {}/{} audio clips", loaded, num_clips));
+          }
+      }
+  };
+
+  /* decoding is mostly CPU-bound, reading cached clips I/O-bound, so use
+   * more threads than CPUs to keep fast drives busy */
+  const auto num_threads = std::min (
+    static_cast<size_t> (juce::SystemStats::getNumCpus ()) * 2, num_clips);
+  z_debug ("loading {} clips with {} threads...", num_clips, num_threads);
+  std::vector<std::future<void>> workers;
+  workers.reserve (num_threads);
+  for (size_t i = 0; i < num_threads; ++i)
+    {
+      workers.emplace_back (std::async (std::launch::async, load_next_clips));
+    }
+  for (auto &worker : workers)
+    {
+      worker.get ();
+    }
+  z_debug ("done loading clips");
+
+  if (progress_info && progress_info->pending_cancellation ())
+    {
+      progress_info->mark_completed (ProgressInfo::CompletionType::CANCELLED, {});
+      throw ZrythmException ("Loading the audio clips was cancelled");
+    }
+  if (!error_message.empty ())
+    {
+      if (progress_info)
+        {
+          progress_info->mark_completed (
+            ProgressInfo::CompletionType::HAS_ERROR, error_message);
+        }
+      throw ZrythmException (error_message);
+    }
+  if (progress_info)
+    {
+      progress_info->mark_completed (ProgressInfo::CompletionType::SUCCESS, {});
+    }
+}
+
 void
 AudioPool::init_after_cloning (const AudioPool &other, ObjectCloneType clone_type)
 {
@@ -70,9 +353,48 @@ AudioPool::get_clip_path (const AudioClip &clip, bool is_backup)
     clip.get_name (), clip.get_use_flac (), is_backup);
 }
 
+std::optional<fs::path>
+AudioPool::get_decoded_cache_path (const AudioClip &clip)
+{
+  if (clip.get_file_hash () == 0)
+    return std::nullopt;
+
+  return PROJECT->get_path (ProjectPath::POOL_DECODED_CACHE, false)
+         / (utils::hash::to_string (clip.get_file_hash ()) + ".f32");
+}
+
+std::optional<fs::path>
+AudioPool::get_peaks_path (const AudioClip &clip)
+{
+  if (clip.get_file_hash () == 0)
+    return std::nullopt;
+
+  return PROJECT->get_path (ProjectPath::POOL_PEAKS, false)
+         / (utils::hash::to_string (clip.get_file_hash ()) + ".peaks");
+}
+
+std::optional<fs::path>
+AudioPool::get_onsets_path (const AudioClip &clip)
+{
+  if (clip.get_file_hash () == 0)
+    return std::nullopt;
+
+  return PROJECT->get_path (ProjectPath::POOL_PEAKS, false)
+         / (utils::hash::to_string (clip.get_file_hash ()) + ".onsets");
+}
+
+bool
+AudioPool::is_clip_written (const AudioClip &clip)
+{
+  return clip.is_written_to_pool ()
+         && utils::io::path_exists (get_clip_path (clip, false));
+}
+
 void
-AudioPool::write_clip (AudioClip &clip, bool parts, bool backup)
+AudioPool::write_clip (AudioClip &clip, bool backup)
 {
+  Z_TRACE_ZONE ("AudioPool::write_clip");
+
   AudioClip * pool_clip = get_clip (clip.get_pool_id ());
   z_return_if_fail (pool_clip == &clip);
 
@@ -87,11 +409,19 @@ AudioPool::write_clip (AudioClip &clip, bool parts, bool backup)
   z_return_if_fail (!path_in_main_project.empty ());
   z_return_if_fail (!new_path.empty ());
 
+  /* skip if the clip didn't change since it was last written (avoids
+   * hashing the file) */
+  if (!backup && is_clip_written (clip))
+    {
+      z_debug ("skipping writing unchanged clip {} to pool", new_path);
+      return;
+    }
+
   /* whether a new write is needed */
   bool need_new_write = true;
 
   /* skip if file with same hash already exists */
-  if (utils::io::path_exists (new_path) && !parts)
+  if (utils::io::path_exists (new_path))
     {
       bool same_hash =
         clip.get_file_hash () != 0
@@ -101,6 +431,10 @@ AudioPool::write_clip (AudioClip &clip, bool parts, bool backup)
         {
           z_debug ("skipping writing to existing clip {} in pool", new_path);
           need_new_write = false;
+          if (!backup)
+            {
+              clip.mark_written_to_pool (clip.get_file_hash ());
+            }
         }
     }
 
@@ -108,8 +442,10 @@ AudioPool::write_clip (AudioClip &clip, bool parts, bool backup)
    * try reflink) */
   if (need_new_write && clip.get_file_hash () != 0 && backup)
     {
-      bool exists_in_main_project = false;
-      if (utils::io::path_exists (path_in_main_project))
+      bool exists_in_main_project = is_clip_written (clip);
+      if (
+        !exists_in_main_project
+        && utils::io::path_exists (path_in_main_project))
         {
           exists_in_main_project =
             clip.get_file_hash ()
@@ -137,13 +473,19 @@ AudioPool::write_clip (AudioClip &clip, bool parts, bool backup)
   if (need_new_write)
     {
       z_debug (
-        "writing clip {} to pool (parts {}, is backup  {}): '{}'",
-        clip.get_name (), parts, backup, new_path);
-      clip.write_to_file (new_path, parts);
-      if (!parts)
+        "writing clip {} to pool (is backup {}): '{}'", clip.get_name (),
+        backup, new_path);
+      clip.write_to_file (new_path);
+
+      /* store file hash */
+      const auto hash = utils::hash::get_file_hash (new_path);
+      if (backup)
         {
-          /* store file hash */
-          clip.set_file_hash (utils::hash::get_file_hash (new_path));
+          clip.set_file_hash (hash);
+        }
+      else
+        {
+          clip.mark_written_to_pool (hash);
         }
     }
 
@@ -241,12 +583,173 @@ AudioPool::add_clip (std::unique_ptr<AudioClip> &&clip)
       clips_[next_id] = std::move (clip);
     }
 
+  /* identical clips share the frames and their peaks and onsets */
+  if (!deduplicate_clip (*clips_[next_id]))
+    {
+      clips_[next_id]->compute_peaks_in_background (
+        get_peaks_path (*clips_[next_id]));
+      clips_[next_id]->compute_onsets_in_background (
+        get_onsets_path (*clips_[next_id]));
+    }
+
   z_debug ("added clip <{}> to pool", clips_[next_id]->get_name ());
   print ();
 
   return next_id;
 }
 
+std::vector<int>
+AudioPool::add_clips_from_files (
+  const std::vector<fs::path> &paths,
+  sample_rate_t                project_sample_rate,
+  bpm_t                        current_bpm,
+  ProgressInfo *               progress_info)
+{
+  Z_TRACE_ZONE ("AudioPool::add_clips_from_files");
+
+  z_return_val_if_fail (engine_, {});
+
+  const auto num_files = paths.size ();
+  if (num_files == 0)
+    return {};
+
+  const auto num_cpus = static_cast<size_t> (juce::SystemStats::getNumCpus ());
+  const auto get_file_name = [&paths] (size_t i) {
+    return paths[i].filename ().string ();
+  };
+
+  /* index of the first file with the same contents as each file */
+  std::vector<size_t>                     source_indices (num_files);
+  std::vector<size_t>                     unique_indices;
+  std::vector<std::unique_ptr<AudioClip>> new_clips (num_files);
+  try
+    {
+      /* hash the files first so that files with the same contents are only
+       * decoded once */
+      std::vector<utils::hash::HashT> hashes (num_files);
+      for_each_index_in_parallel (
+        num_files, num_cpus * 2,
+        [&] (size_t i) {
+          if (progress_info && progress_info->pending_cancellation ())
+            return;
+
+          hashes[i] = utils::hash::get_file_hash (paths[i]);
+          if (hashes[i] == 0)
+            {
+              throw ZrythmException ("Failed to read file");
+            }
+        },
+        get_file_name);
+
+      /* files with the same contents use the clip of the first one */
+      std::unordered_map<utils::hash::HashT, size_t> first_indices;
+      for (size_t i = 0; i < num_files; ++i)
+        {
+          auto [it, inserted] = first_indices.emplace (hashes[i], i);
+          source_indices[i] = it->second;
+          if (inserted)
+            {
+              unique_indices.push_back (i);
+            }
+        }
+      z_debug (
+        "importing {} files ({} unique)", num_files, unique_indices.size ());
+
+      /* decode (and resample) */
+      std::atomic<size_t> num_decoded = 0;
+      for_each_index_in_parallel (
+        unique_indices.size (), num_cpus,
+        [&] (size_t i) {
+          if (progress_info && progress_info->pending_cancellation ())
+            return;
+
+          const auto index = unique_indices[i];
+          new_clips[index] = std::make_unique<AudioClip> (
+            paths[index].string (), project_sample_rate, current_bpm);
+          if (progress_info)
+            {
+              const auto decoded = ++num_decoded;
+              progress_info->update_progress (
+                0.8 * (double) decoded / (double) unique_indices.size (),
+                fmt::format (
+                  "Decoded {}/{} files ({})", decoded, unique_indices.size (),
+                  get_file_name (index)));
+            }
+        },
+        [&] (size_t i) { return get_file_name (unique_indices[i]); });
+    }
+  catch (const ZrythmException &e)
+    {
+      if (progress_info)
+        {
+          progress_info->mark_completed (
+            ProgressInfo::CompletionType::HAS_ERROR, e.what ());
+        }
+      throw;
+    }
+  if (progress_info && progress_info->pending_cancellation ())
+    {
+      progress_info->mark_completed (
+        ProgressInfo::CompletionType::CANCELLED, {});
+      throw ZrythmException ("Importing the files was cancelled");
+    }
+
+  /* add to the pool in order (so names and IDs are deterministic) */
+  std::vector<int>         ids (num_files, -1);
+  std::vector<AudioClip *> clips_to_write;
+  for (const auto index : unique_indices)
+    {
+      ids[index] = add_clip (std::move (new_clips[index]));
+      if (ids[index] < 0)
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to add {} to the pool", get_file_name (index)));
+        }
+      clips_to_write.push_back (get_clip (ids[index]));
+    }
+  for (size_t i = 0; i < num_files; ++i)
+    {
+      ids[i] = ids[source_indices[i]];
+    }
+
+  /* write the clips, so that saving the project doesn't need to */
+  auto prj_pool_dir = engine_->project_->get_path (ProjectPath::POOL, false);
+  std::atomic<size_t> num_written = 0;
+  try
+    {
+      if (!utils::io::path_exists (prj_pool_dir))
+        {
+          utils::io::mkdir (prj_pool_dir);
+        }
+      for_each_clip_in_parallel (
+        clips_to_write, num_cpus, [&] (AudioClip &clip) {
+          write_clip (clip, false);
+          if (progress_info)
+            {
+              const auto written = ++num_written;
+              progress_info->update_progress (
+                0.8
+                  + 0.2 * (double) written / (double) clips_to_write.size (),
+                fmt::format (
+                  "Wrote {}/{} clips to the pool", written,
+                  clips_to_write.size ()));
+            }
+        });
+    }
+  catch (const ZrythmException &e)
+    {
+      /* the clips are still written when saving the project */
+      z_warning ("Failed to write imported clips to the pool: {}", e.what ());
+    }
+
+  if (progress_info)
+    {
+      progress_info->mark_completed (ProgressInfo::CompletionType::SUCCESS, {});
+    }
+
+  return ids;
+}
+
 AudioClip *
 AudioPool::get_clip (int clip_id)
 {
@@ -266,9 +769,8 @@ AudioPool::duplicate_clip (int clip_id, bool write_file)
   const auto clip = get_clip (clip_id);
   z_return_val_if_fail (clip, -1);
 
-  auto new_id = add_clip (std::make_unique<AudioClip> (
-    clip->get_samples (), clip->get_bit_depth (), engine_->sample_rate_,
-    P_TEMPO_TRACK->get_current_bpm (), clip->get_name ()));
+  /* the new clip shares the frames until either clip is modified */
+  auto new_id = add_clip (clip->clone_unique ());
   auto new_clip = get_clip (new_id);
 
   z_debug (
@@ -279,12 +781,154 @@ AudioPool::duplicate_clip (int clip_id, bool write_file)
 
   if (write_file)
     {
-      write_clip (*new_clip, false, false);
+      write_clip (*new_clip, false);
     }
 
   return new_clip->get_pool_id ();
 }
 
+bool
+AudioPool::deduplicate_clip (AudioClip &clip)
+{
+  using utils::audio::AudioFingerprint;
+
+  const auto frames = clip.get_shared_frames ();
+  if (!frames || clip.is_streaming () || !clip.is_loaded ())
+    return false;
+
+  const auto id = clip.get_pool_id ();
+  fingerprint_index_->set (
+    id, clip.get_generation (), AudioFingerprint::compute_exact (*frames));
+  fingerprinted_generations_[id] = clip.get_generation ();
+
+  bool shared = false;
+  for (const auto other_id : fingerprint_index_->find_exact_matches (id))
+    {
+      if (other_id < 0 || other_id >= (int64_t) clips_.size ())
+        continue;
+
+      const auto &other = clips_[other_id];
+      if (
+        !other || other->is_streaming () || !other->get_shared_frames ()
+        || fingerprint_index_->get_version (other_id)
+             != other->get_generation ())
+        continue;
+
+      /* clones already share the frames */
+      if (other->get_shared_frames () == frames)
+        {
+          shared = true;
+          break;
+        }
+
+      /* guard against hash collisions */
+      if (clip.has_identical_frames (*other))
+        {
+          z_debug (
+            "clip <{}> is identical to clip <{}>, sharing its frames",
+            clip.get_name (), other->get_name ());
+          clip.share_frames_with (*other);
+          shared = true;
+          break;
+        }
+    }
+
+  fingerprint_clip_in_background (clip, false);
+  return shared;
+}
+
+void
+AudioPool::fingerprint_clip_in_background (const AudioClip &clip, bool exact)
+{
+  using utils::audio::AudioFingerprint;
+
+  auto frames = clip.get_shared_frames ();
+  if (!frames || !gZrythm || !gZrythm->background_thread_pool_)
+    return;
+
+  fingerprinted_generations_[clip.get_pool_id ()] = clip.get_generation ();
+
+  /* the frames are not modified while the job refers to them (edits copy
+   * them first), and fingerprints of older generations are not used */
+  gZrythm->background_thread_pool_->addJob (
+    [index = fingerprint_index_, frames, exact, id = clip.get_pool_id (),
+     generation = clip.get_generation (),
+     samplerate = clip.get_samplerate ()] () {
+      if (exact)
+        {
+          index->set (
+            id, generation, AudioFingerprint::compute_exact (*frames));
+        }
+      index->set_chroma (
+        id, generation, AudioFingerprint::compute_chroma (*frames, samplerate));
+    });
+}
+
+void
+AudioPool::update_fingerprints ()
+{
+  std::vector<utils::audio::AudioFingerprintIndex::Key> ids;
+  for (const auto &clip : clips_)
+    {
+      if (!clip)
+        continue;
+
+      const auto id = clip->get_pool_id ();
+      ids.push_back (id);
+      if (
+        !clip->is_loaded () || clip->is_streaming ()
+        || !clip->get_shared_frames ())
+        continue;
+
+      auto it = fingerprinted_generations_.find (id);
+      if (
+        it != fingerprinted_generations_.end ()
+        && it->second == clip->get_generation ())
+        continue;
+
+      fingerprint_clip_in_background (*clip, true);
+    }
+  fingerprint_index_->retain (ids);
+}
+
+void
+AudioPool::update_onsets ()
+{
+  for (const auto &clip : clips_)
+    {
+      if (clip && clip->is_loaded () && !clip->is_streaming ())
+        clip->compute_onsets_in_background (get_onsets_path (*clip));
+    }
+}
+
+std::vector<int>
+AudioPool::find_duplicate_clips (int clip_id)
+{
+  update_fingerprints ();
+
+  std::vector<int> ret;
+  for (const auto id : fingerprint_index_->find_exact_matches (clip_id))
+    {
+      ret.push_back (static_cast<int> (id));
+    }
+  return ret;
+}
+
+std::vector<std::pair<int, float>>
+AudioPool::find_similar_clips (int clip_id, float min_similarity)
+{
+  update_fingerprints ();
+
+  std::vector<std::pair<int, float>> ret;
+  for (
+    const auto &[id, similarity] :
+    fingerprint_index_->find_similar (clip_id, min_similarity))
+    {
+      ret.emplace_back (static_cast<int> (id), similarity);
+    }
+  return ret;
+}
+
 std::string
 AudioPool::gen_name_for_recording_clip (const Track &track, int lane)
 {
@@ -310,6 +954,8 @@ AudioPool::remove_clip (int clip_id, bool free_and_remove_file, bool backup)
       utils::io::remove (path);
     }
 
+  fingerprint_index_->remove (clip_id);
+  fingerprinted_generations_.erase (clip_id);
   auto removed_clip = std::move (clips_[clip_id]);
 }
 
@@ -331,7 +977,8 @@ AudioPool::remove_unused (bool backup)
         }
     }
 
-  /* remove untracked files from pool directory */
+  /* remove untracked files (including stale decoded caches, peaks and
+   * onsets) from pool directory */
   auto prj_pool_dir = PROJECT->get_path (ProjectPath::POOL, backup);
   auto files =
     utils::io::get_files_in_dir_ending_in (prj_pool_dir, true, std::nullopt);
@@ -343,7 +990,13 @@ AudioPool::remove_unused (bool backup)
           if (!clip)
             continue;
 
-          if (get_clip_path (*clip, backup) == fs::path (path.toStdString ()))
+          const fs::path file_path = path.toStdString ();
+          if (
+            get_clip_path (*clip, backup) == file_path
+            || (!backup
+                && (get_decoded_cache_path (*clip) == file_path
+                    || get_peaks_path (*clip) == file_path
+                    || get_onsets_path (*clip) == file_path)))
             {
               found = true;
               break;
@@ -363,6 +1016,9 @@ AudioPool::remove_unused (bool backup)
 void
 AudioPool::reload_clip_frame_bufs ()
 {
+  Z_TRACE_ZONE ("AudioPool::reload_clip_frame_bufs");
+
+  std::vector<AudioClip *> clips_to_load;
   for (auto &clip : clips_)
     {
       if (!clip)
@@ -373,8 +1029,7 @@ AudioPool::reload_clip_frame_bufs ()
       if (in_use && clip->get_num_frames () == 0)
         {
           /* load from the file */
-          clip->init_loaded (get_clip_path_from_name (
-            clip->get_name (), clip->get_use_flac (), false));
+          clips_to_load.push_back (clip.get ());
         }
       else if (!in_use && clip->get_num_frames () > 0)
         {
@@ -382,6 +1037,9 @@ AudioPool::reload_clip_frame_bufs ()
           clip->clear_frames ();
         }
     }
+  load_clips (clips_to_load, nullptr);
+  update_fingerprints ();
+  update_onsets ();
 }
 
 struct WriteClipData
@@ -397,6 +1055,8 @@ struct WriteClipData
 void
 AudioPool::write_to_disk (bool is_backup)
 {
+  Z_TRACE_ZONE ("AudioPool::write_to_disk");
+
   z_return_if_fail (engine_);
 
   /* ensure pool dir exists */
@@ -414,42 +1074,32 @@ AudioPool::write_to_disk (bool is_backup)
         }
     }
 
-  const int        num_threads = juce::SystemStats::getNumCpus ();
-  juce::ThreadPool pool (num_threads);
-
-  std::string           error_message;
-  juce::CriticalSection error_mutex;
-
+  /* only write clips that changed since they were last written (backups
+   * are in a new directory each time so all clips are needed, but unchanged
+   * ones are reflinked or copied from the main project) */
+  std::vector<AudioClip *> clips_to_write;
   for (auto &clip : clips_)
     {
-      if (clip)
+      if (clip && (is_backup || !is_clip_written (*clip)))
         {
-          pool.addJob ([this, &clip, is_backup, &error_message, &error_mutex] () {
-            try
-              {
-                write_clip (*clip, false, is_backup);
-              }
-            catch (const ZrythmException &e)
-              {
-                const juce::ScopedLock lock (error_mutex);
-                if (error_message.empty ())
-                  {
-                    error_message = fmt::format (
-                      "Failed to write clip {} to disk: {}", clip->get_name (),
-                      e.what ());
-                  }
-              }
-          });
+          clips_to_write.push_back (clip.get ());
         }
     }
+  z_debug (
+    "writing {} of {} clips to the pool", clips_to_write.size (),
+    clips_.size ());
 
-  z_debug ("waiting for tasks to finish...");
-  pool.removeAllJobs (false, -1);
-  z_debug ("done");
-
-  if (!error_message.empty ())
+  try
     {
-      throw ZrythmException (error_message);
+      for_each_clip_in_parallel (
+        clips_to_write,
+        static_cast<size_t> (juce::SystemStats::getNumCpus ()),
+        [&] (AudioClip &clip) { write_clip (clip, is_backup); });
+    }
+  catch (const ZrythmException &e)
+    {
+      throw ZrythmException (
+        fmt::format ("Failed to write clip {} to disk", e.what ()));
     }
 }
 
@@ -4,7 +4,16 @@
 #ifndef __AUDIO_POOL_H__
 #define __AUDIO_POOL_H__
 
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <unordered_map>
+
 #include "gui/dsp/clip.h"
+#include "utils/audio_fingerprint.h"
+#include "utils/progress_info.h"
 
 class Track;
 class AudioEngine;
@@ -36,9 +45,60 @@ public:
   /**
    * Initializes the audio pool after deserialization.
    *
+   * The clips are loaded in parallel.
+   *
+   * @param progress_info Progress info to report the loading progress to, if
+   * any (cancelling it skips the remaining clips).
    * @throw ZrythmException if an error occurred.
    */
-  void init_loaded (AudioEngine * engine);
+  void
+  init_loaded (AudioEngine * engine, ProgressInfo * progress_info = nullptr);
+
+  /**
+   * Starts init_loaded() in the background, so that the rest of the project
+   * can be initialized meanwhile.
+   *
+   * Clips are marked as not loaded (see AudioClip::is_loaded()) until their
+   * frames are available. wait_until_loaded() or wait_until_clips_loaded()
+   * must be called before accessing their frames.
+   */
+  void start_init_loaded (
+    AudioEngine *  engine,
+    ProgressInfo * progress_info = nullptr);
+
+  /**
+   * Waits for the loading started by start_init_loaded() to finish (does
+   * nothing if not loading).
+   *
+   * @throw ZrythmException if an error occurred while loading (only thrown to
+   * the first caller).
+   */
+  void wait_until_loaded ();
+
+  /**
+   * Loads @p clips before the other clips still waiting to be loaded by
+   * start_init_loaded() (e.g., because their tracks became visible).
+   */
+  void prioritize_clips (const std::vector<AudioClip *> &clips);
+
+  /**
+   * Prioritizes @p clips (see prioritize_clips()) and waits until they are
+   * loaded, while the rest of the clips keep loading in the background.
+   *
+   * @throw ZrythmException if any of @p clips failed to load.
+   */
+  void wait_until_clips_loaded (const std::vector<AudioClip *> &clips);
+
+  /**
+   * Returns whether clips are still waiting to be loaded by
+   * start_init_loaded().
+   */
+  bool has_pending_clips ();
+
+  /**
+   * Returns the clips used by the regions of @p track.
+   */
+  static std::vector<AudioClip *> get_clips_used_by_track (Track &track);
 
   /**
    * Adds an audio clip to the pool.
@@ -50,6 +110,27 @@ public:
    */
   int add_clip (std::unique_ptr<AudioClip> &&clip);
 
+  /**
+   * Adds clips for the given audio files to the pool (e.g., when importing
+   * many files at once).
+   *
+   * The files are hashed, decoded (and resampled to @p project_sample_rate)
+   * and written to the pool in parallel. Files with the same contents share
+   * a clip.
+   *
+   * @param progress_info Progress info to report the progress to (per file),
+   * if any. Cancelling it stops the import before any clip is added.
+   * @return The ID in the pool of the clip of each file.
+   *
+   * @throw ZrythmException if any of the files couldn't be read, or if
+   * cancelled.
+   */
+  std::vector<int> add_clips_from_files (
+    const std::vector<fs::path> &paths,
+    sample_rate_t                project_sample_rate,
+    bpm_t                        current_bpm,
+    ProgressInfo *               progress_info = nullptr);
+
   /**
    * Duplicates the clip with the given ID and returns the duplicate.
    *
@@ -81,15 +162,42 @@ public:
    */
   static fs::path get_clip_path (const AudioClip &clip, bool is_backup);
 
+  /**
+   * Gets the path of the decoded audio cache of the given clip in the (main)
+   * project's pool, or nothing if the clip has no file hash yet.
+   *
+   * @see utils::audio::DecodedAudioCache.
+   */
+  static std::optional<fs::path>
+  get_decoded_cache_path (const AudioClip &clip);
+
+  /**
+   * Gets the path of the waveform peaks of the given clip in the (main)
+   * project's pool, or nothing if the clip has no file hash yet.
+   *
+   * @see utils::audio::PeakPyramid.
+   */
+  static std::optional<fs::path> get_peaks_path (const AudioClip &clip);
+
+  /**
+   * Gets the path of the onsets of the given clip in the (main) project's
+   * pool, or nothing if the clip has no file hash yet.
+   *
+   * @see utils::audio::OnsetIndex.
+   */
+  static std::optional<fs::path> get_onsets_path (const AudioClip &clip);
+
   /**
    * Writes the clip to the pool as a wav file.
    *
-   * @param parts If true, only write new data. @see AudioClip.frames_written.
+   * Recorded clips are streamed to the pool while recording instead (see
+   * RecordingDiskWriter).
+   *
    * @param backup Whether writing to a backup project.
    *
    * @throw ZrythmException on error.
    */
-  void write_clip (AudioClip &clip, bool parts, bool backup);
+  void write_clip (AudioClip &clip, bool backup);
 
   /**
    * Removes the clip with the given ID from the pool and optionally frees it
@@ -137,7 +245,9 @@ public:
   /**
    * Writes all the clips to disk.
    *
-   * Used when saving a project elsewhere.
+   * Clips that didn't change since they were last written to the main
+   * project are skipped (or copied, for backups). The rest are written in
+   * parallel.
    *
    * @param is_backup Whether this is a backup project.
    *
@@ -145,6 +255,44 @@ public:
    */
   void write_to_disk (bool is_backup);
 
+  /**
+   * Fingerprints the clips whose frames changed since they were last
+   * fingerprinted, in the background (see find_duplicate_clips() and
+   * find_similar_clips()).
+   *
+   * Clips that are not loaded or are streamed are skipped.
+   */
+  void update_fingerprints ();
+
+  /**
+   * Detects the onsets of the clips whose frames changed since they were
+   * last detected, in the background (see AudioClip::get_onsets()).
+   *
+   * Clips that are not loaded or are streamed are skipped.
+   */
+  void update_onsets ();
+
+  /**
+   * Returns the IDs of the other clips with identical frames (regardless of
+   * the files they were imported from), in ascending order.
+   *
+   * Only clips whose fingerprints were computed already are considered (see
+   * update_fingerprints()).
+   */
+  std::vector<int> find_duplicate_clips (int clip_id);
+
+  /**
+   * Returns the IDs of the other clips with similar (but not identical)
+   * audio and their similarity (from 0 to 1), most similar first.
+   *
+   * Requires Chromaprint. Only clips whose fingerprints were computed
+   * already are considered (see update_fingerprints()).
+   */
+  std::vector<std::pair<int, float>> find_similar_clips (
+    int   clip_id,
+    float min_similarity =
+      zrythm::utils::audio::AudioFingerprintIndex::DEFAULT_MIN_SIMILARITY);
+
   void print () const;
 
   void init_after_cloning (const AudioPool &other, ObjectCloneType clone_type)
@@ -155,11 +303,76 @@ public:
 private:
   bool name_exists (const std::string &name) const;
 
+  /**
+   * Returns whether the clip's file in the main project's pool is up to date
+   * (without hashing the file).
+   */
+  static bool is_clip_written (const AudioClip &clip);
+
+  /**
+   * Calls @p func on each of @p clips from up to @p max_threads threads.
+   *
+   * @throw ZrythmException The first error thrown by @p func (prefixed with
+   * the clip's name), after all the clips are processed.
+   */
+  static void for_each_clip_in_parallel (
+    const std::vector<AudioClip *>          &clips,
+    size_t                                   max_threads,
+    const std::function<void (AudioClip &)> &func);
+
+  /**
+   * Calls @p func with each index in [0, @p count) from up to @p max_threads
+   * threads.
+   *
+   * @param get_error_prefix Returns the prefix of the error message of each
+   * index.
+   * @throw ZrythmException The first error thrown by @p func, after all the
+   * indices are processed.
+   */
+  static void for_each_index_in_parallel (
+    size_t                                     count,
+    size_t                                     max_threads,
+    const std::function<void (size_t)>        &func,
+    const std::function<std::string (size_t)> &get_error_prefix);
+
+  /**
+   * Loads the frames of the clips in @ref pending_clips_ from their files in
+   * parallel, in order.
+   *
+   * @throw ZrythmException if any clip failed to load.
+   */
+  void load_pending_clips (ProgressInfo * progress_info);
+
+  /**
+   * Removes and returns the first clip in @ref pending_clips_, or nullptr if
+   * there are none left.
+   */
+  AudioClip * take_next_pending_clip ();
+
   /**
    * Returns the next available ID.
    */
   int get_next_id () const;
 
+  /**
+   * Fingerprints the frames of @p clip and makes it share the frames of an
+   * identical clip, if any, then computes the rest of the fingerprint in the
+   * background.
+   *
+   * The clip must not be played back yet.
+   *
+   * @return Whether the clip now shares the frames of another clip.
+   */
+  bool deduplicate_clip (AudioClip &clip);
+
+  /**
+   * Computes the fingerprint of @p clip in the background.
+   *
+   * @param exact Whether to also compute the exact part (or only the part
+   * used for similarity).
+   */
+  void fingerprint_clip_in_background (const AudioClip &clip, bool exact);
+
 public:
   /**
    * Audio clips.
@@ -172,6 +385,42 @@ public:
    * @brief Owner engine.
    */
   AudioEngine * engine_ = nullptr;
+
+private:
+  /** Clips waiting to be loaded by start_init_loaded(), in order. */
+  std::deque<AudioClip *> pending_clips_;
+
+  /** Errors of the clips that failed to load, by clip. */
+  std::unordered_map<const AudioClip *, std::string> failed_clips_;
+
+  /** Protects @ref pending_clips_ and @ref failed_clips_. */
+  std::mutex loading_mutex_;
+
+  /** Notified when a clip is loaded (or failed to load). */
+  std::condition_variable clip_loaded_cv_;
+
+  /**
+   * Fingerprints of the clips, by pool ID (versioned by the clip
+   * generations).
+   *
+   * Shared with the background jobs computing them.
+   */
+  std::shared_ptr<zrythm::utils::audio::AudioFingerprintIndex>
+    fingerprint_index_ =
+      std::make_shared<zrythm::utils::audio::AudioFingerprintIndex> ();
+
+  /**
+   * Generation of each clip when its fingerprint was last computed or
+   * queued, so that unchanged clips are skipped.
+   */
+  std::unordered_map<int, uint64_t> fingerprinted_generations_;
+
+  /**
+   * Loading started by start_init_loaded(), if any.
+   *
+   * Declared last so that it's waited for before the clips are freed.
+   */
+  std::future<void> loading_;
 };
 
 /**
@@ -11,6 +11,7 @@
 #include "gui/dsp/midi_port.h"
 #include "gui/dsp/port.h"
 #include "gui/dsp/rtmidi_device.h"
+#include "utils/aligned_buffer_arena.h"
 #include "utils/dsp.h"
 #include "utils/hash.h"
 #include "utils/rt_thread_id.h"
@@ -61,12 +62,55 @@ Port::is_exposed_to_backend () const
          && ((backend_ && backend_->is_exposed ()) || id_->owner_type_ == PortIdentifier::OwnerType::AudioEngine || exposed_to_backend_);
 }
 
+void
+Port::unsubscribe_from_ring_buffers ()
+{
+  [[maybe_unused]] const auto prev =
+    num_ring_buffer_subscribers_.fetch_sub (1, std::memory_order_relaxed);
+  z_warn_if_fail (prev > 0);
+}
+
+size_t
+Port::get_memory_usage () const
+{
+  size_t ret = own_buf_.size () * sizeof (float);
+  if (audio_ring_)
+    {
+      ret += audio_ring_->capacity () * sizeof (float);
+    }
+  return ret;
+}
+
 bool
 Port::needs_external_buffer_clear_on_early_return () const
 {
   return id_->flow_ == dsp::PortFlow::Output && is_exposed_to_backend ();
 }
 
+bool
+Port::can_render_ahead () const
+{
+  if (
+    is_exposed_to_backend ()
+    || ENUM_BITSET_TEST (id_->flags_, PortIdentifier::Flags::ManualPress))
+    return false;
+
+  switch (id_->owner_type_)
+    {
+    case PortIdentifier::OwnerType::AudioEngine:
+    case PortIdentifier::OwnerType::HardwareProcessor:
+    case PortIdentifier::OwnerType::Transport:
+      return false;
+    default:
+      break;
+    }
+
+  /* inputs that receive data from the backend directly (e.g., when
+   * recording) */
+  return !is_input () || owner_ == nullptr
+         || !owner_->should_sum_data_from_backend ();
+}
+
 void
 Port::process_block (EngineProcessTimeInfo time_nfo)
 {
@@ -185,6 +229,17 @@ Port::copy_members_from (const Port &other, ObjectCloneType clone_type)
   range_ = other.range_;
 }
 
+void
+Port::ensure_buffer_size (size_t size)
+{
+  if (own_buf_.size () == size)
+    return;
+
+  utils::AlignedBufferArena buf;
+  buf.allocate (1, size);
+  set_buffer (buf.get_slice (0), buf.get_storage ());
+}
+
 void
 Port::set_expose_to_backend (AudioEngine &engine, bool expose)
 {
@@ -214,6 +269,16 @@ Port::set_expose_to_backend (AudioEngine &engine, bool expose)
             }
           break;
 #endif
+#if HAVE_PIPEWIRE
+        case AudioBackend::AUDIO_BACKEND_PIPEWIRE:
+          if (
+            !backend_
+            || (dynamic_cast<PipeWirePortBackend *> (backend_.get ()) == nullptr))
+            {
+              backend_ = std::make_unique<PipeWirePortBackend> (engine.pw_client_);
+            }
+          break;
+#endif
 #if HAVE_RTAUDIO
         case AudioBackend::AUDIO_BACKEND_ALSA_RTAUDIO:
         case AudioBackend::AUDIO_BACKEND_JACK_RTAUDIO:
@@ -283,6 +348,16 @@ Port::set_expose_to_backend (AudioEngine &engine, bool expose)
             }
           break;
 #endif
+#if HAVE_PIPEWIRE
+        case MidiBackend::MIDI_BACKEND_PIPEWIRE:
+          if (
+            !backend_
+            || (dynamic_cast<PipeWirePortBackend *> (backend_.get ()) == nullptr))
+            {
+              backend_ = std::make_unique<PipeWirePortBackend> (engine.pw_client_);
+            }
+          break;
+#endif
 #if HAVE_RTMIDI
         case MidiBackend::MIDI_BACKEND_ALSA_RTMIDI:
         case MidiBackend::MIDI_BACKEND_JACK_RTMIDI:
@@ -319,6 +394,9 @@ Port::set_expose_to_backend (AudioEngine &engine, bool expose)
       else
         {
           backend_->unexpose ();
+
+          /* the buffer may point to the backend's buffer */
+          buf_ = own_buf_;
         }
       exposed_to_backend_ = expose;
     }
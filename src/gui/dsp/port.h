@@ -131,6 +131,18 @@ public:
     return false;
   }
 
+  /**
+   * @brief Returns the stereo buffer to add the port's data to instead of the
+   * master track output when should_bounce_to_master() is true, or nullptr
+   * to add it to the master output.
+   *
+   * See Track::bounce_tap_.
+   */
+  virtual utils::audio::AudioBuffer * get_bounce_tap () const
+  {
+    return nullptr;
+  }
+
   /**
    * @brief Returns whether MIDI events on this channel on an input port should
    * be processed (not ignored).
@@ -210,6 +222,22 @@ public:
    */
   virtual void allocate_bufs () = 0;
 
+  /**
+   * @brief Makes @p buf (kept alive by @p storage) the port's own buffer.
+   */
+  void set_buffer (std::span<float> buf, std::shared_ptr<float[]> storage)
+  {
+    buf_ = buf;
+    own_buf_ = buf;
+    buf_storage_ = std::move (storage);
+  }
+
+  /**
+   * @brief Returns whether @ref buf_ currently points to another port's
+   * buffer.
+   */
+  bool is_buffer_aliased () const { return buf_.data () != own_buf_.data (); }
+
   std::string get_node_name () const override
   {
     return get_full_designation ();
@@ -219,9 +247,51 @@ public:
 
   [[gnu::hot]] void process_block (EngineProcessTimeInfo time_nfo) override;
 
+  /**
+   * Ports exposed to the backend, hardware, engine and transport ports and
+   * MIDI ports fed by manual presses are processed live.
+   */
+  bool can_render_ahead () const override;
+
+  void set_rendered_ahead (bool rendered_ahead) override
+  {
+    rendered_ahead_.store (rendered_ahead, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns whether the port is processed by the anticipative renderer
+   * (see dsp::AnticipativeRenderer), in which case clear_buffer() does nothing.
+   */
+  bool is_rendered_ahead () const
+  {
+    return rendered_ahead_.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Registers a UI consumer (e.g., a meter) of the ring buffers below.
+   *
+   * The ring buffers are only written to while they have at least one
+   * subscriber, so each call must be matched by a call to
+   * unsubscribe_from_ring_buffers().
+   */
+  void subscribe_to_ring_buffers ()
+  {
+    num_ring_buffer_subscribers_.fetch_add (1, std::memory_order_relaxed);
+  }
+
+  void unsubscribe_from_ring_buffers ();
+
+  bool has_ring_buffer_subscribers () const
+  {
+    return num_ring_buffer_subscribers_.load (std::memory_order_relaxed) > 0;
+  }
+
   /**
    * Clears the port buffer.
    *
+   * Does nothing if the port is rendered ahead, since the realtime threads
+   * would clear what the anticipative renderer is writing.
+   *
    * @note Only the Zrythm buffer is cleared. Use port_clear_external_buffer()
    * to clear backend buffers.
    */
@@ -233,6 +303,12 @@ public:
    */
   virtual bool has_sound () const { return false; };
 
+  /**
+   * @brief Returns the approximate number of bytes used by the port's
+   * buffers.
+   */
+  virtual size_t get_memory_usage () const;
+
   /**
    * Gets a full designation of the port in the format "Track/Port" or
    * "Track/Plugin/Port".
@@ -339,6 +415,12 @@ protected:
 
   void copy_members_from (const Port &other, ObjectCloneType clone_type);
 
+  /**
+   * @brief Points @ref buf_ to a new buffer of its own of @p size samples,
+   * unless it already has that size.
+   */
+  void ensure_buffer_size (size_t size);
+
   DECLARE_DEFINE_BASE_FIELDS_METHOD ();
 
   int get_num_unlocked (bool sources) const;
@@ -392,23 +474,42 @@ public:
   /** Port undergoing deletion. */
   bool deleting_ = false;
 
+  /** See is_rendered_ahead(). */
+  std::atomic<bool> rendered_ahead_ = false;
+
   /**
-   * Flag to indicate if the ring buffers below should be filled or not.
+   * Number of UI consumers of the ring buffers below.
    *
-   * If a UI element that needs them becomes mapped
-   * (visible), this should be set to true, and when unmapped
-   * (invisible) it should be set to false.
+   * The ring buffers are only filled while this is non-zero (see
+   * subscribe_to_ring_buffers()).
    */
-  bool write_ring_buffers_ = false;
+  std::atomic<int> num_ring_buffer_subscribers_ = 0;
 
   /**
    * Buffer to be reallocated every time the buffer size changes.
    *
    * The buffer size is AUDIO_ENGINE->block_length_.
    *
+   * Points into the engine's port buffer arena for ports in the graph (see
+   * AudioEngine::rebuild_port_buffer_arena()), or into a buffer of its own
+   * until the arena is rebuilt.
+   *
+   * Audio ports may also point it to the buffer of their only source or to
+   * their backend's buffer during a cycle instead of copying it (see
+   * AudioPort::process()).
+   *
    * Used only by CV and Audio ports.
    */
-  std::vector<float> buf_;
+  std::span<float> buf_;
+
+  /**
+   * @brief The buffer owned by this port (what @ref buf_ points to unless it
+   * aliases another port's buffer).
+   */
+  std::span<float> own_buf_;
+
+  /** Keeps the memory @ref own_buf_ points into alive. */
+  std::shared_ptr<float[]> buf_storage_;
 
   /**
    * Ring buffer for saving the contents of the audio buffer to be used in the
@@ -419,9 +520,12 @@ public:
    *
    * This is also used for CV.
    *
+   * Shared so that the MeteringService can keep draining it while the port
+   * is being destroyed.
+   *
    * FIXME should be moved to a class inherited by AudioPort and CVPort.
    */
-  std::unique_ptr<RingBuffer<float>> audio_ring_;
+  std::shared_ptr<RingBuffer<float>> audio_ring_;
 
   /** Last allocated buffer size (used for audio ports). */
   size_t last_buf_sz_ = 0;
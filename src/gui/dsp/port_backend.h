@@ -91,6 +91,21 @@ public:
   virtual void clear_backend_buffer (dsp::PortType type, nframes_t nframes) = 0;
 
   virtual bool is_exposed () const = 0;
+
+  /**
+   * @brief Returns the backend's audio buffer for the current cycle, if the
+   * port may use it directly as its own buffer instead of copying from/to it
+   * with sum_data()/send_data().
+   *
+   * Input buffers returned must be treated as read-only.
+   *
+   * @param nframes Number of frames in the cycle.
+   * @return The buffer, or nullptr if not supported.
+   */
+  virtual float * get_audio_buffer_for_cycle (nframes_t nframes)
+  {
+    return nullptr;
+  }
 };
 
 #if HAVE_JACK
@@ -242,6 +257,11 @@ public:
       }
   }
 
+  float * get_audio_buffer_for_cycle (nframes_t nframes) override
+  {
+    return static_cast<float *> (jack_port_get_buffer (port_, nframes));
+  }
+
   jack_port_t * get_jack_port () const { return port_; }
 
   /**
@@ -268,6 +288,60 @@ private:
 };
 #endif
 
+#if HAVE_PIPEWIRE
+class PipeWireClient;
+
+/**
+ * @brief Port of the engine's PipeWire filter node (see PipeWireClient).
+ */
+class PipeWirePortBackend : public PortBackend
+{
+public:
+  PipeWirePortBackend (std::shared_ptr<PipeWireClient> client)
+      : client_ (std::move (client))
+  {
+  }
+  ~PipeWirePortBackend () override;
+
+  void sum_data (float * buf, FrameRange range) override;
+  void sum_data (
+    MidiEvents               &midi_events,
+    FrameRange                range,
+    IsMidiChannelAcceptedFunc approve_func) override;
+  void send_data (const float * buf, FrameRange range) override;
+  void send_data (const MidiEvents &midi_events, FrameRange range) override;
+
+  void expose (
+    const dsp::PortIdentifier &id,
+    PortDesignationProvider    designation_provider) override;
+  void unexpose () override;
+  bool is_exposed () const override { return port_data_ != nullptr; }
+
+  void clear_backend_buffer (dsp::PortType type, nframes_t nframes) override;
+
+  float * get_audio_buffer_for_cycle (nframes_t nframes) override;
+
+private:
+  /**
+   * @brief Returns this cycle's MIDI output buffer, starting an empty event
+   * sequence in it if this is the first call in the cycle.
+   */
+  void * get_midi_output_buffer ();
+
+private:
+  std::shared_ptr<PipeWireClient> client_;
+
+  /** Port data returned by pw_filter_add_port(). */
+  void * port_data_ = nullptr;
+
+  /** Cycle (see PipeWireClient::cycle_) of the current MIDI output sequence. */
+  uint64_t midi_out_cycle_ = 0;
+
+  /** Size of the current MIDI output sequence in bytes. */
+  uint32_t midi_out_size_ = 0;
+};
+#endif
+
 #if HAVE_RTMIDI
 class RtMidiPortBackend : public PortBackend
 {
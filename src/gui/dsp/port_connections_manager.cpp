@@ -48,23 +48,25 @@ PortConnectionsManager::disconnect_port_collection (
 }
 
 void
-PortConnectionsManager::add_or_replace_connection (
-  ConnectionHashTable  &ht,
-  const PortUuid       &id,
-  const PortConnection &conn)
+PortConnectionsManager::add_to_hashtables (PortConnection * conn)
 {
-  auto   it = ht.find (id);
-  auto * clone_conn = conn.clone_raw_ptr ();
-  clone_conn->setParent (this);
-  if (it != ht.end ())
-    {
-      z_return_if_fail (it->first == id);
-      it->second.push_back (clone_conn);
-    }
-  else
-    {
-      ht.emplace (id, ConnectionsVector{ clone_conn });
-    }
+  src_ht_[conn->src_id_].push_back (conn);
+  dest_ht_[conn->dest_id_].push_back (conn);
+}
+
+void
+PortConnectionsManager::remove_from_hashtables (const PortConnection * conn)
+{
+  const auto remove_from_ht = [conn] (ConnectionHashTable &ht, const auto &id) {
+    auto it = ht.find (id);
+    z_return_if_fail (it != ht.end ());
+    auto &conns = it->second;
+    std::erase (conns, conn);
+    if (conns.empty ())
+      ht.erase (it);
+  };
+  remove_from_ht (src_ht_, conn->src_id_);
+  remove_from_ht (dest_ht_, conn->dest_id_);
 }
 
 bool
@@ -78,11 +80,12 @@ PortConnectionsManager::replace_connection (
       z_return_val_if_reached (false);
     }
 
+  remove_from_hashtables (*it);
   (*it)->setParent (nullptr);
   (*it)->deleteLater ();
   *it = after.clone_raw_ptr ();
   (*it)->setParent (this);
-  regenerate_hashtables ();
+  add_to_hashtables (*it);
 
   return true;
 }
@@ -93,10 +96,9 @@ PortConnectionsManager::regenerate_hashtables ()
   src_ht_.clear ();
   dest_ht_.clear ();
 
-  for (auto &conn : connections_)
+  for (auto * conn : connections_)
     {
-      add_or_replace_connection (src_ht_, conn->src_id_, *conn);
-      add_or_replace_connection (dest_ht_, conn->dest_id_, *conn);
+      add_to_hashtables (conn);
     }
 
 #if 0
@@ -221,11 +223,15 @@ PortConnectionsManager::find_connection (
   const PortUuid &src,
   const PortUuid &dest) const
 {
-  auto it = std::find_if (
-    connections_.begin (), connections_.end (), [&] (const auto &conn) {
-      return conn->src_id_ == src && conn->dest_id_ == dest;
-    });
-  return it != connections_.end () ? (*it) : nullptr;
+  auto ht_it = src_ht_.find (src);
+  if (ht_it == src_ht_.end ())
+    return nullptr;
+
+  const auto &conns = ht_it->second;
+  auto        it = std::ranges::find_if (conns, [&] (const auto &conn) {
+    return conn->dest_id_ == dest;
+  });
+  return it != conns.end () ? (*it) : nullptr;
 }
 
 const PortConnection *
@@ -238,14 +244,10 @@ PortConnectionsManager::ensure_connect (
 {
   z_warn_if_fail (ZRYTHM_IS_QT_THREAD);
 
-  for (auto &conn : connections_)
+  if (auto * existing_conn = find_connection (src, dest))
     {
-      if (conn->src_id_ == src && conn->dest_id_ == dest)
-        {
-          conn->update (multiplier, locked, enabled);
-          regenerate_hashtables ();
-          return conn;
-        }
+      existing_conn->update (multiplier, locked, enabled);
+      return existing_conn;
     }
 
   connections_.push_back (
@@ -259,25 +261,25 @@ PortConnectionsManager::ensure_connect (
         connections_.size ());
     }
 
-  regenerate_hashtables ();
+  add_to_hashtables (conn);
 
   return conn;
 }
 
 void
-PortConnectionsManager::remove_connection (const size_t idx)
+PortConnectionsManager::remove_connection (PortConnection * conn)
 {
-  const auto conn = connections_[idx];
+  auto it = std::ranges::find (connections_, conn);
+  z_return_if_fail (it != connections_.end ());
 
-  connections_.erase (connections_.begin () + idx);
+  remove_from_hashtables (conn);
+  connections_.erase (it);
 
   if (this == get_active_instance ())
     {
       z_debug (
         "Disconnected <{}>; have {} connections", *conn, connections_.size ());
     }
-
-  regenerate_hashtables ();
 }
 
 bool
@@ -287,17 +289,12 @@ PortConnectionsManager::ensure_disconnect (
 {
   z_return_val_if_fail (ZRYTHM_IS_QT_THREAD, false);
 
-  for (size_t i = 0; i < connections_.size (); i++)
-    {
-      const auto &conn = connections_[i];
-      if (conn->src_id_ == src && conn->dest_id_ == dest)
-        {
-          remove_connection (i);
-          return true;
-        }
-    }
+  auto * conn = find_connection (src, dest);
+  if (conn == nullptr)
+    return false;
 
-  return false;
+  remove_connection (conn);
+  return true;
 }
 
 void
@@ -305,14 +302,20 @@ PortConnectionsManager::ensure_disconnect_all (const PortUuid &pi)
 {
   z_return_if_fail (ZRYTHM_IS_QT_THREAD);
 
-  for (size_t i = 0; i < connections_.size (); i++)
+  /* copy the indexed connections since removing them modifies the index */
+  ConnectionsVector conns;
+  get_dests (&conns, pi);
+  if (auto it = dest_ht_.find (pi); it != dest_ht_.end ())
     {
-      const auto &conn = connections_[i];
-      if (conn->src_id_ == pi || conn->dest_id_ == pi)
-        {
-          remove_connection (i);
-          i--;
-        }
+      /* skip connections from the port to itself (already added) */
+      std::ranges::copy_if (
+        it->second, std::back_inserter (conns),
+        [&pi] (const auto &conn) { return conn->src_id_ != pi; });
+    }
+
+  for (auto * conn : conns)
+    {
+      remove_connection (conn);
     }
 }
 bool
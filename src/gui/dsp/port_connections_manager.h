@@ -53,7 +53,9 @@ public:
   /**
    * Regenerates the hash tables.
    *
-   * Must be called when a change is made in the connections.
+   * The mutating methods of this class keep the hash tables up to date, so
+   * this only needs to be called after @ref connections_ is modified
+   * directly (e.g., when deserializing).
    */
   void regenerate_hashtables ();
 
@@ -205,14 +207,24 @@ public:
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 private:
-  void add_or_replace_connection (
-    ConnectionHashTable  &ht,
-    const PortUuid       &id,
-    const PortConnection &conn);
+  /**
+   * Adds @p conn (owned by @ref connections_) to the hash tables.
+   */
+  void add_to_hashtables (PortConnection * conn);
 
-  void remove_connection (size_t idx);
+  void remove_from_hashtables (const PortConnection * conn);
 
-  void clear_connections () { connections_.clear (); }
+  /**
+   * Removes the given connection (owned by @ref connections_) from this.
+   */
+  void remove_connection (PortConnection * conn);
+
+  void clear_connections ()
+  {
+    connections_.clear ();
+    src_ht_.clear ();
+    dest_ht_.clear ();
+  }
 
 public:
   /** Connections (owned pointers). */
@@ -222,7 +234,8 @@ public:
    * Hashtable to speedup lookup by source port identifier.
    *
    * Key: Port identifier
-   * Value: A reference to a PortConnection from @ref connections_.
+   * Value: References to the PortConnection's from @ref connections_ with
+   * this source.
    */
   ConnectionHashTable src_ht_;
 
@@ -230,7 +243,8 @@ public:
    * Hashtable to speedup lookup by destination port identifier.
    *
    * Key: Destination port identifier
-   * Value: A reference to a PortConnection from @ref connections_.
+   * Value: References to the PortConnection's from @ref connections_ with
+   * this destination.
    */
   ConnectionHashTable dest_ht_;
 };
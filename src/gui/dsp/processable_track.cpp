@@ -9,6 +9,7 @@
 #include "gui/dsp/engine.h"
 #include "gui/dsp/laned_track.h"
 #include "gui/dsp/processable_track.h"
+#include "gui/dsp/recordable_track.h"
 #include "gui/dsp/track_processor.h"
 #include "gui/dsp/transport.h"
 
@@ -65,6 +66,30 @@ ProcessableTrack::process_block (EngineProcessTimeInfo time_nfo)
   processor_->process (time_nfo);
 }
 
+bool
+ProcessableTrack::can_render_ahead () const
+{
+  if (is_auditioner ())
+    return false;
+
+  if (
+    const auto * recordable_track =
+      dynamic_cast<const RecordableTrack *> (this))
+    {
+      if (recordable_track->get_recording ())
+        return false;
+    }
+
+  if (in_signal_type_ == PortType::Event && CLIP_EDITOR->has_region ())
+    {
+      const auto clip_editor_track_id = CLIP_EDITOR->get_track_id ();
+      if (clip_editor_track_id && *clip_editor_track_id == get_uuid ())
+        return false;
+    }
+
+  return true;
+}
+
 bool
 ProcessableTrack::get_monitor_audio () const
 {
@@ -117,6 +142,13 @@ ProcessableTrack::fill_events_common (
 
   const bool use_caches = !is_auditioner ();
 
+  /* events queued earlier are normally sorted already (see
+   * MidiEventVector::merge()) */
+  if (midi_events && !midi_events->is_sorted ()) [[unlikely]]
+    {
+      midi_events->sort ();
+    }
+
   std::visit (
     [&] (auto &&track) {
       using TrackT = base_type<decltype (track)>;
@@ -214,15 +246,24 @@ ProcessableTrack::fill_events_common (
             if constexpr (RegionTypeWithMidiEvents<RegionT>)
               {
                 z_return_if_fail (midi_events);
+                region_midi_events_.clear ();
                 r.fill_midi_events (
                   nfo, need_note_off,
                   !is_transport_end && (is_loop_end || is_region_end),
-                  *midi_events);
+                  region_midi_events_);
+
+                /* a region's events are few and nearly sorted, so sort them
+                 * on their own and merge them into the (sorted) track events
+                 * instead of sorting everything */
+                region_midi_events_.sort ();
+                midi_events->merge (
+                  region_midi_events_, nfo.local_offset_, nfo.nframes_);
               }
             else if constexpr (std::is_same_v<RegionT, AudioRegion>)
               {
                 z_return_if_fail (stereo_ports);
-                r.fill_stereo_ports (nfo, *stereo_ports);
+                r.fill_stereo_ports (
+                  nfo, *stereo_ports, track->region_scratch_bufs_);
               }
             else
               {
@@ -234,16 +275,20 @@ ProcessableTrack::fill_events_common (
           } /* end while frames left */
       };
 
+      /* regions that may be hit by this cycle (the snapshots are indexed
+       * by position, so the others aren't visited) */
+      const auto snapshots_from =
+        (signed_frame_t) time_nfo.g_start_frame_w_offset_;
+      const auto snapshots_to = (signed_frame_t) g_end_frames;
+
       /* go through each region collection (either each lane or the chord track)
        */
       if constexpr (std::is_same_v<TrackT, ChordTrack>)
         {
           if (use_caches)
             {
-              for (auto &region : track->region_snapshots_)
-                {
-                  process_single_region (*region);
-                }
+              track->foreach_region_snapshot_in (
+                snapshots_from, snapshots_to, process_single_region);
             }
           else
             {
@@ -259,10 +304,8 @@ ProcessableTrack::fill_events_common (
             {
               for (auto &lane : track->lane_snapshots_)
                 {
-                  for (auto &region : lane->region_snapshots_)
-                    {
-                      process_single_region (*region);
-                    }
+                  lane->foreach_region_snapshot_in (
+                    snapshots_from, snapshots_to, process_single_region);
                 }
             }
           else
@@ -287,11 +330,6 @@ ProcessableTrack::fill_events_common (
 
       if (midi_events)
         {
-          midi_events->clear_duplicates ();
-
-          /* sort events */
-          midi_events->sort ();
-
 #if 0
       if (midi_events_has_any (midi_events, F_QUEUED))
         {
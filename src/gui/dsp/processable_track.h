@@ -5,6 +5,7 @@
 #define __AUDIO_PROCESSABLE_TRACK_H__
 
 #include "gui/dsp/automatable_track.h"
+#include "gui/dsp/midi_event.h"
 #include "gui/dsp/track_processor.h"
 
 class TrackProcessor;
@@ -55,6 +56,12 @@ public:
 
   void process_block (EngineProcessTimeInfo time_nfo) override;
 
+  /**
+   * Tracks can be rendered ahead unless they are auditioned, recording, or
+   * get live MIDI from the piano roll (when they are the clip editor's track).
+   */
+  bool can_render_ahead () const override;
+
 protected:
   /**
    * Common logic for audio and MIDI/instrument tracks to fill in MidiEvents or
@@ -89,6 +96,16 @@ public:
 
 protected:
   PortRegistry &port_registry_;
+
+private:
+  /**
+   * @brief Scratch buffer for the events of a single region, which are then
+   * merged into the track's events (see fill_events_common()).
+   *
+   * A track is only processed by one thread at a time, so its regions can
+   * share it.
+   */
+  mutable MidiEventVector region_midi_events_{ true };
 };
 
 using ProcessableTrackVariant = std::variant<
@@ -4,6 +4,7 @@
 #include "dsp/graph.h"
 #include "gui/backend/backend/project.h"
 #include "gui/dsp/project_graph_builder.h"
+#include "utils/env.h"
 
 using namespace zrythm;
 
@@ -128,6 +129,13 @@ ProjectGraphBuilder::build_graph_impl (dsp::Graph &graph)
         cur_tr);
     }
 
+  /* CV that only modulates control ports is processed at control rate */
+  const auto cv_control_rate_interval = static_cast<nframes_t> (std::max (
+    env_get_int (
+      "ZRYTHM_DSP_CV_CONTROL_RATE_INTERVAL",
+      static_cast<int> (CVPort::DEFAULT_CONTROL_RATE_INTERVAL)),
+    0));
+
   auto add_port =
     [&] (
       auto &graph, PortPtrVariant port_var, PortConnectionsManager &mgr,
@@ -155,6 +163,10 @@ ProjectGraphBuilder::build_graph_impl (dsp::Graph &graph)
               z_return_val_if_fail (port->srcs_.back (), nullptr);
               port->src_connections_.emplace_back (conn->clone_unique ());
             }
+          if constexpr (std::is_same_v<PortT, AudioPort>)
+            {
+              port->update_processing_info ();
+            }
 
           PortConnectionsManager::ConnectionsVector dests;
           mgr.get_sources_or_dests (&dests, port->get_uuid (), false);
@@ -170,6 +182,10 @@ ProjectGraphBuilder::build_graph_impl (dsp::Graph &graph)
               z_return_val_if_fail (port->dests_.back (), nullptr);
               port->dest_connections_.emplace_back (conn->clone_unique ());
             }
+          if constexpr (std::is_same_v<PortT, CVPort>)
+            {
+              port->update_processing_info (cv_control_rate_interval);
+            }
 
           /* skip unnecessary control ports */
           if constexpr (std::is_same_v<PortT, ControlPort>)
@@ -212,6 +228,16 @@ ProjectGraphBuilder::build_graph_impl (dsp::Graph &graph)
           /* allocate buffers to be used during DSP */
           port->allocate_bufs ();
 
+          /* add the partial sums of ports with many sources (connected
+           * below) */
+          if constexpr (std::is_same_v<PortT, AudioPort>)
+            {
+              for (const auto &partial_sum : port->get_partial_sums ())
+                {
+                  add_node_for_processable (*partial_sum);
+                }
+            }
+
           return add_node_for_processable (*port);
         },
         port_var);
@@ -427,38 +453,14 @@ ProjectGraphBuilder::build_graph_impl (dsp::Graph &graph)
 
           if constexpr (std::derived_from<TrackT, PianoRollTrack>)
             {
-              auto track_processor = tr->processor_.get ();
-
-              for (const auto channel_index : std::views::iota (0, 16))
+              std::vector<ControlPort *> midi_automatable_ports;
+              tr->processor_->append_midi_automatable_ports (
+                midi_automatable_ports);
+              for (auto * port : midi_automatable_ports)
                 {
-                  for (const auto cc_index : std::views::iota (0, 128))
-                    {
-                      auto node2 = graph.get_nodes ().find_node_for_processable (
-                        track_processor->get_midi_cc_port (
-                          channel_index, cc_index));
-                      if (node2)
-                        {
-                          node2->connect_to (*track_node);
-                        }
-                    }
-
-                  auto node2 = graph.get_nodes ().find_node_for_processable (
-                    track_processor->get_pitch_bend_port (channel_index));
-                  if (node2 || !drop_unnecessary_ports)
-                    {
-                      node2->connect_to (*track_node);
-                    }
-
-                  node2 = graph.get_nodes ().find_node_for_processable (
-                    track_processor->get_poly_key_pressure_port (channel_index));
-                  if (node2 || !drop_unnecessary_ports)
-                    {
-                      node2->connect_to (*track_node);
-                    }
-
-                  node2 = graph.get_nodes ().find_node_for_processable (
-                    track_processor->get_channel_pressure_port (channel_index));
-                  if (node2 || !drop_unnecessary_ports)
+                  auto node2 =
+                    graph.get_nodes ().find_node_for_processable (*port);
+                  if (node2)
                     {
                       node2->connect_to (*track_node);
                     }
@@ -539,6 +541,7 @@ ProjectGraphBuilder::build_graph_impl (dsp::Graph &graph)
                   auto mmp_node =
                     graph.get_nodes ().find_node_for_processable (*mmp);
                   z_return_if_fail (mmp_node);
+                  mmp->update_processing_info ();
 
                   {
                     auto * const node2 =
@@ -721,21 +724,49 @@ ProjectGraphBuilder::build_graph_impl (dsp::Graph &graph)
         cur_tr);
     }
 
+  /* returns the node through which the signal of src enters dest (its
+   * partial sum, if dest has any) */
+  const auto get_input_node =
+    [&] (const Port &src, Port &dest, dsp::GraphNode * dest_node) {
+      if (dest.is_audio ())
+        {
+          if (
+            auto * partial_sum =
+              static_cast<AudioPort &> (dest).get_partial_sum_for_source (src))
+            {
+              return graph.get_nodes ().find_node_for_processable (
+                *partial_sum);
+            }
+        }
+      return dest_node;
+    };
+
   auto connect_port = [&]<FinalPortSubclass PortT> (PortT &p) {
     auto * node = graph.get_nodes ().find_node_for_processable (p);
+    if constexpr (std::is_same_v<PortT, AudioPort>)
+      {
+        for (const auto &partial_sum : p.get_partial_sums ())
+          {
+            auto * node2 =
+              graph.get_nodes ().find_node_for_processable (*partial_sum);
+            z_warn_if_fail (node);
+            z_warn_if_fail (node2);
+            node2->connect_to (*node);
+          }
+      }
     for (auto &src : p.srcs_)
       {
         auto node2 = graph.get_nodes ().find_node_for_processable (*src);
         z_warn_if_fail (node);
         z_warn_if_fail (node2);
-        node2->connect_to (*node);
+        node2->connect_to (*get_input_node (*src, p, node));
       }
     for (auto &dest : p.dests_)
       {
         auto node2 = graph.get_nodes ().find_node_for_processable (*dest);
         z_warn_if_fail (node);
         z_warn_if_fail (node2);
-        node->connect_to (*node2);
+        node->connect_to (*get_input_node (p, *dest, node2));
       }
   };
 
@@ -758,6 +789,42 @@ ProjectGraphBuilder::build_graph_impl (dsp::Graph &graph)
         convert_to_variant<PortPtrVariant> (port));
     }
 
+  if (bounced_tracks_only_)
+    {
+      /* keep what feeds the master output, which is what gets exported, and
+       * the outputs of the tracks bounced directly to master or to stems */
+      std::vector<dsp::GraphNode *> sinks;
+      const auto add_sink = [&] (const dsp::IProcessable &processable) {
+        auto * node = graph.get_nodes ().find_node_for_processable (processable);
+        if (node)
+          sinks.push_back (node);
+      };
+      iterate_tuple (
+        add_sink,
+        tracklist->get_track_span ()
+          .get_master_track ()
+          .channel_->get_stereo_out_ports ());
+      for (
+        auto * tr :
+        tracklist->get_track_span ()
+          | std::views::filter (
+            TrackSpan::derived_from_type_projection<ChannelTrack>)
+          | std::views::transform (
+            TrackSpan::derived_type_transformation<ChannelTrack>))
+        {
+          if (
+            !tr->bounce_to_master_
+            || tr->out_signal_type_ != dsp::PortType::Audio)
+            continue;
+
+          iterate_tuple (add_sink, tr->channel_->get_stereo_out_ports ());
+          /* the earlier bounce steps are upstream of the prefader */
+          iterate_tuple (
+            add_sink, tr->channel_->prefader_->get_stereo_out_ports ());
+        }
+      graph.get_nodes ().remove_nodes_not_upstream_of (sinks);
+    }
+
   z_debug ("done building graph");
 }
 
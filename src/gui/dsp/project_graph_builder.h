@@ -13,8 +13,12 @@ class Port;
 class ProjectGraphBuilder final : public dsp::IGraphBuilder
 {
 public:
-  ProjectGraphBuilder (Project &project, bool drop_unnecessary_ports)
-      : project_ (project), drop_unnecessary_ports_ (drop_unnecessary_ports)
+  ProjectGraphBuilder (
+    Project &project,
+    bool     drop_unnecessary_ports,
+    bool     bounced_tracks_only = false)
+      : project_ (project), drop_unnecessary_ports_ (drop_unnecessary_ports),
+        bounced_tracks_only_ (bounced_tracks_only)
   {
   }
 
@@ -38,4 +42,13 @@ private:
    * @brief Whether to drop any ports that don't connect anywhere.
    */
   bool drop_unnecessary_ports_{};
+
+  /**
+   * @brief Whether to only keep the nodes needed to render the master output
+   * and the tracks marked with Track::bounce_to_master_.
+   *
+   * Used when bouncing tracks or regions, so that the other tracks are not
+   * processed just to be discarded.
+   */
+  bool bounced_tracks_only_{};
 };
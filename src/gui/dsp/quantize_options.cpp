@@ -11,6 +11,8 @@
 #include "utils/algorithms.h"
 #include "utils/pcg_rand.h"
 
+#include <QtConcurrent>
+
 namespace zrythm::gui::old_dsp
 {
 
@@ -159,4 +161,35 @@ QuantizeOptions::quantize_position (Position * pos)
   return diff;
 }
 
+void
+QuantizeOptions::quantize_notes (
+  std::span<dsp::PackedNotes> notes_per_region) const
+{
+  const auto points =
+    q_points_
+    | std::views::transform ([] (const Position &pos) { return pos.ticks_; })
+    | std::ranges::to<std::vector> ();
+
+  /* one random sequence per region, so that the result doesn't depend on
+   * the scheduling */
+  struct Job
+  {
+    dsp::PackedNotes * notes;
+    uint32_t           seed;
+  };
+  std::vector<Job> jobs;
+  jobs.reserve (notes_per_region.size ());
+  auto rand = PCGRand::getInstance ();
+  for (auto &notes : notes_per_region)
+    {
+      jobs.push_back ({ &notes, rand->u32 () });
+    }
+
+  QtConcurrent::blockingMap (jobs, [&] (const Job &job) {
+    job.notes->quantize (
+      points, static_cast<double> (amount_) / 100.0, adj_start_, adj_end_,
+      rand_ticks_, job.seed);
+  });
+}
+
 }; // namespace zrythm::gui::old_dsp
@@ -4,8 +4,11 @@
 #ifndef __AUDIO_QUANTIZE_OPTIONS_H__
 #define __AUDIO_QUANTIZE_OPTIONS_H__
 
+#include <span>
+
 #include "gui/dsp/snap_grid.h"
 
+#include "dsp/packed_notes.h"
 #include "dsp/position.h"
 
 #define QUANTIZE_OPTIONS_IS_EDITOR(qo) \
@@ -70,6 +73,17 @@ public:
    */
   double quantize_position (Position * pos);
 
+  /**
+   * Quantizes the packed notes of many regions at once (see
+   * ArrangerSelectionsAction::EditNotesAction), in parallel.
+   *
+   * Unlike quantize_position(), this takes into account the adjust_start
+   * and adjust_end options.
+   *
+   * @param notes_per_region Selected notes of each region.
+   */
+  void quantize_notes (std::span<dsp::PackedNotes> notes_per_region) const;
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 private:
@@ -4,7 +4,9 @@
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/dsp/control_port.h"
+#include "gui/dsp/engine.h"
 #include "gui/dsp/recordable_track.h"
+#include "gui/dsp/router.h"
 
 #include "utils/rt_thread_id.h"
 
@@ -41,6 +43,12 @@ RecordableTrack::set_recording (bool recording)
 
   get_recording_port ().set_toggled (recording, false);
 
+  /* recording tracks are processed live */
+  if (AUDIO_ENGINE && ROUTER && !ROUTER->is_processing_thread ())
+    {
+      ROUTER->reassign_rendered_ahead_nodes ();
+    }
+
   if (recording)
     {
       z_info ("enabled recording on {}", name_);
@@ -0,0 +1,291 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <thread>
+
+#include "gui/dsp/recording_disk_writer.h"
+#include "utils/debug.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+namespace fs = std::filesystem;
+
+RecordingDiskWriter::Stream::Stream (
+  std::unique_ptr<juce::AudioFormatWriter> writer,
+  fs::path                                 path,
+  int                                      num_channels,
+  int                                      bytes_per_frame)
+    : writer_ (std::move (writer)), path_ (std::move (path)),
+      num_channels_ (num_channels), bytes_per_frame_ (bytes_per_frame)
+{
+  for (size_t i = 0; i < NUM_PREALLOCATED_BLOCKS; ++i)
+    {
+      auto block = std::make_unique<Block> ();
+      block->buf_.setSize (num_channels_, BLOCK_FRAMES);
+      if (i == 0)
+        current_block_ = block.get ();
+      else
+        free_blocks_.write (block.get ());
+      blocks_.push_back (std::move (block));
+    }
+}
+
+RecordingDiskWriter::Stream::Block &
+RecordingDiskWriter::Stream::get_free_block (RecordingDiskWriter &disk_writer)
+{
+  Block * block = nullptr;
+  if (!free_blocks_.read (block))
+    {
+      auto new_block = std::make_unique<Block> ();
+      new_block->buf_.setSize (num_channels_, BLOCK_FRAMES);
+      block = new_block.get ();
+      blocks_.push_back (std::move (new_block));
+      disk_writer.num_extra_blocks_.fetch_add (1, std::memory_order_relaxed);
+    }
+  block->num_frames_ = 0;
+  return *block;
+}
+
+RecordingDiskWriter::RecordingDiskWriter ()
+    : juce::Thread ("RecordingDiskWriter")
+{
+}
+
+RecordingDiskWriter::~RecordingDiskWriter ()
+{
+  stopThread (-1);
+}
+
+std::shared_ptr<RecordingDiskWriter::Stream>
+RecordingDiskWriter::open_stream (
+  const fs::path        &path,
+  sample_rate_t          sample_rate,
+  int                    num_channels,
+  utils::audio::BitDepth bit_depth)
+{
+  juce::File file (path.string ());
+  auto       out_stream =
+    std::make_unique<juce::FileOutputStream> (file, FILE_BUFFER_SIZE);
+  if (!out_stream->openedOk () || !out_stream->setPosition (0))
+    {
+      throw ZrythmException (
+        fmt::format ("Failed to open file '{}' for writing", path.string ()));
+    }
+  out_stream->truncate ();
+
+  juce::WavAudioFormat format;
+  const int            bits = utils::audio::bit_depth_enum_to_int (bit_depth);
+  auto                 writer = std::unique_ptr<juce::AudioFormatWriter> (
+    format.createWriterFor (
+      out_stream.get (), sample_rate, num_channels, bits, {}, 0));
+  if (!writer)
+    {
+      throw ZrythmException (
+        fmt::format (
+          "Failed to create audio writer for file '{}'", path.string ()));
+    }
+
+  /* the writer owns the stream now */
+  out_stream.release ();
+
+  auto stream = std::make_shared<Stream> (
+    std::move (writer), path, num_channels, num_channels * bits / 8);
+  {
+    const std::lock_guard lock (streams_mutex_);
+    streams_.push_back (stream);
+  }
+
+  if (!isThreadRunning ())
+    {
+      startThread (juce::Thread::Priority::normal);
+    }
+
+  z_debug ("opened recording stream for '{}'", path.string ());
+  return stream;
+}
+
+void
+RecordingDiskWriter::append (
+  Stream                          &stream,
+  const utils::audio::AudioBuffer &frames)
+{
+  z_return_if_fail (!stream.closing_.load ());
+  z_return_if_fail (frames.getNumChannels () == stream.num_channels_);
+
+  const int num_frames = frames.getNumSamples ();
+  int       frames_done = 0;
+  while (frames_done < num_frames)
+    {
+      auto     &block = *stream.current_block_;
+      const int num_frames_to_copy =
+        std::min (num_frames - frames_done, BLOCK_FRAMES - block.num_frames_);
+      for (int i = 0; i < stream.num_channels_; ++i)
+        {
+          block.buf_.copyFrom (
+            i, block.num_frames_, frames, i, frames_done, num_frames_to_copy);
+        }
+      block.num_frames_ += num_frames_to_copy;
+      frames_done += num_frames_to_copy;
+
+      if (block.num_frames_ == BLOCK_FRAMES)
+        {
+          queue_current_block (stream);
+          stream.current_block_ = &stream.get_free_block (*this);
+        }
+    }
+}
+
+void
+RecordingDiskWriter::queue_current_block (Stream &stream)
+{
+  auto * block = stream.current_block_;
+  if (block->num_frames_ == 0)
+    return;
+
+  /* count the frames before queuing so that the writer can't subtract them
+   * first */
+  const uint64_t backlog =
+    backlog_frames_.fetch_add (block->num_frames_) + block->num_frames_;
+  uint64_t max_backlog = max_backlog_frames_.load ();
+  while (
+    backlog > max_backlog
+    && !max_backlog_frames_.compare_exchange_weak (max_backlog, backlog))
+    {
+    }
+
+  while (!stream.full_blocks_.write (block))
+    {
+      /* the writer is far behind - wait instead of dropping audio */
+      notify ();
+      std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+  notify ();
+}
+
+void
+RecordingDiskWriter::close_stream (Stream &stream)
+{
+  z_return_if_fail (!stream.closing_.load ());
+
+  queue_current_block (stream);
+  stream.current_block_ = nullptr;
+  stream.closing_.store (true, std::memory_order_release);
+  notify ();
+
+  /* rethrows the writer thread's exception, if any */
+  stream.closed_.get_future ().get ();
+  z_debug ("closed recording stream for '{}'", stream.path_.string ());
+}
+
+bool
+RecordingDiskWriter::write_queued_blocks (Stream &stream)
+{
+  /* check before draining, so that the last block is written before
+   * closing */
+  const bool closing = stream.closing_.load (std::memory_order_acquire);
+
+  Stream::Block * block = nullptr;
+  while (stream.full_blocks_.read (block))
+    {
+      if (
+        stream.writer_
+        && !stream.writer_->writeFromAudioSampleBuffer (
+          block->buf_, 0, block->num_frames_))
+        {
+          stream.error_ = fmt::format (
+            "Failed to write to file '{}'", stream.path_.string ());
+          z_warning ("{}", stream.error_);
+          stream.writer_.reset ();
+        }
+      bytes_written_.fetch_add (
+        static_cast<uint64_t> (block->num_frames_) * stream.bytes_per_frame_,
+        std::memory_order_relaxed);
+      backlog_frames_.fetch_sub (block->num_frames_);
+      stream.free_blocks_.write (block);
+    }
+
+  if (!closing)
+    return false;
+
+  /* finalizes the file's header */
+  stream.writer_.reset ();
+  if (stream.error_.empty ())
+    {
+      stream.closed_.set_value ();
+    }
+  else
+    {
+      stream.closed_.set_exception (
+        std::make_exception_ptr (ZrythmException (stream.error_)));
+    }
+  return true;
+}
+
+void
+RecordingDiskWriter::update_throughput ()
+{
+  const auto now = juce::Time::currentTimeMillis ();
+  const auto bytes_written = bytes_written_.load (std::memory_order_relaxed);
+  if (prev_stats_time_ms_ == 0)
+    {
+      prev_stats_time_ms_ = now;
+      prev_bytes_written_ = bytes_written;
+      return;
+    }
+
+  const auto elapsed_ms = now - prev_stats_time_ms_;
+  if (elapsed_ms < STATS_INTERVAL_MS)
+    return;
+
+  throughput_.store (
+    static_cast<double> (bytes_written - prev_bytes_written_) * 1000.0
+      / static_cast<double> (elapsed_ms),
+    std::memory_order_relaxed);
+  prev_stats_time_ms_ = now;
+  prev_bytes_written_ = bytes_written;
+}
+
+RecordingDiskWriter::Stats
+RecordingDiskWriter::get_stats () const
+{
+  return {
+    .bytes_written_ = bytes_written_.load (std::memory_order_relaxed),
+    .throughput_ = throughput_.load (std::memory_order_relaxed),
+    .backlog_frames_ = backlog_frames_.load (std::memory_order_relaxed),
+    .max_backlog_frames_ = max_backlog_frames_.load (std::memory_order_relaxed),
+    .num_extra_blocks_ = num_extra_blocks_.load (std::memory_order_relaxed),
+  };
+}
+
+void
+RecordingDiskWriter::run ()
+{
+  while (!threadShouldExit ())
+    {
+      {
+        const std::lock_guard lock (streams_mutex_);
+        streams_to_write_ = streams_;
+      }
+
+      for (const auto &stream : streams_to_write_)
+        {
+          if (write_queued_blocks (*stream))
+            {
+              const std::lock_guard lock (streams_mutex_);
+              std::erase (streams_, stream);
+            }
+        }
+      streams_to_write_.clear ();
+
+      update_throughput ();
+      wait (STATS_INTERVAL_MS);
+    }
+
+  /* write what is left of the streams that were not closed */
+  const std::lock_guard lock (streams_mutex_);
+  for (const auto &stream : streams_)
+    {
+      write_queued_blocks (*stream);
+      stream->writer_.reset ();
+    }
+}
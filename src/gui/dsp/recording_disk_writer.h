@@ -0,0 +1,217 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "utils/audio.h"
+#include "utils/ring_buffer.h"
+#include "utils/types.h"
+
+#include "juce_wrapper.h"
+
+/**
+ * @addtogroup dsp
+ *
+ * @{
+ */
+
+/**
+ * @brief Writes recorded audio to disk on a dedicated thread.
+ *
+ * Each recorded file gets a Stream with its own preallocated blocks. The
+ * recording code copies the recorded frames into the stream's current block
+ * and hands full blocks to the writer thread through a lock-free ring, which
+ * hands them back through another ring once written. Files are written through
+ * a large buffer, so the filesystem sees few large writes, and a slow disk
+ * only grows the backlog instead of stalling the thread that handles the
+ * recording events.
+ *
+ * Files are written as WAV, which is only ever appended to: the sizes in the
+ * header are patched when the stream is closed, and
+ * AudioFile::repair_wav_header() fixes them if that never happened.
+ */
+class RecordingDiskWriter final : public juce::Thread
+{
+public:
+  /** Frames per block. */
+  static constexpr int BLOCK_FRAMES = 32768;
+
+  /** Blocks preallocated for each stream. */
+  static constexpr size_t NUM_PREALLOCATED_BLOCKS = 8;
+
+  /**
+   * Maximum number of blocks waiting to be written for each stream before
+   * appending blocks until the writer catches up.
+   */
+  static constexpr size_t MAX_QUEUED_BLOCKS = 1024;
+
+  /** Size of the buffer files are written through. */
+  static constexpr int FILE_BUFFER_SIZE = 1024 * 1024;
+
+  /** Interval between throughput updates. */
+  static constexpr int STATS_INTERVAL_MS = 1000;
+
+  struct Stats
+  {
+    /** Bytes of audio written since the writer was created. */
+    uint64_t bytes_written_ = 0;
+
+    /** Bytes of audio written per second during the last interval. */
+    double throughput_ = 0.0;
+
+    /** Frames waiting to be written, for all streams. */
+    uint64_t backlog_frames_ = 0;
+
+    /** Highest value of @ref backlog_frames_ so far. */
+    uint64_t max_backlog_frames_ = 0;
+
+    /** Number of blocks allocated because the preallocated ones were all in
+     * use. */
+    uint64_t num_extra_blocks_ = 0;
+  };
+
+  /**
+   * @brief A file being written.
+   */
+  class Stream
+  {
+  public:
+    Stream (
+      std::unique_ptr<juce::AudioFormatWriter> writer,
+      std::filesystem::path                    path,
+      int                                      num_channels,
+      int                                      bytes_per_frame);
+
+    const std::filesystem::path &get_path () const { return path_; }
+
+  private:
+    friend class RecordingDiskWriter;
+
+    struct Block
+    {
+      utils::audio::AudioBuffer buf_;
+      int                       num_frames_ = 0;
+    };
+
+    /**
+     * @brief Returns a block to fill, allocating one if all are in use.
+     */
+    Block &get_free_block (RecordingDiskWriter &disk_writer);
+
+  private:
+    /** Only used by the writer thread (until closed). */
+    std::unique_ptr<juce::AudioFormatWriter> writer_;
+
+    std::filesystem::path path_;
+    int                   num_channels_;
+    int                   bytes_per_frame_;
+
+    /** All blocks (only modified by the producer). */
+    std::vector<std::unique_ptr<Block>> blocks_;
+
+    /** Block currently being filled by the producer. */
+    Block * current_block_ = nullptr;
+
+    /** Blocks to be written (producer to writer). */
+    RingBuffer<Block *> full_blocks_{ MAX_QUEUED_BLOCKS };
+
+    /** Written blocks (writer to producer), large enough for all blocks. */
+    RingBuffer<Block *> free_blocks_{
+      MAX_QUEUED_BLOCKS + NUM_PREALLOCATED_BLOCKS
+    };
+
+    /** Error that occurred while writing (only used by the writer thread). */
+    std::string error_;
+
+    /** Set by the producer after queuing the last block. */
+    std::atomic<bool> closing_ = false;
+
+    /** Fulfilled by the writer thread once the file is closed. */
+    std::promise<void> closed_;
+  };
+
+  RecordingDiskWriter ();
+  ~RecordingDiskWriter () override;
+  Z_DISABLE_COPY_MOVE (RecordingDiskWriter)
+
+  /**
+   * @brief Creates the WAV file at @p path and returns a stream to write to
+   * it.
+   *
+   * @throw ZrythmException If the file could not be created.
+   */
+  std::shared_ptr<Stream> open_stream (
+    const std::filesystem::path &path,
+    sample_rate_t                sample_rate,
+    int                          num_channels,
+    utils::audio::BitDepth       bit_depth);
+
+  /**
+   * @brief Queues @p frames to be appended to the stream's file.
+   *
+   * Only blocks if the writer is so far behind that @ref MAX_QUEUED_BLOCKS
+   * blocks are waiting to be written.
+   */
+  void append (Stream &stream, const utils::audio::AudioBuffer &frames);
+
+  /**
+   * @brief Writes the remaining frames, closes the file and waits for it to
+   * be closed.
+   *
+   * @throw ZrythmException If writing to the file failed.
+   */
+  void close_stream (Stream &stream);
+
+  /**
+   * @brief Returns the statistics (can be called from any thread).
+   */
+  Stats get_stats () const;
+
+  void run () override;
+
+private:
+  /**
+   * @brief Queues the stream's current block if it contains frames.
+   */
+  void queue_current_block (Stream &stream);
+
+  /**
+   * @brief Writes the queued blocks of @p stream.
+   *
+   * @return Whether the stream was closed.
+   */
+  bool write_queued_blocks (Stream &stream);
+
+  void update_throughput ();
+
+private:
+  /** Protects @ref streams_. */
+  std::mutex streams_mutex_;
+
+  std::vector<std::shared_ptr<Stream>> streams_;
+
+  /** Streams being written (only used by the writer thread). */
+  std::vector<std::shared_ptr<Stream>> streams_to_write_;
+
+  std::atomic<uint64_t> bytes_written_ = 0;
+  std::atomic<double>   throughput_ = 0.0;
+  std::atomic<uint64_t> backlog_frames_ = 0;
+  std::atomic<uint64_t> max_backlog_frames_ = 0;
+  std::atomic<uint64_t> num_extra_blocks_ = 0;
+
+  /** Used by the writer thread to compute the throughput. */
+  uint64_t    prev_bytes_written_ = 0;
+  juce::int64 prev_stats_time_ms_ = 0;
+};
+
+/**
+ * @}
+ */
@@ -28,6 +28,19 @@
 class RecordingEvent
 {
 public:
+  /** Maximum number of MIDI events carried by a single recording event. */
+  static constexpr size_t MAX_MIDI_EVENTS = 16;
+
+  /**
+   * @brief Recorded audio, kept apart from the event so that events that
+   * don't carry audio stay small.
+   */
+  struct AudioData
+  {
+    std::array<float, 8192> lbuf_{};
+    std::array<float, 8192> rbuf_{};
+  };
+
   enum class Type
   {
     StartTrackRecording,
@@ -70,8 +83,8 @@ public:
     track_uuid_ = track.get_uuid ();
     g_start_frame_w_offset_ = time_nfo.g_start_frame_w_offset_;
     local_offset_ = time_nfo.local_offset_;
-    has_midi_event_ = false;
-    midi_event_ = MidiEvent{};
+    num_midi_events_ = 0;
+    audio_data_ = nullptr;
     automation_track_idx_ = 0;
     nframes_ = time_nfo.nframes_;
     file_ = file;
@@ -82,8 +95,6 @@ public:
 public:
   Type type_ = Type::Audio;
 
-  bool has_midi_event_ = false;
-
   /** The identifier of the track this event is for. */
   dsp::PortIdentifier::TrackUuid track_uuid_;
 
@@ -100,17 +111,19 @@ public:
   int automation_track_idx_ = 0;
 
   /**
-   * The actual data (if audio).
-   *
-   * This will be @ref nframes_ times the number of channels in the track.
+   * The actual data (if audio), owned by the recording manager's audio data
+   * pool.
    */
-  std::array<float, 8192> lbuf_{};
-  std::array<float, 8192> rbuf_{};
+  AudioData * audio_data_ = nullptr;
 
   /**
-   * MidiEvent, if midi.
+   * MIDI events received in the range (if midi).
+   *
+   * Cycles with more than @ref MAX_MIDI_EVENTS events are split into
+   * multiple recording events.
    */
-  MidiEvent midi_event_;
+  std::array<MidiEvent, MAX_MIDI_EVENTS> midi_events_;
+  size_t                                 num_midi_events_ = 0;
 
   /* debug info */
   const char * file_ = nullptr;
@@ -126,11 +139,11 @@ DEFINE_OBJECT_FORMATTER (
       "RecordingEvent {{ type: {}, track_name_hash: {}, "
       "g_start_frame_w_offset: {}, local_offset: {}, "
       "nframes: {}, automation_track_idx: {}, "
-      "has_midi_event: {}, midi_event: TODO, "
+      "num_midi_events: {}, "
       "file: {}, func: {}, line: {} }}",
       static_cast<int> (ev.type_), ev.track_uuid_, ev.g_start_frame_w_offset_,
       ev.local_offset_, ev.nframes_, ev.automation_track_idx_,
-      ev.has_midi_event_, // ev.midi_event_,
+      ev.num_midi_events_,
       ev.file_, ev.func_, ev.lineno_);
   })
 
@@ -5,6 +5,7 @@
 
 #include "gui/backend/backend/actions/arranger_selections_action.h"
 #include "gui/backend/backend/project.h"
+#include "gui/backend/backend/settings_manager.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/dsp/arranger_object.h"
 #include "gui/dsp/audio_region.h"
@@ -17,6 +18,7 @@
 #include "gui/dsp/control_port.h"
 #include "gui/dsp/engine.h"
 #include "gui/dsp/laned_track.h"
+#include "gui/dsp/pool.h"
 #include "gui/dsp/piano_roll_track.h"
 #include "gui/dsp/processable_track.h"
 #include "gui/dsp/recordable_track.h"
@@ -130,10 +132,17 @@ RecordingManager::handle_stop_recording (bool is_automation)
         {
           auto *      ar = std::get<AudioRegion *> (r.value ());
           AudioClip * clip = ar->get_clip ();
+          auto        it = disk_streams_.find (clip->get_pool_id ());
+          if (it == disk_streams_.end ())
+            continue;
+
+          auto stream = std::move (it->second);
+          disk_streams_.erase (it);
           try
             {
-              AUDIO_POOL->write_clip (*clip, true, false);
-              clip->finalize_buffered_write ();
+              disk_writer_->close_stream (*stream);
+              clip->mark_written_to_pool (
+                utils::hash::get_file_hash (stream->get_path ()));
             }
           catch (const ZrythmException &ex)
             {
@@ -170,6 +179,43 @@ RecordingManager::handle_stop_recording (bool is_automation)
   z_return_if_fail (num_active_recordings_ == 0);
 }
 
+RecordingEvent *
+RecordingManager::acquire_event ()
+{
+  auto * ev = event_obj_pool_.try_acquire ();
+  if (!ev) [[unlikely]]
+    {
+      num_dropped_events_.fetch_add (1, std::memory_order_relaxed);
+    }
+  return ev;
+}
+
+void
+RecordingManager::release_event (RecordingEvent * ev)
+{
+  if (ev->audio_data_)
+    {
+      audio_data_pool_.release (ev->audio_data_);
+      ev->audio_data_ = nullptr;
+    }
+  event_obj_pool_.release (ev);
+}
+
+void
+RecordingManager::push_event (RecordingEvent * ev)
+{
+  /* the queue can hold all the events in the pool, so this only fails if
+   * the sizes get out of sync */
+  if (!event_queue_.push_back (ev)) [[unlikely]]
+    {
+      num_dropped_events_.fetch_add (1, std::memory_order_relaxed);
+      release_event (ev);
+      return;
+    }
+  num_queued_events_.fetch_add (1, std::memory_order_relaxed);
+  event_notifier_->notify ();
+}
+
 void
 RecordingManager::handle_recording (
   const TrackProcessor *              track_processor,
@@ -213,7 +259,7 @@ RecordingManager::handle_recording (
   auto tr = track_processor->get_track ();
   auto atl = &tr->get_automation_tracklist ();
   auto recordable_track = dynamic_cast<RecordableTrack *> (tr);
-  auto cur_time = Zrythm::getInstance ()->get_monotonic_time_usecs ();
+  auto cur_time = time_nfo->cycle_start_time_usecs_;
 
   /* if track type can't record do nothing */
   if (!tr->can_record ()) [[unlikely]]
@@ -229,12 +275,15 @@ RecordingManager::handle_recording (
         Q_UNLIKELY (recordable_track->recording_region_)
         && !recordable_track->recording_stop_sent_)
         {
-          recordable_track->recording_stop_sent_ = true;
-
-          /* send stop recording event */
-          auto re = event_obj_pool_.acquire ();
-          re->init (RecordingEvent::Type::StopTrackRecording, *tr, *time_nfo);
-          event_queue_.push_back (re);
+          /* send stop recording event (retried in the next cycle if no
+           * event is available) */
+          if (auto * re = acquire_event ())
+            {
+              re->init (
+                RecordingEvent::Type::StopTrackRecording, *tr, *time_nfo);
+              push_event (re);
+              recordable_track->recording_stop_sent_ = true;
+            }
         }
       skip_adding_track_events = true;
     }
@@ -246,9 +295,12 @@ RecordingManager::handle_recording (
         || recordable_track->recording_start_sent_)
         {
           /* send pause event */
-          auto re = event_obj_pool_.acquire ();
-          re->init (RecordingEvent::Type::PauseTrackRecording, *tr, *time_nfo);
-          event_queue_.push_back (re);
+          if (auto * re = acquire_event ())
+            {
+              re->init (
+                RecordingEvent::Type::PauseTrackRecording, *tr, *time_nfo);
+              push_event (re);
+            }
 
           skip_adding_track_events = true;
         }
@@ -261,12 +313,14 @@ RecordingManager::handle_recording (
         !recordable_track->recording_region_
         && !recordable_track->recording_start_sent_)
         {
-          recordable_track->recording_start_sent_ = true;
-
           /* send start recording event */
-          auto re = event_obj_pool_.acquire ();
-          re->init (RecordingEvent::Type::StartTrackRecording, *tr, *time_nfo);
-          event_queue_.push_back (re);
+          if (auto * re = acquire_event ())
+            {
+              re->init (
+                RecordingEvent::Type::StartTrackRecording, *tr, *time_nfo);
+              push_event (re);
+              recordable_track->recording_start_sent_ = true;
+            }
         }
     }
   else if (!inside_punch_range)
@@ -284,11 +338,13 @@ RecordingManager::handle_recording (
         && (!TRANSPORT->isRolling () || !at_should_be_recording))
         {
           /* send stop automation recording event */
-          auto re = event_obj_pool_.acquire ();
-          re->init (
-            RecordingEvent::Type::StopAutomationRecording, *tr, *time_nfo);
-          re->automation_track_idx_ = at->index_;
-          event_queue_.push_back (re);
+          if (auto * re = acquire_event ())
+            {
+              re->init (
+                RecordingEvent::Type::StopAutomationRecording, *tr, *time_nfo);
+              re->automation_track_idx_ = at->index_;
+              push_event (re);
+            }
 
           skip_adding_automation_events = true;
         }
@@ -296,11 +352,14 @@ RecordingManager::handle_recording (
       else if (Q_UNLIKELY (at->recording_start_sent_ && time_nfo->nframes_ == 0) && (time_nfo->g_start_frame_w_offset_ == static_cast<unsigned_frame_t> (TRANSPORT->loop_end_pos_->getFrames())))
         {
           /* send pause event */
-          auto re = event_obj_pool_.acquire ();
-          re->init (
-            RecordingEvent::Type::PauseAutomationRecording, *tr, *time_nfo);
-          re->automation_track_idx_ = at->index_;
-          event_queue_.push_back (re);
+          if (auto * re = acquire_event ())
+            {
+              re->init (
+                RecordingEvent::Type::PauseAutomationRecording, *tr,
+                *time_nfo);
+              re->automation_track_idx_ = at->index_;
+              push_event (re);
+            }
 
           skip_adding_automation_events = true;
         }
@@ -311,14 +370,16 @@ RecordingManager::handle_recording (
           /* if recording hasn't started yet */
           if (!at->recording_started_ && !at->recording_start_sent_)
             {
-              at->recording_start_sent_ = true;
-
               /* send start recording event */
-              auto re = event_obj_pool_.acquire ();
-              re->init (
-                RecordingEvent::Type::StartAutomationRecording, *tr, *time_nfo);
-              re->automation_track_idx_ = at->index_;
-              event_queue_.push_back (re);
+              if (auto * re = acquire_event ())
+                {
+                  re->init (
+                    RecordingEvent::Type::StartAutomationRecording, *tr,
+                    *time_nfo);
+                  re->automation_track_idx_ = at->index_;
+                  push_event (re);
+                  at->recording_start_sent_ = true;
+                }
             }
         }
     }
@@ -334,41 +395,66 @@ RecordingManager::handle_recording (
           auto &midi_events =
             track_processor->get_midi_in_port ().midi_events_.active_events_;
 
+          /* send the cycle's MIDI events in as few recording events as
+           * possible (at least one, to extend the region) */
+          RecordingEvent * re = nullptr;
           for (const auto &me : midi_events)
             {
-              auto re = event_obj_pool_.acquire ();
-              re->init (RecordingEvent::Type::Midi, *tr, *time_nfo);
-              re->has_midi_event_ = true;
-              re->midi_event_ = me;
-              event_queue_.push_back (re);
+              if (re && re->num_midi_events_ == RecordingEvent::MAX_MIDI_EVENTS)
+                {
+                  push_event (re);
+                  re = nullptr;
+                }
+              if (!re)
+                {
+                  re = acquire_event ();
+                  if (!re) [[unlikely]]
+                    break;
+                  re->init (RecordingEvent::Type::Midi, *tr, *time_nfo);
+                }
+              re->midi_events_[re->num_midi_events_++] = me;
             }
 
           if (midi_events.empty ())
             {
-              auto re = event_obj_pool_.acquire ();
-              re->init (RecordingEvent::Type::Midi, *tr, *time_nfo);
-              re->has_midi_event_ = false;
-              event_queue_.push_back (re);
+              re = acquire_event ();
+              if (re)
+                re->init (RecordingEvent::Type::Midi, *tr, *time_nfo);
             }
+          if (re)
+            push_event (re);
         }
       else if (tr->type_ == Track::Type::Audio)
         {
-          auto re = event_obj_pool_.acquire ();
-          re->init (RecordingEvent::Type::Audio, *tr, *time_nfo);
-          auto tp_stereo_ins = track_processor->get_stereo_in_ports ();
-          utils::float_ranges::copy (
-            &re->lbuf_[time_nfo->local_offset_],
-            &tp_stereo_ins.first.buf_[time_nfo->local_offset_],
-            time_nfo->nframes_);
-          auto &r =
-            track_processor->mono_id_
-                && track_processor->get_mono_port ().is_toggled ()
-              ? tp_stereo_ins.first
-              : tp_stereo_ins.second;
-          utils::float_ranges::copy (
-            &re->rbuf_[time_nfo->local_offset_],
-            &r.buf_[time_nfo->local_offset_], time_nfo->nframes_);
-          event_queue_.push_back (re);
+          auto * re = acquire_event ();
+          if (re)
+            {
+              re->init (RecordingEvent::Type::Audio, *tr, *time_nfo);
+              re->audio_data_ = audio_data_pool_.try_acquire ();
+              if (!re->audio_data_) [[unlikely]]
+                {
+                  num_dropped_events_.fetch_add (1, std::memory_order_relaxed);
+                  release_event (re);
+                  re = nullptr;
+                }
+            }
+          if (re)
+            {
+              auto tp_stereo_ins = track_processor->get_stereo_in_ports ();
+              utils::float_ranges::copy (
+                &re->audio_data_->lbuf_[time_nfo->local_offset_],
+                &tp_stereo_ins.first.buf_[time_nfo->local_offset_],
+                time_nfo->nframes_);
+              auto &r =
+                track_processor->mono_id_
+                    && track_processor->get_mono_port ().is_toggled ()
+                  ? tp_stereo_ins.first
+                  : tp_stereo_ins.second;
+              utils::float_ranges::copy (
+                &re->audio_data_->rbuf_[time_nfo->local_offset_],
+                &r.buf_[time_nfo->local_offset_], time_nfo->nframes_);
+              push_event (re);
+            }
         }
     }
 
@@ -391,10 +477,12 @@ RecordingManager::handle_recording (
         continue;
 
       /* send recording event */
-      auto re = event_obj_pool_.acquire ();
+      auto * re = acquire_event ();
+      if (!re) [[unlikely]]
+        continue;
       re->init (RecordingEvent::Type::Automation, *tr, *time_nfo);
       re->automation_track_idx_ = at->index_;
-      event_queue_.push_back (re);
+      push_event (re);
     }
 }
 void
@@ -409,6 +497,9 @@ RecordingManager::delete_automation_points (
       region.remove_object (*ap, false);
     }
 
+  /* the held value is not part of the simplified curve */
+  at->recording_simplifier_.reset ();
+
   /* create a new automation point at the pos with the previous value */
   if (region.last_recorded_ap_)
     {
@@ -448,6 +539,11 @@ RecordingManager::create_automation_point (
       region.remove_object (*ap, false);
     }
 
+  if (!region.last_recorded_ap_)
+    {
+      at->recording_simplifier_.reset ();
+    }
+
   Position adj_pos = pos;
   adj_pos.add_ticks (-region.pos_->ticks_, AUDIO_ENGINE->frames_per_tick_);
   if (
@@ -462,10 +558,39 @@ RecordingManager::create_automation_point (
     }
   else
     {
+      /* drop the last recorded point if the curve stays close enough to it
+       * without it */
+      auto &simplifier = at->recording_simplifier_;
+      const bool simplify = simplifier.get_tolerance () > 0.0;
+      if (simplify)
+        {
+          if (simplifier.empty () && region.last_recorded_ap_)
+            {
+              simplifier.add_point (
+                region.last_recorded_ap_->pos_->ticks_,
+                region.last_recorded_ap_->normalized_val_);
+            }
+          if (
+            simplifier.add_point (adj_pos.ticks_, normalized_val)
+              == dsp::StreamingCurveSimplifier::Result::ReplaceLastPoint
+            && region.last_recorded_ap_)
+            {
+              region.remove_object (*region.last_recorded_ap_, false);
+            }
+        }
+
       auto * ap = new AutomationPoint (val, normalized_val, adj_pos);
       region.append_object (ap, true);
-      ap->curve_opts_.curviness_ = 1.0;
-      ap->curve_opts_.algo_ = dsp::CurveOptions::Algorithm::Pulse;
+      if (simplify)
+        {
+          /* the simplified curve joins the kept points with straight lines */
+          ap->curve_opts_.curviness_ = 0.0;
+        }
+      else
+        {
+          ap->curve_opts_.curviness_ = 1.0;
+          ap->curve_opts_.algo_ = dsp::CurveOptions::Algorithm::Pulse;
+        }
       region.last_recorded_ap_ = ap;
       return ap;
     }
@@ -808,21 +933,29 @@ RecordingManager::handle_audio_event (const RecordingEvent &ev)
   utils::audio::AudioBuffer buf_to_append{
     clip->get_num_channels (), (int) ev.nframes_
   };
-  buf_to_append.copyFrom (0, 0, ev.lbuf_.data (), ev.nframes_);
-  buf_to_append.copyFrom (1, 0, ev.rbuf_.data (), ev.nframes_);
+  buf_to_append.copyFrom (0, 0, ev.audio_data_->lbuf_.data (), ev.nframes_);
+  buf_to_append.copyFrom (1, 0, ev.audio_data_->rbuf_.data (), ev.nframes_);
   clip->expand_with_frames (buf_to_append);
 
-  /* write to pool if enough time passed since last write */
-  if (clip->enough_time_elapsed_since_last_write ())
+  /* queue the frames to be written to the pool file */
+  try
     {
-      try
+      auto &stream = disk_streams_[clip->get_pool_id ()];
+      if (!stream)
         {
-          AUDIO_POOL->write_clip (*clip, true, false);
-        }
-      catch (const ZrythmException &ex)
-        {
-          ex.handle ("Failed to write audio clip to pool");
+          /* recorded clips are always WAV (see AudioClip's constructor) so
+           * that they can be streamed */
+          z_return_if_fail (!clip->get_use_flac ());
+          stream = disk_writer_->open_stream (
+            AudioPool::get_clip_path (*clip, false), clip->get_samplerate (),
+            clip->get_num_channels (), clip->get_bit_depth ());
         }
+      disk_writer_->append (*stream, buf_to_append);
+    }
+  catch (const ZrythmException &ex)
+    {
+      disk_streams_.erase (clip->get_pool_id ());
+      ex.handle ("Failed to write audio clip to pool");
     }
 }
 
@@ -903,52 +1036,54 @@ RecordingManager::handle_midi_event (const RecordingEvent &ev)
                     }
                 }
 
-              if (!ev.has_midi_event_)
-                return;
-
               /* convert MIDI data to midi notes */
-              MidiNote *  mn;
-              const auto &mev = ev.midi_event_;
-              const auto &buf = mev.raw_buffer_.data ();
-
-              if constexpr (std::is_same_v<RegionT, ChordRegion>)
-                {
-                  if (midi_is_note_on (buf))
-                    {
-                      midi_byte_t note_number = midi_get_note_number (buf);
-                      const dsp::ChordDescriptor * descr =
-                        CHORD_EDITOR->get_chord_from_note_number (note_number);
-                      z_return_if_fail (descr);
-                      int  chord_idx = CHORD_EDITOR->get_chord_index (*descr);
-                      auto co = new ChordObject (
-                        region->id_, chord_idx, region->chord_objects_.size ());
-                      region->append_object (co, true);
-                      co->set_position (
-                        &local_pos, ArrangerObject::PositionType::Start, false);
-                    }
-                }
-              /* else if not chord track */
-              else if constexpr (std::is_same_v<RegionT, MidiRegion>)
+              for (size_t i = 0; i < ev.num_midi_events_; ++i)
                 {
-                  if (midi_is_note_on (buf))
-                    {
-                      z_return_if_fail (region);
-                      region->start_unended_note (
-                        &local_pos, &local_end_pos, midi_get_note_number (buf),
-                        midi_get_velocity (buf), true);
-                    }
-                  else if (midi_is_note_off (buf))
+                  const auto &buf = ev.midi_events_[i].raw_buffer_.data ();
+
+                  if constexpr (std::is_same_v<RegionT, ChordRegion>)
                     {
-                      z_return_if_fail (region);
-                      mn = region->pop_unended_note (midi_get_note_number (buf));
-                      if (mn)
+                      if (midi_is_note_on (buf))
                         {
-                          mn->end_pos_setter (&local_end_pos);
+                          midi_byte_t note_number = midi_get_note_number (buf);
+                          const dsp::ChordDescriptor * descr =
+                            CHORD_EDITOR->get_chord_from_note_number (
+                              note_number);
+                          z_return_if_fail (descr);
+                          int chord_idx =
+                            CHORD_EDITOR->get_chord_index (*descr);
+                          auto co = new ChordObject (
+                            region->id_, chord_idx,
+                            region->chord_objects_.size ());
+                          region->append_object (co, true);
+                          co->set_position (
+                            &local_pos, ArrangerObject::PositionType::Start,
+                            false);
                         }
                     }
-                  else
+                  /* else if not chord track */
+                  else if constexpr (std::is_same_v<RegionT, MidiRegion>)
                     {
-                      /* TODO */
+                      if (midi_is_note_on (buf))
+                        {
+                          region->start_unended_note (
+                            &local_pos, &local_end_pos,
+                            midi_get_note_number (buf), midi_get_velocity (buf),
+                            true);
+                        }
+                      else if (midi_is_note_off (buf))
+                        {
+                          auto * mn = region->pop_unended_note (
+                            midi_get_note_number (buf));
+                          if (mn)
+                            {
+                              mn->end_pos_setter (&local_end_pos);
+                            }
+                        }
+                      else
+                        {
+                          /* TODO */
+                        }
                     }
                 }
             },
@@ -1034,6 +1169,10 @@ RecordingManager::handle_automation_event (const RecordingEvent &ev)
               recorded_ids_.push_back (region->id_);
             }
 
+          if (region != at->recording_region_)
+            {
+              at->recording_simplifier_.reset ();
+            }
           at->recording_region_ = region;
 
           if (new_region_created || (region && region->end_pos_ < end_pos))
@@ -1142,6 +1281,14 @@ RecordingManager::handle_start_recording (
            */
           /*at->recording_paused = false;*/
 
+          /* start a new simplified curve (the tolerance is a percentage of
+           * the normalized range) */
+          at->recording_simplifier_.reset ();
+          at->recording_simplifier_.set_tolerance (
+            ZRYTHM_TESTING || ZRYTHM_BENCHMARKING
+              ? 0.0
+              : gui::SettingsManager::automationRecordingTolerance () / 100.0);
+
           /* nothing, wait for event to start writing data */
           auto port_var = PROJECT->find_port_by_id (at->port_id_);
           z_return_if_fail (
@@ -1232,153 +1379,264 @@ RecordingManager::handle_start_recording (
     tr_var);
 }
 
-void
-RecordingManager::process_events ()
+bool
+RecordingManager::can_coalesce_events (
+  const RecordingEvent &prev,
+  const RecordingEvent &next)
 {
-  SemaphoreRAII lock (processing_sem_);
-  z_return_if_fail (!currently_processing_);
-  currently_processing_ = true;
+  if (
+    prev.type_ != next.type_ || prev.track_uuid_ != next.track_uuid_
+    || prev.automation_track_idx_ != next.automation_track_idx_
+    || prev.g_start_frame_w_offset_ + prev.nframes_
+         != next.g_start_frame_w_offset_)
+    {
+      return false;
+    }
 
-  RecordingEvent * ev;
-  while (event_queue_.pop_front (ev))
+  switch (next.type_)
     {
-      if (freeing_)
+    case RecordingEvent::Type::Midi:
+      /* MIDI events are positioned at the start/end of their range, so only
+       * ranges without MIDI events can be extended */
+      return prev.num_midi_events_ == 0 && next.num_midi_events_ == 0;
+    case RecordingEvent::Type::Automation:
+      /* the automation value is read when the event is handled anyway */
+      return true;
+    default:
+      return false;
+    }
+}
+
+void
+RecordingManager::coalesce_events (std::vector<RecordingEvent *> &events)
+{
+  /* start/stop/pause events are barriers, so only look for events to
+   * coalesce with since the last one */
+  size_t barrier_idx = 0;
+  for (size_t i = 0; i < events.size (); ++i)
+    {
+      auto * ev = events[i];
+      if (
+        ev->type_ != RecordingEvent::Type::Midi
+        && ev->type_ != RecordingEvent::Type::Audio
+        && ev->type_ != RecordingEvent::Type::Automation)
         {
-          goto return_to_pool;
+          barrier_idx = i + 1;
+          continue;
         }
 
-      switch (ev->type_)
+      /* find the previous event for the same track (and automation track) */
+      for (size_t j = i; j-- > barrier_idx;)
         {
-        case RecordingEvent::Type::Midi:
-          handle_midi_event (*ev);
-          break;
-        case RecordingEvent::Type::Audio:
-          handle_audio_event (*ev);
-          break;
-        case RecordingEvent::Type::Automation:
-          handle_automation_event (*ev);
-          break;
-        case RecordingEvent::Type::PauseTrackRecording:
-          z_debug ("-------- PAUSE TRACK RECORDING");
-          handle_pause_event (*ev);
-          break;
-        case RecordingEvent::Type::PauseAutomationRecording:
-          z_debug ("-------- PAUSE AUTOMATION RECORDING");
-          handle_pause_event (*ev);
-          break;
-        case RecordingEvent::Type::StopTrackRecording:
-          {
-            auto tr_var = *TRACKLIST->get_track (ev->track_uuid_);
-            std::visit (
-              [&] (auto &&tr) {
-                using TrackT = base_type<decltype (tr)>;
-                if constexpr (std::derived_from<TrackT, RecordableTrack>)
-                  {
-                    z_debug ("-------- STOP TRACK RECORDING ({})", tr->name_);
-                    handle_stop_recording (false);
-                    tr->recording_region_ = nullptr;
-                    tr->recording_start_sent_ = false;
-                    tr->recording_stop_sent_ = false;
-                  }
-                else
-                  {
-                    z_return_if_reached ();
-                  }
-              },
-              tr_var);
-          }
-          z_debug ("num active recordings: {}", num_active_recordings_);
-          break;
-        case RecordingEvent::Type::StopAutomationRecording:
-          z_debug ("-------- STOP AUTOMATION RECORDING");
-          {
-            auto tr_var = *TRACKLIST->get_track (ev->track_uuid_);
-            std::visit (
-              [&] (auto &tr) {
-                using TrackT = base_type<decltype (tr)>;
-                if constexpr (std::derived_from<TrackT, AutomatableTrack>)
-                  {
-                    auto &at =
-                      tr->automation_tracklist_->ats_[ev->automation_track_idx_];
-                    z_return_if_fail (at);
-                    if (at->recording_started_)
-                      {
-                        handle_stop_recording (true);
-                      }
-                    at->recording_started_ = false;
-                    at->recording_start_sent_ = false;
-                    at->recording_region_ = nullptr;
-                  }
-                else
-                  {
-                    z_return_if_reached ();
-                  }
-              },
-              tr_var);
-          }
-          z_debug ("num active recordings: {}", num_active_recordings_);
-          break;
-        case RecordingEvent::Type::StartTrackRecording:
-          {
-            auto tr_var = *TRACKLIST->get_track (ev->track_uuid_);
-            std::visit (
-              [&] (auto &&tr) {
-                z_debug ("-------- START TRACK RECORDING ({})", tr->name_);
-                handle_start_recording (*ev, false);
-                z_debug ("num active recordings: {}", num_active_recordings_);
-              },
-              tr_var);
-          }
+          auto * prev = events[j];
+          if (
+            !prev || prev->type_ != ev->type_
+            || prev->track_uuid_ != ev->track_uuid_
+            || prev->automation_track_idx_ != ev->automation_track_idx_)
+            {
+              continue;
+            }
+
+          if (can_coalesce_events (*prev, *ev))
+            {
+              prev->nframes_ += ev->nframes_;
+              release_event (ev);
+              events[i] = nullptr;
+              num_coalesced_events_.fetch_add (1, std::memory_order_relaxed);
+            }
           break;
-        case RecordingEvent::Type::StartAutomationRecording:
-          z_info ("-------- START AUTOMATION RECORDING");
-          {
-            auto tr_var = *TRACKLIST->get_track (ev->track_uuid_);
-            std::visit (
-              [&] (auto &tr) {
-                using TrackT = base_type<decltype (tr)>;
-                if constexpr (std::derived_from<TrackT, AutomatableTrack>)
+        }
+    }
+}
+
+void
+RecordingManager::handle_event (const RecordingEvent &ev)
+{
+  switch (ev.type_)
+    {
+    case RecordingEvent::Type::Midi:
+      handle_midi_event (ev);
+      break;
+    case RecordingEvent::Type::Audio:
+      handle_audio_event (ev);
+      break;
+    case RecordingEvent::Type::Automation:
+      handle_automation_event (ev);
+      break;
+    case RecordingEvent::Type::PauseTrackRecording:
+      z_debug ("-------- PAUSE TRACK RECORDING");
+      handle_pause_event (ev);
+      break;
+    case RecordingEvent::Type::PauseAutomationRecording:
+      z_debug ("-------- PAUSE AUTOMATION RECORDING");
+      handle_pause_event (ev);
+      break;
+    case RecordingEvent::Type::StopTrackRecording:
+      {
+        auto tr_var = *TRACKLIST->get_track (ev.track_uuid_);
+        std::visit (
+          [&] (auto &&tr) {
+            using TrackT = base_type<decltype (tr)>;
+            if constexpr (std::derived_from<TrackT, RecordableTrack>)
+              {
+                z_debug ("-------- STOP TRACK RECORDING ({})", tr->name_);
+                handle_stop_recording (false);
+                tr->recording_region_ = nullptr;
+                tr->recording_start_sent_ = false;
+                tr->recording_stop_sent_ = false;
+              }
+            else
+              {
+                z_return_if_reached ();
+              }
+          },
+          tr_var);
+      }
+      z_debug ("num active recordings: {}", num_active_recordings_);
+      break;
+    case RecordingEvent::Type::StopAutomationRecording:
+      z_debug ("-------- STOP AUTOMATION RECORDING");
+      {
+        auto tr_var = *TRACKLIST->get_track (ev.track_uuid_);
+        std::visit (
+          [&] (auto &tr) {
+            using TrackT = base_type<decltype (tr)>;
+            if constexpr (std::derived_from<TrackT, AutomatableTrack>)
+              {
+                auto &at =
+                  tr->automation_tracklist_->ats_[ev.automation_track_idx_];
+                z_return_if_fail (at);
+                if (at->recording_started_)
                   {
-                    auto &at =
-                      tr->automation_tracklist_->ats_[ev->automation_track_idx_];
-                    z_return_if_fail (at);
-                    if (!at->recording_started_)
-                      {
-                        handle_start_recording (*ev, true);
-                      }
-                    at->recording_started_ = true;
+                    handle_stop_recording (true);
                   }
-                else
+                at->recording_started_ = false;
+                at->recording_start_sent_ = false;
+                at->recording_region_ = nullptr;
+              }
+            else
+              {
+                z_return_if_reached ();
+              }
+          },
+          tr_var);
+      }
+      z_debug ("num active recordings: {}", num_active_recordings_);
+      break;
+    case RecordingEvent::Type::StartTrackRecording:
+      {
+        auto tr_var = *TRACKLIST->get_track (ev.track_uuid_);
+        std::visit (
+          [&] (auto &&tr) {
+            z_debug ("-------- START TRACK RECORDING ({})", tr->name_);
+            handle_start_recording (ev, false);
+            z_debug ("num active recordings: {}", num_active_recordings_);
+          },
+          tr_var);
+      }
+      break;
+    case RecordingEvent::Type::StartAutomationRecording:
+      z_info ("-------- START AUTOMATION RECORDING");
+      {
+        auto tr_var = *TRACKLIST->get_track (ev.track_uuid_);
+        std::visit (
+          [&] (auto &tr) {
+            using TrackT = base_type<decltype (tr)>;
+            if constexpr (std::derived_from<TrackT, AutomatableTrack>)
+              {
+                auto &at =
+                  tr->automation_tracklist_->ats_[ev.automation_track_idx_];
+                z_return_if_fail (at);
+                if (!at->recording_started_)
                   {
-                    z_return_if_reached ();
+                    handle_start_recording (ev, true);
                   }
-              },
-              tr_var);
-            z_debug ("num active recordings: {}", num_active_recordings_);
-          }
-          break;
+                at->recording_started_ = true;
+              }
+            else
+              {
+                z_return_if_reached ();
+              }
+          },
+          tr_var);
+        z_debug ("num active recordings: {}", num_active_recordings_);
+      }
+      break;
+    }
+}
+
+void
+RecordingManager::process_events ()
+{
+  /* this only runs on the main thread, so only guard against re-entrance */
+  z_return_if_fail (!currently_processing_);
+  currently_processing_ = true;
+
+  /* handle all the queued events as one batch, so that consecutive events
+   * can be coalesced (e.g., one region update for many cycles) */
+  RecordingEvent * ev;
+  while (event_queue_.pop_front (ev))
+    {
+      batch_.push_back (ev);
+    }
+  if (batch_.size () > max_backlog_events_.load (std::memory_order_relaxed))
+    {
+      max_backlog_events_.store (batch_.size (), std::memory_order_relaxed);
+    }
+
+  if (!freeing_)
+    {
+      coalesce_events (batch_);
+      for (auto * batch_ev : batch_)
+        {
+          if (batch_ev)
+            handle_event (*batch_ev);
         }
+    }
 
-return_to_pool:
-      event_obj_pool_.release (ev);
+  for (auto * batch_ev : batch_)
+    {
+      if (batch_ev)
+        release_event (batch_ev);
     }
+  num_handled_events_.fetch_add (batch_.size (), std::memory_order_relaxed);
+  batch_.clear ();
 
   currently_processing_ = false;
 }
 
-RecordingManager::RecordingManager (QObject * parent) : QObject (parent)
+RecordingManager::Stats
+RecordingManager::get_stats () const
+{
+  const auto num_queued = num_queued_events_.load (std::memory_order_relaxed);
+  const auto num_handled = num_handled_events_.load (std::memory_order_relaxed);
+  return {
+    .backlog_events_ = num_queued > num_handled ? num_queued - num_handled : 0,
+    .max_backlog_events_ = max_backlog_events_.load (std::memory_order_relaxed),
+    .num_dropped_events_ = num_dropped_events_.load (std::memory_order_relaxed),
+    .num_coalesced_events_ =
+      num_coalesced_events_.load (std::memory_order_relaxed),
+  };
+}
+
+RecordingManager::RecordingManager (QObject * parent)
+    : QObject (parent), disk_writer_ (std::make_unique<RecordingDiskWriter> ())
 {
   recorded_ids_.reserve (8000);
 
-  const size_t max_events = ZRYTHM_TESTING || ZRYTHM_BENCHMARKING ? 400 : 10000;
+  /* the pools are never expanded during processing (events are dropped
+   * instead), and the queue can hold all the events of the pool, so pushing
+   * never fails */
+  const bool   small_pools = ZRYTHM_TESTING || ZRYTHM_BENCHMARKING;
+  const size_t max_events = small_pools ? 512 : 16384;
   event_obj_pool_.reserve (max_events);
-  event_queue_.reserve (max_events);
+  event_queue_.reserve (event_obj_pool_.get_capacity ());
+  audio_data_pool_.reserve (small_pools ? 64 : 1024);
+  batch_.reserve (event_obj_pool_.get_capacity ());
 
-  auto * timer = new QTimer (this);
-  timer->setInterval (12);
-  timer->setSingleShot (false);
-  connect (timer, &QTimer::timeout, this, &RecordingManager::process_events);
-  timer->start ();
+  event_notifier_ = std::make_unique<utils::MainThreadNotifier> ([this] () {
+    process_events ();
+  });
 }
 
 RecordingManager::~RecordingManager ()
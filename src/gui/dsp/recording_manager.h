@@ -4,12 +4,15 @@
 #ifndef __AUDIO_RECORDING_MANAGER_H__
 #define __AUDIO_RECORDING_MANAGER_H__
 
-#include <semaphore>
+#include <atomic>
+#include <unordered_map>
 
 #include "gui/dsp/automation_point.h"
+#include "gui/dsp/recording_disk_writer.h"
 #include "gui/dsp/recording_event.h"
 #include "gui/dsp/region_identifier.h"
 
+#include "utils/main_thread_notifier.h"
 #include "utils/mpmc_queue.h"
 #include "utils/object_pool.h"
 #include "utils/types.h"
@@ -42,11 +45,28 @@ class RecordingManager : public QObject
 public:
   using Position = zrythm::dsp::Position;
 
+  /**
+   * @brief Statistics of the recording event pipeline.
+   */
+  struct Stats
+  {
+    /** Events queued but not handled yet. */
+    uint64_t backlog_events_ = 0;
+
+    /** Highest number of events handled in a single batch. */
+    uint64_t max_backlog_events_ = 0;
+
+    /** Events dropped because the pools were exhausted. */
+    uint64_t num_dropped_events_ = 0;
+
+    /** Events merged into a previous event of the same batch. */
+    uint64_t num_coalesced_events_ = 0;
+  };
+
 public:
   /**
-   * Creates the event queue and starts the event loop.
-   *
-   * Must be called from a GTK thread.
+   * Creates the event queue and the notifier that processes the events on
+   * the main thread.
    */
   RecordingManager (QObject * parent = nullptr);
   Q_DISABLE_COPY_MOVE (RecordingManager)
@@ -66,9 +86,52 @@ public:
     const TrackProcessor *        track_processor,
     const EngineProcessTimeInfo * time_nfo);
 
+  /**
+   * @brief Handles the queued events as one batch.
+   */
   Q_SLOT void process_events ();
 
+  /**
+   * @brief Returns the statistics (can be called from any thread).
+   */
+  Stats get_stats () const;
+
 private:
+  /**
+   * @brief Returns an event from the pool, or nullptr if the pool is
+   * exhausted (realtime-safe).
+   */
+  RecordingEvent * acquire_event ();
+
+  /**
+   * @brief Returns the event (and its audio data) to the pools.
+   */
+  void release_event (RecordingEvent * ev);
+
+  /**
+   * @brief Queues an event and notifies the main thread (realtime-safe).
+   */
+  void push_event (RecordingEvent * ev);
+
+  /**
+   * @brief Returns whether @p next only extends the range of @p prev, so
+   * that they can be handled as one event.
+   */
+  static bool
+  can_coalesce_events (const RecordingEvent &prev, const RecordingEvent &next);
+
+  /**
+   * @brief Merges each event of @p events into the previous event for the
+   * same track if possible (see can_coalesce_events()), replacing it with
+   * nullptr.
+   *
+   * Start/stop/pause events are not coalesced and events are not coalesced
+   * across them.
+   */
+  void coalesce_events (std::vector<RecordingEvent *> &events);
+
+  void handle_event (const RecordingEvent &ev);
+
   void handle_start_recording (const RecordingEvent &ev, bool is_automation);
 
   /**
@@ -102,6 +165,10 @@ private:
    * Creates a new automation point and deletes anything between the last
    * recorded automation point and this point.
    *
+   * If the automation track's recording tolerance is non-zero, the last
+   * recorded automation point is also deleted when the curve stays within
+   * the tolerance without it (see AutomationTrack::recording_simplifier_).
+   *
    * @note Runs in GTK thread only.
    */
   AutomationPoint * create_automation_point (
@@ -150,7 +217,14 @@ public:
   /**
    * Memory pool of event structs to avoid real time allocation.
    */
-  ObjectPool<RecordingEvent> event_obj_pool_;
+  ObjectPool<RecordingEvent> event_obj_pool_{ 0 };
+
+  /** Memory pool of audio data for audio events. */
+  ObjectPool<RecordingEvent::AudioData> audio_data_pool_{ 0 };
+
+  /** Wakes up the main thread to call process_events() when events are
+   * pushed. */
+  std::unique_ptr<utils::MainThreadNotifier> event_notifier_;
 
   /** Cloned objects before starting recording. */
   std::vector<ArrangerObjectPtrVariant> objects_before_start_;
@@ -165,16 +239,26 @@ public:
   /** Pending recorded automation points. */
   std::vector<AutomationPoint *> pending_aps_;
 
-  bool                  currently_processing_ = false;
-  std::binary_semaphore processing_sem_{ 1 };
+  bool currently_processing_ = false;
 
   bool freeing_ = false;
 
+  /** Writes the recorded audio to the pool files. */
+  std::unique_ptr<RecordingDiskWriter> disk_writer_;
+
 private:
-  /**
-   * @brief Thread to be used for writing data in the background (TODO).
-   */
-  std::unique_ptr<juce::TimeSliceThread> time_slice_thread_;
+  /** Events being handled (only used by process_events()). */
+  std::vector<RecordingEvent *> batch_;
+
+  std::atomic<uint64_t> num_queued_events_ = 0;
+  std::atomic<uint64_t> num_handled_events_ = 0;
+  std::atomic<uint64_t> max_backlog_events_ = 0;
+  std::atomic<uint64_t> num_dropped_events_ = 0;
+  std::atomic<uint64_t> num_coalesced_events_ = 0;
+
+  /** Streams of the audio clips being recorded, by pool ID. */
+  std::unordered_map<int, std::shared_ptr<RecordingDiskWriter::Stream>>
+    disk_streams_;
 };
 
 /**
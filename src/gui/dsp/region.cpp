@@ -1,7 +1,6 @@
 // SPDX-FileCopyrightText: © 2018-2022, 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
-#include "dsp/stretcher.h"
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/backend/channel.h"
@@ -21,6 +20,7 @@
 #include "gui/dsp/recording_manager.h"
 #include "gui/dsp/region.h"
 #include "gui/dsp/region_link_group_manager.h"
+#include "gui/dsp/region_list.h"
 #include "gui/dsp/router.h"
 #include "gui/dsp/track.h"
 #include "gui/dsp/tracklist.h"
@@ -60,8 +60,8 @@ Region::init (
     }
   id_.idx_ = idx_inside_lane_or_at;
 
-  *static_cast<Position *> (pos_) = start_pos;
-  *static_cast<Position *> (end_pos_) = end_pos;
+  *pos_ = start_pos;
+  *end_pos_ = end_pos;
   long length = get_length_in_frames ();
   z_return_if_fail (length > 0);
   loop_end_pos_.from_frames (length, ticks_per_frame);
@@ -164,7 +164,7 @@ RegionImpl<RegionT>::send_note_offs (
     }
   else
     {
-      midi_events.add_all_notes_off (channel, midi_time_for_note_off, true);
+      midi_events.add_all_notes_off (channel, midi_time_for_note_off);
     }
 }
 
@@ -191,96 +191,140 @@ RegionImpl<RegionT>::fill_midi_events (
       const auto r_local_pos = timeline_frames_to_local (
         (signed_frame_t) time_nfo.g_start_frame_w_offset_, true);
 
-      auto process_object = [&]<typename ObjectType> (const ObjectType &obj) {
-        if (obj.get_muted (false))
-          return;
-
-        dsp::ChordDescriptor * descr = nullptr;
-        if constexpr (std::is_same_v<ObjectType, ChordObject>)
-          {
-            descr = obj.get_chord_descriptor ();
-          }
-
-        /* if object starts inside the current range */
-        if (
-          obj.pos_->frames_ >= 0 && obj.pos_->frames_ >= r_local_pos
-          && obj.pos_->frames_ < r_local_pos + (signed_frame_t) time_nfo.nframes_)
-          {
-            auto _time =
-              (midi_time_t) (time_nfo.local_offset_
-                             + (obj.pos_->frames_ - r_local_pos));
-
-            if constexpr (std::is_same_v<RegionT, MidiRegion>)
-              {
-                midi_events.add_note_on (
-                  r->get_midi_ch (), obj.pitch_, obj.vel_->vel_, _time);
-              }
-            else if constexpr (std::is_same_v<ObjectType, ChordObject>)
-              {
-                midi_events.add_note_ons_from_chord_descr (
-                  *descr, 1, VELOCITY_DEFAULT, _time);
-              }
-          }
-
-        signed_frame_t obj_end_frames = 0;
-        if constexpr (std::is_same_v<ObjectType, MidiNote>)
-          {
-            obj_end_frames = obj.end_pos_->frames_;
-          }
-        else if constexpr (std::is_same_v<ObjectType, ChordObject>)
-          {
-            obj_end_frames = utils::math::round_to_signed_frame_t (
-              obj.pos_->frames_
-              + TRANSPORT->ticks_per_beat_ * AUDIO_ENGINE->frames_per_tick_);
-          }
-
-        /* if note ends within the cycle */
-        if (
-          obj_end_frames >= r_local_pos
-          && (obj_end_frames <= (r_local_pos + time_nfo.nframes_)))
-          {
-            auto _time =
-              (midi_time_t) (time_nfo.local_offset_
-                             + (obj_end_frames - r_local_pos));
-
-            /* note actually ends 1 frame before the end point, not at the end
-             * point */
-            if (_time > 0)
-              {
-                _time--;
-              }
+      const signed_frame_t r_local_end =
+        r_local_pos + (signed_frame_t) time_nfo.nframes_;
 
-            if constexpr (std::is_same_v<RegionT, MidiRegion>)
-              {
-                midi_events.add_note_off (r->get_midi_ch (), obj.pitch_, _time);
-              }
-            else if constexpr (std::is_same_v<ObjectType, ChordObject>)
-              {
-                for (
-                  size_t l = 0; l < ChordObject::ChordDescriptor::MAX_NOTES; l++)
-                  {
-                    if (descr->notes_[l])
-                      {
-                        midi_events.add_note_off (1, l + 36, _time);
-                      }
-                  }
-              }
-          }
-      };
+      auto process_object_start =
+        [&]<typename ObjectType> (const ObjectType &obj) {
+          if (obj.get_muted (false))
+            return;
+
+          /* if object starts inside the current range */
+          if (
+            obj.pos_->frames_ >= 0 && obj.pos_->frames_ >= r_local_pos
+            && obj.pos_->frames_ < r_local_end)
+            {
+              auto _time =
+                (midi_time_t) (time_nfo.local_offset_
+                               + (obj.pos_->frames_ - r_local_pos));
+
+              if constexpr (std::is_same_v<RegionT, MidiRegion>)
+                {
+                  midi_events.add_note_on (
+                    r->get_midi_ch (), obj.pitch_, obj.vel_->vel_, _time);
+                }
+              else if constexpr (std::is_same_v<ObjectType, ChordObject>)
+                {
+                  midi_events.add_note_ons_from_chord_descr (
+                    *obj.get_chord_descriptor (), 1, VELOCITY_DEFAULT, _time);
+                }
+            }
+        };
+
+      auto process_object_end =
+        [&]<typename ObjectType> (const ObjectType &obj) {
+          if (obj.get_muted (false))
+            return;
+
+          signed_frame_t obj_end_frames = 0;
+          if constexpr (std::is_same_v<ObjectType, MidiNote>)
+            {
+              obj_end_frames = obj.end_pos_->frames_;
+            }
+          else if constexpr (std::is_same_v<ObjectType, ChordObject>)
+            {
+              obj_end_frames = utils::math::round_to_signed_frame_t (
+                obj.pos_->frames_
+                + TRANSPORT->ticks_per_beat_ * AUDIO_ENGINE->frames_per_tick_);
+            }
+
+          /* if note ends within the cycle */
+          if (obj_end_frames >= r_local_pos && obj_end_frames <= r_local_end)
+            {
+              auto _time =
+                (midi_time_t) (time_nfo.local_offset_
+                               + (obj_end_frames - r_local_pos));
+
+              /* note actually ends 1 frame before the end point, not at the
+               * end point */
+              if (_time > 0)
+                {
+                  _time--;
+                }
+
+              if constexpr (std::is_same_v<RegionT, MidiRegion>)
+                {
+                  midi_events.add_note_off (
+                    r->get_midi_ch (), obj.pitch_, _time);
+                }
+              else if constexpr (std::is_same_v<ObjectType, ChordObject>)
+                {
+                  const auto * descr = obj.get_chord_descriptor ();
+                  for (
+                    size_t l = 0; l < ChordObject::ChordDescriptor::MAX_NOTES;
+                    l++)
+                    {
+                      if (descr->notes_[l])
+                        {
+                          midi_events.add_note_off (1, l + 36, _time);
+                        }
+                    }
+                }
+            }
+        };
 
       /* process each object */
       if constexpr (std::is_same_v<RegionT, MidiRegion>)
         {
-          for (const auto &mn : get_derived ().midi_notes_)
+          const auto &mr = get_derived ();
+          if (mr.has_note_index ())
             {
-              process_object (*mn);
+              /* only visit the notes that start or end in this range, using
+               * the packed note data (same logic as process_object_start()
+               * and process_object_end()) */
+              const auto midi_ch = r->get_midi_ch ();
+              const auto starting =
+                mr.get_notes_starting_in (r_local_pos, r_local_end);
+              for (size_t i = 0; i < starting.size (); ++i)
+                {
+                  const auto start_frames = starting.frames_[i];
+                  if (start_frames < 0)
+                    continue;
+
+                  midi_events.add_note_on (
+                    midi_ch, starting.pitches_[i], starting.velocities_[i],
+                    (midi_time_t) (time_nfo.local_offset_
+                                   + (start_frames - r_local_pos)));
+                }
+              const auto ending =
+                mr.get_notes_ending_in (r_local_pos, r_local_end);
+              for (size_t i = 0; i < ending.size (); ++i)
+                {
+                  auto _time =
+                    (midi_time_t) (time_nfo.local_offset_
+                                   + (ending.frames_[i] - r_local_pos));
+                  if (_time > 0)
+                    {
+                      _time--;
+                    }
+                  midi_events.add_note_off (midi_ch, ending.pitches_[i], _time);
+                }
+            }
+          else
+            {
+              for (const auto &mn : mr.midi_notes_)
+                {
+                  process_object_start (*mn);
+                  process_object_end (*mn);
+                }
             }
         }
       else if constexpr (std::is_same_v<RegionT, ChordRegion>)
         {
           for (const auto &co : get_derived ().chord_objects_)
             {
-              process_object (*co);
+              process_object_start (*co);
+              process_object_end (*co);
             }
         }
     },
@@ -625,34 +669,8 @@ RegionImpl<RegionT>::stretch (double ratio)
     }
   else if constexpr (is_audio ())
     {
-      auto * clip = get_derived ().get_clip ();
-      int new_clip_id = AUDIO_POOL->duplicate_clip (clip->get_pool_id (), false);
-      z_return_if_fail (new_clip_id >= 0);
-      auto * new_clip = AUDIO_POOL->get_clip (new_clip_id);
-      get_derived ().set_clip_id (new_clip->get_pool_id ());
-
-      auto stretcher = dsp::Stretcher::create_rubberband (
-        AUDIO_ENGINE->sample_rate_, new_clip->get_num_channels (), ratio, 1.0,
-        false);
-
-      auto buf = new_clip->get_samples ();
-      buf.interleave_samples ();
-      auto stretched_buf = stretcher->stretch_interleaved (buf);
-      stretched_buf.deinterleave_samples (new_clip->get_num_channels ());
-      new_clip->clear_frames ();
-      new_clip->expand_with_frames (stretched_buf);
-      auto num_frames_per_channel = new_clip->get_num_frames ();
-      z_return_if_fail (num_frames_per_channel > 0);
-
-      AUDIO_POOL->write_clip (*new_clip, false, false);
-
-      /* readjust end position to match the number of frames exactly */
-      dsp::Position new_end_pos (
-        static_cast<signed_frame_t> (num_frames_per_channel),
-        AUDIO_ENGINE->ticks_per_frame_);
-      set_position (&new_end_pos, ArrangerObject::PositionType::LoopEnd, false);
-      new_end_pos.add_frames (pos_->frames_, AUDIO_ENGINE->ticks_per_frame_);
-      set_position (&new_end_pos, ArrangerObject::PositionType::End, false);
+      auto &self = get_derived ();
+      self.apply_stretched_frames (self.get_stretched_frames (ratio));
     }
   else
     {
@@ -902,11 +920,7 @@ void
 Region::update_link_group ()
 {
   z_debug ("updating link group {}", id_.link_group_);
-  if (id_.link_group_ >= 0)
-    {
-      auto group = REGION_LINK_GROUP_MANAGER.get_group (id_.link_group_);
-      group->update (*this);
-    }
+  REGION_LINK_GROUP_MANAGER.update_linked_regions (*this);
 }
 
 template <typename RegionT>
@@ -1041,6 +1055,15 @@ Region::print_to_str () const
     end_pos_->ticks_ - pos_->ticks_, loop_end_pos_, id_.link_group_);
 }
 
+void
+Region::invalidate_playback_snapshot ()
+{
+  playback_snapshot_valid_ = false;
+
+  /* the region may have moved */
+  RegionList::invalidate_indices ();
+}
+
 template <typename RegionT>
 RegionT *
 RegionImpl<RegionT>::at_position (
@@ -1048,19 +1071,10 @@ RegionImpl<RegionT>::at_position (
   const AutomationTrack * at,
   const dsp::Position     pos)
 {
-  auto region_is_at_pos = [&pos] (const auto &region) {
-    return *std::get<RegionT *> (region)->pos_ <= pos
-           && *std::get<RegionT *> (region)->end_pos_ >= pos;
-  };
-
   if constexpr (is_automation ())
     {
       z_return_val_if_fail (at, nullptr);
-      auto it =
-        std::ranges::find_if (at->region_list_->regions_, region_is_at_pos);
-      return it != at->region_list_->regions_.end ()
-               ? std::get<RegionT *> (*it)
-               : nullptr;
+      return at->get_region_at_pos (pos, true);
     }
   else
     {
@@ -1074,20 +1088,13 @@ RegionImpl<RegionT>::at_position (
           for (auto &lane_var : laned_track->lanes_)
             {
               auto lane = std::get<TrackLaneT *> (lane_var);
-              auto it = std::ranges::find_if (
-                lane->region_list_->regions_, region_is_at_pos);
-              return it != at->region_list_->regions_.end ()
-                       ? std::get<RegionT *> (*it)
-                       : nullptr;
+              if (auto * region = lane->get_region_at_pos (pos, true))
+                return region;
             }
         }
       else if constexpr (is_chord ())
         {
-          auto it = std::ranges::find_if (
-            P_CHORD_TRACK->region_list_->regions_, region_is_at_pos);
-          return it != at->region_list_->regions_.end ()
-                   ? std::get<RegionT *> (*it)
-                   : nullptr;
+          return P_CHORD_TRACK->get_region_at_pos (pos, true);
         }
     }
 
@@ -1216,15 +1223,6 @@ Region::get_at_pos (
   AutomationTrack *   at,
   bool                include_region_end)
 {
-  auto is_at_pos = [&] (const auto &region_var) {
-    return std::visit (
-      [&] (auto &&region) {
-        return *region->pos_ <= pos
-               && (include_region_end ? *region->end_pos_ >= pos : *region->end_pos_ > pos);
-      },
-      region_var);
-  };
-
   if (track)
     {
       if (track->has_lanes ())
@@ -1238,16 +1236,10 @@ Region::get_at_pos (
                 {
                   using TrackLaneT = T::LanedTrackImpl::TrackLaneType;
                   auto lane = std::get<TrackLaneT *> (lane_var);
-                  auto ret = lane->get_region_at_pos (pos, include_region_end);
-                  if (ret)
-                    return ret;
-
-                  auto it = std::ranges::find_if (
-                    lane->region_list_->regions_, is_at_pos);
-                  if (it != lane->region_list_->regions_.end ())
-                    {
-                      return *it;
-                    }
+                  if (
+                    auto * region =
+                      lane->get_region_at_pos (pos, include_region_end))
+                    return region;
                 }
               return std::nullopt;
             },
@@ -1256,22 +1248,17 @@ Region::get_at_pos (
       else if (track->is_chord ())
         {
           auto * chord_track = dynamic_cast<ChordTrack *> (track);
-          auto   it = std::ranges::find_if (
-            chord_track->region_list_->regions_, is_at_pos);
-          if (it != chord_track->region_list_->regions_.end ())
-            {
-              return *it;
-            }
+          if (
+            auto * region =
+              chord_track->get_region_at_pos (pos, include_region_end))
+            return region;
           return std::nullopt;
         }
     }
   else if (at)
     {
-      auto it = std::ranges::find_if (at->region_list_->regions_, is_at_pos);
-      if (it != at->region_list_->regions_.end ())
-        {
-          return *it;
-        }
+      if (auto * region = at->get_region_at_pos (pos, include_region_end))
+        return region;
       return std::nullopt;
     }
   z_return_val_if_reached (std::nullopt);
@@ -228,6 +228,16 @@ public:
    */
   void update_link_group ();
 
+  /**
+   * @brief Marks the playback snapshot of this region as outdated, so that
+   * the next snapshot update clones this region again.
+   *
+   * Must be called after changing a region (or its children) without
+   * regenerating all the snapshots of its track (see
+   * Track::update_playback_snapshots()).
+   */
+  void invalidate_playback_snapshot ();
+
   static std::optional<RegionPtrVariant> find (const RegionIdentifier &id);
 
   /**
@@ -277,6 +287,15 @@ public:
   /** Unique ID. */
   RegionIdentifier id_;
 
+  /**
+   * Whether the playback snapshot of this region (if any) is up to date.
+   *
+   * Not copied when cloning, so new regions always get a new snapshot.
+   *
+   * @see RegionOwnerImpl::update_region_snapshots().
+   */
+  bool playback_snapshot_valid_ = false;
+
   /**
    * Set to ON during bouncing if this region should be included.
    *
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: © 2020, 2023-2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include "gui/backend/backend/project.h"
+#include "gui/dsp/region.h"
 #include "gui/dsp/region_link_group_manager.h"
 
 #include "utils/logger.h"
@@ -55,3 +57,58 @@ RegionLinkGroupManager::remove_group (int group_id)
     }
   groups_.pop_back ();
 }
+
+void
+RegionLinkGroupManager::update_linked_regions (Region &region)
+{
+  if (region.id_.link_group_ < 0)
+    return;
+
+  if (deferred_updates_depth_ > 0)
+    {
+      if (!std::ranges::contains (queued_regions_, region.get_uuid ()))
+        {
+          queued_regions_.push_back (region.get_uuid ());
+        }
+      return;
+    }
+
+  auto * group = get_group (region.id_.link_group_);
+  z_return_if_fail (group);
+  group->update (region);
+}
+
+void
+RegionLinkGroupManager::end_deferred_updates ()
+{
+  z_return_if_fail (deferred_updates_depth_ > 0);
+  if (--deferred_updates_depth_ > 0)
+    return;
+
+  const auto       region_ids = std::exchange (queued_regions_, {});
+  std::vector<int> updated_groups;
+  for (const auto &region_id : region_ids)
+    {
+      /* the region may have been removed since it was queued */
+      auto obj_var = PROJECT->find_arranger_object_by_id (region_id);
+      if (!obj_var)
+        continue;
+
+      std::visit (
+        [&] (auto &&obj) {
+          using ObjT = base_type<decltype (obj)>;
+          if constexpr (std::derived_from<ObjT, Region>)
+            {
+              const int group_idx = obj->id_.link_group_;
+              if (
+                group_idx < 0
+                || std::ranges::contains (updated_groups, group_idx))
+                return;
+
+              updated_groups.push_back (group_idx);
+              update_linked_regions (*obj);
+            }
+        },
+        obj_var->get ());
+    }
+}
@@ -4,6 +4,7 @@
 #ifndef __AUDIO_REGION_LINK_GROUP_MANAGER_H__
 #define __AUDIO_REGION_LINK_GROUP_MANAGER_H__
 
+#include "gui/dsp/arranger_object.h"
 #include "gui/dsp/region_link_group.h"
 
 #include "utils/format.h"
@@ -37,11 +38,59 @@ public:
 
   bool validate () const;
 
+  /**
+   * @brief Updates the regions linked to @p region with its children.
+   *
+   * While updates are deferred, the region is only queued.
+   */
+  void update_linked_regions (Region &region);
+
+  /**
+   * @brief Defers updating linked regions until the matching
+   * end_deferred_updates().
+   *
+   * Once all regions in a group are updated, they have the same children, so
+   * each group only needs to be updated once no matter how many of its
+   * regions' children changed. This makes editing many objects of a linked
+   * region cost one update instead of one per object.
+   */
+  void begin_deferred_updates () { ++deferred_updates_depth_; }
+
+  /**
+   * @brief Updates each group with queued regions once, from the first
+   * region queued in the group (same result as updating them as they were
+   * queued).
+   */
+  void end_deferred_updates ();
+
+  /**
+   * @brief RAII helper for begin_deferred_updates()/end_deferred_updates().
+   */
+  class DeferredUpdates
+  {
+  public:
+    explicit DeferredUpdates (RegionLinkGroupManager &mgr) : mgr_ (mgr)
+    {
+      mgr_.begin_deferred_updates ();
+    }
+    ~DeferredUpdates () { mgr_.end_deferred_updates (); }
+    Z_DISABLE_COPY_MOVE (DeferredUpdates)
+
+  private:
+    RegionLinkGroupManager &mgr_;
+  };
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 public:
   /** Region link groups. */
   std::vector<RegionLinkGroup> groups_;
+
+private:
+  int deferred_updates_depth_ = 0;
+
+  /** Regions queued while updates are deferred, in order. */
+  std::vector<ArrangerObject::Uuid> queued_regions_;
 };
 
 DEFINE_OBJECT_FORMATTER (
@@ -61,5 +61,20 @@ RegionList::clear ()
 {
   beginResetModel ();
   regions_.clear ();
+  invalidate_indices ();
   endResetModel ();
 }
+
+const zrythm::utils::IntervalIndex &
+RegionList::get_index () const
+{
+  const auto generation = index_generation_.load (std::memory_order_relaxed);
+  if (
+    index_built_generation_ != generation
+    || index_.size () != regions_.size ())
+    {
+      build_index (index_, regions_);
+      index_built_generation_ = generation;
+    }
+  return index_;
+}
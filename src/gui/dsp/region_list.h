@@ -1,6 +1,9 @@
 #pragma once
 
+#include <atomic>
+
 #include "gui/dsp/region.h"
+#include "utils/interval_index.h"
 
 template <typename RegionT> class RegionOwnerImpl;
 
@@ -34,6 +37,56 @@ public:
 
   void clear ();
 
+  /**
+   * @brief Returns an index of @ref regions_ by position, rebuilding it if
+   * any region was added, removed or moved since it was built.
+   *
+   * @note Not realtime-safe (the engine uses the index of the playback
+   * snapshots instead, see RegionOwnerImpl::foreach_region_snapshot_in()).
+   */
+  const zrythm::utils::IntervalIndex &get_index () const;
+
+  /**
+   * @brief Marks the index of every region list as outdated.
+   *
+   * Must be called after adding, removing or moving regions. Positions set
+   * through ArrangerObject::set_position() and regions whose snapshot is
+   * invalidated (see Region::invalidate_playback_snapshot()) already call
+   * this.
+   */
+  static void invalidate_indices ()
+  {
+    index_generation_.fetch_add (1, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Indexes @p regions (pointers, smart pointers or RegionPtrVariant's)
+   * by their [start, end] positions in frames.
+   */
+  template <typename Range>
+  static void
+  build_index (zrythm::utils::IntervalIndex &index, const Range &regions)
+  {
+    std::vector<zrythm::utils::IntervalIndex::Interval> intervals;
+    intervals.reserve (std::ranges::size (regions));
+    for (const auto &region : regions)
+      {
+        const auto add = [&] (const auto &r) {
+          intervals.push_back ({ r->pos_->frames_, r->end_pos_->frames_ });
+        };
+        if constexpr (
+          std::is_same_v<std::ranges::range_value_t<Range>, RegionPtrVariant>)
+          {
+            std::visit (add, region);
+          }
+        else
+          {
+            add (region);
+          }
+      }
+    index.build (intervals);
+  }
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 public:
@@ -43,4 +96,13 @@ public:
    * @note must always be sorted by position.
    */
   std::vector<RegionPtrVariant> regions_;
+
+private:
+  /** Incremented whenever any region is added, removed or moved. */
+  static inline std::atomic<uint64_t> index_generation_ = 0;
+
+  mutable zrythm::utils::IntervalIndex index_;
+
+  /** Value of @ref index_generation_ when @ref index_ was built. */
+  mutable std::optional<uint64_t> index_built_generation_;
 };
@@ -34,7 +34,7 @@ void
 RegionOwnedObjectImpl<RegionT>::get_global_start_pos (Position &pos) const
 {
   auto r = get_region ();
-  pos = *static_cast<Position *> (pos_);
+  pos = *pos_;
   pos.add_ticks (r->pos_->ticks_, AUDIO_ENGINE->frames_per_tick_);
 }
 
@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <unordered_map>
+
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/dsp/audio_region.h"
@@ -41,6 +43,53 @@ RegionOwnerImpl<RegionT>::foreach_region (
     }
 }
 
+template <typename RegionT>
+void
+RegionOwnerImpl<RegionT>::update_region_snapshots (const RegionOwnerImpl &owner)
+{
+  struct UuidHash
+  {
+    size_t operator() (const ArrangerObject::Uuid &uuid) const
+    {
+      return uuid.hash ();
+    }
+  };
+
+  std::unordered_map<ArrangerObject::Uuid, std::unique_ptr<RegionT>, UuidHash>
+    prev_snapshots;
+  prev_snapshots.reserve (region_snapshots_.size ());
+  for (auto &snapshot : region_snapshots_)
+    {
+      const auto uuid = snapshot->get_uuid ();
+      prev_snapshots.emplace (uuid, std::move (snapshot));
+    }
+  region_snapshots_.clear ();
+  region_snapshots_.reserve (owner.region_list_->regions_.size ());
+
+  for (const auto &region_var : owner.region_list_->regions_)
+    {
+      auto * region = std::get<RegionT *> (region_var);
+      if (region->playback_snapshot_valid_)
+        {
+          auto it = prev_snapshots.find (region->get_uuid ());
+          if (it != prev_snapshots.end ())
+            {
+              region_snapshots_.push_back (std::move (it->second));
+              continue;
+            }
+        }
+
+      auto &snapshot = region_snapshots_.emplace_back (region->clone_unique ());
+      if constexpr (std::is_same_v<RegionT, MidiRegion>)
+        {
+          snapshot->build_note_index ();
+        }
+      region->playback_snapshot_valid_ = true;
+    }
+
+  RegionList::build_index (region_snapshot_index_, region_snapshots_);
+}
+
 template <typename RegionT>
 void
 RegionOwnerImpl<RegionT>::copy_members_from (
@@ -76,7 +125,10 @@ RegionOwnerImpl<
 
   const auto remove_idx =
     std::distance (region_list_->regions_.begin (), it_to_remove);
-  region_list_->beginRemoveRows ({}, remove_idx, remove_idx);
+  if (!clearing_)
+    {
+      region_list_->beginRemoveRows ({}, remove_idx, remove_idx);
+    }
 
   if (is_in_active_project () && !is_auditioner ())
     {
@@ -118,6 +170,7 @@ RegionOwnerImpl<
     }
 
   auto next_it = region_list_->regions_.erase (it_to_remove);
+  RegionList::invalidate_indices ();
   region.setParent (nullptr);
   if (free_region)
     {
@@ -139,7 +192,10 @@ RegionOwnerImpl<
 
   after_remove_region ();
 
-  region_list_->endRemoveRows ();
+  if (!clearing_)
+    {
+      region_list_->endRemoveRows ();
+    }
 
   return true;
 }
@@ -148,16 +204,25 @@ template <typename RegionT>
 void
 RegionOwnerImpl<RegionT>::clear_regions ()
 {
-  region_list_->beginResetModel ();
+  /* remove all the rows at once instead of one by one */
+  const int num_regions = static_cast<int> (region_list_->regions_.size ());
+  if (num_regions > 0)
+    {
+      region_list_->beginRemoveRows ({}, 0, num_regions - 1);
+    }
   clearing_ = true;
-  for (int i = region_list_->regions_.size (); i > 0; --i)
+  for (int i = num_regions; i > 0; --i)
     {
       remove_region (
         *std::get<RegionT *> (region_list_->regions_.at (i - 1)), true, false);
     }
   region_snapshots_.clear ();
+  region_snapshot_index_.clear ();
   clearing_ = false;
-  region_list_->endResetModel ();
+  if (num_regions > 0)
+    {
+      region_list_->endRemoveRows ();
+    }
 }
 
 template <typename RegionT>
@@ -170,6 +235,7 @@ RegionOwnerImpl<RegionT>::insert_region (RegionTPtr region, int idx)
 
   region_list_->beginInsertRows ({}, idx, idx);
   region_list_->regions_.insert (region_list_->regions_.begin () + idx, region);
+  RegionList::invalidate_indices ();
   region->setParent (region_list_);
 
   if constexpr (std::is_same_v<RegionT, AutomationRegion>)
@@ -98,14 +98,11 @@ public:
   RegionT *
   get_region_at_pos (dsp::Position pos, bool include_region_end = false) const
   {
-    auto it =
-      std::ranges::find_if (region_list_->regions_, [&] (const auto &r_var) {
-        return *std::get<RegionT *> (r_var)->pos_ <= pos
-               && std::get<RegionT *> (r_var)->end_pos_->frames_
-                      + (include_region_end ? 1 : 0)
-                    > pos.frames_;
-      });
-    return it != region_list_->regions_.end () ? std::get<RegionT *> (*it) : nullptr;
+    const auto index = region_list_->get_index ().find_first_overlapping (
+      pos.frames_ + (include_region_end ? 0 : 1), pos.frames_);
+    return index
+             ? std::get<RegionT *> (region_list_->regions_[*index])
+             : nullptr;
   }
 
   void clear_regions ();
@@ -116,6 +113,44 @@ public:
 
   void foreach_region (std::function<void (RegionT &)> func) const;
 
+  /**
+   * @brief Updates @ref region_snapshots_ to contain a snapshot of each region
+   * of @p owner.
+   *
+   * The existing snapshots of regions whose snapshot is still valid (see
+   * Region::invalidate_playback_snapshot()) are reused, so only the regions
+   * that changed are cloned.
+   *
+   * @param owner The owner of the regions (this, or the object this is a
+   * snapshot of).
+   */
+  void update_region_snapshots (const RegionOwnerImpl &owner);
+
+  /**
+   * @brief Calls @p func with each region snapshot overlapping [@p from,
+   * @p to] (in global frames, inclusive), in order of position.
+   *
+   * @note Realtime-safe.
+   */
+  template <typename Func>
+  void foreach_region_snapshot_in (
+    signed_frame_t from,
+    signed_frame_t to,
+    Func         &&func) const
+  {
+    region_snapshot_index_.for_each_overlapping (from, to, [&] (size_t i) {
+      func (*region_snapshots_[i]);
+    });
+  }
+
+  /**
+   * @brief Returns the index of @ref region_snapshots_ by position.
+   */
+  const zrythm::utils::IntervalIndex &get_region_snapshot_index () const
+  {
+    return region_snapshot_index_;
+  }
+
 protected:
   RegionOwnerImpl ();
 
@@ -137,6 +172,10 @@ public:
   /** Snapshots used during playback, if applicable. */
   std::vector<std::unique_ptr<RegionT>> region_snapshots_;
 
+private:
+  /** Index of @ref region_snapshots_, rebuilt along with them. */
+  zrythm::utils::IntervalIndex region_snapshot_index_;
+
 protected:
   /**
    * @brief Whether currently in the middle of @ref clear_regions().
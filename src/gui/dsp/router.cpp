@@ -32,7 +32,10 @@
 #include "gui/dsp/control_port.h"
 #include "gui/dsp/engine.h"
 #include "gui/dsp/project_graph_builder.h"
+#include "utils/cpu_affinity.h"
 #include "utils/debug.h"
+#include "utils/env.h"
+#include "utils/tracing.h"
 #if HAVE_JACK
 #  include "gui/dsp/engine_jack.h"
 #endif
@@ -83,6 +86,14 @@ Router::start_cycle (EngineProcessTimeInfo time_nfo)
       return;
     }
 
+  /* latency changes are applied at the cycle boundary */
+  if (scheduler_->apply_pending_latency_updates ())
+    {
+      get_max_route_playback_latency ();
+      AUDIO_ENGINE->remaining_latency_preroll_ = std::min (
+        AUDIO_ENGINE->remaining_latency_preroll_, max_route_playback_latency_);
+    }
+
   global_offset_ =
     max_route_playback_latency_ - AUDIO_ENGINE->remaining_latency_preroll_;
   time_nfo_ = time_nfo;
@@ -93,6 +104,9 @@ Router::start_cycle (EngineProcessTimeInfo time_nfo)
   ControlPort::ChangeEvent change{};
   while (ctrl_port_change_queue_.read (change))
     {
+      /* tempo changes move everything rendered ahead */
+      invalidate_rendered_ahead ();
+
       if (ENUM_BITSET_TEST (change.flag1, dsp::PortIdentifier::Flags::Bpm))
         {
           P_TEMPO_TRACK->set_bpm (change.real_val, 0.f, true, true);
@@ -117,31 +131,129 @@ Router::start_cycle (EngineProcessTimeInfo time_nfo)
 void
 Router::recalc_graph (bool soft)
 {
+  Z_TRACE_ZONE ("Router::recalc_graph");
+
+  if (deferred_recalc_depth_ > 0)
+    {
+      defer_recalc (soft);
+      return;
+    }
+
   z_info ("Recalculating{}...", soft ? " (soft)" : "");
 
   auto rebuild_graph = [&] () {
     graph_setup_in_progress_.store (true);
-    ProjectGraphBuilder builder (*PROJECT, true);
+    ProjectGraphBuilder builder (*PROJECT, true, bounced_tracks_only_);
     dsp::Graph          graph;
-    builder.build_graph (graph);
+
+    /* diff against the live graph so that only the latencies affected by the
+     * changes are recalculated */
+    auto      &live_nodes = scheduler_->get_nodes ();
+    const bool topology_changed = builder.build_graph (
+      graph, live_nodes.graph_nodes_.empty () ? nullptr : &live_nodes);
     PROJECT->clip_editor_->set_caches ();
     TRACKLIST->get_track_span ().set_caches (ALL_CACHE_TYPES);
-    scheduler_->rechain_from_node_collection (graph.steal_nodes ());
+    TRACKLIST->invalidate_solo_state ();
+    if (
+      auto * renderer = get_anticipative_renderer ();
+      renderer
+      && renderer->get_block_length () != AUDIO_ENGINE->block_length_)
+      {
+        renderer->pause ();
+        renderer->set_block_length (AUDIO_ENGINE->block_length_);
+        renderer->resume ();
+      }
+    if (topology_changed)
+      {
+        graph.fuse_linear_chains ();
+        scheduler_->rechain_from_node_collection (graph.steal_nodes ());
+      }
+    else
+      {
+        z_debug ("graph topology unchanged, keeping live graph");
+        live_nodes.update_latencies_incrementally ({});
+        live_nodes.update_critical_path_priorities ();
+        scheduler_->reassign_rendered_ahead_nodes ();
+      }
+    auto * renderer = get_anticipative_renderer ();
+    if (renderer)
+      renderer->pause ();
+    AUDIO_ENGINE->rebuild_port_buffer_arena (scheduler_->get_nodes ());
+    if (renderer)
+      renderer->resume ();
     graph_setup_in_progress_.store (false);
   };
 
   if (!scheduler_ && !soft)
     {
-      scheduler_ = std::make_unique<dsp::GraphScheduler> ();
+      scheduler_ = std::make_unique<dsp::GraphScheduler> (
+        env_get_int ("ZRYTHM_DSP_WORK_STEALING", 0) != 0
+          ? dsp::GraphScheduler::SchedulingStrategy::WorkStealing
+          : dsp::GraphScheduler::SchedulingStrategy::SharedQueue);
+      if (
+        const auto cpus =
+          juce::SystemStats::getEnvironmentVariable ("ZRYTHM_DSP_CPUS", {});
+        cpus.isNotEmpty ())
+        {
+          scheduler_->set_cpu_affinity (
+            utils::cpu::parse_cpu_list (cpus.toStdString ()));
+        }
+      scheduler_->set_idle_spin_duration (std::chrono::microseconds (
+        env_get_int ("ZRYTHM_DSP_SPIN_US", 20)));
+      scheduler_->set_static_schedule_limits (
+        env_get_int ("ZRYTHM_DSP_STATIC_SCHEDULE_MAX_NODES", 16),
+        std::chrono::microseconds (
+          env_get_int ("ZRYTHM_DSP_STATIC_SCHEDULE_MAX_COST_US", 100)));
+      scheduler_->set_trace_recording_enabled (
+        env_get_int ("ZRYTHM_DSP_TRACE_XRUNS", 0) != 0);
+      if (
+        const auto render_ahead_blocks =
+          env_get_int ("ZRYTHM_DSP_RENDER_AHEAD_BLOCKS", 0);
+        render_ahead_blocks > 0)
+        {
+          scheduler_->enable_anticipative_rendering (
+            *TRANSPORT, AUDIO_ENGINE->block_length_,
+            static_cast<size_t> (render_ahead_blocks));
+        }
       rebuild_graph ();
       scheduler_->start_threads ();
+
+      /* the graph nodes are only assigned to NUMA nodes once the threads are
+       * started */
+      if (scheduler_->uses_numa_placement ())
+        {
+          graph_setup_in_progress_.store (true);
+          auto * renderer = get_anticipative_renderer ();
+          if (renderer)
+            renderer->pause ();
+          AUDIO_ENGINE->rebuild_port_buffer_arena (scheduler_->get_nodes ());
+          if (renderer)
+            renderer->resume ();
+          graph_setup_in_progress_.store (false);
+        }
+      latency_update_notifier_ = std::make_unique<utils::MainThreadNotifier> (
+        [this] () { update_latencies (); });
+      if (
+        env_get_int ("ZRYTHM_DSP_CALIBRATE_THREADS", 0) != 0
+        && !AUDIO_ENGINE->run_.load ())
+        {
+          EngineProcessTimeInfo time_nfo{
+            .g_start_frame_ = 0,
+            .g_start_frame_w_offset_ = 0,
+            .local_offset_ = 0,
+            .nframes_ = AUDIO_ENGINE->block_length_,
+          };
+          scheduler_->calibrate_num_threads (
+            time_nfo, utils::audio::get_num_cores ());
+        }
       return;
     }
 
   if (soft)
     {
       graph_access_sem_.acquire ();
-      scheduler_->get_nodes ().update_latencies ();
+      scheduler_->get_nodes ().update_latencies_incrementally ({});
+      scheduler_->get_nodes ().update_critical_path_priorities ();
       graph_access_sem_.release ();
     }
   else
@@ -150,7 +262,7 @@ Router::recalc_graph (bool soft)
       AUDIO_ENGINE->run_.store (false);
       while (AUDIO_ENGINE->cycle_running_.load ())
         {
-          std::this_thread::sleep_for (std::chrono::milliseconds (100));
+          std::this_thread::sleep_for (std::chrono::milliseconds (1));
         }
       rebuild_graph ();
       AUDIO_ENGINE->run_.store (running);
@@ -159,6 +271,189 @@ Router::recalc_graph (bool soft)
   z_info ("done");
 }
 
+void
+Router::begin_deferred_recalc ()
+{
+  ++deferred_recalc_depth_;
+}
+
+void
+Router::defer_recalc (bool soft)
+{
+  if (soft)
+    {
+      /* only latencies change, the engine can keep running */
+      deferred_soft_recalc_needed_ = true;
+      return;
+    }
+
+  deferred_recalc_needed_ = true;
+  if (engine_stopped_for_deferred_recalc_)
+    return;
+
+  running_before_deferred_recalc_ = AUDIO_ENGINE->run_.load ();
+  AUDIO_ENGINE->run_.store (false);
+  while (AUDIO_ENGINE->cycle_running_.load ())
+    {
+      std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+  engine_stopped_for_deferred_recalc_ = true;
+}
+
+void
+Router::end_deferred_recalc ()
+{
+  z_return_if_fail (deferred_recalc_depth_ > 0);
+  if (--deferred_recalc_depth_ > 0)
+    return;
+
+  if (deferred_recalc_needed_)
+    {
+      recalc_graph (false);
+    }
+  else if (deferred_soft_recalc_needed_)
+    {
+      recalc_graph (true);
+    }
+  deferred_recalc_needed_ = false;
+  deferred_soft_recalc_needed_ = false;
+
+  if (engine_stopped_for_deferred_recalc_)
+    {
+      AUDIO_ENGINE->run_.store (running_before_deferred_recalc_);
+      engine_stopped_for_deferred_recalc_ = false;
+    }
+}
+
+void
+Router::reassign_rendered_ahead_nodes ()
+{
+  if (!get_anticipative_renderer ())
+    return;
+
+  bool running = AUDIO_ENGINE->run_.load ();
+  AUDIO_ENGINE->run_.store (false);
+  while (AUDIO_ENGINE->cycle_running_.load ())
+    {
+      std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+  scheduler_->reassign_rendered_ahead_nodes ();
+  AUDIO_ENGINE->run_.store (running);
+}
+
+void
+Router::update_block_length ()
+{
+  auto * renderer = get_anticipative_renderer ();
+  if (!renderer || renderer->get_block_length () == AUDIO_ENGINE->block_length_)
+    return;
+
+  renderer->pause ();
+  renderer->set_block_length (AUDIO_ENGINE->block_length_);
+  reassign_rendered_ahead_nodes ();
+  renderer->resume ();
+}
+
+void
+Router::recalc_graph_connections ()
+{
+  /* the engine is stopped during a batch, so the graph will be rebuilt
+   * directly */
+  if (deferred_recalc_depth_ > 0)
+    {
+      defer_recalc (false);
+      return;
+    }
+
+  if (!scheduler_ || !AUDIO_ENGINE->run_.load ())
+    {
+      recalc_graph (false);
+      return;
+    }
+
+  z_info ("Recalculating connections...");
+
+  ProjectGraphBuilder builder (*PROJECT, true, bounced_tracks_only_);
+  dsp::Graph          graph;
+  if (!builder.build_graph (graph, &scheduler_->get_nodes ()))
+    {
+      recalc_graph (true);
+      return;
+    }
+  graph.fuse_linear_chains ();
+  if (!scheduler_->publish_node_collection (graph.steal_nodes ()))
+    {
+      recalc_graph (false);
+      return;
+    }
+
+  /* wait for the processing threads to switch to the new graph so that the
+   * caller can free anything only the old graph referred to */
+  constexpr auto timeout = std::chrono::milliseconds (500);
+  const auto     start = std::chrono::steady_clock::now ();
+  while (
+    scheduler_->has_pending_node_collection ()
+    && std::chrono::steady_clock::now () - start < timeout)
+    {
+      std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+  if (scheduler_->has_pending_node_collection ())
+    {
+      /* no cycles are running, switch manually */
+      z_info ("processing stalled, switching graph with engine paused");
+      bool running = AUDIO_ENGINE->run_.load ();
+      AUDIO_ENGINE->run_.store (false);
+      while (AUDIO_ENGINE->cycle_running_.load ())
+        {
+          std::this_thread::sleep_for (std::chrono::milliseconds (1));
+        }
+      scheduler_->apply_pending_node_collection ();
+      AUDIO_ENGINE->run_.store (running);
+    }
+  scheduler_->free_retired_node_collections ();
+
+  z_info ("done");
+}
+
+void
+Router::update_latencies ()
+{
+  if (!scheduler_)
+    return;
+
+  if (!AUDIO_ENGINE->run_.load ())
+    {
+      recalc_graph (true);
+      return;
+    }
+
+  auto updates = scheduler_->get_nodes ().compute_latency_updates ({});
+  if (updates.empty ())
+    return;
+
+  z_debug ("applying latency changes of {} nodes", updates.size ());
+  scheduler_->publish_latency_updates (std::move (updates));
+
+  /* wait for the processing thread to apply the updates so that no graph
+   * changes can happen in the meantime */
+  constexpr auto timeout = std::chrono::milliseconds (500);
+  const auto     start = std::chrono::steady_clock::now ();
+  while (
+    scheduler_->has_pending_latency_updates ()
+    && std::chrono::steady_clock::now () - start < timeout)
+    {
+      std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+  if (scheduler_->has_pending_latency_updates ())
+    {
+      /* no cycles are running, apply manually */
+      graph_access_sem_.acquire ();
+      scheduler_->apply_pending_latency_updates ();
+      get_max_route_playback_latency ();
+      graph_access_sem_.release ();
+    }
+}
+
 void
 Router::queue_control_port_change (const ControlPort::ChangeEvent &change)
 {
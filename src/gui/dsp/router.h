@@ -32,6 +32,7 @@
 #include "dsp/graph_scheduler.h"
 #include "gui/dsp/control_port.h"
 #include "gui/dsp/engine.h"
+#include "utils/main_thread_notifier.h"
 #include "utils/rt_thread_id.h"
 #include "utils/types.h"
 
@@ -63,6 +64,104 @@ public:
    */
   void recalc_graph (bool soft);
 
+  /**
+   * Rebuilds the graph after connections changed, without pausing the engine.
+   *
+   * The new graph is built on the calling thread and switched to by the
+   * processing threads at the next cycle boundary, so no cycles are skipped.
+   * Unlike recalc_graph(), track and plugin caches are not refreshed, so this
+   * must only be used when nothing but port connections changed (e.g., when
+   * rerouting sends).
+   *
+   * Falls back to recalc_graph() if the engine is not running or the new graph
+   * can't be switched to without reallocating.
+   */
+  void recalc_graph_connections ();
+
+  /**
+   * @brief Starts a batch of changes during which graph recalculations are
+   * deferred.
+   *
+   * recalc_graph() and recalc_graph_connections() only record that the graph
+   * must be rebuilt. The first (non-soft) request stops the engine until the
+   * outermost batch ends, since the live graph may refer to objects removed
+   * by the following changes. Batches can be nested.
+   */
+  void begin_deferred_recalc ();
+
+  /**
+   * @brief Ends a batch started with begin_deferred_recalc().
+   *
+   * When the outermost batch ends, the graph is recalculated once (if
+   * requested during the batch) and the engine resumes.
+   */
+  void end_deferred_recalc ();
+
+  /**
+   * Requests updating the graph latencies after the latency of a node changed
+   * (e.g., a plugin switched its lookahead mode).
+   *
+   * Realtime-safe. The update runs on the main thread (see update_latencies()).
+   */
+  void queue_latency_update () const
+  {
+    if (latency_update_notifier_)
+      {
+        latency_update_notifier_->notify ();
+      }
+  }
+
+  /**
+   * Recalculates the latencies of the nodes affected by latency changes
+   * without rebuilding the graph or pausing the engine.
+   *
+   * The new latencies are calculated on the calling thread and applied by the
+   * processing thread at the next cycle boundary. Latency compensation has no
+   * delay buffers (see dsp::GraphNode::compensate_latency()), so nothing else
+   * needs to change.
+   */
+  void update_latencies ();
+
+  /**
+   * @brief Returns the renderer of the parts of the graph rendered ahead, or
+   * nullptr if disabled (see ZRYTHM_DSP_RENDER_AHEAD_BLOCKS).
+   */
+  dsp::AnticipativeRenderer * get_anticipative_renderer () const
+  {
+    return scheduler_ ? scheduler_->get_anticipative_renderer () : nullptr;
+  }
+
+  /**
+   * @brief Discards the blocks rendered ahead.
+   *
+   * Must be called when anything that affects what the timeline renders to
+   * changes. Realtime-safe.
+   */
+  void invalidate_rendered_ahead () const
+  {
+    if (auto * renderer = get_anticipative_renderer ())
+      {
+        renderer->invalidate ();
+      }
+  }
+
+  /**
+   * @brief Reassigns the nodes rendered ahead with the engine paused.
+   *
+   * Must be called when something that affects
+   * dsp::IProcessable::can_render_ahead() changes (e.g., when a track starts
+   * recording).
+   */
+  void reassign_rendered_ahead_nodes ();
+
+  /**
+   * @brief Applies a block length change that fits in the allocated port
+   * buffers, without rebuilding the graph.
+   *
+   * @see AudioEngine::realloc_port_buffers().
+   */
+  void update_block_length ();
+
   /**
    * Starts a new cycle.
    */
@@ -97,6 +196,13 @@ public:
         return is_processing_thread;
       }
 
+    /* small graphs are processed directly on the kickoff thread (see
+     * dsp::GraphScheduler::set_static_schedule_limits()) */
+    if (is_processing_kickoff_thread ())
+      {
+        return true;
+      }
+
     if (!scheduler_) [[unlikely]]
       {
         have_result = false;
@@ -146,6 +252,14 @@ public:
 
   bool callback_in_progress_ = false;
 
+  /**
+   * Whether the graph should only contain what is needed to render the tracks
+   * being bounced (see ProjectGraphBuilder).
+   *
+   * Set by the Exporter while bouncing tracks or regions.
+   */
+  bool bounced_tracks_only_ = false;
+
   /** ID of the thread that calls kicks off the cycle. */
   unsigned int process_kickoff_thread_ = 0;
 
@@ -154,6 +268,30 @@ public:
   RingBuffer<ControlPort::ChangeEvent> ctrl_port_change_queue_{ 32 };
 
   AudioEngine * audio_engine_ = nullptr;
+
+  /** Runs update_latencies() on the main thread (created with the graph). */
+  std::unique_ptr<utils::MainThreadNotifier> latency_update_notifier_;
+
+private:
+  /**
+   * @brief Records a recalculation requested during a batch, stopping the
+   * engine if not done yet.
+   */
+  void defer_recalc (bool soft);
+
+private:
+  /** Nesting level of begin_deferred_recalc(). */
+  int deferred_recalc_depth_ = 0;
+
+  /** Whether the engine was stopped for the current batch. */
+  bool engine_stopped_for_deferred_recalc_ = false;
+
+  /** Whether the engine was running before it was stopped for the batch. */
+  bool running_before_deferred_recalc_ = false;
+
+  /** Recalculations requested during the current batch. */
+  bool deferred_recalc_needed_ = false;
+  bool deferred_soft_recalc_needed_ = false;
 };
 
 /**
@@ -81,7 +81,6 @@ SampleProcessor::init_common ()
     *this, audio_engine_->get_port_registry (),
     audio_engine_->get_track_registry (), PORT_CONNECTIONS_MGR);
   midi_events_ = std::make_unique<MidiEvents> ();
-  current_samples_.reserve (256);
 }
 
 void
@@ -111,18 +110,78 @@ SampleProcessor::prepare_process (const nframes_t nframes)
 void
 SampleProcessor::remove_sample_playback (SamplePlayback &in_sp)
 {
-  auto it = std::ranges::find_if (current_samples_, [&in_sp] (const auto &sp) {
-    return &sp == &in_sp;
-  });
+  const auto num = num_current_samples_;
+  for (size_t i = 0; i < num; ++i)
+    {
+      if (&current_samples_[i] == &in_sp)
+        {
+          /* order doesn't matter, so move the last one here */
+          std::swap (current_samples_[i], current_samples_[num - 1]);
+          --num_current_samples_;
+          return;
+        }
+    }
+
+  z_warning ("Sample playback not found for removal");
+}
+
+void
+SampleProcessor::clear_current_samples ()
+{
+  num_current_samples_ = 0;
+}
 
-  if (it != current_samples_.end ())
+void
+SampleProcessor::queue_sample_playback (
+  const std::shared_ptr<zrythm::utils::audio::AudioBuffer> &buf,
+  float                                                     volume,
+  nframes_t                                                 offset)
+{
+  SamplePlayback * slot = nullptr;
+  if (num_current_samples_ < current_samples_.size ())
     {
-      current_samples_.erase (it);
+      slot = &current_samples_[num_current_samples_++];
     }
   else
     {
-      z_warning ("Sample playback not found for removal");
+      /* replace the sample that played the longest */
+      slot = &*std::ranges::max_element (
+        current_samples_, {}, &SamplePlayback::offset_);
     }
+
+  /* (copying the pointer only bumps the refcount) */
+  slot->buf_ = buf;
+  slot->volume_ = volume;
+  slot->start_offset_ = offset;
+  slot->offset_ = 0;
+}
+
+void
+SampleProcessor::queue_countin_ticks (nframes_t cycle_offset, nframes_t nframes)
+{
+  if (
+    const auto requested =
+      requested_countin_frames_.exchange (0, std::memory_order_acq_rel);
+    requested > 0)
+    {
+      countin_pos_ = 0;
+      countin_frames_ = requested;
+    }
+  if (countin_pos_ >= countin_frames_)
+    return;
+
+  /* the count-in ticks are the ticks of the first bars */
+  auto      &metronome = *audio_engine_->metronome_;
+  const auto end = std::min (
+    countin_frames_, countin_pos_ + static_cast<signed_frame_t> (nframes));
+  metronome.update_click_grid (*audio_engine_);
+  metronome.click_schedule_.for_each_click (
+    countin_pos_, end, [&] (const auto &click) {
+      queue_metronome (
+        click.emphasis_ ? Metronome::Type::Emphasis : Metronome::Type::Normal,
+        cycle_offset + static_cast<nframes_t> (click.frame_ - countin_pos_));
+    });
+  countin_pos_ = end;
 }
 
 void
@@ -130,6 +189,7 @@ SampleProcessor::process_block (EngineProcessTimeInfo time_nfo)
 {
   const auto    cycle_offset = time_nfo.local_offset_;
   const auto    nframes = time_nfo.nframes_;
+  const auto    cycle_start_time = time_nfo.cycle_start_time_usecs_;
   SemaphoreRAII lock (rebuilding_sem_);
   if (!lock.is_acquired ())
     {
@@ -141,17 +201,19 @@ SampleProcessor::process_block (EngineProcessTimeInfo time_nfo)
   auto &l = fader_stereo_out_ports.first.buf_;
   auto &r = fader_stereo_out_ports.second.buf_;
 
+  queue_countin_ticks (cycle_offset, nframes);
+
   // Process the samples in the queue
-  for (auto it = current_samples_.begin (); it != current_samples_.end ();)
+  for (size_t i = 0; i < num_current_samples_;)
     {
-      auto &sp = *it;
+      auto &sp = current_samples_[i];
       z_return_if_fail_cmp (sp.buf_->getNumChannels (), >, 0);
 
       // If sample starts after this cycle, update offset and skip processing
       if (sp.start_offset_ >= nframes)
         {
           sp.start_offset_ -= nframes;
-          ++it;
+          ++i;
           continue;
         }
 
@@ -191,17 +253,24 @@ SampleProcessor::process_block (EngineProcessTimeInfo time_nfo)
           process_samples (sp.start_offset_, max_frames);
         }
 
-      // If the sample is finished playing, remove it
+      // If the sample is finished playing, remove it (the last one is moved
+      // here, so don't advance)
       if (sp.offset_ >= (unsigned_frame_t) sp.buf_->getNumSamples ())
         {
-          it = current_samples_.erase (it);
+          std::swap (sp, current_samples_[--num_current_samples_]);
         }
       else
         {
-          ++it;
+          ++i;
         }
     }
 
+  if (file_preview_)
+    {
+      file_preview_->read (
+        &l[cycle_offset], &r[cycle_offset], nframes, fader_->get_amp ());
+    }
+
   if (roll_)
     {
       midi_events_->active_events_.clear ();
@@ -228,6 +297,7 @@ SampleProcessor::process_block (EngineProcessTimeInfo time_nfo)
                       + cycle_offset,
                     .local_offset_ = cycle_offset,
                     .nframes_ = nframes,
+                    .cycle_start_time_usecs_ = cycle_start_time,
                   };
 
                   const float * audio_data_l = nullptr;
@@ -292,34 +362,13 @@ SampleProcessor::queue_metronome_countin ()
   auto bars = ENUM_INT_TO_VALUE (
     PrerollCountBars, gui::SettingsManager::metronomeCountIn ());
   int num_bars = Transport::preroll_count_bars_enum_to_int (bars);
-  int beats_per_bar = P_TEMPO_TRACK->get_beats_per_bar ();
-  int num_beats = beats_per_bar * num_bars;
 
   double frames_per_bar =
     AUDIO_ENGINE->frames_per_tick_
     * static_cast<double> (TRANSPORT->ticks_per_bar_);
-  for (int i = 0; i < num_bars; i++)
-    {
-      long offset = static_cast<long> (static_cast<double> (i) * frames_per_bar);
-      current_samples_.emplace_back (
-        METRONOME->emphasis_, 0.1f * METRONOME->volume_, offset, __FILE__,
-        __func__, __LINE__);
-    }
-
-  double frames_per_beat =
-    AUDIO_ENGINE->frames_per_tick_
-    * static_cast<double> (TRANSPORT->ticks_per_beat_);
-  for (int i = 0; i < num_beats; i++)
-    {
-      if (i % beats_per_bar == 0)
-        continue;
-
-      long offset =
-        static_cast<long> (static_cast<double> (i) * frames_per_beat);
-      current_samples_.emplace_back (
-        METRONOME->normal_, 0.1f * METRONOME->volume_, offset, __FILE__,
-        __func__, __LINE__);
-    }
+  const auto num_frames = static_cast<signed_frame_t> (
+    static_cast<double> (num_bars) * frames_per_bar);
+  requested_countin_frames_.store (num_frames, std::memory_order_release);
 }
 
 void
@@ -330,15 +379,13 @@ SampleProcessor::queue_metronome (Metronome::Type type, nframes_t offset)
 
   if (type == Metronome::Type::Emphasis)
     {
-      current_samples_.emplace_back (
-        METRONOME->emphasis_, 0.1f * METRONOME->volume_, offset, __FILE__,
-        __func__, __LINE__);
+      queue_sample_playback (
+        METRONOME->emphasis_, 0.1f * METRONOME->volume_, offset);
     }
   else if (type == Metronome::Type::Normal)
     {
-      current_samples_.emplace_back (
-        METRONOME->normal_, 0.1f * METRONOME->volume_, offset, __FILE__,
-        __func__, __LINE__);
+      queue_sample_playback (
+        METRONOME->normal_, 0.1f * METRONOME->volume_, offset);
     }
 }
 
@@ -353,7 +400,11 @@ SampleProcessor::queue_file_or_chord_preset (
   const FileDescriptor * file,
   const ChordPreset *    chord_pset)
 {
-  SemaphoreRAII<std::binary_semaphore> sem_raii (rebuilding_sem_);
+  /* destroyed (cancelled) after the lock is released */
+  std::unique_ptr<dsp::FilePreviewStream> prev_file_preview;
+
+  SemaphoreRAII<std::binary_semaphore> sem_raii (rebuilding_sem_, true);
+  prev_file_preview = std::move (file_preview_);
 
   /* clear tracks */
   for (auto track_var : tracklist_->get_track_span () | std::views::reverse)
@@ -379,6 +430,18 @@ SampleProcessor::queue_file_or_chord_preset (
         track_var);
     }
 
+  /* stream audio files from disk (playback starts as soon as the first
+   * chunk is decoded instead of after the whole file is loaded) */
+  if (file && file->is_audio ())
+    {
+      roll_ = false;
+      file_preview_ = std::make_unique<dsp::FilePreviewStream> (
+        file->abs_path_, audio_engine_->sample_rate_,
+        dsp::FilePreviewStream::DEFAULT_PREFETCH_FRAMES,
+        &audio_engine_->quality_governor_);
+      return;
+    }
+
   Position start_pos;
   auto     transport = audio_engine_->project_->transport_;
   start_pos.set_to_bar (
@@ -399,33 +462,7 @@ SampleProcessor::queue_file_or_chord_preset (
       false);
   }
 
-  if (file && file->is_audio ())
-    {
-      z_debug ("creating audio track...");
-      auto * audio_track =
-        PROJECT->get_track_registry ().create_object<AudioTrack> (
-          PROJECT->get_track_registry (), PROJECT->get_plugin_registry (),
-          PROJECT->get_port_registry (), true);
-      audio_track->set_name (*tracklist_, "Sample processor audio", false);
-      tracklist_->insert_track (
-        audio_track->get_uuid (), tracklist_->tracks_.size (), *AUDIO_ENGINE,
-        false, false);
-
-      /* create an audio region & add to track */
-      try
-        {
-          auto ar = new AudioRegion (
-            file->abs_path_, start_pos, audio_track->get_uuid (), 0, 0);
-          audio_track->add_region (ar, nullptr, 0, true, false);
-          file_end_pos_ = *ar->end_pos_;
-        }
-      catch (const ZrythmException &e)
-        {
-          e.handle ("Failed to create/add audio region for sample processor");
-          return;
-        }
-    }
-  else if (((file && file->is_midi ()) || chord_pset) && instrument_setting_)
+  if (((file && file->is_midi ()) || chord_pset) && instrument_setting_)
     {
       /* create an instrument track */
       z_debug ("creating instrument track...");
@@ -482,7 +519,7 @@ SampleProcessor::queue_file_or_chord_preset (
                         mr, nullptr, 0, !mr->name_.empty () ? false : true,
                         false);
                       file_end_pos_ = std::max (
-                        file_end_pos_, *static_cast<Position *> (mr->end_pos_));
+                        file_end_pos_, *mr->end_pos_);
                     }
                   catch (const ZrythmException &e)
                     {
@@ -531,7 +568,7 @@ SampleProcessor::queue_file_or_chord_preset (
                     }
 
                   file_end_pos_ = std::max (
-                    file_end_pos_, *static_cast<Position *> (mr->end_pos_));
+                    file_end_pos_, *mr->end_pos_);
 
                   try
                     {
@@ -593,6 +630,14 @@ SampleProcessor::queue_chord_preset (const ChordPreset &chord_pset)
 void
 SampleProcessor::stop_file_playback ()
 {
+  /* cancel the stream outside the lock so that the engine isn't blocked */
+  std::unique_ptr<dsp::FilePreviewStream> file_preview;
+  {
+    SemaphoreRAII<std::binary_semaphore> sem_raii (rebuilding_sem_, true);
+    file_preview = std::move (file_preview_);
+  }
+  file_preview.reset ();
+
   roll_ = false;
   auto * transport = audio_engine_->project_->transport_;
   playhead_.set_to_bar (
@@ -629,107 +674,16 @@ SampleProcessor::find_and_queue_metronome (
   if (start_pos.frames_ == end_pos.frames_)
     return;
 
-  const auto  &audio_engine = *audio_engine_;
-  const auto  &transport = *audio_engine.project_->transport_;
-  const auto * tempo_track_ptr = get_tempo_track ();
-  z_return_if_fail (tempo_track_ptr);
-  const auto &tempo_track = *tempo_track_ptr;
-
-  /* find each bar / beat change from start to finish */
-  int num_bars_before = start_pos.get_total_bars (
-    false, transport.ticks_per_bar_, audio_engine_->frames_per_tick_);
-  int num_bars_after = end_pos.get_total_bars (
-    false, transport.ticks_per_bar_, audio_engine_->frames_per_tick_);
-  int bars_diff = num_bars_after - num_bars_before;
-
-#if 0
-  char start_pos_str[60];
-  char end_pos_str[60];
-  position_to_string (start_pos, start_pos_str);
-  position_to_string (end_pos, end_pos_str);
-  z_info (
-    "%s: %s ~ %s <num bars before %d after %d>",
-    __func__, start_pos_str, end_pos_str,
-    num_bars_before, num_bars_after);
-#endif
-
-  /* handle start (not caught below) */
-  if (start_pos.frames_ == 0)
-    {
-      queue_metronome (Metronome::Type::Emphasis, loffset);
-    }
-
-  for (int i = 0; i < bars_diff; i++)
-    {
-      /* get position of bar */
-      Position bar_pos;
-      bar_pos.add_bars (
-        num_bars_before + i + 1, transport.ticks_per_bar_,
-        audio_engine_->frames_per_tick_);
-
-      /* offset of bar pos from start pos */
-      signed_frame_t bar_offset_long = bar_pos.frames_ - start_pos.frames_;
-      if (bar_offset_long < 0)
-        {
-          z_warning ("bar pos: {} | start pos {}", bar_pos, start_pos);
-          z_error ("bar offset long ({}) is < 0", bar_offset_long);
-          return;
-        }
-
-      /* add local offset */
-      signed_frame_t metronome_offset_long =
-        bar_offset_long + (signed_frame_t) loffset;
-      z_return_if_fail_cmp (metronome_offset_long, >=, 0);
-      auto metronome_offset = (nframes_t) metronome_offset_long;
-      z_return_if_fail_cmp (metronome_offset, <, audio_engine_->block_length_);
-      queue_metronome (Metronome::Type::Emphasis, metronome_offset);
-    }
-
-  int num_beats_before = start_pos.get_total_beats (
-    false, tempo_track.get_beats_per_bar (), transport.ticks_per_beat_,
-    audio_engine_->frames_per_tick_);
-  int num_beats_after = end_pos.get_total_beats (
-    false, tempo_track.get_beats_per_bar (), transport.ticks_per_beat_,
-    audio_engine_->frames_per_tick_);
-  int beats_diff = num_beats_after - num_beats_before;
-
-  for (int i = 0; i < beats_diff; i++)
-    {
-      /* get position of beat */
-      Position beat_pos;
-      beat_pos.add_beats (
-        num_beats_before + i + 1, transport.ticks_per_beat_,
-        audio_engine_->frames_per_tick_);
-
-      /* if not a bar (already handled above) */
-      if (
-        beat_pos.get_beats (
-          true, tempo_track.get_beats_per_bar (), transport.ticks_per_beat_)
-        != 1)
-        {
-          /* adjust position because even though the start and beat pos have the
-           * same ticks, their frames differ (the beat position might be before
-           * the start position in frames) */
-          if (beat_pos.frames_ < start_pos.frames_)
-            {
-              beat_pos.frames_ = start_pos.frames_;
-            }
-
-          /* offset of beat pos from start pos */
-          signed_frame_t beat_offset_long = beat_pos.frames_ - start_pos.frames_;
-          z_return_if_fail_cmp (beat_offset_long, >=, 0);
-
-          /* add local offset */
-          signed_frame_t metronome_offset_long =
-            beat_offset_long + (signed_frame_t) loffset;
-          z_return_if_fail_cmp (metronome_offset_long, >=, 0);
-
-          auto metronome_offset = (nframes_t) metronome_offset_long;
-          z_return_if_fail_cmp (
-            metronome_offset, <, AUDIO_ENGINE->block_length_);
-          queue_metronome (Metronome::Type::Normal, metronome_offset);
-        }
-    }
+  audio_engine_->metronome_->click_schedule_.for_each_click (
+    start_pos.frames_, end_pos.frames_, [&] (const auto &click) {
+      /* offset of the click from start pos, plus the local offset */
+      const auto offset =
+        static_cast<nframes_t> (click.frame_ - start_pos.frames_) + loffset;
+      z_return_if_fail_cmp (offset, <, audio_engine_->block_length_);
+      queue_metronome (
+        click.emphasis_ ? Metronome::Type::Emphasis : Metronome::Type::Normal,
+        offset);
+    });
 }
 
 bool
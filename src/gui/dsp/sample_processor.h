@@ -4,6 +4,11 @@
 #ifndef DSP_SAMPLE_PROCESSOR_H
 #define DSP_SAMPLE_PROCESSOR_H
 
+#include <array>
+#include <atomic>
+#include <span>
+
+#include "dsp/file_preview_stream.h"
 #include "dsp/graph.h"
 #include "dsp/position.h"
 #include "gui/backend/backend/settings/plugin_settings.h"
@@ -43,6 +48,13 @@ class SampleProcessor final
 public:
   using Position = zrythm::dsp::Position;
 
+  /**
+   * Max number of samples (e.g., metronome clicks) playing at once.
+   *
+   * When exceeded, the sample that played the longest is replaced.
+   */
+  static constexpr size_t MAX_SAMPLE_PLAYBACKS = 32;
+
 public:
   SampleProcessor () = default;
   SampleProcessor (AudioEngine * engine);
@@ -83,10 +95,21 @@ public:
    */
   void remove_sample_playback (SamplePlayback &sp);
 
+  /** Samples currently being played. */
+  std::span<const SamplePlayback> get_current_samples () const
+  {
+    return { current_samples_.data (), num_current_samples_ };
+  }
+
+  /** Stops all samples currently being played. */
+  void clear_current_samples ();
+
   /**
-   * Queues a metronomem tick at the given offset.
+   * Queues the metronome ticks of the count-in, starting from the next
+   * cycle.
    *
-   * Used for countin.
+   * The ticks are queued by the processing thread as the count-in
+   * progresses.
    */
   void queue_metronome_countin ();
 
@@ -133,6 +156,8 @@ public:
    * within the given range and adds them to the
    * queue.
    *
+   * Uses the precomputed Metronome::click_schedule_.
+   *
    * @param end_pos End position, exclusive.
    * @param loffset Local offset (this is where @p start_pos starts at).
    */
@@ -150,11 +175,43 @@ private:
     const FileDescriptor * file,
     const ChordPreset *    chord_pset);
 
+  /**
+   * Starts playing @p buf at @p offset in a free playback slot.
+   *
+   * Realtime-safe (does not allocate).
+   */
+  void queue_sample_playback (
+    const std::shared_ptr<zrythm::utils::audio::AudioBuffer> &buf,
+    float                                                     volume,
+    nframes_t                                                 offset);
+
+  /** Queues the count-in ticks within this cycle, if any. */
+  void queue_countin_ticks (nframes_t cycle_offset, nframes_t nframes);
+
+private:
+  /**
+   * Preallocated slots for the samples currently being played (the first
+   * @ref num_current_samples_ are in use).
+   */
+  std::array<SamplePlayback, MAX_SAMPLE_PLAYBACKS> current_samples_;
+  size_t                                           num_current_samples_ = 0;
+
+  /**
+   * Count-in length requested by queue_metronome_countin() (0 if none),
+   * picked up by the processing thread.
+   */
+  std::atomic<signed_frame_t> requested_countin_frames_{ 0 };
+
+  /** Count-in progress (processing thread only). */
+  signed_frame_t countin_pos_ = 0;
+  signed_frame_t countin_frames_ = 0;
+
 public:
-  /** An array of samples currently being played. */
-  std::vector<SamplePlayback> current_samples_;
 
-  /** Tracklist for file auditioning. */
+  /** Audio file being auditioned, streamed from disk. */
+  std::unique_ptr<dsp::FilePreviewStream> file_preview_;
+
+  /** Tracklist for MIDI file and chord preset auditioning. */
   std::unique_ptr<Tracklist> tracklist_;
 
   /** Instrument for MIDI auditioning. */
@@ -14,7 +14,6 @@
 ScaleObject::ScaleObject (QObject * parent)
     : ArrangerObject (ArrangerObject::Type::ScaleObject), QObject (parent)
 {
-  ArrangerObject::parent_base_qproperties (*this);
 }
 
 ScaleObject::ScaleObject (const MusicalScale &descr, QObject * parent)
@@ -4,6 +4,7 @@
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/settings_manager.h"
 #include "gui/backend/backend/zrythm.h"
+#include "gui/dsp/audio_region.h"
 #include "gui/dsp/engine.h"
 #include "gui/dsp/snap_grid.h"
 #include "gui/dsp/transport.h"
@@ -243,13 +244,49 @@ SnapGrid::get_snapped_end_position (const Position &start_pos) const
   return end_pos;
 }
 
+std::vector<zrythm::dsp::Position>
+SnapGrid::get_event_snap_points (Track * track, Region * region) const
+{
+  std::vector<Position> points;
+  if (track && track->has_lanes ())
+    {
+      std::visit (
+        [&] (auto &&t) {
+          using TrackT = base_type<decltype (t)>;
+          for (auto &lane_var : t->lanes_)
+            {
+              using TrackLaneT = TrackT::LanedTrackImpl::TrackLaneType;
+              auto lane = std::get<TrackLaneT *> (lane_var);
+              for (auto &r_var : lane->region_list_->regions_)
+                {
+                  auto * r = std::get<typename TrackLaneT::RegionT *> (r_var);
+                  points.push_back (*r->pos_);
+                  points.push_back (*r->end_pos_);
+                }
+            }
+        },
+        convert_to_variant<LanedTrackPtrVariant> (track));
+    }
+  else if (auto * audio_region = dynamic_cast<AudioRegion *> (region))
+    {
+      points = audio_region->get_transient_positions (MIN_TRANSIENT_STRENGTH);
+    }
+  else if (region)
+    {
+      /* TODO */
+    }
+
+  std::ranges::sort (points);
+  return points;
+}
+
 bool
 SnapGrid::get_prev_or_next_snap_point (
-  const Position &pivot_pos,
-  Track *         track,
-  Region *        region,
-  Position       &out_pos,
-  bool            get_prev_point) const
+  const Position           &pivot_pos,
+  int                       snap_ticks,
+  std::span<const Position> event_snap_points,
+  Position                 &out_pos,
+  bool                      get_prev_point) const
 {
   out_pos = pivot_pos;
   if (!pivot_pos.is_positive ())
@@ -259,11 +296,10 @@ SnapGrid::get_prev_or_next_snap_point (
     }
 
   bool snapped = false;
-  auto snap_point = pivot_pos;
 
-  if (snap_to_grid_)
+  if (snap_ticks > 0)
     {
-      double snap_ticks = get_snap_ticks ();
+      auto   snap_point = pivot_pos;
       double ticks_from_prev = fmod (pivot_pos.ticks_, snap_ticks);
       if (get_prev_point)
         {
@@ -279,44 +315,20 @@ SnapGrid::get_prev_or_next_snap_point (
       snapped = true;
     }
 
-  if (track && track->has_lanes ())
+  /* the first event snap point after the pivot position */
+  const auto it = std::ranges::upper_bound (event_snap_points, pivot_pos);
+  if (get_prev_point)
     {
-      std::visit (
-        [&] (auto &&t) {
-          using TrackT = base_type<decltype (t)>;
-          for (auto &lane_var : t->lanes_)
-            {
-              using TrackLaneT = TrackT::LanedTrackImpl::TrackLaneType;
-              auto lane = std::get<TrackLaneT *> (lane_var);
-              for (auto &r_var : lane->region_list_->regions_)
-                {
-                  auto * r = std::get<typename TrackLaneT::RegionT *> (r_var);
-                  snap_point = *r->pos_;
-                  if (
-                    get_prev_point
-                      ? (snap_point <= pivot_pos && snap_point > out_pos)
-                      : (snap_point > pivot_pos && snap_point < out_pos))
-                    {
-                      out_pos = snap_point;
-                      snapped = true;
-                    }
-                  snap_point = *r->end_pos_;
-                  if (
-                    get_prev_point
-                      ? (snap_point <= pivot_pos && snap_point > out_pos)
-                      : (snap_point > pivot_pos && snap_point < out_pos))
-                    {
-                      out_pos = snap_point;
-                      snapped = true;
-                    }
-                }
-            }
-        },
-        convert_to_variant<LanedTrackPtrVariant> (track));
+      if (it != event_snap_points.begin () && *std::prev (it) > out_pos)
+        {
+          out_pos = *std::prev (it);
+          snapped = true;
+        }
     }
-  else if (region)
+  else if (it != event_snap_points.end () && *it < out_pos)
     {
-      /* TODO */
+      out_pos = *it;
+      snapped = true;
     }
 
   /* if no point to snap to, set to same position */
@@ -328,6 +340,19 @@ SnapGrid::get_prev_or_next_snap_point (
   return snapped;
 }
 
+bool
+SnapGrid::get_prev_or_next_snap_point (
+  const Position &pivot_pos,
+  Track *         track,
+  Region *        region,
+  Position       &out_pos,
+  bool            get_prev_point) const
+{
+  return get_prev_or_next_snap_point (
+    pivot_pos, snap_to_grid_ ? get_snap_ticks () : -1,
+    get_event_snap_points (track, region), out_pos, get_prev_point);
+}
+
 bool
 SnapGrid::get_prev_snap_point (
   const Position &pivot_pos,
@@ -350,16 +375,18 @@ SnapGrid::get_next_snap_point (
 
 bool
 SnapGrid::get_closest_snap_point (
-  const Position &pivot_pos,
-  Track *         track,
-  Region *        region,
-  Position       &closest_sp) const
+  const Position           &pivot_pos,
+  int                       snap_ticks,
+  std::span<const Position> event_snap_points,
+  Position                 &closest_sp) const
 {
   /* get closest snap point */
   Position prev_sp;
   Position next_sp;
-  bool prev_snapped = get_prev_snap_point (pivot_pos, track, region, prev_sp);
-  bool next_snapped = get_next_snap_point (pivot_pos, track, region, next_sp);
+  bool     prev_snapped = get_prev_or_next_snap_point (
+    pivot_pos, snap_ticks, event_snap_points, prev_sp, true);
+  bool next_snapped = get_prev_or_next_snap_point (
+    pivot_pos, snap_ticks, event_snap_points, next_sp, false);
   if (prev_snapped && next_snapped)
     {
       closest_sp = pivot_pos.get_closest_position (prev_sp, next_sp);
@@ -380,6 +407,18 @@ SnapGrid::get_closest_snap_point (
   return false;
 }
 
+bool
+SnapGrid::get_closest_snap_point (
+  const Position &pivot_pos,
+  Track *         track,
+  Region *        region,
+  Position       &closest_sp) const
+{
+  return get_closest_snap_point (
+    pivot_pos, snap_to_grid_ ? get_snap_ticks () : -1,
+    get_event_snap_points (track, region), closest_sp);
+}
+
 SnapGrid::Position
 SnapGrid::snap (
   const Position  &pivot_pos,
@@ -400,6 +439,53 @@ SnapGrid::snap (
       track = nullptr;
     }
 
+  return snap (
+    pivot_pos, start_pos, snap_to_grid_ ? get_snap_ticks () : -1,
+    get_event_snap_points (track, region));
+}
+
+std::vector<zrythm::dsp::Position>
+SnapGrid::snap_batch (
+  std::span<const Position> pivot_positions,
+  std::span<const Position> start_positions,
+  Track *                   track,
+  Region *                  region) const
+{
+  z_warn_if_fail (any_snap ());
+  z_return_val_if_fail (
+    !snap_to_grid_keep_offset_
+      || start_positions.size () == pivot_positions.size (),
+    {});
+
+  if (!snap_to_events_)
+    {
+      region = nullptr;
+      track = nullptr;
+    }
+
+  const int  snap_ticks = snap_to_grid_ ? get_snap_ticks () : -1;
+  const auto event_snap_points = get_event_snap_points (track, region);
+
+  std::vector<Position> ret;
+  ret.reserve (pivot_positions.size ());
+  for (size_t i = 0; i < pivot_positions.size (); ++i)
+    {
+      const auto &pivot_pos = pivot_positions[i];
+      z_return_val_if_fail (pivot_pos.is_positive (), {});
+      ret.push_back (snap (
+        pivot_pos, i < start_positions.size () ? &start_positions[i] : nullptr,
+        snap_ticks, event_snap_points));
+    }
+  return ret;
+}
+
+SnapGrid::Position
+SnapGrid::snap (
+  const Position           &pivot_pos,
+  const Position *          start_pos,
+  int                       snap_ticks,
+  std::span<const Position> event_snap_points) const
+{
   Position ret (pivot_pos);
 
   /* snap to grid with offset */
@@ -408,7 +494,9 @@ SnapGrid::snap (
       /* get previous snap point from start pos */
       z_return_val_if_fail (start_pos, {});
       Position prev_sp_from_start_pos;
-      get_prev_snap_point (*start_pos, track, region, prev_sp_from_start_pos);
+      get_prev_or_next_snap_point (
+        *start_pos, snap_ticks, event_snap_points, prev_sp_from_start_pos,
+        true);
 
       /* get diff from previous snap point */
       double ticks_delta = start_pos->ticks_ - prev_sp_from_start_pos.ticks_;
@@ -418,8 +506,8 @@ SnapGrid::snap (
 
       /* get closest snap point */
       Position closest_sp;
-      bool     have_closest_sp =
-        get_closest_snap_point (ret, track, region, closest_sp);
+      bool     have_closest_sp = get_closest_snap_point (
+        ret, snap_ticks, event_snap_points, closest_sp);
       if (have_closest_sp)
         {
           /* move to closest snap point */
@@ -434,7 +522,7 @@ SnapGrid::snap (
     {
       /* get closest snap point */
       Position closest_sp;
-      get_closest_snap_point (ret, track, region, closest_sp);
+      get_closest_snap_point (ret, snap_ticks, event_snap_points, closest_sp);
 
       /* move to closest snap point */
       ret = closest_sp;
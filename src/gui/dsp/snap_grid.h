@@ -45,6 +45,12 @@ public:
 
   static constexpr int DEFAULT_MAX_BAR = 10000;
 
+  /**
+   * Minimum relative strength of the transients of audio regions to snap to
+   * when snapping to events.
+   */
+  static constexpr float MIN_TRANSIENT_STRENGTH = 0.2f;
+
   using FramesPerTickProvider = std::function<double (void)>;
   using TicksPerBarProvider = std::function<int (void)>;
   using TicksPerBeatProvider = std::function<int (void)>;
@@ -228,6 +234,22 @@ public:
     Track *          track,
     Region *         region) const;
 
+  /**
+   * Snaps each of @p pivot_positions using given options (e.g., when dragging
+   * multiple objects).
+   *
+   * Same as calling snap() for each position, except that the snap points of
+   * the objects in @p track or @p region are only collected once.
+   *
+   * @param start_positions The positions the drag started at, one for each
+   * pivot position. Only used when the "keep offset" setting is on.
+   */
+  std::vector<Position> snap_batch (
+    std::span<const Position> pivot_positions,
+    std::span<const Position> start_positions,
+    Track *                   track,
+    Region *                  region) const;
+
   /**
    * @brief Snaps @p pivot_pos using given options.
    *
@@ -297,6 +319,42 @@ public:
    */
   NoteLengthType length_type_ = NoteLengthType::NOTE_LENGTH_LINK;
 
+private:
+  /**
+   * @brief Returns the positions of the objects in @p track or @p region that
+   * can be snapped to, sorted.
+   *
+   * For audio regions, these are the transients of their clips.
+   */
+  std::vector<Position>
+  get_event_snap_points (Track * track, Region * region) const;
+
+  /**
+   * @brief Implementation of get_prev_or_next_snap_point() that looks up the
+   * (sorted) @p event_snap_points by binary search.
+   *
+   * @param snap_ticks Snap length, or a negative value to not snap to the
+   * grid.
+   */
+  bool get_prev_or_next_snap_point (
+    const Position           &pivot_pos,
+    int                       snap_ticks,
+    std::span<const Position> event_snap_points,
+    Position                 &out_pos,
+    bool                      get_prev_point) const;
+
+  bool get_closest_snap_point (
+    const Position           &pivot_pos,
+    int                       snap_ticks,
+    std::span<const Position> event_snap_points,
+    Position                 &closest_sp) const;
+
+  Position snap (
+    const Position           &pivot_pos,
+    const Position *          start_pos,
+    int                       snap_ticks,
+    std::span<const Position> event_snap_points) const;
+
 private:
   FramesPerTickProvider frames_per_tick_provider_;
   TicksPerBarProvider   ticks_per_bar_provider_;
@@ -5,6 +5,7 @@
 #include "gui/backend/backend/project.h"
 #include "gui/backend/backend/zrythm.h"
 #include "gui/backend/ui.h"
+#include "gui/dsp/automation_region.h"
 #include "gui/dsp/automation_track.h"
 #include "gui/dsp/port.h"
 #include "gui/dsp/router.h"
@@ -114,10 +115,67 @@ TempoTrack::validate () const
 bpm_t
 TempoTrack::get_bpm_at_pos (const Position pos)
 {
+  if (!tempo_map_.empty ())
+    return tempo_map_.get_bpm_at_ticks (pos.ticks_);
+
   auto at = AutomationTrack::find_from_port_id (bpm_port_, false);
   return at->get_val_at_pos (pos, false, false, Z_F_NO_USE_SNAPSHOTS);
 }
 
+void
+TempoTrack::rebuild_tempo_map ()
+{
+  const auto   sample_rate = AUDIO_ENGINE->sample_rate_;
+  const int    ticks_per_beat = TRANSPORT->ticks_per_beat_;
+  const double frames_per_tick = AUDIO_ENGINE->frames_per_tick_;
+  if (sample_rate == 0 || ticks_per_beat <= 0 || frames_per_tick <= 0)
+    return;
+
+  std::vector<dsp::TempoMap::TempoChange> changes;
+  if (auto * at = AutomationTrack::find_from_port_id (bpm_port_, false))
+    {
+      double end_ticks = 0.0;
+      at->foreach_region ([&] (const AutomationRegion &region) {
+        end_ticks = std::max (end_ticks, region.end_pos_->ticks_);
+      });
+
+      for (
+        double ticks = 0.0; ticks < end_ticks;
+        ticks += Position::TICKS_PER_SIXTEENTH_NOTE_DBL)
+        {
+          changes.push_back ({
+            ticks,
+            at->get_val_at_pos (
+              Position (ticks, frames_per_tick), false, false,
+              Z_F_NO_USE_SNAPSHOTS),
+          });
+        }
+    }
+
+  tempo_map_.rebuild (get_current_bpm (), changes, sample_rate, ticks_per_beat);
+}
+
+void
+TempoTrack::update_tempo_map ()
+{
+  if (
+    tempo_map_.get_segments ().size () > 1
+    && tempo_map_.get_sample_rate () == AUDIO_ENGINE->sample_rate_
+    && tempo_map_.get_ticks_per_beat () == TRANSPORT->ticks_per_beat_)
+    {
+      return;
+    }
+
+  rebuild_tempo_map ();
+}
+
+void
+TempoTrack::set_playback_caches ()
+{
+  AutomatableTrack::set_playback_caches ();
+  rebuild_tempo_map ();
+}
+
 bpm_t
 TempoTrack::get_current_bpm () const
 {
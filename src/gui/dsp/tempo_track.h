@@ -4,6 +4,7 @@
 #ifndef __AUDIO_TEMPO_TRACK_H__
 #define __AUDIO_TEMPO_TRACK_H__
 
+#include "dsp/tempo_map.h"
 #include "gui/dsp/automatable_track.h"
 
 #include "utils/types.h"
@@ -76,9 +77,36 @@ public:
 
   /**
    * Returns the BPM at the given pos.
+   *
+   * Looks it up in the tempo map once it is built.
    */
   bpm_t get_bpm_at_pos (Position pos);
 
+  /**
+   * @brief Returns the tempo map built from the BPM automation.
+   */
+  const dsp::TempoMap &get_tempo_map () const { return tempo_map_; }
+
+  /**
+   * @brief Rebuilds the tempo map from the BPM automation.
+   *
+   * Curved automation is sampled every sixteenth note.
+   *
+   * @note Must only be called while the engine is stopped or during
+   * processing kickoff.
+   */
+  void rebuild_tempo_map ();
+
+  /**
+   * @brief Updates the tempo map after the tempo, the time signature or the
+   * sample rate changed.
+   *
+   * Automation changes the tempo during playback, so a map built from tempo
+   * automation is only rebuilt when the time signature or the sample rate
+   * changed.
+   */
+  void update_tempo_map ();
+
   void init_after_cloning (const TempoTrack &other, ObjectCloneType clone_type)
     override;
 
@@ -171,6 +199,8 @@ public:
 private:
   bool initialize ();
 
+  void set_playback_caches () override;
+
 private:
   PortRegistry &port_registry_;
 
@@ -182,6 +212,9 @@ private:
 
   /** Automatable beat unit port. */
   PortUuid beat_unit_port_;
+
+  /** Tempo map (not serialized). */
+  dsp::TempoMap tempo_map_;
 };
 
 static_assert (ConstructibleWithDependencyHolder<TempoTrack>);
@@ -47,6 +47,15 @@ Track::Track (Type type, PortType in_signal_type, PortType out_signal_type)
   z_debug ("creating {} track", type);
 }
 
+void
+Track::update_selection_index ()
+{
+  if (tracklist_ != nullptr)
+    {
+      tracklist_->update_track_selection (*this);
+    }
+}
+
 Tracklist *
 Track::get_tracklist () const
 {
@@ -166,6 +175,8 @@ Track::copy_members_from (const Track &other, ObjectCloneType clone_type)
   bounce_to_master_ = other.bounce_to_master_;
   frozen_ = other.frozen_;
   pool_id_ = other.pool_id_;
+  freeze_step_ = other.freeze_step_;
+  freeze_fingerprint_ = other.freeze_fingerprint_;
   disconnecting_ = other.disconnecting_;
   selected_ = other.selected_;
 }
@@ -353,7 +364,7 @@ Track::insert_region (
         {
           auto clip = added_region->get_clip ();
           z_return_val_if_fail (clip, nullptr);
-          AUDIO_POOL->write_clip (*clip, false, false);
+          AUDIO_POOL->write_clip (*clip, false);
         }
     }
 
@@ -448,105 +459,6 @@ Track::should_be_visible () const
   });
 }
 
-#if 0
-static void
-freeze_progress_close_cb (ExportData * data)
-{
-  g_thread_join (data->thread);
-
-  Track * self = (Track *) g_ptr_array_index (data->tracks, 0);
-
-  exporter_post_export (data->info, data->conns, data->state);
-
-  /* assert exporting is finished */
-  z_return_if_fail (!AUDIO_ENGINE->exporting);
-
-  if (
-    data->info->progress_info->get_completion_type ()
-    == ProgressInfo::CompletionType::SUCCESS)
-    {
-      /* move the temporary file to the pool */
-      GError *    err = NULL;
-      AudioClip * clip = audio_clip_new_from_file (data->info->file_uri, &err);
-      if (!clip)
-        {
-          HANDLE_ERROR (
-            err, QObject::tr ("Failed creating audio clip from file at {}"),
-            data->info->file_uri);
-          return;
-        }
-      audio_pool_add_clip (AUDIO_POOL, clip);
-      err = NULL;
-      bool success =
-        audio_clip_write_to_pool (clip, F_NO_PARTS, F_NOT_BACKUP, &err);
-      if (!success)
-        {
-          HANDLE_ERROR (
-            err, "Failed to write frozen audio for track '{}' to pool",
-            self->name);
-          return;
-        }
-      self->pool_id_ = clip->pool_id_;
-    }
-
-  if (g_file_test (data->info->file_uri, G_FILE_TEST_IS_REGULAR))
-    {
-      io_remove (data->info->file_uri);
-    }
-
-  self->frozen = true;
-  // EVENTS_PUSH (EventType::ET_TRACK_FREEZE_CHANGED, self);
-}
-
-bool
-track_freeze (Track * self, bool freeze, GError ** error)
-{
-  z_info ("{}freezing {}...", freeze ? "" : "un", self->name);
-
-  if (freeze)
-    {
-      ExportSettings * info = export_settings_new ();
-      ExportData *     data = export_data_new (nullptr, info);
-      data->tracks = g_ptr_array_new ();
-      g_ptr_array_add (data->tracks, self);
-      self->bounce_to_master = true;
-      track_mark_for_bounce (
-        self, F_BOUNCE, F_MARK_REGIONS, F_NO_MARK_CHILDREN, F_NO_MARK_PARENTS);
-      data->info->mode = Exporter::Mode::EXPORT_MODE_TRACKS;
-      export_settings_set_bounce_defaults (
-        data->info, Exporter::Format::WAV, "", self->name);
-
-      data->conns = exporter_prepare_tracks_for_export (data->info, data->state);
-
-      /* start exporting in a new thread */
-      data->thread = g_thread_new (
-        "bounce_thread", (GThreadFunc) exporter_generic_export_thread,
-        data->info);
-      Exporter exporter (*info);
-      data->thread = exporter.begin_generic_thread ();
-
-      /* create a progress dialog and block */
-      ExportProgressDialogWidget * progress_dialog =
-        export_progress_dialog_widget_new (
-          data, true, freeze_progress_close_cb, false, F_CANCELABLE);
-      adw_dialog_present (
-        ADW_DIALOG (progress_dialog), GTK_WIDGET (MAIN_WINDOW));
-      return true;
-    }
-  else
-    {
-      /* FIXME */
-      /*audio_pool_remove_clip (*/
-      /*AUDIO_POOL, self->pool_id_, true);*/
-
-      self->frozen = false;
-      // EVENTS_PUSH (EventType::ET_TRACK_FREEZE_CHANGED, self);
-    }
-
-  return true;
-}
-#endif
-
 void
 Track::remove_plugin (
   dsp::PluginSlot slot,
@@ -736,18 +648,22 @@ Track::update_positions (bool from_ticks, bool bpm_change, double frames_per_tic
 
   std::vector<ArrangerObjectPtrVariant> objects;
   append_objects (objects);
-  for (auto obj_var : objects)
-    {
-      std::visit (
-        [&] (auto &&obj) {
-          if (ZRYTHM_TESTING)
-            obj->validate (is_in_active_project (), 0);
-          obj->update_positions (from_ticks, bpm_change, frames_per_tick);
-          if (ZRYTHM_TESTING)
-            obj->validate (is_in_active_project (), 0);
-        },
-        obj_var);
-    }
+
+  const auto validate_objects = [&] () {
+    for (const auto &obj_var : objects)
+      {
+        std::visit (
+          [&] (auto &&obj) { obj->validate (is_in_active_project (), 0); },
+          obj_var);
+      }
+  };
+
+  if (ZRYTHM_TESTING)
+    validate_objects ();
+  ArrangerObject::update_positions (
+    objects, from_ticks, bpm_change, frames_per_tick);
+  if (ZRYTHM_TESTING)
+    validate_objects ();
 }
 
 bool
@@ -823,7 +739,16 @@ Track::set_name (
   bool               pub_events)
 {
   auto new_name = get_unique_name (tracklist, name);
+  const bool changed = name_ != new_name;
   name_ = new_name;
+  if (changed)
+    {
+      std::visit (
+        [this] (auto &&track) {
+          Q_EMIT track->nameChanged (QString::fromStdString (name_));
+        },
+        convert_to_variant<TrackPtrVariant> (this));
+    }
 
   std::vector<Port *> ports;
   append_ports (ports, true);
@@ -1195,15 +1120,34 @@ Track::create_without_file_with_action (
   return Track::from_variant (track);
 }
 
+void
+Track::update_playback_snapshots ()
+{
+  if (is_auditioner ())
+    return;
+
+  z_return_if_fail (AUDIO_ENGINE->run_.load () == false);
+
+  set_playback_caches ();
+
+  /* the blocks rendered ahead used the old snapshots */
+  ROUTER->invalidate_rendered_ahead ();
+}
+
 void
 Track::set_caches (CacheType types)
 {
   if (
     ENUM_BITSET_TEST (types, CacheType::PlaybackSnapshots) && !is_auditioner ())
     {
-      z_return_if_fail (AUDIO_ENGINE->run_.load () == false);
+      std::vector<Region *> regions;
+      get_regions_in_range (regions, nullptr, nullptr);
+      for (auto * region : regions)
+        {
+          region->invalidate_playback_snapshot ();
+        }
 
-      set_playback_caches ();
+      update_playback_snapshots ();
     }
 
   if (ENUM_BITSET_TEST (types, CacheType::PluginPorts))
@@ -146,6 +146,7 @@ public: \
       return; \
 \
     selected_ = selected; \
+    update_selection_index (); \
     Q_EMIT selectedChanged (selected); \
   } \
   Q_SIGNAL void selectedChanged (bool selected); \
@@ -753,6 +754,12 @@ public:
    */
   bool is_selected () const { return selected_; }
 
+  /**
+   * @brief Updates the tracklist's selection index after the selection status
+   * changed.
+   */
+  void update_selection_index ();
+
   bool can_be_group_target () const { return type_can_be_group_target (type_); }
 
   /**
@@ -1028,21 +1035,6 @@ public:
   virtual void
   append_ports (std::vector<Port *> &ports, bool include_plugins) const = 0;
 
-  /**
-   * Freezes or unfreezes the track.
-   *
-   * When a track is frozen, it is bounced with effects to a temporary file in
-   * the pool, which is played back directly from disk.
-   *
-   * When the track is unfrozen, this file will be removed from the pool and
-   * the track will be played normally again.
-   *
-   * @remark Unimplemented/not used.
-   *
-   * @throw ZrythmException on error.
-   */
-  void track_freeze (bool freeze);
-
   /**
    * Wrapper over Channel.add_plugin() and ModulatorTrack.insert_modulator().
    *
@@ -1149,9 +1141,17 @@ public:
   /**
    * Set various caches (snapshots, track name hash, plugin input/output
    * ports, etc).
+   *
+   * Playback snapshots are regenerated for all the regions.
    */
   void set_caches (CacheType types);
 
+  /**
+   * @brief Updates the playback snapshots, only cloning the regions whose
+   * snapshot was invalidated (see Region::invalidate_playback_snapshot()).
+   */
+  void update_playback_snapshots ();
+
   /**
    * @brief Creates a new track with the given parameters.
    *
@@ -1378,12 +1378,30 @@ public:
    */
   bool bounce_to_master_ = false;
 
+  /**
+   * Stereo buffer to add the output to instead of the master output when
+   * bouncing to master, so that the stems of several tracks can be rendered
+   * in the same pass (see Exporter::can_export_stems_in_parallel()).
+   *
+   * Not owned.
+   */
+  utils::audio::AudioBuffer * bounce_tap_ = nullptr;
+
   /** Whether the track is currently frozen. */
   bool frozen_ = false;
 
   /** Pool ID of the clip if track is frozen. */
   int pool_id_ = 0;
 
+  /** Point in the signal chain the frozen clip was rendered at. */
+  utils::audio::BounceStep freeze_step_ = utils::audio::BounceStep::PostFader;
+
+  /**
+   * Fingerprint of the state the frozen clip was rendered from (see
+   * ChannelTrack::is_freeze_stale()).
+   */
+  uint64_t freeze_fingerprint_ = 0;
+
   int magic_ = TRACK_MAGIC;
 
   /** Whether currently disconnecting. */
@@ -1431,6 +1449,14 @@ concept FinalTrackSubclass = TrackSubclass<TrackT> && FinalClass<TrackT>;
 using TrackRegistry = utils::OwningObjectRegistry<TrackPtrVariant, Track>;
 using TrackRegistryRef = std::reference_wrapper<TrackRegistry>;
 
+/* tracks (with their lanes, regions and automation) only reference ports and
+ * plugins from the registries when deserialized, so they are deserialized in
+ * parallel */
+template <>
+inline constexpr bool
+  zrythm::utils::serialization::deserialize_in_parallel_v<TrackPtrVariant> =
+    true;
+
 class RecordableTrack;
 
 extern template MidiRegion *
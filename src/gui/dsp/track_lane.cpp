@@ -318,19 +318,24 @@ TrackLaneImpl<RegionT>::copy_members_from (
 
 template <typename RegionT>
 std::unique_ptr<typename TrackLaneImpl<RegionT>::TrackLaneT>
-TrackLaneImpl<RegionT>::gen_snapshot () const
+TrackLaneImpl<RegionT>::gen_snapshot (
+  std::unique_ptr<TrackLaneT> prev_snapshot) const
 {
-  auto ret = dynamic_cast<const TrackLaneT *> (this)->clone_unique ();
-  ret->track_ = track_;
-
-  /* clone_unique above creates the regions in `regions_` but we want them in
-   * `region_snapshots_`... */
-  for (auto &region_var : this->region_list_->regions_)
+  auto ret = std::move (prev_snapshot);
+  if (ret)
     {
-      auto region = std::get<RegionT *> (region_var);
-      ret->region_snapshots_.emplace_back (region->clone_unique ());
+      ret->TrackLaneImpl::copy_members_from (*this, ObjectCloneType::Snapshot);
     }
-  ret->region_list_->clear ();
+  else
+    {
+      ret = dynamic_cast<const TrackLaneT *> (this)->clone_unique ();
+
+      /* clone_unique above creates the regions in `regions_` but we want them
+       * in `region_snapshots_`... */
+      ret->region_list_->clear ();
+    }
+  ret->track_ = track_;
+  ret->update_region_snapshots (*this);
   return ret;
 }
 
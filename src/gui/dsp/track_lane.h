@@ -253,8 +253,13 @@ public:
 
   /**
    * Generate a snapshot for playback.
+   *
+   * @param prev_snapshot A previous snapshot of this lane to update instead
+   * of cloning this lane, if any. The snapshots of the regions that didn't
+   * change are reused.
    */
-  std::unique_ptr<TrackLaneT> gen_snapshot () const;
+  std::unique_ptr<TrackLaneT>
+  gen_snapshot (std::unique_ptr<TrackLaneT> prev_snapshot = nullptr) const;
 
 protected:
   void
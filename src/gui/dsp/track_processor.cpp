@@ -11,6 +11,7 @@
 #include "gui/backend/channel.h"
 #include "gui/dsp/audio_region.h"
 #include "gui/dsp/audio_track.h"
+#include "gui/dsp/automation_tracklist.h"
 #include "gui/dsp/clip.h"
 #include "gui/dsp/control_port.h"
 #include "gui/dsp/control_room.h"
@@ -21,6 +22,7 @@
 #include "gui/dsp/midi_track.h"
 #include "gui/dsp/port.h"
 #include "gui/dsp/recording_manager.h"
+#include "gui/dsp/router.h"
 #include "gui/dsp/track.h"
 #include "gui/dsp/tracklist.h"
 #include "utils/dsp.h"
@@ -67,10 +69,7 @@ TrackProcessor::TrackProcessor (
           piano_roll->id_->sym_ = "track_processor_piano_roll";
           piano_roll->id_->flags_ = PortIdentifier::Flags::PianoRoll;
           piano_roll_id_ = piano_roll->get_uuid ();
-          if (!tr.is_chord ())
-            {
-              init_midi_cc_ports ();
-            }
+          has_midi_automatables_ = !tr.is_chord ();
         }
       break;
     case PortType::Audio:
@@ -152,6 +151,9 @@ TrackProcessor::init_loaded (
   PortRegistry      &port_registry)
 {
   track_ = track;
+  has_midi_automatables_ =
+    track->in_signal_type_ == PortType::Event && track->has_piano_roll ()
+    && !track->is_chord ();
 
   std::vector<Port *> ports;
   append_ports (ports);
@@ -166,57 +168,57 @@ TrackProcessor::init_loaded (
 void
 TrackProcessor::init_common ()
 {
-  if (midi_cc_ids_)
+  if (has_midi_automatables_)
     {
       cc_mappings_ = std::make_unique<MidiMappings> ();
 
-      for (const auto i : std::views::iota (0, 16))
+      std::vector<ControlPort *> ports;
+      append_midi_automatable_ports (ports);
+      for (auto * port : ports)
         {
-          for (const auto j : std::views::iota (0, 128))
-            {
-              auto cc_port_id = (*midi_cc_ids_)[i * 128 + j];
-              auto cc_port = std::get<ControlPort *> (
-                port_registry_.find_by_id_or_throw (cc_port_id));
-
-              /* set caches */
-              cc_port->midi_channel_ = i + 1;
-              cc_port->midi_cc_no_ = j;
-
-              /* set model bytes for CC:
-               * [0] = ctrl change + channel
-               * [1] = controller
-               * [2] (unused) = control */
-              std::array<midi_byte_t, 3> buf{};
-              buf[0] = (midi_byte_t) (MIDI_CH1_CTRL_CHANGE | (midi_byte_t) i);
-              buf[1] = (midi_byte_t) j;
-              buf[2] = 0;
-
-              /* bind */
-              cc_mappings_->bind_track (buf, *cc_port, false);
-            } /* endforeach 0..127 */
-
-          auto pb_id = pitch_bend_ids_->at (i);
-          auto kp_id = poly_key_pressure_ids_->at (i);
-          auto cp_id = channel_pressure_ids_->at (i);
-          auto pb = std::get<ControlPort *> (
-            port_registry_.find_by_id_or_throw (pb_id));
-          auto kp = std::get<ControlPort *> (
-            port_registry_.find_by_id_or_throw (kp_id));
-          auto cp = std::get<ControlPort *> (
-            port_registry_.find_by_id_or_throw (cp_id));
-
-          /* set caches */
-          pb->midi_channel_ = i + 1;
-          kp->midi_channel_ = i + 1;
-          cp->midi_channel_ = i + 1;
-
-        } /* endforeach 0..15 */
+          init_midi_automatable_port (*port);
+        }
 
       updated_midi_automatable_ports_ =
         std::make_unique<MPMCQueue<ControlPort *>> (128 * 16);
     }
 }
 
+void
+TrackProcessor::init_midi_automatable_port (ControlPort &port)
+{
+  const bool is_cc =
+    !ENUM_BITSET_TEST (port.id_->flags2_, PortIdentifier::Flags2::MidiPitchBend)
+    && !ENUM_BITSET_TEST (
+      port.id_->flags2_, PortIdentifier::Flags2::MidiPolyKeyPressure)
+    && !ENUM_BITSET_TEST (
+      port.id_->flags2_, PortIdentifier::Flags2::MidiChannelPressure);
+  const int channel_index =
+    is_cc ? port.id_->port_index_ / 128 : port.id_->port_index_;
+
+  /* set caches */
+  port.midi_channel_ = static_cast<midi_byte_t> (channel_index + 1);
+
+  if (is_cc)
+    {
+      const int cc_index = port.id_->port_index_ % 128;
+      port.midi_cc_no_ = static_cast<midi_byte_t> (cc_index);
+
+      /* set model bytes for CC:
+       * [0] = ctrl change + channel
+       * [1] = controller
+       * [2] (unused) = control */
+      std::array<midi_byte_t, 3> buf{};
+      buf[0] =
+        (midi_byte_t) (MIDI_CH1_CTRL_CHANGE | (midi_byte_t) channel_index);
+      buf[1] = (midi_byte_t) cc_index;
+      buf[2] = 0;
+
+      /* bind */
+      cc_mappings_->bind_track (buf, port, false);
+    }
+}
+
 void
 TrackProcessor::init_midi_port (bool in)
 {
@@ -239,68 +241,141 @@ TrackProcessor::init_midi_port (bool in)
     }
 }
 
-void
-TrackProcessor::init_midi_cc_ports ()
+ControlPort *
+TrackProcessor::find_midi_automatable_port (
+  const std::vector<PortUuid> &ids,
+  int                          port_index) const
+{
+  for (const auto &id : ids)
+    {
+      auto * port =
+        std::get<ControlPort *> (port_registry_.find_by_id_or_throw (id));
+      if (port->id_->port_index_ == port_index)
+        return port;
+    }
+  return nullptr;
+}
+
+ControlPort &
+TrackProcessor::create_midi_automatable_port (
+  std::vector<PortUuid> &ids,
+  std::string            label,
+  std::string            sym,
+  int                    channel_index,
+  int                    port_index)
+{
+  if (!has_midi_automatables_)
+    {
+      throw ZrythmException ("Track processor has no MIDI automatable ports");
+    }
+
+  auto * port = port_registry_.create_object<ControlPort> (std::move (label));
+  port->set_owner (*this);
+  port->id_->sym_ = std::move (sym);
+  port->id_->flags_ |= dsp::PortIdentifier::Flags::MidiAutomatable;
+  port->id_->flags_ |= dsp::PortIdentifier::Flags::Automatable;
+  port->id_->midi_channel_ = channel_index + 1;
+  port->id_->port_index_ = port_index;
+  ids.push_back (port->get_uuid ());
+  return *port;
+}
+
+ControlPort &
+TrackProcessor::get_or_create_midi_cc_port (int channel_index, int cc_index)
+{
+  if (auto * port = get_midi_cc_port (channel_index, cc_index))
+    return *port;
+
+  /* starting from 1 */
+  const int channel = channel_index + 1;
+  auto     &cc = create_midi_automatable_port (
+    midi_cc_ids_,
+    fmt::format ("Ch{} {}", channel, midi_get_controller_name (cc_index)),
+    fmt::format ("midi_controller_ch{}_{}", channel, cc_index + 1),
+    channel_index, (channel_index * 128) + cc_index);
+  return activate_midi_automatable_port (cc);
+}
+
+ControlPort &
+TrackProcessor::get_or_create_pitch_bend_port (int channel_index)
+{
+  if (auto * port = get_pitch_bend_port (channel_index))
+    return *port;
+
+  auto &pitch_bend = create_midi_automatable_port (
+    pitch_bend_ids_, fmt::format ("Ch{} Pitch bend", channel_index + 1),
+    fmt::format ("ch{}_pitch_bend", channel_index + 1), channel_index,
+    channel_index);
+  pitch_bend.range_ = { -8192.f, 8191.f, 0.f };
+  pitch_bend.deff_ = 0.f;
+  pitch_bend.id_->flags2_ |= PortIdentifier::Flags2::MidiPitchBend;
+  return activate_midi_automatable_port (pitch_bend);
+}
+
+ControlPort &
+TrackProcessor::get_or_create_poly_key_pressure_port (int channel_index)
 {
-  constexpr auto init_midi_port = [&] (const auto &port, const auto &index) {
-    port->id_->flags_ |= dsp::PortIdentifier::Flags::MidiAutomatable;
-    port->id_->flags_ |= dsp::PortIdentifier::Flags::Automatable;
-    port->id_->midi_channel_ = index + 1;
-    port->id_->port_index_ = index;
-  };
-
-  midi_cc_ids_ = std::make_unique<decltype (midi_cc_ids_)::element_type> ();
-  pitch_bend_ids_ =
-    std::make_unique<decltype (pitch_bend_ids_)::element_type> ();
-  poly_key_pressure_ids_ =
-    std::make_unique<decltype (poly_key_pressure_ids_)::element_type> ();
-  channel_pressure_ids_ =
-    std::make_unique<decltype (channel_pressure_ids_)::element_type> ();
-
-  for (const auto i : std::views::iota (0, 16))
+  if (auto * port = get_poly_key_pressure_port (channel_index))
+    return *port;
+
+  auto &poly_key_pressure = create_midi_automatable_port (
+    poly_key_pressure_ids_,
+    fmt::format ("Ch{} Poly key pressure", channel_index + 1),
+    fmt::format ("ch{}_poly_key_pressure", channel_index + 1), channel_index,
+    channel_index);
+  poly_key_pressure.id_->flags2_ |= PortIdentifier::Flags2::MidiPolyKeyPressure;
+  return activate_midi_automatable_port (poly_key_pressure);
+}
+
+ControlPort &
+TrackProcessor::get_or_create_channel_pressure_port (int channel_index)
+{
+  if (auto * port = get_channel_pressure_port (channel_index))
+    return *port;
+
+  auto &channel_pressure = create_midi_automatable_port (
+    channel_pressure_ids_,
+    fmt::format ("Ch{} Channel pressure", channel_index + 1),
+    fmt::format ("ch{}_channel_pressure", channel_index + 1), channel_index,
+    channel_index);
+  channel_pressure.id_->flags2_ |= PortIdentifier::Flags2::MidiChannelPressure;
+  return activate_midi_automatable_port (channel_pressure);
+}
+
+ControlPort &
+TrackProcessor::activate_midi_automatable_port (ControlPort &port)
+{
+  /* the CC mappings are also used during processing */
+  AudioEngine::State state{};
+  const bool         in_active_project = is_in_active_project ();
+  if (in_active_project)
+    AUDIO_ENGINE->wait_for_pause (state, false, true);
+
+  init_midi_automatable_port (port);
+  track_->get_automation_tracklist ().add_at (*new AutomationTrack (port));
+
+  if (in_active_project)
     {
-      /* starting from 1 */
-      int channel = i + 1;
+      ROUTER->recalc_graph (false);
+      AUDIO_ENGINE->resume (state);
+    }
+  return port;
+}
 
-      for (const auto j : std::views::iota (0, 128))
+void
+TrackProcessor::append_midi_automatable_ports (
+  std::vector<ControlPort *> &ports) const
+{
+  for (
+    const auto * ids :
+    { &midi_cc_ids_, &pitch_bend_ids_, &poly_key_pressure_ids_,
+      &channel_pressure_ids_ })
+    {
+      for (const auto &id : *ids)
         {
-          auto * cc = port_registry_.create_object<ControlPort> (
-            fmt::format ("Ch{} {}", channel, midi_get_controller_name (j)));
-          cc->set_owner (*this);
-          init_midi_port (cc, (i * 128) + j);
-          cc->id_->sym_ =
-            fmt::format ("midi_controller_ch{}_{}", channel, j + 1);
-          (*midi_cc_ids_)[(i * 128) + j] = cc->get_uuid ();
+          ports.push_back (
+            std::get<ControlPort *> (port_registry_.find_by_id_or_throw (id)));
         }
-
-      auto * pitch_bend = port_registry_.create_object<ControlPort> (
-        fmt::format ("Ch{} Pitch bend", i + 1));
-      pitch_bend->set_owner (*this);
-      pitch_bend->id_->sym_ = fmt::format ("ch{}_pitch_bend", i + 1);
-      init_midi_port (pitch_bend, i);
-      pitch_bend->range_ = { -8192.f, 8191.f, 0.f };
-      pitch_bend->deff_ = 0.f;
-      pitch_bend->id_->flags2_ |= PortIdentifier::Flags2::MidiPitchBend;
-      (*pitch_bend_ids_)[i] = pitch_bend->get_uuid ();
-
-      auto * poly_key_pressure = port_registry_.create_object<ControlPort> (
-        fmt::format ("Ch{} Poly key pressure", i + 1));
-      poly_key_pressure->set_owner (*this);
-      poly_key_pressure->id_->sym_ =
-        fmt::format ("ch{}_poly_key_pressure", i + 1);
-      init_midi_port (poly_key_pressure, i);
-      poly_key_pressure->id_->flags2_ |=
-        PortIdentifier::Flags2::MidiPolyKeyPressure;
-      (*poly_key_pressure_ids_)[i] = poly_key_pressure->get_uuid ();
-
-      auto * channel_pressure = port_registry_.create_object<ControlPort> (
-        fmt::format ("Ch{} Channel pressure", i + 1));
-      channel_pressure->set_owner (*this);
-      channel_pressure->id_->sym_ = fmt::format ("ch{}_channel_pressure", i + 1);
-      init_midi_port (channel_pressure, i);
-      channel_pressure->id_->flags2_ |=
-        PortIdentifier::Flags2::MidiChannelPressure;
-      (*channel_pressure_ids_)[i] = channel_pressure->get_uuid ();
     }
 }
 
@@ -414,6 +489,12 @@ TrackProcessor::should_bounce_to_master (utils::audio::BounceStep step) const
   return track->bounce_ && track->bounce_to_master_;
 }
 
+utils::audio::AudioBuffer *
+TrackProcessor::get_bounce_tap () const
+{
+  return get_track ()->bounce_tap_;
+}
+
 bool
 TrackProcessor::are_events_on_midi_channel_approved (midi_byte_t channel) const
 {
@@ -452,18 +533,11 @@ TrackProcessor::init_after_cloning (
   if (other.cc_mappings_)
     cc_mappings_ = other.cc_mappings_->clone_unique ();
 
-  midi_cc_ids_ = std::make_unique<decltype (midi_cc_ids_)::element_type> ();
-  pitch_bend_ids_ =
-    std::make_unique<decltype (pitch_bend_ids_)::element_type> ();
-  poly_key_pressure_ids_ =
-    std::make_unique<decltype (poly_key_pressure_ids_)::element_type> ();
-  channel_pressure_ids_ =
-    std::make_unique<decltype (channel_pressure_ids_)::element_type> ();
-
-  *midi_cc_ids_ = *other.midi_cc_ids_;
-  *pitch_bend_ids_ = *other.pitch_bend_ids_;
-  *poly_key_pressure_ids_ = *other.poly_key_pressure_ids_;
-  *channel_pressure_ids_ = *other.channel_pressure_ids_;
+  has_midi_automatables_ = other.has_midi_automatables_;
+  midi_cc_ids_ = other.midi_cc_ids_;
+  pitch_bend_ids_ = other.pitch_bend_ids_;
+  poly_key_pressure_ids_ = other.poly_key_pressure_ids_;
+  channel_pressure_ids_ = other.channel_pressure_ids_;
 
   init_common ();
 }
@@ -511,20 +585,11 @@ TrackProcessor::append_ports (std::vector<Port *> &ports)
     {
       ports.push_back (std::addressof (get_piano_roll_port ()));
     }
-  if (midi_cc_ids_)
-    {
-      for (const auto ch_idx : std::views::iota (0, 16))
-        {
-          for (const auto cc_idx : std::views::iota (0, 128))
-            {
-              ports.push_back (
-                std::addressof (get_midi_cc_port (ch_idx, cc_idx)));
-            }
-          ports.push_back (std::addressof (get_pitch_bend_port (ch_idx)));
-          ports.push_back (std::addressof (get_poly_key_pressure_port (ch_idx)));
-          ports.push_back (std::addressof (get_channel_pressure_port (ch_idx)));
-        }
-    }
+  std::vector<ControlPort *> midi_automatable_ports;
+  append_midi_automatable_ports (midi_automatable_ports);
+  ports.insert (
+    ports.end (), midi_automatable_ports.begin (),
+    midi_automatable_ports.end ());
 }
 
 /**
@@ -797,6 +862,7 @@ TrackProcessor::handle_recording (const EngineProcessTimeInfo &time_nfo)
         .g_start_frame_w_offset_ = split_point,
         .local_offset_ = 0,
         .nframes_ = each_nframes[i],
+        .cycle_start_time_usecs_ = time_nfo.cycle_start_time_usecs_,
       };
       RECORDING_MANAGER->handle_recording (this, &cur_time_nfo);
     }
@@ -1048,7 +1114,7 @@ TrackProcessor::process (const EngineProcessTimeInfo &time_nfo)
           if (pending_midi_panic_)
             {
               get_midi_out_port ()
-                .midi_events_.active_events_.panic_without_lock ();
+                .midi_events_.active_events_.panic ();
               pending_midi_panic_ = false;
             }
         }
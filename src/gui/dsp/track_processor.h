@@ -72,6 +72,8 @@ public:
 
   bool should_bounce_to_master (utils::audio::BounceStep step) const override;
 
+  utils::audio::AudioBuffer * get_bounce_tap () const override;
+
   bool are_events_on_midi_channel_approved (midi_byte_t channel) const override;
 
   void on_midi_activity (const dsp::PortIdentifier &id) override;
@@ -164,9 +166,11 @@ public:
         throw std::runtime_error ("Not an audio track processor");
       }
     auto * l = std::get<AudioPort *> (
-      port_registry_.find_by_id_or_throw (stereo_in_left_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        stereo_in_left_id_.value (), stereo_in_left_handle_));
     auto * r = std::get<AudioPort *> (
-      port_registry_.find_by_id_or_throw (stereo_in_right_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        stereo_in_right_id_.value (), stereo_in_right_handle_));
     return { *l, *r };
   }
   std::pair<AudioPort &, AudioPort &> get_stereo_out_ports () const
@@ -176,68 +180,106 @@ public:
         throw std::runtime_error ("Not an audio track processor");
       }
     auto * l = std::get<AudioPort *> (
-      port_registry_.find_by_id_or_throw (stereo_out_left_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        stereo_out_left_id_.value (), stereo_out_left_handle_));
     auto * r = std::get<AudioPort *> (
-      port_registry_.find_by_id_or_throw (stereo_out_right_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        stereo_out_right_id_.value (), stereo_out_right_handle_));
     return { *l, *r };
   }
 
   ControlPort &get_mono_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_.find_by_id_or_throw (mono_id_.value ()));
+      port_registry_.find_by_id_or_throw (mono_id_.value (), mono_handle_));
   }
   ControlPort &get_input_gain_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_.find_by_id_or_throw (input_gain_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        input_gain_id_.value (), input_gain_handle_));
   }
   ControlPort &get_output_gain_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_.find_by_id_or_throw (output_gain_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        output_gain_id_.value (), output_gain_handle_));
   }
   ControlPort &get_monitor_audio_port () const
   {
     return *std::get<ControlPort *> (
-      port_registry_.find_by_id_or_throw (monitor_audio_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        monitor_audio_id_.value (), monitor_audio_handle_));
   }
   MidiPort &get_midi_in_port () const
   {
     return *std::get<MidiPort *> (
-      port_registry_.find_by_id_or_throw (midi_in_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        midi_in_id_.value (), midi_in_handle_));
   }
   MidiPort &get_midi_out_port () const
   {
     return *std::get<MidiPort *> (
-      port_registry_.find_by_id_or_throw (midi_out_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        midi_out_id_.value (), midi_out_handle_));
   }
   MidiPort &get_piano_roll_port () const
   {
     return *std::get<MidiPort *> (
-      port_registry_.find_by_id_or_throw (piano_roll_id_.value ()));
+      port_registry_.find_by_id_or_throw (
+        piano_roll_id_.value (), piano_roll_handle_));
   }
-  ControlPort &get_midi_cc_port (int channel_index, int cc_index) const
+
+  /**
+   * @brief Returns whether the processor has MIDI CC, pitch bend and pressure
+   * ports (piano roll tracks other than the chord track).
+   */
+  bool has_midi_automatable_ports () const { return has_midi_automatables_; }
+
+  /**
+   * @brief Returns the MIDI CC port for the given channel and controller, or
+   * null if it wasn't created yet.
+   *
+   * MIDI automatable ports are only created when something targets them (see
+   * get_or_create_midi_cc_port()).
+   */
+  ControlPort * get_midi_cc_port (int channel_index, int cc_index) const
   {
-    return *std::get<ControlPort *> (port_registry_.find_by_id_or_throw (
-      (*midi_cc_ids_).at ((channel_index * 128) + cc_index)));
+    return find_midi_automatable_port (
+      midi_cc_ids_, (channel_index * 128) + cc_index);
   }
-  ControlPort &get_pitch_bend_port (int channel_index) const
+  ControlPort * get_pitch_bend_port (int channel_index) const
   {
-    return *std::get<ControlPort *> (port_registry_.find_by_id_or_throw (
-      (*pitch_bend_ids_).at (channel_index)));
+    return find_midi_automatable_port (pitch_bend_ids_, channel_index);
   }
-  ControlPort &get_poly_key_pressure_port (int channel_index) const
+  ControlPort * get_poly_key_pressure_port (int channel_index) const
   {
-    return *std::get<ControlPort *> (port_registry_.find_by_id_or_throw (
-      (*poly_key_pressure_ids_).at (channel_index)));
+    return find_midi_automatable_port (poly_key_pressure_ids_, channel_index);
   }
-  ControlPort &get_channel_pressure_port (int channel_index) const
+  ControlPort * get_channel_pressure_port (int channel_index) const
   {
-    return *std::get<ControlPort *> (port_registry_.find_by_id_or_throw (
-      (*channel_pressure_ids_).at (channel_index)));
+    return find_midi_automatable_port (channel_pressure_ids_, channel_index);
   }
 
+  /**
+   * @brief Returns the MIDI CC port for the given channel and controller,
+   * creating it along with its automation track if needed.
+   *
+   * When a port is created for a processor in the active project, the engine
+   * is paused and the graph is recalculated.
+   *
+   * @throw ZrythmException if the processor has no MIDI automatable ports.
+   */
+  ControlPort &get_or_create_midi_cc_port (int channel_index, int cc_index);
+  ControlPort &get_or_create_pitch_bend_port (int channel_index);
+  ControlPort &get_or_create_poly_key_pressure_port (int channel_index);
+  ControlPort &get_or_create_channel_pressure_port (int channel_index);
+
+  /**
+   * @brief Appends the MIDI automatable ports created so far.
+   */
+  void append_midi_automatable_ports (std::vector<ControlPort *> &ports) const;
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 private:
@@ -252,7 +294,35 @@ private:
    * @param in True if input (false for output).
    */
   void init_midi_port (bool in);
-  void init_midi_cc_ports ();
+
+  ControlPort * find_midi_automatable_port (
+    const std::vector<PortUuid> &ids,
+    int                          port_index) const;
+
+  /**
+   * @brief Creates a MIDI automatable port and registers it in @p ids.
+   *
+   * @param port_index Index of the port in its group (see
+   * dsp::PortIdentifier::port_index_).
+   */
+  ControlPort &create_midi_automatable_port (
+    std::vector<PortUuid> &ids,
+    std::string            label,
+    std::string            sym,
+    int                    channel_index,
+    int                    port_index);
+
+  /**
+   * @brief Sets the caches of the given MIDI automatable port and binds its
+   * CC mapping, if any.
+   */
+  void init_midi_automatable_port (ControlPort &port);
+
+  /**
+   * @brief Inits a newly created MIDI automatable port and adds its automation
+   * track.
+   */
+  ControlPort &activate_midi_automatable_port (ControlPort &port);
 
   /**
    * Inits the stereo ports of the Channel while exposing them to the backend.
@@ -344,18 +414,42 @@ public:
    */
   std::optional<PortUuid> monitor_audio_id_;
 
+  /** Handles the port IDs above last resolved to, for the getters. */
+  utils::ObjectHandleCache stereo_in_left_handle_;
+  utils::ObjectHandleCache stereo_in_right_handle_;
+  utils::ObjectHandleCache stereo_out_left_handle_;
+  utils::ObjectHandleCache stereo_out_right_handle_;
+  utils::ObjectHandleCache mono_handle_;
+  utils::ObjectHandleCache input_gain_handle_;
+  utils::ObjectHandleCache output_gain_handle_;
+  utils::ObjectHandleCache monitor_audio_handle_;
+  utils::ObjectHandleCache midi_in_handle_;
+  utils::ObjectHandleCache midi_out_handle_;
+  utils::ObjectHandleCache piano_roll_handle_;
+
   /* --- MIDI controls --- */
 
   /** Mappings to each CC port. */
   std::unique_ptr<MidiMappings> cc_mappings_;
 
-  /** MIDI CC control ports, 16 channels x 128 controls. */
-  std::unique_ptr<std::array<PortUuid, 16zu * 128>> midi_cc_ids_;
+  /*
+   * The MIDI automatable ports below only contain the ports created so far,
+   * in creation order. Their dsp::PortIdentifier::port_index_ identifies them
+   * (channel_index * 128 + cc_index for CCs, channel_index for the rest).
+   */
+
+  /**
+   * Whether the ports below are supported.
+   *
+   * @see has_midi_automatable_ports().
+   */
+  bool has_midi_automatables_ = false;
 
-  using SixteenPortUuidArray = std::array<PortUuid, 16>;
+  /** MIDI CC control ports, up to 16 channels x 128 controls. */
+  std::vector<PortUuid> midi_cc_ids_;
 
-  /** Pitch bend x 16 channels. */
-  std::unique_ptr<SixteenPortUuidArray> pitch_bend_ids_;
+  /** Pitch bend, up to 16 channels. */
+  std::vector<PortUuid> pitch_bend_ids_;
 
   /**
    * Polyphonic key pressure (aftertouch).
@@ -366,7 +460,7 @@ public:
    * FIXME this is completely wrong. It's supposed to be per-key, so 128 x
    * 16 ports.
    */
-  std::unique_ptr<SixteenPortUuidArray> poly_key_pressure_ids_;
+  std::vector<PortUuid> poly_key_pressure_ids_;
 
   /**
    * Channel pressure (aftertouch).
@@ -374,7 +468,7 @@ public:
    * This message is different from polyphonic after-touch - sends the
    * single greatest pressure value (of all the current depressed keys).
    */
-  std::unique_ptr<SixteenPortUuidArray> channel_pressure_ids_;
+  std::vector<PortUuid> channel_pressure_ids_;
 
   /* --- end MIDI controls --- */
   /**
@@ -3,6 +3,7 @@
 #include "gui/backend/backend/actions/undo_manager.h"
 #include "gui/backend/backend/project.h"
 #include "gui/dsp/engine.h"
+#include "utils/concurrency.h"
 
 #include "./track_span.h"
 
@@ -73,7 +74,7 @@ TrackSpanImpl<Range>::fix_audio_regions ()
 {
   z_debug ("fixing audio region positions...");
 
-  int num_fixed{};
+  std::vector<AudioRegion *> regions;
   std::ranges::for_each (*this, [&] (auto &&track_var) {
     if (std::holds_alternative<AudioTrack *> (track_var))
       {
@@ -82,14 +83,24 @@ TrackSpanImpl<Range>::fix_audio_regions ()
           {
             const auto * lane = std::get<AudioLane *> (lane_var);
             lane->foreach_region ([&] (auto &region) {
-              if (region.fix_positions (0))
-                ++num_fixed;
+              regions.push_back (&region);
             });
           }
       }
   });
 
-  z_debug ("done fixing {} audio region positions", num_fixed);
+  /* regions are independent of each other, so fix them in parallel */
+  const auto          frames_per_tick = AUDIO_ENGINE->frames_per_tick_;
+  std::atomic<size_t> num_fixed = 0;
+  all_of_indices_in_parallel (
+    regions.size (), static_cast<size_t> (juce::SystemStats::getNumCpus ()),
+    [&] (size_t i) {
+      if (regions[i]->fix_positions (frames_per_tick))
+        ++num_fixed;
+      return true;
+    });
+
+  z_debug ("done fixing {} audio region positions", num_fixed.load ());
 
   return num_fixed > 0;
 }
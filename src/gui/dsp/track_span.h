@@ -396,6 +396,20 @@ public:
     });
   }
 
+  /**
+   * @brief Updates the playback snapshots of each track, only cloning the
+   * regions whose snapshot was invalidated.
+   *
+   * @see Track::update_playback_snapshots().
+   */
+  void update_playback_snapshots ()
+  {
+    std::ranges::for_each (*this, [&] (auto &track_var) {
+      std::visit (
+        [&] (auto &&track) { track->update_playback_snapshots (); }, track_var);
+    });
+  }
+
   /**
    * Exposes each track's ports that should be exposed to the backend.
    *
@@ -442,6 +456,29 @@ public:
     });
   }
 
+  /**
+   * Unfreezes the frozen tracks whose frozen clip no longer matches their
+   * contents (see ChannelTrack::is_freeze_stale()).
+   */
+  void unfreeze_stale_tracks ()
+  {
+    std::ranges::for_each (*this, [&] (auto &track_var) {
+      std::visit (
+        [&] (auto &&track) {
+          using TrackT = base_type<decltype (track)>;
+          if constexpr (std::derived_from<TrackT, ChannelTrack>)
+            {
+              if (track->frozen_ && track->is_freeze_stale ())
+                {
+                  z_info ("unfreezing stale track '{}'", track->name_);
+                  track->unfreeze ();
+                }
+            }
+        },
+        track_var);
+    });
+  }
+
   void init_loaded (
     gui::old_dsp::plugins::PluginRegistry &plugin_registry,
     PortRegistry                          &port_registry)
@@ -12,12 +12,15 @@
 #include "gui/dsp/marker_track.h"
 #include "gui/dsp/master_track.h"
 #include "gui/dsp/modulator_track.h"
+#include "gui/dsp/pool.h"
 #include "gui/dsp/router.h"
 #include "gui/dsp/tempo_track.h"
 #include "gui/dsp/track.h"
 #include "gui/dsp/tracklist.h"
+#include "utils/concurrency.h"
 #include "utils/flags.h"
 #include "utils/gtest_wrapper.h"
+#include "utils/io.h"
 #include "utils/rt_thread_id.h"
 #include "utils/string.h"
 
@@ -82,6 +85,8 @@ Tracklist::init_loaded (
               modulator_track_ = track;
             }
           track->tracklist_ = this;
+          update_track_selection (*track);
+          connect_track (*track);
           track->init_loaded (*plugin_registry_, *port_registry_);
         },
         track_var);
@@ -217,7 +222,6 @@ Tracklist::insert_track (
 {
   auto track_var = get_track_registry ().find_by_id_or_throw (track_id);
 
-  beginResetModel ();
   std::visit (
     [&] (auto &&track) {
       using TrackT = base_type<decltype (track)>;
@@ -235,6 +239,8 @@ Tracklist::insert_track (
           return;
         }
 
+      beginInsertRows ({}, pos, pos);
+
       /* set to -1 so other logic knows it is a new track */
       track->pos_ = -1;
 
@@ -244,6 +250,7 @@ Tracklist::insert_track (
       /* append the track at the end */
       tracks_.emplace_back (track_id);
       track->tracklist_ = this;
+      update_track_selection (*track);
 
       /* remember important tracks */
       if constexpr (std::is_same_v<TrackT, MasterTrack>)
@@ -279,6 +286,9 @@ Tracklist::insert_track (
         }
 
       track->pos_ = pos;
+      connect_track (*track);
+
+      endInsertRows ();
 
       if (
         is_in_active_project ()
@@ -349,7 +359,6 @@ Tracklist::insert_track (
         track->get_uuid (), pos);
     },
     track_var);
-  endResetModel ();
   return track_var;
 }
 
@@ -400,52 +409,55 @@ Tracklist::multiply_track_heights (
 }
 
 bool
-Tracklist::validate () const
+Tracklist::validate (size_t sample_stride) const
 {
-  /* this validates tracks in parallel */
-  std::vector<std::future<bool>> ret_vals;
-  ret_vals.reserve (tracks_.size ());
-  auto span = get_track_span ();
-  for (const auto [index, track_var] : std::views::enumerate (span))
-    {
-      ret_vals.emplace_back (std::async ([this, index, &track_var] () {
-        // z_return_val_if_fail (track && track->is_in_active_project (), false);
-        auto * tr = Track::from_variant (track_var);
-        z_return_val_if_fail (tr, false);
+  z_return_val_if_fail (sample_stride > 0, false);
+
+  auto         span = get_track_span ();
+  const size_t first_index =
+    sample_stride > 1 ? validation_sample_offset_++ % sample_stride : 0;
+  const size_t num_to_validate =
+    span.size () > first_index
+      ? (span.size () - first_index + sample_stride - 1) / sample_stride
+      : 0;
 
-        if (!tr->validate ())
+  /* this validates tracks in parallel */
+  return all_of_indices_in_parallel (
+    num_to_validate, static_cast<size_t> (juce::SystemStats::getNumCpus ()),
+    [&] (size_t i) {
+      const auto index = first_index + (i * sample_stride);
+      // z_return_val_if_fail (track && track->is_in_active_project (), false);
+      auto * tr = Track::from_variant (span[index]);
+      z_return_val_if_fail (tr, false);
+
+      if (!tr->validate ())
+        return false;
+
+      if (tr->pos_ != static_cast<int> (index))
+        {
           return false;
+        }
 
-        if (tr->pos_ != index)
-          {
-            return false;
-          }
-
-        /* validate size */
-        int track_size = 1;
-        if (const auto * foldable_track = dynamic_cast<FoldableTrack *> (tr))
-          {
-            track_size = foldable_track->size_;
-          }
-        z_return_val_if_fail (
-          tr->pos_ + track_size <= (int) tracks_.size (), false);
-
-        /* validate connections */
-        if (const auto * channel_track = dynamic_cast<ChannelTrack *> (tr))
-          {
-            const auto &channel = channel_track->get_channel ();
-            for (const auto &send : channel->get_sends ())
-              {
-                send->validate ();
-              }
-          }
-        return true;
-      }));
-    }
+      /* validate size */
+      int track_size = 1;
+      if (const auto * foldable_track = dynamic_cast<FoldableTrack *> (tr))
+        {
+          track_size = foldable_track->size_;
+        }
+      z_return_val_if_fail (
+        tr->pos_ + track_size <= (int) tracks_.size (), false);
 
-  return std::all_of (ret_vals.begin (), ret_vals.end (), [] (auto &t) {
-    return t.get ();
-  });
+      /* validate connections */
+      if (const auto * channel_track = dynamic_cast<ChannelTrack *> (tr))
+        {
+          const auto &channel = channel_track->get_channel ();
+          for (const auto &send : channel->get_sends ())
+            {
+              send->validate ();
+            }
+        }
+      return true;
+    });
 }
 
 int
@@ -545,8 +557,6 @@ Tracklist::remove_track (
         track_index, track->get_name (), rm_pl, router.has_value (),
         tracks_.size ());
 
-      beginRemoveRows ({}, track_index, track_index);
-
       std::optional<TrackPtrVariant> prev_visible = std::nullopt;
       std::optional<TrackPtrVariant> next_visible = std::nullopt;
       if (!is_auditioner ())
@@ -568,7 +578,12 @@ Tracklist::remove_track (
 
       track_it = std::ranges::find (tracks_, track_id);
       z_return_if_fail (track_it != tracks_.end ());
+      const auto remove_index = std::distance (tracks_.begin (), track_it);
+      beginRemoveRows ({}, remove_index, remove_index);
+      QObject::disconnect (track, nullptr, this, nullptr);
       tracks_.erase (track_it);
+      selected_tracks_.remove (track_id);
+      endRemoveRows ();
 
       // recreate the span because underlying vector changed
       span = get_track_span ();
@@ -576,7 +591,7 @@ Tracklist::remove_track (
       if (is_in_active_project () && !is_auditioner ())
         {
           /* if it was the only track selected, select the next one */
-          if (std::ranges::count_if (span, span.selected_projection) == 0)
+          if (selected_tracks_.empty ())
             {
               auto track_to_select = next_visible ? next_visible : prev_visible;
               if (!track_to_select && !tracks_.empty ())
@@ -599,8 +614,6 @@ Tracklist::remove_track (
           router->get ().recalc_graph (false);
         }
 
-      endRemoveRows ();
-
       z_debug ("done removing track {}", track->getName ());
     },
     track_var);
@@ -611,30 +624,90 @@ Tracklist::clear_selections_for_object_siblings (
   const ArrangerObject::Uuid &object_id)
 {
   auto obj_var = PROJECT->find_arranger_object_by_id (object_id);
-  std::visit (
-    [&] (auto &&obj) {
+  z_return_if_fail (obj_var.has_value ());
+
+  /* the region whose children are the siblings, if the object is in an
+   * editor */
+  const auto region_id = std::visit (
+    [&] (auto &&obj) -> std::optional<RegionIdentifier> {
       using ObjT = base_type<decltype (obj)>;
       if constexpr (std::derived_from<ObjT, RegionOwnedObject>)
-        {
-          auto region = obj->get_region ();
-          auto children = region->get_objects ();
-          for (auto &child : children)
+        return obj->region_id_;
+      else
+        return std::nullopt;
+    },
+    obj_var->get ());
+
+  for (const auto &selected_var : get_selected_arranger_objects ())
+    {
+      std::visit (
+        [&] (auto &&selected) {
+          using ObjT = base_type<decltype (selected)>;
+          if constexpr (std::derived_from<ObjT, RegionOwnedObject>)
             {
-              child->setSelected (false);
+              if (region_id && selected->region_id_ == *region_id)
+                selected->setSelected (false);
             }
-        }
-      else
-        {
-          auto tl_objs = get_timeline_objects_in_range ();
-          for (const auto &tl_obj_var : tl_objs)
+          else if (!region_id)
             {
-              std::visit (
-                [&] (auto &&tl_obj) { tl_obj->setSelected (false); },
-                tl_obj_var);
+              selected->setSelected (false);
             }
+        },
+        selected_var);
+    }
+}
+
+std::vector<TrackPtrVariant>
+Tracklist::get_selected_tracks () const
+{
+  std::vector<TrackPtrVariant> ret;
+  ret.reserve (selected_tracks_.size ());
+  for (const auto &track_id : selected_tracks_.get_ids ())
+    {
+      auto track_var = get_track_registry ().find_by_id (track_id);
+      if (!track_var)
+        continue;
+
+      std::visit (
+        [&] (auto &&track) {
+          if (track->tracklist_ == this && track->is_selected ())
+            ret.push_back (track);
+        },
+        track_var->get ());
+    }
+  return ret;
+}
+
+std::vector<ArrangerObjectPtrVariant>
+Tracklist::get_selected_arranger_objects ()
+{
+  std::vector<ArrangerObjectPtrVariant> ret;
+  std::vector<ArrangerObject::Uuid>     stale_ids;
+  ret.reserve (selected_arranger_objects_.size ());
+  for (const auto &obj_id : selected_arranger_objects_.get_ids ())
+    {
+      auto obj_var = PROJECT->find_arranger_object_by_id (obj_id);
+      if (!obj_var)
+        {
+          stale_ids.push_back (obj_id);
+          continue;
         }
-    },
-    *obj_var);
+
+      std::visit (
+        [&] (auto &&obj) {
+          if (obj->is_selected ())
+            ret.push_back (obj);
+          else
+            stale_ids.push_back (obj_id);
+        },
+        obj_var->get ());
+    }
+
+  for (const auto &obj_id : stale_ids)
+    {
+      selected_arranger_objects_.remove (obj_id);
+    }
+  return ret;
 }
 
 std::vector<ArrangerObjectPtrVariant>
@@ -706,8 +779,6 @@ Tracklist::move_track (
       if (pos == track_index)
         return;
 
-      beginMoveRows ({}, track_index, track_index, {}, pos);
-
       bool move_higher = pos < track_index;
 
       auto prev_visible = get_prev_visible_track (track_id);
@@ -724,9 +795,7 @@ Tracklist::move_track (
           track->setSelected (false);
 
           /* if it was the only track selected, select the next one */
-          if (
-            std::ranges::count_if (span, span.selected_projection) == 0
-            && (prev_visible || next_visible))
+          if (selected_tracks_.empty () && (prev_visible || next_visible))
             {
               auto track_to_add = next_visible ? *next_visible : *prev_visible;
               std::visit (
@@ -734,6 +803,20 @@ Tracklist::move_track (
             }
         }
 
+      /* the row the track ends up at */
+      const int new_index = std::min (
+        !move_higher && always_before_pos && pos > 0 ? pos - 1 : pos,
+        static_cast<int> (tracks_.size ()) - 1);
+      const bool index_changed = new_index != track_index;
+      if (index_changed)
+        {
+          /* the destination is the row before which the track is moved, in
+           * the rows before the move */
+          beginMoveRows (
+            {}, track_index, track_index, {},
+            new_index > track_index ? new_index + 1 : new_index);
+        }
+
       /* the current implementation currently moves some tracks to tracks.size()
        * + 1 temporarily, so we expand the vector here and resize it back at the
        * end */
@@ -773,6 +856,11 @@ Tracklist::move_track (
           tracks_.resize (tracks_.size () - 1);
         }
 
+      if (index_changed)
+        {
+          endMoveRows ();
+        }
+
       // recreate span
       span = get_track_span ();
 
@@ -787,8 +875,6 @@ Tracklist::move_track (
           router->get ().recalc_graph (false);
         }
 
-      endMoveRows ();
-
       z_debug ("finished moving track");
     },
     *track_var);
@@ -805,6 +891,32 @@ Tracklist::track_name_is_unique (
     .contains_track_name (name);
 }
 
+void
+Tracklist::update_solo_state ()
+{
+  if (!solo_state_dirty_.exchange (false, std::memory_order_acquire))
+    return;
+
+  const auto span = get_track_span ();
+  has_soloed_.store (span.has_soloed (), std::memory_order_relaxed);
+  has_listened_.store (span.has_listened (), std::memory_order_relaxed);
+
+  for (const auto &track_var : span)
+    {
+      std::visit (
+        [&] (auto &&track) {
+          using TrackT = base_type<decltype (track)>;
+          if constexpr (std::derived_from<TrackT, ChannelTrack>)
+            {
+              auto * fader = track->get_fader (true);
+              fader->implied_soloed_.store (
+                fader->get_implied_soloed (), std::memory_order_relaxed);
+            }
+        },
+        track_var);
+    }
+}
+
 void
 Tracklist::import_regions (
   std::vector<std::vector<std::shared_ptr<Region>>> &region_arrays,
@@ -906,7 +1018,8 @@ Tracklist::import_files (
   const TrackLane *      lane,
   int                    index,
   const dsp::Position *  pos,
-  TracksReadyCallback    ready_cb)
+  TracksReadyCallback    ready_cb,
+  ProgressInfo *         progress_info)
 {
   std::vector<FileDescriptor> file_arr;
   if (orig_file)
@@ -961,6 +1074,57 @@ Tracklist::import_files (
         }
     }
 
+  /* audio files dropped outside tracks are imported in one batch, each in a
+   * new track */
+  if (!track && std::ranges::all_of (file_arr, [] (const auto &file) {
+        return file.is_audio ();
+      }))
+    {
+      std::vector<fs::path> paths;
+      for (const auto &file : file_arr)
+        {
+          paths.emplace_back (file.abs_path_);
+        }
+      const auto pool_ids = AUDIO_POOL->add_clips_from_files (
+        paths, AUDIO_ENGINE->sample_rate_, tempo_track_->get_current_bpm (),
+        progress_info);
+
+      const int start_index =
+        index >= 0 ? index : static_cast<int> (tracks_.size ());
+      gui::actions::UndoManager::Transaction transaction (*UNDO_MANAGER);
+      int executed_actions = 0;
+      try
+        {
+          for (size_t i = 0; i < pool_ids.size (); ++i)
+            {
+              UNDO_MANAGER->perform (
+                new gui::actions::CreateAudioTrackFromClipAction (
+                  pool_ids[i],
+                  utils::io::path_get_basename (file_arr[i].abs_path_),
+                  start_index + static_cast<int> (i), pos));
+              ++executed_actions;
+            }
+        }
+      catch (const ZrythmException &)
+        {
+          /* undo any performed actions */
+          while (executed_actions > 0)
+            {
+              UNDO_MANAGER->undo ();
+              --executed_actions;
+            }
+          throw;
+        }
+
+      /* undo/redo all the tracks at once */
+      auto last_action = UNDO_MANAGER->get_last_action ();
+      z_return_if_fail (last_action.has_value ());
+      std::visit (
+        [&] (auto &&ua) { ua->num_actions_ = executed_actions; },
+        *last_action);
+      return;
+    }
+
   StringArray filepaths;
   for (const auto &file : file_arr)
     {
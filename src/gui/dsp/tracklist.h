@@ -13,6 +13,7 @@
 #include "gui/dsp/arranger_object_span.h"
 #include "gui/dsp/track.h"
 #include "gui/dsp/track_span.h"
+#include "utils/selection_index.h"
 
 #include <QtQmlIntegration>
 
@@ -32,6 +33,7 @@ class ModulatorTrack;
 class MasterTrack;
 class MarkerTrack;
 class StringArray;
+class ProgressInfo;
 class Router;
 
 /**
@@ -209,7 +211,16 @@ public:
     int       publish_events,
     int       recalc_graph);
 
-  bool validate () const;
+  /**
+   * @brief Validates the tracks in parallel.
+   *
+   * Stops at the first invalid track.
+   *
+   * @param sample_stride Only validate every Nth track (1 validates all
+   * tracks). Each sampled pass starts at a different track, so consecutive
+   * passes eventually cover all tracks.
+   */
+  bool validate (size_t sample_stride = 1) const;
 
   ChordTrack * get_chord_track () const;
 
@@ -305,11 +316,48 @@ public:
   /**
    * @brief Clears either the timeline selections or the clip editor selections.
    *
+   * Only goes through the selected objects.
+   *
    * @param object_id The object that is part of the target selections.
    */
   void
   clear_selections_for_object_siblings (const ArrangerObject::Uuid &object_id);
 
+  /**
+   * @brief Updates the selection index after the selection status of a track
+   * in this tracklist changed.
+   */
+  void update_track_selection (const Track &track)
+  {
+    selected_tracks_.set_selected (track.get_uuid (), track.is_selected ());
+  }
+
+  /**
+   * @brief Returns the selected tracks, in no particular order.
+   *
+   * Only goes through the selected tracks.
+   */
+  std::vector<TrackPtrVariant> get_selected_tracks () const;
+
+  /**
+   * @brief Updates the selection index after the selection status of an
+   * arranger object registered in the project changed.
+   */
+  void update_arranger_object_selection (const ArrangerObject &obj)
+  {
+    selected_arranger_objects_.set_selected (
+      obj.get_uuid (), obj.is_selected ());
+  }
+
+  /**
+   * @brief Returns the selected arranger objects of the project, in no
+   * particular order.
+   *
+   * Only goes through the selected objects, and drops the ones that no longer
+   * exist from the index.
+   */
+  std::vector<ArrangerObjectPtrVariant> get_selected_arranger_objects ();
+
   /**
    * @brief Imports regions from a region array.
    *
@@ -327,12 +375,18 @@ public:
    * Begins file import Handles a file drop inside the timeline or in empty
    * space in the tracklist.
    *
+   * Audio files dropped outside tracks are decoded in parallel and added as
+   * new tracks in a single undoable step (see
+   * AudioPool::add_clips_from_files()).
+   *
    * @param uri_list URI list, if URI list was dropped.
    * @param file File, if FileDescriptor was dropped.
    * @param track Track, if any.
    * @param lane TrackLane, if any.
    * @param index Index to insert new tracks at, or -1 to insert at end.
    * @param pos Position the file was dropped at, if inside track.
+   * @param progress_info Progress info to report the import progress to, if
+   * any.
    *
    * @throw ZrythmException on error.
    */
@@ -343,7 +397,8 @@ public:
     const TrackLane *             lane,
     int                           index,
     const zrythm::dsp::Position * pos,
-    TracksReadyCallback           ready_cb);
+    TracksReadyCallback           ready_cb,
+    ProgressInfo *                progress_info = nullptr);
 
 #if 0
   /**
@@ -393,11 +448,66 @@ public:
     return is_track_pinned (get_track_index (track_id));
   }
 
+  /**
+   * @brief Marks the cached solo state as outdated (see update_solo_state()).
+   *
+   * To be called when a track's solo or listen state changes or the routing
+   * changes. Realtime-safe.
+   */
+  void invalidate_solo_state ()
+  {
+    solo_state_dirty_.store (true, std::memory_order_release);
+  }
+
+  /**
+   * @brief Recalculates the cached solo state if outdated.
+   *
+   * This caches whether any track is soloed/listened and whether each
+   * channel fader is implied-soloed (see Fader::get_implied_soloed()), so
+   * that the faders don't need to go through all the tracks every cycle.
+   *
+   * Called by the engine at the start of each cycle.
+   */
+  void update_solo_state ();
+
+  /**
+   * @brief Returns whether any track is soloed, as of the last
+   * update_solo_state().
+   */
+  bool has_soloed_tracks () const
+  {
+    return has_soloed_.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns whether any track is listened, as of the last
+   * update_solo_state().
+   */
+  bool has_listened_tracks () const
+  {
+    return has_listened_.load (std::memory_order_relaxed);
+  }
+
   DECLARE_DEFINE_FIELDS_METHOD ();
 
 private:
   void swap_tracks (size_t index1, size_t index2);
 
+  /**
+   * @brief Notifies views of changes to @p track's row (only the roles that
+   * changed), when the track is in this tracklist.
+   */
+  template <typename TrackT> void connect_track (TrackT &track)
+  {
+    QObject::connect (&track, &TrackT::nameChanged, this, [this, &track] () {
+      const auto row = index (track.pos_);
+      if (row.isValid ())
+        {
+          Q_EMIT dataChanged (row, row, { TrackNameRole });
+        }
+    });
+  }
+
   TrackRegistry &get_track_registry () const;
 
 public:
@@ -460,6 +570,22 @@ public:
   std::optional<TrackRegistryRef>                         track_registry_;
   std::optional<PortRegistryRef>                          port_registry_;
   std::optional<gui::old_dsp::plugins::PluginRegistryRef> plugin_registry_;
+
+private:
+  /**
+   * Selected tracks and arranger objects, kept in sync with their selection
+   * flags so that selection queries don't need to go through all objects.
+   */
+  utils::SelectionIndex<Track::TrackUuid>     selected_tracks_;
+  utils::SelectionIndex<ArrangerObject::Uuid> selected_arranger_objects_;
+
+  /* cached solo state (see update_solo_state()) */
+  std::atomic<bool> solo_state_dirty_ = true;
+  std::atomic<bool> has_soloed_ = false;
+  std::atomic<bool> has_listened_ = false;
+
+  /** Counter used to vary the tracks checked by sampled validate() passes. */
+  mutable std::atomic<size_t> validation_sample_offset_ = 0;
 };
 
 /**
@@ -12,6 +12,7 @@
 #include "gui/dsp/laned_track.h"
 #include "gui/dsp/marker.h"
 #include "gui/dsp/marker_track.h"
+#include "gui/dsp/scale_object.h"
 #include "gui/dsp/tempo_track.h"
 #include "gui/dsp/tracklist.h"
 #include "gui/dsp/transport.h"
@@ -21,6 +22,8 @@
 #include "utils/gtest_wrapper.h"
 #include "utils/rt_thread_id.h"
 
+#include <QtConcurrent>
+
 using namespace zrythm;
 
 /**
@@ -334,6 +337,16 @@ Transport::stretch_regions (
   double                                   time_ratio,
   bool                                     force)
 {
+  /* audio regions are stretched in parallel after collecting them */
+  struct AudioRegionStretch
+  {
+    AudioRegion *              region_;
+    double                     ratio_;
+    utils::audio::AudioBuffer  frames_;
+    std::optional<std::string> error_;
+  };
+  std::vector<AudioRegionStretch> audio_stretches;
+
   if (sel_var)
     {
       std::visit (
@@ -343,19 +356,23 @@ Transport::stretch_regions (
               auto r_variant = convert_to_variant<RegionPtrVariant> (region);
               std::visit (
                 [&] (auto &&r) {
+                  double ratio =
+                    with_fixed_ratio
+                      ? time_ratio
+                      : r->get_length_in_ticks () / r->before_length_;
                   if constexpr (
                     std::is_same_v<base_type<decltype (r)>, AudioRegion>)
                     {
                       /* don't stretch audio regions with musical mode off */
                       if (!r->get_musical_mode () && !force)
                         return;
-                    }
 
-                  double ratio =
-                    with_fixed_ratio
-                      ? time_ratio
-                      : r->get_length_in_ticks () / r->before_length_;
-                  r->stretch (ratio);
+                      audio_stretches.push_back ({ r, ratio, {}, {} });
+                    }
+                  else
+                    {
+                      r->stretch (ratio);
+                    }
                 },
                 r_variant);
             }
@@ -382,11 +399,40 @@ Transport::stretch_regions (
                     with_fixed_ratio
                       ? time_ratio
                       : region->get_length_in_ticks () / region->before_length_;
-                  region->stretch (ratio);
+                  audio_stretches.push_back ({ region, ratio, {}, {} });
                 }
             }
         }
     }
+
+  if (audio_stretches.empty ())
+    return;
+
+  z_debug ("stretching {} audio regions", audio_stretches.size ());
+  QtConcurrent::blockingMap (
+    audio_stretches, [] (AudioRegionStretch &stretch) {
+      try
+        {
+          stretch.frames_ =
+            stretch.region_->get_stretched_frames (stretch.ratio_);
+        }
+      catch (const std::exception &e)
+        {
+          stretch.error_ = e.what ();
+        }
+    });
+
+  /* the clips are replaced in order, in the calling thread */
+  for (auto &stretch : audio_stretches)
+    {
+      if (stretch.error_)
+        {
+          throw ZrythmException (*stretch.error_);
+        }
+      stretch.region_->stretching_ = true;
+      stretch.region_->apply_stretched_frames (stretch.frames_);
+      stretch.region_->stretching_ = false;
+    }
 }
 
 void
@@ -594,15 +640,16 @@ Transport::move_playhead (
                   if constexpr (
                     std::is_same_v<typename TrackLaneT::RegionT, MidiRegion>)
                     {
+                      MidiEventVector note_offs;
                       for (auto &midi_note : region->midi_notes_)
                         {
                           if (midi_note->is_hit (playhead_pos_->frames_))
                             {
-                              t->processor_->get_piano_roll_port ()
-                                .midi_events_.queued_events_
-                                .add_note_off (1, midi_note->pitch_, 0);
+                              note_offs.add_note_off (1, midi_note->pitch_, 0);
                             }
                         }
+                      t->processor_->get_piano_roll_port ()
+                        .midi_events_.queue_from_non_rt (note_offs);
                     }
                 }
             }
@@ -674,7 +721,7 @@ Transport::move_to_marker_or_pos_and_fire_events (
   const Marker *   marker,
   const Position * pos)
 {
-  move_playhead (marker ? marker->pos_ : pos, true, true, true);
+  move_playhead (marker ? &*marker->pos_ : pos, true, true, true);
 
   if (ZRYTHM_HAVE_UI)
     {
@@ -899,15 +946,66 @@ Transport::position_is_inside_punch_range (const Position pos)
          && pos.frames_ < punch_out_pos_->frames_;
 }
 
+void
+Transport::update_object_end (const ArrangerObjectPtrVariant &obj_var)
+{
+  std::visit (
+    [&] (auto &&obj) {
+      using ObjT = base_type<decltype (obj)>;
+
+      /* only timeline objects have global positions */
+      if constexpr (
+        std::derived_from<ObjT, Region> || std::is_same_v<ObjT, ScaleObject>
+        || std::is_same_v<ObjT, Marker>)
+        {
+          Position pos;
+          if constexpr (std::derived_from<ObjT, BoundedObject>)
+            {
+              obj->get_end_pos (&pos);
+            }
+          else
+            {
+              obj->get_pos (&pos);
+            }
+          object_end_ticks_.set (obj->get_uuid (), pos.ticks_);
+        }
+    },
+    obj_var);
+}
+
+void
+Transport::rebuild_object_end_index ()
+{
+  z_debug ("indexing the end positions of all timeline objects...");
+
+  object_end_ticks_.clear ();
+  std::vector<ArrangerObjectPtrVariant> objs;
+  for (const auto &track_var : TRACKLIST->get_track_span ())
+    {
+      objs.clear ();
+      Track::from_variant (track_var)->append_objects (objs);
+      for (const auto &obj_var : objs)
+        {
+          update_object_end (obj_var);
+        }
+    }
+  object_end_index_built_ = true;
+
+  z_debug ("indexed {} objects", object_end_ticks_.size ());
+}
+
 void
 Transport::recalculate_total_bars (
-  std::optional<ArrangerObjectSpanVariant> sel_var)
+  std::optional<ArrangerObjectSpanVariant> objects)
 {
   if (!ZRYTHM_HAVE_UI)
     return;
 
-  int total_bars = total_bars_;
-  if (sel_var)
+  if (!objects || !object_end_index_built_)
+    {
+      rebuild_object_end_index ();
+    }
+  else
     {
       std::visit (
         [&] (auto &&sel) {
@@ -915,41 +1013,34 @@ Transport::recalculate_total_bars (
             {
               std::visit (
                 [&] (auto &&obj) {
-                  using ObjT = base_type<decltype (obj)>;
-                  Position pos;
-                  if constexpr (std::derived_from<ObjT, BoundedObject>)
+                  /* the given objects may be clones or removed from the
+                   * project */
+                  if (auto prj_obj = obj->find_in_project ())
                     {
-                      obj->get_position_from_type (
-                        &pos, ArrangerObject::PositionType::End);
+                      update_object_end (*prj_obj);
                     }
                   else
                     {
-                      obj->get_pos (&pos);
-                    }
-                  int pos_bars = pos.get_total_bars (
-                    true, ticks_per_bar_,
-                    project_->audio_engine_->frames_per_tick_);
-                  if (pos_bars > total_bars - 3)
-                    {
-                      total_bars = pos_bars + BARS_END_BUFFER;
+                      object_end_ticks_.remove (obj->get_uuid ());
                     }
                 },
                 obj_var);
             }
         },
-        *sel_var);
+        *objects);
     }
-  /* else no selections, calculate total bars for
-   * every object */
-  else
-    {
-      total_bars = TRACKLIST->get_track_span ().get_total_bars (
-        *this, TRANSPORT_DEFAULT_TOTAL_BARS);
 
-      total_bars += BARS_END_BUFFER;
+  int total_bars = TRANSPORT_DEFAULT_TOTAL_BARS;
+  if (const auto end_ticks = object_end_ticks_.get_max ())
+    {
+      const auto frames_per_tick = project_->audio_engine_->frames_per_tick_;
+      const auto end_pos = Position (*end_ticks, frames_per_tick);
+      total_bars = std::max (
+        end_pos.get_total_bars (true, ticks_per_bar_, frames_per_tick),
+        total_bars);
     }
 
-  update_total_bars (total_bars, true);
+  update_total_bars (total_bars + BARS_END_BUFFER, true);
 }
 
 bool
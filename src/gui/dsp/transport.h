@@ -10,6 +10,7 @@
 #include "gui/dsp/arranger_object_span.h"
 #include "gui/dsp/midi_port.h"
 #include "gui/dsp/port.h"
+#include "utils/max_value_index.h"
 #include "utils/types.h"
 
 class Marker;
@@ -462,8 +463,12 @@ frames_add_frames (
   /**
    * Recalculates the total bars based on the last object's position.
    *
-   * @param sel If given, only these objects will be checked, otherwise every
-   * object in the project will be checked.
+   * The end positions of the timeline objects are indexed, so only the
+   * objects that changed need to be checked.
+   *
+   * @param objects Objects that were added, moved, resized or removed since
+   * the last call (objects no longer in the project are removed from the
+   * index). If not given, every object in the project will be checked.
    *
    * FIXME: use signals to update the total bars.
    */
@@ -493,6 +498,17 @@ frames_add_frames (
 private:
   void init_common ();
 
+  /**
+   * Updates the end position of @p obj_var in @ref object_end_ticks_ (if it
+   * is a timeline object).
+   */
+  void update_object_end (const ArrangerObjectPtrVariant &obj_var);
+
+  /**
+   * Indexes the end positions of all timeline objects in the project.
+   */
+  void rebuild_object_end_index ();
+
   /**
    * One of @param marker or @param pos must be non-NULL.
    */
@@ -629,6 +645,15 @@ private:
    */
   QTimer *          property_notification_timer_ = nullptr;
   std::atomic<bool> needs_property_notification_{ false };
+
+  /**
+   * End positions (in ticks, so that they don't change with the tempo or
+   * time signature) of the timeline objects in the project.
+   */
+  utils::MaxValueIndex<ArrangerObject::Uuid, double> object_end_ticks_;
+
+  /** Whether @ref object_end_ticks_ has been built. */
+  bool object_end_index_built_ = false;
 };
 
 /**
@@ -37,6 +37,7 @@ void
 Velocity::set_val (const int val)
 {
   vel_ = std::clamp<uint8_t> (val, 0, 127);
+  ArrangerObject::invalidate_placements ();
 
   /* re-set the midi note value to set a note off event */
   auto * note = get_midi_note ();
@@ -81,6 +81,8 @@ ColumnLayout {
 
                         editorSettings: project.timeline
                         transport: project.transport
+                        visibleX: rulerScrollView.contentItem.contentX
+                        visibleWidth: rulerScrollView.width
                     }
 
                     Binding {
@@ -32,113 +32,32 @@ Item {
     readonly property real barLineOpacity: 0.8
     readonly property real beatLineOpacity: 0.6
     readonly property real sixteenthLineOpacity: 0.4
+    // Visible part of the ruler when it is scrolled (the whole ruler if 0)
+    property real visibleX: 0
+    property real visibleWidth: 0
 
     height: rulerHeight
     width: 1000 * pxPerBar
 
     // Grid lines and time markers
-    Item {
+    RulerTicksItem {
         id: timeGrid
 
-        height: parent.height
-
-        // Generate bars based on zoom level
-        Repeater {
-            model: 1000 // Will be clipped by parent ScrollView
-
-            Rectangle {
-                width: 2
-                height: 14 // parent.height / 3
-                color: control.palette.text
-                opacity: control.barLineOpacity
-                x: index * control.pxPerBar
-
-                Text {
-                    text: index + 1
-                    color: control.palette.text
-                    anchors.left: parent.right
-                    anchors.bottom: parent.bottom
-                    anchors.leftMargin: 2
-                    font.family: Style.smallTextFont.family
-                    font.pixelSize: Style.smallTextFont.pixelSize
-                    font.weight: Font.Medium
-                }
-
-            }
-
-        }
-
-        // Generate beats based on zoom level
-        Loader {
-            active: control.pxPerBeat > control.detailMeasurePxThreshold
-            visible: active
-
-            sourceComponent: Repeater {
-                model: 1000 * 4
-
-                Rectangle {
-                    width: 1
-                    height: 10
-                    color: control.palette.text
-                    opacity: control.beatLineOpacity
-                    x: index * control.pxPerBeat
-                    visible: index % 4 !== 0
-
-                    Text {
-                        readonly property int bar: Math.trunc(index / 4) + 1
-                        readonly property int beatIndex: index % 4 + 1
-
-                        text: `${bar}.${beatIndex}`
-                        color: control.palette.text
-                        anchors.left: parent.right
-                        anchors.top: parent.top
-                        anchors.leftMargin: 2
-                        font: Style.xSmallTextFont
-                        visible: control.pxPerBeat > control.detailMeasureLabelPxThreshold
-                    }
-
-                }
-
-            }
-
-        }
-
-        // Generate sixteenths based on zoom level
-        Loader {
-            active: control.pxPerSixteenth > control.detailMeasurePxThreshold
-            visible: active
-
-            sourceComponent: Repeater {
-                model: 1000 * 4
-
-                Rectangle {
-                    width: 1
-                    height: 8
-                    color: control.palette.text
-                    opacity: control.sixteenthLineOpacity
-                    x: index * control.pxPerSixteenth
-                    visible: index % 4 !== 0
-
-                    Text {
-                        readonly property int bar: Math.trunc(index / 16) + 1
-                        readonly property int beatIndex: Math.trunc(index / 4) + 1
-                        readonly property int sixteenthIndex: index % 4 + 1
-
-                        text: `${bar}.${beatIndex}.${sixteenthIndex}`
-                        color: control.palette.text
-                        anchors.left: parent.right
-                        anchors.top: parent.top
-                        anchors.leftMargin: 2
-                        font: Style.xxSmallTextFont
-                        visible: control.pxPerSixteenth > control.detailMeasureLabelPxThreshold
-                    }
-
-                }
-
-            }
-
-        }
-
+        anchors.fill: parent
+        pxPerSixteenth: control.pxPerSixteenth
+        detailMeasurePxThreshold: control.detailMeasurePxThreshold
+        detailMeasureLabelPxThreshold: control.detailMeasureLabelPxThreshold
+        visibleX: control.visibleX
+        visibleWidth: control.visibleWidth
+        color: control.palette.text
+        barFont.family: Style.smallTextFont.family
+        barFont.pixelSize: Style.smallTextFont.pixelSize
+        barFont.weight: Font.Medium
+        beatFont: Style.xSmallTextFont
+        sixteenthFont: Style.xxSmallTextFont
+        barLineOpacity: control.barLineOpacity
+        beatLineOpacity: control.beatLineOpacity
+        sixteenthLineOpacity: control.sixteenthLineOpacity
     }
 
     Item {
@@ -136,65 +136,18 @@ Item {
             height: 600 // TODO: calculate height
 
             // Vertical grid lines
-            Item {
+            ArrangerGridItem {
                 id: timeGrid
 
-                // Bar lines
-                Repeater {
-                    model: Math.ceil(arrangerContent.width / root.ruler.pxPerBar)
-
-                    Rectangle {
-                        width: 1
-                        height: arrangerContent.height
-                        x: index * root.ruler.pxPerBar
-                        color: root.palette.button
-                        opacity: root.ruler.barLineOpacity
-                    }
-
-                }
-
-                // Beat lines
-                Loader {
-                    active: root.ruler.pxPerBeat > root.ruler.detailMeasurePxThreshold
-                    visible: active
-
-                    sourceComponent: Repeater {
-                        model: Math.ceil(arrangerContent.width / root.ruler.pxPerBeat)
-
-                        Rectangle {
-                            width: 1
-                            height: arrangerContent.height
-                            x: index * ruler.pxPerBeat
-                            color: root.palette.button
-                            opacity: ruler.beatLineOpacity
-                            visible: index % 4 !== 0
-                        }
-
-                    }
-
-                }
-
-                // Sixteenth lines
-                Loader {
-                    active: root.ruler.pxPerSixteenth > root.ruler.detailMeasurePxThreshold
-                    visible: active
-
-                    sourceComponent: Repeater {
-                        model: Math.ceil(arrangerContent.width / root.ruler.pxPerSixteenth)
-
-                        Rectangle {
-                            width: 1
-                            height: arrangerContent.height
-                            x: index * ruler.pxPerSixteenth
-                            color: root.palette.button
-                            opacity: ruler.sixteenthLineOpacity
-                            visible: index % 4 !== 0
-                        }
-
-                    }
-
-                }
-
+                anchors.fill: parent
+                pxPerSixteenth: root.ruler.pxPerSixteenth
+                detailMeasurePxThreshold: root.ruler.detailMeasurePxThreshold
+                visibleX: root.scrollX
+                visibleWidth: root.scrollViewWidth
+                color: root.palette.button
+                barLineOpacity: root.ruler.barLineOpacity
+                beatLineOpacity: root.ruler.beatLineOpacity
+                sixteenthLineOpacity: root.ruler.sixteenthLineOpacity
             }
 
             Item {
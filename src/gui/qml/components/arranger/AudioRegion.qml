@@ -11,4 +11,10 @@ RegionBase {
 
     property bool isLanePart: false
     required property var lane
+
+    WaveformItem {
+        anchors.fill: parent
+        region: root.arrangerObject
+        color: root.palette.buttonText
+    }
 }
@@ -10,10 +10,11 @@ Arranger {
     id: root
 
     required property var pianoRoll
+    required property var region
+    readonly property real keyHeight: 16 // Same as PianoRollKeys
 
     function getPitchAtY(y: real): var {
-      // TODO
-      return 0;
+        return 127 - Math.floor(y / root.keyHeight);
     }
 
     function updateCursor() {
@@ -157,32 +158,75 @@ Arranger {
     enableYScroll: true
     scrollView.ScrollBar.horizontal.policy: ScrollBar.AsNeeded
 
-    content: ListView {
-        id: midiNotesListView
-
-        anchors.fill: parent
-        interactive: false
+    // Notes may have been moved, selected or deselected
+    onCurrentActionChanged: {
+        if (root.currentAction === Arranger.None) {
+            midiNotesItem.invalidate();
+            selectedNotesModel.invalidate();
+        }
+    }
 
-        model: region.midiNotes
+    // All the notes are drawn by a single item. Only the selected notes in the
+    // visible part of the arranger and the hovered note get their own items
+    content: [
+        MidiNotesItem {
+            id: midiNotesItem
+
+            x: root.region.position.ticks * root.ruler.pxPerTick
+            width: (root.region.endPosition.ticks - root.region.position.ticks) * root.ruler.pxPerTick
+            height: 128 * root.keyHeight
+            region: root.region
+            drawMode: MidiNotesItem.Notes
+            pxPerTick: root.ruler.pxPerTick
+            keyHeight: root.keyHeight
+            color: root.region.effectiveColor
+
+            HoverHandler {
+                id: notesHoverHandler
+            }
 
-        delegate: Item {
-            id: midiNoteDelegate
+        },
+        Repeater {
+            id: selectedNotesRepeater
 
-            TextMetrics {
-                id: arrangerObjectTextMetrics
+            model: MidiNoteWindowModel {
+                id: selectedNotesModel
 
-                text: "Some text"
-                font: Style.arrangerObjectTextFont
+                region: root.region
+                selectedOnly: true
+                startTicks: (root.scrollX - Style.scrollLoaderBufferPx) / root.ruler.pxPerTick - root.region.position.ticks
+                endTicks: (root.scrollXPlusWidth + Style.scrollLoaderBufferPx) / root.ruler.pxPerTick - root.region.position.ticks
+                lowestPitch: root.getPitchAtY(root.scrollYPlusHeight)
+                highestPitch: root.getPitchAtY(root.scrollY)
             }
 
-            Loader {
-                id: midiNotesLoader
-            }
+            delegate: Rectangle {
+                required property var midiNote
 
-        }
+                x: (root.region.position.ticks + midiNote.position.ticks) * root.ruler.pxPerTick
+                y: (127 - midiNote.pitch) * root.keyHeight
+                width: (midiNote.endPosition.ticks - midiNote.position.ticks) * root.ruler.pxPerTick
+                height: root.keyHeight
+                color: Qt.lighter(root.region.effectiveColor, 1.2)
+                border.color: root.palette.highlight
+                radius: 2
+            }
 
-    }
+        },
+        Rectangle {
+            id: hoveredNoteOverlay
 
-}
+            readonly property var midiNote: notesHoverHandler.hovered ? midiNotesItem.noteAt(notesHoverHandler.point.position.x, notesHoverHandler.point.position.y) : null
 
+            visible: midiNote !== null
+            x: midiNote ? (root.region.position.ticks + midiNote.position.ticks) * root.ruler.pxPerTick : 0
+            y: midiNote ? (127 - midiNote.pitch) * root.keyHeight : 0
+            width: midiNote ? (midiNote.endPosition.ticks - midiNote.position.ticks) * root.ruler.pxPerTick : 0
+            height: root.keyHeight
+            color: "transparent"
+            border.color: root.palette.highlight
+            radius: 2
+        }
+    ]
 
+}
@@ -10,6 +10,7 @@ Arranger {
     id: root
 
     required property var pianoRoll
+    required property var region
 
     function updateCursor() {
         let cursor = "default";
@@ -144,32 +145,22 @@ Arranger {
     enableYScroll: false
     scrollView.ScrollBar.horizontal.policy: ScrollBar.AsNeeded
 
-    content: ListView {
-        id: midiNotesListView
+    onCurrentActionChanged: {
+        if (root.currentAction === Arranger.None)
+            velocitiesItem.invalidate();
 
-        anchors.fill: parent
-        interactive: false
-
-        model: region.midiNotes
-
-        delegate: Item {
-            id: midiNoteDelegate
-
-            TextMetrics {
-                id: arrangerObjectTextMetrics
-
-                text: "Some text"
-                font: Style.arrangerObjectTextFont
-            }
-
-            Loader {
-                id: midiNotesLoader
-            }
+    }
 
-        }
+    content: MidiNotesItem {
+        id: velocitiesItem
 
+        x: root.region.position.ticks * root.ruler.pxPerTick
+        width: (root.region.endPosition.ticks - root.region.position.ticks) * root.ruler.pxPerTick
+        height: parent.height
+        region: root.region
+        drawMode: MidiNotesItem.Velocities
+        pxPerTick: root.ruler.pxPerTick
+        color: root.region.effectiveColor
     }
 
 }
-
-
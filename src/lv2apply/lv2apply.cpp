@@ -17,12 +17,18 @@
  SPDX-License-Identifier: ISC
 */
 
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <cstdarg>
 #include <cstdint>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "lv2/atom/atom.h"
@@ -45,6 +51,9 @@
 #  define ARRAY_SIZE(arr) (sizeof (arr) / sizeof (arr[0]))
 #endif
 
+/** Maximum number of frames processed per plugin run */
+#define BLOCK_LENGTH 4096
+
 /** Control port value set from the command line */
 typedef struct Param
 {
@@ -70,13 +79,11 @@ typedef struct
   bool             optional;  ///< True iff connection optional
 } Port;
 
-/** Features */
+/** Features shared by all plugin instances */
 typedef struct
 {
-  LV2_Feature        map_feature;
-  LV2_Feature        unmap_feature;
-  LV2_Options_Option options[4];
-  LV2_Feature        options_feature;
+  LV2_Feature map_feature;
+  LV2_Feature unmap_feature;
 } LV2ApplyFeatures;
 
 /** URIDs */
@@ -89,106 +96,143 @@ typedef struct
   LV2_URID param_sampleRate;
 } LV2ApplyURIDs;
 
+/** Input file and the file to write the processed audio to */
+typedef struct
+{
+  std::string in_path;
+  std::string out_path;
+} Job;
+
+/**
+   Plugin instance and buffers of a worker thread.
+
+   Each worker runs its own instance, so files are processed concurrently
+   without sharing plugin state. The instance is reused (and re-activated) for
+   each file with the same sample rate.
+*/
+typedef struct
+{
+  LilvInstance *      instance;
+  float               sample_rate;      ///< Sample rate of the instance
+  int32_t             min_block_length; ///< Always 1
+  int32_t             max_block_length; ///< Always BLOCK_LENGTH
+  LV2_Options_Option  options[4];
+  LV2_Feature         options_feature;
+  const LV2_Feature * feature_list[4];
+  std::vector<float>  values;   ///< Control values, per port
+  std::vector<float>  in_bufs;  ///< Input port buffers, one after another
+  std::vector<float>  out_bufs; ///< Output port buffers, one after another
+  std::vector<float>  in_frames;  ///< Interleaved frames read from a file
+  std::vector<float>  out_frames; ///< Interleaved frames to write to a file
+} Worker;
+
 /** Application state */
 typedef struct
 {
-  LilvWorld *          world;
-  const LilvPlugin *   plugin;
-  LilvInstance *       instance;
-  const char *         in_path;
-  const char *         out_path;
-  SNDFILE *            in_file;
-  SNDFILE *            out_file;
-  unsigned             n_params;
-  Param *              params;
-  unsigned             n_ports;
-  unsigned             n_audio_in;
-  unsigned             n_audio_out;
-  Port *               ports;
-  LV2ApplyFeatures     features;
-  const LV2_Feature ** feature_list;
-  Symap *              symap; ///< URI map
-  LV2_URID_Map         map;   ///< URI => Int map
-  LV2_URID_Unmap       unmap; ///< Int => URI map
-  LV2ApplyURIDs        urids; ///< URIDs
-  int                  block_length;
-  float                sample_rate; ///< Sample rate
+  LilvWorld *         world;
+  const LilvPlugin *  plugin;
+  std::vector<Job>    jobs;
+  unsigned            n_params;
+  Param *             params;
+  unsigned            n_ports;
+  unsigned            n_audio_in;
+  unsigned            n_audio_out;
+  Port *              ports;
+  LV2ApplyFeatures    features;
+  Symap *             symap;      ///< URI map
+  std::mutex          symap_lock; ///< Lock for URI map
+  LV2_URID_Map        map;        ///< URI => Int map
+  LV2_URID_Unmap      unmap;      ///< Int => URI map
+  LV2ApplyURIDs       urids;      ///< URIDs
+  std::mutex          instantiate_lock; ///< Serializes (de)instantiation
+  std::vector<Worker> workers;
 } LV2Apply;
 
 static LV2_URID
 map_uri (LV2_URID_Map_Handle handle, const char * uri)
 {
-  LV2Apply *     lv2apply = (LV2Apply *) handle;
-  const LV2_URID id = lv2apply->symap->map (uri);
+  LV2Apply *       lv2apply = (LV2Apply *) handle;
+  std::scoped_lock lock (lv2apply->symap_lock);
+  const LV2_URID   id = lv2apply->symap->map (uri);
   return id;
 }
 
 static const char *
 unmap_uri (LV2_URID_Unmap_Handle handle, LV2_URID urid)
 {
-  LV2Apply *   lv2apply = (LV2Apply *) handle;
-  const char * uri = lv2apply->symap->unmap (urid);
+  LV2Apply *       lv2apply = (LV2Apply *) handle;
+  std::scoped_lock lock (lv2apply->symap_lock);
+  const char *     uri = lv2apply->symap->unmap (urid);
   return uri;
 }
 
 static int
 fatal (LV2Apply * self, int status, const char * fmt, ...);
 
+/** Print a (non-fatal) error. */
+LILV_LOG_FUNC (1, 2)
+static void
+print_error (const char * fmt, ...)
+{
+  va_list args;
+  va_start (args, fmt);
+  fprintf (stderr, "error: ");
+  vfprintf (stderr, fmt, args);
+  va_end (args);
+}
+
 /** Open a sound file with error handling. */
 static SNDFILE *
-sopen (LV2Apply * self, const char * path, int mode, SF_INFO * fmt)
+sopen (const char * path, int mode, SF_INFO * fmt)
 {
   SNDFILE * file = sf_open (path, mode, fmt);
   const int st = sf_error (file);
   if (st)
     {
-      fatal (self, 1, "Failed to open %s (%s)\n", path, sf_error_number (st));
+      print_error ("Failed to open %s (%s)\n", path, sf_error_number (st));
+      sf_close (file);
       return NULL;
     }
   return file;
 }
 
 /** Close a sound file with error handling. */
-static void
+static bool
 sclose (const char * path, SNDFILE * file)
 {
   int st = 0;
   if (file && (st = sf_close (file)))
     {
-      fatal (
-        nullptr, 1, "Failed to close %s (%s)\n", path, sf_error_number (st));
+      print_error ("Failed to close %s (%s)\n", path, sf_error_number (st));
+      return false;
     }
+  return true;
 }
 
-/**
-   Read a single frame from a file into an interleaved buffer.
-
-   If more channels are required than are available in the file, the remaining
-   channels are distributed in a round-robin fashion (LRLRL).
-*/
-static bool
-sread (SNDFILE * file, unsigned file_chans, float * buf, unsigned buf_chans)
+/** Free the plugin instance of a worker, if any. */
+static void
+free_instance (LV2Apply * self, Worker * worker)
 {
-  const sf_count_t n_read = sf_readf_float (file, buf, 1);
-  for (unsigned i = file_chans - 1; i < buf_chans; ++i)
+  if (worker->instance)
     {
-      buf[i] = buf[i % file_chans];
+      std::scoped_lock lock (self->instantiate_lock);
+      lilv_instance_free (worker->instance);
+      worker->instance = nullptr;
     }
-  return n_read == 1;
 }
 
 /** Clean up all resources. */
 static int
 cleanup (int status, LV2Apply * self)
 {
-  sclose (self->in_path, self->in_file);
-  sclose (self->out_path, self->out_file);
-  lilv_instance_free (self->instance);
+  for (auto &worker : self->workers)
+    {
+      free_instance (self, &worker);
+    }
   lilv_world_free (self->world);
   free (self->ports);
   free (self->params);
   delete (self->symap);
-  free (self->feature_list);
   return status;
 }
 
@@ -300,9 +344,12 @@ print_usage (int status)
   fprintf (
     status ? stderr : stdout,
     "Usage: lv2apply [OPTION]... PLUGIN_URI\n"
-    "Apply an LV2 plugin to an audio file.\n\n"
-    "  -i IN_FILE   Input file\n"
-    "  -o OUT_FILE  Output file\n"
+    "Apply an LV2 plugin to audio files.\n\n"
+    "  -i IN_FILE   Input file (can be given multiple times)\n"
+    "  -l LIST      File with input files, one per line\n"
+    "  -o OUT_FILE  Output file (single input file only)\n"
+    "  -d OUT_DIR   Output directory, for multiple input files\n"
+    "  -j JOBS      Number of files to process in parallel\n"
     "  -c SYM VAL   Control value\n"
     "  --help       Display this help and exit\n"
     "  --version    Display version information and exit\n");
@@ -332,22 +379,6 @@ init_feature (LV2_Feature * const dest, const char * const URI, void * data)
 static void
 init_features (LV2Apply * self)
 {
-  /* Build options array to pass to plugin */
-  const LV2_Options_Option options[ARRAY_SIZE (self->features.options)] = {
-    { LV2_OPTIONS_INSTANCE, 0, self->urids.param_sampleRate,     sizeof (float),
-     self->urids.atom_Float,                                                                           &self->sample_rate  },
-    { LV2_OPTIONS_INSTANCE, 0, self->urids.bufsz_minBlockLength,
-     sizeof (int32_t),                                                           self->urids.atom_Int, &self->block_length },
-    { LV2_OPTIONS_INSTANCE, 0, self->urids.bufsz_maxBlockLength,
-     sizeof (int32_t),                                                           self->urids.atom_Int, &self->block_length },
-    { LV2_OPTIONS_INSTANCE, 0, 0,                                0,              0,                    NULL                }
-  };
-  memcpy (self->features.options, options, sizeof (self->features.options));
-
-  init_feature (
-    &self->features.options_feature, LV2_OPTIONS__options,
-    self->features.options);
-
   self->map.handle = self;
   self->map.map = map_uri;
   init_feature (&self->features.map_feature, LV2_URID__map, &self->map);
@@ -355,31 +386,259 @@ init_features (LV2Apply * self)
   self->unmap.handle = self;
   self->unmap.unmap = unmap_uri;
   init_feature (&self->features.unmap_feature, LV2_URID__unmap, &self->unmap);
+}
 
-  /* Build feature list for passing to plugins */
-  const LV2_Feature * const features[] = {
-    &self->features.map_feature, &self->features.unmap_feature,
-    &self->features.options_feature, NULL
+/** Set up the options, features and buffers of a worker. */
+static void
+init_worker (LV2Apply * self, Worker * worker)
+{
+  worker->instance = nullptr;
+  worker->sample_rate = 0.f;
+  worker->min_block_length = 1;
+  worker->max_block_length = BLOCK_LENGTH;
+
+  /* Build options array to pass to plugin */
+  const LV2_Options_Option options[ARRAY_SIZE (worker->options)] = {
+    { LV2_OPTIONS_INSTANCE, 0, self->urids.param_sampleRate, sizeof (float),
+     self->urids.atom_Float, &worker->sample_rate },
+    { LV2_OPTIONS_INSTANCE, 0, self->urids.bufsz_minBlockLength,
+     sizeof (int32_t), self->urids.atom_Int, &worker->min_block_length },
+    { LV2_OPTIONS_INSTANCE, 0, self->urids.bufsz_maxBlockLength,
+     sizeof (int32_t), self->urids.atom_Int, &worker->max_block_length },
+    { LV2_OPTIONS_INSTANCE, 0, 0, 0, 0, NULL }
   };
-  self->feature_list =
-    static_cast<const LV2_Feature **> (calloc (1, sizeof (features)));
-  if (!self->feature_list)
+  memcpy (worker->options, options, sizeof (worker->options));
+
+  init_feature (
+    &worker->options_feature, LV2_OPTIONS__options, worker->options);
+
+  /* Build feature list for passing to plugins */
+  worker->feature_list[0] = &self->features.map_feature;
+  worker->feature_list[1] = &self->features.unmap_feature;
+  worker->feature_list[2] = &worker->options_feature;
+  worker->feature_list[3] = NULL;
+
+  worker->values.resize (self->n_ports);
+  for (unsigned p = 0; p < self->n_ports; ++p)
+    {
+      worker->values[p] = self->ports[p].value;
+    }
+  worker->in_bufs.resize (std::max (self->n_audio_in, 1u) * BLOCK_LENGTH);
+  worker->out_bufs.resize (std::max (self->n_audio_out, 1u) * BLOCK_LENGTH);
+  worker->out_frames.resize (worker->out_bufs.size ());
+}
+
+/**
+   Make sure the worker has a plugin instance running at the given sample
+   rate, with its ports connected to the worker's buffers.
+*/
+static bool
+ensure_instance (LV2Apply * self, Worker * worker, float sample_rate)
+{
+  if (worker->instance && worker->sample_rate == sample_rate)
+    {
+      return true;
+    }
+
+  free_instance (self, worker);
+  worker->sample_rate = sample_rate;
+
+  {
+    /* instantiation functions may not be called concurrently */
+    std::scoped_lock lock (self->instantiate_lock);
+    worker->instance = lilv_plugin_instantiate (
+      self->plugin, sample_rate, worker->feature_list);
+  }
+  if (!worker->instance)
+    {
+      print_error ("Failed to instantiate plugin\n");
+      return false;
+    }
+
+  for (uint32_t p = 0, i = 0, o = 0; p < self->n_ports; ++p)
+    {
+      if (self->ports[p].type == TYPE_CONTROL)
+        {
+          lilv_instance_connect_port (
+            worker->instance, p, &worker->values[p]);
+        }
+      else if (self->ports[p].type == TYPE_AUDIO)
+        {
+          if (self->ports[p].is_input)
+            {
+              lilv_instance_connect_port (
+                worker->instance, p,
+                worker->in_bufs.data () + (size_t) (i++) * BLOCK_LENGTH);
+            }
+          else
+            {
+              lilv_instance_connect_port (
+                worker->instance, p,
+                worker->out_bufs.data () + (size_t) (o++) * BLOCK_LENGTH);
+            }
+        }
+      else
+        {
+          lilv_instance_connect_port (worker->instance, p, nullptr);
+        }
+    }
+
+  return true;
+}
+
+/**
+   Apply the plugin to a file, using the worker's plugin instance.
+
+   The file is processed in blocks of up to BLOCK_LENGTH frames. If more
+   input ports than file channels are available, the remaining ports are fed
+   in a round-robin fashion (LRLRL).
+*/
+static bool
+process_file (LV2Apply * self, Worker * worker, const Job * job)
+{
+  const char * in_path = job->in_path.c_str ();
+  const char * out_path = job->out_path.c_str ();
+
+  /* Open input file */
+  SF_INFO   in_fmt = { 0, 0, 0, 0, 0, 0 };
+  SNDFILE * in_file = sopen (in_path, SFM_READ, &in_fmt);
+  if (!in_file)
+    {
+      return false;
+    }
+
+  if (
+    self->n_audio_in == 0
+    || (in_fmt.channels != (int) self->n_audio_in && in_fmt.channels != 1))
+    {
+      print_error (
+        "Unable to map %d inputs of %s to %u ports\n", in_fmt.channels,
+        in_path, self->n_audio_in);
+      sclose (in_path, in_file);
+      return false;
+    }
+
+  if (!ensure_instance (self, worker, (float) in_fmt.samplerate))
+    {
+      sclose (in_path, in_file);
+      return false;
+    }
+
+  /* Open output file */
+  SF_INFO out_fmt = in_fmt;
+  out_fmt.channels = (int) self->n_audio_out;
+  SNDFILE * out_file = sopen (out_path, SFM_WRITE, &out_fmt);
+  if (!out_file)
     {
-      fatal (self, 10, "Failed to allocate feature list\n");
+      sclose (in_path, in_file);
+      return false;
     }
-  memcpy (self->feature_list, features, sizeof (features));
+
+  const auto in_chans = (unsigned) in_fmt.channels;
+  const auto out_chans = self->n_audio_out;
+  worker->in_frames.resize ((size_t) in_chans * BLOCK_LENGTH);
+
+  /* re-activating resets the state left by the previous file */
+  lilv_instance_activate (worker->instance);
+  bool ok = true;
+  for (;;)
+    {
+      const sf_count_t n_read =
+        sf_readf_float (in_file, worker->in_frames.data (), BLOCK_LENGTH);
+      if (n_read <= 0)
+        {
+          break;
+        }
+
+      const auto n_frames = (size_t) n_read;
+      for (unsigned c = 0; c < self->n_audio_in; ++c)
+        {
+          float *       dest = worker->in_bufs.data () + c * BLOCK_LENGTH;
+          const float * src = worker->in_frames.data () + c % in_chans;
+          for (size_t f = 0; f < n_frames; ++f)
+            {
+              dest[f] = src[f * in_chans];
+            }
+        }
+
+      lilv_instance_run (worker->instance, (uint32_t) n_frames);
+
+      for (unsigned c = 0; c < out_chans; ++c)
+        {
+          const float * src = worker->out_bufs.data () + c * BLOCK_LENGTH;
+          float *       dest = worker->out_frames.data () + c;
+          for (size_t f = 0; f < n_frames; ++f)
+            {
+              dest[f * out_chans] = src[f];
+            }
+        }
+      if (
+        sf_writef_float (out_file, worker->out_frames.data (), n_read)
+        != n_read)
+        {
+          print_error ("Failed to write to %s\n", out_path);
+          ok = false;
+          break;
+        }
+    }
+  lilv_instance_deactivate (worker->instance);
+
+  ok = sclose (in_path, in_file) && ok;
+  ok = sclose (out_path, out_file) && ok;
+  return ok;
+}
+
+/** Add the input files listed (one per line) in a file. */
+static bool
+read_list (std::vector<std::string> &in_paths, const char * list_path)
+{
+  std::ifstream list (list_path);
+  if (!list)
+    {
+      return false;
+    }
+
+  std::string line;
+  while (std::getline (list, line))
+    {
+      if (!line.empty () && line.back () == '\r')
+        {
+          line.pop_back ();
+        }
+      if (!line.empty ())
+        {
+          in_paths.push_back (line);
+        }
+    }
+  return true;
+}
+
+/** Return the path of the file named like @p in_path in @p out_dir. */
+static std::string
+get_out_path (const char * out_dir, const std::string &in_path)
+{
+  const auto  sep = in_path.find_last_of ("/\\");
+  std::string name =
+    sep == std::string::npos ? in_path : in_path.substr (sep + 1);
+  std::string dir = out_dir;
+  if (!dir.empty () && dir.back () != '/' && dir.back () != '\\')
+    {
+      dir += '/';
+    }
+  return dir + name;
 }
 
 int
 main (int argc, char ** argv)
 {
-  LV2Apply self = {
-    nullptr, nullptr, nullptr, nullptr, nullptr, nullptr, nullptr,
-    0,       nullptr, 0,       0,       0,       NULL
-  };
+  LV2Apply self{};
 
   /* Parse command line arguments */
-  const char * plugin_uri = NULL;
+  const char *             plugin_uri = NULL;
+  const char *             out_path = NULL;
+  const char *             out_dir = NULL;
+  std::vector<std::string> in_paths;
+  unsigned                 n_jobs = std::thread::hardware_concurrency ();
   for (int i = 1; i < argc; ++i)
     {
       if (!strcmp (argv[i], "--version"))
@@ -395,13 +654,37 @@ main (int argc, char ** argv)
           return print_usage (0);
         }
 
+      if (
+        (!strcmp (argv[i], "-i") || !strcmp (argv[i], "-l")
+         || !strcmp (argv[i], "-o") || !strcmp (argv[i], "-d")
+         || !strcmp (argv[i], "-j"))
+        && argc < i + 2)
+        {
+          return fatal (&self, 1, "Missing argument for %s\n", argv[i]);
+        }
+
       if (!strcmp (argv[i], "-i"))
         {
-          self.in_path = argv[++i];
+          in_paths.emplace_back (argv[++i]);
+        }
+      else if (!strcmp (argv[i], "-l"))
+        {
+          if (!read_list (in_paths, argv[++i]))
+            {
+              return fatal (&self, 1, "Failed to read %s\n", argv[i]);
+            }
         }
       else if (!strcmp (argv[i], "-o"))
         {
-          self.out_path = argv[++i];
+          out_path = argv[++i];
+        }
+      else if (!strcmp (argv[i], "-d"))
+        {
+          out_dir = argv[++i];
+        }
+      else if (!strcmp (argv[i], "-j"))
+        {
+          n_jobs = (unsigned) std::max (atoi (argv[++i]), 0);
         }
       else if (!strcmp (argv[i], "-c"))
         {
@@ -426,12 +709,21 @@ main (int argc, char ** argv)
         }
     }
 
-  /* Check that required arguments are given */
-  if (!self.in_path || !self.out_path || !plugin_uri)
+  /* Check that required arguments are given: either a single input file
+     and an output file, or input files and an output directory */
+  if (
+    in_paths.empty () || !plugin_uri || (out_path && out_dir)
+    || (!out_path && !out_dir) || (out_path && in_paths.size () > 1))
     {
       free (self.params);
       return print_usage (1);
     }
+  for (const auto &in_path : in_paths)
+    {
+      self.jobs.push_back (
+        Job{ in_path, out_path ? out_path : get_out_path (out_dir, in_path) });
+    }
+  n_jobs = std::clamp (n_jobs, 1u, (unsigned) self.jobs.size ());
 
   /* Create world and plugin URI */
   self.world = lilv_world_new ();
@@ -453,30 +745,12 @@ main (int argc, char ** argv)
       return fatal (&self, 3, "Plugin <%s> not found\n", plugin_uri);
     }
 
-  /* Open input file */
-  SF_INFO in_fmt = { 0, 0, 0, 0, 0, 0 };
-  if (!(self.in_file = sopen (&self, self.in_path, SFM_READ, &in_fmt)))
-    {
-      return 4;
-    }
-
   /* Create port structures */
   if (create_ports (&self))
     {
       return 5;
     }
 
-  if (
-    self.n_audio_in == 0
-    || (in_fmt.channels != (int) self.n_audio_in && in_fmt.channels != 1))
-    {
-      return fatal (
-        &self, 6, "Unable to map %d inputs to %u ports\n", in_fmt.channels,
-        self.n_audio_in);
-    }
-  self.block_length = 1;
-  self.sample_rate = in_fmt.samplerate;
-
   /* Init URIDs */
   init_urids (&self);
 
@@ -498,72 +772,37 @@ main (int argc, char ** argv)
       self.ports[lilv_port_get_index (plugin, port)].value = param->value;
     }
 
-  /* Open output file */
-  SF_INFO out_fmt = in_fmt;
-  out_fmt.channels = self.n_audio_out;
-  if (!(self.out_file = sopen (&self, self.out_path, SFM_WRITE, &out_fmt)))
+  /* Create the workers (their options point into them, so the vector must
+     not be resized afterwards) */
+  self.workers = std::vector<Worker> (n_jobs);
+  for (auto &worker : self.workers)
     {
-      free (self.ports);
-      return 8;
+      init_worker (&self, &worker);
     }
 
-  /* Instantiate plugin and connect ports */
-  const uint32_t     n_ports = lilv_plugin_get_num_ports (plugin);
-  std::vector<float> in_buf (1);
-  if (self.n_audio_in > 0)
+  /* Process the files, each worker taking the next one until done */
+  std::atomic<size_t>      next_job = 0;
+  std::atomic<bool>        failed = false;
+  std::vector<std::thread> threads;
+  for (auto &worker : self.workers)
     {
-      in_buf.resize (self.n_audio_in);
+      threads.emplace_back ([&self, &worker, &next_job, &failed] () {
+        size_t j = 0;
+        while ((j = next_job++) < self.jobs.size ())
+          {
+            const Job * job = &self.jobs[j];
+            if (!process_file (&self, &worker, job))
+              {
+                print_error ("Failed to process %s\n", job->in_path.c_str ());
+                failed = true;
+              }
+          }
+      });
     }
-  std::vector<float> out_buf (1);
-  if (self.n_audio_out > 0)
+  for (auto &thread : threads)
     {
-      out_buf.resize (self.n_audio_out);
-    }
-  self.instance =
-    lilv_plugin_instantiate (self.plugin, in_fmt.samplerate, self.feature_list);
-  if (!self.instance)
-    {
-      return fatal (&self, 11, "Failed to instantiate plugin\n");
-    }
-  for (uint32_t p = 0, i = 0, o = 0; p < n_ports; ++p)
-    {
-      if (self.ports[p].type == TYPE_CONTROL)
-        {
-          lilv_instance_connect_port (self.instance, p, &self.ports[p].value);
-        }
-      else if (self.ports[p].type == TYPE_AUDIO)
-        {
-          if (self.ports[p].is_input)
-            {
-              lilv_instance_connect_port (
-                self.instance, p, in_buf.data () + i++);
-            }
-          else
-            {
-              lilv_instance_connect_port (
-                self.instance, p, out_buf.data () + o++);
-            }
-        }
-      else
-        {
-          lilv_instance_connect_port (self.instance, p, nullptr);
-        }
-    }
-
-  /* Ports are now connected to buffers in interleaved format, so we can run
-     a single frame at a time and avoid having to interleave buffers to
-     read/write from/to sndfile. */
-
-  lilv_instance_activate (self.instance);
-  while (sread (self.in_file, in_fmt.channels, in_buf.data (), self.n_audio_in))
-    {
-      lilv_instance_run (self.instance, 1);
-      if (sf_writef_float (self.out_file, out_buf.data (), 1) != 1)
-        {
-          return fatal (&self, 9, "Failed to write to output file\n");
-        }
+      thread.join ();
     }
-  lilv_instance_deactivate (self.instance);
 
-  return cleanup (0, &self);
+  return cleanup (failed ? 9 : 0, &self);
 }
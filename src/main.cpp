@@ -3,6 +3,8 @@
 
 #include "zrythm-config.h"
 
+#include <cstring>
+
 #include "gui/backend/zrythm_application.h"
 
 /**
@@ -11,6 +13,17 @@
 int
 main (int argc, char ** argv)
 {
+  /* rendering from the command line doesn't need a display */
+  for (int i = 1; i < argc; ++i)
+    {
+      if (
+        std::strcmp (argv[i], "--render") == 0
+        && !qEnvironmentVariableIsSet ("QT_QPA_PLATFORM"))
+        {
+          qputenv ("QT_QPA_PLATFORM", "offscreen");
+        }
+    }
+
   zrythm::gui::ZrythmApplication app (argc, argv);
   return app.exec ();
 }
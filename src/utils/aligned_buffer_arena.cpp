@@ -0,0 +1,41 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "utils/aligned_buffer_arena.h"
+#include "utils/cpu_affinity.h"
+#include "utils/large_buffer_allocator.h"
+
+namespace zrythm::utils
+{
+
+void
+AlignedBufferArena::allocate (size_t num_slices, size_t slice_size)
+{
+  constexpr size_t floats_per_line = ALIGNMENT / sizeof (float);
+  const size_t     stride =
+    (slice_size + floats_per_line - 1) / floats_per_line * floats_per_line;
+  const size_t num_floats = std::max (num_slices * stride, floats_per_line);
+
+  storage_ = LargeBufferAllocator::allocate_floats (num_floats, ALIGNMENT);
+  num_slices_ = num_slices;
+  slice_size_ = slice_size;
+  stride_ = stride;
+}
+
+bool
+AlignedBufferArena::bind_slices_to_numa_node (
+  size_t first_slice,
+  size_t num_slices,
+  int    numa_node) const
+{
+  if (num_slices == 0 || first_slice + num_slices > num_slices_)
+    return false;
+
+  return cpu::bind_memory_to_numa_node (
+    storage_.get () + first_slice * stride_,
+    num_slices * stride_ * sizeof (float), numa_node);
+}
+
+} // namespace zrythm::utils
@@ -0,0 +1,75 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <memory>
+#include <span>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief A single allocation split into equally sized float slices that each
+ * start on a cache line boundary.
+ *
+ * Handing the slices out in the order they are used (e.g., in graph processing
+ * order) keeps the memory touched by consecutive operations close together.
+ */
+class AlignedBufferArena
+{
+public:
+  static constexpr size_t ALIGNMENT = 64;
+
+  /**
+   * @brief Replaces the allocation with @p num_slices zeroed slices of
+   * @p slice_size floats.
+   *
+   * The storage is allocated with LargeBufferAllocator (so it may be backed
+   * by huge pages and locked in memory).
+   *
+   * Slices of the previous allocation stay valid for as long as its storage
+   * (see get_storage()) is referenced elsewhere.
+   */
+  void allocate (size_t num_slices, size_t slice_size);
+
+  std::span<float> get_slice (size_t index) const
+  {
+    return { storage_.get () + index * stride_, slice_size_ };
+  }
+
+  /**
+   * @brief Returns the storage the slices point into.
+   *
+   * Holders of slices may keep a reference to it so that the slices outlive
+   * the next allocate().
+   */
+  const std::shared_ptr<float[]> &get_storage () const { return storage_; }
+
+  size_t get_num_slices () const { return num_slices_; }
+  size_t get_slice_size () const { return slice_size_; }
+
+  /**
+   * @brief Distance in floats between the starts of consecutive slices.
+   */
+  size_t get_stride () const { return stride_; }
+
+  /**
+   * @brief Moves the memory of @p num_slices slices starting at
+   * @p first_slice to @p numa_node.
+   *
+   * @see cpu::bind_memory_to_numa_node().
+   */
+  bool bind_slices_to_numa_node (
+    size_t first_slice,
+    size_t num_slices,
+    int    numa_node) const;
+
+private:
+  std::shared_ptr<float[]> storage_;
+  size_t                   num_slices_ = 0;
+  size_t                   slice_size_ = 0;
+  size_t                   stride_ = 0;
+};
+
+} // namespace zrythm::utils
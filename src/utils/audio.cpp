@@ -1,6 +1,10 @@
 // SPDX-FileCopyrightText: © 2019-2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+
 #include "utils/audio.h"
 #include "utils/audio_file.h"
 #include "utils/dsp.h"
@@ -172,69 +176,169 @@ detect_bpm (
   unsigned int        samplerate,
   std::vector<float> &candidates)
 {
-  // unimplemented
-  z_return_val_if_reached (140.f);
-#if 0
-  ZVampPlugin * plugin =
-    vamp_get_plugin (Z_VAMP_PLUGIN_FIXED_TEMPO_ESTIMATOR, static_cast<float>(samplerate));
-  size_t step_sz = vamp_plugin_get_preferred_step_size (plugin);
-  size_t block_sz = vamp_plugin_get_preferred_block_size (plugin);
-
-  /* only works with 1 channel */
-  vamp_plugin_initialize (plugin, 1, step_sz, block_sz);
-
-  ZVampOutputList * outputs = vamp_plugin_get_output_descriptors (plugin);
-  vamp_plugin_output_list_print (outputs);
-  vamp_plugin_output_list_free (outputs);
-
-  long  cur_timestamp = 0;
-  float bpm = 0.f;
-  while ((cur_timestamp + static_cast<long>(block_sz)) < static_cast<long>(num_frames))
+  BpmDetector detector (samplerate);
+  detector.process (&src, 1, num_frames);
+  return detector.detect (candidates);
+}
+
+BpmDetector::BpmDetector (unsigned int samplerate)
+    : hop_size_ (std::max<size_t> (
+        1, (samplerate + ENVELOPE_RATE / 2) / ENVELOPE_RATE)),
+      envelope_rate_ (
+        static_cast<double> (samplerate) / static_cast<double> (hop_size_))
+{
+}
+
+void
+BpmDetector::process (
+  const float * const * channels,
+  size_t                num_channels,
+  size_t                num_frames)
+{
+  z_return_if_fail (num_channels > 0);
+  const float gain = 1.f / static_cast<float> (num_channels);
+  for (size_t i = 0; i < num_frames; ++i)
     {
-      const float * frames[] = {
-        &src[cur_timestamp],
-      };
-      ZVampFeatureSet * feature_set = vamp_plugin_process (
-        plugin, (const float * const *) frames, cur_timestamp, samplerate);
-      const ZVampFeatureList * fl =
-        vamp_feature_set_get_list_for_output (feature_set, 0);
-      if (fl)
+      float sum = 0.f;
+      for (size_t ch = 0; ch < num_channels; ++ch)
         {
-          vamp_feature_list_print (fl);
-          const ZVampFeature * feature =
-            (ZVampFeature *) g_ptr_array_index (fl->list, 0);
-          bpm = feature->values[0];
-
-          for (size_t i = 0; i < feature->num_values; i++)
-            {
-              candidates.push_back (feature->values[i]);
-            }
+          sum += channels[ch][i];
         }
-      cur_timestamp += static_cast<long>(step_sz);
-      vamp_feature_set_free (feature_set);
+      add_mono_sample (sum * gain);
     }
+}
 
-  z_info ("getting remaining features");
-  ZVampFeatureSet * feature_set =
-    vamp_plugin_get_remaining_features (plugin, samplerate);
-  const ZVampFeatureList * fl =
-    vamp_feature_set_get_list_for_output (feature_set, 0);
-  if (fl)
+void
+BpmDetector::process_interleaved (
+  const float * frames,
+  size_t        num_channels,
+  size_t        num_frames)
+{
+  z_return_if_fail (num_channels > 0);
+  const float gain = 1.f / static_cast<float> (num_channels);
+  for (size_t i = 0; i < num_frames; ++i)
     {
-      vamp_feature_list_print (fl);
-      const ZVampFeature * feature =
-        (ZVampFeature *) g_ptr_array_index (fl->list, 0);
-      bpm = feature->values[0];
+      float sum = 0.f;
+      for (size_t ch = 0; ch < num_channels; ++ch)
+        {
+          sum += frames[i * num_channels + ch];
+        }
+      add_mono_sample (sum * gain);
+    }
+}
 
-      for (size_t i = 0; i < feature->num_values; i++)
+float
+BpmDetector::detect (std::vector<float> &candidates) const
+{
+  candidates.clear ();
+  const auto num_env_frames = envelope_.size ();
+  if (
+    static_cast<double> (num_env_frames)
+    < static_cast<double> (MIN_DURATION) * envelope_rate_)
+    return 0.f;
+
+  /* onset strength: rising edges of the log-compressed energy */
+  std::vector<float> onsets (num_env_frames - 1);
+  const auto compress = [] (float energy) {
+    return std::log1p (1000.f * energy);
+  };
+  float  prev = compress (envelope_[0]);
+  double sum = 0.0;
+  for (size_t i = 1; i < num_env_frames; ++i)
+    {
+      const float cur = compress (envelope_[i]);
+      onsets[i - 1] = std::max (cur - prev, 0.f);
+      sum += onsets[i - 1];
+      prev = cur;
+    }
+  const auto mean =
+    static_cast<float> (sum / static_cast<double> (onsets.size ()));
+
+  /* smooth the onsets (triangular window of about 25 ms) so that beat
+   * periods that fall between two envelope frames still correlate */
+  std::vector<float> smoothed (onsets.size (), 0.f);
+  constexpr std::array<float, 5> kernel = {
+    1.f / 9, 2.f / 9, 3.f / 9, 2.f / 9, 1.f / 9
+  };
+  constexpr size_t half_kernel = kernel.size () / 2;
+  for (size_t i = 0; i < onsets.size (); ++i)
+    {
+      for (size_t k = 0; k < kernel.size (); ++k)
         {
-          candidates.push_back (feature->values[i]);
+          const auto j = i + k;
+          if (j >= half_kernel && j - half_kernel < onsets.size ())
+            smoothed[i] += kernel[k] * onsets[j - half_kernel];
         }
+      smoothed[i] -= mean;
+    }
+  onsets = std::move (smoothed);
+
+  const auto lag_to_bpm = [this] (double lag) {
+    return static_cast<float> (60.0 * envelope_rate_ / lag);
+  };
+  const auto min_lag = std::max<size_t> (
+    2, static_cast<size_t> (
+         std::floor (60.0 * envelope_rate_ / static_cast<double> (MAX_BPM))));
+  const auto max_lag = static_cast<size_t> (
+    std::ceil (60.0 * envelope_rate_ / static_cast<double> (MIN_BPM)));
+
+  /* unbiased autocorrelation, up to twice the longest beat period so that
+   * each period can be reinforced by the one of its half tempo */
+  const auto         num_lags = std::min (2 * max_lag + 3, onsets.size ());
+  std::vector<float> autocorr (num_lags, 0.f);
+  for (size_t lag = 1; lag < num_lags; ++lag)
+    {
+      double acc = 0.0;
+      for (size_t i = 0; i + lag < onsets.size (); ++i)
+        {
+          acc += static_cast<double> (onsets[i]) * onsets[i + lag];
+        }
+      autocorr[lag] =
+        static_cast<float> (acc / static_cast<double> (onsets.size () - lag));
     }
-  vamp_feature_set_free (feature_set);
 
-  return bpm;
-#endif
+  /* score each period, preferring tempos around 120 BPM (log-normal weight
+   * with a standard deviation of one octave) */
+  std::vector<float> scores (std::min (max_lag + 2, num_lags), 0.f);
+  for (size_t lag = min_lag - 1; lag < scores.size (); ++lag)
+    {
+      float score = autocorr[lag];
+      if (2 * lag < num_lags)
+        score += 0.5f * autocorr[2 * lag];
+      const auto octaves =
+        std::log2 (lag_to_bpm (static_cast<double> (lag)) / 120.f);
+      scores[lag] = score * std::exp (-0.5f * octaves * octaves);
+    }
+
+  /* local maxima, best first */
+  std::vector<size_t> peaks;
+  for (size_t lag = min_lag; lag + 1 < scores.size () && lag <= max_lag; ++lag)
+    {
+      if (
+        scores[lag] > 0.f && scores[lag] > scores[lag - 1]
+        && scores[lag] >= scores[lag + 1])
+        peaks.push_back (lag);
+    }
+  std::ranges::sort (peaks, [&scores] (size_t a, size_t b) {
+    return scores[a] > scores[b];
+  });
+
+  for (const auto lag : peaks)
+    {
+      if (candidates.size () >= MAX_CANDIDATES)
+        break;
+
+      /* refine the period with a parabola through the neighbouring scores */
+      const float before = scores[lag - 1];
+      const float at = scores[lag];
+      const float after = scores[lag + 1];
+      const float denom = before - 2.f * at + after;
+      const float offset = denom < 0.f ? 0.5f * (before - after) / denom : 0.f;
+      candidates.push_back (
+        lag_to_bpm (static_cast<double> (lag) + static_cast<double> (offset)));
+    }
+
+  return candidates.empty () ? 0.f : candidates.front ();
 }
 
 /**
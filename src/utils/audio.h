@@ -99,7 +99,10 @@ frames_empty (const float * src, size_t num_frames);
 /**
  * Detect BPM.
  *
+ * @param src Mono frames.
+ * @param[out] candidates The most likely BPMs, most likely first.
  * @return The BPM, or 0 if not found.
+ * @see BpmDetector.
  */
 float
 detect_bpm (
@@ -108,6 +111,85 @@ detect_bpm (
   unsigned int        samplerate,
   std::vector<float> &candidates);
 
+/**
+ * @brief Estimates the tempo of audio added to it in blocks.
+ *
+ * The channels are mixed down to mono and decimated to an energy envelope of
+ * about @ref ENVELOPE_RATE frames per second while they are added, so long
+ * audio is analysed in a single pass without keeping it in memory.
+ *
+ * The tempo is the beat period (within [MIN_BPM, MAX_BPM]) at which the
+ * onsets of the envelope correlate best, with a mild preference for tempos
+ * around 120 BPM to resolve half/double tempo ambiguities.
+ */
+class BpmDetector
+{
+public:
+  static constexpr float MIN_BPM = 60.f;
+  static constexpr float MAX_BPM = 200.f;
+
+  /** Approximate number of envelope frames per second. */
+  static constexpr unsigned int ENVELOPE_RATE = 200;
+
+  /** Audio shorter than this (in seconds) is not analysed. */
+  static constexpr float MIN_DURATION = 2.f;
+
+  /** Maximum number of candidates returned by detect(). */
+  static constexpr size_t MAX_CANDIDATES = 5;
+
+  explicit BpmDetector (unsigned int samplerate);
+
+  /**
+   * @brief Adds non-interleaved (planar) frames.
+   */
+  void process (
+    const float * const * channels,
+    size_t                num_channels,
+    size_t                num_frames);
+
+  /**
+   * @brief Adds interleaved frames.
+   */
+  void process_interleaved (
+    const float * frames,
+    size_t        num_channels,
+    size_t        num_frames);
+
+  /**
+   * @brief Estimates the tempo of the frames added so far.
+   *
+   * @param[out] candidates The most likely BPMs, most likely first.
+   * @return The BPM, or 0 if not found.
+   */
+  float detect (std::vector<float> &candidates) const;
+
+private:
+  void add_mono_sample (float sample)
+  {
+    hop_energy_ += static_cast<double> (sample) * sample;
+    if (++hop_pos_ == hop_size_)
+      {
+        envelope_.push_back (
+          static_cast<float> (hop_energy_ / static_cast<double> (hop_size_)));
+        hop_energy_ = 0.0;
+        hop_pos_ = 0;
+      }
+  }
+
+private:
+  /** Input frames per envelope frame. */
+  size_t hop_size_;
+
+  /** Exact envelope frames per second. */
+  double envelope_rate_;
+
+  size_t hop_pos_ = 0;
+  double hop_energy_ = 0.0;
+
+  /** Mean energy of each hop. */
+  std::vector<float> envelope_;
+};
+
 bool
 audio_file_is_silent (const fs::path &filepath);
 
@@ -126,6 +208,23 @@ public:
   {
   }
 
+  /**
+   * Creates an AudioBuffer that refers to existing (planar) data instead of
+   * allocating its own.
+   *
+   * The data must outlive the buffer (or until it gets resized).
+   */
+  AudioBuffer (
+    sample_t * const * data_to_refer_to,
+    int                num_channels,
+    int                num_frames_per_channel)
+      : juce::AudioBuffer<sample_t> (
+          data_to_refer_to,
+          num_channels,
+          num_frames_per_channel)
+  {
+  }
+
   /**
    * Creates an AudioBuffer from interleaved audio data.
    *
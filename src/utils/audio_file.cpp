@@ -1,6 +1,12 @@
 // SPDX-FileCopyrightText: © 2023-2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
 #include "utils/audio_file.h"
 #include "utils/dsp.h"
 #include "utils/exceptions.h"
@@ -10,6 +16,38 @@
 namespace zrythm::utils::audio
 {
 
+namespace
+{
+uint32_t
+read_le (const char * data, int num_bytes)
+{
+  uint32_t val = 0;
+  for (int i = 0; i < num_bytes; ++i)
+    {
+      val |= static_cast<uint32_t> (static_cast<uint8_t> (data[i])) << (i * 8);
+    }
+  return val;
+}
+
+std::array<char, 4>
+to_le32 (uint32_t val)
+{
+  return {
+    static_cast<char> (val & 0xFF), static_cast<char> ((val >> 8) & 0xFF),
+    static_cast<char> ((val >> 16) & 0xFF),
+    static_cast<char> ((val >> 24) & 0xFF)
+  };
+}
+
+bool
+is_chunk_id (const char * id)
+{
+  return std::all_of (id, id + 4, [] (char c) {
+    return c >= 0x20 && c < 0x7F;
+  });
+}
+} // namespace
+
 void
 AudioFile::ensure_file_is_open ()
 {
@@ -123,6 +161,36 @@ AudioFile::read_samples_interleaved (
     samples, buffer.getReadPointer (0), num_frames_to_read * metadata_.channels);
 }
 
+void
+AudioFile::read_resampled (
+  size_t                          samplerate,
+  const StreamingResampler::Sink &sink,
+  Resampler::Quality              quality,
+  size_t                          chunk_frames)
+{
+  read_metadata ();
+
+  StreamingResampler resampler (
+    static_cast<size_t> (metadata_.channels),
+    static_cast<double> (metadata_.samplerate),
+    static_cast<double> (samplerate), quality, sink, chunk_frames);
+  AudioBuffer chunk (metadata_.channels, static_cast<int> (chunk_frames));
+  const auto  num_frames = static_cast<size_t> (metadata_.num_frames);
+  for (size_t start = 0; start < num_frames; start += chunk_frames)
+    {
+      const auto len = std::min (chunk_frames, num_frames - start);
+      if (!reader_->read (
+            &chunk, 0, static_cast<int> (len),
+            static_cast<juce::int64> (start), true, true))
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to read frames at {} from file '{}'", start, filepath_));
+        }
+      resampler.process (chunk.getArrayOfReadPointers (), len);
+    }
+  resampler.finish ();
+}
+
 void
 AudioFile::read_full (
   zrythm::utils::audio::AudioBuffer &buffer,
@@ -130,6 +198,38 @@ AudioFile::read_full (
 {
   read_metadata ();
 
+  if (samplerate.has_value () && samplerate != metadata_.samplerate)
+    {
+      /* resample to project's sample rate while reading, so that only the
+       * result is kept in memory */
+      const auto num_channels = metadata_.channels;
+      const auto expected_frames = static_cast<int> (std::ceil (
+        static_cast<double> (metadata_.num_frames)
+        * static_cast<double> (*samplerate)
+        / static_cast<double> (metadata_.samplerate)));
+      buffer.setSize (num_channels, expected_frames, false, false, false);
+      int  num_written = 0;
+      auto append = [&] (
+                      const float * const * frames, size_t num_frame_channels,
+                      size_t num_frames) {
+        const auto len = static_cast<int> (num_frames);
+        if (num_written + len > buffer.getNumSamples ())
+          {
+            buffer.setSize (
+              num_channels, num_written + len, true, false, true);
+          }
+        for (size_t ch = 0; ch < num_frame_channels; ++ch)
+          {
+            buffer.copyFrom (
+              static_cast<int> (ch), num_written, frames[ch], len);
+          }
+        num_written += len;
+      };
+      read_resampled (*samplerate, append);
+      buffer.setSize (num_channels, num_written, true, false, true);
+      return;
+    }
+
   /* read frames in file's sample rate */
   zrythm::utils::audio::AudioBuffer interleaved_buffer (
     1, metadata_.channels * (size_t) metadata_.num_frames);
@@ -137,23 +237,96 @@ AudioFile::read_full (
   read_samples_interleaved (
     false, interleaved_buffer.getWritePointer (0), 0, metadata_.num_frames);
   interleaved_buffer.deinterleave_samples (metadata_.channels);
+  buffer = std::move (interleaved_buffer);
+}
 
-  if (samplerate.has_value () && samplerate != metadata_.samplerate)
+bool
+AudioFile::repair_wav_header (const fs::path &path)
+{
+  std::error_code ec;
+  const auto      file_size = fs::file_size (path, ec);
+  if (ec || file_size < 12 || file_size - 8 > UINT32_MAX)
+    return false;
+
+  std::fstream file (path, std::ios::in | std::ios::out | std::ios::binary);
+  std::array<char, 12> riff_header{};
+  if (
+    !file.read (riff_header.data (), riff_header.size ())
+    || std::memcmp (riff_header.data (), "RIFF", 4) != 0
+    || std::memcmp (riff_header.data () + 8, "WAVE", 4) != 0)
     {
-      /* resample to project's sample rate */
-      Resampler r (
-        interleaved_buffer, metadata_.samplerate, *samplerate,
-        Resampler::Quality::VeryHigh);
-      while (!r.is_done ())
-        {
-          r.process ();
-        }
-      buffer = r.get_out_frames ();
+      return false;
     }
-  else
+
+  uint64_t block_align = 0;
+  for (uint64_t pos = 12; pos + 8 <= file_size;)
     {
-      buffer = std::move (interleaved_buffer);
+      std::array<char, 8> chunk_header{};
+      file.seekg (static_cast<std::streamoff> (pos));
+      if (!file.read (chunk_header.data (), chunk_header.size ()))
+        return false;
+
+      const uint64_t chunk_size = read_le (chunk_header.data () + 4, 4);
+      const uint64_t chunk_start = pos + 8;
+      if (std::memcmp (chunk_header.data (), "fmt ", 4) == 0)
+        {
+          /* format tag, channels, sample rate, byte rate, block align */
+          std::array<char, 14> fmt{};
+          if (!file.read (fmt.data (), fmt.size ()))
+            return false;
+          block_align = read_le (fmt.data () + 12, 2);
+        }
+      else if (std::memcmp (chunk_header.data (), "data", 4) == 0)
+        {
+          /* valid if the data ends at the end of the file or is followed by
+           * another chunk */
+          const uint64_t declared_end = chunk_start + chunk_size;
+          if (declared_end == file_size)
+            return false;
+          if (chunk_size > 0 && declared_end + 8 <= file_size)
+            {
+              std::array<char, 4> next_id{};
+              file.seekg (
+                static_cast<std::streamoff> (declared_end + (chunk_size & 1)));
+              if (
+                file.read (next_id.data (), next_id.size ())
+                && is_chunk_id (next_id.data ()))
+                {
+                  return false;
+                }
+              file.clear ();
+            }
+          if (block_align == 0)
+            return false;
+
+          uint64_t data_size = file_size - chunk_start;
+          data_size -= data_size % block_align;
+          const auto data_size_bytes =
+            to_le32 (static_cast<uint32_t> (data_size));
+          const auto riff_size_bytes = to_le32 (
+            static_cast<uint32_t> (chunk_start + data_size - 8));
+          file.seekp (static_cast<std::streamoff> (pos + 4));
+          file.write (data_size_bytes.data (), data_size_bytes.size ());
+          file.seekp (4);
+          file.write (riff_size_bytes.data (), riff_size_bytes.size ());
+          file.close ();
+          if (!file)
+            return false;
+
+          if (chunk_start + data_size != file_size)
+            {
+              fs::resize_file (path, chunk_start + data_size, ec);
+            }
+          z_info (
+            "repaired header of '{}' ({} bytes of audio data)", path.string (),
+            data_size);
+          return !ec;
+        }
+
+      pos = chunk_start + chunk_size + (chunk_size & 1);
     }
+
+  return false;
 }
 
 }; //  namespace zrythm::utils::io
@@ -10,6 +10,7 @@
 #include <utility>
 
 #include "utils/audio.h"
+#include "utils/resampler.h"
 
 namespace zrythm::utils::audio
 {
@@ -88,10 +89,26 @@ public:
     size_t  start_from,
     size_t  num_frames_to_read);
 
+  /**
+   * @brief Reads the file in chunks resampled to @p samplerate, passing them
+   * to @p sink.
+   *
+   * Neither the file nor the result are kept in memory, so this can be used
+   * to convert large files (e.g., by writing each chunk to another file).
+   *
+   * @throw ZrythmException on error.
+   */
+  void read_resampled (
+    size_t                          samplerate,
+    const StreamingResampler::Sink &sink,
+    Resampler::Quality              quality = Resampler::Quality::VeryHigh,
+    size_t chunk_frames = StreamingResampler::DEFAULT_CHUNK_FRAMES);
+
   /**
    * Simple blocking API for reading and optionally resampling audio files.
    *
-   * Only to be used on small files.
+   * The whole result is kept in memory, so this is only to be used on files
+   * that fit in memory (see read_resampled()).
    *
    * @param[out] buffer Buffer to store the result to. Its internal buffers may
    * be re-allocated.
@@ -104,6 +121,21 @@ public:
     zrythm::utils::audio::AudioBuffer &buffer,
     std::optional<size_t>              samplerate);
 
+  /**
+   * @brief Fixes the sizes in the header of a WAV file whose writer didn't
+   * finalize it (e.g., because the application crashed while recording).
+   *
+   * WAV files are written with the size of the data chunk in the header,
+   * which is only updated when the writer is flushed or closed. If the data
+   * chunk is the last chunk and doesn't end at the end of the file, its size
+   * and the RIFF size are set from the file size (an incomplete frame at the
+   * end is truncated).
+   *
+   * @return Whether the header was fixed. Files that are not WAV, larger
+   * than 4 GiB or already valid are left untouched.
+   */
+  static bool repair_wav_header (const fs::path &path);
+
 private:
   /**
    * Ensures there is an opened file.
@@ -0,0 +1,255 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-config.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+#include "utils/audio_fingerprint.h"
+
+#if HAVE_CHROMAPRINT
+#  include <chromaprint.h>
+#endif
+
+namespace zrythm::utils::audio
+{
+
+namespace
+{
+/**
+ * Fingerprints are compared at offsets of up to this many items (about a
+ * second).
+ */
+constexpr int MAX_CHROMA_OFFSET = 8;
+
+/** Fingerprints overlapping less than this are not compared. */
+constexpr size_t MIN_CHROMA_OVERLAP = 16;
+
+#if HAVE_CHROMAPRINT
+constexpr int CHROMA_FEED_FRAMES = 8192;
+#endif
+}
+
+AudioFingerprint
+AudioFingerprint::compute_exact (const AudioBuffer &frames)
+{
+  AudioFingerprint ret;
+  ret.num_channels_ = frames.getNumChannels ();
+  ret.num_frames_ = frames.getNumSamples ();
+
+  /* chain the channel hashes so that the channel order matters */
+  XXH64_hash_t hash = static_cast<XXH64_hash_t> (ret.num_channels_);
+  for (int ch = 0; ch < ret.num_channels_; ++ch)
+    {
+      hash = XXH3_64bits_withSeed (
+        frames.getReadPointer (ch),
+        static_cast<size_t> (ret.num_frames_) * sizeof (float), hash);
+    }
+  ret.content_hash_ = hash;
+  return ret;
+}
+
+std::vector<uint32_t>
+AudioFingerprint::compute_chroma (
+  const AudioBuffer &frames,
+  sample_rate_t      samplerate)
+{
+#if HAVE_CHROMAPRINT
+  const int num_channels = frames.getNumChannels ();
+  const int num_frames = static_cast<int> (std::min<double> (
+    frames.getNumSamples (), MAX_CHROMA_SECONDS * samplerate));
+  if (num_channels == 0 || num_frames == 0 || samplerate == 0)
+    return {};
+
+  ChromaprintContext * ctx = chromaprint_new (CHROMAPRINT_ALGORITHM_DEFAULT);
+  if (!ctx)
+    return {};
+
+  /* feed a mono mixdown to skip the channel mixing in chromaprint */
+  bool ok = chromaprint_start (ctx, static_cast<int> (samplerate), 1) != 0;
+  std::vector<int16_t> buf (CHROMA_FEED_FRAMES);
+  const float          gain = 1.f / static_cast<float> (num_channels);
+  for (int start = 0; ok && start < num_frames; start += CHROMA_FEED_FRAMES)
+    {
+      const int len = std::min (CHROMA_FEED_FRAMES, num_frames - start);
+      for (int i = 0; i < len; ++i)
+        {
+          float sum = 0.f;
+          for (int ch = 0; ch < num_channels; ++ch)
+            sum += frames.getSample (ch, start + i);
+          buf[i] = static_cast<int16_t> (
+            std::clamp (sum * gain, -1.f, 1.f)
+            * std::numeric_limits<int16_t>::max ());
+        }
+      ok = chromaprint_feed (ctx, buf.data (), len) != 0;
+    }
+  ok = ok && chromaprint_finish (ctx) != 0;
+
+  std::vector<uint32_t> ret;
+  uint32_t *            raw = nullptr;
+  int                   raw_size = 0;
+  if (ok && chromaprint_get_raw_fingerprint (ctx, &raw, &raw_size) != 0)
+    {
+      ret.assign (raw, raw + raw_size);
+    }
+  if (raw)
+    chromaprint_dealloc (raw);
+  chromaprint_free (ctx);
+  return ret;
+#else
+  return {};
+#endif
+}
+
+float
+AudioFingerprint::get_similarity (const AudioFingerprint &other) const
+{
+  const auto &a = chroma_;
+  const auto &b = other.chroma_;
+  if (a.empty () || b.empty ())
+    return 0.f;
+
+  /* best bit error rate at the offsets around the start */
+  float best = 0.f;
+  for (int offset = -MAX_CHROMA_OFFSET; offset <= MAX_CHROMA_OFFSET; ++offset)
+    {
+      const size_t a_start = offset > 0 ? static_cast<size_t> (offset) : 0;
+      const size_t b_start = offset < 0 ? static_cast<size_t> (-offset) : 0;
+      if (a_start >= a.size () || b_start >= b.size ())
+        continue;
+
+      const size_t overlap =
+        std::min (a.size () - a_start, b.size () - b_start);
+      if (
+        overlap < MIN_CHROMA_OVERLAP
+        && overlap < std::min (a.size (), b.size ()))
+        continue;
+
+      size_t error_bits = 0;
+      for (size_t i = 0; i < overlap; ++i)
+        {
+          error_bits += static_cast<size_t> (
+            std::popcount (a[a_start + i] ^ b[b_start + i]));
+        }
+      const auto similarity =
+        1.f
+        - static_cast<float> (error_bits)
+            / static_cast<float> (overlap * 32);
+      best = std::max (best, similarity);
+    }
+  return best;
+}
+
+void
+AudioFingerprintIndex::set (
+  Key              key,
+  uint64_t         version,
+  AudioFingerprint fingerprint)
+{
+  std::lock_guard lock (mutex_);
+  entries_[key] = Entry{ version, std::move (fingerprint) };
+}
+
+void
+AudioFingerprintIndex::set_chroma (
+  Key                   key,
+  uint64_t              version,
+  std::vector<uint32_t> chroma)
+{
+  std::lock_guard lock (mutex_);
+  auto            it = entries_.find (key);
+  if (it == entries_.end () || it->second.version_ != version)
+    return;
+
+  it->second.fingerprint_.chroma_ = std::move (chroma);
+}
+
+void
+AudioFingerprintIndex::remove (Key key)
+{
+  std::lock_guard lock (mutex_);
+  entries_.erase (key);
+}
+
+void
+AudioFingerprintIndex::retain (const std::vector<Key> &keys)
+{
+  std::lock_guard lock (mutex_);
+  std::erase_if (entries_, [&] (const auto &kv) {
+    return std::ranges::find (keys, kv.first) == keys.end ();
+  });
+}
+
+std::optional<uint64_t>
+AudioFingerprintIndex::get_version (Key key) const
+{
+  std::lock_guard lock (mutex_);
+  auto            it = entries_.find (key);
+  if (it == entries_.end ())
+    return std::nullopt;
+
+  return it->second.version_;
+}
+
+bool
+AudioFingerprintIndex::has_chroma (Key key) const
+{
+  std::lock_guard lock (mutex_);
+  auto            it = entries_.find (key);
+  return it != entries_.end () && !it->second.fingerprint_.chroma_.empty ();
+}
+
+std::vector<AudioFingerprintIndex::Key>
+AudioFingerprintIndex::find_exact_matches (Key key) const
+{
+  std::lock_guard  lock (mutex_);
+  std::vector<Key> ret;
+  auto             it = entries_.find (key);
+  if (it == entries_.end ())
+    return ret;
+
+  const auto &fp = it->second.fingerprint_;
+  for (const auto &[other_key, entry] : entries_)
+    {
+      if (other_key != key && entry.fingerprint_.is_exact_match (fp))
+        ret.push_back (other_key);
+    }
+  std::ranges::sort (ret);
+  return ret;
+}
+
+std::vector<std::pair<AudioFingerprintIndex::Key, float>>
+AudioFingerprintIndex::find_similar (Key key, float min_similarity) const
+{
+  std::lock_guard                    lock (mutex_);
+  std::vector<std::pair<Key, float>> ret;
+  auto                               it = entries_.find (key);
+  if (it == entries_.end ())
+    return ret;
+
+  const auto &fp = it->second.fingerprint_;
+  for (const auto &[other_key, entry] : entries_)
+    {
+      if (other_key == key || entry.fingerprint_.is_exact_match (fp))
+        continue;
+
+      const auto similarity = fp.get_similarity (entry.fingerprint_);
+      if (similarity >= min_similarity)
+        ret.emplace_back (other_key, similarity);
+    }
+  std::ranges::sort (ret, [] (const auto &a, const auto &b) {
+    return a.second > b.second || (a.second == b.second && a.first < b.first);
+  });
+  return ret;
+}
+
+size_t
+AudioFingerprintIndex::size () const
+{
+  std::lock_guard lock (mutex_);
+  return entries_.size ();
+}
+
+} // namespace zrythm::utils::audio
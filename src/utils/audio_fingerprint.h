@@ -0,0 +1,159 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_AUDIO_FINGERPRINT_H__
+#define __UTILS_AUDIO_FINGERPRINT_H__
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "utils/audio.h"
+#include "utils/hash.h"
+#include "utils/types.h"
+
+namespace zrythm::utils::audio
+{
+
+/**
+ * @brief Fingerprint of some audio, used to find the same or similar audio
+ * regardless of the file (format, bit depth, metadata) it came from.
+ */
+struct AudioFingerprint
+{
+  /**
+   * Audio longer than this (in seconds) is only fingerprinted by its
+   * beginning for similarity.
+   */
+  static constexpr double MAX_CHROMA_SECONDS = 120.0;
+
+  /**
+   * @brief Computes the exact part of the fingerprint (fast).
+   */
+  static AudioFingerprint compute_exact (const AudioBuffer &frames);
+
+  /**
+   * @brief Computes the Chromaprint fingerprint of @p frames, used for
+   * similarity.
+   *
+   * @return The raw fingerprint, or empty if Chromaprint is not available or
+   * the audio is too short.
+   */
+  static std::vector<uint32_t>
+  compute_chroma (const AudioBuffer &frames, sample_rate_t samplerate);
+
+  /**
+   * @brief Returns whether the audio is identical (barring hash collisions).
+   */
+  bool is_exact_match (const AudioFingerprint &other) const
+  {
+    return content_hash_ == other.content_hash_
+           && num_channels_ == other.num_channels_
+           && num_frames_ == other.num_frames_;
+  }
+
+  /**
+   * @brief Returns the similarity of the chroma fingerprints, from 0 to 1
+   * (unrelated audio is around 0.5).
+   *
+   * The fingerprints are compared at the offset (of up to about a second)
+   * where they match best.
+   *
+   * @return The similarity, or 0 if either has no chroma fingerprint.
+   */
+  float get_similarity (const AudioFingerprint &other) const;
+
+  /** Hash of the frames of all the channels. */
+  hash::HashT content_hash_ = 0;
+
+  int     num_channels_ = 0;
+  int64_t num_frames_ = 0;
+
+  /** Raw Chromaprint fingerprint (see compute_chroma()). */
+  std::vector<uint32_t> chroma_;
+};
+
+/**
+ * @brief Index of audio fingerprints by key, to find duplicates and
+ * near-duplicates.
+ *
+ * Each fingerprint has a version (e.g., the generation of the audio it was
+ * computed from) so that stale fingerprints can be detected and fingerprints
+ * computed in the background don't replace newer ones.
+ *
+ * Thread-safe.
+ */
+class AudioFingerprintIndex
+{
+public:
+  using Key = int64_t;
+
+  /**
+   * Audio at least this similar (see AudioFingerprint::get_similarity()) is
+   * considered a near-duplicate by default.
+   */
+  static constexpr float DEFAULT_MIN_SIMILARITY = 0.85f;
+
+  /**
+   * @brief Adds or replaces the fingerprint of @p key.
+   */
+  void set (Key key, uint64_t version, AudioFingerprint fingerprint);
+
+  /**
+   * @brief Sets the chroma fingerprint of @p key, if its fingerprint is still
+   * at @p version.
+   */
+  void
+  set_chroma (Key key, uint64_t version, std::vector<uint32_t> chroma);
+
+  void remove (Key key);
+
+  /**
+   * @brief Removes the keys not in @p keys.
+   */
+  void retain (const std::vector<Key> &keys);
+
+  /**
+   * @brief Returns the version of the fingerprint of @p key, if any.
+   */
+  std::optional<uint64_t> get_version (Key key) const;
+
+  /**
+   * @brief Returns whether the fingerprint of @p key includes a chroma
+   * fingerprint.
+   */
+  bool has_chroma (Key key) const;
+
+  /**
+   * @brief Returns the other keys with identical audio, in ascending order.
+   */
+  std::vector<Key> find_exact_matches (Key key) const;
+
+  /**
+   * @brief Returns the other keys with similar (but not identical) audio
+   * and their similarity, most similar first.
+   */
+  std::vector<std::pair<Key, float>> find_similar (
+    Key   key,
+    float min_similarity = DEFAULT_MIN_SIMILARITY) const;
+
+  size_t size () const;
+
+private:
+  struct Entry
+  {
+    uint64_t         version_ = 0;
+    AudioFingerprint fingerprint_;
+  };
+
+  std::unordered_map<Key, Entry> entries_;
+
+  mutable std::mutex mutex_;
+};
+
+} // namespace zrythm::utils::audio
+
+#endif
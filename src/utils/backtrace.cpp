@@ -49,4 +49,50 @@ Backtrace::get_backtrace (std::string prefix, int depth, bool write_to_file)
   return oss.str ();
 }
 
+void
+RawBacktrace::capture () noexcept
+{
+#if BACKWARD_HAS_UNWIND == 1
+  struct Callback
+  {
+    RawBacktrace &self_;
+    void          operator() (size_t idx, void * addr)
+    {
+      self_.addresses_[idx] = addr;
+    }
+  };
+  Callback callback{ *this };
+  depth_ = backward::details::unwind (callback, MAX_DEPTH);
+#else
+  depth_ = 0;
+#endif
+}
+
+std::string
+RawBacktrace::to_string () const
+{
+  backward::TraceResolver resolver;
+  resolver.load_addresses (addresses_.data (), static_cast<int> (depth_));
+
+  std::ostringstream oss;
+  for (size_t i = 0; i < depth_; ++i)
+    {
+      const auto trace =
+        resolver.resolve (backward::ResolvedTrace (
+          backward::Trace (addresses_[i], i)));
+      oss << "#" << i << " " << trace.addr << " in "
+          << (trace.object_function.empty () ? "??" : trace.object_function);
+      if (!trace.source.filename.empty ())
+        {
+          oss << " at " << trace.source.filename << ":" << trace.source.line;
+        }
+      else if (!trace.object_filename.empty ())
+        {
+          oss << " (" << trace.object_filename << ")";
+        }
+      oss << "\n";
+    }
+  return oss.str ();
+}
+
 }; // namespace zrythm::utils
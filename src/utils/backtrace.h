@@ -4,6 +4,8 @@
 #ifndef __UTILS_BACKTRACE_H__
 #define __UTILS_BACKTRACE_H__
 
+#include <array>
+#include <span>
 #include <string>
 
 namespace zrythm::utils
@@ -30,6 +32,48 @@ public:
   std::string get_backtrace (std::string prefix, int depth, bool write_to_file);
 };
 
+/**
+ * @brief Return addresses of a call stack, captured without allocating and
+ * symbolized on demand.
+ *
+ * Unlike Backtrace, capturing is cheap enough to be done on realtime threads.
+ * The (slow, allocating) symbolization can be done later on another thread.
+ */
+class RawBacktrace
+{
+public:
+  static constexpr size_t MAX_DEPTH = 16;
+
+  /**
+   * @brief Captures the return addresses of the calling thread's stack,
+   * replacing any previous ones.
+   *
+   * Does not allocate.
+   */
+  void capture () noexcept;
+
+  void clear () noexcept { depth_ = 0; }
+
+  bool empty () const { return depth_ == 0; }
+
+  std::span<void * const> get_addresses () const
+  {
+    return { addresses_.data (), depth_ };
+  }
+
+  /**
+   * @brief Resolves the addresses to a human-readable backtrace (one frame
+   * per line).
+   *
+   * Allocates, so must not be called on realtime threads.
+   */
+  std::string to_string () const;
+
+private:
+  std::array<void *, MAX_DEPTH> addresses_{};
+  size_t                        depth_ = 0;
+};
+
 }; // namespace zrythm::utils
 
 #endif
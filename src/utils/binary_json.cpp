@@ -0,0 +1,429 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+#include "utils/binary_json.h"
+#include "utils/exceptions.h"
+
+namespace zrythm::utils::binary_json
+{
+
+namespace
+{
+
+constexpr char MAGIC[4] = { 'Z', 'B', 'J', 'S' };
+
+/** Nesting limit when reading, so that corrupt files can't blow the stack. */
+constexpr int MAX_DEPTH = 512;
+
+enum class Tag : uint8_t
+{
+  Null = 0,
+  False,
+  True,
+  Uint,
+  Sint,
+  Real,
+  String,
+  Array,
+  Object,
+};
+
+class Writer
+{
+public:
+  explicit Writer (const json::ChunkSink &sink) : sink_ (sink) { }
+
+  void write_header ()
+  {
+    out_.append (MAGIC, sizeof (MAGIC));
+    write_u32 (FORMAT_VERSION);
+  }
+
+  void write_value (yyjson_mut_val * val)
+  {
+    switch (yyjson_mut_get_type (val))
+      {
+      case YYJSON_TYPE_NULL:
+        write_tag (Tag::Null);
+        break;
+      case YYJSON_TYPE_BOOL:
+        write_tag (yyjson_mut_get_bool (val) ? Tag::True : Tag::False);
+        break;
+      case YYJSON_TYPE_NUM:
+        if (yyjson_mut_is_uint (val))
+          {
+            write_tag (Tag::Uint);
+            write_varint (yyjson_mut_get_uint (val));
+          }
+        else if (yyjson_mut_is_sint (val))
+          {
+            const auto sint = yyjson_mut_get_sint (val);
+            write_tag (Tag::Sint);
+            write_varint (
+              (static_cast<uint64_t> (sint) << 1)
+              ^ static_cast<uint64_t> (sint >> 63));
+          }
+        else
+          {
+            uint64_t bits;
+            const double real = yyjson_mut_get_real (val);
+            std::memcpy (&bits, &real, sizeof (bits));
+            write_tag (Tag::Real);
+            for (int i = 0; i < 8; ++i)
+              {
+                out_.push_back (static_cast<char> ((bits >> (i * 8)) & 0xFF));
+              }
+          }
+        break;
+      case YYJSON_TYPE_STR:
+        write_tag (Tag::String);
+        write_string (yyjson_mut_get_str (val), yyjson_mut_get_len (val));
+        break;
+      case YYJSON_TYPE_ARR:
+        {
+          write_tag (Tag::Array);
+          write_varint (yyjson_mut_arr_size (val));
+          yyjson_mut_arr_iter it = yyjson_mut_arr_iter_with (val);
+          yyjson_mut_val *    child = nullptr;
+          while ((child = yyjson_mut_arr_iter_next (&it)))
+            {
+              write_value (child);
+            }
+        }
+        break;
+      case YYJSON_TYPE_OBJ:
+        {
+          write_tag (Tag::Object);
+          write_varint (yyjson_mut_obj_size (val));
+          yyjson_mut_obj_iter it = yyjson_mut_obj_iter_with (val);
+          yyjson_mut_val *    key = nullptr;
+          while ((key = yyjson_mut_obj_iter_next (&it)))
+            {
+              write_key (key);
+              write_value (yyjson_mut_obj_iter_get_val (key));
+            }
+        }
+        break;
+      default:
+        throw ZrythmException ("Cannot encode JSON value to binary");
+      }
+
+    if (out_.size () >= json::WRITE_CHUNK_SIZE)
+      flush ();
+  }
+
+  void flush ()
+  {
+    if (out_.empty ())
+      return;
+
+    sink_ (out_);
+    out_.clear ();
+  }
+
+private:
+  void write_tag (Tag tag) { out_.push_back (static_cast<char> (tag)); }
+
+  void write_u32 (uint32_t val)
+  {
+    for (int i = 0; i < 4; ++i)
+      {
+        out_.push_back (static_cast<char> ((val >> (i * 8)) & 0xFF));
+      }
+  }
+
+  void write_varint (uint64_t val)
+  {
+    while (val >= 0x80)
+      {
+        out_.push_back (static_cast<char> ((val & 0x7F) | 0x80));
+        val >>= 7;
+      }
+    out_.push_back (static_cast<char> (val));
+  }
+
+  void write_string (const char * str, size_t len)
+  {
+    write_varint (len);
+    out_.append (str, len);
+  }
+
+  /**
+   * Keys are written as 0 followed by the string on first use, or as their
+   * index + 1 afterwards.
+   */
+  void write_key (yyjson_mut_val * key)
+  {
+    const std::string_view key_str{
+      yyjson_mut_get_str (key), yyjson_mut_get_len (key)
+    };
+    if (auto it = key_indices_.find (key_str); it != key_indices_.end ())
+      {
+        write_varint (it->second + 1);
+        return;
+      }
+
+    write_varint (0);
+    write_string (key_str.data (), key_str.size ());
+    key_indices_.emplace (key_str, key_indices_.size ());
+  }
+
+private:
+  const json::ChunkSink                         &sink_;
+  std::string                                    out_;
+  std::unordered_map<std::string_view, uint64_t> key_indices_;
+};
+
+class Reader
+{
+public:
+  Reader (std::string_view data, yyjson_mut_doc * doc)
+      : data_ (data), doc_ (doc)
+  {
+  }
+
+  void read_header ()
+  {
+    if (!is_binary (data_))
+      {
+        throw ZrythmException ("Not a binary JSON document");
+      }
+    pos_ = sizeof (MAGIC);
+    const auto version = read_u32 ();
+    if (version > FORMAT_VERSION)
+      {
+        throw ZrythmException (fmt::format (
+          "Cannot read binary JSON document version {} (newest supported "
+          "is {})",
+          version, FORMAT_VERSION));
+      }
+  }
+
+  yyjson_mut_val * read_value (int depth)
+  {
+    if (depth > MAX_DEPTH)
+      {
+        throw ZrythmException ("Binary JSON document is nested too deeply");
+      }
+
+    const auto tag = static_cast<Tag> (read_byte ());
+    switch (tag)
+      {
+      case Tag::Null:
+        return yyjson_mut_null (doc_);
+      case Tag::False:
+        return yyjson_mut_false (doc_);
+      case Tag::True:
+        return yyjson_mut_true (doc_);
+      case Tag::Uint:
+        return yyjson_mut_uint (doc_, read_varint ());
+      case Tag::Sint:
+        {
+          const auto zigzag = read_varint ();
+          return yyjson_mut_sint (
+            doc_,
+            static_cast<int64_t> (zigzag >> 1)
+              ^ -static_cast<int64_t> (zigzag & 1));
+        }
+      case Tag::Real:
+        {
+          uint64_t bits = 0;
+          for (int i = 0; i < 8; ++i)
+            {
+              bits |= static_cast<uint64_t> (read_byte ()) << (i * 8);
+            }
+          double real;
+          std::memcpy (&real, &bits, sizeof (real));
+          return yyjson_mut_real (doc_, real);
+        }
+      case Tag::String:
+        {
+          const auto str = read_string ();
+          return yyjson_mut_strn (doc_, str.data (), str.size ());
+        }
+      case Tag::Array:
+        {
+          const auto       count = read_count ();
+          yyjson_mut_val * arr = yyjson_mut_arr (doc_);
+          for (uint64_t i = 0; i < count; ++i)
+            {
+              yyjson_mut_arr_append (arr, read_value (depth + 1));
+            }
+          return arr;
+        }
+      case Tag::Object:
+        {
+          const auto       count = read_count ();
+          yyjson_mut_val * obj = yyjson_mut_obj (doc_);
+          for (uint64_t i = 0; i < count; ++i)
+            {
+              const auto       key_str = read_key ();
+              yyjson_mut_val * key =
+                yyjson_mut_strn (doc_, key_str.data (), key_str.size ());
+              yyjson_mut_obj_add (obj, key, read_value (depth + 1));
+            }
+          return obj;
+        }
+      }
+
+    throw ZrythmException (
+      fmt::format ("Invalid binary JSON tag {}", static_cast<int> (tag)));
+  }
+
+  bool at_end () const { return pos_ == data_.size (); }
+
+private:
+  uint8_t read_byte ()
+  {
+    if (pos_ >= data_.size ())
+      {
+        throw ZrythmException ("Unexpected end of binary JSON document");
+      }
+    return static_cast<uint8_t> (data_[pos_++]);
+  }
+
+  uint32_t read_u32 ()
+  {
+    uint32_t val = 0;
+    for (int i = 0; i < 4; ++i)
+      {
+        val |= static_cast<uint32_t> (read_byte ()) << (i * 8);
+      }
+    return val;
+  }
+
+  uint64_t read_varint ()
+  {
+    uint64_t val = 0;
+    for (int shift = 0; shift < 64; shift += 7)
+      {
+        const auto byte = read_byte ();
+        val |= static_cast<uint64_t> (byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0)
+          return val;
+      }
+    throw ZrythmException ("Invalid varint in binary JSON document");
+  }
+
+  /**
+   * Reads a number of children, which can't exceed the remaining bytes since
+   * each child takes at least one.
+   */
+  uint64_t read_count ()
+  {
+    const auto count = read_varint ();
+    if (count > data_.size () - pos_)
+      {
+        throw ZrythmException ("Invalid size in binary JSON document");
+      }
+    return count;
+  }
+
+  std::string_view read_string ()
+  {
+    const auto len = read_varint ();
+    if (len > data_.size () - pos_)
+      {
+        throw ZrythmException ("Invalid string in binary JSON document");
+      }
+    std::string_view str = data_.substr (pos_, len);
+    pos_ += len;
+    return str;
+  }
+
+  std::string_view read_key ()
+  {
+    const auto index = read_varint ();
+    if (index == 0)
+      {
+        keys_.push_back (read_string ());
+        return keys_.back ();
+      }
+    if (index > keys_.size ())
+      {
+        throw ZrythmException ("Invalid key in binary JSON document");
+      }
+    return keys_[index - 1];
+  }
+
+private:
+  std::string_view              data_;
+  size_t                        pos_ = 0;
+  yyjson_mut_doc *              doc_;
+  std::vector<std::string_view> keys_;
+};
+
+} // namespace
+
+bool
+is_binary (std::string_view data)
+{
+  return data.size () >= sizeof (MAGIC)
+         && std::memcmp (data.data (), MAGIC, sizeof (MAGIC)) == 0;
+}
+
+void
+write (yyjson_mut_doc * doc, const json::ChunkSink &sink)
+{
+  yyjson_mut_val * root = yyjson_mut_doc_get_root (doc);
+  if (!root)
+    {
+      throw ZrythmException ("Cannot encode empty JSON document");
+    }
+
+  Writer writer (sink);
+  writer.write_header ();
+  writer.write_value (root);
+  writer.flush ();
+}
+
+std::string
+write (yyjson_mut_doc * doc)
+{
+  std::string ret;
+  write (doc, [&ret] (std::string_view chunk) { ret.append (chunk); });
+  return ret;
+}
+
+yyjson_doc *
+read (std::string_view data)
+{
+  /* build a mutable document referencing the strings in data, then copy it
+   * into an immutable one (which also copies the strings) */
+  yyjson_mut_doc * mut_doc = yyjson_mut_doc_new (nullptr);
+  if (!mut_doc)
+    {
+      throw ZrythmException ("Failed to create JSON document");
+    }
+
+  yyjson_doc * doc = nullptr;
+  try
+    {
+      Reader reader (data, mut_doc);
+      reader.read_header ();
+      yyjson_mut_doc_set_root (mut_doc, reader.read_value (0));
+      if (!reader.at_end ())
+        {
+          throw ZrythmException ("Trailing data in binary JSON document");
+        }
+      doc = yyjson_mut_doc_imut_copy (mut_doc, nullptr);
+    }
+  catch (...)
+    {
+      yyjson_mut_doc_free (mut_doc);
+      throw;
+    }
+  yyjson_mut_doc_free (mut_doc);
+
+  if (!doc)
+    {
+      throw ZrythmException ("Failed to create JSON document");
+    }
+  return doc;
+}
+
+}; // namespace zrythm::utils::binary_json
@@ -0,0 +1,72 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_BINARY_JSON_H__
+#define __UTILS_BINARY_JSON_H__
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "utils/json.h"
+#include <yyjson.h>
+
+/**
+ * @brief Compact binary encoding of JSON documents.
+ *
+ * Documents start with a 4-byte magic followed by the format version (see
+ * @ref FORMAT_VERSION). Each value is a 1-byte tag followed by its payload:
+ * integers are (zigzag) LEB128 varints, reals are 8-byte little-endian IEEE
+ * 754 doubles, strings are length-prefixed, and arrays/objects are prefixed
+ * with their number of children. Object keys are interned: the first
+ * occurrence of a key is written inline and later occurrences refer to it by
+ * index, which is what makes the format much smaller than the JSON text for
+ * serialized objects (the same keys are repeated for each instance).
+ *
+ * Member order and duplicate keys are preserved, so a document read back is
+ * equivalent to the one written for code iterating it with yyjson.
+ */
+namespace zrythm::utils::binary_json
+{
+
+/** Bumped on incompatible changes to the encoding. */
+constexpr uint32_t FORMAT_VERSION = 1;
+
+/**
+ * @brief Returns whether @p data starts with the binary document magic.
+ */
+bool
+is_binary (std::string_view data);
+
+/**
+ * @brief Encodes the root of @p doc.
+ *
+ * @throw ZrythmException If the document contains values that can't be
+ * encoded (e.g., raw values).
+ */
+std::string
+write (yyjson_mut_doc * doc);
+
+/**
+ * @brief Encodes the root of @p doc in chunks of about @ref
+ * json::WRITE_CHUNK_SIZE bytes.
+ *
+ * @throw ZrythmException Same as write(), or rethrows exceptions from @p sink.
+ */
+void
+write (yyjson_mut_doc * doc, const json::ChunkSink &sink);
+
+/**
+ * @brief Decodes a document written with write().
+ *
+ * @return A new document to be freed with yyjson_doc_free(). Strings are
+ * copied, so @p data may be released afterwards.
+ * @throw ZrythmException If @p data is not a valid document or was written
+ * by a newer format version.
+ */
+yyjson_doc *
+read (std::string_view data);
+
+}; // namespace zrythm::utils::binary_json
+
+#endif // __UTILS_BINARY_JSON_H__
@@ -1,10 +1,17 @@
 // SPDX-FileCopyrightText: © 2023-2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <algorithm>
+
 #include "utils/base64.h"
 #include "utils/compression.h"
 #include "utils/exceptions.h"
+#include "utils/logger.h"
 #include "utils/mem.h"
+
+#include <QFile>
+#include <QSaveFile>
+
 #include <zstd.h>
 
 namespace zrythm::utils::compression
@@ -73,4 +80,247 @@ decompress_string_from_base64 (const QByteArray &b64)
   return { dest };
 }
 
+std::string
+compress (std::string_view src, int level)
+{
+  std::string ret (ZSTD_compressBound (src.size ()), '\0');
+  const size_t size = ZSTD_compress (
+    ret.data (), ret.size (), src.data (), src.size (),
+    std::clamp (level, ZSTD_minCLevel (), ZSTD_maxCLevel ()));
+  if (ZSTD_isError (size))
+    {
+      throw ZrythmException (
+        fmt::format ("Failed to compress: {}", ZSTD_getErrorName (size)));
+    }
+  ret.resize (size);
+  return ret;
+}
+
+std::string
+decompress (std::string_view src)
+{
+  const auto content_size = ZSTD_getFrameContentSize (src.data (), src.size ());
+  if (
+    content_size == ZSTD_CONTENTSIZE_ERROR
+    || content_size == ZSTD_CONTENTSIZE_UNKNOWN)
+    {
+      throw ZrythmException ("Data not compressed by zstd");
+    }
+
+  std::string  ret (content_size, '\0');
+  const size_t size =
+    ZSTD_decompress (ret.data (), ret.size (), src.data (), src.size ());
+  if (ZSTD_isError (size))
+    {
+      throw ZrythmException (
+        fmt::format ("Failed to decompress: {}", ZSTD_getErrorName (size)));
+    }
+  if (size != content_size)
+    {
+      throw ZrythmException ("Decompressed size != frame content size");
+    }
+  return ret;
+}
+
+std::string
+decompress_file (const std::filesystem::path &path)
+{
+  QFile file (path);
+  if (!file.open (QIODevice::ReadOnly))
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to open file for reading: '{}' ({})", path.string (),
+        file.errorString ()));
+    }
+
+  std::vector<char> in_buf (ZSTD_DStreamInSize ());
+  std::string       ret;
+
+  /* reserve the full size up front if known (frames written in streaming mode
+   * don't record it) */
+  {
+    /* ZSTD_FRAMEHEADERSIZE_MAX (only exposed with ZSTD_STATIC_LINKING_ONLY) */
+    constexpr qint64 max_frame_header_size = 18;
+    const auto       header_size =
+      file.peek (in_buf.data (), max_frame_header_size);
+    if (header_size > 0)
+      {
+        const auto content_size = ZSTD_getFrameContentSize (
+          in_buf.data (), static_cast<size_t> (header_size));
+        if (content_size == ZSTD_CONTENTSIZE_ERROR)
+          {
+            throw ZrythmException (fmt::format (
+              "File '{}' is not compressed by zstd", path.string ()));
+          }
+        if (content_size != ZSTD_CONTENTSIZE_UNKNOWN)
+          {
+            ret.reserve (content_size);
+          }
+      }
+  }
+
+  auto dctx = std::unique_ptr<ZSTD_DCtx, decltype (&ZSTD_freeDCtx)> (
+    ZSTD_createDCtx (), ZSTD_freeDCtx);
+  if (!dctx)
+    {
+      throw ZrythmException ("Failed to create zstd context");
+    }
+
+  std::vector<char> out_buf (ZSTD_DStreamOutSize ());
+  size_t            last_ret = 0;
+  bool              read_any = false;
+  while (true)
+    {
+      const auto read = file.read (in_buf.data (), in_buf.size ());
+      if (read < 0)
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to read file '{}' ({})", path.string (),
+            file.errorString ()));
+        }
+      if (read == 0)
+        break;
+
+      read_any = true;
+      ZSTD_inBuffer in{ in_buf.data (), static_cast<size_t> (read), 0 };
+      while (in.pos < in.size)
+        {
+          ZSTD_outBuffer out{ out_buf.data (), out_buf.size (), 0 };
+          last_ret = ZSTD_decompressStream (dctx.get (), &out, &in);
+          if (ZSTD_isError (last_ret))
+            {
+              throw ZrythmException (fmt::format (
+                "Failed to decompress '{}': {}", path.string (),
+                ZSTD_getErrorName (last_ret)));
+            }
+          ret.append (out_buf.data (), out.pos);
+        }
+    }
+
+  /* flush any remaining output */
+  while (last_ret != 0)
+    {
+      ZSTD_inBuffer  in{ nullptr, 0, 0 };
+      ZSTD_outBuffer out{ out_buf.data (), out_buf.size (), 0 };
+      last_ret = ZSTD_decompressStream (dctx.get (), &out, &in);
+      if (ZSTD_isError (last_ret))
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to decompress '{}': {}", path.string (),
+            ZSTD_getErrorName (last_ret)));
+        }
+      ret.append (out_buf.data (), out.pos);
+
+      /* no progress possible: the last frame is incomplete */
+      if (last_ret != 0 && out.pos < out.size)
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to decompress '{}': truncated data", path.string ()));
+        }
+    }
+
+  if (!read_any)
+    {
+      throw ZrythmException (
+        fmt::format ("File '{}' is empty", path.string ()));
+    }
+
+  return ret;
+}
+
+StreamingFileCompressor::StreamingFileCompressor (
+  const std::filesystem::path &path,
+  int                          level,
+  int                          num_workers)
+    : path_ (path), file_ (std::make_unique<QSaveFile> (path)),
+      cctx_ (ZSTD_createCCtx ()), out_buf_ (ZSTD_CStreamOutSize ())
+{
+  if (!cctx_)
+    {
+      throw ZrythmException ("Failed to create zstd context");
+    }
+  ZSTD_CCtx_setParameter (
+    cctx_, ZSTD_c_compressionLevel,
+    std::clamp (level, ZSTD_minCLevel (), ZSTD_maxCLevel ()));
+  if (num_workers > 0)
+    {
+      const auto err =
+        ZSTD_CCtx_setParameter (cctx_, ZSTD_c_nbWorkers, num_workers);
+      if (ZSTD_isError (err))
+        {
+          z_debug (
+            "zstd multi-threading unavailable, compressing on the calling "
+            "thread: {}",
+            ZSTD_getErrorName (err));
+        }
+    }
+
+  if (!file_->open (QIODevice::WriteOnly))
+    {
+      ZSTD_freeCCtx (cctx_);
+      throw ZrythmException (fmt::format (
+        "Failed to open file for writing: '{}' ({})", path.string (),
+        file_->errorString ()));
+    }
+}
+
+StreamingFileCompressor::~StreamingFileCompressor ()
+{
+  /* the file is discarded if finish() was not called */
+  ZSTD_freeCCtx (cctx_);
+}
+
+void
+StreamingFileCompressor::write (std::string_view data)
+{
+  compress (data, false);
+  total_in_ += data.size ();
+}
+
+void
+StreamingFileCompressor::finish ()
+{
+  compress ({}, true);
+  if (!file_->commit ())
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to write file '{}' ({})", path_.string (),
+        file_->errorString ()));
+    }
+}
+
+void
+StreamingFileCompressor::compress (std::string_view data, bool end)
+{
+  ZSTD_inBuffer in{ data.data (), data.size (), 0 };
+  while (true)
+    {
+      ZSTD_outBuffer out{ out_buf_.data (), out_buf_.size (), 0 };
+      const size_t   remaining = ZSTD_compressStream2 (
+        cctx_, &out, &in, end ? ZSTD_e_end : ZSTD_e_continue);
+      if (ZSTD_isError (remaining))
+        {
+          throw ZrythmException (fmt::format (
+            "Failed to compress: {}", ZSTD_getErrorName (remaining)));
+        }
+
+      if (out.pos > 0)
+        {
+          if (
+            file_->write (out_buf_.data (), static_cast<qint64> (out.pos))
+            != static_cast<qint64> (out.pos))
+            {
+              throw ZrythmException (fmt::format (
+                "Failed to write file '{}' ({})", path_.string (),
+                file_->errorString ()));
+            }
+          total_out_ += out.pos;
+        }
+
+      const bool done = end ? remaining == 0 : in.pos == in.size;
+      if (done)
+        break;
+    }
+}
+
 };
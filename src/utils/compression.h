@@ -4,9 +4,18 @@
 #ifndef __UTILS_COMPRESSION_H__
 #define __UTILS_COMPRESSION_H__
 
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
 #include "utils/string.h"
 #include "utils/types.h"
 
+class QSaveFile;
+struct ZSTD_CCtx_s;
+
 /**
  * @brief Compression utilities.
  */
@@ -29,6 +38,101 @@ compress_to_base64_str (const QByteArray &src);
 string::CStringRAII
 decompress_string_from_base64 (const QByteArray &b64);
 
+/**
+ * @brief Compresses @p src with zstd into a single frame that records the
+ * uncompressed size.
+ *
+ * @param level zstd compression level (clamped to the supported range). Low
+ * levels are the fastest.
+ * @throw ZrythmException on error.
+ */
+std::string
+compress (std::string_view src, int level = 1);
+
+/**
+ * @brief Decompresses data compressed with compress().
+ *
+ * @throw ZrythmException If @p src is not a valid zstd frame with a recorded
+ * content size.
+ */
+std::string
+decompress (std::string_view src);
+
+/**
+ * @brief Decompresses the zstd-compressed file at @p path.
+ *
+ * The file is read and decompressed in chunks, so only the decompressed data
+ * is held in memory as a whole. Frames with and without a recorded content
+ * size are supported.
+ *
+ * @throw ZrythmException If the file could not be read or is not valid zstd
+ * data.
+ */
+std::string
+decompress_file (const std::filesystem::path &path);
+
+/**
+ * @brief Compresses data with zstd and writes it to a file as it arrives.
+ *
+ * Only buffers of a fixed size are kept in memory regardless of the amount of
+ * data written. The file at the given path is only replaced when finish()
+ * succeeds, so an interrupted write leaves any existing file intact.
+ *
+ * The written frame doesn't contain the uncompressed size, so it must be
+ * decompressed in streaming mode (e.g., with decompress_file()).
+ */
+class StreamingFileCompressor
+{
+public:
+  /**
+   * @param level zstd compression level (clamped to the supported range).
+   * @param num_workers Number of threads to compress on in the background, or
+   * 0 to compress on the calling thread. Ignored if zstd was built without
+   * multi-threading support.
+   * @throw ZrythmException If the file could not be opened.
+   */
+  StreamingFileCompressor (
+    const std::filesystem::path &path,
+    int                          level,
+    int                          num_workers = 0);
+  ~StreamingFileCompressor ();
+  Z_DISABLE_COPY_MOVE (StreamingFileCompressor)
+
+  /**
+   * @brief Compresses @p data and writes the output to the file.
+   *
+   * @throw ZrythmException on error.
+   */
+  void write (std::string_view data);
+
+  /**
+   * @brief Ends the frame and commits the file.
+   *
+   * @throw ZrythmException on error.
+   */
+  void finish ();
+
+  /** Number of uncompressed bytes written so far. */
+  size_t get_total_in () const { return total_in_; }
+
+  /** Number of compressed bytes written so far. */
+  size_t get_total_out () const { return total_out_; }
+
+private:
+  /**
+   * @param end Whether to end the frame after compressing @p data.
+   */
+  void compress (std::string_view data, bool end);
+
+private:
+  std::filesystem::path      path_;
+  std::unique_ptr<QSaveFile> file_;
+  ZSTD_CCtx_s *              cctx_ = nullptr;
+  std::vector<char>          out_buf_;
+  size_t                     total_in_ = 0;
+  size_t                     total_out_ = 0;
+};
+
 }; // namespace zrythm::utils::compression
 
 #endif // __UTILS_COMPRESSION_H__
@@ -4,8 +4,11 @@
 #ifndef __UTILS_CONCURRENCY_H__
 #define __UTILS_CONCURRENCY_H__
 
+#include <algorithm>
 #include <atomic>
+#include <future>
 #include <semaphore>
+#include <vector>
 
 /**
  * @brief RAII class for managing the lifetime of an atomic bool.
@@ -132,4 +135,52 @@ private:
   bool acquired_ = false;    ///< Flag indicating if the semaphore is acquired.
 };
 
+/**
+ * @brief Calls @p func with each index in [0, @p count) from up to
+ * @p max_threads threads (including the calling thread), until a call returns
+ * false.
+ *
+ * Once a call returns false no more indices are handed out, but calls already
+ * running on other threads are completed. Exceptions thrown by @p func are
+ * rethrown after all threads finish.
+ *
+ * @param func Function taking an index and returning whether to continue.
+ * @return Whether all calls returned true.
+ */
+template <typename Func>
+bool
+all_of_indices_in_parallel (size_t count, size_t max_threads, Func &&func)
+{
+  std::atomic<size_t> next_index = 0;
+  std::atomic_bool    failed = false;
+  const auto          process_next_indices = [&] () {
+    while (!failed.load (std::memory_order_relaxed))
+      {
+        const auto index = next_index.fetch_add (1);
+        if (index >= count)
+          break;
+
+        if (!func (index))
+          failed.store (true, std::memory_order_relaxed);
+      }
+  };
+
+  const auto num_threads =
+    std::max (std::min (max_threads, count), size_t{ 1 });
+  std::vector<std::future<void>> workers;
+  workers.reserve (num_threads - 1);
+  for (size_t i = 1; i < num_threads; ++i)
+    {
+      workers.emplace_back (
+        std::async (std::launch::async, process_next_indices));
+    }
+  process_next_indices ();
+  for (auto &worker : workers)
+    {
+      worker.get ();
+    }
+
+  return !failed.load ();
+}
+
 #endif // __UTILS_CONCURRENCY_H__
\ No newline at end of file
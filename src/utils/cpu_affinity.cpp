@@ -0,0 +1,263 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-config.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+#include "utils/cpu_affinity.h"
+#include "utils/logger.h"
+
+#ifdef __linux__
+#  include <linux/mempolicy.h>
+#  include <pthread.h>
+#  include <sched.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+#ifdef _WIN32
+#  include <windows.h>
+#endif
+
+namespace zrythm::utils::cpu
+{
+
+std::vector<int>
+parse_cpu_list (std::string_view str)
+{
+  std::vector<int> ret;
+
+  auto parse_int = [] (std::string_view s, int &out) {
+    const auto res = std::from_chars (s.data (), s.data () + s.size (), out);
+    return res.ec == std::errc () && res.ptr == s.data () + s.size ()
+           && out >= 0;
+  };
+
+  /* trim whitespace (sysfs entries end with a newline) */
+  while (
+    !str.empty () && std::isspace (static_cast<unsigned char> (str.back ())))
+    str.remove_suffix (1);
+  while (
+    !str.empty () && std::isspace (static_cast<unsigned char> (str.front ())))
+    str.remove_prefix (1);
+
+  while (!str.empty ())
+    {
+      const auto       comma = str.find (',');
+      std::string_view range = str.substr (0, comma);
+      str = comma == std::string_view::npos ? "" : str.substr (comma + 1);
+
+      int        first = 0;
+      int        last = 0;
+      const auto dash = range.find ('-');
+      if (dash == std::string_view::npos)
+        {
+          if (!parse_int (range, first))
+            return {};
+          last = first;
+        }
+      else if (
+        !parse_int (range.substr (0, dash), first)
+        || !parse_int (range.substr (dash + 1), last) || last < first)
+        {
+          return {};
+        }
+
+      for (int i = first; i <= last; ++i)
+        {
+          ret.push_back (i);
+        }
+    }
+
+  std::ranges::sort (ret);
+  const auto [first, last] = std::ranges::unique (ret);
+  ret.erase (first, last);
+  return ret;
+}
+
+#ifdef __linux__
+static std::string
+read_sysfs_file (const std::string &path)
+{
+  std::ifstream file (path);
+  std::string   contents;
+  if (file)
+    std::getline (file, contents);
+  return contents;
+}
+#endif
+
+std::vector<int>
+get_isolated_cpus ()
+{
+#ifdef __linux__
+  return parse_cpu_list (
+    read_sysfs_file ("/sys/devices/system/cpu/isolated"));
+#else
+  return {};
+#endif
+}
+
+std::vector<int>
+get_performance_cpus ()
+{
+#ifdef __linux__
+  /* Intel hybrid CPUs expose a separate PMU for each core type */
+  auto p_cores =
+    parse_cpu_list (read_sysfs_file ("/sys/devices/cpu_core/cpus"));
+  auto e_cores =
+    parse_cpu_list (read_sysfs_file ("/sys/devices/cpu_atom/cpus"));
+  if (!p_cores.empty () && !e_cores.empty ())
+    return p_cores;
+
+  /* ARM big.LITTLE reports a relative capacity per core */
+  const auto online =
+    parse_cpu_list (read_sysfs_file ("/sys/devices/system/cpu/online"));
+  std::vector<std::pair<int, int>> capacities;
+  for (const auto cpu : online)
+    {
+      const auto str = read_sysfs_file (
+        "/sys/devices/system/cpu/cpu" + std::to_string (cpu) + "/cpu_capacity");
+      int capacity = 0;
+      if (
+        str.empty ()
+        || std::from_chars (str.data (), str.data () + str.size (), capacity)
+               .ec
+             != std::errc ())
+        return {};
+      capacities.emplace_back (cpu, capacity);
+    }
+  if (capacities.empty ())
+    return {};
+
+  const auto max_capacity =
+    std::ranges::max (capacities, {}, &std::pair<int, int>::second).second;
+  std::vector<int> ret;
+  for (const auto &[cpu, capacity] : capacities)
+    {
+      if (capacity == max_capacity)
+        ret.push_back (cpu);
+    }
+  if (ret.size () == capacities.size ())
+    return {};
+  return ret;
+#else
+  return {};
+#endif
+}
+
+bool
+set_current_thread_affinity (std::span<const int> cpus)
+{
+  if (cpus.empty ())
+    return false;
+
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO (&set);
+  for (const auto cpu : cpus)
+    {
+      if (cpu < CPU_SETSIZE)
+        CPU_SET (cpu, &set);
+    }
+  const int ret = pthread_setaffinity_np (pthread_self (), sizeof (set), &set);
+  if (ret != 0)
+    {
+      z_warning ("failed to set thread affinity: {}", strerror (ret));
+      return false;
+    }
+  return true;
+#elif defined(_WIN32)
+  DWORD_PTR mask = 0;
+  for (const auto cpu : cpus)
+    {
+      if (cpu < static_cast<int> (sizeof (DWORD_PTR) * 8))
+        mask |= DWORD_PTR{ 1 } << cpu;
+    }
+  if (mask == 0 || SetThreadAffinityMask (GetCurrentThread (), mask) == 0)
+    {
+      z_warning ("failed to set thread affinity");
+      return false;
+    }
+  return true;
+#else
+  return false;
+#endif
+}
+
+std::vector<NumaNode>
+get_numa_nodes ()
+{
+#ifdef __linux__
+  const auto online =
+    parse_cpu_list (read_sysfs_file ("/sys/devices/system/node/online"));
+  std::vector<NumaNode> ret;
+  for (const auto id : online)
+    {
+      auto cpus = parse_cpu_list (read_sysfs_file (
+        "/sys/devices/system/node/node" + std::to_string (id) + "/cpulist"));
+
+      /* skip memory-only nodes (e.g., CXL memory expanders) */
+      if (!cpus.empty ())
+        ret.push_back (NumaNode{ .id_ = id, .cpus_ = std::move (cpus) });
+    }
+  return ret;
+#else
+  return {};
+#endif
+}
+
+int
+get_numa_node_of_cpu (int cpu, std::span<const NumaNode> nodes)
+{
+  const auto it = std::ranges::find_if (nodes, [cpu] (const auto &node) {
+    return std::ranges::binary_search (node.cpus_, cpu);
+  });
+  return it != nodes.end () ? it->id_ : -1;
+}
+
+bool
+bind_memory_to_numa_node (void * data, size_t size, int numa_node)
+{
+#ifdef __linux__
+  /* the kernel only looks at the first maxnode - 1 bits of the mask */
+  constexpr int max_node = sizeof (unsigned long) * 8;
+  if (numa_node < 0 || numa_node >= max_node - 1)
+    return false;
+
+  const auto page_size = static_cast<uintptr_t> (sysconf (_SC_PAGESIZE));
+  const auto begin = reinterpret_cast<uintptr_t> (data);
+  const auto first_page = (begin + page_size - 1) / page_size * page_size;
+  const auto last_page = (begin + size) / page_size * page_size;
+  if (last_page <= first_page)
+    return false;
+
+  /* preferred rather than bound so that allocations fall back to other
+   * nodes if this one runs out of memory */
+  const unsigned long nodemask = 1UL << numa_node;
+  if (
+    syscall (
+      SYS_mbind, first_page, last_page - first_page, MPOL_PREFERRED, &nodemask,
+      max_node, MPOL_MF_MOVE)
+    != 0)
+    {
+      z_warning (
+        "failed to bind memory to NUMA node {}: {}", numa_node,
+        strerror (errno));
+      return false;
+    }
+  return true;
+#else
+  return false;
+#endif
+}
+
+}; // namespace zrythm::utils::cpu
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+#include <vector>
+
+/**
+ * @addtogroup utils
+ *
+ * @{
+ */
+
+namespace zrythm::utils::cpu
+{
+
+/**
+ * @brief Parses a CPU list in the Linux sysfs/cpuset format (e.g. "0-3,8").
+ *
+ * @return The sorted list of CPU indices, without duplicates. Empty if the
+ * string is empty or malformed.
+ */
+std::vector<int>
+parse_cpu_list (std::string_view str);
+
+/**
+ * @brief Returns the CPUs isolated from the scheduler (isolcpus) by the
+ * kernel, if any.
+ *
+ * Always empty on platforms other than Linux.
+ */
+std::vector<int>
+get_isolated_cpus ();
+
+/**
+ * @brief Returns the performance cores on hybrid CPUs (Intel P-cores, ARM
+ * big cores).
+ *
+ * Empty if all online cores are of the same type or the topology can't be
+ * determined.
+ */
+std::vector<int>
+get_performance_cpus ();
+
+/**
+ * @brief Restricts the calling thread to the given CPUs.
+ *
+ * @return Whether the affinity was set. Always false on platforms where
+ * affinity is not supported (macOS).
+ */
+bool
+set_current_thread_affinity (std::span<const int> cpus);
+
+/**
+ * @brief A NUMA node and its CPUs.
+ */
+struct NumaNode
+{
+  int id_ = 0;
+
+  /** Sorted CPU indices. */
+  std::vector<int> cpus_;
+};
+
+/**
+ * @brief Returns the NUMA nodes that have CPUs, sorted by ID.
+ *
+ * Empty on platforms other than Linux or if the topology can't be determined.
+ */
+std::vector<NumaNode>
+get_numa_nodes ();
+
+/**
+ * @brief Returns the ID of the node in @p nodes that @p cpu belongs to, or -1.
+ */
+int
+get_numa_node_of_cpu (int cpu, std::span<const NumaNode> nodes);
+
+/**
+ * @brief Moves the memory in the given range to @p numa_node, and makes the
+ * kernel allocate the pages that weren't touched yet there.
+ *
+ * Only the pages that lie entirely within the range are moved, since the
+ * others are shared with neighboring memory.
+ *
+ * @return Whether the memory was bound. Always false on platforms other than
+ * Linux.
+ */
+bool
+bind_memory_to_numa_node (void * data, size_t size, int numa_node);
+
+}; // namespace zrythm::utils::cpu
+
+/**
+ * @}
+ */
@@ -0,0 +1,184 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <array>
+#include <cstring>
+
+#include "utils/decoded_audio_cache.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+
+namespace zrythm::utils::audio
+{
+
+namespace
+{
+
+constexpr std::array<char, 8> MAGIC = {
+  'Z', 'R', 'D', 'E', 'C', 'A', 'U', 'D'
+};
+constexpr uint32_t VERSION = 1;
+
+/** Size of the header (the frames start right after). */
+constexpr size_t HEADER_SIZE = 64;
+
+/**
+ * Frames per channel are padded to a multiple of this so that each channel
+ * starts at a 64-byte boundary.
+ */
+constexpr uint64_t CHANNEL_ALIGNMENT_FRAMES = 64 / sizeof (sample_t);
+
+struct Header
+{
+  std::array<char, 8> magic;
+  uint32_t            version;
+  uint32_t            num_channels;
+  uint64_t            num_frames;
+
+  /** Number of frames between the starts of 2 consecutive channels. */
+  uint64_t channel_stride;
+
+  uint64_t source_hash;
+  uint32_t samplerate;
+};
+static_assert (sizeof (Header) <= HEADER_SIZE);
+
+uint64_t
+get_channel_stride (uint64_t num_frames)
+{
+  return (num_frames + CHANNEL_ALIGNMENT_FRAMES - 1) / CHANNEL_ALIGNMENT_FRAMES
+         * CHANNEL_ALIGNMENT_FRAMES;
+}
+
+} // namespace
+
+void
+DecodedAudioCache::write (
+  const fs::path    &path,
+  const AudioBuffer &frames,
+  sample_rate_t      samplerate,
+  hash::HashT        source_hash)
+{
+  juce::File file (path.string ());
+  if (auto res = file.getParentDirectory ().createDirectory (); res.failed ())
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to create directory for '{}': {}", path,
+        res.getErrorMessage ().toStdString ()));
+    }
+
+  const auto num_frames = static_cast<uint64_t> (frames.getNumSamples ());
+  Header     header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.num_channels = static_cast<uint32_t> (frames.getNumChannels ());
+  header.num_frames = num_frames;
+  header.channel_stride = get_channel_stride (num_frames);
+  header.source_hash = source_hash;
+  header.samplerate = samplerate;
+
+  std::array<char, HEADER_SIZE> header_bytes{};
+  std::memcpy (header_bytes.data (), &header, sizeof (header));
+
+  /* write to a temporary file first so that a partial file is never used */
+  juce::TemporaryFile temp_file (file);
+  {
+    juce::FileOutputStream out (temp_file.getFile ());
+    if (out.failedToOpen ())
+      {
+        throw ZrythmException (
+          fmt::format ("Failed to open '{}' for writing", path));
+      }
+
+    const std::vector<sample_t> padding (
+      header.channel_stride - num_frames, 0.f);
+    bool ok = out.write (header_bytes.data (), header_bytes.size ());
+    for (int ch = 0; ch < frames.getNumChannels () && ok; ++ch)
+      {
+        ok =
+          out.write (frames.getReadPointer (ch), num_frames * sizeof (sample_t))
+          && (padding.empty ()
+              || out.write (
+                padding.data (), padding.size () * sizeof (sample_t)));
+      }
+    out.flush ();
+    if (!ok || out.getStatus ().failed ())
+      {
+        throw ZrythmException (fmt::format ("Failed to write '{}'", path));
+      }
+  }
+
+  if (!temp_file.overwriteTargetFileWithTemporary ())
+    {
+      throw ZrythmException (fmt::format ("Failed to replace '{}'", path));
+    }
+}
+
+std::unique_ptr<DecodedAudioCache>
+DecodedAudioCache::open (
+  const fs::path &path,
+  sample_rate_t   samplerate,
+  hash::HashT     source_hash)
+{
+  juce::File file (path.string ());
+  if (!file.existsAsFile ())
+    return nullptr;
+
+  auto mapped_file = std::make_unique<juce::MemoryMappedFile> (
+    file, juce::MemoryMappedFile::readOnly);
+  const auto * data = static_cast<const char *> (mapped_file->getData ());
+  const auto   size = mapped_file->getSize ();
+  if (data == nullptr || size < HEADER_SIZE)
+    {
+      z_warning ("Failed to map decoded audio cache '{}'", path);
+      return nullptr;
+    }
+
+  Header header{};
+  std::memcpy (&header, data, sizeof (header));
+  if (
+    header.magic != MAGIC || header.version != VERSION
+    || header.num_channels == 0
+    || header.channel_stride != get_channel_stride (header.num_frames))
+    {
+      z_warning ("Invalid decoded audio cache '{}'", path);
+      return nullptr;
+    }
+  if (header.samplerate != samplerate || header.source_hash != source_hash)
+    {
+      z_debug ("Decoded audio cache '{}' is stale", path);
+      return nullptr;
+    }
+  if (
+    size
+    < HEADER_SIZE
+        + header.num_channels * header.channel_stride * sizeof (sample_t))
+    {
+      z_warning ("Truncated decoded audio cache '{}'", path);
+      return nullptr;
+    }
+
+  auto cache = std::unique_ptr<DecodedAudioCache> (new DecodedAudioCache ());
+  cache->num_channels_ = static_cast<int> (header.num_channels);
+  cache->num_frames_ = static_cast<int64_t> (header.num_frames);
+  for (uint32_t ch = 0; ch < header.num_channels; ++ch)
+    {
+      /* the pointers are non-const only because juce::AudioBuffer needs it */
+      cache->channel_ptrs_.push_back (
+        const_cast<sample_t *> (reinterpret_cast<const sample_t *> (
+          data + HEADER_SIZE
+          + ch * header.channel_stride * sizeof (sample_t))));
+    }
+  cache->mapped_file_ = std::move (mapped_file);
+  return cache;
+}
+
+AudioBuffer
+DecodedAudioCache::get_frames () const
+{
+  return {
+    channel_ptrs_.data (), num_channels_, static_cast<int> (num_frames_)
+  };
+}
+
+} // namespace zrythm::utils::audio
@@ -0,0 +1,80 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_DECODED_AUDIO_CACHE_H__
+#define __UTILS_DECODED_AUDIO_CACHE_H__
+
+#include <memory>
+#include <vector>
+
+#include "utils/audio.h"
+#include "utils/hash.h"
+#include "utils/types.h"
+
+#include "juce_wrapper.h"
+
+namespace zrythm::utils::audio
+{
+
+/**
+ * @brief Memory-mapped cache of the decoded frames of an audio file.
+ *
+ * The cache file stores the frames as planar 32-bit floats (in native byte
+ * order), so opening it does not need any decoding and the OS can page the
+ * frames in and out as needed.
+ *
+ * Each cache file records the hash of the source file and the sample rate it
+ * was decoded to, and open() ignores it if they don't match.
+ */
+class DecodedAudioCache
+{
+public:
+  /**
+   * @brief Writes @p frames to a new cache file at @p path (atomically),
+   * creating the parent directory if needed.
+   *
+   * @param samplerate Sample rate of @p frames.
+   * @param source_hash Hash of the file @p frames were decoded from.
+   * @throw ZrythmException on error.
+   */
+  static void write (
+    const fs::path    &path,
+    const AudioBuffer &frames,
+    sample_rate_t      samplerate,
+    hash::HashT        source_hash);
+
+  /**
+   * @brief Maps the cache file at @p path.
+   *
+   * @return The cache, or nullptr if the file doesn't exist, is invalid or
+   * doesn't match @p samplerate and @p source_hash.
+   */
+  static std::unique_ptr<DecodedAudioCache> open (
+    const fs::path &path,
+    sample_rate_t   samplerate,
+    hash::HashT     source_hash);
+
+  int     get_num_channels () const { return num_channels_; }
+  int64_t get_num_frames () const { return num_frames_; }
+
+  /**
+   * @brief Returns a buffer that refers to the mapped frames.
+   *
+   * The buffer must not be written to (the mapping is read-only) or outlive
+   * this cache.
+   */
+  AudioBuffer get_frames () const;
+
+private:
+  DecodedAudioCache () = default;
+
+private:
+  std::unique_ptr<juce::MemoryMappedFile> mapped_file_;
+  int                                     num_channels_ = 0;
+  int64_t                                 num_frames_ = 0;
+  std::vector<sample_t *>                 channel_ptrs_;
+};
+
+} // namespace zrythm::utils::audio
+
+#endif // __UTILS_DECODED_AUDIO_CACHE_H__
@@ -3,12 +3,240 @@
 
 #include "zrythm-config.h"
 
+#include <algorithm>
+
 #include "utils/dsp.h"
 #include "utils/math.h"
 
 namespace zrythm::utils::float_ranges
 {
 
+namespace detail
+{
+
+constexpr Kernels scalar_kernels = {
+  .backend = SimdBackend::Scalar,
+  .fill = [] (float * buf, float val, size_t size) {
+    fill (buf, val, size, false);
+  },
+  .copy = [] (float * dest, const float * src, size_t size) {
+    copy (dest, src, size, false);
+  },
+  .add2 = [] (float * dest, const float * src, size_t size) {
+    add2 (dest, src, size, false);
+  },
+  .mix_product =
+    [] (float * dest, const float * src, float k, size_t size) {
+      mix_product (dest, src, k, size, false);
+    },
+  .mul_k2 = [] (float * dest, float k, size_t size) {
+    mul_k2 (dest, k, size, false);
+  },
+  .mul2 = [] (float * dest, const float * src, size_t size) {
+    mul2 (dest, src, size, false);
+  },
+  .abs_max = [] (const float * buf, size_t size) {
+    return size > 0 ? abs_max (buf, size, false) : 0.f;
+  },
+  .clip = [] (float * buf, float minf, float maxf, size_t size) {
+    clip (buf, minf, maxf, size, false);
+  },
+  .make_mono = [] (float * l, float * r, float k, size_t size) {
+    for (size_t i = 0; i < size; i++)
+      {
+        l[i] = (l[i] + r[i]) * k;
+        r[i] = l[i];
+      }
+  },
+  .mul_ramp =
+    [] (
+      float * dest, float base, float scale, float first_index,
+      float index_step, size_t size) {
+      for (size_t i = 0; i < size; i++)
+        {
+          const float index =
+            first_index + index_step * static_cast<float> (i);
+          dest[i] *= base + scale * index;
+        }
+    },
+  .stereo_gain =
+    [] (
+      float * dest_l, float * dest_r, const float * src_l, const float * src_r,
+      const float * gains_l, const float * gains_r, float mono_k, float limit,
+      size_t size) {
+      for (size_t i = 0; i < size; i++)
+        {
+          float l = src_l[i] * gains_l[i];
+          float r = src_r[i] * gains_r[i];
+          if (mono_k != 0.f)
+            {
+              l = (l + r) * mono_k;
+              r = l;
+            }
+          if (limit > 0.f)
+            {
+              l = std::clamp (l, -limit, limit);
+              r = std::clamp (r, -limit, limit);
+            }
+          dest_l[i] = l;
+          dest_r[i] = r;
+        }
+    },
+};
+
+constexpr Kernels baseline_kernels = {
+  .backend = SimdBackend::Baseline,
+  .fill = [] (float * buf, float val, size_t size) {
+    juce::FloatVectorOperations::fill (buf, val, size);
+  },
+  .copy = [] (float * dest, const float * src, size_t size) {
+    juce::FloatVectorOperations::copy (dest, src, size);
+  },
+  .add2 = [] (float * dest, const float * src, size_t size) {
+    juce::FloatVectorOperations::add (dest, src, size);
+  },
+  .mix_product =
+    [] (float * dest, const float * src, float k, size_t size) {
+      juce::FloatVectorOperations::addWithMultiply (dest, src, k, size);
+    },
+  .mul_k2 = [] (float * dest, float k, size_t size) {
+    juce::FloatVectorOperations::multiply (dest, k, size);
+  },
+  .mul2 = [] (float * dest, const float * src, size_t size) {
+    juce::FloatVectorOperations::multiply (dest, src, size);
+  },
+  .abs_max = [] (const float * buf, size_t size) {
+    if (size == 0)
+      return 0.f;
+    auto min_and_max = juce::FloatVectorOperations::findMinAndMax (buf, size);
+    return std::max (
+      std::abs (min_and_max.getStart ()), std::abs (min_and_max.getEnd ()));
+  },
+  .clip = [] (float * buf, float minf, float maxf, size_t size) {
+    juce::FloatVectorOperations::clip (buf, buf, minf, maxf, size);
+  },
+  .make_mono = [] (float * l, float * r, float k, size_t size) {
+    juce::FloatVectorOperations::add (l, r, size);
+    juce::FloatVectorOperations::multiply (l, k, size);
+    juce::FloatVectorOperations::copy (r, l, size);
+  },
+  /* no JUCE equivalent, the compiler vectorizes this with the baseline
+   * instruction set */
+  .mul_ramp = scalar_kernels.mul_ramp,
+  .stereo_gain = scalar_kernels.stereo_gain,
+};
+
+namespace
+{
+
+const Kernels &
+detect_best_kernels ()
+{
+#ifdef ZRYTHM_HAVE_AVX512_KERNELS
+  if (juce::SystemStats::hasAVX512F ())
+    return avx512_kernels;
+#endif
+#ifdef ZRYTHM_HAVE_AVX2_KERNELS
+  if (juce::SystemStats::hasAVX2 () && juce::SystemStats::hasFMA3 ())
+    return avx2_kernels;
+#endif
+  return baseline_kernels;
+}
+
+const Kernels *
+get_kernels_for_backend (SimdBackend backend)
+{
+  switch (backend)
+    {
+    case SimdBackend::Scalar:
+      return &scalar_kernels;
+    case SimdBackend::Baseline:
+      return &baseline_kernels;
+#ifdef ZRYTHM_HAVE_AVX2_KERNELS
+    case SimdBackend::Avx2:
+      if (juce::SystemStats::hasAVX2 () && juce::SystemStats::hasFMA3 ())
+        return &avx2_kernels;
+      break;
+#endif
+#ifdef ZRYTHM_HAVE_AVX512_KERNELS
+    case SimdBackend::Avx512:
+      if (juce::SystemStats::hasAVX512F ())
+        return &avx512_kernels;
+      break;
+#endif
+    default:
+      break;
+    }
+  return nullptr;
+}
+
+} // namespace
+
+std::atomic<const Kernels *> &
+get_active_kernels ()
+{
+  /* the CPU is only queried once, the first time a kernel is used */
+  static std::atomic<const Kernels *> active_kernels{ &detect_best_kernels () };
+  return active_kernels;
+}
+
+} // namespace detail
+
+std::vector<SimdBackend>
+get_supported_simd_backends ()
+{
+  std::vector<SimdBackend> ret;
+  for (
+    const auto backend :
+    { SimdBackend::Scalar, SimdBackend::Baseline, SimdBackend::Avx2,
+      SimdBackend::Avx512 })
+    {
+      if (detail::get_kernels_for_backend (backend) != nullptr)
+        ret.push_back (backend);
+    }
+  return ret;
+}
+
+SimdBackend
+get_simd_backend ()
+{
+  return detail::get_kernels ().backend;
+}
+
+bool
+set_simd_backend (SimdBackend backend)
+{
+  const auto * kernels = detail::get_kernels_for_backend (backend);
+  if (kernels == nullptr)
+    return false;
+
+  detail::get_active_kernels ().store (kernels);
+  return true;
+}
+
+std::string_view
+simd_backend_to_string (SimdBackend backend)
+{
+  switch (backend)
+    {
+    case SimdBackend::Scalar:
+      return "Scalar";
+    case SimdBackend::Baseline:
+#if JUCE_USE_ARM_NEON
+      return "NEON";
+#elif JUCE_USE_SSE_INTRINSICS
+      return "SSE2";
+#else
+      return "Baseline";
+#endif
+    case SimdBackend::Avx2:
+      return "AVX2";
+    case SimdBackend::Avx512:
+      return "AVX-512";
+    }
+  return "";
+}
+
 /**
  * Calculate linear fade by multiplying from 0 to 1 for
  * @param total_frames_to_fade samples.
@@ -31,15 +259,11 @@ linear_fade_in_from (
   size_t  size,
   float   fade_from_multiplier)
 {
-  // TODO check juce::AudioSampleBuffer::applyGainRamp ()
-
-  for (size_t i = 0; i < size; ++i)
-    {
-      float k =
-        (float) (i + (size_t) start_offset) / (float) (total_frames_to_fade - 1);
-      k = fade_from_multiplier + (1.f - fade_from_multiplier) * k;
-      dest[i] *= k;
-    }
+  /* k[i] = from + (1 - from) * (start_offset + i) / (total - 1) */
+  const float scale =
+    (1.f - fade_from_multiplier) / (float) (total_frames_to_fade - 1);
+  detail::get_kernels ().mul_ramp (
+    dest, fade_from_multiplier, scale, (float) start_offset, 1.f, size);
 }
 
 /**
@@ -61,16 +285,12 @@ linear_fade_out_to (
   size_t  size,
   float   fade_to_multiplier)
 {
-  // TODO check juce::AudioSampleBuffer::applyGainRamp ()
-
-  for (size_t i = 0; i < size; i++)
-    {
-      float k =
-        (float) (total_frames_to_fade - (i + (size_t) start_offset) - 1)
-        / (float) (total_frames_to_fade - 1);
-      k = fade_to_multiplier + (1.f - fade_to_multiplier) * k;
-      dest[i] *= k;
-    }
+  /* k[i] = to + (1 - to) * (total - start_offset - 1 - i) / (total - 1) */
+  const float scale =
+    (1.f - fade_to_multiplier) / (float) (total_frames_to_fade - 1);
+  detail::get_kernels ().mul_ramp (
+    dest, fade_to_multiplier, scale,
+    (float) (total_frames_to_fade - start_offset - 1), -1.f, size);
 }
 
 /**
@@ -88,9 +308,16 @@ void
 make_mono (float * l, float * r, size_t size, bool equal_power, bool optimize)
 {
   float multiple = equal_power ? 0.7079f : 0.5f;
-  add2 (l, r, size, optimize);
-  mul_k2 (l, multiple, size, optimize);
-  copy (r, l, size, optimize);
+  if (optimize)
+    {
+      detail::get_kernels ().make_mono (l, r, multiple, size);
+    }
+  else
+    {
+      add2 (l, r, size, false);
+      mul_k2 (l, multiple, size, false);
+      copy (r, l, size, false);
+    }
 }
 
 }; // zrythm::dsp::float_ranges
@@ -15,12 +15,59 @@
 
 #include "zrythm-config.h"
 
+#include <atomic>
+#include <string_view>
+#include <vector>
+
 #include "juce_wrapper.h"
+#include "utils/dsp_kernels.h"
 #include "utils/math.h"
 
 namespace zrythm::utils::float_ranges
 {
 
+namespace detail
+{
+/**
+ * @brief Returns the kernels in use (the best ones supported by the CPU,
+ * unless overridden by set_simd_backend()).
+ */
+std::atomic<const Kernels *> &
+get_active_kernels ();
+
+[[gnu::hot]] static inline const Kernels &
+get_kernels ()
+{
+  return *get_active_kernels ().load (std::memory_order_relaxed);
+}
+} // namespace detail
+
+/**
+ * @brief Returns the SIMD backends supported by this build and CPU, from the
+ * slowest to the fastest.
+ */
+std::vector<SimdBackend>
+get_supported_simd_backends ();
+
+/**
+ * @brief Returns the SIMD backend used by the functions below when
+ * `optimized` is true.
+ */
+SimdBackend
+get_simd_backend ();
+
+/**
+ * @brief Overrides the SIMD backend detected at startup (e.g., to compare
+ * backends in benchmarks).
+ *
+ * @return Whether @p backend is supported (otherwise nothing is changed).
+ */
+bool
+set_simd_backend (SimdBackend backend);
+
+std::string_view
+simd_backend_to_string (SimdBackend backend);
+
 /**
  * Fill the buffer with the given value.
  */
@@ -29,7 +76,7 @@ fill (float * buf, float val, size_t size, bool optimized = true)
 {
   if (optimized)
     {
-      juce::FloatVectorOperations::fill (buf, val, size);
+      detail::get_kernels ().fill (buf, val, size);
     }
   else
     {
@@ -45,7 +92,7 @@ clip (float * buf, float minf, float maxf, size_t size, bool optimized = true)
 {
   if (optimized)
     {
-      juce::FloatVectorOperations::clip (buf, buf, minf, maxf, size);
+      detail::get_kernels ().clip (buf, minf, maxf, size);
     }
   else
     {
@@ -63,7 +110,7 @@ copy (float * dest, const float * src, size_t size, bool optimized = true)
 {
   if (optimized)
     {
-      juce::FloatVectorOperations::copy (dest, src, size);
+      detail::get_kernels ().copy (dest, src, size);
     }
   else
     {
@@ -79,7 +126,7 @@ mul_k2 (float * dest, float k, size_t size, bool optimized = true)
 {
   if (optimized)
     {
-      juce::FloatVectorOperations::multiply (dest, k, size);
+      detail::get_kernels ().mul_k2 (dest, k, size);
     }
   else
     {
@@ -87,6 +134,22 @@ mul_k2 (float * dest, float k, size_t size, bool optimized = true)
     }
 }
 
+/**
+ * Multiply: dst[i] = dst[i] * src[i].
+ */
+[[using gnu: nonnull, hot]] static inline void
+mul2 (float * dest, const float * src, size_t size, bool optimized = true)
+{
+  if (optimized)
+    {
+      detail::get_kernels ().mul2 (dest, src, size);
+    }
+  else
+    {
+      std::transform (dest, dest + size, src, dest, std::multiplies<> ());
+    }
+}
+
 /**
  * Gets the maximum absolute value of the buffer (as amplitude).
  */
@@ -95,9 +158,7 @@ abs_max (const float * buf, size_t size, bool optimized = true)
 {
   if (optimized)
     {
-      auto min_and_max = juce::FloatVectorOperations::findMinAndMax (buf, size);
-      return std::max (
-        std::abs (min_and_max.getStart ()), std::abs (min_and_max.getEnd ()));
+      return detail::get_kernels ().abs_max (buf, size);
     }
 
   return std::abs (*std::max_element (buf, buf + size, [] (float a, float b) {
@@ -105,6 +166,40 @@ abs_max (const float * buf, size_t size, bool optimized = true)
   }));
 }
 
+/**
+ * @brief Returns whether all values in the buffer are within ±@p threshold.
+ *
+ * Stops at the first block containing a louder value, so this is cheap for
+ * buffers that are not silent.
+ */
+[[nodiscard]] [[using gnu: nonnull, hot]] static inline bool
+is_silent (const float * buf, size_t size, float threshold)
+{
+  /* check in blocks so that the inner loop can be vectorized */
+  constexpr size_t block_size = 16;
+  size_t           i = 0;
+  for (; i + block_size <= size; i += block_size)
+    {
+      float block_max = 0.f;
+      for (size_t j = 0; j < block_size; j++)
+        {
+          block_max = std::max (block_max, std::abs (buf[i + j]));
+        }
+      if (block_max > threshold)
+        {
+          return false;
+        }
+    }
+  for (; i < size; i++)
+    {
+      if (std::abs (buf[i]) > threshold)
+        {
+          return false;
+        }
+    }
+  return true;
+}
+
 /**
  * Gets the absolute max of the buffer.
  *
@@ -181,7 +276,7 @@ add2 (float * dest, const float * src, size_t count, bool optimized = true)
 {
   if (optimized)
     {
-      juce::FloatVectorOperations::add (dest, src, count);
+      detail::get_kernels ().add2 (dest, src, count);
     }
   else
     {
@@ -202,7 +297,7 @@ mix_product (
 {
   if (optimized)
     {
-      juce::FloatVectorOperations::addWithMultiply (dest, src, k, size);
+      detail::get_kernels ().mix_product (dest, src, k, size);
     }
   else
     {
@@ -212,6 +307,139 @@ mix_product (
     }
 }
 
+namespace detail
+{
+
+/**
+ * @brief Calculates dest[i] = op (dest[i], src[i]) and returns the maximum
+ * absolute value of the results.
+ *
+ * Works in blocks so that the inner loop can be vectorized.
+ */
+template <typename Op>
+[[using gnu: nonnull, hot]] static inline float
+transform_with_peak (float * dest, const float * src, size_t size, Op op)
+{
+  constexpr size_t block_size = 16;
+  float            peak = 0.f;
+  size_t           i = 0;
+  for (; i + block_size <= size; i += block_size)
+    {
+      float block_peak = 0.f;
+      for (size_t j = 0; j < block_size; j++)
+        {
+          const float val = op (dest[i + j], src[i + j]);
+          dest[i + j] = val;
+          block_peak = std::max (block_peak, std::abs (val));
+        }
+      peak = std::max (peak, block_peak);
+    }
+  for (; i < size; i++)
+    {
+      dest[i] = op (dest[i], src[i]);
+      peak = std::max (peak, std::abs (dest[i]));
+    }
+  return peak;
+}
+
+} // namespace detail
+
+/**
+ * @brief Calculate dest[i] = dest[i] + src[i] and return the maximum absolute
+ * value of the result, in a single pass.
+ */
+[[nodiscard]] [[using gnu: nonnull, hot]] static inline float
+add2_with_peak (
+  float *       dest,
+  const float * src,
+  size_t        size,
+  bool          optimized = true)
+{
+  if (!optimized)
+    {
+      add2 (dest, src, size, false);
+      return size > 0 ? abs_max (dest, size, false) : 0.f;
+    }
+
+  return detail::transform_with_peak (
+    dest, src, size, [] (float x, float y) { return x + y; });
+}
+
+/**
+ * @brief Calculate dest[i] = dest[i] + src[i] * k and return the maximum
+ * absolute value of the result, in a single pass.
+ */
+[[nodiscard]] [[using gnu: nonnull, hot]] static inline float
+mix_product_with_peak (
+  float *       dest,
+  const float * src,
+  float         k,
+  size_t        size,
+  bool          optimized = true)
+{
+  if (!optimized)
+    {
+      mix_product (dest, src, k, size, false);
+      return size > 0 ? abs_max (dest, size, false) : 0.f;
+    }
+
+  return detail::transform_with_peak (
+    dest, src, size, [k] (float x, float y) { return x + y * k; });
+}
+
+/**
+ * @brief Calculate dest[i] = clamp (dest[i] + src[i], minf, maxf) in a single
+ * pass.
+ */
+[[using gnu: nonnull, hot]] static inline void
+add2_clamped (
+  float *       dest,
+  const float * src,
+  float         minf,
+  float         maxf,
+  size_t        size,
+  bool          optimized = true)
+{
+  if (!optimized)
+    {
+      add2 (dest, src, size, false);
+      clip (dest, minf, maxf, size, false);
+      return;
+    }
+
+  std::transform (
+    dest, dest + size, src, dest, [minf, maxf] (float x, float y) {
+      return std::clamp (x + y, minf, maxf);
+    });
+}
+
+/**
+ * @brief Calculate dest[i] = clamp (dest[i] + src[i] * k, minf, maxf) in a
+ * single pass.
+ */
+[[using gnu: nonnull, hot]] static inline void
+mix_product_clamped (
+  float *       dest,
+  const float * src,
+  float         k,
+  float         minf,
+  float         maxf,
+  size_t        size,
+  bool          optimized = true)
+{
+  if (!optimized)
+    {
+      mix_product (dest, src, k, size, false);
+      clip (dest, minf, maxf, size, false);
+      return;
+    }
+
+  std::transform (
+    dest, dest + size, src, dest, [k, minf, maxf] (float x, float y) {
+      return std::clamp (x + y * k, minf, maxf);
+    });
+}
+
 /**
  * Reverse the order of samples: dst[i] <=> src[count - i - 1].
  */
@@ -293,6 +521,35 @@ make_mono (
   bool    equal_power,
   bool    optimize = true);
 
+/**
+ * @brief Applies per-frame gains to a stereo signal and optionally sums it to
+ * mono and clips it, in a single pass.
+ *
+ * The sources may be the destinations.
+ *
+ * @param mono_k Multiplier of the sum of the channels when summing to mono
+ * (see make_mono()), or 0 to keep the signal stereo.
+ * @param limit Absolute value to clip the output to, or 0 to not clip.
+ */
+[[using gnu: nonnull, hot]] static inline void
+stereo_gain (
+  float *       dest_l,
+  float *       dest_r,
+  const float * src_l,
+  const float * src_r,
+  const float * gains_l,
+  const float * gains_r,
+  float         mono_k,
+  float         limit,
+  size_t        size,
+  bool          optimized = true)
+{
+  const auto &kernels =
+    optimized ? detail::get_kernels () : detail::scalar_kernels;
+  kernels.stereo_gain (
+    dest_l, dest_r, src_l, src_r, gains_l, gains_r, mono_k, limit, size);
+}
+
 }; // zrythm::dsp::float_ranges
 
 #endif
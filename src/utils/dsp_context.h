@@ -9,19 +9,21 @@
 #include "juce_wrapper.h"
 
 /**
- * RAII class for managing a DSP context (disabling denormals, etc.).
+ * RAII class for managing a DSP context on the current thread.
  *
- * The DSP context is only started and finished if the
- * `ZRYTHM_USE_OPTIMIZED_DSP` macro is defined.
+ * Enables flush-to-zero and denormals-are-zero (MXCSR on x86, FPCR on ARM)
+ * while in scope, so that denormal numbers (e.g., in reverb tails) don't
+ * slow down processing, and restores the previous state afterwards.
+ *
+ * This is realtime-safe and should be used on all realtime threads.
  */
 class DspContextRAII
 {
 public:
-  DspContextRAII ();
-  ~DspContextRAII ();
+  DspContextRAII () = default;
 
 private:
-  std::unique_ptr<juce::ScopedNoDenormals> ctx_;
+  juce::ScopedNoDenormals no_denormals_;
 };
 
-#endif // __UTILS_DSP_CONTEXT_H__
\ No newline at end of file
+#endif // __UTILS_DSP_CONTEXT_H__
@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * @file
+ *
+ * Backends for the vectorized functions in utils/dsp.h.
+ *
+ * @note This header is also included by translation units compiled with
+ * extra instruction sets enabled, so it must only contain declarations.
+ */
+
+#pragma once
+
+#include <cstddef>
+
+namespace zrythm::utils::float_ranges
+{
+
+/**
+ * @brief Instruction set used by the vectorized functions.
+ */
+enum class SimdBackend
+{
+  /** Plain C++ loops. */
+  Scalar,
+
+  /**
+   * JUCE's vector operations (SSE2 on x86-64, NEON on ARM), available on all
+   * CPUs of the target architecture.
+   */
+  Baseline,
+
+  /** AVX2 + FMA (x86-64 only). */
+  Avx2,
+
+  /** AVX-512F (x86-64 only). */
+  Avx512,
+};
+
+/**
+ * @brief Table of kernels implemented by a SimdBackend.
+ *
+ * All kernels accept a @p size of 0.
+ */
+struct Kernels
+{
+  SimdBackend backend;
+
+  void (*fill) (float * buf, float val, size_t size);
+  void (*copy) (float * dest, const float * src, size_t size);
+  void (*add2) (float * dest, const float * src, size_t size);
+  void (*mix_product) (float * dest, const float * src, float k, size_t size);
+  void (*mul_k2) (float * dest, float k, size_t size);
+  void (*mul2) (float * dest, const float * src, size_t size);
+  float (*abs_max) (const float * buf, size_t size);
+  void (*clip) (float * buf, float minf, float maxf, size_t size);
+
+  /** l[i] = r[i] = (l[i] + r[i]) * k. */
+  void (*make_mono) (float * l, float * r, float k, size_t size);
+
+  /**
+   * dest[i] = dest[i] * (base + scale * (first_index + index_step * i)).
+   *
+   * The index is kept separate so that the ends of a ramp are exact.
+   */
+  void (*mul_ramp) (
+    float * dest,
+    float   base,
+    float   scale,
+    float   first_index,
+    float   index_step,
+    size_t  size);
+
+  /**
+   * dest_l[i] = src_l[i] * gains_l[i] and dest_r[i] = src_r[i] * gains_r[i],
+   * then, if @p mono_k is not 0, both become (dest_l[i] + dest_r[i]) * mono_k,
+   * then, if @p limit is greater than 0, both are clipped to
+   * [-limit, limit].
+   *
+   * The sources may be the destinations.
+   */
+  void (*stereo_gain) (
+    float *       dest_l,
+    float *       dest_r,
+    const float * src_l,
+    const float * src_r,
+    const float * gains_l,
+    const float * gains_r,
+    float         mono_k,
+    float         limit,
+    size_t        size);
+};
+
+namespace detail
+{
+extern const Kernels scalar_kernels;
+extern const Kernels baseline_kernels;
+#ifdef ZRYTHM_HAVE_AVX2_KERNELS
+extern const Kernels avx2_kernels;
+#endif
+#ifdef ZRYTHM_HAVE_AVX512_KERNELS
+extern const Kernels avx512_kernels;
+#endif
+} // namespace detail
+
+} // namespace zrythm::utils::float_ranges
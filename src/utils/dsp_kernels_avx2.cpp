@@ -0,0 +1,59 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/* compiled with AVX2 and FMA enabled - see utils/dsp_kernels_x86.h */
+
+#ifdef ZRYTHM_HAVE_AVX2_KERNELS
+
+#  include "utils/dsp_kernels_x86.h"
+
+#  include <immintrin.h>
+
+namespace zrythm::utils::float_ranges
+{
+namespace
+{
+
+struct Avx2Ops
+{
+  using Vec = __m256;
+  static constexpr size_t width = 8;
+
+  static Vec load (const float * p) { return _mm256_loadu_ps (p); }
+  static void store (float * p, Vec v) { _mm256_storeu_ps (p, v); }
+  static Vec set1 (float val) { return _mm256_set1_ps (val); }
+  static Vec add (Vec a, Vec b) { return _mm256_add_ps (a, b); }
+  static Vec mul (Vec a, Vec b) { return _mm256_mul_ps (a, b); }
+
+  /** a * b + c. */
+  static Vec fmadd (Vec a, Vec b, Vec c) { return _mm256_fmadd_ps (a, b, c); }
+  static Vec min (Vec a, Vec b) { return _mm256_min_ps (a, b); }
+  static Vec max (Vec a, Vec b) { return _mm256_max_ps (a, b); }
+  static Vec abs (Vec v) { return _mm256_andnot_ps (_mm256_set1_ps (-0.f), v); }
+
+  /** { 0, 1, ..., width - 1 }. */
+  static Vec iota ()
+  {
+    return _mm256_setr_ps (0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f);
+  }
+
+  static float reduce_max (Vec v)
+  {
+    __m128 m =
+      _mm_max_ps (_mm256_castps256_ps128 (v), _mm256_extractf128_ps (v, 1));
+    m = _mm_max_ps (m, _mm_movehl_ps (m, m));
+    m = _mm_max_ss (m, _mm_shuffle_ps (m, m, 1));
+    return _mm_cvtss_f32 (m);
+  }
+};
+
+} // namespace
+
+namespace detail
+{
+constexpr Kernels avx2_kernels = make_kernels<Avx2Ops> (SimdBackend::Avx2);
+}
+
+} // namespace zrythm::utils::float_ranges
+
+#endif // ZRYTHM_HAVE_AVX2_KERNELS
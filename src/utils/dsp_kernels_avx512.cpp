@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/* compiled with AVX-512F enabled - see utils/dsp_kernels_x86.h */
+
+#ifdef ZRYTHM_HAVE_AVX512_KERNELS
+
+#  include "utils/dsp_kernels_x86.h"
+
+#  include <immintrin.h>
+
+namespace zrythm::utils::float_ranges
+{
+namespace
+{
+
+struct Avx512Ops
+{
+  using Vec = __m512;
+  static constexpr size_t width = 16;
+
+  static Vec load (const float * p) { return _mm512_loadu_ps (p); }
+  static void store (float * p, Vec v) { _mm512_storeu_ps (p, v); }
+  static Vec set1 (float val) { return _mm512_set1_ps (val); }
+  static Vec add (Vec a, Vec b) { return _mm512_add_ps (a, b); }
+  static Vec mul (Vec a, Vec b) { return _mm512_mul_ps (a, b); }
+
+  /** a * b + c. */
+  static Vec fmadd (Vec a, Vec b, Vec c) { return _mm512_fmadd_ps (a, b, c); }
+  static Vec min (Vec a, Vec b) { return _mm512_min_ps (a, b); }
+  static Vec max (Vec a, Vec b) { return _mm512_max_ps (a, b); }
+  static Vec abs (Vec v) { return _mm512_abs_ps (v); }
+
+  /** { 0, 1, ..., width - 1 }. */
+  static Vec iota ()
+  {
+    return _mm512_setr_ps (
+      0.f, 1.f, 2.f, 3.f, 4.f, 5.f, 6.f, 7.f, 8.f, 9.f, 10.f, 11.f, 12.f, 13.f,
+      14.f, 15.f);
+  }
+
+  static float reduce_max (Vec v) { return _mm512_reduce_max_ps (v); }
+};
+
+} // namespace
+
+namespace detail
+{
+constexpr Kernels avx512_kernels =
+  make_kernels<Avx512Ops> (SimdBackend::Avx512);
+}
+
+} // namespace zrythm::utils::float_ranges
+
+#endif // ZRYTHM_HAVE_AVX512_KERNELS
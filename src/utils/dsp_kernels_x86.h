@@ -0,0 +1,279 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * @file
+ *
+ * Kernels shared by the x86 SIMD backends, written against a set of vector
+ * operations (@p Ops) provided by each backend.
+ *
+ * @warning Only include this from the translation unit of a backend. Those
+ * are compiled with extra instruction sets enabled, so everything here has
+ * internal linkage and avoids inline functions from other headers, otherwise
+ * the linker could pick a copy using instructions the CPU doesn't support.
+ */
+
+#pragma once
+
+#include "utils/dsp_kernels.h"
+
+namespace zrythm::utils::float_ranges
+{
+namespace
+{
+
+template <typename Ops>
+void
+fill_kernel (float * buf, float val, size_t size)
+{
+  const auto v = Ops::set1 (val);
+  size_t     i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    Ops::store (&buf[i], v);
+  for (; i < size; i++)
+    buf[i] = val;
+}
+
+template <typename Ops>
+void
+copy_kernel (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    Ops::store (&dest[i], Ops::load (&src[i]));
+  for (; i < size; i++)
+    dest[i] = src[i];
+}
+
+template <typename Ops>
+void
+add2_kernel (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    Ops::store (
+      &dest[i], Ops::add (Ops::load (&dest[i]), Ops::load (&src[i])));
+  for (; i < size; i++)
+    dest[i] += src[i];
+}
+
+template <typename Ops>
+void
+mix_product_kernel (float * dest, const float * src, float k, size_t size)
+{
+  const auto vk = Ops::set1 (k);
+  size_t     i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    Ops::store (
+      &dest[i], Ops::fmadd (Ops::load (&src[i]), vk, Ops::load (&dest[i])));
+  for (; i < size; i++)
+    dest[i] += src[i] * k;
+}
+
+template <typename Ops>
+void
+mul_k2_kernel (float * dest, float k, size_t size)
+{
+  const auto vk = Ops::set1 (k);
+  size_t     i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    Ops::store (&dest[i], Ops::mul (Ops::load (&dest[i]), vk));
+  for (; i < size; i++)
+    dest[i] *= k;
+}
+
+template <typename Ops>
+void
+mul2_kernel (float * dest, const float * src, size_t size)
+{
+  size_t i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    Ops::store (
+      &dest[i], Ops::mul (Ops::load (&dest[i]), Ops::load (&src[i])));
+  for (; i < size; i++)
+    dest[i] *= src[i];
+}
+
+template <typename Ops>
+float
+abs_max_kernel (const float * buf, size_t size)
+{
+  auto   vmax = Ops::set1 (0.f);
+  size_t i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    vmax = Ops::max (vmax, Ops::abs (Ops::load (&buf[i])));
+  float ret = Ops::reduce_max (vmax);
+  for (; i < size; i++)
+    {
+      const float val = buf[i] < 0.f ? -buf[i] : buf[i];
+      ret = val > ret ? val : ret;
+    }
+  return ret;
+}
+
+template <typename Ops>
+void
+clip_kernel (float * buf, float minf, float maxf, size_t size)
+{
+  const auto vmin = Ops::set1 (minf);
+  const auto vmax = Ops::set1 (maxf);
+  size_t     i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    Ops::store (
+      &buf[i], Ops::min (Ops::max (Ops::load (&buf[i]), vmin), vmax));
+  for (; i < size; i++)
+    {
+      const float val = buf[i] < minf ? minf : buf[i];
+      buf[i] = val > maxf ? maxf : val;
+    }
+}
+
+template <typename Ops>
+void
+make_mono_kernel (float * l, float * r, float k, size_t size)
+{
+  const auto vk = Ops::set1 (k);
+  size_t     i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    {
+      const auto mono =
+        Ops::mul (Ops::add (Ops::load (&l[i]), Ops::load (&r[i])), vk);
+      Ops::store (&l[i], mono);
+      Ops::store (&r[i], mono);
+    }
+  for (; i < size; i++)
+    {
+      l[i] = (l[i] + r[i]) * k;
+      r[i] = l[i];
+    }
+}
+
+template <typename Ops>
+void
+mul_ramp_kernel (
+  float * dest,
+  float   base,
+  float   scale,
+  float   first_index,
+  float   index_step,
+  size_t  size)
+{
+  const auto vbase = Ops::set1 (base);
+  const auto vscale = Ops::set1 (scale);
+  const auto vindex_step = Ops::set1 (index_step);
+  const auto vindex_offsets = Ops::mul (Ops::iota (), vindex_step);
+  size_t     i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    {
+      /* computed from i instead of accumulated to avoid drift */
+      const auto index = Ops::add (
+        Ops::set1 (first_index + index_step * static_cast<float> (i)),
+        vindex_offsets);
+      const auto gain = Ops::fmadd (index, vscale, vbase);
+      Ops::store (&dest[i], Ops::mul (Ops::load (&dest[i]), gain));
+    }
+  for (; i < size; i++)
+    {
+      const float index = first_index + index_step * static_cast<float> (i);
+      dest[i] *= base + scale * index;
+    }
+}
+
+template <typename Ops, bool Mono, bool Limit>
+void
+stereo_gain_loop (
+  float *       dest_l,
+  float *       dest_r,
+  const float * src_l,
+  const float * src_r,
+  const float * gains_l,
+  const float * gains_r,
+  float         mono_k,
+  float         limit,
+  size_t        size)
+{
+  const auto vmono_k = Ops::set1 (mono_k);
+  const auto vmax = Ops::set1 (limit);
+  const auto vmin = Ops::set1 (-limit);
+  size_t     i = 0;
+  for (; i + Ops::width <= size; i += Ops::width)
+    {
+      auto l = Ops::mul (Ops::load (&src_l[i]), Ops::load (&gains_l[i]));
+      auto r = Ops::mul (Ops::load (&src_r[i]), Ops::load (&gains_r[i]));
+      if constexpr (Mono)
+        {
+          l = Ops::mul (Ops::add (l, r), vmono_k);
+          r = l;
+        }
+      if constexpr (Limit)
+        {
+          l = Ops::min (Ops::max (l, vmin), vmax);
+          r = Ops::min (Ops::max (r, vmin), vmax);
+        }
+      Ops::store (&dest_l[i], l);
+      Ops::store (&dest_r[i], r);
+    }
+  for (; i < size; i++)
+    {
+      float l = src_l[i] * gains_l[i];
+      float r = src_r[i] * gains_r[i];
+      if constexpr (Mono)
+        {
+          l = (l + r) * mono_k;
+          r = l;
+        }
+      if constexpr (Limit)
+        {
+          l = l < -limit ? -limit : (l > limit ? limit : l);
+          r = r < -limit ? -limit : (r > limit ? limit : r);
+        }
+      dest_l[i] = l;
+      dest_r[i] = r;
+    }
+}
+
+template <typename Ops>
+void
+stereo_gain_kernel (
+  float *       dest_l,
+  float *       dest_r,
+  const float * src_l,
+  const float * src_r,
+  const float * gains_l,
+  const float * gains_r,
+  float         mono_k,
+  float         limit,
+  size_t        size)
+{
+  const bool mono = mono_k != 0.f;
+  const bool clip = limit > 0.f;
+  const auto loop =
+    mono ? (clip ? stereo_gain_loop<Ops, true, true>
+                 : stereo_gain_loop<Ops, true, false>)
+         : (clip ? stereo_gain_loop<Ops, false, true>
+                 : stereo_gain_loop<Ops, false, false>);
+  loop (dest_l, dest_r, src_l, src_r, gains_l, gains_r, mono_k, limit, size);
+}
+
+template <typename Ops>
+constexpr Kernels
+make_kernels (SimdBackend backend)
+{
+  return {
+    .backend = backend,
+    .fill = fill_kernel<Ops>,
+    .copy = copy_kernel<Ops>,
+    .add2 = add2_kernel<Ops>,
+    .mix_product = mix_product_kernel<Ops>,
+    .mul_k2 = mul_k2_kernel<Ops>,
+    .mul2 = mul2_kernel<Ops>,
+    .abs_max = abs_max_kernel<Ops>,
+    .clip = clip_kernel<Ops>,
+    .make_mono = make_mono_kernel<Ops>,
+    .mul_ramp = mul_ramp_kernel<Ops>,
+    .stereo_gain = stereo_gain_kernel<Ops>,
+  };
+}
+
+} // namespace
+} // namespace zrythm::utils::float_ranges
@@ -0,0 +1,108 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_FIXED_SPSC_RING_H__
+#define __UTILS_FIXED_SPSC_RING_H__
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Single-producer single-consumer lock-free ring buffer with its
+ * storage inline.
+ *
+ * Unlike RingBuffer, this doesn't allocate or hold pointers, so it can be
+ * placed in memory shared between processes (the indices are lock-free
+ * atomics, which are address-free).
+ *
+ * @tparam T Element type (must be trivially copyable).
+ * @tparam Capacity Number of elements (must be a power of 2).
+ */
+template <typename T, size_t Capacity> class FixedSpscRing
+{
+  static_assert (std::is_trivially_copyable_v<T>);
+  static_assert (Capacity > 0 && (Capacity & (Capacity - 1)) == 0);
+  static_assert (std::atomic<uint64_t>::is_always_lock_free);
+
+public:
+  static constexpr size_t capacity () { return Capacity; }
+
+  /**
+   * @brief Pushes an element (producer only).
+   *
+   * @return Whether there was space for it.
+   */
+  bool push (const T &value)
+  {
+    const auto write = write_idx_.load (std::memory_order_relaxed);
+    if (write - read_idx_.load (std::memory_order_acquire) >= Capacity)
+      return false;
+
+    buf_[write & (Capacity - 1)] = value;
+    write_idx_.store (write + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops the oldest element (consumer only).
+   *
+   * @return Whether there was an element.
+   */
+  bool pop (T &value)
+  {
+    const auto read = read_idx_.load (std::memory_order_relaxed);
+    if (read == write_idx_.load (std::memory_order_acquire))
+      return false;
+
+    value = buf_[read & (Capacity - 1)];
+    read_idx_.store (read + 1, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Pops all the elements and keeps the newest one (consumer only).
+   *
+   * Useful for state where only the latest value matters.
+   *
+   * @return Whether there was an element.
+   */
+  bool pop_latest (T &value)
+  {
+    const auto read = read_idx_.load (std::memory_order_relaxed);
+    const auto write = write_idx_.load (std::memory_order_acquire);
+    if (read == write)
+      return false;
+
+    value = buf_[(write - 1) & (Capacity - 1)];
+    read_idx_.store (write, std::memory_order_release);
+    return true;
+  }
+
+  /**
+   * @brief Number of elements available to read (approximate when called
+   * from the producer).
+   */
+  size_t read_space () const
+  {
+    return static_cast<size_t> (
+      write_idx_.load (std::memory_order_acquire)
+      - read_idx_.load (std::memory_order_acquire));
+  }
+
+private:
+  /* on separate cache lines to avoid false sharing between the producer and
+   * the consumer */
+  alignas (64) std::atomic<uint64_t> write_idx_{ 0 };
+  alignas (64) std::atomic<uint64_t> read_idx_{ 0 };
+  alignas (64) std::array<T, Capacity> buf_{};
+};
+
+} // namespace zrythm::utils
+
+#endif // __UTILS_FIXED_SPSC_RING_H__
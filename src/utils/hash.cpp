@@ -1,8 +1,13 @@
 // SPDX-FileCopyrightText: © 2021-2022, 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <algorithm>
+#include <atomic>
+#include <future>
 #include <memory>
 #include <span>
+#include <thread>
+#include <vector>
 
 #include "utils/hash.h"
 #include "utils/io.h"
@@ -31,7 +36,58 @@ public:
 private:
   std::unique_ptr<XXH3_state_t, decltype (&XXH3_freeState)> state_;
 };
+
+/**
+ * Passes the bytes [offset, offset + size) of @p file to @p func, using a
+ * memory map if possible or reading them in chunks otherwise.
+ *
+ * @return Whether all the bytes were read.
+ */
+template <typename Func>
+bool
+read_file_range (QFile &file, qint64 offset, qint64 size, Func &&func)
+{
+  /* map windows instead of the whole file to not use huge amounts of
+   * address space for large files */
+  constexpr qint64 window_size = 64 * 1024 * 1024;
+  const qint64     end = offset + size;
+  for (qint64 pos = offset; pos < end; pos += window_size)
+    {
+      const qint64 len = std::min (window_size, end - pos);
+      auto *       data = file.map (pos, len);
+      if (data == nullptr)
+        break;
+
+      func (std::span<const std::byte>{
+        reinterpret_cast<const std::byte *> (data),
+        static_cast<size_t> (len) });
+      file.unmap (data);
+      offset = pos + len;
+    }
+  if (offset == end)
+    return true;
+
+  /* fall back to reading if mapping is not supported */
+  if (!file.seek (offset))
+    return false;
+
+  constexpr qint64       buf_size = 1024 * 1024;
+  std::vector<std::byte> buf (static_cast<size_t> (std::min (buf_size, size)));
+  while (offset < end)
+    {
+      const qint64 len = file.read (
+        reinterpret_cast<char *> (buf.data ()),
+        std::min (buf_size, end - offset));
+      if (len <= 0)
+        return false;
+
+      func (
+        std::span<const std::byte>{ buf.data (), static_cast<size_t> (len) });
+      offset += len;
+    }
+  return true;
 }
+} // namespace
 
 HashT
 get_file_hash (const std::filesystem::path &path)
@@ -45,18 +101,92 @@ get_file_hash (const std::filesystem::path &path)
       return 0;
     }
 
-  constexpr size_t buf_size = 16384;
-  QByteArray       buf;
-  while (!(buf = file.read (buf_size)).isEmpty ())
+  if (!read_file_range (file, 0, file.size (), [&] (auto data) {
+        hasher.update (data);
+      }))
     {
-      hasher.update (std::span<const std::byte>{
-        reinterpret_cast<const std::byte *> (buf.data ()),
-        static_cast<size_t> (buf.size ()) });
+      z_warning ("Failed to read file: {}", path.string ());
+      return 0;
     }
 
   return hasher.finalize ();
 }
 
+HashT
+get_file_hash_parallel (
+  const std::filesystem::path &path,
+  unsigned int                 num_threads)
+{
+  const auto file_path = QString::fromStdString (path.string ());
+  qint64     file_size = 0;
+  {
+    QFile file (file_path);
+    if (!file.open (QIODevice::ReadOnly))
+      {
+        z_warning ("Failed to open file: {}", path.string ());
+        return 0;
+      }
+    file_size = file.size ();
+  }
+
+  const auto num_chunks = static_cast<size_t> (std::max<qint64> (
+    (file_size + FILE_HASH_CHUNK_SIZE - 1) / FILE_HASH_CHUNK_SIZE, 1));
+  if (num_threads == 0)
+    {
+      num_threads = std::max (std::thread::hardware_concurrency (), 1u);
+    }
+  num_threads =
+    std::min (num_threads, static_cast<unsigned int> (num_chunks));
+
+  std::vector<HashT>  chunk_hashes (num_chunks);
+  std::atomic<size_t> next_chunk = 0;
+  std::atomic_bool    failed = false;
+
+  const auto hash_next_chunks = [&] () {
+    /* each thread uses its own file handle */
+    QFile file (file_path);
+    if (!file.open (QIODevice::ReadOnly))
+      {
+        failed = true;
+        return;
+      }
+
+    for (auto i = next_chunk++; i < num_chunks && !failed; i = next_chunk++)
+      {
+        const qint64  offset = static_cast<qint64> (i) * FILE_HASH_CHUNK_SIZE;
+        StreamingHash hasher;
+        if (!read_file_range (
+              file, offset, std::min (FILE_HASH_CHUNK_SIZE, file_size - offset),
+              [&] (auto data) { hasher.update (data); }))
+          {
+            failed = true;
+            return;
+          }
+        chunk_hashes[i] = hasher.finalize ();
+      }
+  };
+
+  std::vector<std::future<void>> workers;
+  workers.reserve (num_threads);
+  for (unsigned int i = 0; i < num_threads; ++i)
+    {
+      workers.emplace_back (std::async (std::launch::async, hash_next_chunks));
+    }
+  for (auto &worker : workers)
+    {
+      worker.get ();
+    }
+
+  if (failed)
+    {
+      z_warning ("Failed to read file: {}", path.string ());
+      return 0;
+    }
+
+  return get_custom_hash (
+    chunk_hashes.data (), chunk_hashes.size () * sizeof (HashT));
+}
+
 std::string
 to_string (HashT hash)
 {
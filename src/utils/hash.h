@@ -35,10 +35,36 @@ get_string_hash (const std::string &str)
   return get_custom_hash (str.data (), str.size ());
 }
 
-// Hash a file
+/**
+ * Hashes a file (XXH3 of its contents).
+ *
+ * The file is streamed through memory-mapped windows, so memory use doesn't
+ * grow with the file size.
+ *
+ * @return The hash, or 0 if the file could not be read.
+ */
 HashT
 get_file_hash (const std::filesystem::path &path);
 
+/** Size of the chunks hashed separately by get_file_hash_parallel(). */
+constexpr qint64 FILE_HASH_CHUNK_SIZE = 16 * 1024 * 1024;
+
+/**
+ * Hashes a file by hashing chunks of FILE_HASH_CHUNK_SIZE bytes in parallel
+ * and then hashing the chunk hashes.
+ *
+ * This is faster than get_file_hash() for large files, but the hashes are
+ * different, so they must never be compared with hashes from
+ * get_file_hash() (such as the file hashes stored in projects).
+ *
+ * @param num_threads Number of threads to use (0 to use all cores).
+ * @return The hash, or 0 if the file could not be read.
+ */
+HashT
+get_file_hash_parallel (
+  const std::filesystem::path &path,
+  unsigned int                 num_threads = 0);
+
 // Get canonical string representation of a hash
 std::string
 to_string (HashT hash);
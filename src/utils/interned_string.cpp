@@ -0,0 +1,48 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <mutex>
+
+#include "utils/interned_string.h"
+#include "utils/symap.h"
+
+namespace zrythm::utils
+{
+
+namespace
+{
+
+struct StringTable
+{
+  std::mutex mutex_;
+  ::Symap    symap_;
+};
+
+StringTable &
+get_string_table ()
+{
+  /* never destroyed so that handles in other static objects stay valid during
+   * static destruction */
+  static auto * table = new StringTable ();
+  return *table;
+}
+
+}
+
+InternedString &
+InternedString::operator= (std::string_view str)
+{
+  if (str.empty ())
+    {
+      str_ = nullptr;
+      return *this;
+    }
+
+  const std::string     null_terminated (str);
+  auto                 &table = get_string_table ();
+  const std::lock_guard lock (table.mutex_);
+  str_ = table.symap_.unmap (table.symap_.map (null_terminated.c_str ()));
+  return *this;
+}
+
+} // namespace zrythm::utils
@@ -0,0 +1,95 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include <fmt/format.h>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Handle to a string stored once in a process-wide string table.
+ *
+ * Equal strings share the same storage, so copies are a pointer copy and
+ * comparing or hashing two handles never looks at the characters.
+ *
+ * Strings are kept in the table (see Symap) until the process exits, so this
+ * is meant for the small set of strings that get repeated across many objects
+ * (port labels, symbols, URIs, etc.).
+ */
+class InternedString
+{
+public:
+  InternedString () = default;
+  explicit InternedString (std::string_view str) { *this = str; }
+
+  /**
+   * @brief Interns @p str.
+   *
+   * Takes a lock on the string table, so must not be called from realtime
+   * threads.
+   */
+  InternedString &operator= (std::string_view str);
+
+  InternedString &operator= (const std::string &str)
+  {
+    return *this = std::string_view (str);
+  }
+  InternedString &operator= (const char * str)
+  {
+    return *this = std::string_view (str);
+  }
+
+  bool empty () const { return str_ == nullptr; }
+
+  size_t size () const { return view ().size (); }
+  size_t length () const { return size (); }
+
+  /**
+   * @brief Returns a null-terminated string valid for the lifetime of the
+   * process.
+   */
+  const char * c_str () const { return str_ != nullptr ? str_ : ""; }
+
+  std::string_view view () const { return c_str (); }
+
+  std::string str () const { return c_str (); }
+
+  operator std::string () const { return str (); }
+
+  /**
+   * @brief Hash of the handle (not of the characters).
+   *
+   * Only valid for the current process, so must not be stored.
+   */
+  size_t hash () const { return std::hash<const char *>{}(str_); }
+
+  bool operator== (const InternedString &other) const
+  {
+    return str_ == other.str_;
+  }
+  bool operator== (std::string_view other) const { return view () == other; }
+
+private:
+  /** Storage in the string table, or nullptr if empty. */
+  const char * str_ = nullptr;
+};
+
+} // namespace zrythm::utils
+
+template <>
+struct fmt::formatter<zrythm::utils::InternedString>
+    : fmt::formatter<std::string_view>
+{
+  template <typename FormatContext>
+  auto
+  format (const zrythm::utils::InternedString &str, FormatContext &ctx) const
+  {
+    return fmt::formatter<std::string_view>::format (str.view (), ctx);
+  }
+};
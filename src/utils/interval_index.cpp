@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <limits>
+
+#include "utils/interval_index.h"
+
+namespace zrythm::utils
+{
+
+void
+IntervalIndex::build (std::span<const Interval> intervals)
+{
+  sorted_.clear ();
+  sorted_.reserve (intervals.size ());
+  sorted_ends_.clear ();
+  sorted_ends_.reserve (intervals.size ());
+  for (size_t i = 0; i < intervals.size (); ++i)
+    {
+      sorted_.push_back ({ intervals[i].start_, intervals[i].end_, i });
+      sorted_ends_.push_back (intervals[i].end_);
+    }
+  std::ranges::stable_sort (sorted_, {}, &Entry::start_);
+  std::ranges::sort (sorted_ends_);
+
+  max_end_pos_.resize (sorted_.size ());
+  for (size_t i = 0; i < sorted_.size (); ++i)
+    {
+      max_end_pos_[i] =
+        (i > 0 && sorted_[max_end_pos_[i - 1]].end_ > sorted_[i].end_)
+          ? max_end_pos_[i - 1]
+          : i;
+    }
+}
+
+void
+IntervalIndex::clear ()
+{
+  sorted_.clear ();
+  max_end_pos_.clear ();
+  sorted_ends_.clear ();
+}
+
+std::pair<size_t, size_t>
+IntervalIndex::get_candidates (int64_t from, int64_t to) const
+{
+  /* intervals starting after `to` can't overlap */
+  const auto last = static_cast<size_t> (
+    std::ranges::upper_bound (sorted_, to, {}, &Entry::start_)
+    - sorted_.begin ());
+
+  /* neither can the ones before the first whose running maximum end reaches
+   * `from` (the running maximum is non-decreasing) */
+  const auto candidates = std::span (max_end_pos_).first (last);
+  const auto first = static_cast<size_t> (
+    std::ranges::partition_point (
+      candidates, [&] (size_t pos) { return sorted_[pos].end_ < from; })
+    - candidates.begin ());
+  return { first, last };
+}
+
+std::optional<size_t>
+IntervalIndex::find_first_overlapping (int64_t from, int64_t to) const
+{
+  const auto [first, last] = get_candidates (from, to);
+  for (size_t i = first; i < last; ++i)
+    {
+      if (sorted_[i].end_ >= from)
+        return sorted_[i].index_;
+    }
+  return std::nullopt;
+}
+
+std::optional<size_t>
+IntervalIndex::find_last_overlapping (int64_t from, int64_t to) const
+{
+  const auto [first, last] = get_candidates (from, to);
+  for (size_t i = last; i > first; --i)
+    {
+      if (sorted_[i - 1].end_ >= from)
+        return sorted_[i - 1].index_;
+    }
+  return std::nullopt;
+}
+
+std::optional<size_t>
+IntervalIndex::find_latest_ending_started_by (int64_t pos) const
+{
+  const auto last = std::ranges::upper_bound (sorted_, pos, {}, &Entry::start_)
+                    - sorted_.begin ();
+  if (last == 0)
+    return std::nullopt;
+
+  return sorted_[max_end_pos_[static_cast<size_t> (last - 1)]].index_;
+}
+
+std::pair<int64_t, int64_t>
+IntervalIndex::get_boundaries_around (int64_t pos, bool include_ends) const
+{
+  int64_t from = std::numeric_limits<int64_t>::min ();
+  int64_t until = std::numeric_limits<int64_t>::max ();
+
+  const auto next_start =
+    std::ranges::upper_bound (sorted_, pos, {}, &Entry::start_);
+  if (next_start != sorted_.end ())
+    until = next_start->start_;
+  if (next_start != sorted_.begin ())
+    from = std::prev (next_start)->start_;
+
+  if (include_ends)
+    {
+      /* boundaries at end + 1, so the ones <= pos have end < pos */
+      const auto next_end = std::ranges::lower_bound (sorted_ends_, pos);
+      if (next_end != sorted_ends_.end ())
+        until = std::min (until, *next_end + 1);
+      if (next_end != sorted_ends_.begin ())
+        from = std::max (from, *std::prev (next_end) + 1);
+    }
+
+  return { from, until };
+}
+
+} // namespace zrythm::utils
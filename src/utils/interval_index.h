@@ -0,0 +1,132 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_INTERVAL_INDEX_H__
+#define __UTILS_INTERVAL_INDEX_H__
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Index of closed intervals for finding the ones overlapping a
+ * position or range without going through all of them.
+ *
+ * The intervals are sorted by their start, along with the running maximum of
+ * their ends, so a query binary-searches the intervals starting before its
+ * end and skips the ones that all end before its start. Queries cost
+ * O(log n + k), where k is the number of intervals starting between the
+ * first overlapping one and the query's end (just the overlapping ones
+ * unless long intervals contain shorter ones).
+ *
+ * The index refers to the intervals by their position in the span passed to
+ * build() and must be rebuilt after they change.
+ */
+class IntervalIndex
+{
+public:
+  /** A closed interval [start_, end_]. */
+  struct Interval
+  {
+    int64_t start_;
+    int64_t end_;
+  };
+
+  /**
+   * @brief Indexes @p intervals, replacing the previous ones.
+   */
+  void build (std::span<const Interval> intervals);
+
+  void clear ();
+
+  size_t size () const { return sorted_.size (); }
+  bool   empty () const { return sorted_.empty (); }
+
+  /**
+   * @brief Calls @p func with the index of each interval overlapping
+   * [@p from, @p to] (start <= @p to and end >= @p from), in order of their
+   * start (ties in the original order).
+   *
+   * @p from may be greater than @p to, e.g. to find the intervals that
+   * contain [pos, pos + 1] but not only its start.
+   */
+  template <typename Func>
+  void for_each_overlapping (int64_t from, int64_t to, Func &&func) const
+  {
+    const auto [first, last] = get_candidates (from, to);
+    for (size_t i = first; i < last; ++i)
+      {
+        if (sorted_[i].end_ >= from)
+          {
+            func (sorted_[i].index_);
+          }
+      }
+  }
+
+  /**
+   * @brief Returns the first (in order of start, ties in the original order)
+   * interval overlapping [@p from, @p to].
+   */
+  std::optional<size_t> find_first_overlapping (int64_t from, int64_t to) const;
+
+  /**
+   * @brief Returns the last (in order of start, ties in the original order)
+   * interval overlapping [@p from, @p to].
+   */
+  std::optional<size_t> find_last_overlapping (int64_t from, int64_t to) const;
+
+  /**
+   * @brief Returns the interval ending last among the ones starting at or
+   * before @p pos (ties resolved to the last one in order of start).
+   */
+  std::optional<size_t> find_latest_ending_started_by (int64_t pos) const;
+
+  /**
+   * @brief Returns the closest boundaries around @p pos as [from, until):
+   * @p from is the largest boundary <= @p pos and @p until the smallest one
+   * greater than @p pos (or the limits of int64_t if there are none).
+   *
+   * The boundaries are the starts of the intervals, plus the positions right
+   * after their ends if @p include_ends is true.
+   */
+  std::pair<int64_t, int64_t>
+  get_boundaries_around (int64_t pos, bool include_ends) const;
+
+private:
+  struct Entry
+  {
+    int64_t start_;
+    int64_t end_;
+
+    /** Index of the interval in the span passed to build(). */
+    size_t index_;
+  };
+
+  /**
+   * @brief Returns the range of @ref sorted_ that can overlap [@p from,
+   * @p to].
+   */
+  std::pair<size_t, size_t> get_candidates (int64_t from, int64_t to) const;
+
+private:
+  /** Intervals sorted by start. */
+  std::vector<Entry> sorted_;
+
+  /**
+   * Position in @ref sorted_ of the interval ending last among
+   * sorted_[0..i] (ties resolved to the last one).
+   */
+  std::vector<size_t> max_end_pos_;
+
+  /** Ends of the intervals, sorted. */
+  std::vector<int64_t> sorted_ends_;
+};
+
+} // namespace zrythm::utils
+
+#endif
@@ -11,12 +11,18 @@
 #define __IO_SERIALIZATION_ISERIALIZABLE_H__
 
 #include <any>
+#include <atomic>
+#include <exception>
 #include <filesystem>
+#include <future>
 #include <memory>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <type_traits>
 #include <vector>
 
+#include "utils/binary_json.h"
 #include "utils/dependency_holder.h"
 #include "utils/exceptions.h"
 #include "utils/json.h"
@@ -56,6 +62,19 @@ template <typename T> constexpr bool is_uuid_qhash_v = is_uuid_qhash<T>::value;
 template <typename T>
 concept QHashType = is_uuid_qhash_v<T>;
 
+/**
+ * @brief Opts the objects of @p VariantT into being deserialized in parallel
+ * when stored in a UUID-variant hash table (e.g., an OwningObjectRegistry).
+ *
+ * The objects are still created on the calling thread in document order, but
+ * their fields are deserialized on worker threads. This may only be enabled
+ * for types whose define_fields() doesn't modify shared state (like
+ * registries) and only creates objects owned by the object being
+ * deserialized.
+ */
+template <typename VariantT>
+inline constexpr bool deserialize_in_parallel_v = false;
+
 class ISerializableBase
 {
 public:
@@ -121,6 +140,7 @@ public:
       format_major_version_ = other.format_major_version_;
       format_minor_version_ = other.format_minor_version_;
       dependency_holder_ = other.dependency_holder_;
+      object_thread_ = other.object_thread_;
     }
 
     template <typename T> void add_dependency (T &&dependency)
@@ -151,6 +171,12 @@ public:
     /* used during deserialization */
     yyjson_val * obj_ = nullptr;
 
+    /**
+     * Thread to move the QObjects created during deserialization to, if they
+     * are created on a worker thread (see deserialize_in_parallel_v).
+     */
+    QThread * object_thread_ = nullptr;
+
     /** Dependency storage */
     DeserializationDependencyHolder dependency_holder_;
   };
@@ -605,28 +631,7 @@ public:
    */
   string::CStringRAII serialize_to_json_string () const
   {
-    yyjson_mut_doc * doc = yyjson_mut_doc_new (nullptr);
-    yyjson_mut_val * root = yyjson_mut_obj (doc);
-    if (!root)
-      {
-        throw ZrythmException ("Failed to create root obj");
-      }
-    yyjson_mut_doc_set_root (doc, root);
-
-    auto document_type = get_document_type ();
-    auto format_major_version = get_format_major_version ();
-    auto format_minor_version = get_format_minor_version ();
-    z_debug (
-      "serializing '{}' v{}.{} to JSON...", document_type, format_major_version,
-      format_minor_version);
-    yyjson_mut_obj_add_strncpy (
-      doc, root, "documentType", document_type.data (), document_type.size ());
-    yyjson_mut_obj_add_int (doc, root, "formatMajor", format_major_version);
-    yyjson_mut_obj_add_int (doc, root, "formatMinor", format_minor_version);
-
-    Context ctx (
-      doc, root, document_type, format_major_version, format_minor_version);
-    serialize (ctx);
+    yyjson_mut_doc * doc = create_serialized_doc ("JSON");
     yyjson_write_err write_err;
     char *           json = yyjson_mut_write_opts (
       doc, YYJSON_WRITE_PRETTY_TWO_SPACES, nullptr, nullptr, &write_err);
@@ -648,49 +653,67 @@ public:
     return { json };
   }
 
+  /**
+   * Serializes the object to the compact binary format (see
+   * utils::binary_json).
+   *
+   * The document is the same as the one produced by
+   * serialize_to_json_string(), only encoded differently. It is much faster to
+   * read back than JSON text, so it is meant for large documents like
+   * projects. JSON should be preferred for interchange and debugging.
+   *
+   * @throw ZrythmException if an error occurred.
+   */
+  std::string serialize_to_binary () const
+  {
+    std::string ret;
+    serialize_to_binary ([&ret] (std::string_view chunk) {
+      ret.append (chunk);
+    });
+    return ret;
+  }
+
+  /**
+   * Serializes the object to JSON like serialize_to_json_string(), but passes
+   * the text to @p sink in chunks instead of building the whole string.
+   *
+   * @throw ZrythmException if an error occurred.
+   */
+  void serialize_to_json (const json::ChunkSink &sink) const
+  {
+    serialize_to_sink ("JSON", [&sink] (yyjson_mut_doc * doc) {
+      json::write_to_sink (yyjson_mut_doc_get_root (doc), sink);
+    });
+  }
+
+  /**
+   * Serializes the object to the binary format like serialize_to_binary(),
+   * but passes the data to @p sink in chunks.
+   *
+   * @throw ZrythmException if an error occurred.
+   */
+  void serialize_to_binary (const json::ChunkSink &sink) const
+  {
+    serialize_to_sink ("binary", [&sink] (yyjson_mut_doc * doc) {
+      binary_json::write (doc, sink);
+    });
+  }
+
   void deserialize_from_json_string (const char * json)
   {
     yyjson_doc * doc =
       yyjson_read_opts ((char *) json, strlen (json), 0, nullptr, nullptr);
-    yyjson_val * root = yyjson_doc_get_root (doc);
-    if (!root)
-      {
-        throw ZrythmException ("Failed to create root JSON object");
-      }
-
-    auto document_type = get_document_type ();
-    auto format_major_version = get_format_major_version ();
-    auto format_minor_version = get_format_minor_version ();
-    z_debug (
-      "deserializing '{}' v{}.{} from JSON...", document_type,
-      format_major_version, format_minor_version);
-    yyjson_obj_iter it = yyjson_obj_iter_with (root);
-    if (!yyjson_equals_str (
-          yyjson_obj_iter_get (&it, "documentType"), document_type.c_str ()))
-      {
-        throw ZrythmException ("Invalid document type");
-      }
-    int deserialized_format_major_version =
-      yyjson_get_int (yyjson_obj_iter_get (&it, "formatMajor"));
-    int deserialized_format_minor_version =
-      yyjson_get_int (yyjson_obj_iter_get (&it, "formatMinor"));
-
-    /* abort if read version is newer */
-    if (
-      deserialized_format_major_version > format_major_version
-      || (deserialized_format_major_version == format_major_version && deserialized_format_minor_version > format_minor_version))
-      {
-        throw ZrythmException (fmt::format (
-          "Cannot deserialize newer '{}' version {}.{}", document_type,
-          deserialized_format_major_version, deserialized_format_minor_version));
-      }
-    Context ctx (
-      root, document_type, deserialized_format_major_version,
-      deserialized_format_minor_version);
-    deserialize (ctx);
-    z_debug ("done deserializing from json");
+    deserialize_from_doc (doc, "JSON");
+  }
 
-    yyjson_doc_free (doc);
+  /**
+   * Deserializes an object written with serialize_to_binary().
+   *
+   * @throw ZrythmException if an error occurred.
+   */
+  void deserialize_from_binary (std::string_view data)
+  {
+    deserialize_from_doc (binary_json::read (data), "binary");
   }
 
   template <IsVariant T>
@@ -1203,9 +1226,115 @@ public:
             obj = std::make_unique<T> ();
           }
       }
+    move_to_object_thread (*obj, ctx);
     return obj;
   }
 
+  /**
+   * @brief Moves a newly created (parentless) object to the thread given in
+   * the context, if any.
+   */
+  template <typename T>
+  static void move_to_object_thread (T &obj, const Context &ctx)
+  {
+    if constexpr (std::derived_from<T, QObject>)
+      {
+        if (ctx.object_thread_ && obj.thread () != ctx.object_thread_)
+          {
+            obj.moveToThread (ctx.object_thread_);
+          }
+      }
+  }
+
+  /**
+   * @brief Deserializes the objects in a UUID-variant hash table (see
+   * deserialize_in_parallel_v).
+   *
+   * The objects are created here in document order, then their fields are
+   * deserialized on worker threads.
+   *
+   * @return The objects in document order.
+   * @throw ZrythmException The first error in document order, in which case
+   * all the objects are deleted.
+   */
+  template <IsVariant VariantT>
+  std::vector<VariantT>
+  deserialize_variant_pointers_in_parallel (yyjson_val * arr, Context ctx)
+  {
+    std::vector<yyjson_val *> elems;
+    elems.reserve (yyjson_arr_size (arr));
+    size_t       idx = 0;
+    size_t       max = 0;
+    yyjson_val * elem = nullptr;
+    yyjson_arr_foreach (arr, idx, max, elem)
+    {
+      elems.push_back (elem);
+    }
+
+    std::vector<VariantT> objects;
+    objects.reserve (elems.size ());
+    for (auto * cur_elem : elems)
+      {
+        objects.push_back (create_object_at_variant_index<VariantT> (
+          yyjson_get_uint (yyjson_obj_get (cur_elem, "variantIndex")), ctx));
+      }
+
+    /* objects created by the workers are moved to this thread */
+    ctx.object_thread_ = QThread::currentThread ();
+
+    std::vector<std::exception_ptr> errors (objects.size ());
+    std::atomic_size_t              next_object{ 0 };
+    const auto                      deserialize_next_objects = [&] () {
+      for (size_t i = next_object++; i < objects.size (); i = next_object++)
+        {
+          Context obj_ctx = ctx;
+          obj_ctx.obj_ = yyjson_obj_get (elems[i], "data");
+          try
+            {
+              std::visit (
+                [&] (auto &&ptr) {
+                  using PtrType = base_type<decltype (ptr)>;
+                  ptr->ISerializable<PtrType>::deserialize (obj_ctx);
+                },
+                objects[i]);
+            }
+          catch (...)
+            {
+              errors[i] = std::current_exception ();
+            }
+        }
+    };
+
+    const auto num_threads = std::min (
+      static_cast<size_t> (std::max (1u, std::thread::hardware_concurrency ())),
+      objects.size ());
+    std::vector<std::future<void>> workers;
+    workers.reserve (num_threads);
+    for (size_t i = 0; i < num_threads; ++i)
+      {
+        workers.emplace_back (
+          std::async (std::launch::async, deserialize_next_objects));
+      }
+    for (auto &worker : workers)
+      {
+        worker.get ();
+      }
+
+    if (
+      auto it = std::ranges::find_if (
+        errors, [] (const auto &err) { return err != nullptr; });
+      it != errors.end ())
+      {
+        for (auto &obj : objects)
+          {
+            std::visit ([] (auto &&ptr) { delete ptr; }, obj);
+          }
+        std::rethrow_exception (*it);
+      }
+
+    return objects;
+  }
+
   template <typename Variant>
   auto create_object_at_variant_index (size_t index, const Context &ctx)
   {
@@ -1270,17 +1399,34 @@ public:
               "Expected JSON array for UUID-variant hash table");
           }
 
+        using VariantT = typename T::value_type;
+        const auto insert_child = [&] (const VariantT &child_var) {
+          std::visit (
+            [&] (auto &&child) {
+              value.insert (type_safe::get (child->get_uuid ()), child);
+            },
+            child_var);
+        };
+
         size_t len = yyjson_arr_size (val);
+        if constexpr (deserialize_in_parallel_v<VariantT>)
+          {
+            if (len > 1)
+              {
+                for (
+                  const auto &child_var :
+                  deserialize_variant_pointers_in_parallel<VariantT> (val, ctx))
+                  {
+                    insert_child (child_var);
+                  }
+                return;
+              }
+          }
+
         for (const auto i : std::views::iota (0zu, len))
           {
             yyjson_val * elem = yyjson_arr_get (val, i);
-            auto         child_var =
-              deserialize_variant_pointer<typename T::value_type> (elem, ctx);
-            std::visit (
-              [&] (auto &&child) {
-                value.insert (type_safe::get (child->get_uuid ()), child);
-              },
-              child_var);
+            insert_child (deserialize_variant_pointer<VariantT> (elem, ctx));
           }
         return;
       }
@@ -1316,7 +1462,10 @@ public:
                 if constexpr (is_unique_ptr_v<T>)
                   value = create_object<ObjType> (ctx);
                 else if constexpr (is_shared_ptr_v<T>)
-                  value = std::make_shared<ObjType> ();
+                  {
+                    value = std::make_shared<ObjType> ();
+                    move_to_object_thread (*value, ctx);
+                  }
                 else
                   static_assert (
                     dependent_false_v<T, VariantT>, "Unsupported pointer type");
@@ -1853,6 +2002,132 @@ public:
       typeid (Derived).name (), key, val_to_json.c_str ()));
   }
 
+private:
+  /**
+   * @brief Creates a document with the header fields and the serialized
+   * fields of this object.
+   *
+   * The caller must free it with yyjson_mut_doc_free().
+   */
+  yyjson_mut_doc * create_serialized_doc (std::string_view format_name) const
+  {
+    yyjson_mut_doc * doc = yyjson_mut_doc_new (nullptr);
+    yyjson_mut_val * root = yyjson_mut_obj (doc);
+    if (!root)
+      {
+        yyjson_mut_doc_free (doc);
+        throw ZrythmException ("Failed to create root obj");
+      }
+    yyjson_mut_doc_set_root (doc, root);
+
+    auto document_type = get_document_type ();
+    auto format_major_version = get_format_major_version ();
+    auto format_minor_version = get_format_minor_version ();
+    z_debug (
+      "serializing '{}' v{}.{} to {}...", document_type, format_major_version,
+      format_minor_version, format_name);
+    yyjson_mut_obj_add_strncpy (
+      doc, root, "documentType", document_type.data (), document_type.size ());
+    yyjson_mut_obj_add_int (doc, root, "formatMajor", format_major_version);
+    yyjson_mut_obj_add_int (doc, root, "formatMinor", format_minor_version);
+
+    Context ctx (
+      doc, root, document_type, format_major_version, format_minor_version);
+    try
+      {
+        serialize (ctx);
+      }
+    catch (...)
+      {
+        yyjson_mut_doc_free (doc);
+        throw;
+      }
+    return doc;
+  }
+
+  template <typename WriteFunc>
+  void serialize_to_sink (std::string_view format_name, WriteFunc &&write) const
+  {
+    yyjson_mut_doc * doc = create_serialized_doc (format_name);
+    try
+      {
+        write (doc);
+      }
+    catch (const ZrythmException &e)
+      {
+        yyjson_mut_doc_free (doc);
+        throw ZrythmException (fmt::format (
+          "Failed to serialize to {}:\n{}", format_name, e.what ()));
+      }
+    catch (...)
+      {
+        yyjson_mut_doc_free (doc);
+        throw;
+      }
+    z_debug ("done serializing to {}", format_name);
+    yyjson_mut_doc_free (doc);
+  }
+
+  /**
+   * @brief Validates the header fields of @p doc and deserializes this object
+   * from it.
+   *
+   * Takes ownership of @p doc.
+   */
+  void deserialize_from_doc (yyjson_doc * doc, std::string_view format_name)
+  {
+    yyjson_val * root = yyjson_doc_get_root (doc);
+    if (!root)
+      {
+        yyjson_doc_free (doc);
+        throw ZrythmException ("Failed to create root JSON object");
+      }
+
+    auto document_type = get_document_type ();
+    auto format_major_version = get_format_major_version ();
+    auto format_minor_version = get_format_minor_version ();
+    z_debug (
+      "deserializing '{}' v{}.{} from {}...", document_type,
+      format_major_version, format_minor_version, format_name);
+    try
+      {
+        yyjson_obj_iter it = yyjson_obj_iter_with (root);
+        if (!yyjson_equals_str (
+              yyjson_obj_iter_get (&it, "documentType"),
+              document_type.c_str ()))
+          {
+            throw ZrythmException ("Invalid document type");
+          }
+        int deserialized_format_major_version =
+          yyjson_get_int (yyjson_obj_iter_get (&it, "formatMajor"));
+        int deserialized_format_minor_version =
+          yyjson_get_int (yyjson_obj_iter_get (&it, "formatMinor"));
+
+        /* abort if read version is newer */
+        if (
+          deserialized_format_major_version > format_major_version
+          || (deserialized_format_major_version == format_major_version && deserialized_format_minor_version > format_minor_version))
+          {
+            throw ZrythmException (fmt::format (
+              "Cannot deserialize newer '{}' version {}.{}", document_type,
+              deserialized_format_major_version,
+              deserialized_format_minor_version));
+          }
+        Context ctx (
+          root, document_type, deserialized_format_major_version,
+          deserialized_format_minor_version);
+        deserialize (ctx);
+      }
+    catch (...)
+      {
+        yyjson_doc_free (doc);
+        throw;
+      }
+    z_debug ("done deserializing from {}", format_name);
+
+    yyjson_doc_free (doc);
+  }
+
 protected:
   template <typename... Field>
   void serialize_fields (const Context &ctx, Field &&... field) const
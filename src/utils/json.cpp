@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <cmath>
+#include <iterator>
+
 #include "utils/exceptions.h"
 #include "utils/json.h"
 
@@ -23,4 +26,195 @@ get_string (yyjson_val * val)
   return { json };
 }
 
+namespace
+{
+
+class StreamWriter
+{
+public:
+  explicit StreamWriter (const ChunkSink &sink) : sink_ (sink)
+  {
+    buf_.reserve (WRITE_CHUNK_SIZE + 1024);
+  }
+
+  void write_value (yyjson_mut_val * val, int level)
+  {
+    switch (yyjson_mut_get_type (val))
+      {
+      case YYJSON_TYPE_NULL:
+        buf_.append ("null");
+        break;
+      case YYJSON_TYPE_BOOL:
+        buf_.append (yyjson_mut_get_bool (val) ? "true" : "false");
+        break;
+      case YYJSON_TYPE_NUM:
+        write_number (val);
+        break;
+      case YYJSON_TYPE_STR:
+        write_string (yyjson_mut_get_str (val), yyjson_mut_get_len (val));
+        break;
+      case YYJSON_TYPE_RAW:
+        buf_.append (yyjson_mut_get_raw (val), yyjson_mut_get_len (val));
+        break;
+      case YYJSON_TYPE_ARR:
+        {
+          if (yyjson_mut_arr_size (val) == 0)
+            {
+              buf_.append ("[]");
+              break;
+            }
+          buf_.append ("[\n");
+          yyjson_mut_arr_iter it = yyjson_mut_arr_iter_with (val);
+          yyjson_mut_val *    child = nullptr;
+          bool                first = true;
+          while ((child = yyjson_mut_arr_iter_next (&it)))
+            {
+              if (!first)
+                buf_.append (",\n");
+              first = false;
+              write_indent (level + 1);
+              write_value (child, level + 1);
+            }
+          buf_.push_back ('\n');
+          write_indent (level);
+          buf_.push_back (']');
+        }
+        break;
+      case YYJSON_TYPE_OBJ:
+        {
+          if (yyjson_mut_obj_size (val) == 0)
+            {
+              buf_.append ("{}");
+              break;
+            }
+          buf_.append ("{\n");
+          yyjson_mut_obj_iter it = yyjson_mut_obj_iter_with (val);
+          yyjson_mut_val *    key = nullptr;
+          bool                first = true;
+          while ((key = yyjson_mut_obj_iter_next (&it)))
+            {
+              if (!first)
+                buf_.append (",\n");
+              first = false;
+              write_indent (level + 1);
+              write_string (yyjson_mut_get_str (key), yyjson_mut_get_len (key));
+              buf_.append (": ");
+              write_value (yyjson_mut_obj_iter_get_val (key), level + 1);
+            }
+          buf_.push_back ('\n');
+          write_indent (level);
+          buf_.push_back ('}');
+        }
+        break;
+      default:
+        throw ZrythmException ("Failed to serialize to JSON: invalid value");
+      }
+
+    if (buf_.size () >= WRITE_CHUNK_SIZE)
+      flush ();
+  }
+
+  void flush ()
+  {
+    if (buf_.empty ())
+      return;
+
+    sink_ (buf_);
+    buf_.clear ();
+  }
+
+private:
+  void write_indent (int level) { buf_.append (level * 2, ' '); }
+
+  void write_number (yyjson_mut_val * val)
+  {
+    if (yyjson_mut_is_uint (val))
+      {
+        fmt::format_to (
+          std::back_inserter (buf_), "{}", yyjson_mut_get_uint (val));
+        return;
+      }
+    if (yyjson_mut_is_sint (val))
+      {
+        fmt::format_to (
+          std::back_inserter (buf_), "{}", yyjson_mut_get_sint (val));
+        return;
+      }
+
+    const double real = yyjson_mut_get_real (val);
+    if (!std::isfinite (real))
+      {
+        throw ZrythmException (
+          "Failed to serialize to JSON: nan or inf number is not allowed");
+      }
+    const auto start = buf_.size ();
+    fmt::format_to (std::back_inserter (buf_), "{}", real);
+
+    /* keep it a real when read back */
+    if (buf_.find_first_of (".eE", start) == std::string::npos)
+      buf_.append (".0");
+  }
+
+  void write_string (const char * str, size_t len)
+  {
+    constexpr char hex[] = "0123456789abcdef";
+    buf_.push_back ('"');
+    for (size_t i = 0; i < len; ++i)
+      {
+        const auto c = static_cast<unsigned char> (str[i]);
+        switch (c)
+          {
+          case '"':
+            buf_.append ("\\\"");
+            break;
+          case '\\':
+            buf_.append ("\\\\");
+            break;
+          case '\b':
+            buf_.append ("\\b");
+            break;
+          case '\f':
+            buf_.append ("\\f");
+            break;
+          case '\n':
+            buf_.append ("\\n");
+            break;
+          case '\r':
+            buf_.append ("\\r");
+            break;
+          case '\t':
+            buf_.append ("\\t");
+            break;
+          default:
+            if (c < 0x20)
+              {
+                buf_.append ("\\u00");
+                buf_.push_back (hex[c >> 4]);
+                buf_.push_back (hex[c & 0xF]);
+              }
+            else
+              {
+                buf_.push_back (static_cast<char> (c));
+              }
+            break;
+          }
+      }
+    buf_.push_back ('"');
+  }
+
+private:
+  const ChunkSink &sink_;
+  std::string      buf_;
+};
+
+} // namespace
+
+void
+write_to_sink (yyjson_mut_val * val, const ChunkSink &sink)
+{
+  StreamWriter writer (sink);
+  writer.write_value (val, 0);
+  writer.flush ();
+}
+
 };
@@ -4,6 +4,9 @@
 #ifndef __UTILS_JSON_H__
 #define __UTILS_JSON_H__
 
+#include <functional>
+#include <string_view>
+
 #include "utils/string.h"
 #include <yyjson.h>
 
@@ -16,6 +19,28 @@ namespace zrythm::utils::json
 string::CStringRAII
 get_string (yyjson_val * val);
 
+/**
+ * @brief Receives output as it is produced, in chunks.
+ *
+ * The chunk is only valid during the call.
+ */
+using ChunkSink = std::function<void (std::string_view)>;
+
+constexpr size_t WRITE_CHUNK_SIZE = 64 * 1024;
+
+/**
+ * @brief Renders the given JSON node in chunks of about @ref
+ * WRITE_CHUNK_SIZE bytes.
+ *
+ * The output is pretty-printed with 2 spaces like get_string(), but the full
+ * string is never held in memory.
+ *
+ * @throw ZrythmException If the node contains values that can't be written
+ * (e.g., NaN), or rethrows exceptions from @p sink.
+ */
+void
+write_to_sink (yyjson_mut_val * val, const ChunkSink &sink);
+
 };
 
 #endif // ___UTILS_JSON_H__
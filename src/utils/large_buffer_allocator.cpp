@@ -0,0 +1,183 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-config.h"
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+
+#include "utils/large_buffer_allocator.h"
+#include "utils/logger.h"
+
+#ifdef _WIN32
+#  include <windows.h>
+#else
+#  include <sys/mman.h>
+#  include <unistd.h>
+#endif
+
+namespace zrythm::utils
+{
+
+namespace
+{
+
+std::atomic<bool> huge_pages_enabled = false;
+std::atomic<bool> lock_enabled = false;
+
+/* only warn once about each kind of failure */
+std::atomic<bool> warned_huge_pages = false;
+std::atomic<bool> warned_lock = false;
+
+size_t
+get_page_size ()
+{
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo (&info);
+  return info.dwPageSize;
+#else
+  return static_cast<size_t> (sysconf (_SC_PAGESIZE));
+#endif
+}
+
+size_t
+round_up (size_t size, size_t multiple)
+{
+  return (size + multiple - 1) / multiple * multiple;
+}
+
+bool
+lock_memory (void * data, size_t num_bytes)
+{
+#ifdef _WIN32
+  return VirtualLock (data, num_bytes) != 0;
+#else
+  return mlock (data, num_bytes) == 0;
+#endif
+}
+
+void
+unlock_memory (void * data, size_t num_bytes)
+{
+#ifdef _WIN32
+  VirtualUnlock (data, num_bytes);
+#else
+  munlock (data, num_bytes);
+#endif
+}
+
+#ifdef _WIN32
+/**
+ * Returns large pages (which are never paged out), or nullptr if not
+ * available (e.g., the user lacks the "Lock pages in memory" privilege).
+ */
+float *
+allocate_windows_large_pages (size_t num_bytes)
+{
+  const auto large_page_size = GetLargePageMinimum ();
+  if (large_page_size == 0)
+    return nullptr;
+
+  const auto size = round_up (num_bytes, large_page_size);
+  auto *     data = VirtualAlloc (
+    nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+  return static_cast<float *> (data);
+}
+#endif
+
+} // namespace
+
+void
+LargeBufferAllocator::set_options (Options options)
+{
+  huge_pages_enabled.store (options.huge_pages_);
+  lock_enabled.store (options.lock_);
+}
+
+LargeBufferAllocator::Options
+LargeBufferAllocator::get_options ()
+{
+  return { .huge_pages_ = huge_pages_enabled.load (),
+           .lock_ = lock_enabled.load () };
+}
+
+std::shared_ptr<float[]>
+LargeBufferAllocator::allocate_floats (size_t num_floats, size_t alignment)
+{
+  const auto options = get_options ();
+  size_t     num_bytes = std::max (num_floats, size_t{ 1 }) * sizeof (float);
+  const bool huge_pages = options.huge_pages_ && num_bytes >= HUGE_PAGE_SIZE;
+
+#ifdef _WIN32
+  if (huge_pages)
+    {
+      if (auto * data = allocate_windows_large_pages (num_bytes))
+        {
+          /* already zeroed and locked */
+          return {
+            data, [] (float * ptr) { VirtualFree (ptr, 0, MEM_RELEASE); }
+          };
+        }
+      if (!warned_huge_pages.exchange (true))
+        {
+          z_warning (
+            "Failed to allocate large pages (requires the 'Lock pages in "
+            "memory' privilege), using regular pages");
+        }
+    }
+#endif
+
+  /* align to whole pages when locking so that unlocking a buffer doesn't
+   * unlock pages shared with another one, and to huge pages so that the
+   * kernel can back the whole buffer with them */
+  if (huge_pages)
+    {
+      alignment = std::max (alignment, HUGE_PAGE_SIZE);
+      num_bytes = round_up (num_bytes, HUGE_PAGE_SIZE);
+    }
+  else if (options.lock_)
+    {
+      const auto page_size = get_page_size ();
+      alignment = std::max (alignment, page_size);
+      num_bytes = round_up (num_bytes, page_size);
+    }
+
+  auto * data = static_cast<float *> (
+    ::operator new[] (num_bytes, std::align_val_t{ alignment }));
+
+#ifdef __linux__
+  /* before touching the memory, so that it gets faulted in as huge pages */
+  if (
+    huge_pages && madvise (data, num_bytes, MADV_HUGEPAGE) != 0
+    && !warned_huge_pages.exchange (true))
+    {
+      z_warning (
+        "Failed to enable transparent huge pages, using regular pages");
+    }
+#endif
+
+  std::fill_n (data, num_bytes / sizeof (float), 0.f);
+
+  const bool locked = options.lock_ && lock_memory (data, num_bytes);
+  if (options.lock_ && !locked && !warned_lock.exchange (true))
+    {
+      z_warning (
+        "Failed to lock {} bytes in memory (the limit of locked memory may be "
+        "too low), buffers may get paged out",
+        num_bytes);
+    }
+
+  return {
+    data, [num_bytes, alignment, locked] (float * ptr) {
+      if (locked)
+        {
+          unlock_memory (ptr, num_bytes);
+        }
+      ::operator delete[] (ptr, std::align_val_t{ alignment });
+    }
+  };
+}
+
+} // namespace zrythm::utils
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Allocates the large buffers that the realtime threads access
+ * constantly (port buffer arenas, in-memory clip frames).
+ *
+ * Depending on the process-wide options, the buffers are:
+ * - backed by huge pages to reduce TLB misses (transparent huge pages through
+ *   `madvise(MADV_HUGEPAGE)` on Linux, large pages on Windows), and/or
+ * - locked in RAM so that they never get paged out (e.g., during a live
+ *   show).
+ *
+ * Both are best effort: if the system refuses (e.g., no permission to use
+ * large pages or the lock limit is reached), regular memory is used and a
+ * warning is logged.
+ */
+class LargeBufferAllocator
+{
+public:
+  struct Options
+  {
+    bool huge_pages_ = false;
+    bool lock_ = false;
+  };
+
+  /** Size of a huge page (buffers smaller than this use regular pages). */
+  static constexpr size_t HUGE_PAGE_SIZE = size_t{ 2 } << 20;
+
+public:
+  /**
+   * @brief Sets the options used by subsequent allocations.
+   *
+   * Existing buffers are not affected.
+   */
+  static void set_options (Options options);
+
+  static Options get_options ();
+
+  /**
+   * @brief Returns whether huge pages or locking are enabled.
+   *
+   * Owners of large buffers allocated elsewhere may move them to memory from
+   * this allocator if so.
+   */
+  static bool is_enabled ()
+  {
+    const auto options = get_options ();
+    return options.huge_pages_ || options.lock_;
+  }
+
+  /**
+   * @brief Allocates @p num_floats zeroed floats, aligned to at least
+   * @p alignment bytes.
+   *
+   * The memory is released when the last reference is dropped. Not
+   * realtime-safe.
+   */
+  static std::shared_ptr<float[]>
+  allocate_floats (size_t num_floats, size_t alignment);
+};
+
+} // namespace zrythm::utils
@@ -0,0 +1,60 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "utils/main_thread_notifier.h"
+
+#include <QCoreApplication>
+
+namespace zrythm::utils
+{
+
+MainThreadNotifier::MainThreadNotifier (std::function<void ()> callback)
+    : callback_ (std::move (callback)), context_ (std::make_unique<QObject> ()),
+      thread_ ([this] () { run (); })
+{
+  /* in case this is created on another thread (e.g., while loading a
+   * project) */
+  if (auto * app = QCoreApplication::instance ())
+    {
+      context_->moveToThread (app->thread ());
+    }
+}
+
+MainThreadNotifier::~MainThreadNotifier ()
+{
+  quit_.store (true);
+  wakeup_sem_.release ();
+  thread_.join ();
+}
+
+void
+MainThreadNotifier::notify () noexcept
+{
+  if (!pending_.exchange (true, std::memory_order_acq_rel))
+    {
+      wakeup_sem_.release ();
+    }
+}
+
+void
+MainThreadNotifier::run ()
+{
+  while (true)
+    {
+      wakeup_sem_.acquire ();
+      if (quit_.load ())
+        break;
+
+      QMetaObject::invokeMethod (
+        context_.get (),
+        [this] () {
+          /* clear first so that work added during the callback notifies
+           * again */
+          pending_.store (false, std::memory_order_release);
+          callback_ ();
+        },
+        Qt::QueuedConnection);
+    }
+}
+
+} // namespace zrythm::utils
@@ -0,0 +1,70 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_MAIN_THREAD_NOTIFIER_H__
+#define __UTILS_MAIN_THREAD_NOTIFIER_H__
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <semaphore>
+#include <thread>
+
+#include <QObject>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Runs a callback on the main (Qt) thread when other threads (including
+ * realtime ones) notify that there is work for it, instead of polling.
+ *
+ * Notifications are coalesced: notify() only wakes a helper thread (which
+ * queues the callback on the main thread's event loop) if the callback is not
+ * already pending, so bursts of notifications cause a single call. The
+ * callback is expected to handle all the work available when it runs.
+ *
+ * Must be destroyed on the main thread.
+ */
+class MainThreadNotifier
+{
+public:
+  /**
+   * @param callback Callback to run on the main thread.
+   */
+  explicit MainThreadNotifier (std::function<void ()> callback);
+  ~MainThreadNotifier ();
+
+  MainThreadNotifier (const MainThreadNotifier &) = delete;
+  MainThreadNotifier &operator= (const MainThreadNotifier &) = delete;
+
+  /**
+   * @brief Requests the callback to run on the main thread.
+   *
+   * Realtime-safe (it may only release a semaphore).
+   */
+  void notify () noexcept;
+
+private:
+  void run ();
+
+private:
+  std::function<void ()> callback_;
+
+  /**
+   * Receiver of the queued calls, so that pending calls are dropped when this
+   * is destroyed.
+   */
+  std::unique_ptr<QObject> context_;
+
+  /** Whether a call is pending (set by notify() and cleared by the call). */
+  std::atomic<bool> pending_{ false };
+
+  std::binary_semaphore wakeup_sem_{ 0 };
+  std::atomic<bool>     quit_{ false };
+  std::thread           thread_;
+};
+
+} // namespace zrythm::utils
+
+#endif // __UTILS_MAIN_THREAD_NOTIFIER_H__
@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <set>
+#include <unordered_map>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Values keyed by object ID, with the maximum available at any time.
+ *
+ * Setting or removing a value costs O(log n) and getting the maximum O(1),
+ * so the maximum can be kept up to date as single objects change instead of
+ * being recomputed from all of them.
+ *
+ * @tparam IdT An equality-comparable ID type, hashed with its hash() method
+ * if it has one (like UuidIdentifiableObject::Uuid) or with std::hash
+ * otherwise.
+ * @tparam ValueT A totally ordered value type.
+ */
+template <typename IdT, typename ValueT> class MaxValueIndex
+{
+public:
+  /**
+   * @brief Sets the value of @p id, adding it if it isn't in the index.
+   */
+  void set (const IdT &id, ValueT value)
+  {
+    const auto it = entries_.find (id);
+    if (it != entries_.end ())
+      {
+        if (*it->second == value)
+          return;
+
+        values_.erase (it->second);
+        it->second = values_.insert (value);
+      }
+    else
+      {
+        entries_.emplace (id, values_.insert (value));
+      }
+  }
+
+  void remove (const IdT &id)
+  {
+    const auto it = entries_.find (id);
+    if (it == entries_.end ())
+      return;
+
+    values_.erase (it->second);
+    entries_.erase (it);
+  }
+
+  bool contains (const IdT &id) const { return entries_.contains (id); }
+
+  size_t size () const { return entries_.size (); }
+  bool   empty () const { return entries_.empty (); }
+
+  void clear ()
+  {
+    entries_.clear ();
+    values_.clear ();
+  }
+
+  /**
+   * @brief Returns the maximum value, if any.
+   */
+  std::optional<ValueT> get_max () const
+  {
+    if (values_.empty ())
+      return std::nullopt;
+
+    return *values_.rbegin ();
+  }
+
+private:
+  struct Hash
+  {
+    size_t operator() (const IdT &id) const
+    {
+      if constexpr (requires { id.hash (); })
+        return id.hash ();
+      else
+        return std::hash<IdT>{}(id);
+    }
+  };
+
+  using ValueSet = std::multiset<ValueT>;
+
+  ValueSet                                                   values_;
+  std::unordered_map<IdT, typename ValueSet::iterator, Hash> entries_;
+};
+
+} // namespace zrythm::utils
@@ -166,6 +166,120 @@ public:
     return true;
   }
 
+  /**
+   * @brief Pushes up to @p count elements, claiming their slots with a single
+   * CAS.
+   *
+   * @return The number of elements pushed (less than @p count if the queue
+   * got full). The first elements of @p data are pushed.
+   */
+  size_t push_back_multiple (const T * data, size_t count)
+  {
+    size_t pos = _enqueue_pos.load (std::memory_order_relaxed);
+    size_t num_claimed = 0;
+
+    while (count > 0)
+      {
+        /* count the consecutive free slots */
+        num_claimed = 0;
+        intptr_t dif = 0;
+        while (num_claimed < count)
+          {
+            const size_t slot_pos = pos + num_claimed;
+            const size_t seq = _buffer[slot_pos & _buffer_mask]._sequence.load (
+              std::memory_order_acquire);
+            dif = (intptr_t) seq - (intptr_t) slot_pos;
+            if (dif != 0)
+              {
+                break;
+              }
+            ++num_claimed;
+          }
+
+        if (num_claimed > 0)
+          {
+            if (_enqueue_pos.compare_exchange_weak (
+                  pos, pos + num_claimed, std::memory_order_relaxed))
+              {
+                break;
+              }
+          }
+        else if (dif < 0)
+          {
+            return 0;
+          }
+        else
+          {
+            pos = _enqueue_pos.load (std::memory_order_relaxed);
+          }
+      }
+
+    for (size_t i = 0; i < num_claimed; ++i)
+      {
+        cell_t * cell = &_buffer[(pos + i) & _buffer_mask];
+        cell->_data = data[i];
+        cell->_sequence.store (pos + i + 1, std::memory_order_release);
+      }
+    return num_claimed;
+  }
+
+  /**
+   * @brief Pops up to @p count elements into @p data, claiming their slots
+   * with a single CAS.
+   *
+   * @return The number of elements popped.
+   */
+  size_t pop_front_multiple (T * data, size_t count)
+  {
+    size_t pos = _dequeue_pos.load (std::memory_order_relaxed);
+    size_t num_claimed = 0;
+
+    while (count > 0)
+      {
+        /* count the consecutive filled slots */
+        num_claimed = 0;
+        intptr_t dif = 0;
+        while (num_claimed < count)
+          {
+            const size_t slot_pos = pos + num_claimed;
+            const size_t seq = _buffer[slot_pos & _buffer_mask]._sequence.load (
+              std::memory_order_acquire);
+            dif = (intptr_t) seq - (intptr_t) (slot_pos + 1);
+            if (dif != 0)
+              {
+                break;
+              }
+            ++num_claimed;
+          }
+
+        if (num_claimed > 0)
+          {
+            if (_dequeue_pos.compare_exchange_weak (
+                  pos, pos + num_claimed, std::memory_order_relaxed))
+              {
+                break;
+              }
+          }
+        else if (dif < 0)
+          {
+            return 0;
+          }
+        else
+          {
+            pos = _dequeue_pos.load (std::memory_order_relaxed);
+          }
+      }
+
+    for (size_t i = 0; i < num_claimed; ++i)
+      {
+        cell_t * cell = &_buffer[(pos + i) & _buffer_mask];
+        data[i] = cell->_data;
+        cell->_sequence.store (
+          pos + i + _buffer_mask + 1, std::memory_order_release);
+      }
+    return num_claimed;
+  }
+
 private:
   struct cell_t
   {
@@ -173,14 +287,13 @@ private:
     T               _data;
   };
 
-  char            _pad0[64] = {};
-  cell_t *        _buffer{ nullptr };
-  size_t          _buffer_mask{};
-  char            _pad1[64 - sizeof (cell_t *) - sizeof (size_t)] = {};
-  MPMC_QUEUE_TYPE _enqueue_pos{ 0 };
-  char            _pad2[64 - sizeof (size_t)] = {};
-  MPMC_QUEUE_TYPE _dequeue_pos = 0;
-  char            _pad3[64 - sizeof (size_t)] = {};
+  /* the positions are on separate cache lines (also from the read-mostly
+   * buffer fields) to avoid false sharing between producers and consumers */
+  alignas (64) cell_t * _buffer{ nullptr };
+  size_t _buffer_mask{};
+  alignas (64) MPMC_QUEUE_TYPE _enqueue_pos{ 0 };
+  alignas (64) MPMC_QUEUE_TYPE _dequeue_pos = 0;
+  char _pad[64 - sizeof (MPMC_QUEUE_TYPE)] = {};
 };
 
 /**
@@ -4,7 +4,10 @@
 #ifndef ZRYTHM_UTILS_OBJECT_POOL_H
 #define ZRYTHM_UTILS_OBJECT_POOL_H
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 #include "utils/mpmc_queue.h"
@@ -12,6 +15,12 @@
 /**
  * @brief Thread-safe, realtime-safe object pool.
  *
+ * By default, acquire() grows the pool when all objects are in use, which
+ * allocates and locks. Realtime pools (created with a maximum capacity)
+ * never do that: acquire() then only takes objects from the lock-free free
+ * list and fails fast when they are all in use, and the pool is topped up
+ * by refill() from a non-realtime thread.
+ *
  * @tparam T The type of objects to be pooled. Must be default-constructible.
  */
 template <typename T, bool EnableDebug = false> class ObjectPool
@@ -23,14 +32,40 @@ public:
 
   ObjectPool (size_t initial_capacity = 64) { reserve (initial_capacity); }
 
+  /**
+   * @brief Creates a realtime pool.
+   *
+   * @param initial_capacity Number of objects allocated now.
+   * @param max_capacity Maximum number of objects refill() may grow the pool
+   * to (the free list is allocated for this many objects now).
+   */
+  ObjectPool (size_t initial_capacity, size_t max_capacity)
+      : realtime_ (true),
+        max_capacity_ (std::max (initial_capacity, max_capacity))
+  {
+    available_.reserve (max_capacity_);
+    reserve (initial_capacity);
+  }
+
+  /**
+   * @brief Returns an available object, growing the pool if needed.
+   *
+   * On realtime pools this never grows the pool and returns nullptr if all
+   * objects are in use (see try_acquire()).
+   */
   T * acquire ()
   {
+    if (realtime_)
+      {
+        return try_acquire ();
+      }
+
     T * object;
     if (available_.pop_front (object))
       {
         if constexpr (EnableDebug)
           {
-            num_in_use.fetch_add (1, std::memory_order_relaxed);
+            count_acquired ();
           }
         return object;
       }
@@ -43,29 +78,118 @@ public:
     return acquire ();
   }
 
+  /**
+   * @brief Returns an available object, or nullptr if all objects are in use.
+   *
+   * Unlike acquire(), this never expands the pool, so it is realtime-safe.
+   */
+  T * try_acquire ()
+  {
+    T * object;
+    if (!available_.pop_front (object))
+      {
+        if (realtime_)
+          {
+            num_failed_acquires_.fetch_add (1, std::memory_order_relaxed);
+          }
+        return nullptr;
+      }
+
+    if (EnableDebug || realtime_)
+      {
+        count_acquired ();
+      }
+    return object;
+  }
+
   void release (T * object)
   {
     available_.push_back (object);
-    if constexpr (EnableDebug)
+    if (EnableDebug || realtime_)
       {
-        num_in_use.fetch_add (-1);
+        num_in_use.fetch_sub (1, std::memory_order_relaxed);
       }
   }
 
+  /**
+   * @brief Grows the pool to at least @p size objects (at most the maximum
+   * capacity of realtime pools).
+   *
+   * Not realtime-safe.
+   */
   void reserve (size_t size)
   {
-    available_.reserve (size);
+    if (realtime_)
+      {
+        size = std::min (size, max_capacity_);
+      }
+    else
+      {
+        available_.reserve (size);
+      }
     while (size_ < size)
       {
         expand ();
       }
   }
 
+  /**
+   * @brief Grows a realtime pool (up to its maximum capacity) if at most a
+   * quarter of its objects are available.
+   *
+   * Meant to be called periodically from a non-realtime thread. Does
+   * nothing for pools that grow on demand.
+   */
+  void refill ()
+  {
+    if (!realtime_)
+      return;
+
+    std::lock_guard<std::mutex> lock (expand_mutex_);
+    const auto in_use = std::min (size_, get_num_in_use ());
+    if (size_ < max_capacity_ && (size_ - in_use) * 4 <= size_)
+      {
+        grow ();
+      }
+  }
+
   auto get_num_in_use () const { return num_in_use.load (); }
   auto get_capacity () const { return capacity_; }
   auto get_size () const { return size_; }
 
+  bool   is_realtime () const { return realtime_; }
+  size_t get_max_capacity () const { return max_capacity_; }
+
+  /**
+   * @brief Returns the highest number of objects that were in use at once
+   * (tracked on realtime pools and when debugging), to help size the pool.
+   */
+  size_t get_high_water_mark () const
+  {
+    return high_water_mark_.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Returns the number of times a realtime pool had no available
+   * object.
+   */
+  size_t get_num_failed_acquires () const
+  {
+    return num_failed_acquires_.load (std::memory_order_relaxed);
+  }
+
 private:
+  void count_acquired ()
+  {
+    const auto in_use = num_in_use.fetch_add (1, std::memory_order_relaxed) + 1;
+    auto high_water_mark = high_water_mark_.load (std::memory_order_relaxed);
+    while (
+      in_use > high_water_mark
+      && !high_water_mark_.compare_exchange_weak (
+        high_water_mark, in_use, std::memory_order_relaxed))
+      ;
+  }
+
   void expand ()
   {
     std::lock_guard<std::mutex> lock (expand_mutex_);
@@ -73,23 +197,38 @@ private:
     // Check again after acquiring lock in case another thread already expanded
     if (size_ == capacity_)
       {
-        size_t old_capacity = capacity_;
-        if (capacity_ == 0)
-          {
-            capacity_ = 1;
-          }
-        capacity_ *= 2;
+        grow ();
+      }
+  }
 
-        buffer_.reserve (capacity_);
+  /**
+   * @brief Doubles the capacity (up to the maximum capacity of realtime
+   * pools).
+   *
+   * Must be called with @ref expand_mutex_ locked.
+   */
+  void grow ()
+  {
+    size_t old_capacity = capacity_;
+    if (capacity_ == 0)
+      {
+        capacity_ = 1;
+      }
+    capacity_ *= 2;
+    if (realtime_)
+      {
+        capacity_ = std::min (capacity_, max_capacity_);
+      }
 
-        for (size_t i = old_capacity; i < capacity_; ++i)
-          {
-            buffer_.emplace_back (std::make_unique<T> ());
-            available_.push_back (buffer_.back ().get ());
-          }
+    buffer_.reserve (capacity_);
 
-        size_ = capacity_;
+    for (size_t i = old_capacity; i < capacity_; ++i)
+      {
+        buffer_.emplace_back (std::make_unique<T> ());
+        available_.push_back (buffer_.back ().get ());
       }
+
+    size_ = capacity_;
   }
 
   std::vector<std::unique_ptr<T>> buffer_;
@@ -98,8 +237,17 @@ private:
   size_t                          size_ = 0;
   std::mutex                      expand_mutex_;
 
+  /** Whether this is a realtime pool. */
+  const bool realtime_ = false;
+
+  /** Maximum capacity of realtime pools. */
+  const size_t max_capacity_ = 0;
+
   // Debug counter
   std::atomic<size_t> num_in_use;
+
+  std::atomic<size_t> high_water_mark_{ 0 };
+  std::atomic<size_t> num_failed_acquires_{ 0 };
 };
 
 #endif
@@ -0,0 +1,315 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+#include "utils/onset_index.h"
+
+#include "juce_wrapper.h"
+
+namespace zrythm::utils::audio
+{
+
+namespace
+{
+
+constexpr std::array<char, 8> MAGIC = {
+  'Z', 'R', 'O', 'N', 'S', 'E', 'T', 'S'
+};
+constexpr uint32_t VERSION = 1;
+
+struct Header
+{
+  std::array<char, 8> magic;
+  uint32_t            version;
+  uint64_t            num_frames;
+  uint64_t            source_hash;
+  uint64_t            num_onsets;
+};
+
+/** Minimum rise of the energy (in dB) for an onset. */
+constexpr float MIN_RISE_DB = 6.f;
+
+/** Energy of silent hops (in dB). */
+constexpr float FLOOR_DB = -120.f;
+
+/**
+ * The attack of an onset starts at the first frame reaching this fraction of
+ * the peak of the hop.
+ */
+constexpr float ATTACK_THRESHOLD = 0.5f;
+
+float
+to_db (double energy)
+{
+  return energy > 1e-12 ? 10.f * static_cast<float> (std::log10 (energy))
+                        : FLOOR_DB;
+}
+
+} // namespace
+
+OnsetIndex::OnsetIndex (const OnsetIndex &other)
+{
+  std::lock_guard lock (other.mutex_);
+  onsets_ = other.onsets_;
+  num_frames_ = other.num_frames_;
+  computed_ = other.computed_;
+}
+
+void
+OnsetIndex::assign (OnsetIndex &&other)
+{
+  std::scoped_lock lock (mutex_, other.mutex_);
+  onsets_ = std::move (other.onsets_);
+  num_frames_ = other.num_frames_;
+  computed_ = other.computed_;
+}
+
+void
+OnsetIndex::update (const AudioBuffer &frames, sample_rate_t samplerate)
+{
+  const int     num_channels = frames.getNumChannels ();
+  const int64_t num_frames = frames.getNumSamples ();
+  const float   gain =
+    num_channels > 0 ? 1.f / static_cast<float> (num_channels) : 0.f;
+  const auto get_mono = [&] (int64_t i) {
+    float sum = 0.f;
+    for (int ch = 0; ch < num_channels; ++ch)
+      sum += frames.getSample (ch, static_cast<int> (i));
+    return sum * gain;
+  };
+
+  /* energy of each hop, with the first difference emphasizing high
+   * frequencies (attacks) */
+  const auto num_hops =
+    static_cast<size_t> ((num_frames + HOP_SIZE - 1) / HOP_SIZE);
+  std::vector<float> energies (num_hops);
+  float              prev = 0.f;
+  for (size_t hop = 0; hop < num_hops; ++hop)
+    {
+      const int64_t start = static_cast<int64_t> (hop) * HOP_SIZE;
+      const int64_t end = std::min (start + HOP_SIZE, num_frames);
+      double        energy = 0.0;
+      for (int64_t i = start; i < end; ++i)
+        {
+          const float val = get_mono (i);
+          const float diff = val - prev;
+          energy += static_cast<double> (val) * val
+                    + static_cast<double> (diff) * diff;
+          prev = val;
+        }
+      energies[hop] = to_db (energy / static_cast<double> (end - start));
+    }
+
+  /* rise over the previous 2 hops, so that attacks straddling 2 hops are
+   * not split */
+  std::vector<float> rises (num_hops);
+  for (size_t hop = 0; hop < num_hops; ++hop)
+    {
+      const float before = hop >= 2 ? energies[hop - 2] : FLOOR_DB;
+      if (energies[hop] > SILENCE_DB)
+        rises[hop] = std::max (0.f, energies[hop] - before);
+    }
+
+  /* pick the peaks of the rises */
+  const auto min_interval_hops = std::max<size_t> (
+    1,
+    static_cast<size_t> (
+      MIN_INTERVAL * static_cast<double> (samplerate)
+      / static_cast<double> (HOP_SIZE)));
+  std::vector<Onset> onsets;
+  float              max_rise = 0.f;
+  for (size_t hop = 0; hop < num_hops; ++hop)
+    {
+      if (rises[hop] < MIN_RISE_DB)
+        continue;
+
+      const size_t from =
+        hop >= min_interval_hops ? hop - min_interval_hops : 0;
+      const size_t to = std::min (num_hops, hop + min_interval_hops + 1);
+      const auto   peak_it = std::max_element (
+        rises.begin () + static_cast<ptrdiff_t> (from),
+        rises.begin () + static_cast<ptrdiff_t> (to));
+      if (static_cast<size_t> (peak_it - rises.begin ()) != hop)
+        continue;
+
+      /* refine to the first frame of the attack */
+      const int64_t hop_start = static_cast<int64_t> (hop) * HOP_SIZE;
+      const int64_t hop_end = std::min (hop_start + HOP_SIZE, num_frames);
+      float         peak = 0.f;
+      for (int64_t i = hop_start; i < hop_end; ++i)
+        peak = std::max (peak, std::abs (get_mono (i)));
+      int64_t attack = hop_start;
+      const int64_t search_start =
+        std::max<int64_t> (0, hop_start - HOP_SIZE);
+      for (int64_t i = search_start; i < hop_end; ++i)
+        {
+          if (std::abs (get_mono (i)) >= peak * ATTACK_THRESHOLD)
+            {
+              attack = i;
+              break;
+            }
+        }
+
+      onsets.push_back ({ .frame_ = attack, .strength_ = rises[hop] });
+      max_rise = std::max (max_rise, rises[hop]);
+    }
+  for (auto &onset : onsets)
+    onset.strength_ /= max_rise;
+
+  std::lock_guard lock (mutex_);
+  onsets_ = std::move (onsets);
+  num_frames_ = num_frames;
+  computed_ = true;
+}
+
+bool
+OnsetIndex::is_computed () const
+{
+  std::lock_guard lock (mutex_);
+  return computed_;
+}
+
+int64_t
+OnsetIndex::get_num_frames () const
+{
+  std::lock_guard lock (mutex_);
+  return num_frames_;
+}
+
+std::vector<OnsetIndex::Onset>
+OnsetIndex::get_onsets (
+  int64_t start_frame,
+  int64_t end_frame,
+  float   min_strength) const
+{
+  std::lock_guard    lock (mutex_);
+  std::vector<Onset> ret;
+  const auto         it =
+    std::ranges::lower_bound (onsets_, start_frame, {}, &Onset::frame_);
+  for (auto cur = it; cur != onsets_.end () && cur->frame_ < end_frame; ++cur)
+    {
+      if (cur->strength_ >= min_strength)
+        ret.push_back (*cur);
+    }
+  return ret;
+}
+
+std::optional<int64_t>
+OnsetIndex::find_nearest (
+  int64_t frame,
+  int64_t max_distance,
+  float   min_strength) const
+{
+  std::optional<int64_t> ret;
+  for (
+    const auto &onset :
+    get_onsets (frame - max_distance, frame + max_distance + 1, min_strength))
+    {
+      if (!ret || std::abs (onset.frame_ - frame) < std::abs (*ret - frame))
+        ret = onset.frame_;
+    }
+  return ret;
+}
+
+void
+OnsetIndex::write (const fs::path &path, hash::HashT source_hash) const
+{
+  juce::File file (path.string ());
+  if (auto res = file.getParentDirectory ().createDirectory (); res.failed ())
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to create directory for '{}': {}", path,
+        res.getErrorMessage ().toStdString ()));
+    }
+
+  std::lock_guard lock (mutex_);
+  Header          header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.num_frames = static_cast<uint64_t> (num_frames_);
+  header.source_hash = source_hash;
+  header.num_onsets = onsets_.size ();
+
+  /* write to a temporary file first so that a partial file is never used */
+  juce::TemporaryFile temp_file (file);
+  {
+    juce::FileOutputStream out (temp_file.getFile ());
+    if (out.failedToOpen ())
+      {
+        throw ZrythmException (
+          fmt::format ("Failed to open '{}' for writing", path));
+      }
+
+    bool ok = out.write (&header, sizeof (header));
+    ok =
+      ok
+      && (onsets_.empty ()
+          || out.write (onsets_.data (), onsets_.size () * sizeof (Onset)));
+    out.flush ();
+    if (!ok || out.getStatus ().failed ())
+      {
+        throw ZrythmException (fmt::format ("Failed to write '{}'", path));
+      }
+  }
+
+  if (!temp_file.overwriteTargetFileWithTemporary ())
+    {
+      throw ZrythmException (fmt::format ("Failed to replace '{}'", path));
+    }
+}
+
+std::unique_ptr<OnsetIndex>
+OnsetIndex::read (const fs::path &path, hash::HashT source_hash)
+{
+  juce::File file (path.string ());
+  if (!file.existsAsFile ())
+    return nullptr;
+
+  juce::FileInputStream in (file);
+  if (in.failedToOpen ())
+    {
+      z_warning ("Failed to open onset file '{}'", path);
+      return nullptr;
+    }
+
+  Header header{};
+  if (
+    in.read (&header, sizeof (header)) != (int) sizeof (header)
+    || header.magic != MAGIC || header.version != VERSION)
+    {
+      z_warning ("Invalid onset file '{}'", path);
+      return nullptr;
+    }
+  if (header.source_hash != source_hash)
+    {
+      z_debug ("Onset file '{}' is stale", path);
+      return nullptr;
+    }
+
+  const size_t num_bytes = header.num_onsets * sizeof (Onset);
+  if ((size_t) in.getTotalLength () != sizeof (header) + num_bytes)
+    {
+      z_warning ("Truncated onset file '{}'", path);
+      return nullptr;
+    }
+
+  auto index = std::make_unique<OnsetIndex> ();
+  index->num_frames_ = static_cast<int64_t> (header.num_frames);
+  index->onsets_.resize (header.num_onsets);
+  if (
+    num_bytes > 0
+    && in.read (index->onsets_.data (), num_bytes) != (int) num_bytes)
+    {
+      z_warning ("Failed to read onset file '{}'", path);
+      return nullptr;
+    }
+  index->computed_ = true;
+  return index;
+}
+
+} // namespace zrythm::utils::audio
@@ -0,0 +1,116 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_ONSET_INDEX_H__
+#define __UTILS_ONSET_INDEX_H__
+
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include "utils/audio.h"
+#include "utils/hash.h"
+#include "utils/types.h"
+
+namespace zrythm::utils::audio
+{
+
+/**
+ * @brief Onsets (transients) of audio frames, used for slicing, snapping and
+ * quantizing audio without analysing the frames again.
+ *
+ * Onsets are the peaks of the rise of the log energy (emphasizing high
+ * frequencies) of a mono mixdown, analysed in hops of HOP_SIZE frames and
+ * then refined to the first frame of the attack.
+ *
+ * Reading is thread-safe, but there must be only one updater at a time.
+ */
+class OnsetIndex
+{
+public:
+  /** Number of frames analysed at a time. */
+  static constexpr int64_t HOP_SIZE = 256;
+
+  /** Onsets closer than this (in seconds) are merged. */
+  static constexpr double MIN_INTERVAL = 0.03;
+
+  /** Hops quieter than this are never onsets. */
+  static constexpr float SILENCE_DB = -60.f;
+
+  struct Onset
+  {
+    /** First frame of the attack. */
+    int64_t frame_ = 0;
+
+    /** Relative strength (the strongest onset of the frames is 1). */
+    float strength_ = 0.f;
+  };
+
+  OnsetIndex () = default;
+  OnsetIndex (const OnsetIndex &other);
+  OnsetIndex &operator= (const OnsetIndex &other) = delete;
+
+  /**
+   * @brief Detects the onsets of @p frames, replacing the previous ones.
+   */
+  void update (const AudioBuffer &frames, sample_rate_t samplerate);
+
+  /**
+   * @brief Whether the onsets were detected (or read) already.
+   */
+  bool is_computed () const;
+
+  int64_t get_num_frames () const;
+
+  /**
+   * @brief Returns the onsets in [@p start_frame, @p end_frame) that are at
+   * least @p min_strength strong, in ascending order.
+   */
+  std::vector<Onset> get_onsets (
+    int64_t start_frame,
+    int64_t end_frame,
+    float   min_strength = 0.f) const;
+
+  /**
+   * @brief Returns the frame of the onset nearest to @p frame that is at
+   * most @p max_distance frames away and at least @p min_strength strong.
+   */
+  std::optional<int64_t> find_nearest (
+    int64_t frame,
+    int64_t max_distance,
+    float   min_strength = 0.f) const;
+
+  /**
+   * @brief Writes the onsets to @p path (atomically), creating the parent
+   * directory if needed.
+   *
+   * @param source_hash Hash of the file the frames came from.
+   * @throw ZrythmException on error.
+   */
+  void write (const fs::path &path, hash::HashT source_hash) const;
+
+  /**
+   * @brief Reads onsets written with write().
+   *
+   * @return The onsets, or nullptr if the file doesn't exist, is invalid or
+   * doesn't match @p source_hash.
+   */
+  static std::unique_ptr<OnsetIndex>
+  read (const fs::path &path, hash::HashT source_hash);
+
+  /**
+   * @brief Replaces the contents of this index with the ones of @p other.
+   */
+  void assign (OnsetIndex &&other);
+
+private:
+  mutable std::mutex mutex_;
+  std::vector<Onset> onsets_;
+  int64_t            num_frames_ = 0;
+  bool               computed_ = false;
+};
+
+} // namespace zrythm::utils::audio
+
+#endif // __UTILS_ONSET_INDEX_H__
@@ -0,0 +1,364 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "utils/dsp.h"
+#include "utils/exceptions.h"
+#include "utils/logger.h"
+#include "utils/peak_pyramid.h"
+
+#include "juce_wrapper.h"
+
+namespace zrythm::utils::audio
+{
+
+namespace
+{
+
+constexpr std::array<char, 8> MAGIC = {
+  'Z', 'R', 'P', 'E', 'A', 'K', 'P', 'Y'
+};
+constexpr uint32_t VERSION = 1;
+
+struct Header
+{
+  std::array<char, 8> magic;
+  uint32_t            version;
+  uint32_t            num_channels;
+  uint64_t            num_frames;
+  uint64_t            source_hash;
+  uint32_t            num_levels;
+};
+
+size_t
+get_num_buckets (int64_t num_frames, int64_t bucket_size)
+{
+  return static_cast<size_t> ((num_frames + bucket_size - 1) / bucket_size);
+}
+
+} // namespace
+
+PeakPyramid::PeakPyramid (const PeakPyramid &other)
+{
+  std::lock_guard lock (other.mutex_);
+  levels_ = other.levels_;
+  num_channels_ = other.num_channels_;
+  num_frames_ = other.num_frames_;
+}
+
+void
+PeakPyramid::assign (PeakPyramid &&other)
+{
+  std::scoped_lock lock (mutex_, other.mutex_);
+  levels_ = std::move (other.levels_);
+  num_channels_ = other.num_channels_;
+  num_frames_ = other.num_frames_;
+}
+
+int
+PeakPyramid::get_num_channels () const
+{
+  std::lock_guard lock (mutex_);
+  return num_channels_;
+}
+
+int64_t
+PeakPyramid::get_num_frames () const
+{
+  std::lock_guard lock (mutex_);
+  return num_frames_;
+}
+
+size_t
+PeakPyramid::get_memory_usage () const
+{
+  std::lock_guard lock (mutex_);
+  size_t          ret = 0;
+  for (const auto &level : levels_)
+    {
+      for (const auto &buckets : level)
+        {
+          ret += buckets.capacity () * sizeof (Bucket);
+        }
+    }
+  return ret;
+}
+
+void
+PeakPyramid::update (const AudioBuffer &frames, int64_t from_frame)
+{
+  const int     num_channels = frames.getNumChannels ();
+  const int64_t num_frames = frames.getNumSamples ();
+
+  int64_t start_frame = 0;
+  {
+    std::lock_guard lock (mutex_);
+    if (num_channels == num_channels_)
+      {
+        start_frame = std::min ({ from_frame, num_frames_, num_frames });
+      }
+  }
+
+  /* start at a bucket of the coarsest level so that each level can be
+   * derived from the one below */
+  start_frame = start_frame / BUCKET_SIZES.back () * BUCKET_SIZES.back ();
+
+  Levels new_levels;
+  for (size_t l = 0; l < BUCKET_SIZES.size (); ++l)
+    {
+      const auto bucket_size = BUCKET_SIZES[l];
+      for (int ch = 0; ch < num_channels; ++ch)
+        {
+          auto &buckets = new_levels[l].emplace_back ();
+          buckets.reserve (
+            get_num_buckets (num_frames - start_frame, bucket_size));
+          if (l == 0)
+            {
+              for (int64_t f = start_frame; f < num_frames; f += bucket_size)
+                {
+                  const auto n =
+                    (size_t) std::min (bucket_size, num_frames - f);
+                  const auto * src = frames.getReadPointer (ch, (int) f);
+                  Bucket       bucket{
+                    .min_ = float_ranges::min (src, n),
+                    .max_ = float_ranges::max (src, n),
+                  };
+                  for (size_t i = 0; i < n; ++i)
+                    {
+                      bucket.sum_squares_ += src[i] * src[i];
+                    }
+                  buckets.push_back (bucket);
+                }
+            }
+          else
+            {
+              const auto &lower = new_levels[l - 1][ch];
+              const auto ratio = (size_t) (bucket_size / BUCKET_SIZES[l - 1]);
+              for (size_t i = 0; i < lower.size (); i += ratio)
+                {
+                  Bucket     bucket = lower[i];
+                  const auto end = std::min (i + ratio, lower.size ());
+                  for (size_t j = i + 1; j < end; ++j)
+                    {
+                      bucket.min_ = std::min (bucket.min_, lower[j].min_);
+                      bucket.max_ = std::max (bucket.max_, lower[j].max_);
+                      bucket.sum_squares_ += lower[j].sum_squares_;
+                    }
+                  buckets.push_back (bucket);
+                }
+            }
+        }
+    }
+
+  std::lock_guard lock (mutex_);
+  if (num_channels != num_channels_)
+    {
+      levels_ = std::move (new_levels);
+    }
+  else
+    {
+      for (size_t l = 0; l < BUCKET_SIZES.size (); ++l)
+        {
+          for (int ch = 0; ch < num_channels; ++ch)
+            {
+              auto &buckets = levels_[l][ch];
+              auto &new_buckets = new_levels[l][ch];
+              buckets.resize ((size_t) (start_frame / BUCKET_SIZES[l]));
+              buckets.insert (
+                buckets.end (), new_buckets.begin (), new_buckets.end ());
+            }
+        }
+    }
+  num_channels_ = num_channels;
+  num_frames_ = num_frames;
+}
+
+void
+PeakPyramid::get_peaks (
+  int             ch,
+  double          start_frame,
+  double          frames_per_peak,
+  std::span<Peak> peaks) const
+{
+  std::ranges::fill (peaks, Peak{});
+
+  std::lock_guard lock (mutex_);
+  if (ch < 0 || ch >= num_channels_ || num_frames_ == 0 || frames_per_peak <= 0)
+    return;
+
+  /* use the coarsest level that is not coarser than a peak */
+  size_t level = 0;
+  while (
+    level + 1 < BUCKET_SIZES.size ()
+    && (double) BUCKET_SIZES[level + 1] <= frames_per_peak)
+    {
+      ++level;
+    }
+  const auto  bucket_size = BUCKET_SIZES[level];
+  const auto &buckets = levels_[level][ch];
+
+  for (size_t i = 0; i < peaks.size (); ++i)
+    {
+      const double range_start = start_frame + (double) i * frames_per_peak;
+      const double range_end = range_start + frames_per_peak;
+      if (range_end <= 0)
+        continue;
+
+      const auto first = (size_t) std::max (
+        0.0, std::floor (range_start / (double) bucket_size));
+      if (first >= buckets.size ())
+        break;
+      const auto last = std::clamp (
+        (size_t) std::ceil (range_end / (double) bucket_size), first + 1,
+        buckets.size ());
+
+      Bucket  merged = buckets[first];
+      int64_t num_frames = 0;
+      for (size_t j = first; j < last; ++j)
+        {
+          merged.min_ = std::min (merged.min_, buckets[j].min_);
+          merged.max_ = std::max (merged.max_, buckets[j].max_);
+          if (j > first)
+            {
+              merged.sum_squares_ += buckets[j].sum_squares_;
+            }
+          num_frames +=
+            std::min (bucket_size, num_frames_ - (int64_t) j * bucket_size);
+        }
+      peaks[i] = {
+        .min_ = merged.min_,
+        .max_ = merged.max_,
+        .rms_ = std::sqrt (merged.sum_squares_ / (float) num_frames),
+      };
+    }
+}
+
+void
+PeakPyramid::write (const fs::path &path, hash::HashT source_hash) const
+{
+  juce::File file (path.string ());
+  if (auto res = file.getParentDirectory ().createDirectory (); res.failed ())
+    {
+      throw ZrythmException (fmt::format (
+        "Failed to create directory for '{}': {}", path,
+        res.getErrorMessage ().toStdString ()));
+    }
+
+  std::lock_guard lock (mutex_);
+  Header          header{};
+  header.magic = MAGIC;
+  header.version = VERSION;
+  header.num_channels = static_cast<uint32_t> (num_channels_);
+  header.num_frames = static_cast<uint64_t> (num_frames_);
+  header.source_hash = source_hash;
+  header.num_levels = static_cast<uint32_t> (BUCKET_SIZES.size ());
+
+  /* write to a temporary file first so that a partial file is never used */
+  juce::TemporaryFile temp_file (file);
+  {
+    juce::FileOutputStream out (temp_file.getFile ());
+    if (out.failedToOpen ())
+      {
+        throw ZrythmException (
+          fmt::format ("Failed to open '{}' for writing", path));
+      }
+
+    bool ok = out.write (&header, sizeof (header));
+    for (const auto &level : levels_)
+      {
+        for (const auto &buckets : level)
+          {
+            ok =
+              ok
+              && (buckets.empty ()
+                  || out.write (
+                    buckets.data (), buckets.size () * sizeof (Bucket)));
+          }
+      }
+    out.flush ();
+    if (!ok || out.getStatus ().failed ())
+      {
+        throw ZrythmException (fmt::format ("Failed to write '{}'", path));
+      }
+  }
+
+  if (!temp_file.overwriteTargetFileWithTemporary ())
+    {
+      throw ZrythmException (fmt::format ("Failed to replace '{}'", path));
+    }
+}
+
+std::unique_ptr<PeakPyramid>
+PeakPyramid::read (const fs::path &path, hash::HashT source_hash)
+{
+  juce::File file (path.string ());
+  if (!file.existsAsFile ())
+    return nullptr;
+
+  juce::FileInputStream in (file);
+  if (in.failedToOpen ())
+    {
+      z_warning ("Failed to open peak file '{}'", path);
+      return nullptr;
+    }
+
+  Header header{};
+  if (in.read (&header, sizeof (header)) != (int) sizeof (header))
+    {
+      z_warning ("Invalid peak file '{}'", path);
+      return nullptr;
+    }
+  if (
+    header.magic != MAGIC || header.version != VERSION
+    || header.num_levels != BUCKET_SIZES.size ())
+    {
+      z_warning ("Invalid peak file '{}'", path);
+      return nullptr;
+    }
+  if (header.source_hash != source_hash)
+    {
+      z_debug ("Peak file '{}' is stale", path);
+      return nullptr;
+    }
+
+  size_t expected_size = sizeof (header);
+  for (const auto bucket_size : BUCKET_SIZES)
+    {
+      expected_size +=
+        header.num_channels
+        * get_num_buckets ((int64_t) header.num_frames, bucket_size)
+        * sizeof (Bucket);
+    }
+  if ((size_t) in.getTotalLength () != expected_size)
+    {
+      z_warning ("Truncated peak file '{}'", path);
+      return nullptr;
+    }
+
+  auto pyramid = std::make_unique<PeakPyramid> ();
+  pyramid->num_channels_ = static_cast<int> (header.num_channels);
+  pyramid->num_frames_ = static_cast<int64_t> (header.num_frames);
+  for (size_t l = 0; l < BUCKET_SIZES.size (); ++l)
+    {
+      const auto num_buckets =
+        get_num_buckets (pyramid->num_frames_, BUCKET_SIZES[l]);
+      for (uint32_t ch = 0; ch < header.num_channels; ++ch)
+        {
+          auto &buckets = pyramid->levels_[l].emplace_back (num_buckets);
+          const auto num_bytes = num_buckets * sizeof (Bucket);
+          if (
+            num_bytes > 0
+            && in.read (buckets.data (), num_bytes) != (int) num_bytes)
+            {
+              z_warning ("Failed to read peak file '{}'", path);
+              return nullptr;
+            }
+        }
+    }
+  return pyramid;
+}
+
+} // namespace zrythm::utils::audio
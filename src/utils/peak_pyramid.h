@@ -0,0 +1,128 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_PEAK_PYRAMID_H__
+#define __UTILS_PEAK_PYRAMID_H__
+
+#include <array>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "utils/audio.h"
+#include "utils/hash.h"
+#include "utils/types.h"
+
+namespace zrythm::utils::audio
+{
+
+/**
+ * @brief Multi-resolution min/max/RMS summary of audio frames, used to draw
+ * waveforms without reading the frames.
+ *
+ * Each level summarizes buckets of BUCKET_SIZES frames (the last bucket of a
+ * level may be partial). get_peaks() picks the coarsest level that is finer
+ * than a pixel, so drawing costs O(pixels) regardless of the zoom level.
+ *
+ * Reading is thread-safe, but there must be only one updater at a time.
+ */
+class PeakPyramid
+{
+public:
+  /** Number of frames summarized by each bucket of each level. */
+  static constexpr std::array<int64_t, 4> BUCKET_SIZES = {
+    64, 512, 4096, 32768
+  };
+
+  /** Summary of a range of frames. */
+  struct Peak
+  {
+    float min_ = 0.f;
+    float max_ = 0.f;
+    float rms_ = 0.f;
+  };
+
+  PeakPyramid () = default;
+  PeakPyramid (const PeakPyramid &other);
+  PeakPyramid &operator= (const PeakPyramid &other) = delete;
+
+  /**
+   * @brief Summarizes @p frames from @p from_frame until their end.
+   *
+   * Summaries of frames past the end of @p frames are dropped. Summaries
+   * from @p from_frame on are recomputed (e.g., after recording appended
+   * frames or an edit replaced them), as well as any frames that were not
+   * summarized yet, so passing 0 recomputes everything.
+   *
+   * @param frames All the frames (not only the changed ones).
+   */
+  void update (const AudioBuffer &frames, int64_t from_frame = 0);
+
+  int     get_num_channels () const;
+  int64_t get_num_frames () const;
+
+  /**
+   * @brief Returns the number of bytes used by the summaries.
+   */
+  size_t get_memory_usage () const;
+
+  /**
+   * @brief Fills @p peaks with the summaries of consecutive ranges of @p
+   * frames_per_peak frames starting at @p start_frame, for channel @p ch.
+   *
+   * Ranges are summarized at 64-frame granularity at best, and ranges outside
+   * the summarized frames are silent.
+   */
+  void get_peaks (
+    int             ch,
+    double          start_frame,
+    double          frames_per_peak,
+    std::span<Peak> peaks) const;
+
+  /**
+   * @brief Writes the pyramid to @p path (atomically), creating the parent
+   * directory if needed.
+   *
+   * @param source_hash Hash of the file the frames came from.
+   * @throw ZrythmException on error.
+   */
+  void write (const fs::path &path, hash::HashT source_hash) const;
+
+  /**
+   * @brief Reads a pyramid written with write().
+   *
+   * @return The pyramid, or nullptr if the file doesn't exist, is invalid or
+   * doesn't match @p source_hash.
+   */
+  static std::unique_ptr<PeakPyramid>
+  read (const fs::path &path, hash::HashT source_hash);
+
+  /**
+   * @brief Replaces the contents of this pyramid with the ones of @p other.
+   */
+  void assign (PeakPyramid &&other);
+
+private:
+  /** Summary of a bucket (the sum of squares allows merging buckets). */
+  struct Bucket
+  {
+    float min_ = 0.f;
+    float max_ = 0.f;
+    float sum_squares_ = 0.f;
+  };
+
+  /** Buckets per level, per channel. */
+  using Levels =
+    std::array<std::vector<std::vector<Bucket>>, BUCKET_SIZES.size ()>;
+
+private:
+  mutable std::mutex mutex_;
+  Levels             levels_;
+  int                num_channels_ = 0;
+  int64_t            num_frames_ = 0;
+};
+
+} // namespace zrythm::utils::audio
+
+#endif // __UTILS_PEAK_PYRAMID_H__
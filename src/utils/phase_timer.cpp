@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "utils/datetime.h"
+#include "utils/exceptions.h"
+#include "utils/io.h"
+#include "utils/json.h"
+#include "utils/phase_timer.h"
+
+namespace zrythm::utils
+{
+
+namespace
+{
+double
+usecs_to_msecs (qint64 usecs)
+{
+  return static_cast<double> (usecs) / 1000.0;
+}
+}
+
+PhaseTimer::PhaseTimer (std::string name) : name_ (std::move (name))
+{
+  timer_.start ();
+}
+
+void
+PhaseTimer::add_phase (
+  std::string name,
+  qint64      start_usecs,
+  qint64      duration_usecs)
+{
+  phases_.push_back (Phase{
+    .name_ = std::move (name),
+    .start_usecs_ = start_usecs,
+    .duration_usecs_ = duration_usecs,
+  });
+}
+
+void
+PhaseTimer::set_info (std::string key, std::string value)
+{
+  for (auto &[cur_key, cur_value] : info_)
+    {
+      if (cur_key == key)
+        {
+          cur_value = std::move (value);
+          return;
+        }
+    }
+  info_.emplace_back (std::move (key), std::move (value));
+}
+
+std::string
+PhaseTimer::get_summary () const
+{
+  std::string ret =
+    fmt::format ("{}: {}ms total", name_, get_elapsed_usecs () / 1000);
+  for (const auto &phase : phases_)
+    {
+      ret +=
+        fmt::format (", {} {}ms", phase.name_, phase.duration_usecs_ / 1000);
+    }
+  return ret;
+}
+
+std::string
+PhaseTimer::get_report_json () const
+{
+  yyjson_mut_doc * doc = yyjson_mut_doc_new (nullptr);
+  if (!doc)
+    {
+      throw ZrythmException ("Failed to create JSON document");
+    }
+
+  yyjson_mut_val * root = yyjson_mut_obj (doc);
+  yyjson_mut_doc_set_root (doc, root);
+  yyjson_mut_obj_add_strncpy (doc, root, "name", name_.data (), name_.size ());
+  const auto datetime = datetime::get_current_as_string ();
+  yyjson_mut_obj_add_strncpy (
+    doc, root, "datetime", datetime.data (), datetime.size ());
+  for (const auto &[key, value] : info_)
+    {
+      yyjson_mut_obj_add (
+        root, yyjson_mut_strncpy (doc, key.data (), key.size ()),
+        yyjson_mut_strncpy (doc, value.data (), value.size ()));
+    }
+  yyjson_mut_obj_add_real (
+    doc, root, "totalMs", usecs_to_msecs (get_elapsed_usecs ()));
+
+  yyjson_mut_val * phases_arr = yyjson_mut_obj_add_arr (doc, root, "phases");
+  for (const auto &phase : phases_)
+    {
+      yyjson_mut_val * phase_obj = yyjson_mut_arr_add_obj (doc, phases_arr);
+      yyjson_mut_obj_add_strncpy (
+        doc, phase_obj, "name", phase.name_.data (), phase.name_.size ());
+      yyjson_mut_obj_add_real (
+        doc, phase_obj, "startMs", usecs_to_msecs (phase.start_usecs_));
+      yyjson_mut_obj_add_real (
+        doc, phase_obj, "durationMs", usecs_to_msecs (phase.duration_usecs_));
+    }
+
+  std::string ret;
+  try
+    {
+      json::write_to_sink (
+        root, [&ret] (std::string_view chunk) { ret.append (chunk); });
+    }
+  catch (...)
+    {
+      yyjson_mut_doc_free (doc);
+      throw;
+    }
+  yyjson_mut_doc_free (doc);
+  ret.push_back ('\n');
+  return ret;
+}
+
+void
+PhaseTimer::write_report (const std::filesystem::path &path) const
+{
+  io::set_file_contents (path, get_report_json ());
+}
+
+} // namespace zrythm::utils
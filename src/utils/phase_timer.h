@@ -0,0 +1,119 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_PHASE_TIMER_H__
+#define __UTILS_PHASE_TIMER_H__
+
+#include <filesystem>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "utils/types.h"
+
+#include <QElapsedTimer>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Records how long the phases of a longer operation (e.g., opening a
+ * project) take, so that slow phases can be attributed.
+ *
+ * Phases are usually timed with scope(). They are kept in the order they
+ * ended and may be nested (e.g., a phase timing a whole function that
+ * contains other phases).
+ */
+class PhaseTimer
+{
+public:
+  struct Phase
+  {
+    std::string name_;
+
+    /** Start of the phase, relative to the start of the timer. */
+    qint64 start_usecs_ = 0;
+
+    qint64 duration_usecs_ = 0;
+  };
+
+  /**
+   * @brief Records a phase lasting from its creation until it's destroyed.
+   */
+  class Scope
+  {
+  public:
+    Scope (PhaseTimer &timer, std::string name)
+        : timer_ (timer), name_ (std::move (name)),
+          start_usecs_ (timer.get_elapsed_usecs ())
+    {
+    }
+    ~Scope ()
+    {
+      timer_.add_phase (
+        std::move (name_), start_usecs_,
+        timer_.get_elapsed_usecs () - start_usecs_);
+    }
+    Z_DISABLE_COPY_MOVE (Scope)
+
+  private:
+    PhaseTimer &timer_;
+    std::string name_;
+    qint64      start_usecs_;
+  };
+
+  /**
+   * @param name Name of the operation, used in the summary and the report.
+   */
+  explicit PhaseTimer (std::string name);
+
+  [[nodiscard]] Scope scope (std::string name)
+  {
+    return { *this, std::move (name) };
+  }
+
+  void add_phase (std::string name, qint64 start_usecs, qint64 duration_usecs);
+
+  /**
+   * @brief Adds a string to the report (e.g., the application version).
+   */
+  void set_info (std::string key, std::string value);
+
+  const std::vector<Phase> &get_phases () const { return phases_; }
+
+  /** Time since the timer was created. */
+  qint64 get_elapsed_usecs () const { return timer_.nsecsElapsed () / 1000; }
+
+  /**
+   * @brief Returns a one-line summary of the phases, for logging.
+   */
+  std::string get_summary () const;
+
+  /**
+   * @brief Returns the report as a JSON document.
+   *
+   * The report contains the name of the operation, the info strings, the
+   * total time and each phase with its start and duration (in
+   * milliseconds).
+   *
+   * @throw ZrythmException If the report could not be written.
+   */
+  std::string get_report_json () const;
+
+  /**
+   * @brief Writes the report to @p path, replacing any existing file.
+   *
+   * @throw ZrythmException On error.
+   */
+  void write_report (const std::filesystem::path &path) const;
+
+private:
+  std::string                                      name_;
+  QElapsedTimer                                    timer_;
+  std::vector<Phase>                               phases_;
+  std::vector<std::pair<std::string, std::string>> info_;
+};
+
+} // namespace zrythm::utils
+
+#endif // __UTILS_PHASE_TIMER_H__
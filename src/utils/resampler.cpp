@@ -1,6 +1,9 @@
 // SPDX-FileCopyrightText: © 2023-2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <algorithm>
+#include <cmath>
+
 #include "utils/audio.h"
 #include "utils/debug.h"
 #include "utils/exceptions.h"
@@ -246,3 +249,257 @@ Resampler::get_out_frames () const
   // resize because we might have allocated more frames than needed
   return pimpl_->get_out_frames ();
 }
+
+class StreamingResampler::Impl
+{
+public:
+  Impl (
+    size_t             num_channels,
+    double             input_rate,
+    double             output_rate,
+    Resampler::Quality quality,
+    Sink               sink,
+    size_t             chunk_frames,
+    unsigned int       num_threads)
+      : num_channels_ (num_channels), chunk_frames_ (chunk_frames),
+        sink_ (std::move (sink)),
+        out_frames_ (
+          static_cast<int> (num_channels),
+          static_cast<int> (chunk_frames)),
+        in_ptrs_ (num_channels)
+  {
+    z_return_if_fail (num_channels > 0 && chunk_frames > 0);
+    for (size_t ch = 0; ch < num_channels; ++ch)
+      {
+        out_ptrs_.push_back (
+          out_frames_.getWritePointer (static_cast<int> (ch)));
+      }
+
+    unsigned long quality_recipe = SOXR_VHQ;
+    switch (quality)
+      {
+      case Resampler::Quality::Quick:
+        quality_recipe = SOXR_QQ;
+        break;
+      case Resampler::Quality::Low:
+        quality_recipe = SOXR_LQ;
+        break;
+      case Resampler::Quality::Medium:
+        quality_recipe = SOXR_MQ;
+        break;
+      case Resampler::Quality::High:
+        quality_recipe = SOXR_HQ;
+        break;
+      case Resampler::Quality::VeryHigh:
+        break;
+      }
+    const auto quality_spec = soxr_quality_spec (quality_recipe, 0);
+
+    /* planar ("split") input and output */
+    const auto io_spec = soxr_io_spec (SOXR_FLOAT32_S, SOXR_FLOAT32_S);
+    const auto runtime_spec = soxr_runtime_spec (num_threads);
+
+    soxr_error_t serror = nullptr;
+    priv_ = soxr_create (
+      input_rate, output_rate, static_cast<unsigned> (num_channels), &serror,
+      &io_spec, &quality_spec, &runtime_spec);
+    if (serror)
+      {
+        throw ZrythmException (fmt::format (
+          "Failed to create soxr instance: {}", std::string{ serror }));
+      }
+  }
+
+  ~Impl () { soxr_delete (priv_); }
+
+  /**
+   * Passes @p num_frames frames starting at @p frames (or the remaining
+   * output if @p frames is null) to SoXR, and the output to the sink.
+   *
+   * @return The number of output frames produced.
+   */
+  size_t process_chunk (const float * const * frames, size_t num_frames)
+  {
+    size_t num_in_done = 0;
+    size_t num_out_done = 0;
+    auto   serror = soxr_process (
+      priv_, frames ? static_cast<soxr_in_t> (frames) : nullptr, num_frames,
+      &num_in_done, static_cast<soxr_out_t> (out_ptrs_.data ()), chunk_frames_,
+      &num_out_done);
+    if (serror)
+      {
+        throw ZrythmException (
+          fmt::format ("soxr_process() error: {}", std::string{ serror }));
+      }
+    if (num_out_done > 0)
+      {
+        sink_ (
+          out_frames_.getArrayOfReadPointers (), num_channels_, num_out_done);
+      }
+    last_num_in_done_ = num_in_done;
+    return num_out_done;
+  }
+
+  void process (const float * const * frames, size_t num_frames)
+  {
+    size_t num_done = 0;
+    while (num_done < num_frames)
+      {
+        for (size_t ch = 0; ch < num_channels_; ++ch)
+          {
+            in_ptrs_[ch] = frames[ch] + num_done;
+          }
+        const auto num_out =
+          process_chunk (in_ptrs_.data (), num_frames - num_done);
+        num_done += last_num_in_done_;
+        if (last_num_in_done_ == 0 && num_out == 0)
+          {
+            throw ZrythmException ("soxr_process() made no progress");
+          }
+      }
+  }
+
+  void finish ()
+  {
+    while (process_chunk (nullptr, 0) > 0)
+      ;
+  }
+
+public:
+  soxr_t priv_ = nullptr;
+
+  size_t num_channels_;
+  size_t chunk_frames_;
+  Sink   sink_;
+
+  /** Output chunk. */
+  utils::audio::AudioBuffer out_frames_;
+  std::vector<float *>      out_ptrs_;
+
+  /** Pointers to the input frames not consumed yet. */
+  std::vector<const float *> in_ptrs_;
+
+  /** Input frames consumed by the last process_chunk() call. */
+  size_t last_num_in_done_ = 0;
+};
+
+StreamingResampler::StreamingResampler (
+  size_t             num_channels,
+  double             input_rate,
+  double             output_rate,
+  Resampler::Quality quality,
+  Sink               sink,
+  size_t             chunk_frames,
+  unsigned int       num_threads)
+    : pimpl_ (std::make_unique<Impl> (
+        num_channels,
+        input_rate,
+        output_rate,
+        quality,
+        std::move (sink),
+        chunk_frames,
+        num_threads))
+{
+}
+
+StreamingResampler::~StreamingResampler () = default;
+
+void
+StreamingResampler::process (const float * const * frames, size_t num_frames)
+{
+  pimpl_->process (frames, num_frames);
+}
+
+void
+StreamingResampler::finish ()
+{
+  pimpl_->finish ();
+}
+
+RealtimeResampler::RealtimeResampler (
+  size_t num_channels,
+  double input_rate,
+  double output_rate)
+    : num_channels_ (num_channels), ratio_ (input_rate / output_rate),
+      history_ (num_channels * HISTORY_SIZE, 0.f)
+{
+  reset ();
+}
+
+void
+RealtimeResampler::reset ()
+{
+  std::ranges::fill (history_, 0.f);
+
+  /* the first output frame is at the first input frame, once it moved to
+   * the second slot of the history */
+  position_ = static_cast<double> (HISTORY_SIZE - 1);
+}
+
+size_t
+RealtimeResampler::get_input_frames_needed (size_t num_out_frames) const
+{
+  if (num_out_frames == 0)
+    return 0;
+
+  const double last_position =
+    position_ + static_cast<double> (num_out_frames - 1) * ratio_;
+  return static_cast<size_t> (std::floor (last_position));
+}
+
+std::pair<size_t, size_t>
+RealtimeResampler::process (
+  const float * const * in_frames,
+  size_t                num_in_frames,
+  float * const *       out_frames,
+  size_t                num_out_frames)
+{
+  size_t num_in_done = 0;
+  size_t num_out_done = 0;
+  while (num_out_done < num_out_frames)
+    {
+      /* move to the input frames around the next output frame */
+      while (position_ >= 1.0)
+        {
+          if (num_in_done == num_in_frames)
+            return { num_in_done, num_out_done };
+
+          for (size_t ch = 0; ch < num_channels_; ++ch)
+            {
+              float * h = &history_[ch * HISTORY_SIZE];
+              std::copy (h + 1, h + HISTORY_SIZE, h);
+              h[HISTORY_SIZE - 1] = in_frames[ch][num_in_done];
+            }
+          ++num_in_done;
+          position_ -= 1.0;
+        }
+
+      const auto t = static_cast<float> (position_);
+      if (fast_)
+        {
+          /* linear interpolation between the 2nd and 3rd frames */
+          for (size_t ch = 0; ch < num_channels_; ++ch)
+            {
+              const float * h = &history_[ch * HISTORY_SIZE];
+              out_frames[ch][num_out_done] = h[1] + t * (h[2] - h[1]);
+            }
+          ++num_out_done;
+          position_ += ratio_;
+          continue;
+        }
+
+      /* Catmull-Rom interpolation between the 2nd and 3rd frames */
+      for (size_t ch = 0; ch < num_channels_; ++ch)
+        {
+          const float * h = &history_[ch * HISTORY_SIZE];
+          const float   c1 = 0.5f * (h[2] - h[0]);
+          const float   c2 = h[0] - 2.5f * h[1] + 2.f * h[2] - 0.5f * h[3];
+          const float   c3 = 0.5f * (h[3] - h[0]) + 1.5f * (h[1] - h[2]);
+          out_frames[ch][num_out_done] = ((c3 * t + c2) * t + c1) * t + h[1];
+        }
+      ++num_out_done;
+      position_ += ratio_;
+    }
+
+  return { num_in_done, num_out_done };
+}
@@ -6,6 +6,10 @@
 
 #include "zrythm-config.h"
 
+#include <functional>
+#include <utility>
+#include <vector>
+
 #include "juce_wrapper.h"
 #include "utils/types.h"
 
@@ -76,6 +80,145 @@ private:
   std::unique_ptr<Impl> pimpl_;
 };
 
+/**
+ * Streaming audio resampler.
+ *
+ * Planar input is added in chunks of any size and the resampled frames are
+ * passed to a sink in chunks of at most the given size as they become
+ * available, so neither the input nor the output has to fit in memory (e.g.,
+ * when converting a large file into another file).
+ *
+ * SoXR's multi-threaded mode is enabled, so channels are resampled in
+ * parallel where SoXR supports it.
+ */
+class StreamingResampler
+{
+public:
+  /**
+   * Receives planar output frames, which are only valid during the call.
+   */
+  using Sink = std::function<void (
+    const float * const * frames,
+    size_t                num_channels,
+    size_t                num_frames)>;
+
+  static constexpr size_t DEFAULT_CHUNK_FRAMES = 16384;
+
+  /**
+   * @param num_threads Number of threads SoXR may use (0 to let SoXR
+   * decide, 1 for single-threaded).
+   *
+   * @throw ZrythmException on error.
+   */
+  StreamingResampler (
+    size_t             num_channels,
+    double             input_rate,
+    double             output_rate,
+    Resampler::Quality quality,
+    Sink               sink,
+    size_t             chunk_frames = DEFAULT_CHUNK_FRAMES,
+    unsigned int       num_threads = 0);
+
+  ~StreamingResampler ();
+
+  /**
+   * @brief Resamples the given planar frames, passing any output available
+   * to the sink.
+   *
+   * @throw ZrythmException on error.
+   */
+  void process (const float * const * frames, size_t num_frames);
+
+  /**
+   * @brief Passes the remaining output to the sink.
+   *
+   * To be called once after the last input was processed.
+   *
+   * @throw ZrythmException on error.
+   */
+  void finish ();
+
+private:
+  class Impl;
+  std::unique_ptr<Impl> pimpl_;
+};
+
+/**
+ * Fast, lower quality resampler that is realtime-safe.
+ *
+ * Uses 4-point cubic (Hermite) interpolation, with all the state allocated
+ * on construction, so it can be used in the audio thread (e.g., to preview
+ * files at a sample rate different from the engine's without resampling them
+ * first). It does not filter, so downsampling may alias.
+ */
+class RealtimeResampler
+{
+public:
+  RealtimeResampler (
+    size_t num_channels,
+    double input_rate,
+    double output_rate);
+
+  /**
+   * @brief Returns the number of input frames process() needs to produce
+   * the given number of output frames.
+   */
+  [[nodiscard]] size_t get_input_frames_needed (size_t num_out_frames) const;
+
+  /**
+   * @brief Resamples the given planar frames.
+   *
+   * Stops when either @p num_out_frames were produced or all the input was
+   * consumed. Input frames not consumed should be passed again in the next
+   * call.
+   *
+   * @return The number of input frames consumed and the number of output
+   * frames produced.
+   */
+  [[gnu::hot]] std::pair<size_t, size_t> process (
+    const float * const * in_frames,
+    size_t                num_in_frames,
+    float * const *       out_frames,
+    size_t                num_out_frames);
+
+  /**
+   * @brief Forgets the previous input (e.g., when seeking).
+   */
+  void reset ();
+
+  /**
+   * @brief Switches to linear interpolation (faster but duller and more
+   * aliased) or back to cubic interpolation.
+   *
+   * Takes effect from the next output frame.
+   */
+  void set_fast (bool fast) { fast_ = fast; }
+
+  bool is_fast () const { return fast_; }
+
+  size_t get_num_channels () const { return num_channels_; }
+
+private:
+  static constexpr size_t HISTORY_SIZE = 4;
+
+  size_t num_channels_;
+
+  /** Whether to use linear interpolation. */
+  bool fast_ = false;
+
+  /** Input frames per output frame. */
+  double ratio_;
+
+  /**
+   * Position of the next output frame after the second frame in the
+   * history, in input frames.
+   */
+  double position_ = 0.0;
+
+  /** Last HISTORY_SIZE input frames of each channel, oldest first. */
+  std::vector<float> history_;
+};
+
 /**
  * @}
  */
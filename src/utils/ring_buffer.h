@@ -11,7 +11,9 @@
 #ifndef __UTILS_RING_BUFFER_H__
 #define __UTILS_RING_BUFFER_H__
 
+#include <algorithm>
 #include <atomic>
+#include <bit>
 #include <cstddef>
 #include <memory>
 
@@ -35,18 +37,23 @@
  *
  * The `capacity`, `write_space`, and `read_space` functions can be used to
  * query the current state of the buffer.
+ *
+ * The `*_multiple` functions copy the elements in at most 2 blocks (before and
+ * after the wrap point). Positions are wrapped with a mask if the capacity is
+ * one less than a power of 2.
  */
 template <typename T> class RingBuffer
 {
 public:
   explicit RingBuffer (size_t size)
-      : size_ (size + 1), buf_ (std::make_unique<T[]> (size_)), read_head_ (0),
-        write_head_ (0)
+      : size_ (size + 1), mask_ (get_mask (size_)),
+        buf_ (std::make_unique<T[]> (size_)), read_head_ (0), write_head_ (0)
   {
   }
 
   RingBuffer (const RingBuffer &other)
-      : size_ (other.size_), buf_ (std::make_unique<T[]> (other.size_)),
+      : size_ (other.size_), mask_ (other.mask_),
+        buf_ (std::make_unique<T[]> (other.size_)),
         read_head_ (other.read_head_.load ()),
         write_head_ (other.write_head_.load ())
   {
@@ -129,47 +136,54 @@ public:
   {
     const size_t write_pos = write_head_.load (std::memory_order_relaxed);
     const size_t read_pos = read_head_.load (std::memory_order_acquire);
-    const size_t available_space = (read_pos - write_pos - 1 + size_) % size_;
+    const size_t available_space =
+      capacity () - get_distance (read_pos, write_pos);
 
     if (count > available_space)
       {
         return false;
       }
 
-    for (size_t i = 0; i < count; ++i)
-      {
-        buf_[(write_pos + i) % size_] = src[i];
-      }
-
-    write_head_.store ((write_pos + count) % size_, std::memory_order_release);
+    copy_to_buf (write_pos, src, count);
+    write_head_.store (wrap (write_pos + count), std::memory_order_release);
     return true;
   }
 
+  /**
+   * @brief Writes @p count elements, dropping the oldest elements if there is
+   * not enough space.
+   *
+   * If @p count exceeds the capacity, only the last elements of @p src are
+   * written.
+   */
   void force_write_multiple (const T * src, size_t count)
   {
-    size_t write_pos = write_head_.load (std::memory_order_relaxed);
-    size_t read_pos = read_head_.load (std::memory_order_acquire);
-
-    for (size_t i = 0; i < count; ++i)
+    if (count > capacity ())
       {
-        buf_[write_pos] = src[i];
-        write_pos = increment_pos (write_pos);
-
-        if (write_pos == read_pos)
-          {
-            read_pos = increment_pos (read_pos);
-          }
+        src += count - capacity ();
+        count = capacity ();
       }
 
-    write_head_.store (write_pos, std::memory_order_release);
-    read_head_.store (read_pos, std::memory_order_release);
+    const size_t write_pos = write_head_.load (std::memory_order_relaxed);
+    const size_t read_pos = read_head_.load (std::memory_order_acquire);
+    const size_t available_space =
+      capacity () - get_distance (read_pos, write_pos);
+
+    copy_to_buf (write_pos, src, count);
+    write_head_.store (wrap (write_pos + count), std::memory_order_release);
+    if (count > available_space)
+      {
+        read_head_.store (
+          wrap (read_pos + (count - available_space)),
+          std::memory_order_release);
+      }
   }
 
   bool skip (size_t num_elements)
   {
     const size_t read_pos = read_head_.load (std::memory_order_relaxed);
     const size_t write_pos = write_head_.load (std::memory_order_acquire);
-    const size_t available_elements = (write_pos - read_pos) % size_;
+    const size_t available_elements = get_distance (read_pos, write_pos);
 
     if (num_elements > available_elements)
       {
@@ -177,7 +191,7 @@ public:
       }
 
     read_head_.store (
-      (read_pos + num_elements) % size_, std::memory_order_release);
+      wrap (read_pos + num_elements), std::memory_order_release);
     return true;
   }
 
@@ -237,14 +251,10 @@ public:
   {
     const size_t read_pos = read_head_.load (std::memory_order_acquire);
     const size_t write_pos = write_head_.load (std::memory_order_acquire);
-    const size_t available = (write_pos - read_pos + size_) % size_;
+    const size_t available = get_distance (read_pos, write_pos);
 
     size_t peeked = std::min (count, available);
-
-    for (size_t i = 0; i < peeked; ++i)
-      {
-        dst[i] = buf_[(read_pos + i) % size_];
-      }
+    copy_from_buf (read_pos, dst, peeked);
 
     return peeked;
   }
@@ -257,32 +267,13 @@ public:
 
   size_t capacity () const { return size_ - 1; }
 
-  size_t write_space () const
-  {
-    size_t read_pos = read_head_.load (std::memory_order_relaxed);
-    size_t write_pos = write_head_.load (std::memory_order_relaxed);
-    if (write_pos >= read_pos)
-      {
-        return (size_ - write_pos) + read_pos - 1;
-      }
-    else
-      {
-        return read_pos - write_pos - 1;
-      }
-  }
+  size_t write_space () const { return capacity () - read_space (); }
 
   size_t read_space () const
   {
-    size_t read_pos = read_head_.load (std::memory_order_relaxed);
-    size_t write_pos = write_head_.load (std::memory_order_relaxed);
-    if (write_pos >= read_pos)
-      {
-        return write_pos - read_pos;
-      }
-    else
-      {
-        return (size_ - read_pos) + write_pos;
-      }
+    return get_distance (
+      read_head_.load (std::memory_order_relaxed),
+      write_head_.load (std::memory_order_relaxed));
   }
 
   bool can_read_multiple (size_t count) const { return count <= read_space (); }
@@ -291,29 +282,70 @@ public:
   {
     const size_t read_pos = read_head_.load (std::memory_order_relaxed);
     const size_t write_pos = write_head_.load (std::memory_order_acquire);
-    const size_t available = (write_pos - read_pos + size_) % size_;
+    const size_t available = get_distance (read_pos, write_pos);
 
     if (count > available)
       {
         return false;
       }
 
-    for (size_t i = 0; i < count; ++i)
+    copy_from_buf (read_pos, dst, count);
+    read_head_.store (wrap (read_pos + count), std::memory_order_release);
+    return true;
+  }
+
+private:
+  static size_t get_mask (size_t size)
+  {
+    return std::has_single_bit (size) ? size - 1 : 0;
+  }
+
+  /**
+   * @brief Wraps a position that is less than twice the size of the buffer.
+   */
+  size_t wrap (size_t pos) const
+  {
+    if (mask_ != 0)
       {
-        dst[i] = buf_[(read_pos + i) % size_];
+        return pos & mask_;
       }
+    return pos >= size_ ? pos - size_ : pos;
+  }
 
-    read_head_.store ((read_pos + count) % size_, std::memory_order_release);
-    return true;
+  size_t increment_pos (size_t pos) const { return wrap (pos + 1); }
+
+  /**
+   * @brief Returns the number of elements from @p read_pos to @p write_pos.
+   */
+  size_t get_distance (size_t read_pos, size_t write_pos) const
+  {
+    return wrap (write_pos + size_ - read_pos);
   }
 
-private:
-  size_t increment_pos (size_t pos) const { return (pos + 1) % size_; }
+  void copy_to_buf (size_t pos, const T * src, size_t count)
+  {
+    const size_t first = std::min (count, size_ - pos);
+    std::copy_n (src, first, buf_.get () + pos);
+    std::copy_n (src + first, count - first, buf_.get ());
+  }
+
+  void copy_from_buf (size_t pos, T * dst, size_t count) const
+  {
+    const size_t first = std::min (count, size_ - pos);
+    std::copy_n (buf_.get () + pos, first, dst);
+    std::copy_n (buf_.get (), count - first, dst + first);
+  }
+
+  const size_t size_;
 
-  const size_t         size_;
+  /** `size_ - 1` if @ref size_ is a power of 2, otherwise 0. */
+  const size_t         mask_;
   std::unique_ptr<T[]> buf_;
-  std::atomic<size_t>  read_head_;
-  std::atomic<size_t>  write_head_;
+
+  /* on separate cache lines to avoid false sharing between the producer and
+   * the consumer */
+  alignas (64) std::atomic<size_t> read_head_;
+  alignas (64) std::atomic<size_t> write_head_;
 };
 
 #endif // __UTILS_RING_BUFFER_H__
\ No newline at end of file
@@ -0,0 +1,325 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-config.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+
+#include "utils/backtrace.h"
+#include "utils/rt_guard.h"
+#include <fmt/format.h>
+#include <magic_enum.hpp>
+
+#if ZRYTHM_RT_GUARD
+#  include <cerrno>
+#  include <cstdlib>
+#  include <new>
+#  if defined(__linux__)
+#    define RT_GUARD_INTERCEPT_LOCKS 1
+#    include <dlfcn.h>
+#    include <pthread.h>
+#    include <semaphore.h>
+#  else
+#    define RT_GUARD_INTERCEPT_LOCKS 0
+#  endif
+#endif
+
+namespace zrythm::utils
+{
+
+namespace
+{
+
+struct Violation
+{
+  RtGuard::ViolationType type_{};
+  RawBacktrace           backtrace_;
+};
+
+std::array<Violation, RtGuard::MAX_RECORDED_VIOLATIONS> violations;
+std::atomic<size_t>                                     num_violations{ 0 };
+
+#if ZRYTHM_RT_GUARD
+constinit thread_local int rt_depth = 0;
+constinit thread_local int suspend_depth = 0;
+#endif
+
+} // namespace
+
+#if ZRYTHM_RT_GUARD
+RtGuard::Scope::Scope () noexcept
+{
+  ++rt_depth;
+}
+
+RtGuard::Scope::~Scope () noexcept
+{
+  --rt_depth;
+}
+
+RtGuard::Suspend::Suspend () noexcept
+{
+  ++suspend_depth;
+}
+
+RtGuard::Suspend::~Suspend () noexcept
+{
+  --suspend_depth;
+}
+
+void
+RtGuard::check (ViolationType type) noexcept
+{
+  if (rt_depth == 0 || suspend_depth > 0) [[likely]]
+    return;
+
+  /* don't report what capturing the stack does */
+  ++suspend_depth;
+  const auto index = num_violations.fetch_add (1, std::memory_order_relaxed);
+  if (index < MAX_RECORDED_VIOLATIONS)
+    {
+      auto &violation = violations[index];
+      violation.type_ = type;
+      violation.backtrace_.capture ();
+    }
+  --suspend_depth;
+}
+#endif
+
+size_t
+RtGuard::get_num_violations ()
+{
+  return num_violations.load (std::memory_order_relaxed);
+}
+
+std::string
+RtGuard::get_report ()
+{
+  const auto num = get_num_violations ();
+  auto       ret = fmt::format ("{} realtime violation(s)", num);
+  for (size_t i = 0; i < std::min (num, MAX_RECORDED_VIOLATIONS); ++i)
+    {
+      ret += fmt::format (
+        "\n#{} {}:\n{}", i, magic_enum::enum_name (violations[i].type_),
+        violations[i].backtrace_.to_string ());
+    }
+  return ret;
+}
+
+void
+RtGuard::reset ()
+{
+  for (auto &violation : violations)
+    {
+      violation.backtrace_.clear ();
+    }
+  num_violations.store (0, std::memory_order_relaxed);
+}
+
+} // namespace zrythm::utils
+
+#if ZRYTHM_RT_GUARD
+
+using zrythm::utils::RtGuard;
+
+#  if defined(__GLIBC__)
+
+/* replace the allocation functions, forwarding to glibc's implementation */
+extern "C"
+{
+  void * __libc_malloc (size_t size);
+  void   __libc_free (void * ptr);
+  void * __libc_calloc (size_t num, size_t size);
+  void * __libc_realloc (void * ptr, size_t size);
+  void * __libc_memalign (size_t alignment, size_t size);
+
+  void * malloc (size_t size) noexcept
+  {
+    RtGuard::check (RtGuard::ViolationType::Allocation);
+    return __libc_malloc (size);
+  }
+
+  void free (void * ptr) noexcept
+  {
+    if (ptr)
+      RtGuard::check (RtGuard::ViolationType::Deallocation);
+    __libc_free (ptr);
+  }
+
+  void * calloc (size_t num, size_t size) noexcept
+  {
+    RtGuard::check (RtGuard::ViolationType::Allocation);
+    return __libc_calloc (num, size);
+  }
+
+  void * realloc (void * ptr, size_t size) noexcept
+  {
+    RtGuard::check (RtGuard::ViolationType::Allocation);
+    return __libc_realloc (ptr, size);
+  }
+
+  void * memalign (size_t alignment, size_t size) noexcept
+  {
+    RtGuard::check (RtGuard::ViolationType::Allocation);
+    return __libc_memalign (alignment, size);
+  }
+
+  void * aligned_alloc (size_t alignment, size_t size) noexcept
+  {
+    RtGuard::check (RtGuard::ViolationType::Allocation);
+    return __libc_memalign (alignment, size);
+  }
+
+  int posix_memalign (void ** ptr, size_t alignment, size_t size) noexcept
+  {
+    RtGuard::check (RtGuard::ViolationType::Allocation);
+    if (
+      alignment % sizeof (void *) != 0
+      || (alignment & (alignment - 1)) != 0)
+      return EINVAL;
+
+    void * ret = __libc_memalign (alignment, size);
+    if (!ret)
+      return ENOMEM;
+
+    *ptr = ret;
+    return 0;
+  }
+}
+
+#  else
+
+/* no portable way to replace malloc(), so only catch operator new/delete
+ * (the aligned and nothrow versions call these by default) */
+void *
+operator new (std::size_t size)
+{
+  RtGuard::check (RtGuard::ViolationType::Allocation);
+  if (void * ptr = std::malloc (size != 0 ? size : 1))
+    return ptr;
+
+  throw std::bad_alloc ();
+}
+
+void *
+operator new[] (std::size_t size)
+{
+  return ::operator new (size);
+}
+
+void
+operator delete (void * ptr) noexcept
+{
+  if (ptr)
+    RtGuard::check (RtGuard::ViolationType::Deallocation);
+  std::free (ptr);
+}
+
+void
+operator delete[] (void * ptr) noexcept
+{
+  ::operator delete (ptr);
+}
+
+void
+operator delete (void * ptr, std::size_t) noexcept
+{
+  ::operator delete (ptr);
+}
+
+void
+operator delete[] (void * ptr, std::size_t) noexcept
+{
+  ::operator delete (ptr);
+}
+
+#  endif
+
+#  if RT_GUARD_INTERCEPT_LOCKS
+
+namespace
+{
+
+/**
+ * Returns the next definition of @p name (the one in libc), looking it up on
+ * first use.
+ */
+template <typename Func>
+Func
+get_real_func (std::atomic<Func> &cache, const char * name)
+{
+  auto func = cache.load (std::memory_order_relaxed);
+  if (!func) [[unlikely]]
+    {
+      func = reinterpret_cast<Func> (dlsym (RTLD_NEXT, name));
+      cache.store (func, std::memory_order_relaxed);
+    }
+  return func;
+}
+
+using MutexLockFunc = int (*) (pthread_mutex_t *);
+using RwlockFunc = int (*) (pthread_rwlock_t *);
+using SemWaitFunc = int (*) (sem_t *);
+using SemTimedWaitFunc = int (*) (sem_t *, const timespec *);
+
+std::atomic<MutexLockFunc>    real_pthread_mutex_lock{ nullptr };
+std::atomic<RwlockFunc>       real_pthread_rwlock_rdlock{ nullptr };
+std::atomic<RwlockFunc>       real_pthread_rwlock_wrlock{ nullptr };
+std::atomic<SemWaitFunc>      real_sem_wait{ nullptr };
+std::atomic<SemTimedWaitFunc> real_sem_timedwait{ nullptr };
+
+/* look up the functions early so that the lookup (which may allocate) doesn't
+ * happen on a realtime thread */
+[[maybe_unused]] const bool funcs_looked_up = [] () {
+  get_real_func (real_pthread_mutex_lock, "pthread_mutex_lock");
+  get_real_func (real_pthread_rwlock_rdlock, "pthread_rwlock_rdlock");
+  get_real_func (real_pthread_rwlock_wrlock, "pthread_rwlock_wrlock");
+  get_real_func (real_sem_wait, "sem_wait");
+  get_real_func (real_sem_timedwait, "sem_timedwait");
+  return true;
+}();
+
+} // namespace
+
+extern "C"
+{
+  int pthread_mutex_lock (pthread_mutex_t * mutex)
+  {
+    RtGuard::check (RtGuard::ViolationType::Lock);
+    return get_real_func (real_pthread_mutex_lock, "pthread_mutex_lock") (
+      mutex);
+  }
+
+  int pthread_rwlock_rdlock (pthread_rwlock_t * rwlock)
+  {
+    RtGuard::check (RtGuard::ViolationType::Lock);
+    return get_real_func (real_pthread_rwlock_rdlock, "pthread_rwlock_rdlock") (
+      rwlock);
+  }
+
+  int pthread_rwlock_wrlock (pthread_rwlock_t * rwlock)
+  {
+    RtGuard::check (RtGuard::ViolationType::Lock);
+    return get_real_func (real_pthread_rwlock_wrlock, "pthread_rwlock_wrlock") (
+      rwlock);
+  }
+
+  int sem_wait (sem_t * sem)
+  {
+    RtGuard::check (RtGuard::ViolationType::Lock);
+    return get_real_func (real_sem_wait, "sem_wait") (sem);
+  }
+
+  int sem_timedwait (sem_t * sem, const timespec * abs_timeout)
+  {
+    RtGuard::check (RtGuard::ViolationType::Lock);
+    return get_real_func (real_sem_timedwait, "sem_timedwait") (
+      sem, abs_timeout);
+  }
+}
+
+#  endif // RT_GUARD_INTERCEPT_LOCKS
+
+#endif // ZRYTHM_RT_GUARD
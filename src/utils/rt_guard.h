@@ -0,0 +1,106 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_RT_GUARD_H__
+#define __UTILS_RT_GUARD_H__
+
+#include "zrythm-config.h"
+
+#include <cstddef>
+#include <string>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Detects allocations and blocking waits on realtime threads (only for
+ * debugging).
+ *
+ * When built with ZRYTHM_RT_GUARD, the memory allocation functions (malloc()
+ * and friends on glibc, operator new/delete elsewhere) and, on POSIX, mutex,
+ * condition variable and semaphore waits are intercepted. Calls made while
+ * the calling thread is inside a Scope (and not inside a Suspend) are recorded
+ * as violations, along with their call stacks.
+ *
+ * Without ZRYTHM_RT_GUARD, Scope and Suspend do nothing and no violations are
+ * ever recorded.
+ */
+class RtGuard
+{
+public:
+  enum class ViolationType
+  {
+    Allocation,
+    Deallocation,
+    Lock,
+  };
+
+  /** Violations beyond this many are counted but their stacks are not kept. */
+  static constexpr size_t MAX_RECORDED_VIOLATIONS = 64;
+
+  /**
+   * @brief Marks the current thread as realtime while in scope.
+   *
+   * Scopes can be nested.
+   */
+  class Scope
+  {
+  public:
+#if ZRYTHM_RT_GUARD
+    Scope () noexcept;
+    ~Scope () noexcept;
+#endif
+    Scope (const Scope &) = delete;
+    Scope &operator= (const Scope &) = delete;
+  };
+
+  /**
+   * @brief Allows allocations and waits while in scope (e.g., for waiting on
+   * work, which is intended).
+   */
+  class Suspend
+  {
+  public:
+#if ZRYTHM_RT_GUARD
+    Suspend () noexcept;
+    ~Suspend () noexcept;
+#endif
+    Suspend (const Suspend &) = delete;
+    Suspend &operator= (const Suspend &) = delete;
+  };
+
+  static constexpr bool enabled () { return ZRYTHM_RT_GUARD; }
+
+  /**
+   * @brief Returns the number of violations since the last reset().
+   */
+  static size_t get_num_violations ();
+
+  /**
+   * @brief Returns a human-readable list of the recorded violations with
+   * their call stacks.
+   *
+   * Allocates, so it must not be called on realtime threads.
+   */
+  static std::string get_report ();
+
+  /**
+   * @brief Forgets the recorded violations.
+   *
+   * Must not be called while realtime threads may record violations.
+   */
+  static void reset ();
+
+#if ZRYTHM_RT_GUARD
+  /**
+   * @brief Records a violation if the current thread is realtime.
+   *
+   * Called by the interceptors. Does not allocate.
+   */
+  static void check (ViolationType type) noexcept;
+#endif
+};
+
+} // namespace zrythm::utils
+
+#endif // __UTILS_RT_GUARD_H__
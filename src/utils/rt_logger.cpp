@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <fmt/args.h>
+
+#include "utils/rt_logger.h"
+
+namespace zrythm::utils
+{
+
+RtLogger::RtLogger (size_t capacity)
+    : juce::Thread ("RtLogger"), queue_ (capacity)
+{
+  /* make sure the logger provider outlives the shared instance, which
+   * flushes to it when destroyed */
+  LoggerProvider::has_logger ();
+}
+
+RtLogger::~RtLogger ()
+{
+  stopThread (-1);
+  flush ();
+}
+
+RtLogger &
+RtLogger::instance ()
+{
+  static RtLogger   logger;
+  static const bool started = [] () {
+    logger.startThread ();
+    return true;
+  }();
+  (void) started;
+  return logger;
+}
+
+std::string
+RtLogger::format_record (const Record &record)
+{
+  fmt::dynamic_format_arg_store<fmt::format_context> store;
+  for (size_t i = 0; i < record.num_args_; ++i)
+    {
+      const auto &arg = record.args_[i];
+      switch (arg.type_)
+        {
+        case Arg::Type::Int:
+          store.push_back (arg.int_);
+          break;
+        case Arg::Type::UInt:
+          store.push_back (arg.uint_);
+          break;
+        case Arg::Type::Double:
+          store.push_back (arg.double_);
+          break;
+        case Arg::Type::Bool:
+          store.push_back (arg.bool_);
+          break;
+        case Arg::Type::String:
+          store.push_back (arg.str_);
+          break;
+        }
+    }
+
+  try
+    {
+      return fmt::vformat (record.fmt_, store);
+    }
+  catch (const fmt::format_error &e)
+    {
+      return fmt::format (
+        "(failed to format '{}': {})",
+        std::string_view (record.fmt_.data (), record.fmt_.size ()), e.what ());
+    }
+}
+
+size_t
+RtLogger::flush ()
+{
+  const auto &logger = LoggerProvider::logger ().get_logger ();
+
+  size_t num_written = 0;
+  Record record;
+  while (queue_.pop_front (record))
+    {
+      logger->log (record.loc_, record.level_, "{}", format_record (record));
+      ++num_written;
+    }
+
+  const auto num_dropped = get_num_dropped ();
+  if (num_dropped > num_dropped_reported_) [[unlikely]]
+    {
+      logger->warn (
+        "dropped {} realtime log records (queue full)",
+        num_dropped - num_dropped_reported_);
+      num_dropped_reported_ = num_dropped;
+    }
+  return num_written;
+}
+
+void
+RtLogger::run ()
+{
+  while (!threadShouldExit ())
+    {
+      flush ();
+      wait (FLUSH_INTERVAL_MS);
+    }
+}
+
+} // namespace zrythm::utils
@@ -0,0 +1,213 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_RT_LOGGER_H__
+#define __UTILS_RT_LOGGER_H__
+
+#include <array>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <string>
+
+#include "utils/logger.h"
+#include "utils/mpmc_queue.h"
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Argument types that can be logged from realtime threads.
+ *
+ * Strings must have static storage duration (e.g., literals), since they are
+ * only read when the record is formatted.
+ */
+template <typename T>
+concept RtLoggableArg =
+  std::integral<std::remove_cvref_t<T>>
+  || std::floating_point<std::remove_cvref_t<T>>
+  || std::same_as<std::decay_t<T>, const char *>;
+
+/**
+ * @brief Realtime-safe logging channel.
+ *
+ * Realtime threads push fixed-size records (the format string and up to
+ * MAX_ARGS numeric or static string arguments) to a lock-free queue, without
+ * formatting or allocating. A background thread formats them and writes them
+ * to the logger from LoggerProvider.
+ *
+ * Records that don't fit in the queue are dropped and counted; the number of
+ * dropped records is logged when the queue is flushed.
+ *
+ * Use the z_rt_* macros instead of the z_* macros on realtime threads.
+ */
+class RtLogger final : public juce::Thread
+{
+public:
+  static constexpr size_t MAX_ARGS = 6;
+  static constexpr size_t DEFAULT_CAPACITY = 1024;
+
+  /** How often the background thread flushes the queue (in ms). */
+  static constexpr int FLUSH_INTERVAL_MS = 50;
+
+  struct Arg
+  {
+    enum class Type : uint8_t
+    {
+      Int,
+      UInt,
+      Double,
+      Bool,
+      String,
+    };
+
+    Type type_ = Type::Int;
+    union
+    {
+      int64_t      int_;
+      uint64_t     uint_;
+      double       double_;
+      bool         bool_;
+      const char * str_;
+    };
+  };
+
+  struct Record
+  {
+    spdlog::level::level_enum level_ = spdlog::level::info;
+    spdlog::source_loc        loc_;
+    fmt::string_view          fmt_;
+    std::array<Arg, MAX_ARGS> args_;
+    uint8_t                   num_args_ = 0;
+  };
+
+  /**
+   * @brief Creates a logger without starting the background thread (records
+   * are only written on flush()).
+   */
+  explicit RtLogger (size_t capacity = DEFAULT_CAPACITY);
+  ~RtLogger () override;
+
+  /**
+   * @brief Returns the shared instance, starting its background thread on
+   * first use.
+   *
+   * The first call must not be on a realtime thread.
+   */
+  static RtLogger &instance ();
+
+  /**
+   * @brief Queues a record.
+   *
+   * Realtime-safe. The format string is checked at compile time.
+   *
+   * @return Whether the record was queued (false if it was dropped).
+   */
+  template <RtLoggableArg... Args>
+  bool log (
+    spdlog::level::level_enum   level,
+    spdlog::source_loc          loc,
+    fmt::format_string<Args...> fmt,
+    Args &&... args)
+  {
+    static_assert (sizeof...(Args) <= MAX_ARGS, "too many arguments");
+
+    Record record;
+    record.level_ = level;
+    record.loc_ = loc;
+    record.fmt_ = fmt::string_view (fmt);
+    record.num_args_ = sizeof...(Args);
+    [[maybe_unused]] size_t i = 0;
+    ((record.args_[i++] = make_arg (args)), ...);
+
+    if (!queue_.push_back (record)) [[unlikely]]
+      {
+        num_dropped_.fetch_add (1, std::memory_order_relaxed);
+        return false;
+      }
+    return true;
+  }
+
+  /**
+   * @brief Formats and writes the queued records (and reports dropped
+   * records).
+   *
+   * Not realtime-safe.
+   *
+   * @return The number of records written.
+   */
+  size_t flush ();
+
+  /**
+   * @brief Returns the number of records dropped because the queue was full.
+   */
+  size_t get_num_dropped () const
+  {
+    return num_dropped_.load (std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Formats a record the way flush() writes it.
+   */
+  static std::string format_record (const Record &record);
+
+private:
+  void run () override;
+
+  template <typename T> static Arg make_arg (T val)
+  {
+    using U = std::decay_t<T>;
+    Arg arg;
+    if constexpr (std::same_as<U, bool>)
+      {
+        arg.type_ = Arg::Type::Bool;
+        arg.bool_ = val;
+      }
+    else if constexpr (std::same_as<U, const char *>)
+      {
+        arg.type_ = Arg::Type::String;
+        arg.str_ = val;
+      }
+    else if constexpr (std::floating_point<U>)
+      {
+        arg.type_ = Arg::Type::Double;
+        arg.double_ = static_cast<double> (val);
+      }
+    else if constexpr (std::signed_integral<U>)
+      {
+        arg.type_ = Arg::Type::Int;
+        arg.int_ = static_cast<int64_t> (val);
+      }
+    else
+      {
+        arg.type_ = Arg::Type::UInt;
+        arg.uint_ = static_cast<uint64_t> (val);
+      }
+    return arg;
+  }
+
+  MPMCQueue<Record>   queue_;
+  std::atomic<size_t> num_dropped_{ 0 };
+
+  /** Number of dropped records already reported. */
+  size_t num_dropped_reported_ = 0;
+};
+
+} // namespace zrythm::utils
+
+#define Z_RT_LOG(level, ...) \
+  zrythm::utils::RtLogger::instance ().log ( \
+    level, spdlog::source_loc{ __FILE__, __LINE__, SPDLOG_FUNCTION }, \
+    __VA_ARGS__)
+
+/**
+ * @brief Realtime-safe versions of z_debug() and friends.
+ *
+ * Only numbers and static strings can be passed as arguments.
+ */
+#define z_rt_debug(...) Z_RT_LOG (spdlog::level::debug, __VA_ARGS__)
+#define z_rt_info(...) Z_RT_LOG (spdlog::level::info, __VA_ARGS__)
+#define z_rt_warning(...) Z_RT_LOG (spdlog::level::warn, __VA_ARGS__)
+#define z_rt_error(...) Z_RT_LOG (spdlog::level::err, __VA_ARGS__)
+
+#endif // __UTILS_RT_LOGGER_H__
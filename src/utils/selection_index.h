@@ -0,0 +1,94 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <functional>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Set of selected object IDs with constant-time insertion, removal and
+ * membership checks.
+ *
+ * Kept next to per-object selection flags so that selection queries and bulk
+ * operations only go through the selected objects instead of all of them.
+ *
+ * @tparam IdT An equality-comparable ID type, hashed with its hash() method
+ * if it has one (like UuidIdentifiableObject::Uuid) or with std::hash
+ * otherwise.
+ */
+template <typename IdT> class SelectionIndex
+{
+public:
+  void add (const IdT &id)
+  {
+    if (positions_.contains (id))
+      return;
+
+    positions_.emplace (id, ids_.size ());
+    ids_.push_back (id);
+  }
+
+  void remove (const IdT &id)
+  {
+    const auto it = positions_.find (id);
+    if (it == positions_.end ())
+      return;
+
+    /* move the last ID into the removed one's place */
+    const auto pos = it->second;
+    positions_.erase (it);
+    if (pos != ids_.size () - 1)
+      {
+        ids_[pos] = ids_.back ();
+        positions_[ids_[pos]] = pos;
+      }
+    ids_.pop_back ();
+  }
+
+  void set_selected (const IdT &id, bool selected)
+  {
+    if (selected)
+      add (id);
+    else
+      remove (id);
+  }
+
+  bool contains (const IdT &id) const { return positions_.contains (id); }
+
+  size_t size () const { return ids_.size (); }
+  bool   empty () const { return ids_.empty (); }
+
+  void clear ()
+  {
+    ids_.clear ();
+    positions_.clear ();
+  }
+
+  /**
+   * @brief Returns the selected IDs, in no particular order.
+   */
+  std::span<const IdT> get_ids () const { return ids_; }
+
+private:
+  struct Hash
+  {
+    size_t operator() (const IdT &id) const
+    {
+      if constexpr (requires { id.hash (); })
+        return id.hash ();
+      else
+        return std::hash<IdT>{}(id);
+    }
+  };
+
+  std::vector<IdT>                      ids_;
+  std::unordered_map<IdT, size_t, Hash> positions_;
+};
+
+} // namespace zrythm::utils
@@ -0,0 +1,224 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <bit>
+
+#include "utils/text_search_index.h"
+
+namespace zrythm::utils
+{
+
+namespace
+{
+constexpr size_t BITS_PER_WORD = 64;
+
+bool
+test_bit (const std::vector<uint64_t> &bits, size_t i)
+{
+  return (bits[i / BITS_PER_WORD] >> (i % BITS_PER_WORD)) & 1u;
+}
+
+void
+set_bit (std::vector<uint64_t> &bits, size_t i)
+{
+  bits[i / BITS_PER_WORD] |= uint64_t{ 1 } << (i % BITS_PER_WORD);
+}
+}
+
+std::string
+TextSearchIndex::to_lower (std::string_view str)
+{
+  std::string ret (str);
+  std::ranges::transform (ret, ret.begin (), [] (char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char> (c - 'A' + 'a') : c;
+  });
+  return ret;
+}
+
+TextSearchIndex::Trigram
+TextSearchIndex::make_trigram (std::string_view str, size_t pos)
+{
+  return static_cast<Trigram> (static_cast<uint8_t> (str[pos])) << 16
+         | static_cast<Trigram> (static_cast<uint8_t> (str[pos + 1])) << 8
+         | static_cast<Trigram> (static_cast<uint8_t> (str[pos + 2]));
+}
+
+void
+TextSearchIndex::build (std::span<const Document> documents)
+{
+  texts_.clear ();
+  texts_.reserve (documents.size ());
+  trigram_postings_.clear ();
+  facets_.clear ();
+  facet_values_.clear ();
+
+  std::vector<Trigram> trigrams;
+  for (size_t i = 0; i < documents.size (); ++i)
+    {
+      auto text = to_lower (documents[i].text_);
+      trigrams.clear ();
+      for (size_t pos = 0; pos + 3 <= text.size (); ++pos)
+        {
+          trigrams.push_back (make_trigram (text, pos));
+        }
+      std::ranges::sort (trigrams);
+      const auto [first, last] = std::ranges::unique (trigrams);
+      trigrams.erase (first, last);
+
+      /* documents are visited in order, so the postings stay sorted */
+      for (const auto trigram : trigrams)
+        {
+          trigram_postings_[trigram].push_back (static_cast<uint32_t> (i));
+        }
+      texts_.push_back (std::move (text));
+    }
+
+  size_t num_facets = 0;
+  for (const auto &doc : documents)
+    {
+      num_facets = std::max (num_facets, doc.facet_values_.size ());
+    }
+  facets_.resize (num_facets);
+  facet_values_.resize (num_facets);
+  const size_t num_words =
+    (documents.size () + BITS_PER_WORD - 1) / BITS_PER_WORD;
+  for (size_t facet = 0; facet < num_facets; ++facet)
+    {
+      for (size_t i = 0; i < documents.size (); ++i)
+        {
+          const auto &values = documents[i].facet_values_;
+          const auto &value =
+            facet < values.size () ? values[facet] : std::string{};
+          auto [it, inserted] = facets_[facet].try_emplace (value);
+          if (inserted)
+            {
+              it->second.resize (num_words);
+              facet_values_[facet].push_back (value);
+            }
+          set_bit (it->second, i);
+        }
+    }
+}
+
+void
+TextSearchIndex::filter_by_word (Bitset &candidates, std::string_view word)
+  const
+{
+  Bitset filtered (candidates.size ());
+  const auto check = [&] (size_t doc) {
+    if (
+      test_bit (candidates, doc)
+      && texts_[doc].find (word) != std::string::npos)
+      {
+        set_bit (filtered, doc);
+      }
+  };
+
+  if (word.size () < 3)
+    {
+      /* too short for trigrams, so check all the candidates */
+      for (size_t doc = 0; doc < texts_.size (); ++doc)
+        {
+          check (doc);
+        }
+      candidates = std::move (filtered);
+      return;
+    }
+
+  /* only the documents containing the word's rarest trigram may contain the
+   * word */
+  const std::vector<uint32_t> * rarest = nullptr;
+  for (size_t pos = 0; pos + 3 <= word.size (); ++pos)
+    {
+      const auto it = trigram_postings_.find (make_trigram (word, pos));
+      if (it == trigram_postings_.end ())
+        {
+          candidates = std::move (filtered);
+          return;
+        }
+      if (!rarest || it->second.size () < rarest->size ())
+        {
+          rarest = &it->second;
+        }
+    }
+  for (const auto doc : *rarest)
+    {
+      check (doc);
+    }
+  candidates = std::move (filtered);
+}
+
+std::vector<size_t>
+TextSearchIndex::search (const Query &query) const
+{
+  const size_t num_docs = texts_.size ();
+  Bitset       candidates (
+    (num_docs + BITS_PER_WORD - 1) / BITS_PER_WORD, ~uint64_t{ 0 });
+  if (num_docs % BITS_PER_WORD != 0)
+    {
+      candidates.back () = (uint64_t{ 1 } << (num_docs % BITS_PER_WORD)) - 1;
+    }
+
+  for (size_t facet = 0; facet < query.facet_values_.size (); ++facet)
+    {
+      const auto &value = query.facet_values_[facet];
+      if (!value)
+        continue;
+
+      /* documents without this facet have an empty value */
+      if (facet >= facets_.size ())
+        {
+          if (!value->empty ())
+            return {};
+          continue;
+        }
+
+      const auto it = facets_[facet].find (*value);
+      if (it == facets_[facet].end ())
+        return {};
+
+      for (size_t i = 0; i < candidates.size (); ++i)
+        {
+          candidates[i] &= it->second[i];
+        }
+    }
+
+  const auto       text = to_lower (query.text_);
+  std::string_view remaining = text;
+  while (!remaining.empty ())
+    {
+      const auto start = remaining.find_first_not_of (" \t");
+      if (start == std::string_view::npos)
+        break;
+
+      remaining.remove_prefix (start);
+      const auto end =
+        std::min (remaining.find_first_of (" \t"), remaining.size ());
+      filter_by_word (candidates, remaining.substr (0, end));
+      remaining.remove_prefix (end);
+    }
+
+  std::vector<size_t> ret;
+  for (size_t i = 0; i < candidates.size (); ++i)
+    {
+      auto word = candidates[i];
+      while (word != 0)
+        {
+          ret.push_back (i * BITS_PER_WORD + std::countr_zero (word));
+          word &= word - 1;
+        }
+    }
+  return ret;
+}
+
+std::vector<std::string>
+TextSearchIndex::get_facet_values (size_t facet) const
+{
+  if (facet >= facet_values_.size ())
+    return {};
+
+  return facet_values_[facet];
+}
+
+} // namespace zrythm::utils
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace zrythm::utils
+{
+
+/**
+ * @brief Index of documents for case-insensitive substring search, filtered by
+ * facets (e.g., category or author).
+ *
+ * Texts are indexed by their trigrams, so a query only checks the documents
+ * containing all the trigrams of its words instead of all the documents.
+ * Facet values are indexed as bitsets of the documents having them, so
+ * filtering by facets is a few bitwise ANDs.
+ *
+ * Case folding only applies to ASCII characters.
+ *
+ * The index is immutable after build(), so it can be queried from multiple
+ * threads.
+ */
+class TextSearchIndex
+{
+public:
+  struct Document
+  {
+    /** Searchable text. */
+    std::string text_;
+
+    /** Value of each facet (the same number of facets for all documents). */
+    std::vector<std::string> facet_values_;
+  };
+
+  struct Query
+  {
+    /**
+     * Whitespace-separated words that must all appear in the text (in any
+     * order).
+     */
+    std::string text_;
+
+    /**
+     * Required value of each facet, or nullopt to accept any value. May have
+     * less elements than the number of facets.
+     */
+    std::vector<std::optional<std::string>> facet_values_;
+  };
+
+  /**
+   * @brief Indexes @p documents, replacing the previous ones.
+   */
+  void build (std::span<const Document> documents);
+
+  size_t size () const { return texts_.size (); }
+  bool   empty () const { return texts_.empty (); }
+
+  /**
+   * @brief Returns the indices of the documents matching @p query, in
+   * ascending order.
+   */
+  std::vector<size_t> search (const Query &query) const;
+
+  /**
+   * @brief Returns the distinct values of facet @p facet, in order of first
+   * appearance.
+   */
+  std::vector<std::string> get_facet_values (size_t facet) const;
+
+private:
+  using Bitset = std::vector<uint64_t>;
+  using Trigram = uint32_t;
+
+  static std::string to_lower (std::string_view str);
+  static Trigram     make_trigram (std::string_view str, size_t pos);
+
+  /**
+   * @brief Removes the documents not containing @p word (lowercase) from
+   * @p candidates.
+   */
+  void filter_by_word (Bitset &candidates, std::string_view word) const;
+
+private:
+  /** Lowercase texts. */
+  std::vector<std::string> texts_;
+
+  /** Sorted indices of the documents containing each trigram. */
+  std::unordered_map<Trigram, std::vector<uint32_t>> trigram_postings_;
+
+  /** Documents having each value, for each facet. */
+  std::vector<std::unordered_map<std::string, Bitset>> facets_;
+
+  /** Values of each facet, in order of first appearance. */
+  std::vector<std::vector<std::string>> facet_values_;
+};
+
+} // namespace zrythm::utils
@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __UTILS_TRACING_H__
+#define __UTILS_TRACING_H__
+
+#include "zrythm-config.h"
+
+/**
+ * @file
+ *
+ * Profiler zones for the Tracy profiler (https://github.com/wolfpld/tracy).
+ *
+ * When built with ZRYTHM_TRACING, the macros below mark zones (timed scopes)
+ * that show up in the Tracy timeline when a Tracy server is connected.
+ * Otherwise they expand to nothing.
+ *
+ * All the macros are realtime-safe, with the caveat that names passed to
+ * Z_TRACE_ZONE_NAMED() must not be created on the realtime thread.
+ */
+
+#if ZRYTHM_TRACING
+
+#  include <tracy/Tracy.hpp>
+
+/** Marks the rest of the current scope as a zone called @p name (a literal). */
+#  define Z_TRACE_ZONE(name) ZoneScopedN (name)
+
+/**
+ * Marks the rest of the current scope as a zone called @p name (a string
+ * with data() and size(), e.g. a std::string cached off the realtime thread).
+ */
+#  define Z_TRACE_ZONE_NAMED(name) \
+    ZoneScoped; \
+    ZoneName ((name).data (), (name).size ())
+
+/** Marks the end of a frame (an engine cycle). */
+#  define Z_TRACE_FRAME_MARK(name) FrameMarkNamed (name)
+
+/** Names the current thread in the profiler (@p name is copied). */
+#  define Z_TRACE_SET_THREAD_NAME(name) tracy::SetThreadName (name)
+
+#else
+
+#  define Z_TRACE_ZONE(name)
+#  define Z_TRACE_ZONE_NAMED(name)
+#  define Z_TRACE_FRAME_MARK(name)
+#  define Z_TRACE_SET_THREAD_NAME(name)
+
+#endif
+
+#endif // __UTILS_TRACING_H__
@@ -189,6 +189,13 @@ public:
    * Number of frames to process in this call, starting from the offset.
    */
   nframes_t nframes_ = 0;
+
+  /**
+   * Monotonic time in microseconds at the start of the processing cycle.
+   *
+   * Processors should use this instead of querying the clock.
+   */
+  RtTimePoint cycle_start_time_usecs_ = 0;
 };
 
 /**
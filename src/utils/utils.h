@@ -9,6 +9,7 @@
 #include "./color.h"
 #include "./compression.h"
 #include "./concurrency.h"
+#include "./cpu_affinity.h"
 #include "./cpu_windows.h"
 #include "./datetime.h"
 #include "./directory_manager.h"
@@ -45,4 +46,5 @@
 #include "./symap.h"
 #include "./windows.h"
 #include "./windows_errors.h"
+#include "./work_stealing_deque.h"
 #include "./yaml.h"
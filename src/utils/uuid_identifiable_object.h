@@ -3,6 +3,10 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstdint>
+#include <limits>
+
 #include "utils/format.h"
 #include "utils/iserializable.h"
 #include "utils/object_factory.h"
@@ -87,6 +91,74 @@ template <typename T>
 concept UuidIdentifiableQObject =
   UuidIdentifiable<T> && std::derived_from<T, QObject>;
 
+/**
+ * @brief Compact runtime reference to an object in an OwningObjectRegistry.
+ *
+ * A handle is the index of the object's slot in the registry plus the slot's
+ * generation, which changes when the object is unregistered, so stale handles
+ * are detected instead of resolving to whatever object reuses the slot.
+ *
+ * Handles are only meaningful for the registry instance that created them and
+ * are never serialized (UUIDs are used for that).
+ */
+struct ObjectHandle
+{
+  static constexpr uint32_t NULL_INDEX = std::numeric_limits<uint32_t>::max ();
+
+  bool is_null () const { return index_ == NULL_INDEX; }
+
+  uint64_t pack () const
+  {
+    return (static_cast<uint64_t> (generation_) << 32) | index_;
+  }
+
+  static ObjectHandle unpack (uint64_t packed)
+  {
+    return {
+      .index_ = static_cast<uint32_t> (packed & 0xFFFFFFFF),
+      .generation_ = static_cast<uint32_t> (packed >> 32),
+    };
+  }
+
+  bool operator== (const ObjectHandle &other) const = default;
+
+  uint32_t index_ = NULL_INDEX;
+  uint32_t generation_ = 0;
+};
+
+/**
+ * @brief Remembers the handle an ID last resolved to, so that repeated
+ * lookups of the same ID skip the hash lookup.
+ *
+ * Can be used from multiple threads. Copies start empty.
+ */
+class ObjectHandleCache
+{
+public:
+  ObjectHandleCache () = default;
+  ObjectHandleCache (const ObjectHandleCache &) { }
+  ObjectHandleCache &operator= (const ObjectHandleCache &)
+  {
+    reset ();
+    return *this;
+  }
+
+  ObjectHandle load () const
+  {
+    return ObjectHandle::unpack (packed_.load (std::memory_order_relaxed));
+  }
+
+  void store (ObjectHandle handle) const
+  {
+    packed_.store (handle.pack (), std::memory_order_relaxed);
+  }
+
+  void reset () { store ({}); }
+
+private:
+  mutable std::atomic<uint64_t> packed_ = ObjectHandle{}.pack ();
+};
+
 /**
  * @brief A registry that owns and manages objects identified by a UUID.
  *
@@ -95,6 +167,11 @@ concept UuidIdentifiableQObject =
  * and sets the parent to `this`. When an object is unregistered, the ownership
  * is released and the caller is responsible for deleting the object.
  *
+ * Besides by UUID, objects can be looked up by ObjectHandle, which resolves
+ * through a flat slot array instead of hashing the 128-bit UUID. Hot paths
+ * that repeatedly resolve the same UUID should use get_handle() once (or
+ * pass an ObjectHandleCache to find_by_id_or_throw()).
+ *
  * Intended to be used with variants of pointers to QObjects.
  *
  * @tparam VariantT A variant of raw pointers to QObject-derived classes.
@@ -175,6 +252,64 @@ public:
     return val.value ().get ();
   }
 
+  /**
+   * @brief Same as above, but first tries the handle @p cache last resolved
+   * @p id to, and updates it if needed.
+   */
+  [[gnu::hot]] const VariantT &
+  find_by_id_or_throw (const UuidType &id, const ObjectHandleCache &cache) const
+  {
+    const auto &uuid = type_safe::get (id);
+    const auto  cached = cache.load ();
+    if (
+      const auto * obj = find_by_handle (cached);
+      obj != nullptr && slots_[cached.index_].uuid_ == uuid)
+      {
+        return *obj;
+      }
+
+    const auto handle = get_handle (id);
+    if (handle.is_null ())
+      {
+        throw std::runtime_error (
+          fmt::format ("Object with id {} not found", uuid.toString ()));
+      }
+    cache.store (handle);
+    return slots_[handle.index_].object_;
+  }
+
+  /**
+   * @brief Returns the handle of the object with the given ID, or a null
+   * handle if there is no such object.
+   */
+  ObjectHandle get_handle (const UuidType &id) const
+  {
+    const auto it = slot_indices_.constFind (type_safe::get (id));
+    if (it == slot_indices_.cend ())
+      {
+        return {};
+      }
+    return { .index_ = *it, .generation_ = slots_[*it].generation_ };
+  }
+
+  /**
+   * @brief Returns the object the handle refers to, or nullptr if the handle
+   * is null or stale.
+   */
+  [[gnu::hot]] const VariantT * find_by_handle (ObjectHandle handle) const
+  {
+    if (handle.index_ >= slots_.size ())
+      {
+        return nullptr;
+      }
+    const auto &slot = slots_[handle.index_];
+    if (!slot.occupied_ || slot.generation_ != handle.generation_)
+      {
+        return nullptr;
+      }
+    return &slot.object_;
+  }
+
   bool contains (const UuidType &id) const
   {
     const auto &uuid = type_safe::get (id);
@@ -197,6 +332,7 @@ public:
           }
         obj->setParent (this);
         objects_by_id_.insert (type_safe::get (obj->get_uuid ()), obj);
+        acquire_slot (type_safe::get (obj->get_uuid ()), obj);
       },
       obj_ptr);
   }
@@ -223,6 +359,7 @@ public:
       }
 
     auto obj_var = objects_by_id_.take (type_safe::get (id));
+    release_slot (slot_indices_.take (type_safe::get (id)));
     std::visit ([&] (auto &&obj) { obj->setParent (nullptr); }, obj_var);
     return obj_var;
   }
@@ -255,15 +392,69 @@ public:
 
     if (ctx.is_deserializing ())
       {
-        for (auto &var : objects_by_id_.values ())
+        slots_.clear ();
+        free_slots_.clear ();
+        slot_indices_.clear ();
+        for (auto it = objects_by_id_.cbegin (); it != objects_by_id_.cend ();
+             ++it)
           {
-            std::visit ([&] (auto &&v) { v->setParent (this); }, var);
+            std::visit ([&] (auto &&v) { v->setParent (this); }, it.value ());
+            acquire_slot (it.key (), it.value ());
           }
       }
   }
 
+private:
+  struct Slot
+  {
+    VariantT object_{};
+    QUuid    uuid_;
+    uint32_t generation_ = 0;
+    bool     occupied_ = false;
+  };
+
+  void acquire_slot (const QUuid &uuid, VariantT obj)
+  {
+    uint32_t index{};
+    if (free_slots_.empty ())
+      {
+        index = static_cast<uint32_t> (slots_.size ());
+        slots_.emplace_back ();
+      }
+    else
+      {
+        index = free_slots_.back ();
+        free_slots_.pop_back ();
+      }
+    auto &slot = slots_[index];
+    slot.object_ = obj;
+    slot.uuid_ = uuid;
+    slot.occupied_ = true;
+    slot_indices_.insert (uuid, index);
+  }
+
+  void release_slot (uint32_t index)
+  {
+    auto &slot = slots_[index];
+    slot.object_ = VariantT{};
+    slot.uuid_ = QUuid ();
+    slot.occupied_ = false;
+
+    /* invalidate the handles to this slot */
+    ++slot.generation_;
+    free_slots_.push_back (index);
+  }
+
 private:
   QHash<QUuid, VariantT> objects_by_id_;
+
+  /**
+   * Objects by handle index. Slots are reused, with their generation bumped,
+   * after their object is unregistered.
+   */
+  std::vector<Slot>      slots_;
+  std::vector<uint32_t>  free_slots_;
+  QHash<QUuid, uint32_t> slot_indices_;
 };
 
 /**
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+/**
+ * @addtogroup utils
+ *
+ * @{
+ */
+
+/**
+ * @brief Fixed-capacity single-owner work-stealing deque.
+ *
+ * The owner thread pushes to and pops from the bottom end (LIFO, good cache
+ * locality), while any number of thief threads steal from the top end (FIFO).
+ *
+ * Based on the Chase-Lev deque as formulated for weak memory models in
+ * "Correct and Efficient Work-Stealing for Weak Memory Models" (Lê et al.,
+ * PPoPP 2013), minus the dynamic growth: the capacity must be reserved up front
+ * (outside the realtime threads) so that no operation allocates.
+ *
+ * @tparam T Element type. Must be trivially copyable (typically a pointer).
+ */
+template <typename T> class WorkStealingDeque
+{
+  static_assert (std::is_trivially_copyable_v<T>);
+
+public:
+  explicit WorkStealingDeque (size_t capacity = 8) { reserve (capacity); }
+
+  size_t capacity () const { return mask_ + 1; }
+
+  /**
+   * @brief Ensures there is space for at least @p capacity elements.
+   *
+   * @warning Not thread-safe. Must not be called while any other thread is
+   * using the deque. Existing elements are discarded if a reallocation is
+   * needed.
+   */
+  void reserve (size_t capacity)
+  {
+    size_t pot = 2;
+    while (pot < capacity)
+      pot <<= 1;
+    if (buf_ && pot <= this->capacity ())
+      return;
+
+    buf_ = std::make_unique<std::atomic<T>[]> (pot);
+    mask_ = pot - 1;
+    clear ();
+  }
+
+  /**
+   * @brief Discards all elements.
+   *
+   * @warning Not thread-safe.
+   */
+  void clear ()
+  {
+    top_.store (0, std::memory_order_relaxed);
+    bottom_.store (0, std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Pushes an element to the bottom end.
+   *
+   * Must only be called by the owner thread.
+   *
+   * @return Whether the element was pushed (false if the deque is full).
+   */
+  bool push (T value)
+  {
+    const int64_t b = bottom_.load (std::memory_order_relaxed);
+    const int64_t t = top_.load (std::memory_order_acquire);
+    if (b - t > static_cast<int64_t> (mask_)) [[unlikely]]
+      {
+        return false;
+      }
+    buf_[b & mask_].store (value, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+    bottom_.store (b + 1, std::memory_order_relaxed);
+    return true;
+  }
+
+  /**
+   * @brief Pops an element from the bottom end.
+   *
+   * Must only be called by the owner thread.
+   */
+  std::optional<T> pop ()
+  {
+    const int64_t b = bottom_.load (std::memory_order_relaxed) - 1;
+    bottom_.store (b, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    int64_t t = top_.load (std::memory_order_relaxed);
+
+    if (t > b)
+      {
+        /* empty */
+        bottom_.store (b + 1, std::memory_order_relaxed);
+        return std::nullopt;
+      }
+
+    T value = buf_[b & mask_].load (std::memory_order_relaxed);
+    if (t == b)
+      {
+        /* last element - race against thieves */
+        const bool won = top_.compare_exchange_strong (
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+        bottom_.store (b + 1, std::memory_order_relaxed);
+        if (!won)
+          return std::nullopt;
+      }
+    return value;
+  }
+
+  /**
+   * @brief Steals an element from the top end.
+   *
+   * May be called by any thread.
+   *
+   * @return The stolen element, or nullopt if the deque was empty or another
+   * thread won the race for the top element.
+   */
+  std::optional<T> steal ()
+  {
+    int64_t t = top_.load (std::memory_order_acquire);
+    std::atomic_thread_fence (std::memory_order_seq_cst);
+    const int64_t b = bottom_.load (std::memory_order_acquire);
+
+    if (t >= b)
+      {
+        return std::nullopt;
+      }
+
+    T value = buf_[t & mask_].load (std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong (
+          t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      {
+        return std::nullopt;
+      }
+    return value;
+  }
+
+  /**
+   * @brief Returns an approximation of the number of elements.
+   */
+  size_t size_approx () const
+  {
+    const int64_t b = bottom_.load (std::memory_order_relaxed);
+    const int64_t t = top_.load (std::memory_order_relaxed);
+    return b > t ? static_cast<size_t> (b - t) : 0;
+  }
+
+  bool empty_approx () const { return size_approx () == 0; }
+
+private:
+  alignas (64) std::atomic<int64_t> top_{ 0 };
+  alignas (64) std::atomic<int64_t> bottom_{ 0 };
+  alignas (64) std::unique_ptr<std::atomic<T>[]> buf_;
+  size_t mask_{};
+};
+
+/**
+ * @}
+ */
@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#ifndef __TESTS_BENCHMARKS_BENCHMARK_HELPERS_H__
+#define __TESTS_BENCHMARKS_BENCHMARK_HELPERS_H__
+
+#include <fstream>
+#include <string>
+#include <string_view>
+
+#include "tests/helpers/zrythm_helper.h"
+
+#include <benchmark/benchmark.h>
+
+/**
+ * @brief Concrete class to use in benchmarks.
+ */
+class BenchmarkZrythmFixture : public ZrythmFixture
+{
+public:
+  BenchmarkZrythmFixture () : ZrythmFixture (false, 0, 0, false, false)
+  {
+    SetUp ();
+  }
+  ~BenchmarkZrythmFixture () override { TearDown (); }
+  void TestBody () override { }
+};
+
+/**
+ * @brief Reports the peak resident set size reached during the benchmark as
+ * counters.
+ *
+ * The kernel's high water mark is reset on construction, so the peak doesn't
+ * include the project setup. "peak_rss_delta" is the growth over the resident
+ * size at that point, which is what allocations in the measured code show up
+ * in.
+ */
+class PeakMemoryCounter
+{
+public:
+  PeakMemoryCounter ()
+  {
+    std::ofstream ("/proc/self/clear_refs") << "5";
+    baseline_kib_ = read_status_kib ("VmRSS:");
+  }
+
+  void report (benchmark::State &state) const
+  {
+    const auto peak_kib = std::max (read_status_kib ("VmHWM:"), baseline_kib_);
+    state.counters["peak_rss"] = benchmark::Counter (
+      static_cast<double> (peak_kib * 1024), benchmark::Counter::kDefaults,
+      benchmark::Counter::kIs1024);
+    state.counters["peak_rss_delta"] = benchmark::Counter (
+      static_cast<double> ((peak_kib - baseline_kib_) * 1024),
+      benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+  }
+
+private:
+  /** Returns the given field of /proc/self/status in KiB, or 0. */
+  static int64_t read_status_kib (std::string_view field)
+  {
+    std::ifstream stream ("/proc/self/status");
+    std::string   line;
+    while (std::getline (stream, line))
+      {
+        if (line.starts_with (field))
+          {
+            return std::stoll (line.substr (field.size ()));
+          }
+      }
+    return 0;
+  }
+
+private:
+  int64_t baseline_kib_ = 0;
+};
+
+#endif
@@ -82,6 +82,36 @@ BM_DspFunctions (benchmark::State &state)
           dsp_mix_add2 (
             buf.data (), src.data (), src.data (), 0.1f, 0.2f, buf_size);
           break;
+        case 9:
+          {
+            /* unfused version of case 10 */
+            utils::float_ranges::add2 (buf.data (), src.data (), buf_size);
+            benchmark::DoNotOptimize (
+              utils::float_ranges::abs_max (buf.data (), buf_size));
+          }
+          break;
+        case 10:
+          benchmark::DoNotOptimize (utils::float_ranges::add2_with_peak (
+            buf.data (), src.data (), buf_size));
+          break;
+        case 11:
+          benchmark::DoNotOptimize (utils::float_ranges::mix_product_with_peak (
+            buf.data (), src.data (), 0.5f, buf_size));
+          break;
+        case 12:
+          {
+            /* unfused version of case 13 (as done for fader inputs) */
+            utils::float_ranges::add2 (buf.data (), src.data (), buf_size);
+            if (utils::float_ranges::abs_max (buf.data (), buf_size) > 2.f)
+              {
+                utils::float_ranges::clip (buf.data (), -2.f, 2.f, buf_size);
+              }
+          }
+          break;
+        case 13:
+          utils::float_ranges::add2_clamped (
+            buf.data (), src.data (), -2.f, 2.f, buf_size);
+          break;
         }
     }
 }
@@ -90,11 +120,93 @@ BM_DspFunctions (benchmark::State &state)
 static const std::vector<std::vector<int64_t>> argument_ranges = {
   { 0, 1 }, // First argument: optimized (0 or 1)
   { 0, 1 }, // Second argument: large buffer (0 or 1)
-  { 0, 1, 2, 3, 4, 5, 6, 7, 8 }  // Third argument: algorithm to run
+  // Third argument: algorithm to run
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13 }
 };
 
 BENCHMARK (BM_DspFunctions)->ArgsProduct (argument_ranges);
 
+/**
+ * @brief Runs the vectorized functions with each SIMD backend.
+ */
+static void
+BM_DspSimdBackends (benchmark::State &state)
+{
+  const auto backend = static_cast<utils::float_ranges::SimdBackend> (
+    state.range (0));
+  bool large_buff = state.range (1);
+  int  algo_to_run = state.range (2);
+
+  const auto prev_backend = utils::float_ranges::get_simd_backend ();
+  if (!utils::float_ranges::set_simd_backend (backend))
+    {
+      state.SkipWithError ("SIMD backend not supported on this machine");
+      return;
+    }
+  state.SetLabel (
+    std::string (utils::float_ranges::simd_backend_to_string (backend)));
+
+  std::vector<float> buf (LARGE_BUFFER_SIZE, 0.5f);
+  std::vector<float> src (LARGE_BUFFER_SIZE, 0.5f);
+
+  const size_t buf_size = large_buff ? LARGE_BUFFER_SIZE : BUFFER_SIZE;
+
+  for (auto _ : state)
+    {
+      switch (algo_to_run)
+        {
+        case 0:
+          utils::float_ranges::fill (buf.data (), 0.3f, buf_size);
+          break;
+        case 1:
+          utils::float_ranges::copy (buf.data (), src.data (), buf_size);
+          break;
+        case 2:
+          utils::float_ranges::add2 (buf.data (), src.data (), buf_size);
+          break;
+        case 3:
+          utils::float_ranges::mix_product (
+            buf.data (), src.data (), 0.5f, buf_size);
+          break;
+        case 4:
+          utils::float_ranges::mul_k2 (buf.data (), 0.99f, buf_size);
+          break;
+        case 5:
+          benchmark::DoNotOptimize (
+            utils::float_ranges::abs_max (buf.data (), buf_size));
+          break;
+        case 6:
+          utils::float_ranges::clip (buf.data (), -1.0f, 1.1f, buf_size);
+          break;
+        case 7:
+          utils::float_ranges::make_mono (
+            buf.data (), src.data (), buf_size, true);
+          break;
+        case 8:
+          utils::float_ranges::linear_fade_in_from (
+            buf.data (), 0, (int32_t) buf_size, buf_size, 0.f);
+          break;
+        case 9:
+          utils::float_ranges::linear_fade_out_to (
+            buf.data (), 0, (int32_t) buf_size, buf_size, 0.f);
+          break;
+        }
+      benchmark::ClobberMemory ();
+    }
+
+  utils::float_ranges::set_simd_backend (prev_backend);
+}
+
+static const std::vector<std::vector<int64_t>> simd_backend_argument_ranges = {
+  // First argument: SIMD backend (scalar, baseline, AVX2, AVX-512)
+  { 0, 1, 2, 3 },
+  { 0, 1 }, // Second argument: large buffer (0 or 1)
+  // Third argument: algorithm to run
+  { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 }
+};
+
+BENCHMARK (BM_DspSimdBackends)->ArgsProduct (simd_backend_argument_ranges);
+
 #if 0
 static void
 BM_RunEngine (benchmark::State &state)
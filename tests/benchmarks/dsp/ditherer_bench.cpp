@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cmath>
+#include <vector>
+
+#include "dsp/ditherer.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace zrythm::dsp;
+
+static void
+BM_Ditherer (benchmark::State &state)
+{
+  const auto         block_length = static_cast<int> (state.range (0));
+  std::vector<float> buf (block_length);
+
+  Ditherer ditherer;
+  ditherer.reset (16);
+  for (auto _ : state)
+    {
+      state.PauseTiming ();
+      for (int i = 0; i < block_length; i++)
+        {
+          buf[i] = 0.5f * std::sin (static_cast<float> (i) * 0.1f);
+        }
+      state.ResumeTiming ();
+
+      ditherer.process (buf.data (), block_length);
+      benchmark::DoNotOptimize (buf.data ());
+    }
+
+  state.SetItemsProcessed (state.iterations () * block_length);
+}
+
+BENCHMARK (BM_Ditherer)->ArgName ("block")->Arg (256)->Arg (1024)->Arg (8192);
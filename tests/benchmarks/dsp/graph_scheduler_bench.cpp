@@ -1,6 +1,7 @@
 #include "dsp/graph_node.h"
 #include "dsp/graph_scheduler.h"
 #include "dsp/graph_thread.h"
+#include "utils/rt_guard.h"
 
 #include <benchmark/benchmark.h>
 #include <gmock/gmock.h>
@@ -45,6 +46,101 @@ public:
     (const, override));
 };
 
+/**
+ * @brief Stopped transport with a short loop, so that most cycles cross the
+ * loop end point.
+ *
+ * Unlike MockTransport, this doesn't go through gmock (see
+ * SyntheticProcessable).
+ */
+class LoopingTransport final : public ITransport
+{
+public:
+  static constexpr double TICKS_PER_FRAME = 0.1;
+
+  explicit LoopingTransport (signed_frame_t loop_length)
+      : loop_end_ (loop_length, TICKS_PER_FRAME)
+  {
+  }
+
+  void position_add_frames (Position &pos, signed_frame_t frames) const override
+  {
+    pos.add_frames (frames, TICKS_PER_FRAME);
+    if (pos.frames_ >= loop_end_.frames_)
+      {
+        pos.from_frames (
+          pos.frames_ - loop_end_.frames_ + loop_start_.frames_,
+          TICKS_PER_FRAME);
+      }
+  }
+  std::pair<Position, Position> get_loop_range_positions () const override
+  {
+    return { loop_start_, loop_end_ };
+  }
+  PlayState get_play_state () const override { return PlayState::Paused; }
+  Position  get_playhead_position () const override { return loop_start_; }
+  bool      get_loop_enabled () const override { return true; }
+  nframes_t
+  is_loop_point_met (signed_frame_t g_start_frames, nframes_t nframes)
+    const override
+  {
+    if (
+      loop_end_.frames_ > g_start_frames
+      && loop_end_.frames_ <= g_start_frames + (signed_frame_t) nframes)
+      {
+        return (nframes_t) (loop_end_.frames_ - g_start_frames);
+      }
+    return 0;
+  }
+
+private:
+  Position loop_start_;
+  Position loop_end_;
+};
+
+/**
+ * @brief Processable that runs a configurable amount of typical DSP work on
+ * its own buffer.
+ *
+ * Unlike MockProcessable, this doesn't go through gmock (which locks a mutex
+ * on each call), so it can be used to model realistic per-node costs.
+ */
+class SyntheticProcessable final : public IProcessable
+{
+public:
+  static constexpr size_t MAX_BLOCK_SIZE = 4096;
+
+  /**
+   * @param work_units Number of passes over the buffer per cycle.
+   */
+  explicit SyntheticProcessable (int work_units)
+      : work_units_ (work_units), buffer_ (MAX_BLOCK_SIZE)
+  {
+  }
+
+  std::string get_node_name () const override { return "synthetic_node"; }
+
+  void process_block (EngineProcessTimeInfo time_nfo) override
+  {
+    const auto nframes =
+      std::min (static_cast<size_t> (time_nfo.nframes_), buffer_.size ());
+    for (int i = 0; i < work_units_; ++i)
+      {
+        zrythm::utils::float_ranges::fill (buffer_.data (), 0.5f, nframes);
+        zrythm::utils::float_ranges::mul_k2 (buffer_.data (), 0.8f, nframes);
+        zrythm::utils::float_ranges::clip (
+          buffer_.data (), -1.0f, 1.0f, nframes);
+        float peak =
+          zrythm::utils::float_ranges::abs_max (buffer_.data (), nframes);
+        benchmark::DoNotOptimize (peak);
+      }
+  }
+
+private:
+  int                work_units_;
+  std::vector<float> buffer_;
+};
+
 class GraphSchedulerBenchmark : public benchmark::Fixture
 {
 protected:
@@ -185,6 +281,211 @@ protected:
     return collection;
   }
 
+  /** Work units of light nodes (e.g., faders) and heavy nodes (plugins). */
+  static constexpr int LIGHT_NODE_COST = 1;
+  static constexpr int HEAVY_NODE_COST = 16;
+
+  /**
+   * @brief Adds a node backed by a SyntheticProcessable of the given cost.
+   */
+  GraphNode &add_synthetic_node (GraphNodeCollection &collection, int cost)
+  {
+    synthetic_processables_.push_back (
+      std::make_unique<SyntheticProcessable> (cost));
+    collection.graph_nodes_.push_back (std::make_unique<GraphNode> (
+      collection.graph_nodes_.size (),
+      looping_transport_ ? *looping_transport_ : *transport_,
+      *synthetic_processables_.back ()));
+    return *collection.graph_nodes_.back ();
+  }
+
+  /**
+   * @brief Adds a track (track processor -> plugin -> fader) and returns its
+   * plugin and fader nodes.
+   */
+  std::pair<GraphNode &, GraphNode &>
+  add_synthetic_track (GraphNodeCollection &collection, int plugin_cost)
+  {
+    auto &processor = add_synthetic_node (collection, LIGHT_NODE_COST);
+    auto &plugin = add_synthetic_node (collection, plugin_cost);
+    auto &fader = add_synthetic_node (collection, LIGHT_NODE_COST);
+    processor.connect_to (plugin);
+    plugin.connect_to (fader);
+    return { plugin, fader };
+  }
+
+  /**
+   * @brief Creates @p num_tracks tracks routed to a master track that feeds
+   * the monitor output.
+   *
+   * @param heavy_every Every this many tracks has a heavy plugin (the others
+   * have light ones). If 0, all plugins are heavy.
+   */
+  GraphNodeCollection create_fan_in (size_t num_tracks, size_t heavy_every)
+  {
+    GraphNodeCollection collection;
+    auto &master = add_synthetic_node (collection, HEAVY_NODE_COST);
+    auto &monitor = add_synthetic_node (collection, LIGHT_NODE_COST);
+    master.connect_to (monitor);
+    for (size_t i = 0; i < num_tracks; i++)
+      {
+        const bool heavy = heavy_every == 0 || i % heavy_every == 0;
+        auto &fader =
+          add_synthetic_track (
+            collection, heavy ? HEAVY_NODE_COST : LIGHT_NODE_COST)
+            .second;
+        fader.connect_to (master);
+      }
+    collection.finalize_nodes ();
+    return collection;
+  }
+
+  /**
+   * @brief Creates @p num_chains chains of @p depth heavy nodes (e.g., long
+   * plugin chains or nested group tracks) feeding a master node.
+   */
+  GraphNodeCollection create_deep_chains (size_t num_chains, size_t depth)
+  {
+    GraphNodeCollection collection;
+    auto &master = add_synthetic_node (collection, LIGHT_NODE_COST);
+    for (size_t c = 0; c < num_chains; c++)
+      {
+        GraphNode * prev = nullptr;
+        for (size_t n = 0; n < depth; n++)
+          {
+            auto &node = add_synthetic_node (collection, HEAVY_NODE_COST);
+            if (prev != nullptr)
+              {
+                prev->connect_to (node);
+              }
+            prev = &node;
+          }
+        prev->connect_to (master);
+      }
+    collection.finalize_nodes ();
+    return collection;
+  }
+
+  /**
+   * @brief Creates @p num_tracks tracks that each split into the master and
+   * a send to a shared reverb bus that rejoins at the master (diamonds), with
+   * every odd track's plugin sidechained from the previous track's plugin.
+   */
+  GraphNodeCollection create_diamonds (size_t num_tracks)
+  {
+    GraphNodeCollection collection;
+    auto &master = add_synthetic_node (collection, HEAVY_NODE_COST);
+    auto &reverb = add_synthetic_node (collection, HEAVY_NODE_COST);
+    reverb.connect_to (master);
+    GraphNode * prev_plugin = nullptr;
+    for (size_t i = 0; i < num_tracks; i++)
+      {
+        auto [plugin, fader] =
+          add_synthetic_track (collection, HEAVY_NODE_COST);
+        auto &send = add_synthetic_node (collection, LIGHT_NODE_COST);
+        plugin.connect_to (send);
+        send.connect_to (reverb);
+        fader.connect_to (master);
+        if (i % 2 == 1)
+          {
+            prev_plugin->connect_to (plugin);
+          }
+        prev_plugin = &plugin;
+      }
+    collection.finalize_nodes ();
+    return collection;
+  }
+
+  /**
+   * @brief Runs processing cycles on the given graph until the benchmark is
+   * done.
+   *
+   * Reports the median and 99th percentile cycle times (the worst cycles are
+   * what causes dropouts, so the mean alone is not enough to compare
+   * scheduling modes).
+   *
+   * If @ref looping_transport_ is set, each cycle continues from where the
+   * previous one ended within its loop.
+   */
+  void run_cycles (
+    benchmark::State   &state,
+    GraphNodeCollection collection,
+    int64_t             block_size,
+    int64_t             num_threads,
+    int64_t             strategy,
+    bool                graph_loop_splitting = true)
+  {
+    scheduler_ = std::make_unique<GraphScheduler> (
+      static_cast<GraphScheduler::SchedulingStrategy> (strategy));
+    scheduler_->set_graph_loop_splitting_enabled (graph_loop_splitting);
+    scheduler_->rechain_from_node_collection (std::move (collection));
+    scheduler_->start_threads (num_threads);
+
+    EngineProcessTimeInfo time_info{};
+    time_info.nframes_ = block_size;
+
+    Position            playhead;
+    std::vector<double> cycle_us;
+    cycle_us.reserve (state.max_iterations);
+    zrythm::utils::RtGuard::reset ();
+    for (auto _ : state)
+      {
+        if (looping_transport_)
+          {
+            time_info.g_start_frame_ = playhead.frames_;
+            time_info.g_start_frame_w_offset_ = playhead.frames_;
+          }
+        const auto start = std::chrono::steady_clock::now ();
+        {
+          zrythm::utils::RtGuard::Scope rt_guard_scope;
+          scheduler_->run_cycle (time_info, 0);
+        }
+        cycle_us.push_back (
+          std::chrono::duration<double, std::micro> (
+            std::chrono::steady_clock::now () - start)
+            .count ());
+        if (looping_transport_)
+          {
+            looping_transport_->position_add_frames (playhead, block_size);
+          }
+      }
+
+    scheduler_->terminate_threads ();
+
+    if constexpr (zrythm::utils::RtGuard::enabled ())
+      {
+        const auto num_violations =
+          zrythm::utils::RtGuard::get_num_violations ();
+        state.counters["rt_violations"] = static_cast<double> (num_violations);
+
+        /* only synthetic nodes are expected to be realtime-safe (gmock
+         * allocates to record calls) */
+        if (num_violations > 0 && !synthetic_processables_.empty ())
+          {
+            state.SkipWithError (
+              zrythm::utils::RtGuard::get_report ().c_str ());
+          }
+      }
+
+    if (!cycle_us.empty ())
+      {
+        /* nearest-rank percentiles */
+        auto percentile = [&] (size_t p) {
+          const auto idx = (cycle_us.size () * p + 99) / 100 - 1;
+          std::ranges::nth_element (
+            cycle_us, cycle_us.begin () + static_cast<ptrdiff_t> (idx));
+          return cycle_us[idx];
+        };
+        state.counters["p50_us"] = percentile (50);
+        state.counters["p99_us"] = percentile (99);
+      }
+  }
+
+  std::vector<std::unique_ptr<SyntheticProcessable>> synthetic_processables_;
+
+  /** If set, synthetic nodes use this instead of @ref transport_. */
+  std::unique_ptr<LoopingTransport> looping_transport_;
+
   std::unique_ptr<MockTransport>                    transport_;
   std::unique_ptr<MockProcessable>                  processable_;
   std::unique_ptr<GraphScheduler>                   scheduler_;
@@ -200,19 +501,10 @@ BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, LinearChain)
   const auto num_nodes = state.range (0);
   const auto block_size = state.range (1);
   const auto num_threads = state.range (2);
+  const auto strategy = state.range (3);
 
-  scheduler_->rechain_from_node_collection (create_linear_chain (num_nodes));
-  scheduler_->start_threads (num_threads);
-
-  EngineProcessTimeInfo time_info{};
-  time_info.nframes_ = block_size;
-
-  for (auto _ : state)
-    {
-      scheduler_->run_cycle (time_info, 0);
-    }
-
-  scheduler_->terminate_threads ();
+  run_cycles (
+    state, create_linear_chain (num_nodes), block_size, num_threads, strategy);
   state.SetComplexityN (num_nodes);
 }
 
@@ -223,20 +515,11 @@ BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, SplitChain)
   const auto nodes_per_branch = state.range (1);
   const auto block_size = state.range (2);
   const auto num_threads = state.range (3);
+  const auto strategy = state.range (4);
 
-  scheduler_->rechain_from_node_collection (
-    create_split_chain (num_branches, nodes_per_branch));
-  scheduler_->start_threads (num_threads);
-
-  EngineProcessTimeInfo time_info{};
-  time_info.nframes_ = block_size;
-
-  for (auto _ : state)
-    {
-      scheduler_->run_cycle (time_info, 0);
-    }
-
-  scheduler_->terminate_threads ();
+  run_cycles (
+    state, create_split_chain (num_branches, nodes_per_branch), block_size,
+    num_threads, strategy);
   state.SetComplexityN (num_branches * nodes_per_branch);
 }
 
@@ -247,20 +530,11 @@ BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, ComplexGraph)
   const auto  block_size = state.range (1);
   const auto  num_threads = state.range (2);
   const float connectivity = state.range (3) / 100.0f;
+  const auto  strategy = state.range (4);
 
-  scheduler_->rechain_from_node_collection (
-    create_complex_graph (num_nodes, connectivity));
-  scheduler_->start_threads (num_threads);
-
-  EngineProcessTimeInfo time_info{};
-  time_info.nframes_ = block_size;
-
-  for (auto _ : state)
-    {
-      scheduler_->run_cycle (time_info, 0);
-    }
-
-  scheduler_->terminate_threads ();
+  run_cycles (
+    state, create_complex_graph (num_nodes, connectivity), block_size,
+    num_threads, strategy);
 
   state.SetComplexityN (num_nodes);
   // state.counters["Nodes/Thread"] = benchmark::Counter (
@@ -268,67 +542,229 @@ BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, ComplexGraph)
   state.counters["Nodes/Thread"] = double (num_nodes) / double (num_threads);
 }
 
+BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, FanIn)
+(benchmark::State &state)
+{
+  const auto num_tracks = state.range (0);
+  const auto block_size = state.range (1);
+  const auto num_threads = state.range (2);
+  const auto strategy = state.range (3);
+
+  run_cycles (
+    state, create_fan_in (num_tracks, 0), block_size, num_threads, strategy);
+  state.SetComplexityN (num_tracks);
+}
+
+BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, MixedCosts)
+(benchmark::State &state)
+{
+  const auto num_tracks = state.range (0);
+  const auto heavy_every = state.range (1);
+  const auto block_size = state.range (2);
+  const auto num_threads = state.range (3);
+  const auto strategy = state.range (4);
+
+  run_cycles (
+    state, create_fan_in (num_tracks, heavy_every), block_size, num_threads,
+    strategy);
+  state.SetComplexityN (num_tracks);
+}
+
+BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, DeepChains)
+(benchmark::State &state)
+{
+  const auto num_chains = state.range (0);
+  const auto depth = state.range (1);
+  const auto block_size = state.range (2);
+  const auto num_threads = state.range (3);
+  const auto strategy = state.range (4);
+
+  run_cycles (
+    state, create_deep_chains (num_chains, depth), block_size, num_threads,
+    strategy);
+  state.SetComplexityN (num_chains * depth);
+}
+
+BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, Diamonds)
+(benchmark::State &state)
+{
+  const auto num_tracks = state.range (0);
+  const auto block_size = state.range (1);
+  const auto num_threads = state.range (2);
+  const auto strategy = state.range (3);
+
+  run_cycles (
+    state, create_diamonds (num_tracks), block_size, num_threads, strategy);
+  state.SetComplexityN (num_tracks);
+}
+
+BENCHMARK_DEFINE_F (GraphSchedulerBenchmark, LoopHeavy)
+(benchmark::State &state)
+{
+  const auto num_tracks = state.range (0);
+  const auto block_size = state.range (1);
+  const auto num_threads = state.range (2);
+  const auto graph_loop_splitting = state.range (3) != 0;
+
+  /* a loop point in 2 out of 3 cycles */
+  looping_transport_ = std::make_unique<LoopingTransport> (block_size * 3 / 2);
+  run_cycles (
+    state, create_fan_in (num_tracks, 4), block_size, num_threads,
+    static_cast<int64_t> (GraphScheduler::SchedulingStrategy::WorkStealing),
+    graph_loop_splitting);
+  state.SetComplexityN (num_tracks);
+}
+
+/**
+ * @brief Registers each set of arguments once per scheduling strategy (the
+ * strategy is appended as the last argument).
+ */
+static void
+add_args_for_all_strategies (
+  benchmark::internal::Benchmark *            b,
+  std::initializer_list<std::vector<int64_t>> args_list)
+{
+  for (
+    const auto strategy :
+    { GraphScheduler::SchedulingStrategy::SharedQueue,
+      GraphScheduler::SchedulingStrategy::WorkStealing })
+    {
+      for (auto args : args_list)
+        {
+          args.push_back (static_cast<int64_t> (strategy));
+          b->Args (args);
+        }
+    }
+}
+
 // Register linear chain benchmarks
 BENCHMARK_REGISTER_F (GraphSchedulerBenchmark, LinearChain)
-  // Format: {num_nodes, block_size, num_threads}
-  ->Args ({ 500, 256, 4 })
-  ->Args ({ 1000, 256, 4 })
-  ->Args ({ 2000, 256, 4 })
-  // Thread scaling
-  ->Args ({ 1000, 256, 2 })
-  ->Args ({ 1000, 256, 6 })
-  ->Args ({ 1000, 256, 14 })
-  // Block sizes
-  ->Args ({ 1000, 64, 4 })
-  ->Args ({ 1000, 1024, 4 })
+  // Format: {num_nodes, block_size, num_threads, strategy}
+  ->ArgNames ({ "nodes", "block", "threads", "strategy" })
+  ->Apply ([] (benchmark::internal::Benchmark * b) {
+    add_args_for_all_strategies (
+      b, {
+           { 500, 256, 4 },
+           { 1000, 256, 4 },
+           { 2000, 256, 4 },
+           // Thread scaling
+           { 1000, 256, 2 },
+           { 1000, 256, 6 },
+           { 1000, 256, 14 },
+           // Block sizes
+           { 1000, 64, 4 },
+           { 1000, 1024, 4 },
+         });
+  })
   ->Complexity ();
 
 // Register split chain benchmarks
 BENCHMARK_REGISTER_F (GraphSchedulerBenchmark, SplitChain)
-  // Format: {num_branches, nodes_per_branch, block_size, num_threads}
-  ->Args ({ 5, 100, 256, 4 })  // 500 nodes
-  ->Args ({ 10, 100, 256, 4 }) // 1k nodes
-  ->Args ({ 20, 100, 256, 4 }) // 2k nodes
-  // Thread scaling
-  ->Args ({ 10, 100, 256, 2 })
-  ->Args ({ 10, 100, 256, 6 })
-  ->Args ({ 10, 100, 256, 14 })
-  // Block sizes
-  ->Args ({ 10, 100, 64, 4 })
-  ->Args ({ 10, 100, 1024, 4 })
-  // Branch variations
-  ->Args ({ 5, 200, 256, 4 }) // Fewer longer branches
-  ->Args ({ 40, 25, 256, 4 }) // More shorter branches
+  // Format: {num_branches, nodes_per_branch, block_size, num_threads, strategy}
+  ->ArgNames ({ "branches", "nodes_per_branch", "block", "threads", "strategy" })
+  ->Apply ([] (benchmark::internal::Benchmark * b) {
+    add_args_for_all_strategies (
+      b, {
+           { 5, 100, 256, 4 },  // 500 nodes
+           { 10, 100, 256, 4 }, // 1k nodes
+           { 20, 100, 256, 4 }, // 2k nodes
+           // Thread scaling
+           { 10, 100, 256, 2 },
+           { 10, 100, 256, 6 },
+           { 10, 100, 256, 14 },
+           // Block sizes
+           { 10, 100, 64, 4 },
+           { 10, 100, 1024, 4 },
+           // Branch variations
+           { 5, 200, 256, 4 }, // Fewer longer branches
+           { 40, 25, 256, 4 }, // More shorter branches
+         });
+  })
   ->Complexity ();
 
 // Register complex graph benchmarks
 BENCHMARK_REGISTER_F (GraphSchedulerBenchmark, ComplexGraph)
-  // Format: {num_nodes, block_size, num_threads, connectivity_percentage}
-
-  // Test thread scaling
-  ->Args ({ 1000, 256, 2, 5 })
-  ->Args ({ 1000, 256, 4, 5 })
-  ->Args ({ 1000, 256, 6, 5 })
-  ->Args ({ 1000, 256, 14, 5 })
-
-  // Test different graph sizes
-  ->Args ({ 500, 256, 6, 10 })
-  ->Args ({ 1000, 256, 6, 5 })
-  ->Args ({ 2000, 256, 6, 2 })
-
-  // Test block sizes
-  ->Args ({ 1000, 64, 6, 5 })
-  ->Args ({ 1000, 256, 6, 5 })
-  ->Args ({ 1000, 1024, 6, 5 })
-
-  // Test connectivity density
-  ->Args ({ 1000, 256, 6, 1 })
-  ->Args ({ 1000, 256, 6, 5 })
-  ->Args ({ 1000, 256, 6, 10 })
-
-  // Extreme cases
-  ->Args ({ 2000, 1024, 14, 1 }) // Large but sparse
-  ->Args ({ 500, 64, 2, 20 })    // Small but dense
+  // Format: {num_nodes, block_size, num_threads, connectivity_percentage,
+  // strategy}
+  ->ArgNames ({ "nodes", "block", "threads", "connectivity", "strategy" })
+  ->Apply ([] (benchmark::internal::Benchmark * b) {
+    add_args_for_all_strategies (
+      b, {
+           // Test thread scaling
+           { 1000, 256, 2, 5 },
+           { 1000, 256, 4, 5 },
+           { 1000, 256, 6, 5 },
+           { 1000, 256, 14, 5 },
+
+           // Test different graph sizes
+           { 500, 256, 6, 10 },
+           { 1000, 256, 6, 5 },
+           { 2000, 256, 6, 2 },
+
+           // Test block sizes
+           { 1000, 64, 6, 5 },
+           { 1000, 256, 6, 5 },
+           { 1000, 1024, 6, 5 },
+
+           // Test connectivity density
+           { 1000, 256, 6, 1 },
+           { 1000, 256, 6, 5 },
+           { 1000, 256, 6, 10 },
+
+           // Extreme cases
+           { 2000, 1024, 14, 1 }, // Large but sparse
+           { 500, 64, 2, 20 },    // Small but dense
+         });
+  })
   ->Complexity ();
 
+/* thread counts, block sizes and strategies swept by the topology benchmarks
+ */
+static const std::vector<int64_t> SWEPT_THREADS = { 1, 2, 4, 8 };
+static const std::vector<int64_t> SWEPT_BLOCK_SIZES = { 64, 256, 1024 };
+static const std::vector<int64_t> SWEPT_STRATEGIES = {
+  static_cast<int64_t> (GraphScheduler::SchedulingStrategy::SharedQueue),
+  static_cast<int64_t> (GraphScheduler::SchedulingStrategy::WorkStealing),
+};
+
+// Register fan-in benchmarks (all tracks into master)
+BENCHMARK_REGISTER_F (GraphSchedulerBenchmark, FanIn)
+  // Format: {num_tracks, block_size, num_threads, strategy}
+  ->ArgNames ({ "tracks", "block", "threads", "strategy" })
+  ->ArgsProduct (
+    { { 16, 100 }, SWEPT_BLOCK_SIZES, SWEPT_THREADS, SWEPT_STRATEGIES })
+  ->UseRealTime ();
+
+// Register mixed cost benchmarks (a few heavy tracks among light ones)
+BENCHMARK_REGISTER_F (GraphSchedulerBenchmark, MixedCosts)
+  // Format: {num_tracks, heavy_every, block_size, num_threads, strategy}
+  ->ArgNames ({ "tracks", "heavy_every", "block", "threads", "strategy" })
+  ->ArgsProduct (
+    { { 100 }, { 4, 20 }, SWEPT_BLOCK_SIZES, SWEPT_THREADS, SWEPT_STRATEGIES })
+  ->UseRealTime ();
+
+// Register deep chain benchmarks
+BENCHMARK_REGISTER_F (GraphSchedulerBenchmark, DeepChains)
+  // Format: {num_chains, depth, block_size, num_threads, strategy}
+  ->ArgNames ({ "chains", "depth", "block", "threads", "strategy" })
+  ->Args ({ 1, 200, 256, 1, 0 })
+  ->ArgsProduct (
+    { { 4 }, { 50 }, SWEPT_BLOCK_SIZES, SWEPT_THREADS, SWEPT_STRATEGIES })
+  ->UseRealTime ();
+
+// Register diamond/sidechain benchmarks
+BENCHMARK_REGISTER_F (GraphSchedulerBenchmark, Diamonds)
+  // Format: {num_tracks, block_size, num_threads, strategy}
+  ->ArgNames ({ "tracks", "block", "threads", "strategy" })
+  ->ArgsProduct ({ { 32 }, SWEPT_BLOCK_SIZES, SWEPT_THREADS, SWEPT_STRATEGIES })
+  ->UseRealTime ();
+
+// Register loop benchmarks, splitting the whole graph vs each node at the loop
+// points
+BENCHMARK_REGISTER_F (GraphSchedulerBenchmark, LoopHeavy)
+  // Format: {num_tracks, block_size, num_threads, graph_loop_splitting}
+  ->ArgNames ({ "tracks", "block", "threads", "graph_split" })
+  ->ArgsProduct ({ { 100 }, SWEPT_BLOCK_SIZES, { 1, 4 }, { 0, 1 } })
+  ->UseRealTime ();
+
 BENCHMARK_MAIN ();
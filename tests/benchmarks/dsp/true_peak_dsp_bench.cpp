@@ -0,0 +1,46 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cmath>
+#include <vector>
+
+#include "dsp/true_peak_dsp.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace zrythm::dsp;
+
+static void
+BM_TruePeakDsp (benchmark::State &state)
+{
+  const auto num_channels = static_cast<size_t> (state.range (0));
+  const auto block_length = static_cast<int> (state.range (1));
+
+  std::vector<std::vector<float>> bufs (
+    num_channels, std::vector<float> (block_length));
+  std::vector<const float *> buf_ptrs;
+  for (size_t ch = 0; ch < num_channels; ch++)
+    {
+      for (int i = 0; i < block_length; i++)
+        {
+          bufs[ch][i] =
+            0.5f * std::sin (static_cast<float> (i * (ch + 1)) * 0.1f);
+        }
+      buf_ptrs.push_back (bufs[ch].data ());
+    }
+
+  TruePeakDsp meter;
+  meter.init (48000.f, num_channels);
+  for (auto _ : state)
+    {
+      meter.process (buf_ptrs.data (), block_length);
+      benchmark::DoNotOptimize (meter.read_f ());
+    }
+
+  state.SetItemsProcessed (
+    state.iterations () * static_cast<int64_t> (num_channels) * block_length);
+}
+
+BENCHMARK (BM_TruePeakDsp)
+  ->ArgNames ({ "channels", "block" })
+  ->ArgsProduct ({ { 1, 2, 8 }, { 64, 256, 1024 } });
@@ -0,0 +1,254 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * @file
+ *
+ * End-to-end playback benchmark: realistic projects played back by the engine
+ * with the dummy backend, one engine cycle per iteration.
+ *
+ * To track the results across commits, write them as JSON with
+ * `--benchmark_out=<file> --benchmark_out_format=json` and compare 2 runs
+ * with google benchmark's `tools/compare.py benchmarks <old> <new>`. The
+ * per-cycle percentiles are reported as counters, so they are included in the
+ * JSON output.
+ */
+
+#include "zrythm-test-config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "gui/backend/backend/actions/channel_send_action.h"
+#include "gui/backend/backend/actions/tracklist_selections_action.h"
+#include "gui/backend/backend/actions/undo_manager.h"
+#include "gui/backend/backend/project.h"
+#include "gui/backend/backend/zrythm.h"
+#include "gui/backend/io/file_descriptor.h"
+#include "gui/dsp/audio_bus_track.h"
+#include "gui/dsp/audio_group_track.h"
+#include "gui/dsp/audio_track.h"
+#include "gui/dsp/automation_point.h"
+#include "gui/dsp/automation_region.h"
+#include "gui/dsp/instrument_track.h"
+#include "gui/dsp/midi_note.h"
+#include "gui/dsp/midi_region.h"
+
+#include "tests/helpers/plugin_manager.h"
+#include "tests/helpers/project_helper.h"
+#include "tests/helpers/zrythm_helper.h"
+
+#include "tests/benchmarks/benchmark_helpers.h"
+
+namespace
+{
+
+constexpr nframes_t CYCLE_SIZE = 256;
+
+/** Played bars (the default loop range). */
+constexpr int NUM_BARS = 4;
+
+/** Number of notes in each MIDI region (one region per bar). */
+constexpr int NOTES_PER_REGION = 16;
+
+/** Automation points in the automation region of each track. */
+constexpr int NUM_AUTOMATION_POINTS = 64;
+
+/**
+ * @brief Adds an automation region spanning the played bars to the first
+ * automation track of @p track.
+ */
+void
+add_automation (ChannelTrack &track)
+{
+  const auto   ticks_per_bar = static_cast<double> (TRANSPORT->ticks_per_bar_);
+  const double frames_per_tick = AUDIO_ENGINE->frames_per_tick_;
+  auto *       at = track.get_automation_tracklist ().ats_.front ();
+  auto *       region = track.Track::add_region (
+    new AutomationRegion (
+      Position (), Position (NUM_BARS * ticks_per_bar, frames_per_tick),
+      track.get_uuid (), at->index_, 0),
+    at, 0, true, false);
+  const double ap_ticks = NUM_BARS * ticks_per_bar / NUM_AUTOMATION_POINTS;
+  for (int i = 0; i < NUM_AUTOMATION_POINTS; ++i)
+    {
+      const float val = (i % 2 == 0) ? 0.2f : 0.8f;
+      region->append_object (new AutomationPoint (
+        val, val, Position (i * ap_ticks, frames_per_tick)));
+    }
+}
+
+/**
+ * @brief Adds a MIDI region with notes to each played bar of @p track.
+ */
+void
+add_midi_regions (InstrumentTrack &track)
+{
+  const auto   ticks_per_bar = static_cast<double> (TRANSPORT->ticks_per_bar_);
+  const double frames_per_tick = AUDIO_ENGINE->frames_per_tick_;
+  for (int i = 0; i < NUM_BARS; ++i)
+    {
+      auto * region = track.Track::add_region (
+        new MidiRegion (
+          Position (i * ticks_per_bar, frames_per_tick),
+          Position ((i + 1) * ticks_per_bar, frames_per_tick),
+          track.get_uuid (), 0, i),
+        nullptr, 0, true, false);
+      const double note_ticks = ticks_per_bar / NOTES_PER_REGION;
+      for (int j = 0; j < NOTES_PER_REGION; ++j)
+        {
+          region->append_object (new MidiNote (
+            region->id_, Position (j * note_ticks, frames_per_tick),
+            Position ((j + 1) * note_ticks, frames_per_tick),
+            static_cast<uint8_t> (48 + j), 90));
+        }
+    }
+}
+
+/**
+ * @brief Creates a project with audio tracks with regions and instrument
+ * tracks (with the test instrument) with MIDI regions, from the first 2
+ * benchmark arguments.
+ *
+ * Every track has automation, is routed to a group track and sends post-fader
+ * to an FX track, and playback is started.
+ */
+void
+prepare_playback (const benchmark::State &state)
+{
+  /* process manually */
+  test_project_stop_dummy_engine ();
+
+  auto * group = Track::create_empty_with_action<AudioGroupTrack> ();
+  auto * fx = Track::create_empty_with_action<AudioBusTrack> ();
+
+  std::vector<ChannelTrack *> tracks;
+  const FileDescriptor        file (fs::path (TESTS_SRCDIR) / "test.wav");
+  const Position              start_pos;
+  for (int64_t i = 0; i < state.range (0); ++i)
+    {
+      Track::create_with_action (
+        Track::Type::Audio, nullptr, &file, &start_pos,
+        TRACKLIST->get_num_tracks (), 1, -1, nullptr);
+      tracks.push_back (
+        TRACKLIST->get_track<AudioTrack> (TRACKLIST->get_num_tracks () - 1));
+    }
+  if (state.range (1) > 0)
+    {
+      const auto num_tracks_before = TRACKLIST->get_num_tracks ();
+      test_plugin_manager_create_tracks_from_plugin (
+        TEST_INSTRUMENT_BUNDLE_URI, TEST_INSTRUMENT_URI, true, false,
+        static_cast<int> (state.range (1)));
+      for (auto i = num_tracks_before; i < TRACKLIST->get_num_tracks (); ++i)
+        {
+          auto * track = TRACKLIST->get_track<InstrumentTrack> (i);
+          add_midi_regions (*track);
+          tracks.push_back (track);
+        }
+    }
+
+  std::vector<TrackPtrVariant> track_vars;
+  for (auto * track : tracks)
+    {
+      add_automation (*track);
+      UNDO_MANAGER->perform (new ChannelSendConnectStereoAction (
+        *track->channel_->sends_[CHANNEL_SEND_POST_FADER_START_SLOT],
+        fx->processor_->get_stereo_in_ports (), *PORT_CONNECTIONS_MGR));
+      track_vars.push_back (convert_to_variant<TrackPtrVariant> (track));
+    }
+  if (!tracks.empty ())
+    {
+      UNDO_MANAGER->perform (new ChangeTracksDirectOutAction (
+        TrackSpan{ track_vars }, *PORT_CONNECTIONS_MGR,
+        convert_to_variant<TrackPtrVariant> (group)));
+    }
+  UNDO_MANAGER->clear_stacks ();
+
+  TRANSPORT->set_loop (true, true);
+  TRANSPORT->requestRoll (true);
+
+  AUDIO_ENGINE->run_.store (false);
+  TRACKLIST->set_caches (CacheType::PlaybackSnapshots);
+  AUDIO_ENGINE->run_.store (true);
+}
+
+/**
+ * @brief Returns the given percentile of the sorted @p values.
+ */
+double
+get_percentile (const std::vector<double> &values, double percentile)
+{
+  if (values.empty ())
+    return 0.0;
+
+  const auto index = static_cast<size_t> (
+    percentile / 100.0 * static_cast<double> (values.size () - 1));
+  return values[index];
+}
+
+#ifdef PACKAGE_VERSION
+/* record the version in the JSON output so that runs can be told apart */
+[[maybe_unused]] const bool context_added = [] () {
+  benchmark::AddCustomContext ("zrythm_version", PACKAGE_VERSION);
+  return true;
+}();
+#endif
+
+}
+
+/**
+ * Plays back a project with the given number of audio and MIDI tracks, one
+ * engine cycle per iteration.
+ *
+ * Besides the cycle time statistics, reports the per-cycle p50/p99/max times
+ * (in microseconds) and the DSP load (the time spent processing over the
+ * duration of the processed audio). The CPU time includes the graph threads.
+ */
+static void
+BM_ProjectPlayback (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  prepare_playback (state);
+
+  spdlog::set_level (spdlog::level::off);
+  std::vector<double> cycle_times;
+  cycle_times.reserve (static_cast<size_t> (state.max_iterations));
+  PeakMemoryCounter peak_memory;
+  for (auto _ : state)
+    {
+      const auto start = std::chrono::steady_clock::now ();
+      AUDIO_ENGINE->process (CYCLE_SIZE);
+      const auto end = std::chrono::steady_clock::now ();
+      const auto secs = std::chrono::duration<double> (end - start).count ();
+      state.SetIterationTime (secs);
+      cycle_times.push_back (secs);
+    }
+  peak_memory.report (state);
+
+  double total_secs = 0.0;
+  for (const auto secs : cycle_times)
+    total_secs += secs;
+  std::ranges::sort (cycle_times);
+  state.counters["p50_us"] = get_percentile (cycle_times, 50.0) * 1e6;
+  state.counters["p99_us"] = get_percentile (cycle_times, 99.0) * 1e6;
+  state.counters["max_us"] =
+    cycle_times.empty () ? 0.0 : cycle_times.back () * 1e6;
+  const double audio_secs =
+    static_cast<double> (cycle_times.size () * CYCLE_SIZE)
+    / static_cast<double> (AUDIO_ENGINE->sample_rate_);
+  state.counters["dsp_load"] = audio_secs > 0.0 ? total_secs / audio_secs : 0.0;
+  state.SetItemsProcessed (
+    static_cast<int64_t> (state.iterations ()) * CYCLE_SIZE);
+}
+
+/* audio tracks, MIDI tracks */
+BENCHMARK (BM_ProjectPlayback)
+  ->ArgNames ({ "audio_tracks", "midi_tracks" })
+  ->Args ({ 8, 8 })
+  ->Args ({ 32, 16 })
+  ->Args ({ 64, 32 })
+  ->UseManualTime ()
+  ->MeasureProcessCPUTime ()
+  ->Unit (benchmark::kMicrosecond)
+  ->Iterations (48000 * 30 / CYCLE_SIZE);
@@ -0,0 +1,319 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include "gui/backend/backend/actions/mixer_selections_action.h"
+#include "gui/backend/backend/actions/undo_manager.h"
+#include "gui/backend/backend/project.h"
+#include "gui/backend/backend/zrythm.h"
+#include "gui/dsp/automation_point.h"
+#include "gui/dsp/automation_region.h"
+#include "gui/dsp/instrument_track.h"
+#include "gui/dsp/midi_note.h"
+#include "gui/dsp/midi_region.h"
+#include "utils/compression.h"
+#include "utils/io.h"
+
+#include "tests/helpers/plugin_manager.h"
+#include "tests/helpers/project_helper.h"
+#include "tests/helpers/zrythm_helper.h"
+
+#include "tests/benchmarks/benchmark_helpers.h"
+
+namespace
+{
+
+/** Number of notes in each MIDI region. */
+constexpr int NOTES_PER_REGION = 16;
+
+/**
+ * @brief Synthetic project size, from the first 4 benchmark arguments.
+ */
+struct ProjectSize
+{
+  explicit ProjectSize (const benchmark::State &state)
+      : num_tracks_ (static_cast<int> (state.range (0))),
+        num_regions_ (static_cast<int> (state.range (1))),
+        num_automation_points_ (static_cast<int> (state.range (2))),
+        num_plugins_ (static_cast<int> (state.range (3)))
+  {
+  }
+
+  /** Instrument tracks. */
+  int num_tracks_;
+
+  /** MIDI regions per track. */
+  int num_regions_;
+
+  /** Automation points in the automation region of each track. */
+  int num_automation_points_;
+
+  /** Insert plugins per track (besides the instrument). */
+  int num_plugins_;
+};
+
+/**
+ * @brief Fills the current project with instrument tracks, each with MIDI
+ * regions, an automation region and insert plugins.
+ */
+void
+populate_project (const ProjectSize &size)
+{
+  test_plugin_manager_create_tracks_from_plugin (
+    TRIPLE_SYNTH_BUNDLE, TRIPLE_SYNTH_URI, true, false, size.num_tracks_);
+  const auto insert_setting = test_plugin_manager_get_plugin_setting (
+    COMPRESSOR_BUNDLE, COMPRESSOR_URI, false);
+
+  const auto   ticks_per_bar = static_cast<double> (TRANSPORT->ticks_per_bar_);
+  const double frames_per_tick = AUDIO_ENGINE->frames_per_tick_;
+  const auto   num_tracks = TRACKLIST->get_num_tracks ();
+  for (
+    size_t i = static_cast<size_t> (num_tracks - size.num_tracks_);
+    i < static_cast<size_t> (num_tracks); ++i)
+    {
+      auto * track =
+        std::get<InstrumentTrack *> (TRACKLIST->get_track_at_index (i));
+
+      for (int j = 0; j < size.num_regions_; ++j)
+        {
+          auto * region = track->Track::add_region (
+            new MidiRegion (
+              Position (j * ticks_per_bar, frames_per_tick),
+              Position ((j + 1) * ticks_per_bar, frames_per_tick),
+              track->get_uuid (), 0, j),
+            nullptr, 0, true, false);
+          const double note_ticks = ticks_per_bar / NOTES_PER_REGION;
+          for (int k = 0; k < NOTES_PER_REGION; ++k)
+            {
+              region->append_object (new MidiNote (
+                region->id_, Position (k * note_ticks, frames_per_tick),
+                Position ((k + 1) * note_ticks, frames_per_tick),
+                static_cast<uint8_t> (48 + k), 90));
+            }
+        }
+
+      if (size.num_automation_points_ > 0)
+        {
+          auto * at = track->get_automation_tracklist ().ats_.front ();
+          const Position end_pos (
+            std::max (size.num_regions_, 1) * ticks_per_bar, frames_per_tick);
+          auto * region = track->Track::add_region (
+            new AutomationRegion (
+              Position (), end_pos, track->get_uuid (), at->index_, 0),
+            at, 0, true, false);
+          const double ap_ticks = ticks_per_bar / 4;
+          for (int k = 0; k < size.num_automation_points_; ++k)
+            {
+              const float val = (k % 2 == 0) ? 0.2f : 0.8f;
+              region->append_object (new AutomationPoint (
+                val, val, Position (k * ap_ticks, frames_per_tick)));
+            }
+        }
+
+      if (size.num_plugins_ > 0)
+        {
+          UNDO_MANAGER->perform (new MixerSelectionsCreateAction (
+            *track, dsp::PluginSlot (dsp::PluginSlotType::Insert, 0),
+            insert_setting, size.num_plugins_));
+        }
+    }
+
+  /* only measure the project itself */
+  UNDO_MANAGER->clear_stacks ();
+}
+
+}
+
+static void
+BM_ProjectSerialize (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  populate_project (ProjectSize (state));
+  const bool binary = state.range (4) != 0;
+  state.SetLabel (binary ? "binary" : "json");
+
+  spdlog::set_level (spdlog::level::off);
+  size_t            size = 0;
+  PeakMemoryCounter peak_memory;
+  for (auto _ : state)
+    {
+      if (binary)
+        {
+          const auto data = PROJECT->serialize_to_binary ();
+          size = data.size ();
+        }
+      else
+        {
+          const auto json = PROJECT->serialize_to_json_string ();
+          size = strlen (json.c_str ());
+        }
+    }
+  peak_memory.report (state);
+  state.counters["doc_size"] = benchmark::Counter (
+    static_cast<double> (size), benchmark::Counter::kDefaults,
+    benchmark::Counter::kIs1024);
+  state.SetBytesProcessed (
+    static_cast<int64_t> (state.iterations ()) * static_cast<int64_t> (size));
+}
+
+static void
+BM_ProjectDeserialize (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  populate_project (ProjectSize (state));
+  const bool binary = state.range (4) != 0;
+  state.SetLabel (binary ? "binary" : "json");
+  const std::string data =
+    binary ? PROJECT->serialize_to_binary ()
+           : std::string (PROJECT->serialize_to_json_string ().c_str ());
+
+  spdlog::set_level (spdlog::level::off);
+  PeakMemoryCounter peak_memory;
+  for (auto _ : state)
+    {
+      auto prj = std::make_unique<Project> ();
+      if (binary)
+        {
+          prj->deserialize_from_binary (data);
+        }
+      else
+        {
+          prj->deserialize_from_json_string (data.c_str ());
+        }
+      benchmark::DoNotOptimize (prj);
+    }
+  peak_memory.report (state);
+  state.SetBytesProcessed (
+    static_cast<int64_t> (state.iterations ())
+    * static_cast<int64_t> (data.size ()));
+}
+
+static void
+BM_ProjectClone (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  populate_project (ProjectSize (state));
+
+  spdlog::set_level (spdlog::level::off);
+  PeakMemoryCounter peak_memory;
+  for (auto _ : state)
+    {
+      auto prj = std::unique_ptr<Project> (PROJECT->clone (false));
+      benchmark::DoNotOptimize (prj);
+    }
+  peak_memory.report (state);
+}
+
+static void
+BM_ProjectCompress (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  populate_project (ProjectSize (state));
+  const int level = static_cast<int> (state.range (4));
+  state.SetLabel (fmt::format ("level {}", level));
+  const auto json = PROJECT->serialize_to_json_string ();
+  const std::string_view data = json.c_str ();
+  const auto             tmp_dir = utils::io::make_tmp_dir ();
+  const auto path = fs::path (tmp_dir->path ().toStdString ()) / PROJECT_FILE;
+
+  spdlog::set_level (spdlog::level::off);
+  size_t            compressed_size = 0;
+  PeakMemoryCounter peak_memory;
+  for (auto _ : state)
+    {
+      utils::compression::StreamingFileCompressor compressor (path, level);
+      compressor.write (data);
+      compressor.finish ();
+      compressed_size = compressor.get_total_out ();
+    }
+  peak_memory.report (state);
+  state.counters["ratio"] =
+    static_cast<double> (data.size ()) / static_cast<double> (compressed_size);
+  state.SetBytesProcessed (
+    static_cast<int64_t> (state.iterations ())
+    * static_cast<int64_t> (data.size ()));
+}
+
+static void
+BM_ProjectLoad (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  populate_project (ProjectSize (state));
+  PROJECT->save (PROJECT->dir_, false, false, false);
+  const auto prj_file = PROJECT->dir_ / PROJECT_FILE;
+
+  spdlog::set_level (spdlog::level::off);
+  PeakMemoryCounter peak_memory;
+  for (auto _ : state)
+    {
+      state.PauseTiming ();
+      AUDIO_ENGINE->activate (false);
+      PROJECT.reset ();
+      state.ResumeTiming ();
+
+      test_project_reload (prj_file);
+    }
+  peak_memory.report (state);
+}
+
+/* tracks, regions per track, automation points per track, plugins per track */
+static const std::vector<std::vector<int64_t>> project_sizes = {
+  { 8, 8, 32, 1 },
+  { 32, 16, 128, 2 },
+  { 64, 32, 512, 4 },
+};
+
+static void
+project_size_args (benchmark::internal::Benchmark * b)
+{
+  b->ArgNames ({ "tracks", "regions", "aps", "plugins" });
+  for (const auto &size : project_sizes)
+    {
+      b->Args (size);
+    }
+}
+
+static void
+project_size_and_format_args (benchmark::internal::Benchmark * b)
+{
+  b->ArgNames ({ "tracks", "regions", "aps", "plugins", "binary" });
+  for (const auto &size : project_sizes)
+    {
+      for (int64_t binary : { 0, 1 })
+        {
+          auto args = size;
+          args.push_back (binary);
+          b->Args (args);
+        }
+    }
+}
+
+static void
+project_size_and_level_args (benchmark::internal::Benchmark * b)
+{
+  b->ArgNames ({ "tracks", "regions", "aps", "plugins", "level" });
+  for (int64_t level : { 1, 3, 9, 19 })
+    {
+      auto args = project_sizes[1];
+      args.push_back (level);
+      b->Args (args);
+    }
+}
+
+BENCHMARK (BM_ProjectSerialize)
+  ->Apply (project_size_and_format_args)
+  ->Unit (benchmark::kMillisecond);
+BENCHMARK (BM_ProjectDeserialize)
+  ->Apply (project_size_and_format_args)
+  ->Unit (benchmark::kMillisecond);
+BENCHMARK (BM_ProjectClone)
+  ->Apply (project_size_args)
+  ->Unit (benchmark::kMillisecond);
+BENCHMARK (BM_ProjectCompress)
+  ->Apply (project_size_and_level_args)
+  ->Unit (benchmark::kMillisecond);
+BENCHMARK (BM_ProjectLoad)
+  ->Apply (project_size_args)
+  ->Unit (benchmark::kMillisecond)
+  ->Iterations (3);
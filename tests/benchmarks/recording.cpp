@@ -0,0 +1,197 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include <chrono>
+#include <cmath>
+#include <numbers>
+
+#include "gui/backend/backend/project.h"
+#include "gui/backend/backend/zrythm.h"
+#include "gui/dsp/audio_track.h"
+#include "gui/dsp/engine_dummy.h"
+#include "gui/dsp/midi_track.h"
+#include "gui/dsp/recording_manager.h"
+
+#include "tests/helpers/project_helper.h"
+#include "tests/helpers/zrythm_helper.h"
+
+#include "tests/benchmarks/benchmark_helpers.h"
+
+namespace
+{
+
+constexpr nframes_t CYCLE_SIZE = 256;
+
+/**
+ * Number of cycles between processing the recording events, similar to how
+ * often the main thread gets to them while the engine is running.
+ */
+constexpr int CYCLES_PER_EVENT_BATCH = 8;
+
+/** Cycles between MIDI notes sent to each MIDI track. */
+constexpr int CYCLES_PER_NOTE = 4;
+
+/**
+ * @brief Creates the armed tracks and starts recording, from the first 2
+ * benchmark arguments.
+ */
+void
+prepare_recording (const benchmark::State &state)
+{
+  /* process manually */
+  test_project_stop_dummy_engine ();
+
+  AUDIO_ENGINE->dummy_input_ =
+    std::make_unique<StereoPorts> (true, "Dummy input", "dummy_input");
+  AUDIO_ENGINE->dummy_input_->set_owner (AUDIO_ENGINE.get ());
+  AUDIO_ENGINE->dummy_input_->allocate_bufs ();
+
+  for (int64_t i = 0; i < state.range (0); ++i)
+    {
+      auto * track = Track::create_empty_with_action<AudioTrack> ();
+      track->set_recording (true, false);
+    }
+  for (int64_t i = 0; i < state.range (1); ++i)
+    {
+      auto * track = Track::create_empty_with_action<MidiTrack> ();
+      track->set_recording (true, false);
+    }
+
+  TRANSPORT->set_loop (false, true);
+  TRANSPORT->set_punch_mode_enabled (false);
+  TRANSPORT->recording_ = true;
+  TRANSPORT->requestRoll (true);
+
+  AUDIO_ENGINE->run_.store (false);
+  TRACKLIST->set_caches (CacheType::PlaybackSnapshots);
+  AUDIO_ENGINE->run_.store (true);
+}
+
+/**
+ * @brief Fills the dummy input with a sine and queues a note on the MIDI
+ * tracks every few cycles.
+ */
+void
+feed_input (int cycle)
+{
+  auto &l = AUDIO_ENGINE->dummy_input_->get_l ().buf_;
+  auto &r = AUDIO_ENGINE->dummy_input_->get_r ().buf_;
+  for (nframes_t i = 0; i < CYCLE_SIZE; ++i)
+    {
+      const auto frame = static_cast<double> (cycle * CYCLE_SIZE + i);
+      const auto val = static_cast<float> (
+        0.5 * std::sin (2.0 * std::numbers::pi * 440.0 * frame / 48000.0));
+      l[i] = val;
+      r[i] = -val;
+    }
+
+  if (cycle % CYCLES_PER_NOTE != 0)
+    return;
+
+  const auto pitch =
+    static_cast<midi_byte_t> (48 + (cycle / CYCLES_PER_NOTE) % 24);
+  for (
+    auto * track :
+    TRACKLIST->get_track_span ().get_elements_by_type<MidiTrack> ())
+    {
+      auto &events = track->processor_->midi_in_->midi_events_.queued_events_;
+      events.add_note_on (1, pitch, 90, 0);
+      events.add_note_off (1, pitch, CYCLE_SIZE - 1);
+    }
+}
+
+/**
+ * @brief Disarms the tracks and handles the remaining events, which closes
+ * the recorded files.
+ */
+void
+stop_recording ()
+{
+  for (
+    auto * track :
+    TRACKLIST->get_track_span ().get_elements_derived_from<RecordableTrack> ())
+    {
+      track->set_recording (false, false);
+    }
+  AUDIO_ENGINE->process (CYCLE_SIZE);
+  RECORDING_MANAGER->process_events ();
+}
+
+}
+
+/**
+ * Records synthetic input on many tracks for a long take, one engine cycle
+ * per iteration.
+ *
+ * The iteration time is the time of the engine cycle only (which includes
+ * queuing the recording events), while the events are handled every few
+ * cycles like on the main thread. Fails if any recording event was dropped,
+ * since that means lost frames or notes.
+ */
+static void
+BM_RecordingStress (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  prepare_recording (state);
+
+  spdlog::set_level (spdlog::level::off);
+  PeakMemoryCounter peak_memory;
+  int               cycle = 0;
+  for (auto _ : state)
+    {
+      feed_input (cycle);
+
+      const auto start = std::chrono::steady_clock::now ();
+      AUDIO_ENGINE->process (CYCLE_SIZE);
+      const auto end = std::chrono::steady_clock::now ();
+      state.SetIterationTime (
+        std::chrono::duration<double> (end - start).count ());
+
+      if (++cycle % CYCLES_PER_EVENT_BATCH == 0)
+        {
+          RECORDING_MANAGER->process_events ();
+        }
+    }
+  stop_recording ();
+  peak_memory.report (state);
+
+  const auto recording_stats = RECORDING_MANAGER->get_stats ();
+  const auto disk_stats = RECORDING_MANAGER->disk_writer_->get_stats ();
+  state.counters["max_event_backlog"] =
+    static_cast<double> (recording_stats.max_backlog_events_);
+  state.counters["coalesced_events"] =
+    static_cast<double> (recording_stats.num_coalesced_events_);
+  state.counters["max_disk_backlog_frames"] =
+    static_cast<double> (disk_stats.max_backlog_frames_);
+  state.counters["extra_disk_blocks"] =
+    static_cast<double> (disk_stats.num_extra_blocks_);
+  state.counters["disk_written"] = benchmark::Counter (
+    static_cast<double> (disk_stats.bytes_written_),
+    benchmark::Counter::kDefaults, benchmark::Counter::kIs1024);
+  state.counters["disk_throughput"] = benchmark::Counter (
+    disk_stats.throughput_, benchmark::Counter::kDefaults,
+    benchmark::Counter::kIs1024);
+  state.SetItemsProcessed (
+    static_cast<int64_t> (state.iterations ()) * CYCLE_SIZE);
+
+  if (recording_stats.num_dropped_events_ > 0)
+    {
+      state.SkipWithError (
+        fmt::format (
+          "{} recording events were dropped",
+          recording_stats.num_dropped_events_)
+          .c_str ());
+    }
+}
+
+/* audio tracks, MIDI tracks */
+BENCHMARK (BM_RecordingStress)
+  ->ArgNames ({ "audio_tracks", "midi_tracks" })
+  ->Args ({ 8, 8 })
+  ->Args ({ 32, 16 })
+  ->Args ({ 64, 32 })
+  ->UseManualTime ()
+  ->Unit (benchmark::kMicrosecond)
+  ->Iterations (48000 * 60 / CYCLE_SIZE);
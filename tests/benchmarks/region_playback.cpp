@@ -0,0 +1,277 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "zrythm-test-config.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "gui/backend/backend/project.h"
+#include "gui/backend/backend/zrythm.h"
+#include "gui/dsp/audio_region.h"
+#include "gui/dsp/audio_track.h"
+#include "gui/dsp/midi_note.h"
+#include "gui/dsp/midi_region.h"
+#include "gui/dsp/midi_track.h"
+#include "gui/dsp/tempo_track.h"
+
+#include "tests/helpers/project_helper.h"
+#include "tests/helpers/zrythm_helper.h"
+
+#include "tests/benchmarks/benchmark_helpers.h"
+
+namespace
+{
+
+/** Length of region loops, when looping. */
+constexpr signed_frame_t LOOP_FRAMES = 4800;
+
+/** Length of MIDI regions in bars. */
+constexpr int MIDI_REGION_BARS = 4;
+
+/** How long to wait for the background timestretching. */
+constexpr auto MAX_TIMESTRETCH_WAIT = std::chrono::seconds (30);
+
+/**
+ * @brief Sets the caches used during playback and starts rolling (without
+ * the engine running, since the benchmarks process manually).
+ */
+void
+prepare_caches_and_roll ()
+{
+  AUDIO_ENGINE->run_.store (false);
+  TRACKLIST->set_caches (CacheType::PlaybackSnapshots);
+  AUDIO_ENGINE->run_.store (true);
+  TRANSPORT->play_state_ = Transport::PlayState::Rolling;
+}
+
+/**
+ * @brief Returns the time info of the block starting at @p frame.
+ */
+EngineProcessTimeInfo
+make_time_nfo (unsigned_frame_t frame, nframes_t block_size)
+{
+  return {
+    .g_start_frame_ = frame,
+    .g_start_frame_w_offset_ = frame,
+    .local_offset_ = 0,
+    .nframes_ = block_size,
+  };
+}
+
+/**
+ * @brief Waits until the background timestretching of @p region's clip to
+ * the current BPM is done.
+ *
+ * @return Whether the stretched frames are ready (or no stretching is
+ * needed).
+ */
+bool
+wait_for_timestretch (const AudioRegion &region)
+{
+  const auto key =
+    region.get_timestretch_key (P_TEMPO_TRACK->get_current_bpm ());
+  if (!key || !gZrythm->timestretch_cache_)
+    return true;
+
+  const auto deadline =
+    std::chrono::steady_clock::now () + MAX_TIMESTRETCH_WAIT;
+  while (!gZrythm->timestretch_cache_->get_num_frames (*key))
+    {
+      if (std::chrono::steady_clock::now () > deadline)
+        return false;
+      std::this_thread::sleep_for (std::chrono::milliseconds (10));
+    }
+  return true;
+}
+
+}
+
+/**
+ * Fills the ports of an audio track from overlapping audio regions, one block
+ * per iteration, moving through the regions.
+ *
+ * Arguments: number of regions, block size, whether the regions loop (every
+ * LOOP_FRAMES), fade in/out length in frames (0 for the built-in fades only)
+ * and whether the regions are timestretched (musical mode with a BPM
+ * different from the clip's, using the frames stretched in the background).
+ */
+static void
+BM_AudioRegionFillStereoPorts (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  test_project_stop_dummy_engine ();
+
+  const auto num_regions = static_cast<int> (state.range (0));
+  const auto block_size = static_cast<nframes_t> (state.range (1));
+  const bool loop = state.range (2) != 0;
+  const auto fade_frames = static_cast<signed_frame_t> (state.range (3));
+  const bool stretch = state.range (4) != 0;
+
+  auto * track = Track::create_empty_with_action<AudioTrack> ();
+
+  std::vector<AudioRegion *> regions;
+  const Position             start_pos;
+  regions.push_back (track->Track::add_region (
+    new AudioRegion (
+      fs::path (TESTS_SRCDIR) / "test.wav", start_pos, track->get_uuid (), 0,
+      0),
+    nullptr, 0, true, false));
+  for (int i = 1; i < num_regions; ++i)
+    {
+      regions.push_back (track->Track::add_region (
+        new AudioRegion (
+          regions.front ()->pool_id_, start_pos, track->get_uuid (), i, 0),
+        nullptr, i, true, false));
+    }
+
+  if (stretch)
+    {
+      const auto bpm = P_TEMPO_TRACK->get_current_bpm ();
+      P_TEMPO_TRACK->set_bpm (bpm * 1.25f, bpm, false, false);
+    }
+
+  signed_frame_t end_frames = 0;
+  for (auto * region : regions)
+    {
+      if (loop)
+        {
+          Position loop_end;
+          loop_end.from_frames (LOOP_FRAMES, AUDIO_ENGINE->ticks_per_frame_);
+          region->loop_end_pos_setter (&loop_end);
+        }
+      if (fade_frames > 0)
+        {
+          Position fade_in;
+          fade_in.from_frames (fade_frames, AUDIO_ENGINE->ticks_per_frame_);
+          region->set_position (
+            &fade_in, ArrangerObject::PositionType::FadeIn, true);
+          Position fade_out;
+          fade_out.from_frames (
+            region->get_length_in_frames () - fade_frames,
+            AUDIO_ENGINE->ticks_per_frame_);
+          region->set_position (
+            &fade_out, ArrangerObject::PositionType::FadeOut, true);
+        }
+      if (stretch)
+        {
+          region->musical_mode_ = MusicalMode::On;
+        }
+      end_frames = std::max (end_frames, region->end_pos_->frames_);
+    }
+
+  prepare_caches_and_roll ();
+  if (stretch && !wait_for_timestretch (*regions.front ()))
+    {
+      state.SkipWithError ("timestretching didn't finish");
+      return;
+    }
+
+  const auto ports = track->processor_->get_stereo_out_ports ();
+  ports.first.ensure_buffer_size (block_size);
+  ports.second.ensure_buffer_size (block_size);
+
+  spdlog::set_level (spdlog::level::off);
+  unsigned_frame_t frame = 0;
+  for (auto _ : state)
+    {
+      track->fill_events (make_time_nfo (frame, block_size), ports);
+      benchmark::ClobberMemory ();
+
+      frame += block_size;
+      if (frame + block_size > static_cast<unsigned_frame_t> (end_frames))
+        frame = 0;
+    }
+  state.SetItemsProcessed (
+    static_cast<int64_t> (state.iterations ()) * block_size * num_regions);
+}
+
+/**
+ * Fills the MIDI events of a MIDI track from overlapping MIDI regions, one
+ * block per iteration, moving through the regions.
+ *
+ * Arguments: number of regions, notes per bar in each region, block size and
+ * whether the regions loop (every LOOP_FRAMES).
+ */
+static void
+BM_MidiTrackFillMidiEvents (benchmark::State &state)
+{
+  BenchmarkZrythmFixture fixture;
+  test_project_stop_dummy_engine ();
+
+  const auto num_regions = static_cast<int> (state.range (0));
+  const auto notes_per_bar = static_cast<int> (state.range (1));
+  const auto block_size = static_cast<nframes_t> (state.range (2));
+  const bool loop = state.range (3) != 0;
+
+  auto * track = Track::create_empty_with_action<MidiTrack> ();
+
+  const auto   ticks_per_bar = static_cast<double> (TRANSPORT->ticks_per_bar_);
+  const double frames_per_tick = AUDIO_ENGINE->frames_per_tick_;
+  const double note_ticks = ticks_per_bar / notes_per_bar;
+
+  const Position end_pos (MIDI_REGION_BARS * ticks_per_bar, frames_per_tick);
+  for (int i = 0; i < num_regions; ++i)
+    {
+      auto * region = track->Track::add_region (
+        new MidiRegion (Position (), end_pos, track->get_uuid (), i, 0),
+        nullptr, i, true, false);
+      for (int j = 0; j < MIDI_REGION_BARS * notes_per_bar; ++j)
+        {
+          region->append_object (new MidiNote (
+            region->id_, Position (j * note_ticks, frames_per_tick),
+            Position ((j + 1) * note_ticks, frames_per_tick),
+            static_cast<uint8_t> (36 + (j + i) % 48), 90));
+        }
+      if (loop)
+        {
+          Position loop_end;
+          loop_end.from_frames (LOOP_FRAMES, AUDIO_ENGINE->ticks_per_frame_);
+          region->loop_end_pos_setter (&loop_end);
+        }
+    }
+
+  prepare_caches_and_roll ();
+
+  MidiEventVector events;
+  size_t          num_events = 0;
+  spdlog::set_level (spdlog::level::off);
+  unsigned_frame_t frame = 0;
+  for (auto _ : state)
+    {
+      events.clear ();
+      track->fill_midi_events (make_time_nfo (frame, block_size), events);
+      num_events += events.size ();
+
+      frame += block_size;
+      if (frame + block_size > static_cast<unsigned_frame_t> (end_pos.frames_))
+        frame = 0;
+    }
+  state.counters["events"] = benchmark::Counter (
+    static_cast<double> (num_events), benchmark::Counter::kIsRate);
+  state.SetItemsProcessed (
+    static_cast<int64_t> (state.iterations ()) * block_size * num_regions);
+}
+
+BENCHMARK (BM_AudioRegionFillStereoPorts)
+  ->ArgNames ({ "regions", "block", "loop", "fade", "stretch" })
+  /* region count */
+  ->ArgsProduct ({ { 1, 8, 32 }, { 256 }, { 0 }, { 0 }, { 0 } })
+  /* block size */
+  ->ArgsProduct ({ { 8 }, { 32, 1024, 4096 }, { 0 }, { 0 }, { 0 } })
+  /* loops, fades and stretching */
+  ->ArgsProduct ({ { 8 }, { 256 }, { 1 }, { 0 }, { 0 } })
+  ->ArgsProduct ({ { 8 }, { 256 }, { 0 }, { 4800 }, { 0 } })
+  ->ArgsProduct ({ { 8 }, { 256 }, { 0 }, { 0 }, { 1 } })
+  ->Unit (benchmark::kMicrosecond);
+
+BENCHMARK (BM_MidiTrackFillMidiEvents)
+  ->ArgNames ({ "regions", "notes_per_bar", "block", "loop" })
+  /* region count and note density */
+  ->ArgsProduct ({ { 1, 8, 32 }, { 4, 64 }, { 256 }, { 0 } })
+  /* block size */
+  ->ArgsProduct ({ { 8 }, { 16 }, { 32, 1024, 4096 }, { 0 } })
+  /* loops */
+  ->ArgsProduct ({ { 8 }, { 16 }, { 256 }, { 1 } })
+  ->Unit (benchmark::kMicrosecond);
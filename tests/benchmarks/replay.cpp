@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+/**
+ * @file
+ *
+ * Replays engine cycles captured with dsp::CycleCapture (see
+ * AudioEngine::start_cycle_capture() and the ZRYTHM_CYCLE_CAPTURE environment
+ * variable) against the project they were captured with, as fast as possible
+ * and deterministically.
+ *
+ * The project file and the capture are given by the ZRYTHM_REPLAY_PROJECT and
+ * ZRYTHM_REPLAY_CAPTURE environment variables (the benchmark is skipped
+ * otherwise). The dummy engine must use the capture's sample rate and a block
+ * length at least as large as the capture's (see ZRYTHM_DUMMY_SAMPLE_RATE and
+ * ZRYTHM_DUMMY_BLOCK_LENGTH).
+ *
+ * The per-node processing times are printed after the run when built with
+ * ZRYTHM_DSP_NODE_PROFILING.
+ */
+
+#include "zrythm-test-config.h"
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "dsp/cycle_capture.h"
+#include "gui/backend/backend/project.h"
+#include "gui/backend/backend/zrythm.h"
+
+#include "tests/helpers/project_helper.h"
+#include "tests/helpers/zrythm_helper.h"
+
+#include "tests/benchmarks/benchmark_helpers.h"
+
+namespace
+{
+
+/**
+ * @brief Returns the given percentile of the sorted @p values.
+ */
+double
+get_percentile (const std::vector<double> &values, double percentile)
+{
+  if (values.empty ())
+    return 0.0;
+
+  const auto index = static_cast<size_t> (
+    percentile / 100.0 * static_cast<double> (values.size () - 1));
+  return values[index];
+}
+
+}
+
+/**
+ * Replays the captured cycles in order (starting over at the end), one cycle
+ * per iteration.
+ *
+ * Reports the per-cycle p50/p99/max times (in microseconds), the DSP load
+ * (the time spent processing over the duration of the processed audio) and
+ * the number of cycles dropped while capturing (which the replay skips).
+ */
+static void
+BM_ReplayCapture (benchmark::State &state)
+{
+  if (
+    !qEnvironmentVariableIsSet ("ZRYTHM_REPLAY_PROJECT")
+    || !qEnvironmentVariableIsSet ("ZRYTHM_REPLAY_CAPTURE"))
+    {
+      state.SkipWithError (
+        "ZRYTHM_REPLAY_PROJECT and ZRYTHM_REPLAY_CAPTURE must be set");
+      return;
+    }
+
+  BenchmarkZrythmFixture fixture;
+  test_project_reload (
+    qEnvironmentVariable ("ZRYTHM_REPLAY_PROJECT").toStdString ());
+  const dsp::CycleCaptureReader reader (
+    qEnvironmentVariable ("ZRYTHM_REPLAY_CAPTURE").toStdString ());
+  const auto &cycles = reader.get_cycles ();
+  const auto &header = reader.get_file_header ();
+  if (cycles.empty ())
+    {
+      state.SkipWithError ("no cycles captured");
+      return;
+    }
+  if (header.sample_rate_ != AUDIO_ENGINE->sample_rate_)
+    {
+      state.SkipWithError (
+        "the capture's sample rate differs from the engine's "
+        "(set ZRYTHM_DUMMY_SAMPLE_RATE)");
+      return;
+    }
+  if (header.max_block_length_ > AUDIO_ENGINE->max_block_length_)
+    {
+      state.SkipWithError (
+        "the capture's block length exceeds the engine's "
+        "(set ZRYTHM_DUMMY_BLOCK_LENGTH)");
+      return;
+    }
+
+  /* process manually */
+  test_project_stop_dummy_engine ();
+
+  spdlog::set_level (spdlog::level::off);
+  std::vector<double> cycle_times;
+  cycle_times.reserve (static_cast<size_t> (state.max_iterations));
+  size_t   cycle_idx = 0;
+  uint64_t num_frames = 0;
+  for (auto _ : state)
+    {
+      const auto &cycle = cycles[cycle_idx];
+      const auto  start = std::chrono::steady_clock::now ();
+      AUDIO_ENGINE->replay_cycle (cycle);
+      const auto end = std::chrono::steady_clock::now ();
+      const auto secs = std::chrono::duration<double> (end - start).count ();
+      state.SetIterationTime (secs);
+      cycle_times.push_back (secs);
+      num_frames += cycle.header_.nframes_;
+      cycle_idx = (cycle_idx + 1) % cycles.size ();
+    }
+
+  double total_secs = 0.0;
+  for (const auto secs : cycle_times)
+    total_secs += secs;
+  std::ranges::sort (cycle_times);
+  state.counters["p50_us"] = get_percentile (cycle_times, 50.0) * 1e6;
+  state.counters["p99_us"] = get_percentile (cycle_times, 99.0) * 1e6;
+  state.counters["max_us"] =
+    cycle_times.empty () ? 0.0 : cycle_times.back () * 1e6;
+  const double audio_secs = static_cast<double> (num_frames)
+                            / static_cast<double> (header.sample_rate_);
+  state.counters["dsp_load"] = audio_secs > 0.0 ? total_secs / audio_secs : 0.0;
+  state.counters["dropped_cycles"] =
+    static_cast<double> (reader.get_num_missing_cycles ());
+  state.SetItemsProcessed (static_cast<int64_t> (num_frames));
+
+  if (ZRYTHM_DSP_NODE_PROFILING)
+    {
+      fmt::print ("{}\n", ROUTER->scheduler_->node_stats_to_str ());
+    }
+}
+
+BENCHMARK (BM_ReplayCapture)
+  ->UseManualTime ()
+  ->MeasureProcessCPUTime ()
+  ->Unit (benchmark::kMicrosecond);
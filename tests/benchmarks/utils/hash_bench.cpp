@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <fstream>
+#include <vector>
+
+#include "utils/hash.h"
+#include "utils/io.h"
+
+#include <benchmark/benchmark.h>
+
+using namespace zrythm::utils;
+
+namespace
+{
+
+/** Creates a file of the given size in MiB inside @p dir. */
+fs::path
+create_file (const QTemporaryDir &dir, int64_t size_mib)
+{
+  auto path = fs::path (dir.path ().toStdString ()) / "file.bin";
+  std::vector<char> buf (1024 * 1024);
+  for (size_t i = 0; i < buf.size (); i++)
+    {
+      buf[i] = static_cast<char> (i * 31);
+    }
+  std::ofstream stream (path, std::ios::binary);
+  for (int64_t i = 0; i < size_mib; i++)
+    {
+      stream.write (buf.data (), static_cast<std::streamsize> (buf.size ()));
+    }
+  return path;
+}
+
+}
+
+static void
+BM_FileHash (benchmark::State &state)
+{
+  const auto tmp_dir = io::make_tmp_dir ();
+  const auto path = create_file (*tmp_dir, state.range (0));
+  for (auto _ : state)
+    {
+      benchmark::DoNotOptimize (hash::get_file_hash (path));
+    }
+  state.SetBytesProcessed (state.iterations () * state.range (0) * 1024 * 1024);
+}
+
+static void
+BM_FileHashParallel (benchmark::State &state)
+{
+  const auto tmp_dir = io::make_tmp_dir ();
+  const auto path = create_file (*tmp_dir, state.range (0));
+  for (auto _ : state)
+    {
+      benchmark::DoNotOptimize (hash::get_file_hash_parallel (
+        path, static_cast<unsigned int> (state.range (1))));
+    }
+  state.SetBytesProcessed (state.iterations () * state.range (0) * 1024 * 1024);
+}
+
+BENCHMARK (BM_FileHash)->ArgName ("MiB")->Arg (1)->Arg (64)->Arg (512);
+BENCHMARK (BM_FileHashParallel)
+  ->ArgNames ({ "MiB", "threads" })
+  ->Args ({ 64, 1 })
+  ->Args ({ 64, 0 })
+  ->Args ({ 512, 1 })
+  ->Args ({ 512, 0 });
@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <array>
+#include <memory>
+
+#include "utils/mpmc_queue.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+/** Like the children triggered by a node with many dependents. */
+constexpr size_t BATCH_SIZE = 50;
+
+std::unique_ptr<MPMCQueue<int *>> queue;
+
+/**
+ * Each thread pushes and pops BATCH_SIZE elements per iteration, either one
+ * at a time or as one batch.
+ */
+template <bool Bulk>
+void
+push_and_pop (benchmark::State &state)
+{
+  if (state.thread_index () == 0)
+    {
+      queue = std::make_unique<MPMCQueue<int *>> (
+        BATCH_SIZE * static_cast<size_t> (state.threads ()));
+    }
+
+  int                           dummy = 0;
+  std::array<int *, BATCH_SIZE> items;
+  items.fill (&dummy);
+  for (auto _ : state)
+    {
+      if constexpr (Bulk)
+        {
+          size_t pushed = 0;
+          while (pushed < BATCH_SIZE)
+            {
+              pushed += queue->push_back_multiple (
+                items.data () + pushed, BATCH_SIZE - pushed);
+            }
+          size_t popped = 0;
+          while (popped < BATCH_SIZE)
+            {
+              popped += queue->pop_front_multiple (
+                items.data () + popped, BATCH_SIZE - popped);
+            }
+        }
+      else
+        {
+          for (auto * item : items)
+            {
+              while (!queue->push_back (item))
+                ;
+            }
+          for (auto &item : items)
+            {
+              while (!queue->pop_front (item))
+                ;
+            }
+        }
+      benchmark::DoNotOptimize (items.data ());
+    }
+  state.SetItemsProcessed (
+    state.iterations () * static_cast<int64_t> (BATCH_SIZE));
+
+  if (state.thread_index () == 0)
+    {
+      queue.reset ();
+    }
+}
+
+}
+
+static void
+BM_MPMCQueueSingle (benchmark::State &state)
+{
+  push_and_pop<false> (state);
+}
+
+static void
+BM_MPMCQueueBatch (benchmark::State &state)
+{
+  push_and_pop<true> (state);
+}
+
+BENCHMARK (BM_MPMCQueueSingle)->ThreadRange (8, 64)->UseRealTime ();
+BENCHMARK (BM_MPMCQueueBatch)->ThreadRange (8, 64)->UseRealTime ();
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include "utils/ring_buffer.h"
+
+#include <benchmark/benchmark.h>
+
+namespace
+{
+
+/**
+ * Writes and reads blocks of range(1) frames through a ring buffer with a
+ * capacity of range(0) frames, like the audio rings of ports.
+ */
+template <bool Bulk>
+void
+write_and_read_blocks (benchmark::State &state)
+{
+  const auto         capacity = static_cast<size_t> (state.range (0));
+  const auto         block_size = static_cast<size_t> (state.range (1));
+  RingBuffer<float>  ring (capacity);
+  std::vector<float> in (block_size, 0.5f);
+  std::vector<float> out (block_size);
+  for (auto _ : state)
+    {
+      if constexpr (Bulk)
+        {
+          ring.force_write_multiple (in.data (), block_size);
+          ring.read_multiple (out.data (), block_size);
+        }
+      else
+        {
+          for (const auto val : in)
+            ring.force_write (val);
+          for (auto &val : out)
+            ring.read (val);
+        }
+      benchmark::DoNotOptimize (out.data ());
+    }
+  state.SetItemsProcessed (
+    state.iterations () * static_cast<int64_t> (block_size));
+}
+
+}
+
+static void
+BM_RingBufferPerElement (benchmark::State &state)
+{
+  write_and_read_blocks<false> (state);
+}
+
+static void
+BM_RingBufferBulk (benchmark::State &state)
+{
+  write_and_read_blocks<true> (state);
+}
+
+/** Producer and consumer on separate threads (measures false sharing). */
+static void
+BM_RingBufferProducerConsumer (benchmark::State &state)
+{
+  constexpr size_t   block_size = 256;
+  RingBuffer<float>  ring (static_cast<size_t> (state.range (0)));
+  std::atomic<bool>  done{ false };
+  std::thread        consumer ([&] () {
+    std::vector<float> out (block_size);
+    while (!done.load (std::memory_order_relaxed))
+      {
+        ring.read_multiple (out.data (), block_size);
+      }
+  });
+  std::vector<float> in (block_size, 0.5f);
+  for (auto _ : state)
+    {
+      while (!ring.write_multiple (in.data (), block_size))
+        ;
+    }
+  done = true;
+  consumer.join ();
+  state.SetItemsProcessed (
+    state.iterations () * static_cast<int64_t> (block_size));
+}
+
+// 65535 is one less than a power of 2 (mask fast path)
+BENCHMARK (BM_RingBufferPerElement)
+  ->ArgNames ({ "capacity", "block" })
+  ->Args ({ 65535, 256 })
+  ->Args ({ 65536, 256 })
+  ->Args ({ 65536, 4096 });
+BENCHMARK (BM_RingBufferBulk)
+  ->ArgNames ({ "capacity", "block" })
+  ->Args ({ 65535, 256 })
+  ->Args ({ 65536, 256 })
+  ->Args ({ 65536, 4096 });
+BENCHMARK (BM_RingBufferProducerConsumer)
+  ->ArgName ("capacity")
+  ->Arg (4095)
+  ->Arg (65536)
+  ->UseRealTime ();
@@ -86,7 +86,7 @@ TEST_F (ZrythmFixture, FillStereoPorts)
     .local_offset_ = 0,
     .nframes_ = 100
   };
-  r->fill_stereo_ports (time_nfo, ports);
+  r->fill_stereo_ports (time_nfo, ports, track->region_scratch_bufs_);
 
   ASSERT_TRUE (audio_frames_empty (&ports.get_l ().buf_[0], 20));
   ASSERT_TRUE (audio_frames_empty (&ports.get_r ().buf_[0], 20));
@@ -8,7 +8,9 @@
 
 #include "tests/helpers/project_helper.h"
 
+#include "gui/dsp/audio_track.h"
 #include "gui/dsp/channel_track.h"
+#include "gui/dsp/pool.h"
 
 TEST_F (ZrythmFixture, CloneChannelTrack)
 {
@@ -36,3 +38,28 @@ TEST_F (ZrythmFixture, CloneChannelTrack)
   // check for cloned track
   expect_ports_have_orig_track_name_hash (cloned_track);
 }
+
+TEST_F (ZrythmFixture, FreezeChannelTrack)
+{
+  FileDescriptor file (fs::path (TESTS_SRCDIR) / "test.wav");
+  Track::create_with_action (
+    Track::Type::Audio, nullptr, &file, &PLAYHEAD, TRACKLIST->get_num_tracks (),
+    1, -1, nullptr);
+  auto * track = TRACKLIST->get_last_track<AudioTrack> ();
+
+  track->freeze (utils::audio::BounceStep::PostFader);
+  ASSERT_TRUE (track->frozen_);
+  ASSERT_FALSE (track->is_freeze_stale ());
+  const auto * clip = AUDIO_POOL->get_clip (track->pool_id_);
+  ASSERT_NONNULL (clip);
+  ASSERT_GT (clip->get_num_frames (), 0);
+  ASSERT_TRUE (PROJECT->is_audio_clip_in_use (*clip, false));
+
+  /* changing the fader invalidates a post-fader freeze */
+  track->channel_->fader_->set_amp (0.5f);
+  ASSERT_TRUE (track->is_freeze_stale ());
+
+  track->unfreeze ();
+  ASSERT_FALSE (track->frozen_);
+  ASSERT_FALSE (track->is_freeze_stale ());
+}
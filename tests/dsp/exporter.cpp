@@ -14,6 +14,7 @@
 #include "tests/helpers/zrythm_helper.h"
 
 #include "utils/chromaprint.h"
+#include "utils/io.h"
 #include "utils/progress_info.h"
 #include <sndfile.h>
 
@@ -61,14 +62,17 @@ TEST_F (ZrythmFixture, BounceWithNoteAtStart)
   settings.time_range_ = Exporter::TimeRange::Loop;
   TL_SELECTIONS->mark_for_bounce (settings.bounce_with_parents_);
 
-  Exporter exporter (settings);
+  const auto block_length = AUDIO_ENGINE->block_length_;
+  Exporter   exporter (settings);
   exporter.prepare_tracks_for_export (*AUDIO_ENGINE, *TRANSPORT);
+  ASSERT_EQ (AUDIO_ENGINE->block_length_, Exporter::OFFLINE_BLOCK_LENGTH);
 
   /* start exporting in a new thread */
   exporter.begin_generic_thread ();
   print_progress_and_sleep (*exporter.progress_info_);
   exporter.join_generic_thread ();
   exporter.post_export ();
+  ASSERT_EQ (AUDIO_ENGINE->block_length_, block_length);
 
   ASSERT_FALSE (audio_file_is_silent (exporter.get_exported_path ().c_str ()));
 }
@@ -946,3 +950,93 @@ TEST_F (ZrythmFixture, ExportMidiRange)
   ASSERT_POSITION_EQ (mn->pos_, start);
   ASSERT_POSITION_EQ (mn->end_pos_, end);
 }
+
+/**
+ * Export stems in a single pass and check that they match the stems exported
+ * one after another.
+ */
+TEST_F (ZrythmFixture, ExportStemsInParallel)
+{
+  /* create 2 audio tracks */
+  FileDescriptor file (fs::path (TESTS_SRCDIR) / "test.wav");
+  std::vector<Track *> tracks;
+  for (int i = 0; i < 2; ++i)
+    {
+      Track::create_with_action (
+        Track::Type::Audio, nullptr, &file, &PLAYHEAD,
+        TRACKLIST->get_num_tracks (), 1, -1, nullptr);
+      tracks.push_back (TRACKLIST->get_last_track<AudioTrack> ());
+    }
+  dynamic_cast<AudioTrack *> (tracks[1])->channel_->fader_->set_amp (0.5f);
+
+  const auto get_settings = [] () {
+    Exporter::Settings settings;
+    settings.mode_ = Exporter::Mode::Tracks;
+    settings.set_bounce_defaults (Exporter::Format::WAV, "", __func__);
+    settings.time_range_ = Exporter::TimeRange::Loop;
+    settings.bounce_with_parents_ = false;
+    return settings;
+  };
+  const auto mark_for_bounce = [] (const std::vector<Track *> &to_bounce) {
+    TRACKLIST->mark_all_tracks_for_bounce (false);
+    for (auto * track : to_bounce)
+      {
+        track->bounce_to_master_ = true;
+        track->mark_for_bounce (true, true, true, false);
+      }
+  };
+  const auto export_stems = [] (Exporter &exporter) {
+    exporter.prepare_tracks_for_export (*AUDIO_ENGINE, *TRANSPORT);
+    exporter.begin_generic_thread ();
+    print_progress_and_sleep (*exporter.progress_info_);
+    exporter.join_generic_thread ();
+    exporter.post_export ();
+  };
+
+  /* sequentially */
+  std::vector<fs::path> sequential_stems;
+  for (auto * track : tracks)
+    {
+      mark_for_bounce ({ track });
+      Exporter exporter (get_settings ());
+      exporter.export_stems_ = true;
+      export_stems (exporter);
+      sequential_stems.push_back (exporter.get_exported_path ());
+    }
+
+  /* in a single pass */
+  auto settings = get_settings ();
+  ASSERT_TRUE (Exporter::can_export_stems_in_parallel (settings, tracks));
+  mark_for_bounce (tracks);
+  Exporter exporter (settings);
+  exporter.export_stems_ = true;
+  exporter.tracks_ = tracks;
+  for (size_t i = 0; i < tracks.size (); ++i)
+    {
+      exporter.stem_file_uris_.push_back (
+        (fs::path (settings.file_uri_).parent_path ()
+         / fmt::format ("parallel_stem_{}.wav", i))
+          .string ());
+    }
+  export_stems (exporter);
+  ASSERT_EQ (
+    exporter.progress_info_->get_completion_type (),
+    ProgressInfo::CompletionType::SUCCESS);
+
+  for (size_t i = 0; i < tracks.size (); ++i)
+    {
+      const auto &stem_path = exporter.stem_file_uris_[i];
+      ASSERT_FALSE (audio_file_is_silent (stem_path.c_str ()));
+      EXPECT_EQ (
+        utils::io::read_file_contents (stem_path),
+        utils::io::read_file_contents (sequential_stems[i]));
+    }
+
+  /* a send to a stem track is only audible when rendering all the stems at
+   * once */
+  UNDO_MANAGER->perform (std::make_unique<ChannelSendConnectStereoAction> (
+    *dynamic_cast<AudioTrack *> (tracks[0])->channel_->sends_.at (0),
+    *dynamic_cast<AudioTrack *> (tracks[1])->processor_->stereo_in_,
+    *PORT_CONNECTIONS_MGR));
+  EXPECT_FALSE (Exporter::can_export_stems_in_parallel (settings, tracks));
+}
@@ -24,7 +24,7 @@ TEST_F (ZrythmFixture, FindAndQueueMetronome)
     AUDIO_ENGINE->metronome_->queue_events (
       AUDIO_ENGINE.get (), 0, AUDIO_ENGINE->block_length_);
 
-    ASSERT_EMPTY (SAMPLE_PROCESSOR->current_samples_);
+    ASSERT_EMPTY (SAMPLE_PROCESSOR->get_current_samples ());
   }
 
   /*
@@ -64,14 +64,14 @@ TEST_F (ZrythmFixture, FindAndQueueMetronome)
       AUDIO_ENGINE.get (), 0, AUDIO_ENGINE->block_length_);
 
     /* assert no sound is played for 5.1.1.0 */
-    ASSERT_EMPTY (SAMPLE_PROCESSOR->current_samples_);
+    ASSERT_EMPTY (SAMPLE_PROCESSOR->get_current_samples ());
 
     /* go to the next round and verify that metronome was added */
     TRANSPORT->add_to_playhead (AUDIO_ENGINE->block_length_);
     AUDIO_ENGINE->metronome_->queue_events (AUDIO_ENGINE.get (), 0, 1);
 
     /* assert metronome is queued for 1.1.1.0 */
-    ASSERT_SIZE_EQ (SAMPLE_PROCESSOR->current_samples_, 1);
+    ASSERT_SIZE_EQ (SAMPLE_PROCESSOR->get_current_samples (), 1);
   }
 
   {
@@ -82,9 +82,9 @@ TEST_F (ZrythmFixture, FindAndQueueMetronome)
 
     for (nframes_t i = 0; i < 200; i++)
       {
-        SAMPLE_PROCESSOR->current_samples_.clear ();
+        SAMPLE_PROCESSOR->clear_current_samples ();
         AUDIO_ENGINE->metronome_->queue_events (AUDIO_ENGINE.get (), 0, 1);
-        ASSERT_SIZE_EQ (SAMPLE_PROCESSOR->current_samples_, i == 4);
+        ASSERT_SIZE_EQ (SAMPLE_PROCESSOR->get_current_samples (), i == 4);
         TRANSPORT->add_to_playhead (1);
       }
 
@@ -93,9 +93,10 @@ TEST_F (ZrythmFixture, FindAndQueueMetronome)
     TRANSPORT->set_playhead_pos (play_pos);
     for (nframes_t i = 0; i < 200; i++)
       {
-        SAMPLE_PROCESSOR->current_samples_.clear ();
+        SAMPLE_PROCESSOR->clear_current_samples ();
         METRONOME->queue_events (AUDIO_ENGINE.get (), 0, 2);
-        ASSERT_SIZE_EQ (SAMPLE_PROCESSOR->current_samples_, (i >= 3 && i <= 4));
+        ASSERT_SIZE_EQ (
+          SAMPLE_PROCESSOR->get_current_samples (), (i >= 3 && i <= 4));
         TRANSPORT->add_to_playhead (1);
       }
   }
@@ -115,18 +116,18 @@ TEST_F (ZrythmFixture, FindAndQueueMetronome)
       TRANSPORT->loop_end_pos_.set_to_bar (16);
 
       /* assert no playback from playhead to loop end */
-      SAMPLE_PROCESSOR->current_samples_.clear ();
+      SAMPLE_PROCESSOR->clear_current_samples ();
       METRONOME->queue_events (
         AUDIO_ENGINE.get (), 0, AUDIO_ENGINE->block_length_);
-      ASSERT_EMPTY (SAMPLE_PROCESSOR->current_samples_);
+      ASSERT_EMPTY (SAMPLE_PROCESSOR->get_current_samples ());
 
       /* add remaining frames and assert playback at the first sample */
       TRANSPORT->add_to_playhead (AUDIO_ENGINE->block_length_);
-      SAMPLE_PROCESSOR->current_samples_.clear ();
+      SAMPLE_PROCESSOR->clear_current_samples ();
       METRONOME->queue_events (
         AUDIO_ENGINE.get (), 0, AUDIO_ENGINE->block_length_);
-      ASSERT_SIZE_EQ (SAMPLE_PROCESSOR->current_samples_, 1);
-      const auto &sp = SAMPLE_PROCESSOR->current_samples_[0];
+      ASSERT_SIZE_EQ (SAMPLE_PROCESSOR->get_current_samples (), 1);
+      const auto &sp = SAMPLE_PROCESSOR->get_current_samples ()[0];
       ASSERT_EQ (sp.start_offset_, 0);
     }
 }
@@ -21,7 +21,12 @@ TEST_F (ZrythmFixture, QueueFile)
   FileDescriptor file (fs::path (TESTS_SRCDIR) / "test.wav");
   SAMPLE_PROCESSOR->queue_file (file);
 
-  ASSERT_EQ (SAMPLE_PROCESSOR->playhead_.frames_, 0);
+  /* wait for the first frames to be streamed */
+  ASSERT_NONNULL (SAMPLE_PROCESSOR->file_preview_);
+  while (SAMPLE_PROCESSOR->file_preview_->get_num_buffered_frames () < 256 * 3)
+    {
+      std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
 
   /* queue for a few frames */
   AUDIO_ENGINE->process (256);
@@ -5,6 +5,9 @@
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 
+#include "utils/rt_guard.h"
+
+#include "tests/helpers/project_helper.h"
 #include "tests/helpers/zrythm_helper.h"
 
 /**
@@ -13,3 +16,34 @@
  * This is intended to be ran with a memory leak detector.
  */
 TEST_F (ZrythmFixture, MemoryAllocation) { }
+
+/**
+ * Verify that playing back a project doesn't allocate or block on the
+ * realtime threads (needs ZRYTHM_RT_GUARD).
+ */
+TEST_F (BootstrapTimelineFixture, NoRealtimeViolationsDuringPlayback)
+{
+  using zrythm::utils::RtGuard;
+  if constexpr (!RtGuard::enabled ())
+    {
+      GTEST_SKIP () << "built without ZRYTHM_RT_GUARD";
+    }
+
+  test_project_stop_dummy_engine ();
+  TRANSPORT->play_state_ = Transport::PlayState::Rolling;
+
+  /* let the first cycles fill any caches */
+  constexpr int NUM_WARMUP_CYCLES = 4;
+  for (int i = 0; i < NUM_WARMUP_CYCLES; ++i)
+    {
+      AUDIO_ENGINE->process (AUDIO_ENGINE->block_length_);
+    }
+
+  RtGuard::reset ();
+  constexpr int NUM_CYCLES = 512;
+  for (int i = 0; i < NUM_CYCLES; ++i)
+    {
+      AUDIO_ENGINE->process (AUDIO_ENGINE->block_length_);
+    }
+  EXPECT_EQ (RtGuard::get_num_violations (), 0) << RtGuard::get_report ();
+}
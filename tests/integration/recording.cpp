@@ -7,6 +7,7 @@
 # include "gui/dsp/master_track.h"
 # include "gui/dsp/midi_event.h"
 # include "gui/dsp/midi_track.h"
+# include "gui/dsp/pool.h"
 # include "gui/dsp/recording_manager.h"
 #include "utils/flags.h"
 #include "gui/backend/backend/project.h"
@@ -763,6 +764,11 @@ TEST_F (ZrythmFixture, MonoRecording)
   TRANSPORT->requestPause (true);
   RECORDING_MANAGER->process_events ();
 
+  /* assert that the disk writer wrote the whole clip to the pool */
+  ASSERT_TRUE (clip->verify_recorded_file (
+    AudioPool::get_clip_path (*clip, false), AUDIO_ENGINE->sample_rate_,
+    P_TEMPO_TRACK->get_current_bpm ()));
+
   /* save and undo/redo */
   test_project_save_and_reload ();
   UNDO_MANAGER->undo ();
@@ -0,0 +1,326 @@
+#include <thread>
+
+#include "dsp/anticipative_renderer.h"
+#include "dsp/graph_node.h"
+#include "dsp/graph_scheduler.h"
+#include "utils/gtest_wrapper.h"
+
+using namespace std::chrono_literals;
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+constexpr nframes_t BLOCK_LENGTH = 64;
+
+class RollingTransport final : public ITransport
+{
+public:
+  void position_add_frames (Position &pos, signed_frame_t frames) const override
+  {
+    pos.frames_ += frames;
+  }
+  std::pair<Position, Position> get_loop_range_positions () const override
+  {
+    return {};
+  }
+  PlayState get_play_state () const override { return PlayState::Rolling; }
+  Position  get_playhead_position () const override
+  {
+    Position pos;
+    pos.frames_ = playhead_.load ();
+    return pos;
+  }
+  bool get_loop_enabled () const override { return false; }
+  nframes_t
+  is_loop_point_met (signed_frame_t, nframes_t) const override
+  {
+    return 0;
+  }
+
+  std::atomic<signed_frame_t> playhead_ = 0;
+};
+
+/**
+ * Plays back the timeline: outputs the start frame of the block it was
+ * processed for.
+ */
+class TimelineProcessable final : public IProcessable
+{
+public:
+  std::string get_node_name () const override { return "timeline"; }
+  void        process_block (EngineProcessTimeInfo time_nfo) override
+  {
+    out_ = static_cast<signed_frame_t> (time_nfo.g_start_frame_w_offset_);
+    ++num_processed_;
+  }
+  bool can_render_ahead () const override { return true; }
+  void set_rendered_ahead (bool rendered_ahead) override
+  {
+    rendered_ahead_ = rendered_ahead;
+  }
+  void clear_rendered_ahead_buffers () override { out_ = -1; }
+
+  signed_frame_t    out_ = -1;
+  std::atomic<int>  num_processed_ = 0;
+  bool              rendered_ahead_ = false;
+};
+
+/**
+ * Copies @ref src_ to its output, like a port summing its sources.
+ */
+class PassThroughProcessable final : public IProcessable
+{
+public:
+  PassThroughProcessable (const TimelineProcessable &src, bool can_store)
+      : src_ (src), can_store_ (can_store)
+  {
+  }
+  std::string get_node_name () const override { return "pass-through"; }
+  void        process_block (EngineProcessTimeInfo) override
+  {
+    out_ = src_.out_;
+  }
+  bool        can_render_ahead () const override { return true; }
+  bool        can_store_rendered_ahead_output () const override
+  {
+    return can_store_;
+  }
+  void allocate_rendered_ahead_slots (size_t num_slots, nframes_t) override
+  {
+    slots_.assign (num_slots, -1);
+  }
+  void render_ahead_into_slot (size_t slot, EngineProcessTimeInfo) override
+  {
+    slots_[slot] = src_.out_;
+  }
+  void restore_from_slot (size_t slot, EngineProcessTimeInfo) override
+  {
+    out_ = slots_[slot];
+  }
+
+  const TimelineProcessable  &src_;
+  bool                        can_store_;
+  std::atomic<signed_frame_t> out_ = -1;
+  std::vector<signed_frame_t> slots_;
+};
+
+/**
+ * Live node reading the pass-through output.
+ */
+class LiveProcessable final : public IProcessable
+{
+public:
+  explicit LiveProcessable (const PassThroughProcessable &src) : src_ (src) { }
+  std::string get_node_name () const override { return "live"; }
+  void        process_block (EngineProcessTimeInfo time_nfo) override
+  {
+    received_ = src_.out_.load ();
+    expected_ = static_cast<signed_frame_t> (time_nfo.g_start_frame_w_offset_);
+  }
+
+  const PassThroughProcessable &src_;
+  signed_frame_t                received_ = -1;
+  signed_frame_t                expected_ = -1;
+};
+
+}
+
+class AnticipativeRendererTest : public ::testing::Test
+{
+protected:
+  GraphNodeCollection create_collection (bool boundary_can_store)
+  {
+    pass_through_ =
+      std::make_unique<PassThroughProcessable> (timeline_, boundary_can_store);
+    live_ = std::make_unique<LiveProcessable> (*pass_through_);
+
+    GraphNodeCollection collection;
+    collection.graph_nodes_.push_back (
+      std::make_unique<GraphNode> (0, transport_, timeline_));
+    collection.graph_nodes_.push_back (
+      std::make_unique<GraphNode> (1, transport_, *pass_through_));
+    collection.graph_nodes_.push_back (
+      std::make_unique<GraphNode> (2, transport_, *live_));
+    collection.graph_nodes_[0]->connect_to (*collection.graph_nodes_[1]);
+    collection.graph_nodes_[1]->connect_to (*collection.graph_nodes_[2]);
+    collection.finalize_nodes ();
+    return collection;
+  }
+
+  void process_cycle (
+    AnticipativeRenderer      &renderer,
+    const GraphNodeCollection &collection)
+  {
+    const auto                  frames = transport_.playhead_.load ();
+    const EngineProcessTimeInfo time_nfo{
+      .g_start_frame_ = static_cast<unsigned_frame_t> (frames),
+      .g_start_frame_w_offset_ = static_cast<unsigned_frame_t> (frames),
+      .local_offset_ = 0,
+      .nframes_ = BLOCK_LENGTH,
+    };
+    renderer.begin_cycle (time_nfo, 0);
+    for (const auto node : collection.topological_order_)
+      {
+        node.get ().process (time_nfo, 0);
+      }
+    renderer.end_cycle ();
+    transport_.playhead_ += BLOCK_LENGTH;
+  }
+
+  RollingTransport                        transport_;
+  TimelineProcessable                     timeline_;
+  std::unique_ptr<PassThroughProcessable> pass_through_;
+  std::unique_ptr<LiveProcessable>        live_;
+};
+
+TEST_F (AnticipativeRendererTest, AssignsTimelineOnlyNodes)
+{
+  auto                 collection = create_collection (true);
+  AnticipativeRenderer renderer (transport_, BLOCK_LENGTH);
+  renderer.assign_nodes (collection);
+
+  EXPECT_EQ (renderer.get_num_assigned_nodes (), 2);
+  EXPECT_EQ (renderer.get_num_boundary_nodes (), 1);
+  EXPECT_TRUE (timeline_.rendered_ahead_);
+  EXPECT_TRUE (collection.graph_nodes_[1]->rendered_ahead_boundary_);
+  EXPECT_EQ (collection.graph_nodes_[2]->anticipative_renderer_, nullptr);
+
+  renderer.release_nodes ();
+  EXPECT_EQ (renderer.get_num_assigned_nodes (), 0);
+  EXPECT_FALSE (timeline_.rendered_ahead_);
+  EXPECT_EQ (collection.graph_nodes_[0]->anticipative_renderer_, nullptr);
+}
+
+TEST_F (AnticipativeRendererTest, BoundaryMustStoreOutput)
+{
+  // the pass-through node can't store its output and neither can the
+  // timeline node that would become the boundary instead
+  auto                 collection = create_collection (false);
+  AnticipativeRenderer renderer (transport_, BLOCK_LENGTH);
+  renderer.assign_nodes (collection);
+
+  EXPECT_EQ (renderer.get_num_assigned_nodes (), 0);
+  EXPECT_FALSE (timeline_.rendered_ahead_);
+}
+
+TEST_F (AnticipativeRendererTest, RestoresRenderedBlocks)
+{
+  auto                 collection = create_collection (true);
+  AnticipativeRenderer renderer (transport_, BLOCK_LENGTH, 2);
+  renderer.assign_nodes (collection);
+
+  // nothing was rendered yet, so the first cycle is processed live
+  EXPECT_FALSE (renderer.render_next_block ());
+  process_cycle (renderer, collection);
+  EXPECT_EQ (live_->received_, 0);
+  EXPECT_EQ (renderer.get_num_live_cycles (), 1);
+  EXPECT_EQ (timeline_.num_processed_, 1);
+
+  // render the next 2 blocks ahead
+  EXPECT_TRUE (renderer.render_next_block ());
+  EXPECT_TRUE (renderer.render_next_block ());
+  EXPECT_FALSE (renderer.render_next_block ());
+  EXPECT_EQ (timeline_.num_processed_, 3);
+
+  // the realtime thread only restores them
+  for (int i = 0; i < 2; ++i)
+    {
+      process_cycle (renderer, collection);
+      EXPECT_EQ (live_->received_, live_->expected_);
+    }
+  EXPECT_EQ (timeline_.num_processed_, 3);
+  EXPECT_EQ (renderer.get_num_rendered_ahead_cycles (), 2);
+
+  // rendered blocks are discarded on invalidation
+  EXPECT_TRUE (renderer.render_next_block ());
+  renderer.invalidate ();
+  EXPECT_FALSE (renderer.render_next_block ());
+  process_cycle (renderer, collection);
+  EXPECT_EQ (live_->received_, live_->expected_);
+  EXPECT_EQ (renderer.get_num_live_cycles (), 2);
+
+  // and after seeking
+  EXPECT_TRUE (renderer.render_next_block ());
+  transport_.playhead_ += 10 * BLOCK_LENGTH;
+  process_cycle (renderer, collection);
+  EXPECT_EQ (live_->received_, live_->expected_);
+  EXPECT_EQ (renderer.get_num_live_cycles (), 3);
+}
+
+TEST_F (AnticipativeRendererTest, PauseDiscardsRenderedBlocks)
+{
+  auto                 collection = create_collection (true);
+  AnticipativeRenderer renderer (transport_, BLOCK_LENGTH);
+  renderer.assign_nodes (collection);
+  process_cycle (renderer, collection);
+  EXPECT_TRUE (renderer.render_next_block ());
+
+  renderer.pause ();
+  EXPECT_TRUE (renderer.is_paused ());
+  EXPECT_FALSE (renderer.render_next_block ());
+  renderer.resume ();
+  EXPECT_FALSE (renderer.is_paused ());
+
+  process_cycle (renderer, collection);
+  EXPECT_EQ (live_->received_, live_->expected_);
+  EXPECT_EQ (renderer.get_num_rendered_ahead_cycles (), 0);
+  EXPECT_EQ (renderer.get_num_live_cycles (), 2);
+}
+
+TEST_F (AnticipativeRendererTest, WaitsForLiveCycleAfterResume)
+{
+  auto                 collection = create_collection (true);
+  AnticipativeRenderer renderer (transport_, BLOCK_LENGTH);
+  renderer.assign_nodes (collection);
+
+  // the position published before pausing is not used after resuming, as
+  // anything may have changed in between
+  process_cycle (renderer, collection);
+  renderer.pause ();
+  renderer.resume ();
+  EXPECT_FALSE (renderer.render_next_block ());
+
+  process_cycle (renderer, collection);
+  EXPECT_TRUE (renderer.render_next_block ());
+}
+
+TEST_F (AnticipativeRendererTest, WithScheduler)
+{
+  GraphScheduler scheduler;
+  scheduler.rechain_from_node_collection (create_collection (true));
+  scheduler.enable_anticipative_rendering (transport_, BLOCK_LENGTH);
+  scheduler.start_threads (1);
+
+  auto * renderer = scheduler.get_anticipative_renderer ();
+  ASSERT_NE (renderer, nullptr);
+  EXPECT_EQ (renderer->get_num_assigned_nodes (), 2);
+
+  // published collections can't be handed over to the renderer
+  EXPECT_FALSE (scheduler.publish_node_collection (GraphNodeCollection{}));
+
+  // every cycle gets the output for its own position, whether it was
+  // rendered ahead or not
+  for (
+    int i = 0; i < 2000 && renderer->get_num_rendered_ahead_cycles () < 8; ++i)
+    {
+      const auto                  frames = transport_.playhead_.load ();
+      const EngineProcessTimeInfo time_nfo{
+        .g_start_frame_ = static_cast<unsigned_frame_t> (frames),
+        .g_start_frame_w_offset_ = static_cast<unsigned_frame_t> (frames),
+        .local_offset_ = 0,
+        .nframes_ = BLOCK_LENGTH,
+      };
+      scheduler.run_cycle (time_nfo, 0);
+      EXPECT_EQ (live_->received_, live_->expected_);
+      transport_.playhead_ += BLOCK_LENGTH;
+      std::this_thread::sleep_for (1ms);
+    }
+  EXPECT_GE (renderer->get_num_rendered_ahead_cycles (), 8);
+
+  scheduler.terminate_threads ();
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,124 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cmath>
+#include <cstring>
+
+#include "dsp/audio_range_patch.h"
+#include "utils/exceptions.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+utils::audio::AudioBuffer
+make_sine (int num_frames)
+{
+  utils::audio::AudioBuffer buf (2, num_frames);
+  for (int i = 0; i < num_frames; ++i)
+    {
+      const auto val = std::sin (static_cast<float> (i) * 0.01f);
+      buf.setSample (0, i, val);
+      buf.setSample (1, i, -val);
+    }
+  return buf;
+}
+}
+
+TEST (AudioRangePatchTest, OnlyStoresChangedFrames)
+{
+  constexpr int num_frames = 48000;
+  const auto    before = make_sine (num_frames);
+  auto          after = before;
+
+  /* change 99 frames near the end */
+  after.applyGain (num_frames - 100, 99, 0.5f);
+
+  const AudioRangePatch patch (before, after, 1000);
+  EXPECT_EQ (patch.get_start_frame (), 1000 + num_frames - 100);
+  EXPECT_EQ (patch.get_num_frames (), 99);
+  EXPECT_EQ (patch.get_num_channels (), 2);
+  /* much less than a copy of the clip */
+  EXPECT_LT (patch.get_compressed_size (), num_frames * sizeof (float) / 10);
+
+  const auto frames_after = patch.get_frames (true);
+  ASSERT_EQ (frames_after.getNumSamples (), 99);
+  for (int i = 0; i < 99; ++i)
+    {
+      EXPECT_EQ (
+        frames_after.getSample (1, i),
+        after.getSample (1, num_frames - 100 + i));
+    }
+}
+
+TEST (AudioRangePatchTest, ApplyRestoresExactly)
+{
+  const auto before = make_sine (4096);
+  auto       after = before;
+  after.applyGain (1000, 2000, -1.f);
+  after.setSample (0, 1500, std::nanf (""));
+
+  const AudioRangePatch patch (before, after, 0);
+
+  auto clip = before;
+  patch.apply (clip, true);
+  for (int ch = 0; ch < 2; ++ch)
+    {
+      EXPECT_EQ (
+        std::memcmp (
+          clip.getReadPointer (ch), after.getReadPointer (ch),
+          4096 * sizeof (float)),
+        0);
+    }
+
+  patch.apply (clip, false);
+  for (int ch = 0; ch < 2; ++ch)
+    {
+      EXPECT_EQ (
+        std::memcmp (
+          clip.getReadPointer (ch), before.getReadPointer (ch),
+          4096 * sizeof (float)),
+        0);
+    }
+
+  utils::audio::AudioBuffer too_small (2, 100);
+  EXPECT_THROW (patch.apply (too_small, true), ZrythmException);
+}
+
+TEST (AudioRangePatchTest, Unchanged)
+{
+  const auto            frames = make_sine (1000);
+  const AudioRangePatch patch (frames, frames, 0);
+  EXPECT_TRUE (patch.empty ());
+  EXPECT_EQ (patch.get_compressed_size (), 0);
+  EXPECT_EQ (patch.get_frames (false).getNumSamples (), 0);
+
+  EXPECT_THROW (
+    AudioRangePatch (frames, make_sine (999), 0), ZrythmException);
+}
+
+TEST (AudioRangePatchTest, Serialization)
+{
+  const auto before = make_sine (2000);
+  auto       after = before;
+  after.applyGain (100, 300, 0.25f);
+
+  const AudioRangePatch patch (before, after, 500);
+  const auto            json = patch.serialize_to_json_string ();
+
+  AudioRangePatch restored;
+  restored.deserialize_from_json_string (json.c_str ());
+  EXPECT_EQ (restored.get_start_frame (), patch.get_start_frame ());
+  EXPECT_EQ (restored.get_num_frames (), patch.get_num_frames ());
+  EXPECT_EQ (restored.get_compressed_size (), patch.get_compressed_size ());
+
+  const auto frames = restored.get_frames (true);
+  for (int i = 0; i < frames.getNumSamples (); ++i)
+    {
+      EXPECT_EQ (frames.getSample (0, i), after.getSample (0, 100 + i));
+    }
+}
+
+} // namespace zrythm::dsp
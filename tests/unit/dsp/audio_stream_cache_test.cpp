@@ -0,0 +1,222 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "dsp/audio_stream_cache.h"
+#include "utils/exceptions.h"
+#include "utils/gtest_wrapper.h"
+
+using namespace std::chrono_literals;
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+constexpr auto PAGE_SIZE = AudioStreamCache::PAGE_SIZE;
+
+/** Sample value of the test source at @p frame of @p ch. */
+float
+source_sample (int ch, unsigned_frame_t frame)
+{
+  return static_cast<float> (ch) + static_cast<float> (frame % 1000) / 1000.f;
+}
+
+AudioStreamCache::ReadFunc
+make_read_func (std::atomic<int> * num_reads = nullptr)
+{
+  return [num_reads] (
+           utils::audio::AudioBuffer &dest, unsigned_frame_t start_frame,
+           unsigned_frame_t num_frames) {
+    for (int ch = 0; ch < dest.getNumChannels (); ch++)
+      {
+        for (unsigned_frame_t i = 0; i < num_frames; i++)
+          {
+            dest.setSample (
+              ch, static_cast<int> (i), source_sample (ch, start_frame + i));
+          }
+      }
+    if (num_reads != nullptr)
+      {
+        (*num_reads)++;
+      }
+  };
+}
+
+struct StereoBuffer
+{
+  explicit StereoBuffer (size_t size) : l (size, -1.f), r (size, -1.f) { }
+
+  float * const * get () { return ptrs.data (); }
+
+  std::vector<float>     l;
+  std::vector<float>     r;
+  std::array<float *, 2> ptrs{ l.data (), r.data () };
+};
+
+} // namespace
+
+TEST (AudioStreamCacheTest, MissingFramesAreSilentUntilPrefetched)
+{
+  AudioStreamCache cache (2, PAGE_SIZE * 10, make_read_func ());
+  StereoBuffer     buf (256);
+
+  const unsigned_frame_t start = PAGE_SIZE * 3 + 100;
+  EXPECT_FALSE (cache.read (start, buf.get (), 2, 256));
+  EXPECT_EQ (cache.get_num_underruns (), 1);
+  for (size_t i = 0; i < 256; i++)
+    {
+      EXPECT_FLOAT_EQ (buf.l[i], 0.f);
+      EXPECT_FLOAT_EQ (buf.r[i], 0.f);
+    }
+
+  // the failed read is remembered as a position to prefetch
+  EXPECT_TRUE (cache.prefetch ());
+  EXPECT_TRUE (cache.read (start, buf.get (), 2, 256));
+  for (size_t i = 0; i < 256; i++)
+    {
+      EXPECT_FLOAT_EQ (buf.l[i], source_sample (0, start + i));
+      EXPECT_FLOAT_EQ (buf.r[i], source_sample (1, start + i));
+    }
+
+  // nothing new to load
+  EXPECT_FALSE (cache.prefetch ());
+}
+
+TEST (AudioStreamCacheTest, ReadsAheadAndAcrossPages)
+{
+  std::atomic<int> num_reads = 0;
+  AudioStreamCache cache (2, PAGE_SIZE * 20, make_read_func (&num_reads));
+  cache.add_hint (0);
+  cache.prefetch ();
+  EXPECT_EQ (num_reads, 1 + AudioStreamCache::READ_AHEAD_PAGES);
+
+  // read spanning pages 1 and 2
+  const unsigned_frame_t start = PAGE_SIZE * 2 - 10;
+  StereoBuffer           buf (20);
+  EXPECT_TRUE (cache.read (start, buf.get (), 2, 20));
+  for (size_t i = 0; i < 20; i++)
+    {
+      EXPECT_FLOAT_EQ (buf.l[i], source_sample (0, start + i));
+      EXPECT_FLOAT_EQ (buf.r[i], source_sample (1, start + i));
+    }
+
+  // beyond the read-ahead
+  EXPECT_FALSE (cache.read (
+    PAGE_SIZE * (AudioStreamCache::READ_AHEAD_PAGES + 1), buf.get (), 2, 20));
+}
+
+TEST (AudioStreamCacheTest, MonoToStereo)
+{
+  AudioStreamCache cache (1, PAGE_SIZE, make_read_func ());
+  cache.add_hint (0);
+  cache.prefetch ();
+
+  StereoBuffer buf (64);
+  EXPECT_TRUE (cache.read (10, buf.get (), 2, 64));
+  for (size_t i = 0; i < 64; i++)
+    {
+      EXPECT_FLOAT_EQ (buf.l[i], source_sample (0, 10 + i));
+      EXPECT_FLOAT_EQ (buf.r[i], source_sample (0, 10 + i));
+    }
+}
+
+TEST (AudioStreamCacheTest, FramesPastEndAreSilent)
+{
+  const unsigned_frame_t num_frames = PAGE_SIZE + 50;
+  AudioStreamCache       cache (2, num_frames, make_read_func ());
+  cache.add_hint (PAGE_SIZE);
+  cache.prefetch ();
+
+  StereoBuffer buf (100);
+  EXPECT_TRUE (cache.read (PAGE_SIZE, buf.get (), 2, 100));
+  for (size_t i = 0; i < 100; i++)
+    {
+      EXPECT_FLOAT_EQ (buf.l[i], i < 50 ? source_sample (0, PAGE_SIZE + i) : 0.f);
+    }
+  EXPECT_EQ (cache.get_num_underruns (), 0);
+}
+
+TEST (AudioStreamCacheTest, EvictsPagesNoLongerNeeded)
+{
+  // room for the read-ahead of a single position
+  constexpr size_t num_pages = AudioStreamCache::READ_AHEAD_PAGES + 1;
+  AudioStreamCache cache (
+    2, PAGE_SIZE * 100, make_read_func (), num_pages);
+  StereoBuffer buf (16);
+
+  // move through the source, as during playback
+  for (unsigned_frame_t page = 0; page < 100; page += 10)
+    {
+      for (size_t i = 0; i < AudioStreamCache::NUM_HINTS; i++)
+        {
+          cache.add_hint (page * PAGE_SIZE);
+        }
+      cache.prefetch ();
+      EXPECT_TRUE (cache.read (page * PAGE_SIZE, buf.get (), 2, 16));
+      EXPECT_FLOAT_EQ (buf.l[0], source_sample (0, page * PAGE_SIZE));
+    }
+}
+
+TEST (AudioStreamCacheTest, FailedReadsAreNotCached)
+{
+  AudioStreamCache cache (
+    2, PAGE_SIZE * 4,
+    [] (utils::audio::AudioBuffer &, unsigned_frame_t, unsigned_frame_t) {
+      throw ZrythmException ("read error");
+    });
+  cache.add_hint (0);
+  EXPECT_FALSE (cache.prefetch ());
+
+  StereoBuffer buf (16);
+  EXPECT_FALSE (cache.read (0, buf.get (), 2, 16));
+}
+
+TEST (AudioStreamCacheTest, PrefetcherThread)
+{
+  auto cache =
+    std::make_shared<AudioStreamCache> (2, PAGE_SIZE * 100, make_read_func ());
+  AudioStreamPrefetcher prefetcher;
+  prefetcher.add_cache (cache);
+
+  constexpr size_t block_size = 512;
+  StereoBuffer     buf (block_size);
+  std::atomic_bool stop = false;
+
+  // simulate playback from the middle of the source while the prefetcher
+  // thread keeps evicting and loading pages
+  std::atomic<int> num_mismatches = 0;
+  std::thread      reader ([&] () {
+    unsigned_frame_t pos = PAGE_SIZE * 50;
+    while (!stop && pos + block_size < PAGE_SIZE * 100)
+      {
+        if (cache->read (pos, buf.get (), 2, block_size))
+          {
+            for (size_t i = 0; i < block_size; i++)
+              {
+                if (buf.l[i] != source_sample (0, pos + i))
+                  num_mismatches++;
+              }
+          }
+        pos += block_size;
+        std::this_thread::sleep_for (1ms);
+      }
+  });
+  std::this_thread::sleep_for (200ms);
+  stop = true;
+  reader.join ();
+
+  EXPECT_EQ (num_mismatches, 0);
+
+  // the first block is read before the prefetcher could load it, but then
+  // the prefetcher keeps ahead
+  EXPECT_GE (cache->get_num_underruns (), 1);
+  EXPECT_LT (cache->get_num_underruns (), 50);
+}
+
+} // namespace zrythm::dsp
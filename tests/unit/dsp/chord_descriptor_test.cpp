@@ -58,6 +58,70 @@ TEST (ChordDescriptorTest, BassNotes)
   EXPECT_EQ (with_bass.to_string (), "CMaj/G");
 }
 
+TEST (ChordDescriptorTest, PitchClassMasks)
+{
+  ChordDescriptor with_bass (
+    MusicalNote::D, true, MusicalNote::B, ChordType::Minor,
+    ChordAccent::Seventh, -1);
+  EXPECT_EQ (
+    with_bass.get_notes_pitch_class_mask (),
+    pitch_class_mask_from_note (MusicalNote::D)
+      | pitch_class_mask_from_note (MusicalNote::F)
+      | pitch_class_mask_from_note (MusicalNote::A)
+      | pitch_class_mask_from_note (MusicalNote::C)
+      | pitch_class_mask_from_note (MusicalNote::B));
+  EXPECT_EQ (
+    with_bass.get_bass_pitch_class_mask (),
+    pitch_class_mask_from_note (MusicalNote::B));
+  for (int i = 0; i < 12; i++)
+    {
+      const auto note = static_cast<MusicalNote> (i);
+      EXPECT_EQ (
+        pitch_class_mask_contains (with_bass.get_pitch_class_mask (), note),
+        with_bass.is_key_in_chord (note));
+    }
+
+  /* the mask follows changes */
+  with_bass.root_note_ = MusicalNote::E;
+  with_bass.update_notes ();
+  EXPECT_TRUE (with_bass.is_key_in_chord (MusicalNote::G));
+  EXPECT_FALSE (with_bass.is_key_in_chord (MusicalNote::F));
+
+  ChordDescriptor none;
+  EXPECT_EQ (none.get_notes_pitch_class_mask (), 0);
+  EXPECT_TRUE (none.is_key_in_chord (MusicalNote::C));
+  EXPECT_FALSE (none.is_key_in_chord (MusicalNote::D));
+}
+
+TEST (ChordDescriptorTest, KeyMasks)
+{
+  constexpr auto c_e = static_cast<PitchClassMask> (
+    pitch_class_mask_from_note (MusicalNote::C)
+    | pitch_class_mask_from_note (MusicalNote::E));
+  static_assert (
+    pitch_class_mask_transpose (c_e, 10)
+    == (pitch_class_mask_from_note (MusicalNote::ASharp)
+        | pitch_class_mask_from_note (MusicalNote::D)));
+  static_assert (pitch_class_mask_transpose (c_e, -12) == c_e);
+
+  const auto all_keys = pitch_class_mask_to_key_mask (c_e);
+  EXPECT_EQ (all_keys.count (), 22);
+  EXPECT_TRUE (all_keys.test (0));
+  EXPECT_TRUE (all_keys.test (64));
+  EXPECT_TRUE (all_keys.test (120));
+  EXPECT_FALSE (all_keys.test (62));
+  EXPECT_FALSE (all_keys.test (126));
+
+  const auto visible_keys = pitch_class_mask_to_key_mask (c_e, 60, 12);
+  EXPECT_EQ (visible_keys.count (), 2);
+  EXPECT_TRUE (visible_keys.test (60));
+  EXPECT_TRUE (visible_keys.test (64));
+
+  EXPECT_TRUE (pitch_class_mask_to_key_mask (c_e, 125, 10).none ());
+  EXPECT_EQ (
+    pitch_class_mask_to_key_mask (PITCH_CLASS_MASK_ALL, 120, 100).count (), 8);
+}
+
 TEST (ChordDescriptorTest, MaxInversions)
 {
   ChordDescriptor triad (
@@ -109,4 +173,6 @@ TEST (ChordDescriptorTest, Serialization)
   EXPECT_EQ (chord1.accent_, chord2.accent_);
   EXPECT_EQ (chord1.notes_, chord2.notes_);
   EXPECT_EQ (chord1.inversion_, chord2.inversion_);
+  EXPECT_EQ (
+    chord1.get_notes_pitch_class_mask (), chord2.get_notes_pitch_class_mask ());
 }
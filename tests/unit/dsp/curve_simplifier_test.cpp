@@ -0,0 +1,126 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cmath>
+#include <utility>
+#include <vector>
+
+#include "dsp/curve_simplifier.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+using Point = std::pair<double, double>;
+
+/** Adds @p points and returns the points kept, like a caller would. */
+std::vector<Point>
+simplify (StreamingCurveSimplifier &simplifier, const std::vector<Point> &points)
+{
+  std::vector<Point> kept;
+  for (const auto &[x, y] : points)
+    {
+      if (
+        simplifier.add_point (x, y)
+        == StreamingCurveSimplifier::Result::ReplaceLastPoint)
+        {
+          kept.pop_back ();
+        }
+      kept.emplace_back (x, y);
+    }
+  return kept;
+}
+
+/** Y of the polyline through @p points at @p x. */
+double
+get_y_at (const std::vector<Point> &points, double x)
+{
+  for (size_t i = 1; i < points.size (); i++)
+    {
+      const auto &[x1, y1] = points[i - 1];
+      const auto &[x2, y2] = points[i];
+      if (x <= x2)
+        {
+          return y1 + (y2 - y1) * (x - x1) / (x2 - x1);
+        }
+    }
+  return points.back ().second;
+}
+
+} // namespace
+
+TEST (StreamingCurveSimplifierTest, StraightLineKeepsEnds)
+{
+  StreamingCurveSimplifier simplifier (0.001);
+  std::vector<Point>       points;
+  for (int i = 0; i <= 100; i++)
+    {
+      points.emplace_back (i * 10.0, 0.2 + i * 0.005);
+    }
+  const auto kept = simplify (simplifier, points);
+  ASSERT_EQ (kept.size (), 2);
+  EXPECT_EQ (kept.front (), points.front ());
+  EXPECT_EQ (kept.back (), points.back ());
+}
+
+TEST (StreamingCurveSimplifierTest, CornersAreKept)
+{
+  StreamingCurveSimplifier simplifier (0.01);
+  const auto               kept = simplify (
+    simplifier, { { 0, 0 }, { 1, 0 }, { 2, 0 }, { 3, 1 }, { 4, 1 }, { 5, 1 } });
+  const std::vector<Point> expected{ { 0, 0 }, { 2, 0 }, { 3, 1 }, { 5, 1 } };
+  EXPECT_EQ (kept, expected);
+}
+
+TEST (StreamingCurveSimplifierTest, ZeroToleranceKeepsAllPoints)
+{
+  StreamingCurveSimplifier simplifier;
+  const std::vector<Point> points{ { 0, 0 }, { 1, 0.5 }, { 2, 1 }, { 3, 1 } };
+  EXPECT_EQ (simplify (simplifier, points), points);
+}
+
+TEST (StreamingCurveSimplifierTest, StaysWithinTolerance)
+{
+  constexpr double         tolerance = 0.01;
+  StreamingCurveSimplifier simplifier (tolerance);
+  std::vector<Point>       points;
+  for (int i = 0; i < 5000; i++)
+    {
+      const double x = i * 12.5;
+      points.emplace_back (
+        x, 0.5 + 0.4 * std::sin (x * 0.001) + 0.003 * std::sin (x * 0.7));
+    }
+  const auto kept = simplify (simplifier, points);
+  EXPECT_LT (kept.size (), points.size () / 10);
+  for (const auto &[x, y] : points)
+    {
+      EXPECT_NEAR (get_y_at (kept, x), y, tolerance + 1e-9);
+    }
+}
+
+TEST (StreamingCurveSimplifierTest, ResetStartsNewCurve)
+{
+  StreamingCurveSimplifier simplifier (0.1);
+  simplifier.add_point (0, 0);
+  simplifier.add_point (1, 0);
+  simplifier.reset ();
+  EXPECT_TRUE (simplifier.empty ());
+  EXPECT_EQ (
+    simplifier.add_point (2, 0), StreamingCurveSimplifier::Result::AppendPoint);
+  EXPECT_EQ (
+    simplifier.add_point (3, 0), StreamingCurveSimplifier::Result::AppendPoint);
+  EXPECT_EQ (
+    simplifier.add_point (4, 0),
+    StreamingCurveSimplifier::Result::ReplaceLastPoint);
+
+  // going back in time starts a new curve too
+  EXPECT_EQ (
+    simplifier.add_point (1, 0), StreamingCurveSimplifier::Result::AppendPoint);
+  EXPECT_EQ (
+    simplifier.add_point (2, 0), StreamingCurveSimplifier::Result::AppendPoint);
+}
+
+} // namespace zrythm::dsp
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <array>
+#include <vector>
+
 #include "dsp/curve.h"
 #include "utils/gtest_wrapper.h"
 
@@ -108,6 +112,85 @@ TEST (CurveTest, FadeOperations)
   EXPECT_NEAR (opts.get_normalized_y_for_fade (1.0, false), 0.0, epsilon);
 }
 
+TEST (CurveTest, BatchMatchesSingleValues)
+{
+  constexpr std::array algos = {
+    CurveOptions::Algorithm::Exponent, CurveOptions::Algorithm::SuperEllipse,
+    CurveOptions::Algorithm::Vital, CurveOptions::Algorithm::Pulse,
+    CurveOptions::Algorithm::Logarithmic,
+  };
+  constexpr std::array curvinesses = { -1.0, -0.7, -0.3, 0.0, 0.3, 0.7, 1.0 };
+
+  for (const auto algo : algos)
+    {
+      for (const double curviness : curvinesses)
+        {
+          const CurveOptions opts (curviness, algo);
+          for (const bool start_higher : { false, true })
+            {
+              // sparse enough to be evaluated exactly
+              constexpr size_t   size = 101;
+              std::vector<float> ys (size);
+              opts.get_normalized_ys (
+                ys.data (), 0.0, 1.0 / (size - 1), size, start_higher);
+              for (size_t i = 0; i < size; i++)
+                {
+                  const double x = std::min ((double) i / (size - 1), 1.0);
+                  EXPECT_NEAR (
+                    ys[i], opts.get_normalized_y (x, start_higher), 1e-6)
+                    << algo << " " << curviness << " " << x;
+                }
+            }
+        }
+    }
+}
+
+TEST (CurveTest, BatchInterpolatesDenseValues)
+{
+  constexpr std::array algos = {
+    CurveOptions::Algorithm::Exponent, CurveOptions::Algorithm::SuperEllipse,
+    CurveOptions::Algorithm::Vital, CurveOptions::Algorithm::Logarithmic,
+  };
+  constexpr std::array curvinesses = { -1.0, -0.5, 0.5, 1.0 };
+
+  // e.g., a 1 second fade at 48 kHz, processed in blocks of 256 frames
+  constexpr size_t   total_size = 48000;
+  constexpr size_t   block_size = 256;
+  const double       x_step = 1.0 / total_size;
+  std::vector<float> ys (block_size);
+  for (const auto algo : algos)
+    {
+      for (const double curviness : curvinesses)
+        {
+          const CurveOptions opts (curviness, algo);
+          double             max_error = 0.0;
+          for (size_t offset = 0; offset < total_size; offset += block_size)
+            {
+              const size_t size = std::min (block_size, total_size - offset);
+              opts.get_normalized_ys_for_fade (
+                ys.data (), (double) offset * x_step, x_step, size, true);
+              for (size_t i = 0; i < size; i++)
+                {
+                  const double y = opts.get_normalized_y_for_fade (
+                    (double) (offset + i) * x_step, true);
+                  max_error = std::max (max_error, std::abs (ys[i] - y));
+                }
+            }
+          EXPECT_LT (max_error, 1e-4) << algo << " " << curviness;
+        }
+    }
+}
+
+TEST (CurveTest, BatchClampsX)
+{
+  CurveOptions       opts (0.5, CurveOptions::Algorithm::Exponent);
+  std::array<float, 3> ys{};
+  opts.get_normalized_ys (ys.data (), -1.0, 1.0, ys.size (), false);
+  EXPECT_FLOAT_EQ (ys[0], 0.f);
+  EXPECT_FLOAT_EQ (ys[1], 0.f);
+  EXPECT_FLOAT_EQ (ys[2], 1.f);
+}
+
 TEST (CurveTest, Serialization)
 {
   // Create curve options with specific values
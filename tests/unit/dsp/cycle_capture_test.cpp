@@ -0,0 +1,158 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <filesystem>
+#include <vector>
+
+#include "dsp/cycle_capture.h"
+#include "utils/exceptions.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+constexpr sample_rate_t SAMPLERATE = 48000;
+constexpr nframes_t     MAX_BLOCK_LENGTH = 64;
+constexpr size_t        NUM_CHANNELS = 2;
+
+std::filesystem::path
+get_capture_path ()
+{
+  return std::filesystem::temp_directory_path () / "cycle_capture_test.zst";
+}
+
+/** Records a cycle with one MIDI event and a ramp on each channel. */
+void
+record_cycle (CycleCapture &capture, nframes_t nframes, int64_t playhead)
+{
+  capture.begin_cycle ({
+    .playhead_frames_ = playhead,
+    .graph_generation_ = 3,
+    .bpm_ = 140.f,
+    .nframes_ = nframes,
+    .flags_ = CycleCapture::Rolling | CycleCapture::Looping,
+  });
+  capture.add_midi_event ({
+    .time_ = 5,
+    .input_ = 1,
+    .size_ = 3,
+    .data_ = { 0x90, 60, 100 },
+  });
+  for (size_t ch = 0; ch < NUM_CHANNELS; ++ch)
+    {
+      std::vector<float> frames (nframes);
+      for (nframes_t i = 0; i < nframes; ++i)
+        {
+          frames[i] = static_cast<float> (ch) + static_cast<float> (i) / 100.f;
+        }
+      capture.set_audio_input (ch, frames);
+    }
+  capture.end_cycle ();
+}
+
+} // namespace
+
+TEST (CycleCaptureTest, RoundTrip)
+{
+  const auto path = get_capture_path ();
+  std::filesystem::remove (path);
+  {
+    CycleCapture capture (path, SAMPLERATE, MAX_BLOCK_LENGTH, NUM_CHANNELS);
+    capture.queue_control_change ({ .port_id_ = { 1, 2, 3 }, .value_ = 0.5f });
+    record_cycle (capture, MAX_BLOCK_LENGTH, 0);
+    record_cycle (capture, MAX_BLOCK_LENGTH / 2, MAX_BLOCK_LENGTH);
+    capture.finish ();
+    EXPECT_EQ (capture.get_num_captured_cycles (), 2);
+    EXPECT_EQ (capture.get_num_dropped_cycles (), 0);
+  }
+
+  const CycleCaptureReader reader (path);
+  EXPECT_EQ (reader.get_file_header ().sample_rate_, SAMPLERATE);
+  EXPECT_EQ (reader.get_file_header ().max_block_length_, MAX_BLOCK_LENGTH);
+  EXPECT_EQ (reader.get_file_header ().num_audio_channels_, NUM_CHANNELS);
+  EXPECT_EQ (reader.get_num_missing_cycles (), 0);
+
+  const auto &cycles = reader.get_cycles ();
+  ASSERT_EQ (cycles.size (), 2);
+
+  const auto &first = cycles[0];
+  EXPECT_EQ (first.header_.index_, 0);
+  EXPECT_EQ (first.header_.playhead_frames_, 0);
+  EXPECT_EQ (first.header_.graph_generation_, 3);
+  EXPECT_FLOAT_EQ (first.header_.bpm_, 140.f);
+  EXPECT_EQ (first.header_.nframes_, MAX_BLOCK_LENGTH);
+  EXPECT_EQ (
+    first.header_.flags_, CycleCapture::Rolling | CycleCapture::Looping);
+
+  /* control changes are recorded with the next cycle */
+  ASSERT_EQ (first.control_changes_.size (), 1);
+  EXPECT_EQ (first.control_changes_[0].port_id_[2], 3);
+  EXPECT_FLOAT_EQ (first.control_changes_[0].value_, 0.5f);
+  EXPECT_TRUE (cycles[1].control_changes_.empty ());
+
+  ASSERT_EQ (first.midi_events_.size (), 1);
+  EXPECT_EQ (first.midi_events_[0].time_, 5);
+  EXPECT_EQ (first.midi_events_[0].input_, 1);
+  EXPECT_EQ (first.midi_events_[0].size_, 3);
+  EXPECT_EQ (first.midi_events_[0].data_[1], 60);
+
+  const auto &second = cycles[1];
+  EXPECT_EQ (second.header_.index_, 1);
+  EXPECT_EQ (second.header_.playhead_frames_, MAX_BLOCK_LENGTH);
+  EXPECT_EQ (second.header_.nframes_, MAX_BLOCK_LENGTH / 2);
+  for (size_t ch = 0; ch < NUM_CHANNELS; ++ch)
+    {
+      const auto frames = second.get_audio_channel (ch);
+      ASSERT_EQ (frames.size (), MAX_BLOCK_LENGTH / 2);
+      EXPECT_FLOAT_EQ (frames[0], static_cast<float> (ch));
+      EXPECT_FLOAT_EQ (frames[10], static_cast<float> (ch) + 0.1f);
+    }
+
+  std::filesystem::remove (path);
+}
+
+TEST (CycleCaptureTest, DropsCyclesLongerThanMaxBlockLength)
+{
+  const auto path = get_capture_path ();
+  std::filesystem::remove (path);
+  {
+    CycleCapture capture (path, SAMPLERATE, MAX_BLOCK_LENGTH, NUM_CHANNELS);
+    record_cycle (capture, MAX_BLOCK_LENGTH, 0);
+    record_cycle (capture, MAX_BLOCK_LENGTH * 2, 0);
+    record_cycle (capture, MAX_BLOCK_LENGTH, 0);
+    capture.finish ();
+    EXPECT_EQ (capture.get_num_captured_cycles (), 2);
+    EXPECT_EQ (capture.get_num_dropped_cycles (), 1);
+  }
+
+  const CycleCaptureReader reader (path);
+  ASSERT_EQ (reader.get_cycles ().size (), 2);
+  EXPECT_EQ (reader.get_cycles ()[1].header_.index_, 2);
+  EXPECT_EQ (reader.get_num_missing_cycles (), 1);
+
+  std::filesystem::remove (path);
+}
+
+TEST (CycleCaptureTest, RejectsInvalidData)
+{
+  EXPECT_THROW (
+    CycleCaptureReader::from_data ("not a cycle capture at all"),
+    ZrythmException);
+
+  /* truncated cycle */
+  CycleCapture::FileHeader header;
+  std::string              data (
+    reinterpret_cast<const char *> (&header), sizeof (header));
+  data += "xyz";
+  EXPECT_THROW (CycleCaptureReader::from_data (data), ZrythmException);
+
+  /* no cycles */
+  data.resize (sizeof (header));
+  const auto reader = CycleCaptureReader::from_data (data);
+  EXPECT_TRUE (reader.get_cycles ().empty ());
+}
+
+} // namespace zrythm::dsp
@@ -1,3 +1,7 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 #include "dsp/ditherer.h"
 #include "utils/gtest_wrapper.h"
 
@@ -98,3 +102,54 @@ TEST (DithererTest, DifferentBitDepths)
   EXPECT_GT (diff8, diff16);
   EXPECT_GT (diff16, diff24);
 }
+
+TEST (DithererTest, BlockSizeDoesNotAffectOutput)
+{
+  constexpr int      num_samples = 1000;
+  std::vector<float> whole (num_samples);
+  for (int i = 0; i < num_samples; i++)
+    {
+      whole[i] = 0.5f * std::sin ((float) i * 0.01f);
+    }
+  auto chunked = whole;
+
+  zrythm::dsp::Ditherer ditherer1;
+  ditherer1.reset (16);
+  ditherer1.process (whole.data (), num_samples);
+
+  zrythm::dsp::Ditherer ditherer2;
+  ditherer2.reset (16);
+  for (int offset = 0; offset < num_samples;)
+    {
+      const int num = std::min (37, num_samples - offset);
+      ditherer2.process (&chunked[offset], num);
+      offset += num;
+    }
+
+  for (int i = 0; i < num_samples; i++)
+    {
+      EXPECT_FLOAT_EQ (whole[i], chunked[i]);
+    }
+}
+
+TEST (DithererTest, NoiseAmplitude)
+{
+  zrythm::dsp::Ditherer ditherer;
+  ditherer.reset (16);
+
+  constexpr int      num_samples = 10000;
+  std::vector<float> samples (num_samples, 0.25f);
+  ditherer.process (samples.data (), num_samples);
+
+  // offset + TPDF noise + error feedback stay within a few LSBs
+  constexpr float lsb = 1.f / 32768.f;
+  double          sum = 0.0;
+  for (float sample : samples)
+    {
+      EXPECT_NEAR (sample, 0.25f, 3.f * lsb);
+      sum += sample - 0.25f;
+    }
+
+  // the mean is the offset (the noise and feedback average out)
+  EXPECT_NEAR (sum / num_samples, 0.25f * lsb, 0.05f * lsb);
+}
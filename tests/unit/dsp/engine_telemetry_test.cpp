@@ -0,0 +1,127 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "dsp/engine_telemetry.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+TEST (EngineTelemetryTest, EmptySnapshot)
+{
+  EngineTelemetry telemetry;
+  const auto      snapshot = telemetry.get_snapshot ();
+  EXPECT_EQ (snapshot.num_cycles_, 0);
+  EXPECT_EQ (snapshot.num_xruns_, 0);
+  EXPECT_EQ (snapshot.mean_duration_us_, 0);
+  EXPECT_DOUBLE_EQ (snapshot.mean_dsp_load_, 0.0);
+  EXPECT_TRUE (snapshot.xrun_timestamps_us_.empty ());
+}
+
+TEST (EngineTelemetryTest, HistogramBins)
+{
+  EXPECT_EQ (EngineTelemetry::get_bin_for_duration (0), 0);
+  EXPECT_EQ (EngineTelemetry::get_bin_for_duration (31), 0);
+  EXPECT_EQ (EngineTelemetry::get_bin_for_duration (32), 1);
+  EXPECT_EQ (EngineTelemetry::get_bin_for_duration (63), 1);
+  EXPECT_EQ (EngineTelemetry::get_bin_for_duration (64), 2);
+  EXPECT_EQ (
+    EngineTelemetry::get_bin_for_duration (1'000'000'000),
+    EngineTelemetry::NUM_HISTOGRAM_BINS - 1);
+
+  // ranges are contiguous and match get_bin_for_duration()
+  for (size_t bin = 0; bin < EngineTelemetry::NUM_HISTOGRAM_BINS; ++bin)
+    {
+      const auto [lower, upper] = EngineTelemetry::get_bin_range_us (bin);
+      EXPECT_EQ (EngineTelemetry::get_bin_for_duration (lower), bin);
+      if (bin < EngineTelemetry::NUM_HISTOGRAM_BINS - 1)
+        {
+          EXPECT_EQ (EngineTelemetry::get_bin_for_duration (upper - 1), bin);
+          EXPECT_EQ (EngineTelemetry::get_bin_range_us (bin + 1).first, upper);
+        }
+      else
+        {
+          EXPECT_EQ (upper, 0);
+        }
+    }
+}
+
+TEST (EngineTelemetryTest, DurationsAndLoad)
+{
+  EngineTelemetry telemetry;
+  telemetry.record_cycle_end (100, 1000);
+  telemetry.record_cycle_end (300, 1000);
+  telemetry.record_cycle_end (500, 2000);
+
+  const auto snapshot = telemetry.get_snapshot ();
+  EXPECT_EQ (snapshot.num_cycles_, 3);
+  EXPECT_EQ (snapshot.last_duration_us_, 500);
+  EXPECT_EQ (snapshot.mean_duration_us_, 300);
+  EXPECT_EQ (snapshot.max_duration_us_, 500);
+  EXPECT_DOUBLE_EQ (snapshot.last_dsp_load_, 25.0);
+  EXPECT_DOUBLE_EQ (snapshot.mean_dsp_load_, 900.0 * 100.0 / 4000.0);
+  EXPECT_DOUBLE_EQ (snapshot.max_dsp_load_, 30.0);
+
+  uint64_t total = 0;
+  for (const auto count : snapshot.histogram_)
+    total += count;
+  EXPECT_EQ (total, 3);
+  EXPECT_EQ (
+    snapshot.histogram_[EngineTelemetry::get_bin_for_duration (100)], 1);
+  // 300 and 500 are in [256, 512)
+  EXPECT_EQ (
+    snapshot.histogram_[EngineTelemetry::get_bin_for_duration (300)], 2);
+}
+
+TEST (EngineTelemetryTest, Jitter)
+{
+  EngineTelemetry telemetry;
+  telemetry.record_cycle_start (10'000, 1000);
+  telemetry.record_cycle_start (11'000, 1000); // on time
+  telemetry.record_cycle_start (12'200, 1000); // 200 late
+  telemetry.record_cycle_start (13'100, 1000); // 100 early
+
+  const auto snapshot = telemetry.get_snapshot ();
+  EXPECT_DOUBLE_EQ (snapshot.mean_jitter_us_, 100.0);
+  EXPECT_EQ (snapshot.max_jitter_us_, 200);
+}
+
+TEST (EngineTelemetryTest, XrunTimestampsKeepLatest)
+{
+  EngineTelemetry telemetry;
+  const auto num_xruns = EngineTelemetry::MAX_XRUN_TIMESTAMPS + 5;
+  for (size_t i = 0; i < num_xruns; ++i)
+    {
+      telemetry.record_xrun (static_cast<int64_t> (i) * 10);
+    }
+
+  const auto snapshot = telemetry.get_snapshot ();
+  EXPECT_EQ (snapshot.num_xruns_, num_xruns);
+  ASSERT_EQ (
+    snapshot.xrun_timestamps_us_.size (), EngineTelemetry::MAX_XRUN_TIMESTAMPS);
+  EXPECT_EQ (snapshot.xrun_timestamps_us_.front (), 50);
+  EXPECT_EQ (
+    snapshot.xrun_timestamps_us_.back (),
+    static_cast<int64_t> (num_xruns - 1) * 10);
+}
+
+TEST (EngineTelemetryTest, Reset)
+{
+  EngineTelemetry telemetry;
+  telemetry.record_cycle_start (1000, 1000);
+  telemetry.record_cycle_end (100, 1000);
+  telemetry.record_xrun (5);
+  telemetry.reset ();
+
+  auto snapshot = telemetry.get_snapshot ();
+  EXPECT_EQ (snapshot.num_cycles_, 0);
+  EXPECT_EQ (snapshot.num_xruns_, 0);
+  EXPECT_EQ (snapshot.max_duration_us_, 0);
+
+  // the first callback after a reset has no previous callback to compare to
+  telemetry.record_cycle_start (50'000, 1000);
+  snapshot = telemetry.get_snapshot ();
+  EXPECT_EQ (snapshot.max_jitter_us_, 0);
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,98 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "dsp/file_preview_stream.h"
+#include "utils/audio_file.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+constexpr size_t BLOCK_LENGTH = 256;
+
+/** Reads the whole stream, waiting for frames to be decoded. */
+std::pair<std::vector<float>, std::vector<float>>
+read_all (FilePreviewStream &stream)
+{
+  std::vector<float> l;
+  std::vector<float> r;
+  while (!stream.is_finished ())
+    {
+      const auto size = l.size ();
+      l.resize (size + BLOCK_LENGTH);
+      r.resize (size + BLOCK_LENGTH);
+      const auto read = stream.read (&l[size], &r[size], BLOCK_LENGTH, 1.f);
+      l.resize (size + read);
+      r.resize (size + read);
+      if (read == 0)
+        std::this_thread::sleep_for (std::chrono::milliseconds (1));
+    }
+  return { l, r };
+}
+
+} // namespace
+
+TEST (FilePreviewStreamTest, StreamsFileAtSameRate)
+{
+  utils::audio::AudioFile   file (TEST_WAV_FILE_PATH);
+  const auto                metadata = file.read_metadata ();
+  utils::audio::AudioBuffer expected;
+  file.read_full (expected, std::nullopt);
+
+  /* small prefetch buffer so that the decoder has to wait for the reader */
+  FilePreviewStream stream (TEST_WAV_FILE_PATH, metadata.samplerate, 4096);
+  const auto [l, r] = read_all (stream);
+  ASSERT_EQ (l.size (), static_cast<size_t> (metadata.num_frames));
+  for (size_t i = 0; i < l.size (); i += 97)
+    {
+      EXPECT_FLOAT_EQ (l[i], expected.getSample (0, static_cast<int> (i)));
+      EXPECT_FLOAT_EQ (
+        r[i],
+        expected.getSample (
+          expected.getNumChannels () > 1 ? 1 : 0, static_cast<int> (i)));
+    }
+}
+
+TEST (FilePreviewStreamTest, ResamplesToEngineRate)
+{
+  utils::audio::AudioFile file (TEST_WAV_FILE_PATH);
+  const auto              metadata = file.read_metadata ();
+
+  FilePreviewStream stream (TEST_WAV_FILE_PATH, metadata.samplerate * 2);
+  const auto [l, r] = read_all (stream);
+  const auto expected_frames = static_cast<double> (metadata.num_frames) * 2;
+  EXPECT_NEAR (static_cast<double> (l.size ()), expected_frames, 8.0);
+  EXPECT_EQ (l.size (), r.size ());
+}
+
+TEST (FilePreviewStreamTest, CancelsQuickly)
+{
+  utils::audio::AudioFile file (TEST_WAV_FILE_PATH);
+  const auto              metadata = file.read_metadata ();
+
+  /* nothing is read, so the decoder blocks on the full prefetch buffer */
+  const auto start = std::chrono::steady_clock::now ();
+  {
+    FilePreviewStream stream (TEST_WAV_FILE_PATH, metadata.samplerate, 1024);
+    std::this_thread::sleep_for (std::chrono::milliseconds (20));
+    EXPECT_FALSE (stream.is_finished ());
+  }
+  EXPECT_LT (
+    std::chrono::steady_clock::now () - start, std::chrono::milliseconds (500));
+}
+
+TEST (FilePreviewStreamTest, MissingFilePlaysSilence)
+{
+  FilePreviewStream stream ("/nonexistent/file.wav", 48000);
+  const auto [l, r] = read_all (stream);
+  EXPECT_TRUE (l.empty ());
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,62 @@
+#include "dsp/graph_node_stats.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+TEST (GraphNodeStatsTest, Empty)
+{
+  GraphNodeStats stats;
+  const auto     snapshot = stats.get_snapshot ();
+  EXPECT_EQ (snapshot.num_samples_, 0);
+  EXPECT_EQ (snapshot.last_ns_, 0);
+  EXPECT_EQ (snapshot.mean_ns_, 0);
+  EXPECT_EQ (snapshot.p99_ns_, 0);
+  EXPECT_EQ (snapshot.max_ns_, 0);
+}
+
+TEST (GraphNodeStatsTest, Statistics)
+{
+  GraphNodeStats stats;
+  for (uint64_t i = 1; i <= 100; ++i)
+    {
+      stats.record (i * 10);
+    }
+
+  const auto snapshot = stats.get_snapshot ();
+  EXPECT_EQ (snapshot.num_samples_, 100);
+  EXPECT_EQ (snapshot.last_ns_, 1000);
+  EXPECT_EQ (snapshot.mean_ns_, 505);
+  EXPECT_EQ (snapshot.p99_ns_, 990);
+  EXPECT_EQ (snapshot.max_ns_, 1000);
+
+  stats.reset ();
+  EXPECT_EQ (stats.get_snapshot ().num_samples_, 0);
+}
+
+TEST (GraphNodeStatsTest, RollingWindow)
+{
+  GraphNodeStats stats;
+
+  /* an early outlier must eventually leave the window */
+  stats.record (1'000'000);
+  for (size_t i = 0; i < GraphNodeStats::WINDOW_SIZE; ++i)
+    {
+      stats.record (100);
+    }
+
+  const auto snapshot = stats.get_snapshot ();
+  EXPECT_EQ (snapshot.num_samples_, GraphNodeStats::WINDOW_SIZE);
+  EXPECT_EQ (snapshot.last_ns_, 100);
+  EXPECT_EQ (snapshot.mean_ns_, 100);
+  EXPECT_EQ (snapshot.max_ns_, 100);
+}
+
+TEST (GraphNodeStatsTest, ClampsLargeValues)
+{
+  GraphNodeStats stats;
+  stats.record (uint64_t{ UINT32_MAX } + 1000);
+  EXPECT_EQ (stats.get_snapshot ().max_ns_, UINT32_MAX);
+}
+
+} // namespace zrythm::dsp
@@ -292,4 +292,341 @@ TEST_F (GraphNodeTest, ProcessableSearch)
   EXPECT_EQ (not_found, nullptr);
 }
 
+TEST_F (GraphNodeTest, CriticalPathPriorities)
+{
+  GraphNodeCollection collection;
+
+  // root feeds a long chain (a1 -> a2 -> a3) and a single node (b)
+  auto root = std::make_unique<GraphNode> (0, *transport_, *processable_);
+  auto a1 = std::make_unique<GraphNode> (1, *transport_, *processable_);
+  auto a2 = std::make_unique<GraphNode> (2, *transport_, *processable_);
+  auto a3 = std::make_unique<GraphNode> (3, *transport_, *processable_);
+  auto b = std::make_unique<GraphNode> (4, *transport_, *processable_);
+
+  root->connect_to (*b);
+  root->connect_to (*a1);
+  a1->connect_to (*a2);
+  a2->connect_to (*a3);
+
+  auto * root_ptr = root.get ();
+  auto * a1_ptr = a1.get ();
+  auto * b_ptr = b.get ();
+  collection.graph_nodes_.push_back (std::move (root));
+  collection.graph_nodes_.push_back (std::move (a1));
+  collection.graph_nodes_.push_back (std::move (a2));
+  collection.graph_nodes_.push_back (std::move (a3));
+  collection.graph_nodes_.push_back (std::move (b));
+
+  collection.finalize_nodes ();
+
+  // without measurements the cost is the path length
+  EXPECT_DOUBLE_EQ (root_ptr->critical_path_cost_, 4.0);
+  EXPECT_DOUBLE_EQ (a1_ptr->critical_path_cost_, 3.0);
+  EXPECT_DOUBLE_EQ (b_ptr->critical_path_cost_, 1.0);
+  EXPECT_EQ (root_ptr->priority_, GraphNode::NUM_PRIORITY_LEVELS - 1);
+  EXPECT_LT (b_ptr->priority_, a1_ptr->priority_);
+
+  // the longer chain must be dispatched first
+  ASSERT_EQ (root_ptr->childnodes_.size (), 2);
+  EXPECT_EQ (&root_ptr->childnodes_.front ().get (), a1_ptr);
+
+  // an expensive node makes the short branch critical
+  for (auto &node : collection.graph_nodes_)
+    {
+      node->processing_cost_ns_ = 100.f;
+    }
+  b_ptr->processing_cost_ns_ = 10000.f;
+  collection.update_critical_path_priorities ();
+  EXPECT_EQ (&root_ptr->childnodes_.front ().get (), b_ptr);
+  EXPECT_GT (b_ptr->priority_, a1_ptr->priority_);
+}
+
+TEST_F (GraphNodeTest, ProcessingCostSamples)
+{
+  auto node = create_test_node ();
+  EXPECT_FLOAT_EQ (node.processing_cost_ns_, 0.f);
+  node.add_processing_cost_sample (1000.f);
+  EXPECT_FLOAT_EQ (node.processing_cost_ns_, 1000.f);
+  node.add_processing_cost_sample (2000.f);
+  EXPECT_GT (node.processing_cost_ns_, 1000.f);
+  EXPECT_LT (node.processing_cost_ns_, 2000.f);
+}
+
+
+TEST_F (GraphNodeTest, FuseLinearChains)
+{
+  GraphNodeCollection collection;
+
+  // root feeds a chain (a1 -> a2 -> a3) and a single node (b), which both
+  // feed sink
+  auto root = std::make_unique<GraphNode> (0, *transport_, *processable_);
+  auto a1 = std::make_unique<GraphNode> (1, *transport_, *processable_);
+  auto a2 = std::make_unique<GraphNode> (2, *transport_, *processable_);
+  auto a3 = std::make_unique<GraphNode> (3, *transport_, *processable_);
+  auto b = std::make_unique<GraphNode> (4, *transport_, *processable_);
+  auto sink = std::make_unique<GraphNode> (5, *transport_, *processable_);
+
+  root->connect_to (*a1);
+  root->connect_to (*b);
+  a1->connect_to (*a2);
+  a2->connect_to (*a3);
+  a3->connect_to (*sink);
+  b->connect_to (*sink);
+
+  auto * root_ptr = root.get ();
+  auto * a1_ptr = a1.get ();
+  auto * a2_ptr = a2.get ();
+  auto * a3_ptr = a3.get ();
+  auto * b_ptr = b.get ();
+  auto * sink_ptr = sink.get ();
+  collection.graph_nodes_.push_back (std::move (root));
+  collection.graph_nodes_.push_back (std::move (a1));
+  collection.graph_nodes_.push_back (std::move (a2));
+  collection.graph_nodes_.push_back (std::move (a3));
+  collection.graph_nodes_.push_back (std::move (b));
+  collection.graph_nodes_.push_back (std::move (sink));
+
+  collection.finalize_nodes ();
+  collection.fuse_linear_chains ();
+
+  // a2 and a3 are fused into a1, which now feeds sink directly
+  ASSERT_EQ (a1_ptr->fused_nodes_.size (), 2);
+  EXPECT_EQ (&a1_ptr->fused_nodes_[0].get (), a2_ptr);
+  EXPECT_EQ (&a1_ptr->fused_nodes_[1].get (), a3_ptr);
+  EXPECT_TRUE (a2_ptr->fused_);
+  EXPECT_TRUE (a3_ptr->fused_);
+  ASSERT_EQ (a1_ptr->childnodes_.size (), 1);
+  EXPECT_EQ (&a1_ptr->childnodes_.front ().get (), sink_ptr);
+
+  // nodes with several parents or children are left alone
+  EXPECT_FALSE (root_ptr->fused_);
+  EXPECT_FALSE (b_ptr->fused_);
+  EXPECT_FALSE (sink_ptr->fused_);
+  EXPECT_TRUE (b_ptr->fused_nodes_.empty ());
+  EXPECT_EQ (sink_ptr->init_refcount_, 2);
+
+  ASSERT_EQ (collection.trigger_nodes_.size (), 1);
+  EXPECT_EQ (&collection.trigger_nodes_.front ().get (), root_ptr);
+  ASSERT_EQ (collection.terminal_nodes_.size (), 1);
+  EXPECT_EQ (&collection.terminal_nodes_.front ().get (), sink_ptr);
+
+  // the fused chain counts as 3 nodes on the critical path
+  EXPECT_DOUBLE_EQ (root_ptr->critical_path_cost_, 5.0);
+  EXPECT_EQ (&root_ptr->childnodes_.front ().get (), a1_ptr);
+}
+
+TEST_F (GraphNodeTest, FusedNodesProcessing)
+{
+  GraphNodeCollection collection;
+
+  NiceMock<MockProcessable> processable1;
+  NiceMock<MockProcessable> processable2;
+  NiceMock<MockProcessable> special_processable;
+
+  auto node1 = std::make_unique<GraphNode> (1, *transport_, processable1);
+  auto node2 = std::make_unique<GraphNode> (2, *transport_, processable2);
+  auto special =
+    std::make_unique<GraphNode> (3, *transport_, special_processable);
+  node1->connect_to (*node2);
+  node2->connect_to (*special);
+
+  auto * node1_ptr = node1.get ();
+  auto * special_ptr = special.get ();
+  collection.graph_nodes_.push_back (std::move (node1));
+  collection.graph_nodes_.push_back (std::move (node2));
+  collection.graph_nodes_.push_back (std::move (special));
+  collection.add_special_node (*special_ptr);
+
+  collection.finalize_nodes ();
+  collection.fuse_linear_chains ();
+
+  // special nodes are never fused
+  ASSERT_EQ (node1_ptr->fused_nodes_.size (), 1);
+  EXPECT_FALSE (special_ptr->fused_);
+
+  // fused nodes are processed back to back, even if the head is bypassed
+  {
+    InSequence seq;
+    EXPECT_CALL (processable1, process_block (_)).Times (1);
+    EXPECT_CALL (processable2, process_block (_)).Times (2);
+  }
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  node1_ptr->process (time_info, 0);
+  node1_ptr->set_skip_processing (true);
+  node1_ptr->process (time_info, 0);
+}
+
+
+TEST_F (GraphNodeTest, IncrementalLatencies)
+{
+  std::array<NiceMock<MockProcessable>, 4> processables;
+  ON_CALL (processables[2], get_single_playback_latency ())
+    .WillByDefault (Return (64));
+  ON_CALL (processables[3], get_single_playback_latency ())
+    .WillByDefault (Return (128));
+
+  const auto make_collection =
+    [&] (std::initializer_list<std::pair<int, int>> edges) {
+      auto collection = std::make_unique<GraphNodeCollection> ();
+      for (auto &processable : processables)
+        {
+          collection->graph_nodes_.push_back (std::make_unique<GraphNode> (
+            collection->graph_nodes_.size (), *transport_, processable));
+        }
+      for (const auto &[src, dest] : edges)
+        {
+          collection->graph_nodes_[src]->connect_to (
+            *collection->graph_nodes_[dest]);
+        }
+      return collection;
+    };
+
+  // 0 -> 1 -> 2, 3 isolated
+  auto prev = make_collection ({ { 0, 1 }, { 1, 2 } });
+  EXPECT_TRUE (prev->finalize_nodes ());
+  EXPECT_EQ (prev->graph_nodes_[0]->route_playback_latency_, 64);
+  EXPECT_EQ (prev->graph_nodes_[3]->route_playback_latency_, 128);
+
+  // connecting 0 -> 3 only changes node 0
+  auto next = make_collection ({ { 0, 1 }, { 1, 2 }, { 0, 3 } });
+  const auto changed = next->get_nodes_with_changed_connections (*prev);
+  ASSERT_EQ (changed.size (), 1);
+  EXPECT_EQ (changed.front (), next->graph_nodes_[0].get ());
+  EXPECT_TRUE (next->finalize_nodes (prev.get ()));
+  EXPECT_EQ (next->graph_nodes_[0]->route_playback_latency_, 128);
+  EXPECT_EQ (next->graph_nodes_[1]->route_playback_latency_, 64);
+  EXPECT_EQ (next->graph_nodes_[2]->route_playback_latency_, 64);
+  EXPECT_EQ (next->graph_nodes_[3]->route_playback_latency_, 128);
+
+  // same topology
+  auto same = make_collection ({ { 0, 3 }, { 1, 2 }, { 0, 1 } });
+  EXPECT_FALSE (same->finalize_nodes (next.get ()));
+  EXPECT_EQ (same->graph_nodes_[0]->route_playback_latency_, 128);
+
+  // a latency change propagates upstream only, and can be computed without
+  // touching the nodes
+  ON_CALL (processables[2], get_single_playback_latency ())
+    .WillByDefault (Return (256));
+  const auto updates = next->compute_latency_updates ({});
+  EXPECT_EQ (updates.size (), 3);
+  EXPECT_EQ (next->graph_nodes_[2]->playback_latency_, 64);
+  EXPECT_EQ (next->graph_nodes_[0]->route_playback_latency_, 128);
+  GraphNodeCollection::apply_latency_updates (updates);
+  EXPECT_TRUE (next->compute_latency_updates ({}).empty ());
+  EXPECT_EQ (next->graph_nodes_[0]->route_playback_latency_, 256);
+  EXPECT_EQ (next->graph_nodes_[1]->route_playback_latency_, 256);
+  EXPECT_EQ (next->graph_nodes_[2]->route_playback_latency_, 256);
+  EXPECT_EQ (next->graph_nodes_[3]->route_playback_latency_, 128);
+
+  // the result matches a full recalculation
+  auto full = make_collection ({ { 0, 1 }, { 1, 2 }, { 0, 3 } });
+  full->finalize_nodes ();
+  for (size_t i = 0; i < processables.size (); ++i)
+    {
+      EXPECT_EQ (
+        full->graph_nodes_[i]->route_playback_latency_,
+        next->graph_nodes_[i]->route_playback_latency_);
+    }
+}
+
+TEST_F (GraphNodeTest, RemoveNodesNotUpstreamOf)
+{
+  GraphNodeCollection collection;
+
+  // a -> b -> sink, a -> c -> other, d -> special
+  std::vector<GraphNode *> nodes;
+  for (int i = 0; i < 7; ++i)
+    {
+      collection.graph_nodes_.push_back (
+        std::make_unique<GraphNode> (i, *transport_, *processable_));
+      nodes.push_back (collection.graph_nodes_.back ().get ());
+    }
+  auto * a = nodes[0];
+  auto * b = nodes[1];
+  auto * c = nodes[2];
+  auto * sink = nodes[3];
+  auto * other = nodes[4];
+  auto * d = nodes[5];
+  auto * special = nodes[6];
+  a->connect_to (*b);
+  b->connect_to (*sink);
+  a->connect_to (*c);
+  c->connect_to (*other);
+  d->connect_to (*special);
+  collection.add_special_node (*special);
+
+  const std::vector<GraphNode *> sinks{ sink };
+  EXPECT_EQ (collection.remove_nodes_not_upstream_of (sinks), 2);
+
+  // special nodes and what feeds them are kept
+  ASSERT_EQ (collection.graph_nodes_.size (), 5);
+  for (auto * node : { a, b, sink, d, special })
+    {
+      EXPECT_TRUE (std::ranges::any_of (
+        collection.graph_nodes_,
+        [node] (const auto &cur) { return cur.get () == node; }));
+    }
+
+  // edges to removed nodes are dropped
+  ASSERT_EQ (a->childnodes_.size (), 1);
+  EXPECT_EQ (&a->childnodes_.front ().get (), b);
+
+  collection.finalize_nodes ();
+  EXPECT_EQ (collection.trigger_nodes_.size (), 2);
+  EXPECT_EQ (collection.terminal_nodes_.size (), 2);
+}
+
+TEST_F (GraphNodeTest, PlacementGroups)
+{
+  GraphNodeCollection collection;
+
+  // 2 tracks (in1a, in1b -> proc1 -> fader1 and in2 -> proc2 -> fader2) that
+  // feed master -> out
+  std::vector<GraphNode *> nodes;
+  for (int i = 0; i < 9; ++i)
+    {
+      collection.graph_nodes_.push_back (
+        std::make_unique<GraphNode> (i, *transport_, *processable_));
+      nodes.push_back (collection.graph_nodes_.back ().get ());
+    }
+  auto * in1a = nodes[0];
+  auto * in1b = nodes[1];
+  auto * proc1 = nodes[2];
+  auto * fader1 = nodes[3];
+  auto * in2 = nodes[4];
+  auto * proc2 = nodes[5];
+  auto * fader2 = nodes[6];
+  auto * master = nodes[7];
+  auto * out = nodes[8];
+  in1a->connect_to (*proc1);
+  in1b->connect_to (*proc1);
+  proc1->connect_to (*fader1);
+  fader1->connect_to (*master);
+  in2->connect_to (*proc2);
+  proc2->connect_to (*fader2);
+  fader2->connect_to (*master);
+  master->connect_to (*out);
+  collection.finalize_nodes ();
+
+  const auto groups = collection.get_placement_groups ();
+  ASSERT_EQ (groups.size (), 3);
+  const auto group_of = [&] (const GraphNode * node) {
+    return std::ranges::find_if (groups, [node] (const auto &group) {
+      return std::ranges::contains (group, node);
+    });
+  };
+  EXPECT_EQ (group_of (in1a)->size (), 4);
+  EXPECT_EQ (group_of (in1a), group_of (in1b));
+  EXPECT_EQ (group_of (in1a), group_of (proc1));
+  EXPECT_EQ (group_of (in1a), group_of (fader1));
+  EXPECT_EQ (group_of (in2)->size (), 3);
+  EXPECT_EQ (group_of (in2), group_of (fader2));
+  EXPECT_EQ (group_of (master)->size (), 2);
+  EXPECT_EQ (group_of (master), group_of (out));
+
+  // the master group starts after the tracks in topological order
+  EXPECT_EQ (groups.back ().front (), master);
+}
+
 } // namespace zrythm::dsp
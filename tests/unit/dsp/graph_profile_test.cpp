@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "dsp/graph_node.h"
+#include "dsp/graph_profile.h"
+#include "utils/gtest_wrapper.h"
+
+#include <yyjson.h>
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+class NamedProcessable final : public IProcessable
+{
+public:
+  explicit NamedProcessable (std::string name) : name_ (std::move (name)) { }
+  std::string get_node_name () const override { return name_; }
+
+private:
+  std::string name_;
+};
+
+class StoppedTransport final : public ITransport
+{
+public:
+  void position_add_frames (Position &, signed_frame_t) const override { }
+  std::pair<Position, Position> get_loop_range_positions () const override
+  {
+    return {};
+  }
+  PlayState get_play_state () const override { return PlayState::Paused; }
+  Position  get_playhead_position () const override { return {}; }
+  bool      get_loop_enabled () const override { return false; }
+  nframes_t
+  is_loop_point_met (signed_frame_t, nframes_t) const override
+  {
+    return 0;
+  }
+};
+
+}
+
+/**
+ * Diamond graph where the heavy branch is the critical path:
+ * input -> { light, heavy } -> master.
+ */
+class GraphProfileTest : public ::testing::Test
+{
+protected:
+  void SetUp () override
+  {
+    add_node (input_, 1000.f);
+    add_node (light_, 2000.f);
+    add_node (heavy_, 8000.f);
+    add_node (master_, 1000.f);
+    auto &nodes = collection_.graph_nodes_;
+    nodes[0]->connect_to (*nodes[1]);
+    nodes[0]->connect_to (*nodes[2]);
+    nodes[1]->connect_to (*nodes[3]);
+    nodes[2]->connect_to (*nodes[3]);
+    nodes[2]->last_thread_lane_ = 1;
+    collection_.finalize_nodes ();
+  }
+
+  void add_node (IProcessable &processable, float cost_ns)
+  {
+    const auto id = static_cast<int> (collection_.graph_nodes_.size ());
+    collection_.graph_nodes_.push_back (
+      std::make_unique<GraphNode> (id, transport_, processable));
+    collection_.graph_nodes_.back ()->processing_cost_ns_ = cost_ns;
+  }
+
+  static const GraphProfile::Node &
+  find_node (const GraphProfile &profile, const std::string &name)
+  {
+    const auto it = std::ranges::find (
+      profile.nodes_, name, &GraphProfile::Node::name_);
+    EXPECT_NE (it, profile.nodes_.end ());
+    return *it;
+  }
+
+  const std::vector<std::string> thread_names_{ "worker 0", "worker 1" };
+  StoppedTransport               transport_;
+  NamedProcessable               input_{ "input" };
+  NamedProcessable               light_{ "light" };
+  NamedProcessable               heavy_{ "heavy" };
+  NamedProcessable               master_{ "master" };
+  GraphNodeCollection            collection_;
+};
+
+TEST_F (GraphProfileTest, CriticalPath)
+{
+  const auto profile = GraphProfile::capture (collection_, thread_names_);
+  ASSERT_EQ (profile.nodes_.size (), 4);
+  EXPECT_DOUBLE_EQ (profile.total_cost_ns_, 12000.0);
+  EXPECT_DOUBLE_EQ (profile.critical_path_cost_ns_, 10000.0);
+  EXPECT_DOUBLE_EQ (profile.get_max_parallelism (), 1.2);
+
+  EXPECT_TRUE (find_node (profile, "input").critical_);
+  EXPECT_TRUE (find_node (profile, "heavy").critical_);
+  EXPECT_TRUE (find_node (profile, "master").critical_);
+  EXPECT_FALSE (find_node (profile, "light").critical_);
+  EXPECT_DOUBLE_EQ (find_node (profile, "light").path_cost_ns_, 3000.0);
+
+  EXPECT_EQ (find_node (profile, "heavy").thread_, "worker 1");
+  EXPECT_TRUE (find_node (profile, "light").thread_.empty ());
+
+  // nodes are in topological order
+  EXPECT_EQ (profile.nodes_.front ().name_, "input");
+  EXPECT_EQ (profile.nodes_.back ().name_, "master");
+  EXPECT_EQ (profile.nodes_.front ().children_.size (), 2);
+}
+
+TEST_F (GraphProfileTest, FusedNodesAreOneUnit)
+{
+  GraphNodeCollection chain;
+  NamedProcessable    synth{ "synth" };
+  NamedProcessable    reverb{ "reverb" };
+  chain.graph_nodes_.push_back (
+    std::make_unique<GraphNode> (0, transport_, synth));
+  chain.graph_nodes_.push_back (
+    std::make_unique<GraphNode> (1, transport_, reverb));
+  chain.graph_nodes_[0]->connect_to (*chain.graph_nodes_[1]);
+  chain.finalize_nodes ();
+  chain.fuse_linear_chains ();
+
+  const auto profile = GraphProfile::capture (chain, thread_names_);
+  ASSERT_EQ (profile.nodes_.size (), 1);
+  EXPECT_EQ (profile.nodes_[0].name_, "synth");
+  EXPECT_EQ (
+    profile.nodes_[0].fused_names_, std::vector<std::string>{ "reverb" });
+  EXPECT_NE (profile.to_dot ().find ("(+1 fused)"), std::string::npos);
+}
+
+TEST_F (GraphProfileTest, Dot)
+{
+  const auto dot = GraphProfile::capture (collection_, thread_names_).to_dot ();
+  EXPECT_TRUE (dot.starts_with ("digraph"));
+  EXPECT_NE (dot.find ("heavy\\n8.0 us"), std::string::npos);
+  EXPECT_NE (dot.find ("worker 1"), std::string::npos);
+
+  // only the edges on the critical path are highlighted
+  size_t num_critical_edges = 0;
+  for (
+    size_t pos = dot.find (" [color=red"); pos != std::string::npos;
+    pos = dot.find (" [color=red", pos + 1))
+    ++num_critical_edges;
+  EXPECT_EQ (num_critical_edges, 2);
+}
+
+TEST_F (GraphProfileTest, Json)
+{
+  const auto json =
+    GraphProfile::capture (collection_, thread_names_).to_json ();
+  yyjson_doc * doc = yyjson_read (json.c_str (), json.size (), 0);
+  ASSERT_NE (doc, nullptr);
+  yyjson_val * root = yyjson_doc_get_root (doc);
+  EXPECT_DOUBLE_EQ (
+    yyjson_get_real (yyjson_obj_get (root, "criticalPathCostNs")), 10000.0);
+  EXPECT_EQ (yyjson_arr_size (yyjson_obj_get (root, "criticalPath")), 3);
+
+  yyjson_val * nodes = yyjson_obj_get (root, "nodes");
+  ASSERT_EQ (yyjson_arr_size (nodes), 4);
+  yyjson_val * first = yyjson_arr_get_first (nodes);
+  EXPECT_STREQ (yyjson_get_str (yyjson_obj_get (first, "name")), "input");
+  EXPECT_TRUE (yyjson_is_null (yyjson_obj_get (first, "thread")));
+  EXPECT_EQ (yyjson_arr_size (yyjson_obj_get (first, "children")), 2);
+  yyjson_doc_free (doc);
+}
+
+} // namespace zrythm::dsp
@@ -83,6 +83,36 @@ protected:
     return collection;
   }
 
+  /**
+   * @brief Creates a root node feeding @p branches chains of
+   * @p nodes_per_branch nodes that all feed a single sink node.
+   */
+  GraphNodeCollection
+  create_fan_out_collection (size_t branches, size_t nodes_per_branch)
+  {
+    GraphNodeCollection collection;
+    auto root = std::make_unique<GraphNode> (0, *transport_, *processable_);
+    auto sink = std::make_unique<GraphNode> (1, *transport_, *processable_);
+    for (size_t b = 0; b < branches; b++)
+      {
+        GraphNode * prev = root.get ();
+        for (size_t n = 0; n < nodes_per_branch; n++)
+          {
+            auto node = std::make_unique<GraphNode> (
+              collection.graph_nodes_.size () + 2, *transport_, *processable_);
+            prev->connect_to (*node);
+            prev = node.get ();
+            collection.graph_nodes_.push_back (std::move (node));
+          }
+        prev->connect_to (*sink);
+      }
+    collection.graph_nodes_.push_back (std::move (root));
+    collection.graph_nodes_.push_back (std::move (sink));
+
+    collection.finalize_nodes ();
+    return collection;
+  }
+
   std::unique_ptr<MockTransport>   transport_;
   std::unique_ptr<MockProcessable> processable_;
   std::unique_ptr<GraphScheduler>  scheduler_;
@@ -175,4 +205,388 @@ TEST_F (GraphSchedulerTest, NodeTriggeringOrder)
   scheduler_->terminate_threads ();
 }
 
+TEST_F (GraphSchedulerTest, WorkStealingProcessingCycle)
+{
+  scheduler_ = std::make_unique<GraphScheduler> (
+    GraphScheduler::SchedulingStrategy::WorkStealing);
+  auto collection = create_test_collection ();
+
+  EXPECT_CALL (*processable_, process_block (_)).Times (3); // Once for each node
+
+  scheduler_->rechain_from_node_collection (std::move (collection));
+  scheduler_->start_threads (2);
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  scheduler_->run_cycle (time_info, 0);
+
+  scheduler_->terminate_threads ();
+}
+
+TEST_F (GraphSchedulerTest, WorkStealingMultipleCycles)
+{
+  scheduler_ = std::make_unique<GraphScheduler> (
+    GraphScheduler::SchedulingStrategy::WorkStealing);
+  constexpr size_t branches = 16;
+  constexpr size_t nodes_per_branch = 8;
+  constexpr int    num_cycles = 50;
+  auto collection = create_fan_out_collection (branches, nodes_per_branch);
+  const auto num_nodes = collection.graph_nodes_.size ();
+
+  std::atomic<int> process_count{ 0 };
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_count++;
+  });
+
+  scheduler_->rechain_from_node_collection (std::move (collection));
+  scheduler_->start_threads (4);
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  for (int i = 0; i < num_cycles; i++)
+    {
+      scheduler_->run_cycle (time_info, 0);
+      EXPECT_EQ (process_count, static_cast<int> (num_nodes) * (i + 1));
+    }
+
+  scheduler_->terminate_threads ();
+}
+
+
+TEST_F (GraphSchedulerTest, PublishNodeCollection)
+{
+  std::atomic<int> process_count{ 0 };
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_count++;
+  });
+
+  // 2 branches of 2 nodes + root + sink
+  scheduler_->rechain_from_node_collection (create_fan_out_collection (2, 2));
+  scheduler_->start_threads (2);
+
+  // keep processing while the new graph is published
+  std::atomic<bool> stop{ false };
+  std::thread       process_thread ([&] () {
+    EngineProcessTimeInfo time_info{};
+    time_info.nframes_ = 256;
+    while (!stop)
+      {
+        scheduler_->run_cycle (time_info, 0);
+      }
+  });
+
+  EXPECT_TRUE (scheduler_->publish_node_collection (create_test_collection ()));
+  while (scheduler_->has_pending_node_collection ())
+    {
+      std::this_thread::yield ();
+    }
+  scheduler_->free_retired_node_collections ();
+  EXPECT_EQ (scheduler_->get_nodes ().graph_nodes_.size (), 3);
+
+  stop = true;
+  process_thread.join ();
+
+  // now running the new graph
+  const int             count_before = process_count;
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  scheduler_->run_cycle (time_info, 0);
+  EXPECT_EQ (process_count - count_before, 3);
+
+  // graphs that don't fit the preallocated queues are rejected
+  auto large_collection = create_fan_out_collection (8, 8);
+  EXPECT_FALSE (
+    scheduler_->publish_node_collection (std::move (large_collection)));
+  EXPECT_EQ (large_collection.graph_nodes_.size (), 66);
+  EXPECT_FALSE (scheduler_->has_pending_node_collection ());
+
+  scheduler_->terminate_threads ();
+}
+
+TEST_F (GraphSchedulerTest, LatencyUpdates)
+{
+  scheduler_->rechain_from_node_collection (create_test_collection ());
+  auto &nodes = scheduler_->get_nodes ();
+  EXPECT_TRUE (nodes.compute_latency_updates ({}).empty ());
+
+  // the processable now reports latency
+  ON_CALL (*processable_, get_single_playback_latency ())
+    .WillByDefault (Return (128));
+  auto updates = nodes.compute_latency_updates ({});
+  EXPECT_EQ (updates.size (), 3);
+  scheduler_->publish_latency_updates (std::move (updates));
+  EXPECT_TRUE (scheduler_->has_pending_latency_updates ());
+  for (const auto &node : nodes.graph_nodes_)
+    {
+      EXPECT_EQ (node->route_playback_latency_, 0);
+    }
+
+  // applied at the cycle boundary
+  EXPECT_TRUE (scheduler_->apply_pending_latency_updates ());
+  EXPECT_FALSE (scheduler_->has_pending_latency_updates ());
+  EXPECT_FALSE (scheduler_->apply_pending_latency_updates ());
+  for (const auto &node : nodes.graph_nodes_)
+    {
+      EXPECT_EQ (node->playback_latency_, 128);
+      EXPECT_EQ (node->route_playback_latency_, 128);
+    }
+}
+
+TEST_F (GraphSchedulerTest, RestartThreads)
+{
+  std::atomic<int> process_count{ 0 };
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_count++;
+  });
+
+  scheduler_->set_cpu_affinity ({});
+  scheduler_->rechain_from_node_collection (create_test_collection ());
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  for (const int num_threads : { 2, 1, 3 })
+    {
+      process_count = 0;
+      scheduler_->start_threads (num_threads);
+      scheduler_->run_cycle (time_info, 0);
+      scheduler_->run_cycle (time_info, 0);
+      EXPECT_EQ (process_count, 6);
+      scheduler_->terminate_threads ();
+    }
+}
+
+TEST_F (GraphSchedulerTest, NoNumaPlacementWithoutPinning)
+{
+  scheduler_ = std::make_unique<GraphScheduler> (
+    GraphScheduler::SchedulingStrategy::WorkStealing);
+  std::atomic<int> process_count{ 0 };
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_count++;
+  });
+
+  // unpinned threads aren't on a known NUMA node
+  scheduler_->set_cpu_affinity ({});
+  scheduler_->rechain_from_node_collection (create_fan_out_collection (4, 2));
+  scheduler_->start_threads (3);
+  EXPECT_FALSE (scheduler_->uses_numa_placement ());
+  EXPECT_TRUE (scheduler_->get_numa_placement ().empty ());
+  for (const auto &node : scheduler_->get_nodes ().graph_nodes_)
+    {
+      EXPECT_EQ (node->numa_node_, -1);
+    }
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  scheduler_->run_cycle (time_info, 0);
+  EXPECT_EQ (process_count, 10);
+
+  scheduler_->terminate_threads ();
+}
+
+TEST_F (GraphSchedulerTest, CalibrateNumThreads)
+{
+  std::atomic<int> process_count{ 0 };
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_count++;
+  });
+
+  scheduler_->set_cpu_affinity ({});
+  scheduler_->rechain_from_node_collection (create_fan_out_collection (4, 2));
+  scheduler_->start_threads (2);
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  const int num_threads = scheduler_->calibrate_num_threads (time_info, 3, 8);
+  EXPECT_GE (num_threads, 1);
+  EXPECT_LE (num_threads, 3);
+
+  // the threads keep running with the chosen number of workers
+  process_count = 0;
+  scheduler_->run_cycle (time_info, 0);
+  EXPECT_EQ (process_count, 10);
+
+  scheduler_->terminate_threads ();
+}
+
+TEST_F (GraphSchedulerTest, IdleSpinning)
+{
+  std::atomic<int> process_count{ 0 };
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_count++;
+  });
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  for (const auto spin_duration : { 0us, 20us, 5000us })
+    {
+      scheduler_ = std::make_unique<GraphScheduler> ();
+      scheduler_->set_idle_spin_duration (spin_duration);
+      scheduler_->rechain_from_node_collection (
+        create_fan_out_collection (4, 2));
+      scheduler_->start_threads (3);
+
+      process_count = 0;
+      for (int i = 0; i < 100; i++)
+        {
+          scheduler_->run_cycle (time_info, 0);
+        }
+      EXPECT_EQ (process_count, 1000);
+
+      scheduler_->terminate_threads ();
+    }
+}
+
+TEST_F (GraphSchedulerTest, StaticSchedule)
+{
+  std::vector<std::thread::id> process_threads;
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_threads.push_back (std::this_thread::get_id ());
+  });
+
+  scheduler_->rechain_from_node_collection (create_fan_out_collection (4, 2));
+  scheduler_->start_threads (2);
+  scheduler_->set_static_schedule_limits (16, 1s);
+  EXPECT_TRUE (scheduler_->is_using_static_schedule ());
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  scheduler_->run_cycle (time_info, 0);
+
+  // all nodes are processed on the calling thread
+  EXPECT_EQ (process_threads.size (), 10);
+  EXPECT_THAT (process_threads, Each (std::this_thread::get_id ()));
+
+  // too many nodes
+  scheduler_->set_static_schedule_limits (4, 1s);
+  EXPECT_FALSE (scheduler_->is_using_static_schedule ());
+
+  scheduler_->terminate_threads ();
+}
+
+TEST_F (GraphSchedulerTest, StaticScheduleSwitchesWhenExpensive)
+{
+  std::atomic<int> process_count{ 0 };
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_count++;
+    std::this_thread::sleep_for (10us);
+  });
+
+  scheduler_->rechain_from_node_collection (create_test_collection ());
+  scheduler_->start_threads (2);
+  scheduler_->set_static_schedule_limits (16, 1us);
+  EXPECT_TRUE (scheduler_->is_using_static_schedule ());
+
+  // the first measurements reveal that the graph is too expensive
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  for (int i = 0; i < 100; i++)
+    {
+      scheduler_->run_cycle (time_info, 0);
+    }
+  EXPECT_FALSE (scheduler_->is_using_static_schedule ());
+  EXPECT_EQ (process_count, 300);
+
+  scheduler_->terminate_threads ();
+}
+
+TEST_F (GraphSchedulerTest, StaticScheduleWithoutThreads)
+{
+  std::atomic<int> process_count{ 0 };
+  ON_CALL (*processable_, process_block (_)).WillByDefault ([&] (auto) {
+    process_count++;
+  });
+
+  scheduler_->rechain_from_node_collection (create_test_collection ());
+  EXPECT_TRUE (scheduler_->is_using_static_schedule ());
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  scheduler_->run_cycle (time_info, 0);
+  EXPECT_EQ (process_count, 3);
+}
+
+TEST_F (GraphSchedulerTest, GraphLoopSplitting)
+{
+  const Position loop_end{ 1920.0, 22.675736961451247 };
+  ON_CALL (*transport_, get_play_state ())
+    .WillByDefault (Return (ITransport::PlayState::Paused));
+  ON_CALL (*transport_, get_loop_enabled ()).WillByDefault (Return (true));
+  ON_CALL (*transport_, get_loop_range_positions ())
+    .WillByDefault (Return (std::make_pair (Position{}, loop_end)));
+
+  // the loop point is looked up once per part for the whole graph instead of
+  // by each node
+  EXPECT_CALL (*transport_, is_loop_point_met (_, _))
+    .WillOnce (Return (100))
+    .WillOnce (Return (0));
+  EXPECT_CALL (
+    *processable_,
+    process_block (AllOf (
+      Field (&EngineProcessTimeInfo::nframes_, 100),
+      Field (&EngineProcessTimeInfo::local_offset_, 0))))
+    .Times (3);
+  EXPECT_CALL (
+    *processable_,
+    process_block (AllOf (
+      Field (&EngineProcessTimeInfo::nframes_, 156),
+      Field (&EngineProcessTimeInfo::local_offset_, 100),
+      Field (&EngineProcessTimeInfo::g_start_frame_w_offset_, 0))))
+    .Times (3);
+
+  scheduler_->rechain_from_node_collection (create_test_collection ());
+
+  EngineProcessTimeInfo time_info{};
+  time_info.g_start_frame_ = loop_end.frames_ - 100;
+  time_info.g_start_frame_w_offset_ = time_info.g_start_frame_;
+  time_info.nframes_ = 256;
+  scheduler_->run_cycle (time_info, 0);
+}
+
+TEST_F (GraphSchedulerTest, TraceRecording)
+{
+  scheduler_->rechain_from_node_collection (create_fan_out_collection (4, 2));
+  scheduler_->start_threads (2);
+  EXPECT_EQ (scheduler_->get_trace_recorder (), nullptr);
+  scheduler_->terminate_threads ();
+
+  scheduler_->set_trace_recording_enabled (true);
+  scheduler_->start_threads (2);
+  auto * recorder = scheduler_->get_trace_recorder ();
+  ASSERT_NE (recorder, nullptr);
+
+  // 2 workers, the main graph thread and the thread running the cycles
+  EXPECT_EQ (recorder->get_num_lanes (), 4);
+
+  EngineProcessTimeInfo time_info{};
+  time_info.nframes_ = 256;
+  auto count_node_spans = [&] () {
+    size_t num_spans = 0;
+    for (size_t lane = 0; lane < recorder->get_num_lanes (); ++lane)
+      {
+        num_spans += recorder->get_spans (lane).size ();
+      }
+    return num_spans;
+  };
+  for (int i = 0; i < 3; ++i)
+    {
+      scheduler_->run_cycle (time_info, 0);
+    }
+  recorder->freeze ();
+  EXPECT_EQ (count_node_spans (), 30);
+  EXPECT_EQ (recorder->get_spans (recorder->get_num_lanes ()).size (), 3);
+  for (const auto &span : recorder->get_spans (recorder->get_num_lanes ()))
+    {
+      EXPECT_LE (span.start_ns_, span.end_ns_);
+    }
+
+  // the recording is kept while frozen
+  scheduler_->run_cycle (time_info, 0);
+  EXPECT_EQ (count_node_spans (), 30);
+
+  recorder->reset ();
+  scheduler_->run_cycle (time_info, 0);
+  EXPECT_EQ (count_node_spans (), 10);
+
+  scheduler_->terminate_threads ();
+}
 }
@@ -0,0 +1,160 @@
+#include "dsp/graph_node.h"
+#include "dsp/graph_trace_recorder.h"
+#include "utils/gtest_wrapper.h"
+
+#include <yyjson.h>
+
+using namespace std::chrono_literals;
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+class NamedProcessable final : public IProcessable
+{
+public:
+  explicit NamedProcessable (std::string name) : name_ (std::move (name)) { }
+  std::string get_node_name () const override { return name_; }
+
+private:
+  std::string name_;
+};
+
+class StoppedTransport final : public ITransport
+{
+public:
+  void position_add_frames (Position &, signed_frame_t) const override { }
+  std::pair<Position, Position> get_loop_range_positions () const override
+  {
+    return {};
+  }
+  PlayState get_play_state () const override { return PlayState::Paused; }
+  Position  get_playhead_position () const override { return {}; }
+  bool      get_loop_enabled () const override { return false; }
+  nframes_t
+  is_loop_point_met (signed_frame_t, nframes_t) const override
+  {
+    return 0;
+  }
+};
+
+}
+
+class GraphTraceRecorderTest : public ::testing::Test
+{
+protected:
+  void SetUp () override
+  {
+    collection_.graph_nodes_.push_back (
+      std::make_unique<GraphNode> (0, transport_, synth_));
+    collection_.graph_nodes_.push_back (
+      std::make_unique<GraphNode> (1, transport_, reverb_));
+    collection_.graph_nodes_[0]->connect_to (*collection_.graph_nodes_[1]);
+    collection_.finalize_nodes ();
+  }
+
+  const GraphNode &synth_node () const { return *collection_.graph_nodes_[0]; }
+  const GraphNode &reverb_node () const { return *collection_.graph_nodes_[1]; }
+
+  static GraphTraceRecorder::Clock::time_point at (std::chrono::nanoseconds ns)
+  {
+    return GraphTraceRecorder::Clock::time_point (ns);
+  }
+
+  StoppedTransport    transport_;
+  NamedProcessable    synth_{ "synth" };
+  NamedProcessable    reverb_{ "reverb" };
+  GraphNodeCollection collection_;
+};
+
+TEST_F (GraphTraceRecorderTest, RecordAndFreeze)
+{
+  GraphTraceRecorder recorder ({ "thread 0", "thread 1" }, 16);
+  EXPECT_EQ (recorder.get_num_lanes (), 2);
+
+  recorder.record_node (0, synth_node (), at (1000ns), at (2000ns));
+  recorder.record_node (1, reverb_node (), at (2000ns), at (2500ns));
+  recorder.record_cycle (at (1000ns), at (3000ns));
+
+  EXPECT_TRUE (recorder.freeze ());
+  EXPECT_FALSE (recorder.freeze ());
+  EXPECT_TRUE (recorder.is_frozen ());
+
+  // nothing is recorded while frozen
+  recorder.record_node (0, reverb_node (), at (4000ns), at (5000ns));
+  recorder.record_cycle (at (4000ns), at (5000ns));
+
+  const auto spans = recorder.get_spans (0);
+  ASSERT_EQ (spans.size (), 1);
+  EXPECT_EQ (spans[0].node_, &synth_node ());
+  EXPECT_EQ (spans[0].start_ns_, 1000);
+  EXPECT_EQ (spans[0].end_ns_, 2000);
+  EXPECT_EQ (recorder.get_spans (1).size (), 1);
+
+  const auto cycles = recorder.get_spans (recorder.get_num_lanes ());
+  ASSERT_EQ (cycles.size (), 1);
+  EXPECT_EQ (cycles[0].node_, nullptr);
+
+  recorder.reset ();
+  EXPECT_FALSE (recorder.is_frozen ());
+  EXPECT_TRUE (recorder.get_spans (0).empty ());
+}
+
+TEST_F (GraphTraceRecorderTest, RingKeepsLatestSpans)
+{
+  GraphTraceRecorder recorder ({ "thread 0" }, 4);
+  for (int i = 0; i < 10; ++i)
+    {
+      recorder.record_node (
+        0, synth_node (), at (i * 1000ns), at (i * 1000ns + 500ns));
+    }
+  recorder.freeze ();
+
+  // the oldest slot may be being overwritten when frozen, so it is skipped
+  const auto spans = recorder.get_spans (0);
+  ASSERT_EQ (spans.size (), 3);
+  EXPECT_EQ (spans.front ().start_ns_, 7000);
+  EXPECT_EQ (spans.back ().start_ns_, 9000);
+}
+
+TEST_F (GraphTraceRecorderTest, ChromeTraceJson)
+{
+  GraphTraceRecorder recorder ({ "worker" }, 16);
+  recorder.register_node_names (collection_);
+
+  // an old cycle that is not exported
+  recorder.record_node (0, synth_node (), at (100ns), at (200ns));
+  recorder.record_cycle (at (0ns), at (1000ns));
+
+  recorder.record_node (0, synth_node (), at (10'000ns), at (12'000ns));
+  recorder.record_node (0, reverb_node (), at (12'000ns), at (15'000ns));
+  recorder.record_cycle (at (10'000ns), at (16'000ns));
+  recorder.freeze ();
+
+  const auto json = recorder.to_chrome_trace_json (5us, 1);
+  yyjson_doc * doc = yyjson_read (json.c_str (), json.size (), 0);
+  ASSERT_NE (doc, nullptr);
+  yyjson_val * events =
+    yyjson_obj_get (yyjson_doc_get_root (doc), "traceEvents");
+  ASSERT_TRUE (yyjson_is_arr (events));
+
+  std::vector<std::string> names;
+  size_t                   idx = 0;
+  size_t                   max = 0;
+  yyjson_val *             event = nullptr;
+  yyjson_arr_foreach (events, idx, max, event)
+  {
+    if (std::string (yyjson_get_str (yyjson_obj_get (event, "ph"))) != "X")
+      continue;
+    names.emplace_back (yyjson_get_str (yyjson_obj_get (event, "name")));
+  }
+  EXPECT_EQ (
+    names,
+    (std::vector<std::string>{ "cycle (overrun)", "synth", "reverb" }));
+
+  yyjson_doc_free (doc);
+}
+
+} // namespace zrythm::dsp
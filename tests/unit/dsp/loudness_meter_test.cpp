@@ -0,0 +1,107 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cmath>
+#include <numbers>
+
+#include "dsp/loudness_meter.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+class LoudnessMeterTest : public ::testing::Test
+{
+protected:
+  static constexpr float SAMPLE_RATE = 48000.0f;
+
+  void SetUp () override { meter_.init (SAMPLE_RATE, 2); }
+
+  /**
+   * @brief Processes @p seconds of a 1 kHz sine at @p dbfs on both channels,
+   * in blocks of @p block_length frames.
+   */
+  void process_sine (double dbfs, double seconds, int block_length = 4096)
+  {
+    const float amp = static_cast<float> (std::pow (10.0, dbfs / 20.0));
+    const auto  total = static_cast<int> (seconds * SAMPLE_RATE);
+    std::vector<float> buf (block_length);
+    for (int offset = 0; offset < total; offset += block_length)
+      {
+        const int n = std::min (block_length, total - offset);
+        for (int i = 0; i < n; ++i)
+          {
+            buf[i] =
+              amp
+              * std::sin (
+                2.f * std::numbers::pi_v<float> * 1000.f
+                * static_cast<float> (phase_ + i) / SAMPLE_RATE);
+          }
+        phase_ = (phase_ + n) % static_cast<int> (SAMPLE_RATE);
+        const float * channels[] = { buf.data (), buf.data () };
+        meter_.process (channels, n);
+      }
+  }
+
+  LoudnessMeter meter_;
+  int           phase_ = 0;
+};
+
+TEST_F (LoudnessMeterTest, Silence)
+{
+  std::vector<float> silence (48000, 0.f);
+  const float *      channels[] = { silence.data (), silence.data () };
+  meter_.process (channels, static_cast<int> (silence.size ()));
+  EXPECT_TRUE (std::isinf (meter_.get_integrated_loudness ()));
+  EXPECT_DOUBLE_EQ (meter_.get_loudness_range (), 0.0);
+  EXPECT_FLOAT_EQ (meter_.get_true_peak (), 0.f);
+}
+
+TEST_F (LoudnessMeterTest, TooShortForAGatingBlock)
+{
+  process_sine (-20.0, 0.3);
+  EXPECT_TRUE (std::isinf (meter_.get_integrated_loudness ()));
+}
+
+TEST_F (LoudnessMeterTest, StereoSineIntegratedLoudness)
+{
+  /* EBU Tech 3341 case 1 */
+  process_sine (-23.0, 20.0);
+  EXPECT_NEAR (meter_.get_integrated_loudness (), -23.0, 0.1);
+}
+
+TEST_F (LoudnessMeterTest, IntegratedLoudnessIgnoresQuietParts)
+{
+  /* EBU Tech 3341 case 3: the -36 dBFS part is below the relative gate */
+  process_sine (-36.0, 10.0);
+  process_sine (-23.0, 60.0);
+  process_sine (-36.0, 10.0);
+  EXPECT_NEAR (meter_.get_integrated_loudness (), -23.0, 0.1);
+}
+
+TEST_F (LoudnessMeterTest, LoudnessRange)
+{
+  /* EBU Tech 3342 case 1 */
+  process_sine (-20.0, 20.0);
+  process_sine (-30.0, 20.0);
+  EXPECT_NEAR (meter_.get_loudness_range (), 10.0, 1.0);
+}
+
+TEST_F (LoudnessMeterTest, TruePeak)
+{
+  process_sine (-6.0, 1.0);
+  EXPECT_NEAR (meter_.get_true_peak (), std::pow (10.f, -6.f / 20.f), 0.02f);
+}
+
+TEST_F (LoudnessMeterTest, BlockLengthDoesNotAffectResult)
+{
+  process_sine (-18.0, 5.0, 4096);
+  const double expected = meter_.get_integrated_loudness ();
+
+  meter_.init (SAMPLE_RATE, 2);
+  phase_ = 0;
+  process_sine (-18.0, 5.0, 113);
+  EXPECT_NEAR (meter_.get_integrated_loudness (), expected, 1e-6);
+}
+
+} // namespace zrythm::dsp
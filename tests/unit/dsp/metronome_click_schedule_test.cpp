@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <vector>
+
+#include "dsp/metronome_click_schedule.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+constexpr int TICKS_PER_BEAT = 960;
+
+/* 120 BPM at 48 kHz: 24000 frames per beat */
+constexpr double FRAMES_PER_TICK = 24000.0 / TICKS_PER_BEAT;
+
+namespace
+{
+std::vector<MetronomeClickSchedule::Click>
+collect (
+  MetronomeClickSchedule &schedule,
+  signed_frame_t          start,
+  signed_frame_t          end)
+{
+  std::vector<MetronomeClickSchedule::Click> clicks;
+  schedule.for_each_click (start, end, [&] (const auto &click) {
+    clicks.push_back (click);
+  });
+  return clicks;
+}
+}
+
+TEST (MetronomeClickScheduleTest, ClicksInRange)
+{
+  MetronomeClickSchedule schedule;
+  schedule.set_grid (FRAMES_PER_TICK, TICKS_PER_BEAT, 4);
+
+  /* start is inclusive */
+  auto clicks = collect (schedule, 0, 256);
+  ASSERT_EQ (clicks.size (), 1);
+  EXPECT_EQ (clicks[0].frame_, 0);
+  EXPECT_TRUE (clicks[0].emphasis_);
+
+  /* end is exclusive */
+  EXPECT_TRUE (collect (schedule, 23744, 24000).empty ());
+  clicks = collect (schedule, 24000, 24256);
+  ASSERT_EQ (clicks.size (), 1);
+  EXPECT_EQ (clicks[0].frame_, 24000);
+  EXPECT_FALSE (clicks[0].emphasis_);
+
+  /* second bar */
+  clicks = collect (schedule, 95990, 96010);
+  ASSERT_EQ (clicks.size (), 1);
+  EXPECT_EQ (clicks[0].frame_, 96000);
+  EXPECT_TRUE (clicks[0].emphasis_);
+}
+
+TEST (MetronomeClickScheduleTest, RangeLongerThanWindow)
+{
+  MetronomeClickSchedule schedule;
+  schedule.set_grid (FRAMES_PER_TICK, TICKS_PER_BEAT, 3);
+
+  constexpr auto num_beats = MetronomeClickSchedule::LOOKAHEAD_BEATS * 3 + 5;
+  const auto     clicks =
+    collect (schedule, 0, static_cast<signed_frame_t> (num_beats) * 24000);
+  ASSERT_EQ (clicks.size (), num_beats);
+  for (size_t i = 0; i < clicks.size (); ++i)
+    {
+      EXPECT_EQ (clicks[i].frame_, static_cast<signed_frame_t> (i) * 24000);
+      EXPECT_EQ (clicks[i].emphasis_, i % 3 == 0);
+    }
+}
+
+TEST (MetronomeClickScheduleTest, JumpsAndGridChanges)
+{
+  MetronomeClickSchedule schedule;
+  schedule.set_grid (FRAMES_PER_TICK, TICKS_PER_BEAT, 4);
+
+  /* far ahead, then back (e.g., looping) */
+  auto clicks = collect (schedule, 24000 * 1000 - 10, 24000 * 1000 + 10);
+  ASSERT_EQ (clicks.size (), 1);
+  EXPECT_TRUE (clicks[0].emphasis_);
+  clicks = collect (schedule, 24000 * 3, 24000 * 3 + 10);
+  ASSERT_EQ (clicks.size (), 1);
+  EXPECT_FALSE (clicks[0].emphasis_);
+
+  /* 60 BPM */
+  schedule.set_grid (FRAMES_PER_TICK * 2, TICKS_PER_BEAT, 4);
+  EXPECT_TRUE (collect (schedule, 24000 * 3, 24000 * 3 + 10).empty ());
+  clicks = collect (schedule, 48000 * 3, 48000 * 3 + 10);
+  ASSERT_EQ (clicks.size (), 1);
+
+  /* negative ranges have no clicks */
+  EXPECT_TRUE (collect (schedule, -1000, 0).empty ());
+}
+
+TEST (MetronomeClickScheduleTest, NoGrid)
+{
+  MetronomeClickSchedule schedule;
+  EXPECT_TRUE (collect (schedule, 0, 100000).empty ());
+}
+
+} // namespace zrythm::dsp
@@ -119,6 +119,46 @@ TEST (MusicalScaleTest, ExoticScales)
   EXPECT_TRUE (whole_tone.contains_note (MusicalNote::ASharp));
 }
 
+TEST (MusicalScaleTest, PitchClassMasks)
+{
+  EXPECT_EQ (
+    MusicalScale::get_pitch_class_mask_for_type (MusicalScale::Type::Chromatic),
+    PITCH_CLASS_MASK_ALL);
+
+  MusicalScale d_dorian (MusicalScale::Type::Dorian, MusicalNote::D);
+  MusicalScale c_major (MusicalScale::Type::Major, MusicalNote::C);
+  EXPECT_EQ (d_dorian.get_pitch_class_mask (), c_major.get_pitch_class_mask ());
+  for (int i = 0; i < 12; i++)
+    {
+      const auto note = static_cast<MusicalNote> (i);
+      EXPECT_EQ (
+        pitch_class_mask_contains (d_dorian.get_pitch_class_mask (), note),
+        c_major.contains_note (note));
+    }
+
+  // Bool tables match the masks
+  const bool * notes =
+    MusicalScale::get_notes_for_type (MusicalScale::Type::Dorian, true);
+  ASSERT_NE (notes, nullptr);
+  for (int i = 0; i < 12; i++)
+    {
+      EXPECT_EQ (
+        notes[i],
+        pitch_class_mask_contains (
+          MusicalScale::get_pitch_class_mask_for_type (
+            MusicalScale::Type::Dorian),
+          static_cast<MusicalNote> (i)));
+    }
+
+  // Unimplemented scales only contain the root
+  MusicalScale blues (MusicalScale::Type::Blues, MusicalNote::E);
+  EXPECT_EQ (
+    MusicalScale::get_notes_for_type (MusicalScale::Type::Blues, true),
+    nullptr);
+  EXPECT_TRUE (blues.contains_note (MusicalNote::E));
+  EXPECT_FALSE (blues.contains_note (MusicalNote::G));
+}
+
 TEST (MusicalScaleTest, Serialization)
 {
   MusicalScale scale1 (MusicalScale::Type::Major, MusicalNote::C);
@@ -0,0 +1,103 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <vector>
+
+#include "dsp/packed_automation_points.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+PackedAutomationPoints
+make_points ()
+{
+  PackedAutomationPoints points;
+  points.push_back (0.0, 0.2f, { 0.5, CurveOptions::Algorithm::Exponent });
+  points.push_back (100.0, 0.8f, { -0.3, CurveOptions::Algorithm::Vital });
+  points.push_back (150.0, 0.5f, { 0.0, CurveOptions::Algorithm::Exponent });
+  points.push_back (400.0, 0.1f, { 0.1, CurveOptions::Algorithm::Pulse });
+  return points;
+}
+}
+
+TEST (PackedAutomationPointsTest, ChangedIndicesAndSelect)
+{
+  const auto before = make_points ();
+  auto       after = before;
+  EXPECT_TRUE (before.get_changed_indices (after).empty ());
+
+  after.values_[1] = 0.9f;
+  after.curviness_[3] = 0.2;
+  const auto changed = before.get_changed_indices (after);
+  EXPECT_EQ (changed, (std::vector<size_t>{ 1, 3 }));
+
+  const auto selected = after.select (changed);
+  ASSERT_EQ (selected.size (), 2u);
+  EXPECT_FLOAT_EQ (selected.values_[0], 0.9f);
+  EXPECT_EQ (selected.get_curve (1).algo_, CurveOptions::Algorithm::Pulse);
+
+  PackedAutomationPoints appended;
+  appended.append (selected);
+  appended.append (selected);
+  EXPECT_EQ (appended.size (), 4u);
+}
+
+TEST (PackedAutomationPointsTest, FlattenAndFlipVertical)
+{
+  auto points = make_points ();
+  points.flatten ();
+  for (size_t i = 0; i < points.size (); ++i)
+    {
+      EXPECT_DOUBLE_EQ (points.curviness_[i], 1.0);
+      EXPECT_EQ (points.get_curve (i).algo_, CurveOptions::Algorithm::Pulse);
+    }
+
+  points = make_points ();
+  points.flip_vertical ();
+  EXPECT_FLOAT_EQ (points.values_[0], 0.8f);
+  EXPECT_FLOAT_EQ (points.values_[3], 0.9f);
+  EXPECT_DOUBLE_EQ (points.curviness_[1], 0.3);
+}
+
+TEST (PackedAutomationPointsTest, FlipHorizontal)
+{
+  auto points = make_points ();
+  points.flip_horizontal ();
+  EXPECT_EQ (
+    points.pos_ticks_, (std::vector<double>{ 400.0, 300.0, 250.0, 0.0 }));
+
+  /* values stay with their points */
+  EXPECT_FLOAT_EQ (points.values_[1], 0.8f);
+
+  /* the curve of the first segment (0 -> 1) now belongs to point 1 */
+  EXPECT_DOUBLE_EQ (points.curviness_[1], -0.5);
+  EXPECT_EQ (points.get_curve (1).algo_, CurveOptions::Algorithm::Exponent);
+  EXPECT_EQ (points.get_curve (2).algo_, CurveOptions::Algorithm::Vital);
+  EXPECT_DOUBLE_EQ (points.curviness_[2], 0.3);
+
+  /* the old first point takes the trailing curve */
+  EXPECT_EQ (points.get_curve (0).algo_, CurveOptions::Algorithm::Pulse);
+  EXPECT_DOUBLE_EQ (points.curviness_[0], 0.1);
+}
+
+TEST (PackedAutomationPointsTest, SmoothAndScale)
+{
+  auto points = make_points ();
+  points.smooth (1);
+  EXPECT_FLOAT_EQ (points.values_[0], 0.5f);
+  EXPECT_FLOAT_EQ (points.values_[1], 0.5f);
+  EXPECT_FLOAT_EQ (points.values_[2], 1.4f / 3.f);
+  EXPECT_FLOAT_EQ (points.values_[3], 0.3f);
+
+  points = make_points ();
+  points.scale_values (2.f, 0.5f);
+  EXPECT_FLOAT_EQ (points.values_[0], 0.f);
+  EXPECT_FLOAT_EQ (points.values_[1], 1.f);
+  EXPECT_FLOAT_EQ (points.values_[2], 0.5f);
+  EXPECT_FLOAT_EQ (points.values_[3], 0.f);
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,155 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <vector>
+
+#include "dsp/packed_notes.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+PackedNotes
+make_notes ()
+{
+  PackedNotes notes;
+  notes.push_back (10.0, 100.0, 60, 90);
+  notes.push_back (250.0, 300.0, 64, 80);
+  notes.push_back (95.0, 150.0, 67, 70);
+  return notes;
+}
+}
+
+TEST (PackedNotesTest, ChangedIndicesAndSelect)
+{
+  const auto before = make_notes ();
+  auto       after = before;
+  EXPECT_TRUE (before.get_changed_indices (after).empty ());
+
+  after.pitches_[2] = 70;
+  after.end_ticks_[0] = 120.0;
+  const auto changed = before.get_changed_indices (after);
+  EXPECT_EQ (changed, (std::vector<size_t>{ 0, 2 }));
+
+  const auto selected = after.select (changed);
+  ASSERT_EQ (selected.size (), 2u);
+  EXPECT_DOUBLE_EQ (selected.end_ticks_[0], 120.0);
+  EXPECT_EQ (selected.pitches_[1], 70);
+
+  PackedNotes appended;
+  appended.append (selected);
+  appended.append (selected);
+  EXPECT_EQ (appended.size (), 4u);
+}
+
+TEST (PackedNotesTest, Quantize)
+{
+  auto                      notes = make_notes ();
+  const std::vector<double> points{ 0.0, 96.0, 192.0, 288.0 };
+  notes.quantize (points, 1.0, true, false, 0.0, 0);
+  EXPECT_DOUBLE_EQ (notes.start_ticks_[0], 0.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[0], 90.0);
+  EXPECT_DOUBLE_EQ (notes.start_ticks_[1], 288.0);
+  EXPECT_DOUBLE_EQ (notes.start_ticks_[2], 96.0);
+
+  /* half the amount, ends only, relative to an offset */
+  notes = make_notes ();
+  notes.offset_ticks_ = 2.0;
+  notes.quantize (points, 0.5, false, true, 0.0, 0);
+  EXPECT_DOUBLE_EQ (notes.start_ticks_[0], 10.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[0], 97.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[1], 293.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[2], 170.0);
+
+  /* randomization stays within range */
+  notes = make_notes ();
+  notes.quantize (points, 1.0, true, false, 5.0, 42);
+  EXPECT_NEAR (notes.start_ticks_[0], 0.0, 5.0);
+  EXPECT_NEAR (notes.start_ticks_[1], 288.0, 5.0);
+}
+
+TEST (PackedNotesTest, TransposeAndHumanize)
+{
+  auto notes = make_notes ();
+  notes.transpose (70);
+  EXPECT_EQ (notes.pitches_, (std::vector<uint8_t>{ 127, 127, 127 }));
+  notes.transpose (-200);
+  EXPECT_EQ (notes.pitches_, (std::vector<uint8_t>{ 0, 0, 0 }));
+
+  notes = make_notes ();
+  notes.humanize_velocities (10, 1);
+  for (size_t i = 0; i < notes.size (); ++i)
+    {
+      EXPECT_NEAR (notes.velocities_[i], make_notes ().velocities_[i], 10);
+    }
+}
+
+TEST (PackedNotesTest, FlipVertical)
+{
+  auto       notes = make_notes ();
+  const auto [lowest, highest] = notes.get_pitch_range ();
+  EXPECT_EQ (lowest, 60);
+  EXPECT_EQ (highest, 67);
+  notes.flip_vertical (lowest, highest);
+  EXPECT_EQ (notes.pitches_, (std::vector<uint8_t>{ 67, 63, 60 }));
+}
+
+TEST (PackedNotesTest, FlipHorizontal)
+{
+  auto notes = make_notes ();
+  notes.flip_horizontal ();
+
+  /* starts in reverse order, same lengths */
+  EXPECT_DOUBLE_EQ (notes.start_ticks_[0], 250.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[0], 340.0);
+  EXPECT_DOUBLE_EQ (notes.start_ticks_[2], 95.0);
+  EXPECT_DOUBLE_EQ (notes.start_ticks_[1], 10.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[1], 60.0);
+}
+
+TEST (PackedNotesTest, ConnectToNext)
+{
+  auto notes = make_notes ();
+  notes.connect_to_next (0.0, 20.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[0], 95.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[2], 250.0);
+
+  /* the last note is not changed */
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[1], 300.0);
+
+  /* gaps too large for the note fall back to the next start */
+  notes = make_notes ();
+  notes.connect_to_next (90.0, 20.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[0], 115.0);
+  EXPECT_DOUBLE_EQ (notes.end_ticks_[2], 160.0);
+}
+
+TEST (PackedNotesTest, SetLengths)
+{
+  auto notes = make_notes ();
+  notes.set_lengths (30.0);
+  for (size_t i = 0; i < notes.size (); ++i)
+    {
+      EXPECT_DOUBLE_EQ (notes.end_ticks_[i] - notes.start_ticks_[i], 30.0);
+    }
+  notes.set_lengths (0.0);
+  EXPECT_DOUBLE_EQ (
+    notes.end_ticks_[0] - notes.start_ticks_[0], PackedNotes::MIN_LENGTH_TICKS);
+}
+
+TEST (PackedNotesTest, RampVelocities)
+{
+  auto               notes = make_notes ();
+  const CurveOptions curve (0.0, CurveOptions::Algorithm::SuperEllipse);
+  const auto [first, last] = notes.get_start_range ();
+  EXPECT_DOUBLE_EQ (first, 10.0);
+  EXPECT_DOUBLE_EQ (last, 250.0);
+  notes.ramp_velocities (first, last, 20, 100, curve);
+  EXPECT_EQ (notes.velocities_[0], 20);
+  EXPECT_EQ (notes.velocities_[1], 100);
+  EXPECT_GT (notes.velocities_[2], 20);
+  EXPECT_LT (notes.velocities_[2], 100);
+}
+}
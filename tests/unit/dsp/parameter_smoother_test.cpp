@@ -0,0 +1,110 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <vector>
+
+#include "dsp/parameter_smoother.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+TEST (ParameterSmootherTest, FirstTargetIsJumpedTo)
+{
+  ParameterSmoother smoother;
+  smoother.set_ramp_length (100);
+  smoother.set_target (0.5f);
+  EXPECT_FALSE (smoother.is_smoothing ());
+  EXPECT_FLOAT_EQ (smoother.get_current_value (), 0.5f);
+
+  std::vector<float> buf (10, 1.f);
+  smoother.apply_gain (buf.data (), buf.size ());
+  for (const auto val : buf)
+    {
+      EXPECT_FLOAT_EQ (val, 0.5f);
+    }
+}
+
+TEST (ParameterSmootherTest, LinearRamp)
+{
+  ParameterSmoother smoother;
+  smoother.reset (0.f);
+  smoother.set_ramp_length (100);
+  smoother.set_target (1.f);
+  EXPECT_TRUE (smoother.is_smoothing ());
+
+  // ramp across several calls and chunks, then hold the target
+  std::vector<float> buf (150, 1.f);
+  smoother.apply_gain (buf.data (), 30);
+  smoother.apply_gain (&buf[30], 120);
+  for (size_t i = 0; i < 100; i++)
+    {
+      EXPECT_NEAR (buf[i], static_cast<float> (i + 1) / 100.f, 1e-5f);
+    }
+  for (size_t i = 100; i < buf.size (); i++)
+    {
+      EXPECT_FLOAT_EQ (buf[i], 1.f);
+    }
+  EXPECT_FALSE (smoother.is_smoothing ());
+  EXPECT_FLOAT_EQ (smoother.get_current_value (), 1.f);
+}
+
+TEST (ParameterSmootherTest, ExponentialRamp)
+{
+  ParameterSmoother smoother (ParameterSmoother::Mode::Exponential);
+  smoother.reset (0.25f);
+  smoother.set_ramp_length (80);
+  smoother.set_target (1.f);
+
+  std::vector<float> buf (80, 1.f);
+  smoother.apply_gain (buf.data (), buf.size ());
+  for (size_t i = 1; i < buf.size (); i++)
+    {
+      // constant ratio between consecutive frames
+      EXPECT_NEAR (buf[i] / buf[i - 1], buf[1] / buf[0], 1e-4f);
+    }
+  EXPECT_NEAR (buf.back (), 1.f, 1e-4f);
+  EXPECT_FLOAT_EQ (smoother.get_current_value (), 1.f);
+
+  // ramps to 0 are linear
+  smoother.set_target (0.f);
+  smoother.apply_gain (buf.data (), 40);
+  EXPECT_NEAR (buf[0] - buf[1], buf[1] - buf[2], 1e-4f);
+}
+
+TEST (ParameterSmootherTest, MixProduct)
+{
+  ParameterSmoother smoother;
+  smoother.reset (1.f);
+  smoother.set_ramp_length (4);
+  smoother.set_target (0.f);
+
+  std::vector<float> src (6, 2.f);
+  std::vector<float> dest (6, 1.f);
+  smoother.mix_product (dest.data (), src.data (), dest.size ());
+  const std::vector<float> expected = { 2.5f, 2.f, 1.5f, 1.f, 1.f, 1.f };
+  for (size_t i = 0; i < dest.size (); i++)
+    {
+      EXPECT_FLOAT_EQ (dest[i], expected[i]);
+    }
+}
+
+TEST (ParameterSmootherTest, FillValues)
+{
+  ParameterSmoother smoother;
+  smoother.reset (0.f);
+  smoother.set_ramp_length (4);
+  smoother.set_target (1.f);
+
+  std::vector<float> values (6);
+  smoother.fill_values (values.data (), 3);
+  smoother.fill_values (&values[3], 3);
+  const std::vector<float> expected = { 0.25f, 0.5f, 0.75f, 1.f, 1.f, 1.f };
+  for (size_t i = 0; i < values.size (); i++)
+    {
+      EXPECT_FLOAT_EQ (values[i], expected[i]);
+    }
+  EXPECT_FALSE (smoother.is_smoothing ());
+}
+
+} // namespace zrythm::dsp
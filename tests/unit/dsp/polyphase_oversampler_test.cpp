@@ -0,0 +1,100 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "dsp/polyphase_oversampler.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+class PolyphaseOversamplerTest : public ::testing::Test
+{
+protected:
+  static constexpr size_t BLOCK_LENGTH = 256;
+  static constexpr auto   FACTOR = PolyphaseOversampler::FACTOR;
+
+  void SetUp () override { oversampler_.init (2, BLOCK_LENGTH); }
+
+  /**
+   * @brief Oversamples @p in (one vector per channel) in blocks.
+   */
+  std::vector<std::vector<float>>
+  oversample (const std::vector<std::vector<float>> &in)
+  {
+    std::vector<std::vector<float>> out (in.size ());
+    for (auto &buf : out)
+      buf.resize (in.front ().size () * FACTOR);
+
+    for (size_t offset = 0; offset < in.front ().size ();
+         offset += BLOCK_LENGTH)
+      {
+        std::vector<const float *> in_ptrs;
+        std::vector<float *>       out_ptrs;
+        for (size_t ch = 0; ch < in.size (); ch++)
+          {
+            in_ptrs.push_back (&in[ch][offset]);
+            out_ptrs.push_back (&out[ch][offset * FACTOR]);
+          }
+        oversampler_.process (
+          in_ptrs.data (), out_ptrs.data (),
+          std::min (BLOCK_LENGTH, in.front ().size () - offset));
+      }
+    return out;
+  }
+
+  PolyphaseOversampler oversampler_;
+};
+
+TEST_F (PolyphaseOversamplerTest, PassesDc)
+{
+  const auto out =
+    oversample ({ std::vector (1024, 0.5f), std::vector (1024, -1.f) });
+  for (size_t i = BLOCK_LENGTH * FACTOR; i < out[0].size (); i++)
+    {
+      EXPECT_NEAR (out[0][i], 0.5f, 1e-5f);
+      EXPECT_NEAR (out[1][i], -1.f, 1e-5f);
+    }
+}
+
+TEST_F (PolyphaseOversamplerTest, InterpolatesSine)
+{
+  /* fs/4 sine sampled at +-45 degrees: the sample peak is 0.707 but the true
+   * peak is 1 */
+  std::vector<float> signal (1024);
+  for (size_t i = 0; i < signal.size (); i++)
+    {
+      signal[i] = static_cast<float> (std::sin (
+        std::numbers::pi / 2.0 * static_cast<double> (i)
+        + std::numbers::pi / 4.0));
+    }
+  const auto out = oversample ({ signal, signal });
+
+  float peak = 0.f;
+  for (size_t i = BLOCK_LENGTH * FACTOR; i < out[0].size (); i++)
+    {
+      peak = std::max (peak, std::abs (out[0][i]));
+      EXPECT_FLOAT_EQ (out[0][i], out[1][i]);
+    }
+  EXPECT_NEAR (peak, 1.f, 0.02f);
+}
+
+TEST_F (PolyphaseOversamplerTest, ResetClearsHistory)
+{
+  oversample ({ std::vector (64, 1.f), std::vector (64, 1.f) });
+  oversampler_.reset ();
+  const auto out =
+    oversample ({ std::vector (64, 0.f), std::vector (64, 0.f) });
+  for (const auto &buf : out)
+    {
+      for (const auto val : buf)
+        {
+          EXPECT_FLOAT_EQ (val, 0.f);
+        }
+    }
+}
+
+} // namespace zrythm::dsp
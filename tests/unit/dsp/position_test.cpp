@@ -1,6 +1,8 @@
 // SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
 // SPDX-License-Identifier: LicenseRef-ZrythmLicense
 
+#include <vector>
+
 #include "dsp/position.h"
 #include "utils/gtest_wrapper.h"
 
@@ -170,3 +172,34 @@ TEST_F (PositionTest, Serialization)
   EXPECT_EQ (pos1.ticks_, pos2.ticks_);
   EXPECT_EQ (pos1.frames_, pos2.frames_);
 }
+
+TEST_F (PositionTest, BatchConversion)
+{
+  std::vector<Position>   positions;
+  std::vector<Position *> position_ptrs;
+  for (int i = -50; i < 200; ++i)
+    {
+      positions.emplace_back (i * 37.3, frames_per_tick_);
+    }
+  for (auto &pos : positions)
+    {
+      position_ptrs.push_back (&pos);
+    }
+
+  /* frames from ticks, with a new tempo */
+  const double new_frames_per_tick = frames_per_tick_ * 1.7;
+  Position::update (position_ptrs, true, new_frames_per_tick);
+  for (const auto &pos : positions)
+    {
+      EXPECT_EQ (
+        pos.frames_,
+        Position::get_frames_from_ticks (pos.ticks_, new_frames_per_tick));
+    }
+
+  /* ticks from frames */
+  Position::update (position_ptrs, false, ticks_per_frame_);
+  for (const auto &pos : positions)
+    {
+      EXPECT_DOUBLE_EQ (pos.ticks_, (double) pos.frames_ * ticks_per_frame_);
+    }
+}
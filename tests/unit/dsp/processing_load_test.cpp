@@ -0,0 +1,64 @@
+#include "dsp/processing_load.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+TEST (ProcessingLoadTest, Empty)
+{
+  ProcessingLoad load;
+  EXPECT_FLOAT_EQ (load.get_load (), 0.f);
+
+  /* invalid blocks are ignored */
+  load.record (1000, 0, 48000);
+  load.record (1000, 256, 0);
+  EXPECT_FLOAT_EQ (load.get_load (), 0.f);
+}
+
+TEST (ProcessingLoadTest, ConvergesToBlockLoad)
+{
+  ProcessingLoad load;
+
+  /* 256 frames at 48 kHz last ~5.33 ms; spend a quarter of that */
+  constexpr uint32_t nframes = 256;
+  constexpr uint32_t sample_rate = 48000;
+  constexpr uint64_t block_ns = (1'000'000'000ULL * nframes) / sample_rate;
+  for (int i = 0; i < 2000; ++i)
+    {
+      load.record (block_ns / 4, nframes, sample_rate);
+    }
+  EXPECT_NEAR (load.get_load (), 0.25f, 0.001f);
+
+  /* the load decays when the processor stops doing work */
+  for (int i = 0; i < 2000; ++i)
+    {
+      load.record (0, nframes, sample_rate);
+    }
+  EXPECT_NEAR (load.get_load (), 0.f, 0.001f);
+
+  load.record (block_ns, nframes, sample_rate);
+  load.reset ();
+  EXPECT_FLOAT_EQ (load.get_load (), 0.f);
+}
+
+TEST (ProcessingLoadTest, IndependentOfBlockSize)
+{
+  ProcessingLoad small_blocks;
+  ProcessingLoad large_blocks;
+  constexpr uint32_t sample_rate = 48000;
+
+  /* same wall time (~0.1 s) at half load with different block sizes */
+  for (int i = 0; i < 75; ++i)
+    {
+      small_blocks.record (
+        (1'000'000'000ULL * 64) / sample_rate / 2, 64, sample_rate);
+    }
+  for (int i = 0; i < 5; ++i)
+    {
+      large_blocks.record (
+        (1'000'000'000ULL * 960) / sample_rate / 2, 960, sample_rate);
+    }
+  EXPECT_NEAR (small_blocks.get_load (), large_blocks.get_load (), 0.001f);
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "dsp/quality_governor.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+constexpr int64_t CYCLE_US = 10'000;
+
+TEST (QualityGovernorTest, ReducesAndRestoresWithHysteresis)
+{
+  QualityGovernor governor;
+  int64_t         now = 0;
+
+  /* a single spike doesn't reduce quality */
+  EXPECT_FALSE (governor.record_cycle (100.0, false, false, now));
+  EXPECT_FALSE (governor.is_reduced ());
+
+  /* sustained high load does */
+  bool changed = false;
+  for (int i = 0; i < 100 && !changed; ++i)
+    {
+      now += CYCLE_US;
+      changed = governor.record_cycle (95.0, false, false, now);
+    }
+  EXPECT_TRUE (changed);
+  EXPECT_TRUE (governor.is_reduced ());
+  EXPECT_GT (governor.get_smoothed_load (), 85.0);
+
+  /* load in between the thresholds keeps the reduced quality */
+  for (int i = 0; i < 1000; ++i)
+    {
+      now += CYCLE_US;
+      EXPECT_FALSE (governor.record_cycle (70.0, false, false, now));
+    }
+  EXPECT_TRUE (governor.is_reduced ());
+
+  /* low load restores quality, but only after a while */
+  int64_t restored_at = -1;
+  for (int i = 0; i < 1000 && restored_at < 0; ++i)
+    {
+      now += CYCLE_US;
+      if (governor.record_cycle (10.0, false, false, now))
+        restored_at = now;
+    }
+  EXPECT_FALSE (governor.is_reduced ());
+  EXPECT_GE (restored_at, 3'000'000);
+}
+
+TEST (QualityGovernorTest, XrunReducesImmediately)
+{
+  QualityGovernor governor;
+  EXPECT_TRUE (governor.record_cycle (20.0, true, false, 0));
+  EXPECT_TRUE (governor.is_reduced ());
+}
+
+TEST (QualityGovernorTest, OfflineUsesFullQuality)
+{
+  QualityGovernor governor;
+  governor.record_cycle (20.0, true, false, 0);
+  ASSERT_TRUE (governor.is_reduced ());
+
+  EXPECT_TRUE (governor.record_cycle (500.0, true, true, CYCLE_US));
+  EXPECT_FALSE (governor.is_reduced ());
+  EXPECT_FALSE (governor.record_cycle (500.0, true, true, 2 * CYCLE_US));
+  EXPECT_FALSE (governor.is_reduced ());
+}
+
+} // namespace zrythm::dsp
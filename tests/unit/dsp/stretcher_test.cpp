@@ -125,3 +125,42 @@ TEST_F (StretcherTest, RealtimeProcessing)
 
   EXPECT_GT (frames_processed, 0);
 }
+
+TEST_F (StretcherTest, SegmentedStretching)
+{
+  /* long enough to be stretched in segments */
+  constexpr unsigned samplerate = 8000;
+  const auto         num_frames = static_cast<size_t> (
+    (Stretcher::MIN_SEGMENTED_LENGTH_SECONDS + 5) * samplerate);
+  constexpr double   ratio = 1.25;
+  auto               stretcher =
+    Stretcher::create_rubberband (samplerate, 1, ratio, pitch_ratio_, false);
+  ASSERT_NE (stretcher, nullptr);
+
+  zrythm::utils::audio::AudioBuffer in (1, static_cast<int> (num_frames));
+  for (size_t i = 0; i < num_frames; i++)
+    {
+      in.setSample (
+        0, static_cast<int> (i),
+        0.5f * std::sin (2.0f * M_PI * 220.0f * i / samplerate));
+    }
+
+  auto out = stretcher->stretch_interleaved (in);
+  EXPECT_NEAR (out.getNumSamples (), num_frames * ratio, 1);
+
+  /* the level stays the same across the seams */
+  const auto *     samples = out.getReadPointer (0);
+  constexpr size_t window = samplerate / 10;
+  for (
+    size_t start = samplerate;
+    start + window < static_cast<size_t> (out.getNumSamples ()) - samplerate;
+    start += window)
+    {
+      float peak = 0.f;
+      for (size_t i = start; i < start + window; i++)
+        {
+          peak = std::max (peak, std::abs (samples[i]));
+        }
+      EXPECT_NEAR (peak, 0.5f, 0.1f) << "at frame " << start;
+    }
+}
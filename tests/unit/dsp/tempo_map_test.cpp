@@ -0,0 +1,97 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <cmath>
+#include <vector>
+
+#include "dsp/tempo_map.h"
+#include "utils/gtest_wrapper.h"
+
+namespace zrythm::dsp
+{
+
+constexpr sample_rate_t SAMPLE_RATE = 48000;
+constexpr int           TICKS_PER_BEAT = 960;
+
+/* 120 BPM at 48 kHz: 0.5 seconds per beat */
+constexpr double FRAMES_PER_TICK_120 = 24000.0 / TICKS_PER_BEAT;
+
+TEST (TempoMapTest, ConstantTempo)
+{
+  TempoMap map;
+  map.set_constant_tempo (120.f, SAMPLE_RATE, TICKS_PER_BEAT);
+  ASSERT_EQ (map.get_segments ().size (), 1);
+  EXPECT_DOUBLE_EQ (map.ticks_to_frames (960.0), 24000.0);
+  EXPECT_DOUBLE_EQ (map.frames_to_ticks (24000.0), 960.0);
+  EXPECT_DOUBLE_EQ (
+    map.get_segment_at_ticks (1000.0).frames_per_tick_, FRAMES_PER_TICK_120);
+
+  /* negative positions use the first tempo */
+  EXPECT_DOUBLE_EQ (map.ticks_to_frames (-960.0), -24000.0);
+  EXPECT_DOUBLE_EQ (map.frames_to_ticks (-24000.0), -960.0);
+}
+
+TEST (TempoMapTest, TempoChanges)
+{
+  const std::vector<TempoMap::TempoChange> changes = {
+    { 0.0, 120.f },    // replaces the initial tempo
+    { 960.0, 60.f },   // 1 beat at 120 BPM: 24000 frames
+    { 1920.0, 60.f },  // no change
+    { 2880.0, 240.f }, // 2 beats at 60 BPM: 96000 frames
+  };
+  TempoMap map;
+  map.rebuild (100.f, changes, SAMPLE_RATE, TICKS_PER_BEAT);
+
+  const auto segments = map.get_segments ();
+  ASSERT_EQ (segments.size (), 3);
+  EXPECT_DOUBLE_EQ (segments[1].start_frames_, 24000.0);
+  EXPECT_DOUBLE_EQ (segments[2].start_frames_, 120000.0);
+
+  EXPECT_FLOAT_EQ (map.get_bpm_at_ticks (500.0), 120.f);
+  EXPECT_FLOAT_EQ (map.get_bpm_at_ticks (960.0), 60.f);
+  EXPECT_FLOAT_EQ (map.get_bpm_at_ticks (100000.0), 240.f);
+
+  EXPECT_DOUBLE_EQ (map.ticks_to_frames (1440.0), 48000.0);
+  EXPECT_DOUBLE_EQ (map.ticks_to_frames (3840.0), 132000.0);
+  EXPECT_DOUBLE_EQ (map.frames_to_ticks (48000.0), 1440.0);
+  EXPECT_DOUBLE_EQ (map.frames_to_ticks (132000.0), 3840.0);
+
+  for (double ticks = -100.0; ticks < 10000.0; ticks += 77.0)
+    {
+      EXPECT_NEAR (
+        map.frames_to_ticks (map.ticks_to_frames (ticks)), ticks, 1e-6);
+    }
+}
+
+TEST (TempoMapTest, BatchConversion)
+{
+  std::vector<TempoMap::TempoChange> changes;
+  for (int i = 1; i < 32; ++i)
+    {
+      changes.push_back (
+        { i * 480.0, static_cast<bpm_t> (i % 2 == 0 ? 90 : 150) });
+    }
+  TempoMap map;
+  map.rebuild (120.f, changes, SAMPLE_RATE, TICKS_PER_BEAT);
+
+  /* sorted positions, then unsorted ones */
+  std::vector<double> ticks;
+  for (double t = 0.0; t < 20000.0; t += 100.0)
+    ticks.push_back (t);
+  ticks.insert (ticks.end (), { 15000.0, 10.0, 7000.0, -50.0, 479.0 });
+
+  std::vector<signed_frame_t> frames (ticks.size ());
+  map.ticks_to_frames (ticks, frames);
+  std::vector<double> ticks_back (frames.size ());
+  map.frames_to_ticks (frames, ticks_back);
+  for (size_t i = 0; i < ticks.size (); ++i)
+    {
+      EXPECT_EQ (
+        frames[i], static_cast<signed_frame_t> (
+                     std::llround (map.ticks_to_frames (ticks[i]))));
+      EXPECT_DOUBLE_EQ (
+        ticks_back[i], map.frames_to_ticks (static_cast<double> (frames[i])));
+    }
+}
+
+} // namespace zrythm::dsp
@@ -0,0 +1,206 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+#include "dsp/timestretch_cache.h"
+#include "utils/gtest_wrapper.h"
+
+using namespace std::chrono_literals;
+
+namespace zrythm::dsp
+{
+
+namespace
+{
+
+constexpr sample_rate_t SAMPLERATE = 48000;
+constexpr int           NUM_FRAMES = 1000;
+
+TimestretchCache::Source
+make_source (int num_channels)
+{
+  auto frames =
+    std::make_shared<utils::audio::AudioBuffer> (num_channels, NUM_FRAMES);
+  for (int ch = 0; ch < num_channels; ch++)
+    {
+      for (int i = 0; i < NUM_FRAMES; i++)
+        {
+          frames->setSample (
+            ch, i, static_cast<float> (ch) + static_cast<float> (i) / 1000.f);
+        }
+    }
+  return frames;
+}
+
+/** Nearest-neighbour "stretching" (enough to verify the cache). */
+TimestretchCache::StretchFunc
+make_stretch_func (std::atomic<int> * num_stretches = nullptr)
+{
+  return [num_stretches] (
+           const utils::audio::AudioBuffer &source,
+           const TimestretchCache::Key     &key) {
+    if (num_stretches != nullptr)
+      {
+        (*num_stretches)++;
+      }
+    const auto num_frames = static_cast<int> (
+      std::round (static_cast<double> (source.getNumSamples ()) / key.ratio_));
+    utils::audio::AudioBuffer frames (source.getNumChannels (), num_frames);
+    for (int ch = 0; ch < source.getNumChannels (); ch++)
+      {
+        for (int i = 0; i < num_frames; i++)
+          {
+            const auto src_index = std::min (
+              static_cast<int> (i * key.ratio_), source.getNumSamples () - 1);
+            frames.setSample (ch, i, source.getSample (ch, src_index));
+          }
+      }
+    return frames;
+  };
+}
+
+TimestretchCache::Key
+make_key (double ratio, utils::hash::HashT hash = 1)
+{
+  return { hash, ratio, SAMPLERATE };
+}
+
+bool
+wait_until_rendered (
+  const TimestretchCache      &cache,
+  const TimestretchCache::Key &key)
+{
+  for (int i = 0; i < 2000; i++)
+    {
+      if (cache.get_num_frames (key))
+        return true;
+      std::this_thread::sleep_for (1ms);
+    }
+  return false;
+}
+
+} // namespace
+
+TEST (TimestretchCacheTest, RendersInBackground)
+{
+  TimestretchCache cache (make_stretch_func ());
+  const auto       source = make_source (2);
+  const auto       key = make_key (2.0);
+
+  std::vector<float> l (NUM_FRAMES / 2);
+  std::vector<float> r (NUM_FRAMES / 2);
+  EXPECT_FALSE (cache.get_num_frames (key));
+
+  cache.request (key, source);
+  ASSERT_TRUE (wait_until_rendered (cache, key));
+  EXPECT_EQ (*cache.get_num_frames (key), NUM_FRAMES / 2);
+
+  ASSERT_TRUE (cache.read (key, 0, l.data (), r.data (), l.size ()));
+  for (size_t i = 0; i < l.size (); i++)
+    {
+      EXPECT_FLOAT_EQ (l[i], source->getSample (0, static_cast<int> (i * 2)));
+      EXPECT_FLOAT_EQ (r[i], source->getSample (1, static_cast<int> (i * 2)));
+    }
+
+  // other ratios are separate entries
+  EXPECT_FALSE (cache.get_num_frames (make_key (0.5)));
+  EXPECT_FALSE (cache.read (make_key (0.5), 0, l.data (), r.data (), 16));
+  EXPECT_FLOAT_EQ (l[0], 0.f);
+}
+
+TEST (TimestretchCacheTest, MonoToStereoAndFramesPastEnd)
+{
+  TimestretchCache cache (make_stretch_func ());
+  const auto       source = make_source (1);
+  const auto       key = make_key (0.5);
+  cache.request (key, source);
+  ASSERT_TRUE (wait_until_rendered (cache, key));
+  ASSERT_EQ (*cache.get_num_frames (key), NUM_FRAMES * 2);
+
+  std::vector<float> l (16, 1.f);
+  std::vector<float> r (16, 1.f);
+  ASSERT_TRUE (
+    cache.read (key, NUM_FRAMES * 2 - 8, l.data (), r.data (), l.size ()));
+  for (size_t i = 0; i < 8; i++)
+    {
+      EXPECT_FLOAT_EQ (
+        l[i], source->getSample (0, NUM_FRAMES - 4 + static_cast<int> (i / 2)));
+      EXPECT_FLOAT_EQ (r[i], l[i]);
+    }
+  for (size_t i = 8; i < l.size (); i++)
+    {
+      EXPECT_FLOAT_EQ (l[i], 0.f);
+      EXPECT_FLOAT_EQ (r[i], 0.f);
+    }
+}
+
+TEST (TimestretchCacheTest, DuplicateRequestsRenderOnce)
+{
+  std::atomic<int> num_stretches = 0;
+  TimestretchCache cache (make_stretch_func (&num_stretches));
+  const auto       source = make_source (2);
+  const auto       key = make_key (1.5);
+  for (int i = 0; i < 3; i++)
+    {
+      cache.request (key, source);
+    }
+  ASSERT_TRUE (wait_until_rendered (cache, key));
+  cache.request (key, source);
+  std::this_thread::sleep_for (50ms);
+  EXPECT_EQ (num_stretches, 1);
+}
+
+TEST (TimestretchCacheTest, EvictsLeastRecentlyUsed)
+{
+  TimestretchCache cache (make_stretch_func (), 2);
+  const auto       source = make_source (2);
+  const auto       key_a = make_key (2.0, 1);
+  const auto       key_b = make_key (2.0, 2);
+  const auto       key_c = make_key (2.0, 3);
+
+  cache.request (key_a, source);
+  ASSERT_TRUE (wait_until_rendered (cache, key_a));
+  cache.request (key_b, source);
+  ASSERT_TRUE (wait_until_rendered (cache, key_b));
+
+  // use A so that B becomes the least recently used
+  std::vector<float> l (16);
+  std::vector<float> r (16);
+  EXPECT_TRUE (cache.read (key_a, 0, l.data (), r.data (), l.size ()));
+
+  cache.request (key_c, source);
+  ASSERT_TRUE (wait_until_rendered (cache, key_c));
+  EXPECT_TRUE (cache.get_num_frames (key_a));
+  EXPECT_FALSE (cache.get_num_frames (key_b));
+}
+
+TEST (TimestretchCacheTest, RespectsByteBudget)
+{
+  // room for a single stereo entry of NUM_FRAMES / 2 frames
+  constexpr size_t entry_bytes = 2 * (NUM_FRAMES / 2) * sizeof (float);
+  TimestretchCache cache (make_stretch_func (), 8, entry_bytes + 100);
+  const auto       source = make_source (2);
+  const auto       key_a = make_key (2.0, 1);
+  const auto       key_b = make_key (2.0, 2);
+
+  cache.request (key_a, source);
+  ASSERT_TRUE (wait_until_rendered (cache, key_a));
+  cache.request (key_b, source);
+  ASSERT_TRUE (wait_until_rendered (cache, key_b));
+  EXPECT_FALSE (cache.get_num_frames (key_a));
+
+  // entries larger than the budget are not cached
+  const auto key_large = make_key (0.25, 3);
+  cache.request (key_large, source);
+  std::this_thread::sleep_for (100ms);
+  EXPECT_FALSE (cache.get_num_frames (key_large));
+  EXPECT_TRUE (cache.get_num_frames (key_b));
+}
+
+} // namespace zrythm::dsp
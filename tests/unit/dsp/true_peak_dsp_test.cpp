@@ -128,4 +128,34 @@ TEST_F (TruePeakDspTest, DifferentSampleRates)
   EXPECT_GT (peak2, 0.0f);
 }
 
+TEST_F (TruePeakDspTest, MultipleChannels)
+{
+  std::vector<float> left (1024, 0.0f);
+  std::vector<float> right (1024, 0.0f);
+  for (size_t i = 0; i < left.size (); i++)
+    {
+      left[i] = 0.3f * std::sin (2.0f * M_PI * static_cast<float> (i) / 32.0f);
+      right[i] =
+        0.6f
+        * std::sin (2.0f * M_PI * static_cast<float> (i) / 4.0f + M_PI / 4.0f);
+    }
+
+  TruePeakDsp stereo_meter;
+  stereo_meter.init (SAMPLE_RATE, 2);
+  const std::array<const float *, 2> channels{ left.data (), right.data () };
+  stereo_meter.process (channels.data (), left.size ());
+  auto [stereo_rms, stereo_peak] = stereo_meter.read ();
+
+  // The readings are the maximum of the readings of each channel
+  TruePeakDsp right_meter;
+  right_meter.init (SAMPLE_RATE);
+  right_meter.process (right.data (), right.size ());
+  auto [right_rms, right_peak] = right_meter.read ();
+  EXPECT_NEAR (stereo_rms, right_rms, EPSILON);
+  EXPECT_NEAR (stereo_peak, right_peak, EPSILON);
+
+  // The fs/4 sine is sampled at 0.6 * sqrt (0.5) but peaks at 0.6
+  EXPECT_GT (stereo_peak, 0.58f);
+}
+
 } // namespace zrythm::dsp
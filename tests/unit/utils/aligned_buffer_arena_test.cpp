@@ -0,0 +1,64 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cstdint>
+
+#include "utils/aligned_buffer_arena.h"
+#include "utils/gtest_wrapper.h"
+
+using namespace zrythm::utils;
+
+TEST (AlignedBufferArenaTest, SlicesAreAlignedAndContiguous)
+{
+  AlignedBufferArena arena;
+  arena.allocate (3, 100);
+  EXPECT_EQ (arena.get_num_slices (), 3);
+  EXPECT_EQ (arena.get_slice_size (), 100);
+  EXPECT_EQ (arena.get_stride (), 112);
+
+  for (size_t i = 0; i < arena.get_num_slices (); ++i)
+    {
+      const auto slice = arena.get_slice (i);
+      EXPECT_EQ (slice.size (), 100);
+      EXPECT_EQ (
+        reinterpret_cast<std::uintptr_t> (slice.data ())
+          % AlignedBufferArena::ALIGNMENT,
+        0);
+      EXPECT_TRUE (std::ranges::all_of (slice, [] (float f) {
+        return f == 0.f;
+      }));
+      EXPECT_EQ (slice.data (), arena.get_slice (0).data () + i * 112);
+    }
+}
+
+TEST (AlignedBufferArenaTest, StorageOutlivesReallocation)
+{
+  AlignedBufferArena arena;
+  arena.allocate (2, 16);
+  auto       storage = arena.get_storage ();
+  const auto slice = arena.get_slice (1);
+  slice[0] = 1.f;
+
+  arena.allocate (4, 32);
+  EXPECT_NE (arena.get_storage (), storage);
+  EXPECT_EQ (storage.use_count (), 1);
+  EXPECT_EQ (slice[0], 1.f);
+}
+
+TEST (AlignedBufferArenaTest, Empty)
+{
+  AlignedBufferArena arena;
+  arena.allocate (0, 64);
+  EXPECT_NE (arena.get_storage (), nullptr);
+  EXPECT_EQ (arena.get_num_slices (), 0);
+}
+
+TEST (AlignedBufferArenaTest, BindSlicesToNumaNode)
+{
+  AlignedBufferArena arena;
+  arena.allocate (4, 16);
+  EXPECT_FALSE (arena.bind_slices_to_numa_node (0, 0, 0));
+  EXPECT_FALSE (arena.bind_slices_to_numa_node (2, 3, 0));
+  EXPECT_FALSE (arena.bind_slices_to_numa_node (0, 4, -1));
+}
@@ -1,5 +1,8 @@
+#include <fstream>
+
 #include "utils/audio_file.h"
 #include "utils/gtest_wrapper.h"
+#include "utils/io.h"
 
 using namespace zrythm::utils::audio;
 
@@ -64,4 +67,68 @@ TEST (AudioFileTest, ReadFullWithResampling)
   size_t target_samplerate = metadata.samplerate * 2;
   file.read_full (buffer, target_samplerate);
   EXPECT_EQ (buffer.getNumChannels (), metadata.channels);
+  EXPECT_NEAR (buffer.getNumSamples (), metadata.num_frames * 2, 2);
+}
+
+TEST (AudioFileTest, ReadResampledInChunks)
+{
+  AudioFile file (TEST_WAV_FILE_PATH, false);
+  auto      metadata = file.read_metadata ();
+
+  constexpr size_t chunk_frames = 1000;
+  size_t           total_frames = 0;
+  file.read_resampled (
+    metadata.samplerate / 2,
+    [&] (const float * const *, size_t num_channels, size_t num_frames) {
+      EXPECT_EQ (num_channels, static_cast<size_t> (metadata.channels));
+      EXPECT_LE (num_frames, chunk_frames);
+      total_frames += num_frames;
+    },
+    Resampler::Quality::Quick, chunk_frames);
+  EXPECT_NEAR (total_frames, metadata.num_frames / 2, 2);
+}
+
+TEST (AudioFileTest, RepairWavHeader)
+{
+  auto     tmp_dir = zrythm::utils::io::make_tmp_dir ();
+  fs::path path = fs::path (tmp_dir->path ().toStdString ()) / "recording.wav";
+
+  constexpr int num_frames = 1000;
+  {
+    zrythm::utils::audio::AudioBuffer buf (2, num_frames);
+    buf.clear ();
+    juce::WavAudioFormat format;
+    auto                 writer =
+      std::unique_ptr<juce::AudioFormatWriter> (format.createWriterFor (
+        new juce::FileOutputStream (juce::File (path.string ())), 48000, 2, 16,
+        {}, 0));
+    ASSERT_NE (writer, nullptr);
+    writer->writeFromAudioSampleBuffer (buf, 0, num_frames);
+  }
+  EXPECT_FALSE (AudioFile::repair_wav_header (path));
+
+  /* reset the sizes like a writer that never finalized the header, and add
+   * an incomplete frame */
+  {
+    std::fstream file (path, std::ios::in | std::ios::out | std::ios::binary);
+    std::string  contents (
+      (std::istreambuf_iterator<char> (file)),
+      std::istreambuf_iterator<char> ());
+    const auto data_pos = contents.find ("data");
+    ASSERT_NE (data_pos, std::string::npos);
+    const std::array<char, 4> zero{};
+    file.clear ();
+    file.seekp (static_cast<std::streamoff> (data_pos + 4));
+    file.write (zero.data (), zero.size ());
+    file.seekp (4);
+    file.write (zero.data (), zero.size ());
+    file.seekp (0, std::ios::end);
+    file.write (zero.data (), 1);
+  }
+
+  EXPECT_TRUE (AudioFile::repair_wav_header (path));
+  EXPECT_FALSE (AudioFile::repair_wav_header (path));
+
+  AudioFile file (path.string ());
+  EXPECT_EQ (file.read_metadata ().num_frames, num_frames);
 }
@@ -0,0 +1,195 @@
+#include "zrythm-config.h"
+
+#include <cmath>
+#include <numbers>
+#include <random>
+
+#include "utils/audio_fingerprint.h"
+#include "utils/gtest_wrapper.h"
+
+using namespace zrythm::utils::audio;
+
+namespace
+{
+AudioBuffer
+make_sine (int num_channels, float freq, double samplerate, int num_frames)
+{
+  AudioBuffer buf (num_channels, num_frames);
+  for (int ch = 0; ch < num_channels; ++ch)
+    {
+      for (int i = 0; i < num_frames; ++i)
+        {
+          buf.setSample (
+            ch, i,
+            0.5f
+              * static_cast<float> (std::sin (
+                2.0 * std::numbers::pi * freq * i / samplerate)));
+        }
+    }
+  return buf;
+}
+
+std::vector<uint32_t>
+make_random_chroma (unsigned seed)
+{
+  std::mt19937          gen (seed);
+  std::vector<uint32_t> ret (64);
+  for (auto &item : ret)
+    item = gen ();
+  return ret;
+}
+}
+
+TEST (AudioFingerprintTest, ExactMatch)
+{
+  const auto a = make_sine (2, 440.f, 44100.0, 4096);
+  auto       b = make_sine (2, 440.f, 44100.0, 4096);
+  const auto fp_a = AudioFingerprint::compute_exact (a);
+  EXPECT_TRUE (fp_a.is_exact_match (AudioFingerprint::compute_exact (b)));
+
+  b.setSample (1, 100, 0.f);
+  EXPECT_FALSE (fp_a.is_exact_match (AudioFingerprint::compute_exact (b)));
+
+  /* same frames, different layout */
+  const auto mono = make_sine (1, 440.f, 44100.0, 8192);
+  EXPECT_FALSE (fp_a.is_exact_match (AudioFingerprint::compute_exact (mono)));
+}
+
+TEST (AudioFingerprintTest, ChannelOrderMatters)
+{
+  auto a = make_sine (2, 440.f, 44100.0, 1024);
+  auto b = make_sine (2, 440.f, 44100.0, 1024);
+  a.clear (1, 0, 1024);
+  b.clear (0, 0, 1024);
+  EXPECT_FALSE (AudioFingerprint::compute_exact (a).is_exact_match (
+    AudioFingerprint::compute_exact (b)));
+}
+
+TEST (AudioFingerprintTest, NoSimilarityWithoutChroma)
+{
+  const AudioFingerprint a;
+  const AudioFingerprint b;
+  EXPECT_FLOAT_EQ (a.get_similarity (b), 0.f);
+}
+
+TEST (AudioFingerprintTest, SimilarityOfRawFingerprints)
+{
+  AudioFingerprint a;
+  a.chroma_ = make_random_chroma (1);
+
+  /* identical */
+  auto b = a;
+  EXPECT_FLOAT_EQ (a.get_similarity (b), 1.f);
+
+  /* shifted by a few items */
+  b.chroma_.erase (b.chroma_.begin (), b.chroma_.begin () + 3);
+  EXPECT_FLOAT_EQ (a.get_similarity (b), 1.f);
+
+  /* one bit of each item differs */
+  b = a;
+  for (auto &item : b.chroma_)
+    item ^= 1u;
+  EXPECT_FLOAT_EQ (a.get_similarity (b), 31.f / 32.f);
+
+  /* unrelated */
+  b.chroma_ = make_random_chroma (2);
+  EXPECT_LT (a.get_similarity (b), 0.6f);
+}
+
+TEST (AudioFingerprintIndexTest, FindExactMatches)
+{
+  AudioFingerprintIndex index;
+  const auto            sine = make_sine (2, 440.f, 44100.0, 4096);
+  const auto            other = make_sine (2, 880.f, 44100.0, 4096);
+  index.set (3, 1, AudioFingerprint::compute_exact (sine));
+  index.set (1, 1, AudioFingerprint::compute_exact (sine));
+  index.set (2, 1, AudioFingerprint::compute_exact (other));
+  index.set (0, 5, AudioFingerprint::compute_exact (sine));
+
+  EXPECT_EQ (index.find_exact_matches (3), (std::vector<int64_t>{ 0, 1 }));
+  EXPECT_TRUE (index.find_exact_matches (2).empty ());
+  EXPECT_TRUE (index.find_exact_matches (42).empty ());
+  EXPECT_EQ (index.get_version (0), 5u);
+  EXPECT_FALSE (index.get_version (42).has_value ());
+
+  index.remove (1);
+  EXPECT_EQ (index.find_exact_matches (3), (std::vector<int64_t>{ 0 }));
+
+  index.retain ({ 2, 3 });
+  EXPECT_EQ (index.size (), 2u);
+  EXPECT_TRUE (index.find_exact_matches (3).empty ());
+}
+
+TEST (AudioFingerprintIndexTest, IgnoresStaleChroma)
+{
+  AudioFingerprintIndex index;
+  index.set (0, 2, {});
+  index.set_chroma (0, 1, { 1, 2, 3 });
+  EXPECT_FALSE (index.has_chroma (0));
+  index.set_chroma (0, 2, { 1, 2, 3 });
+  EXPECT_TRUE (index.has_chroma (0));
+
+  /* unknown keys are not added */
+  index.set_chroma (1, 1, { 1, 2, 3 });
+  EXPECT_EQ (index.size (), 1u);
+}
+
+TEST (AudioFingerprintIndexTest, FindSimilar)
+{
+  AudioFingerprintIndex index;
+  AudioFingerprint      a;
+  a.chroma_ = make_random_chroma (1);
+  a.content_hash_ = 1;
+  auto close = a;
+  close.content_hash_ = 2;
+  for (auto &item : close.chroma_)
+    item ^= 1u;
+  auto far = a;
+  far.content_hash_ = 3;
+  far.chroma_ = make_random_chroma (2);
+
+  index.set (0, 1, a);
+  index.set (1, 1, close);
+  index.set (2, 1, far);
+  index.set (3, 1, a);
+
+  /* exact matches are not included */
+  const auto similar = index.find_similar (0);
+  ASSERT_EQ (similar.size (), 1u);
+  EXPECT_EQ (similar[0].first, 1);
+  EXPECT_FLOAT_EQ (similar[0].second, 31.f / 32.f);
+}
+
+#if HAVE_CHROMAPRINT
+TEST (AudioFingerprintTest, ChromaSimilarity)
+{
+  constexpr double samplerate = 44100.0;
+  const int        num_frames = static_cast<int> (samplerate * 10);
+
+  /* a chord, and the same chord a bit quieter and in mono */
+  auto chord = make_sine (2, 261.63f, samplerate, num_frames);
+  for (const auto freq : { 329.63f, 392.f })
+    {
+      const auto note = make_sine (2, freq, samplerate, num_frames);
+      for (int ch = 0; ch < 2; ++ch)
+        chord.addFrom (ch, 0, note, ch, 0, num_frames);
+    }
+  chord.applyGain (0.5f);
+  AudioBuffer quieter (1, num_frames);
+  quieter.copyFrom (0, 0, chord, 0, 0, num_frames, 0.7f);
+
+  const auto different = make_sine (2, 1000.f, samplerate, num_frames);
+
+  AudioFingerprint a;
+  a.chroma_ = AudioFingerprint::compute_chroma (chord, samplerate);
+  AudioFingerprint b;
+  b.chroma_ = AudioFingerprint::compute_chroma (quieter, samplerate);
+  AudioFingerprint c;
+  c.chroma_ = AudioFingerprint::compute_chroma (different, samplerate);
+  ASSERT_FALSE (a.chroma_.empty ());
+
+  EXPECT_GE (
+    a.get_similarity (b), AudioFingerprintIndex::DEFAULT_MIN_SIMILARITY);
+  EXPECT_GT (a.get_similarity (b), a.get_similarity (c));
+}
+#endif
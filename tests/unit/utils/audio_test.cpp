@@ -50,15 +50,73 @@ TEST (AudioTest, FramesEmpty)
   EXPECT_FALSE (frames_empty (buf, 1024));
 }
 
-// TODO
-#if 0
+namespace
+{
+/** Returns a click (a short decaying tone) on every beat. */
+std::vector<float>
+make_click_track (float bpm, unsigned int samplerate, float seconds)
+{
+  std::vector<float> frames (static_cast<size_t> (seconds * samplerate), 0.f);
+  const auto         beat_frames = 60.0 * samplerate / bpm;
+  const auto click_frames = static_cast<size_t> (samplerate / 100);
+  for (double beat = 0.0; beat < static_cast<double> (frames.size ());
+       beat += beat_frames)
+    {
+      const auto start = static_cast<size_t> (beat);
+      for (size_t i = 0; i < click_frames && start + i < frames.size (); ++i)
+        {
+          const auto t =
+            static_cast<float> (i) / static_cast<float> (samplerate);
+          frames[start + i] = std::sin (2.f * 3.14159265f * 1000.f * t)
+                              * (1.f - static_cast<float> (i) / click_frames);
+        }
+    }
+  return frames;
+}
+}
+
 TEST (AudioTest, BpmDetection)
 {
   std::vector<float> candidates;
-  float              bpm = detect_bpm (nullptr, 0, 44100, candidates);
-  EXPECT_GE (bpm, 0.f);
+  for (const float bpm : { 90.f, 110.f, 128.f, 140.f })
+    {
+      const auto frames = make_click_track (bpm, 44100, 10.f);
+      EXPECT_NEAR (
+        detect_bpm (frames.data (), frames.size (), 44100, candidates), bpm,
+        1.f);
+      ASSERT_FALSE (candidates.empty ());
+      EXPECT_LE (candidates.size (), BpmDetector::MAX_CANDIDATES);
+    }
+
+  // too short or silent
+  const auto short_frames = make_click_track (120.f, 44100, 1.f);
+  EXPECT_EQ (
+    detect_bpm (short_frames.data (), short_frames.size (), 44100, candidates),
+    0.f);
+  EXPECT_TRUE (candidates.empty ());
+  const std::vector<float> silence (44100 * 10, 0.f);
+  EXPECT_EQ (
+    detect_bpm (silence.data (), silence.size (), 44100, candidates), 0.f);
+}
+
+TEST (AudioTest, BpmDetectionMixesDownChannels)
+{
+  // the beat is split across the channels, so neither channel alone has it
+  const auto  frames = make_click_track (120.f, 48000, 8.f);
+  const auto  beat_frames = static_cast<size_t> (48000 * 60 / 120);
+  std::vector left (frames);
+  std::vector right (frames);
+  for (size_t i = 0; i < frames.size (); ++i)
+    {
+      ((i / beat_frames) % 2 == 0 ? right : left)[i] = 0.f;
+    }
+
+  BpmDetector           detector (48000);
+  const float * const   channels[] = { left.data (), right.data () };
+  std::vector<float>    candidates;
+  detector.process (channels, 2, frames.size ());
+  EXPECT_NEAR (detector.detect (candidates), 120.f, 1.f);
 }
-#endif
 
 TEST (AudioTest, AudioFileSilence)
 {
@@ -0,0 +1,26 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "utils/backtrace.h"
+#include "utils/gtest_wrapper.h"
+
+using namespace zrythm::utils;
+
+TEST (RawBacktraceTest, CaptureAndClear)
+{
+  RawBacktrace bt;
+  EXPECT_TRUE (bt.empty ());
+  EXPECT_TRUE (bt.to_string ().empty ());
+
+  bt.capture ();
+  EXPECT_FALSE (bt.empty ());
+  EXPECT_LE (bt.get_addresses ().size (), RawBacktrace::MAX_DEPTH);
+  for (const auto * addr : bt.get_addresses ())
+    {
+      EXPECT_NE (addr, nullptr);
+    }
+  EXPECT_FALSE (bt.to_string ().empty ());
+
+  bt.clear ();
+  EXPECT_TRUE (bt.empty ());
+}
@@ -0,0 +1,97 @@
+#include "utils/binary_json.h"
+#include "utils/exceptions.h"
+#include "utils/gtest_wrapper.h"
+#include "utils/json.h"
+
+using namespace zrythm::utils;
+
+namespace
+{
+/* encodes the given JSON text and returns it decoded as JSON text */
+std::string
+round_trip (std::string_view json)
+{
+  yyjson_doc * doc =
+    yyjson_read (json.data (), json.size (), YYJSON_READ_NOFLAG);
+  EXPECT_NE (doc, nullptr);
+  yyjson_mut_doc * mut_doc = yyjson_doc_mut_copy (doc, nullptr);
+  yyjson_doc_free (doc);
+
+  auto binary = binary_json::write (mut_doc);
+  yyjson_mut_doc_free (mut_doc);
+  EXPECT_TRUE (binary_json::is_binary (binary));
+
+  yyjson_doc * decoded = binary_json::read (binary);
+  std::string  ret = json::get_string (yyjson_doc_get_root (decoded)).c_str ();
+  yyjson_doc_free (decoded);
+  return ret;
+}
+
+std::string
+to_pretty (std::string_view json)
+{
+  yyjson_doc * doc =
+    yyjson_read (json.data (), json.size (), YYJSON_READ_NOFLAG);
+  std::string ret = json::get_string (yyjson_doc_get_root (doc)).c_str ();
+  yyjson_doc_free (doc);
+  return ret;
+}
+}
+
+TEST (BinaryJsonTest, RoundTrip)
+{
+  constexpr std::string_view json =
+    R"({"a":null,"b":true,"c":false,"d":0,"e":18446744073709551615,)"
+    R"("f":-9223372036854775808,"g":-1,"h":3.25,"i":"",)"
+    R"("j":"text with \u0000 nul","k":[],"l":{},)"
+    R"("m":[{"x":1,"y":[1,2]},{"x":2,"y":[]},{"y":null,"x":3}],"a":1})";
+  EXPECT_EQ (round_trip (json), to_pretty (json));
+}
+
+TEST (BinaryJsonTest, InternsKeys)
+{
+  std::string json = "[";
+  for (int i = 0; i < 100; ++i)
+    {
+      json += R"({"aLongKeyName":1},)";
+    }
+  json.back () = ']';
+
+  yyjson_doc *     doc = yyjson_read (json.data (), json.size (), 0);
+  yyjson_mut_doc * mut_doc = yyjson_doc_mut_copy (doc, nullptr);
+  yyjson_doc_free (doc);
+  auto binary = binary_json::write (mut_doc);
+  yyjson_mut_doc_free (mut_doc);
+
+  /* the key is only stored once */
+  EXPECT_LT (binary.size (), 100 * 5 + 64);
+  EXPECT_EQ (round_trip (json), to_pretty (json));
+}
+
+TEST (BinaryJsonTest, InvalidData)
+{
+  EXPECT_FALSE (binary_json::is_binary ("{}"));
+  EXPECT_THROW (binary_json::read ("{}"), ZrythmException);
+
+  yyjson_mut_doc * mut_doc = yyjson_mut_doc_new (nullptr);
+  yyjson_mut_val * root = yyjson_mut_obj (mut_doc);
+  yyjson_mut_doc_set_root (mut_doc, root);
+  yyjson_mut_obj_add_str (mut_doc, root, "key", "value");
+  auto binary = binary_json::write (mut_doc);
+  yyjson_mut_doc_free (mut_doc);
+
+  /* truncated */
+  for (size_t i = 0; i < binary.size (); ++i)
+    {
+      EXPECT_THROW (
+        binary_json::read (std::string_view (binary).substr (0, i)),
+        ZrythmException);
+    }
+
+  /* trailing data */
+  EXPECT_THROW (binary_json::read (binary + '\0'), ZrythmException);
+
+  /* newer version */
+  binary[4] = static_cast<char> (binary_json::FORMAT_VERSION + 1);
+  EXPECT_THROW (binary_json::read (binary), ZrythmException);
+}
@@ -1,6 +1,11 @@
+#include <fstream>
+
 #include "utils/compression.h"
+#include "utils/exceptions.h"
 #include "utils/gtest_wrapper.h"
 
+#include <zstd.h>
+
 TEST (CompressionTest, CompressDecompress)
 {
   // Test basic compression/decompression
@@ -75,3 +80,113 @@ TEST (CompressionTest, CompressDecompress)
         .ends_with (",\"markerTrackVisibilityIndex\":0}}"));
   }
 }
+
+TEST (CompressionTest, StreamingFileCompressor)
+{
+  const auto path =
+    std::filesystem::temp_directory_path () / "streaming_compressor_test.zst";
+  std::filesystem::remove (path);
+
+  std::string original;
+  {
+    zrythm::utils::compression::StreamingFileCompressor compressor (
+      path, 3, 2);
+    for (int i = 0; i < 10000; ++i)
+      {
+        auto chunk = fmt::format ("chunk {}\n", i);
+        compressor.write (chunk);
+        original += chunk;
+      }
+
+    /* nothing is visible until finished */
+    EXPECT_FALSE (std::filesystem::exists (path));
+    compressor.finish ();
+    EXPECT_EQ (compressor.get_total_in (), original.size ());
+    EXPECT_LT (compressor.get_total_out (), original.size ());
+  }
+  ASSERT_TRUE (std::filesystem::exists (path));
+
+  std::ifstream     file (path, std::ios::binary);
+  const std::string compressed{
+    std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ()
+  };
+  file.close ();
+  EXPECT_EQ (
+    ZSTD_getFrameContentSize (compressed.data (), compressed.size ()),
+    ZSTD_CONTENTSIZE_UNKNOWN);
+
+  const auto decompressed =
+    zrythm::utils::compression::decompress_file (path);
+  EXPECT_EQ (decompressed, original);
+
+  std::filesystem::remove (path);
+}
+
+TEST (CompressionTest, StreamingFileCompressorDiscardsUnfinished)
+{
+  const auto path =
+    std::filesystem::temp_directory_path () / "streaming_compressor_test.zst";
+  std::filesystem::remove (path);
+  {
+    zrythm::utils::compression::StreamingFileCompressor compressor (path, 1);
+    compressor.write ("data");
+  }
+  EXPECT_FALSE (std::filesystem::exists (path));
+}
+
+TEST (CompressionTest, DecompressFile)
+{
+  const auto path =
+    std::filesystem::temp_directory_path () / "decompress_file_test.zst";
+  const auto write_file = [&] (const std::string &contents) {
+    std::ofstream file (path, std::ios::binary | std::ios::trunc);
+    file.write (
+      contents.data (), static_cast<std::streamsize> (contents.size ()));
+  };
+
+  /* frame with a known content size */
+  const std::string original (100000, 'X');
+  std::string       compressed (ZSTD_compressBound (original.size ()), '\0');
+  compressed.resize (ZSTD_compress (
+    compressed.data (), compressed.size (), original.data (), original.size (),
+    1));
+  write_file (compressed);
+  EXPECT_EQ (zrythm::utils::compression::decompress_file (path), original);
+
+  /* truncated */
+  write_file (compressed.substr (0, compressed.size () - 1));
+  EXPECT_THROW (
+    zrythm::utils::compression::decompress_file (path), ZrythmException);
+
+  /* not zstd */
+  write_file ("not zstd data");
+  EXPECT_THROW (
+    zrythm::utils::compression::decompress_file (path), ZrythmException);
+
+  /* empty */
+  write_file ({});
+  EXPECT_THROW (
+    zrythm::utils::compression::decompress_file (path), ZrythmException);
+
+  std::filesystem::remove (path);
+  EXPECT_THROW (
+    zrythm::utils::compression::decompress_file (path), ZrythmException);
+}
+
+TEST (CompressionTest, CompressBinary)
+{
+  std::string original (10000, '\0');
+  for (size_t i = 0; i < original.size (); ++i)
+    original[i] = static_cast<char> (i % 7);
+  const auto compressed = zrythm::utils::compression::compress (original);
+  EXPECT_LT (compressed.size (), original.size ());
+  EXPECT_EQ (zrythm::utils::compression::decompress (compressed), original);
+
+  EXPECT_EQ (
+    zrythm::utils::compression::decompress (
+      zrythm::utils::compression::compress ({})),
+    "");
+  EXPECT_THROW (
+    zrythm::utils::compression::decompress ("not zstd data"),
+    ZrythmException);
+}
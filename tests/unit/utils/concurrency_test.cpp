@@ -93,3 +93,44 @@ TEST (ConcurrencyTest, SemaphoreRAIIMultiThreaded)
 
   EXPECT_EQ (counter, num_iterations * 2);
 }
+
+TEST (ConcurrencyTest, AllOfIndicesInParallel)
+{
+  constexpr size_t              count = 1000;
+  std::vector<std::atomic<int>> visits (count);
+
+  EXPECT_TRUE (all_of_indices_in_parallel (count, 4, [&] (size_t index) {
+    visits[index]++;
+    return true;
+  }));
+  for (const auto &num_visits : visits)
+    {
+      EXPECT_EQ (num_visits, 1);
+    }
+
+  // No indices
+  EXPECT_TRUE (all_of_indices_in_parallel (0, 4, [] (size_t) {
+    ADD_FAILURE ();
+    return true;
+  }));
+}
+
+TEST (ConcurrencyTest, AllOfIndicesInParallelStopsEarly)
+{
+  constexpr size_t    count = 100000;
+  std::atomic<size_t> num_calls{ 0 };
+
+  EXPECT_FALSE (all_of_indices_in_parallel (count, 4, [&] (size_t index) {
+    num_calls++;
+    return index != 10;
+  }));
+  EXPECT_LT (num_calls, count);
+
+  // Single thread stops right away
+  num_calls = 0;
+  EXPECT_FALSE (all_of_indices_in_parallel (count, 1, [&] (size_t index) {
+    num_calls++;
+    return index != 10;
+  }));
+  EXPECT_EQ (num_calls, 11);
+}
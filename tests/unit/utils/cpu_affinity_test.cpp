@@ -0,0 +1,64 @@
+#include <algorithm>
+#include <array>
+
+#include "utils/cpu_affinity.h"
+#include "utils/gtest_wrapper.h"
+
+using namespace zrythm::utils::cpu;
+
+TEST (CpuAffinityTest, ParseCpuList)
+{
+  EXPECT_TRUE (parse_cpu_list ("").empty ());
+  EXPECT_TRUE (parse_cpu_list ("\n").empty ());
+  EXPECT_EQ (parse_cpu_list ("3"), (std::vector<int>{ 3 }));
+  EXPECT_EQ (parse_cpu_list ("0-3\n"), (std::vector<int>{ 0, 1, 2, 3 }));
+  EXPECT_EQ (
+    parse_cpu_list ("8,0-2,10-11"), (std::vector<int>{ 0, 1, 2, 8, 10, 11 }));
+
+  // duplicates are merged
+  EXPECT_EQ (parse_cpu_list ("1-2,2,1"), (std::vector<int>{ 1, 2 }));
+}
+
+TEST (CpuAffinityTest, ParseMalformedCpuList)
+{
+  EXPECT_TRUE (parse_cpu_list ("a").empty ());
+  EXPECT_TRUE (parse_cpu_list ("3-1").empty ());
+  EXPECT_TRUE (parse_cpu_list ("1,,2").empty ());
+  EXPECT_TRUE (parse_cpu_list ("-1").empty ());
+  EXPECT_TRUE (parse_cpu_list ("1-").empty ());
+}
+
+TEST (CpuAffinityTest, SetCurrentThreadAffinity)
+{
+  EXPECT_FALSE (set_current_thread_affinity ({}));
+}
+
+TEST (CpuAffinityTest, GetNumaNodeOfCpu)
+{
+  const std::vector<NumaNode> nodes{
+    { .id_ = 0, .cpus_ = { 0, 1, 4, 5 } },
+    { .id_ = 2, .cpus_ = { 2, 3, 6, 7 } },
+  };
+  EXPECT_EQ (get_numa_node_of_cpu (5, nodes), 0);
+  EXPECT_EQ (get_numa_node_of_cpu (6, nodes), 2);
+  EXPECT_EQ (get_numa_node_of_cpu (8, nodes), -1);
+  EXPECT_EQ (get_numa_node_of_cpu (0, {}), -1);
+}
+
+TEST (CpuAffinityTest, GetNumaNodes)
+{
+  const auto nodes = get_numa_nodes ();
+  EXPECT_TRUE (std::ranges::is_sorted (nodes, {}, &NumaNode::id_));
+  for (const auto &node : nodes)
+    {
+      EXPECT_FALSE (node.cpus_.empty ());
+    }
+}
+
+TEST (CpuAffinityTest, BindMemoryToNumaNode)
+{
+  // a range that contains no whole page is never bound
+  std::array<char, 16> small{};
+  EXPECT_FALSE (bind_memory_to_numa_node (small.data (), small.size (), 0));
+  EXPECT_FALSE (bind_memory_to_numa_node (small.data (), small.size (), -1));
+}
@@ -0,0 +1,108 @@
+#include <fstream>
+
+#include "utils/decoded_audio_cache.h"
+#include "utils/gtest_wrapper.h"
+#include "utils/io.h"
+
+using namespace zrythm::utils::audio;
+
+namespace
+{
+
+constexpr sample_rate_t              SAMPLERATE = 48000;
+constexpr zrythm::utils::hash::HashT SOURCE_HASH = 0x1234abcd;
+
+AudioBuffer
+make_test_frames (int num_channels, int num_frames)
+{
+  AudioBuffer frames (num_channels, num_frames);
+  for (int ch = 0; ch < num_channels; ++ch)
+    {
+      for (int i = 0; i < num_frames; ++i)
+        {
+          frames.setSample (
+            ch, i, static_cast<float> (ch) + static_cast<float> (i) / 1000.f);
+        }
+    }
+  return frames;
+}
+
+} // namespace
+
+TEST (DecodedAudioCacheTest, WriteAndOpen)
+{
+  auto     tmp_dir = zrythm::utils::io::make_tmp_dir ();
+  fs::path path =
+    fs::path (tmp_dir->path ().toStdString ()) / "decoded" / "clip.f32";
+
+  // odd number of frames to exercise channel padding
+  const auto frames = make_test_frames (2, 1001);
+  ASSERT_NO_THROW (
+    DecodedAudioCache::write (path, frames, SAMPLERATE, SOURCE_HASH));
+
+  auto cache = DecodedAudioCache::open (path, SAMPLERATE, SOURCE_HASH);
+  ASSERT_NE (cache, nullptr);
+  EXPECT_EQ (cache->get_num_channels (), 2);
+  EXPECT_EQ (cache->get_num_frames (), 1001);
+
+  const auto mapped_frames = cache->get_frames ();
+  ASSERT_EQ (mapped_frames.getNumChannels (), 2);
+  ASSERT_EQ (mapped_frames.getNumSamples (), 1001);
+  for (int ch = 0; ch < 2; ++ch)
+    {
+      // channels are aligned for SIMD
+      EXPECT_EQ (
+        reinterpret_cast<uintptr_t> (mapped_frames.getReadPointer (ch)) % 16,
+        0u);
+      for (int i = 0; i < 1001; ++i)
+        {
+          EXPECT_FLOAT_EQ (
+            mapped_frames.getSample (ch, i), frames.getSample (ch, i));
+        }
+    }
+}
+
+TEST (DecodedAudioCacheTest, StaleCacheIsIgnored)
+{
+  auto     tmp_dir = zrythm::utils::io::make_tmp_dir ();
+  fs::path path = fs::path (tmp_dir->path ().toStdString ()) / "clip.f32";
+  DecodedAudioCache::write (
+    path, make_test_frames (1, 64), SAMPLERATE, SOURCE_HASH);
+
+  EXPECT_EQ (DecodedAudioCache::open (path, 44100, SOURCE_HASH), nullptr);
+  EXPECT_EQ (
+    DecodedAudioCache::open (path, SAMPLERATE, SOURCE_HASH + 1), nullptr);
+  EXPECT_NE (DecodedAudioCache::open (path, SAMPLERATE, SOURCE_HASH), nullptr);
+
+  // overwriting replaces the previous cache
+  DecodedAudioCache::write (
+    path, make_test_frames (1, 64), SAMPLERATE, SOURCE_HASH + 1);
+  EXPECT_EQ (DecodedAudioCache::open (path, SAMPLERATE, SOURCE_HASH), nullptr);
+  EXPECT_NE (
+    DecodedAudioCache::open (path, SAMPLERATE, SOURCE_HASH + 1), nullptr);
+}
+
+TEST (DecodedAudioCacheTest, InvalidFilesAreIgnored)
+{
+  auto     tmp_dir = zrythm::utils::io::make_tmp_dir ();
+  fs::path dir = tmp_dir->path ().toStdString ();
+
+  EXPECT_EQ (
+    DecodedAudioCache::open (dir / "nonexistent.f32", SAMPLERATE, SOURCE_HASH),
+    nullptr);
+
+  {
+    std::ofstream garbage (dir / "garbage.f32");
+    garbage << "not a decoded audio cache";
+  }
+  EXPECT_EQ (
+    DecodedAudioCache::open (dir / "garbage.f32", SAMPLERATE, SOURCE_HASH),
+    nullptr);
+
+  // truncated file
+  const auto path = dir / "truncated.f32";
+  DecodedAudioCache::write (
+    path, make_test_frames (2, 4096), SAMPLERATE, SOURCE_HASH);
+  fs::resize_file (path, fs::file_size (path) / 2);
+  EXPECT_EQ (DecodedAudioCache::open (path, SAMPLERATE, SOURCE_HASH), nullptr);
+}
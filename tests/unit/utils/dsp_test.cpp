@@ -44,6 +44,17 @@ TEST (DspTest, MultiplyByConstant)
     }
 }
 
+TEST (DspTest, Multiply)
+{
+  float buf[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+  float src[4] = { 0.5f, -1.0f, 0.0f, 2.0f };
+  mul2 (buf, src, 4);
+  EXPECT_FLOAT_EQ (buf[0], 0.5f);
+  EXPECT_FLOAT_EQ (buf[1], -2.0f);
+  EXPECT_FLOAT_EQ (buf[2], 0.0f);
+  EXPECT_FLOAT_EQ (buf[3], 8.0f);
+}
+
 TEST (DspTest, AbsMax)
 {
   // Test with mixed positive/negative values
@@ -67,6 +78,21 @@ TEST (DspTest, AbsMax)
   EXPECT_FLOAT_EQ (abs_max (buf5, 4), 0.75f);
 }
 
+TEST (DspTest, IsSilent)
+{
+  std::vector<float> buf (37, 1e-12f);
+  EXPECT_TRUE (is_silent (buf.data (), buf.size (), 1e-7f));
+  EXPECT_TRUE (is_silent (buf.data (), 0, 1e-7f));
+
+  // loud values in a full block and in the remainder are both detected
+  buf[5] = -0.5f;
+  EXPECT_FALSE (is_silent (buf.data (), buf.size (), 1e-7f));
+  buf[5] = 1e-12f;
+  buf[36] = 0.5f;
+  EXPECT_FALSE (is_silent (buf.data (), buf.size (), 1e-7f));
+  EXPECT_TRUE (is_silent (buf.data (), 36, 1e-7f));
+}
+
 TEST (DspTest, MinMax)
 {
   float buf[4] = { -2.0f, 1.0f, -3.0f, 2.5f };
@@ -96,6 +122,61 @@ TEST (DspTest, MixProduct)
     }
 }
 
+TEST (DspTest, FusedMixingWithPeak)
+{
+  // long enough to cover both the blocks and the remainder
+  constexpr size_t   size = 37;
+  std::vector<float> src (size);
+  std::vector<float> dest (size);
+  for (size_t i = 0; i < size; i++)
+    {
+      src[i] = (i % 2 == 0 ? 0.1f : -0.1f) * static_cast<float> (i);
+      dest[i] = 0.5f;
+    }
+
+  for (const bool optimized : { true, false })
+    {
+      auto  sum = dest;
+      float peak = add2_with_peak (sum.data (), src.data (), size, optimized);
+      for (size_t i = 0; i < size; i++)
+        {
+          EXPECT_FLOAT_EQ (sum[i], 0.5f + src[i]);
+        }
+      EXPECT_FLOAT_EQ (peak, abs_max (sum.data (), size, false));
+
+      sum = dest;
+      peak = mix_product_with_peak (
+        sum.data (), src.data (), 2.f, size, optimized);
+      for (size_t i = 0; i < size; i++)
+        {
+          EXPECT_FLOAT_EQ (sum[i], 0.5f + src[i] * 2.f);
+        }
+      EXPECT_FLOAT_EQ (peak, abs_max (sum.data (), size, false));
+    }
+}
+
+TEST (DspTest, FusedMixingClamped)
+{
+  float src[4] = { 0.5f, -3.0f, 1.5f, 2.0f };
+
+  for (const bool optimized : { true, false })
+    {
+      float dest[4] = { 1.0f, 2.0f, -3.0f, 0.0f };
+      add2_clamped (dest, src, -2.f, 2.f, 4, optimized);
+      EXPECT_FLOAT_EQ (dest[0], 1.5f);
+      EXPECT_FLOAT_EQ (dest[1], -1.0f);
+      EXPECT_FLOAT_EQ (dest[2], -1.5f);
+      EXPECT_FLOAT_EQ (dest[3], 2.0f);
+
+      float dest2[4] = { 1.0f, 2.0f, -3.0f, 0.0f };
+      mix_product_clamped (dest2, src, 2.f, -2.f, 2.f, 4, optimized);
+      EXPECT_FLOAT_EQ (dest2[0], 2.0f);
+      EXPECT_FLOAT_EQ (dest2[1], -2.0f);
+      EXPECT_FLOAT_EQ (dest2[2], 0.0f);
+      EXPECT_FLOAT_EQ (dest2[3], 2.0f);
+    }
+}
+
 TEST (DspTest, Reverse)
 {
   float src[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
@@ -157,3 +238,130 @@ TEST (DspTest, MakeMono)
       EXPECT_FLOAT_EQ (l[i], r[i]);
     }
 }
+
+TEST (DspTest, StereoGain)
+{
+  const float src_l[4] = { 1.0f, 2.0f, 3.0f, 4.0f };
+  const float src_r[4] = { 2.0f, 3.0f, 4.0f, 5.0f };
+  const float gains_l[4] = { 1.0f, 0.5f, -1.0f, 1.0f };
+  const float gains_r[4] = { 0.0f, 1.0f, 1.0f, 1.0f };
+  float       l[4];
+  float       r[4];
+
+  // Test gains only
+  stereo_gain (l, r, src_l, src_r, gains_l, gains_r, 0.f, 0.f, 4);
+  EXPECT_FLOAT_EQ (l[1], 1.0f);
+  EXPECT_FLOAT_EQ (l[2], -3.0f);
+  EXPECT_FLOAT_EQ (r[0], 0.0f);
+  EXPECT_FLOAT_EQ (r[3], 5.0f);
+
+  // Test mono and clipping
+  stereo_gain (l, r, src_l, src_r, gains_l, gains_r, 0.5f, 4.f, 4);
+  EXPECT_FLOAT_EQ (l[0], 0.5f);
+  EXPECT_FLOAT_EQ (r[0], 0.5f);
+  EXPECT_FLOAT_EQ (l[2], 0.5f);
+  EXPECT_FLOAT_EQ (l[3], 4.0f);
+  EXPECT_FLOAT_EQ (r[3], 4.0f);
+
+  // Test in place
+  std::copy_n (src_l, 4, l);
+  std::copy_n (src_r, 4, r);
+  stereo_gain (l, r, l, r, gains_l, gains_r, 0.f, 0.f, 4);
+  EXPECT_FLOAT_EQ (l[1], 1.0f);
+  EXPECT_FLOAT_EQ (r[0], 0.0f);
+}
+
+TEST (DspTest, SimdBackendsMatchScalar)
+{
+  const auto prev_backend = get_simd_backend ();
+  const auto backends = get_supported_simd_backends ();
+  ASSERT_FALSE (backends.empty ());
+  EXPECT_EQ (backends.front (), SimdBackend::Scalar);
+  EXPECT_NE (std::ranges::find (backends, prev_backend), backends.end ());
+
+  /* an odd size to also exercise the non-vectorized tail */
+  constexpr size_t   size = 67;
+  std::vector<float> src (size);
+  std::vector<float> other (size);
+  for (size_t i = 0; i < size; i++)
+    {
+      src[i] = std::sin (static_cast<float> (i) * 0.37f) * 1.5f;
+      other[i] = std::cos (static_cast<float> (i) * 0.11f);
+    }
+
+  const auto run_all = [&] () {
+    std::vector<std::vector<float>> results;
+    auto                            buf = src;
+
+    fill (buf.data (), 0.25f, size);
+    results.push_back (buf);
+
+    copy (buf.data (), src.data (), size);
+    results.push_back (buf);
+
+    add2 (buf.data (), other.data (), size);
+    results.push_back (buf);
+
+    mix_product (buf.data (), other.data (), 0.3f, size);
+    results.push_back (buf);
+
+    mul_k2 (buf.data (), 0.7f, size);
+    results.push_back (buf);
+
+    mul2 (buf.data (), other.data (), size);
+    results.push_back (buf);
+
+    results.push_back ({ abs_max (buf.data (), size) });
+
+    clip (buf.data (), -0.5f, 0.8f, size);
+    results.push_back (buf);
+
+    auto l = src;
+    auto r = other;
+    make_mono (l.data (), r.data (), size, true);
+    results.push_back (l);
+    results.push_back (r);
+
+    buf = src;
+    linear_fade_in_from (buf.data (), 3, 100, size, 0.1f);
+    results.push_back (buf);
+
+    buf = src;
+    linear_fade_out_to (buf.data (), 20, 90, size, 0.f);
+    results.push_back (buf);
+
+    for (const auto mono_k : { 0.f, 0.5f })
+      {
+        l = other;
+        r = src;
+        stereo_gain (
+          l.data (), r.data (), src.data (), other.data (), other.data (),
+          src.data (), mono_k, 0.9f, size);
+        results.push_back (l);
+        results.push_back (r);
+      }
+    return results;
+  };
+
+  ASSERT_TRUE (set_simd_backend (SimdBackend::Scalar));
+  const auto expected = run_all ();
+  for (const auto backend : backends)
+    {
+      ASSERT_TRUE (set_simd_backend (backend));
+      EXPECT_EQ (get_simd_backend (), backend);
+      const auto results = run_all ();
+      ASSERT_EQ (results.size (), expected.size ());
+      for (size_t i = 0; i < results.size (); i++)
+        {
+          ASSERT_EQ (results[i].size (), expected[i].size ());
+          for (size_t j = 0; j < results[i].size (); j++)
+            {
+              EXPECT_NEAR (results[i][j], expected[i][j], 1e-5f)
+                << simd_backend_to_string (backend) << " result " << i
+                << " frame " << j;
+            }
+        }
+    }
+
+  set_simd_backend (prev_backend);
+}
@@ -0,0 +1,85 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <memory>
+#include <thread>
+
+#include "utils/fixed_spsc_ring.h"
+#include "utils/gtest_wrapper.h"
+
+using namespace zrythm::utils;
+
+TEST (FixedSpscRingTest, PushPop)
+{
+  FixedSpscRing<int, 4> ring;
+  EXPECT_EQ (ring.capacity (), 4);
+
+  int value = 0;
+  EXPECT_FALSE (ring.pop (value));
+
+  for (int i = 0; i < 4; ++i)
+    {
+      EXPECT_TRUE (ring.push (i));
+    }
+  EXPECT_FALSE (ring.push (4));
+  EXPECT_EQ (ring.read_space (), 4);
+
+  for (int i = 0; i < 4; ++i)
+    {
+      EXPECT_TRUE (ring.pop (value));
+      EXPECT_EQ (value, i);
+    }
+  EXPECT_FALSE (ring.pop (value));
+
+  // wraps around
+  EXPECT_TRUE (ring.push (10));
+  EXPECT_TRUE (ring.pop (value));
+  EXPECT_EQ (value, 10);
+}
+
+TEST (FixedSpscRingTest, PopLatest)
+{
+  FixedSpscRing<int, 8> ring;
+  int                   value = 0;
+  EXPECT_FALSE (ring.pop_latest (value));
+
+  ring.push (1);
+  ring.push (2);
+  ring.push (3);
+  EXPECT_TRUE (ring.pop_latest (value));
+  EXPECT_EQ (value, 3);
+  EXPECT_EQ (ring.read_space (), 0);
+  EXPECT_FALSE (ring.pop (value));
+}
+
+TEST (FixedSpscRingTest, ConcurrentProducerConsumer)
+{
+  constexpr int num_values = 10000;
+  auto          ring = std::make_unique<FixedSpscRing<int, 64>> ();
+
+  std::thread producer ([&] () {
+    for (int i = 0; i < num_values;)
+      {
+        if (ring->push (i))
+          ++i;
+        else
+          std::this_thread::yield ();
+      }
+  });
+
+  int expected = 0;
+  while (expected < num_values)
+    {
+      int value = 0;
+      if (ring->pop (value))
+        {
+          ASSERT_EQ (value, expected);
+          ++expected;
+        }
+      else
+        {
+          std::this_thread::yield ();
+        }
+    }
+  producer.join ();
+}
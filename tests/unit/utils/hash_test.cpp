@@ -1,5 +1,21 @@
+#include <fstream>
+#include <iterator>
+#include <vector>
+
 #include "utils/gtest_wrapper.h"
 #include "utils/hash.h"
+#include "utils/io.h"
+
+namespace
+{
+void
+write_file (const fs::path &path, const std::vector<char> &contents)
+{
+  std::ofstream stream (path, std::ios::binary);
+  stream.write (
+    contents.data (), static_cast<std::streamsize> (contents.size ()));
+}
+}
 
 TEST (HashTest, HashObject)
 {
@@ -32,6 +48,52 @@ TEST (HashTest, HashFile)
   EXPECT_EQ (hash_str.find_first_not_of ("0123456789abcdef"), std::string::npos);
 }
 
+TEST (HashTest, HashFileMatchesContentsHash)
+{
+  auto          filepath = fs::path (TEST_WAV_FILE_PATH);
+  std::ifstream stream (filepath, std::ios::binary);
+  std::vector<char> contents (
+    (std::istreambuf_iterator<char> (stream)),
+    std::istreambuf_iterator<char> ());
+  ASSERT_FALSE (contents.empty ());
+
+  EXPECT_EQ (
+    zrythm::utils::hash::get_file_hash (filepath),
+    zrythm::utils::hash::get_custom_hash (contents.data (), contents.size ()));
+}
+
+TEST (HashTest, HashFileParallel)
+{
+  using namespace zrythm::utils::hash;
+
+  // spans multiple chunks, the last one partial
+  auto tmp_dir = zrythm::utils::io::make_tmp_dir ();
+  auto filepath = fs::path (tmp_dir->path ().toStdString ()) / "large.bin";
+  std::vector<char> contents (
+    static_cast<size_t> (FILE_HASH_CHUNK_SIZE) * 2 + 1234);
+  for (size_t i = 0; i < contents.size (); ++i)
+    {
+      contents[i] = static_cast<char> ((i * 31) ^ (i >> 13));
+    }
+  write_file (filepath, contents);
+
+  EXPECT_EQ (
+    get_file_hash (filepath),
+    get_custom_hash (contents.data (), contents.size ()));
+
+  const auto hash = get_file_hash_parallel (filepath);
+  EXPECT_NE (hash, 0);
+  EXPECT_EQ (get_file_hash_parallel (filepath, 1), hash);
+  EXPECT_EQ (get_file_hash_parallel (filepath, 2), hash);
+
+  // any change is detected
+  contents[static_cast<size_t> (FILE_HASH_CHUNK_SIZE) + 1] ^= 1;
+  write_file (filepath, contents);
+  EXPECT_NE (get_file_hash_parallel (filepath), hash);
+
+  EXPECT_EQ (get_file_hash_parallel (filepath.parent_path () / "missing"), 0);
+}
+
 TEST (HashTest, HashString)
 {
   std::string test1 = "Hello World";
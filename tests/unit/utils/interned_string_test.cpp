@@ -0,0 +1,39 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "utils/gtest_wrapper.h"
+#include "utils/interned_string.h"
+
+using namespace zrythm::utils;
+
+TEST (InternedStringTest, Empty)
+{
+  InternedString str;
+  EXPECT_TRUE (str.empty ());
+  EXPECT_STREQ (str.c_str (), "");
+  EXPECT_EQ (str.size (), 0);
+
+  str = "";
+  EXPECT_TRUE (str.empty ());
+  EXPECT_EQ (str, InternedString ());
+}
+
+TEST (InternedStringTest, SharesStorage)
+{
+  InternedString a;
+  a = "Stereo Out";
+  InternedString b;
+  b = std::string ("Stereo ") + "Out";
+  EXPECT_EQ (a.c_str (), b.c_str ());
+  EXPECT_EQ (a, b);
+  EXPECT_EQ (a.hash (), b.hash ());
+  EXPECT_EQ (a, "Stereo Out");
+  EXPECT_EQ (a.size (), 10);
+
+  const std::string copy = a;
+  EXPECT_EQ (copy, "Stereo Out");
+
+  b = "Stereo In";
+  EXPECT_NE (a, b);
+  EXPECT_EQ (fmt::format ("{}", b), "Stereo In");
+}
@@ -0,0 +1,120 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <limits>
+#include <random>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/interval_index.h"
+
+using namespace zrythm::utils;
+
+using Interval = IntervalIndex::Interval;
+using Range = std::pair<int64_t, int64_t>;
+
+TEST (IntervalIndexTest, Empty)
+{
+  IntervalIndex index;
+  index.build ({});
+  EXPECT_TRUE (index.empty ());
+  EXPECT_FALSE (index.find_first_overlapping (0, 100).has_value ());
+  EXPECT_FALSE (index.find_latest_ending_started_by (0).has_value ());
+  EXPECT_EQ (
+    index.get_boundaries_around (0, true),
+    (Range{
+      std::numeric_limits<int64_t>::min (),
+      std::numeric_limits<int64_t>::max () }));
+}
+
+TEST (IntervalIndexTest, Overlapping)
+{
+  const std::vector<Interval> intervals = {
+    { 100, 199 }, { 0, 99 }, { 150, 400 }, { 500, 600 }, { 0, 1000 },
+  };
+  IntervalIndex index;
+  index.build (intervals);
+
+  std::vector<size_t> found;
+  index.for_each_overlapping (
+    180, 450, [&] (size_t i) { found.push_back (i); });
+  EXPECT_EQ (found, (std::vector<size_t>{ 4, 0, 2 }));
+
+  /* closed intervals */
+  EXPECT_EQ (index.find_first_overlapping (99, 99), 1u);
+  EXPECT_EQ (index.find_last_overlapping (99, 99), 4u);
+  EXPECT_EQ (index.find_last_overlapping (600, 600), 3u);
+  EXPECT_EQ (index.find_last_overlapping (1000, 1000), 4u);
+  EXPECT_FALSE (index.find_first_overlapping (1001, 2000).has_value ());
+
+  /* [pos + 1, pos]: containing pos but not ending at it */
+  EXPECT_EQ (index.find_last_overlapping (600, 599), 3u);
+  EXPECT_EQ (index.find_last_overlapping (601, 600), 4u);
+}
+
+TEST (IntervalIndexTest, LatestEndingStartedBy)
+{
+  const std::vector<Interval> intervals = {
+    { 0, 50 }, { 10, 300 }, { 20, 300 }, { 400, 450 },
+  };
+  IntervalIndex index;
+  index.build (intervals);
+
+  EXPECT_FALSE (index.find_latest_ending_started_by (-1).has_value ());
+  EXPECT_EQ (index.find_latest_ending_started_by (5), 0u);
+  EXPECT_EQ (index.find_latest_ending_started_by (10), 1u);
+
+  /* ties go to the one starting last */
+  EXPECT_EQ (index.find_latest_ending_started_by (350), 2u);
+  EXPECT_EQ (index.find_latest_ending_started_by (1000), 3u);
+}
+
+TEST (IntervalIndexTest, BoundariesAround)
+{
+  const std::vector<Interval> intervals = { { 100, 199 }, { 300, 399 } };
+  IntervalIndex index;
+  index.build (intervals);
+
+  EXPECT_EQ (index.get_boundaries_around (150, false), (Range{ 100, 300 }));
+  EXPECT_EQ (index.get_boundaries_around (150, true), (Range{ 100, 200 }));
+  EXPECT_EQ (index.get_boundaries_around (200, true), (Range{ 200, 300 }));
+  EXPECT_EQ (index.get_boundaries_around (399, true), (Range{ 300, 400 }));
+  EXPECT_EQ (
+    index.get_boundaries_around (500, true),
+    (Range{ 400, std::numeric_limits<int64_t>::max () }));
+}
+
+TEST (IntervalIndexTest, MatchesLinearSearch)
+{
+  std::mt19937                           rng (1234);
+  std::uniform_int_distribution<int64_t> start_dist (0, 10000);
+  std::uniform_int_distribution<int64_t> length_dist (0, 500);
+
+  std::vector<Interval> intervals;
+  for (int i = 0; i < 500; ++i)
+    {
+      const auto start = start_dist (rng);
+      intervals.push_back ({ start, start + length_dist (rng) });
+    }
+  IntervalIndex index;
+  index.build (intervals);
+
+  for (int i = 0; i < 1000; ++i)
+    {
+      const auto from = start_dist (rng);
+      const auto to = from + length_dist (rng) / 4;
+
+      std::vector<size_t> expected;
+      for (size_t j = 0; j < intervals.size (); ++j)
+        {
+          if (intervals[j].start_ <= to && intervals[j].end_ >= from)
+            expected.push_back (j);
+        }
+      std::vector<size_t> found;
+      index.for_each_overlapping (from, to, [&] (size_t j) {
+        found.push_back (j);
+      });
+      std::ranges::sort (found);
+      ASSERT_EQ (found, expected);
+    }
+}
@@ -117,3 +117,27 @@ TEST (ISerializableTest, NestedObjects)
   EXPECT_EQ (deserialized.simple_vec[1].str_value, obj.simple_vec[1].str_value);
   EXPECT_EQ (deserialized.simple_ptr->bool_value, obj.simple_ptr->bool_value);
 }
+
+TEST (ISerializableTest, Binary)
+{
+  NestedObject obj;
+  obj.simple.int_value = -999;
+  obj.simple.float_value = 1.5f;
+  obj.simple_vec[1].str_value = "modified vector";
+  obj.simple_ptr->bool_value = false;
+
+  auto binary = obj.serialize_to_binary ();
+  EXPECT_LT (binary.size (), strlen (obj.serialize_to_json_string ().c_str ()));
+
+  NestedObject deserialized;
+  deserialized.deserialize_from_binary (binary);
+
+  EXPECT_EQ (deserialized.simple.int_value, obj.simple.int_value);
+  EXPECT_FLOAT_EQ (deserialized.simple.float_value, obj.simple.float_value);
+  EXPECT_EQ (deserialized.simple_vec[1].str_value, obj.simple_vec[1].str_value);
+  EXPECT_EQ (deserialized.simple_ptr->bool_value, obj.simple_ptr->bool_value);
+
+  /* documents of a different type are rejected */
+  SimpleObject simple;
+  EXPECT_THROW (simple.deserialize_from_binary (binary), ZrythmException);
+}
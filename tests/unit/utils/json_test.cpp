@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <cmath>
+
 #include "utils/gtest_wrapper.h"
 #include "utils/json.h"
 
@@ -27,3 +30,65 @@ TEST (JsonTest, GetString)
     yyjson_doc_free (doc);
   }
 }
+
+TEST (JsonTest, WriteToSink)
+{
+  constexpr std::string_view json =
+    R"({"null":null,"bools":[true,false],"uint":42,"sint":-42,"real":0.5,)"
+    R"("str":"quote \" backslash \\ newline \n tab \t","empty_arr":[],)"
+    R"("empty_obj":{},"nested":{"a":[{"b":1},{"c":[1,2,[3]]}]}})";
+  yyjson_doc * doc = yyjson_read (json.data (), json.size (), 0);
+  ASSERT_TRUE (doc != nullptr);
+  yyjson_mut_doc * mut_doc = yyjson_doc_mut_copy (doc, nullptr);
+
+  std::string streamed;
+  int         num_chunks = 0;
+  zrythm::utils::json::write_to_sink (
+    yyjson_mut_doc_get_root (mut_doc), [&] (std::string_view chunk) {
+      streamed.append (chunk);
+      ++num_chunks;
+    });
+
+  /* same output as the non-streaming writer */
+  auto str = zrythm::utils::json::get_string (yyjson_doc_get_root (doc));
+  EXPECT_EQ (streamed, std::string (str.c_str ()));
+  EXPECT_EQ (num_chunks, 1);
+
+  yyjson_mut_doc_free (mut_doc);
+  yyjson_doc_free (doc);
+}
+
+TEST (JsonTest, WriteToSinkInChunks)
+{
+  yyjson_mut_doc * doc = yyjson_mut_doc_new (nullptr);
+  yyjson_mut_val * arr = yyjson_mut_arr (doc);
+  yyjson_mut_doc_set_root (doc, arr);
+  for (int i = 0; i < 100000; ++i)
+    {
+      yyjson_mut_arr_add_real (doc, arr, i);
+    }
+
+  std::string streamed;
+  size_t      max_chunk_size = 0;
+  zrythm::utils::json::write_to_sink (arr, [&] (std::string_view chunk) {
+    streamed.append (chunk);
+    max_chunk_size = std::max (max_chunk_size, chunk.size ());
+  });
+  EXPECT_GT (streamed.size (), zrythm::utils::json::WRITE_CHUNK_SIZE);
+  EXPECT_LT (max_chunk_size, zrythm::utils::json::WRITE_CHUNK_SIZE + 64);
+
+  /* reals stay reals */
+  yyjson_doc * read_doc = yyjson_read (streamed.data (), streamed.size (), 0);
+  ASSERT_TRUE (read_doc != nullptr);
+  yyjson_val * first = yyjson_arr_get_first (yyjson_doc_get_root (read_doc));
+  EXPECT_TRUE (yyjson_is_real (first));
+  EXPECT_EQ (yyjson_arr_size (yyjson_doc_get_root (read_doc)), 100000);
+  yyjson_doc_free (read_doc);
+
+  /* nan can't be written */
+  yyjson_mut_arr_add_real (doc, arr, std::nan (""));
+  EXPECT_ANY_THROW (
+    zrythm::utils::json::write_to_sink (arr, [] (std::string_view) { }));
+
+  yyjson_mut_doc_free (doc);
+}
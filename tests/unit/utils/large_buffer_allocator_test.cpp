@@ -0,0 +1,62 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+#include <cstdint>
+#include <span>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/large_buffer_allocator.h"
+
+using namespace zrythm::utils;
+
+class LargeBufferAllocatorTest : public ::testing::Test
+{
+protected:
+  void TearDown () override { LargeBufferAllocator::set_options ({}); }
+
+  /** Checks that the buffer is zeroed, writable and aligned. */
+  static void
+  check_buffer (const std::shared_ptr<float[]> &buf, size_t size, size_t align)
+  {
+    ASSERT_NE (buf, nullptr);
+    EXPECT_EQ (reinterpret_cast<std::uintptr_t> (buf.get ()) % align, 0);
+    std::span<float> floats (buf.get (), size);
+    EXPECT_TRUE (std::ranges::all_of (floats, [] (float f) {
+      return f == 0.f;
+    }));
+    std::ranges::fill (floats, 1.f);
+    EXPECT_EQ (floats.back (), 1.f);
+  }
+};
+
+TEST_F (LargeBufferAllocatorTest, RegularPages)
+{
+  EXPECT_FALSE (LargeBufferAllocator::is_enabled ());
+  const auto buf = LargeBufferAllocator::allocate_floats (1000, 64);
+  check_buffer (buf, 1000, 64);
+}
+
+TEST_F (LargeBufferAllocatorTest, HugePages)
+{
+  LargeBufferAllocator::set_options ({ .huge_pages_ = true });
+  EXPECT_TRUE (LargeBufferAllocator::is_enabled ());
+
+  // large enough for huge pages
+  const size_t num_floats = LargeBufferAllocator::HUGE_PAGE_SIZE;
+  check_buffer (
+    LargeBufferAllocator::allocate_floats (num_floats, 64), num_floats, 64);
+
+  // too small, allocated normally
+  check_buffer (LargeBufferAllocator::allocate_floats (16, 64), 16, 64);
+}
+
+TEST_F (LargeBufferAllocatorTest, Locked)
+{
+  // locking may fail (e.g., low RLIMIT_MEMLOCK) but the buffer is usable
+  LargeBufferAllocator::set_options ({ .lock_ = true });
+  for (int i = 0; i < 4; ++i)
+    {
+      check_buffer (LargeBufferAllocator::allocate_floats (5000, 64), 5000, 64);
+    }
+}
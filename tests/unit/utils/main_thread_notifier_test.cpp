@@ -0,0 +1,101 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <chrono>
+#include <thread>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/main_thread_notifier.h"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+
+using namespace zrythm::utils;
+using namespace std::chrono_literals;
+
+namespace
+{
+
+/** Processes events until @p pred is true or the timeout is reached. */
+template <typename Pred>
+bool
+process_events_until (Pred pred, int timeout_ms = 2000)
+{
+  QElapsedTimer timer;
+  timer.start ();
+  while (!pred () && timer.elapsed () < timeout_ms)
+    {
+      QCoreApplication::processEvents (QEventLoop::AllEvents, 10);
+      std::this_thread::sleep_for (1ms);
+    }
+  return pred ();
+}
+
+} // namespace
+
+class MainThreadNotifierTest : public ::testing::Test
+{
+protected:
+  void SetUp () override
+  {
+    if (QCoreApplication::instance () == nullptr)
+      {
+        static int   argc = 1;
+        static char  arg0[] = "test";
+        static char * argv[] = { arg0, nullptr };
+        app_ = std::make_unique<QCoreApplication> (argc, argv);
+      }
+  }
+
+  static inline std::unique_ptr<QCoreApplication> app_;
+};
+
+TEST_F (MainThreadNotifierTest, CallbackRunsOnMainThread)
+{
+  int                calls = 0;
+  std::thread::id    callback_thread;
+  MainThreadNotifier notifier ([&] () {
+    calls++;
+    callback_thread = std::this_thread::get_id ();
+  });
+
+  std::thread ([&] () { notifier.notify (); }).join ();
+
+  EXPECT_TRUE (process_events_until ([&] () { return calls > 0; }));
+  EXPECT_EQ (calls, 1);
+  EXPECT_EQ (callback_thread, std::this_thread::get_id ());
+}
+
+TEST_F (MainThreadNotifierTest, NotificationsAreCoalesced)
+{
+  int                calls = 0;
+  MainThreadNotifier notifier ([&] () { calls++; });
+
+  for (int i = 0; i < 100; i++)
+    {
+      notifier.notify ();
+    }
+
+  EXPECT_TRUE (process_events_until ([&] () { return calls > 0; }));
+
+  // give any extra (unexpected) calls a chance to run
+  process_events_until ([] () { return false; }, 50);
+  EXPECT_EQ (calls, 1);
+
+  // notifying again after the callback ran calls it again
+  notifier.notify ();
+  EXPECT_TRUE (process_events_until ([&] () { return calls > 1; }));
+  EXPECT_EQ (calls, 2);
+}
+
+TEST_F (MainThreadNotifierTest, NoCallbackAfterDestruction)
+{
+  int calls = 0;
+  {
+    MainThreadNotifier notifier ([&] () { calls++; });
+    notifier.notify ();
+    std::this_thread::sleep_for (20ms);
+  }
+  process_events_until ([] () { return false; }, 50);
+  EXPECT_EQ (calls, 0);
+}
@@ -0,0 +1,63 @@
+// SPDX-FileCopyrightText: © 2025 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "utils/gtest_wrapper.h"
+#include "utils/max_value_index.h"
+
+using namespace zrythm::utils;
+
+namespace
+{
+struct TestId
+{
+  size_t hash () const { return std::hash<int>{}(val_); }
+  bool   operator== (const TestId &other) const = default;
+
+  int val_;
+};
+}
+
+TEST (MaxValueIndexTest, SetAndRemove)
+{
+  MaxValueIndex<int, double> index;
+  EXPECT_TRUE (index.empty ());
+  EXPECT_FALSE (index.get_max ().has_value ());
+
+  index.set (1, 10.0);
+  index.set (2, 30.0);
+  index.set (3, 20.0);
+  EXPECT_EQ (index.size (), 3);
+  EXPECT_TRUE (index.contains (2));
+  EXPECT_DOUBLE_EQ (*index.get_max (), 30.0);
+
+  // Moving the last value back
+  index.set (2, 5.0);
+  EXPECT_EQ (index.size (), 3);
+  EXPECT_DOUBLE_EQ (*index.get_max (), 20.0);
+
+  index.remove (3);
+  EXPECT_FALSE (index.contains (3));
+  EXPECT_DOUBLE_EQ (*index.get_max (), 10.0);
+
+  // Removing a missing ID does nothing
+  index.remove (3);
+  EXPECT_EQ (index.size (), 2);
+
+  index.clear ();
+  EXPECT_TRUE (index.empty ());
+  EXPECT_FALSE (index.get_max ().has_value ());
+}
+
+TEST (MaxValueIndexTest, EqualValues)
+{
+  MaxValueIndex<TestId, int> index;
+  index.set ({ 1 }, 7);
+  index.set ({ 2 }, 7);
+  index.set ({ 2 }, 7);
+  EXPECT_EQ (index.size (), 2);
+
+  index.remove ({ 1 });
+  EXPECT_EQ (*index.get_max (), 7);
+  index.remove ({ 2 });
+  EXPECT_TRUE (index.empty ());
+}
@@ -1,3 +1,4 @@
+#include <array>
 #include <thread>
 #include <vector>
 
@@ -94,3 +95,90 @@ TEST (MPMCQueueTest, MultiThreaded)
 
   EXPECT_EQ (sum, num_producers * items_per_producer);
 }
+
+TEST (MPMCQueueTest, BatchOperations)
+{
+  MPMCQueue<int>   queue (8);
+  std::vector<int> input = { 1, 2, 3, 4, 5 };
+  EXPECT_EQ (queue.push_back_multiple (input.data (), input.size ()), 5);
+
+  // only the first elements fit
+  EXPECT_EQ (queue.push_back_multiple (input.data (), input.size ()), 3);
+  EXPECT_EQ (queue.push_back_multiple (input.data (), input.size ()), 0);
+
+  std::vector<int> output (6);
+  EXPECT_EQ (queue.pop_front_multiple (output.data (), output.size ()), 6);
+  EXPECT_EQ (output, std::vector<int> ({ 1, 2, 3, 4, 5, 1 }));
+
+  // mixed with single pops, across the wrap point
+  int value;
+  EXPECT_TRUE (queue.pop_front (value));
+  EXPECT_EQ (value, 2);
+  EXPECT_EQ (queue.push_back_multiple (input.data (), input.size ()), 5);
+  EXPECT_EQ (queue.pop_front_multiple (output.data (), output.size ()), 6);
+  EXPECT_EQ (output, std::vector<int> ({ 3, 1, 2, 3, 4, 5 }));
+  EXPECT_EQ (queue.pop_front_multiple (output.data (), output.size ()), 0);
+}
+
+TEST (MPMCQueueTest, MultiThreadedBatches)
+{
+  MPMCQueue<int>   queue (64);
+  std::atomic<int> count (0);
+  std::atomic<int> sum (0);
+  constexpr int    num_producers = 4;
+  constexpr int    num_consumers = 4;
+  constexpr int    items_per_producer = 1000;
+  constexpr int    batch_size = 7;
+
+  std::vector<std::thread> producers;
+  for (int i = 0; i < num_producers; i++)
+    {
+      producers.emplace_back ([&queue] () {
+        std::vector<int> items (items_per_producer, 1);
+        size_t           pushed = 0;
+        while (pushed < items.size ())
+          {
+            const auto num =
+              std::min<size_t> (batch_size, items.size () - pushed);
+            const auto num_pushed =
+              queue.push_back_multiple (items.data () + pushed, num);
+            if (num_pushed == 0)
+              {
+                std::this_thread::yield ();
+              }
+            pushed += num_pushed;
+          }
+      });
+    }
+
+  std::vector<std::thread> consumers;
+  for (int i = 0; i < num_consumers; i++)
+    {
+      consumers.emplace_back ([&] () {
+        std::array<int, batch_size> values{};
+        while (count < num_producers * items_per_producer)
+          {
+            const auto num_popped =
+              queue.pop_front_multiple (values.data (), values.size ());
+            if (num_popped == 0)
+              {
+                std::this_thread::yield ();
+                continue;
+              }
+            for (size_t j = 0; j < num_popped; j++)
+              {
+                sum += values[j];
+              }
+            count += static_cast<int> (num_popped);
+          }
+      });
+    }
+
+  for (auto &p : producers)
+    p.join ();
+  for (auto &c : consumers)
+    c.join ();
+
+  EXPECT_EQ (count, num_producers * items_per_producer);
+  EXPECT_EQ (sum, num_producers * items_per_producer);
+}
@@ -46,6 +46,32 @@ TEST (ObjectPoolTest, AutoExpansion)
     }
 }
 
+TEST (ObjectPoolTest, TryAcquireDoesNotExpand)
+{
+  ObjectPool<TestObject> pool (4);
+
+  std::vector<TestObject *> objects;
+  for (int i = 0; i < 4; i++)
+    {
+      objects.push_back (pool.try_acquire ());
+      EXPECT_NE (objects.back (), nullptr);
+    }
+
+  EXPECT_EQ (pool.try_acquire (), nullptr);
+  EXPECT_EQ (pool.get_capacity (), 4);
+
+  pool.release (objects.back ());
+  objects.pop_back ();
+  auto obj = pool.try_acquire ();
+  EXPECT_NE (obj, nullptr);
+  objects.push_back (obj);
+
+  for (auto object : objects)
+    {
+      pool.release (object);
+    }
+}
+
 TEST (ObjectPoolTest, MultiThreaded)
 {
   ObjectPool<TestObject> pool (32);
@@ -152,3 +178,67 @@ TEST (ObjectPoolTest, VariousSizes)
   test_with_size<TestStruct> (16, 31, 32);
   test_with_size<TestStruct> (16, 32, 32);
 }
+
+TEST (ObjectPoolTest, RealtimePoolDoesNotGrowOnAcquire)
+{
+  ObjectPool<TestObject> pool (2, 8);
+  EXPECT_TRUE (pool.is_realtime ());
+  EXPECT_EQ (pool.get_capacity (), 2);
+  EXPECT_EQ (pool.get_max_capacity (), 8);
+
+  auto obj1 = pool.acquire ();
+  auto obj2 = pool.acquire ();
+  EXPECT_NE (obj1, nullptr);
+  EXPECT_NE (obj2, nullptr);
+  EXPECT_EQ (pool.acquire (), nullptr);
+  EXPECT_EQ (pool.try_acquire (), nullptr);
+  EXPECT_EQ (pool.get_capacity (), 2);
+  EXPECT_EQ (pool.get_num_failed_acquires (), 2);
+  EXPECT_EQ (pool.get_num_in_use (), 2);
+  EXPECT_EQ (pool.get_high_water_mark (), 2);
+
+  pool.release (obj1);
+  EXPECT_EQ (pool.get_num_in_use (), 1);
+  EXPECT_EQ (pool.get_high_water_mark (), 2);
+  pool.release (obj2);
+}
+
+TEST (ObjectPoolTest, RefillGrowsRealtimePoolUpToMaxCapacity)
+{
+  ObjectPool<TestObject> pool (4, 12);
+
+  // nothing to do while enough objects are available
+  pool.refill ();
+  EXPECT_EQ (pool.get_capacity (), 4);
+
+  std::vector<TestObject *> objects;
+  for (int i = 0; i < 3; i++)
+    {
+      objects.push_back (pool.acquire ());
+    }
+  pool.refill ();
+  EXPECT_EQ (pool.get_capacity (), 8);
+
+  while (auto obj = pool.acquire ())
+    {
+      objects.push_back (obj);
+    }
+  EXPECT_EQ (objects.size (), 8);
+  pool.refill ();
+  EXPECT_EQ (pool.get_capacity (), 12);
+  pool.refill ();
+  EXPECT_EQ (pool.get_capacity (), 12);
+
+  while (auto obj = pool.acquire ())
+    {
+      objects.push_back (obj);
+    }
+  EXPECT_EQ (objects.size (), 12);
+  pool.refill ();
+  EXPECT_EQ (pool.get_capacity (), 12);
+
+  for (auto obj : objects)
+    {
+      pool.release (obj);
+    }
+}
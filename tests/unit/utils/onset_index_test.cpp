@@ -0,0 +1,124 @@
+#include <array>
+#include <cmath>
+#include <random>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/io.h"
+#include "utils/onset_index.h"
+
+using namespace zrythm::utils::audio;
+
+namespace
+{
+
+constexpr zrythm::utils::hash::HashT SOURCE_HASH = 0x1234abcd;
+constexpr sample_rate_t              SAMPLERATE = 44'100;
+
+/* frames and amplitudes of the hits of make_test_frames() */
+constexpr std::array<int, 3>   HIT_FRAMES = { 10'000, 30'000, 52'345 };
+constexpr std::array<float, 3> HIT_AMPS = { 1.f, 0.1f, 0.8f };
+
+/** Stereo noise floor with decaying hits. */
+AudioBuffer
+make_test_frames ()
+{
+  AudioBuffer                           frames (2, 2 * SAMPLERATE);
+  std::mt19937                          gen (1);
+  std::uniform_real_distribution<float> dist (-1e-3f, 1e-3f);
+  for (int ch = 0; ch < 2; ++ch)
+    {
+      for (int i = 0; i < frames.getNumSamples (); ++i)
+        frames.setSample (ch, i, dist (gen));
+    }
+  for (size_t hit = 0; hit < HIT_FRAMES.size (); ++hit)
+    {
+      for (int i = 0; i < 8'000; ++i)
+        {
+          const float val = HIT_AMPS[hit] * std::exp (-i / 2'000.f)
+                            * std::sin (static_cast<float> (i) * 0.05f);
+          for (int ch = 0; ch < 2; ++ch)
+            frames.addSample (ch, HIT_FRAMES[hit] + i, val);
+        }
+    }
+  return frames;
+}
+
+} // namespace
+
+TEST (OnsetIndexTest, DetectsHits)
+{
+  OnsetIndex index;
+  EXPECT_FALSE (index.is_computed ());
+  index.update (make_test_frames (), SAMPLERATE);
+  EXPECT_TRUE (index.is_computed ());
+
+  const auto onsets = index.get_onsets (0, 2 * SAMPLERATE);
+  ASSERT_EQ (onsets.size (), HIT_FRAMES.size ());
+  for (size_t i = 0; i < onsets.size (); ++i)
+    {
+      EXPECT_NEAR (onsets[i].frame_, HIT_FRAMES[i], 32);
+    }
+  EXPECT_FLOAT_EQ (onsets[0].strength_, 1.f);
+  EXPECT_LT (onsets[1].strength_, onsets[2].strength_);
+
+  // ranges and strengths
+  EXPECT_EQ (index.get_onsets (20'000, 60'000).size (), 2);
+  EXPECT_EQ (index.get_onsets (0, 2 * SAMPLERATE, 0.8f).size (), 2);
+}
+
+TEST (OnsetIndexTest, SilenceHasNoOnsets)
+{
+  OnsetIndex index;
+  index.update (AudioBuffer (2, SAMPLERATE), SAMPLERATE);
+  EXPECT_TRUE (index.is_computed ());
+  EXPECT_TRUE (index.get_onsets (0, SAMPLERATE).empty ());
+  EXPECT_FALSE (index.find_nearest (1'000, SAMPLERATE).has_value ());
+}
+
+TEST (OnsetIndexTest, FindNearest)
+{
+  OnsetIndex index;
+  index.update (make_test_frames (), SAMPLERATE);
+
+  auto nearest = index.find_nearest (31'000, 2'000);
+  ASSERT_TRUE (nearest.has_value ());
+  EXPECT_NEAR (*nearest, HIT_FRAMES[1], 32);
+
+  // too far away
+  EXPECT_FALSE (index.find_nearest (40'000, 2'000).has_value ());
+
+  // too weak
+  nearest = index.find_nearest (31'000, 30'000, 0.8f);
+  ASSERT_TRUE (nearest.has_value ());
+  EXPECT_NEAR (*nearest, HIT_FRAMES[0], 32);
+}
+
+TEST (OnsetIndexTest, WriteAndRead)
+{
+  auto     tmp_dir = zrythm::utils::io::make_tmp_dir ();
+  fs::path path =
+    fs::path (tmp_dir->path ().toStdString ()) / "onsets" / "clip.onsets";
+
+  OnsetIndex index;
+  index.update (make_test_frames (), SAMPLERATE);
+  ASSERT_NO_THROW (index.write (path, SOURCE_HASH));
+
+  EXPECT_EQ (OnsetIndex::read (path, SOURCE_HASH + 1), nullptr);
+  auto read_index = OnsetIndex::read (path, SOURCE_HASH);
+  ASSERT_NE (read_index, nullptr);
+  EXPECT_TRUE (read_index->is_computed ());
+  EXPECT_EQ (read_index->get_num_frames (), 2 * SAMPLERATE);
+
+  const auto onsets = index.get_onsets (0, 2 * SAMPLERATE);
+  const auto read_onsets = read_index->get_onsets (0, 2 * SAMPLERATE);
+  ASSERT_EQ (read_onsets.size (), onsets.size ());
+  for (size_t i = 0; i < onsets.size (); ++i)
+    {
+      EXPECT_EQ (read_onsets[i].frame_, onsets[i].frame_);
+      EXPECT_FLOAT_EQ (read_onsets[i].strength_, onsets[i].strength_);
+    }
+
+  // truncated file
+  fs::resize_file (path, fs::file_size (path) - 4);
+  EXPECT_EQ (OnsetIndex::read (path, SOURCE_HASH), nullptr);
+}
@@ -0,0 +1,160 @@
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/io.h"
+#include "utils/peak_pyramid.h"
+
+using namespace zrythm::utils::audio;
+
+namespace
+{
+
+constexpr zrythm::utils::hash::HashT SOURCE_HASH = 0x1234abcd;
+
+AudioBuffer
+make_test_frames (int num_frames)
+{
+  AudioBuffer frames (2, num_frames);
+  for (int i = 0; i < num_frames; ++i)
+    {
+      frames.setSample (
+        0, i,
+        std::sin (static_cast<float> (i) * 0.01f) * static_cast<float> (i)
+          / static_cast<float> (num_frames));
+      frames.setSample (1, i, -0.5f);
+    }
+  return frames;
+}
+
+/** Summary of frames [start, end) of @p ch computed from the frames. */
+PeakPyramid::Peak
+get_exact_peak (const AudioBuffer &frames, int ch, int start, int end)
+{
+  PeakPyramid::Peak peak{ .min_ = 1.f, .max_ = -1.f };
+  double            sum_squares = 0;
+  for (int i = start; i < end; ++i)
+    {
+      const float val = frames.getSample (ch, i);
+      peak.min_ = std::min (peak.min_, val);
+      peak.max_ = std::max (peak.max_, val);
+      sum_squares += val * val;
+    }
+  peak.rms_ = static_cast<float> (std::sqrt (sum_squares / (end - start)));
+  return peak;
+}
+
+} // namespace
+
+TEST (PeakPyramidTest, PeaksAlignedToBuckets)
+{
+  // not a multiple of any bucket size
+  const auto  frames = make_test_frames (100'000);
+  PeakPyramid pyramid;
+  pyramid.update (frames);
+  EXPECT_EQ (pyramid.get_num_channels (), 2);
+  EXPECT_EQ (pyramid.get_num_frames (), 100'000);
+
+  for (const auto frames_per_peak : { 64, 512, 4096, 32768 })
+    {
+      std::vector<PeakPyramid::Peak> peaks (100'000 / frames_per_peak + 1);
+      pyramid.get_peaks (0, 0, frames_per_peak, peaks);
+      for (size_t i = 0; i < peaks.size (); ++i)
+        {
+          const int start = static_cast<int> (i) * frames_per_peak;
+          const auto expected = get_exact_peak (
+            frames, 0, start, std::min (start + frames_per_peak, 100'000));
+          EXPECT_FLOAT_EQ (peaks[i].min_, expected.min_);
+          EXPECT_FLOAT_EQ (peaks[i].max_, expected.max_);
+          EXPECT_NEAR (peaks[i].rms_, expected.rms_, 1e-4f);
+        }
+    }
+}
+
+TEST (PeakPyramidTest, UnalignedRangesIncludeWholeBuckets)
+{
+  const auto  frames = make_test_frames (10'000);
+  PeakPyramid pyramid;
+  pyramid.update (frames);
+
+  std::vector<PeakPyramid::Peak> peaks (3);
+  pyramid.get_peaks (1, 9'900, 200, peaks);
+
+  // constant channel
+  EXPECT_FLOAT_EQ (peaks[0].min_, -0.5f);
+  EXPECT_FLOAT_EQ (peaks[0].max_, -0.5f);
+  EXPECT_NEAR (peaks[0].rms_, 0.5f, 1e-5f);
+
+  // past the end
+  EXPECT_FLOAT_EQ (peaks[1].min_, 0.f);
+  EXPECT_FLOAT_EQ (peaks[2].rms_, 0.f);
+
+  // invalid channel
+  pyramid.get_peaks (2, 0, 100, peaks);
+  EXPECT_FLOAT_EQ (peaks[0].min_, 0.f);
+}
+
+TEST (PeakPyramidTest, IncrementalUpdates)
+{
+  const auto  frames = make_test_frames (100'000);
+  PeakPyramid full;
+  full.update (frames);
+
+  // e.g., while recording
+  PeakPyramid incremental;
+  for (int num_frames = 10'000; num_frames <= 100'000; num_frames += 10'000)
+    {
+      AudioBuffer part (2, num_frames);
+      for (int ch = 0; ch < 2; ++ch)
+        {
+          part.copyFrom (ch, 0, frames, ch, 0, num_frames);
+        }
+      incremental.update (part, num_frames - 10'000);
+    }
+  ASSERT_EQ (incremental.get_num_frames (), 100'000);
+
+  std::vector<PeakPyramid::Peak> full_peaks (200);
+  std::vector<PeakPyramid::Peak> incremental_peaks (200);
+  full.get_peaks (0, 0, 500, full_peaks);
+  incremental.get_peaks (0, 0, 500, incremental_peaks);
+  for (size_t i = 0; i < full_peaks.size (); ++i)
+    {
+      EXPECT_FLOAT_EQ (incremental_peaks[i].min_, full_peaks[i].min_);
+      EXPECT_FLOAT_EQ (incremental_peaks[i].max_, full_peaks[i].max_);
+      EXPECT_NEAR (incremental_peaks[i].rms_, full_peaks[i].rms_, 1e-5f);
+    }
+}
+
+TEST (PeakPyramidTest, WriteAndRead)
+{
+  auto     tmp_dir = zrythm::utils::io::make_tmp_dir ();
+  fs::path path =
+    fs::path (tmp_dir->path ().toStdString ()) / "peaks" / "clip.peaks";
+
+  const auto  frames = make_test_frames (5'000);
+  PeakPyramid pyramid;
+  pyramid.update (frames);
+  ASSERT_NO_THROW (pyramid.write (path, SOURCE_HASH));
+
+  EXPECT_EQ (PeakPyramid::read (path, SOURCE_HASH + 1), nullptr);
+  auto read_pyramid = PeakPyramid::read (path, SOURCE_HASH);
+  ASSERT_NE (read_pyramid, nullptr);
+  EXPECT_EQ (read_pyramid->get_num_channels (), 2);
+  EXPECT_EQ (read_pyramid->get_num_frames (), 5'000);
+
+  std::vector<PeakPyramid::Peak> peaks (50);
+  std::vector<PeakPyramid::Peak> read_peaks (50);
+  pyramid.get_peaks (0, 0, 100, peaks);
+  read_pyramid->get_peaks (0, 0, 100, read_peaks);
+  for (size_t i = 0; i < peaks.size (); ++i)
+    {
+      EXPECT_FLOAT_EQ (read_peaks[i].min_, peaks[i].min_);
+      EXPECT_FLOAT_EQ (read_peaks[i].max_, peaks[i].max_);
+      EXPECT_FLOAT_EQ (read_peaks[i].rms_, peaks[i].rms_);
+    }
+
+  // truncated file
+  fs::resize_file (path, fs::file_size (path) - 4);
+  EXPECT_EQ (PeakPyramid::read (path, SOURCE_HASH), nullptr);
+}
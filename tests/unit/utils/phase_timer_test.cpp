@@ -0,0 +1,73 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <thread>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/io.h"
+#include "utils/phase_timer.h"
+
+#include <yyjson.h>
+
+using namespace zrythm::utils;
+
+TEST (PhaseTimerTest, ScopedPhases)
+{
+  PhaseTimer timer ("test");
+  {
+    auto outer = timer.scope ("outer");
+    {
+      auto inner = timer.scope ("inner");
+      std::this_thread::sleep_for (std::chrono::milliseconds (2));
+    }
+  }
+  timer.add_phase ("manual", 5, 10);
+
+  // phases are kept in the order they ended
+  const auto &phases = timer.get_phases ();
+  ASSERT_EQ (phases.size (), 3);
+  EXPECT_EQ (phases[0].name_, "inner");
+  EXPECT_EQ (phases[1].name_, "outer");
+  EXPECT_EQ (phases[2].name_, "manual");
+  EXPECT_GE (phases[0].duration_usecs_, 2000);
+  EXPECT_GE (phases[1].duration_usecs_, phases[0].duration_usecs_);
+  EXPECT_LE (phases[1].start_usecs_, phases[0].start_usecs_);
+  EXPECT_EQ (phases[2].start_usecs_, 5);
+  EXPECT_EQ (phases[2].duration_usecs_, 10);
+
+  const auto summary = timer.get_summary ();
+  EXPECT_TRUE (summary.starts_with ("test: "));
+  EXPECT_NE (summary.find ("inner"), std::string::npos);
+  EXPECT_NE (summary.find ("manual 0ms"), std::string::npos);
+}
+
+TEST (PhaseTimerTest, Report)
+{
+  PhaseTimer timer ("test");
+  timer.set_info ("version", "1.0");
+  timer.set_info ("version", "2.0");
+  timer.add_phase ("decompress", 0, 1500);
+  timer.add_phase ("deserialize", 1500, 2500);
+
+  auto tmp_dir = io::make_tmp_dir ();
+  auto path = fs::path (tmp_dir->path ().toStdString ()) / "report.json";
+  timer.write_report (path);
+
+  const auto   contents = io::read_file_contents (path);
+  yyjson_doc * doc = yyjson_read (contents.constData (), contents.size (), 0);
+  ASSERT_NE (doc, nullptr);
+  yyjson_val * root = yyjson_doc_get_root (doc);
+  EXPECT_STREQ (yyjson_get_str (yyjson_obj_get (root, "name")), "test");
+  EXPECT_STREQ (yyjson_get_str (yyjson_obj_get (root, "version")), "2.0");
+  EXPECT_TRUE (yyjson_is_str (yyjson_obj_get (root, "datetime")));
+  EXPECT_TRUE (yyjson_is_real (yyjson_obj_get (root, "totalMs")));
+
+  yyjson_val * phases = yyjson_obj_get (root, "phases");
+  ASSERT_EQ (yyjson_arr_size (phases), 2);
+  yyjson_val * phase = yyjson_arr_get (phases, 1);
+  EXPECT_STREQ (yyjson_get_str (yyjson_obj_get (phase, "name")), "deserialize");
+  EXPECT_DOUBLE_EQ (yyjson_get_real (yyjson_obj_get (phase, "startMs")), 1.5);
+  EXPECT_DOUBLE_EQ (
+    yyjson_get_real (yyjson_obj_get (phase, "durationMs")), 2.5);
+  yyjson_doc_free (doc);
+}
@@ -0,0 +1,119 @@
+#include <cmath>
+#include <numbers>
+#include <vector>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/resampler.h"
+
+namespace
+{
+std::vector<float>
+make_sine (float freq, double samplerate, size_t num_frames)
+{
+  std::vector<float> frames (num_frames);
+  for (size_t i = 0; i < num_frames; ++i)
+    {
+      frames[i] = static_cast<float> (std::sin (
+        2.0 * std::numbers::pi * freq * static_cast<double> (i) / samplerate));
+    }
+  return frames;
+}
+}
+
+TEST (RealtimeResamplerTest, SameRateIsIdentity)
+{
+  const auto         in = make_sine (440.f, 48000.0, 512);
+  std::vector<float> out (in.size ());
+  RealtimeResampler  resampler (1, 48000.0, 48000.0);
+
+  const float * in_ptrs[] = { in.data () };
+  float *       out_ptrs[] = { out.data () };
+  EXPECT_EQ (resampler.get_input_frames_needed (out.size ()), in.size () + 2);
+
+  /* the last 2 output frames need 2 more input frames */
+  auto [num_in, num_out] =
+    resampler.process (in_ptrs, in.size (), out_ptrs, out.size ());
+  EXPECT_EQ (num_in, in.size ());
+  EXPECT_EQ (num_out, out.size () - 2);
+  for (size_t i = 0; i < num_out; ++i)
+    {
+      EXPECT_FLOAT_EQ (out[i], in[i]);
+    }
+}
+
+TEST (RealtimeResamplerTest, UpsamplesSine)
+{
+  constexpr double in_rate = 44100.0;
+  constexpr double out_rate = 48000.0;
+  const auto       in = make_sine (440.f, in_rate, 4410);
+  const auto       expected = make_sine (440.f, out_rate, 4000);
+
+  /* process in small blocks, as the audio thread would */
+  RealtimeResampler  resampler (1, in_rate, out_rate);
+  std::vector<float> out (expected.size ());
+  size_t             in_pos = 0;
+  size_t             out_pos = 0;
+  while (out_pos < out.size ())
+    {
+      const size_t  block = std::min<size_t> (64, out.size () - out_pos);
+      const float * in_ptrs[] = { in.data () + in_pos };
+      float *       out_ptrs[] = { out.data () + out_pos };
+      auto [num_in, num_out] =
+        resampler.process (in_ptrs, in.size () - in_pos, out_ptrs, block);
+      ASSERT_GT (num_out, 0u);
+      in_pos += num_in;
+      out_pos += num_out;
+    }
+
+  for (size_t i = 0; i < out.size (); ++i)
+    {
+      EXPECT_NEAR (out[i], expected[i], 0.001f);
+    }
+}
+
+TEST (RealtimeResamplerTest, Reset)
+{
+  const std::vector<float> in (16, 1.f);
+  std::vector<float>       out (8);
+  RealtimeResampler        resampler (1, 48000.0, 48000.0);
+  const float *            in_ptrs[] = { in.data () };
+  float *                  out_ptrs[] = { out.data () };
+  resampler.process (in_ptrs, in.size (), out_ptrs, out.size ());
+
+  resampler.reset ();
+  EXPECT_EQ (resampler.get_input_frames_needed (1), 3u);
+}
+
+TEST (StreamingResamplerTest, ProcessesInChunks)
+{
+  constexpr size_t   num_frames = 48000;
+  constexpr size_t   chunk_frames = 4096;
+  const auto         left = make_sine (440.f, 48000.0, num_frames);
+  const auto         right = make_sine (880.f, 48000.0, num_frames);
+  std::vector<float> out_left;
+
+  StreamingResampler resampler (
+    2, 48000.0, 44100.0, Resampler::Quality::High,
+    [&] (const float * const * frames, size_t num_channels, size_t len) {
+      EXPECT_EQ (num_channels, 2u);
+      EXPECT_LE (len, chunk_frames);
+      out_left.insert (out_left.end (), frames[0], frames[0] + len);
+    },
+    chunk_frames);
+
+  /* feed input in uneven blocks */
+  for (size_t start = 0; start < num_frames; start += 1000)
+    {
+      const size_t  len = std::min<size_t> (1000, num_frames - start);
+      const float * in_ptrs[] = { left.data () + start, right.data () + start };
+      resampler.process (in_ptrs, len);
+    }
+  resampler.finish ();
+
+  EXPECT_NEAR (out_left.size (), 44100, 2);
+  const auto expected = make_sine (440.f, 44100.0, out_left.size ());
+  for (size_t i = 1000; i < out_left.size () - 1000; ++i)
+    {
+      EXPECT_NEAR (out_left[i], expected[i], 0.01f);
+    }
+}
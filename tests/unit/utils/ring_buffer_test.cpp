@@ -53,6 +53,55 @@ TEST (RingBufferTest, ForceWriteMultiple)
   EXPECT_EQ (output, std::vector<int> ({ 2, 3, 4 }));
 }
 
+TEST (RingBufferTest, MultipleOperationsAcrossWrapPoint)
+{
+  // capacity 5 (not a power of 2 minus 1) and 7 (power of 2 minus 1)
+  for (const size_t capacity : { 5, 7 })
+    {
+      RingBuffer<int> buffer (capacity);
+      for (int round = 0; round < 10; ++round)
+        {
+          std::vector<int> input = { round, round + 1, round + 2, round + 3 };
+          EXPECT_TRUE (buffer.write_multiple (input.data (), input.size ()));
+          EXPECT_EQ (buffer.read_space (), 4);
+          EXPECT_EQ (buffer.write_space (), capacity - 4);
+
+          std::vector<int> peeked (8);
+          EXPECT_EQ (buffer.peek_multiple (peeked.data (), peeked.size ()), 4);
+          peeked.resize (4);
+          EXPECT_EQ (peeked, input);
+
+          std::vector<int> output (4);
+          EXPECT_TRUE (buffer.read_multiple (output.data (), output.size ()));
+          EXPECT_EQ (output, input);
+          EXPECT_EQ (buffer.read_space (), 0);
+        }
+
+      std::vector<int> too_many (capacity + 1);
+      EXPECT_FALSE (buffer.write_multiple (too_many.data (), too_many.size ()));
+    }
+}
+
+TEST (RingBufferTest, ForceWriteMultipleAcrossWrapPoint)
+{
+  RingBuffer<int>  buffer (4);
+  std::vector<int> input = { 1, 2, 3 };
+  buffer.force_write_multiple (input.data (), input.size ());
+  input = { 4, 5, 6 };
+  buffer.force_write_multiple (input.data (), input.size ());
+
+  std::vector<int> output (4);
+  EXPECT_TRUE (buffer.read_multiple (output.data (), output.size ()));
+  EXPECT_EQ (output, std::vector<int> ({ 3, 4, 5, 6 }));
+
+  // more than the capacity at once keeps the last elements
+  input = { 7, 8, 9, 10, 11, 12 };
+  buffer.force_write_multiple (input.data (), input.size ());
+  EXPECT_EQ (buffer.read_space (), 4);
+  EXPECT_TRUE (buffer.read_multiple (output.data (), output.size ()));
+  EXPECT_EQ (output, std::vector<int> ({ 9, 10, 11, 12 }));
+}
+
 TEST (RingBufferTest, PeekOperations)
 {
   RingBuffer<int> buffer (4);
@@ -0,0 +1,71 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <memory>
+#include <mutex>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/rt_guard.h"
+
+using namespace zrythm::utils;
+
+class RtGuardTest : public ::testing::Test
+{
+protected:
+  void SetUp () override
+  {
+    if constexpr (!RtGuard::enabled ())
+      {
+        GTEST_SKIP () << "built without ZRYTHM_RT_GUARD";
+      }
+    RtGuard::reset ();
+  }
+
+  void TearDown () override { RtGuard::reset (); }
+};
+
+TEST_F (RtGuardTest, IgnoresNonRealtimeThreads)
+{
+  auto val = std::make_unique<int> (1);
+  val.reset ();
+  EXPECT_EQ (RtGuard::get_num_violations (), 0);
+}
+
+TEST_F (RtGuardTest, DetectsAllocations)
+{
+  std::unique_ptr<int> val;
+  {
+    RtGuard::Scope scope;
+    val = std::make_unique<int> (1);
+  }
+  EXPECT_EQ (RtGuard::get_num_violations (), 1);
+
+  {
+    RtGuard::Scope scope;
+    val.reset ();
+  }
+  EXPECT_EQ (RtGuard::get_num_violations (), 2);
+  EXPECT_NE (RtGuard::get_report ().find ("Deallocation"), std::string::npos);
+}
+
+#ifdef __linux__
+TEST_F (RtGuardTest, DetectsLocks)
+{
+  std::mutex mutex;
+  {
+    RtGuard::Scope  scope;
+    std::lock_guard lock (mutex);
+  }
+  EXPECT_EQ (RtGuard::get_num_violations (), 1);
+}
+#endif
+
+TEST_F (RtGuardTest, SuspendAllowsAllocations)
+{
+  RtGuard::Scope scope;
+  {
+    RtGuard::Suspend suspend;
+    auto             val = std::make_unique<int> (1);
+  }
+  EXPECT_EQ (RtGuard::get_num_violations (), 0);
+}
@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include "utils/gtest_wrapper.h"
+#include "utils/rt_logger.h"
+
+using namespace zrythm::utils;
+
+TEST (RtLoggerTest, FormatRecord)
+{
+  RtLogger::Record record;
+  record.fmt_ = "{} {} {:.1f} {} {}";
+  record.num_args_ = 5;
+  record.args_[0].type_ = RtLogger::Arg::Type::Int;
+  record.args_[0].int_ = -3;
+  record.args_[1].type_ = RtLogger::Arg::Type::UInt;
+  record.args_[1].uint_ = 42;
+  record.args_[2].type_ = RtLogger::Arg::Type::Double;
+  record.args_[2].double_ = 0.25;
+  record.args_[3].type_ = RtLogger::Arg::Type::Bool;
+  record.args_[3].bool_ = true;
+  record.args_[4].type_ = RtLogger::Arg::Type::String;
+  record.args_[4].str_ = "text";
+  EXPECT_EQ (RtLogger::format_record (record), "-3 42 0.2 true text");
+
+  // missing arguments don't throw
+  record.num_args_ = 1;
+  EXPECT_NO_THROW (RtLogger::format_record (record));
+}
+
+TEST (RtLoggerTest, QueueAndFlush)
+{
+  RtLogger logger (4);
+  const spdlog::source_loc loc{ __FILE__, __LINE__, SPDLOG_FUNCTION };
+  EXPECT_TRUE (logger.log (spdlog::level::debug, loc, "no args"));
+  EXPECT_TRUE (
+    logger.log (spdlog::level::info, loc, "{} {}", 1, static_cast<size_t> (2)));
+  EXPECT_TRUE (logger.log (spdlog::level::warn, loc, "{}", 3.5f));
+  EXPECT_TRUE (logger.log (spdlog::level::debug, loc, "{}", "static"));
+  EXPECT_EQ (logger.get_num_dropped (), 0);
+
+  // queue full
+  EXPECT_FALSE (logger.log (spdlog::level::debug, loc, "{}", 5));
+  EXPECT_FALSE (logger.log (spdlog::level::debug, loc, "{}", 6));
+  EXPECT_EQ (logger.get_num_dropped (), 2);
+
+  EXPECT_EQ (logger.flush (), 4);
+  EXPECT_EQ (logger.flush (), 0);
+
+  EXPECT_TRUE (logger.log (spdlog::level::debug, loc, "{}", 7));
+  EXPECT_EQ (logger.flush (), 1);
+  EXPECT_EQ (logger.get_num_dropped (), 2);
+}
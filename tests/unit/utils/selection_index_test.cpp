@@ -0,0 +1,79 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <algorithm>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/selection_index.h"
+
+using namespace zrythm::utils;
+
+namespace
+{
+struct TestId
+{
+  size_t hash () const { return std::hash<int>{}(val_); }
+  bool   operator== (const TestId &other) const = default;
+
+  int val_;
+};
+}
+
+TEST (SelectionIndexTest, AddAndRemove)
+{
+  SelectionIndex<int> index;
+  EXPECT_TRUE (index.empty ());
+
+  index.add (1);
+  index.add (2);
+  index.add (3);
+  index.add (2);
+  EXPECT_EQ (index.size (), 3);
+  EXPECT_TRUE (index.contains (2));
+
+  index.remove (1);
+  index.remove (4);
+  EXPECT_EQ (index.size (), 2);
+  EXPECT_FALSE (index.contains (1));
+  EXPECT_TRUE (index.contains (2));
+  EXPECT_TRUE (index.contains (3));
+
+  std::vector<int> ids (index.get_ids ().begin (), index.get_ids ().end ());
+  std::ranges::sort (ids);
+  EXPECT_EQ (ids, (std::vector<int>{ 2, 3 }));
+
+  index.clear ();
+  EXPECT_TRUE (index.empty ());
+  EXPECT_FALSE (index.contains (2));
+}
+
+TEST (SelectionIndexTest, SetSelected)
+{
+  SelectionIndex<TestId> index;
+  index.set_selected (TestId{ 5 }, true);
+  index.set_selected (TestId{ 6 }, true);
+  index.set_selected (TestId{ 5 }, false);
+  EXPECT_EQ (index.size (), 1);
+  EXPECT_TRUE (index.contains (TestId{ 6 }));
+  EXPECT_EQ (index.get_ids ().front (), TestId{ 6 });
+}
+
+TEST (SelectionIndexTest, ManyIds)
+{
+  SelectionIndex<int> index;
+  for (int i = 0; i < 1000; ++i)
+    index.add (i);
+  for (int i = 0; i < 1000; i += 2)
+    index.remove (i);
+
+  EXPECT_EQ (index.size (), 500);
+  for (int i = 0; i < 1000; ++i)
+    EXPECT_EQ (index.contains (i), i % 2 != 0);
+
+  /* positions stay consistent after removals */
+  for (const auto id : index.get_ids ())
+    EXPECT_TRUE (index.contains (id));
+  for (int i = 1; i < 1000; i += 2)
+    index.remove (i);
+  EXPECT_TRUE (index.empty ());
+}
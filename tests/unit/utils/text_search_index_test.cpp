@@ -0,0 +1,135 @@
+// SPDX-FileCopyrightText: © 2024 Alexandros Theodotou <alex@zrythm.org>
+// SPDX-License-Identifier: LicenseRef-ZrythmLicense
+
+#include <random>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/text_search_index.h"
+
+using namespace zrythm::utils;
+
+using Document = TextSearchIndex::Document;
+using Query = TextSearchIndex::Query;
+
+namespace
+{
+/* facets: category, author */
+const std::vector<Document> test_documents = {
+  { "Dragonfly Room Reverb", { "Reverb", "Michael Willis" } },
+  { "Dragonfly Hall Reverb", { "Reverb", "Michael Willis" } },
+  { "ZynAddSubFX", { "Instrument", "Zynaddsubfx" } },
+  { "Helm", { "Instrument", "Matt Tytel" } },
+  { "x42 EQ", { "Equaliser", "x42" } },
+  { "LSP Room Reverb Stereo", { "Reverb", "LSP" } },
+};
+}
+
+TEST (TextSearchIndexTest, Empty)
+{
+  TextSearchIndex index;
+  index.build ({});
+  EXPECT_TRUE (index.empty ());
+  EXPECT_TRUE (index.search ({ .text_ = "reverb" }).empty ());
+  EXPECT_TRUE (index.search ({}).empty ());
+}
+
+TEST (TextSearchIndexTest, Text)
+{
+  TextSearchIndex index;
+  index.build (test_documents);
+  EXPECT_EQ (index.size (), test_documents.size ());
+
+  EXPECT_EQ (
+    index.search ({ .text_ = "reverb" }), (std::vector<size_t>{ 0, 1, 5 }));
+  EXPECT_EQ (
+    index.search ({ .text_ = "ROOM reverb" }), (std::vector<size_t>{ 0, 5 }));
+  EXPECT_EQ (
+    index.search ({ .text_ = "  reverb   dragon " }),
+    (std::vector<size_t>{ 0, 1 }));
+  EXPECT_EQ (index.search ({ .text_ = "addsub" }), (std::vector<size_t>{ 2 }));
+  EXPECT_TRUE (index.search ({ .text_ = "chorus" }).empty ());
+
+  /* words shorter than a trigram */
+  EXPECT_EQ (index.search ({ .text_ = "eq" }), (std::vector<size_t>{ 4 }));
+  EXPECT_EQ (index.search ({ .text_ = "z" }), (std::vector<size_t>{ 2 }));
+
+  /* no words matches everything */
+  EXPECT_EQ (index.search ({}).size (), test_documents.size ());
+}
+
+TEST (TextSearchIndexTest, Facets)
+{
+  TextSearchIndex index;
+  index.build (test_documents);
+
+  EXPECT_EQ (
+    index.search ({ .facet_values_ = { "Reverb" } }),
+    (std::vector<size_t>{ 0, 1, 5 }));
+  EXPECT_EQ (
+    index.search ({ .facet_values_ = { std::nullopt, "Michael Willis" } }),
+    (std::vector<size_t>{ 0, 1 }));
+  EXPECT_EQ (
+    index.search ({ .text_ = "room", .facet_values_ = { "Reverb", "LSP" } }),
+    (std::vector<size_t>{ 5 }));
+  EXPECT_TRUE (index.search ({ .facet_values_ = { "Delay" } }).empty ());
+
+  /* facets that no document has */
+  EXPECT_EQ (
+    index.search ({ .facet_values_ = { std::nullopt, std::nullopt, "" } })
+      .size (),
+    test_documents.size ());
+  EXPECT_TRUE (
+    index.search ({ .facet_values_ = { std::nullopt, std::nullopt, "a" } })
+      .empty ());
+
+  EXPECT_EQ (
+    index.get_facet_values (0),
+    (std::vector<std::string>{ "Reverb", "Instrument", "Equaliser" }));
+  EXPECT_TRUE (index.get_facet_values (2).empty ());
+}
+
+TEST (TextSearchIndexTest, MatchesLinearSearch)
+{
+  std::mt19937                    rng (0);
+  std::uniform_int_distribution<> char_dist ('a', 'f');
+  std::uniform_int_distribution<> len_dist (0, 12);
+  std::uniform_int_distribution<> facet_dist (0, 3);
+
+  const auto random_string = [&] (int len) {
+    std::string ret;
+    for (int i = 0; i < len; ++i)
+      {
+        ret.push_back (static_cast<char> (char_dist (rng)));
+      }
+    return ret;
+  };
+
+  std::vector<Document> documents;
+  for (int i = 0; i < 500; ++i)
+    {
+      documents.push_back (
+        { random_string (len_dist (rng)),
+          { std::to_string (facet_dist (rng)) } });
+    }
+  TextSearchIndex index;
+  index.build (documents);
+
+  for (int i = 0; i < 200; ++i)
+    {
+      const auto word = random_string (1 + i % 4);
+      const auto facet = std::to_string (facet_dist (rng));
+      std::vector<size_t> expected;
+      for (size_t doc = 0; doc < documents.size (); ++doc)
+        {
+          if (
+            documents[doc].text_.find (word) != std::string::npos
+            && documents[doc].facet_values_[0] == facet)
+            {
+              expected.push_back (doc);
+            }
+        }
+      EXPECT_EQ (
+        index.search ({ .text_ = word, .facet_values_ = { facet } }), expected)
+        << word;
+    }
+}
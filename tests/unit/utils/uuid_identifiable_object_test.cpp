@@ -136,6 +136,56 @@ TEST_F (UuidIdentifiableObjectRegistryTest, ObjectLookup)
   EXPECT_THROW (registry_.find_by_id_or_throw (TestUuid{}), std::runtime_error);
 }
 
+TEST_F (UuidIdentifiableObjectRegistryTest, HandleLookup)
+{
+  const auto handle = registry_.get_handle (obj2_->get_uuid ());
+  ASSERT_FALSE (handle.is_null ());
+  const auto * found_var = registry_.find_by_handle (handle);
+  ASSERT_NE (found_var, nullptr);
+  EXPECT_EQ (std::get<DerivedTestObject *> (*found_var), obj2_);
+  EXPECT_TRUE (registry_.get_handle (TestUuid{}).is_null ());
+  EXPECT_EQ (registry_.find_by_handle ({}), nullptr);
+
+  // handles become stale once the object is unregistered, even if the slot
+  // is reused
+  const auto id2 = obj2_->get_uuid ();
+  registry_.delete_object_by_id (id2);
+  EXPECT_EQ (registry_.find_by_handle (handle), nullptr);
+  auto * obj4 =
+    new DerivedTestObject (TestUuid{ QUuid::createUuid () }, "Object4");
+  registry_.register_object (obj4);
+  const auto handle4 = registry_.get_handle (obj4->get_uuid ());
+  EXPECT_EQ (handle4.index_, handle.index_);
+  EXPECT_EQ (registry_.find_by_handle (handle), nullptr);
+  EXPECT_EQ (
+    std::get<DerivedTestObject *> (*registry_.find_by_handle (handle4)), obj4);
+}
+
+TEST_F (UuidIdentifiableObjectRegistryTest, CachedLookup)
+{
+  ObjectHandleCache cache;
+  const auto       &found_var =
+    registry_.find_by_id_or_throw (obj1_->get_uuid (), cache);
+  EXPECT_EQ (std::get<DerivedTestObject *> (found_var), obj1_);
+  EXPECT_EQ (cache.load (), registry_.get_handle (obj1_->get_uuid ()));
+
+  // a cached handle for another object is not used
+  EXPECT_EQ (
+    std::get<DerivedTestObject *> (
+      registry_.find_by_id_or_throw (obj3_->get_uuid (), cache)),
+    obj3_);
+  EXPECT_EQ (cache.load (), registry_.get_handle (obj3_->get_uuid ()));
+
+  registry_.delete_object_by_id (obj3_->get_uuid ());
+  EXPECT_THROW (
+    registry_.find_by_id_or_throw (TestUuid{}, cache), std::runtime_error);
+
+  // copies start empty
+  cache.store (registry_.get_handle (obj1_->get_uuid ()));
+  const auto copy = cache;
+  EXPECT_TRUE (copy.load ().is_null ());
+}
+
 TEST_F (UuidIdentifiableObjectRegistryTest, SpanIteration)
 {
   std::vector<TestUuid> uuids{ obj3_->get_uuid (), obj1_->get_uuid () };
@@ -0,0 +1,106 @@
+#include <thread>
+#include <vector>
+
+#include "utils/gtest_wrapper.h"
+#include "utils/work_stealing_deque.h"
+
+TEST (WorkStealingDequeTest, BasicOperations)
+{
+  WorkStealingDeque<int> deque (8);
+  EXPECT_EQ (deque.capacity (), 8);
+  EXPECT_FALSE (deque.pop ().has_value ());
+  EXPECT_FALSE (deque.steal ().has_value ());
+
+  EXPECT_TRUE (deque.push (1));
+  EXPECT_TRUE (deque.push (2));
+  EXPECT_TRUE (deque.push (3));
+  EXPECT_EQ (deque.size_approx (), 3);
+
+  // owner pops LIFO, thieves steal FIFO
+  EXPECT_EQ (deque.pop (), 3);
+  EXPECT_EQ (deque.steal (), 1);
+  EXPECT_EQ (deque.pop (), 2);
+  EXPECT_TRUE (deque.empty_approx ());
+}
+
+TEST (WorkStealingDequeTest, Capacity)
+{
+  WorkStealingDeque<int> deque (5);
+  EXPECT_EQ (deque.capacity (), 8);
+
+  for (int i = 0; i < 8; i++)
+    {
+      EXPECT_TRUE (deque.push (i));
+    }
+  EXPECT_FALSE (deque.push (42));
+
+  // stealing frees space at the top
+  EXPECT_EQ (deque.steal (), 0);
+  EXPECT_TRUE (deque.push (42));
+  EXPECT_EQ (deque.pop (), 42);
+}
+
+TEST (WorkStealingDequeTest, Reserve)
+{
+  WorkStealingDeque<int> deque (4);
+  deque.reserve (2);
+  EXPECT_EQ (deque.capacity (), 4);
+  deque.reserve (100);
+  EXPECT_EQ (deque.capacity (), 128);
+}
+
+TEST (WorkStealingDequeTest, ConcurrentSteal)
+{
+  constexpr int          num_items = 100000;
+  constexpr int          num_thieves = 4;
+  WorkStealingDeque<int> deque (num_items);
+  std::atomic<int>       taken{ 0 };
+  std::atomic<int64_t>   sum{ 0 };
+  std::atomic<bool>      done_pushing{ false };
+
+  std::vector<std::thread> thieves;
+  for (int i = 0; i < num_thieves; i++)
+    {
+      thieves.emplace_back ([&] () {
+        while (taken < num_items)
+          {
+            if (auto val = deque.steal ())
+              {
+                sum += *val;
+                taken++;
+              }
+            else if (done_pushing)
+              {
+                std::this_thread::yield ();
+              }
+          }
+      });
+    }
+
+  // owner interleaves pushes and pops
+  for (int i = 0; i < num_items; i++)
+    {
+      EXPECT_TRUE (deque.push (i));
+      if (i % 3 == 0)
+        {
+          if (auto val = deque.pop ())
+            {
+              sum += *val;
+              taken++;
+            }
+        }
+    }
+  done_pushing = true;
+  while (auto val = deque.pop ())
+    {
+      sum += *val;
+      taken++;
+    }
+
+  for (auto &t : thieves)
+    t.join ();
+
+  // every item must have been taken exactly once
+  EXPECT_EQ (taken, num_items);
+  EXPECT_EQ (sum, static_cast<int64_t> (num_items) * (num_items - 1) / 2);
+}